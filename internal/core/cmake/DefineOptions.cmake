@@ -45,6 +45,8 @@ set_option_category("Milvus Build Option")
 
 define_option(MILVUS_GPU_VERSION "Build GPU version" OFF)
 
+define_option(MILVUS_SEGCORE_METRICS "Build the segcore counters and latency histograms" ON)
+
 #----------------------------------------------------------------------
 set_option_category("Thirdparty")
 
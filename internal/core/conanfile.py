@@ -44,6 +44,7 @@ class MilvusConan(ConanFile):
         "arrow:parquet": True,
         "arrow:compute": True,
         "arrow:with_zstd": True,
+        "arrow:with_lz4": True,
         "arrow:shared": False,
         "arrow:with_jemalloc": True,
         "aws-sdk-cpp:text-to-speech": False,
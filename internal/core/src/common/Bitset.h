@@ -0,0 +1,469 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
+namespace milvus {
+
+// Dense bitset over 64-bit blocks in 64-byte aligned storage. Bit i lives
+// in bit (i % 64) of block (i / 64), so on little-endian hosts the blocks
+// are also the byte layout knowhere::BitsetView expects and can be viewed
+// without a copy. Bits past size() in the last block are always zero.
+//
+// The interface follows the subset of boost::dynamic_bitset the code base
+// uses; whole-bitset operations run block-wise over aligned storage so the
+// compiler can vectorize them.
+class Bitset {
+ public:
+    using block_type = uint64_t;
+    using size_type = size_t;
+    static constexpr size_type bits_per_block = 64;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+    static constexpr size_t alignment = 64;
+
+    class reference {
+     public:
+        reference(block_type& block, block_type mask)
+            : block_(block), mask_(mask) {
+        }
+
+        operator bool() const {
+            return (block_ & mask_) != 0;
+        }
+
+        bool
+        operator~() const {
+            return (block_ & mask_) == 0;
+        }
+
+        reference&
+        operator=(bool value) {
+            if (value) {
+                block_ |= mask_;
+            } else {
+                block_ &= ~mask_;
+            }
+            return *this;
+        }
+
+        reference&
+        operator=(const reference& other) {
+            return *this = bool(other);
+        }
+
+        reference&
+        flip() {
+            block_ ^= mask_;
+            return *this;
+        }
+
+     private:
+        block_type& block_;
+        block_type mask_;
+    };
+
+    Bitset() = default;
+
+    explicit Bitset(size_type num_bits, bool value = false)
+        : blocks_(num_blocks_for(num_bits), value ? ~block_type(0) : 0),
+          num_bits_(num_bits) {
+        zero_unused_bits();
+    }
+
+ public:
+    size_type
+    size() const {
+        return num_bits_;
+    }
+
+    size_type
+    num_blocks() const {
+        return blocks_.size();
+    }
+
+    bool
+    empty() const {
+        return num_bits_ == 0;
+    }
+
+    const block_type*
+    data() const {
+        return blocks_.data();
+    }
+
+    block_type*
+    data() {
+        return blocks_.data();
+    }
+
+    void
+    reserve(size_type num_bits) {
+        blocks_.reserve(num_blocks_for(num_bits));
+    }
+
+    void
+    resize(size_type num_bits, bool value = false) {
+        auto old_bits = num_bits_;
+        blocks_.resize(num_blocks_for(num_bits), value ? ~block_type(0) : 0);
+        num_bits_ = num_bits;
+        if (value && num_bits > old_bits) {
+            // the tail of the old last block was zero
+            fill_range(old_bits, std::min(num_bits, round_up(old_bits)), true);
+        }
+        zero_unused_bits();
+    }
+
+    void
+    clear() {
+        blocks_.clear();
+        num_bits_ = 0;
+    }
+
+    void
+    push_back(bool value) {
+        resize(num_bits_ + 1);
+        if (value) {
+            set(num_bits_ - 1);
+        }
+    }
+
+    void
+    swap(Bitset& other) noexcept {
+        blocks_.swap(other.blocks_);
+        std::swap(num_bits_, other.num_bits_);
+    }
+
+ public:
+    bool
+    test(size_type pos) const {
+        assert(pos < num_bits_);
+        return (blocks_[block_index(pos)] & bit_mask(pos)) != 0;
+    }
+
+    bool
+    operator[](size_type pos) const {
+        return test(pos);
+    }
+
+    reference
+    operator[](size_type pos) {
+        assert(pos < num_bits_);
+        return {blocks_[block_index(pos)], bit_mask(pos)};
+    }
+
+    Bitset&
+    set() {
+        std::fill(blocks_.begin(), blocks_.end(), ~block_type(0));
+        zero_unused_bits();
+        return *this;
+    }
+
+    Bitset&
+    set(size_type pos, bool value = true) {
+        assert(pos < num_bits_);
+        if (value) {
+            blocks_[block_index(pos)] |= bit_mask(pos);
+        } else {
+            blocks_[block_index(pos)] &= ~bit_mask(pos);
+        }
+        return *this;
+    }
+
+    // set [pos, pos + len) to value, filling whole blocks at once
+    Bitset&
+    set(size_type pos, size_type len, bool value) {
+        assert(pos + len <= num_bits_);
+        fill_range(pos, pos + len, value);
+        return *this;
+    }
+
+    Bitset&
+    reset() {
+        std::fill(blocks_.begin(), blocks_.end(), 0);
+        return *this;
+    }
+
+    Bitset&
+    reset(size_type pos) {
+        return set(pos, false);
+    }
+
+    Bitset&
+    reset(size_type pos, size_type len) {
+        return set(pos, len, false);
+    }
+
+    Bitset&
+    flip() {
+        auto blocks = aligned_data();
+        auto n = blocks_.size();
+        for (size_type i = 0; i < n; ++i) {
+            blocks[i] = ~blocks[i];
+        }
+        zero_unused_bits();
+        return *this;
+    }
+
+    Bitset&
+    flip(size_type pos) {
+        assert(pos < num_bits_);
+        blocks_[block_index(pos)] ^= bit_mask(pos);
+        return *this;
+    }
+
+ public:
+    size_type
+    count() const {
+        auto blocks = aligned_data();
+        auto n = blocks_.size();
+        size_type result = 0;
+        for (size_type i = 0; i < n; ++i) {
+            result += __builtin_popcountll(blocks[i]);
+        }
+        return result;
+    }
+
+    bool
+    any() const {
+        auto blocks = aligned_data();
+        auto n = blocks_.size();
+        block_type acc = 0;
+        for (size_type i = 0; i < n; ++i) {
+            acc |= blocks[i];
+        }
+        return acc != 0;
+    }
+
+    bool
+    none() const {
+        return !any();
+    }
+
+    // true for an empty bitset, as boost::dynamic_bitset
+    bool
+    all() const {
+        if (num_bits_ == 0) {
+            return true;
+        }
+        auto blocks = aligned_data();
+        auto full = blocks_.size() - 1;
+        block_type acc = ~block_type(0);
+        for (size_type i = 0; i < full; ++i) {
+            acc &= blocks[i];
+        }
+        return acc == ~block_type(0) && blocks[full] == last_block_mask();
+    }
+
+    size_type
+    find_first() const {
+        return find_from(0);
+    }
+
+    // first set bit after pos, npos if none
+    size_type
+    find_next(size_type pos) const {
+        if (pos == npos || pos + 1 >= num_bits_) {
+            return npos;
+        }
+        return find_from(pos + 1);
+    }
+
+ public:
+    Bitset&
+    operator&=(const Bitset& other) {
+        return apply(other, [](block_type a, block_type b) { return a & b; });
+    }
+
+    Bitset&
+    operator|=(const Bitset& other) {
+        return apply(other, [](block_type a, block_type b) { return a | b; });
+    }
+
+    Bitset&
+    operator^=(const Bitset& other) {
+        return apply(other, [](block_type a, block_type b) { return a ^ b; });
+    }
+
+    // and-not: clear the bits set in other
+    Bitset&
+    operator-=(const Bitset& other) {
+        return apply(other, [](block_type a, block_type b) { return a & ~b; });
+    }
+
+    Bitset
+    operator~() const {
+        Bitset result(*this);
+        result.flip();
+        return result;
+    }
+
+    friend Bitset
+    operator&(const Bitset& x, const Bitset& y) {
+        Bitset result(x);
+        return result &= y;
+    }
+
+    friend Bitset
+    operator|(const Bitset& x, const Bitset& y) {
+        Bitset result(x);
+        return result |= y;
+    }
+
+    friend Bitset
+    operator^(const Bitset& x, const Bitset& y) {
+        Bitset result(x);
+        return result ^= y;
+    }
+
+    friend Bitset
+    operator-(const Bitset& x, const Bitset& y) {
+        Bitset result(x);
+        return result -= y;
+    }
+
+    friend bool
+    operator==(const Bitset& x, const Bitset& y) {
+        return x.num_bits_ == y.num_bits_ && x.blocks_ == y.blocks_;
+    }
+
+    friend bool
+    operator!=(const Bitset& x, const Bitset& y) {
+        return !(x == y);
+    }
+
+ private:
+    static constexpr size_type
+    num_blocks_for(size_type num_bits) {
+        return (num_bits + bits_per_block - 1) / bits_per_block;
+    }
+
+    static constexpr size_type
+    round_up(size_type num_bits) {
+        return num_blocks_for(num_bits) * bits_per_block;
+    }
+
+    static constexpr size_type
+    block_index(size_type pos) {
+        return pos / bits_per_block;
+    }
+
+    static constexpr block_type
+    bit_mask(size_type pos) {
+        return block_type(1) << (pos % bits_per_block);
+    }
+
+    // the valid bits of the last block
+    block_type
+    last_block_mask() const {
+        auto tail = num_bits_ % bits_per_block;
+        return tail == 0 ? ~block_type(0) : (block_type(1) << tail) - 1;
+    }
+
+    void
+    zero_unused_bits() {
+        if (!blocks_.empty()) {
+            blocks_.back() &= last_block_mask();
+        }
+    }
+
+    const block_type*
+    aligned_data() const {
+        return static_cast<const block_type*>(
+            __builtin_assume_aligned(blocks_.data(), alignment));
+    }
+
+    block_type*
+    aligned_data() {
+        return static_cast<block_type*>(
+            __builtin_assume_aligned(blocks_.data(), alignment));
+    }
+
+    // [begin, end) to value; partial blocks are masked, the rest filled
+    void
+    fill_range(size_type begin, size_type end, bool value) {
+        if (begin >= end) {
+            return;
+        }
+        auto first = block_index(begin);
+        auto last = block_index(end - 1);
+        auto head = ~block_type(0) << (begin % bits_per_block);
+        auto tail = ~block_type(0) >>
+                    (bits_per_block - 1 - (end - 1) % bits_per_block);
+        auto write = [&](size_type block_id, block_type mask) {
+            if (value) {
+                blocks_[block_id] |= mask;
+            } else {
+                blocks_[block_id] &= ~mask;
+            }
+        };
+        if (first == last) {
+            write(first, head & tail);
+            return;
+        }
+        write(first, head);
+        std::fill(blocks_.begin() + first + 1,
+                  blocks_.begin() + last,
+                  value ? ~block_type(0) : 0);
+        write(last, tail);
+    }
+
+    size_type
+    find_from(size_type pos) const {
+        if (pos >= num_bits_) {
+            return npos;
+        }
+        auto block_id = block_index(pos);
+        auto word =
+            blocks_[block_id] & (~block_type(0) << (pos % bits_per_block));
+        while (word == 0) {
+            if (++block_id == blocks_.size()) {
+                return npos;
+            }
+            word = blocks_[block_id];
+        }
+        return block_id * bits_per_block + __builtin_ctzll(word);
+    }
+
+    template <typename Op>
+    Bitset&
+    apply(const Bitset& other, Op op) {
+        assert(num_bits_ == other.num_bits_);
+        auto dst = aligned_data();
+        auto src = other.aligned_data();
+        auto n = blocks_.size();
+        for (size_type i = 0; i < n; ++i) {
+            dst[i] = op(dst[i], src[i]);
+        }
+        return *this;
+    }
+
+ private:
+    std::vector<block_type,
+                boost::alignment::aligned_allocator<block_type, alignment>>
+        blocks_;
+    size_type num_bits_ = 0;
+};
+
+}  // namespace milvus
@@ -18,7 +18,6 @@
 
 #include <fmt/core.h>
 
-#include <boost_ext/dynamic_bitset_ext.hpp>
 #include <deque>
 
 #include "common/Types.h"
@@ -41,7 +40,7 @@ class BitsetView : public knowhere::BitsetView {
     }
 
     BitsetView(const BitsetType& bitset)  // NOLINT
-        : BitsetView((uint8_t*)boost_ext::get_data(bitset),
+        : BitsetView(reinterpret_cast<const uint8_t*>(bitset.data()),
                      size_t(bitset.size())) {
     }
 
@@ -0,0 +1,72 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/BuildContext.h"
+
+#include <omp.h>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+namespace {
+thread_local BuildContext* current_context = nullptr;
+}  // namespace
+
+void
+BuildContext::Report(const std::string& phase,
+                     int64_t rows_done,
+                     int64_t rows_total) {
+    if (cancelled_) {
+        PanicCodeInfo(ErrorCodeEnum::BuildIndexError,
+                      "index build cancelled in phase " + phase);
+    }
+    if (progress_) {
+        progress_(phase, rows_done, rows_total);
+    }
+}
+
+BuildContextScope::BuildContextScope(BuildContext* context)
+    : previous_(current_context) {
+    current_context = context;
+    if (context != nullptr && context->num_threads() > 0) {
+        previous_threads_ = omp_get_max_threads();
+        omp_set_num_threads(int(context->num_threads()));
+    }
+}
+
+BuildContextScope::~BuildContextScope() {
+    if (previous_threads_ > 0) {
+        omp_set_num_threads(previous_threads_);
+    }
+    current_context = previous_;
+}
+
+BuildContext*
+CurrentBuildContext() {
+    return current_context;
+}
+
+void
+ReportBuildProgress(const std::string& phase,
+                    int64_t rows_done,
+                    int64_t rows_total) {
+    if (current_context != nullptr) {
+        current_context->Report(phase, rows_done, rows_total);
+    }
+}
+
+}  // namespace milvus
@@ -0,0 +1,95 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace milvus {
+
+// an index build run for the index node: the threads it may take, a flag
+// to stop it and where its progress goes
+class BuildContext {
+ public:
+    // rows_total is -1 while unknown
+    using ProgressFn = std::function<void(
+        const std::string& phase, int64_t rows_done, int64_t rows_total)>;
+
+    // num_threads 0 leaves the threads to the index
+    BuildContext(int64_t num_threads, ProgressFn progress)
+        : num_threads_(num_threads), progress_(std::move(progress)) {
+    }
+
+    int64_t
+    num_threads() const {
+        return num_threads_;
+    }
+
+    // the build stops at its next progress report
+    void
+    Cancel() {
+        cancelled_ = true;
+    }
+
+    bool
+    cancelled() const {
+        return cancelled_;
+    }
+
+    // throws BuildIndexError once cancelled
+    void
+    Report(const std::string& phase, int64_t rows_done, int64_t rows_total);
+
+ private:
+    const int64_t num_threads_;
+    ProgressFn progress_;
+    std::atomic<bool> cancelled_ = false;
+};
+
+using BuildContextPtr = std::shared_ptr<BuildContext>;
+
+// the build context of the calling thread while it lives, which also caps
+// the openmp threads of the thread to its budget
+class BuildContextScope {
+ public:
+    explicit BuildContextScope(BuildContext* context);
+
+    ~BuildContextScope();
+
+    BuildContextScope(const BuildContextScope&) = delete;
+    BuildContextScope&
+    operator=(const BuildContextScope&) = delete;
+
+ private:
+    BuildContext* previous_;
+    int previous_threads_ = 0;
+};
+
+// the context of the build running on this thread, null if none
+BuildContext*
+CurrentBuildContext();
+
+// reports to the build running on this thread, if any
+void
+ReportBuildProgress(const std::string& phase,
+                    int64_t rows_done,
+                    int64_t rows_total = -1);
+
+}  // namespace milvus
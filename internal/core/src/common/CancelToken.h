@@ -0,0 +1,100 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "common/type_c.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+// stops an execution of a plan on all its segments once cancelled or past
+// its deadline: the filters, the vector searches and the reduce check it
+// between chunks and blocks, and throw a QueryCancelled error. a copy of a
+// plan is another execution, so a copied token starts afresh
+class CancelToken {
+ public:
+    CancelToken() = default;
+
+    CancelToken(const CancelToken&) {
+    }
+
+    CancelToken&
+    operator=(const CancelToken&) {
+        return *this;
+    }
+
+    // from any thread, the running checks see it at their next one
+    void
+    Cancel() {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    // a unix time in milliseconds, 0 for none
+    void
+    SetDeadline(int64_t deadline_ms) {
+        deadline_ms_.store(deadline_ms, std::memory_order_relaxed);
+    }
+
+    // Cancel was called
+    bool
+    CancelRequested() const {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    bool
+    PastDeadline() const {
+        auto deadline_ms = deadline_ms_.load(std::memory_order_relaxed);
+        if (deadline_ms == 0) {
+            return false;
+        }
+        auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+        return now_ms >= deadline_ms;
+    }
+
+    bool
+    Cancelled() const {
+        return CancelRequested() || PastDeadline();
+    }
+
+    void
+    Check() const {
+        if (Cancelled()) {
+            PanicCodeInfo(static_cast<ErrorCodeEnum>(QueryCancelled),
+                          "query cancelled or past its deadline");
+        }
+    }
+
+ private:
+    std::atomic<bool> cancelled_{false};
+    std::atomic<int64_t> deadline_ms_{0};
+};
+
+// checks token, unless null
+inline void
+CheckCancel(const CancelToken* token) {
+    if (token != nullptr) {
+        token->Check();
+    }
+}
+
+}  // namespace milvus
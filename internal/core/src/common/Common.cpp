@@ -15,13 +15,32 @@
 // limitations under the License.
 
 #include "common/Common.h"
+#include "exceptions/EasyAssert.h"
 #include "log/Log.h"
 
 namespace milvus {
 
 int64_t index_file_slice_size = DEFAULT_INDEX_FILE_SLICE_SIZE;
 int64_t thread_core_coefficient = DEFAULT_THREAD_CORE_COEFFICIENT;
+int64_t query_thread_core_coefficient = DEFAULT_QUERY_THREAD_CORE_COEFFICIENT;
+int64_t build_thread_core_coefficient = DEFAULT_BUILD_THREAD_CORE_COEFFICIENT;
+int64_t compaction_thread_core_coefficient =
+    DEFAULT_COMPACTION_THREAD_CORE_COEFFICIENT;
 int cpu_num = DEFAULT_CPU_NUM;
+bool lazy_mmap_populate = DEFAULT_LAZY_MMAP_POPULATE;
+int64_t remote_upload_part_size = DEFAULT_REMOTE_UPLOAD_PART_SIZE;
+int64_t remote_upload_parallel_degree = DEFAULT_REMOTE_UPLOAD_PARALLEL_DEGREE;
+std::string vector_payload_compression = DEFAULT_VECTOR_PAYLOAD_COMPRESSION;
+int vector_payload_compression_level = DEFAULT_VECTOR_PAYLOAD_COMPRESSION_LEVEL;
+std::string scalar_payload_compression = DEFAULT_SCALAR_PAYLOAD_COMPRESSION;
+int scalar_payload_compression_level = DEFAULT_SCALAR_PAYLOAD_COMPRESSION_LEVEL;
+bool float_byte_stream_split = DEFAULT_FLOAT_BYTE_STREAM_SPLIT;
+bool segment_arenas = DEFAULT_SEGMENT_ARENAS;
+std::string disk_index_warm_up = DEFAULT_DISK_INDEX_WARM_UP;
+int64_t disk_index_cache_budget = DEFAULT_DISK_INDEX_CACHE_BUDGET;
+int64_t disk_index_local_cache_size = DEFAULT_DISK_INDEX_LOCAL_CACHE_SIZE;
+bool binlog_checksum = DEFAULT_BINLOG_CHECKSUM;
+bool numa_placement = DEFAULT_NUMA_PLACEMENT;
 
 void
 SetIndexSliceSize(const int64_t size) {
@@ -37,9 +56,112 @@ SetThreadCoreCoefficient(const int64_t coefficient) {
                        << thread_core_coefficient;
 }
 
+void
+SetQueryThreadCoreCoefficient(const int64_t coefficient) {
+    query_thread_core_coefficient = coefficient;
+    LOG_SEGCORE_DEBUG_ << "set query thread pool core coefficient: "
+                       << query_thread_core_coefficient;
+}
+
+void
+SetBuildThreadCoreCoefficient(const int64_t coefficient) {
+    build_thread_core_coefficient = coefficient;
+    LOG_SEGCORE_DEBUG_ << "set build thread pool core coefficient: "
+                       << build_thread_core_coefficient;
+}
+
+void
+SetCompactionThreadCoreCoefficient(const int64_t coefficient) {
+    compaction_thread_core_coefficient = coefficient;
+    LOG_SEGCORE_DEBUG_ << "set compaction thread pool core coefficient: "
+                       << compaction_thread_core_coefficient;
+}
+
 void
 SetCpuNum(const int num) {
     cpu_num = num;
 }
 
+void
+SetLazyMmapPopulate(const bool lazy) {
+    lazy_mmap_populate = lazy;
+    LOG_SEGCORE_DEBUG_ << "set config lazy mmap populate: "
+                       << lazy_mmap_populate;
+}
+
+void
+SetRemoteUploadPartSize(const int64_t size) {
+    remote_upload_part_size = size;
+    LOG_SEGCORE_DEBUG_ << "set config remote upload part size: "
+                       << remote_upload_part_size;
+}
+
+void
+SetRemoteUploadParallelDegree(const int64_t degree) {
+    remote_upload_parallel_degree = degree;
+    LOG_SEGCORE_DEBUG_ << "set config remote upload parallel degree: "
+                       << remote_upload_parallel_degree;
+}
+
+void
+SetVectorPayloadCompression(const std::string& codec, const int level) {
+    vector_payload_compression = codec;
+    vector_payload_compression_level = level;
+    LOG_SEGCORE_DEBUG_ << "set config vector payload compression: "
+                       << vector_payload_compression << ", level "
+                       << vector_payload_compression_level;
+}
+
+void
+SetScalarPayloadCompression(const std::string& codec, const int level) {
+    scalar_payload_compression = codec;
+    scalar_payload_compression_level = level;
+    LOG_SEGCORE_DEBUG_ << "set config scalar payload compression: "
+                       << scalar_payload_compression << ", level "
+                       << scalar_payload_compression_level;
+}
+
+void
+SetFloatByteStreamSplit(const bool enable) {
+    float_byte_stream_split = enable;
+    LOG_SEGCORE_DEBUG_ << "set config float byte stream split: "
+                       << float_byte_stream_split;
+}
+
+void
+SetSegmentArenas(const bool enable) {
+    segment_arenas = enable;
+    LOG_SEGCORE_DEBUG_ << "set config segment arenas: " << segment_arenas;
+}
+
+void
+SetDiskIndexWarmUp(const std::string& strategy, const int64_t budget) {
+    AssertInfo(strategy == "none" || strategy == "bfs" || strategy == "sample",
+               "invalid disk index warm up: " + strategy);
+    disk_index_warm_up = strategy;
+    disk_index_cache_budget = budget;
+    LOG_SEGCORE_DEBUG_ << "set config disk index warm up: "
+                       << disk_index_warm_up << ", cache budget "
+                       << disk_index_cache_budget;
+}
+
+void
+SetDiskIndexLocalCacheSize(const int64_t size) {
+    disk_index_local_cache_size = size;
+    LOG_SEGCORE_DEBUG_ << "set config disk index local cache size: "
+                       << disk_index_local_cache_size;
+}
+
+void
+SetBinlogChecksum(const bool enable) {
+    binlog_checksum = enable;
+    LOG_SEGCORE_DEBUG_ << "set config binlog checksum: " << binlog_checksum;
+}
+
+void
+SetNumaPlacement(const bool enable) {
+    numa_placement = enable;
+    LOG_SEGCORE_DEBUG_ << "set config numa placement: " << numa_placement;
+}
+
 }  // namespace milvus
@@ -17,21 +17,105 @@
 #pragma once
 
 #include <iostream>
+#include <string>
 #include "common/Consts.h"
 
 namespace milvus {
 
 extern int64_t index_file_slice_size;
 extern int64_t thread_core_coefficient;
+extern int64_t query_thread_core_coefficient;
+extern int64_t build_thread_core_coefficient;
+extern int64_t compaction_thread_core_coefficient;
 extern int cpu_num;
+extern bool lazy_mmap_populate;
+extern int64_t remote_upload_part_size;
+extern int64_t remote_upload_parallel_degree;
+extern std::string vector_payload_compression;
+extern int vector_payload_compression_level;
+extern std::string scalar_payload_compression;
+extern int scalar_payload_compression_level;
+extern bool float_byte_stream_split;
+extern bool segment_arenas;
+extern std::string disk_index_warm_up;
+extern int64_t disk_index_cache_budget;
+extern int64_t disk_index_local_cache_size;
+extern bool binlog_checksum;
+extern bool numa_placement;
 
 void
 SetIndexSliceSize(const int64_t size);
 
+// threads per core of the load pool, which downloads and caches files
 void
 SetThreadCoreCoefficient(const int64_t coefficient);
 
+void
+SetQueryThreadCoreCoefficient(const int64_t coefficient);
+
+void
+SetBuildThreadCoreCoefficient(const int64_t coefficient);
+
+void
+SetCompactionThreadCoreCoefficient(const int64_t coefficient);
+
 void
 SetCpuNum(const int core);
 
+// Loaded fields get their pages read ahead in the background instead of
+// populated before the load returns, so a segment becomes queryable
+// right after its data is written and the first searches may fault
+void
+SetLazyMmapPopulate(const bool lazy);
+
+void
+SetRemoteUploadPartSize(const int64_t size);
+
+// parts of one multipart upload in flight at a time
+void
+SetRemoteUploadParallelDegree(const int64_t degree);
+
+// codec is an arrow codec name such as "uncompressed", "lz4" or "zstd",
+// level is ignored by codecs without levels
+void
+SetVectorPayloadCompression(const std::string& codec, const int level);
+
+void
+SetScalarPayloadCompression(const std::string& codec, const int level);
+
+// float and double payloads get the byte stream split encoding, which
+// lines up the bytes of each value so the codec finds the redundancy
+void
+SetFloatByteStreamSplit(const bool enable);
+
+// segments created after it keep their data in jemalloc arenas of their
+// own, purged when they are released; no effect without jemalloc
+void
+SetSegmentArenas(const bool enable);
+
+// what a loaded disk index caches in memory before it serves: "none",
+// "bfs" for the nodes nearest the entry point or "sample" for the nodes
+// the queries sampled at build time visit; budget is the bytes all the
+// disk indexes of the node may cache together
+void
+SetDiskIndexWarmUp(const std::string& strategy, const int64_t budget);
+
+// bytes of local disk index files the node keeps: the files of released
+// indexes stay for a reload of the same index while they fit beside the
+// loaded ones, 0 removes them on release
+void
+SetDiskIndexLocalCacheSize(const int64_t size);
+
+// binlogs and index files written after it carry the crc32c of their
+// payload, checked when they are read back; files without it are read
+// unchecked either way
+void
+SetBinlogChecksum(const bool enable);
+
+// on a machine of several NUMA nodes, segments created after it are
+// spread over the nodes by id: their loaded and inserted data is placed
+// on their node and their searches get helpers pinned to its cpus
+void
+SetNumaPlacement(const bool enable);
+
 }  // namespace milvus
@@ -0,0 +1,560 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "common/Bitset.h"
+
+namespace milvus {
+
+// Set of rows in [0, size()) held in whichever of three containers is the
+// smallest for its density, as roaring bitmaps do per container:
+//   Array: sorted row offsets, for very sparse sets
+//   Run:   sorted disjoint [begin, end) row runs, for clustered or very
+//          dense sets
+//   Dense: a plain Bitset
+// Operations keep sparse operands sparse where the result can only shrink
+// and fall back to Dense otherwise; to_dense() is meant for the boundary
+// where a real bitmap is needed.
+class CompressedBitset {
+ public:
+    using size_type = Bitset::size_type;
+    using offset_type = uint32_t;
+
+    enum class Container {
+        Array,
+        Run,
+        Dense,
+    };
+
+    CompressedBitset() = default;
+
+    // empty set of size rows
+    explicit CompressedBitset(size_type size) : size_(size) {
+        if (size_ > max_sparse_size()) {
+            container_ = Container::Dense;
+            dense_ = Bitset(size_);
+        }
+    }
+
+    CompressedBitset(Bitset&& dense)
+        : container_(Container::Dense),
+          size_(dense.size()),
+          dense_(std::move(dense)) {
+    }
+
+    CompressedBitset(const Bitset& dense)
+        : container_(Container::Dense), size_(dense.size()), dense_(dense) {
+    }
+
+    // offsets need be neither sorted nor unique
+    static CompressedBitset
+    from_offsets(size_type size, std::vector<offset_type> offsets) {
+        if (size > max_sparse_size()) {
+            Bitset dense(size);
+            for (auto offset : offsets) {
+                dense.set(offset);
+            }
+            return CompressedBitset(std::move(dense));
+        }
+        std::sort(offsets.begin(), offsets.end());
+        offsets.erase(std::unique(offsets.begin(), offsets.end()),
+                      offsets.end());
+        assert(offsets.empty() || offsets.back() < size);
+        CompressedBitset result(size);
+        result.values_ = std::move(offsets);
+        result.optimize();
+        return result;
+    }
+
+    // a dense result moved into the container that suits its density
+    static CompressedBitset
+    compress(Bitset&& dense) {
+        CompressedBitset result(std::move(dense));
+        result.optimize();
+        return result;
+    }
+
+ public:
+    size_type
+    size() const {
+        return size_;
+    }
+
+    Container
+    container() const {
+        return container_;
+    }
+
+    // only valid for the Dense container
+    const Bitset&
+    dense() const {
+        assert(container_ == Container::Dense);
+        return dense_;
+    }
+
+    size_type
+    count() const {
+        switch (container_) {
+            case Container::Array:
+                return values_.size();
+            case Container::Run: {
+                size_type result = 0;
+                for (size_t i = 0; i < values_.size(); i += 2) {
+                    result += values_[i + 1] - values_[i];
+                }
+                return result;
+            }
+            default:
+                return dense_.count();
+        }
+    }
+
+    bool
+    none() const {
+        return container_ == Container::Dense ? dense_.none()
+                                              : values_.empty();
+    }
+
+    bool
+    any() const {
+        return !none();
+    }
+
+    bool
+    test(size_type pos) const {
+        assert(pos < size_);
+        switch (container_) {
+            case Container::Array:
+                return std::binary_search(
+                    values_.begin(), values_.end(), offset_type(pos));
+            case Container::Run: {
+                // first run end past pos, ends sit at odd indexes
+                auto iter = std::upper_bound(
+                    values_.begin(), values_.end(), offset_type(pos));
+                return ((iter - values_.begin()) & 1) == 1;
+            }
+            default:
+                return dense_.test(pos);
+        }
+    }
+
+    // bytes held by the container
+    size_type
+    memory_usage() const {
+        if (container_ == Container::Dense) {
+            return dense_.num_blocks() * sizeof(Bitset::block_type);
+        }
+        return values_.size() * sizeof(offset_type);
+    }
+
+    // calls func(begin, end) for every maximal run of set rows in order
+    template <typename Func>
+    void
+    for_each_run(Func func) const {
+        switch (container_) {
+            case Container::Array: {
+                size_t i = 0;
+                while (i < values_.size()) {
+                    size_t j = i + 1;
+                    while (j < values_.size() &&
+                           values_[j] == values_[j - 1] + 1) {
+                        ++j;
+                    }
+                    func(size_type(values_[i]), size_type(values_[j - 1]) + 1);
+                    i = j;
+                }
+                break;
+            }
+            case Container::Run: {
+                for (size_t i = 0; i < values_.size(); i += 2) {
+                    func(size_type(values_[i]), size_type(values_[i + 1]));
+                }
+                break;
+            }
+            default:
+                dense_runs(dense_, func);
+        }
+    }
+
+    Bitset
+    to_dense() const& {
+        if (container_ == Container::Dense) {
+            return dense_;
+        }
+        Bitset result(size_);
+        for_each_run([&](size_type begin, size_type end) {
+            result.set(begin, end - begin, true);
+        });
+        return result;
+    }
+
+    Bitset
+    to_dense() && {
+        if (container_ == Container::Dense) {
+            return std::move(dense_);
+        }
+        return static_cast<const CompressedBitset&>(*this).to_dense();
+    }
+
+    // switch to the smallest container, ties go to Dense as the fastest
+    void
+    optimize() {
+        if (size_ > max_sparse_size()) {
+            make_dense();
+            return;
+        }
+        size_type count = 0;
+        size_type runs = 0;
+        if (container_ == Container::Dense) {
+            count = dense_.count();
+            runs = count_dense_runs(dense_);
+        } else {
+            count = this->count();
+            for_each_run([&](size_type, size_type) { ++runs; });
+        }
+        auto dense_bytes =
+            (size_ + Bitset::bits_per_block - 1) / Bitset::bits_per_block *
+            sizeof(Bitset::block_type);
+        auto array_bytes = count * sizeof(offset_type);
+        auto run_bytes = runs * 2 * sizeof(offset_type);
+        if (dense_bytes <= array_bytes && dense_bytes <= run_bytes) {
+            make_dense();
+        } else if (array_bytes <= run_bytes) {
+            make_array();
+        } else {
+            make_run();
+        }
+    }
+
+ public:
+    CompressedBitset&
+    flip() {
+        if (container_ == Container::Dense) {
+            dense_.flip();
+            return *this;
+        }
+        // the complement of a sparse set is a set of runs over the gaps
+        auto runs = to_runs();
+        std::vector<offset_type> gaps;
+        gaps.reserve(runs.size() + 2);
+        offset_type prev = 0;
+        for (size_t i = 0; i < runs.size(); i += 2) {
+            if (runs[i] > prev) {
+                gaps.push_back(prev);
+                gaps.push_back(runs[i]);
+            }
+            prev = runs[i + 1];
+        }
+        if (prev < size_) {
+            gaps.push_back(prev);
+            gaps.push_back(offset_type(size_));
+        }
+        assign_runs(std::move(gaps));
+        return *this;
+    }
+
+    CompressedBitset&
+    operator&=(const CompressedBitset& other) {
+        assert(size_ == other.size_);
+        if (container_ == Container::Array) {
+            filter([&](offset_type pos) { return other.test(pos); });
+        } else if (other.container_ == Container::Array) {
+            CompressedBitset result(other);
+            result &= *this;
+            *this = std::move(result);
+        } else if (container_ == Container::Run &&
+                   other.container_ == Container::Run) {
+            assign_runs(intersect_runs(values_, other.values_));
+        } else {
+            make_dense();
+            if (other.container_ == Container::Dense) {
+                dense_ &= other.dense_;
+            } else {
+                // clear the gaps between the runs of other
+                size_type prev = 0;
+                other.for_each_run([&](size_type begin, size_type end) {
+                    dense_.reset(prev, begin - prev);
+                    prev = end;
+                });
+                dense_.reset(prev, size_ - prev);
+            }
+        }
+        return *this;
+    }
+
+    CompressedBitset&
+    operator|=(const CompressedBitset& other) {
+        assert(size_ == other.size_);
+        if (container_ != Container::Dense &&
+            other.container_ != Container::Dense) {
+            assign_runs(union_runs(to_runs(), other.to_runs()));
+        } else if (container_ != Container::Dense) {
+            CompressedBitset result(other);
+            result |= *this;
+            *this = std::move(result);
+        } else if (other.container_ == Container::Dense) {
+            dense_ |= other.dense_;
+        } else {
+            other.for_each_run([&](size_type begin, size_type end) {
+                dense_.set(begin, end - begin, true);
+            });
+        }
+        return *this;
+    }
+
+    CompressedBitset&
+    operator^=(const CompressedBitset& other) {
+        assert(size_ == other.size_);
+        make_dense();
+        if (other.container_ == Container::Dense) {
+            dense_ ^= other.dense_;
+        } else {
+            dense_ ^= other.to_dense();
+        }
+        return *this;
+    }
+
+    // and-not: drop the rows set in other
+    CompressedBitset&
+    operator-=(const CompressedBitset& other) {
+        assert(size_ == other.size_);
+        if (container_ == Container::Array) {
+            filter([&](offset_type pos) { return !other.test(pos); });
+        } else if (container_ == Container::Run &&
+                   other.container_ != Container::Dense) {
+            auto complement = CompressedBitset(other).flip();
+            assign_runs(intersect_runs(values_, complement.to_runs()));
+        } else {
+            make_dense();
+            if (other.container_ == Container::Dense) {
+                dense_ -= other.dense_;
+            } else {
+                other.for_each_run([&](size_type begin, size_type end) {
+                    dense_.reset(begin, end - begin);
+                });
+            }
+        }
+        return *this;
+    }
+
+    friend bool
+    operator==(const CompressedBitset& x, const CompressedBitset& y) {
+        if (x.size_ != y.size_) {
+            return false;
+        }
+        if (x.container_ == Container::Dense ||
+            y.container_ == Container::Dense) {
+            return x.to_dense() == y.to_dense();
+        }
+        return x.to_runs() == y.to_runs();
+    }
+
+    friend bool
+    operator!=(const CompressedBitset& x, const CompressedBitset& y) {
+        return !(x == y);
+    }
+
+ private:
+    static constexpr size_type
+    max_sparse_size() {
+        return std::numeric_limits<offset_type>::max();
+    }
+
+    // each maximal run of set bits of a dense bitset, whole zero and one
+    // blocks are skipped without looking at their bits
+    template <typename Func>
+    static void
+    dense_runs(const Bitset& dense, Func func) {
+        using block_type = Bitset::block_type;
+        constexpr auto bits = Bitset::bits_per_block;
+        auto blocks = dense.data();
+        auto n = dense.num_blocks();
+        bool in_run = false;
+        size_type begin = 0;
+        for (size_type b = 0; b < n; ++b) {
+            auto word = blocks[b];
+            if ((!in_run && word == 0) || (in_run && word == ~block_type(0))) {
+                continue;
+            }
+            size_type bit = 0;
+            while (bit < bits) {
+                auto above = ~block_type(0) << bit;
+                auto rest = in_run ? ~word & above : word & above;
+                if (rest == 0) {
+                    break;
+                }
+                bit = __builtin_ctzll(rest);
+                if (in_run) {
+                    func(begin, b * bits + bit);
+                } else {
+                    begin = b * bits + bit;
+                }
+                in_run = !in_run;
+            }
+        }
+        if (in_run) {
+            func(begin, dense.size());
+        }
+    }
+
+    static size_type
+    count_dense_runs(const Bitset& dense) {
+        using block_type = Bitset::block_type;
+        auto blocks = dense.data();
+        auto n = dense.num_blocks();
+        size_type runs = 0;
+        block_type carry = 0;
+        for (size_type b = 0; b < n; ++b) {
+            auto word = blocks[b];
+            // set bits whose lower neighbour is clear start a run
+            runs += __builtin_popcountll(word & ~((word << 1) | carry));
+            carry = word >> (Bitset::bits_per_block - 1);
+        }
+        return runs;
+    }
+
+    static std::vector<offset_type>
+    intersect_runs(const std::vector<offset_type>& x,
+                   const std::vector<offset_type>& y) {
+        std::vector<offset_type> result;
+        size_t i = 0;
+        size_t j = 0;
+        while (i < x.size() && j < y.size()) {
+            auto begin = std::max(x[i], y[j]);
+            auto end = std::min(x[i + 1], y[j + 1]);
+            if (begin < end) {
+                result.push_back(begin);
+                result.push_back(end);
+            }
+            if (x[i + 1] < y[j + 1]) {
+                i += 2;
+            } else {
+                j += 2;
+            }
+        }
+        return result;
+    }
+
+    static std::vector<offset_type>
+    union_runs(const std::vector<offset_type>& x,
+               const std::vector<offset_type>& y) {
+        std::vector<offset_type> result;
+        result.reserve(x.size() + y.size());
+        size_t i = 0;
+        size_t j = 0;
+        while (i < x.size() || j < y.size()) {
+            const offset_type* run;
+            if (j == y.size() || (i < x.size() && x[i] <= y[j])) {
+                run = &x[i];
+                i += 2;
+            } else {
+                run = &y[j];
+                j += 2;
+            }
+            // merge overlapping and adjacent runs
+            if (!result.empty() && run[0] <= result.back()) {
+                result.back() = std::max(result.back(), run[1]);
+            } else {
+                result.push_back(run[0]);
+                result.push_back(run[1]);
+            }
+        }
+        return result;
+    }
+
+    std::vector<offset_type>
+    to_runs() const {
+        if (container_ == Container::Run) {
+            return values_;
+        }
+        std::vector<offset_type> runs;
+        for_each_run([&](size_type begin, size_type end) {
+            runs.push_back(offset_type(begin));
+            runs.push_back(offset_type(end));
+        });
+        return runs;
+    }
+
+    void
+    assign_runs(std::vector<offset_type> runs) {
+        container_ = Container::Run;
+        values_ = std::move(runs);
+        dense_ = Bitset();
+        optimize();
+    }
+
+    template <typename Pred>
+    void
+    filter(Pred pred) {
+        assert(container_ == Container::Array);
+        auto drop = [&](offset_type pos) { return !pred(pos); };
+        values_.erase(std::remove_if(values_.begin(), values_.end(), drop),
+                      values_.end());
+    }
+
+    void
+    make_dense() {
+        if (container_ == Container::Dense) {
+            return;
+        }
+        dense_ = to_dense();
+        values_ = std::vector<offset_type>();
+        container_ = Container::Dense;
+    }
+
+    void
+    make_array() {
+        if (container_ == Container::Array) {
+            return;
+        }
+        std::vector<offset_type> values;
+        for_each_run([&](size_type begin, size_type end) {
+            for (auto pos = begin; pos < end; ++pos) {
+                values.push_back(offset_type(pos));
+            }
+        });
+        values_ = std::move(values);
+        dense_ = Bitset();
+        container_ = Container::Array;
+    }
+
+    void
+    make_run() {
+        if (container_ == Container::Run) {
+            return;
+        }
+        values_ = to_runs();
+        dense_ = Bitset();
+        container_ = Container::Run;
+    }
+
+ private:
+    Container container_ = Container::Array;
+    size_type size_ = 0;
+    // Array: set rows, Run: begin and end of each run, both ascending
+    std::vector<offset_type> values_;
+    Bitset dense_;
+};
+
+}  // namespace milvus
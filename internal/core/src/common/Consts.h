@@ -27,6 +27,10 @@ const milvus::PkType INVALID_PK;  // of std::monostate if not set.
 // TODO: default field start id, could get from config.yaml
 const int64_t START_USER_FIELDID = 100;
 const char MAX_LENGTH[] = "max_length";
+// type param of the field sealed segments keep their rows sorted by
+const char CLUSTERING_KEY[] = "clustering_key";
+// type param of the field the rows of a collection are partitioned by
+const char PARTITION_KEY[] = "partition_key";
 
 // const fieldID (rowID and timestamp)
 const milvus::FieldId RowFieldID = milvus::FieldId(0);
@@ -35,16 +39,61 @@ const milvus::FieldId TimestampFieldID = milvus::FieldId(1);
 // fill followed extra info to binlog file
 const char ORIGIN_SIZE_KEY[] = "original_size";
 const char INDEX_BUILD_ID_KEY[] = "indexBuildID";
+// crc32c of the event payload, 8 hex digits
+const char PAYLOAD_CRC32C_KEY[] = "payloadCRC32C";
 
 const char INDEX_ROOT_PATH[] = "index_files";
 const char RAWDATA_ROOT_PATH[] = "raw_datas";
 
 const int64_t DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT = 67108864;  // bytes
 const int64_t DEFAULT_THREAD_CORE_COEFFICIENT = 50;
+// query helpers are cpu bound and capped by cpu_num, the build pool mostly
+// uploads index files so it is sized like the load pool
+const int64_t DEFAULT_QUERY_THREAD_CORE_COEFFICIENT = 1;
+const int64_t DEFAULT_BUILD_THREAD_CORE_COEFFICIENT = 50;
+const int64_t DEFAULT_COMPACTION_THREAD_CORE_COEFFICIENT = 1;
+// rows a memory index trains on when built from binlogs
+const int64_t DEFAULT_INDEX_TRAIN_SAMPLE_ROWS = 100000;
 
 const int64_t DEFAULT_INDEX_FILE_SLICE_SIZE = 4;  // megabytes
 
+// larger remote reads are split into ranged requests of this size
+const int64_t DEFAULT_REMOTE_READ_PART_SIZE = 4194304;  // bytes
+const int64_t DEFAULT_REMOTE_READ_PARALLEL_DEGREE = 8;
+
+// larger remote writes are uploaded as multipart uploads of this part size
+const int64_t DEFAULT_REMOTE_UPLOAD_PART_SIZE = 64;  // megabytes
+const int64_t DEFAULT_REMOTE_UPLOAD_PARALLEL_DEGREE = 8;
+
+// threads of a remote chunk manager serving all its async requests
+const int DEFAULT_REMOTE_ASYNC_THREAD_NUM = 16;
+
 const int DEFAULT_CPU_NUM = 1;
 
+const bool DEFAULT_LAZY_MMAP_POPULATE = false;
+
+// parquet codec and level of binlog payloads, by arrow codec name
+const char DEFAULT_VECTOR_PAYLOAD_COMPRESSION[] = "zstd";
+const int DEFAULT_VECTOR_PAYLOAD_COMPRESSION_LEVEL = 3;
+const char DEFAULT_SCALAR_PAYLOAD_COMPRESSION[] = "zstd";
+const int DEFAULT_SCALAR_PAYLOAD_COMPRESSION_LEVEL = 3;
+const bool DEFAULT_FLOAT_BYTE_STREAM_SPLIT = false;
+
+const bool DEFAULT_SEGMENT_ARENAS = true;
+
+const char DEFAULT_DISK_INDEX_WARM_UP[] = "none";
+const int64_t DEFAULT_DISK_INDEX_CACHE_BUDGET = 0;
+const int64_t DEFAULT_DISK_INDEX_LOCAL_CACHE_SIZE = 0;
+
+const bool DEFAULT_BINLOG_CHECKSUM = false;
+
+const bool DEFAULT_NUMA_PLACEMENT = false;
+
 constexpr const char* RADIUS = knowhere::meta::RADIUS;
 constexpr const char* RANGE_FILTER = knowhere::meta::RANGE_FILTER;
+// search param naming the id of a scalar field to group the hits by, only
+// the best hit of each of its values is kept
+const char GROUP_BY_FIELD[] = "group_by_field";
+// search param asking an index of a sealed segment for refine_factor times
+// the topk, ranked again exactly on the raw vectors if they are loaded too
+const char REFINE_FACTOR[] = "refine_factor";
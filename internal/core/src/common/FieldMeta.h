@@ -20,6 +20,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "common/SparseVector.h"
 #include "common/Types.h"
 #include "exceptions/EasyAssert.h"
 #include "utils/Status.h"
@@ -80,6 +81,8 @@ datatype_name(DataType data_type) {
         case DataType::VECTOR_BINARY: {
             return "vector_binary";
         }
+        case DataType::VECTOR_SPARSE_FLOAT:
+            return "vector_sparse_float";
         default: {
             auto err_msg =
                 "Unsupported DataType(" + std::to_string((int)data_type) + ")";
@@ -94,6 +97,12 @@ datatype_is_vector(DataType datatype) {
            datatype == DataType::VECTOR_FLOAT;
 }
 
+// sparse vectors are no vectors of a dim, is_vector() is false for them
+inline bool
+datatype_is_sparse_vector(DataType datatype) {
+    return datatype == DataType::VECTOR_SPARSE_FLOAT;
+}
+
 inline bool
 datatype_is_string(DataType datatype) {
     switch (datatype) {
@@ -152,7 +161,7 @@ class FieldMeta {
 
     FieldMeta(const FieldName& name, FieldId id, DataType type)
         : name_(name), id_(id), type_(type) {
-        Assert(!is_vector());
+        Assert(!is_vector() && !is_sparse_vector());
     }
 
     FieldMeta(const FieldName& name,
@@ -166,6 +175,7 @@ class FieldMeta {
         Assert(is_string());
     }
 
+    // the dim of a sparse vector field bounds its dimensions if above 0
     FieldMeta(const FieldName& name,
               FieldId id,
               DataType type,
@@ -175,7 +185,7 @@ class FieldMeta {
           id_(id),
           type_(type),
           vector_info_(VectorInfo{dim, metric_type}) {
-        Assert(is_vector());
+        Assert(is_vector() || is_sparse_vector());
     }
 
     bool
@@ -185,6 +195,11 @@ class FieldMeta {
                type_ == DataType::VECTOR_FLOAT;
     }
 
+    bool
+    is_sparse_vector() const {
+        return type_ == DataType::VECTOR_SPARSE_FLOAT;
+    }
+
     bool
     is_string() const {
         Assert(type_ != DataType::NONE);
@@ -193,7 +208,7 @@ class FieldMeta {
 
     int64_t
     get_dim() const {
-        Assert(is_vector());
+        Assert(is_vector() || is_sparse_vector());
         Assert(vector_info_.has_value());
         return vector_info_->dim_;
     }
@@ -207,7 +222,7 @@ class FieldMeta {
 
     std::optional<knowhere::MetricType>
     get_metric_type() const {
-        Assert(is_vector());
+        Assert(is_vector() || is_sparse_vector());
         Assert(vector_info_.has_value());
         return vector_info_->metric_type_;
     }
@@ -233,6 +248,9 @@ class FieldMeta {
             return datatype_sizeof(type_, get_dim());
         } else if (is_string()) {
             return string_info_->max_length;
+        } else if (is_sparse_vector()) {
+            // the rows in memory, their nonzeros are on the heap
+            return sizeof(SparseFloatRow);
         } else {
             return datatype_sizeof(type_);
         }
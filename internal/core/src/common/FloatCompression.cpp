@@ -0,0 +1,82 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "common/FloatCompression.h"
+
+#include <memory>
+
+#include "arrow/util/compression.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+namespace {
+
+// one shot compress and decompress keep no state, the codec is shared
+arrow::util::Codec&
+FloatCodec() {
+    static auto codec = [] {
+        auto codec = arrow::util::Codec::Create(arrow::Compression::ZSTD);
+        AssertInfo(codec.ok(), "zstd is not built in");
+        return std::move(codec).ValueOrDie();
+    }();
+    return *codec;
+}
+
+}  // namespace
+
+std::vector<char>
+CompressFloats(const float* values, int64_t n) {
+    auto bytes = n * int64_t(sizeof(float));
+    std::vector<uint8_t> streams(bytes);
+    auto input = reinterpret_cast<const uint8_t*>(values);
+    for (int64_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < sizeof(float); ++k) {
+            streams[k * n + i] = input[i * sizeof(float) + k];
+        }
+    }
+    auto& codec = FloatCodec();
+    std::vector<char> output(codec.MaxCompressedLen(bytes, streams.data()));
+    auto size = codec.Compress(bytes,
+                               streams.data(),
+                               output.size(),
+                               reinterpret_cast<uint8_t*>(output.data()));
+    AssertInfo(size.ok(),
+               "failed to compress floats: " + size.status().ToString());
+    output.resize(size.ValueOrDie());
+    output.shrink_to_fit();
+    return output;
+}
+
+void
+DecompressFloats(const char* data, int64_t size, int64_t n, float* dst) {
+    auto bytes = n * int64_t(sizeof(float));
+    std::vector<uint8_t> streams(bytes);
+    auto decompressed =
+        FloatCodec().Decompress(size,
+                              reinterpret_cast<const uint8_t*>(data),
+                              bytes,
+                              streams.data());
+    AssertInfo(decompressed.ok() && decompressed.ValueOrDie() == bytes,
+               "failed to decompress floats");
+    auto output = reinterpret_cast<uint8_t*>(dst);
+    for (int64_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < sizeof(float); ++k) {
+            output[i * sizeof(float) + k] = streams[k * n + i];
+        }
+    }
+}
+
+}  // namespace milvus
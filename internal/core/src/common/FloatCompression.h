@@ -0,0 +1,35 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace milvus {
+
+// lossless compression of floats for the data kept in memory: the bytes
+// of the values are split into a stream per byte position, which lines up
+// the sign and exponent bytes, then the streams are zstd compressed; an
+// entropy coder is what shrinks those streams, lz4 finds few matches
+// in them
+std::vector<char>
+CompressFloats(const float* values, int64_t n);
+
+// the n floats of a CompressFloats buffer into dst
+void
+DecompressFloats(const char* data, int64_t size, int64_t n, float* dst);
+
+}  // namespace milvus
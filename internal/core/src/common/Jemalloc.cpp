@@ -0,0 +1,122 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Jemalloc.h"
+
+#include <fmt/core.h>
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "common/Common.h"
+#include "exceptions/EasyAssert.h"
+#include "log/Log.h"
+
+// resolved only when jemalloc is linked in or preloaded
+extern "C" int
+mallctl(const char* name,
+        void* oldp,
+        size_t* oldlenp,
+        void* newp,
+        size_t newlen) __attribute__((weak));
+
+namespace milvus {
+
+namespace {
+
+std::mutex free_arenas_mutex;
+// arenas of released segments, purged
+std::vector<unsigned> free_arenas;
+
+unsigned
+AcquireArena() {
+    {
+        std::lock_guard lck(free_arenas_mutex);
+        if (!free_arenas.empty()) {
+            auto id = free_arenas.back();
+            free_arenas.pop_back();
+            return id;
+        }
+    }
+    unsigned id = 0;
+    size_t size = sizeof(id);
+    if (mallctl("arenas.create", &id, &size, nullptr, 0) != 0) {
+        LOG_SEGCORE_WARNING_LIMITED_(1) << "failed to create a jemalloc arena";
+        return 0;
+    }
+    return id;
+}
+
+void
+ReleaseArena(unsigned id) {
+    // frees of this thread sit in its cache until flushed
+    mallctl("thread.tcache.flush", nullptr, nullptr, nullptr, 0);
+    auto purge = fmt::format("arena.{}.purge", id);
+    if (mallctl(purge.c_str(), nullptr, nullptr, nullptr, 0) != 0) {
+        LOG_SEGCORE_WARNING_LIMITED_(1) << "failed to purge jemalloc arena " << id;
+    }
+    std::lock_guard lck(free_arenas_mutex);
+    free_arenas.push_back(id);
+}
+
+}  // namespace
+
+bool
+JemallocAvailable() {
+    return mallctl != nullptr;
+}
+
+SegmentArena::SegmentArena() {
+    if (JemallocAvailable() && segment_arenas) {
+        id_ = AcquireArena();
+    }
+}
+
+SegmentArena::~SegmentArena() {
+    if (id_ != 0) {
+        ReleaseArena(id_);
+    }
+}
+
+ArenaScope::ArenaScope(const SegmentArena& arena) {
+    if (arena.id() == 0) {
+        return;
+    }
+    auto id = arena.id();
+    size_t size = sizeof(previous_);
+    bound_ = mallctl("thread.arena", &previous_, &size, &id, sizeof(id)) == 0;
+}
+
+ArenaScope::~ArenaScope() {
+    if (bound_) {
+        mallctl("thread.arena", nullptr, nullptr, &previous_, sizeof(previous_));
+    }
+}
+
+void
+DumpHeapProfile(const std::string& path) {
+    AssertInfo(JemallocAvailable(), "jemalloc is not the allocator");
+    auto filename = path.c_str();
+    auto ret =
+        mallctl("prof.dump", nullptr, nullptr, &filename, sizeof(filename));
+    AssertInfo(ret == 0,
+               fmt::format("failed to dump the heap profile to {}, err: {}",
+                           path,
+                           ret));
+}
+
+}  // namespace milvus
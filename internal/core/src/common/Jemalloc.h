@@ -0,0 +1,73 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+namespace milvus {
+
+// controls of jemalloc when it is the allocator of the process, no-ops
+// otherwise
+bool
+JemallocAvailable();
+
+// an arena of its own for the data of a segment, so what the segment
+// frees can be purged together when it goes away instead of leaving
+// the shared arenas fragmented; released arenas are purged and reused,
+// jemalloc can't destroy one something else may still point into
+class SegmentArena {
+ public:
+    SegmentArena();
+
+    ~SegmentArena();
+
+    SegmentArena(const SegmentArena&) = delete;
+    SegmentArena&
+    operator=(const SegmentArena&) = delete;
+
+    // 0 if there is none, jemalloc's own first arena is never handed out
+    unsigned
+    id() const {
+        return id_;
+    }
+
+ private:
+    unsigned id_ = 0;
+};
+
+// allocations of the calling thread go to the arena while it lives
+class ArenaScope {
+ public:
+    explicit ArenaScope(const SegmentArena& arena);
+
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope&
+    operator=(const ArenaScope&) = delete;
+
+ private:
+    unsigned previous_ = 0;
+    bool bound_ = false;
+};
+
+// writes a heap profile to path, which needs jemalloc built with
+// --enable-prof and run with MALLOC_CONF=prof:true
+void
+DumpHeapProfile(const std::string& path);
+
+}  // namespace milvus
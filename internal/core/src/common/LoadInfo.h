@@ -18,6 +18,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "Types.h"
 #include "common/CDataType.h"
@@ -33,6 +34,23 @@ struct LoadFieldDataInfo {
     const char* mmap_dir_path{nullptr};
 };
 
+// the insert binlogs of a fixed width user field, in row order, segcore
+// reads and decodes them itself
+struct LoadFieldBinlogInfo {
+    int64_t field_id;
+    std::vector<std::string> binlog_paths;
+    int64_t row_count{-1};
+};
+
+// the parquet files of a bulk import, a column per user field named after
+// it; the rows get the row ids from row_id_begin on, in file order, and
+// are inserted at timestamp
+struct LoadParquetInfo {
+    std::vector<std::string> files;
+    int64_t row_id_begin = 0;
+    milvus::Timestamp timestamp = 0;
+};
+
 struct LoadDeletedRecordInfo {
     const void* timestamps = nullptr;
     const milvus::IdArray* primary_keys = nullptr;
@@ -0,0 +1,114 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/MemoryBudget.h"
+
+#include <fmt/core.h>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+void
+MemoryBudget::SetCapacity(int64_t capacity) {
+    {
+        std::lock_guard lck(mutex_);
+        capacity_ = capacity;
+    }
+    released_.notify_all();
+}
+
+int64_t
+MemoryBudget::Capacity() const {
+    std::lock_guard lck(mutex_);
+    return capacity_;
+}
+
+int64_t
+MemoryBudget::Used() const {
+    std::lock_guard lck(mutex_);
+    return used_;
+}
+
+bool
+MemoryBudget::TryReserve(int64_t bytes) {
+    std::lock_guard lck(mutex_);
+    if (!fits(bytes)) {
+        return false;
+    }
+    used_ += bytes;
+    return true;
+}
+
+bool
+MemoryBudget::Reserve(int64_t bytes, std::chrono::milliseconds wait) {
+    std::unique_lock lck(mutex_);
+    // more than the whole budget would wait for nothing
+    if (capacity_ > 0 && bytes > capacity_) {
+        return false;
+    }
+    if (!released_.wait_for(lck, wait, [&] { return fits(bytes); })) {
+        return false;
+    }
+    used_ += bytes;
+    return true;
+}
+
+void
+MemoryBudget::Release(int64_t bytes) {
+    {
+        std::lock_guard lck(mutex_);
+        used_ -= bytes;
+    }
+    released_.notify_all();
+}
+
+MemoryReservation
+MemoryBudget::Acquire(int64_t bytes,
+                      std::chrono::milliseconds wait,
+                      const std::string& what) {
+    if (!Reserve(bytes, wait)) {
+        PanicCodeInfo(
+            ErrorCodeEnum::OutOfMemory,
+            fmt::format("memory budget exhausted by {}: {} bytes wanted, "
+                        "{} of {} bytes in use",
+                        what,
+                        bytes,
+                        Used(),
+                        Capacity()));
+    }
+    return MemoryReservation(this, bytes);
+}
+
+MemoryBudget&
+LoadBudget() {
+    static MemoryBudget budget;
+    return budget;
+}
+
+MemoryBudget&
+ScratchBudget() {
+    static MemoryBudget budget;
+    return budget;
+}
+
+MemoryBudget&
+IndexFetchBudget() {
+    static MemoryBudget budget;
+    return budget;
+}
+
+}  // namespace milvus
@@ -0,0 +1,139 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace milvus {
+
+class MemoryReservation;
+
+// bytes a part of the process may hold at a time, 0 for no limit;
+// reservations past it fail, or wait for others to be released
+class MemoryBudget {
+ public:
+    void
+    SetCapacity(int64_t capacity);
+
+    int64_t
+    Capacity() const;
+
+    int64_t
+    Used() const;
+
+    bool
+    TryReserve(int64_t bytes);
+
+    // false if the bytes are not released by others within wait
+    bool
+    Reserve(int64_t bytes, std::chrono::milliseconds wait);
+
+    void
+    Release(int64_t bytes);
+
+    // reserves the bytes, waiting up to wait, or throws OutOfMemory
+    MemoryReservation
+    Acquire(int64_t bytes,
+            std::chrono::milliseconds wait,
+            const std::string& what);
+
+ private:
+    bool
+    fits(int64_t bytes) const {
+        return capacity_ <= 0 || used_ + bytes <= capacity_;
+    }
+
+ private:
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    int64_t capacity_ = 0;
+    int64_t used_ = 0;
+};
+
+// fields and indexes loaded into memory, which fail their load when it
+// is exhausted
+MemoryBudget&
+LoadBudget();
+
+// scratch of the requests in flight, bitsets and result buffers, which
+// queue for it when it is exhausted
+MemoryBudget&
+ScratchBudget();
+
+// index files downloaded for the loads in flight and not yet deserialized,
+// which queue for it when it is exhausted
+MemoryBudget&
+IndexFetchBudget();
+
+// bytes reserved from a budget, released when it goes away
+class MemoryReservation {
+ public:
+    MemoryReservation() = default;
+
+    MemoryReservation(MemoryBudget* budget, int64_t bytes)
+        : budget_(budget), bytes_(bytes) {
+    }
+
+    MemoryReservation(MemoryReservation&& other) noexcept
+        : budget_(other.budget_), bytes_(other.bytes_) {
+        other.budget_ = nullptr;
+        other.bytes_ = 0;
+    }
+
+    MemoryReservation&
+    operator=(MemoryReservation&& other) noexcept {
+        if (this != &other) {
+            reset();
+            std::swap(budget_, other.budget_);
+            std::swap(bytes_, other.bytes_);
+        }
+        return *this;
+    }
+
+    MemoryReservation(const MemoryReservation&) = delete;
+    MemoryReservation&
+    operator=(const MemoryReservation&) = delete;
+
+    ~MemoryReservation() {
+        reset();
+    }
+
+    int64_t
+    bytes() const {
+        return bytes_;
+    }
+
+    void
+    reset() {
+        if (budget_ != nullptr) {
+            budget_->Release(bytes_);
+        }
+        budget_ = nullptr;
+        bytes_ = 0;
+    }
+
+ private:
+    MemoryBudget* budget_ = nullptr;
+    int64_t bytes_ = 0;
+};
+
+}  // namespace milvus
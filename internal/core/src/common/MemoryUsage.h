@@ -0,0 +1,95 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "common/Types.h"
+
+namespace milvus {
+
+// heap bytes a value owns besides its sizeof, none for most types
+template <typename T>
+inline int64_t
+HeapBytes(const T&) {
+    return 0;
+}
+
+inline int64_t
+HeapBytes(const std::string& str) {
+    // short strings are kept inside the object
+    auto object = reinterpret_cast<const char*>(&str);
+    if (str.data() >= object && str.data() < object + sizeof(str)) {
+        return 0;
+    }
+    return str.capacity() + 1;
+}
+
+inline int64_t
+HeapBytes(const PkType& pk) {
+    if (auto str = std::get_if<std::string>(&pk)) {
+        return HeapBytes(*str);
+    }
+    return 0;
+}
+
+// the buffer of a vector, as allocated, and what its elements own
+template <typename T>
+inline int64_t
+HeapBytes(const std::vector<T>& vec) {
+    int64_t bytes = vec.capacity() * sizeof(T);
+    if constexpr (std::is_same_v<T, std::string> ||
+                  std::is_same_v<T, PkType>) {
+        for (auto& value : vec) {
+            bytes += HeapBytes(value);
+        }
+    }
+    return bytes;
+}
+
+// bytes held by the parts of a segment, by component name
+class MemoryUsage {
+ public:
+    void
+    Add(const std::string& component, int64_t bytes) {
+        components_[component] += bytes;
+    }
+
+    int64_t
+    Total() const {
+        int64_t total = 0;
+        for (auto& [component, bytes] : components_) {
+            total += bytes;
+        }
+        return total;
+    }
+
+    const std::map<std::string, int64_t>&
+    Components() const {
+        return components_;
+    }
+
+ private:
+    std::map<std::string, int64_t> components_;
+};
+
+}  // namespace milvus
@@ -0,0 +1,107 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Metrics.h"
+
+#include "nlohmann/json.hpp"
+
+namespace milvus::metrics {
+
+const char*
+CounterName(Counter counter) {
+    switch (counter) {
+        case Counter::SearchQueries:
+            return "segcore_search_queries_total";
+        case Counter::RetrieveRows:
+            return "segcore_retrieve_rows_total";
+        case Counter::InsertRows:
+            return "segcore_insert_rows_total";
+        case Counter::DeleteRows:
+            return "segcore_delete_rows_total";
+        case Counter::LoadRows:
+            return "segcore_load_rows_total";
+        case Counter::RemoteReadBytes:
+            return "segcore_remote_read_bytes_total";
+        case Counter::RemoteWriteBytes:
+            return "segcore_remote_write_bytes_total";
+        default:
+            return "segcore_unknown_total";
+    }
+}
+
+const char*
+HistogramName(Histogram histogram) {
+    switch (histogram) {
+        case Histogram::SearchLatency:
+            return "segcore_search_latency_us";
+        case Histogram::RetrieveLatency:
+            return "segcore_retrieve_latency_us";
+        case Histogram::InsertLatency:
+            return "segcore_insert_latency_us";
+        case Histogram::DeleteLatency:
+            return "segcore_delete_latency_us";
+        case Histogram::LoadLatency:
+            return "segcore_load_latency_us";
+        case Histogram::IndexBuildLatency:
+            return "segcore_index_build_latency_us";
+        case Histogram::RemoteReadLatency:
+            return "segcore_remote_read_latency_us";
+        case Histogram::RemoteWriteLatency:
+            return "segcore_remote_write_latency_us";
+        default:
+            return "segcore_unknown_latency_us";
+    }
+}
+
+Registry&
+Registry::GetInstance() {
+    // thread-safe enough after c++ 11
+    static Registry instance;
+    return instance;
+}
+
+std::string
+Registry::ToJson() const {
+    nlohmann::json counters = nlohmann::json::object();
+    for (int i = 0; i < int(Counter::Count); ++i) {
+        counters[CounterName(Counter(i))] = counters_[i].Value();
+    }
+    nlohmann::json histograms = nlohmann::json::object();
+    for (int i = 0; i < int(Histogram::Count); ++i) {
+        auto snapshot = histograms_[i].Collect();
+        nlohmann::json buckets = nlohmann::json::array();
+        int64_t cumulative = 0;
+        for (int b = 0; b < ShardedHistogram::kBuckets; ++b) {
+            if (snapshot.buckets_[b] == 0) {
+                continue;
+            }
+            cumulative += snapshot.buckets_[b];
+            buckets.push_back({ShardedHistogram::UpperBound(b), cumulative});
+        }
+        histograms[HistogramName(Histogram(i))] = {
+            {"count", snapshot.count_},
+            {"sum", snapshot.sum_},
+            {"buckets", std::move(buckets)},
+        };
+    }
+    nlohmann::json metrics = {
+        {"counters", std::move(counters)},
+        {"histograms", std::move(histograms)},
+    };
+    return metrics.dump();
+}
+
+}  // namespace milvus::metrics
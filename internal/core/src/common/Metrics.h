@@ -0,0 +1,245 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace milvus::metrics {
+
+enum class Counter : int {
+    SearchQueries = 0,
+    RetrieveRows,
+    InsertRows,
+    DeleteRows,
+    LoadRows,
+    RemoteReadBytes,
+    RemoteWriteBytes,
+    Count,
+};
+
+// latencies, in microseconds
+enum class Histogram : int {
+    SearchLatency = 0,
+    RetrieveLatency,
+    InsertLatency,
+    DeleteLatency,
+    LoadLatency,
+    IndexBuildLatency,
+    RemoteReadLatency,
+    RemoteWriteLatency,
+    Count,
+};
+
+const char*
+CounterName(Counter counter);
+
+const char*
+HistogramName(Histogram histogram);
+
+// writers only touch the shard of their thread, so they never contend on
+// a cache line, readers sum the shards
+constexpr int kMetricShards = 16;
+
+inline int
+ThisShard() {
+    static std::atomic<int> next_shard{0};
+    thread_local const int shard =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+class ShardedCounter {
+ public:
+    void
+    Add(int64_t value) {
+        shards_[ThisShard()].value_.fetch_add(value,
+                                              std::memory_order_relaxed);
+    }
+
+    int64_t
+    Value() const {
+        int64_t value = 0;
+        for (auto& shard : shards_) {
+            value += shard.value_.load(std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+ private:
+    struct alignas(64) Shard {
+        std::atomic<int64_t> value_{0};
+    };
+    Shard shards_[kMetricShards];
+};
+
+// log-linear buckets like HDR histograms: every power of two is split into
+// kSubBuckets, which bounds the error of a bucket to 1/kSubBuckets
+class ShardedHistogram {
+ public:
+    static constexpr int kSubBucketBits = 2;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    // values from 2^(kMaxExponent + 1) on, about 25 days in microseconds,
+    // fall into the last bucket
+    static constexpr int kMaxExponent = 40;
+    static constexpr int kBuckets =
+        (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    static int
+    BucketOf(int64_t value) {
+        if (value < kSubBuckets) {
+            return value < 0 ? 0 : int(value);
+        }
+        int exponent = 63 - __builtin_clzll(uint64_t(value));
+        if (exponent > kMaxExponent) {
+            return kBuckets - 1;
+        }
+        int sub = int(value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+        return (exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+    }
+
+    // the largest value falling into bucket
+    static int64_t
+    UpperBound(int bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        int shift = bucket / kSubBuckets - 1;
+        int64_t lower = int64_t(kSubBuckets + bucket % kSubBuckets) << shift;
+        return lower + (int64_t(1) << shift) - 1;
+    }
+
+    void
+    Observe(int64_t value) {
+        auto& shard = shards_[ThisShard()];
+        shard.buckets_[BucketOf(value)].fetch_add(1,
+                                                  std::memory_order_relaxed);
+        shard.sum_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    struct Snapshot {
+        int64_t count_ = 0;
+        int64_t sum_ = 0;
+        int64_t buckets_[kBuckets] = {};
+    };
+
+    Snapshot
+    Collect() const {
+        Snapshot snapshot;
+        for (auto& shard : shards_) {
+            snapshot.sum_ += shard.sum_.load(std::memory_order_relaxed);
+            for (int i = 0; i < kBuckets; ++i) {
+                auto count = shard.buckets_[i].load(std::memory_order_relaxed);
+                snapshot.buckets_[i] += count;
+                snapshot.count_ += count;
+            }
+        }
+        return snapshot;
+    }
+
+ private:
+    struct alignas(64) Shard {
+        std::atomic<int64_t> sum_{0};
+        std::atomic<int64_t> buckets_[kBuckets]{};
+    };
+    Shard shards_[kMetricShards];
+};
+
+class Registry {
+ public:
+    static Registry&
+    GetInstance();
+
+    ShardedCounter&
+    counter(Counter counter) {
+        return counters_[int(counter)];
+    }
+
+    ShardedHistogram&
+    histogram(Histogram histogram) {
+        return histograms_[int(histogram)];
+    }
+
+    // counters by name, and histograms by name as count, sum and the
+    // cumulative count of every non-empty bucket keyed by its upper bound,
+    // the way prometheus takes them
+    std::string
+    ToJson() const;
+
+ private:
+    Registry() = default;
+
+    ShardedCounter counters_[int(Counter::Count)];
+    ShardedHistogram histograms_[int(Histogram::Count)];
+};
+
+inline void
+Add(Counter counter, int64_t value) {
+    Registry::GetInstance().counter(counter).Add(value);
+}
+
+inline void
+Observe(Histogram histogram, int64_t micros) {
+    Registry::GetInstance().histogram(histogram).Observe(micros);
+}
+
+// observes the time it lives
+class LatencyTimer {
+ public:
+    explicit LatencyTimer(Histogram histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {
+    }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer&
+    operator=(const LatencyTimer&) = delete;
+
+    ~LatencyTimer() {
+        Observe(histogram_,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start_)
+                    .count());
+    }
+
+ private:
+    Histogram histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace milvus::metrics
+
+#define SEGCORE_METRIC_CONCAT_(a, b) a##b
+#define SEGCORE_METRIC_CONCAT(a, b) SEGCORE_METRIC_CONCAT_(a, b)
+
+// built with MILVUS_DISABLE_METRICS the hot paths carry no metrics at all,
+// not even the evaluation of the arguments
+#ifdef MILVUS_DISABLE_METRICS
+#define SEGCORE_METRIC_ADD(counter, value) static_cast<void>(0)
+#define SEGCORE_METRIC_OBSERVE(histogram, micros) static_cast<void>(0)
+#define SEGCORE_METRIC_TIMER(histogram) static_cast<void>(0)
+#else
+#define SEGCORE_METRIC_ADD(counter, value) \
+    milvus::metrics::Add(milvus::metrics::Counter::counter, (value))
+#define SEGCORE_METRIC_OBSERVE(histogram, micros) \
+    milvus::metrics::Observe(milvus::metrics::Histogram::histogram, (micros))
+#define SEGCORE_METRIC_TIMER(histogram)                                \
+    milvus::metrics::LatencyTimer SEGCORE_METRIC_CONCAT(metric_timer_, \
+                                                        __LINE__)(     \
+        milvus::metrics::Histogram::histogram)
+#endif
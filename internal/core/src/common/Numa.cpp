@@ -0,0 +1,151 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Numa.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "common/Common.h"
+#include "log/Log.h"
+
+namespace milvus {
+
+namespace {
+
+// from linux/mempolicy.h, which is not always installed
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr unsigned MPOL_MF_MOVE_FLAG = 1 << 1;
+
+const char NODE_ROOT[] = "/sys/devices/system/node/";
+
+thread_local int current_node = -1;
+
+std::string
+ReadLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+}  // namespace
+
+std::vector<int>
+ParseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range.find_first_of("0123456789") != 0) {
+            continue;
+        }
+        auto dash = range.find('-');
+        auto first = std::stoi(range.substr(0, dash));
+        auto last = dash == std::string::npos
+                        ? first
+                        : std::stoi(range.substr(dash + 1));
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+const std::vector<int>&
+NumaNodes() {
+    static const std::vector<int> nodes = [] {
+        auto nodes = ParseCpuList(ReadLine(std::string(NODE_ROOT) + "online"));
+        if (nodes.empty()) {
+            nodes.push_back(0);
+        }
+        return nodes;
+    }();
+    return nodes;
+}
+
+const std::vector<int>&
+NumaNodeCpus(int node) {
+    static const std::map<int, std::vector<int>> cpus = [] {
+        std::map<int, std::vector<int>> cpus;
+        for (auto node : NumaNodes()) {
+            cpus[node] = ParseCpuList(ReadLine(std::string(NODE_ROOT) + "node" +
+                                               std::to_string(node) +
+                                               "/cpulist"));
+        }
+        return cpus;
+    }();
+    static const std::vector<int> none;
+    auto it = cpus.find(node);
+    return it == cpus.end() ? none : it->second;
+}
+
+int
+SegmentNumaNode(int64_t segment_id) {
+    auto& nodes = NumaNodes();
+    if (!numa_placement || nodes.size() < 2) {
+        return -1;
+    }
+    auto index = static_cast<uint64_t>(segment_id) % nodes.size();
+    return nodes[index];
+}
+
+void
+NumaBind(void* addr, size_t len, int node) {
+    if (node < 0 || addr == nullptr || len == 0) {
+        return;
+    }
+    // mbind takes whole pages
+    auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    auto begin = reinterpret_cast<uintptr_t>(addr) & ~(page - 1);
+    auto end = reinterpret_cast<uintptr_t>(addr) + len;
+    constexpr int bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] |= 1UL << (node % bits);
+    auto ret = syscall(SYS_mbind,
+                       begin,
+                       end - begin,
+                       MPOL_PREFERRED_MODE,
+                       mask.data(),
+                       mask.size() * bits + 1,
+                       MPOL_MF_MOVE_FLAG);
+    if (ret != 0) {
+        LOG_SEGCORE_WARNING_ << "failed to bind " << end - begin
+                             << " bytes to numa node " << node << ": "
+                             << strerror(errno);
+    }
+}
+
+int
+CurrentNumaNode() {
+    return current_node;
+}
+
+NumaNodeScope::NumaNodeScope(int node) : prev_(current_node) {
+    current_node = node;
+}
+
+NumaNodeScope::~NumaNodeScope() {
+    current_node = prev_;
+}
+
+}  // namespace milvus
@@ -0,0 +1,69 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace milvus {
+
+// parses a sysfs list of cpus or nodes such as "0-3,8,10-11"
+std::vector<int>
+ParseCpuList(const std::string& list);
+
+// the online memory nodes, a single node 0 on a machine without NUMA
+const std::vector<int>&
+NumaNodes();
+
+// the cpus of node, empty if it is not known
+const std::vector<int>&
+NumaNodeCpus(int node);
+
+// the node whose memory and query threads serve a segment, spread by
+// its id; -1 with numa_placement off or a single node
+int
+SegmentNumaNode(int64_t segment_id);
+
+// prefers node for the pages of [addr, addr + len), moving the ones
+// already faulted in; other nodes are used once it is full. a hint only,
+// failures are logged. a no-op for node -1
+void
+NumaBind(void* addr, size_t len, int node);
+
+// the node whose query pool runs the helpers of the current thread,
+// -1 for the shared query pool
+int
+CurrentNumaNode();
+
+// sets CurrentNumaNode for its lifetime
+class NumaNodeScope {
+ public:
+    explicit NumaNodeScope(int node);
+
+    ~NumaNodeScope();
+
+    NumaNodeScope(const NumaNodeScope&) = delete;
+    NumaNodeScope&
+    operator=(const NumaNodeScope&) = delete;
+
+ private:
+    int prev_;
+};
+
+}  // namespace milvus
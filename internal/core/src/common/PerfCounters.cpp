@@ -0,0 +1,181 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/PerfCounters.h"
+
+#include <fmt/core.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "log/Log.h"
+
+namespace milvus {
+
+namespace {
+
+// the fields of PerfCounts in the order of the events
+uint64_t PerfCounts::*const kFields[PerfCounterGroup::kEvents] = {
+    &PerfCounts::cycles,
+    &PerfCounts::instructions,
+    &PerfCounts::cache_references,
+    &PerfCounts::cache_misses,
+    &PerfCounts::branches,
+    &PerfCounts::branch_misses,
+};
+
+#ifdef __linux__
+const uint64_t kConfigs[PerfCounterGroup::kEvents] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_REFERENCES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int
+OpenEvent(uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+}  // namespace
+
+PerfCounts&
+PerfCounts::operator+=(const PerfCounts& other) {
+    for (auto field : kFields) {
+        this->*field += other.*field;
+    }
+    return *this;
+}
+
+PerfCounts
+PerfCounts::operator-(const PerfCounts& other) const {
+    // the scaled counts of a multiplexed counter may step back a little
+    PerfCounts diff;
+    for (auto field : kFields) {
+        diff.*field = this->*field > other.*field ? this->*field - other.*field
+                                                  : 0;
+    }
+    return diff;
+}
+
+std::string
+PerfCounts::ToString() const {
+    return fmt::format(
+        "cycles {} instructions {} ipc {:.2f} cache_misses {}/{} "
+        "branch_misses {}/{}",
+        cycles,
+        instructions,
+        ipc(),
+        cache_misses,
+        cache_references,
+        branch_misses,
+        branches);
+}
+
+PerfCounterGroup::PerfCounterGroup() {
+    for (auto& fd : fds_) {
+        fd = -1;
+    }
+#ifdef __linux__
+    fds_[0] = OpenEvent(kConfigs[0]);
+    if (fds_[0] < 0) {
+        static std::atomic<bool> logged{false};
+        if (!logged.exchange(true)) {
+            LOG_SEGCORE_INFO_ << "no hardware counters: " << strerror(errno);
+        }
+        return;
+    }
+    // not a group: the kernel multiplexes counters the cpu has too few
+    // of, and one it lacks stays 0 while the others count on
+    for (int i = 1; i < kEvents; ++i) {
+        fds_[i] = OpenEvent(kConfigs[i]);
+    }
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#ifdef __linux__
+    for (auto fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+PerfCounts
+PerfCounterGroup::Read() const {
+    PerfCounts counts;
+#ifdef __linux__
+    if (!available()) {
+        return counts;
+    }
+    for (int i = 0; i < kEvents; ++i) {
+        // the value, the time enabled and the time running
+        uint64_t buf[3];
+        if (fds_[i] < 0 || read(fds_[i], buf, sizeof(buf)) != sizeof(buf) ||
+            buf[2] == 0) {
+            continue;
+        }
+        counts.*kFields[i] = uint64_t(double(buf[0]) * buf[1] / buf[2]);
+    }
+#endif
+    return counts;
+}
+
+const PerfCounterGroup&
+ThreadPerfCounters() {
+    thread_local PerfCounterGroup group;
+    return group;
+}
+
+ScopedPerfCounters::ScopedPerfCounters(PerfCounts* sum)
+    : sum_(sum), start_(ThreadPerfCounters().Read()) {
+}
+
+ScopedPerfCounters::ScopedPerfCounters(std::string name)
+    : name_(std::move(name)), start_(ThreadPerfCounters().Read()) {
+}
+
+ScopedPerfCounters::~ScopedPerfCounters() {
+    auto counts = ThreadPerfCounters().Read() - start_;
+    if (sum_ != nullptr) {
+        *sum_ += counts;
+    } else {
+        LOG_SEGCORE_INFO_ << name_ << ": " << counts.ToString();
+    }
+}
+
+}  // namespace milvus
@@ -0,0 +1,112 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace milvus {
+
+// hardware event counts of the calling thread, user space only
+struct PerfCounts {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_references = 0;
+    // of the last level cache
+    uint64_t cache_misses = 0;
+    uint64_t branches = 0;
+    uint64_t branch_misses = 0;
+
+    double
+    ipc() const {
+        return cycles == 0 ? 0 : double(instructions) / cycles;
+    }
+
+    // the lines the cache misses read, an estimate of the memory traffic:
+    // the traffic itself is counted by the uncore, for the whole socket
+    uint64_t
+    memory_bytes() const {
+        return cache_misses * 64;
+    }
+
+    PerfCounts&
+    operator+=(const PerfCounts& other);
+
+    PerfCounts
+    operator-(const PerfCounts& other) const;
+
+    std::string
+    ToString() const;
+};
+
+// the counters of the calling thread through perf_event_open, counting
+// from construction on. the kernel may refuse them, with
+// perf_event_paranoid above 2, in a container or off linux: then
+// available() is false and the counts stay 0. work handed to other
+// threads, as ParallelFor does, is not counted
+class PerfCounterGroup {
+ public:
+    PerfCounterGroup();
+
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup&
+    operator=(const PerfCounterGroup&) = delete;
+
+    bool
+    available() const {
+        return fds_[0] >= 0;
+    }
+
+    // the counts so far, scaled up for the time the kernel had them
+    // multiplexed out
+    PerfCounts
+    Read() const;
+
+    static constexpr int kEvents = 6;
+
+ private:
+    int fds_[kEvents];
+};
+
+// the group of the calling thread, opened on first use
+const PerfCounterGroup&
+ThreadPerfCounters();
+
+// counts its lifetime on the calling thread, for ad hoc profiling of a
+// hot path: adds the counts to *sum, or logs them under name. scopes may
+// nest
+class ScopedPerfCounters {
+ public:
+    explicit ScopedPerfCounters(PerfCounts* sum);
+
+    explicit ScopedPerfCounters(std::string name);
+
+    ~ScopedPerfCounters();
+
+    ScopedPerfCounters(const ScopedPerfCounters&) = delete;
+    ScopedPerfCounters&
+    operator=(const ScopedPerfCounters&) = delete;
+
+ private:
+    PerfCounts* sum_ = nullptr;
+    std::string name_;
+    PerfCounts start_;
+};
+
+}  // namespace milvus
@@ -0,0 +1,83 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/QueryInfo.h"
+
+#include "common/Consts.h"
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+namespace {
+
+SearchParamsPtr
+Parse(const SearchInfo& search_info) {
+    auto params = std::make_shared<SearchParams>();
+    auto& json = search_info.search_params_;
+    if (json.contains(RADIUS)) {
+        params->radius_ = json[RADIUS].get<float>();
+        if (json.contains(RANGE_FILTER)) {
+            params->range_filter_ = json[RANGE_FILTER].get<float>();
+        }
+    }
+    if (json.contains(REFINE_FACTOR)) {
+        params->refine_factor_ = json[REFINE_FACTOR].get<int64_t>();
+        AssertInfo(params->refine_factor_ >= 1,
+                   "refine_factor must be at least 1");
+    }
+    params->index_conf_ = json;
+    // grouping and refining are done by segcore, the indexes search plain
+    // topk
+    params->index_conf_.erase(GROUP_BY_FIELD);
+    params->index_conf_.erase(REFINE_FACTOR);
+    params->index_conf_[knowhere::meta::TOPK] = search_info.topk_;
+    params->index_conf_[knowhere::meta::METRIC_TYPE] =
+        search_info.metric_type_;
+    params->topk_ = search_info.topk_;
+    params->metric_type_ = search_info.metric_type_;
+    params->text_ = json.dump();
+    return params;
+}
+
+}  // namespace
+
+const knowhere::Json&
+SearchParams::IndexConf(int64_t topk,
+                        const MetricType& metric_type,
+                        knowhere::Json& scratch) const {
+    if (topk == topk_ && metric_type == metric_type_) {
+        return index_conf_;
+    }
+    scratch = index_conf_;
+    scratch[knowhere::meta::TOPK] = topk;
+    scratch[knowhere::meta::METRIC_TYPE] = metric_type;
+    return scratch;
+}
+
+SearchParamsPtr
+SearchInfo::GetParams() const {
+    if (params_ != nullptr) {
+        return params_;
+    }
+    return Parse(*this);
+}
+
+void
+ParseSearchParams(SearchInfo& search_info) {
+    search_info.params_ = Parse(search_info);
+}
+
+}  // namespace milvus
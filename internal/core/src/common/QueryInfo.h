@@ -17,18 +17,64 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 
 #include "common/Types.h"
 #include "knowhere/config.h"
 namespace milvus {
+
+class CancelToken;
+
+// the search params read on every segment and chunk searched, parsed once
+// per plan out of the json of the search
+struct SearchParams {
+    std::optional<float> radius_;
+    std::optional<float> range_filter_;
+    // the json with the topk and the metric type it was parsed for, as
+    // indexes hand it to knowhere
+    knowhere::Json index_conf_;
+    int64_t topk_ = 0;
+    MetricType metric_type_;
+    // from REFINE_FACTOR, 1 for none
+    int64_t refine_factor_ = 1;
+    // the json as text, the same for searches of the same params
+    std::string text_;
+
+    // index_conf_ if it was built for topk and metric_type, otherwise a
+    // copy of it for them in scratch
+    const knowhere::Json&
+    IndexConf(int64_t topk,
+              const MetricType& metric_type,
+              knowhere::Json& scratch) const;
+};
+
+using SearchParamsPtr = std::shared_ptr<const SearchParams>;
+
 struct SearchInfo {
     int64_t topk_;
     int64_t round_decimal_;
     FieldId field_id_;
     MetricType metric_type_;
     knowhere::Json search_params_;
+    // search_params_ parsed, shared by the copies of the info; parsed again
+    // by ParseSearchParams whenever search_params_ changes
+    SearchParamsPtr params_;
+    // from GROUP_BY_FIELD of search_params_: the topk are the best hits of
+    // topk different values of this field
+    std::optional<FieldId> group_by_field_id_;
+    // of the execution searching with this copy of the info, null for none
+    const CancelToken* cancel_token_ = nullptr;
+
+    // params_, parsed on the spot for an info built without them
+    SearchParamsPtr
+    GetParams() const;
 };
 
+// parses search_params_ of the info into its params_
+void
+ParseSearchParams(SearchInfo& search_info);
+
 using SearchInfoPtr = std::shared_ptr<SearchInfo>;
 
 }  // namespace milvus
@@ -0,0 +1,159 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+namespace milvus {
+
+// where the time of a search went, collected per segment when the plan
+// asks for it and merged with the reduce of the segments
+struct QueryProfile {
+    // an evaluated expression node, children before their parent
+    struct ExprNode {
+        std::string name_;
+        int64_t depth_ = 0;
+        int64_t nanos_ = 0;
+        // rows the node had to be exact on, and the ones it set
+        int64_t rows_ = 0;
+        int64_t matched_rows_ = 0;
+    };
+
+    std::vector<ExprNode> exprs_;
+    // nanoseconds per stage, summed over the segments
+    std::map<std::string, int64_t> stage_nanos_;
+
+    int64_t segments_ = 0;
+    int64_t active_rows_ = 0;
+    // rows the filters left to the vector search
+    int64_t filtered_rows_ = 0;
+    int64_t filter_cache_hits_ = 0;
+    // segments that reused the result of an identical search
+    int64_t search_cache_hits_ = 0;
+    int64_t delete_cache_hits_ = 0;
+    int64_t delete_cache_misses_ = 0;
+    // chunks the vector search ran on an index and by brute force
+    int64_t index_chunks_ = 0;
+    int64_t brute_force_chunks_ = 0;
+    // segments that brute forced the filtered rows instead
+    int64_t prefilter_segments_ = 0;
+    // queries searched again as their index search fell short of topk
+    int64_t widened_queries_ = 0;
+
+    // segments run the same expression tree, so their nodes are summed
+    // one by one
+    void
+    Merge(const QueryProfile& other) {
+        if (exprs_.empty()) {
+            exprs_ = other.exprs_;
+        } else if (exprs_.size() == other.exprs_.size()) {
+            for (size_t i = 0; i < exprs_.size(); ++i) {
+                exprs_[i].nanos_ += other.exprs_[i].nanos_;
+                exprs_[i].rows_ += other.exprs_[i].rows_;
+                exprs_[i].matched_rows_ += other.exprs_[i].matched_rows_;
+            }
+        } else {
+            exprs_.insert(
+                exprs_.end(), other.exprs_.begin(), other.exprs_.end());
+        }
+        for (auto& [stage, nanos] : other.stage_nanos_) {
+            stage_nanos_[stage] += nanos;
+        }
+        segments_ += other.segments_;
+        active_rows_ += other.active_rows_;
+        filtered_rows_ += other.filtered_rows_;
+        filter_cache_hits_ += other.filter_cache_hits_;
+        search_cache_hits_ += other.search_cache_hits_;
+        delete_cache_hits_ += other.delete_cache_hits_;
+        delete_cache_misses_ += other.delete_cache_misses_;
+        index_chunks_ += other.index_chunks_;
+        brute_force_chunks_ += other.brute_force_chunks_;
+        prefilter_segments_ += other.prefilter_segments_;
+        widened_queries_ += other.widened_queries_;
+    }
+
+    std::string
+    ToJson() const {
+        auto ratio = [](int64_t part, int64_t whole) {
+            return whole == 0 ? 0.0 : double(part) / double(whole);
+        };
+        nlohmann::json exprs = nlohmann::json::array();
+        for (auto& expr : exprs_) {
+            exprs.push_back({{"expr", expr.name_},
+                             {"depth", expr.depth_},
+                             {"nanos", expr.nanos_},
+                             {"rows", expr.rows_},
+                             {"matched_rows", expr.matched_rows_},
+                             {"selectivity",
+                              ratio(expr.matched_rows_, expr.rows_)}});
+        }
+        nlohmann::json profile = {
+            {"segments", segments_},
+            {"active_rows", active_rows_},
+            {"filtered_rows", filtered_rows_},
+            {"selectivity", ratio(filtered_rows_, active_rows_)},
+            {"filter_cache_hits", filter_cache_hits_},
+            {"search_cache_hits", search_cache_hits_},
+            {"delete_cache_hits", delete_cache_hits_},
+            {"delete_cache_misses", delete_cache_misses_},
+            {"index_chunks", index_chunks_},
+            {"brute_force_chunks", brute_force_chunks_},
+            {"prefilter_segments", prefilter_segments_},
+            {"widened_queries", widened_queries_},
+            {"stage_nanos", stage_nanos_},
+            {"exprs", std::move(exprs)},
+        };
+        return profile.dump();
+    }
+};
+
+// adds the time it lives to a stage of profile, if there is a profile
+class ProfileTimer {
+ public:
+    ProfileTimer(QueryProfile* profile, const char* stage)
+        : profile_(profile), stage_(stage) {
+        if (profile_ != nullptr) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ProfileTimer(const ProfileTimer&) = delete;
+    ProfileTimer&
+    operator=(const ProfileTimer&) = delete;
+
+    ~ProfileTimer() {
+        if (profile_ != nullptr) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            profile_->stage_nanos_[stage_] +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count();
+        }
+    }
+
+ private:
+    QueryProfile* profile_;
+    const char* stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace milvus
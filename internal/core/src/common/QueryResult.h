@@ -17,19 +17,29 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <map>
 #include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 #include <boost/align/aligned_allocator.hpp>
-#include <boost/dynamic_bitset.hpp>
 #include <NamedType/named_type.hpp>
 
 #include "common/FieldMeta.h"
+#include "common/QueryProfile.h"
 #include "pb/schema.pb.h"
 
 namespace milvus {
+// how a segment ran the vector search of a request
+enum class SearchStrategy {
+    // the index, or brute force where there is none, skipping the rows
+    // the filter drops
+    Index,
+    // brute force over the rows the filter leaves only
+    PreFilter,
+};
+
 struct SearchResult {
     SearchResult() = default;
 
@@ -64,8 +74,21 @@ struct SearchResult {
     // set output fields data when fill target entity
     std::map<FieldId, std::unique_ptr<milvus::DataArray>> output_fields_data_;
 
+    // the value of the group by field of each hit, ints and bools as
+    // int64_t; empty unless the search groups its hits
+    std::vector<PkType> group_by_values_;
+
     // used for reduce, filter invalid pk, get real topks count
     std::vector<size_t> topk_per_nq_prefix_sum_;
+
+    // query stats: the search strategy and the rows the filter left
+    SearchStrategy search_strategy_ = SearchStrategy::Index;
+    int64_t filtered_rows_ = 0;
+    // chunks the vector search ran on an index and by brute force
+    int64_t index_chunks_ = 0;
+    int64_t brute_force_chunks_ = 0;
+    // set if the plan asked for a profile
+    std::shared_ptr<QueryProfile> profile_;
 };
 
 using SearchResultPtr = std::shared_ptr<SearchResult>;
@@ -78,6 +101,8 @@ struct RetrieveResult {
     void* segment_;
     std::vector<int64_t> result_offsets_;
     std::vector<DataArray> field_data_;
+    // matching rows of an aggregating retrieve, unset if none matched
+    std::optional<BitsetType> matches_;
 };
 
 using RetrieveResultPtr = std::shared_ptr<RetrieveResult>;
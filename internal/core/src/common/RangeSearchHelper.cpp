@@ -9,16 +9,64 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
-#include <queue>
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <vector>
 #include "common/Utils.h"
-#include <functional>
-#include <iostream>
 
 namespace milvus {
 namespace {
 using ResultPair = std::pair<float, int64_t>;
+
+// a query keeps its topk in a bounded heap when it has more than this many
+// hits per kept one, otherwise it selects them out of a copy of all hits
+constexpr int64_t HEAP_SELECT_RATIO = 8;
+
+// cmp(a, b) is true if a ranks before b
+template <typename Cmp>
+void
+SortQueryResult(const int64_t* id,
+                const float* dist,
+                int64_t size,
+                int64_t capacity,
+                std::vector<ResultPair>& buffer,
+                int64_t* p_id,
+                float* p_dist,
+                Cmp cmp) {
+    buffer.clear();
+    if (capacity * HEAP_SELECT_RATIO < size) {
+        // the heap top is the worst of the kept hits
+        for (int64_t j = 0; j < capacity; j++) {
+            buffer.emplace_back(dist[j], id[j]);
+        }
+        std::make_heap(buffer.begin(), buffer.end(), cmp);
+        for (int64_t j = capacity; j < size; j++) {
+            auto current = ResultPair(dist[j], id[j]);
+            if (cmp(current, buffer.front())) {
+                std::pop_heap(buffer.begin(), buffer.end(), cmp);
+                buffer.back() = current;
+                std::push_heap(buffer.begin(), buffer.end(), cmp);
+            }
+        }
+        std::sort_heap(buffer.begin(), buffer.end(), cmp);
+    } else {
+        for (int64_t j = 0; j < size; j++) {
+            buffer.emplace_back(dist[j], id[j]);
+        }
+        auto kept = buffer.begin() + capacity;
+        if (kept != buffer.end()) {
+            std::nth_element(buffer.begin(), kept, buffer.end(), cmp);
+        }
+        std::sort(buffer.begin(), kept, cmp);
+    }
+    for (int64_t j = 0; j < capacity; j++) {
+        p_dist[j] = buffer[j].first;
+        p_id[j] = buffer[j].second;
+    }
 }
+}  // namespace
+
 DatasetPtr
 SortRangeSearchResult(DatasetPtr data_set,
                       int64_t topk,
@@ -48,55 +96,47 @@ SortRangeSearchResult(DatasetPtr data_set,
     auto dist = GetDatasetDistance(data_set);
 
     // use p_id and p_dist to GenResultDataset after sorted
-    auto p_id = new int64_t[topk * nq];
-    memset(p_id, -1, sizeof(int64_t) * topk * nq);
-    auto p_dist = new float[topk * nq];
-    std::fill_n(p_dist, topk * nq, std::numeric_limits<float>::max());
-
-    // cnt means the subscript of p_id and p_dist
-    int cnt = 0;
+    std::unique_ptr<int64_t[]> p_id(new int64_t[topk * nq]);
+    std::fill_n(p_id.get(), topk * nq, -1);
+    std::unique_ptr<float[]> p_dist(new float[topk * nq]);
+    std::fill_n(p_dist.get(), topk * nq, std::numeric_limits<float>::max());
 
-    for (int i = 0; i < nq; i++) {
+    /*
+     *   get result for one nq
+     *   IP:   1.0        range_filter     radius
+     *          |------------+---------------|       min_heap   descending_order
+     *   L2:   0.0        range_filter     radius
+     *          |------------+---------------|       max_heap   ascending_order
+     *
+     */
+    auto descending = IsMetricType(metric_type, knowhere::metric::IP);
+    std::vector<ResultPair> buffer;
+    for (int64_t i = 0; i < nq; i++) {
         // if RangeSearch answer size of one nq is less than topk, set the capacity to size
-        int size = lims[i + 1] - lims[i];
-        int capacity = topk > size ? size : topk;
-        /*
-         *   get result for one nq
-         *   IP:   1.0        range_filter     radius
-         *          |------------+---------------|       min_heap   descending_order
-         *   L2:   0.0        range_filter     radius
-         *          |------------+---------------|       max_heap   ascending_order
-         *
-         */
-        std::function<bool(const ResultPair&, const ResultPair&)> cmp =
-            std::less<std::pair<float, int64_t>>();
-        if (IsMetricType(metric_type, knowhere::metric::IP)) {
-            cmp = std::greater<std::pair<float, int64_t>>();
-        }
-        std::priority_queue<std::pair<float, int64_t>,
-                            std::vector<std::pair<float, int64_t>>,
-                            decltype(cmp)>
-            sub_result(cmp);
-
-        for (int j = lims[i]; j < lims[i + 1]; j++) {
-            auto current = ResultPair(dist[j], id[j]);
-            if (sub_result.size() == capacity) {
-                if (cmp(sub_result.top(), current)) {
-                    current = sub_result.top();
-                }
-                sub_result.pop();
-            }
-            sub_result.push(current);
-        }
-
-        for (int i = capacity + cnt - 1; i > cnt - 1; i--) {
-            p_dist[i] = sub_result.top().first;
-            p_id[i] = sub_result.top().second;
-            sub_result.pop();
+        int64_t size = lims[i + 1] - lims[i];
+        int64_t capacity = std::min(topk, size);
+        auto offset = i * topk;
+        if (descending) {
+            SortQueryResult(id + lims[i],
+                            dist + lims[i],
+                            size,
+                            capacity,
+                            buffer,
+                            p_id.get() + offset,
+                            p_dist.get() + offset,
+                            std::greater<ResultPair>());
+        } else {
+            SortQueryResult(id + lims[i],
+                            dist + lims[i],
+                            size,
+                            capacity,
+                            buffer,
+                            p_id.get() + offset,
+                            p_dist.get() + offset,
+                            std::less<ResultPair>());
         }
-        cnt += topk;
     }
-    return GenResultDataset(nq, topk, p_id, p_dist);
+    return GenResultDataset(nq, topk, p_id.release(), p_dist.release());
 }
 
 void
@@ -74,6 +74,16 @@ Schema::ParseFrom(const milvus::proto::schema::CollectionSchema& schema_proto) {
                 auto metric_type = index_map.at("metric_type");
                 schema->AddField(name, field_id, data_type, dim, metric_type);
             }
+        } else if (datatype_is_sparse_vector(data_type)) {
+            // sparse vectors are searched by inner product, a dim is
+            // optional
+            auto type_map = RepeatedKeyValToMap(child.type_params());
+            int64_t dim = 0;
+            if (type_map.count("dim")) {
+                dim = boost::lexical_cast<int64_t>(type_map.at("dim"));
+            }
+            schema->AddField(
+                name, field_id, data_type, dim, knowhere::metric::IP);
         } else if (datatype_is_string(data_type)) {
             auto type_map = RepeatedKeyValToMap(child.type_params());
             AssertInfo(type_map.count(MAX_LENGTH), "max_length not found");
@@ -89,6 +99,20 @@ Schema::ParseFrom(const milvus::proto::schema::CollectionSchema& schema_proto) {
                        "repetitive primary key");
             schema->set_primary_field_id(field_id);
         }
+
+        auto type_map = RepeatedKeyValToMap(child.type_params());
+        if (type_map.count(CLUSTERING_KEY) &&
+            type_map.at(CLUSTERING_KEY) == "true") {
+            AssertInfo(!schema->get_clustering_key_field_id().has_value(),
+                       "repetitive clustering key");
+            schema->set_clustering_key_field_id(field_id);
+        }
+        if (type_map.count(PARTITION_KEY) &&
+            type_map.at(PARTITION_KEY) == "true") {
+            AssertInfo(!schema->get_partition_key_field_id().has_value(),
+                       "repetitive partition key");
+            schema->set_partition_key_field_id(field_id);
+        }
     }
 
     AssertInfo(schema->get_primary_field_id().has_value(),
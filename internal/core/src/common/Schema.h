@@ -88,6 +88,28 @@ class Schema {
         this->primary_field_id_opt_ = field_id;
     }
 
+    // an int or varchar field; sealed segments built by segcore get their
+    // rows sorted by it, so range filters on it select contiguous rows
+    void
+    set_clustering_key_field_id(FieldId field_id) {
+        auto data_type = operator[](field_id).get_data_type();
+        AssertInfo(datatype_is_integer(data_type) ||
+                       datatype_is_string(data_type),
+                   "clustering key must be an int or a varchar field");
+        this->clustering_key_field_id_opt_ = field_id;
+    }
+
+    // an int64 or varchar field; segments track which of its values they
+    // hold, so filters on a key they lack skip them whole
+    void
+    set_partition_key_field_id(FieldId field_id) {
+        auto data_type = operator[](field_id).get_data_type();
+        AssertInfo(data_type == DataType::INT64 ||
+                       datatype_is_string(data_type),
+                   "partition key must be an int64 or a varchar field");
+        this->partition_key_field_id_opt_ = field_id;
+    }
+
     auto
     begin() const {
         return fields_.begin();
@@ -105,11 +127,30 @@ class Schema {
 
     const FieldMeta&
     operator[](FieldId field_id) const {
-        Assert(field_id.get() >= 0);
-        AssertInfo(fields_.find(field_id) != fields_.end(),
+        auto offset = get_field_offset(field_id);
+        AssertInfo(offset >= 0,
                    "Cannot find field with field_id: " +
                        std::to_string(field_id.get()));
-        return fields_.at(field_id);
+        return field_metas_[offset];
+    }
+
+    // the position of a field among the fields of the schema, in the order
+    // they were added, for per-field state kept in arrays; -1 if the
+    // schema has no such field
+    int64_t
+    get_field_offset(FieldId field_id) const {
+        auto slot = field_id.get() - START_USER_FIELDID;
+        if (slot >= 0 && slot < int64_t(dense_offsets_.size())) {
+            return dense_offsets_[slot];
+        }
+        auto iter = sparse_offsets_.find(field_id);
+        return iter == sparse_offsets_.end() ? -1 : iter->second;
+    }
+
+    // the field at an offset of get_field_offset
+    const FieldMeta&
+    get_field_meta(int64_t offset) const {
+        return field_metas_[offset];
     }
 
     auto
@@ -138,7 +179,7 @@ class Schema {
         auto id_iter = name_ids_.find(field_name);
         AssertInfo(id_iter != name_ids_.end(),
                    "Cannot find field with field_name: " + field_name.get());
-        return fields_.at(id_iter->second);
+        return field_metas_[get_field_offset(id_iter->second)];
     }
 
     std::optional<FieldId>
@@ -146,6 +187,16 @@ class Schema {
         return primary_field_id_opt_;
     }
 
+    std::optional<FieldId>
+    get_clustering_key_field_id() const {
+        return clustering_key_field_id_opt_;
+    }
+
+    std::optional<FieldId>
+    get_partition_key_field_id() const {
+        return partition_key_field_id_opt_;
+    }
+
  public:
     static std::shared_ptr<Schema>
     ParseFrom(const milvus::proto::schema::CollectionSchema& schema_proto);
@@ -159,7 +210,20 @@ class Schema {
         name_ids_.emplace(field_name, field_id);
         id_names_.emplace(field_id, field_name);
 
+        // ids of user fields are mostly consecutive from
+        // START_USER_FIELDID, those index a table, the others a map
+        int64_t offset = field_ids_.size();
+        auto slot = field_id.get() - START_USER_FIELDID;
+        if (slot >= 0 && slot < MAX_DENSE_FIELD_SLOTS) {
+            if (slot >= int64_t(dense_offsets_.size())) {
+                dense_offsets_.resize(slot + 1, -1);
+            }
+            dense_offsets_[slot] = offset;
+        } else {
+            sparse_offsets_.emplace(field_id, offset);
+        }
         fields_.emplace(field_id, field_meta);
+        field_metas_.push_back(field_meta);
         field_ids_.emplace_back(field_id);
 
         auto field_sizeof = field_meta.get_sizeof();
@@ -173,12 +237,20 @@ class Schema {
     // this is where data holds
     std::unordered_map<FieldId, FieldMeta> fields_;
 
+    // the fields in offset order, and the offsets of their ids
+    static constexpr int64_t MAX_DENSE_FIELD_SLOTS = 4096;
+    std::vector<FieldMeta> field_metas_;
+    std::vector<int64_t> dense_offsets_;
+    std::unordered_map<FieldId, int64_t> sparse_offsets_;
+
     // a mapping for random access
     std::unordered_map<FieldName, FieldId> name_ids_;  // field_name -> field_id
     std::unordered_map<FieldId, FieldName> id_names_;  // field_id -> field_name
 
     int64_t total_sizeof_ = 0;
     std::optional<FieldId> primary_field_id_opt_;
+    std::optional<FieldId> clustering_key_field_id_opt_;
+    std::optional<FieldId> partition_key_field_id_opt_;
 };
 
 using SchemaPtr = std::shared_ptr<Schema>;
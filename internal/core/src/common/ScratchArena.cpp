@@ -0,0 +1,91 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ScratchArena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace milvus {
+
+namespace {
+
+std::atomic<int64_t> scratch_arena_bytes = 4 * 1024 * 1024;
+
+// the buffer grows by whole pages at least
+constexpr size_t kGrowthBytes = 4096;
+
+}  // namespace
+
+void
+SetScratchArenaBytes(int64_t bytes) {
+    scratch_arena_bytes = bytes;
+}
+
+int64_t
+GetScratchArenaBytes() {
+    return scratch_arena_bytes;
+}
+
+ScratchArena&
+ScratchArena::Get() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+void*
+ScratchArena::Allocate(size_t bytes, size_t alignment) {
+    if (depth_ == 0) {
+        return nullptr;
+    }
+    auto begin = (used_ + alignment - 1) / alignment * alignment;
+    wanted_ = std::max(wanted_, begin) + bytes;
+    if (buffer_ == nullptr || begin + bytes > capacity_) {
+        return nullptr;
+    }
+    used_ = begin + bytes;
+    ++live_;
+    return buffer_.get() + begin;
+}
+
+void
+ScratchArena::Open() {
+    ++depth_;
+}
+
+void
+ScratchArena::Close() {
+    if (--depth_ > 0) {
+        return;
+    }
+    assert(live_ == 0);
+    // sized for the last request, within the limit
+    auto limit = size_t(std::max<int64_t>(scratch_arena_bytes, 0));
+    auto wanted = std::min(wanted_, limit);
+    if (wanted > capacity_ || limit < capacity_) {
+        buffer_.reset();
+        capacity_ = (wanted + kGrowthBytes - 1) / kGrowthBytes * kGrowthBytes;
+        capacity_ = std::min(capacity_, limit);
+        if (capacity_ > 0) {
+            buffer_.reset(new std::byte[capacity_]);
+        }
+    }
+    used_ = 0;
+    wanted_ = 0;
+}
+
+}  // namespace milvus
@@ -0,0 +1,158 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace milvus {
+
+// the most bytes the scratch arena of a thread keeps between requests, 0
+// sends every scratch buffer to the heap
+void
+SetScratchArenaBytes(int64_t bytes);
+
+int64_t
+GetScratchArenaBytes();
+
+// bump allocator of the calling thread for the buffers a request drops
+// before it returns: bitset blocks of a chunk, merge buffers and the like.
+// it hands out memory only while a ScratchScope is open on the thread and
+// takes all of it back when the outermost one closes, to grow to what the
+// request asked for; a thread serving requests of a steady size allocates
+// nothing from the heap for them
+class ScratchArena {
+ public:
+    // the arena of the calling thread
+    static ScratchArena&
+    Get();
+
+    // nullptr outside a scope or past the end of the buffer
+    void*
+    Allocate(size_t bytes, size_t alignment);
+
+    void
+    Deallocate(void* ptr) {
+        --live_;
+    }
+
+    bool
+    Owns(const void* ptr) const {
+        auto p = static_cast<const std::byte*>(ptr);
+        return p >= buffer_.get() && p < buffer_.get() + capacity_;
+    }
+
+    size_t
+    capacity() const {
+        return capacity_;
+    }
+
+    // bytes handed out since the outermost scope opened
+    size_t
+    used() const {
+        return used_;
+    }
+
+ private:
+    friend class ScratchScope;
+
+    void
+    Open();
+
+    void
+    Close();
+
+ private:
+    int depth_ = 0;
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    // bytes asked for in the scope, those the buffer could not hold too
+    size_t wanted_ = 0;
+    // buffers not released yet, none may outlive the scope
+    int64_t live_ = 0;
+};
+
+// a request, or a task of one, on the calling thread; scopes nest
+class ScratchScope {
+ public:
+    ScratchScope() : arena_(ScratchArena::Get()) {
+        arena_.Open();
+    }
+
+    ~ScratchScope() {
+        arena_.Close();
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope&
+    operator=(const ScratchScope&) = delete;
+
+ private:
+    ScratchArena& arena_;
+};
+
+// allocates from the arena of the calling thread, from the heap outside a
+// scope or when the arena is full. a buffer must be released on the thread
+// that allocated it, before the scope closes
+template <typename T>
+class ScratchAllocator {
+ public:
+    using value_type = T;
+
+    ScratchAllocator() = default;
+
+    template <typename U>
+    ScratchAllocator(const ScratchAllocator<U>&) {
+    }
+
+    T*
+    allocate(size_t n) {
+        auto ptr = ScratchArena::Get().Allocate(n * sizeof(T), alignof(T));
+        return ptr != nullptr ? static_cast<T*>(ptr)
+                              : std::allocator<T>().allocate(n);
+    }
+
+    void
+    deallocate(T* ptr, size_t n) {
+        auto& arena = ScratchArena::Get();
+        if (arena.Owns(ptr)) {
+            arena.Deallocate(ptr);
+        } else {
+            std::allocator<T>().deallocate(ptr, n);
+        }
+    }
+
+    template <typename U>
+    bool
+    operator==(const ScratchAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool
+    operator!=(const ScratchAllocator<U>&) const {
+        return false;
+    }
+};
+
+template <typename T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+}  // namespace milvus
@@ -16,6 +16,7 @@
 
 #include "common/Slice.h"
 #include "common/Common.h"
+#include "exceptions/EasyAssert.h"
 #include "log/Log.h"
 
 namespace milvus {
@@ -39,9 +40,9 @@ Slice(const std::string& prefix,
     int slice_num = 0;
     for (int64_t i = 0; i < data_src->size; ++slice_num) {
         int64_t ri = std::min(i + slice_len, data_src->size);
-        auto size = static_cast<size_t>(ri - i);
-        auto slice_i = std::shared_ptr<uint8_t[]>(new uint8_t[size]);
-        memcpy(slice_i.get(), data_src->data.get() + i, size);
+        // the slices share the buffer of the source binary
+        auto slice_i =
+            std::shared_ptr<uint8_t[]>(data_src->data, data_src->data.get() + i);
         binarySet.Append(
             prefix + "_" + std::to_string(slice_num), slice_i, ri - i);
         i = ri;
@@ -65,19 +66,75 @@ Assemble(BinarySet& binarySet) {
         std::string prefix = item[NAME];
         int slice_num = item[SLICE_NUM];
         auto total_len = static_cast<size_t>(item[TOTAL_LEN]);
-        auto p_data = std::shared_ptr<uint8_t[]>(new uint8_t[total_len]);
-        int64_t pos = 0;
+        std::vector<BinaryPtr> slices;
         for (auto i = 0; i < slice_num; ++i) {
-            auto slice_i_sp = binarySet.Erase(prefix + "_" + std::to_string(i));
-            memcpy(p_data.get() + pos,
-                   slice_i_sp->data.get(),
-                   static_cast<size_t>(slice_i_sp->size));
-            pos += slice_i_sp->size;
+            slices.push_back(
+                binarySet.Erase(prefix + "_" + std::to_string(i)));
+        }
+        // slices still laid out back to back in one buffer, as Slice leaves
+        // them or a loader reading one blob, are used in place
+        bool contiguous = true;
+        for (auto i = 1; i < slice_num && contiguous; ++i) {
+            contiguous = slices[i]->data.get() ==
+                         slices[i - 1]->data.get() + slices[i - 1]->size;
+        }
+        if (contiguous && slice_num > 0) {
+            binarySet.Append(prefix, slices[0]->data, total_len);
+            continue;
         }
+        auto p_data = std::shared_ptr<uint8_t[]>(new uint8_t[total_len]);
+        CopySlices(slices, p_data.get());
         binarySet.Append(prefix, p_data, total_len);
     }
 }
 
+std::vector<BinaryPtr>
+GetSlices(const BinarySet& binarySet, const std::string& name) {
+    auto binary = binarySet.GetByName(name);
+    if (binary != nullptr) {
+        return {binary};
+    }
+    auto slice_meta = binarySet.GetByName(INDEX_FILE_SLICE_META);
+    if (slice_meta == nullptr) {
+        return {};
+    }
+    Config meta_data = Config::parse(std::string(
+        reinterpret_cast<char*>(slice_meta->data.get()), slice_meta->size));
+    for (auto& item : meta_data[META]) {
+        if (item[NAME] != name) {
+            continue;
+        }
+        int slice_num = item[SLICE_NUM];
+        std::vector<BinaryPtr> slices;
+        for (auto i = 0; i < slice_num; ++i) {
+            auto slice_i = binarySet.GetByName(name + "_" + std::to_string(i));
+            AssertInfo(slice_i != nullptr,
+                       "missing slice " + std::to_string(i) + " of " + name);
+            slices.push_back(slice_i);
+        }
+        return slices;
+    }
+    return {};
+}
+
+int64_t
+SlicesSize(const std::vector<BinaryPtr>& slices) {
+    int64_t size = 0;
+    for (auto& slice : slices) {
+        size += slice->size;
+    }
+    return size;
+}
+
+void
+CopySlices(const std::vector<BinaryPtr>& slices, void* dst) {
+    auto pos = static_cast<uint8_t*>(dst);
+    for (auto& slice : slices) {
+        memcpy(pos, slice->data.get(), static_cast<size_t>(slice->size));
+        pos += slice->size;
+    }
+}
+
 void
 Disassemble(BinarySet& binarySet) {
     Config meta_info;
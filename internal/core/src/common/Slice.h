@@ -16,10 +16,15 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "common/Types.h"
 
 namespace milvus {
 
+// replaces the slices of every sliced binary with the whole binary,
+// copying only if the slices are not already back to back in memory
 void
 Assemble(BinarySet& binarySet);
 
@@ -32,4 +37,17 @@ AppendSliceMeta(BinarySet& binarySet, const Config& meta_info);
 BinaryPtr
 EraseSliceMeta(BinarySet& binarySet);
 
+// the binary named name as the list of its parts, in order: its slices if
+// Disassemble sliced it, itself if not, and empty if absent; read through
+// this instead of Assemble to skip materializing a whole copy
+std::vector<BinaryPtr>
+GetSlices(const BinarySet& binarySet, const std::string& name);
+
+int64_t
+SlicesSize(const std::vector<BinaryPtr>& slices);
+
+// dst must hold SlicesSize(slices) bytes
+void
+CopySlices(const std::vector<BinaryPtr>& slices, void* dst);
+
 }  // namespace milvus
@@ -17,9 +17,12 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
+#include "SparseVector.h"
 #include "Types.h"
 #include "VectorTrait.h"
 
@@ -33,6 +36,18 @@ class SpanBase {
         : data_(data), row_count_(row_count), element_sizeof_(element_sizeof) {
     }
 
+    // variable length rows, row i is [offsets[i], offsets[i + 1]) of data
+    // with offsets of offset_sizeof bytes
+    explicit SpanBase(const void* data,
+                      const void* offsets,
+                      int64_t row_count,
+                      int64_t offset_sizeof)
+        : data_(data),
+          offsets_(offsets),
+          row_count_(row_count),
+          element_sizeof_(offset_sizeof) {
+    }
+
     int64_t
     row_count() const {
         return row_count_;
@@ -48,8 +63,29 @@ class SpanBase {
         return data_;
     }
 
+    // nullptr for fixed width rows
+    const void*
+    offsets() const {
+        return offsets_;
+    }
+
+    // rows [begin, begin + count)
+    SpanBase
+    slice(int64_t begin, int64_t count) const {
+        auto shift = begin * element_sizeof_;
+        if (offsets_ != nullptr) {
+            return SpanBase(data_,
+                            static_cast<const char*>(offsets_) + shift,
+                            count,
+                            element_sizeof_);
+        }
+        return SpanBase(
+            static_cast<const char*>(data_) + shift, count, element_sizeof_);
+    }
+
  private:
     const void* data_;
+    const void* offsets_ = nullptr;
     int64_t row_count_;
     int64_t element_sizeof_;
 };
@@ -59,9 +95,11 @@ class Span;
 
 // TODO: refine Span to support T=FloatVector
 template <typename T>
-class Span<
-    T,
-    typename std::enable_if_t<IsScalar<T> || std::is_same_v<T, PkType>>> {
+class Span<T,
+           typename std::enable_if_t<
+               (IsScalar<T> && !std::is_same_v<T, std::string_view>) ||
+               std::is_same_v<T, PkType> ||
+               std::is_same_v<T, SparseFloatRow>>> {
  public:
     using embedded_type = T;
     explicit Span(const T* data, int64_t row_count)
@@ -102,6 +140,92 @@ class Span<
     const int64_t row_count_;
 };
 
+// strings laid out back to back with an offset per row, 32 bits wide
+// unless the strings exceed 4GB; no string_view per row is stored
+template <>
+class Span<std::string_view> {
+ public:
+    using embedded_type = std::string_view;
+
+    // the rows from a position on, indexed like a const string_view*
+    class Rows {
+     public:
+        Rows(const char* data, const void* offsets, bool wide, int64_t begin)
+            : data_(data), offsets_(offsets), wide_(wide), begin_(begin) {
+        }
+
+        std::string_view
+        operator[](int64_t i) const {
+            auto row = begin_ + i;
+            if (wide_) {
+                auto offsets = static_cast<const uint64_t*>(offsets_) + row;
+                return std::string_view(data_ + offsets[0],
+                                        offsets[1] - offsets[0]);
+            }
+            auto offsets = static_cast<const uint32_t*>(offsets_) + row;
+            return std::string_view(data_ + offsets[0],
+                                    offsets[1] - offsets[0]);
+        }
+
+        Rows
+        operator+(int64_t n) const {
+            return Rows(data_, offsets_, wide_, begin_ + n);
+        }
+
+        // calls func(data, offsets) with the typed offsets of these rows,
+        // row i is [offsets[i], offsets[i + 1]) of data
+        template <typename Func>
+        void
+        VisitOffsets(Func&& func) const {
+            if (wide_) {
+                func(data_, static_cast<const uint64_t*>(offsets_) + begin_);
+            } else {
+                func(data_, static_cast<const uint32_t*>(offsets_) + begin_);
+            }
+        }
+
+     private:
+        const char* data_;
+        const void* offsets_;
+        bool wide_;
+        int64_t begin_;
+    };
+
+    explicit Span(const SpanBase& base)
+        : data_(static_cast<const char*>(base.data())),
+          offsets_(base.offsets()),
+          row_count_(base.row_count()),
+          offset_sizeof_(base.element_sizeof()) {
+        assert(offset_sizeof_ == sizeof(uint32_t) ||
+               offset_sizeof_ == sizeof(uint64_t));
+    }
+
+    operator SpanBase() const {
+        return SpanBase(data_, offsets_, row_count_, offset_sizeof_);
+    }
+
+    Rows
+    data() const {
+        return Rows(data_, offsets_, offset_sizeof_ == sizeof(uint64_t), 0);
+    }
+
+    std::string_view
+    operator[](int64_t offset) const {
+        return data()[offset];
+    }
+
+    int64_t
+    row_count() const {
+        return row_count_;
+    }
+
+ private:
+    const char* data_;
+    const void* offsets_;
+    const int64_t row_count_;
+    const int64_t offset_sizeof_;
+};
+
 template <typename VectorType>
 class Span<
     VectorType,
@@ -0,0 +1,186 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/SparseVector.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus {
+
+namespace {
+
+constexpr int64_t kPairBytes = sizeof(uint32_t) + sizeof(float);
+
+SparseFloatRow
+ParsePairs(const char* data, int64_t nnz, int64_t dim) {
+    std::vector<uint32_t> indices(nnz);
+    std::vector<float> values(nnz);
+    for (int64_t i = 0; i < nnz; ++i) {
+        std::memcpy(&indices[i], data + i * kPairBytes, sizeof(uint32_t));
+        std::memcpy(&values[i],
+                    data + i * kPairBytes + sizeof(uint32_t),
+                    sizeof(float));
+    }
+    return SparseFloatRow(std::move(indices), std::move(values), dim);
+}
+
+void
+AppendPairs(const uint32_t* indices,
+            const float* values,
+            int64_t nnz,
+            std::string& bytes) {
+    auto begin = bytes.size();
+    bytes.resize(begin + nnz * kPairBytes);
+    auto out = bytes.data() + begin;
+    for (int64_t i = 0; i < nnz; ++i) {
+        std::memcpy(out + i * kPairBytes, indices + i, sizeof(uint32_t));
+        std::memcpy(out + i * kPairBytes + sizeof(uint32_t),
+                    values + i,
+                    sizeof(float));
+    }
+}
+
+}  // namespace
+
+SparseFloatRow::SparseFloatRow(std::vector<uint32_t> indices,
+                               std::vector<float> values,
+                               int64_t dim) {
+    AssertInfo(indices.size() == values.size(),
+               "sparse row with unpaired dimensions and values");
+    auto nnz = indices.size();
+    if (!std::is_sorted(indices.begin(), indices.end())) {
+        std::vector<size_t> order(nnz);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](auto x, auto y) {
+            return indices[x] < indices[y];
+        });
+        indices_.reserve(nnz);
+        values_.reserve(nnz);
+        for (auto i : order) {
+            indices_.push_back(indices[i]);
+            values_.push_back(values[i]);
+        }
+    } else {
+        indices_ = std::move(indices);
+        values_ = std::move(values);
+    }
+    for (size_t i = 0; i < nnz; ++i) {
+        AssertInfo(i == 0 || indices_[i] != indices_[i - 1],
+                   fmt::format("sparse row repeats dimension {}",
+                               indices_[i]));
+        AssertInfo(dim <= 0 || indices_[i] < dim,
+                   fmt::format("sparse row dimension {} out of dim {}",
+                               indices_[i],
+                               dim));
+        AssertInfo(std::isfinite(values_[i]),
+                   "sparse row with a value not finite");
+    }
+}
+
+float
+SparseFloatRow::dot(const SparseFloatRow& other, bool* overlaps) const {
+    float sum = 0;
+    bool overlap = false;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < indices_.size() && j < other.indices_.size()) {
+        if (indices_[i] < other.indices_[j]) {
+            ++i;
+        } else if (indices_[i] > other.indices_[j]) {
+            ++j;
+        } else {
+            sum += values_[i++] * other.values_[j++];
+            overlap = true;
+        }
+    }
+    if (overlaps != nullptr) {
+        *overlaps = overlap;
+    }
+    return sum;
+}
+
+std::vector<SparseFloatRow>
+ParseSparseRows(const DataArray& data, int64_t count, int64_t dim) {
+    auto& bytes = data.vectors().binary_vector();
+    std::vector<SparseFloatRow> rows;
+    rows.reserve(count);
+    int64_t pos = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        uint32_t nnz;
+        AssertInfo(pos + int64_t(sizeof(nnz)) <= int64_t(bytes.size()),
+                   fmt::format("sparse rows end before row {}", i));
+        std::memcpy(&nnz, bytes.data() + pos, sizeof(nnz));
+        pos += sizeof(nnz);
+        AssertInfo(pos + nnz * kPairBytes <= int64_t(bytes.size()),
+                   fmt::format("sparse row {} is truncated", i));
+        rows.emplace_back(ParsePairs(bytes.data() + pos, nnz, dim));
+        pos += nnz * kPairBytes;
+    }
+    AssertInfo(pos == int64_t(bytes.size()),
+               fmt::format("sparse rows hold bytes past their {} rows", count));
+    return rows;
+}
+
+void
+AppendSparseRow(const uint32_t* indices,
+                const float* values,
+                int64_t nnz,
+                DataArray* data) {
+    auto bytes = data->mutable_vectors()->mutable_binary_vector();
+    uint32_t count = nnz;
+    bytes->append(reinterpret_cast<const char*>(&count), sizeof(count));
+    AppendPairs(indices, values, nnz, *bytes);
+}
+
+std::vector<int64_t>
+SparseRowStarts(const DataArray& data) {
+    auto& bytes = data.vectors().binary_vector();
+    std::vector<int64_t> starts{0};
+    int64_t pos = 0;
+    while (pos < int64_t(bytes.size())) {
+        uint32_t nnz;
+        AssertInfo(pos + int64_t(sizeof(nnz)) <= int64_t(bytes.size()),
+                   "sparse rows are truncated");
+        std::memcpy(&nnz, bytes.data() + pos, sizeof(nnz));
+        pos += sizeof(nnz) + nnz * kPairBytes;
+        starts.push_back(pos);
+    }
+    AssertInfo(pos == int64_t(bytes.size()), "sparse rows are truncated");
+    return starts;
+}
+
+SparseFloatRow
+ParseSparseQuery(const char* data, int64_t size, int64_t dim) {
+    AssertInfo(size % kPairBytes == 0,
+               fmt::format("sparse query of {} bytes", size));
+    return ParsePairs(data, size / kPairBytes, dim);
+}
+
+std::string
+SerializeSparseQuery(const SparseFloatRow& row) {
+    std::string bytes;
+    AppendPairs(row.indices(), row.values(), row.nnz(), bytes);
+    return bytes;
+}
+
+}  // namespace milvus
@@ -0,0 +1,105 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/MemoryUsage.h"
+#include "common/Types.h"
+
+namespace milvus {
+
+// a row of a sparse float vector field: its nonzero dimensions in
+// ascending order and their values
+class SparseFloatRow {
+ public:
+    SparseFloatRow() = default;
+
+    // sorts the dimensions, a repeated one is an error; dims above 0
+    // bound them
+    SparseFloatRow(std::vector<uint32_t> indices,
+                   std::vector<float> values,
+                   int64_t dim = 0);
+
+    int64_t
+    nnz() const {
+        return indices_.size();
+    }
+
+    const uint32_t*
+    indices() const {
+        return indices_.data();
+    }
+
+    const float*
+    values() const {
+        return values_.data();
+    }
+
+    // the inner product with other, false in overlaps if they share no
+    // dimension
+    float
+    dot(const SparseFloatRow& other, bool* overlaps = nullptr) const;
+
+    bool
+    operator==(const SparseFloatRow& other) const {
+        return indices_ == other.indices_ && values_ == other.values_;
+    }
+
+ private:
+    std::vector<uint32_t> indices_;
+    std::vector<float> values_;
+};
+
+inline int64_t
+HeapBytes(const SparseFloatRow& row) {
+    return row.nnz() * int64_t(sizeof(uint32_t) + sizeof(float));
+}
+
+// the rows of a sparse float vector field in a DataArray are its
+// vectors().binary_vector() bytes: per row a uint32 count of nonzeros,
+// then each as a uint32 dimension and a float value
+std::vector<SparseFloatRow>
+ParseSparseRows(const DataArray& data, int64_t count, int64_t dim);
+
+void
+AppendSparseRow(const uint32_t* indices,
+                const float* values,
+                int64_t nnz,
+                DataArray* data);
+
+inline void
+AppendSparseRow(const SparseFloatRow& row, DataArray* data) {
+    AppendSparseRow(row.indices(), row.values(), row.nnz(), data);
+}
+
+// where each of the rows of a DataArray of sparse rows starts in its
+// bytes, and where the last ends, so rows are copied without parsing
+std::vector<int64_t>
+SparseRowStarts(const DataArray& data);
+
+// a sparse query of a placeholder is its nonzeros, each a uint32
+// dimension and a float value, without the count
+SparseFloatRow
+ParseSparseQuery(const char* data, int64_t size, int64_t dim);
+
+std::string
+SerializeSparseQuery(const SparseFloatRow& row);
+
+}  // namespace milvus
@@ -26,10 +26,10 @@
 #include <tbb/concurrent_unordered_set.h>
 #include <boost/align/aligned_allocator.hpp>
 #include <boost/container/vector.hpp>
-#include <boost/dynamic_bitset.hpp>
 #include <NamedType/named_type.hpp>
 #include <variant>
 
+#include "common/Bitset.h"
 #include "nlohmann/json.hpp"
 #include "knowhere/comp/index_param.h"
 #include "knowhere/binaryset.h"
@@ -61,6 +61,8 @@ enum class DataType {
 
     VECTOR_BINARY = 100,
     VECTOR_FLOAT = 101,
+    // no value of schema.proto, the same in segcore and its callers
+    VECTOR_SPARSE_FLOAT = 104,
 };
 
 using Timestamp = uint64_t;  // TODO: use TiKV-like timestamp
@@ -111,15 +113,15 @@ using FieldName = fluent::NamedType<std::string,
 using SegOffset =
     fluent::NamedType<int64_t, impl::SegOffsetTag, fluent::Arithmetic>;
 
-using BitsetType = boost::dynamic_bitset<>;
-using BitsetTypePtr = std::shared_ptr<boost::dynamic_bitset<>>;
+using BitsetType = Bitset;
+using BitsetTypePtr = std::shared_ptr<BitsetType>;
 using BitsetTypeOpt = std::optional<BitsetType>;
 
 template <typename Type>
 using FixedVector = boost::container::vector<Type>;
 
 using Config = nlohmann::json;
-using TargetBitmap = boost::dynamic_bitset<>;
+using TargetBitmap = Bitset;
 using TargetBitmapPtr = std::unique_ptr<TargetBitmap>;
 
 using BinaryPtr = knowhere::BinaryPtr;
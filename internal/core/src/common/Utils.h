@@ -16,13 +16,16 @@
 #include <google/protobuf/text_format.h>
 #include <sys/mman.h>
 
+#include <cmath>
 #include <filesystem>
 #include <string>
 #include <string_view>
 
+#include "common/Common.h"
 #include "common/Consts.h"
 #include "common/FieldMeta.h"
 #include "common/LoadInfo.h"
+#include "common/Numa.h"
 #include "config/ConfigChunkManager.h"
 #include "exceptions/EasyAssert.h"
 #include "knowhere/dataset.h"
@@ -129,9 +132,54 @@ IsMetricType(const std::string& str, const knowhere::MetricType& metric_type) {
     return !strcasecmp(str.c_str(), metric_type.c_str());
 }
 
+// a cosine field keeps its vectors at unit length, scaled once as they are
+// inserted or loaded, and its queries are scaled once per plan, so it is
+// searched by inner product by the kernels and indexes
+inline const knowhere::MetricType METRIC_COSINE = "COSINE";
+
+inline bool
+IsCosine(const knowhere::MetricType& metric_type) {
+    return IsMetricType(metric_type, METRIC_COSINE);
+}
+
+inline bool
+IsCosineField(const FieldMeta& field_meta) {
+    // only vector fields have a metric
+    if (field_meta.get_data_type() != DataType::VECTOR_FLOAT) {
+        return false;
+    }
+    auto metric_type = field_meta.get_metric_type();
+    return metric_type.has_value() && IsCosine(metric_type.value());
+}
+
+// the metric the kernels and indexes search by
+inline knowhere::MetricType
+SearchMetric(const knowhere::MetricType& metric_type) {
+    return IsCosine(metric_type) ? knowhere::metric::IP : metric_type;
+}
+
+// scales the rows to unit length, zero rows stay zero
+inline void
+NormalizeVectors(float* data, int64_t rows, int64_t dim) {
+    for (int64_t i = 0; i < rows; ++i) {
+        auto row = data + i * dim;
+        float norm = 0;
+        for (int64_t d = 0; d < dim; ++d) {
+            norm += row[d] * row[d];
+        }
+        if (norm > 0) {
+            auto scale = 1.0f / std::sqrt(norm);
+            for (int64_t d = 0; d < dim; ++d) {
+                row[d] *= scale;
+            }
+        }
+    }
+}
+
 inline bool
 PositivelyRelated(const knowhere::MetricType& metric_type) {
-    return IsMetricType(metric_type, knowhere::metric::IP);
+    return IsMetricType(metric_type, knowhere::metric::IP) ||
+           IsCosine(metric_type);
 }
 
 inline std::string
@@ -324,16 +372,22 @@ WriteFieldData(int fd, DataType data_type, const DataArray* data, size_t size) {
 
 // CreateMap creates a memory mapping,
 // if mmap enabled, this writes field data to disk and create a map to the file,
-// otherwise this just alloc memory
+// otherwise this just alloc memory.
+// With lazy_mmap_populate, the file mapping is not populated up front but
+// read ahead by the kernel in the background.
+// The pages are placed on the NUMA node of the segment, if it has one.
 inline void*
 CreateMap(int64_t segment_id,
           const FieldMeta& field_meta,
           const LoadFieldDataInfo& info) {
-    static int mmap_flags = MAP_PRIVATE;
+    int mmap_flags = MAP_PRIVATE;
 #ifdef MAP_POPULATE
     // macOS doesn't support MAP_POPULATE
-    mmap_flags |= MAP_POPULATE;
+    if (!lazy_mmap_populate) {
+        mmap_flags |= MAP_POPULATE;
+    }
 #endif
+    auto node = SegmentNumaNode(segment_id);
     // Allocate memory
     if (info.mmap_dir_path == nullptr) {
         auto data_type = field_meta.get_data_type();
@@ -342,16 +396,18 @@ CreateMap(int64_t segment_id,
         if (data_size == 0)
             return nullptr;
 
-        // Use anon mapping so we are able to free these memory with munmap only
+        // Use anon mapping so we are able to free these memory with munmap
+        // only, bound to a node it is faulted in by FillField on that node
         void* map = mmap(NULL,
                          data_size,
                          PROT_READ | PROT_WRITE,
-                         mmap_flags | MAP_ANON,
+                         (node < 0 ? mmap_flags : MAP_PRIVATE) | MAP_ANON,
                          -1,
                          0);
         AssertInfo(
             map != MAP_FAILED,
             fmt::format("failed to create anon map, err: {}", strerror(errno)));
+        NumaBind(map, data_size, node);
         FillField(data_type, data_size, info, map);
         return map;
     }
@@ -378,11 +434,7 @@ CreateMap(int64_t segment_id,
             written,
             size,
             strerror(errno)));
-    int ok = fsync(fd);
-    AssertInfo(ok == 0,
-               fmt::format("failed to fsync mmap data file {}, err: {}",
-                           filepath.c_str(),
-                           strerror(errno)));
+    // no fsync, the file is a scratch copy unlinked right after mapping
 
     // Empty field
     if (written == 0) {
@@ -395,18 +447,26 @@ CreateMap(int64_t segment_id,
                            filepath.c_str(),
                            strerror(errno)));
 
+    if (lazy_mmap_populate) {
+        // a hint only, the pages get read in on fault if it fails
+        madvise(map, written, MADV_WILLNEED);
+    } else {
 #ifndef MAP_POPULATE
-    // Manually access the mapping to populate it
-    const size_t PAGE_SIZE = 4 << 10;  // 4KiB
-    char* begin = (char*)map;
-    char* end = begin + written;
-    for (char* page = begin; page < end; page += PAGE_SIZE) {
-        char value = page[0];
-    }
+        // Manually access the mapping to populate it
+        const size_t PAGE_SIZE = 4 << 10;  // 4KiB
+        char* begin = (char*)map;
+        char* end = begin + written;
+        for (char* page = begin; page < end; page += PAGE_SIZE) {
+            char value = page[0];
+        }
 #endif
+    }
+    // moves the pages read so far, the rest are read in on the node of
+    // the thread faulting them
+    NumaBind(map, written, node);
     // unlink this data file so
     // then it will be auto removed after we don't need it again
-    ok = unlink(filepath.c_str());
+    int ok = unlink(filepath.c_str());
     AssertInfo(ok == 0,
                fmt::format("failed to unlink mmap data file {}, err: {}",
                            filepath.c_str(),
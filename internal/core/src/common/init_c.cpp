@@ -23,7 +23,9 @@
 #include "common/Slice.h"
 #include "common/Common.h"
 
-std::once_flag flag1, flag2, flag3, flag4;
+std::once_flag flag1, flag2, flag3, flag4, flag5, flag6, flag7, flag8, flag9,
+    flag10, flag11, flag12, flag13, flag14, flag15, flag16, flag17, flag18,
+    flag19;
 
 void
 InitLocalRootPath(const char* root_path) {
@@ -55,3 +57,129 @@ InitCpuNum(const int value) {
     std::call_once(
         flag4, [](int value) { milvus::SetCpuNum(value); }, value);
 }
+
+void
+InitLazyMmapPopulate(const bool value) {
+    std::call_once(
+        flag5, [](bool value) { milvus::SetLazyMmapPopulate(value); }, value);
+}
+
+void
+InitRemoteUploadPartSize(const int64_t size) {
+    std::call_once(
+        flag6,
+        [](int64_t size) { milvus::SetRemoteUploadPartSize(size); },
+        size);
+}
+
+void
+InitRemoteUploadParallelDegree(const int64_t value) {
+    std::call_once(
+        flag7,
+        [](int64_t value) { milvus::SetRemoteUploadParallelDegree(value); },
+        value);
+}
+
+void
+InitLocalDirectIO(const bool value) {
+    std::call_once(
+        flag8,
+        [](bool value) { milvus::ChunkMangerConfig::SetLocalDirectIO(value); },
+        value);
+}
+
+void
+InitVectorPayloadCompression(const char* codec, const int level) {
+    std::string codec_name(codec);
+    std::call_once(
+        flag9,
+        [](std::string codec, int level) {
+            milvus::SetVectorPayloadCompression(codec, level);
+        },
+        codec_name,
+        level);
+}
+
+void
+InitScalarPayloadCompression(const char* codec, const int level) {
+    std::string codec_name(codec);
+    std::call_once(
+        flag10,
+        [](std::string codec, int level) {
+            milvus::SetScalarPayloadCompression(codec, level);
+        },
+        codec_name,
+        level);
+}
+
+void
+InitFloatByteStreamSplit(const bool value) {
+    std::call_once(
+        flag11,
+        [](bool value) { milvus::SetFloatByteStreamSplit(value); },
+        value);
+}
+
+void
+InitQueryThreadCoreCoefficient(const int64_t value) {
+    std::call_once(
+        flag12,
+        [](int64_t value) { milvus::SetQueryThreadCoreCoefficient(value); },
+        value);
+}
+
+void
+InitBuildThreadCoreCoefficient(const int64_t value) {
+    std::call_once(
+        flag13,
+        [](int64_t value) { milvus::SetBuildThreadCoreCoefficient(value); },
+        value);
+}
+
+void
+InitCompactionThreadCoreCoefficient(const int64_t value) {
+    std::call_once(
+        flag14,
+        [](int64_t value) {
+            milvus::SetCompactionThreadCoreCoefficient(value);
+        },
+        value);
+}
+
+void
+InitSegmentArenas(const bool value) {
+    std::call_once(
+        flag15, [](bool value) { milvus::SetSegmentArenas(value); }, value);
+}
+
+void
+InitDiskIndexWarmUp(const char* strategy, const int64_t budget) {
+    std::string strategy_name(strategy);
+    std::call_once(
+        flag16,
+        [](std::string strategy, int64_t budget) {
+            milvus::SetDiskIndexWarmUp(strategy, budget);
+        },
+        strategy_name,
+        budget);
+}
+
+void
+InitDiskIndexLocalCacheSize(const int64_t size) {
+    std::call_once(
+        flag17,
+        [](int64_t size) { milvus::SetDiskIndexLocalCacheSize(size); },
+        size);
+}
+
+void
+InitBinlogChecksum(const bool value) {
+    std::call_once(
+        flag18, [](bool value) { milvus::SetBinlogChecksum(value); }, value);
+}
+
+void
+InitNumaPlacement(const bool value) {
+    std::call_once(
+        flag19, [](bool value) { milvus::SetNumaPlacement(value); }, value);
+}
@@ -29,12 +29,57 @@ InitIndexSliceSize(const int64_t);
 void
 InitThreadCoreCoefficient(const int64_t);
 
+void
+InitQueryThreadCoreCoefficient(const int64_t);
+
+void
+InitBuildThreadCoreCoefficient(const int64_t);
+
+void
+InitCompactionThreadCoreCoefficient(const int64_t);
+
 void
 InitCpuNum(const int);
 
 void
 InitLocalRootPath(const char*);
 
+void
+InitLocalDirectIO(const bool);
+
+void
+InitLazyMmapPopulate(const bool);
+
+void
+InitRemoteUploadPartSize(const int64_t);
+
+void
+InitRemoteUploadParallelDegree(const int64_t);
+
+void
+InitVectorPayloadCompression(const char*, const int);
+
+void
+InitScalarPayloadCompression(const char*, const int);
+
+void
+InitFloatByteStreamSplit(const bool);
+
+void
+InitSegmentArenas(const bool);
+
+void
+InitDiskIndexWarmUp(const char*, const int64_t);
+
+void
+InitDiskIndexLocalCacheSize(const int64_t);
+
+void
+InitBinlogChecksum(const bool);
+
+void
+InitNumaPlacement(const bool);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,45 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/CGoHelper.h"
+#include "common/Metrics.h"
+#include "common/metrics_c.h"
+
+CStatus
+GetSegcoreMetrics(CProto* metrics) {
+    try {
+        auto json = milvus::metrics::Registry::GetInstance().ToJson();
+        void* buffer = malloc(json.size());
+        memcpy(buffer, json.data(), json.size());
+        metrics->proto_blob = buffer;
+        metrics->proto_size = json.size();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        metrics->proto_blob = nullptr;
+        metrics->proto_size = 0;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+void
+DeleteSegcoreMetrics(CProto* metrics) {
+    std::free(const_cast<void*>(metrics->proto_blob));
+    metrics->proto_blob = nullptr;
+    metrics->proto_size = 0;
+}
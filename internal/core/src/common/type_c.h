@@ -35,6 +35,9 @@ enum ErrorCode {
     Success = 0,
     UnexpectedError = 1,
     IllegalArgument = 5,
+    OutOfMemory = 24,
+    // not in common.ErrorCode, a search or retrieve stopped by its plan
+    QueryCancelled = 2000,
 };
 
 // pure C don't support that we use schemapb.DataType directly.
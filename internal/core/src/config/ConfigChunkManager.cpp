@@ -19,6 +19,7 @@
 namespace milvus::ChunkMangerConfig {
 
 std::string LOCAL_ROOT_PATH = "/tmp/milvus";  // NOLINT
+bool LOCAL_DIRECT_IO = false;
 
 void
 SetLocalRootPath(const std::string& path_prefix) {
@@ -30,4 +31,14 @@ GetLocalRootPath() {
     return LOCAL_ROOT_PATH;
 }
 
+void
+SetLocalDirectIO(bool direct_io) {
+    LOCAL_DIRECT_IO = direct_io;
+}
+
+bool
+GetLocalDirectIO() {
+    return LOCAL_DIRECT_IO;
+}
+
 }  // namespace milvus::ChunkMangerConfig
@@ -26,4 +26,12 @@ SetLocalRootPath(const std::string& path_prefix);
 std::string
 GetLocalRootPath();
 
+// large sequential writes to local files, such as caching index files,
+// bypass the page cache with O_DIRECT
+void
+SetLocalDirectIO(bool direct_io);
+
+bool
+GetLocalDirectIO();
+
 }  // namespace milvus::ChunkMangerConfig
@@ -41,10 +41,12 @@ KnowhereInitImpl(const char* conf_file) {
         el::Configurations el_conf;
         el_conf.setGlobally(el::ConfigurationType::Enabled, "false");
         el::Loggers::reconfigureAllLoggers(el_conf);
+        RefreshLogLevels();
 #else
         if (conf_file != nullptr) {
             el::Configurations el_conf(conf_file);
             el::Loggers::reconfigureAllLoggers(el_conf);
+            RefreshLogLevels();
             LOG_SERVER_DEBUG_ << "Config easylogging with yaml file: "
                               << conf_file;
         }
@@ -0,0 +1,419 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Meta.h"
+#include "common/Slice.h"
+#include "common/Utils.h"
+
+namespace milvus::index {
+
+// inserts value into the sorted distinct values unless it is there, false
+// if it is not and there is no room left
+template <typename T>
+inline bool
+InsertDistinct(std::vector<T>& distinct, const T& value) {
+    auto iter = std::lower_bound(distinct.begin(), distinct.end(), value);
+    if (iter != distinct.end() && *iter == value) {
+        return true;
+    }
+    if (distinct.size() == BITMAP_INDEX_MAX_VALUES) {
+        return false;
+    }
+    distinct.insert(iter, value);
+    return true;
+}
+
+template <typename T>
+inline bool
+FitsBitmapIndex(const size_t n, const T* values) {
+    std::vector<T> distinct;
+    for (size_t i = 0; i < n; ++i) {
+        if constexpr (std::is_floating_point_v<T>) {
+            // NaN has no place among sorted values
+            if (std::isnan(values[i])) {
+                return false;
+            }
+        }
+        if (!InsertDistinct(distinct, values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::Build(const size_t n, const T* values) {
+    if (n == 0) {
+        throw std::invalid_argument("BitmapIndex cannot build null values!");
+    }
+    values_.clear();
+    for (size_t i = 0; i < n; ++i) {
+        AssertInfo(InsertDistinct(values_, values[i]),
+                   "too many distinct values for a bitmap index");
+    }
+    codes_ = std::shared_ptr<uint8_t[]>(new uint8_t[n]);
+    for (size_t i = 0; i < n; ++i) {
+        codes_[i] =
+            std::lower_bound(values_.begin(), values_.end(), values[i]) -
+            values_.begin();
+    }
+    row_count_ = n;
+    BuildBitmaps();
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::BuildBitmaps() {
+    std::vector<size_t> counts(values_.size());
+    for (int64_t i = 0; i < row_count_; ++i) {
+        AssertInfo(codes_[i] < values_.size(), "bitmap index is corrupted");
+        ++counts[codes_[i]];
+    }
+    std::vector<std::vector<CompressedBitset::offset_type>> rows(
+        values_.size());
+    for (size_t code = 0; code < values_.size(); ++code) {
+        rows[code].reserve(counts[code]);
+    }
+    for (int64_t i = 0; i < row_count_; ++i) {
+        rows[codes_[i]].push_back(i);
+    }
+    bitmaps_.clear();
+    bitmaps_.reserve(values_.size());
+    for (auto& offsets : rows) {
+        bitmaps_.push_back(
+            CompressedBitset::from_offsets(row_count_, std::move(offsets)));
+    }
+}
+
+template <typename T>
+inline BinarySet
+BitmapIndex<T>::Serialize(const Config& config) {
+    AssertInfo(codes_ != nullptr, "index has not been built");
+
+    BitmapIndexHeader header{};
+    header.magic = BITMAP_INDEX_MAGIC;
+    header.version = BITMAP_INDEX_VERSION;
+    header.row_count = row_count_;
+    header.value_count = values_.size();
+    header.value_size = std::is_arithmetic_v<T> ? sizeof(T) : 0;
+
+    size_t meta_size = sizeof(header);
+    for (const auto& value : values_) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            meta_size += sizeof(T);
+        } else {
+            meta_size += sizeof(uint32_t) + value.size();
+        }
+    }
+    std::shared_ptr<uint8_t[]> meta(new uint8_t[meta_size]);
+    auto dst = meta.get();
+    memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+    for (const auto& value : values_) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            T v = value;
+            memcpy(dst, &v, sizeof(T));
+            dst += sizeof(T);
+        } else {
+            uint32_t length = value.size();
+            memcpy(dst, &length, sizeof(length));
+            memcpy(dst + sizeof(length), value.data(), length);
+            dst += sizeof(length) + length;
+        }
+    }
+
+    BinarySet res_set;
+    res_set.Append(BITMAP_INDEX_META, meta, meta_size);
+    res_set.Append(BITMAP_INDEX_CODES, codes_, row_count_);
+
+    milvus::Disassemble(res_set);
+
+    return res_set;
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::Load(const BinarySet& index_binary, const Config& config) {
+    milvus::Assemble(const_cast<BinarySet&>(index_binary));
+    auto meta = index_binary.GetByName(BITMAP_INDEX_META);
+    auto codes = index_binary.GetByName(BITMAP_INDEX_CODES);
+    AssertInfo(meta != nullptr && codes != nullptr, "not a bitmap index");
+
+    BitmapIndexHeader header;
+    AssertInfo(meta->size >= sizeof(header), "bitmap index is truncated");
+    memcpy(&header, meta->data.get(), sizeof(header));
+    AssertInfo(header.magic == BITMAP_INDEX_MAGIC, "not a bitmap index");
+    AssertInfo(header.version == BITMAP_INDEX_VERSION,
+               "unsupported bitmap index version " +
+                   std::to_string(header.version));
+    AssertInfo(header.value_size == (std::is_arithmetic_v<T> ? sizeof(T) : 0),
+               "bitmap index of another data type");
+    AssertInfo(header.value_count <= BITMAP_INDEX_MAX_VALUES &&
+                   codes->size == header.row_count,
+               "bitmap index is corrupted");
+
+    auto src = meta->data.get() + sizeof(header);
+    auto end = meta->data.get() + meta->size;
+    values_.clear();
+    values_.reserve(header.value_count);
+    for (uint32_t i = 0; i < header.value_count; ++i) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            AssertInfo(src + sizeof(T) <= end, "bitmap index is truncated");
+            T value;
+            memcpy(&value, src, sizeof(T));
+            values_.push_back(value);
+            src += sizeof(T);
+        } else {
+            uint32_t length;
+            AssertInfo(src + sizeof(length) <= end,
+                       "bitmap index is truncated");
+            memcpy(&length, src, sizeof(length));
+            src += sizeof(length);
+            AssertInfo(src + length <= end, "bitmap index is truncated");
+            values_.emplace_back(reinterpret_cast<const char*>(src), length);
+            src += length;
+        }
+    }
+
+    row_count_ = header.row_count;
+    codes_ = codes->data;
+    BuildBitmaps();
+}
+
+template <typename T>
+inline std::vector<uint32_t>
+BitmapIndex<T>::Codes(const size_t n, const T* values) const {
+    std::vector<uint32_t> codes;
+    for (size_t i = 0; i < n; ++i) {
+        auto iter =
+            std::lower_bound(values_.begin(), values_.end(), values[i]);
+        if (iter != values_.end() && *iter == values[i]) {
+            codes.push_back(iter - values_.begin());
+        }
+    }
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    return codes;
+}
+
+template <typename T>
+inline CompressedBitset
+BitmapIndex<T>::Union(const std::vector<uint32_t>& codes) const {
+    if (codes.size() * 2 > values_.size()) {
+        std::vector<uint32_t> others;
+        for (uint32_t code = 0, i = 0; code < values_.size(); ++code) {
+            if (i < codes.size() && codes[i] == code) {
+                ++i;
+            } else {
+                others.push_back(code);
+            }
+        }
+        auto result = Union(others);
+        result.flip();
+        return result;
+    }
+    if (codes.empty()) {
+        return CompressedBitset(row_count_);
+    }
+    if (codes.size() == 1) {
+        return bitmaps_[codes[0]];
+    }
+    TargetBitmap result(row_count_);
+    for (auto code : codes) {
+        bitmaps_[code].for_each_run([&result](auto begin, auto end) {
+            result.set(begin, end - begin, true);
+        });
+    }
+    return CompressedBitset::compress(std::move(result));
+}
+
+template <typename T>
+inline CompressedBitset
+BitmapIndex<T>::Union(std::pair<uint32_t, uint32_t> code_range) const {
+    std::vector<uint32_t> codes;
+    for (auto code = code_range.first; code < code_range.second; ++code) {
+        codes.push_back(code);
+    }
+    return Union(codes);
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+BitmapIndex<T>::In(const size_t n, const T* values) {
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    return std::make_unique<TargetBitmap>(
+        Union(Codes(n, values)).to_dense());
+}
+
+template <typename T>
+inline CompressedBitset
+BitmapIndex<T>::InCompressed(const size_t n, const T* values) {
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    return Union(Codes(n, values));
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+BitmapIndex<T>::NotIn(const size_t n, const T* values) {
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    auto result = Union(Codes(n, values));
+    result.flip();
+    return std::make_unique<TargetBitmap>(std::move(result).to_dense());
+}
+
+template <typename T>
+inline std::pair<uint32_t, uint32_t>
+BitmapIndex<T>::CodeRange(const T value, const OpType op) const {
+    uint32_t lb = std::lower_bound(values_.begin(), values_.end(), value) -
+                  values_.begin();
+    uint32_t ub = std::upper_bound(values_.begin(), values_.end(), value) -
+                  values_.begin();
+    uint32_t value_count = values_.size();
+    switch (op) {
+        case OpType::LessThan:
+            return {0, lb};
+        case OpType::LessEqual:
+            return {0, ub};
+        case OpType::GreaterThan:
+            return {ub, value_count};
+        case OpType::GreaterEqual:
+            return {lb, value_count};
+        default:
+            throw std::invalid_argument(std::string("Invalid OperatorType: ") +
+                                        std::to_string((int)op) + "!");
+    }
+}
+
+template <typename T>
+inline std::pair<uint32_t, uint32_t>
+BitmapIndex<T>::CodeRange(T lower_bound_value,
+                          bool lb_inclusive,
+                          T upper_bound_value,
+                          bool ub_inclusive) const {
+    if (lower_bound_value > upper_bound_value ||
+        (lower_bound_value == upper_bound_value &&
+         !(lb_inclusive && ub_inclusive))) {
+        return {0, 0};
+    }
+    auto lb = lb_inclusive ? CodeRange(lower_bound_value, OpType::GreaterEqual)
+                           : CodeRange(lower_bound_value, OpType::GreaterThan);
+    auto ub = ub_inclusive ? CodeRange(upper_bound_value, OpType::LessEqual)
+                           : CodeRange(upper_bound_value, OpType::LessThan);
+    return {lb.first, std::max(lb.first, ub.second)};
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+BitmapIndex<T>::Range(const T value, const OpType op) {
+    return std::make_unique<TargetBitmap>(
+        RangeCompressed(value, op).to_dense());
+}
+
+template <typename T>
+inline CompressedBitset
+BitmapIndex<T>::RangeCompressed(const T value, const OpType op) {
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    return Union(CodeRange(value, op));
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+BitmapIndex<T>::Range(T lower_bound_value,
+                      bool lb_inclusive,
+                      T upper_bound_value,
+                      bool ub_inclusive) {
+    return std::make_unique<TargetBitmap>(
+        RangeCompressed(
+            lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive)
+            .to_dense());
+}
+
+template <typename T>
+inline CompressedBitset
+BitmapIndex<T>::RangeCompressed(T lower_bound_value,
+                                bool lb_inclusive,
+                                T upper_bound_value,
+                                bool ub_inclusive) {
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    return Union(CodeRange(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive));
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+BitmapIndex<T>::Query(const DatasetPtr& dataset) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        auto op = dataset->Get<OpType>(OPERATOR_TYPE);
+        if (op == OpType::PrefixMatch) {
+            AssertInfo(codes_ != nullptr, "index has not been built");
+            auto prefix = dataset->Get<std::string>(PREFIX_VALUE);
+            auto begin =
+                std::lower_bound(values_.begin(), values_.end(), prefix);
+            auto end = std::partition_point(
+                begin, values_.end(), [&prefix](const std::string& value) {
+                    return milvus::PrefixMatch(value, prefix);
+                });
+            std::pair<uint32_t, uint32_t> code_range(
+                begin - values_.begin(), end - values_.begin());
+            return std::make_unique<TargetBitmap>(
+                Union(code_range).to_dense());
+        }
+    }
+    return ScalarIndex<T>::Query(dataset);
+}
+
+template <typename T>
+inline T
+BitmapIndex<T>::Reverse_Lookup(size_t offset) const {
+    AssertInfo(offset < row_count_, "out of range of total count");
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    return values_[codes_[offset]];
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::ReverseLookupRange(size_t begin, size_t end, T* out) const {
+    AssertInfo(begin <= end && end <= row_count_,
+               "out of range of total count");
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    for (auto offset = begin; offset < end; ++offset) {
+        *out++ = values_[codes_[offset]];
+    }
+}
+
+template <typename T>
+inline void
+BitmapIndex<T>::ReverseLookupBatch(const int64_t* offsets,
+                                   size_t count,
+                                   T* out) const {
+    AssertInfo(codes_ != nullptr, "index has not been built");
+    for (size_t i = 0; i < count; ++i) {
+        AssertInfo(offsets[i] >= 0 && offsets[i] < row_count_,
+                   "out of range of total count");
+        out[i] = values_[codes_[offsets[i]]];
+    }
+}
+
+}  // namespace milvus::index
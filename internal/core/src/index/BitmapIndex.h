@@ -0,0 +1,195 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/CompressedBitset.h"
+#include "common/MemoryUsage.h"
+#include "index/ScalarIndex.h"
+
+namespace milvus::index {
+
+// Index of a field with few distinct values: the sorted distinct values,
+// the code of each row's value, and per value the compressed bitmap of its
+// rows. In, NotIn and Range union the bitmaps of the matched values and
+// never look at single rows. Serialized as two binaries:
+//
+//   BITMAP_INDEX_META   BitmapIndexHeader, then the values; raw for
+//                       arithmetic types, for strings uint32_t lengths
+//                       followed by the bytes
+//   BITMAP_INDEX_CODES  the uint8_t code of each row
+//
+// The bitmaps are rebuilt from the codes at load, in one pass.
+constexpr const char* BITMAP_INDEX_META = "bitmap_index_meta";
+constexpr const char* BITMAP_INDEX_CODES = "bitmap_index_codes";
+constexpr uint32_t BITMAP_INDEX_MAGIC = 0x58444942;  // "BIDX"
+constexpr uint32_t BITMAP_INDEX_VERSION = 1;
+// distinct values a code holds
+constexpr size_t BITMAP_INDEX_MAX_VALUES = 256;
+
+struct BitmapIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t row_count;
+    uint32_t value_count;
+    uint32_t value_size;
+};
+
+// true if the values have at most BITMAP_INDEX_MAX_VALUES distinct ones,
+// stops at the first value past that
+template <typename T>
+bool
+FitsBitmapIndex(size_t n, const T* values);
+
+template <typename T>
+class BitmapIndex : public ScalarIndex<T> {
+ public:
+    BitmapIndex() = default;
+
+    BinarySet
+    Serialize(const Config& config) override;
+
+    void
+    Load(const BinarySet& index_binary, const Config& config = {}) override;
+
+    int64_t
+    Count() override {
+        return row_count_;
+    }
+
+    int64_t
+    MemoryUsage() const override {
+        int64_t bytes = HeapBytes(values_) + (codes_ ? row_count_ : 0) +
+                        bitmaps_.capacity() * sizeof(CompressedBitset);
+        for (auto& bitmap : bitmaps_) {
+            bytes += bitmap.memory_usage();
+        }
+        return bytes;
+    }
+
+    // the values must fit, see FitsBitmapIndex
+    void
+    Build(size_t n, const T* values) override;
+
+    const TargetBitmapPtr
+    In(size_t n, const T* values) override;
+
+    CompressedBitset
+    InCompressed(size_t n, const T* values) override;
+
+    const TargetBitmapPtr
+    NotIn(size_t n, const T* values) override;
+
+    const TargetBitmapPtr
+    Range(T value, OpType op) override;
+
+    const TargetBitmapPtr
+    Range(T lower_bound_value,
+          bool lb_inclusive,
+          T upper_bound_value,
+          bool ub_inclusive) override;
+
+    CompressedBitset
+    RangeCompressed(T value, OpType op) override;
+
+    CompressedBitset
+    RangeCompressed(T lower_bound_value,
+                    bool lb_inclusive,
+                    T upper_bound_value,
+                    bool ub_inclusive) override;
+
+    // also answers PrefixMatch for strings, the matched values are a
+    // range of the sorted ones
+    const TargetBitmapPtr
+    Query(const DatasetPtr& dataset) override;
+
+    T
+    Reverse_Lookup(size_t offset) const override;
+
+    void
+    ReverseLookupRange(size_t begin, size_t end, T* out) const override;
+
+    void
+    ReverseLookupBatch(const int64_t* offsets,
+                       size_t count,
+                       T* out) const override;
+
+    int64_t
+    Size() override {
+        return row_count_;
+    }
+
+ public:
+    const std::vector<T>&
+    GetValues() const {
+        return values_;
+    }
+
+ private:
+    // the codes of the distinct values among values
+    std::vector<uint32_t>
+    Codes(size_t n, const T* values) const;
+
+    // [begin, end) codes of the values in the range
+    std::pair<uint32_t, uint32_t>
+    CodeRange(T value, OpType op) const;
+
+    std::pair<uint32_t, uint32_t>
+    CodeRange(T lower_bound_value,
+              bool lb_inclusive,
+              T upper_bound_value,
+              bool ub_inclusive) const;
+
+    // rows of any of the codes, sorted and unique; when they are most of
+    // the values, the complement of the other codes' rows
+    CompressedBitset
+    Union(const std::vector<uint32_t>& codes) const;
+
+    CompressedBitset
+    Union(std::pair<uint32_t, uint32_t> code_range) const;
+
+    void
+    BuildBitmaps();
+
+ private:
+    int64_t row_count_ = 0;
+    std::vector<T> values_;
+    // shared with the serialized binary
+    std::shared_ptr<uint8_t[]> codes_;
+    std::vector<CompressedBitset> bitmaps_;
+};
+
+template <typename T>
+using BitmapIndexPtr = std::unique_ptr<BitmapIndex<T>>;
+
+}  // namespace milvus::index
+
+#include "index/BitmapIndex-inl.h"
+
+namespace milvus::index {
+template <typename T>
+inline BitmapIndexPtr<T>
+CreateBitmapIndex() {
+    return std::make_unique<BitmapIndex<T>>();
+}
+}  // namespace milvus::index
@@ -0,0 +1,213 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "index/BoolIndex.h"
+
+#include <cstring>
+#include <string>
+
+#include "common/Slice.h"
+#include "index/ScalarIndexSort.h"
+
+namespace milvus::index {
+
+void
+BoolIndex::SetTrues(TargetBitmap&& trues) {
+    auto falses = trues;
+    falses.flip();
+    trues_ = CompressedBitset::compress(std::move(trues));
+    falses_ = CompressedBitset::compress(std::move(falses));
+    is_built_ = true;
+}
+
+void
+BoolIndex::Build(size_t n, const bool* values) {
+    if (n == 0) {
+        throw std::invalid_argument("BoolIndex cannot build null values!");
+    }
+    TargetBitmap trues(n);
+    auto blocks = trues.data();
+    for (size_t i = 0; i < n; ++i) {
+        blocks[i / 64] |= TargetBitmap::block_type(values[i]) << (i % 64);
+    }
+    SetTrues(std::move(trues));
+}
+
+BinarySet
+BoolIndex::Serialize(const Config& config) {
+    AssertInfo(is_built_, "index has not been built");
+    auto trues = trues_.to_dense();
+
+    BoolIndexHeader header{};
+    header.magic = BOOL_INDEX_MAGIC;
+    header.version = BOOL_INDEX_VERSION;
+    header.row_count = trues.size();
+    auto blocks_size = trues.num_blocks() * sizeof(TargetBitmap::block_type);
+    auto size = sizeof(header) + blocks_size;
+    std::shared_ptr<uint8_t[]> data(new uint8_t[size]);
+    memcpy(data.get(), &header, sizeof(header));
+    memcpy(data.get() + sizeof(header), trues.data(), blocks_size);
+
+    BinarySet res_set;
+    res_set.Append(BOOL_INDEX_BITS, data, size);
+    milvus::Disassemble(res_set);
+    return res_set;
+}
+
+void
+BoolIndex::Load(const BinarySet& index_binary, const Config& config) {
+    milvus::Assemble(const_cast<BinarySet&>(index_binary));
+    auto binary = index_binary.GetByName(BOOL_INDEX_BITS);
+    if (binary == nullptr) {
+        // a sort index, as bool fields were indexed before
+        ScalarIndexSort<bool> sorted;
+        sorted.Load(index_binary, config);
+        auto n = sorted.Count();
+        auto values = std::make_unique<bool[]>(n);
+        sorted.ReverseLookupRange(0, n, values.get());
+        Build(n, values.get());
+        return;
+    }
+
+    BoolIndexHeader header;
+    AssertInfo(binary->size >= sizeof(header), "bool index is truncated");
+    memcpy(&header, binary->data.get(), sizeof(header));
+    AssertInfo(header.magic == BOOL_INDEX_MAGIC, "not a bool index");
+    AssertInfo(header.version == BOOL_INDEX_VERSION,
+               "unsupported bool index version " +
+                   std::to_string(header.version));
+    TargetBitmap trues(header.row_count);
+    auto blocks_size = trues.num_blocks() * sizeof(TargetBitmap::block_type);
+    AssertInfo(binary->size == sizeof(header) + blocks_size,
+               "bool index is corrupted");
+    memcpy(trues.data(), binary->data.get() + sizeof(header), blocks_size);
+    SetTrues(std::move(trues));
+}
+
+CompressedBitset
+BoolIndex::Rows(bool has_false, bool has_true) const {
+    AssertInfo(is_built_, "index has not been built");
+    if (has_false && has_true) {
+        return CompressedBitset(TargetBitmap(trues_.size(), true));
+    }
+    if (has_false) {
+        return falses_;
+    }
+    if (has_true) {
+        return trues_;
+    }
+    return CompressedBitset(trues_.size());
+}
+
+CompressedBitset
+BoolIndex::InCompressed(size_t n, const bool* values) {
+    bool has_false = false;
+    bool has_true = false;
+    for (size_t i = 0; i < n; ++i) {
+        (values[i] ? has_true : has_false) = true;
+    }
+    return Rows(has_false, has_true);
+}
+
+const TargetBitmapPtr
+BoolIndex::In(size_t n, const bool* values) {
+    return std::make_unique<TargetBitmap>(InCompressed(n, values).to_dense());
+}
+
+const TargetBitmapPtr
+BoolIndex::NotIn(size_t n, const bool* values) {
+    auto result = InCompressed(n, values);
+    result.flip();
+    return std::make_unique<TargetBitmap>(std::move(result).to_dense());
+}
+
+CompressedBitset
+BoolIndex::RangeCompressed(bool value, OpType op) {
+    // false < true
+    switch (op) {
+        case OpType::LessThan:
+            return Rows(value, false);
+        case OpType::LessEqual:
+            return Rows(true, value);
+        case OpType::GreaterThan:
+            return Rows(false, !value);
+        case OpType::GreaterEqual:
+            return Rows(!value, true);
+        default:
+            throw std::invalid_argument(std::string("Invalid OperatorType: ") +
+                                        std::to_string((int)op) + "!");
+    }
+}
+
+CompressedBitset
+BoolIndex::RangeCompressed(bool lower_bound_value,
+                           bool lb_inclusive,
+                           bool upper_bound_value,
+                           bool ub_inclusive) {
+    auto has_false = !lower_bound_value && lb_inclusive &&
+                     (upper_bound_value || ub_inclusive);
+    auto has_true = (!lower_bound_value || lb_inclusive) &&
+                    upper_bound_value && ub_inclusive;
+    return Rows(has_false, has_true);
+}
+
+const TargetBitmapPtr
+BoolIndex::Range(bool value, OpType op) {
+    return std::make_unique<TargetBitmap>(
+        RangeCompressed(value, op).to_dense());
+}
+
+const TargetBitmapPtr
+BoolIndex::Range(bool lower_bound_value,
+                 bool lb_inclusive,
+                 bool upper_bound_value,
+                 bool ub_inclusive) {
+    return std::make_unique<TargetBitmap>(
+        RangeCompressed(
+            lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive)
+            .to_dense());
+}
+
+bool
+BoolIndex::Reverse_Lookup(size_t offset) const {
+    AssertInfo(is_built_, "index has not been built");
+    AssertInfo(offset < trues_.size(), "out of range of total count");
+    return trues_.test(offset);
+}
+
+void
+BoolIndex::ReverseLookupRange(size_t begin, size_t end, bool* out) const {
+    AssertInfo(is_built_, "index has not been built");
+    AssertInfo(begin <= end && end <= trues_.size(),
+               "out of range of total count");
+    for (auto offset = begin; offset < end; ++offset) {
+        *out++ = trues_.test(offset);
+    }
+}
+
+void
+BoolIndex::ReverseLookupBatch(const int64_t* offsets,
+                              size_t count,
+                              bool* out) const {
+    AssertInfo(is_built_, "index has not been built");
+    for (size_t i = 0; i < count; ++i) {
+        AssertInfo(offsets[i] >= 0 && size_t(offsets[i]) < trues_.size(),
+                   "out of range of total count");
+        out[i] = trues_.test(offsets[i]);
+    }
+}
+
+}  // namespace milvus::index
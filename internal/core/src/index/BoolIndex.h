@@ -16,15 +16,109 @@
 
 #pragma once
 
-#include <vector>
+#include <cstdint>
 #include <memory>
-#include "index/ScalarIndexSort.h"
+
+#include "common/CompressedBitset.h"
+#include "index/ScalarIndex.h"
 
 namespace milvus::index {
 
-//// TODO: optimize here.
-class BoolIndex : public ScalarIndexSort<bool> {};
-using BoolIndexPtr = std::shared_ptr<BoolIndex>;
+// Index of a bool field as the bitmaps of its true and of its false rows,
+// each In, NotIn and Range a copy of one of them. Serialized as one
+// binary, BOOL_INDEX_BITS: BoolIndexHeader, then the 64-bit blocks of the
+// true rows. Loads the sort indexes bool fields had before as well.
+constexpr const char* BOOL_INDEX_BITS = "bool_index_bits";
+constexpr uint32_t BOOL_INDEX_MAGIC = 0x4c4f4f42;  // "BOOL"
+constexpr uint32_t BOOL_INDEX_VERSION = 1;
+
+struct BoolIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t row_count;
+};
+
+class BoolIndex : public ScalarIndex<bool> {
+ public:
+    BoolIndex() = default;
+
+    BinarySet
+    Serialize(const Config& config) override;
+
+    void
+    Load(const BinarySet& index_binary, const Config& config = {}) override;
+
+    int64_t
+    Count() override {
+        return trues_.size();
+    }
+
+    int64_t
+    MemoryUsage() const override {
+        return trues_.memory_usage() + falses_.memory_usage();
+    }
+
+    void
+    Build(size_t n, const bool* values) override;
+
+    const TargetBitmapPtr
+    In(size_t n, const bool* values) override;
+
+    CompressedBitset
+    InCompressed(size_t n, const bool* values) override;
+
+    const TargetBitmapPtr
+    NotIn(size_t n, const bool* values) override;
+
+    const TargetBitmapPtr
+    Range(bool value, OpType op) override;
+
+    const TargetBitmapPtr
+    Range(bool lower_bound_value,
+          bool lb_inclusive,
+          bool upper_bound_value,
+          bool ub_inclusive) override;
+
+    CompressedBitset
+    RangeCompressed(bool value, OpType op) override;
+
+    CompressedBitset
+    RangeCompressed(bool lower_bound_value,
+                    bool lb_inclusive,
+                    bool upper_bound_value,
+                    bool ub_inclusive) override;
+
+    bool
+    Reverse_Lookup(size_t offset) const override;
+
+    void
+    ReverseLookupRange(size_t begin, size_t end, bool* out) const override;
+
+    void
+    ReverseLookupBatch(const int64_t* offsets,
+                       size_t count,
+                       bool* out) const override;
+
+    int64_t
+    Size() override {
+        return trues_.size();
+    }
+
+ private:
+    // the rows holding any of the values
+    CompressedBitset
+    Rows(bool has_false, bool has_true) const;
+
+    void
+    SetTrues(TargetBitmap&& trues);
+
+ private:
+    bool is_built_ = false;
+    CompressedBitset trues_;
+    CompressedBitset falses_;
+};
+
+using BoolIndexPtr = std::unique_ptr<BoolIndex>;
 
 inline BoolIndexPtr
 CreateBoolIndex() {
@@ -17,7 +17,6 @@
 #pragma once
 
 #include <memory>
-#include <boost/dynamic_bitset.hpp>
 #include "knowhere/dataset.h"
 #include "common/Types.h"
 
@@ -44,6 +43,10 @@ class IndexBase {
     virtual int64_t
     Count() = 0;
 
+    // bytes the index holds in memory, or maps
+    virtual int64_t
+    MemoryUsage() const = 0;
+
  protected:
     IndexType index_type_ = "";
     IndexMode index_mode_ = IndexMode::MODE_CPU;
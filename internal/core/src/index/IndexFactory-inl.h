@@ -15,6 +15,8 @@
 // limitations under the License.
 
 #include <string>
+#include "index/BitmapIndex.h"
+#include "index/Meta.h"
 #include "index/ScalarIndexSort.h"
 #include "index/StringIndexMarisa.h"
 #include "index/BoolIndex.h"
@@ -24,18 +26,27 @@ namespace milvus::index {
 template <typename T>
 inline ScalarIndexPtr<T>
 IndexFactory::CreateScalarIndex(const IndexType& index_type) {
+    if (index_type == BITMAP_INDEX_TYPE) {
+        return CreateBitmapIndex<T>();
+    }
     return CreateScalarIndexSort<T>();
 }
 
-// template <>
-// inline ScalarIndexPtr<bool>
-// IndexFactory::CreateScalarIndex(const IndexType& index_type) {
-//    return CreateBoolIndex();
-//}
+template <>
+inline ScalarIndexPtr<bool>
+IndexFactory::CreateScalarIndex(const IndexType& index_type) {
+    if (index_type == BITMAP_INDEX_TYPE) {
+        return CreateBitmapIndex<bool>();
+    }
+    return CreateBoolIndex();
+}
 
 template <>
 inline ScalarIndexPtr<std::string>
 IndexFactory::CreateScalarIndex(const IndexType& index_type) {
+    if (index_type == BITMAP_INDEX_TYPE) {
+        return CreateBitmapIndex<std::string>();
+    }
 #if defined(__linux__) || defined(__APPLE__)
     return CreateStringIndexMarisa();
 #else
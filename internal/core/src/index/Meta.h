@@ -30,6 +30,9 @@ constexpr const char* PREFIX_VALUE = "prefix_value";
 constexpr const char* MARISA_TRIE_INDEX = "marisa_trie_index";
 constexpr const char* MARISA_STR_IDS = "marisa_trie_str_ids";
 
+// load params
+constexpr const char* MMAP_FILE_PATH = "mmap_filepath";
+
 constexpr const char* INDEX_TYPE = "index_type";
 constexpr const char* INDEX_MODE = "index_mode";
 constexpr const char* METRIC_TYPE = "metric_type";
@@ -37,6 +40,8 @@ constexpr const char* METRIC_TYPE = "metric_type";
 // scalar index type
 constexpr const char* ASCENDING_SORT = "STL_SORT";
 constexpr const char* MARISA_TRIE = "Trie";
+// picked by the index builder for fields of few distinct values
+constexpr const char* BITMAP_INDEX_TYPE = "BITMAP";
 
 // index meta
 constexpr const char* COLLECTION_ID = "collection_id";
@@ -67,4 +72,7 @@ constexpr const char* DISK_ANN_PREPARE_USE_BFS_CACHE = "use_bfs_cache";
 // DiskAnn query params
 constexpr const char* DISK_ANN_QUERY_LIST = "search_list";
 constexpr const char* DISK_ANN_QUERY_BEAMWIDTH = "beamwidth";
+// without search_list, picks search_list and beamwidth by topk and filter
+// selectivity under "latency", "balanced" (default) or "recall"
+constexpr const char* DISK_ANN_QUERY_PROFILE = "search_profile";
 }  // namespace milvus::index
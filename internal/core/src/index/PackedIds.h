@@ -0,0 +1,97 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace milvus::index {
+
+// ids below a bound, bit packed at the width of the largest one
+class PackedIds {
+ public:
+    PackedIds() = default;
+
+    template <typename Id>
+    PackedIds(const Id* ids, size_t size, uint64_t bound) : size_(size) {
+        while (bits_ < 64 && (uint64_t(1) << bits_) < bound) {
+            ++bits_;
+        }
+        // one word of padding for the two-word reads
+        words_.assign((size * bits_ + 63) / 64 + 1, 0);
+        if (bits_ == 0) {
+            return;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            auto code = uint64_t(ids[i]);
+            auto bit = i * bits_;
+            auto shift = bit & 63;
+            words_[bit >> 6] |= code << shift;
+            if (shift + bits_ > 64) {
+                words_[(bit >> 6) + 1] |= code >> (64 - shift);
+            }
+        }
+    }
+
+    size_t
+    size() const {
+        return size_;
+    }
+
+    uint64_t
+    operator[](size_t i) const {
+        if (bits_ == 0) {
+            return 0;
+        }
+        auto bit = i * bits_;
+        auto shift = bit & 63;
+        auto word = words_.data() + (bit >> 6);
+        auto code = word[0] >> shift;
+        if (shift + bits_ > 64) {
+            code |= word[1] << (64 - shift);
+        }
+        auto mask = bits_ == 64 ? ~uint64_t(0) : (uint64_t(1) << bits_) - 1;
+        return code & mask;
+    }
+
+    // the ids in [begin, end) into out
+    template <typename Id>
+    void
+    Decode(size_t begin, size_t end, Id* out) const {
+        for (auto i = begin; i < end; ++i) {
+            *out++ = Id(operator[](i));
+        }
+    }
+
+    int
+    bits() const {
+        return bits_;
+    }
+
+    size_t
+    memory_bytes() const {
+        return words_.capacity() * sizeof(uint64_t);
+    }
+
+ private:
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+    int bits_ = 0;
+};
+
+}  // namespace milvus::index
@@ -0,0 +1,149 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+
+#include "index/IndexStructure.h"
+
+namespace milvus::index {
+
+// fewer entries than this are sorted on the calling thread
+constexpr size_t PARALLEL_SORT_MIN_SIZE = 1 << 16;
+
+// an unsigned key in the order of the value: the sign bit of integers is
+// flipped, negative floats have every bit flipped and the others the sign
+template <typename T>
+inline auto
+RadixKey(T value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return uint8_t(value);
+    } else if constexpr (std::is_integral_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        return U(U(value) ^ (U(1) << (sizeof(T) * 8 - 1)));
+    } else {
+        using U = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        U bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+        return (bits & sign) ? U(~bits) : U(bits | sign);
+    }
+}
+
+// a stable LSD radix sort by a byte a pass: every block of the entries
+// counts its digits, then scatters them to where the counts of the blocks
+// before it end. passes whose digit is the same for all entries are skipped
+template <typename T>
+void
+ParallelRadixSort(std::vector<IndexStructure<T>>& data) {
+    using Key = decltype(RadixKey(T()));
+    constexpr size_t block_size = 1 << 14;
+    auto n = data.size();
+    if (n < PARALLEL_SORT_MIN_SIZE) {
+        std::stable_sort(data.begin(), data.end());
+        return;
+    }
+    auto num_blocks =
+        std::min((n + block_size - 1) / block_size,
+                 size_t(tbb::this_task_arena::max_concurrency()) * 4);
+    auto block_begin = [&](size_t block) { return n * block / num_blocks; };
+
+    std::vector<IndexStructure<T>> buffer(n);
+    std::vector<std::array<size_t, 256>> counts(num_blocks);
+    for (size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+        auto digit = [shift](const IndexStructure<T>& entry) {
+            return (RadixKey(entry.a_) >> shift) & 0xff;
+        };
+        tbb::parallel_for(size_t(0), num_blocks, [&](size_t block) {
+            auto& count = counts[block];
+            count.fill(0);
+            for (auto i = block_begin(block); i < block_begin(block + 1); ++i) {
+                ++count[digit(data[i])];
+            }
+        });
+        // the start of every block in every bucket, buckets in order
+        size_t offset = 0;
+        bool one_bucket = false;
+        for (size_t d = 0; d < 256; ++d) {
+            auto bucket_begin = offset;
+            for (auto& count : counts) {
+                auto size = count[d];
+                count[d] = offset;
+                offset += size;
+            }
+            one_bucket |= offset - bucket_begin == n;
+        }
+        if (one_bucket) {
+            continue;
+        }
+        tbb::parallel_for(size_t(0), num_blocks, [&](size_t block) {
+            auto& next = counts[block];
+            for (auto i = block_begin(block); i < block_begin(block + 1); ++i) {
+                buffer[next[digit(data[i])]++] = data[i];
+            }
+        });
+        data.swap(buffer);
+    }
+}
+
+// sorts the entries by value, ties in no particular order for strings
+template <typename T>
+void
+ParallelSortEntries(std::vector<IndexStructure<T>>& data) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        if (data.size() < PARALLEL_SORT_MIN_SIZE) {
+            std::sort(data.begin(), data.end());
+        } else {
+            tbb::parallel_sort(data.begin(), data.end());
+        }
+    } else {
+        ParallelRadixSort(data);
+    }
+}
+
+// offsets[data[i].idx_] = i for all the entries
+template <typename T>
+void
+ParallelFillInverse(const std::vector<IndexStructure<T>>& data,
+                    std::vector<int32_t>& offsets) {
+    auto n = data.size();
+    if (n < PARALLEL_SORT_MIN_SIZE) {
+        for (size_t i = 0; i < n; ++i) {
+            offsets[data[i].idx_] = i;
+        }
+        return;
+    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                          for (auto i = range.begin(); i < range.end(); ++i) {
+                              offsets[data[i].idx_] = i;
+                          }
+                      });
+}
+
+}  // namespace milvus::index
@@ -0,0 +1,61 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "index/PostingList.h"
+
+#include <algorithm>
+
+namespace milvus::index {
+
+void
+PostingLists::Encode(const uint32_t* rows, size_t size) {
+    for (size_t begin = 0; begin < size; begin += POSTING_BLOCK_SIZE) {
+        auto end = std::min(begin + POSTING_BLOCK_SIZE, size);
+        uint32_t max_gap = 0;
+        for (auto i = begin + 1; i < end; ++i) {
+            max_gap = std::max(max_gap, rows[i] - rows[i - 1] - 1);
+        }
+        uint8_t bits = max_gap == 0 ? 0 : 32 - __builtin_clz(max_gap);
+
+        uint8_t header[sizeof(uint32_t) + 1];
+        memcpy(header, &rows[begin], sizeof(uint32_t));
+        header[sizeof(uint32_t)] = bits;
+        data_.insert(data_.end(), header, header + sizeof(header));
+        uint64_t acc = 0;
+        size_t filled = 0;
+        for (auto i = begin + 1; i < end; ++i) {
+            acc |= uint64_t(rows[i] - rows[i - 1] - 1) << filled;
+            filled += bits;
+            for (; filled >= 8; filled -= 8, acc >>= 8) {
+                data_.push_back(acc & 0xff);
+            }
+        }
+        if (filled > 0) {
+            data_.push_back(acc & 0xff);
+        }
+    }
+}
+
+void
+PostingLists::Fill(size_t term, TargetBitmap& bitset, bool value) const {
+    if (value) {
+        ForEach(term, [&bitset](uint32_t row) { bitset.set(row); });
+    } else {
+        ForEach(term, [&bitset](uint32_t row) { bitset.reset(row); });
+    }
+}
+
+}  // namespace milvus::index
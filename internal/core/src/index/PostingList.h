@@ -0,0 +1,139 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/Types.h"
+
+namespace milvus::index {
+
+// postings sharing a block header
+constexpr size_t POSTING_BLOCK_SIZE = 128;
+
+// The rows of every term of a column, each term's ascending rows stored
+// in blocks of POSTING_BLOCK_SIZE as
+//
+//   uint32_t first row, uint8_t bit width
+//   the gaps to the next rows minus one, bit packed at that width
+//
+// so a term costs about log2 of its mean gap bits per row, and visiting
+// it costs its own rows, not the column's.
+class PostingLists {
+ public:
+    PostingLists() = default;
+
+    // term_ids[row] in [0, term_count) for every row
+    template <typename TermId>
+    PostingLists(size_t term_count, const TermId* term_ids, size_t row_count);
+
+    size_t
+    term_count() const {
+        return counts_.size();
+    }
+
+    size_t
+    count(size_t term) const {
+        return counts_[term];
+    }
+
+    // calls func(row) for the rows of term, ascending
+    template <typename Func>
+    void
+    ForEach(size_t term, Func func) const;
+
+    // sets, or resets if value is false, the rows of term in bitset
+    void
+    Fill(size_t term, TargetBitmap& bitset, bool value = true) const;
+
+    size_t
+    memory_bytes() const {
+        return data_.size() + starts_.size() * sizeof(uint64_t) +
+               counts_.size() * sizeof(uint32_t);
+    }
+
+ private:
+    // appends the blocks of one term's ascending rows
+    void
+    Encode(const uint32_t* rows, size_t size);
+
+ private:
+    // packed blocks, padded for 8-byte loads at any packed gap
+    std::vector<uint8_t> data_;
+    // byte offset of each term's first block
+    std::vector<uint64_t> starts_;
+    std::vector<uint32_t> counts_;
+};
+
+template <typename TermId>
+PostingLists::PostingLists(size_t term_count,
+                           const TermId* term_ids,
+                           size_t row_count) {
+    counts_.assign(term_count, 0);
+    for (size_t row = 0; row < row_count; ++row) {
+        ++counts_[term_ids[row]];
+    }
+    // rows bucketed by term, the order of rows kept
+    std::vector<uint64_t> bucket(term_count + 1, 0);
+    for (size_t term = 0; term < term_count; ++term) {
+        bucket[term + 1] = bucket[term] + counts_[term];
+    }
+    std::vector<uint32_t> rows(row_count);
+    auto cursor = bucket;
+    for (size_t row = 0; row < row_count; ++row) {
+        rows[cursor[term_ids[row]]++] = row;
+    }
+
+    starts_.reserve(term_count);
+    for (size_t term = 0; term < term_count; ++term) {
+        starts_.push_back(data_.size());
+        Encode(rows.data() + bucket[term], counts_[term]);
+    }
+    data_.resize(data_.size() + sizeof(uint64_t), 0);
+    data_.shrink_to_fit();
+}
+
+template <typename Func>
+void
+PostingLists::ForEach(size_t term, Func func) const {
+    auto src = data_.data() + starts_[term];
+    size_t remain = counts_[term];
+    while (remain > 0) {
+        uint32_t row;
+        memcpy(&row, src, sizeof(row));
+        uint8_t bits = src[sizeof(row)];
+        src += sizeof(row) + 1;
+        func(row);
+
+        auto gaps = std::min(remain, POSTING_BLOCK_SIZE) - 1;
+        uint64_t mask = bits == 0 ? 0 : (~uint64_t(0) >> (64 - bits));
+        for (size_t i = 0; i < gaps; ++i) {
+            auto bit = i * bits;
+            uint64_t word;
+            memcpy(&word, src + bit / 8, sizeof(word));
+            row += ((word >> (bit % 8)) & mask) + 1;
+            func(row);
+        }
+        src += (gaps * bits + 7) / 8;
+        remain -= gaps + 1;
+    }
+}
+
+}  // namespace milvus::index
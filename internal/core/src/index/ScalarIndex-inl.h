@@ -68,6 +68,24 @@ ScalarIndex<T>::Query(const DatasetPtr& dataset) {
     }
 }
 
+template <typename T>
+void
+ScalarIndex<T>::ReverseLookupRange(size_t begin, size_t end, T* out) const {
+    for (auto offset = begin; offset < end; ++offset) {
+        *out++ = Reverse_Lookup(offset);
+    }
+}
+
+template <typename T>
+void
+ScalarIndex<T>::ReverseLookupBatch(const int64_t* offsets,
+                                   size_t count,
+                                   T* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = Reverse_Lookup(offsets[i]);
+    }
+}
+
 template <>
 inline void
 ScalarIndex<std::string>::BuildWithRawData(size_t n,
@@ -16,11 +16,12 @@
 
 #pragma once
 
-#include <boost/dynamic_bitset.hpp>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 
+#include "common/CompressedBitset.h"
 #include "common/Types.h"
 #include "exceptions/EasyAssert.h"
 #include "index/Index.h"
@@ -60,9 +61,39 @@ class ScalarIndex : public IndexBase {
           T upper_bound_value,
           bool ub_inclusive) = 0;
 
+    // In and Range results in the container that suits their density,
+    // by default the bitmaps of In and Range compressed
+    virtual CompressedBitset
+    InCompressed(size_t n, const T* values) {
+        return CompressedBitset::compress(std::move(*In(n, values)));
+    }
+
+    virtual CompressedBitset
+    RangeCompressed(T value, OpType op) {
+        return CompressedBitset::compress(std::move(*Range(value, op)));
+    }
+
+    virtual CompressedBitset
+    RangeCompressed(T lower_bound_value,
+                    bool lb_inclusive,
+                    T upper_bound_value,
+                    bool ub_inclusive) {
+        return CompressedBitset::compress(std::move(*Range(
+            lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive)));
+    }
+
     virtual T
     Reverse_Lookup(size_t offset) const = 0;
 
+    // the values of the rows in [begin, end) into out, by default one
+    // Reverse_Lookup per row; indexes override it to decode in bulk
+    virtual void
+    ReverseLookupRange(size_t begin, size_t end, T* out) const;
+
+    // the values of the rows at offsets into out
+    virtual void
+    ReverseLookupBatch(const int64_t* offsets, size_t count, T* out) const;
+
     virtual const TargetBitmapPtr
     Query(const DatasetPtr& dataset);
 
@@ -14,7 +14,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <memory>
 #include <utility>
 #include <pb/schema.pb.h>
@@ -22,8 +29,11 @@
 #include <string>
 #include "knowhere/log.h"
 #include "Meta.h"
+#include "common/MemoryUsage.h"
 #include "common/Utils.h"
 #include "common/Slice.h"
+#include "index/ParallelSort.h"
+#include "index/Utils.h"
 
 namespace milvus::index {
 
@@ -47,35 +57,123 @@ ScalarIndexSort<T>::Build(const size_t n, const T* values) {
         throw std::invalid_argument(
             "ScalarIndexSort cannot build null values!");
     }
-    data_.reserve(n);
-    idx_to_offsets_.resize(n);
-    T* p = const_cast<T*>(values);
-    for (size_t i = 0; i < n; ++i) {
-        data_.emplace_back(IndexStructure(*p++, i));
-    }
-    std::sort(data_.begin(), data_.end());
-    for (size_t i = 0; i < data_.size(); ++i) {
-        idx_to_offsets_[data_[i].idx_] = i;
+    if constexpr (std::is_same_v<T, std::string>) {
+        data_.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            data_.emplace_back(IndexStructure(values[i], i));
+        }
+    } else {
+        data_.resize(n);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (auto i = range.begin(); i < range.end();
+                                   ++i) {
+                                  data_[i] = IndexStructure(values[i], i);
+                              }
+                          });
     }
+    ParallelSortEntries(data_);
+    idx_to_offsets_.resize(n);
+    ParallelFillInverse(data_, idx_to_offsets_);
+    UseOwnedData();
     is_built_ = true;
 }
 
+template <typename T>
+inline void
+ScalarIndexSort<T>::UseOwnedData() {
+    entries_ = data_.data();
+    inverse_ = idx_to_offsets_.data();
+    size_ = data_.size();
+    buffer_.reset();
+    memory_usage_ = HeapBytes(idx_to_offsets_) +
+                    data_.capacity() * sizeof(IndexStructure<T>);
+    if constexpr (std::is_same_v<T, std::string>) {
+        for (auto& entry : data_) {
+            memory_usage_ += HeapBytes(entry.a_);
+        }
+    }
+}
+
+template <typename T>
+inline void
+ScalarIndexSort<T>::UseBuffer(std::shared_ptr<const void> holder,
+                              const uint8_t* data,
+                              size_t size) {
+    SortIndexHeader header;
+    AssertInfo(size >= sizeof(header), "sort index is truncated");
+    memcpy(&header, data, sizeof(header));
+    AssertInfo(header.magic == SORT_INDEX_MAGIC, "not a sort index");
+    AssertInfo(header.version == SORT_INDEX_VERSION,
+               "unsupported sort index version " +
+                   std::to_string(header.version));
+    AssertInfo(header.entry_size == sizeof(IndexStructure<T>),
+               "sort index of another data type");
+    auto rows = header.row_count;
+    AssertInfo(header.entries_offset % SORT_INDEX_ALIGNMENT == 0 &&
+                   header.inverse_offset % SORT_INDEX_ALIGNMENT == 0 &&
+                   header.entries_offset + rows * header.entry_size <=
+                       header.inverse_offset &&
+                   header.inverse_offset + rows * sizeof(int32_t) <= size,
+               "sort index is corrupted");
+    // the binaries of a BinarySet and mappings are at least 16 aligned
+    AssertInfo(reinterpret_cast<uintptr_t>(data) % alignof(int64_t) == 0,
+               "sort index buffer is misaligned");
+
+    data_.clear();
+    data_.shrink_to_fit();
+    idx_to_offsets_.clear();
+    idx_to_offsets_.shrink_to_fit();
+    auto entries = data + header.entries_offset;
+    entries_ = reinterpret_cast<const IndexStructure<T>*>(entries);
+    inverse_ = reinterpret_cast<const int32_t*>(data + header.inverse_offset);
+    size_ = rows;
+    memory_usage_ = size;
+    buffer_ = std::move(holder);
+}
+
 template <typename T>
 inline BinarySet
 ScalarIndexSort<T>::Serialize(const Config& config) {
     AssertInfo(is_built_, "index has not been built");
 
-    auto index_data_size = data_.size() * sizeof(IndexStructure<T>);
-    std::shared_ptr<uint8_t[]> index_data(new uint8_t[index_data_size]);
-    memcpy(index_data.get(), data_.data(), index_data_size);
+    BinarySet res_set;
+    if constexpr (std::is_arithmetic_v<T>) {
+        auto align = [](uint64_t size) {
+            return (size + SORT_INDEX_ALIGNMENT - 1) / SORT_INDEX_ALIGNMENT *
+                   SORT_INDEX_ALIGNMENT;
+        };
+        SortIndexHeader header{};
+        header.magic = SORT_INDEX_MAGIC;
+        header.version = SORT_INDEX_VERSION;
+        header.row_count = size_;
+        header.entry_size = sizeof(IndexStructure<T>);
+        header.entries_offset = align(sizeof(header));
+        header.inverse_offset =
+            align(header.entries_offset + size_ * sizeof(IndexStructure<T>));
+        auto total = header.inverse_offset + size_ * sizeof(int32_t);
+
+        std::shared_ptr<uint8_t[]> index_data(new uint8_t[total]());
+        memcpy(index_data.get(), &header, sizeof(header));
+        memcpy(index_data.get() + header.entries_offset,
+               entries_,
+               size_ * sizeof(IndexStructure<T>));
+        memcpy(index_data.get() + header.inverse_offset,
+               inverse_,
+               size_ * sizeof(int32_t));
+        res_set.Append(SORT_INDEX_DATA, index_data, total);
+    } else {
+        auto index_data_size = size_ * sizeof(IndexStructure<T>);
+        std::shared_ptr<uint8_t[]> index_data(new uint8_t[index_data_size]);
+        memcpy(index_data.get(), entries_, index_data_size);
 
-    std::shared_ptr<uint8_t[]> index_length(new uint8_t[sizeof(size_t)]);
-    auto index_size = data_.size();
-    memcpy(index_length.get(), &index_size, sizeof(size_t));
+        std::shared_ptr<uint8_t[]> index_length(new uint8_t[sizeof(size_t)]);
+        auto index_size = size_;
+        memcpy(index_length.get(), &index_size, sizeof(size_t));
 
-    BinarySet res_set;
-    res_set.Append("index_data", index_data, index_data_size);
-    res_set.Append("index_length", index_length, sizeof(size_t));
+        res_set.Append("index_data", index_data, index_data_size);
+        res_set.Append("index_length", index_length, sizeof(size_t));
+    }
 
     milvus::Disassemble(res_set);
 
@@ -85,8 +183,33 @@ ScalarIndexSort<T>::Serialize(const Config& config) {
 template <typename T>
 inline void
 ScalarIndexSort<T>::Load(const BinarySet& index_binary, const Config& config) {
-    size_t index_size;
     milvus::Assemble(const_cast<BinarySet&>(index_binary));
+    if constexpr (std::is_arithmetic_v<T>) {
+        auto binary = index_binary.GetByName(SORT_INDEX_DATA);
+        if (binary != nullptr) {
+            auto path = GetValueFromConfig<std::string>(config, MMAP_FILE_PATH);
+            if (!path.has_value()) {
+                UseBuffer(binary->data, binary->data.get(), binary->size);
+                is_built_ = true;
+                return;
+            }
+            // the mapping outlives the file, the kernel pages it from disk
+            std::filesystem::create_directories(
+                std::filesystem::path(path.value()).parent_path());
+            {
+                std::ofstream file(path.value(), std::ios::binary);
+                file.write(reinterpret_cast<const char*>(binary->data.get()),
+                           binary->size);
+                AssertInfo(file.good(),
+                           "failed to write sort index file " + path.value());
+            }
+            LoadFile(path.value());
+            std::filesystem::remove(path.value());
+            return;
+        }
+    }
+
+    size_t index_size;
     auto index_length = index_binary.GetByName("index_length");
     memcpy(&index_size, index_length->data.get(), (size_t)index_length->size);
 
@@ -94,133 +217,300 @@ ScalarIndexSort<T>::Load(const BinarySet& index_binary, const Config& config) {
     data_.resize(index_size);
     idx_to_offsets_.resize(index_size);
     memcpy(data_.data(), index_data->data.get(), (size_t)index_data->size);
-    for (size_t i = 0; i < data_.size(); ++i) {
-        idx_to_offsets_[data_[i].idx_] = i;
-    }
+    ParallelFillInverse(data_, idx_to_offsets_);
+    UseOwnedData();
     is_built_ = true;
 }
 
 template <typename T>
-inline const TargetBitmapPtr
-ScalarIndexSort<T>::In(const size_t n, const T* values) {
-    AssertInfo(is_built_, "index has not been built");
-    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(data_.size());
+inline void
+ScalarIndexSort<T>::LoadFile(const std::string& path) {
+    AssertInfo(std::is_arithmetic_v<T>,
+               "only sort indexes of arithmetic types can be mapped");
+    auto fd = open(path.c_str(), O_RDONLY);
+    AssertInfo(fd != -1,
+               "failed to open sort index file " + path + ", err: " +
+                   strerror(errno));
+    struct stat st;
+    auto ok = fstat(fd, &st);
+    auto size = static_cast<size_t>(st.st_size);
+    auto map = ok == 0 && size > 0
+                   ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)
+                   : MAP_FAILED;
+    close(fd);
+    AssertInfo(map != MAP_FAILED,
+               "failed to map sort index file " + path + ", err: " +
+                   strerror(errno));
+    std::shared_ptr<const void> holder(
+        map, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+    UseBuffer(std::move(holder), static_cast<const uint8_t*>(map), size);
+    is_built_ = true;
+}
+
+template <typename T>
+template <typename Less>
+inline auto
+ScalarIndexSort<T>::Gallop(ConstIterator begin, ConstIterator end, Less less)
+    -> ConstIterator {
+    auto size = end - begin;
+    decltype(size) bound = 1;
+    while (bound < size && less(begin[bound])) {
+        bound *= 2;
+    }
+    return std::partition_point(
+        begin + bound / 2, begin + std::min(bound, size), less);
+}
+
+template <typename T>
+inline auto
+ScalarIndexSort<T>::EqualSpans(const size_t n, const T* values) const
+    -> std::vector<std::pair<ConstIterator, ConstIterator>> {
+    std::vector<IndexStructure<T>> probes;
+    probes.reserve(n);
     for (size_t i = 0; i < n; ++i) {
-        auto lb = std::lower_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        auto ub = std::upper_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        for (; lb < ub; ++lb) {
-            if (lb->a_ != *(values + i)) {
-                std::cout << "error happens in ScalarIndexSort<T>::In, "
-                             "experted value is: "
-                          << *(values + i) << ", but real value is: " << lb->a_;
-            }
-            bitset->set(lb->idx_);
+        probes.emplace_back(values[i]);
+    }
+    std::sort(probes.begin(), probes.end());
+    probes.erase(std::unique(probes.begin(), probes.end()), probes.end());
+
+    std::vector<std::pair<ConstIterator, ConstIterator>> spans;
+    auto iter = Begin();
+    for (auto& probe : probes) {
+        auto& value = probe.a_;
+        auto lb = Gallop(iter, End(), [&value](const auto& entry) {
+            return entry.a_ < value;
+        });
+        auto ub = Gallop(lb, End(), [&value](const auto& entry) {
+            return !(value < entry.a_);
+        });
+        if (lb < ub) {
+            spans.emplace_back(lb, ub);
         }
+        iter = ub;
     }
-    return bitset;
+    return spans;
 }
 
 template <typename T>
-inline const TargetBitmapPtr
-ScalarIndexSort<T>::NotIn(const size_t n, const T* values) {
-    AssertInfo(is_built_, "index has not been built");
-    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(data_.size());
-    bitset->set();
-    for (size_t i = 0; i < n; ++i) {
-        auto lb = std::lower_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        auto ub = std::upper_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(*(values + i)));
-        for (; lb < ub; ++lb) {
-            if (lb->a_ != *(values + i)) {
-                std::cout << "error happens in ScalarIndexSort<T>::NotIn, "
-                             "experted value is: "
-                          << *(values + i) << ", but real value is: " << lb->a_;
+inline void
+ScalarIndexSort<T>::FillRows(
+    const std::vector<std::pair<ConstIterator, ConstIterator>>& spans,
+    TargetBitmap& bitset) const {
+    size_t total = 0;
+    for (auto& [lb, ub] : spans) {
+        total += ub - lb;
+    }
+    if (total * 2 <= size_) {
+        for (auto& [lb, ub] : spans) {
+            for (auto iter = lb; iter < ub; ++iter) {
+                bitset.set(iter->idx_);
             }
-            bitset->reset(lb->idx_);
         }
+        return;
     }
+    // the rows of sorted entries are scattered, only the whole bitset is a
+    // word-wise fill; the minority between the spans is cleared bit by bit
+    bitset.set();
+    auto gap = Begin();
+    for (auto& [lb, ub] : spans) {
+        for (; gap < lb; ++gap) {
+            bitset.reset(gap->idx_);
+        }
+        gap = ub;
+    }
+    for (; gap < End(); ++gap) {
+        bitset.reset(gap->idx_);
+    }
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+ScalarIndexSort<T>::In(const size_t n, const T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(size_);
+    FillRows(EqualSpans(n, values), *bitset);
     return bitset;
 }
 
 template <typename T>
 inline const TargetBitmapPtr
-ScalarIndexSort<T>::Range(const T value, const OpType op) {
+ScalarIndexSort<T>::NotIn(const size_t n, const T* values) {
     AssertInfo(is_built_, "index has not been built");
-    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(data_.size());
-    auto lb = data_.begin();
-    auto ub = data_.end();
+    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(size_);
+    FillRows(EqualSpans(n, values), *bitset);
+    bitset->flip();
+    return bitset;
+}
+
+template <typename T>
+inline auto
+ScalarIndexSort<T>::RangeBounds(const T value, const OpType op) const
+    -> std::pair<ConstIterator, ConstIterator> {
+    auto lb = Begin();
+    auto ub = End();
     switch (op) {
         case OpType::LessThan:
             ub = std::lower_bound(
-                data_.begin(), data_.end(), IndexStructure<T>(value));
+                Begin(), End(), IndexStructure<T>(value));
             break;
         case OpType::LessEqual:
             ub = std::upper_bound(
-                data_.begin(), data_.end(), IndexStructure<T>(value));
+                Begin(), End(), IndexStructure<T>(value));
             break;
         case OpType::GreaterThan:
             lb = std::upper_bound(
-                data_.begin(), data_.end(), IndexStructure<T>(value));
+                Begin(), End(), IndexStructure<T>(value));
             break;
         case OpType::GreaterEqual:
             lb = std::lower_bound(
-                data_.begin(), data_.end(), IndexStructure<T>(value));
+                Begin(), End(), IndexStructure<T>(value));
             break;
         default:
             throw std::invalid_argument(std::string("Invalid OperatorType: ") +
                                         std::to_string((int)op) + "!");
     }
-    for (; lb < ub; ++lb) {
-        bitset->set(lb->idx_);
-    }
-    return bitset;
+    return {lb, ub};
 }
 
 template <typename T>
-inline const TargetBitmapPtr
-ScalarIndexSort<T>::Range(T lower_bound_value,
-                          bool lb_inclusive,
-                          T upper_bound_value,
-                          bool ub_inclusive) {
-    AssertInfo(is_built_, "index has not been built");
-    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(data_.size());
+inline auto
+ScalarIndexSort<T>::RangeBounds(T lower_bound_value,
+                                bool lb_inclusive,
+                                T upper_bound_value,
+                                bool ub_inclusive) const
+    -> std::pair<ConstIterator, ConstIterator> {
     if (lower_bound_value > upper_bound_value ||
         (lower_bound_value == upper_bound_value &&
          !(lb_inclusive && ub_inclusive))) {
-        return bitset;
+        return {End(), End()};
     }
-    auto lb = data_.begin();
-    auto ub = data_.end();
+    auto lb = Begin();
+    auto ub = End();
     if (lb_inclusive) {
         lb = std::lower_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(lower_bound_value));
+            Begin(), End(), IndexStructure<T>(lower_bound_value));
     } else {
         lb = std::upper_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(lower_bound_value));
+            Begin(), End(), IndexStructure<T>(lower_bound_value));
     }
     if (ub_inclusive) {
         ub = std::upper_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(upper_bound_value));
+            Begin(), End(), IndexStructure<T>(upper_bound_value));
     } else {
         ub = std::lower_bound(
-            data_.begin(), data_.end(), IndexStructure<T>(upper_bound_value));
+            Begin(), End(), IndexStructure<T>(upper_bound_value));
     }
-    for (; lb < ub; ++lb) {
-        bitset->set(lb->idx_);
+    return {lb, std::max(lb, ub)};
+}
+
+template <typename T>
+inline CompressedBitset
+ScalarIndexSort<T>::MatchedRows(
+    const std::vector<std::pair<ConstIterator, ConstIterator>>& spans) const {
+    size_t total = 0;
+    for (auto& [lb, ub] : spans) {
+        total += ub - lb;
+    }
+    auto dense_bytes = (size_ + TargetBitmap::bits_per_block - 1) /
+                       TargetBitmap::bits_per_block *
+                       sizeof(TargetBitmap::block_type);
+    if (total * sizeof(CompressedBitset::offset_type) < dense_bytes) {
+        // too few rows to be worth a bitmap of the whole index
+        std::vector<CompressedBitset::offset_type> offsets;
+        offsets.reserve(total);
+        for (auto& [lb, ub] : spans) {
+            for (auto iter = lb; iter < ub; ++iter) {
+                offsets.push_back(iter->idx_);
+            }
+        }
+        return CompressedBitset::from_offsets(size_,
+                                              std::move(offsets));
     }
+    TargetBitmap bitset(size_);
+    FillRows(spans, bitset);
+    return CompressedBitset::compress(std::move(bitset));
+}
+
+template <typename T>
+inline CompressedBitset
+ScalarIndexSort<T>::InCompressed(const size_t n, const T* values) {
+    AssertInfo(is_built_, "index has not been built");
+    return MatchedRows(EqualSpans(n, values));
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+ScalarIndexSort<T>::Range(const T value, const OpType op) {
+    AssertInfo(is_built_, "index has not been built");
+    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(size_);
+    FillRows({RangeBounds(value, op)}, *bitset);
     return bitset;
 }
 
+template <typename T>
+inline CompressedBitset
+ScalarIndexSort<T>::RangeCompressed(const T value, const OpType op) {
+    AssertInfo(is_built_, "index has not been built");
+    return MatchedRows({RangeBounds(value, op)});
+}
+
+template <typename T>
+inline const TargetBitmapPtr
+ScalarIndexSort<T>::Range(T lower_bound_value,
+                          bool lb_inclusive,
+                          T upper_bound_value,
+                          bool ub_inclusive) {
+    AssertInfo(is_built_, "index has not been built");
+    TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(size_);
+    auto span = RangeBounds(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive);
+    FillRows({span}, *bitset);
+    return bitset;
+}
+
+template <typename T>
+inline CompressedBitset
+ScalarIndexSort<T>::RangeCompressed(T lower_bound_value,
+                                    bool lb_inclusive,
+                                    T upper_bound_value,
+                                    bool ub_inclusive) {
+    AssertInfo(is_built_, "index has not been built");
+    return MatchedRows({RangeBounds(
+        lower_bound_value, lb_inclusive, upper_bound_value, ub_inclusive)});
+}
+
 template <typename T>
 inline T
 ScalarIndexSort<T>::Reverse_Lookup(size_t idx) const {
-    AssertInfo(idx < idx_to_offsets_.size(), "out of range of total count");
+    AssertInfo(idx < size_, "out of range of total count");
     AssertInfo(is_built_, "index has not been built");
 
-    auto offset = idx_to_offsets_[idx];
-    return data_[offset].a_;
+    auto offset = inverse_[idx];
+    return entries_[offset].a_;
+}
+
+template <typename T>
+inline void
+ScalarIndexSort<T>::ReverseLookupRange(size_t begin,
+                                       size_t end,
+                                       T* out) const {
+    AssertInfo(begin <= end && end <= size_, "out of range of total count");
+    AssertInfo(is_built_, "index has not been built");
+    for (auto idx = begin; idx < end; ++idx) {
+        *out++ = entries_[inverse_[idx]].a_;
+    }
+}
+
+template <typename T>
+inline void
+ScalarIndexSort<T>::ReverseLookupBatch(const int64_t* offsets,
+                                       size_t count,
+                                       T* out) const {
+    AssertInfo(is_built_, "index has not been built");
+    for (size_t i = 0; i < count; ++i) {
+        AssertInfo(offsets[i] >= 0 && offsets[i] < size_,
+                   "out of range of total count");
+        out[i] = entries_[inverse_[offsets[i]]].a_;
+    }
 }
 }  // namespace milvus::index
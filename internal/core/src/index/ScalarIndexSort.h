@@ -17,6 +17,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -26,6 +27,31 @@
 
 namespace milvus::index {
 
+// Serialized layout of the sort index of an arithmetic type, one binary
+// named SORT_INDEX_DATA that Load uses in place:
+//
+//   SortIndexHeader
+//   the sorted entries, IndexStructure<T>[row_count], at entries_offset
+//   the sorted position of each row, int32_t[row_count], at inverse_offset
+//
+// Both arrays start SORT_INDEX_ALIGNMENT aligned, so a loaded buffer or a
+// mapped file is queried without copying or rebuilding anything. Indexes
+// of the older index_data / index_length layout still load, by copy.
+constexpr const char* SORT_INDEX_DATA = "sort_index";
+constexpr uint32_t SORT_INDEX_MAGIC = 0x58444953;  // "SIDX"
+constexpr uint32_t SORT_INDEX_VERSION = 2;
+constexpr uint64_t SORT_INDEX_ALIGNMENT = 64;
+
+struct SortIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t row_count;
+    uint32_t entry_size;
+    uint32_t reserved;
+    uint64_t entries_offset;
+    uint64_t inverse_offset;
+};
+
 template <typename T>
 class ScalarIndexSort : public ScalarIndex<T> {
  public:
@@ -35,12 +61,23 @@ class ScalarIndexSort : public ScalarIndex<T> {
     BinarySet
     Serialize(const Config& config) override;
 
+    // with MMAP_FILE_PATH in the config, the index is written to that file
+    // and mapped from it, the file is unlinked right away
     void
     Load(const BinarySet& index_binary, const Config& config = {}) override;
 
+    // maps the SORT_INDEX_DATA binary saved as the file at path
+    void
+    LoadFile(const std::string& path);
+
     int64_t
     Count() override {
-        return data_.size();
+        return size_;
+    }
+
+    int64_t
+    MemoryUsage() const override {
+        return memory_usage_;
     }
 
     void
@@ -49,6 +86,9 @@ class ScalarIndexSort : public ScalarIndex<T> {
     const TargetBitmapPtr
     In(size_t n, const T* values) override;
 
+    CompressedBitset
+    InCompressed(size_t n, const T* values) override;
+
     const TargetBitmapPtr
     NotIn(size_t n, const T* values) override;
 
@@ -61,18 +101,51 @@ class ScalarIndexSort : public ScalarIndex<T> {
           T upper_bound_value,
           bool ub_inclusive) override;
 
+    CompressedBitset
+    RangeCompressed(T value, OpType op) override;
+
+    CompressedBitset
+    RangeCompressed(T lower_bound_value,
+                    bool lb_inclusive,
+                    T upper_bound_value,
+                    bool ub_inclusive) override;
+
     T
     Reverse_Lookup(size_t offset) const override;
 
+    void
+    ReverseLookupRange(size_t begin, size_t end, T* out) const override;
+
+    void
+    ReverseLookupBatch(const int64_t* offsets,
+                       size_t count,
+                       T* out) const override;
+
     int64_t
     Size() override {
-        return (int64_t)data_.size();
+        return (int64_t)size_;
     }
 
  public:
-    const std::vector<IndexStructure<T>>&
-    GetData() {
-        return data_;
+    // the sorted entries, wherever they are kept
+    struct Entries {
+        const IndexStructure<T>* data;
+        size_t count;
+
+        size_t
+        size() const {
+            return count;
+        }
+
+        const IndexStructure<T>&
+        operator[](size_t i) const {
+            return data[i];
+        }
+    };
+
+    Entries
+    GetData() const {
+        return {entries_, size_};
     }
 
     bool
@@ -80,11 +153,75 @@ class ScalarIndexSort : public ScalarIndex<T> {
         return is_built_;
     }
 
+ private:
+    using ConstIterator = const IndexStructure<T>*;
+
+    ConstIterator
+    Begin() const {
+        return entries_;
+    }
+
+    ConstIterator
+    End() const {
+        return entries_ + size_;
+    }
+
+    // queries the owned data_ and idx_to_offsets_
+    void
+    UseOwnedData();
+
+    // queries a SORT_INDEX_DATA buffer in place, kept alive by holder
+    void
+    UseBuffer(std::shared_ptr<const void> holder,
+              const uint8_t* data,
+              size_t size);
+
+    std::pair<ConstIterator, ConstIterator>
+    RangeBounds(T value, OpType op) const;
+
+    std::pair<ConstIterator, ConstIterator>
+    RangeBounds(T lower_bound_value,
+                bool lb_inclusive,
+                T upper_bound_value,
+                bool ub_inclusive) const;
+
+    // the first entry in [begin, end) not satisfying less, searched with
+    // doubling steps from begin, so nearby answers cost few comparisons
+    template <typename Less>
+    static ConstIterator
+    Gallop(ConstIterator begin, ConstIterator end, Less less);
+
+    // the entries equal to any of the values, as sorted disjoint spans; the
+    // values are sorted and deduplicated, then merged with data_ in one pass
+    std::vector<std::pair<ConstIterator, ConstIterator>>
+    EqualSpans(size_t n, const T* values) const;
+
+    // sets the rows of the entries in spans, sorted and disjoint, in a
+    // cleared bitset; when they are most of the index, fills it and clears
+    // the rows between the spans instead
+    void
+    FillRows(const std::vector<std::pair<ConstIterator, ConstIterator>>& spans,
+             TargetBitmap& bitset) const;
+
+    // rows of the entries in spans, as an array of offsets if sparse
+    CompressedBitset
+    MatchedRows(
+        const std::vector<std::pair<ConstIterator, ConstIterator>>& spans)
+        const;
+
  private:
     bool is_built_;
     Config config_;
+    // owned unless the index queries a loaded buffer
     std::vector<int32_t> idx_to_offsets_;  // used to retrieve.
     std::vector<IndexStructure<T>> data_;
+    // what the queries read, data_ and idx_to_offsets_ or the buffer
+    const IndexStructure<T>* entries_ = nullptr;
+    const int32_t* inverse_ = nullptr;
+    size_t size_ = 0;
+    std::shared_ptr<const void> buffer_;
+    // of the owned data or the buffer, whichever the queries read
+    int64_t memory_usage_ = 0;
 };
 
 template <typename T>
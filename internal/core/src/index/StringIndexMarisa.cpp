@@ -20,10 +20,16 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <array>
+#include <unordered_map>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "index/StringIndexMarisa.h"
 #include "index/Utils.h"
 #include "index/Index.h"
+#include "common/MemoryUsage.h"
 #include "common/Utils.h"
 #include "common/Slice.h"
 
@@ -36,6 +42,16 @@ StringIndexMarisa::Size() {
     return trie_.size();
 }
 
+int64_t
+StringIndexMarisa::MemoryUsage() const {
+    // the trie is only there once built or loaded
+    if (str_ids_.size() == 0) {
+        return 0;
+    }
+    return trie_.io_size() + str_ids_.memory_bytes() +
+           postings_.memory_bytes();
+}
+
 void
 StringIndexMarisa::Build(size_t n, const std::string* values) {
     if (built_) {
@@ -51,8 +67,8 @@ StringIndexMarisa::Build(size_t n, const std::string* values) {
     }
 
     trie_.build(keyset);
-    fill_str_ids(n, values);
-    fill_offsets();
+    auto str_ids = lookup_str_ids(n, values);
+    fill_str_ids(str_ids.data(), n);
 
     built_ = true;
 }
@@ -78,9 +94,11 @@ StringIndexMarisa::Serialize(const Config& config) {
     close(fd);
     remove(file.c_str());
 
+    // kept as size_t per row for the indexes already written
     auto str_ids_len = str_ids_.size() * sizeof(size_t);
     std::shared_ptr<uint8_t[]> str_ids(new uint8_t[str_ids_len]);
-    memcpy(str_ids.get(), str_ids_.data(), str_ids_len);
+    str_ids_.Decode(
+        0, str_ids_.size(), reinterpret_cast<size_t*>(str_ids.get()));
 
     BinarySet res_set;
     res_set.Append(MARISA_TRIE_INDEX, index_data, size);
@@ -93,20 +111,25 @@ StringIndexMarisa::Serialize(const Config& config) {
 
 void
 StringIndexMarisa::Load(const BinarySet& set, const Config& config) {
-    milvus::Assemble(const_cast<BinarySet&>(set));
+    // read the slices as they are instead of assembling a copy of each
+    auto index = GetSlices(set, MARISA_TRIE_INDEX);
+    AssertInfo(!index.empty(), "marisa trie index not found");
 
     auto uuid = boost::uuids::random_generator()();
     auto uuid_string = boost::uuids::to_string(uuid);
     auto file = std::string("/tmp/") + uuid_string;
 
-    auto index = set.GetByName(MARISA_TRIE_INDEX);
-    auto len = index->size;
-
     auto fd = open(
         file.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IXUSR);
-    lseek(fd, 0, SEEK_SET);
-    while (write(fd, index->data.get(), len) != len) {
-        lseek(fd, 0, SEEK_SET);
+    for (auto& slice : index) {
+        auto pos = slice->data.get();
+        auto left = slice->size;
+        while (left > 0) {
+            auto written = write(fd, pos, left);
+            AssertInfo(written > 0, "failed to write marisa trie index");
+            pos += written;
+            left -= written;
+        }
     }
 
     lseek(fd, 0, SEEK_SET);
@@ -114,12 +137,10 @@ StringIndexMarisa::Load(const BinarySet& set, const Config& config) {
     close(fd);
     remove(file.c_str());
 
-    auto str_ids = set.GetByName(MARISA_STR_IDS);
-    auto str_ids_len = str_ids->size;
-    str_ids_.resize(str_ids_len / sizeof(size_t));
-    memcpy(str_ids_.data(), str_ids->data.get(), str_ids_len);
-
-    fill_offsets();
+    auto str_id_slices = GetSlices(set, MARISA_STR_IDS);
+    std::vector<size_t> str_ids(SlicesSize(str_id_slices) / sizeof(size_t));
+    CopySlices(str_id_slices, str_ids.data());
+    fill_str_ids(str_ids.data(), str_ids.size());
 }
 
 bool
@@ -134,10 +155,7 @@ StringIndexMarisa::In(size_t n, const std::string* values) {
         auto str = values[i];
         auto str_id = lookup(str);
         if (valid_str_id(str_id)) {
-            auto offsets = str_ids_to_offsets_[str_id];
-            for (auto offset : offsets) {
-                bitset->set(offset);
-            }
+            postings_.Fill(str_id, *bitset);
         }
     }
     return bitset;
@@ -151,10 +169,7 @@ StringIndexMarisa::NotIn(size_t n, const std::string* values) {
         auto str = values[i];
         auto str_id = lookup(str);
         if (valid_str_id(str_id)) {
-            auto offsets = str_ids_to_offsets_[str_id];
-            for (auto offset : offsets) {
-                bitset->reset(offset);
-            }
+            postings_.Fill(str_id, *bitset, false);
         }
     }
     return bitset;
@@ -164,9 +179,10 @@ const TargetBitmapPtr
 StringIndexMarisa::Range(std::string value, OpType op) {
     auto count = Count();
     TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(count);
+    // each distinct string compared once, its rows set from its postings
     marisa::Agent agent;
-    for (size_t offset = 0; offset < count; ++offset) {
-        agent.set_query(str_ids_[offset]);
+    for (size_t str_id = 0; str_id < trie_.size(); ++str_id) {
+        agent.set_query(str_id);
         trie_.reverse_lookup(agent);
         std::string raw_data(agent.key().ptr(), agent.key().length());
         bool set = false;
@@ -189,7 +205,7 @@ StringIndexMarisa::Range(std::string value, OpType op) {
                     std::to_string((int)op) + "!");
         }
         if (set) {
-            bitset->set(offset);
+            postings_.Fill(str_id, *bitset);
         }
     }
     return bitset;
@@ -208,8 +224,8 @@ StringIndexMarisa::Range(std::string lower_bound_value,
         return bitset;
     }
     marisa::Agent agent;
-    for (size_t offset = 0; offset < count; ++offset) {
-        agent.set_query(str_ids_[offset]);
+    for (size_t str_id = 0; str_id < trie_.size(); ++str_id) {
+        agent.set_query(str_id);
         trie_.reverse_lookup(agent);
         std::string raw_data(agent.key().ptr(), agent.key().length());
         bool set = true;
@@ -224,7 +240,7 @@ StringIndexMarisa::Range(std::string lower_bound_value,
             set &= raw_data.compare(upper_bound_value) < 0;
         }
         if (set) {
-            bitset->set(offset);
+            postings_.Fill(str_id, *bitset);
         }
     }
     return bitset;
@@ -235,34 +251,31 @@ StringIndexMarisa::PrefixMatch(std::string prefix) {
     TargetBitmapPtr bitset = std::make_unique<TargetBitmap>(str_ids_.size());
     auto matched = prefix_match(prefix);
     for (const auto str_id : matched) {
-        auto offsets = str_ids_to_offsets_[str_id];
-        for (auto offset : offsets) {
-            bitset->set(offset);
-        }
+        postings_.Fill(str_id, *bitset);
     }
     return bitset;
 }
 
-void
-StringIndexMarisa::fill_str_ids(size_t n, const std::string* values) {
-    str_ids_.resize(n);
-    for (size_t i = 0; i < n; i++) {
-        auto str = values[i];
-        auto str_id = lookup(str);
-        assert(valid_str_id(str_id));
-        str_ids_[i] = str_id;
-    }
+std::vector<uint32_t>
+StringIndexMarisa::lookup_str_ids(size_t n, const std::string* values) {
+    std::vector<uint32_t> str_ids(n);
+    // lookups only read the built trie
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                          for (auto i = range.begin(); i < range.end(); ++i) {
+                              auto str_id = lookup(values[i]);
+                              assert(valid_str_id(str_id));
+                              str_ids[i] = str_id;
+                          }
+                      });
+    return str_ids;
 }
 
+template <typename Id>
 void
-StringIndexMarisa::fill_offsets() {
-    for (size_t offset = 0; offset < str_ids_.size(); offset++) {
-        auto str_id = str_ids_[offset];
-        if (str_ids_to_offsets_.find(str_id) == str_ids_to_offsets_.end()) {
-            str_ids_to_offsets_[str_id] = std::vector<size_t>{};
-        }
-        str_ids_to_offsets_[str_id].push_back(offset);
-    }
+StringIndexMarisa::fill_str_ids(const Id* str_ids, size_t n) {
+    postings_ = PostingLists(trie_.size(), str_ids, n);
+    str_ids_ = PackedIds(str_ids, n, trie_.size());
 }
 
 size_t
@@ -292,11 +305,58 @@ std::string
 StringIndexMarisa::Reverse_Lookup(size_t offset) const {
     AssertInfo(offset < str_ids_.size(), "out of range of total count");
     marisa::Agent agent;
-    agent.set_query(str_ids_[offset]);
+    agent.set_query(size_t(str_ids_[offset]));
     trie_.reverse_lookup(agent);
     return std::string(agent.key().ptr(), agent.key().length());
 }
 
+void
+StringIndexMarisa::ReverseLookupRange(size_t begin,
+                                      size_t end,
+                                      std::string* out) const {
+    AssertInfo(begin <= end && end <= str_ids_.size(),
+               "out of range of total count");
+    std::vector<size_t> str_ids(end - begin);
+    str_ids_.Decode(begin, end, str_ids.data());
+    reverse_lookup(str_ids.data(), str_ids.size(), out);
+}
+
+void
+StringIndexMarisa::ReverseLookupBatch(const int64_t* offsets,
+                                      size_t count,
+                                      std::string* out) const {
+    std::vector<size_t> str_ids(count);
+    for (size_t i = 0; i < count; ++i) {
+        AssertInfo(offsets[i] >= 0 && offsets[i] < str_ids_.size(),
+                   "out of range of total count");
+        str_ids[i] = str_ids_[offsets[i]];
+    }
+    reverse_lookup(str_ids.data(), count, out);
+}
+
+void
+StringIndexMarisa::reverse_lookup(const size_t* str_ids,
+                                  size_t count,
+                                  std::string* out) const {
+    // direct mapped by str_id: the str_id last decoded to a slot and
+    // where in out it went
+    constexpr size_t cache_slots = 1024;
+    std::array<std::pair<size_t, size_t>, cache_slots> cache;
+    cache.fill({MARISA_INVALID_KEY_ID, 0});
+    marisa::Agent agent;
+    for (size_t i = 0; i < count; ++i) {
+        auto& slot = cache[str_ids[i] % cache_slots];
+        if (slot.first == str_ids[i]) {
+            out[i] = out[slot.second];
+            continue;
+        }
+        slot = {str_ids[i], i};
+        agent.set_query(str_ids[i]);
+        trie_.reverse_lookup(agent);
+        out[i].assign(agent.key().ptr(), agent.key().length());
+    }
+}
+
 #endif
 
 }  // namespace milvus::index
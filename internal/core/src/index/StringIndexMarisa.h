@@ -19,6 +19,8 @@
 #if defined(__linux__) || defined(__APPLE__)
 
 #include <marisa.h>
+#include "index/PackedIds.h"
+#include "index/PostingList.h"
 #include "index/StringIndex.h"
 #include <string>
 #include <vector>
@@ -45,6 +47,9 @@ class StringIndexMarisa : public StringIndex {
         return str_ids_.size();
     }
 
+    int64_t
+    MemoryUsage() const override;
+
     void
     Build(size_t n, const std::string* values) override;
 
@@ -69,12 +74,25 @@ class StringIndexMarisa : public StringIndex {
     std::string
     Reverse_Lookup(size_t offset) const override;
 
- private:
     void
-    fill_str_ids(size_t n, const std::string* values);
+    ReverseLookupRange(size_t begin,
+                       size_t end,
+                       std::string* out) const override;
 
     void
-    fill_offsets();
+    ReverseLookupBatch(const int64_t* offsets,
+                       size_t count,
+                       std::string* out) const override;
+
+ private:
+    // the str_id of every value in the built trie
+    std::vector<uint32_t>
+    lookup_str_ids(size_t n, const std::string* values);
+
+    // packs str_ids into str_ids_ and builds postings_ from them
+    template <typename Id>
+    void
+    fill_str_ids(const Id* str_ids, size_t n);
 
     // get str_id by str, if str not found, -1 was returned.
     size_t
@@ -83,11 +101,18 @@ class StringIndexMarisa : public StringIndex {
     std::vector<size_t>
     prefix_match(const std::string& prefix);
 
+    // the strings of str_ids into out, an id repeated nearby read from
+    // the trie once
+    void
+    reverse_lookup(const size_t* str_ids, size_t count, std::string* out) const;
+
  private:
     Config config_;
     marisa::Trie trie_;
-    std::vector<size_t> str_ids_;  // used to retrieve.
-    std::map<size_t, std::vector<size_t>> str_ids_to_offsets_;
+    // the str_id of each row, at the bits of the largest
+    PackedIds str_ids_;
+    // the rows of each str_id
+    PostingLists postings_;
     bool built_ = false;
 };
 
@@ -15,6 +15,7 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cmath>
 #include <tuple>
 #include <vector>
 #include <functional>
@@ -51,6 +52,19 @@ BIN_List() {
     return ret;
 }
 
+// indexes keeping the vectors they are built from as they are
+std::vector<IndexType>
+RAW_DATA_List() {
+    static std::vector<IndexType> ret{
+        knowhere::IndexEnum::INDEX_FAISS_IDMAP,
+        knowhere::IndexEnum::INDEX_FAISS_IVFFLAT,
+        knowhere::IndexEnum::INDEX_HNSW,
+        knowhere::IndexEnum::INDEX_FAISS_BIN_IDMAP,
+        knowhere::IndexEnum::INDEX_FAISS_BIN_IVFFLAT,
+    };
+    return ret;
+}
+
 std::vector<IndexType>
 DISK_LIST() {
     static std::vector<IndexType> ret{
@@ -78,6 +92,11 @@ is_in_nm_list(const IndexType& index_type) {
     return is_in_list<IndexType>(index_type, NM_List);
 }
 
+bool
+is_in_raw_data_list(const IndexType& index_type) {
+    return is_in_list<IndexType>(index_type, RAW_DATA_List);
+}
+
 bool
 is_in_disk_list(const IndexType& index_type) {
     return is_in_list<IndexType>(index_type, DISK_LIST);
@@ -217,4 +236,44 @@ ParseConfigFromIndexParams(
     return config;
 }
 
+uint32_t
+DiskAnnMaxSearchList(int64_t topk) {
+    auto max_list = std::max(topk * 10, int64_t(200));
+    return uint32_t(std::min(max_list, int64_t(65535)));
+}
+
+DiskAnnSearchParams
+AdaptDiskAnnSearch(int64_t topk,
+                   double pass_ratio,
+                   const std::string& profile,
+                   uint32_t base_beamwidth) {
+    // search list of an unfiltered query as a multiple of topk, and a floor
+    // keeping small topk from a list too short to converge
+    double factor;
+    int64_t floor;
+    if (profile == "latency") {
+        factor = 1.5;
+        floor = 16;
+    } else if (profile == "balanced") {
+        factor = 2;
+        floor = 32;
+    } else if (profile == "recall") {
+        factor = 4;
+        floor = 64;
+    } else {
+        PanicInfo("unknown " + std::string(DISK_ANN_QUERY_PROFILE) + ": " +
+                  profile);
+    }
+    auto max_list = double(DiskAnnMaxSearchList(topk));
+    auto base_list = std::min(std::max(topk * factor, double(floor)), max_list);
+    // a filter keeping few rows needs that many more candidates visited
+    pass_ratio = std::clamp(pass_ratio, 1e-3, 1.0);
+    auto list = std::max(std::min(base_list / pass_ratio, max_list),
+                         double(topk));
+    // a wider beam reads the longer list in fewer round trips
+    auto beamwidth = std::clamp(
+        std::round(base_beamwidth * std::sqrt(list / base_list)), 1.0, 16.0);
+    return {uint32_t(list), uint32_t(beamwidth)};
+}
+
 }  // namespace milvus::index
@@ -41,6 +41,9 @@ NM_List();
 std::vector<IndexType>
 BIN_List();
 
+std::vector<IndexType>
+RAW_DATA_List();
+
 std::vector<std::tuple<IndexType, MetricType>>
 unsupported_index_combinations();
 
@@ -60,6 +63,9 @@ is_in_nm_list(const IndexType& index_type);
 bool
 is_in_disk_list(const IndexType& index_type);
 
+bool
+is_in_raw_data_list(const IndexType& index_type);
+
 bool
 is_unsupported(const IndexType& index_type, const MetricType& metric_type);
 
@@ -124,4 +130,22 @@ Config
 ParseConfigFromIndexParams(
     const std::map<std::string, std::string>& index_params);
 
+// the largest search_list a DiskANN query for topk takes
+uint32_t
+DiskAnnMaxSearchList(int64_t topk);
+
+struct DiskAnnSearchParams {
+    uint32_t search_list;
+    uint32_t beamwidth;
+};
+
+// search_list and beamwidth of a DiskANN query for topk rows out of the
+// pass_ratio of rows its filter keeps. the search list grows as the filter
+// drops candidates, the beam widens with it from base_beamwidth
+DiskAnnSearchParams
+AdaptDiskAnnSearch(int64_t topk,
+                   double pass_ratio,
+                   const std::string& profile,
+                   uint32_t base_beamwidth);
+
 }  // namespace milvus::index
@@ -15,25 +15,53 @@
 // limitations under the License.
 
 #include "index/VectorDiskIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
 #include "index/Meta.h"
 #include "index/Utils.h"
 
 #include "storage/LocalChunkManager.h"
+#include "storage/LocalIndexCache.h"
 #include "config/ConfigKnowhere.h"
 #include "storage/Util.h"
+#include "common/BuildContext.h"
+#include "common/Common.h"
 #include "common/Consts.h"
 #include "common/Utils.h"
 #include "common/RangeSearchHelper.h"
+#include "log/Log.h"
+#include "simd/hook.h"
 
 namespace milvus::index {
 
 #ifdef BUILD_DISK_ANN
 
-#define kSearchListMaxValue1 200    // used if tok <= 20
-#define kSearchListMaxValue2 65535  // used for topk > 20
 #define kPrepareDim 100
 #define kPrepareRows 1
 
+namespace {
+
+// bytes of disk_index_cache_budget granted to the loaded disk indexes
+std::atomic<int64_t> granted_cache_bytes = 0;
+
+// up to wanted bytes of what is left of the budget
+int64_t
+GrantCacheBytes(int64_t wanted) {
+    auto granted = granted_cache_bytes.load();
+    int64_t grant;
+    do {
+        grant = std::clamp<int64_t>(
+            milvus::disk_index_cache_budget - granted, 0, wanted);
+    } while (!granted_cache_bytes.compare_exchange_weak(granted,
+                                                        granted + grant));
+    return grant;
+}
+
+}  // namespace
+
 template <typename T>
 VectorDiskAnnIndex<T>::VectorDiskAnnIndex(
     const IndexType& index_type,
@@ -41,25 +69,34 @@ VectorDiskAnnIndex<T>::VectorDiskAnnIndex(
     const IndexMode& index_mode,
     storage::FileManagerImplPtr file_manager)
     : VectorIndex(index_type, index_mode, metric_type) {
+    // its raw data files are written as read, not normalized
+    AssertInfo(!NormalizesVectors(),
+               index_type + " doesn't support metric: " + metric_type);
     file_manager_ =
         std::dynamic_pointer_cast<storage::DiskFileManagerImpl>(file_manager);
     auto& local_chunk_manager = storage::LocalChunkManager::GetInstance();
     auto local_index_path_prefix = file_manager_->GetLocalIndexObjectPrefix();
 
-    // As we have guarded dup-load in QueryNode,
-    // this assertion failed only if the Milvus rebooted in the same pod,
-    // need to remove these files then re-load the segment
-    if (local_chunk_manager.Exist(local_index_path_prefix)) {
-        local_chunk_manager.RemoveDir(local_index_path_prefix);
+    // the files left by a released load of the same index may be reused,
+    // any others are from a Milvus rebooted in the same pod and have to go
+    if (!storage::LocalIndexCache::GetInstance().Contains(
+            local_index_path_prefix)) {
+        if (local_chunk_manager.Exist(local_index_path_prefix)) {
+            local_chunk_manager.RemoveDir(local_index_path_prefix);
+        }
+        local_chunk_manager.CreateDir(local_index_path_prefix);
     }
-
-    local_chunk_manager.CreateDir(local_index_path_prefix);
     auto diskann_index_pack =
         knowhere::Pack(std::shared_ptr<knowhere::FileManager>(file_manager));
     index_ = knowhere::IndexFactory::Instance().Create(GetIndexType(),
                                                        diskann_index_pack);
 }
 
+template <typename T>
+VectorDiskAnnIndex<T>::~VectorDiskAnnIndex() {
+    granted_cache_bytes -= load_stats_.cache_budget;
+}
+
 template <typename T>
 void
 VectorDiskAnnIndex<T>::Load(const BinarySet& binary_set /* not used */,
@@ -70,7 +107,27 @@ VectorDiskAnnIndex<T>::Load(const BinarySet& binary_set /* not used */,
         GetValueFromConfig<std::vector<std::string>>(config, "index_files");
     AssertInfo(index_files.has_value(),
                "index file paths is empty when load disk ann index data");
-    file_manager_->CacheIndexToDisk(index_files.value());
+    load_stats_.reused_local_files =
+        file_manager_->CacheIndexToDisk(index_files.value());
+
+    auto start = std::chrono::steady_clock::now();
+    auto warm_up = disk_index_warm_up;
+    load_stats_.warm_up = warm_up;
+    granted_cache_bytes -= load_stats_.cache_budget;
+    load_stats_.cache_budget = 0;
+    if (warm_up != "none") {
+        auto& local_chunk_manager = storage::LocalChunkManager::GetInstance();
+        // the node cache holds at most the whole index
+        int64_t index_bytes = 0;
+        for (auto& path : file_manager_->GetLocalFilePaths()) {
+            index_bytes += local_chunk_manager.Size(path);
+        }
+        load_stats_.cache_budget = GrantCacheBytes(index_bytes);
+        load_config[DISK_ANN_SEARCH_CACHE_BUDGET] =
+            double(load_stats_.cache_budget) / (1 << 30);
+        load_config[DISK_ANN_PREPARE_USE_BFS_CACHE] = warm_up == "bfs";
+        load_config[DISK_ANN_PREPARE_WARM_UP] = true;
+    }
 
     // todo : replace by index::load function later
     knowhere::DataSetPtr qs = std::make_unique<knowhere::DataSet>();
@@ -82,6 +139,17 @@ VectorDiskAnnIndex<T>::Load(const BinarySet& binary_set /* not used */,
     index_.Search(*qs, load_config, nullptr);
 
     SetDim(index_.Dim());
+    load_stats_.prepare_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    LOG_SEGCORE_INFO_C << "loaded disk index "
+                       << file_manager_->GetLocalIndexObjectPrefix()
+                       << ", reused local files: "
+                       << load_stats_.reused_local_files
+                       << ", warm up: " << load_stats_.warm_up
+                       << ", cache budget: " << load_stats_.cache_budget
+                       << ", prepared in " << load_stats_.prepare_ms << "ms";
 }
 
 template <typename T>
@@ -89,23 +157,11 @@ void
 VectorDiskAnnIndex<T>::BuildWithDataset(const DatasetPtr& dataset,
                                         const Config& config) {
     auto& local_chunk_manager = storage::LocalChunkManager::GetInstance();
-    knowhere::Json build_config;
-    build_config.update(config);
     // set data path
     auto segment_id = file_manager_->GetFileDataMeta().segment_id;
     auto field_id = file_manager_->GetFileDataMeta().field_id;
     auto local_data_path =
         storage::GenFieldRawDataPathPrefix(segment_id, field_id) + "raw_data";
-    build_config[DISK_ANN_RAW_DATA_PATH] = local_data_path;
-
-    auto local_index_path_prefix = file_manager_->GetLocalIndexObjectPrefix();
-    build_config[DISK_ANN_PREFIX_PATH] = local_index_path_prefix;
-
-    auto num_threads = GetValueFromConfig<std::string>(
-        build_config, DISK_ANN_BUILD_THREAD_NUM);
-    AssertInfo(num_threads.has_value(),
-               "param " + std::string(DISK_ANN_BUILD_THREAD_NUM) + "is empty");
-    build_config[DISK_ANN_THREADS_NUM] = std::atoi(num_threads.value().c_str());
 
     if (!local_chunk_manager.Exist(local_data_path)) {
         local_chunk_manager.CreateFile(local_data_path);
@@ -124,9 +180,52 @@ VectorDiskAnnIndex<T>::BuildWithDataset(const DatasetPtr& dataset,
     auto raw_data = const_cast<void*>(milvus::GetDatasetTensor(dataset));
     local_chunk_manager.Write(local_data_path, offset, raw_data, data_size);
 
+    BuildFromRawDataFile(local_data_path, config);
+}
+
+template <typename T>
+void
+VectorDiskAnnIndex<T>::BuildFromBinlogs(
+    const std::vector<std::string>& insert_files,
+    const storage::FileManagerImplPtr& file_manager /* not used */,
+    const Config& config) {
+    ReportBuildProgress("download", 0);
+    BuildFromRawDataFile(file_manager_->CacheRawDataToDisk(insert_files),
+                         config);
+}
+
+template <typename T>
+void
+VectorDiskAnnIndex<T>::BuildFromRawDataFile(const std::string& local_data_path,
+                                            const Config& config) {
+    auto& local_chunk_manager = storage::LocalChunkManager::GetInstance();
+    knowhere::Json build_config;
+    build_config.update(config);
+    build_config[DISK_ANN_RAW_DATA_PATH] = local_data_path;
+
+    auto local_index_path_prefix = file_manager_->GetLocalIndexObjectPrefix();
+    build_config[DISK_ANN_PREFIX_PATH] = local_index_path_prefix;
+
+    // the thread budget of the build context caps the configured threads
+    auto num_threads = GetValueFromConfig<std::string>(
+        build_config, DISK_ANN_BUILD_THREAD_NUM);
+    auto context = CurrentBuildContext();
+    auto budget = context != nullptr ? context->num_threads() : 0;
+    AssertInfo(num_threads.has_value() || budget > 0,
+               "param " + std::string(DISK_ANN_BUILD_THREAD_NUM) + "is empty");
+    auto threads = num_threads.has_value()
+                       ? int64_t(std::atoi(num_threads.value().c_str()))
+                       : budget;
+    if (budget > 0) {
+        threads = std::min(threads, budget);
+    }
+    build_config[DISK_ANN_THREADS_NUM] = threads;
+
+    ReportBuildProgress("build", 0);
     knowhere::DataSet* ds_ptr = nullptr;
     index_.Build(*ds_ptr, build_config);
 
+    auto segment_id = file_manager_->GetFileDataMeta().segment_id;
     local_chunk_manager.RemoveDir(
         storage::GetSegmentRawDataPathPrefix(segment_id));
     // TODO ::
@@ -143,28 +242,39 @@ VectorDiskAnnIndex<T>::Query(const DatasetPtr dataset,
     auto num_queries = dataset->GetRows();
     auto topk = search_info.topk_;
 
-    knowhere::Json search_config = search_info.search_params_;
+    // the disk index adds keys of its own to a copy of the parsed json
+    auto params = search_info.GetParams();
+    knowhere::Json search_config = params->index_conf_;
 
     search_config[knowhere::meta::TOPK] = topk;
     search_config[knowhere::meta::METRIC_TYPE] = GetMetricType();
 
-    // set search list size
+    // set search list size and beamwidth, picked per query if the search
+    // list is not given
     auto search_list_size = GetValueFromConfig<uint32_t>(
         search_info.search_params_, DISK_ANN_QUERY_LIST);
-    AssertInfo(search_list_size.has_value(),
-               "param " + std::string(DISK_ANN_QUERY_LIST) + "is empty");
-    AssertInfo(search_list_size.value() >= topk,
-               "search_list should be greater than or equal to topk");
-    AssertInfo(
-        search_list_size.value() <=
-                std::max(uint32_t(topk * 10), uint32_t(kSearchListMaxValue1)) &&
-            search_list_size.value() <= uint32_t(kSearchListMaxValue2),
-        "search_list should be less than max(topk*10, 200) and less than "
-        "65535");
+    auto beamwidth = search_beamwidth_;
+    if (search_list_size.has_value()) {
+        AssertInfo(search_list_size.value() >= topk,
+                   "search_list should be greater than or equal to topk");
+        AssertInfo(search_list_size.value() <= DiskAnnMaxSearchList(topk),
+                   "search_list should be less than max(topk*10, 200) and "
+                   "less than 65535");
+    } else {
+        auto profile = GetValueFromConfig<std::string>(
+                           search_info.search_params_, DISK_ANN_QUERY_PROFILE)
+                           .value_or("balanced");
+        auto pass_ratio =
+            bitset.empty() ? 1.0
+                           : 1.0 - double(bitset.count()) / bitset.size();
+        auto params =
+            AdaptDiskAnnSearch(topk, pass_ratio, profile, search_beamwidth_);
+        search_list_size = params.search_list;
+        beamwidth = params.beamwidth;
+        search_config.erase(DISK_ANN_QUERY_PROFILE);
+    }
     search_config[DISK_ANN_SEARCH_LIST_SIZE] = search_list_size.value();
-
-    // set beamwidth
-    search_config[DISK_ANN_QUERY_BEAMWIDTH] = int(search_beamwidth_);
+    search_config[DISK_ANN_QUERY_BEAMWIDTH] = int(beamwidth);
 
     // set index prefix, will be removed later
     auto local_index_path_prefix = file_manager_->GetLocalIndexObjectPrefix();
@@ -174,16 +284,12 @@ VectorDiskAnnIndex<T>::Query(const DatasetPtr dataset,
     search_config[DISK_ANN_PQ_CODE_BUDGET] = 0.0;
 
     auto final = [&] {
-        auto radius =
-            GetValueFromConfig<float>(search_info.search_params_, RADIUS);
-        if (radius.has_value()) {
-            search_config[RADIUS] = radius.value();
-            auto range_filter = GetValueFromConfig<float>(
-                search_info.search_params_, RANGE_FILTER);
-            if (range_filter.has_value()) {
-                search_config[RANGE_FILTER] = range_filter.value();
-                CheckRangeSearchParam(search_config[RADIUS],
-                                      search_config[RANGE_FILTER],
+        if (params->radius_.has_value()) {
+            search_config[RADIUS] = params->radius_.value();
+            if (params->range_filter_.has_value()) {
+                search_config[RANGE_FILTER] = params->range_filter_.value();
+                CheckRangeSearchParam(params->radius_.value(),
+                                      params->range_filter_.value(),
                                       GetMetricType());
             }
             auto res = index_.RangeSearch(*dataset, search_config, bitset);
@@ -207,26 +313,20 @@ VectorDiskAnnIndex<T>::Query(const DatasetPtr dataset,
     }();
 
     auto ids = final->GetIds();
-    float* distances = const_cast<float*>(final->GetDistance());
+    auto distances = final->GetDistance();
     final->SetIsOwner(true);
 
-    auto round_decimal = search_info.round_decimal_;
     auto total_num = num_queries * topk;
 
-    if (round_decimal != -1) {
-        const float multiplier = pow(10.0, round_decimal);
-        for (int i = 0; i < total_num; i++) {
-            distances[i] = round(distances[i] * multiplier) / multiplier;
-        }
-    }
+    // knowhere owns its buffers, so the distances are copied once and
+    // rounded in the result, the only rounding on this path
     auto result = std::make_unique<SearchResult>();
-    result->seg_offsets_.resize(total_num);
-    result->distances_.resize(total_num);
+    result->seg_offsets_.assign(ids, ids + total_num);
+    result->distances_.assign(distances, distances + total_num);
     result->total_nq_ = num_queries;
     result->unity_topK_ = topk;
-
-    std::copy_n(ids, total_num, result->seg_offsets_.data());
-    std::copy_n(distances, total_num, result->distances_.data());
+    simd::RoundDecimal(
+        result->distances_.data(), total_num, search_info.round_decimal_);
 
     return result;
 }
@@ -17,12 +17,26 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "common/Consts.h"
 #include "index/VectorIndex.h"
 #include "storage/DiskFileManagerImpl.h"
 
 namespace milvus::index {
 
+// what the last load of a disk index did besides reading it
+struct DiskAnnLoadStats {
+    // the local files of an earlier load of the same index were used
+    bool reused_local_files = false;
+    std::string warm_up = DEFAULT_DISK_INDEX_WARM_UP;
+    // bytes of disk_index_cache_budget granted to the node cache
+    int64_t cache_budget = 0;
+    // opening the index, caching its nodes and warming it up
+    int64_t prepare_ms = 0;
+};
+
 #ifdef BUILD_DISK_ANN
 
 template <typename T>
@@ -32,6 +46,9 @@ class VectorDiskAnnIndex : public VectorIndex {
                                 const MetricType& metric_type,
                                 const IndexMode& index_mode,
                                 storage::FileManagerImplPtr file_manager);
+
+    // returns the cache budget granted to the index
+    ~VectorDiskAnnIndex() override;
     BinarySet
     Serialize(const Config& config) override {
         auto remote_paths_to_size = file_manager_->GetRemotePathsToFileSize();
@@ -48,6 +65,12 @@ class VectorDiskAnnIndex : public VectorIndex {
         return index_.Count();
     }
 
+    // the part of the index cached in memory, the rest stays on disk
+    int64_t
+    MemoryUsage() const override {
+        return index_.Size();
+    }
+
     void
     Load(const BinarySet& binary_set /* not used */,
          const Config& config = {}) override;
@@ -56,6 +79,12 @@ class VectorDiskAnnIndex : public VectorIndex {
     BuildWithDataset(const DatasetPtr& dataset,
                      const Config& config = {}) override;
 
+    // reads the binlogs through the file manager the index was created with
+    void
+    BuildFromBinlogs(const std::vector<std::string>& insert_files,
+                     const storage::FileManagerImplPtr& file_manager,
+                     const Config& config = {}) override;
+
     std::unique_ptr<SearchResult>
     Query(const DatasetPtr dataset,
           const SearchInfo& search_info,
@@ -64,14 +93,24 @@ class VectorDiskAnnIndex : public VectorIndex {
     void
     CleanLocalData() override;
 
+    const DiskAnnLoadStats&
+    GetLoadStats() const {
+        return load_stats_;
+    }
+
  private:
     knowhere::Json
     update_load_json(const Config& config);
 
+    void
+    BuildFromRawDataFile(const std::string& local_data_path,
+                         const Config& config);
+
  private:
     knowhere::Index<knowhere::IndexNode> index_;
     std::shared_ptr<storage::DiskFileManagerImpl> file_manager_;
     uint32_t search_beamwidth_ = 8;
+    DiskAnnLoadStats load_stats_;
 };
 
 template <typename T>
@@ -19,7 +19,7 @@
 #include <map>
 #include <memory>
 #include <string>
-#include <boost/dynamic_bitset.hpp>
+#include <vector>
 
 #include "knowhere/factory.h"
 #include "index/Index.h"
@@ -27,6 +27,8 @@
 #include "common/BitsetView.h"
 #include "common/QueryResult.h"
 #include "common/QueryInfo.h"
+#include "common/Utils.h"
+#include "storage/FileManager.h"
 
 namespace milvus::index {
 
@@ -37,7 +39,8 @@ class VectorIndex : public IndexBase {
                          const MetricType& metric_type)
         : index_type_(index_type),
           index_mode_(index_mode),
-          metric_type_(metric_type) {
+          metric_type_(SearchMetric(metric_type)),
+          normalize_vectors_(IsCosine(metric_type)) {
     }
 
  public:
@@ -48,21 +51,50 @@ class VectorIndex : public IndexBase {
         PanicInfo("vector index don't support build index with raw data");
     };
 
+    // builds the index from the vectors in the insert binlogs, read
+    // through file_manager a batch at a time rather than from one buffer
+    virtual void
+    BuildFromBinlogs(const std::vector<std::string>& insert_files,
+                     const storage::FileManagerImplPtr& file_manager,
+                     const Config& config = {}) {
+        PanicInfo(index_type_ + " doesn't support build index from binlogs");
+    }
+
     virtual std::unique_ptr<SearchResult>
     Query(const DatasetPtr dataset,
           const SearchInfo& search_info,
           const BitsetView& bitset) = 0;
 
+    // whether GetVector can return the vectors the index was built from
+    virtual bool
+    HasRawData() const {
+        return false;
+    }
+
+    // copies the vectors of rows ids into output, row after row
+    virtual void
+    GetVector(const int64_t* ids, int64_t count, void* output) const {
+        PanicInfo(index_type_ + " doesn't keep raw vectors");
+    }
+
     IndexType
     GetIndexType() const {
         return index_type_;
     }
 
+    // the metric the index searches by, inner product for cosine
     MetricType
     GetMetricType() const {
         return metric_type_;
     }
 
+    // whether the index is of a cosine field, built over its vectors
+    // scaled to unit length
+    bool
+    NormalizesVectors() const {
+        return normalize_vectors_;
+    }
+
     IndexMode
     GetIndexMode() const {
         return index_mode_;
@@ -86,6 +118,7 @@ class VectorIndex : public IndexBase {
     IndexType index_type_;
     IndexMode index_mode_;
     MetricType metric_type_;
+    bool normalize_vectors_;
     int64_t dim_;
 };
 
@@ -23,10 +23,17 @@
 #include "knowhere/factory.h"
 #include "knowhere/comp/Timer.h"
 #include "common/BitsetView.h"
+#include "common/BuildContext.h"
 #include "common/Slice.h"
 #include "common/Consts.h"
 #include "common/RangeSearchHelper.h"
 #include "common/Utils.h"
+#include "simd/hook.h"
+
+#ifdef BUILD_DISK_ANN
+#include "storage/DiskFileManagerImpl.h"
+#include "storage/Util.h"
+#endif
 
 namespace milvus::index {
 
@@ -34,7 +41,7 @@ VectorMemIndex::VectorMemIndex(const IndexType& index_type,
                                const MetricType& metric_type,
                                const IndexMode& index_mode)
     : VectorIndex(index_type, index_mode, metric_type) {
-    AssertInfo(!is_unsupported(index_type, metric_type),
+    AssertInfo(!is_unsupported(index_type, GetMetricType()),
                index_type + " doesn't support metric: " + metric_type);
 
     index_ = knowhere::IndexFactory::Instance().Create(GetIndexType());
@@ -68,16 +75,106 @@ VectorMemIndex::BuildWithDataset(const DatasetPtr& dataset,
                                  const Config& config) {
     knowhere::Json index_config;
     index_config.update(config);
+    index_config[knowhere::meta::METRIC_TYPE] = GetMetricType();
 
     SetDim(dataset->GetDim());
 
+    auto build_dataset = dataset;
+    std::vector<float> normalized;
+    if (NormalizesVectors()) {
+        auto rows = dataset->GetRows();
+        auto dim = dataset->GetDim();
+        auto tensor = static_cast<const float*>(dataset->GetTensor());
+        normalized.assign(tensor, tensor + rows * dim);
+        NormalizeVectors(normalized.data(), rows, dim);
+        build_dataset = knowhere::GenDataSet(rows, dim, normalized.data());
+    }
+
     knowhere::TimeRecorder rc("BuildWithoutIds", 1);
-    auto stat = index_.Build(*dataset, index_config);
+    auto stat = index_.Build(*build_dataset, index_config);
     if (stat != knowhere::Status::success)
         PanicCodeInfo(ErrorCodeEnum::BuildIndexError,
                       "failed to build index, " + MatchKnowhereError(stat));
+    ReportBuildProgress("add", rows_added, rows_added);
+    rc.ElapseFromBegin("Done");
+    SetDim(index_.Dim());
+}
+
+void
+VectorMemIndex::BuildFromBinlogs(
+    const std::vector<std::string>& insert_files,
+    const storage::FileManagerImplPtr& file_manager,
+    const Config& config) {
+#ifdef BUILD_DISK_ANN
+    auto reader =
+        std::dynamic_pointer_cast<storage::DiskFileManagerImpl>(file_manager);
+    AssertInfo(reader != nullptr,
+               "build index from binlogs needs a remote file manager");
+    knowhere::Json build_config;
+    build_config.update(config);
+    build_config[knowhere::meta::METRIC_TYPE] = GetMetricType();
+
+    knowhere::TimeRecorder rc("BuildFromBinlogs", 1);
+    std::vector<uint8_t> sample;
+    int64_t sample_rows = 0;
+    int64_t dim = 0;
+    int64_t rows_added = 0;
+    bool trained = false;
+    auto add = [&](int64_t rows, const void* data) {
+        ReportBuildProgress("add", rows_added);
+        auto dataset = knowhere::GenDataSet(rows, dim, data);
+        auto stat = index_.Add(*dataset, build_config);
+        if (stat != knowhere::Status::success)
+            PanicCodeInfo(ErrorCodeEnum::BuildIndexError,
+                          "failed to add to index, " + MatchKnowhereError(stat));
+        rows_added += rows;
+    };
+    auto train = [&] {
+        ReportBuildProgress("train", 0, sample_rows);
+        auto dataset = knowhere::GenDataSet(sample_rows, dim, sample.data());
+        auto stat = index_.Train(*dataset, build_config);
+        if (stat != knowhere::Status::success)
+            PanicCodeInfo(ErrorCodeEnum::BuildIndexError,
+                          "failed to train index, " + MatchKnowhereError(stat));
+        add(sample_rows, sample.data());
+        std::vector<uint8_t>().swap(sample);
+        trained = true;
+    };
+
+    std::vector<float> normalized;
+    reader->ForEachRawData(insert_files, [&](const storage::Payload& payload) {
+        AssertInfo(payload.dimension.has_value(),
+                   "raw data of vector index is not a vector field");
+        dim = payload.dimension.value();
+        auto raw_data = payload.raw_data;
+        if (NormalizesVectors()) {
+            auto values = reinterpret_cast<const float*>(payload.raw_data);
+            normalized.assign(values, values + payload.rows * dim);
+            NormalizeVectors(normalized.data(), payload.rows, dim);
+            raw_data = reinterpret_cast<const uint8_t*>(normalized.data());
+        }
+        if (trained) {
+            add(payload.rows, raw_data);
+            return;
+        }
+        sample.insert(sample.end(),
+                      raw_data,
+                      raw_data + storage::GetPayloadSize(&payload));
+        sample_rows += payload.rows;
+        ReportBuildProgress("sample", sample_rows);
+        if (sample_rows >= DEFAULT_INDEX_TRAIN_SAMPLE_ROWS) {
+            train();
+        }
+    });
+    if (!trained) {
+        AssertInfo(sample_rows > 0, "no rows in insert binlogs");
+        train();
+    }
     rc.ElapseFromBegin("Done");
     SetDim(index_.Dim());
+#else
+    PanicInfo("build index from binlogs needs a remote chunk manager");
+#endif
 }
 
 std::unique_ptr<SearchResult>
@@ -88,17 +185,18 @@ VectorMemIndex::Query(const DatasetPtr dataset,
     //               "Metric type of field index isn't the same with search info");
 
     auto num_queries = dataset->GetRows();
-    knowhere::Json search_conf = search_info.search_params_;
     auto topk = search_info.topk_;
+    // parsed once per plan, the json is only copied if the topk or the
+    // metric type differ from those of the plan
+    auto params = search_info.GetParams();
+    knowhere::Json scratch;
+    auto& search_conf = params->IndexConf(topk, GetMetricType(), scratch);
     // TODO :: check dim of search data
     auto final = [&] {
-        search_conf[knowhere::meta::TOPK] = topk;
-        search_conf[knowhere::meta::METRIC_TYPE] = GetMetricType();
-        auto index_type = GetIndexType();
-        if (CheckKeyInConfig(search_conf, RADIUS)) {
-            if (CheckKeyInConfig(search_conf, RANGE_FILTER)) {
-                CheckRangeSearchParam(search_conf[RADIUS],
-                                      search_conf[RANGE_FILTER],
+        if (params->radius_.has_value()) {
+            if (params->range_filter_.has_value()) {
+                CheckRangeSearchParam(params->radius_.value(),
+                                      params->range_filter_.value(),
                                       GetMetricType());
             }
             auto res = index_.RangeSearch(*dataset, search_conf, bitset);
@@ -121,27 +219,52 @@ VectorMemIndex::Query(const DatasetPtr dataset,
     }();
 
     auto ids = final->GetIds();
-    float* distances = const_cast<float*>(final->GetDistance());
+    auto distances = final->GetDistance();
     final->SetIsOwner(true);
-    auto round_decimal = search_info.round_decimal_;
     auto total_num = num_queries * topk;
 
-    if (round_decimal != -1) {
-        const float multiplier = pow(10.0, round_decimal);
-        for (int i = 0; i < total_num; i++) {
-            distances[i] = round(distances[i] * multiplier) / multiplier;
-        }
-    }
+    // knowhere owns its buffers, so the distances are copied once and
+    // rounded in the result, the only rounding on this path
     auto result = std::make_unique<SearchResult>();
-    result->seg_offsets_.resize(total_num);
-    result->distances_.resize(total_num);
+    result->seg_offsets_.assign(ids, ids + total_num);
+    result->distances_.assign(distances, distances + total_num);
     result->total_nq_ = num_queries;
     result->unity_topK_ = topk;
-
-    std::copy_n(ids, total_num, result->seg_offsets_.data());
-    std::copy_n(distances, total_num, result->distances_.data());
+    simd::RoundDecimal(
+        result->distances_.data(), total_num, search_info.round_decimal_);
 
     return result;
 }
 
+bool
+VectorMemIndex::HasRawData() const {
+    return is_in_raw_data_list(GetIndexType());
+}
+
+void
+VectorMemIndex::GetVector(const int64_t* ids,
+                          int64_t count,
+                          void* output) const {
+    AssertInfo(HasRawData(), GetIndexType() + " doesn't keep raw vectors");
+    auto row_bytes = is_in_bin_list(GetIndexType())
+                         ? GetDim() / 8
+                         : GetDim() * int64_t(sizeof(float));
+    auto dst = static_cast<uint8_t*>(output);
+    // knowhere returns a fresh copy of every batch
+    constexpr int64_t batch_rows = 4096;
+    for (int64_t begin = 0; begin < count; begin += batch_rows) {
+        auto rows = std::min(batch_rows, count - begin);
+        auto ids_dataset = knowhere::GenIdsDataSet(rows, ids + begin);
+        auto res = index_.GetVectorByIds(*ids_dataset, knowhere::Json());
+        if (!res.has_value()) {
+            PanicCodeInfo(ErrorCodeEnum::UnexpectedError,
+                          "failed to get vectors by ids, " +
+                              MatchKnowhereError(res.error()));
+        }
+        auto vectors = res.value();
+        vectors->SetIsOwner(true);
+        memcpy(dst + begin * row_bytes, vectors->GetTensor(), rows * row_bytes);
+    }
+}
+
 }  // namespace milvus::index
@@ -20,7 +20,6 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <boost/dynamic_bitset.hpp>
 #include "knowhere/factory.h"
 #include "index/VectorIndex.h"
 
@@ -42,16 +41,34 @@ class VectorMemIndex : public VectorIndex {
     BuildWithDataset(const DatasetPtr& dataset,
                      const Config& config = {}) override;
 
+    // trains on the first DEFAULT_INDEX_TRAIN_SAMPLE_ROWS rows, then adds
+    // the rows of each later binlog as it is read
+    void
+    BuildFromBinlogs(const std::vector<std::string>& insert_files,
+                     const storage::FileManagerImplPtr& file_manager,
+                     const Config& config = {}) override;
+
     int64_t
     Count() override {
         return index_.Count();
     }
 
+    int64_t
+    MemoryUsage() const override {
+        return index_.Size();
+    }
+
     std::unique_ptr<SearchResult>
     Query(const DatasetPtr dataset,
           const SearchInfo& search_info,
           const BitsetView& bitset) override;
 
+    bool
+    HasRawData() const override;
+
+    void
+    GetVector(const int64_t* ids, int64_t count, void* output) const override;
+
  protected:
     Config config_;
     knowhere::Index<knowhere::IndexNode> index_;
@@ -19,6 +19,7 @@
 #include "common/BitsetView.h"
 #include "index/VectorMemNMIndex.h"
 #include "log/Log.h"
+#include "storage/ThreadPool.h"
 
 #include "knowhere/factory.h"
 #include "knowhere/comp/Timer.h"
@@ -26,8 +27,15 @@
 
 namespace milvus::index {
 
+VectorMemNMIndex::~VectorMemNMIndex() {
+    if (raw_data_loaded_.valid()) {
+        raw_data_loaded_.wait();
+    }
+}
+
 BinarySet
 VectorMemNMIndex::Serialize(const Config& config) {
+    WaitRawData();
     knowhere::BinarySet ret;
     auto stat = index_.Serialize(ret);
     if (stat != knowhere::Status::success)
@@ -50,15 +58,19 @@ VectorMemNMIndex::BuildWithDataset(const DatasetPtr& dataset,
     knowhere::TimeRecorder rc("store_raw_data", 1);
     store_raw_data(dataset);
     rc.ElapseFromBegin("Done");
+    // rather than on the first query
+    raw_data_loaded_ =
+        storage::ThreadPool::GetInstance(storage::ThreadPoolType::LOAD)
+            .Submit([this] { LoadRawData(); })
+            .share();
 }
 
 void
 VectorMemNMIndex::Load(const BinarySet& binary_set, const Config& config) {
+    WaitRawData();
     VectorMemIndex::Load(binary_set, config);
     if (binary_set.Contains(RAW_DATA)) {
-        std::call_once(raw_data_loaded_, [&]() {
-            LOG_SEGCORE_INFO_C << "NM index load raw data done!";
-        });
+        LOG_SEGCORE_INFO_C << "NM index load raw data done!";
     }
 }
 
@@ -66,14 +78,25 @@ std::unique_ptr<SearchResult>
 VectorMemNMIndex::Query(const DatasetPtr dataset,
                         const SearchInfo& search_info,
                         const BitsetView& bitset) {
-    auto load_raw_data_closure = [&]() { LoadRawData(); };  // hide this pointer
     // load -> query, raw data has been loaded
-    // build -> query, this case just for test, should load raw data before query
-    std::call_once(raw_data_loaded_, load_raw_data_closure);
-
+    // build -> query, this case just for test, the raw data may still be
+    // on its way into the index
+    WaitRawData();
     return VectorMemIndex::Query(dataset, search_info, bitset);
 }
 
+int64_t
+VectorMemNMIndex::MemoryUsage() const {
+    auto bytes = VectorMemIndex::MemoryUsage();
+    // the raw data is not to be touched while a build hands it over
+    if (!raw_data_loaded_.valid() ||
+        raw_data_loaded_.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready) {
+        bytes += raw_data_.capacity();
+    }
+    return bytes;
+}
+
 void
 VectorMemNMIndex::store_raw_data(const DatasetPtr& dataset) {
     auto index_type = GetIndexType();
@@ -90,6 +113,22 @@ VectorMemNMIndex::store_raw_data(const DatasetPtr& dataset) {
     memcpy(raw_data_.data(), tensor, data_size);
 }
 
+void
+VectorMemNMIndex::GetVector(const int64_t* ids,
+                            int64_t count,
+                            void* output) const {
+    WaitRawData();
+    VectorMemIndex::GetVector(ids, count, output);
+}
+
+void
+VectorMemNMIndex::WaitRawData() const {
+    if (raw_data_loaded_.valid()) {
+        // rethrows if handing the raw data to the index failed
+        raw_data_loaded_.get();
+    }
+}
+
 void
 VectorMemNMIndex::LoadRawData() {
     knowhere::BinarySet bs;
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
@@ -35,6 +36,8 @@ class VectorMemNMIndex : public VectorMemIndex {
         AssertInfo(is_in_nm_list(index_type), "not valid nm index type");
     }
 
+    ~VectorMemNMIndex() override;
+
     BinarySet
     Serialize(const Config& config) override;
 
@@ -42,6 +45,14 @@ class VectorMemNMIndex : public VectorMemIndex {
     BuildWithDataset(const DatasetPtr& dataset,
                      const Config& config = {}) override;
 
+    // the raw data is kept with the index, so it is built from one dataset
+    void
+    BuildFromBinlogs(const std::vector<std::string>& insert_files,
+                     const storage::FileManagerImplPtr& file_manager,
+                     const Config& config = {}) override {
+        PanicInfo(GetIndexType() + " doesn't support build index from binlogs");
+    }
+
     void
     Load(const BinarySet& binary_set, const Config& config = {}) override;
 
@@ -50,6 +61,12 @@ class VectorMemNMIndex : public VectorMemIndex {
           const SearchInfo& search_info,
           const BitsetView& bitset) override;
 
+    void
+    GetVector(const int64_t* ids, int64_t count, void* output) const override;
+
+    int64_t
+    MemoryUsage() const override;
+
  private:
     void
     store_raw_data(const DatasetPtr& dataset);
@@ -57,9 +74,14 @@ class VectorMemNMIndex : public VectorMemIndex {
     void
     LoadRawData();
 
+    // waits for the raw data a build hands to the index in the background
+    void
+    WaitRawData() const;
+
  private:
     std::vector<uint8_t> raw_data_;
-    std::once_flag raw_data_loaded_;
+    // set after a build, a loaded index gets its raw data with the binary set
+    std::shared_future<void> raw_data_loaded_;
 };
 
 using VectorMemNMIndexPtr = std::unique_ptr<VectorMemNMIndex>;
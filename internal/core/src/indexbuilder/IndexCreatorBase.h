@@ -12,6 +12,7 @@
 #pragma once
 
 #include <memory>
+#include "common/BuildContext.h"
 #include "common/Types.h"
 
 namespace milvus::indexbuilder {
@@ -28,6 +29,15 @@ class IndexCreatorBase {
     // used for test.
     virtual void
     Load(const milvus::BinarySet&) = 0;
+
+    // the builds and serialization after this run under context
+    void
+    SetBuildContext(BuildContextPtr context) {
+        build_context_ = std::move(context);
+    }
+
+ protected:
+    BuildContextPtr build_context_ = nullptr;
 };
 
 using IndexCreatorBasePtr = std::unique_ptr<IndexCreatorBase>;
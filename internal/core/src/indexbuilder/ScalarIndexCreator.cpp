@@ -10,11 +10,14 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include "indexbuilder/ScalarIndexCreator.h"
+#include "index/BitmapIndex.h"
+#include "common/Metrics.h"
 #include "index/IndexFactory.h"
 #include "index/IndexInfo.h"
 #include "index/Meta.h"
 #include "index/Utils.h"
 #include "pb/index_cgo_msg.pb.h"
+#include "pb/schema.pb.h"
 
 #include <string>
 
@@ -50,13 +53,63 @@ ScalarIndexCreator::ScalarIndexCreator(DataType dtype,
 
 void
 ScalarIndexCreator::Build(const milvus::DatasetPtr& dataset) {
+    SEGCORE_METRIC_TIMER(IndexBuildLatency);
+    BuildContextScope scope(build_context_.get());
     auto size = dataset->GetRows();
     auto data = dataset->GetTensor();
+    ReportBuildProgress("build", 0, size);
+    if (fits_bitmap_index(size, data)) {
+        milvus::index::CreateIndexInfo index_info;
+        index_info.field_type = dtype_;
+        index_info.index_type = index::BITMAP_INDEX_TYPE;
+        index_info.index_mode = IndexMode::MODE_CPU;
+        index_ = index::IndexFactory::GetInstance().CreateIndex(index_info,
+                                                                nullptr);
+    }
     index_->BuildWithRawData(size, data);
+    ReportBuildProgress("build", size, size);
+}
+
+bool
+ScalarIndexCreator::fits_bitmap_index(int64_t size, const void* data) {
+    switch (dtype_) {
+        case DataType::INT8:
+            return index::FitsBitmapIndex(
+                size, reinterpret_cast<const int8_t*>(data));
+        case DataType::INT16:
+            return index::FitsBitmapIndex(
+                size, reinterpret_cast<const int16_t*>(data));
+        case DataType::INT32:
+            return index::FitsBitmapIndex(
+                size, reinterpret_cast<const int32_t*>(data));
+        case DataType::INT64:
+            return index::FitsBitmapIndex(
+                size, reinterpret_cast<const int64_t*>(data));
+        case DataType::FLOAT:
+            return index::FitsBitmapIndex(
+                size, reinterpret_cast<const float*>(data));
+        case DataType::DOUBLE:
+            return index::FitsBitmapIndex(
+                size, reinterpret_cast<const double*>(data));
+        case DataType::STRING:
+        case DataType::VARCHAR: {
+            // size is the byte size of the serialized array
+            proto::schema::StringArray arr;
+            if (!arr.ParseFromArray(data, size)) {
+                return false;
+            }
+            return index::FitsBitmapIndex(arr.data_size(),
+                                          arr.data().data());
+        }
+        default:
+            return false;
+    }
 }
 
 milvus::BinarySet
 ScalarIndexCreator::Serialize() {
+    BuildContextScope scope(build_context_.get());
+    ReportBuildProgress("serialize", 0);
     return index_->Serialize(config_);
 }
 
@@ -39,6 +39,10 @@ class ScalarIndexCreator : public IndexCreatorBase {
     std::string
     index_type();
 
+    // the values have few enough distinct ones for a bitmap index
+    bool
+    fits_bitmap_index(int64_t size, const void* data);
+
  private:
     index::IndexBasePtr index_ = nullptr;
     Config config_;
@@ -11,6 +11,7 @@
 
 #include <map>
 
+#include "common/Metrics.h"
 #include "exceptions/EasyAssert.h"
 #include "indexbuilder/VecIndexCreator.h"
 #include "index/Utils.h"
@@ -27,7 +28,7 @@ VecIndexCreator::VecIndexCreator(DataType data_type,
                                  const char* serialized_type_params,
                                  const char* serialized_index_params,
                                  const storage::StorageConfig& storage_config)
-    : data_type_(data_type) {
+    : data_type_(data_type), storage_config_(storage_config) {
     proto::indexcgo::TypeParams type_params_;
     proto::indexcgo::IndexParams index_params_;
     milvus::index::ParseFromString(type_params_,
@@ -51,11 +52,10 @@ VecIndexCreator::VecIndexCreator(DataType data_type,
     index_info.index_type = index::GetIndexTypeFromConfig(config_);
     index_info.metric_type = index::GetMetricTypeFromConfig(config_);
 
-    std::shared_ptr<storage::FileManagerImpl> file_manager = nullptr;
 #ifdef BUILD_DISK_ANN
     if (index::is_in_disk_list(index_info.index_type)) {
         // For now, only support diskann index
-        file_manager = std::make_shared<storage::DiskFileManagerImpl>(
+        file_manager_ = std::make_shared<storage::DiskFileManagerImpl>(
             index::GetFieldDataMetaFromConfig(config_),
             index::GetIndexMetaFromConfig(config_),
             storage_config);
@@ -63,7 +63,7 @@ VecIndexCreator::VecIndexCreator(DataType data_type,
 #endif
 
     index_ = index::IndexFactory::GetInstance().CreateIndex(index_info,
-                                                            file_manager);
+                                                            file_manager_);
     AssertInfo(index_ != nullptr,
                "[VecIndexCreator]Index is null after create index");
 }
@@ -75,11 +75,35 @@ VecIndexCreator::dim() {
 
 void
 VecIndexCreator::Build(const milvus::DatasetPtr& dataset) {
+    SEGCORE_METRIC_TIMER(IndexBuildLatency);
+    BuildContextScope scope(build_context_.get());
+    auto rows = dataset->GetRows();
+    ReportBuildProgress("build", 0, rows);
     index_->BuildWithDataset(dataset, config_);
+    ReportBuildProgress("build", rows, rows);
+}
+
+void
+VecIndexCreator::BuildFromBinlogs(const std::vector<std::string>& insert_files) {
+    SEGCORE_METRIC_TIMER(IndexBuildLatency);
+    BuildContextScope scope(build_context_.get());
+#ifdef BUILD_DISK_ANN
+    // memory indexes only need the file manager to read the binlogs
+    if (file_manager_ == nullptr) {
+        file_manager_ = std::make_shared<storage::DiskFileManagerImpl>(
+            index::GetFieldDataMetaFromConfig(config_),
+            index::GetIndexMetaFromConfig(config_),
+            storage_config_);
+    }
+#endif
+    auto vector_index = dynamic_cast<index::VectorIndex*>(index_.get());
+    vector_index->BuildFromBinlogs(insert_files, file_manager_, config_);
 }
 
 milvus::BinarySet
 VecIndexCreator::Serialize() {
+    BuildContextScope scope(build_context_.get());
+    ReportBuildProgress("serialize", 0);
     return index_->Serialize(config_);
 }
 
@@ -34,6 +34,10 @@ class VecIndexCreator : public IndexCreatorBase {
     void
     Build(const milvus::DatasetPtr& dataset) override;
 
+    // builds from the insert binlogs in remote storage, a batch at a time
+    void
+    BuildFromBinlogs(const std::vector<std::string>& insert_files);
+
     milvus::BinarySet
     Serialize() override;
 
@@ -56,6 +60,8 @@ class VecIndexCreator : public IndexCreatorBase {
     milvus::index::IndexBasePtr index_ = nullptr;
     Config config_;
     DataType data_type_;
+    storage::StorageConfig storage_config_;
+    storage::FileManagerImplPtr file_manager_ = nullptr;
 };
 
 }  // namespace milvus::indexbuilder
@@ -10,6 +10,7 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <string>
+#include <vector>
 
 #ifdef __linux__
 #include <malloc.h>
@@ -108,6 +109,31 @@ BuildFloatVecIndex(CIndex index,
     return status;
 }
 
+CStatus
+BuildVecIndexFromBinlogs(CIndex index,
+                         const char** insert_files,
+                         int64_t insert_files_num) {
+    auto status = CStatus();
+    try {
+        AssertInfo(
+            index,
+            "failed to build vector index from binlogs, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        auto cIndex =
+            dynamic_cast<milvus::indexbuilder::VecIndexCreator*>(real_index);
+        std::vector<std::string> files(insert_files,
+                                       insert_files + insert_files_num);
+        cIndex->BuildFromBinlogs(files);
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
 CStatus
 BuildBinaryVecIndex(CIndex index, int64_t data_size, const uint8_t* vectors) {
     auto status = CStatus();
@@ -200,6 +226,62 @@ LoadIndexFromBinarySet(CIndex index, CBinarySet c_binary_set) {
     return status;
 }
 
+CStatus
+NewBuildContext(int64_t num_threads,
+                CBuildProgress progress,
+                void* user_data,
+                CBuildContext* c_build_context) {
+    auto status = CStatus();
+    try {
+        milvus::BuildContext::ProgressFn progress_fn = nullptr;
+        if (progress != nullptr) {
+            progress_fn = [progress, user_data](const std::string& phase,
+                                                int64_t rows_done,
+                                                int64_t rows_total) {
+                progress(user_data, phase.c_str(), rows_done, rows_total);
+            };
+        }
+        auto context = std::make_shared<milvus::BuildContext>(
+            num_threads, std::move(progress_fn));
+        *c_build_context = new milvus::BuildContextPtr(std::move(context));
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
+void
+DeleteBuildContext(CBuildContext c_build_context) {
+    delete static_cast<milvus::BuildContextPtr*>(c_build_context);
+}
+
+void
+CancelBuild(CBuildContext c_build_context) {
+    (*static_cast<milvus::BuildContextPtr*>(c_build_context))->Cancel();
+}
+
+CStatus
+SetIndexBuildContext(CIndex index, CBuildContext c_build_context) {
+    auto status = CStatus();
+    try {
+        AssertInfo(index,
+                   "failed to set build context, passed index was null");
+        auto real_index =
+            reinterpret_cast<milvus::indexbuilder::IndexCreatorBase*>(index);
+        real_index->SetBuildContext(
+            *static_cast<milvus::BuildContextPtr*>(c_build_context));
+        status.error_code = Success;
+        status.error_msg = "";
+    } catch (std::exception& e) {
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+    }
+    return status;
+}
+
 CStatus
 CleanLocalData(CIndex index) {
     auto status = CStatus();
@@ -33,6 +33,13 @@ DeleteIndex(CIndex index);
 CStatus
 BuildFloatVecIndex(CIndex index, int64_t float_value_num, const float* vectors);
 
+// builds a vector index from the insert binlogs of its field in remote
+// storage, streaming them instead of taking the whole column in one buffer
+CStatus
+BuildVecIndexFromBinlogs(CIndex index,
+                         const char** insert_files,
+                         int64_t insert_files_num);
+
 CStatus
 BuildBinaryVecIndex(CIndex index, int64_t data_size, const uint8_t* vectors);
 
@@ -53,6 +60,26 @@ LoadIndexFromBinarySet(CIndex index, CBinarySet c_binary_set);
 CStatus
 CleanLocalData(CIndex index);
 
+// a context for builds to share: num_threads caps the threads of each
+// build running under it, 0 for no cap, and progress, if not null, gets
+// called on the building thread as phases advance
+CStatus
+NewBuildContext(int64_t num_threads,
+                CBuildProgress progress,
+                void* user_data,
+                CBuildContext* c_build_context);
+
+void
+DeleteBuildContext(CBuildContext c_build_context);
+
+// the builds under the context fail at their next progress report
+void
+CancelBuild(CBuildContext c_build_context);
+
+// the builds and serialization of index after this run under the context
+CStatus
+SetIndexBuildContext(CIndex index, CBuildContext c_build_context);
+
 #ifdef __cplusplus
 };
 #endif
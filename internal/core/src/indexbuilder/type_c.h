@@ -15,3 +15,10 @@
 
 typedef void* CIndex;
 typedef void* CIndexQueryResult;
+typedef void* CBuildContext;
+
+// rows_total is -1 while unknown
+typedef void (*CBuildProgress)(void* user_data,
+                               const char* phase,
+                               int64_t rows_done,
+                               int64_t rows_total);
@@ -0,0 +1,251 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/AsyncLogSink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace milvus {
+
+LogRing::LogRing(int64_t capacity) {
+    uint64_t size = 1;
+    while (size < static_cast<uint64_t>(std::max<int64_t>(capacity, 2))) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    slots_ = std::make_unique<Slot[]>(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool
+LogRing::Push(Line&& line) {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        auto seq = slot->seq.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(seq - pos);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->line = std::move(line);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool
+LogRing::Pop(Line& line) {
+    auto& slot = slots_[head_ & mask_];
+    if (slot.seq.load(std::memory_order_acquire) != head_ + 1) {
+        return false;
+    }
+    line = std::move(slot.line);
+    slot.seq.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    return true;
+}
+
+namespace {
+
+const char DEFAULT_DISPATCH[] = "DefaultLogDispatchCallback";
+const char ASYNC_DISPATCH[] = "AsyncLogSink";
+
+// the ring and the thread draining it, created by the first Enable and
+// kept to the end of the process, as lines may be logged until then
+class AsyncLogWriter {
+ public:
+    explicit AsyncLogWriter(int64_t capacity) : ring_(capacity) {
+        std::thread([this] { Run(); }).detach();
+    }
+
+    bool
+    Push(LogRing::Line&& line) {
+        if (!ring_.Push(std::move(line))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        pushed_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    void
+    Flush() {
+        auto pushed = pushed_.load(std::memory_order_acquire);
+        while (written_.load(std::memory_order_acquire) < pushed) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    int64_t
+    Dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    void
+    Run() {
+        LogRing::Line line;
+        while (true) {
+            uint64_t written = 0;
+            while (ring_.Pop(line)) {
+                Write(line);
+                ++written;
+            }
+            if (written == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            }
+            fflush(stdout);
+            for (auto& [name, file] : files_) {
+                fflush(file);
+            }
+            written_.fetch_add(written, std::memory_order_release);
+        }
+    }
+
+    void
+    Write(const LogRing::Line& line) {
+        auto config = line.logger->typedConfigurations();
+        if (config->toFile(line.level)) {
+            auto file = File(config->filename(line.level));
+            if (file != nullptr) {
+                fwrite(line.text.data(), 1, line.text.size(), file);
+            }
+        }
+        if (config->toStandardOutput(line.level)) {
+            fwrite(line.text.data(), 1, line.text.size(), stdout);
+        }
+    }
+
+    FILE*
+    File(const std::string& name) {
+        auto it = files_.find(name);
+        if (it == files_.end()) {
+            it = files_.emplace(name, fopen(name.c_str(), "a")).first;
+        }
+        return it->second;
+    }
+
+ private:
+    LogRing ring_;
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<int64_t> dropped_{0};
+    // by the writing thread only
+    std::unordered_map<std::string, FILE*> files_;
+};
+
+std::mutex writer_mutex;
+std::atomic<AsyncLogWriter*> writer{nullptr};
+
+}  // namespace
+
+void
+AsyncLogSink::Enable(int64_t capacity) {
+    std::lock_guard lck(writer_mutex);
+    if (writer.load() == nullptr) {
+        writer.store(new AsyncLogWriter(capacity));
+        std::atexit([] { AsyncLogSink::Flush(); });
+    }
+    if (el::Helpers::logDispatchCallback<AsyncLogSink>(ASYNC_DISPATCH) ==
+        nullptr) {
+        el::Helpers::installLogDispatchCallback<AsyncLogSink>(ASYNC_DISPATCH);
+    }
+    el::Helpers::logDispatchCallback<AsyncLogSink>(ASYNC_DISPATCH)
+        ->setEnabled(true);
+    auto default_dispatch =
+        el::Helpers::logDispatchCallback<el::base::DefaultLogDispatchCallback>(
+            DEFAULT_DISPATCH);
+    if (default_dispatch != nullptr) {
+        default_dispatch->setEnabled(false);
+    }
+}
+
+void
+AsyncLogSink::Disable() {
+    {
+        std::lock_guard lck(writer_mutex);
+        auto default_dispatch = el::Helpers::logDispatchCallback<
+            el::base::DefaultLogDispatchCallback>(DEFAULT_DISPATCH);
+        if (default_dispatch != nullptr) {
+            default_dispatch->setEnabled(true);
+        }
+        auto sink = el::Helpers::logDispatchCallback<AsyncLogSink>(
+            ASYNC_DISPATCH);
+        if (sink != nullptr) {
+            sink->setEnabled(false);
+        }
+    }
+    Flush();
+}
+
+void
+AsyncLogSink::Flush() {
+    auto current = writer.load();
+    if (current != nullptr) {
+        current->Flush();
+    }
+}
+
+int64_t
+AsyncLogSink::DroppedLines() {
+    auto current = writer.load();
+    return current == nullptr ? 0 : current->Dropped();
+}
+
+void
+AsyncLogSink::handle(const el::LogDispatchData* data) {
+    auto current = writer.load();
+    if (current == nullptr ||
+        data->dispatchAction() != el::base::DispatchAction::NormalLog) {
+        return;
+    }
+    auto message = data->logMessage();
+    LogRing::Line line;
+    line.logger = message->logger();
+    line.level = message->level();
+    line.text = line.logger->logBuilder()->build(message, true);
+    if (line.level != el::Level::Fatal) {
+        current->Push(std::move(line));
+        return;
+    }
+    // the process aborts once this returns
+    auto text = line.text;
+    auto pushed = current->Push(std::move(line));
+    current->Flush();
+    if (!pushed) {
+        fwrite(text.data(), 1, text.size(), stderr);
+        fflush(stderr);
+    }
+}
+
+}  // namespace milvus
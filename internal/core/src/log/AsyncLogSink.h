@@ -0,0 +1,89 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "easyloggingpp/easylogging++.h"
+
+namespace milvus {
+
+// Bounded ring of log lines, any number of threads push and one pops.
+// A slot's sequence tells whose turn it is: pos when free for the push
+// of pos, pos + 1 once filled for the pop of pos.
+class LogRing {
+ public:
+    struct Line {
+        el::Logger* logger = nullptr;
+        el::Level level = el::Level::Unknown;
+        std::string text;
+    };
+
+    // capacity is rounded up to a power of two
+    explicit LogRing(int64_t capacity);
+
+    // false if the ring is full, the line is not taken then
+    bool
+    Push(Line&& line);
+
+    // false if the ring is empty; by the single consumer only
+    bool
+    Pop(Line& line);
+
+ private:
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        Line line;
+    };
+
+    uint64_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    alignas(64) uint64_t head_ = 0;
+};
+
+// Writes the lines of all easylogging loggers from a background thread,
+// to the stdout and files they are configured with, so a logging thread
+// only formats its line and pushes it into a LogRing. A full ring drops
+// lines rather than block, counted by DroppedLines. A fatal line waits
+// until it is written, the process aborts right after.
+class AsyncLogSink : public el::LogDispatchCallback {
+ public:
+    // replaces the default dispatch; a no-op if already enabled
+    static void
+    Enable(int64_t capacity);
+
+    // writes out the queued lines and dispatches in place again
+    static void
+    Disable();
+
+    // waits until the lines logged so far are written
+    static void
+    Flush();
+
+    static int64_t
+    DroppedLines();
+
+ protected:
+    void
+    handle(const el::LogDispatchData* data) override;
+};
+
+}  // namespace milvus
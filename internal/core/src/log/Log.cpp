@@ -50,6 +50,54 @@ LogOut(const char* pattern, ...) {
     return std::string(str_p.get());
 }
 
+void
+RefreshLogLevels() {
+    // fatal lines abort the process, they are never skipped
+    uint32_t levels = static_cast<uint32_t>(el::Level::Fatal);
+    auto logger = el::Loggers::getLogger("default", false);
+    if (logger == nullptr) {
+        log_enabled_levels.store(~0u, std::memory_order_relaxed);
+        return;
+    }
+    for (auto level : {el::Level::Trace,
+                       el::Level::Debug,
+                       el::Level::Error,
+                       el::Level::Warning,
+                       el::Level::Verbose,
+                       el::Level::Info}) {
+        if (logger->typedConfigurations()->enabled(level)) {
+            levels |= static_cast<uint32_t>(level);
+        }
+    }
+    log_enabled_levels.store(levels, std::memory_order_relaxed);
+}
+
+int64_t
+LogRateLimiter::Acquire() {
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+                   .count();
+    auto second = second_.load(std::memory_order_relaxed);
+    if (second != now &&
+        second_.compare_exchange_strong(
+            second, now, std::memory_order_relaxed)) {
+        passed_.store(0, std::memory_order_relaxed);
+    }
+    if (passed_.fetch_add(1, std::memory_order_relaxed) >= per_second_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    return dropped_.exchange(0, std::memory_order_relaxed);
+}
+
+std::string
+LogDroppedNote(int64_t dropped) {
+    if (dropped <= 0) {
+        return "";
+    }
+    return "(" + std::to_string(dropped) + " similar lines dropped) ";
+}
+
 void
 SetThreadName(const std::string& name) {
     // Note: the name cannot exceed 16 bytes
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <sys/types.h>
 #include <unistd.h>
@@ -67,6 +69,67 @@
                << ""                                  \
                << " | " << #module << " | " << error_code << " | "
 
+// the levels enabled for the default logger, a mask of el::Level bits.
+// the segcore and server macros check it first, a disabled statement
+// evaluates none of its operands
+inline std::atomic<uint32_t> log_enabled_levels{~0u};
+
+inline bool
+LogLevelEnabled(el::Level level) {
+    return log_enabled_levels.load(std::memory_order_relaxed) &
+           static_cast<uint32_t>(level);
+}
+
+// re-reads log_enabled_levels, after the loggers got reconfigured
+void
+RefreshLogLevels();
+
+// makes a log statement an expression of type void for the ?: below
+struct LogVoidify {
+    template <typename T>
+    void
+    operator&(T&&) {
+    }
+};
+
+#define LOG_IF_ENABLED_(level) \
+    !LogLevelEnabled(el::Level::level) ? (void)0 : LogVoidify() &
+
+// counts the lines of a call site per second
+class LogRateLimiter {
+ public:
+    explicit LogRateLimiter(int64_t per_second) : per_second_(per_second) {
+    }
+
+    // -1 if the line is dropped, else the number dropped since the last
+    // one let through
+    int64_t
+    Acquire();
+
+ private:
+    const int64_t per_second_;
+    std::atomic<int64_t> second_{0};
+    std::atomic<int64_t> passed_{0};
+    std::atomic<int64_t> dropped_{0};
+};
+
+// the prefix telling about dropped lines, empty if none
+std::string
+LogDroppedNote(int64_t dropped);
+
+// each expansion has its own lambda and so its own limiter
+#define LOG_LIMITED_(level, per_second, statement)                 \
+    for (int64_t log_dropped_ = LogLevelEnabled(el::Level::level) \
+                                    ? [] {                          \
+                                          static LogRateLimiter     \
+                                              limiter(per_second);  \
+                                          return limiter.Acquire(); \
+                                      }()                           \
+                                    : -1;                           \
+         log_dropped_ >= 0;                                         \
+         log_dropped_ = -1)                                         \
+    statement << LogDroppedNote(log_dropped_)
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 #define SEGCORE_MODULE_NAME "SEGCORE"
 #define SEGCORE_MODULE_CLASS_FUNCTION \
@@ -81,20 +144,42 @@
            __FUNCTION__,        \
            GetThreadName().c_str())
 
-#define LOG_SEGCORE_TRACE_C LOG(TRACE) << SEGCORE_MODULE_CLASS_FUNCTION
-#define LOG_SEGCORE_DEBUG_C LOG(DEBUG) << SEGCORE_MODULE_CLASS_FUNCTION
-#define LOG_SEGCORE_INFO_C LOG(INFO) << SEGCORE_MODULE_CLASS_FUNCTION
-#define LOG_SEGCORE_WARNING_C LOG(WARNING) << SEGCORE_MODULE_CLASS_FUNCTION
-#define LOG_SEGCORE_ERROR_C LOG(ERROR) << SEGCORE_MODULE_CLASS_FUNCTION
+#define LOG_SEGCORE_TRACE_C \
+    LOG_IF_ENABLED_(Trace) LOG(TRACE) << SEGCORE_MODULE_CLASS_FUNCTION
+#define LOG_SEGCORE_DEBUG_C \
+    LOG_IF_ENABLED_(Debug) LOG(DEBUG) << SEGCORE_MODULE_CLASS_FUNCTION
+#define LOG_SEGCORE_INFO_C \
+    LOG_IF_ENABLED_(Info) LOG(INFO) << SEGCORE_MODULE_CLASS_FUNCTION
+#define LOG_SEGCORE_WARNING_C \
+    LOG_IF_ENABLED_(Warning) LOG(WARNING) << SEGCORE_MODULE_CLASS_FUNCTION
+#define LOG_SEGCORE_ERROR_C \
+    LOG_IF_ENABLED_(Error) LOG(ERROR) << SEGCORE_MODULE_CLASS_FUNCTION
 #define LOG_SEGCORE_FATAL_C LOG(FATAL) << SEGCORE_MODULE_CLASS_FUNCTION
 
-#define LOG_SEGCORE_TRACE_ LOG(TRACE) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_DEBUG_ LOG(DEBUG) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_INFO_ LOG(INFO) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_WARNING_ LOG(WARNING) << SEGCORE_MODULE_FUNCTION
-#define LOG_SEGCORE_ERROR_ LOG(ERROR) << SEGCORE_MODULE_FUNCTION
+#define LOG_SEGCORE_TRACE_ \
+    LOG_IF_ENABLED_(Trace) LOG(TRACE) << SEGCORE_MODULE_FUNCTION
+#define LOG_SEGCORE_DEBUG_ \
+    LOG_IF_ENABLED_(Debug) LOG(DEBUG) << SEGCORE_MODULE_FUNCTION
+#define LOG_SEGCORE_INFO_ \
+    LOG_IF_ENABLED_(Info) LOG(INFO) << SEGCORE_MODULE_FUNCTION
+#define LOG_SEGCORE_WARNING_ \
+    LOG_IF_ENABLED_(Warning) LOG(WARNING) << SEGCORE_MODULE_FUNCTION
+#define LOG_SEGCORE_ERROR_ \
+    LOG_IF_ENABLED_(Error) LOG(ERROR) << SEGCORE_MODULE_FUNCTION
 #define LOG_SEGCORE_FATAL_ LOG(FATAL) << SEGCORE_MODULE_FUNCTION
 
+// at most per_second lines a second from the call site, the next one let
+// through tells how many were dropped meanwhile; for logs in loops and on
+// the query path
+#define LOG_SEGCORE_DEBUG_LIMITED_(per_second) \
+    LOG_LIMITED_(Debug, per_second, LOG_SEGCORE_DEBUG_)
+#define LOG_SEGCORE_INFO_LIMITED_(per_second) \
+    LOG_LIMITED_(Info, per_second, LOG_SEGCORE_INFO_)
+#define LOG_SEGCORE_WARNING_LIMITED_(per_second) \
+    LOG_LIMITED_(Warning, per_second, LOG_SEGCORE_WARNING_)
+#define LOG_SEGCORE_ERROR_LIMITED_(per_second) \
+    LOG_LIMITED_(Error, per_second, LOG_SEGCORE_ERROR_)
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 #define SERVER_MODULE_NAME "SERVER"
 #define SERVER_MODULE_CLASS_FUNCTION \
@@ -109,18 +194,28 @@
            __FUNCTION__,       \
            GetThreadName().c_str())
 
-#define LOG_SERVER_TRACE_C LOG(TRACE) << SERVER_MODULE_CLASS_FUNCTION
-#define LOG_SERVER_DEBUG_C LOG(DEBUG) << SERVER_MODULE_CLASS_FUNCTION
-#define LOG_SERVER_INFO_C LOG(INFO) << SERVER_MODULE_CLASS_FUNCTION
-#define LOG_SERVER_WARNING_C LOG(WARNING) << SERVER_MODULE_CLASS_FUNCTION
-#define LOG_SERVER_ERROR_C LOG(ERROR) << SERVER_MODULE_CLASS_FUNCTION
+#define LOG_SERVER_TRACE_C \
+    LOG_IF_ENABLED_(Trace) LOG(TRACE) << SERVER_MODULE_CLASS_FUNCTION
+#define LOG_SERVER_DEBUG_C \
+    LOG_IF_ENABLED_(Debug) LOG(DEBUG) << SERVER_MODULE_CLASS_FUNCTION
+#define LOG_SERVER_INFO_C \
+    LOG_IF_ENABLED_(Info) LOG(INFO) << SERVER_MODULE_CLASS_FUNCTION
+#define LOG_SERVER_WARNING_C \
+    LOG_IF_ENABLED_(Warning) LOG(WARNING) << SERVER_MODULE_CLASS_FUNCTION
+#define LOG_SERVER_ERROR_C \
+    LOG_IF_ENABLED_(Error) LOG(ERROR) << SERVER_MODULE_CLASS_FUNCTION
 #define LOG_SERVER_FATAL_C LOG(FATAL) << SERVER_MODULE_CLASS_FUNCTION
 
-#define LOG_SERVER_TRACE_ LOG(TRACE) << SERVER_MODULE_FUNCTION
-#define LOG_SERVER_DEBUG_ LOG(DEBUG) << SERVER_MODULE_FUNCTION
-#define LOG_SERVER_INFO_ LOG(INFO) << SERVER_MODULE_FUNCTION
-#define LOG_SERVER_WARNING_ LOG(WARNING) << SERVER_MODULE_FUNCTION
-#define LOG_SERVER_ERROR_ LOG(ERROR) << SERVER_MODULE_FUNCTION
+#define LOG_SERVER_TRACE_ \
+    LOG_IF_ENABLED_(Trace) LOG(TRACE) << SERVER_MODULE_FUNCTION
+#define LOG_SERVER_DEBUG_ \
+    LOG_IF_ENABLED_(Debug) LOG(DEBUG) << SERVER_MODULE_FUNCTION
+#define LOG_SERVER_INFO_ \
+    LOG_IF_ENABLED_(Info) LOG(INFO) << SERVER_MODULE_FUNCTION
+#define LOG_SERVER_WARNING_ \
+    LOG_IF_ENABLED_(Warning) LOG(WARNING) << SERVER_MODULE_FUNCTION
+#define LOG_SERVER_ERROR_ \
+    LOG_IF_ENABLED_(Error) LOG(ERROR) << SERVER_MODULE_FUNCTION
 #define LOG_SERVER_FATAL_ LOG(FATAL) << SERVER_MODULE_FUNCTION
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,6 +37,19 @@ struct GenericValueDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GenericValueDefaultTypeInternal _GenericValue_default_instance_;
+PROTOBUF_CONSTEXPR PlanParams::PlanParams(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.values_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct PlanParamsDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR PlanParamsDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~PlanParamsDefaultTypeInternal() {}
+  union {
+    PlanParams _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 PlanParamsDefaultTypeInternal _PlanParams_default_instance_;
 PROTOBUF_CONSTEXPR QueryInfo::QueryInfo(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.metric_type_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
@@ -263,10 +276,28 @@ struct VectorANNSDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 VectorANNSDefaultTypeInternal _VectorANNS_default_instance_;
+PROTOBUF_CONSTEXPR Aggregate::Aggregate(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.field_id_)*/int64_t{0}
+  , /*decltype(_impl_.op_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct AggregateDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR AggregateDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~AggregateDefaultTypeInternal() {}
+  union {
+    Aggregate _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 AggregateDefaultTypeInternal _Aggregate_default_instance_;
 PROTOBUF_CONSTEXPR PlanNode::PlanNode(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.output_field_ids_)*/{}
   , /*decltype(_impl_._output_field_ids_cached_byte_size_)*/{0}
+  , /*decltype(_impl_.aggregates_)*/{}
+  , /*decltype(_impl_.limit_)*/int64_t{0}
+  , /*decltype(_impl_.offset_)*/int64_t{0}
+  , /*decltype(_impl_.order_by_pk_)*/false
   , /*decltype(_impl_.node_)*/{}
   , /*decltype(_impl_._cached_size_)*/{}
   , /*decltype(_impl_._oneof_case_)*/{}} {}
@@ -282,8 +313,8 @@ PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORIT
 }  // namespace plan
 }  // namespace proto
 }  // namespace milvus
-static ::_pb::Metadata file_level_metadata_plan_2eproto[17];
-static const ::_pb::EnumDescriptor* file_level_enum_descriptors_plan_2eproto[4];
+static ::_pb::Metadata file_level_metadata_plan_2eproto[19];
+static const ::_pb::EnumDescriptor* file_level_enum_descriptors_plan_2eproto[5];
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_plan_2eproto = nullptr;
 
 const uint32_t TableStruct_plan_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
@@ -297,8 +328,16 @@ const uint32_t TableStruct_plan_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(pro
   ::_pbi::kInvalidFieldOffsetTag,
   ::_pbi::kInvalidFieldOffsetTag,
   ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::GenericValue, _impl_.val_),
   ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanParams, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanParams, _impl_.values_),
+  ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::QueryInfo, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
@@ -444,6 +483,14 @@ const uint32_t TableStruct_plan_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(pro
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::VectorANNS, _impl_.query_info_),
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::VectorANNS, _impl_.placeholder_tag_),
   ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::Aggregate, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::Aggregate, _impl_.op_),
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::Aggregate, _impl_.field_id_),
+  ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _internal_metadata_),
   ~0u,  // no _extensions_
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _impl_._oneof_case_[0]),
@@ -452,30 +499,37 @@ const uint32_t TableStruct_plan_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(pro
   ::_pbi::kInvalidFieldOffsetTag,
   ::_pbi::kInvalidFieldOffsetTag,
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _impl_.output_field_ids_),
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _impl_.limit_),
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _impl_.offset_),
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _impl_.order_by_pk_),
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _impl_.aggregates_),
   PROTOBUF_FIELD_OFFSET(::milvus::proto::plan::PlanNode, _impl_.node_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
   { 0, -1, -1, sizeof(::milvus::proto::plan::GenericValue)},
-  { 11, -1, -1, sizeof(::milvus::proto::plan::QueryInfo)},
-  { 21, -1, -1, sizeof(::milvus::proto::plan::ColumnInfo)},
-  { 31, -1, -1, sizeof(::milvus::proto::plan::ColumnExpr)},
-  { 38, -1, -1, sizeof(::milvus::proto::plan::ValueExpr)},
-  { 45, -1, -1, sizeof(::milvus::proto::plan::UnaryRangeExpr)},
-  { 54, -1, -1, sizeof(::milvus::proto::plan::BinaryRangeExpr)},
-  { 65, -1, -1, sizeof(::milvus::proto::plan::CompareExpr)},
-  { 74, -1, -1, sizeof(::milvus::proto::plan::TermExpr)},
-  { 82, -1, -1, sizeof(::milvus::proto::plan::UnaryExpr)},
-  { 90, -1, -1, sizeof(::milvus::proto::plan::BinaryExpr)},
-  { 99, -1, -1, sizeof(::milvus::proto::plan::BinaryArithOp)},
-  { 108, -1, -1, sizeof(::milvus::proto::plan::BinaryArithExpr)},
-  { 117, -1, -1, sizeof(::milvus::proto::plan::BinaryArithOpEvalRangeExpr)},
-  { 128, -1, -1, sizeof(::milvus::proto::plan::Expr)},
-  { 145, -1, -1, sizeof(::milvus::proto::plan::VectorANNS)},
-  { 156, -1, -1, sizeof(::milvus::proto::plan::PlanNode)},
+  { 12, -1, -1, sizeof(::milvus::proto::plan::PlanParams)},
+  { 19, -1, -1, sizeof(::milvus::proto::plan::QueryInfo)},
+  { 29, -1, -1, sizeof(::milvus::proto::plan::ColumnInfo)},
+  { 39, -1, -1, sizeof(::milvus::proto::plan::ColumnExpr)},
+  { 46, -1, -1, sizeof(::milvus::proto::plan::ValueExpr)},
+  { 53, -1, -1, sizeof(::milvus::proto::plan::UnaryRangeExpr)},
+  { 62, -1, -1, sizeof(::milvus::proto::plan::BinaryRangeExpr)},
+  { 73, -1, -1, sizeof(::milvus::proto::plan::CompareExpr)},
+  { 82, -1, -1, sizeof(::milvus::proto::plan::TermExpr)},
+  { 90, -1, -1, sizeof(::milvus::proto::plan::UnaryExpr)},
+  { 98, -1, -1, sizeof(::milvus::proto::plan::BinaryExpr)},
+  { 107, -1, -1, sizeof(::milvus::proto::plan::BinaryArithOp)},
+  { 116, -1, -1, sizeof(::milvus::proto::plan::BinaryArithExpr)},
+  { 125, -1, -1, sizeof(::milvus::proto::plan::BinaryArithOpEvalRangeExpr)},
+  { 136, -1, -1, sizeof(::milvus::proto::plan::Expr)},
+  { 153, -1, -1, sizeof(::milvus::proto::plan::VectorANNS)},
+  { 164, -1, -1, sizeof(::milvus::proto::plan::Aggregate)},
+  { 172, -1, -1, sizeof(::milvus::proto::plan::PlanNode)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
   &::milvus::proto::plan::_GenericValue_default_instance_._instance,
+  &::milvus::proto::plan::_PlanParams_default_instance_._instance,
   &::milvus::proto::plan::_QueryInfo_default_instance_._instance,
   &::milvus::proto::plan::_ColumnInfo_default_instance_._instance,
   &::milvus::proto::plan::_ColumnExpr_default_instance_._instance,
@@ -491,103 +545,112 @@ static const ::_pb::Message* const file_default_instances[] = {
   &::milvus::proto::plan::_BinaryArithOpEvalRangeExpr_default_instance_._instance,
   &::milvus::proto::plan::_Expr_default_instance_._instance,
   &::milvus::proto::plan::_VectorANNS_default_instance_._instance,
+  &::milvus::proto::plan::_Aggregate_default_instance_._instance,
   &::milvus::proto::plan::_PlanNode_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_plan_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
   "\n\nplan.proto\022\021milvus.proto.plan\032\014schema."
-  "proto\"i\n\014GenericValue\022\022\n\010bool_val\030\001 \001(\010H"
-  "\000\022\023\n\tint64_val\030\002 \001(\003H\000\022\023\n\tfloat_val\030\003 \001("
-  "\001H\000\022\024\n\nstring_val\030\004 \001(\tH\000B\005\n\003val\"\\\n\tQuer"
-  "yInfo\022\014\n\004topk\030\001 \001(\003\022\023\n\013metric_type\030\003 \001(\t"
-  "\022\025\n\rsearch_params\030\004 \001(\t\022\025\n\rround_decimal"
-  "\030\005 \001(\003\"{\n\nColumnInfo\022\020\n\010field_id\030\001 \001(\003\0220"
-  "\n\tdata_type\030\002 \001(\0162\035.milvus.proto.schema."
-  "DataType\022\026\n\016is_primary_key\030\003 \001(\010\022\021\n\tis_a"
-  "utoID\030\004 \001(\010\"9\n\nColumnExpr\022+\n\004info\030\001 \001(\0132"
-  "\035.milvus.proto.plan.ColumnInfo\";\n\tValueE"
-  "xpr\022.\n\005value\030\001 \001(\0132\037.milvus.proto.plan.G"
-  "enericValue\"\233\001\n\016UnaryRangeExpr\0222\n\013column"
-  "_info\030\001 \001(\0132\035.milvus.proto.plan.ColumnIn"
-  "fo\022%\n\002op\030\002 \001(\0162\031.milvus.proto.plan.OpTyp"
-  "e\022.\n\005value\030\003 \001(\0132\037.milvus.proto.plan.Gen"
-  "ericValue\"\343\001\n\017BinaryRangeExpr\0222\n\013column_"
-  "info\030\001 \001(\0132\035.milvus.proto.plan.ColumnInf"
-  "o\022\027\n\017lower_inclusive\030\002 \001(\010\022\027\n\017upper_incl"
-  "usive\030\003 \001(\010\0224\n\013lower_value\030\004 \001(\0132\037.milvu"
-  "s.proto.plan.GenericValue\0224\n\013upper_value"
-  "\030\005 \001(\0132\037.milvus.proto.plan.GenericValue\""
-  "\247\001\n\013CompareExpr\0227\n\020left_column_info\030\001 \001("
-  "\0132\035.milvus.proto.plan.ColumnInfo\0228\n\021righ"
-  "t_column_info\030\002 \001(\0132\035.milvus.proto.plan."
-  "ColumnInfo\022%\n\002op\030\003 \001(\0162\031.milvus.proto.pl"
-  "an.OpType\"o\n\010TermExpr\0222\n\013column_info\030\001 \001"
-  "(\0132\035.milvus.proto.plan.ColumnInfo\022/\n\006val"
-  "ues\030\002 \003(\0132\037.milvus.proto.plan.GenericVal"
-  "ue\"\206\001\n\tUnaryExpr\0220\n\002op\030\001 \001(\0162$.milvus.pr"
-  "oto.plan.UnaryExpr.UnaryOp\022&\n\005child\030\002 \001("
-  "\0132\027.milvus.proto.plan.Expr\"\037\n\007UnaryOp\022\013\n"
-  "\007Invalid\020\000\022\007\n\003Not\020\001\"\307\001\n\nBinaryExpr\0222\n\002op"
-  "\030\001 \001(\0162&.milvus.proto.plan.BinaryExpr.Bi"
-  "naryOp\022%\n\004left\030\002 \001(\0132\027.milvus.proto.plan"
-  ".Expr\022&\n\005right\030\003 \001(\0132\027.milvus.proto.plan"
-  ".Expr\"6\n\010BinaryOp\022\013\n\007Invalid\020\000\022\016\n\nLogica"
-  "lAnd\020\001\022\r\n\tLogicalOr\020\002\"\255\001\n\rBinaryArithOp\022"
-  "2\n\013column_info\030\001 \001(\0132\035.milvus.proto.plan"
-  ".ColumnInfo\0220\n\010arith_op\030\002 \001(\0162\036.milvus.p"
-  "roto.plan.ArithOpType\0226\n\rright_operand\030\003"
-  " \001(\0132\037.milvus.proto.plan.GenericValue\"\214\001"
-  "\n\017BinaryArithExpr\022%\n\004left\030\001 \001(\0132\027.milvus"
-  ".proto.plan.Expr\022&\n\005right\030\002 \001(\0132\027.milvus"
-  ".proto.plan.Expr\022*\n\002op\030\003 \001(\0162\036.milvus.pr"
-  "oto.plan.ArithOpType\"\221\002\n\032BinaryArithOpEv"
-  "alRangeExpr\0222\n\013column_info\030\001 \001(\0132\035.milvu"
-  "s.proto.plan.ColumnInfo\0220\n\010arith_op\030\002 \001("
-  "\0162\036.milvus.proto.plan.ArithOpType\0226\n\rrig"
-  "ht_operand\030\003 \001(\0132\037.milvus.proto.plan.Gen"
-  "ericValue\022%\n\002op\030\004 \001(\0162\031.milvus.proto.pla"
-  "n.OpType\022.\n\005value\030\005 \001(\0132\037.milvus.proto.p"
-  "lan.GenericValue\"\347\004\n\004Expr\0220\n\tterm_expr\030\001"
-  " \001(\0132\033.milvus.proto.plan.TermExprH\000\0222\n\nu"
-  "nary_expr\030\002 \001(\0132\034.milvus.proto.plan.Unar"
-  "yExprH\000\0224\n\013binary_expr\030\003 \001(\0132\035.milvus.pr"
-  "oto.plan.BinaryExprH\000\0226\n\014compare_expr\030\004 "
-  "\001(\0132\036.milvus.proto.plan.CompareExprH\000\022=\n"
-  "\020unary_range_expr\030\005 \001(\0132!.milvus.proto.p"
-  "lan.UnaryRangeExprH\000\022\?\n\021binary_range_exp"
-  "r\030\006 \001(\0132\".milvus.proto.plan.BinaryRangeE"
-  "xprH\000\022X\n\037binary_arith_op_eval_range_expr"
-  "\030\007 \001(\0132-.milvus.proto.plan.BinaryArithOp"
-  "EvalRangeExprH\000\022\?\n\021binary_arith_expr\030\010 \001"
-  "(\0132\".milvus.proto.plan.BinaryArithExprH\000"
-  "\0222\n\nvalue_expr\030\t \001(\0132\034.milvus.proto.plan"
-  ".ValueExprH\000\0224\n\013column_expr\030\n \001(\0132\035.milv"
-  "us.proto.plan.ColumnExprH\000B\006\n\004expr\"\251\001\n\nV"
-  "ectorANNS\022\021\n\tis_binary\030\001 \001(\010\022\020\n\010field_id"
-  "\030\002 \001(\003\022+\n\npredicates\030\003 \001(\0132\027.milvus.prot"
-  "o.plan.Expr\0220\n\nquery_info\030\004 \001(\0132\034.milvus"
-  ".proto.plan.QueryInfo\022\027\n\017placeholder_tag"
-  "\030\005 \001(\t\"\221\001\n\010PlanNode\0224\n\013vector_anns\030\001 \001(\013"
-  "2\035.milvus.proto.plan.VectorANNSH\000\022-\n\npre"
-  "dicates\030\002 \001(\0132\027.milvus.proto.plan.ExprH\000"
-  "\022\030\n\020output_field_ids\030\003 \003(\003B\006\n\004node*\272\001\n\006O"
-  "pType\022\013\n\007Invalid\020\000\022\017\n\013GreaterThan\020\001\022\020\n\014G"
-  "reaterEqual\020\002\022\014\n\010LessThan\020\003\022\r\n\tLessEqual"
-  "\020\004\022\t\n\005Equal\020\005\022\014\n\010NotEqual\020\006\022\017\n\013PrefixMat"
-  "ch\020\007\022\020\n\014PostfixMatch\020\010\022\t\n\005Match\020\t\022\t\n\005Ran"
-  "ge\020\n\022\006\n\002In\020\013\022\t\n\005NotIn\020\014*G\n\013ArithOpType\022\013"
-  "\n\007Unknown\020\000\022\007\n\003Add\020\001\022\007\n\003Sub\020\002\022\007\n\003Mul\020\003\022\007"
-  "\n\003Div\020\004\022\007\n\003Mod\020\005B3Z1github.com/milvus-io"
-  "/milvus/internal/proto/planpbb\006proto3"
+  "proto\"\200\001\n\014GenericValue\022\022\n\010bool_val\030\001 \001(\010"
+  "H\000\022\023\n\tint64_val\030\002 \001(\003H\000\022\023\n\tfloat_val\030\003 \001"
+  "(\001H\000\022\024\n\nstring_val\030\004 \001(\tH\000\022\025\n\013param_inde"
+  "x\030\005 \001(\003H\000B\005\n\003val\"=\n\nPlanParams\022/\n\006values"
+  "\030\001 \003(\0132\037.milvus.proto.plan.GenericValue\""
+  "\\\n\tQueryInfo\022\014\n\004topk\030\001 \001(\003\022\023\n\013metric_typ"
+  "e\030\003 \001(\t\022\025\n\rsearch_params\030\004 \001(\t\022\025\n\rround_"
+  "decimal\030\005 \001(\003\"{\n\nColumnInfo\022\020\n\010field_id\030"
+  "\001 \001(\003\0220\n\tdata_type\030\002 \001(\0162\035.milvus.proto."
+  "schema.DataType\022\026\n\016is_primary_key\030\003 \001(\010\022"
+  "\021\n\tis_autoID\030\004 \001(\010\"9\n\nColumnExpr\022+\n\004info"
+  "\030\001 \001(\0132\035.milvus.proto.plan.ColumnInfo\";\n"
+  "\tValueExpr\022.\n\005value\030\001 \001(\0132\037.milvus.proto"
+  ".plan.GenericValue\"\233\001\n\016UnaryRangeExpr\0222\n"
+  "\013column_info\030\001 \001(\0132\035.milvus.proto.plan.C"
+  "olumnInfo\022%\n\002op\030\002 \001(\0162\031.milvus.proto.pla"
+  "n.OpType\022.\n\005value\030\003 \001(\0132\037.milvus.proto.p"
+  "lan.GenericValue\"\343\001\n\017BinaryRangeExpr\0222\n\013"
+  "column_info\030\001 \001(\0132\035.milvus.proto.plan.Co"
+  "lumnInfo\022\027\n\017lower_inclusive\030\002 \001(\010\022\027\n\017upp"
+  "er_inclusive\030\003 \001(\010\0224\n\013lower_value\030\004 \001(\0132"
+  "\037.milvus.proto.plan.GenericValue\0224\n\013uppe"
+  "r_value\030\005 \001(\0132\037.milvus.proto.plan.Generi"
+  "cValue\"\247\001\n\013CompareExpr\0227\n\020left_column_in"
+  "fo\030\001 \001(\0132\035.milvus.proto.plan.ColumnInfo\022"
+  "8\n\021right_column_info\030\002 \001(\0132\035.milvus.prot"
+  "o.plan.ColumnInfo\022%\n\002op\030\003 \001(\0162\031.milvus.p"
+  "roto.plan.OpType\"o\n\010TermExpr\0222\n\013column_i"
+  "nfo\030\001 \001(\0132\035.milvus.proto.plan.ColumnInfo"
+  "\022/\n\006values\030\002 \003(\0132\037.milvus.proto.plan.Gen"
+  "ericValue\"\206\001\n\tUnaryExpr\0220\n\002op\030\001 \001(\0162$.mi"
+  "lvus.proto.plan.UnaryExpr.UnaryOp\022&\n\005chi"
+  "ld\030\002 \001(\0132\027.milvus.proto.plan.Expr\"\037\n\007Una"
+  "ryOp\022\013\n\007Invalid\020\000\022\007\n\003Not\020\001\"\307\001\n\nBinaryExp"
+  "r\0222\n\002op\030\001 \001(\0162&.milvus.proto.plan.Binary"
+  "Expr.BinaryOp\022%\n\004left\030\002 \001(\0132\027.milvus.pro"
+  "to.plan.Expr\022&\n\005right\030\003 \001(\0132\027.milvus.pro"
+  "to.plan.Expr\"6\n\010BinaryOp\022\013\n\007Invalid\020\000\022\016\n"
+  "\nLogicalAnd\020\001\022\r\n\tLogicalOr\020\002\"\255\001\n\rBinaryA"
+  "rithOp\0222\n\013column_info\030\001 \001(\0132\035.milvus.pro"
+  "to.plan.ColumnInfo\0220\n\010arith_op\030\002 \001(\0162\036.m"
+  "ilvus.proto.plan.ArithOpType\0226\n\rright_op"
+  "erand\030\003 \001(\0132\037.milvus.proto.plan.GenericV"
+  "alue\"\214\001\n\017BinaryArithExpr\022%\n\004left\030\001 \001(\0132\027"
+  ".milvus.proto.plan.Expr\022&\n\005right\030\002 \001(\0132\027"
+  ".milvus.proto.plan.Expr\022*\n\002op\030\003 \001(\0162\036.mi"
+  "lvus.proto.plan.ArithOpType\"\221\002\n\032BinaryAr"
+  "ithOpEvalRangeExpr\0222\n\013column_info\030\001 \001(\0132"
+  "\035.milvus.proto.plan.ColumnInfo\0220\n\010arith_"
+  "op\030\002 \001(\0162\036.milvus.proto.plan.ArithOpType"
+  "\0226\n\rright_operand\030\003 \001(\0132\037.milvus.proto.p"
+  "lan.GenericValue\022%\n\002op\030\004 \001(\0162\031.milvus.pr"
+  "oto.plan.OpType\022.\n\005value\030\005 \001(\0132\037.milvus."
+  "proto.plan.GenericValue\"\347\004\n\004Expr\0220\n\tterm"
+  "_expr\030\001 \001(\0132\033.milvus.proto.plan.TermExpr"
+  "H\000\0222\n\nunary_expr\030\002 \001(\0132\034.milvus.proto.pl"
+  "an.UnaryExprH\000\0224\n\013binary_expr\030\003 \001(\0132\035.mi"
+  "lvus.proto.plan.BinaryExprH\000\0226\n\014compare_"
+  "expr\030\004 \001(\0132\036.milvus.proto.plan.CompareEx"
+  "prH\000\022=\n\020unary_range_expr\030\005 \001(\0132!.milvus."
+  "proto.plan.UnaryRangeExprH\000\022\?\n\021binary_ra"
+  "nge_expr\030\006 \001(\0132\".milvus.proto.plan.Binar"
+  "yRangeExprH\000\022X\n\037binary_arith_op_eval_ran"
+  "ge_expr\030\007 \001(\0132-.milvus.proto.plan.Binary"
+  "ArithOpEvalRangeExprH\000\022\?\n\021binary_arith_e"
+  "xpr\030\010 \001(\0132\".milvus.proto.plan.BinaryArit"
+  "hExprH\000\0222\n\nvalue_expr\030\t \001(\0132\034.milvus.pro"
+  "to.plan.ValueExprH\000\0224\n\013column_expr\030\n \001(\013"
+  "2\035.milvus.proto.plan.ColumnExprH\000B\006\n\004exp"
+  "r\"\251\001\n\nVectorANNS\022\021\n\tis_binary\030\001 \001(\010\022\020\n\010f"
+  "ield_id\030\002 \001(\003\022+\n\npredicates\030\003 \001(\0132\027.milv"
+  "us.proto.plan.Expr\0220\n\nquery_info\030\004 \001(\0132\034"
+  ".milvus.proto.plan.QueryInfo\022\027\n\017placehol"
+  "der_tag\030\005 \001(\t\"I\n\tAggregate\022*\n\002op\030\001 \001(\0162\036"
+  ".milvus.proto.plan.AggregateOp\022\020\n\010field_"
+  "id\030\002 \001(\003\"\367\001\n\010PlanNode\0224\n\013vector_anns\030\001 \001"
+  "(\0132\035.milvus.proto.plan.VectorANNSH\000\022-\n\np"
+  "redicates\030\002 \001(\0132\027.milvus.proto.plan.Expr"
+  "H\000\022\030\n\020output_field_ids\030\003 \003(\003\022\r\n\005limit\030\004 "
+  "\001(\003\022\016\n\006offset\030\005 \001(\003\022\023\n\013order_by_pk\030\006 \001(\010"
+  "\0220\n\naggregates\030\007 \003(\0132\034.milvus.proto.plan"
+  ".AggregateB\006\n\004node*\272\001\n\006OpType\022\013\n\007Invalid"
+  "\020\000\022\017\n\013GreaterThan\020\001\022\020\n\014GreaterEqual\020\002\022\014\n"
+  "\010LessThan\020\003\022\r\n\tLessEqual\020\004\022\t\n\005Equal\020\005\022\014\n"
+  "\010NotEqual\020\006\022\017\n\013PrefixMatch\020\007\022\020\n\014PostfixM"
+  "atch\020\010\022\t\n\005Match\020\t\022\t\n\005Range\020\n\022\006\n\002In\020\013\022\t\n\005"
+  "NotIn\020\014*G\n\013ArithOpType\022\013\n\007Unknown\020\000\022\007\n\003A"
+  "dd\020\001\022\007\n\003Sub\020\002\022\007\n\003Mul\020\003\022\007\n\003Div\020\004\022\007\n\003Mod\020\005"
+  "*3\n\013AggregateOp\022\t\n\005Count\020\000\022\007\n\003Min\020\001\022\007\n\003M"
+  "ax\020\002\022\007\n\003Sum\020\003B3Z1github.com/milvus-io/mi"
+  "lvus/internal/proto/planpbb\006proto3"
   ;
 static const ::_pbi::DescriptorTable* const descriptor_table_plan_2eproto_deps[1] = {
   &::descriptor_table_schema_2eproto,
 };
 static ::_pbi::once_flag descriptor_table_plan_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_plan_2eproto = {
-    false, false, 3357, descriptor_table_protodef_plan_2eproto,
+    false, false, 3674, descriptor_table_protodef_plan_2eproto,
     "plan.proto",
-    &descriptor_table_plan_2eproto_once, descriptor_table_plan_2eproto_deps, 1, 17,
+    &descriptor_table_plan_2eproto_once, descriptor_table_plan_2eproto_deps, 1, 19,
     schemas, file_default_instances, TableStruct_plan_2eproto::offsets,
     file_level_metadata_plan_2eproto, file_level_enum_descriptors_plan_2eproto,
     file_level_service_descriptors_plan_2eproto,
@@ -688,6 +751,22 @@ bool ArithOpType_IsValid(int value) {
   }
 }
 
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* AggregateOp_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_plan_2eproto);
+  return file_level_enum_descriptors_plan_2eproto[4];
+}
+bool AggregateOp_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+      return true;
+    default:
+      return false;
+  }
+}
+
 
 // ===================================================================
 
@@ -728,6 +807,10 @@ GenericValue::GenericValue(const GenericValue& from)
       _this->_internal_set_string_val(from._internal_string_val());
       break;
     }
+    case kParamIndex: {
+      _this->_internal_set_param_index(from._internal_param_index());
+      break;
+    }
     case VAL_NOT_SET: {
       break;
     }
@@ -786,6 +869,10 @@ void GenericValue::clear_val() {
       _impl_.val_.string_val_.Destroy();
       break;
     }
+    case kParamIndex: {
+      // No need to clear
+      break;
+    }
     case VAL_NOT_SET: {
       break;
     }
@@ -844,6 +931,14 @@ const char* GenericValue::_InternalParse(const char* ptr, ::_pbi::ParseContext*
         } else
           goto handle_unusual;
         continue;
+      // int64 param_index = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _internal_set_param_index(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -901,6 +996,12 @@ uint8_t* GenericValue::_InternalSerialize(
         4, this->_internal_string_val(), target);
   }
 
+  // int64 param_index = 5;
+  if (_internal_has_param_index()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(5, this->_internal_param_index(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -940,6 +1041,11 @@ size_t GenericValue::ByteSizeLong() const {
           this->_internal_string_val());
       break;
     }
+    // int64 param_index = 5;
+    case kParamIndex: {
+      total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_param_index());
+      break;
+    }
     case VAL_NOT_SET: {
       break;
     }
@@ -979,6 +1085,10 @@ void GenericValue::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::P
       _this->_internal_set_string_val(from._internal_string_val());
       break;
     }
+    case kParamIndex: {
+      _this->_internal_set_param_index(from._internal_param_index());
+      break;
+    }
     case VAL_NOT_SET: {
       break;
     }
@@ -1012,6 +1122,191 @@ void GenericValue::InternalSwap(GenericValue* other) {
 
 // ===================================================================
 
+class PlanParams::_Internal {
+ public:
+};
+
+PlanParams::PlanParams(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:milvus.proto.plan.PlanParams)
+}
+PlanParams::PlanParams(const PlanParams& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  PlanParams* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.values_){from._impl_.values_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:milvus.proto.plan.PlanParams)
+}
+
+inline void PlanParams::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.values_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+PlanParams::~PlanParams() {
+  // @@protoc_insertion_point(destructor:milvus.proto.plan.PlanParams)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void PlanParams::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.values_.~RepeatedPtrField();
+}
+
+void PlanParams::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void PlanParams::Clear() {
+// @@protoc_insertion_point(message_clear_start:milvus.proto.plan.PlanParams)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.values_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* PlanParams::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .milvus.proto.plan.GenericValue values = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_values(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* PlanParams::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:milvus.proto.plan.PlanParams)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .milvus.proto.plan.GenericValue values = 1;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_values_size()); i < n; i++) {
+    const auto& repfield = this->_internal_values(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(1, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:milvus.proto.plan.PlanParams)
+  return target;
+}
+
+size_t PlanParams::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:milvus.proto.plan.PlanParams)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .milvus.proto.plan.GenericValue values = 1;
+  total_size += 1UL * this->_internal_values_size();
+  for (const auto& msg : this->_impl_.values_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData PlanParams::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    PlanParams::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*PlanParams::GetClassData() const { return &_class_data_; }
+
+
+void PlanParams::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<PlanParams*>(&to_msg);
+  auto& from = static_cast<const PlanParams&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:milvus.proto.plan.PlanParams)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.values_.MergeFrom(from._impl_.values_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void PlanParams::CopyFrom(const PlanParams& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:milvus.proto.plan.PlanParams)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool PlanParams::IsInitialized() const {
+  return true;
+}
+
+void PlanParams::InternalSwap(PlanParams* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.values_.InternalSwap(&other->_impl_.values_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata PlanParams::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
+      file_level_metadata_plan_2eproto[1]);
+}
+
+// ===================================================================
+
 class QueryInfo::_Internal {
  public:
 };
@@ -1320,7 +1615,7 @@ void QueryInfo::InternalSwap(QueryInfo* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata QueryInfo::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[1]);
+      file_level_metadata_plan_2eproto[2]);
 }
 
 // ===================================================================
@@ -1582,7 +1877,7 @@ void ColumnInfo::InternalSwap(ColumnInfo* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata ColumnInfo::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[2]);
+      file_level_metadata_plan_2eproto[3]);
 }
 
 // ===================================================================
@@ -1775,7 +2070,7 @@ void ColumnExpr::InternalSwap(ColumnExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata ColumnExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[3]);
+      file_level_metadata_plan_2eproto[4]);
 }
 
 // ===================================================================
@@ -1968,7 +2263,7 @@ void ValueExpr::InternalSwap(ValueExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata ValueExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[4]);
+      file_level_metadata_plan_2eproto[5]);
 }
 
 // ===================================================================
@@ -2236,7 +2531,7 @@ void UnaryRangeExpr::InternalSwap(UnaryRangeExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata UnaryRangeExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[5]);
+      file_level_metadata_plan_2eproto[6]);
 }
 
 // ===================================================================
@@ -2570,7 +2865,7 @@ void BinaryRangeExpr::InternalSwap(BinaryRangeExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata BinaryRangeExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[6]);
+      file_level_metadata_plan_2eproto[7]);
 }
 
 // ===================================================================
@@ -2838,7 +3133,7 @@ void CompareExpr::InternalSwap(CompareExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata CompareExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[7]);
+      file_level_metadata_plan_2eproto[8]);
 }
 
 // ===================================================================
@@ -3065,7 +3360,7 @@ void TermExpr::InternalSwap(TermExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata TermExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[8]);
+      file_level_metadata_plan_2eproto[9]);
 }
 
 // ===================================================================
@@ -3292,7 +3587,7 @@ void UnaryExpr::InternalSwap(UnaryExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata UnaryExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[9]);
+      file_level_metadata_plan_2eproto[10]);
 }
 
 // ===================================================================
@@ -3560,7 +3855,7 @@ void BinaryExpr::InternalSwap(BinaryExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata BinaryExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[10]);
+      file_level_metadata_plan_2eproto[11]);
 }
 
 // ===================================================================
@@ -3828,7 +4123,7 @@ void BinaryArithOp::InternalSwap(BinaryArithOp* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata BinaryArithOp::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[11]);
+      file_level_metadata_plan_2eproto[12]);
 }
 
 // ===================================================================
@@ -4096,7 +4391,7 @@ void BinaryArithExpr::InternalSwap(BinaryArithExpr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata BinaryArithExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[12]);
+      file_level_metadata_plan_2eproto[13]);
 }
 
 // ===================================================================
@@ -4436,7 +4731,7 @@ void BinaryArithOpEvalRangeExpr::InternalSwap(BinaryArithOpEvalRangeExpr* other)
 ::PROTOBUF_NAMESPACE_ID::Metadata BinaryArithOpEvalRangeExpr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[13]);
+      file_level_metadata_plan_2eproto[14]);
 }
 
 // ===================================================================
@@ -5205,7 +5500,7 @@ void Expr::InternalSwap(Expr* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata Expr::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[14]);
+      file_level_metadata_plan_2eproto[15]);
 }
 
 // ===================================================================
@@ -5550,7 +5845,221 @@ void VectorANNS::InternalSwap(VectorANNS* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata VectorANNS::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[15]);
+      file_level_metadata_plan_2eproto[16]);
+}
+
+// ===================================================================
+
+class Aggregate::_Internal {
+ public:
+};
+
+Aggregate::Aggregate(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:milvus.proto.plan.Aggregate)
+}
+Aggregate::Aggregate(const Aggregate& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Aggregate* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.field_id_){}
+    , decltype(_impl_.op_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.field_id_, &from._impl_.field_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.op_) -
+    reinterpret_cast<char*>(&_impl_.field_id_)) + sizeof(_impl_.op_));
+  // @@protoc_insertion_point(copy_constructor:milvus.proto.plan.Aggregate)
+}
+
+inline void Aggregate::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.field_id_){int64_t{0}}
+    , decltype(_impl_.op_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+Aggregate::~Aggregate() {
+  // @@protoc_insertion_point(destructor:milvus.proto.plan.Aggregate)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void Aggregate::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void Aggregate::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void Aggregate::Clear() {
+// @@protoc_insertion_point(message_clear_start:milvus.proto.plan.Aggregate)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  ::memset(&_impl_.field_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.op_) -
+      reinterpret_cast<char*>(&_impl_.field_id_)) + sizeof(_impl_.op_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Aggregate::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // .milvus.proto.plan.AggregateOp op = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_op(static_cast<::milvus::proto::plan::AggregateOp>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // int64 field_id = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.field_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* Aggregate::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:milvus.proto.plan.Aggregate)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .milvus.proto.plan.AggregateOp op = 1;
+  if (this->_internal_op() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      1, this->_internal_op(), target);
+  }
+
+  // int64 field_id = 2;
+  if (this->_internal_field_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(2, this->_internal_field_id(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:milvus.proto.plan.Aggregate)
+  return target;
+}
+
+size_t Aggregate::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:milvus.proto.plan.Aggregate)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // int64 field_id = 2;
+  if (this->_internal_field_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_field_id());
+  }
+
+  // .milvus.proto.plan.AggregateOp op = 1;
+  if (this->_internal_op() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_op());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Aggregate::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Aggregate::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Aggregate::GetClassData() const { return &_class_data_; }
+
+
+void Aggregate::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Aggregate*>(&to_msg);
+  auto& from = static_cast<const Aggregate&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:milvus.proto.plan.Aggregate)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from._internal_field_id() != 0) {
+    _this->_internal_set_field_id(from._internal_field_id());
+  }
+  if (from._internal_op() != 0) {
+    _this->_internal_set_op(from._internal_op());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void Aggregate::CopyFrom(const Aggregate& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:milvus.proto.plan.Aggregate)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool Aggregate::IsInitialized() const {
+  return true;
+}
+
+void Aggregate::InternalSwap(Aggregate* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Aggregate, _impl_.op_)
+      + sizeof(Aggregate::_impl_.op_)
+      - PROTOBUF_FIELD_OFFSET(Aggregate, _impl_.field_id_)>(
+          reinterpret_cast<char*>(&_impl_.field_id_),
+          reinterpret_cast<char*>(&other->_impl_.field_id_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Aggregate::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
+      file_level_metadata_plan_2eproto[17]);
 }
 
 // ===================================================================
@@ -5611,11 +6120,18 @@ PlanNode::PlanNode(const PlanNode& from)
   new (&_impl_) Impl_{
       decltype(_impl_.output_field_ids_){from._impl_.output_field_ids_}
     , /*decltype(_impl_._output_field_ids_cached_byte_size_)*/{0}
+    , decltype(_impl_.aggregates_){from._impl_.aggregates_}
+    , decltype(_impl_.limit_){}
+    , decltype(_impl_.offset_){}
+    , decltype(_impl_.order_by_pk_){}
     , decltype(_impl_.node_){}
     , /*decltype(_impl_._cached_size_)*/{}
     , /*decltype(_impl_._oneof_case_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.limit_, &from._impl_.limit_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.order_by_pk_) -
+    reinterpret_cast<char*>(&_impl_.limit_)) + sizeof(_impl_.order_by_pk_));
   clear_has_node();
   switch (from.node_case()) {
     case kVectorAnns: {
@@ -5642,6 +6158,10 @@ inline void PlanNode::SharedCtor(
   new (&_impl_) Impl_{
       decltype(_impl_.output_field_ids_){arena}
     , /*decltype(_impl_._output_field_ids_cached_byte_size_)*/{0}
+    , decltype(_impl_.aggregates_){arena}
+    , decltype(_impl_.limit_){int64_t{0}}
+    , decltype(_impl_.offset_){int64_t{0}}
+    , decltype(_impl_.order_by_pk_){false}
     , decltype(_impl_.node_){}
     , /*decltype(_impl_._cached_size_)*/{}
     , /*decltype(_impl_._oneof_case_)*/{}
@@ -5661,6 +6181,7 @@ PlanNode::~PlanNode() {
 inline void PlanNode::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   _impl_.output_field_ids_.~RepeatedField();
+  _impl_.aggregates_.~RepeatedPtrField();
   if (has_node()) {
     clear_node();
   }
@@ -5700,6 +6221,10 @@ void PlanNode::Clear() {
   (void) cached_has_bits;
 
   _impl_.output_field_ids_.Clear();
+  _impl_.aggregates_.Clear();
+  ::memset(&_impl_.limit_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.order_by_pk_) -
+      reinterpret_cast<char*>(&_impl_.limit_)) + sizeof(_impl_.order_by_pk_));
   clear_node();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
@@ -5737,6 +6262,43 @@ const char* PlanNode::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx)
         } else
           goto handle_unusual;
         continue;
+      // int64 limit = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.limit_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // int64 offset = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _impl_.offset_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool order_by_pk = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _impl_.order_by_pk_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated .milvus.proto.plan.Aggregate aggregates = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_aggregates(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<58>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -5789,6 +6351,32 @@ uint8_t* PlanNode::_InternalSerialize(
     }
   }
 
+  // int64 limit = 4;
+  if (this->_internal_limit() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(4, this->_internal_limit(), target);
+  }
+
+  // int64 offset = 5;
+  if (this->_internal_offset() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(5, this->_internal_offset(), target);
+  }
+
+  // bool order_by_pk = 6;
+  if (this->_internal_order_by_pk() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(6, this->_internal_order_by_pk(), target);
+  }
+
+  // repeated .milvus.proto.plan.Aggregate aggregates = 7;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_aggregates_size()); i < n; i++) {
+    const auto& repfield = this->_internal_aggregates(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(7, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -5819,6 +6407,28 @@ size_t PlanNode::ByteSizeLong() const {
     total_size += data_size;
   }
 
+  // repeated .milvus.proto.plan.Aggregate aggregates = 7;
+  total_size += 1UL * this->_internal_aggregates_size();
+  for (const auto& msg : this->_impl_.aggregates_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // int64 limit = 4;
+  if (this->_internal_limit() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_limit());
+  }
+
+  // int64 offset = 5;
+  if (this->_internal_offset() != 0) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_offset());
+  }
+
+  // bool order_by_pk = 6;
+  if (this->_internal_order_by_pk() != 0) {
+    total_size += 1 + 1;
+  }
+
   switch (node_case()) {
     // .milvus.proto.plan.VectorANNS vector_anns = 1;
     case kVectorAnns: {
@@ -5857,6 +6467,16 @@ void PlanNode::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTO
   (void) cached_has_bits;
 
   _this->_impl_.output_field_ids_.MergeFrom(from._impl_.output_field_ids_);
+  _this->_impl_.aggregates_.MergeFrom(from._impl_.aggregates_);
+  if (from._internal_limit() != 0) {
+    _this->_internal_set_limit(from._internal_limit());
+  }
+  if (from._internal_offset() != 0) {
+    _this->_internal_set_offset(from._internal_offset());
+  }
+  if (from._internal_order_by_pk() != 0) {
+    _this->_internal_set_order_by_pk(from._internal_order_by_pk());
+  }
   switch (from.node_case()) {
     case kVectorAnns: {
       _this->_internal_mutable_vector_anns()->::milvus::proto::plan::VectorANNS::MergeFrom(
@@ -5890,6 +6510,13 @@ void PlanNode::InternalSwap(PlanNode* other) {
   using std::swap;
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   _impl_.output_field_ids_.InternalSwap(&other->_impl_.output_field_ids_);
+  _impl_.aggregates_.InternalSwap(&other->_impl_.aggregates_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(PlanNode, _impl_.order_by_pk_)
+      + sizeof(PlanNode::_impl_.order_by_pk_)
+      - PROTOBUF_FIELD_OFFSET(PlanNode, _impl_.limit_)>(
+          reinterpret_cast<char*>(&_impl_.limit_),
+          reinterpret_cast<char*>(&other->_impl_.limit_));
   swap(_impl_.node_, other->_impl_.node_);
   swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
 }
@@ -5897,7 +6524,7 @@ void PlanNode::InternalSwap(PlanNode* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata PlanNode::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_plan_2eproto_getter, &descriptor_table_plan_2eproto_once,
-      file_level_metadata_plan_2eproto[16]);
+      file_level_metadata_plan_2eproto[18]);
 }
 
 // @@protoc_insertion_point(namespace_scope)
@@ -5909,6 +6536,10 @@ template<> PROTOBUF_NOINLINE ::milvus::proto::plan::GenericValue*
 Arena::CreateMaybeMessage< ::milvus::proto::plan::GenericValue >(Arena* arena) {
   return Arena::CreateMessageInternal< ::milvus::proto::plan::GenericValue >(arena);
 }
+template<> PROTOBUF_NOINLINE ::milvus::proto::plan::PlanParams*
+Arena::CreateMaybeMessage< ::milvus::proto::plan::PlanParams >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::milvus::proto::plan::PlanParams >(arena);
+}
 template<> PROTOBUF_NOINLINE ::milvus::proto::plan::QueryInfo*
 Arena::CreateMaybeMessage< ::milvus::proto::plan::QueryInfo >(Arena* arena) {
   return Arena::CreateMessageInternal< ::milvus::proto::plan::QueryInfo >(arena);
@@ -5969,6 +6600,10 @@ template<> PROTOBUF_NOINLINE ::milvus::proto::plan::VectorANNS*
 Arena::CreateMaybeMessage< ::milvus::proto::plan::VectorANNS >(Arena* arena) {
   return Arena::CreateMessageInternal< ::milvus::proto::plan::VectorANNS >(arena);
 }
+template<> PROTOBUF_NOINLINE ::milvus::proto::plan::Aggregate*
+Arena::CreateMaybeMessage< ::milvus::proto::plan::Aggregate >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::milvus::proto::plan::Aggregate >(arena);
+}
 template<> PROTOBUF_NOINLINE ::milvus::proto::plan::PlanNode*
 Arena::CreateMaybeMessage< ::milvus::proto::plan::PlanNode >(Arena* arena) {
   return Arena::CreateMessageInternal< ::milvus::proto::plan::PlanNode >(arena);
@@ -49,6 +49,9 @@ extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table
 namespace milvus {
 namespace proto {
 namespace plan {
+class Aggregate;
+struct AggregateDefaultTypeInternal;
+extern AggregateDefaultTypeInternal _Aggregate_default_instance_;
 class BinaryArithExpr;
 struct BinaryArithExprDefaultTypeInternal;
 extern BinaryArithExprDefaultTypeInternal _BinaryArithExpr_default_instance_;
@@ -82,6 +85,9 @@ extern GenericValueDefaultTypeInternal _GenericValue_default_instance_;
 class PlanNode;
 struct PlanNodeDefaultTypeInternal;
 extern PlanNodeDefaultTypeInternal _PlanNode_default_instance_;
+class PlanParams;
+struct PlanParamsDefaultTypeInternal;
+extern PlanParamsDefaultTypeInternal _PlanParams_default_instance_;
 class QueryInfo;
 struct QueryInfoDefaultTypeInternal;
 extern QueryInfoDefaultTypeInternal _QueryInfo_default_instance_;
@@ -104,6 +110,7 @@ extern VectorANNSDefaultTypeInternal _VectorANNS_default_instance_;
 }  // namespace proto
 }  // namespace milvus
 PROTOBUF_NAMESPACE_OPEN
+template<> ::milvus::proto::plan::Aggregate* Arena::CreateMaybeMessage<::milvus::proto::plan::Aggregate>(Arena*);
 template<> ::milvus::proto::plan::BinaryArithExpr* Arena::CreateMaybeMessage<::milvus::proto::plan::BinaryArithExpr>(Arena*);
 template<> ::milvus::proto::plan::BinaryArithOp* Arena::CreateMaybeMessage<::milvus::proto::plan::BinaryArithOp>(Arena*);
 template<> ::milvus::proto::plan::BinaryArithOpEvalRangeExpr* Arena::CreateMaybeMessage<::milvus::proto::plan::BinaryArithOpEvalRangeExpr>(Arena*);
@@ -115,6 +122,7 @@ template<> ::milvus::proto::plan::CompareExpr* Arena::CreateMaybeMessage<::milvu
 template<> ::milvus::proto::plan::Expr* Arena::CreateMaybeMessage<::milvus::proto::plan::Expr>(Arena*);
 template<> ::milvus::proto::plan::GenericValue* Arena::CreateMaybeMessage<::milvus::proto::plan::GenericValue>(Arena*);
 template<> ::milvus::proto::plan::PlanNode* Arena::CreateMaybeMessage<::milvus::proto::plan::PlanNode>(Arena*);
+template<> ::milvus::proto::plan::PlanParams* Arena::CreateMaybeMessage<::milvus::proto::plan::PlanParams>(Arena*);
 template<> ::milvus::proto::plan::QueryInfo* Arena::CreateMaybeMessage<::milvus::proto::plan::QueryInfo>(Arena*);
 template<> ::milvus::proto::plan::TermExpr* Arena::CreateMaybeMessage<::milvus::proto::plan::TermExpr>(Arena*);
 template<> ::milvus::proto::plan::UnaryExpr* Arena::CreateMaybeMessage<::milvus::proto::plan::UnaryExpr>(Arena*);
@@ -242,6 +250,33 @@ inline bool ArithOpType_Parse(
   return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<ArithOpType>(
     ArithOpType_descriptor(), name, value);
 }
+enum AggregateOp : int {
+  Count = 0,
+  Min = 1,
+  Max = 2,
+  Sum = 3,
+  AggregateOp_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  AggregateOp_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool AggregateOp_IsValid(int value);
+constexpr AggregateOp AggregateOp_MIN = Count;
+constexpr AggregateOp AggregateOp_MAX = Sum;
+constexpr int AggregateOp_ARRAYSIZE = AggregateOp_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* AggregateOp_descriptor();
+template<typename T>
+inline const std::string& AggregateOp_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, AggregateOp>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function AggregateOp_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    AggregateOp_descriptor(), enum_t_value);
+}
+inline bool AggregateOp_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, AggregateOp* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<AggregateOp>(
+    AggregateOp_descriptor(), name, value);
+}
 // ===================================================================
 
 class GenericValue final :
@@ -292,6 +327,7 @@ class GenericValue final :
     kInt64Val = 2,
     kFloatVal = 3,
     kStringVal = 4,
+    kParamIndex = 5,
     VAL_NOT_SET = 0,
   };
 
@@ -377,6 +413,7 @@ class GenericValue final :
     kInt64ValFieldNumber = 2,
     kFloatValFieldNumber = 3,
     kStringValFieldNumber = 4,
+    kParamIndexFieldNumber = 5,
   };
   // bool bool_val = 1;
   bool has_bool_val() const;
@@ -435,6 +472,19 @@ class GenericValue final :
   std::string* _internal_mutable_string_val();
   public:
 
+  // int64 param_index = 5;
+  bool has_param_index() const;
+  private:
+  bool _internal_has_param_index() const;
+  public:
+  void clear_param_index();
+  int64_t param_index() const;
+  void set_param_index(int64_t value);
+  private:
+  int64_t _internal_param_index() const;
+  void _internal_set_param_index(int64_t value);
+  public:
+
   void clear_val();
   ValCase val_case() const;
   // @@protoc_insertion_point(class_scope:milvus.proto.plan.GenericValue)
@@ -444,6 +494,7 @@ class GenericValue final :
   void set_has_int64_val();
   void set_has_float_val();
   void set_has_string_val();
+  void set_has_param_index();
 
   inline bool has_val() const;
   inline void clear_has_val();
@@ -459,6 +510,7 @@ class GenericValue final :
       int64_t int64_val_;
       double float_val_;
       ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr string_val_;
+      int64_t param_index_;
     } val_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
     uint32_t _oneof_case_[1];
@@ -469,6 +521,163 @@ class GenericValue final :
 };
 // -------------------------------------------------------------------
 
+class PlanParams final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:milvus.proto.plan.PlanParams) */ {
+ public:
+  inline PlanParams() : PlanParams(nullptr) {}
+  ~PlanParams() override;
+  explicit PROTOBUF_CONSTEXPR PlanParams(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  PlanParams(const PlanParams& from);
+  PlanParams(PlanParams&& from) noexcept
+    : PlanParams() {
+    *this = ::std::move(from);
+  }
+
+  inline PlanParams& operator=(const PlanParams& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline PlanParams& operator=(PlanParams&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const PlanParams& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const PlanParams* internal_default_instance() {
+    return reinterpret_cast<const PlanParams*>(
+               &_PlanParams_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(PlanParams& a, PlanParams& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(PlanParams* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(PlanParams* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  PlanParams* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<PlanParams>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const PlanParams& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const PlanParams& from) {
+    PlanParams::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(PlanParams* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "milvus.proto.plan.PlanParams";
+  }
+  protected:
+  explicit PlanParams(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kValuesFieldNumber = 1,
+  };
+  // repeated .milvus.proto.plan.GenericValue values = 1;
+  int values_size() const;
+  private:
+  int _internal_values_size() const;
+  public:
+  void clear_values();
+  ::milvus::proto::plan::GenericValue* mutable_values(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::GenericValue >*
+      mutable_values();
+  private:
+  const ::milvus::proto::plan::GenericValue& _internal_values(int index) const;
+  ::milvus::proto::plan::GenericValue* _internal_add_values();
+  public:
+  const ::milvus::proto::plan::GenericValue& values(int index) const;
+  ::milvus::proto::plan::GenericValue* add_values();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::GenericValue >&
+      values() const;
+
+  // @@protoc_insertion_point(class_scope:milvus.proto.plan.PlanParams)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::GenericValue > values_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_plan_2eproto;
+};
+// -------------------------------------------------------------------
+
 class QueryInfo final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:milvus.proto.plan.QueryInfo) */ {
  public:
@@ -517,7 +726,7 @@ class QueryInfo final :
                &_QueryInfo_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    1;
+    2;
 
   friend void swap(QueryInfo& a, QueryInfo& b) {
     a.Swap(&b);
@@ -708,7 +917,7 @@ class ColumnInfo final :
                &_ColumnInfo_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    2;
+    3;
 
   friend void swap(ColumnInfo& a, ColumnInfo& b) {
     a.Swap(&b);
@@ -889,7 +1098,7 @@ class ColumnExpr final :
                &_ColumnExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    3;
+    4;
 
   friend void swap(ColumnExpr& a, ColumnExpr& b) {
     a.Swap(&b);
@@ -1046,7 +1255,7 @@ class ValueExpr final :
                &_ValueExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    4;
+    5;
 
   friend void swap(ValueExpr& a, ValueExpr& b) {
     a.Swap(&b);
@@ -1203,7 +1412,7 @@ class UnaryRangeExpr final :
                &_UnaryRangeExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    5;
+    6;
 
   friend void swap(UnaryRangeExpr& a, UnaryRangeExpr& b) {
     a.Swap(&b);
@@ -1391,7 +1600,7 @@ class BinaryRangeExpr final :
                &_BinaryRangeExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    6;
+    7;
 
   friend void swap(BinaryRangeExpr& a, BinaryRangeExpr& b) {
     a.Swap(&b);
@@ -1610,7 +1819,7 @@ class CompareExpr final :
                &_CompareExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    7;
+    8;
 
   friend void swap(CompareExpr& a, CompareExpr& b) {
     a.Swap(&b);
@@ -1798,7 +2007,7 @@ class TermExpr final :
                &_TermExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    8;
+    9;
 
   friend void swap(TermExpr& a, TermExpr& b) {
     a.Swap(&b);
@@ -1975,7 +2184,7 @@ class UnaryExpr final :
                &_UnaryExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    9;
+    10;
 
   friend void swap(UnaryExpr& a, UnaryExpr& b) {
     a.Swap(&b);
@@ -2173,7 +2382,7 @@ class BinaryExpr final :
                &_BinaryExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    10;
+    11;
 
   friend void swap(BinaryExpr& a, BinaryExpr& b) {
     a.Swap(&b);
@@ -2393,7 +2602,7 @@ class BinaryArithOp final :
                &_BinaryArithOp_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    11;
+    12;
 
   friend void swap(BinaryArithOp& a, BinaryArithOp& b) {
     a.Swap(&b);
@@ -2581,7 +2790,7 @@ class BinaryArithExpr final :
                &_BinaryArithExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    12;
+    13;
 
   friend void swap(BinaryArithExpr& a, BinaryArithExpr& b) {
     a.Swap(&b);
@@ -2769,7 +2978,7 @@ class BinaryArithOpEvalRangeExpr final :
                &_BinaryArithOpEvalRangeExpr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    13;
+    14;
 
   friend void swap(BinaryArithOpEvalRangeExpr& a, BinaryArithOpEvalRangeExpr& b) {
     a.Swap(&b);
@@ -3002,7 +3211,7 @@ class Expr final :
                &_Expr_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    14;
+    15;
 
   friend void swap(Expr& a, Expr& b) {
     a.Swap(&b);
@@ -3360,7 +3569,7 @@ class VectorANNS final :
                &_VectorANNS_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    15;
+    16;
 
   friend void swap(VectorANNS& a, VectorANNS& b) {
     a.Swap(&b);
@@ -3527,6 +3736,165 @@ class VectorANNS final :
 };
 // -------------------------------------------------------------------
 
+class Aggregate final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:milvus.proto.plan.Aggregate) */ {
+ public:
+  inline Aggregate() : Aggregate(nullptr) {}
+  ~Aggregate() override;
+  explicit PROTOBUF_CONSTEXPR Aggregate(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  Aggregate(const Aggregate& from);
+  Aggregate(Aggregate&& from) noexcept
+    : Aggregate() {
+    *this = ::std::move(from);
+  }
+
+  inline Aggregate& operator=(const Aggregate& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline Aggregate& operator=(Aggregate&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Aggregate& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const Aggregate* internal_default_instance() {
+    return reinterpret_cast<const Aggregate*>(
+               &_Aggregate_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    17;
+
+  friend void swap(Aggregate& a, Aggregate& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(Aggregate* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Aggregate* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  Aggregate* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<Aggregate>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const Aggregate& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Aggregate& from) {
+    Aggregate::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(Aggregate* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "milvus.proto.plan.Aggregate";
+  }
+  protected:
+  explicit Aggregate(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kFieldIdFieldNumber = 2,
+    kOpFieldNumber = 1,
+  };
+  // int64 field_id = 2;
+  void clear_field_id();
+  int64_t field_id() const;
+  void set_field_id(int64_t value);
+  private:
+  int64_t _internal_field_id() const;
+  void _internal_set_field_id(int64_t value);
+  public:
+
+  // .milvus.proto.plan.AggregateOp op = 1;
+  void clear_op();
+  ::milvus::proto::plan::AggregateOp op() const;
+  void set_op(::milvus::proto::plan::AggregateOp value);
+  private:
+  ::milvus::proto::plan::AggregateOp _internal_op() const;
+  void _internal_set_op(::milvus::proto::plan::AggregateOp value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:milvus.proto.plan.Aggregate)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    int64_t field_id_;
+    int op_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_plan_2eproto;
+};
+// -------------------------------------------------------------------
+
 class PlanNode final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:milvus.proto.plan.PlanNode) */ {
  public:
@@ -3581,7 +3949,7 @@ class PlanNode final :
                &_PlanNode_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    16;
+    18;
 
   friend void swap(PlanNode& a, PlanNode& b) {
     a.Swap(&b);
@@ -3655,6 +4023,10 @@ class PlanNode final :
 
   enum : int {
     kOutputFieldIdsFieldNumber = 3,
+    kAggregatesFieldNumber = 7,
+    kLimitFieldNumber = 4,
+    kOffsetFieldNumber = 5,
+    kOrderByPkFieldNumber = 6,
     kVectorAnnsFieldNumber = 1,
     kPredicatesFieldNumber = 2,
   };
@@ -3680,6 +4052,51 @@ class PlanNode final :
   ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
       mutable_output_field_ids();
 
+  // repeated .milvus.proto.plan.Aggregate aggregates = 7;
+  int aggregates_size() const;
+  private:
+  int _internal_aggregates_size() const;
+  public:
+  void clear_aggregates();
+  ::milvus::proto::plan::Aggregate* mutable_aggregates(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::Aggregate >*
+      mutable_aggregates();
+  private:
+  const ::milvus::proto::plan::Aggregate& _internal_aggregates(int index) const;
+  ::milvus::proto::plan::Aggregate* _internal_add_aggregates();
+  public:
+  const ::milvus::proto::plan::Aggregate& aggregates(int index) const;
+  ::milvus::proto::plan::Aggregate* add_aggregates();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::Aggregate >&
+      aggregates() const;
+
+  // int64 limit = 4;
+  void clear_limit();
+  int64_t limit() const;
+  void set_limit(int64_t value);
+  private:
+  int64_t _internal_limit() const;
+  void _internal_set_limit(int64_t value);
+  public:
+
+  // int64 offset = 5;
+  void clear_offset();
+  int64_t offset() const;
+  void set_offset(int64_t value);
+  private:
+  int64_t _internal_offset() const;
+  void _internal_set_offset(int64_t value);
+  public:
+
+  // bool order_by_pk = 6;
+  void clear_order_by_pk();
+  bool order_by_pk() const;
+  void set_order_by_pk(bool value);
+  private:
+  bool _internal_order_by_pk() const;
+  void _internal_set_order_by_pk(bool value);
+  public:
+
   // .milvus.proto.plan.VectorANNS vector_anns = 1;
   bool has_vector_anns() const;
   private:
@@ -3733,6 +4150,10 @@ class PlanNode final :
   struct Impl_ {
     ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t > output_field_ids_;
     mutable std::atomic<int> _output_field_ids_cached_byte_size_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::Aggregate > aggregates_;
+    int64_t limit_;
+    int64_t offset_;
+    bool order_by_pk_;
     union NodeUnion {
       constexpr NodeUnion() : _constinit_{} {}
         ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized _constinit_;
@@ -3948,6 +4369,44 @@ inline void GenericValue::set_allocated_string_val(std::string* string_val) {
   // @@protoc_insertion_point(field_set_allocated:milvus.proto.plan.GenericValue.string_val)
 }
 
+// int64 param_index = 5;
+inline bool GenericValue::_internal_has_param_index() const {
+  return val_case() == kParamIndex;
+}
+inline bool GenericValue::has_param_index() const {
+  return _internal_has_param_index();
+}
+inline void GenericValue::set_has_param_index() {
+  _impl_._oneof_case_[0] = kParamIndex;
+}
+inline void GenericValue::clear_param_index() {
+  if (_internal_has_param_index()) {
+    _impl_.val_.param_index_ = int64_t{0};
+    clear_has_val();
+  }
+}
+inline int64_t GenericValue::_internal_param_index() const {
+  if (_internal_has_param_index()) {
+    return _impl_.val_.param_index_;
+  }
+  return int64_t{0};
+}
+inline void GenericValue::_internal_set_param_index(int64_t value) {
+  if (!_internal_has_param_index()) {
+    clear_val();
+    set_has_param_index();
+  }
+  _impl_.val_.param_index_ = value;
+}
+inline int64_t GenericValue::param_index() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.GenericValue.param_index)
+  return _internal_param_index();
+}
+inline void GenericValue::set_param_index(int64_t value) {
+  _internal_set_param_index(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.plan.GenericValue.param_index)
+}
+
 inline bool GenericValue::has_val() const {
   return val_case() != VAL_NOT_SET;
 }
@@ -3959,6 +4418,50 @@ inline GenericValue::ValCase GenericValue::val_case() const {
 }
 // -------------------------------------------------------------------
 
+// PlanParams
+
+// repeated .milvus.proto.plan.GenericValue values = 1;
+inline int PlanParams::_internal_values_size() const {
+  return _impl_.values_.size();
+}
+inline int PlanParams::values_size() const {
+  return _internal_values_size();
+}
+inline void PlanParams::clear_values() {
+  _impl_.values_.Clear();
+}
+inline ::milvus::proto::plan::GenericValue* PlanParams::mutable_values(int index) {
+  // @@protoc_insertion_point(field_mutable:milvus.proto.plan.PlanParams.values)
+  return _impl_.values_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::GenericValue >*
+PlanParams::mutable_values() {
+  // @@protoc_insertion_point(field_mutable_list:milvus.proto.plan.PlanParams.values)
+  return &_impl_.values_;
+}
+inline const ::milvus::proto::plan::GenericValue& PlanParams::_internal_values(int index) const {
+  return _impl_.values_.Get(index);
+}
+inline const ::milvus::proto::plan::GenericValue& PlanParams::values(int index) const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.PlanParams.values)
+  return _internal_values(index);
+}
+inline ::milvus::proto::plan::GenericValue* PlanParams::_internal_add_values() {
+  return _impl_.values_.Add();
+}
+inline ::milvus::proto::plan::GenericValue* PlanParams::add_values() {
+  ::milvus::proto::plan::GenericValue* _add = _internal_add_values();
+  // @@protoc_insertion_point(field_add:milvus.proto.plan.PlanParams.values)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::GenericValue >&
+PlanParams::values() const {
+  // @@protoc_insertion_point(field_list:milvus.proto.plan.PlanParams.values)
+  return _impl_.values_;
+}
+
+// -------------------------------------------------------------------
+
 // QueryInfo
 
 // int64 topk = 1;
@@ -7298,6 +7801,50 @@ inline void VectorANNS::set_allocated_placeholder_tag(std::string* placeholder_t
 
 // -------------------------------------------------------------------
 
+// Aggregate
+
+// .milvus.proto.plan.AggregateOp op = 1;
+inline void Aggregate::clear_op() {
+  _impl_.op_ = 0;
+}
+inline ::milvus::proto::plan::AggregateOp Aggregate::_internal_op() const {
+  return static_cast< ::milvus::proto::plan::AggregateOp >(_impl_.op_);
+}
+inline ::milvus::proto::plan::AggregateOp Aggregate::op() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.Aggregate.op)
+  return _internal_op();
+}
+inline void Aggregate::_internal_set_op(::milvus::proto::plan::AggregateOp value) {
+  
+  _impl_.op_ = value;
+}
+inline void Aggregate::set_op(::milvus::proto::plan::AggregateOp value) {
+  _internal_set_op(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.plan.Aggregate.op)
+}
+
+// int64 field_id = 2;
+inline void Aggregate::clear_field_id() {
+  _impl_.field_id_ = int64_t{0};
+}
+inline int64_t Aggregate::_internal_field_id() const {
+  return _impl_.field_id_;
+}
+inline int64_t Aggregate::field_id() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.Aggregate.field_id)
+  return _internal_field_id();
+}
+inline void Aggregate::_internal_set_field_id(int64_t value) {
+  
+  _impl_.field_id_ = value;
+}
+inline void Aggregate::set_field_id(int64_t value) {
+  _internal_set_field_id(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.plan.Aggregate.field_id)
+}
+
+// -------------------------------------------------------------------
+
 // PlanNode
 
 // .milvus.proto.plan.VectorANNS vector_anns = 1;
@@ -7495,6 +8042,106 @@ PlanNode::mutable_output_field_ids() {
   return _internal_mutable_output_field_ids();
 }
 
+// int64 limit = 4;
+inline void PlanNode::clear_limit() {
+  _impl_.limit_ = int64_t{0};
+}
+inline int64_t PlanNode::_internal_limit() const {
+  return _impl_.limit_;
+}
+inline int64_t PlanNode::limit() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.PlanNode.limit)
+  return _internal_limit();
+}
+inline void PlanNode::_internal_set_limit(int64_t value) {
+  
+  _impl_.limit_ = value;
+}
+inline void PlanNode::set_limit(int64_t value) {
+  _internal_set_limit(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.plan.PlanNode.limit)
+}
+
+// int64 offset = 5;
+inline void PlanNode::clear_offset() {
+  _impl_.offset_ = int64_t{0};
+}
+inline int64_t PlanNode::_internal_offset() const {
+  return _impl_.offset_;
+}
+inline int64_t PlanNode::offset() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.PlanNode.offset)
+  return _internal_offset();
+}
+inline void PlanNode::_internal_set_offset(int64_t value) {
+  
+  _impl_.offset_ = value;
+}
+inline void PlanNode::set_offset(int64_t value) {
+  _internal_set_offset(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.plan.PlanNode.offset)
+}
+
+// bool order_by_pk = 6;
+inline void PlanNode::clear_order_by_pk() {
+  _impl_.order_by_pk_ = false;
+}
+inline bool PlanNode::_internal_order_by_pk() const {
+  return _impl_.order_by_pk_;
+}
+inline bool PlanNode::order_by_pk() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.PlanNode.order_by_pk)
+  return _internal_order_by_pk();
+}
+inline void PlanNode::_internal_set_order_by_pk(bool value) {
+  
+  _impl_.order_by_pk_ = value;
+}
+inline void PlanNode::set_order_by_pk(bool value) {
+  _internal_set_order_by_pk(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.plan.PlanNode.order_by_pk)
+}
+
+// repeated .milvus.proto.plan.Aggregate aggregates = 7;
+inline int PlanNode::_internal_aggregates_size() const {
+  return _impl_.aggregates_.size();
+}
+inline int PlanNode::aggregates_size() const {
+  return _internal_aggregates_size();
+}
+inline void PlanNode::clear_aggregates() {
+  _impl_.aggregates_.Clear();
+}
+inline ::milvus::proto::plan::Aggregate* PlanNode::mutable_aggregates(int index) {
+  // @@protoc_insertion_point(field_mutable:milvus.proto.plan.PlanNode.aggregates)
+  return _impl_.aggregates_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::Aggregate >*
+PlanNode::mutable_aggregates() {
+  // @@protoc_insertion_point(field_mutable_list:milvus.proto.plan.PlanNode.aggregates)
+  return &_impl_.aggregates_;
+}
+inline const ::milvus::proto::plan::Aggregate& PlanNode::_internal_aggregates(int index) const {
+  return _impl_.aggregates_.Get(index);
+}
+inline const ::milvus::proto::plan::Aggregate& PlanNode::aggregates(int index) const {
+  // @@protoc_insertion_point(field_get:milvus.proto.plan.PlanNode.aggregates)
+  return _internal_aggregates(index);
+}
+inline ::milvus::proto::plan::Aggregate* PlanNode::_internal_add_aggregates() {
+  return _impl_.aggregates_.Add();
+}
+inline ::milvus::proto::plan::Aggregate* PlanNode::add_aggregates() {
+  ::milvus::proto::plan::Aggregate* _add = _internal_add_aggregates();
+  // @@protoc_insertion_point(field_add:milvus.proto.plan.PlanNode.aggregates)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::plan::Aggregate >&
+PlanNode::aggregates() const {
+  // @@protoc_insertion_point(field_list:milvus.proto.plan.PlanNode.aggregates)
+  return _impl_.aggregates_;
+}
+
 inline bool PlanNode::has_node() const {
   return node_case() != NODE_NOT_SET;
 }
@@ -7539,6 +8186,10 @@ inline PlanNode::NodeCase PlanNode::node_case() const {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
@@ -7568,6 +8219,11 @@ template <>
 inline const EnumDescriptor* GetEnumDescriptor< ::milvus::proto::plan::ArithOpType>() {
   return ::milvus::proto::plan::ArithOpType_descriptor();
 }
+template <> struct is_proto_enum< ::milvus::proto::plan::AggregateOp> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::milvus::proto::plan::AggregateOp>() {
+  return ::milvus::proto::plan::AggregateOp_descriptor();
+}
 
 PROTOBUF_NAMESPACE_CLOSE
 
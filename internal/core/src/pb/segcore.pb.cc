@@ -23,11 +23,26 @@ namespace _pbi = _pb::internal;
 namespace milvus {
 namespace proto {
 namespace segcore {
+PROTOBUF_CONSTEXPR AggregateResult::AggregateResult(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.value_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_._oneof_case_)*/{}} {}
+struct AggregateResultDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR AggregateResultDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~AggregateResultDefaultTypeInternal() {}
+  union {
+    AggregateResult _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 AggregateResultDefaultTypeInternal _AggregateResult_default_instance_;
 PROTOBUF_CONSTEXPR RetrieveResults::RetrieveResults(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.offset_)*/{}
   , /*decltype(_impl_._offset_cached_byte_size_)*/{0}
   , /*decltype(_impl_.fields_data_)*/{}
+  , /*decltype(_impl_.aggregates_)*/{}
   , /*decltype(_impl_.ids_)*/nullptr
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct RetrieveResultsDefaultTypeInternal {
@@ -85,11 +100,20 @@ PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORIT
 }  // namespace segcore
 }  // namespace proto
 }  // namespace milvus
-static ::_pb::Metadata file_level_metadata_segcore_2eproto[4];
+static ::_pb::Metadata file_level_metadata_segcore_2eproto[5];
 static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_segcore_2eproto = nullptr;
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_segcore_2eproto = nullptr;
 
 const uint32_t TableStruct_segcore_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::AggregateResult, _internal_metadata_),
+  ~0u,  // no _extensions_
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::AggregateResult, _impl_._oneof_case_[0]),
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::AggregateResult, _impl_.value_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::RetrieveResults, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -99,6 +123,7 @@ const uint32_t TableStruct_segcore_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(
   PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::RetrieveResults, _impl_.ids_),
   PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::RetrieveResults, _impl_.offset_),
   PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::RetrieveResults, _impl_.fields_data_),
+  PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::RetrieveResults, _impl_.aggregates_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::LoadFieldMeta, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -126,13 +151,15 @@ const uint32_t TableStruct_segcore_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(
   PROTOBUF_FIELD_OFFSET(::milvus::proto::segcore::InsertRecord, _impl_.num_rows_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
-  { 0, -1, -1, sizeof(::milvus::proto::segcore::RetrieveResults)},
-  { 9, -1, -1, sizeof(::milvus::proto::segcore::LoadFieldMeta)},
-  { 18, -1, -1, sizeof(::milvus::proto::segcore::LoadSegmentMeta)},
-  { 26, -1, -1, sizeof(::milvus::proto::segcore::InsertRecord)},
+  { 0, -1, -1, sizeof(::milvus::proto::segcore::AggregateResult)},
+  { 9, -1, -1, sizeof(::milvus::proto::segcore::RetrieveResults)},
+  { 19, -1, -1, sizeof(::milvus::proto::segcore::LoadFieldMeta)},
+  { 28, -1, -1, sizeof(::milvus::proto::segcore::LoadSegmentMeta)},
+  { 36, -1, -1, sizeof(::milvus::proto::segcore::InsertRecord)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
+  &::milvus::proto::segcore::_AggregateResult_default_instance_._instance,
   &::milvus::proto::segcore::_RetrieveResults_default_instance_._instance,
   &::milvus::proto::segcore::_LoadFieldMeta_default_instance_._instance,
   &::milvus::proto::segcore::_LoadSegmentMeta_default_instance_._instance,
@@ -141,27 +168,30 @@ static const ::_pb::Message* const file_default_instances[] = {
 
 const char descriptor_table_protodef_segcore_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
   "\n\rsegcore.proto\022\024milvus.proto.segcore\032\014s"
-  "chema.proto\"}\n\017RetrieveResults\022%\n\003ids\030\001 "
-  "\001(\0132\030.milvus.proto.schema.IDs\022\016\n\006offset\030"
-  "\002 \003(\003\0223\n\013fields_data\030\003 \003(\0132\036.milvus.prot"
-  "o.schema.FieldData\"P\n\rLoadFieldMeta\022\025\n\rm"
-  "in_timestamp\030\001 \001(\003\022\025\n\rmax_timestamp\030\002 \001("
-  "\003\022\021\n\trow_count\030\003 \001(\003\"Y\n\017LoadSegmentMeta\022"
-  "2\n\005metas\030\001 \003(\0132#.milvus.proto.segcore.Lo"
-  "adFieldMeta\022\022\n\ntotal_size\030\002 \001(\003\"U\n\014Inser"
-  "tRecord\0223\n\013fields_data\030\001 \003(\0132\036.milvus.pr"
-  "oto.schema.FieldData\022\020\n\010num_rows\030\002 \001(\003B6"
-  "Z4github.com/milvus-io/milvus/internal/p"
-  "roto/segcorepbb\006proto3"
+  "chema.proto\"H\n\017AggregateResult\022\024\n\nlong_v"
+  "alue\030\001 \001(\003H\000\022\026\n\014double_value\030\002 \001(\001H\000B\007\n\005"
+  "value\"\270\001\n\017RetrieveResults\022%\n\003ids\030\001 \001(\0132\030"
+  ".milvus.proto.schema.IDs\022\016\n\006offset\030\002 \003(\003"
+  "\0223\n\013fields_data\030\003 \003(\0132\036.milvus.proto.sch"
+  "ema.FieldData\0229\n\naggregates\030\004 \003(\0132%.milv"
+  "us.proto.segcore.AggregateResult\"P\n\rLoad"
+  "FieldMeta\022\025\n\rmin_timestamp\030\001 \001(\003\022\025\n\rmax_"
+  "timestamp\030\002 \001(\003\022\021\n\trow_count\030\003 \001(\003\"Y\n\017Lo"
+  "adSegmentMeta\0222\n\005metas\030\001 \003(\0132#.milvus.pr"
+  "oto.segcore.LoadFieldMeta\022\022\n\ntotal_size\030"
+  "\002 \001(\003\"U\n\014InsertRecord\0223\n\013fields_data\030\001 \003"
+  "(\0132\036.milvus.proto.schema.FieldData\022\020\n\010nu"
+  "m_rows\030\002 \001(\003B6Z4github.com/milvus-io/mil"
+  "vus/internal/proto/segcorepbb\006proto3"
   ;
 static const ::_pbi::DescriptorTable* const descriptor_table_segcore_2eproto_deps[1] = {
   &::descriptor_table_schema_2eproto,
 };
 static ::_pbi::once_flag descriptor_table_segcore_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_segcore_2eproto = {
-    false, false, 502, descriptor_table_protodef_segcore_2eproto,
+    false, false, 636, descriptor_table_protodef_segcore_2eproto,
     "segcore.proto",
-    &descriptor_table_segcore_2eproto_once, descriptor_table_segcore_2eproto_deps, 1, 4,
+    &descriptor_table_segcore_2eproto_once, descriptor_table_segcore_2eproto_deps, 1, 5,
     schemas, file_default_instances, TableStruct_segcore_2eproto::offsets,
     file_level_metadata_segcore_2eproto, file_level_enum_descriptors_segcore_2eproto,
     file_level_service_descriptors_segcore_2eproto,
@@ -178,6 +208,257 @@ namespace segcore {
 
 // ===================================================================
 
+class AggregateResult::_Internal {
+ public:
+};
+
+AggregateResult::AggregateResult(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:milvus.proto.segcore.AggregateResult)
+}
+AggregateResult::AggregateResult(const AggregateResult& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  AggregateResult* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.value_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  clear_has_value();
+  switch (from.value_case()) {
+    case kLongValue: {
+      _this->_internal_set_long_value(from._internal_long_value());
+      break;
+    }
+    case kDoubleValue: {
+      _this->_internal_set_double_value(from._internal_double_value());
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  // @@protoc_insertion_point(copy_constructor:milvus.proto.segcore.AggregateResult)
+}
+
+inline void AggregateResult::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.value_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , /*decltype(_impl_._oneof_case_)*/{}
+  };
+  clear_has_value();
+}
+
+AggregateResult::~AggregateResult() {
+  // @@protoc_insertion_point(destructor:milvus.proto.segcore.AggregateResult)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void AggregateResult::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  if (has_value()) {
+    clear_value();
+  }
+}
+
+void AggregateResult::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void AggregateResult::clear_value() {
+// @@protoc_insertion_point(one_of_clear_start:milvus.proto.segcore.AggregateResult)
+  switch (value_case()) {
+    case kLongValue: {
+      // No need to clear
+      break;
+    }
+    case kDoubleValue: {
+      // No need to clear
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  _impl_._oneof_case_[0] = VALUE_NOT_SET;
+}
+
+
+void AggregateResult::Clear() {
+// @@protoc_insertion_point(message_clear_start:milvus.proto.segcore.AggregateResult)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  clear_value();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* AggregateResult::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // int64 long_value = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _internal_set_long_value(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // double double_value = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 17)) {
+          _internal_set_double_value(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<double>(ptr));
+          ptr += sizeof(double);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* AggregateResult::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:milvus.proto.segcore.AggregateResult)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // int64 long_value = 1;
+  if (_internal_has_long_value()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(1, this->_internal_long_value(), target);
+  }
+
+  // double double_value = 2;
+  if (_internal_has_double_value()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteDoubleToArray(2, this->_internal_double_value(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:milvus.proto.segcore.AggregateResult)
+  return target;
+}
+
+size_t AggregateResult::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:milvus.proto.segcore.AggregateResult)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  switch (value_case()) {
+    // int64 long_value = 1;
+    case kLongValue: {
+      total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_long_value());
+      break;
+    }
+    // double double_value = 2;
+    case kDoubleValue: {
+      total_size += 1 + 8;
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData AggregateResult::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    AggregateResult::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*AggregateResult::GetClassData() const { return &_class_data_; }
+
+
+void AggregateResult::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<AggregateResult*>(&to_msg);
+  auto& from = static_cast<const AggregateResult&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:milvus.proto.segcore.AggregateResult)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  switch (from.value_case()) {
+    case kLongValue: {
+      _this->_internal_set_long_value(from._internal_long_value());
+      break;
+    }
+    case kDoubleValue: {
+      _this->_internal_set_double_value(from._internal_double_value());
+      break;
+    }
+    case VALUE_NOT_SET: {
+      break;
+    }
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void AggregateResult::CopyFrom(const AggregateResult& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:milvus.proto.segcore.AggregateResult)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool AggregateResult::IsInitialized() const {
+  return true;
+}
+
+void AggregateResult::InternalSwap(AggregateResult* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_.value_, other->_impl_.value_);
+  swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata AggregateResult::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_segcore_2eproto_getter, &descriptor_table_segcore_2eproto_once,
+      file_level_metadata_segcore_2eproto[0]);
+}
+
+// ===================================================================
+
 class RetrieveResults::_Internal {
  public:
   static const ::milvus::proto::schema::IDs& ids(const RetrieveResults* msg);
@@ -209,6 +490,7 @@ RetrieveResults::RetrieveResults(const RetrieveResults& from)
       decltype(_impl_.offset_){from._impl_.offset_}
     , /*decltype(_impl_._offset_cached_byte_size_)*/{0}
     , decltype(_impl_.fields_data_){from._impl_.fields_data_}
+    , decltype(_impl_.aggregates_){from._impl_.aggregates_}
     , decltype(_impl_.ids_){nullptr}
     , /*decltype(_impl_._cached_size_)*/{}};
 
@@ -227,6 +509,7 @@ inline void RetrieveResults::SharedCtor(
       decltype(_impl_.offset_){arena}
     , /*decltype(_impl_._offset_cached_byte_size_)*/{0}
     , decltype(_impl_.fields_data_){arena}
+    , decltype(_impl_.aggregates_){arena}
     , decltype(_impl_.ids_){nullptr}
     , /*decltype(_impl_._cached_size_)*/{}
   };
@@ -245,6 +528,7 @@ inline void RetrieveResults::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   _impl_.offset_.~RepeatedField();
   _impl_.fields_data_.~RepeatedPtrField();
+  _impl_.aggregates_.~RepeatedPtrField();
   if (this != internal_default_instance()) delete _impl_.ids_;
 }
 
@@ -260,6 +544,7 @@ void RetrieveResults::Clear() {
 
   _impl_.offset_.Clear();
   _impl_.fields_data_.Clear();
+  _impl_.aggregates_.Clear();
   if (GetArenaForAllocation() == nullptr && _impl_.ids_ != nullptr) {
     delete _impl_.ids_;
   }
@@ -305,6 +590,19 @@ const char* RetrieveResults::_InternalParse(const char* ptr, ::_pbi::ParseContex
         } else
           goto handle_unusual;
         continue;
+      // repeated .milvus.proto.segcore.AggregateResult aggregates = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_aggregates(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<34>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -358,6 +656,14 @@ uint8_t* RetrieveResults::_InternalSerialize(
         InternalWriteMessage(3, repfield, repfield.GetCachedSize(), target, stream);
   }
 
+  // repeated .milvus.proto.segcore.AggregateResult aggregates = 4;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_aggregates_size()); i < n; i++) {
+    const auto& repfield = this->_internal_aggregates(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(4, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -395,6 +701,13 @@ size_t RetrieveResults::ByteSizeLong() const {
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
   }
 
+  // repeated .milvus.proto.segcore.AggregateResult aggregates = 4;
+  total_size += 1UL * this->_internal_aggregates_size();
+  for (const auto& msg : this->_impl_.aggregates_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
   // .milvus.proto.schema.IDs ids = 1;
   if (this->_internal_has_ids()) {
     total_size += 1 +
@@ -422,6 +735,7 @@ void RetrieveResults::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const
 
   _this->_impl_.offset_.MergeFrom(from._impl_.offset_);
   _this->_impl_.fields_data_.MergeFrom(from._impl_.fields_data_);
+  _this->_impl_.aggregates_.MergeFrom(from._impl_.aggregates_);
   if (from._internal_has_ids()) {
     _this->_internal_mutable_ids()->::milvus::proto::schema::IDs::MergeFrom(
         from._internal_ids());
@@ -445,13 +759,14 @@ void RetrieveResults::InternalSwap(RetrieveResults* other) {
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   _impl_.offset_.InternalSwap(&other->_impl_.offset_);
   _impl_.fields_data_.InternalSwap(&other->_impl_.fields_data_);
+  _impl_.aggregates_.InternalSwap(&other->_impl_.aggregates_);
   swap(_impl_.ids_, other->_impl_.ids_);
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata RetrieveResults::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_segcore_2eproto_getter, &descriptor_table_segcore_2eproto_once,
-      file_level_metadata_segcore_2eproto[0]);
+      file_level_metadata_segcore_2eproto[1]);
 }
 
 // ===================================================================
@@ -686,7 +1001,7 @@ void LoadFieldMeta::InternalSwap(LoadFieldMeta* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata LoadFieldMeta::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_segcore_2eproto_getter, &descriptor_table_segcore_2eproto_once,
-      file_level_metadata_segcore_2eproto[1]);
+      file_level_metadata_segcore_2eproto[2]);
 }
 
 // ===================================================================
@@ -898,7 +1213,7 @@ void LoadSegmentMeta::InternalSwap(LoadSegmentMeta* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata LoadSegmentMeta::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_segcore_2eproto_getter, &descriptor_table_segcore_2eproto_once,
-      file_level_metadata_segcore_2eproto[2]);
+      file_level_metadata_segcore_2eproto[3]);
 }
 
 // ===================================================================
@@ -1113,7 +1428,7 @@ void InsertRecord::InternalSwap(InsertRecord* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata InsertRecord::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_segcore_2eproto_getter, &descriptor_table_segcore_2eproto_once,
-      file_level_metadata_segcore_2eproto[3]);
+      file_level_metadata_segcore_2eproto[4]);
 }
 
 // @@protoc_insertion_point(namespace_scope)
@@ -1121,6 +1436,10 @@ void InsertRecord::InternalSwap(InsertRecord* other) {
 }  // namespace proto
 }  // namespace milvus
 PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::milvus::proto::segcore::AggregateResult*
+Arena::CreateMaybeMessage< ::milvus::proto::segcore::AggregateResult >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::milvus::proto::segcore::AggregateResult >(arena);
+}
 template<> PROTOBUF_NOINLINE ::milvus::proto::segcore::RetrieveResults*
 Arena::CreateMaybeMessage< ::milvus::proto::segcore::RetrieveResults >(Arena* arena) {
   return Arena::CreateMessageInternal< ::milvus::proto::segcore::RetrieveResults >(arena);
@@ -48,6 +48,9 @@ extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table
 namespace milvus {
 namespace proto {
 namespace segcore {
+class AggregateResult;
+struct AggregateResultDefaultTypeInternal;
+extern AggregateResultDefaultTypeInternal _AggregateResult_default_instance_;
 class InsertRecord;
 struct InsertRecordDefaultTypeInternal;
 extern InsertRecordDefaultTypeInternal _InsertRecord_default_instance_;
@@ -64,6 +67,7 @@ extern RetrieveResultsDefaultTypeInternal _RetrieveResults_default_instance_;
 }  // namespace proto
 }  // namespace milvus
 PROTOBUF_NAMESPACE_OPEN
+template<> ::milvus::proto::segcore::AggregateResult* Arena::CreateMaybeMessage<::milvus::proto::segcore::AggregateResult>(Arena*);
 template<> ::milvus::proto::segcore::InsertRecord* Arena::CreateMaybeMessage<::milvus::proto::segcore::InsertRecord>(Arena*);
 template<> ::milvus::proto::segcore::LoadFieldMeta* Arena::CreateMaybeMessage<::milvus::proto::segcore::LoadFieldMeta>(Arena*);
 template<> ::milvus::proto::segcore::LoadSegmentMeta* Arena::CreateMaybeMessage<::milvus::proto::segcore::LoadSegmentMeta>(Arena*);
@@ -75,6 +79,192 @@ namespace segcore {
 
 // ===================================================================
 
+class AggregateResult final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:milvus.proto.segcore.AggregateResult) */ {
+ public:
+  inline AggregateResult() : AggregateResult(nullptr) {}
+  ~AggregateResult() override;
+  explicit PROTOBUF_CONSTEXPR AggregateResult(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  AggregateResult(const AggregateResult& from);
+  AggregateResult(AggregateResult&& from) noexcept
+    : AggregateResult() {
+    *this = ::std::move(from);
+  }
+
+  inline AggregateResult& operator=(const AggregateResult& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline AggregateResult& operator=(AggregateResult&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const AggregateResult& default_instance() {
+    return *internal_default_instance();
+  }
+  enum ValueCase {
+    kLongValue = 1,
+    kDoubleValue = 2,
+    VALUE_NOT_SET = 0,
+  };
+
+  static inline const AggregateResult* internal_default_instance() {
+    return reinterpret_cast<const AggregateResult*>(
+               &_AggregateResult_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(AggregateResult& a, AggregateResult& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(AggregateResult* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(AggregateResult* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  AggregateResult* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<AggregateResult>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const AggregateResult& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const AggregateResult& from) {
+    AggregateResult::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(AggregateResult* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "milvus.proto.segcore.AggregateResult";
+  }
+  protected:
+  explicit AggregateResult(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kLongValueFieldNumber = 1,
+    kDoubleValueFieldNumber = 2,
+  };
+  // int64 long_value = 1;
+  bool has_long_value() const;
+  private:
+  bool _internal_has_long_value() const;
+  public:
+  void clear_long_value();
+  int64_t long_value() const;
+  void set_long_value(int64_t value);
+  private:
+  int64_t _internal_long_value() const;
+  void _internal_set_long_value(int64_t value);
+  public:
+
+  // double double_value = 2;
+  bool has_double_value() const;
+  private:
+  bool _internal_has_double_value() const;
+  public:
+  void clear_double_value();
+  double double_value() const;
+  void set_double_value(double value);
+  private:
+  double _internal_double_value() const;
+  void _internal_set_double_value(double value);
+  public:
+
+  void clear_value();
+  ValueCase value_case() const;
+  // @@protoc_insertion_point(class_scope:milvus.proto.segcore.AggregateResult)
+ private:
+  class _Internal;
+  void set_has_long_value();
+  void set_has_double_value();
+
+  inline bool has_value() const;
+  inline void clear_has_value();
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    union ValueUnion {
+      constexpr ValueUnion() : _constinit_{} {}
+        ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized _constinit_;
+      int64_t long_value_;
+      double double_value_;
+    } value_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    uint32_t _oneof_case_[1];
+
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_segcore_2eproto;
+};
+// -------------------------------------------------------------------
+
 class RetrieveResults final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:milvus.proto.segcore.RetrieveResults) */ {
  public:
@@ -123,7 +313,7 @@ class RetrieveResults final :
                &_RetrieveResults_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    0;
+    1;
 
   friend void swap(RetrieveResults& a, RetrieveResults& b) {
     a.Swap(&b);
@@ -198,6 +388,7 @@ class RetrieveResults final :
   enum : int {
     kOffsetFieldNumber = 2,
     kFieldsDataFieldNumber = 3,
+    kAggregatesFieldNumber = 4,
     kIdsFieldNumber = 1,
   };
   // repeated int64 offset = 2;
@@ -240,6 +431,24 @@ class RetrieveResults final :
   const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::schema::FieldData >&
       fields_data() const;
 
+  // repeated .milvus.proto.segcore.AggregateResult aggregates = 4;
+  int aggregates_size() const;
+  private:
+  int _internal_aggregates_size() const;
+  public:
+  void clear_aggregates();
+  ::milvus::proto::segcore::AggregateResult* mutable_aggregates(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::segcore::AggregateResult >*
+      mutable_aggregates();
+  private:
+  const ::milvus::proto::segcore::AggregateResult& _internal_aggregates(int index) const;
+  ::milvus::proto::segcore::AggregateResult* _internal_add_aggregates();
+  public:
+  const ::milvus::proto::segcore::AggregateResult& aggregates(int index) const;
+  ::milvus::proto::segcore::AggregateResult* add_aggregates();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::segcore::AggregateResult >&
+      aggregates() const;
+
   // .milvus.proto.schema.IDs ids = 1;
   bool has_ids() const;
   private:
@@ -269,6 +478,7 @@ class RetrieveResults final :
     ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t > offset_;
     mutable std::atomic<int> _offset_cached_byte_size_;
     ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::schema::FieldData > fields_data_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::segcore::AggregateResult > aggregates_;
     ::milvus::proto::schema::IDs* ids_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
@@ -325,7 +535,7 @@ class LoadFieldMeta final :
                &_LoadFieldMeta_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    1;
+    2;
 
   friend void swap(LoadFieldMeta& a, LoadFieldMeta& b) {
     a.Swap(&b);
@@ -495,7 +705,7 @@ class LoadSegmentMeta final :
                &_LoadSegmentMeta_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    2;
+    3;
 
   friend void swap(LoadSegmentMeta& a, LoadSegmentMeta& b) {
     a.Swap(&b);
@@ -663,7 +873,7 @@ class InsertRecord final :
                &_InsertRecord_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    3;
+    4;
 
   friend void swap(InsertRecord& a, InsertRecord& b) {
     a.Swap(&b);
@@ -790,6 +1000,95 @@ class InsertRecord final :
   #pragma GCC diagnostic push
   #pragma GCC diagnostic ignored "-Wstrict-aliasing"
 #endif  // __GNUC__
+// AggregateResult
+
+// int64 long_value = 1;
+inline bool AggregateResult::_internal_has_long_value() const {
+  return value_case() == kLongValue;
+}
+inline bool AggregateResult::has_long_value() const {
+  return _internal_has_long_value();
+}
+inline void AggregateResult::set_has_long_value() {
+  _impl_._oneof_case_[0] = kLongValue;
+}
+inline void AggregateResult::clear_long_value() {
+  if (_internal_has_long_value()) {
+    _impl_.value_.long_value_ = int64_t{0};
+    clear_has_value();
+  }
+}
+inline int64_t AggregateResult::_internal_long_value() const {
+  if (_internal_has_long_value()) {
+    return _impl_.value_.long_value_;
+  }
+  return int64_t{0};
+}
+inline void AggregateResult::_internal_set_long_value(int64_t value) {
+  if (!_internal_has_long_value()) {
+    clear_value();
+    set_has_long_value();
+  }
+  _impl_.value_.long_value_ = value;
+}
+inline int64_t AggregateResult::long_value() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.segcore.AggregateResult.long_value)
+  return _internal_long_value();
+}
+inline void AggregateResult::set_long_value(int64_t value) {
+  _internal_set_long_value(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.segcore.AggregateResult.long_value)
+}
+
+// double double_value = 2;
+inline bool AggregateResult::_internal_has_double_value() const {
+  return value_case() == kDoubleValue;
+}
+inline bool AggregateResult::has_double_value() const {
+  return _internal_has_double_value();
+}
+inline void AggregateResult::set_has_double_value() {
+  _impl_._oneof_case_[0] = kDoubleValue;
+}
+inline void AggregateResult::clear_double_value() {
+  if (_internal_has_double_value()) {
+    _impl_.value_.double_value_ = 0;
+    clear_has_value();
+  }
+}
+inline double AggregateResult::_internal_double_value() const {
+  if (_internal_has_double_value()) {
+    return _impl_.value_.double_value_;
+  }
+  return 0;
+}
+inline void AggregateResult::_internal_set_double_value(double value) {
+  if (!_internal_has_double_value()) {
+    clear_value();
+    set_has_double_value();
+  }
+  _impl_.value_.double_value_ = value;
+}
+inline double AggregateResult::double_value() const {
+  // @@protoc_insertion_point(field_get:milvus.proto.segcore.AggregateResult.double_value)
+  return _internal_double_value();
+}
+inline void AggregateResult::set_double_value(double value) {
+  _internal_set_double_value(value);
+  // @@protoc_insertion_point(field_set:milvus.proto.segcore.AggregateResult.double_value)
+}
+
+inline bool AggregateResult::has_value() const {
+  return value_case() != VALUE_NOT_SET;
+}
+inline void AggregateResult::clear_has_value() {
+  _impl_._oneof_case_[0] = VALUE_NOT_SET;
+}
+inline AggregateResult::ValueCase AggregateResult::value_case() const {
+  return AggregateResult::ValueCase(_impl_._oneof_case_[0]);
+}
+// -------------------------------------------------------------------
+
 // RetrieveResults
 
 // .milvus.proto.schema.IDs ids = 1;
@@ -961,6 +1260,46 @@ RetrieveResults::fields_data() const {
   return _impl_.fields_data_;
 }
 
+// repeated .milvus.proto.segcore.AggregateResult aggregates = 4;
+inline int RetrieveResults::_internal_aggregates_size() const {
+  return _impl_.aggregates_.size();
+}
+inline int RetrieveResults::aggregates_size() const {
+  return _internal_aggregates_size();
+}
+inline void RetrieveResults::clear_aggregates() {
+  _impl_.aggregates_.Clear();
+}
+inline ::milvus::proto::segcore::AggregateResult* RetrieveResults::mutable_aggregates(int index) {
+  // @@protoc_insertion_point(field_mutable:milvus.proto.segcore.RetrieveResults.aggregates)
+  return _impl_.aggregates_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::segcore::AggregateResult >*
+RetrieveResults::mutable_aggregates() {
+  // @@protoc_insertion_point(field_mutable_list:milvus.proto.segcore.RetrieveResults.aggregates)
+  return &_impl_.aggregates_;
+}
+inline const ::milvus::proto::segcore::AggregateResult& RetrieveResults::_internal_aggregates(int index) const {
+  return _impl_.aggregates_.Get(index);
+}
+inline const ::milvus::proto::segcore::AggregateResult& RetrieveResults::aggregates(int index) const {
+  // @@protoc_insertion_point(field_get:milvus.proto.segcore.RetrieveResults.aggregates)
+  return _internal_aggregates(index);
+}
+inline ::milvus::proto::segcore::AggregateResult* RetrieveResults::_internal_add_aggregates() {
+  return _impl_.aggregates_.Add();
+}
+inline ::milvus::proto::segcore::AggregateResult* RetrieveResults::add_aggregates() {
+  ::milvus::proto::segcore::AggregateResult* _add = _internal_add_aggregates();
+  // @@protoc_insertion_point(field_add:milvus.proto.segcore.RetrieveResults.aggregates)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::milvus::proto::segcore::AggregateResult >&
+RetrieveResults::aggregates() const {
+  // @@protoc_insertion_point(field_list:milvus.proto.segcore.RetrieveResults.aggregates)
+  return _impl_.aggregates_;
+}
+
 // -------------------------------------------------------------------
 
 // LoadFieldMeta
@@ -1159,6 +1498,8 @@ inline void InsertRecord::set_num_rows(int64_t value) {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
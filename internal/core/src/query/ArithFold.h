@@ -0,0 +1,133 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "ExprImpl.h"
+
+namespace milvus::query {
+
+// Rewrites `(x arith_op c) op v` on an integer field into a plain range
+// over x, so that the range kernels and zone maps apply, e.g. `x + 5 > 10`
+// becomes `x > 5`. Only arithmetic that is monotone increasing in x is
+// folded: addition, subtraction, and multiplication or truncating division
+// by a positive constant. Bounds are derived over the integers and clamped
+// to the field type; anything else is returned unchanged.
+template <typename T>
+ExprPtr
+FoldBinaryArithOpEvalRange(
+    std::unique_ptr<BinaryArithOpEvalRangeExprImpl<T>> expr) {
+    if constexpr (!std::is_integral_v<T> || std::is_same_v<T, bool>) {
+        return expr;
+    } else {
+        using Wide = __int128;
+        constexpr Wide min = std::numeric_limits<T>::min();
+        constexpr Wide max = std::numeric_limits<T>::max();
+        auto arith_op = expr->arith_op_;
+        auto c = Wide(expr->right_operand_);
+        auto v = Wide(expr->value_);
+        auto scaled =
+            arith_op == ArithOpType::Mul || arith_op == ArithOpType::Div;
+        if (!(arith_op == ArithOpType::Add || arith_op == ArithOpType::Sub ||
+              (scaled && c > 0))) {
+            return expr;
+        }
+
+        // the least x with (x arith_op c) >= k
+        auto least = [arith_op, c](Wide k) -> Wide {
+            switch (arith_op) {
+                case ArithOpType::Add:
+                    return k - c;
+                case ArithOpType::Sub:
+                    return k + c;
+                case ArithOpType::Mul:
+                    return k >= 0 ? (k + c - 1) / c : -(-k / c);
+                default:
+                    return k > 0 ? k * c : (k - 1) * c + 1;
+            }
+        };
+        // (x arith_op c) == v exactly for x in [lower, upper)
+        auto lower = least(v);
+        auto upper = least(v + 1);
+
+        auto field_id = expr->field_id_;
+        auto data_type = expr->data_type_;
+        auto unary = [&](OpType op, Wide value) -> ExprPtr {
+            return std::make_unique<UnaryRangeExprImpl<T>>(
+                field_id, data_type, op, static_cast<T>(value));
+        };
+        auto never = [&] { return unary(OpType::GreaterThan, max); };
+        auto always = [&] { return unary(OpType::GreaterEqual, min); };
+        // x >= bound and x < bound
+        auto at_least = [&](Wide bound) {
+            return bound > max
+                       ? never()
+                       : unary(OpType::GreaterEqual, std::max(bound, min));
+        };
+        auto below = [&](Wide bound) {
+            return bound > max ? always()
+                               : unary(OpType::LessThan, std::max(bound, min));
+        };
+        auto empty = lower >= upper || lower > max || upper <= min;
+        auto single = upper - lower == 1 && !empty;
+
+        switch (expr->op_type_) {
+            case OpType::GreaterEqual:
+                return at_least(lower);
+            case OpType::GreaterThan:
+                return at_least(upper);
+            case OpType::LessThan:
+                return below(lower);
+            case OpType::LessEqual:
+                return below(upper);
+            case OpType::Equal: {
+                if (empty) {
+                    return never();
+                }
+                if (single) {
+                    return unary(OpType::Equal, lower);
+                }
+                auto clamped = upper > max;
+                return std::make_unique<BinaryRangeExprImpl<T>>(
+                    field_id,
+                    data_type,
+                    true,
+                    clamped,
+                    static_cast<T>(std::max(lower, min)),
+                    static_cast<T>(clamped ? max : upper));
+            }
+            case OpType::NotEqual: {
+                if (empty) {
+                    return always();
+                }
+                if (single) {
+                    return unary(OpType::NotEqual, lower);
+                }
+                return expr;
+            }
+            default:
+                return expr;
+        }
+    }
+}
+
+}  // namespace milvus::query
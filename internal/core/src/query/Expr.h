@@ -18,9 +18,11 @@
 
 #include <any>
 #include <map>
+#include <mutex>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -39,10 +41,24 @@ struct Expr {
     virtual ~Expr() = default;
     virtual void
     accept(ExprVisitor&) = 0;
+
+ public:
+    // the literals of this leaf are parameters of a prepared plan, it only
+    // runs through the leaf bound for an execution
+    bool parameterized_ = false;
 };
 
 using ExprPtr = std::unique_ptr<Expr>;
 
+// the parameterized leaves of a prepared predicate rebuilt with the values
+// bound for one execution
+struct ExprBindings {
+    std::unordered_map<const Expr*, ExprPtr> exprs_;
+    // canonical encoding of the bound values, extends the fingerprint of
+    // the predicate
+    std::string fingerprint_;
+};
+
 struct BinaryExprBase : Expr {
     const ExprPtr left_;
     const ExprPtr right_;
@@ -76,6 +92,9 @@ struct LogicalUnaryExpr : UnaryExprBase {
     accept(ExprVisitor&) override;
 };
 
+// an AND tree of range leaves evaluated in one pass, see ExecExprVisitor
+struct FusedConjunction;
+
 struct LogicalBinaryExpr : BinaryExprBase {
     // Note: bitA - bitB == bitA & ~bitB, alias to LogicalMinus
     enum class OpType {
@@ -91,6 +110,11 @@ struct LogicalBinaryExpr : BinaryExprBase {
         : BinaryExprBase(left, right), op_type_(op_type) {
     }
 
+    // what an AND tree fuses into, built on its first evaluation and kept
+    // with the plan; null if it does not fuse
+    mutable std::once_flag fuse_once_;
+    mutable std::shared_ptr<const FusedConjunction> fused_;
+
  public:
     void
     accept(ExprVisitor&) override;
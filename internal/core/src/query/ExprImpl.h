@@ -21,17 +21,20 @@
 #include <boost/container/vector.hpp>
 
 #include "Expr.h"
+#include "TermSet.h"
 
 namespace milvus::query {
 
 template <typename T>
 struct TermExprImpl : TermExpr {
     const std::vector<T> terms_;
+    // built once here, probed by every segment the plan runs on
+    const TermSet<T> term_set_;
 
     TermExprImpl(const FieldId field_id,
                  const DataType data_type,
                  const std::vector<T>& terms)
-        : TermExpr(field_id, data_type), terms_(terms) {
+        : TermExpr(field_id, data_type), terms_(terms), term_set_(terms) {
     }
 };
 
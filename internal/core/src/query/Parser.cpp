@@ -17,9 +17,11 @@
 #include <vector>
 #include <boost/algorithm/string.hpp>
 
+#include "ArithFold.h"
 #include "ExprImpl.h"
 #include "Parser.h"
 #include "Plan.h"
+#include "common/Utils.h"
 #include "generated/ExtractInfoPlanNodeVisitor.h"
 #include "generated/VerifyPlanNodeVisitor.h"
 
@@ -200,10 +202,12 @@ Parser::ParseVecNode(const Json& out_body) {
         }
     }();
     vec_node->search_info_.topk_ = topk;
-    vec_node->search_info_.metric_type_ = vec_info.at("metric_type");
+    vec_node->search_info_.metric_type_ =
+        SearchMetric(vec_info.at("metric_type"));
     vec_node->search_info_.search_params_ = vec_info.at("params");
     vec_node->search_info_.field_id_ = field_id;
     vec_node->search_info_.round_decimal_ = vec_info.at("round_decimal");
+    ParseSearchParams(vec_node->search_info_);
     vec_node->placeholder_tag_ = vec_info.at("query");
     auto tag = vec_node->placeholder_tag_;
     AssertInfo(!tag2field_.count(tag), "duplicated placeholder tag");
@@ -301,13 +305,14 @@ Parser::ParseRangeNodeImpl(const FieldName& field_name, const Json& body) {
                 static_assert(always_false<T>, "unsupported type");
             }
 
-            return std::make_unique<BinaryArithOpEvalRangeExprImpl<T>>(
-                schema.get_field_id(field_name),
-                schema[field_name].get_data_type(),
-                arith_op_mapping_.at(arith_op_name),
-                right_operand,
-                mapping_.at(op_name),
-                value);
+            return FoldBinaryArithOpEvalRange(
+                std::make_unique<BinaryArithOpEvalRangeExprImpl<T>>(
+                    schema.get_field_id(field_name),
+                    schema[field_name].get_data_type(),
+                    arith_op_mapping_.at(arith_op_name),
+                    right_operand,
+                    mapping_.at(op_name),
+                    value));
         }
 
         if constexpr (std::is_same_v<T, bool>) {
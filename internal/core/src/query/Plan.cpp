@@ -14,55 +14,226 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
 #include "Parser.h"
 #include "Plan.h"
 #include "PlanProto.h"
+#include "SearchBruteForce.h"
+#include "common/Utils.h"
 #include "generated/ShowPlanNodeVisitor.h"
 
 namespace milvus::query {
 
-// deprecated
-std::unique_ptr<PlaceholderGroup>
-ParsePlaceholderGroup(const Plan* plan,
-                      const std::string& placeholder_group_blob) {
-    return ParsePlaceholderGroup(
-        plan,
-        reinterpret_cast<const uint8_t*>(placeholder_group_blob.c_str()),
-        placeholder_group_blob.size());
+namespace {
+
+// a placeholder as laid out in the serialized group, its values point
+// into the serialized bytes
+struct RawPlaceholder {
+    std::string tag;
+    std::vector<std::pair<const char*, int64_t>> values;
+};
+
+// walks the wire format of common.PlaceholderGroup instead of parsing
+// it into messages, which would copy every query vector into a string
+std::vector<RawPlaceholder>
+ParseRawPlaceholders(const uint8_t* blob, const int64_t blob_len) {
+    namespace io = google::protobuf::io;
+    using google::protobuf::internal::WireFormatLite;
+    using proto::common::PlaceholderGroup;
+    using proto::common::PlaceholderValue;
+    constexpr auto kDelimited = WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+    constexpr auto kPlaceholdersTag = WireFormatLite::MakeTag(
+        PlaceholderGroup::kPlaceholdersFieldNumber, kDelimited);
+    constexpr auto kTagTag =
+        WireFormatLite::MakeTag(PlaceholderValue::kTagFieldNumber, kDelimited);
+    constexpr auto kValuesTag = WireFormatLite::MakeTag(
+        PlaceholderValue::kValuesFieldNumber, kDelimited);
+
+    AssertInfo(blob_len <= std::numeric_limits<int>::max(),
+               "placeholder group too large");
+    io::CodedInputStream input(blob, blob_len);
+    std::vector<RawPlaceholder> result;
+    while (auto tag = input.ReadTag()) {
+        if (tag != kPlaceholdersTag) {
+            AssertInfo(WireFormatLite::SkipField(&input, tag),
+                       "invalid placeholder group");
+            continue;
+        }
+        uint32_t size;
+        AssertInfo(input.ReadVarint32(&size), "invalid placeholder group");
+        auto limit = input.PushLimit(size);
+        RawPlaceholder placeholder;
+        while (auto field = input.ReadTag()) {
+            if (field == kTagTag) {
+                AssertInfo(WireFormatLite::ReadString(&input, &placeholder.tag),
+                           "invalid placeholder group");
+            } else if (field == kValuesTag) {
+                uint32_t line_size;
+                AssertInfo(input.ReadVarint32(&line_size),
+                           "invalid placeholder group");
+                auto line = reinterpret_cast<const char*>(blob) +
+                            input.CurrentPosition();
+                AssertInfo(input.Skip(line_size), "invalid placeholder group");
+                placeholder.values.emplace_back(line, line_size);
+            } else {
+                AssertInfo(WireFormatLite::SkipField(&input, field),
+                           "invalid placeholder group");
+            }
+        }
+        AssertInfo(input.ConsumedEntireMessage(), "invalid placeholder group");
+        input.PopLimit(limit);
+        result.emplace_back(std::move(placeholder));
+    }
+    AssertInfo(input.ConsumedEntireMessage(), "invalid placeholder group");
+    return result;
 }
 
+// finds the queries repeating an earlier one, by a hash of their bytes,
+// and gathers the distinct ones
+void
+DedupQueries(Placeholder& element) {
+    auto num_queries = element.num_of_queries_;
+    auto line_sizeof = element.line_sizeof_;
+    if (num_queries < 2) {
+        return;
+    }
+    std::unordered_map<std::string_view, int64_t> unique_index;
+    unique_index.reserve(num_queries);
+    std::vector<int64_t> unique_of(num_queries);
+    std::vector<int64_t> firsts;
+    for (int64_t i = 0; i < num_queries; ++i) {
+        std::string_view line(element.data_ + i * line_sizeof, line_sizeof);
+        auto [it, inserted] = unique_index.emplace(line, firsts.size());
+        if (inserted) {
+            firsts.push_back(i);
+        }
+        unique_of[i] = it->second;
+    }
+    if (int64_t(firsts.size()) == num_queries) {
+        return;
+    }
+    auto target =
+        std::make_shared<aligned_vector<char>>(line_sizeof * firsts.size());
+    for (size_t i = 0; i < firsts.size(); ++i) {
+        std::memcpy(target->data() + i * line_sizeof,
+                    element.data_ + firsts[i] * line_sizeof,
+                    line_sizeof);
+    }
+    element.unique_of_ = std::move(unique_of);
+    element.num_of_unique_queries_ = firsts.size();
+    element.unique_data_ = target->data();
+    element.unique_holder_ = std::move(target);
+}
+
+// views the query vectors in the serialized group when serialized keeps
+// it alive and the rows are contiguous and aligned, copies them otherwise
 std::unique_ptr<PlaceholderGroup>
-ParsePlaceholderGroup(const Plan* plan,
+BuildPlaceholderGroup(const Plan* plan,
                       const uint8_t* blob,
-                      const int64_t blob_len) {
-    namespace set = milvus::proto::common;
+                      const int64_t blob_len,
+                      std::shared_ptr<const void> serialized) {
     auto result = std::make_unique<PlaceholderGroup>();
-    set::PlaceholderGroup ph_group;
-    auto ok = ph_group.ParseFromArray(blob, blob_len);
-    Assert(ok);
-    for (auto& info : ph_group.placeholders()) {
+    for (auto& info : ParseRawPlaceholders(blob, blob_len)) {
         Placeholder element;
-        element.tag_ = info.tag();
+        element.tag_ = std::move(info.tag);
         Assert(plan->tag2field_.count(element.tag_));
         auto field_id = plan->tag2field_.at(element.tag_);
         auto& field_meta = plan->schema_[field_id];
-        element.num_of_queries_ = info.values_size();
+        element.num_of_queries_ = info.values.size();
         AssertInfo(element.num_of_queries_, "must have queries");
         Assert(element.num_of_queries_ > 0);
-        element.line_sizeof_ = info.values().Get(0).size();
+        if (field_meta.is_sparse_vector()) {
+            // the queries vary in size, they are parsed into rows
+            auto rows = std::make_shared<std::vector<SparseFloatRow>>();
+            rows->reserve(element.num_of_queries_);
+            for (auto [line, size] : info.values) {
+                rows->push_back(
+                    ParseSparseQuery(line, size, field_meta.get_dim()));
+            }
+            element.line_sizeof_ = sizeof(SparseFloatRow);
+            element.data_ = reinterpret_cast<const char*>(rows->data());
+            element.holder_ = std::move(rows);
+            result->emplace_back(std::move(element));
+            continue;
+        }
+        element.line_sizeof_ = info.values[0].second;
         AssertInfo(field_meta.get_sizeof() == element.line_sizeof_,
                    "vector dimension mismatch");
-        auto& target = element.blob_;
-        target.reserve(element.line_sizeof_ * element.num_of_queries_);
-        for (auto& line : info.values()) {
-            Assert(element.line_sizeof_ == line.size());
-            target.insert(target.end(), line.begin(), line.end());
+
+        auto line_sizeof = element.line_sizeof_;
+        auto first = info.values[0].first;
+        auto contiguous = true;
+        for (int64_t i = 0; i < element.num_of_queries_; ++i) {
+            auto [line, size] = info.values[i];
+            Assert(line_sizeof == size);
+            contiguous = contiguous && line == first + i * line_sizeof;
+        }
+        auto alignment = field_meta.get_data_type() == DataType::VECTOR_FLOAT
+                             ? alignof(float)
+                             : 1;
+        auto aligned = reinterpret_cast<uintptr_t>(first) % alignment == 0;
+        // the queries of a cosine field are normalized in a copy
+        auto normalize = IsCosineField(field_meta);
+        if (serialized != nullptr && contiguous && aligned && !normalize) {
+            element.data_ = first;
+            element.holder_ = serialized;
+        } else {
+            auto target = std::make_shared<aligned_vector<char>>(
+                line_sizeof * element.num_of_queries_);
+            for (int64_t i = 0; i < element.num_of_queries_; ++i) {
+                std::memcpy(target->data() + i * line_sizeof,
+                            info.values[i].first,
+                            line_sizeof);
+            }
+            if (normalize) {
+                NormalizeVectors(reinterpret_cast<float*>(target->data()),
+                                 element.num_of_queries_,
+                                 field_meta.get_dim());
+            }
+            element.data_ = target->data();
+            element.holder_ = std::move(target);
         }
+        DedupQueries(element);
         result->emplace_back(std::move(element));
     }
     return result;
 }
 
+}  // namespace
+
+// deprecated
+std::unique_ptr<PlaceholderGroup>
+ParsePlaceholderGroup(const Plan* plan,
+                      const std::string& placeholder_group_blob) {
+    return ParsePlaceholderGroup(
+        plan,
+        reinterpret_cast<const uint8_t*>(placeholder_group_blob.c_str()),
+        placeholder_group_blob.size());
+}
+
+std::unique_ptr<PlaceholderGroup>
+ParsePlaceholderGroup(const Plan* plan,
+                      const uint8_t* blob,
+                      const int64_t blob_len) {
+    return BuildPlaceholderGroup(plan, blob, blob_len, nullptr);
+}
+
+std::unique_ptr<PlaceholderGroup>
+ParsePlaceholderGroup(const Plan* plan,
+                      std::shared_ptr<const std::string> serialized_group) {
+    auto blob = reinterpret_cast<const uint8_t*>(serialized_group->data());
+    auto blob_len = int64_t(serialized_group->size());
+    return BuildPlaceholderGroup(
+        plan, blob, blob_len, std::move(serialized_group));
+}
+
 std::unique_ptr<Plan>
 CreatePlan(const Schema& schema, const std::string& dsl_str) {
     Json dsl;
@@ -90,6 +261,41 @@ CreateRetrievePlanByExpr(const Schema& schema,
     return ProtoParser(schema).CreateRetrievePlan(plan_node);
 }
 
+void
+BindSearchPlanParams(Plan* plan,
+                     const void* serialized_params,
+                     const int64_t size) {
+    proto::plan::PlanParams params;
+    AssertInfo(params.ParseFromArray(serialized_params, size),
+               "invalid plan params");
+    plan->bindings_ = ProtoParser(plan->schema_)
+                          .BindParams(plan->plan_node_->param_slots_, params);
+}
+
+void
+BindRetrievePlanParams(RetrievePlan* plan,
+                       const void* serialized_params,
+                       const int64_t size) {
+    proto::plan::PlanParams params;
+    AssertInfo(params.ParseFromArray(serialized_params, size),
+               "invalid plan params");
+    plan->bindings_ = ProtoParser(plan->schema_)
+                          .BindParams(plan->plan_node_->param_slots_, params);
+}
+
+void
+ShareSearchBound(Plan* plan, const PlaceholderGroup* group) {
+    auto& node = *plan->plan_node_;
+    // the fused scores of several fields are not the distances of one
+    AssertInfo(dynamic_cast<const MultiVectorANNS*>(&node) == nullptr,
+               "searches of several vector fields share no bound");
+    auto& info = node.search_info_;
+    auto radius = info.GetParams()->radius_.value_or(
+        SubSearchResult::init_value(info.metric_type_));
+    plan->search_bound_ = std::make_shared<RangeSearchBound>(
+        GetNumOfQueries(group), info.metric_type_, radius);
+}
+
 int64_t
 GetTopK(const Plan* plan) {
     return plan->plan_node_->search_info_.topk_;
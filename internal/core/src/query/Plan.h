@@ -45,6 +45,12 @@ std::unique_ptr<PlaceholderGroup>
 ParsePlaceholderGroup(const Plan* plan,
                       const std::string& placeholder_group_blob);
 
+// keeps the serialized group alive and views the query vectors in it
+// when they need no copy to be contiguous and aligned
+std::unique_ptr<PlaceholderGroup>
+ParsePlaceholderGroup(const Plan* plan,
+                      std::shared_ptr<const std::string> serialized_group);
+
 int64_t
 GetNumOfQueries(const PlaceholderGroup*);
 
@@ -53,6 +59,24 @@ CreateRetrievePlanByExpr(const Schema& schema,
                          const void* serialized_expr_plan,
                          const int64_t size);
 
+// bind the parameters of a plan parsed from a prepared expression to the
+// values of a serialized proto::plan::PlanParams
+void
+BindSearchPlanParams(Plan* plan,
+                     const void* serialized_params,
+                     const int64_t size);
+
+void
+BindRetrievePlanParams(RetrievePlan* plan,
+                       const void* serialized_params,
+                       const int64_t size);
+
+// the segments searched with plan and group drop the hits beyond the
+// topk-th distances the ones searched before found, which cannot make the
+// topk of the request; a range search also narrows its radius to them
+void
+ShareSearchBound(Plan* plan, const PlaceholderGroup* group);
+
 // Query Overall TopK from Plan
 // Used to alloc result memory at Go side
 int64_t
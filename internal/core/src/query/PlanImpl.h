@@ -21,12 +21,15 @@
 #include "PlanNode.h"
 #include "exceptions/EasyAssert.h"
 #include "utils/Json.h"
+#include "common/CancelToken.h"
 #include "common/Consts.h"
 
 namespace milvus::query {
 
 using Json = nlohmann::json;
 
+class RangeSearchBound;
+
 struct ExtractedPlanInfo {
  public:
     explicit ExtractedPlanInfo(int64_t size) : involved_fields_(size) {
@@ -50,7 +53,23 @@ struct Plan {
 
  public:
     const Schema& schema_;
-    std::unique_ptr<VectorPlanNode> plan_node_;
+    // shared by the copies of a cached plan, not modified after parsing
+    std::shared_ptr<VectorPlanNode> plan_node_;
+    // the values bound to the parameters of plan_node_ for this execution
+    std::shared_ptr<const ExprBindings> bindings_;
+    // collect a QueryProfile of each segment searched and of the reduce
+    bool profile_ = false;
+    // the topk-th distances of the segments searched with this plan so
+    // far, null unless the request shares them, see ShareSearchBound
+    std::shared_ptr<RangeSearchBound> search_bound_;
+    // stops the searches with this plan
+    CancelToken cancel_token_;
+    // past the deadline of cancel_token_, SearchSegmentsAndReduce reduces
+    // the results of the segments searched by then instead of failing
+    bool partial_on_deadline_ = false;
+    // whose work the searches are queued as, and the share it gets
+    std::string tenant_;
+    int64_t tenant_weight_ = 1;
     std::map<std::string, FieldId> tag2field_;  // PlaceholderName -> FieldId
     std::vector<FieldId> target_entries_;
     void
@@ -65,18 +84,23 @@ struct Placeholder {
     std::string tag_;
     int64_t num_of_queries_;
     int64_t line_sizeof_;
-    aligned_vector<char> blob_;
+    // num_of_queries_ rows of line_sizeof_ bytes, either copied into an
+    // owned buffer or viewed in the serialized group; holder_ keeps them
+    // alive and is shared by everything searched with this placeholder
+    const char* data_ = nullptr;
+    std::shared_ptr<const void> holder_;
+    // when some queries repeat, the distinct ones in order of their first
+    // occurrence, searched in place of all of them; query i is distinct
+    // query unique_of_[i]. unique_of_ is empty if none repeats
+    std::vector<int64_t> unique_of_;
+    int64_t num_of_unique_queries_ = 0;
+    const char* unique_data_ = nullptr;
+    std::shared_ptr<const void> unique_holder_;
 
     template <typename T>
     const T*
     get_blob() const {
-        return reinterpret_cast<const T*>(blob_.data());
-    }
-
-    template <typename T>
-    T*
-    get_blob() {
-        return reinterpret_cast<T*>(blob_.data());
+        return reinterpret_cast<const T*>(data_);
     }
 };
 
@@ -87,8 +111,12 @@ struct RetrievePlan {
 
  public:
     const Schema& schema_;
-    std::unique_ptr<RetrievePlanNode> plan_node_;
+    // shared by the copies of a cached plan, not modified after parsing
+    std::shared_ptr<RetrievePlanNode> plan_node_;
+    std::shared_ptr<const ExprBindings> bindings_;
     std::vector<FieldId> field_ids_;
+    // stops the retrieves with this plan
+    CancelToken cancel_token_;
 };
 
 using PlanPtr = std::unique_ptr<Plan>;
@@ -34,8 +34,20 @@ struct PlanNode {
 
 using PlanNodePtr = std::unique_ptr<PlanNode>;
 
+// a leaf of a prepared predicate, proto_ is the leaf as written and is
+// parsed again with the bound values in place of its parameters
+struct ExprParamSlot {
+    const Expr* expr_;
+    proto::plan::Expr proto_;
+};
+
 struct VectorPlanNode : PlanNode {
     std::optional<ExprPtr> predicate_;
+    // canonical encoding of predicate_, keys the filter cache of segments;
+    // empty if the plan did not come from a proto
+    std::string predicate_fingerprint_;
+    // empty unless the predicate has parameters
+    std::vector<ExprParamSlot> param_slots_;
     SearchInfo search_info_;
     std::string placeholder_tag_;
 };
@@ -52,12 +64,61 @@ struct BinaryVectorANNS : VectorPlanNode {
     accept(PlanNodeVisitor&) override;
 };
 
+// searches a sparse float vector field by inner product, by brute force
+// in growing segments and over an inverted index in sealed ones
+struct SparseFloatVectorANNS : VectorPlanNode {
+ public:
+    void
+    accept(PlanNodeVisitor&) override;
+};
+
+// one of the vector fields of a MultiVectorANNS
+struct VectorFieldSearch {
+    SearchInfo search_info_;
+    std::string placeholder_tag_;
+    float weight_ = 1;
+};
+
+// searches several vector fields under one predicate, a row scoring the
+// weighted sum of its distances on all of them; search_info_ and
+// placeholder_tag_ are those of the first field, whose topk and metric
+// give the fused topk and order
+struct MultiVectorANNS : VectorPlanNode {
+ public:
+    void
+    accept(PlanNodeVisitor&) override;
+
+    std::vector<VectorFieldSearch> fields_;
+};
+
+enum class AggregateOp {
+    Count = 0,
+    Min = 1,
+    Max = 2,
+    Sum = 3,
+};
+
+struct AggregateInfo {
+    AggregateOp op_;
+    // unused by count
+    FieldId field_id_;
+};
+
 struct RetrievePlanNode : PlanNode {
  public:
     void
     accept(PlanNodeVisitor&) override;
 
     ExprPtr predicate_;
+    std::string predicate_fingerprint_;
+    std::vector<ExprParamSlot> param_slots_;
+    // a segment keeps offset_ + limit_ rows, 0 keeps all of them
+    int64_t limit_ = 0;
+    int64_t offset_ = 0;
+    bool order_by_pk_ = false;
+    // if not empty, the retrieve returns these over the matching rows
+    // instead of the rows themselves
+    std::vector<AggregateInfo> aggregates_;
 };
 
 }  // namespace milvus::query
@@ -11,11 +11,22 @@
 
 #include "PlanProto.h"
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <optional>
 #include <string>
+#include <unordered_set>
 
+#include "ArithFold.h"
 #include "ExprImpl.h"
+#include "common/Consts.h"
+#include "common/Utils.h"
 #include "common/VectorTrait.h"
 #include "generated/ExtractInfoExprVisitor.h"
 #include "generated/ExtractInfoPlanNodeVisitor.h"
@@ -116,7 +127,7 @@ ExtractBinaryRangeExprImpl(FieldId field_id,
 }
 
 template <typename T>
-std::unique_ptr<BinaryArithOpEvalRangeExprImpl<T>>
+ExprPtr
 ExtractBinaryArithOpEvalRangeExprImpl(
     FieldId field_id,
     DataType data_type,
@@ -136,41 +147,566 @@ ExtractBinaryArithOpEvalRangeExprImpl(
             static_assert(always_false<T>);
         }
     };
-    return std::make_unique<BinaryArithOpEvalRangeExprImpl<T>>(
-        field_id,
-        data_type,
-        static_cast<ArithOpType>(expr_proto.arith_op()),
-        getValue(expr_proto.right_operand()),
-        static_cast<OpType>(expr_proto.op()),
-        getValue(expr_proto.value()));
+    return FoldBinaryArithOpEvalRange(
+        std::make_unique<BinaryArithOpEvalRangeExprImpl<T>>(
+            field_id,
+            data_type,
+            static_cast<ArithOpType>(expr_proto.arith_op()),
+            getValue(expr_proto.right_operand()),
+            static_cast<OpType>(expr_proto.op()),
+            getValue(expr_proto.value())));
 }
 
-std::unique_ptr<VectorPlanNode>
-ProtoParser::PlanNodeFromProto(const planpb::PlanNode& plan_node_proto) {
-    // TODO: add more buffs
-    Assert(plan_node_proto.has_vector_anns());
-    auto& anns_proto = plan_node_proto.vector_anns();
-    auto expr_opt = [&]() -> std::optional<ExprPtr> {
-        if (!anns_proto.has_predicates()) {
+// deterministic serialization of a predicate or of the values bound to
+// its parameters, the same bytes for the same message
+static std::string
+Fingerprint(const google::protobuf::MessageLite& message) {
+    std::string fingerprint;
+    {
+        google::protobuf::io::StringOutputStream stream(&fingerprint);
+        google::protobuf::io::CodedOutputStream output(&stream);
+        output.SetSerializationDeterministic(true);
+        message.SerializeToCodedStream(&output);
+    }
+    return fingerprint;
+}
+
+static bool
+IsParam(const planpb::GenericValue& value) {
+    return value.val_case() == planpb::GenericValue::kParamIndex;
+}
+
+// whether a leaf expression has parameters for literals
+static bool
+HasParams(const planpb::Expr& expr_pb) {
+    switch (expr_pb.expr_case()) {
+        case planpb::Expr::kTermExpr: {
+            auto& values = expr_pb.term_expr().values();
+            return std::any_of(values.begin(), values.end(), IsParam);
+        }
+        case planpb::Expr::kUnaryRangeExpr: {
+            return IsParam(expr_pb.unary_range_expr().value());
+        }
+        case planpb::Expr::kBinaryRangeExpr: {
+            auto& range = expr_pb.binary_range_expr();
+            return IsParam(range.lower_value()) ||
+                   IsParam(range.upper_value());
+        }
+        case planpb::Expr::kBinaryArithOpEvalRangeExpr: {
+            auto& range = expr_pb.binary_arith_op_eval_range_expr();
+            return IsParam(range.right_operand()) || IsParam(range.value());
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// replaces each parameter of a leaf expression with
+// func(param_index, column_info)
+template <typename Func>
+static void
+ReplaceParams(planpb::Expr& expr_pb, Func func) {
+    auto replace = [&](planpb::GenericValue* value,
+                       const planpb::ColumnInfo& column_info) {
+        if (IsParam(*value)) {
+            *value = func(value->param_index(), column_info);
+        }
+    };
+    switch (expr_pb.expr_case()) {
+        case planpb::Expr::kTermExpr: {
+            auto term = expr_pb.mutable_term_expr();
+            for (auto& value : *term->mutable_values()) {
+                replace(&value, term->column_info());
+            }
+            break;
+        }
+        case planpb::Expr::kUnaryRangeExpr: {
+            auto range = expr_pb.mutable_unary_range_expr();
+            replace(range->mutable_value(), range->column_info());
+            break;
+        }
+        case planpb::Expr::kBinaryRangeExpr: {
+            auto range = expr_pb.mutable_binary_range_expr();
+            replace(range->mutable_lower_value(), range->column_info());
+            replace(range->mutable_upper_value(), range->column_info());
+            break;
+        }
+        case planpb::Expr::kBinaryArithOpEvalRangeExpr: {
+            auto range = expr_pb.mutable_binary_arith_op_eval_range_expr();
+            replace(range->mutable_right_operand(), range->column_info());
+            replace(range->mutable_value(), range->column_info());
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+// stands in for a parameter of a data_type column until it is bound, one
+// rather than zero so that arithmetic over it folds like any constant
+static planpb::GenericValue
+StandInValue(DataType data_type) {
+    planpb::GenericValue value;
+    switch (data_type) {
+        case DataType::BOOL: {
+            value.set_bool_val(false);
+            break;
+        }
+        case DataType::FLOAT:
+        case DataType::DOUBLE: {
+            value.set_float_val(1);
+            break;
+        }
+        case DataType::VARCHAR: {
+            value.set_string_val("");
+            break;
+        }
+        default: {
+            value.set_int64_val(1);
+            break;
+        }
+    }
+    return value;
+}
+
+// a bound a range leaf puts on its field
+struct RangeBound {
+    planpb::GenericValue value;
+    bool inclusive;
+};
+
+// the range leaves ANDed on one field, merged
+struct FieldRange {
+    planpb::ColumnInfo column_info;
+    std::optional<RangeBound> lower;
+    std::optional<RangeBound> upper;
+    int64_t leaves = 0;
+    // where the merged leaf goes among the conjuncts
+    size_t position = 0;
+};
+
+template <typename T>
+static bool
+FitsIn(int64_t value) {
+    return value >= std::numeric_limits<T>::min() &&
+           value <= std::numeric_limits<T>::max();
+}
+
+// value as a field of data_type holds it, so that ordering the values
+// orders them like the field does; nullopt if the field does not merge
+// ranges over it
+static std::optional<planpb::GenericValue>
+NormalizeValue(DataType data_type, const planpb::GenericValue& value) {
+    auto int_value = [&](bool fits) -> std::optional<planpb::GenericValue> {
+        if (value.val_case() != planpb::GenericValue::kInt64Val || !fits) {
             return std::nullopt;
+        }
+        return value;
+    };
+    switch (data_type) {
+        case DataType::INT8:
+            return int_value(FitsIn<int8_t>(value.int64_val()));
+        case DataType::INT16:
+            return int_value(FitsIn<int16_t>(value.int64_val()));
+        case DataType::INT32:
+            return int_value(FitsIn<int32_t>(value.int64_val()));
+        case DataType::INT64:
+            return int_value(true);
+        case DataType::FLOAT:
+        case DataType::DOUBLE: {
+            if (value.val_case() != planpb::GenericValue::kFloatVal ||
+                std::isnan(value.float_val())) {
+                return std::nullopt;
+            }
+            auto normalized = value;
+            if (data_type == DataType::FLOAT) {
+                normalized.set_float_val(float(value.float_val()));
+            }
+            return normalized;
+        }
+        case DataType::VARCHAR: {
+            if (value.val_case() != planpb::GenericValue::kStringVal) {
+                return std::nullopt;
+            }
+            return value;
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+// <0, 0 or >0 as a orders before, with or after b, normalized values of
+// one field
+static int
+CompareValues(const planpb::GenericValue& a, const planpb::GenericValue& b) {
+    switch (a.val_case()) {
+        case planpb::GenericValue::kInt64Val:
+            return (a.int64_val() > b.int64_val()) -
+                   (a.int64_val() < b.int64_val());
+        case planpb::GenericValue::kFloatVal:
+            return (a.float_val() > b.float_val()) -
+                   (a.float_val() < b.float_val());
+        default:
+            return a.string_val().compare(b.string_val());
+    }
+}
+
+// the bounds of a range leaf the conjuncts merge, false if expr_pb is
+// not one
+static bool
+LeafBounds(const planpb::Expr& expr_pb,
+           std::optional<RangeBound>& lower,
+           std::optional<RangeBound>& upper) {
+    if (expr_pb.has_unary_range_expr()) {
+        auto& range = expr_pb.unary_range_expr();
+        auto data_type =
+            static_cast<DataType>(range.column_info().data_type());
+        auto value = NormalizeValue(data_type, range.value());
+        if (!value.has_value()) {
+            return false;
+        }
+        switch (range.op()) {
+            case planpb::GreaterThan:
+            case planpb::GreaterEqual:
+                lower = RangeBound{*value, range.op() == planpb::GreaterEqual};
+                return true;
+            case planpb::LessThan:
+            case planpb::LessEqual:
+                upper = RangeBound{*value, range.op() == planpb::LessEqual};
+                return true;
+            case planpb::Equal:
+                lower = upper = RangeBound{*value, true};
+                return true;
+            default:
+                return false;
+        }
+    }
+    if (expr_pb.has_binary_range_expr()) {
+        auto& range = expr_pb.binary_range_expr();
+        auto data_type =
+            static_cast<DataType>(range.column_info().data_type());
+        auto lower_value = NormalizeValue(data_type, range.lower_value());
+        auto upper_value = NormalizeValue(data_type, range.upper_value());
+        if (!lower_value.has_value() || !upper_value.has_value()) {
+            return false;
+        }
+        lower = RangeBound{*lower_value, range.lower_inclusive()};
+        upper = RangeBound{*upper_value, range.upper_inclusive()};
+        return true;
+    }
+    return false;
+}
+
+static const planpb::ColumnInfo&
+LeafColumn(const planpb::Expr& expr_pb) {
+    return expr_pb.has_unary_range_expr()
+               ? expr_pb.unary_range_expr().column_info()
+               : expr_pb.binary_range_expr().column_info();
+}
+
+// a leaf no row matches: a term without values
+static planpb::Expr
+Never(const planpb::ColumnInfo& column_info) {
+    planpb::Expr expr_pb;
+    *expr_pb.mutable_term_expr()->mutable_column_info() = column_info;
+    return expr_pb;
+}
+
+static bool
+IsNever(const planpb::Expr& expr_pb) {
+    return expr_pb.has_term_expr() && expr_pb.term_expr().values().empty();
+}
+
+// the negation of Never, which every row matches
+static bool
+IsAlways(const planpb::Expr& expr_pb) {
+    return expr_pb.has_unary_expr() &&
+           expr_pb.unary_expr().op() == planpb::UnaryExpr::Not &&
+           IsNever(expr_pb.unary_expr().child());
+}
+
+static bool
+IsLogical(const planpb::Expr& expr_pb, planpb::BinaryExpr::BinaryOp op) {
+    return expr_pb.has_binary_expr() && expr_pb.binary_expr().op() == op;
+}
+
+// the operands of the op nodes nested from expr_pb, left to right
+static void
+Flatten(const planpb::Expr& expr_pb,
+        planpb::BinaryExpr::BinaryOp op,
+        std::vector<planpb::Expr>& operands) {
+    if (IsLogical(expr_pb, op)) {
+        Flatten(expr_pb.binary_expr().left(), op, operands);
+        Flatten(expr_pb.binary_expr().right(), op, operands);
+    } else {
+        operands.push_back(expr_pb);
+    }
+}
+
+// the operands joined by op, left-deep
+static planpb::Expr
+Chain(std::vector<planpb::Expr> operands, planpb::BinaryExpr::BinaryOp op) {
+    AssertInfo(!operands.empty(), "logical expr without operands");
+    auto result = std::move(operands[0]);
+    for (size_t i = 1; i < operands.size(); ++i) {
+        planpb::Expr node;
+        auto binary = node.mutable_binary_expr();
+        binary->set_op(op);
+        *binary->mutable_left() = std::move(result);
+        *binary->mutable_right() = std::move(operands[i]);
+        result = std::move(node);
+    }
+    return result;
+}
+
+// keeps the first of the operands equal to each other
+static void
+Dedup(std::vector<planpb::Expr>& operands) {
+    std::unordered_set<std::string> seen;
+    auto end = std::remove_if(
+        operands.begin(), operands.end(), [&](const planpb::Expr& operand) {
+            return !seen.insert(Fingerprint(operand)).second;
+        });
+    operands.erase(end, operands.end());
+}
+
+static planpb::Expr
+SimplifyAnd(std::vector<planpb::Expr> conjuncts) {
+    std::vector<planpb::Expr> kept;
+    std::map<int64_t, FieldRange> ranges;
+    for (auto& conjunct : conjuncts) {
+        if (IsNever(conjunct)) {
+            return conjunct;
+        }
+        if (IsAlways(conjunct)) {
+            continue;
+        }
+        std::optional<RangeBound> lower;
+        std::optional<RangeBound> upper;
+        if (!LeafBounds(conjunct, lower, upper)) {
+            kept.push_back(std::move(conjunct));
+            continue;
+        }
+        auto& column_info = LeafColumn(conjunct);
+        auto [iter, inserted] = ranges.try_emplace(column_info.field_id());
+        auto& range = iter->second;
+        if (inserted) {
+            range.column_info = column_info;
+            range.position = kept.size();
+            kept.push_back(conjunct);
+        }
+        ++range.leaves;
+        // the greater lower bound and the lesser upper one, the exclusive
+        // one of two on the same value
+        if (lower.has_value() &&
+            (!range.lower.has_value() ||
+             CompareValues(lower->value, range.lower->value) > 0 ||
+             (CompareValues(lower->value, range.lower->value) == 0 &&
+              !lower->inclusive))) {
+            range.lower = lower;
+        }
+        if (upper.has_value() &&
+            (!range.upper.has_value() ||
+             CompareValues(upper->value, range.upper->value) < 0 ||
+             (CompareValues(upper->value, range.upper->value) == 0 &&
+              !upper->inclusive))) {
+            range.upper = upper;
+        }
+    }
+    if (kept.empty()) {
+        return conjuncts[0];
+    }
+
+    for (auto& entry : ranges) {
+        auto& range = entry.second;
+        if (range.leaves < 2) {
+            continue;
+        }
+        planpb::Expr merged;
+        if (range.lower.has_value() && range.upper.has_value()) {
+            auto order = CompareValues(range.lower->value, range.upper->value);
+            auto inclusive = range.lower->inclusive && range.upper->inclusive;
+            if (order > 0 || (order == 0 && !inclusive)) {
+                return Never(range.column_info);
+            }
+            if (order == 0) {
+                auto unary = merged.mutable_unary_range_expr();
+                *unary->mutable_column_info() = range.column_info;
+                unary->set_op(planpb::Equal);
+                *unary->mutable_value() = range.lower->value;
+            } else {
+                auto binary = merged.mutable_binary_range_expr();
+                *binary->mutable_column_info() = range.column_info;
+                binary->set_lower_inclusive(range.lower->inclusive);
+                binary->set_upper_inclusive(range.upper->inclusive);
+                *binary->mutable_lower_value() = range.lower->value;
+                *binary->mutable_upper_value() = range.upper->value;
+            }
         } else {
-            return ParseExpr(anns_proto.predicates());
+            auto& bound = range.lower.has_value() ? range.lower : range.upper;
+            auto unary = merged.mutable_unary_range_expr();
+            *unary->mutable_column_info() = range.column_info;
+            if (range.lower.has_value()) {
+                unary->set_op(bound->inclusive ? planpb::GreaterEqual
+                                               : planpb::GreaterThan);
+            } else {
+                unary->set_op(bound->inclusive ? planpb::LessEqual
+                                               : planpb::LessThan);
+            }
+            *unary->mutable_value() = bound->value;
         }
-    }();
+        kept[range.position] = std::move(merged);
+    }
+    Dedup(kept);
+    return Chain(std::move(kept), planpb::BinaryExpr::LogicalAnd);
+}
+
+static planpb::Expr
+SimplifyOr(std::vector<planpb::Expr> disjuncts) {
+    std::vector<planpb::Expr> kept;
+    for (auto& disjunct : disjuncts) {
+        if (IsAlways(disjunct)) {
+            return disjunct;
+        }
+        if (!IsNever(disjunct)) {
+            kept.push_back(std::move(disjunct));
+        }
+    }
+    if (kept.empty()) {
+        return disjuncts[0];
+    }
+    Dedup(kept);
+    if (kept.size() == 1) {
+        return kept[0];
+    }
+
+    // the conjuncts every disjunct has are evaluated once, outside the OR:
+    // (a && b) || (a && c) is a && (b || c)
+    std::vector<std::vector<planpb::Expr>> branches(kept.size());
+    std::vector<std::unordered_set<std::string>> branch_keys(kept.size());
+    for (size_t i = 0; i < kept.size(); ++i) {
+        Flatten(kept[i], planpb::BinaryExpr::LogicalAnd, branches[i]);
+        for (auto& conjunct : branches[i]) {
+            branch_keys[i].insert(Fingerprint(conjunct));
+        }
+    }
+    std::vector<planpb::Expr> common;
+    std::unordered_set<std::string> common_keys;
+    for (auto& conjunct : branches[0]) {
+        auto key = Fingerprint(conjunct);
+        auto everywhere = std::all_of(
+            branch_keys.begin() + 1,
+            branch_keys.end(),
+            [&key](const auto& keys) { return keys.count(key) > 0; });
+        if (everywhere && common_keys.insert(key).second) {
+            common.push_back(conjunct);
+        }
+    }
+    if (common.empty()) {
+        return Chain(std::move(kept), planpb::BinaryExpr::LogicalOr);
+    }
+    std::vector<planpb::Expr> rests;
+    for (auto& branch : branches) {
+        std::vector<planpb::Expr> rest;
+        for (auto& conjunct : branch) {
+            if (common_keys.count(Fingerprint(conjunct)) == 0) {
+                rest.push_back(std::move(conjunct));
+            }
+        }
+        if (rest.empty()) {
+            // a || (a && b) is a
+            return SimplifyAnd(std::move(common));
+        }
+        rests.push_back(
+            Chain(std::move(rest), planpb::BinaryExpr::LogicalAnd));
+    }
+    Flatten(SimplifyOr(std::move(rests)),
+            planpb::BinaryExpr::LogicalAnd,
+            common);
+    return SimplifyAnd(std::move(common));
+}
+
+planpb::Expr
+SimplifyExpr(const planpb::Expr& expr_pb) {
+    if (HasParams(expr_pb)) {
+        return expr_pb;
+    }
+    if (expr_pb.has_unary_expr()) {
+        auto& unary = expr_pb.unary_expr();
+        auto child = SimplifyExpr(unary.child());
+        if (unary.op() == planpb::UnaryExpr::Not && child.has_unary_expr() &&
+            child.unary_expr().op() == planpb::UnaryExpr::Not) {
+            return child.unary_expr().child();
+        }
+        auto result = expr_pb;
+        *result.mutable_unary_expr()->mutable_child() = std::move(child);
+        return result;
+    }
+    if (IsLogical(expr_pb, planpb::BinaryExpr::LogicalAnd) ||
+        IsLogical(expr_pb, planpb::BinaryExpr::LogicalOr)) {
+        auto op = expr_pb.binary_expr().op();
+        std::vector<planpb::Expr> operands;
+        Flatten(SimplifyExpr(expr_pb.binary_expr().left()), op, operands);
+        Flatten(SimplifyExpr(expr_pb.binary_expr().right()), op, operands);
+        return op == planpb::BinaryExpr::LogicalAnd
+                   ? SimplifyAnd(std::move(operands))
+                   : SimplifyOr(std::move(operands));
+    }
+    return expr_pb;
+}
 
+static SearchInfo
+SearchInfoFromProto(const planpb::VectorANNS& anns_proto) {
     auto& query_info_proto = anns_proto.query_info();
 
     SearchInfo search_info;
     auto field_id = FieldId(anns_proto.field_id());
     search_info.field_id_ = field_id;
 
-    search_info.metric_type_ = query_info_proto.metric_type();
+    // cosine is searched by inner product over normalized vectors
+    search_info.metric_type_ = SearchMetric(query_info_proto.metric_type());
     search_info.topk_ = query_info_proto.topk();
     search_info.round_decimal_ = query_info_proto.round_decimal();
     search_info.search_params_ = json::parse(query_info_proto.search_params());
+    if (search_info.search_params_.contains(GROUP_BY_FIELD)) {
+        search_info.group_by_field_id_ = FieldId(
+            search_info.search_params_[GROUP_BY_FIELD].get<int64_t>());
+    }
+    ParseSearchParams(search_info);
+    return search_info;
+}
+
+std::unique_ptr<VectorPlanNode>
+ProtoParser::PlanNodeFromProto(const planpb::PlanNode& plan_node_proto) {
+    // TODO: add more buffs
+    if (plan_node_proto.has_multi_vector_anns()) {
+        return MultiVectorPlanNodeFromProto(
+            plan_node_proto.multi_vector_anns());
+    }
+    Assert(plan_node_proto.has_vector_anns());
+    auto& anns_proto = plan_node_proto.vector_anns();
+    auto predicates = SimplifyExpr(anns_proto.predicates());
+    auto expr_opt = [&]() -> std::optional<ExprPtr> {
+        if (!anns_proto.has_predicates()) {
+            return std::nullopt;
+        } else {
+            return ParseExpr(predicates);
+        }
+    }();
+
+    auto search_info = SearchInfoFromProto(anns_proto);
 
     auto plan_node = [&]() -> std::unique_ptr<VectorPlanNode> {
-        if (anns_proto.is_binary()) {
+        if (schema[search_info.field_id_].is_sparse_vector()) {
+            AssertInfo(
+                IsMetricType(search_info.metric_type_, knowhere::metric::IP),
+                "sparse vectors are searched by inner product");
+            AssertInfo(!search_info.group_by_field_id_.has_value(),
+                       "searches of sparse vectors are not grouped");
+            return std::make_unique<SparseFloatVectorANNS>();
+        } else if (anns_proto.is_binary()) {
             return std::make_unique<BinaryVectorANNS>();
         } else {
             return std::make_unique<FloatVectorANNS>();
@@ -178,21 +714,91 @@ ProtoParser::PlanNodeFromProto(const planpb::PlanNode& plan_node_proto) {
     }();
     plan_node->placeholder_tag_ = anns_proto.placeholder_tag();
     plan_node->predicate_ = std::move(expr_opt);
+    plan_node->param_slots_ = std::move(param_slots_);
+    if (anns_proto.has_predicates()) {
+        plan_node->predicate_fingerprint_ = Fingerprint(predicates);
+    }
+    if (auto group_by = search_info.group_by_field_id_) {
+        auto data_type = schema[group_by.value()].get_data_type();
+        AssertInfo(data_type == DataType::BOOL ||
+                       datatype_is_integer(data_type) ||
+                       datatype_is_string(data_type),
+                   "group by field must be a bool, int or varchar field");
+        AssertInfo(!search_info.search_params_.contains(RADIUS),
+                   "range search does not support group by");
+    }
     plan_node->search_info_ = std::move(search_info);
     return plan_node;
 }
 
+std::unique_ptr<VectorPlanNode>
+ProtoParser::MultiVectorPlanNodeFromProto(
+    const planpb::MultiVectorANNS& anns_proto) {
+    auto num_fields = anns_proto.fields_size();
+    AssertInfo(num_fields > 0, "multi vector search without fields");
+    AssertInfo(anns_proto.weights().empty() ||
+                   anns_proto.weights_size() == num_fields,
+               "multi vector search needs one weight per field");
+    auto plan_node = std::make_unique<MultiVectorANNS>();
+    for (int i = 0; i < num_fields; ++i) {
+        auto& field_proto = anns_proto.fields(i);
+        VectorFieldSearch field;
+        field.search_info_ = SearchInfoFromProto(field_proto);
+        field.placeholder_tag_ = field_proto.placeholder_tag();
+        if (!anns_proto.weights().empty()) {
+            field.weight_ = anns_proto.weights(i);
+        }
+        auto& info = field.search_info_;
+        AssertInfo(schema[info.field_id_].is_vector(),
+                   "multi vector search over a scalar field");
+        AssertInfo(!info.search_params_.contains(RADIUS),
+                   "multi vector search does not support range search");
+        AssertInfo(!info.group_by_field_id_.has_value(),
+                   "multi vector search does not support group by");
+        for (auto& other : plan_node->fields_) {
+            AssertInfo(other.search_info_.field_id_ != info.field_id_ &&
+                           other.placeholder_tag_ != field.placeholder_tag_,
+                       "multi vector search repeats a field or a tag");
+            // the fused score is only ordered if every distance is
+            AssertInfo(PositivelyRelated(other.search_info_.metric_type_) ==
+                           PositivelyRelated(info.metric_type_),
+                       "multi vector search mixes similarity and distance "
+                       "metrics");
+        }
+        plan_node->fields_.push_back(std::move(field));
+    }
+    plan_node->search_info_ = plan_node->fields_[0].search_info_;
+    plan_node->placeholder_tag_ = plan_node->fields_[0].placeholder_tag_;
+    if (anns_proto.has_predicates()) {
+        auto predicates = SimplifyExpr(anns_proto.predicates());
+        plan_node->predicate_ = ParseExpr(predicates);
+        plan_node->predicate_fingerprint_ = Fingerprint(predicates);
+    }
+    plan_node->param_slots_ = std::move(param_slots_);
+    return plan_node;
+}
+
 std::unique_ptr<RetrievePlanNode>
 ProtoParser::RetrievePlanNodeFromProto(
     const planpb::PlanNode& plan_node_proto) {
     Assert(plan_node_proto.has_predicates());
-    auto& predicate_proto = plan_node_proto.predicates();
+    auto predicate_proto = SimplifyExpr(plan_node_proto.predicates());
     auto expr_opt = [&]() -> ExprPtr { return ParseExpr(predicate_proto); }();
 
     auto plan_node = [&]() -> std::unique_ptr<RetrievePlanNode> {
         return std::make_unique<RetrievePlanNode>();
     }();
     plan_node->predicate_ = std::move(expr_opt);
+    plan_node->predicate_fingerprint_ = Fingerprint(predicate_proto);
+    plan_node->param_slots_ = std::move(param_slots_);
+    plan_node->limit_ = plan_node_proto.limit();
+    plan_node->offset_ = plan_node_proto.offset();
+    plan_node->order_by_pk_ = plan_node_proto.order_by_pk();
+    for (auto& aggregate : plan_node_proto.aggregates()) {
+        auto op = static_cast<AggregateOp>(aggregate.op());
+        plan_node->aggregates_.push_back(
+            AggregateInfo{op, FieldId(aggregate.field_id())});
+    }
     return plan_node;
 }
 
@@ -206,7 +812,14 @@ ProtoParser::CreatePlan(const proto::plan::PlanNode& plan_node_proto) {
     ExtractInfoPlanNodeVisitor extractor(plan_info);
     plan_node->accept(extractor);
 
-    plan->tag2field_["$0"] = plan_node->search_info_.field_id_;
+    if (auto multi = dynamic_cast<MultiVectorANNS*>(plan_node.get())) {
+        for (auto& field : multi->fields_) {
+            plan->tag2field_[field.placeholder_tag_] =
+                field.search_info_.field_id_;
+        }
+    } else {
+        plan->tag2field_["$0"] = plan_node->search_info_.field_id_;
+    }
     plan->plan_node_ = std::move(plan_node);
     plan->extra_info_opt_ = std::move(plan_info);
 
@@ -467,6 +1080,9 @@ ProtoParser::ParseBinaryArithOpEvalRangeExpr(
 ExprPtr
 ProtoParser::ParseExpr(const proto::plan::Expr& expr_pb) {
     using ppe = proto::plan::Expr;
+    if (HasParams(expr_pb)) {
+        return ParseParameterizedExpr(expr_pb);
+    }
     switch (expr_pb.expr_case()) {
         case ppe::kBinaryExpr: {
             return ParseBinaryExpr(expr_pb.binary_expr());
@@ -495,4 +1111,40 @@ ProtoParser::ParseExpr(const proto::plan::Expr& expr_pb) {
     }
 }
 
+ExprPtr
+ProtoParser::ParseParameterizedExpr(const proto::plan::Expr& expr_pb) {
+    auto stand_in_pb = expr_pb;
+    ReplaceParams(stand_in_pb,
+                  [&](int64_t, const planpb::ColumnInfo& column_info) {
+                      auto field_id = FieldId(column_info.field_id());
+                      return StandInValue(schema[field_id].get_data_type());
+                  });
+    auto expr = ParseExpr(stand_in_pb);
+    expr->parameterized_ = true;
+    param_slots_.push_back(ExprParamSlot{expr.get(), expr_pb});
+    return expr;
+}
+
+std::shared_ptr<const ExprBindings>
+ProtoParser::BindParams(const std::vector<ExprParamSlot>& slots,
+                        const proto::plan::PlanParams& params) {
+    auto bindings = std::make_shared<ExprBindings>();
+    for (auto& slot : slots) {
+        auto bound_pb = slot.proto_;
+        ReplaceParams(
+            bound_pb, [&](int64_t param_index, const planpb::ColumnInfo&) {
+                AssertInfo(param_index >= 0 &&
+                               param_index < params.values_size(),
+                           "parameter index out of range");
+                auto& value = params.values(param_index);
+                AssertInfo(!IsParam(value),
+                           "parameter bound to another parameter");
+                return value;
+            });
+        bindings->exprs_.emplace(slot.expr_, ParseExpr(bound_pb));
+    }
+    bindings->fingerprint_ = Fingerprint(params);
+    return bindings;
+}
+
 }  // namespace milvus::query
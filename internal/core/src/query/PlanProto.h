@@ -11,8 +11,8 @@
 
 #pragma once
 
-#include <boost/dynamic_bitset.hpp>
 #include <memory>
+#include <vector>
 
 #include "Plan.h"
 #include "PlanNode.h"
@@ -21,6 +21,14 @@
 
 namespace milvus::query {
 
+// an equivalent predicate that is cheaper to evaluate: range leaves ANDed
+// on a field merge into one range, repeated operands of an AND or an OR
+// are kept once, conjuncts shared by every branch of an OR move out of it,
+// and ranges no value satisfies fold into a term without values, which
+// matches no row. leaves with parameters are kept as written
+proto::plan::Expr
+SimplifyExpr(const proto::plan::Expr& expr_pb);
+
 class ProtoParser {
  public:
     explicit ProtoParser(const Schema& schema) : schema(schema) {
@@ -54,9 +62,23 @@ class ProtoParser {
     ExprPtr
     ParseExpr(const proto::plan::Expr& expr_pb);
 
+    // a leaf with parameters for literals, parsed over stand-in values and
+    // recorded in param_slots_
+    ExprPtr
+    ParseParameterizedExpr(const proto::plan::Expr& expr_pb);
+
+    // the leaves of slots parsed again with the values of params
+    std::shared_ptr<const ExprBindings>
+    BindParams(const std::vector<ExprParamSlot>& slots,
+               const proto::plan::PlanParams& params);
+
     std::unique_ptr<VectorPlanNode>
     PlanNodeFromProto(const proto::plan::PlanNode& plan_node_proto);
 
+    std::unique_ptr<VectorPlanNode>
+    MultiVectorPlanNodeFromProto(
+        const proto::plan::MultiVectorANNS& anns_proto);
+
     std::unique_ptr<RetrievePlanNode>
     RetrievePlanNodeFromProto(const proto::plan::PlanNode& plan_node_proto);
 
@@ -68,6 +90,8 @@ class ProtoParser {
 
  private:
     const Schema& schema;
+    // the parameterized leaves parsed so far
+    std::vector<ExprParamSlot> param_slots_;
 };
 
 }  // namespace milvus::query
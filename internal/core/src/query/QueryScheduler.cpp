@@ -0,0 +1,97 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "query/QueryScheduler.h"
+
+#include <algorithm>
+
+#include "segcore/SegcoreConfig.h"
+
+namespace milvus::query {
+
+namespace {
+// tenants idle long enough to be caught up by the virtual time are
+// forgotten once there are this many
+constexpr size_t MAX_TRACKED_TENANTS = 4096;
+}  // namespace
+
+QueryScheduler&
+QueryScheduler::GetInstance() {
+    static QueryScheduler instance;
+    return instance;
+}
+
+QueryScheduler::Ticket
+QueryScheduler::Acquire(const std::string& tenant,
+                        int64_t weight,
+                        int64_t cost) {
+    auto slots =
+        segcore::SegcoreConfig::default_config().get_query_scheduler_slots();
+    if (slots == 0) {
+        return Ticket(nullptr);
+    }
+    std::unique_lock lck(mutex_);
+    if (finish_tags_.size() >= MAX_TRACKED_TENANTS) {
+        for (auto it = finish_tags_.begin(); it != finish_tags_.end();) {
+            it = it->second <= virtual_time_ ? finish_tags_.erase(it)
+                                             : std::next(it);
+        }
+    }
+    auto& finish_tag = finish_tags_[tenant];
+    auto tag = std::max(virtual_time_, finish_tag);
+    finish_tag = tag + double(std::max<int64_t>(cost, 1)) /
+                           double(std::max<int64_t>(weight, 1));
+    auto key = std::make_pair(tag, arrivals_++);
+    waiting_.insert(key);
+    // slots are read again on each wake up, so a change of them applies
+    // to the searches waiting; 0 lets them all in
+    released_.wait(lck, [&] {
+        auto slots = segcore::SegcoreConfig::default_config()
+                         .get_query_scheduler_slots();
+        return (slots == 0 || running_ < slots) && *waiting_.begin() == key;
+    });
+    waiting_.erase(waiting_.begin());
+    ++running_;
+    virtual_time_ = std::max(virtual_time_, tag);
+    // the next in line may fit in a slot too
+    released_.notify_all();
+    return Ticket(this);
+}
+
+int64_t
+QueryScheduler::Waiting() {
+    std::lock_guard lck(mutex_);
+    return waiting_.size();
+}
+
+void
+QueryScheduler::Reconfigured() {
+    {
+        std::lock_guard lck(mutex_);
+    }
+    released_.notify_all();
+}
+
+void
+QueryScheduler::Release() {
+    {
+        std::lock_guard lck(mutex_);
+        --running_;
+    }
+    released_.notify_all();
+}
+
+}  // namespace milvus::query
@@ -0,0 +1,96 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace milvus::query {
+
+// Admits the vector searches of segcore query_scheduler_slots at a time,
+// in weighted fair order of their tenants (start-time fair queuing): a
+// search is tagged with the work its tenant was admitted for so far over
+// the tenant's weight, and the smallest tag goes first. A large request
+// queues once per slice of its queries, so the small requests of other
+// tenants, and the later ones of its own, get their turns in between.
+class QueryScheduler {
+ public:
+    // a slot, given back when it goes out of scope
+    class Ticket {
+     public:
+        explicit Ticket(QueryScheduler* scheduler) : scheduler_(scheduler) {
+        }
+
+        Ticket(Ticket&& other) noexcept
+            : scheduler_(std::exchange(other.scheduler_, nullptr)) {
+        }
+
+        Ticket(const Ticket&) = delete;
+        Ticket&
+        operator=(const Ticket&) = delete;
+        Ticket&
+        operator=(Ticket&&) = delete;
+
+        ~Ticket() {
+            if (scheduler_ != nullptr) {
+                scheduler_->Release();
+            }
+        }
+
+     private:
+        QueryScheduler* scheduler_;
+    };
+
+    static QueryScheduler&
+    GetInstance();
+
+    // waits for a slot for work of cost, e.g. its number of queries, on
+    // behalf of tenant; a weight of 2 gets twice the share of 1
+    Ticket
+    Acquire(const std::string& tenant, int64_t weight, int64_t cost);
+
+    // searches waiting for a slot
+    int64_t
+    Waiting();
+
+    // wakes the waiting searches up after query_scheduler_slots changed
+    void
+    Reconfigured();
+
+ private:
+    void
+    Release();
+
+ private:
+    std::mutex mutex_;
+    std::condition_variable released_;
+    int64_t running_ = 0;
+    // the tag of the last search admitted
+    double virtual_time_ = 0;
+    // the tag the next search of a tenant starts from
+    std::unordered_map<std::string, double> finish_tags_;
+    // tag and arrival of the waiting searches
+    std::set<std::pair<double, uint64_t>> waiting_;
+    uint64_t arrivals_ = 0;
+};
+
+}  // namespace milvus::query
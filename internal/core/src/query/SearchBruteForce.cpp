@@ -9,7 +9,11 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/Consts.h"
@@ -19,8 +23,88 @@
 #include "SubSearchResult.h"
 #include "knowhere/comp/brute_force.h"
 #include "knowhere/comp/index_param.h"
+#include "simd/hook.h"
 namespace milvus::query {
 
+namespace {
+
+bool
+IsPopcountMetric(const MetricType& metric_type) {
+    return IsMetricType(metric_type, knowhere::metric::HAMMING) ||
+           IsMetricType(metric_type, knowhere::metric::JACCARD);
+}
+
+// the topk nearest unfiltered rows of every query into sub_result. the
+// chunk is scanned in blocks every query computes the distances of while
+// they are in cache, distances(q, begin, end, dst) those of rows [begin,
+// end) to query q. keep(distance) drops the rows out of range, descending
+// metrics are negated into the max heaps. ties go to the smaller offset,
+// so the results do not depend on the block size
+template <typename Distances, typename Keep>
+void
+BlockTopk(int64_t chunk_rows,
+          const BitsetView& bitset,
+          Distances distances,
+          Keep keep,
+          bool descending,
+          SubSearchResult& sub_result) {
+    auto nq = sub_result.get_num_queries();
+    auto topk = sub_result.get_topk();
+    using Candidate = std::pair<float, int64_t>;
+    std::vector<std::vector<Candidate>> heaps(nq);
+    for (auto& heap : heaps) {
+        heap.reserve(topk);
+    }
+    std::vector<float> block_distances(BRUTE_FORCE_BLOCK_ROWS);
+    std::vector<int64_t> rows;
+    rows.reserve(BRUTE_FORCE_BLOCK_ROWS);
+    for (int64_t begin = 0; begin < chunk_rows;
+         begin += BRUTE_FORCE_BLOCK_ROWS) {
+        auto end = std::min(begin + BRUTE_FORCE_BLOCK_ROWS, chunk_rows);
+        rows.clear();
+        for (auto i = begin; i < end; ++i) {
+            if (bitset.empty() || !bitset.test(i)) {
+                rows.push_back(i);
+            }
+        }
+        if (rows.empty()) {
+            continue;
+        }
+        for (int64_t q = 0; q < nq; ++q) {
+            distances(q, begin, end, block_distances.data());
+            auto& heap = heaps[q];
+            for (auto row : rows) {
+                auto distance = block_distances[row - begin];
+                if (!keep(distance)) {
+                    continue;
+                }
+                Candidate candidate{descending ? -distance : distance, row};
+                if (int64_t(heap.size()) < topk) {
+                    heap.push_back(candidate);
+                    std::push_heap(heap.begin(), heap.end());
+                } else if (candidate < heap.front()) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = candidate;
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+        }
+    }
+
+    for (int64_t q = 0; q < nq; ++q) {
+        auto& heap = heaps[q];
+        std::sort_heap(heap.begin(), heap.end());
+        auto seg_offsets = sub_result.get_seg_offsets() + q * topk;
+        auto result_distances = sub_result.get_distances() + q * topk;
+        for (size_t i = 0; i < heap.size(); ++i) {
+            seg_offsets[i] = heap[i].second;
+            result_distances[i] = descending ? -heap[i].first : heap[i].first;
+        }
+    }
+}
+
+}  // namespace
+
 void
 CheckBruteForceSearchParam(const FieldMeta& field,
                            const SearchInfo& search_info) {
@@ -37,12 +121,110 @@ CheckBruteForceSearchParam(const FieldMeta& field,
                "[BruteForceSearch] Data type and metric type miss-match");
 }
 
+RangeSearchBound::RangeSearchBound(int64_t num_queries,
+                                   const std::string& metric_type,
+                                   float radius)
+    : num_queries_(num_queries),
+      descending_(IsMetricType(metric_type, knowhere::metric::IP)),
+      radius_(radius),
+      bounds_(new std::atomic<float>[num_queries]) {
+    for (int64_t i = 0; i < num_queries; ++i) {
+        bounds_[i].store(radius, std::memory_order_relaxed);
+    }
+}
+
+float
+RangeSearchBound::Radius() const {
+    // IP keeps distances above the radius, the others below it
+    if (num_queries_ == 0) {
+        return radius_;
+    }
+    auto radius = bounds_[0].load(std::memory_order_relaxed);
+    for (int64_t i = 1; i < num_queries_; ++i) {
+        auto bound = bounds_[i].load(std::memory_order_relaxed);
+        radius = descending_ ? std::min(radius, bound)
+                             : std::max(radius, bound);
+    }
+    return radius;
+}
+
+void
+RangeSearchBound::Update(const SubSearchResult& sub_result) {
+    Update(sub_result.get_topk(),
+           sub_result.get_ids(),
+           sub_result.get_distances());
+}
+
+void
+RangeSearchBound::Update(int64_t topk,
+                         const int64_t* seg_offsets,
+                         const float* distances) {
+    if (topk == 0) {
+        return;
+    }
+    for (int64_t i = 0; i < num_queries_; ++i) {
+        auto last = i * topk + topk - 1;
+        if (seg_offsets[last] == INVALID_SEG_OFFSET) {
+            continue;
+        }
+        // ties with the topk-th hit stay inside the radius
+        auto distance = distances[last];
+        auto bound = descending_
+                         ? std::nextafter(distance,
+                                          std::numeric_limits<float>::lowest())
+                         : std::nextafter(distance,
+                                          std::numeric_limits<float>::max());
+        auto current = bounds_[i].load(std::memory_order_relaxed);
+        while ((descending_ ? bound > current : bound < current) &&
+               !bounds_[i].compare_exchange_weak(current, bound)) {
+        }
+    }
+}
+
+int64_t
+RangeSearchBound::Prune(int64_t topk,
+                        int64_t* seg_offsets,
+                        float* distances) const {
+    int64_t pruned = 0;
+    for (int64_t i = 0; i < num_queries_ * topk; ++i) {
+        if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+            continue;
+        }
+        auto bound = bounds_[i / topk].load(std::memory_order_relaxed);
+        if (descending_ ? distances[i] > bound : distances[i] < bound) {
+            continue;
+        }
+        seg_offsets[i] = INVALID_SEG_OFFSET;
+        distances[i] = descending_ ? std::numeric_limits<float>::lowest()
+                                   : std::numeric_limits<float>::max();
+        ++pruned;
+    }
+    return pruned;
+}
+
 SubSearchResult
 BruteForceSearch(const dataset::SearchDataset& dataset,
                  const void* chunk_data_raw,
                  int64_t chunk_rows,
-                 const knowhere::Json& conf,
-                 const BitsetView& bitset) {
+                 const SearchParams& params,
+                 const BitsetView& bitset,
+                 RangeSearchBound* bound,
+                 const float* norms) {
+    if (!params.radius_.has_value() && IsPopcountMetric(dataset.metric_type)) {
+        return BinaryBruteForceSearch(
+            dataset,
+            static_cast<const uint8_t*>(chunk_data_raw),
+            chunk_rows,
+            bitset);
+    }
+    if (norms != nullptr && !params.radius_.has_value() &&
+        IsMetricType(dataset.metric_type, knowhere::metric::L2)) {
+        return NormBruteForceSearch(dataset,
+                                    static_cast<const float*>(chunk_data_raw),
+                                    norms,
+                                    chunk_rows,
+                                    bitset);
+    }
     SubSearchResult sub_result(dataset.num_queries,
                                dataset.topk,
                                dataset.metric_type,
@@ -64,10 +246,11 @@ BruteForceSearch(const dataset::SearchDataset& dataset,
         sub_result.mutable_seg_offsets().resize(nq * topk);
         sub_result.mutable_distances().resize(nq * topk);
 
-        if (conf.contains(RADIUS)) {
-            config[RADIUS] = conf[RADIUS].get<float>();
-            if (conf.contains(RANGE_FILTER)) {
-                config[RANGE_FILTER] = conf[RANGE_FILTER].get<float>();
+        if (params.radius_.has_value()) {
+            config[RADIUS] =
+                bound != nullptr ? bound->Radius() : params.radius_.value();
+            if (params.range_filter_.has_value()) {
+                config[RANGE_FILTER] = params.range_filter_.value();
                 CheckRangeSearchParam(
                     config[RADIUS], config[RANGE_FILTER], dataset.metric_type);
             }
@@ -86,6 +269,9 @@ BruteForceSearch(const dataset::SearchDataset& dataset,
             std::copy_n(GetDatasetDistance(result),
                         nq * topk,
                         sub_result.get_distances());
+            if (bound != nullptr) {
+                bound->Update(sub_result);
+            }
         } else {
             auto stat = knowhere::BruteForce::SearchWithBuf(
                 base_dataset,
@@ -107,4 +293,225 @@ BruteForceSearch(const dataset::SearchDataset& dataset,
     return sub_result;
 }
 
+SubSearchResult
+NormBruteForceSearch(const dataset::SearchDataset& dataset,
+                     const float* chunk_data,
+                     const float* norms,
+                     int64_t chunk_rows,
+                     const BitsetView& bitset) {
+    AssertInfo(IsMetricType(dataset.metric_type, knowhere::metric::L2),
+               "[NormBruteForceSearch] metric type must be L2");
+    auto nq = dataset.num_queries;
+    auto dim = dataset.dim;
+    SubSearchResult sub_result(
+        nq, dataset.topk, dataset.metric_type, dataset.round_decimal);
+    auto queries = static_cast<const float*>(dataset.query_data);
+    std::vector<float> query_norms(nq);
+    simd::SquaredNorms(queries, dim, nq, query_norms.data());
+
+    // BlockTopk asks for the queries of a block in turn, the first one
+    // computes the products of all of them
+    std::vector<float> products(nq * BRUTE_FORCE_BLOCK_ROWS);
+    int64_t products_begin = -1;
+    BlockTopk(
+        chunk_rows,
+        bitset,
+        [&](int64_t q, int64_t begin, int64_t end, float* distances) {
+            auto rows = end - begin;
+            if (begin != products_begin) {
+                simd::InnerProducts(queries,
+                                    nq,
+                                    chunk_data + begin * dim,
+                                    dim,
+                                    rows,
+                                    products.data());
+                products_begin = begin;
+            }
+            auto query_products = products.data() + q * rows;
+            for (int64_t i = 0; i < rows; ++i) {
+                // rounding may take a distance of 0 below it
+                distances[i] = std::max(0.0f,
+                                        norms[begin + i] -
+                                            2 * query_products[i] +
+                                            query_norms[q]);
+            }
+        },
+        [](float) { return true; },
+        false,
+        sub_result);
+    sub_result.round_values();
+    return sub_result;
+}
+
+SubSearchResult
+BinaryBruteForceSearch(const dataset::SearchDataset& dataset,
+                       const uint8_t* chunk_data,
+                       int64_t chunk_rows,
+                       const BitsetView& bitset) {
+    auto code_size = dataset.dim / 8;
+    auto is_jaccard =
+        IsMetricType(dataset.metric_type, knowhere::metric::JACCARD);
+    AssertInfo(is_jaccard ||
+                   IsMetricType(dataset.metric_type, knowhere::metric::HAMMING),
+               "[BinaryBruteForceSearch] metric type must be HAMMING or "
+               "JACCARD");
+    SubSearchResult sub_result(dataset.num_queries,
+                               dataset.topk,
+                               dataset.metric_type,
+                               dataset.round_decimal);
+    auto kernel = is_jaccard ? simd::Jaccard : simd::Hamming;
+    auto queries = static_cast<const uint8_t*>(dataset.query_data);
+    BlockTopk(
+        chunk_rows,
+        bitset,
+        [&](int64_t q, int64_t begin, int64_t end, float* distances) {
+            kernel(queries + q * code_size,
+                   chunk_data + begin * code_size,
+                   code_size,
+                   end - begin,
+                   distances);
+        },
+        [](float) { return true; },
+        false,
+        sub_result);
+    sub_result.round_values();
+    return sub_result;
+}
+
+SubSearchResult
+HalfBruteForceSearch(const dataset::SearchDataset& dataset,
+                     const uint16_t* chunk_data,
+                     simd::HalfType half_type,
+                     int64_t chunk_rows,
+                     const SearchParams& params,
+                     const BitsetView& bitset) {
+    auto dim = dataset.dim;
+    auto is_ip = IsMetricType(dataset.metric_type, knowhere::metric::IP);
+    AssertInfo(is_ip || IsMetricType(dataset.metric_type, knowhere::metric::L2),
+               "[HalfBruteForceSearch] metric type must be L2 or IP");
+    SubSearchResult sub_result(dataset.num_queries,
+                               dataset.topk,
+                               dataset.metric_type,
+                               dataset.round_decimal);
+
+    // a range search keeps the rows between the radius and the range
+    // filter, IP above the radius and L2 below it
+    auto lowest = std::numeric_limits<float>::lowest();
+    auto highest = std::numeric_limits<float>::max();
+    auto radius = is_ip ? lowest : highest;
+    auto range_filter = is_ip ? highest : lowest;
+    if (params.radius_.has_value()) {
+        radius = params.radius_.value();
+        if (params.range_filter_.has_value()) {
+            range_filter = params.range_filter_.value();
+            CheckRangeSearchParam(radius, range_filter, dataset.metric_type);
+        }
+    }
+    auto queries = static_cast<const float*>(dataset.query_data);
+    auto distances = [&](int64_t q, int64_t begin, int64_t end, float* dst) {
+        simd::HalfDistances(queries + q * dim,
+                            chunk_data + begin * dim,
+                            dim,
+                            end - begin,
+                            half_type,
+                            is_ip,
+                            dst);
+    };
+    if (is_ip) {
+        BlockTopk(
+            chunk_rows,
+            bitset,
+            distances,
+            [=](float d) { return d > radius && d <= range_filter; },
+            true,
+            sub_result);
+    } else {
+        BlockTopk(
+            chunk_rows,
+            bitset,
+            distances,
+            [=](float d) { return d < radius && d >= range_filter; },
+            false,
+            sub_result);
+    }
+    sub_result.round_values();
+    return sub_result;
+}
+
+SubSearchResult
+QuantizedBruteForceSearch(const dataset::SearchDataset& dataset,
+                          const segcore::SQ8Chunk& codes,
+                          int64_t code_begin,
+                          const float* chunk_data,
+                          int64_t chunk_rows,
+                          int64_t refine_ratio,
+                          const BitsetView& bitset) {
+    auto nq = dataset.num_queries;
+    auto dim = dataset.dim;
+    auto topk = dataset.topk;
+    auto is_ip = IsMetricType(dataset.metric_type, knowhere::metric::IP);
+    AssertInfo(is_ip || IsMetricType(dataset.metric_type, knowhere::metric::L2),
+               "[QuantizedBruteForceSearch] metric type must be L2 or IP");
+    SubSearchResult sub_result(
+        nq, topk, dataset.metric_type, dataset.round_decimal);
+
+    std::vector<int64_t> rows;
+    rows.reserve(chunk_rows);
+    for (int64_t i = 0; i < chunk_rows; ++i) {
+        if (bitset.empty() || !bitset.test(i)) {
+            rows.push_back(i);
+        }
+    }
+    if (rows.empty()) {
+        return sub_result;
+    }
+    auto num_candidates = std::min<int64_t>(
+        rows.size(), topk * std::max<int64_t>(refine_ratio, 1));
+    auto num_results = std::min<int64_t>(rows.size(), topk);
+
+    // smaller is nearer in both stages, the inner products are negated
+    using Candidate = std::pair<float, int64_t>;
+    std::vector<float> approx(chunk_rows);
+    std::vector<Candidate> candidates(rows.size());
+    for (int64_t q = 0; q < nq; ++q) {
+        auto query = static_cast<const float*>(dataset.query_data) + q * dim;
+        codes.Distances(
+            query, is_ip, code_begin, code_begin + chunk_rows, approx.data());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            candidates[i] = {approx[rows[i]], rows[i]};
+        }
+        std::nth_element(candidates.begin(),
+                         candidates.begin() + num_candidates - 1,
+                         candidates.end());
+
+        for (int64_t i = 0; i < num_candidates; ++i) {
+            auto row = chunk_data + candidates[i].second * dim;
+            float acc = 0;
+            if (is_ip) {
+                for (int64_t d = 0; d < dim; ++d) {
+                    acc -= query[d] * row[d];
+                }
+            } else {
+                for (int64_t d = 0; d < dim; ++d) {
+                    auto diff = query[d] - row[d];
+                    acc += diff * diff;
+                }
+            }
+            candidates[i].first = acc;
+        }
+        std::partial_sort(candidates.begin(),
+                          candidates.begin() + num_results,
+                          candidates.begin() + num_candidates);
+
+        auto seg_offsets = sub_result.get_seg_offsets() + q * topk;
+        auto distances = sub_result.get_distances() + q * topk;
+        for (int64_t i = 0; i < num_results; ++i) {
+            seg_offsets[i] = candidates[i].second;
+            distances[i] = is_ip ? -candidates[i].first : candidates[i].first;
+        }
+    }
+    sub_result.round_values();
+    return sub_result;
+}
+
 }  // namespace milvus::query
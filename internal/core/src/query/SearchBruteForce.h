@@ -11,23 +11,113 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <string>
+
 #include "common/BitsetView.h"
 #include "common/FieldMeta.h"
 #include "common/QueryInfo.h"
 #include "query/SubSearchResult.h"
 #include "query/helper.h"
+#include "segcore/QuantizedChunk.h"
+#include "simd/common.h"
 
 namespace milvus::query {
 
+// rows of a chunk every query scans while they are in cache
+constexpr int64_t BRUTE_FORCE_BLOCK_ROWS = 1024;
+
 void
 CheckBruteForceSearchParam(const FieldMeta& field,
                            const SearchInfo& search_info);
 
+// the topk-th distance every query of a search over many chunks or
+// segments has found so far, the ones searched later narrow their radius
+// to it and drop what lies beyond. shared by concurrent searches
+class RangeSearchBound {
+ public:
+    RangeSearchBound(int64_t num_queries,
+                     const std::string& metric_type,
+                     float radius);
+
+    // the radius a chunk search needs for all queries, never looser than
+    // the radius of the search
+    float
+    Radius() const;
+
+    // takes the topk-th distance of every query full in sub_result
+    void
+    Update(const SubSearchResult& sub_result);
+
+    // the same over the topk hits of each query in seg_offsets and
+    // distances
+    void
+    Update(int64_t topk, const int64_t* seg_offsets, const float* distances);
+
+    // invalidates the hits beyond the bound of their query, returns how
+    // many it dropped
+    int64_t
+    Prune(int64_t topk, int64_t* seg_offsets, float* distances) const;
+
+ private:
+    int64_t num_queries_;
+    bool descending_;
+    float radius_;
+    std::unique_ptr<std::atomic<float>[]> bounds_;
+};
+
+// a range search narrows to and updates bound if it is given. norms are
+// the squared norms of float rows if known, an L2 search for the topk
+// takes NormBruteForceSearch with them
 SubSearchResult
 BruteForceSearch(const dataset::SearchDataset& dataset,
                  const void* chunk_data_raw,
                  int64_t chunk_rows,
-                 const knowhere::Json& conf,
-                 const BitsetView& bitset);
+                 const SearchParams& params,
+                 const BitsetView& bitset,
+                 RangeSearchBound* bound = nullptr,
+                 const float* norms = nullptr);
+
+// brute force of L2 over float rows of known squared norms: |x - q|^2 is
+// |x|^2 - 2 x.q + |q|^2, the products of a block of rows with all queries
+// computed together
+SubSearchResult
+NormBruteForceSearch(const dataset::SearchDataset& dataset,
+                     const float* chunk_data,
+                     const float* norms,
+                     int64_t chunk_rows,
+                     const BitsetView& bitset);
+
+// brute force of HAMMING or JACCARD over binary rows: popcount kernels
+// and a bounded heap of the topk nearest of every query. BruteForceSearch
+// takes this path for those metrics unless it is a range search
+SubSearchResult
+BinaryBruteForceSearch(const dataset::SearchDataset& dataset,
+                       const uint8_t* chunk_data,
+                       int64_t chunk_rows,
+                       const BitsetView& bitset);
+
+// brute force of L2 or IP over float vectors stored as halves, the query
+// stays float. a range search of params keeps the topk nearest in range
+SubSearchResult
+HalfBruteForceSearch(const dataset::SearchDataset& dataset,
+                     const uint16_t* chunk_data,
+                     simd::HalfType half_type,
+                     int64_t chunk_rows,
+                     const SearchParams& params,
+                     const BitsetView& bitset);
+
+// brute force over rows [code_begin, code_begin + chunk_rows) of the 8-bit
+// copy of a float chunk, then re-ranks the topk * refine_ratio nearest of
+// every query on the float rows starting at chunk_data; L2 and IP only
+SubSearchResult
+QuantizedBruteForceSearch(const dataset::SearchDataset& dataset,
+                          const segcore::SQ8Chunk& codes,
+                          int64_t code_begin,
+                          const float* chunk_data,
+                          int64_t chunk_rows,
+                          int64_t refine_ratio,
+                          const BitsetView& bitset);
 
 }  // namespace milvus::query
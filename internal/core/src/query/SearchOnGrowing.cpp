@@ -9,85 +9,24 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
 #include "common/BitsetView.h"
+#include "common/CancelToken.h"
+#include "common/Consts.h"
 #include "common/QueryInfo.h"
 #include "SearchOnGrowing.h"
 #include "query/SearchBruteForce.h"
 #include "query/SearchOnIndex.h"
+#include "query/SparseSearch.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::query {
 
-// TODO: small index is disabled, however 3 unittests still call this API, consider to remove this API
-//   - Query::ExecWithPredicateLoader
-//   - Query::ExecWithPredicate
-//   - Query::ExecWithoutPredicate
-int32_t
-FloatIndexSearch(const segcore::SegmentGrowingImpl& segment,
-                 const SearchInfo& info,
-                 const void* query_data,
-                 int64_t num_queries,
-                 int64_t ins_barrier,
-                 const BitsetView& bitset,
-                 SubSearchResult& results) {
-    auto& schema = segment.get_schema();
-    auto& indexing_record = segment.get_indexing_record();
-    auto& record = segment.get_insert_record();
-
-    auto vecfield_id = info.field_id_;
-    auto& field = schema[vecfield_id];
-
-    AssertInfo(field.get_data_type() == DataType::VECTOR_FLOAT,
-               "[FloatSearch]Field data type isn't VECTOR_FLOAT");
-    dataset::SearchDataset search_dataset{info.metric_type_,
-                                          num_queries,
-                                          info.topk_,
-                                          info.round_decimal_,
-                                          field.get_dim(),
-                                          query_data};
-    auto vec_ptr = record.get_field_data<FloatVector>(vecfield_id);
-
-    int current_chunk_id = 0;
-    if (indexing_record.is_in(vecfield_id)) {
-        auto max_indexed_id = indexing_record.get_finished_ack();
-        const auto& field_indexing =
-            indexing_record.get_vec_field_indexing(vecfield_id);
-        auto search_params = field_indexing.get_search_params(info.topk_);
-        SearchInfo search_conf(info);
-        search_conf.search_params_ = search_params;
-        AssertInfo(vec_ptr->get_size_per_chunk() ==
-                       field_indexing.get_size_per_chunk(),
-                   "[FloatSearch]Chunk size of vector not equal to chunk size "
-                   "of field index");
-
-        auto size_per_chunk = field_indexing.get_size_per_chunk();
-        for (int chunk_id = current_chunk_id; chunk_id < max_indexed_id;
-             ++chunk_id) {
-            if ((chunk_id + 1) * size_per_chunk > ins_barrier) {
-                break;
-            }
-
-            auto indexing = field_indexing.get_chunk_indexing(chunk_id);
-            auto sub_view =
-                bitset.subview(chunk_id * size_per_chunk, size_per_chunk);
-            auto vec_index = (index::VectorIndex*)(indexing);
-            auto sub_qr = SearchOnIndex(
-                search_dataset, *vec_index, search_conf, sub_view);
-
-            // convert chunk uid to segment uid
-            for (auto& x : sub_qr.mutable_seg_offsets()) {
-                if (x != -1) {
-                    x += chunk_id * size_per_chunk;
-                }
-            }
-
-            results.merge(sub_qr);
-            current_chunk_id++;
-        }
-    }
-    return current_chunk_id;
-}
-
 void
 SearchOnGrowing(const segcore::SegmentGrowingImpl& segment,
                 const SearchInfo& info,
@@ -98,6 +37,8 @@ SearchOnGrowing(const segcore::SegmentGrowingImpl& segment,
                 SearchResult& results) {
     auto& schema = segment.get_schema();
     auto& record = segment.get_insert_record();
+    auto& indexing_record = segment.get_indexing_record();
+    auto& segcore_config = segment.get_segcore_config();
     auto active_count =
         std::min(int64_t(bitset.size()), segment.get_active_count(timestamp));
 
@@ -115,55 +56,275 @@ SearchOnGrowing(const segcore::SegmentGrowingImpl& segment,
     auto topk = info.topk_;
     auto metric_type = info.metric_type_;
     auto round_decimal = info.round_decimal_;
+    auto params = info.GetParams();
 
-    // step 2: small indexing search
-    SubSearchResult final_qr(num_queries, topk, metric_type, round_decimal);
     dataset::SearchDataset search_dataset{
         metric_type, num_queries, topk, round_decimal, dim, query_data};
-
-    int32_t current_chunk_id = 0;
-    if (field.get_data_type() == DataType::VECTOR_FLOAT) {
-        current_chunk_id = FloatIndexSearch(segment,
-                                            info,
-                                            query_data,
-                                            num_queries,
-                                            active_count,
-                                            bitset,
-                                            final_qr);
-    }
-
-    // step 3: brute force search where small indexing is unavailable
     auto vec_ptr = record.get_field_data_base(vecfield_id);
     auto vec_size_per_chunk = vec_ptr->get_size_per_chunk();
-    auto max_chunk = upper_div(active_count, vec_size_per_chunk);
 
-    for (int chunk_id = current_chunk_id; chunk_id < max_chunk; ++chunk_id) {
-        auto chunk_data = vec_ptr->get_chunk_data(chunk_id);
+    // every task searches rows of its own and returns segment offsets
+    std::vector<std::function<SubSearchResult()>> tasks;
 
-        auto element_begin = chunk_id * vec_size_per_chunk;
+    // step 2: index search, rows [0, indexed_rows) are covered by the graph
+    // or the small indexes
+    int64_t indexed_rows = 0;
+    auto graph = indexing_record.get_graph_index(vecfield_id);
+    auto ivf_chunk = indexing_record.get_ivf_chunk(vecfield_id, 0);
+    // the lists the queries probe, the same in every chunk
+    std::vector<int32_t> probes;
+    SearchInfo index_conf(info);
+    if (graph != nullptr) {
+        indexed_rows = std::min(graph->size(), active_count);
+        auto ef = segcore_config.get_graph_index_config().ef_search;
+        tasks.emplace_back([&, graph, ef, indexed_rows] {
+            SubSearchResult sub_qr(
+                num_queries, topk, metric_type, round_decimal);
+            auto queries = static_cast<const float*>(query_data);
+            for (int64_t i = 0; i < num_queries; ++i) {
+                graph->Search(queries + i * dim,
+                              topk,
+                              ef,
+                              indexed_rows,
+                              bitset,
+                              sub_qr.get_seg_offsets() + i * topk,
+                              sub_qr.get_distances() + i * topk);
+            }
+            sub_qr.round_values();
+            return sub_qr;
+        });
+    } else if (ivf_chunk != nullptr && !params->radius_.has_value()) {
+        auto centroids = ivf_chunk->centroids();
+        auto nprobe =
+            std::min(segcore_config.get_nprobe(), centroids->nlist());
+        auto queries = static_cast<const float*>(query_data);
+        probes = centroids->Probe(queries, num_queries, nprobe);
+        auto num_indexed_chunks =
+            std::min(indexing_record.get_finished_rows() / vec_size_per_chunk,
+                     active_count / vec_size_per_chunk);
+        for (int64_t chunk_id = 0; chunk_id < num_indexed_chunks;
+             ++chunk_id) {
+            auto chunk = indexing_record.get_ivf_chunk(vecfield_id, chunk_id);
+            AssertInfo(chunk->centroids() == centroids,
+                       "chunks of a field differ in their ivf centroids");
+            tasks.emplace_back([&, chunk_id, chunk, queries, nprobe] {
+                auto element_begin = chunk_id * vec_size_per_chunk;
+                auto chunk_data = static_cast<const float*>(
+                    vec_ptr->get_chunk_data(chunk_id));
+                auto sub_view =
+                    bitset.subview(element_begin, vec_size_per_chunk);
+                SubSearchResult sub_qr(
+                    num_queries, topk, metric_type, round_decimal);
+                for (int64_t i = 0; i < num_queries; ++i) {
+                    chunk->Search(chunk_data,
+                                  queries + i * dim,
+                                  probes.data() + i * nprobe,
+                                  nprobe,
+                                  topk,
+                                  sub_view,
+                                  sub_qr.get_seg_offsets() + i * topk,
+                                  sub_qr.get_distances() + i * topk);
+                }
+                sub_qr.round_values();
+                sub_qr.shift_offsets(element_begin);
+                return sub_qr;
+            });
+        }
+        indexed_rows = num_indexed_chunks * vec_size_per_chunk;
+    } else if (data_type == DataType::VECTOR_FLOAT &&
+               indexing_record.is_in(vecfield_id)) {
+        const auto& field_indexing =
+            indexing_record.get_vec_field_indexing(vecfield_id);
+        index_conf.search_params_ = field_indexing.get_search_params(topk);
+        ParseSearchParams(index_conf);
+        AssertInfo(vec_size_per_chunk == field_indexing.get_size_per_chunk(),
+                   "[FloatSearch]Chunk size of vector not equal to chunk size "
+                   "of field index");
+
+        // the indexes of complete chunks only
+        auto num_indexed_chunks =
+            std::min(indexing_record.get_finished_rows() / vec_size_per_chunk,
+                     active_count / vec_size_per_chunk);
+        for (int64_t chunk_id = 0; chunk_id < num_indexed_chunks;
+             ++chunk_id) {
+            auto vec_index = dynamic_cast<const index::VectorIndex*>(
+                field_indexing.get_chunk_indexing(chunk_id));
+            tasks.emplace_back([&, chunk_id, vec_index] {
+                auto element_begin = chunk_id * vec_size_per_chunk;
+                auto sub_view =
+                    bitset.subview(element_begin, vec_size_per_chunk);
+                auto sub_qr = SearchOnIndex(
+                    search_dataset, *vec_index, index_conf, sub_view);
+                sub_qr.shift_offsets(element_begin);
+                return sub_qr;
+            });
+        }
+        indexed_rows = num_indexed_chunks * vec_size_per_chunk;
+    }
+    auto index_tasks = int64_t(tasks.size());
+
+    // step 3: brute force search where small indexing is unavailable, on
+    // the 8-bit copies of complete chunks if there are any
+    auto max_chunk = upper_div(active_count, vec_size_per_chunk);
+    auto row_bytes = field.get_sizeof();
+    auto refine_ratio = params->radius_.has_value()
+                            ? 0
+                            : segcore_config.get_growing_sq8_refine_ratio();
+    // chunks of a range search share the radius their topk narrows down
+    std::unique_ptr<RangeSearchBound> range_bound;
+    if (params->radius_.has_value()) {
+        range_bound = std::make_unique<RangeSearchBound>(
+            num_queries, metric_type, params->radius_.value());
+    }
+    for (int64_t chunk_id = indexed_rows / vec_size_per_chunk;
+         chunk_id < max_chunk;
+         ++chunk_id) {
+        auto chunk_begin = chunk_id * vec_size_per_chunk;
+        auto element_begin = std::max(chunk_begin, indexed_rows);
         auto element_end =
             std::min(active_count, (chunk_id + 1) * vec_size_per_chunk);
         auto size_per_chunk = element_end - element_begin;
+        if (size_per_chunk <= 0) {
+            continue;
+        }
+        auto chunk_data =
+            static_cast<const char*>(vec_ptr->get_chunk_data(chunk_id)) +
+            (element_begin - chunk_begin) * row_bytes;
+        auto quantized =
+            refine_ratio > 0
+                ? indexing_record.get_quantized_chunk(vecfield_id, chunk_id)
+                : nullptr;
+        if (quantized != nullptr) {
+            tasks.emplace_back([&,
+                                quantized,
+                                chunk_data,
+                                chunk_begin,
+                                element_begin,
+                                size_per_chunk] {
+                auto sub_view = bitset.subview(element_begin, size_per_chunk);
+                auto sub_qr = QuantizedBruteForceSearch(
+                    search_dataset,
+                    *quantized,
+                    element_begin - chunk_begin,
+                    reinterpret_cast<const float*>(chunk_data),
+                    size_per_chunk,
+                    refine_ratio,
+                    sub_view);
+                sub_qr.shift_offsets(element_begin);
+                return sub_qr;
+            });
+            continue;
+        }
+        auto norms = vec_ptr->get_chunk_norms(chunk_id);
+        if (norms != nullptr) {
+            norms += element_begin - chunk_begin;
+        }
+        tasks.emplace_back([&,
+                            chunk_data,
+                            norms,
+                            element_begin,
+                            size_per_chunk] {
+            auto sub_view = bitset.subview(element_begin, size_per_chunk);
+            auto sub_qr = BruteForceSearch(search_dataset,
+                                           chunk_data,
+                                           size_per_chunk,
+                                           *params,
+                                           sub_view,
+                                           range_bound.get(),
+                                           norms);
+            sub_qr.shift_offsets(element_begin);
+            return sub_qr;
+        });
+    }
+
+    // step 4: fan the tasks out, then merge all their results at once
+    std::vector<std::optional<SubSearchResult>> sub_results(tasks.size());
+    ParallelFor(tasks.size(),
+                segcore_config.get_growing_search_parallelism() - 1,
+                [&](int64_t id) {
+                    CheckCancel(info.cancel_token_);
+                    sub_results[id].emplace(tasks[id]());
+                });
+    if (sub_results.empty()) {
+        sub_results.emplace_back(std::in_place,
+                                 num_queries,
+                                 topk,
+                                 metric_type,
+                                 round_decimal);
+    }
+    std::vector<const SubSearchResult*> others;
+    others.reserve(sub_results.size() - 1);
+    for (size_t i = 1; i < sub_results.size(); ++i) {
+        others.push_back(&*sub_results[i]);
+    }
+    sub_results.front()->merge_many(others);
+    auto& final_qr = *sub_results.front();
+    results.distances_ = std::move(final_qr.mutable_distances());
+    results.seg_offsets_ = std::move(final_qr.mutable_seg_offsets());
+    results.unity_topK_ = topk;
+    results.total_nq_ = num_queries;
+    results.index_chunks_ = index_tasks;
+    results.brute_force_chunks_ = int64_t(tasks.size()) - index_tasks;
+}
 
-        auto sub_view = bitset.subview(element_begin, size_per_chunk);
-        auto sub_qr = BruteForceSearch(search_dataset,
-                                       chunk_data,
-                                       size_per_chunk,
-                                       info.search_params_,
-                                       sub_view);
+void
+SearchSparseOnGrowing(const segcore::SegmentGrowingImpl& segment,
+                      const SearchInfo& info,
+                      const SparseFloatRow* queries,
+                      int64_t num_queries,
+                      Timestamp timestamp,
+                      const BitsetView& bitset,
+                      SearchResult& results) {
+    auto& record = segment.get_insert_record();
+    auto& segcore_config = segment.get_segcore_config();
+    auto active_count =
+        std::min(int64_t(bitset.size()), segment.get_active_count(timestamp));
+    AssertInfo(!info.GetParams()->radius_.has_value(),
+               "sparse vectors have no range search");
+    auto topk = info.topk_;
+    auto round_decimal = info.round_decimal_;
+    auto vec_ptr = record.get_field_data<SparseFloatRow>(info.field_id_);
+    auto size_per_chunk = vec_ptr->get_size_per_chunk();
 
-        // convert chunk uid to segment uid
-        for (auto& x : sub_qr.mutable_seg_offsets()) {
-            if (x != -1) {
-                x += chunk_id * vec_size_per_chunk;
-            }
-        }
-        final_qr.merge(sub_qr);
+    auto num_chunks = upper_div(active_count, size_per_chunk);
+    std::vector<std::optional<SubSearchResult>> sub_results(num_chunks);
+    ParallelFor(num_chunks,
+                segcore_config.get_growing_search_parallelism() - 1,
+                [&](int64_t chunk_id) {
+                    CheckCancel(info.cancel_token_);
+                    auto begin = chunk_id * size_per_chunk;
+                    auto size = std::min(size_per_chunk, active_count - begin);
+                    auto rows = static_cast<const SparseFloatRow*>(
+                        vec_ptr->get_chunk_data(chunk_id));
+                    auto sub_qr =
+                        SparseBruteForceSearch(queries,
+                                               num_queries,
+                                               rows,
+                                               size,
+                                               topk,
+                                               round_decimal,
+                                               bitset.subview(begin, size));
+                    sub_qr.shift_offsets(begin);
+                    sub_results[chunk_id].emplace(std::move(sub_qr));
+                });
+    if (sub_results.empty()) {
+        sub_results.emplace_back(std::in_place,
+                                 num_queries,
+                                 topk,
+                                 knowhere::metric::IP,
+                                 round_decimal);
+    }
+    std::vector<const SubSearchResult*> others;
+    for (size_t i = 1; i < sub_results.size(); ++i) {
+        others.push_back(&*sub_results[i]);
     }
+    sub_results.front()->merge_many(others);
+    auto& final_qr = *sub_results.front();
     results.distances_ = std::move(final_qr.mutable_distances());
     results.seg_offsets_ = std::move(final_qr.mutable_seg_offsets());
     results.unity_topK_ = topk;
     results.total_nq_ = num_queries;
+    results.brute_force_chunks_ = num_chunks;
 }
 
 }  // namespace milvus::query
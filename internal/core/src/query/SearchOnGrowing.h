@@ -25,4 +25,14 @@ SearchOnGrowing(const segcore::SegmentGrowingImpl& segment,
                 const BitsetView& bitset,
                 SearchResult& results);
 
+// brute force over the rows of a sparse float vector field, a task a chunk
+void
+SearchSparseOnGrowing(const segcore::SegmentGrowingImpl& segment,
+                      const SearchInfo& info,
+                      const SparseFloatRow* queries,
+                      int64_t num_queries,
+                      Timestamp timestamp,
+                      const BitsetView& bitset,
+                      SearchResult& results);
+
 }  // namespace milvus::query
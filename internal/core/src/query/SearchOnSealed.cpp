@@ -9,12 +9,22 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <vector>
 
+#include "common/CancelToken.h"
 #include "common/QueryInfo.h"
+#include "common/ScratchArena.h"
 #include "query/SearchBruteForce.h"
 #include "query/SearchOnSealed.h"
 #include "query/helper.h"
+#include "segcore/SegcoreConfig.h"
+#include "simd/hook.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::query {
 
@@ -27,7 +37,6 @@ SearchOnSealedIndex(const Schema& schema,
                     const BitsetView& bitset,
                     SearchResult& result) {
     auto topk = search_info.topk_;
-    auto round_decimal = search_info.round_decimal_;
 
     auto field_id = search_info.field_id_;
     auto& field = schema[field_id];
@@ -35,41 +44,170 @@ SearchOnSealedIndex(const Schema& schema,
     auto dim = field.get_dim();
 
     AssertInfo(record.is_ready(field_id), "[SearchOnSealed]Record isn't ready");
+    // knowhere can not be stopped once it runs
+    CheckCancel(search_info.cancel_token_);
     auto field_indexing = record.get_field_indexing(field_id);
     AssertInfo(field_indexing->metric_type_ == search_info.metric_type_,
                "Metric type of field index isn't the same with search info");
 
     auto final = [&] {
         auto ds = knowhere::GenDataSet(num_queries, dim, query_data);
-
-        auto conf = search_info.search_params_;
-        conf[knowhere::meta::TOPK] = search_info.topk_;
-        conf[knowhere::meta::METRIC_TYPE] = field_indexing->metric_type_;
         auto vec_index =
             dynamic_cast<index::VectorIndex*>(field_indexing->indexing_.get());
-        auto index_type = vec_index->GetIndexType();
         return vec_index->Query(ds, search_info, bitset);
     }();
 
-    auto ids = final->seg_offsets_.data();
-    float* distances = final->distances_.data();
+    // Query has rounded the distances already
+    result.seg_offsets_ = std::move(final->seg_offsets_);
+    result.distances_ = std::move(final->distances_);
+    result.total_nq_ = num_queries;
+    result.unity_topK_ = topk;
+}
 
-    auto total_num = num_queries * topk;
-    if (round_decimal != -1) {
-        const float multiplier = pow(10.0, round_decimal);
-        for (int i = 0; i < total_num; i++) {
-            distances[i] = round(distances[i] * multiplier) / multiplier;
+void
+RefineOnRawVectors(const SearchInfo& search_info,
+                   const float* vectors,
+                   int64_t dim,
+                   const void* query_data,
+                   int64_t num_queries,
+                   SearchResult& result) {
+    auto topk = search_info.topk_;
+    auto fetched = result.unity_topK_;
+    auto is_ip = PositivelyRelated(search_info.metric_type_);
+    SubSearchResult refined(num_queries,
+                            topk,
+                            search_info.metric_type_,
+                            search_info.round_decimal_);
+    ScratchVector<int64_t> rows;
+    ScratchVector<float> exact;
+    ScratchVector<int64_t> order;
+    for (int64_t q = 0; q < num_queries; ++q) {
+        rows.clear();
+        for (int64_t i = q * fetched; i < (q + 1) * fetched; ++i) {
+            if (result.seg_offsets_[i] != INVALID_SEG_OFFSET) {
+                rows.push_back(result.seg_offsets_[i]);
+            }
+        }
+        exact.resize(rows.size());
+        simd::GatherDistances(static_cast<const float*>(query_data) + q * dim,
+                              vectors,
+                              dim,
+                              rows.data(),
+                              rows.size(),
+                              is_ip,
+                              exact.data());
+        order.resize(rows.size());
+        std::iota(order.begin(), order.end(), 0);
+        auto kept = std::min<int64_t>(topk, rows.size());
+        std::partial_sort(
+            order.begin(),
+            order.begin() + kept,
+            order.end(),
+            [&](int64_t a, int64_t b) {
+                if (exact[a] != exact[b]) {
+                    return is_ip ? exact[a] > exact[b] : exact[a] < exact[b];
+                }
+                return rows[a] < rows[b];
+            });
+        auto seg_offsets = refined.get_seg_offsets() + q * topk;
+        auto distances = refined.get_distances() + q * topk;
+        for (int64_t i = 0; i < kept; ++i) {
+            seg_offsets[i] = rows[order[i]];
+            distances[i] = exact[order[i]];
         }
     }
-    result.seg_offsets_.resize(total_num);
-    result.distances_.resize(total_num);
-    result.total_nq_ = num_queries;
+    refined.round_values();
+    result.seg_offsets_ = std::move(refined.mutable_seg_offsets());
+    result.distances_ = std::move(refined.mutable_distances());
     result.unity_topK_ = topk;
+}
+
+namespace {
 
-    std::copy_n(ids, total_num, result.seg_offsets_.data());
-    std::copy_n(distances, total_num, result.distances_.data());
+// brute force over row_count rows in ranges searched in parallel, the
+// rows of a range got as rows_of(begin, rows, buffer), which may fill
+// buffer with them
+template <typename RowsOf>
+void
+SearchSealedRows(const Schema& schema,
+                 const SearchInfo& search_info,
+                 const void* query_data,
+                 int64_t num_queries,
+                 int64_t row_count,
+                 const BitsetView& bitset,
+                 SearchResult& result,
+                 const float* norms,
+                 const RowsOf& rows_of) {
+    auto field_id = search_info.field_id_;
+    auto& field = schema[field_id];
+
+    query::dataset::SearchDataset dataset{search_info.metric_type_,
+                                          num_queries,
+                                          search_info.topk_,
+                                          search_info.round_decimal_,
+                                          field.get_dim(),
+                                          query_data};
+
+    CheckBruteForceSearchParam(field, search_info);
+    auto params = search_info.GetParams();
+    auto& config = segcore::SegcoreConfig::default_config();
+
+    // ranges of rows of about the L2 cache, searched in parallel; whole
+    // blocks of the brute force so their bitsets start at a byte
+    auto row_bytes = field.get_sizeof();
+    auto block_rows = config.get_sealed_search_block_bytes() / row_bytes /
+                      BRUTE_FORCE_BLOCK_ROWS * BRUTE_FORCE_BLOCK_ROWS;
+    block_rows = std::max<int64_t>(block_rows, BRUTE_FORCE_BLOCK_ROWS);
+    auto num_blocks = upper_div(row_count, block_rows);
+    // the ranges of a range search narrow the radius of each other
+    std::unique_ptr<RangeSearchBound> range_bound;
+    if (params->radius_.has_value()) {
+        range_bound = std::make_unique<RangeSearchBound>(
+            num_queries, dataset.metric_type, params->radius_.value());
+    }
+    ScratchVector<std::optional<SubSearchResult>> sub_results(num_blocks);
+    ParallelFor(
+        num_blocks,
+        config.get_sealed_search_parallelism() - 1,
+        [&](int64_t id) {
+            CheckCancel(search_info.cancel_token_);
+            auto begin = id * block_rows;
+            auto rows = std::min(block_rows, row_count - begin);
+            ScratchVector<float> buffer;
+            auto sub_qr = BruteForceSearch(
+                dataset,
+                rows_of(begin, rows, buffer),
+                rows,
+                *params,
+                bitset.subview(begin, rows),
+                range_bound.get(),
+                norms != nullptr ? norms + begin : nullptr);
+            sub_qr.shift_offsets(begin);
+            sub_results[id].emplace(std::move(sub_qr));
+        });
+    if (sub_results.empty()) {
+        sub_results.emplace_back(std::in_place,
+                                 num_queries,
+                                 dataset.topk,
+                                 dataset.metric_type,
+                                 dataset.round_decimal);
+    }
+    std::vector<const SubSearchResult*> others;
+    others.reserve(sub_results.size() - 1);
+    for (size_t i = 1; i < sub_results.size(); ++i) {
+        others.push_back(&*sub_results[i]);
+    }
+    auto& final_qr = *sub_results.front();
+    final_qr.merge_many(others);
+
+    result.distances_ = std::move(final_qr.mutable_distances());
+    result.seg_offsets_ = std::move(final_qr.mutable_seg_offsets());
+    result.unity_topK_ = dataset.topk;
+    result.total_nq_ = dataset.num_queries;
 }
 
+}  // namespace
+
 void
 SearchOnSealed(const Schema& schema,
                const void* vec_data,
@@ -78,10 +216,57 @@ SearchOnSealed(const Schema& schema,
                int64_t num_queries,
                int64_t row_count,
                const BitsetView& bitset,
-               SearchResult& result) {
-    auto field_id = search_info.field_id_;
-    auto& field = schema[field_id];
+               SearchResult& result,
+               const float* norms) {
+    auto row_bytes = schema[search_info.field_id_].get_sizeof();
+    SearchSealedRows(schema,
+                     search_info,
+                     query_data,
+                     num_queries,
+                     row_count,
+                     bitset,
+                     result,
+                     norms,
+                     [&](int64_t begin, int64_t, std::vector<float>&) {
+                         return static_cast<const char*>(vec_data) +
+                                begin * row_bytes;
+                     });
+}
+
+void
+SearchOnSealed(const Schema& schema,
+               const segcore::CompressedVectorColumn& vec_data,
+               const SearchInfo& search_info,
+               const void* query_data,
+               int64_t num_queries,
+               const BitsetView& bitset,
+               SearchResult& result,
+               const float* norms) {
+    SearchSealedRows(schema,
+                     search_info,
+                     query_data,
+                     num_queries,
+                     vec_data.size(),
+                     bitset,
+                     result,
+                     norms,
+                     [&](int64_t begin, int64_t rows, auto& buffer) {
+                         // a range is decoded when it is searched
+                         buffer.resize(rows * vec_data.dim());
+                         vec_data.Decode(begin, rows, buffer.data());
+                         return reinterpret_cast<const char*>(buffer.data());
+                     });
+}
 
+void
+SearchOnSealed(const Schema& schema,
+               const segcore::HalfVectorColumn& vec_data,
+               const SearchInfo& search_info,
+               const void* query_data,
+               int64_t num_queries,
+               const BitsetView& bitset,
+               SearchResult& result) {
+    auto& field = schema[search_info.field_id_];
     query::dataset::SearchDataset dataset{search_info.metric_type_,
                                           num_queries,
                                           search_info.topk_,
@@ -90,8 +275,13 @@ SearchOnSealed(const Schema& schema,
                                           query_data};
 
     CheckBruteForceSearchParam(field, search_info);
-    auto sub_qr = BruteForceSearch(
-        dataset, vec_data, row_count, search_info.search_params_, bitset);
+    CheckCancel(search_info.cancel_token_);
+    auto sub_qr = HalfBruteForceSearch(dataset,
+                                       vec_data.data(),
+                                       vec_data.type(),
+                                       vec_data.size(),
+                                       *search_info.GetParams(),
+                                       bitset);
 
     result.distances_ = std::move(sub_qr.mutable_distances());
     result.seg_offsets_ = std::move(sub_qr.mutable_seg_offsets());
@@ -14,6 +14,7 @@
 #include "common/BitsetView.h"
 #include "query/PlanNode.h"
 #include "query/SearchOnGrowing.h"
+#include "segcore/EncodedColumn.h"
 #include "segcore/SealedIndexingRecord.h"
 
 namespace milvus::query {
@@ -27,6 +28,17 @@ SearchOnSealedIndex(const Schema& schema,
                     const BitsetView& view,
                     SearchResult& result);
 
+// narrows the hits of each query in result down to the topk of
+// search_info, ranked by their exact distances to the float rows of dim
+// floats at vectors; L2, IP and COSINE only
+void
+RefineOnRawVectors(const SearchInfo& search_info,
+                   const float* vectors,
+                   int64_t dim,
+                   const void* query_data,
+                   int64_t num_queries,
+                   SearchResult& result);
+
 void
 SearchOnSealed(const Schema& schema,
                const void* vec_data,
@@ -35,6 +47,29 @@ SearchOnSealed(const Schema& schema,
                int64_t num_queries,
                int64_t row_count,
                const BitsetView& bitset,
+               SearchResult& result,
+               const float* norms = nullptr);
+
+// brute force over a float vector field stored as halves
+void
+SearchOnSealed(const Schema& schema,
+               const segcore::HalfVectorColumn& vec_data,
+               const SearchInfo& search_info,
+               const void* query_data,
+               int64_t num_queries,
+               const BitsetView& bitset,
                SearchResult& result);
 
+// brute force over a float vector field stored compressed, with the
+// squared norms of its rows if not null
+void
+SearchOnSealed(const Schema& schema,
+               const segcore::CompressedVectorColumn& vec_data,
+               const SearchInfo& search_info,
+               const void* query_data,
+               int64_t num_queries,
+               const BitsetView& bitset,
+               SearchResult& result,
+               const float* norms = nullptr);
+
 }  // namespace milvus::query
@@ -0,0 +1,307 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "query/SparseSearch.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "exceptions/EasyAssert.h"
+
+namespace milvus::query {
+
+namespace {
+
+struct Hit {
+    float score;
+    int64_t offset;
+};
+
+// by score, then by the lower offset
+bool
+Better(const Hit& x, const Hit& y) {
+    return x.score > y.score || (x.score == y.score && x.offset < y.offset);
+}
+
+// the best topk hits pushed, the worst of them on top
+class TopkHits {
+ public:
+    explicit TopkHits(int64_t topk) : topk_(topk) {
+        hits_.reserve(topk);
+    }
+
+    bool
+    full() const {
+        return int64_t(hits_.size()) == topk_;
+    }
+
+    // the score of the worst hit, once full
+    float
+    worst() const {
+        return hits_.front().score;
+    }
+
+    void
+    Push(float score, int64_t offset) {
+        Hit hit{score, offset};
+        if (!full()) {
+            hits_.push_back(hit);
+            std::push_heap(hits_.begin(), hits_.end(), Better);
+        } else if (Better(hit, hits_.front())) {
+            std::pop_heap(hits_.begin(), hits_.end(), Better);
+            hits_.back() = hit;
+            std::push_heap(hits_.begin(), hits_.end(), Better);
+        }
+    }
+
+    // the hits, best first, into the slots of query q
+    void
+    Write(SubSearchResult& result, int64_t q) {
+        std::sort_heap(hits_.begin(), hits_.end(), Better);
+        for (size_t i = 0; i < hits_.size(); ++i) {
+            result.get_seg_offsets()[q * topk_ + i] = hits_[i].offset;
+            result.get_distances()[q * topk_ + i] = hits_[i].score;
+        }
+    }
+
+ private:
+    int64_t topk_;
+    std::vector<Hit> hits_;
+};
+
+bool
+Filtered(const BitsetView& bitset, int64_t offset) {
+    return !bitset.empty() &&
+           (offset >= int64_t(bitset.size()) || bitset.test(offset));
+}
+
+// a posting list walked by a query
+struct Cursor {
+    const uint32_t* rows;
+    const float* values;
+    int64_t size;
+    int64_t pos;
+    float weight;
+    // weight times the largest value
+    float bound;
+
+    int64_t
+    row() const {
+        return pos < size ? int64_t(rows[pos]) : MAX_ROW_COUNT;
+    }
+
+    // to the first row at or after offset
+    void
+    Seek(int64_t offset) {
+        if (pos < size && rows[pos] < offset) {
+            pos = std::lower_bound(rows + pos, rows + size, offset) - rows;
+        }
+    }
+};
+
+}  // namespace
+
+SubSearchResult
+SparseBruteForceSearch(const SparseFloatRow* queries,
+                       int64_t num_queries,
+                       const SparseFloatRow* rows,
+                       int64_t num_rows,
+                       int64_t topk,
+                       int64_t round_decimal,
+                       const BitsetView& bitset) {
+    SubSearchResult result(
+        num_queries, topk, knowhere::metric::IP, round_decimal);
+    for (int64_t q = 0; q < num_queries; ++q) {
+        TopkHits hits(topk);
+        for (int64_t i = 0; i < num_rows; ++i) {
+            if (Filtered(bitset, i)) {
+                continue;
+            }
+            bool overlaps;
+            auto score = queries[q].dot(rows[i], &overlaps);
+            if (overlaps) {
+                hits.Push(score, i);
+            }
+        }
+        hits.Write(result, q);
+    }
+    result.round_values();
+    return result;
+}
+
+SparseInvertedIndex::SparseInvertedIndex(const SparseFloatRow* rows,
+                                         int64_t num_rows) {
+    AssertInfo(num_rows <= std::numeric_limits<uint32_t>::max(),
+               "too many rows for a sparse index");
+    row_offsets_.resize(num_rows + 1);
+    for (int64_t i = 0; i < num_rows; ++i) {
+        row_offsets_[i + 1] = row_offsets_[i] + rows[i].nnz();
+    }
+    auto nnz = row_offsets_[num_rows];
+    row_indices_.resize(nnz);
+    row_values_.resize(nnz);
+    for (int64_t i = 0; i < num_rows; ++i) {
+        std::copy_n(rows[i].indices(),
+                    rows[i].nnz(),
+                    row_indices_.data() + row_offsets_[i]);
+        std::copy_n(rows[i].values(),
+                    rows[i].nnz(),
+                    row_values_.data() + row_offsets_[i]);
+    }
+
+    dims_ = row_indices_;
+    std::sort(dims_.begin(), dims_.end());
+    dims_.erase(std::unique(dims_.begin(), dims_.end()), dims_.end());
+    // the rows are visited in order, so each list comes out ascending
+    std::vector<int64_t> slots(nnz);
+    posting_offsets_.assign(dims_.size() + 1, 0);
+    for (int64_t k = 0; k < nnz; ++k) {
+        slots[k] =
+            std::lower_bound(dims_.begin(), dims_.end(), row_indices_[k]) -
+            dims_.begin();
+        ++posting_offsets_[slots[k] + 1];
+    }
+    for (size_t d = 0; d < dims_.size(); ++d) {
+        posting_offsets_[d + 1] += posting_offsets_[d];
+    }
+    posting_rows_.resize(nnz);
+    posting_values_.resize(nnz);
+    max_values_.assign(dims_.size(), std::numeric_limits<float>::lowest());
+    std::vector<int64_t> fill(posting_offsets_.begin(),
+                              posting_offsets_.end() - 1);
+    for (int64_t i = 0; i < num_rows; ++i) {
+        for (auto k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+            auto slot = slots[k];
+            auto value = row_values_[k];
+            posting_rows_[fill[slot]] = i;
+            posting_values_[fill[slot]++] = value;
+            max_values_[slot] = std::max(max_values_[slot], value);
+            non_negative_ = non_negative_ && value >= 0;
+        }
+    }
+}
+
+void
+SparseInvertedIndex::AppendRow(int64_t offset, DataArray* data) const {
+    auto begin = row_offsets_[offset];
+    AppendSparseRow(row_indices_.data() + begin,
+                    row_values_.data() + begin,
+                    row_offsets_[offset + 1] - begin,
+                    data);
+}
+
+SubSearchResult
+SparseInvertedIndex::Search(const SparseFloatRow* queries,
+                            int64_t num_queries,
+                            int64_t topk,
+                            int64_t round_decimal,
+                            const BitsetView& bitset,
+                            const CancelToken* cancel_token) const {
+    SubSearchResult result(
+        num_queries, topk, knowhere::metric::IP, round_decimal);
+    std::vector<Cursor> cursors;
+    // bounds[i] is the sum of the bounds of cursors [0, i]
+    std::vector<float> bounds;
+    for (int64_t q = 0; q < num_queries; ++q) {
+        CheckCancel(cancel_token);
+        auto& query = queries[q];
+        cursors.clear();
+        auto prune = non_negative_;
+        for (int64_t i = 0; i < query.nnz(); ++i) {
+            auto it = std::lower_bound(
+                dims_.begin(), dims_.end(), query.indices()[i]);
+            if (it == dims_.end() || *it != query.indices()[i]) {
+                continue;
+            }
+            auto d = it - dims_.begin();
+            auto begin = posting_offsets_[d];
+            auto weight = query.values()[i];
+            prune = prune && weight >= 0;
+            cursors.push_back({posting_rows_.data() + begin,
+                               posting_values_.data() + begin,
+                               posting_offsets_[d + 1] - begin,
+                               0,
+                               weight,
+                               weight * max_values_[d]});
+        }
+        std::sort(cursors.begin(), cursors.end(), [](auto& x, auto& y) {
+            return x.bound < y.bound;
+        });
+        bounds.resize(cursors.size());
+        float sum = 0;
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            sum += cursors[i].bound;
+            bounds[i] = sum;
+        }
+
+        TopkHits hits(topk);
+        int64_t m = cursors.size();
+        // cursors [0, first) are not essential: a row on them only can't
+        // make the topk, they only score the rows the others find
+        int64_t first = 0;
+        while (true) {
+            if (prune && hits.full()) {
+                while (first < m && bounds[first] <= hits.worst()) {
+                    ++first;
+                }
+            }
+            if (first == m) {
+                break;
+            }
+            auto row = MAX_ROW_COUNT;
+            for (auto i = first; i < m; ++i) {
+                row = std::min(row, cursors[i].row());
+            }
+            if (row == MAX_ROW_COUNT) {
+                break;
+            }
+            float score = 0;
+            for (auto i = first; i < m; ++i) {
+                auto& cursor = cursors[i];
+                if (cursor.row() == row) {
+                    score += cursor.weight * cursor.values[cursor.pos++];
+                }
+            }
+            if (Filtered(bitset, row)) {
+                continue;
+            }
+            for (auto i = first - 1; i >= 0; --i) {
+                // ties lose, the rows in the topk have lower offsets
+                if (hits.full() && score + bounds[i] <= hits.worst()) {
+                    break;
+                }
+                auto& cursor = cursors[i];
+                cursor.Seek(row);
+                if (cursor.row() == row) {
+                    score += cursor.weight * cursor.values[cursor.pos++];
+                }
+            }
+            hits.Push(score, row);
+        }
+        hits.Write(result, q);
+    }
+    result.round_values();
+    return result;
+}
+
+int64_t
+SparseInvertedIndex::memory_bytes() const {
+    return row_offsets_.size() * sizeof(int64_t) +
+           row_indices_.size() * sizeof(uint32_t) +
+           row_values_.size() * sizeof(float) +
+           dims_.size() * sizeof(uint32_t) +
+           posting_offsets_.size() * sizeof(int64_t) +
+           posting_rows_.size() * sizeof(uint32_t) +
+           posting_values_.size() * sizeof(float) +
+           max_values_.size() * sizeof(float);
+}
+
+}  // namespace milvus::query
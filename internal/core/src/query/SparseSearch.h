@@ -0,0 +1,81 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <vector>
+
+#include "common/BitsetView.h"
+#include "common/CancelToken.h"
+#include "common/SparseVector.h"
+#include "query/SubSearchResult.h"
+
+namespace milvus::query {
+
+// the topk of num_rows rows for each query by inner product, among the
+// rows sharing a dimension with it; ties go to the lower offset. offsets
+// are those of rows
+SubSearchResult
+SparseBruteForceSearch(const SparseFloatRow* queries,
+                       int64_t num_queries,
+                       const SparseFloatRow* rows,
+                       int64_t num_rows,
+                       int64_t topk,
+                       int64_t round_decimal,
+                       const BitsetView& bitset);
+
+// the rows of a sealed sparse float vector field in csr form, and an
+// inverted index over them: per dimension the rows holding it in
+// ascending order, their values and the largest one. a search walks the
+// posting lists of the dimensions of a query row by row, MaxScore style:
+// the lists whose bounds add up to no more than the worst hit of the topk
+// only score the rows the others found. with negative values there are no
+// bounds and every list is walked
+class SparseInvertedIndex {
+ public:
+    SparseInvertedIndex(const SparseFloatRow* rows, int64_t num_rows);
+
+    int64_t
+    size() const {
+        return int64_t(row_offsets_.size()) - 1;
+    }
+
+    // appends row offset, in the wire format of the field
+    void
+    AppendRow(int64_t offset, DataArray* data) const;
+
+    // as SparseBruteForceSearch over all the rows
+    SubSearchResult
+    Search(const SparseFloatRow* queries,
+           int64_t num_queries,
+           int64_t topk,
+           int64_t round_decimal,
+           const BitsetView& bitset,
+           const CancelToken* cancel_token) const;
+
+    int64_t
+    memory_bytes() const;
+
+ private:
+    std::vector<int64_t> row_offsets_;
+    std::vector<uint32_t> row_indices_;
+    std::vector<float> row_values_;
+
+    // the dimensions held by any row, ascending, and their posting lists
+    std::vector<uint32_t> dims_;
+    std::vector<int64_t> posting_offsets_;
+    std::vector<uint32_t> posting_rows_;
+    std::vector<float> posting_values_;
+    std::vector<float> max_values_;
+    bool non_negative_ = true;
+};
+
+}  // namespace milvus::query
@@ -9,89 +9,124 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
-#include <cmath>
+#include <algorithm>
 
 #include "exceptions/EasyAssert.h"
 #include "query/SubSearchResult.h"
+#include "simd/hook.h"
 
 namespace milvus::query {
 
 template <bool is_desc>
 void
-SubSearchResult::merge_impl(const SubSearchResult& right) {
-    AssertInfo(num_queries_ == right.num_queries_,
-               "[SubSearchResult]Nq check failed");
-    AssertInfo(topk_ == right.topk_, "[SubSearchResult]Topk check failed");
-    AssertInfo(metric_type_ == right.metric_type_,
-               "[SubSearchResult]Metric type check failed");
+SubSearchResult::merge_many_impl(
+    const std::vector<const SubSearchResult*>& sub_results) {
+    for (auto right : sub_results) {
+        AssertInfo(num_queries_ == right->num_queries_,
+                   "[SubSearchResult]Nq check failed");
+        AssertInfo(topk_ == right->topk_,
+                   "[SubSearchResult]Topk check failed");
+        AssertInfo(metric_type_ == right->metric_type_,
+                   "[SubSearchResult]Metric type check failed");
+    }
     AssertInfo(is_desc == PositivelyRelated(metric_type_),
                "[SubSearchResult]Metric type isn't desc");
 
-    for (int64_t qn = 0; qn < num_queries_; ++qn) {
-        auto offset = qn * topk_;
-
-        int64_t* __restrict__ left_ids = this->get_seg_offsets() + offset;
-        float* __restrict__ left_distances = this->get_distances() + offset;
-
-        auto right_ids = right.get_ids() + offset;
-        auto right_distances = right.get_distances() + offset;
+    // the next entry of a source, source 0 being this result
+    struct Head {
+        float distance;
+        int64_t source;
+        int64_t pos;
+    };
+    // whether a comes out after b, the heap keeps the best on top
+    auto later = [](const Head& a, const Head& b) {
+        if (a.distance != b.distance) {
+            return is_desc ? a.distance < b.distance : a.distance > b.distance;
+        }
+        return a.source > b.source;
+    };
 
-        std::vector<float> buf_distances(topk_);
-        std::vector<int64_t> buf_ids(topk_);
+    // scratch space shared by all the queries
+    auto num_sources = sub_results.size() + 1;
+    std::vector<const int64_t*> source_ids(num_sources);
+    std::vector<const float*> source_distances(num_sources);
+    std::vector<Head> heap;
+    heap.reserve(num_sources);
+    std::vector<int64_t> buf_ids(topk_);
+    std::vector<float> buf_distances(topk_);
 
-        auto lit = 0;  // left iter
-        auto rit = 0;  // right iter
+    for (int64_t qn = 0; qn < num_queries_; ++qn) {
+        auto offset = qn * topk_;
+        heap.clear();
+        for (size_t source = 0; source < num_sources; ++source) {
+            auto result = source == 0 ? this : sub_results[source - 1];
+            source_ids[source] = result->get_ids() + offset;
+            source_distances[source] = result->get_distances() + offset;
+            // results end with their invalid entries
+            if (topk_ > 0 && source_ids[source][0] != INVALID_SEG_OFFSET) {
+                heap.push_back({source_distances[source][0],
+                                int64_t(source),
+                                0});
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), later);
 
-        for (auto buf_iter = 0; buf_iter < topk_; ++buf_iter) {
-            auto left_id = left_ids[lit];
-            auto left_v = left_distances[lit];
-            auto right_id = right_ids[rit];
-            auto right_v = right_distances[rit];
-            // optimize out at compiling
-            if (left_id == INVALID_SEG_OFFSET) {
-                buf_distances[buf_iter] = right_distances[rit];
-                buf_ids[buf_iter] = right_ids[rit];
-                ++rit;
-            } else if (right_id == INVALID_SEG_OFFSET) {
-                buf_distances[buf_iter] = left_distances[lit];
-                buf_ids[buf_iter] = left_ids[lit];
-                ++lit;
+        int64_t buf_iter = 0;
+        for (; buf_iter < topk_ && !heap.empty(); ++buf_iter) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            auto& head = heap.back();
+            buf_ids[buf_iter] = source_ids[head.source][head.pos];
+            buf_distances[buf_iter] = head.distance;
+            auto next = ++head.pos;
+            if (next < topk_ &&
+                source_ids[head.source][next] != INVALID_SEG_OFFSET) {
+                head.distance = source_distances[head.source][next];
+                std::push_heap(heap.begin(), heap.end(), later);
             } else {
-                if (is_desc ? (left_v >= right_v) : (left_v <= right_v)) {
-                    buf_distances[buf_iter] = left_distances[lit];
-                    buf_ids[buf_iter] = left_ids[lit];
-                    ++lit;
-                } else {
-                    buf_distances[buf_iter] = right_distances[rit];
-                    buf_ids[buf_iter] = right_ids[rit];
-                    ++rit;
-                }
+                heap.pop_back();
             }
         }
-        std::copy_n(buf_distances.data(), topk_, left_distances);
-        std::copy_n(buf_ids.data(), topk_, left_ids);
+        std::fill(
+            buf_ids.begin() + buf_iter, buf_ids.end(), INVALID_SEG_OFFSET);
+        std::fill(buf_distances.begin() + buf_iter,
+                  buf_distances.end(),
+                  init_value(metric_type_));
+
+        std::copy_n(buf_distances.data(), topk_, get_distances() + offset);
+        std::copy_n(buf_ids.data(), topk_, get_seg_offsets() + offset);
     }
 }
 
 void
 SubSearchResult::merge(const SubSearchResult& sub_result) {
-    AssertInfo(metric_type_ == sub_result.metric_type_,
-               "[SubSearchResult]Metric type check failed when merge");
+    merge_many({&sub_result});
+}
+
+void
+SubSearchResult::merge_many(
+    const std::vector<const SubSearchResult*>& sub_results) {
+    for (auto sub_result : sub_results) {
+        AssertInfo(metric_type_ == sub_result->metric_type_,
+                   "[SubSearchResult]Metric type check failed when merge");
+    }
     if (PositivelyRelated(metric_type_)) {
-        this->merge_impl<true>(sub_result);
+        this->merge_many_impl<true>(sub_results);
     } else {
-        this->merge_impl<false>(sub_result);
+        this->merge_many_impl<false>(sub_results);
     }
 }
 
 void
 SubSearchResult::round_values() {
-    if (round_decimal_ == -1)
-        return;
-    const float multiplier = pow(10.0, round_decimal_);
-    for (auto it = this->distances_.begin(); it != this->distances_.end();
-         it++) {
-        *it = round(*it * multiplier) / multiplier;
+    simd::RoundDecimal(distances_.data(), distances_.size(), round_decimal_);
+}
+
+void
+SubSearchResult::shift_offsets(int64_t offset) {
+    for (auto& x : seg_offsets_) {
+        if (x != INVALID_SEG_OFFSET) {
+            x += offset;
+        }
     }
 }
 
@@ -94,13 +94,23 @@ class SubSearchResult {
     void
     round_values();
 
+    // adds offset to the valid offsets, from those of a range of rows to
+    // those of the segment
+    void
+    shift_offsets(int64_t offset);
+
     void
     merge(const SubSearchResult& sub_result);
 
+    // merges the topk of this and all of sub_results in one k-way pass,
+    // ties go to this first, then to sub_results in order
+    void
+    merge_many(const std::vector<const SubSearchResult*>& sub_results);
+
  private:
     template <bool is_desc>
     void
-    merge_impl(const SubSearchResult& sub_result);
+    merge_many_impl(const std::vector<const SubSearchResult*>& sub_results);
 
  private:
     int64_t num_queries_;
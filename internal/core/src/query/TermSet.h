@@ -0,0 +1,181 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace milvus::query {
+
+// Membership probe of the terms of a TermExpr.
+// It is built once with the plan and shared by every segment the plan
+// runs on, the layout is chosen by the number of distinct terms:
+// a linear scan for a handful of terms, a sorted array searched without
+// branches for a medium list, and an open addressing hash set beyond.
+template <typename T>
+class TermSet {
+ public:
+    enum class Layout { Linear, Sorted, Hash };
+    // std::vector<bool> has no contiguous storage to search
+    using ValueType = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+
+    static constexpr size_t LINEAR_LIMIT = 16;
+    static constexpr size_t SORTED_LIMIT = 1024;
+
+    explicit TermSet(const std::vector<T>& terms)
+        : terms_(terms.begin(), terms.end()) {
+        if constexpr (std::is_floating_point_v<T>) {
+            // NaN equals nothing, so it can never match
+            terms_.erase(std::remove_if(terms_.begin(),
+                                        terms_.end(),
+                                        [](T x) { return std::isnan(x); }),
+                         terms_.end());
+        }
+        std::sort(terms_.begin(), terms_.end());
+        terms_.erase(std::unique(terms_.begin(), terms_.end()), terms_.end());
+
+        if (terms_.size() < LINEAR_LIMIT) {
+            layout_ = Layout::Linear;
+        } else if (terms_.size() < SORTED_LIMIT) {
+            layout_ = Layout::Sorted;
+        } else {
+            layout_ = Layout::Hash;
+            BuildHash();
+        }
+    }
+
+    Layout
+    layout() const {
+        return layout_;
+    }
+
+    // distinct terms in ascending order
+    const std::vector<ValueType>&
+    terms() const {
+        return terms_;
+    }
+
+    template <typename U>
+    bool
+    contains(const U& x) const {
+        switch (layout_) {
+            case Layout::Linear:
+                return LinearContains(x);
+            case Layout::Sorted:
+                return SortedContains(x);
+            default:
+                return HashContains(x);
+        }
+    }
+
+ private:
+    template <typename U>
+    bool
+    LinearContains(const U& x) const {
+        bool found = false;
+        for (const auto& term : terms_) {
+            found |= term == x;
+        }
+        return found;
+    }
+
+    template <typename U>
+    bool
+    SortedContains(const U& x) const {
+        // the search range shrinks by half each step without a branch
+        // to mispredict, `base` ends on the last term not greater than x
+        auto base = terms_.data();
+        auto n = terms_.size();
+        while (n > 1) {
+            auto half = n / 2;
+            base = (base[half] <= x) ? base + half : base;
+            n -= half;
+        }
+        return *base == x;
+    }
+
+    template <typename U>
+    bool
+    HashContains(const U& x) const {
+        for (auto slot = Slot(x);; slot = (slot + 1) & mask_) {
+            if (!used_[slot]) {
+                return false;
+            }
+            if (slots_[slot] == x) {
+                return true;
+            }
+        }
+    }
+
+    template <typename U>
+    static size_t
+    Hash(const U& x) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            return std::hash<std::string_view>{}(std::string_view(x));
+        } else {
+            return std::hash<ValueType>{}(x);
+        }
+    }
+
+    // fibonacci hashing, the identity std::hash of integers would
+    // cluster sequential keys in neighbouring slots
+    template <typename U>
+    size_t
+    Slot(const U& x) const {
+        return (uint64_t(Hash(x)) * 0x9E3779B97F4A7C15ULL) >> shift_;
+    }
+
+    void
+    BuildHash() {
+        // keep the load factor at most 1/2
+        int bits = 1;
+        while ((size_t(1) << bits) < terms_.size() * 2) {
+            ++bits;
+        }
+        auto capacity = size_t(1) << bits;
+        mask_ = capacity - 1;
+        shift_ = 64 - bits;
+        slots_.resize(capacity);
+        used_.resize(capacity, false);
+        for (const auto& term : terms_) {
+            auto slot = Slot(term);
+            while (used_[slot]) {
+                slot = (slot + 1) & mask_;
+            }
+            slots_[slot] = term;
+            used_[slot] = true;
+        }
+    }
+
+ private:
+    std::vector<ValueType> terms_;
+    Layout layout_ = Layout::Linear;
+
+    // open addressing with linear probing, only for Layout::Hash
+    std::vector<ValueType> slots_;
+    std::vector<uint8_t> used_;
+    size_t mask_ = 0;
+    int shift_ = 64;
+};
+
+}  // namespace milvus::query
@@ -12,10 +12,14 @@
 #pragma once
 // Generated File
 // DO NOT EDIT
+#include <chrono>
 #include <optional>
 #include <boost/variant.hpp>
 #include <utility>
 #include <deque>
+#include "common/CancelToken.h"
+#include "common/CompressedBitset.h"
+#include "common/QueryProfile.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "query/ExprImpl.h"
 #include "ExprVisitor.h"
@@ -47,17 +51,39 @@ class ExecExprVisitor : public ExprVisitor {
  public:
     ExecExprVisitor(const segcore::SegmentInternalInterface& segment,
                     int64_t row_count,
-                    Timestamp timestamp)
-        : segment_(segment), row_count_(row_count), timestamp_(timestamp) {
+                    Timestamp timestamp,
+                    const ExprBindings* bindings = nullptr,
+                    QueryProfile* profile = nullptr,
+                    const CancelToken* cancel_token = nullptr)
+        : segment_(segment),
+          row_count_(row_count),
+          timestamp_(timestamp),
+          bindings_(bindings),
+          profile_(profile),
+          cancel_token_(cancel_token) {
     }
 
     BitsetType
     call_child(Expr& expr) {
+        return call_child_compressed(expr).to_dense();
+    }
+
+    // the result in the container it was produced in, intermediate
+    // results stay compressed until call_child needs a bitmap
+    CompressedBitset
+    call_child_compressed(Expr& expr) {
         Assert(!bitset_opt_.has_value());
+        CheckCancel(cancel_token_);
+        auto start = std::chrono::steady_clock::now();
+        ++depth_;
         expr.accept(*this);
+        --depth_;
         Assert(bitset_opt_.has_value());
         auto res = std::move(bitset_opt_);
         bitset_opt_ = std::nullopt;
+        if (profile_ != nullptr) {
+            ProfileExpr(expr, res.value(), start);
+        }
         return std::move(res.value());
     }
 
@@ -66,17 +92,17 @@ class ExecExprVisitor : public ExprVisitor {
     auto
     ExecRangeVisitorImpl(FieldId field_id,
                          IndexFunc func,
-                         ElementFunc element_func) -> BitsetType;
+                         ElementFunc element_func) -> CompressedBitset;
 
-    template <typename T, typename IndexFunc, typename ElementFunc>
+    template <typename T, typename ElementFunc>
     auto
-    ExecDataRangeVisitorImpl(FieldId field_id,
-                             IndexFunc index_func,
-                             ElementFunc element_func) -> BitsetType;
+    ExecDataRangeVisitorImpl(FieldId field_id, ElementFunc element_func)
+        -> BitsetType;
 
     template <typename T>
     auto
-    ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw) -> BitsetType;
+    ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw)
+        -> CompressedBitset;
 
     template <typename T>
     auto
@@ -85,26 +111,69 @@ class ExecExprVisitor : public ExprVisitor {
 
     template <typename T>
     auto
-    ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw) -> BitsetType;
+    ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw)
+        -> CompressedBitset;
 
     template <typename T>
     auto
-    ExecTermVisitorImpl(TermExpr& expr_raw) -> BitsetType;
+    ExecTermVisitorImpl(TermExpr& expr_raw) -> CompressedBitset;
 
     template <typename T>
     auto
-    ExecTermVisitorImplTemplate(TermExpr& expr_raw) -> BitsetType;
+    ExecTermVisitorImplTemplate(TermExpr& expr_raw) -> CompressedBitset;
+
+    // the rows holding one of the keys of the partition key field, from the
+    // rows the segment keeps per key; nullopt if it keeps none
+    template <typename K>
+    auto
+    PartitionKeyRows(FieldId field_id, const std::vector<K>& keys)
+        -> std::optional<CompressedBitset>;
 
     template <typename CmpFunc>
     auto
     ExecCompareExprDispatcher(CompareExpr& expr, CmpFunc cmp_func)
         -> BitsetType;
 
+    // the leaf bound for a parameterized expr
+    Expr&
+    BoundExpr(const Expr& expr);
+
+    // records the evaluation of expr started at start
+    void
+    ProfileExpr(const Expr& expr,
+                const CompressedBitset& res,
+                std::chrono::steady_clock::time_point start);
+
+    CompressedBitset
+    Combine(LogicalBinaryExpr::OpType op,
+            CompressedBitset left,
+            const CompressedBitset& right);
+
+    // a rough cost of evaluating expr on the segment, to evaluate the
+    // cheaper side of an AND/OR first
+    int64_t
+    EvalCost(const Expr& expr) const;
+
+    // an AND tree of range leaves on raw numeric data in one pass over
+    // the rows, nullopt if the tree or the segment does not allow it
+    auto
+    ExecFusedConjunction(const LogicalBinaryExpr& expr)
+        -> std::optional<CompressedBitset>;
+
  private:
     const segcore::SegmentInternalInterface& segment_;
     Timestamp timestamp_;
     int64_t row_count_;
-
-    BitsetTypeOpt bitset_opt_;
+    const ExprBindings* bindings_;
+    QueryProfile* profile_;
+    const CancelToken* cancel_token_;
+    // nesting of the expr being evaluated
+    int64_t depth_ = 0;
+
+    std::optional<CompressedBitset> bitset_opt_;
+    // rows the current subtree has to be exact on, the others may hold
+    // any value since the enclosing AND/OR already decided them,
+    // nullptr means all rows
+    const BitsetType* candidate_ = nullptr;
 };
 }  // namespace milvus::query
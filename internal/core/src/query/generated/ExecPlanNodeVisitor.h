@@ -14,6 +14,7 @@
 // DO NOT EDIT
 #include "utils/Json.h"
 #include "query/PlanImpl.h"
+#include "query/QueryScheduler.h"
 #include "segcore/SegmentGrowing.h"
 #include <utility>
 #include "PlanNodeVisitor.h"
@@ -27,24 +28,58 @@ class ExecPlanNodeVisitor : public PlanNodeVisitor {
     void
     visit(BinaryVectorANNS& node) override;
 
+    void
+    visit(SparseFloatVectorANNS& node) override;
+
+    void
+    visit(MultiVectorANNS& node) override;
+
     void
     visit(RetrievePlanNode& node) override;
 
  public:
     ExecPlanNodeVisitor(const segcore::SegmentInterface& segment,
                         Timestamp timestamp,
-                        const PlaceholderGroup* placeholder_group)
+                        const PlaceholderGroup* placeholder_group,
+                        const ExprBindings* bindings = nullptr)
         : segment_(segment),
           timestamp_(timestamp),
-          placeholder_group_(placeholder_group) {
+          placeholder_group_(placeholder_group),
+          bindings_(bindings) {
     }
 
     ExecPlanNodeVisitor(const segcore::SegmentInterface& segment,
-                        Timestamp timestamp)
-        : segment_(segment), timestamp_(timestamp) {
+                        Timestamp timestamp,
+                        const ExprBindings* bindings = nullptr)
+        : segment_(segment), timestamp_(timestamp), bindings_(bindings) {
         placeholder_group_ = nullptr;
     }
 
+    // collect the profile of the searches into profile, unless null
+    void
+    set_profile(QueryProfile* profile) {
+        profile_ = profile;
+    }
+
+    // stop the execution once token is, unless null
+    void
+    set_cancel_token(const CancelToken* token) {
+        cancel_token_ = token;
+    }
+
+    // queue the vector searches as work of tenant, of weight
+    void
+    set_tenant(const std::string& tenant, int64_t weight) {
+        tenant_ = tenant;
+        tenant_weight_ = weight;
+    }
+
+    // narrow the radius of a range search to bound, unless null
+    void
+    set_search_bound(const RangeSearchBound* bound) {
+        search_bound_ = bound;
+    }
+
     SearchResult
     get_moved_result(PlanNode& node) {
         assert(!search_result_opt_.has_value());
@@ -56,10 +91,22 @@ class ExecPlanNodeVisitor : public PlanNodeVisitor {
         return ret;
     }
 
+    // rows a search of node at timestamp skips: the rows failing its
+    // predicate, the deleted ones and the ones newer than timestamp;
+    // skips_all is set to whether that is every row
+    static BitsetType
+    ExecSearchFilter(const segcore::SegmentInternalInterface& segment,
+                     const VectorPlanNode& node,
+                     int64_t active_count,
+                     Timestamp timestamp,
+                     bool& skips_all,
+                     const ExprBindings* bindings = nullptr,
+                     QueryProfile* profile = nullptr,
+                     const CancelToken* cancel_token = nullptr);
+
     RetrieveResult
     get_retrieve_result(PlanNode& node) {
         assert(!retrieve_result_opt_.has_value());
-        std::cout.flush();
         node.accept(*this);
         assert(retrieve_result_opt_.has_value());
         auto ret = std::move(retrieve_result_opt_).value();
@@ -73,10 +120,20 @@ class ExecPlanNodeVisitor : public PlanNodeVisitor {
     void
     VectorVisitorImpl(VectorPlanNode& node);
 
+    // a slot of the query scheduler for a search of num_queries
+    QueryScheduler::Ticket
+    AcquireTicket(int64_t num_queries);
+
  private:
     const segcore::SegmentInterface& segment_;
     Timestamp timestamp_;
     const PlaceholderGroup* placeholder_group_;
+    const ExprBindings* bindings_;
+    QueryProfile* profile_ = nullptr;
+    const RangeSearchBound* search_bound_ = nullptr;
+    const CancelToken* cancel_token_ = nullptr;
+    std::string tenant_;
+    int64_t tenant_weight_ = 1;
 
     SearchResultOpt search_result_opt_;
     RetrieveResultOpt retrieve_result_opt_;
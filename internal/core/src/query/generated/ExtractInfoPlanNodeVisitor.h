@@ -24,6 +24,12 @@ class ExtractInfoPlanNodeVisitor : public PlanNodeVisitor {
     void
     visit(BinaryVectorANNS& node) override;
 
+    void
+    visit(SparseFloatVectorANNS& node) override;
+
+    void
+    visit(MultiVectorANNS& node) override;
+
     void
     visit(RetrievePlanNode& node) override;
 
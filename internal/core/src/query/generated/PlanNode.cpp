@@ -25,6 +25,16 @@ BinaryVectorANNS::accept(PlanNodeVisitor& visitor) {
     visitor.visit(*this);
 }
 
+void
+SparseFloatVectorANNS::accept(PlanNodeVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+void
+MultiVectorANNS::accept(PlanNodeVisitor& visitor) {
+    visitor.visit(*this);
+}
+
 void
 RetrievePlanNode::accept(PlanNodeVisitor& visitor) {
     visitor.visit(*this);
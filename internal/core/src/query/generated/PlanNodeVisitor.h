@@ -25,6 +25,12 @@ class PlanNodeVisitor {
     virtual void
     visit(BinaryVectorANNS&) = 0;
 
+    virtual void
+    visit(SparseFloatVectorANNS&) = 0;
+
+    virtual void
+    visit(MultiVectorANNS&) = 0;
+
     virtual void
     visit(RetrievePlanNode&) = 0;
 };
@@ -28,6 +28,12 @@ class ShowPlanNodeVisitor : public PlanNodeVisitor {
     void
     visit(BinaryVectorANNS& node) override;
 
+    void
+    visit(SparseFloatVectorANNS& node) override;
+
+    void
+    visit(MultiVectorANNS& node) override;
+
     void
     visit(RetrievePlanNode& node) override;
 
@@ -27,6 +27,12 @@ class VerifyPlanNodeVisitor : public PlanNodeVisitor {
     void
     visit(BinaryVectorANNS& node) override;
 
+    void
+    visit(SparseFloatVectorANNS& node) override;
+
+    void
+    visit(MultiVectorANNS& node) override;
+
     void
     visit(RetrievePlanNode& node) override;
 
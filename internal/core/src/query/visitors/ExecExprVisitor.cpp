@@ -11,16 +11,28 @@
 
 #include "query/generated/ExecExprVisitor.h"
 
+#include <algorithm>
+#include <atomic>
 #include <boost/variant.hpp>
-#include <deque>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
 #include <optional>
-#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "common/ScratchArena.h"
 #include "query/ExprImpl.h"
 #include "query/Relational.h"
 #include "query/Utils.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/SegmentGrowingImpl.h"
+#include "simd/hook.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::query {
 // THIS CONTAINS EXTRA BODY FOR VISITOR
@@ -30,19 +42,41 @@ class ExecExprVisitor : ExprVisitor {
  public:
     ExecExprVisitor(const segcore::SegmentInternalInterface& segment,
                     int64_t row_count,
-                    Timestamp timestamp)
-        : segment_(segment), row_count_(row_count), timestamp_(timestamp) {
+                    Timestamp timestamp,
+                    const ExprBindings* bindings = nullptr,
+                    QueryProfile* profile = nullptr,
+                    const CancelToken* cancel_token = nullptr)
+        : segment_(segment),
+          row_count_(row_count),
+          timestamp_(timestamp),
+          bindings_(bindings),
+          profile_(profile),
+          cancel_token_(cancel_token) {
     }
 
     BitsetType
     call_child(Expr& expr) {
+        return call_child_compressed(expr).to_dense();
+    }
+
+    // the result in the container it was produced in, intermediate
+    // results stay compressed until call_child needs a bitmap
+    CompressedBitset
+    call_child_compressed(Expr& expr) {
         AssertInfo(!bitset_opt_.has_value(),
                    "[ExecExprVisitor]Bitset already has value before accept");
+        CheckCancel(cancel_token_);
+        auto start = std::chrono::steady_clock::now();
+        ++depth_;
         expr.accept(*this);
+        --depth_;
         AssertInfo(bitset_opt_.has_value(),
                    "[ExecExprVisitor]Bitset doesn't have value after accept");
         auto res = std::move(bitset_opt_);
         bitset_opt_ = std::nullopt;
+        if (profile_ != nullptr) {
+            ProfileExpr(expr, res.value(), start);
+        }
         return std::move(res.value());
     }
 
@@ -51,11 +85,12 @@ class ExecExprVisitor : ExprVisitor {
     auto
     ExecRangeVisitorImpl(FieldId field_id,
                          IndexFunc func,
-                         ElementFunc element_func) -> BitsetType;
+                         ElementFunc element_func) -> CompressedBitset;
 
     template <typename T>
     auto
-    ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw) -> BitsetType;
+    ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw)
+        -> CompressedBitset;
 
     template <typename T>
     auto
@@ -64,34 +99,76 @@ class ExecExprVisitor : ExprVisitor {
 
     template <typename T>
     auto
-    ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw) -> BitsetType;
+    ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw)
+        -> CompressedBitset;
 
     template <typename T>
     auto
-    ExecTermVisitorImpl(TermExpr& expr_raw) -> BitsetType;
+    ExecTermVisitorImpl(TermExpr& expr_raw) -> CompressedBitset;
 
     template <typename T>
     auto
-    ExecTermVisitorImplTemplate(TermExpr& expr_raw) -> BitsetType;
+    ExecTermVisitorImplTemplate(TermExpr& expr_raw) -> CompressedBitset;
+
+    // the rows holding one of the keys of the partition key field, from the
+    // rows the segment keeps per key; nullopt if it keeps none
+    template <typename K>
+    auto
+    PartitionKeyRows(FieldId field_id, const std::vector<K>& keys)
+        -> std::optional<CompressedBitset>;
 
     template <typename CmpFunc>
     auto
     ExecCompareExprDispatcher(CompareExpr& expr, CmpFunc cmp_func)
         -> BitsetType;
 
+    // the leaf bound for a parameterized expr
+    Expr&
+    BoundExpr(const Expr& expr);
+
+    // records the evaluation of expr started at start
+    void
+    ProfileExpr(const Expr& expr,
+                const CompressedBitset& res,
+                std::chrono::steady_clock::time_point start);
+
+    CompressedBitset
+    Combine(LogicalBinaryExpr::OpType op,
+            CompressedBitset left,
+            const CompressedBitset& right);
+
+    // a rough cost of evaluating expr on the segment, to evaluate the
+    // cheaper side of an AND/OR first
+    int64_t
+    EvalCost(const Expr& expr) const;
+
+    // an AND tree of range leaves on raw numeric data in one pass over
+    // the rows, nullopt if the tree or the segment does not allow it
+    auto
+    ExecFusedConjunction(const LogicalBinaryExpr& expr)
+        -> std::optional<CompressedBitset>;
+
  private:
     const segcore::SegmentInternalInterface& segment_;
     int64_t row_count_;
     Timestamp timestamp_;
-    BitsetTypeOpt bitset_opt_;
+    const ExprBindings* bindings_;
+    QueryProfile* profile_;
+    const CancelToken* cancel_token_;
+    // nesting of the expr being evaluated
+    int64_t depth_ = 0;
+    std::optional<CompressedBitset> bitset_opt_;
+    // rows the current subtree has to be exact on, the others may hold
+    // any value since the enclosing AND/OR already decided them,
+    // nullptr means all rows
+    const BitsetType* candidate_ = nullptr;
 };
 }  // namespace impl
 
 void
 ExecExprVisitor::visit(LogicalUnaryExpr& expr) {
     using OpType = LogicalUnaryExpr::OpType;
-    auto child_res = call_child(*expr.child_);
-    BitsetType res = std::move(child_res);
+    auto res = call_child_compressed(*expr.child_);
     switch (expr.op_type_) {
         case OpType::LogicalNot: {
             res.flip();
@@ -109,12 +186,122 @@ ExecExprVisitor::visit(LogicalUnaryExpr& expr) {
 void
 ExecExprVisitor::visit(LogicalBinaryExpr& expr) {
     using OpType = LogicalBinaryExpr::OpType;
-    auto left = call_child(*expr.left_);
-    auto right = call_child(*expr.right_);
+    if (expr.op_type_ == OpType::LogicalAnd &&
+        segcore::SegcoreConfig::default_config().get_fused_filters()) {
+        auto fused = ExecFusedConjunction(expr);
+        if (fused.has_value()) {
+            bitset_opt_ = std::move(fused.value());
+            return;
+        }
+    }
+    auto short_circuit = expr.op_type_ == OpType::LogicalAnd ||
+                         expr.op_type_ == OpType::LogicalOr;
+    if (!short_circuit) {
+        auto left = call_child_compressed(*expr.left_);
+        auto right = call_child_compressed(*expr.right_);
+        bitset_opt_ = Combine(expr.op_type_, std::move(left), right);
+        return;
+    }
+
+    // AND and OR commute, the cheaper side runs over all the candidates
+    // and the other one only over those it leaves undecided
+    auto* first = expr.left_.get();
+    auto* second = expr.right_.get();
+    if (EvalCost(*second) < EvalCost(*first)) {
+        std::swap(first, second);
+    }
+    auto left = call_child_compressed(*first);
+    BitsetType candidate = left.to_dense();
+    if (expr.op_type_ == OpType::LogicalOr) {
+        candidate.flip();
+    }
+    if (candidate_ != nullptr) {
+        candidate &= *candidate_;
+    }
+    if (candidate.none()) {
+        AssertInfo(left.size() == row_count_,
+                   "[ExecExprVisitor]Size of results not equal row count");
+        bitset_opt_ = std::move(left);
+        return;
+    }
+    auto outer_candidate = std::exchange(candidate_, &candidate);
+    auto right = call_child_compressed(*second);
+    candidate_ = outer_candidate;
+    bitset_opt_ = Combine(expr.op_type_, std::move(left), right);
+}
+
+Expr&
+ExecExprVisitor::BoundExpr(const Expr& expr) {
+    AssertInfo(bindings_ != nullptr, "parameters of the plan are not bound");
+    auto iter = bindings_->exprs_.find(&expr);
+    AssertInfo(iter != bindings_->exprs_.end(),
+               "parameters of the plan are bound for another plan");
+    return *iter->second;
+}
+
+static std::string
+ExprName(const Expr& expr) {
+    auto field = [](FieldId field_id) {
+        return "(" + std::to_string(field_id.get()) + ")";
+    };
+    if (dynamic_cast<const LogicalUnaryExpr*>(&expr) != nullptr) {
+        return "Not";
+    }
+    if (auto binary = dynamic_cast<const LogicalBinaryExpr*>(&expr)) {
+        switch (binary->op_type_) {
+            case LogicalBinaryExpr::OpType::LogicalAnd:
+                return "And";
+            case LogicalBinaryExpr::OpType::LogicalOr:
+                return "Or";
+            case LogicalBinaryExpr::OpType::LogicalXor:
+                return "Xor";
+            default:
+                return "Minus";
+        }
+    }
+    if (auto term = dynamic_cast<const TermExpr*>(&expr)) {
+        return "Term" + field(term->field_id_);
+    }
+    if (auto range = dynamic_cast<const UnaryRangeExpr*>(&expr)) {
+        return "UnaryRange" + field(range->field_id_);
+    }
+    if (auto range = dynamic_cast<const BinaryRangeExpr*>(&expr)) {
+        return "BinaryRange" + field(range->field_id_);
+    }
+    if (auto range = dynamic_cast<const BinaryArithOpEvalRangeExpr*>(&expr)) {
+        return "BinaryArithOpEvalRange" + field(range->field_id_);
+    }
+    if (auto compare = dynamic_cast<const CompareExpr*>(&expr)) {
+        return "Compare(" + std::to_string(compare->left_field_id_.get()) +
+               ", " + std::to_string(compare->right_field_id_.get()) + ")";
+    }
+    return "Expr";
+}
+
+void
+ExecExprVisitor::ProfileExpr(const Expr& expr,
+                             const CompressedBitset& res,
+                             std::chrono::steady_clock::time_point start) {
+    QueryProfile::ExprNode node;
+    node.name_ = ExprName(expr);
+    node.depth_ = depth_;
+    node.nanos_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    node.rows_ = candidate_ == nullptr ? row_count_ : candidate_->count();
+    node.matched_rows_ = res.count();
+    profile_->exprs_.push_back(std::move(node));
+}
+
+CompressedBitset
+ExecExprVisitor::Combine(LogicalBinaryExpr::OpType op,
+                         CompressedBitset left,
+                         const CompressedBitset& right) {
+    using OpType = LogicalBinaryExpr::OpType;
     AssertInfo(left.size() == right.size(),
                "[ExecExprVisitor]Left size not equal to right size");
     auto res = std::move(left);
-    switch (expr.op_type_) {
+    switch (op) {
         case OpType::LogicalAnd: {
             res &= right;
             break;
@@ -137,79 +324,839 @@ ExecExprVisitor::visit(LogicalBinaryExpr& expr) {
     }
     AssertInfo(res.size() == row_count_,
                "[ExecExprVisitor]Size of results not equal row count");
-    bitset_opt_ = std::move(res);
+    return res;
 }
 
-static auto
-Assemble(const std::deque<BitsetType>& srcs) -> BitsetType {
-    BitsetType res;
+int64_t
+ExecExprVisitor::EvalCost(const Expr& expr) const {
+    if (auto unary = dynamic_cast<const LogicalUnaryExpr*>(&expr)) {
+        return EvalCost(*unary->child_);
+    }
+    if (auto binary = dynamic_cast<const LogicalBinaryExpr*>(&expr)) {
+        return EvalCost(*binary->left_) + EvalCost(*binary->right_);
+    }
+    if (dynamic_cast<const CompareExpr*>(&expr) != nullptr) {
+        // two columns of raw data
+        return 8;
+    }
+    // a leaf on one field: an index, then the raw data of a fixed width
+    // type, then strings; the primary key resolves terms by its pk index
+    auto leaf = [&](FieldId field_id, DataType data_type) -> int64_t {
+        if (segment_.num_chunk_index(field_id) > 0) {
+            return 1;
+        }
+        return datatype_is_variable(data_type) ? 4 : 2;
+    };
+    if (auto term = dynamic_cast<const TermExpr*>(&expr)) {
+        auto pk_field_id = segment_.get_schema().get_primary_field_id();
+        if (pk_field_id.has_value() &&
+            pk_field_id.value() == term->field_id_) {
+            return 1;
+        }
+        return leaf(term->field_id_, term->data_type_);
+    }
+    if (auto range = dynamic_cast<const UnaryRangeExpr*>(&expr)) {
+        return leaf(range->field_id_, range->data_type_);
+    }
+    if (auto range = dynamic_cast<const BinaryRangeExpr*>(&expr)) {
+        return leaf(range->field_id_, range->data_type_);
+    }
+    if (auto range = dynamic_cast<const BinaryArithOpEvalRangeExpr*>(&expr)) {
+        // arithmetic on every row
+        return leaf(range->field_id_, range->data_type_) + 2;
+    }
+    return 8;
+}
+
+using BitsetBlock = BitsetType::block_type;
+using segcore::FieldAccess;
+constexpr int64_t BITS_PER_BLOCK = BitsetType::bits_per_block;
+static_assert(sizeof(BitsetBlock) == sizeof(simd::BlockType),
+              "simd kernels must share the block layout of BitsetType");
+
+// OR `word` into `blocks` starting at bit `pos`,
+// the word is split across two blocks when `pos` is not block aligned
+static inline void
+merge_block(BitsetBlock* blocks,
+            int64_t num_blocks,
+            int64_t pos,
+            BitsetBlock word) {
+    auto block_id = pos / BITS_PER_BLOCK;
+    auto shift = pos % BITS_PER_BLOCK;
+    if (shift == 0) {
+        blocks[block_id] |= word;
+        return;
+    }
+    blocks[block_id] |= word << shift;
+    auto high = word >> (BITS_PER_BLOCK - shift);
+    if (high != 0 && block_id + 1 < num_blocks) {
+        blocks[block_id + 1] |= high;
+    }
+}
 
-    int64_t total_size = 0;
-    for (auto& chunk : srcs) {
-        total_size += chunk.size();
+// the block of `blocks` starting at bit `pos`, the inverse of merge_block
+static inline BitsetBlock
+extract_block(const BitsetBlock* blocks, int64_t num_blocks, int64_t pos) {
+    auto block_id = pos / BITS_PER_BLOCK;
+    auto shift = pos % BITS_PER_BLOCK;
+    if (shift == 0) {
+        return blocks[block_id];
     }
-    res.resize(total_size);
+    auto word = blocks[block_id] >> shift;
+    if (block_id + 1 < num_blocks) {
+        word |= blocks[block_id + 1] << (BITS_PER_BLOCK - shift);
+    }
+    return word;
+}
+
+// whether any row in [offset, offset + size) is a candidate,
+// a null `candidate` selects every row
+static bool
+AnyCandidate(const BitsetType* candidate, int64_t offset, int64_t size) {
+    if (candidate == nullptr) {
+        return true;
+    }
+    auto pos = offset == 0 ? candidate->find_first()
+                           : candidate->find_next(offset - 1);
+    return pos != BitsetType::npos && pos < offset + size;
+}
 
-    int64_t counter = 0;
-    for (auto& chunk : srcs) {
-        for (int64_t i = 0; i < chunk.size(); ++i) {
-            res[counter + i] = chunk[i];
+// copy a chunk result into the pre-sized `dst` at bit `offset`, whole blocks
+// at a time instead of bit by bit. `dst` must be zero in [offset, offset + src.size())
+static void
+AssembleAt(BitsetType& dst, int64_t offset, const BitsetType& src) {
+    if (src.empty()) {
+        return;
+    }
+    AssertInfo(offset + src.size() <= dst.size(),
+               "[ExecExprVisitor]Chunk result out of range of final result");
+    auto dst_blocks = dst.data();
+    auto src_blocks = src.data();
+    auto num_blocks = dst.num_blocks();
+    if (offset % BITS_PER_BLOCK == 0) {
+        std::copy_n(src_blocks,
+                    src.num_blocks(),
+                    dst_blocks + offset / BITS_PER_BLOCK);
+        return;
+    }
+    for (int64_t i = 0; i < src.num_blocks(); ++i) {
+        merge_block(
+            dst_blocks, num_blocks, offset + i * BITS_PER_BLOCK, src_blocks[i]);
+    }
+}
+
+static void
+AssembleAt(BitsetType& dst, int64_t offset, const CompressedBitset& src) {
+    if (src.container() == CompressedBitset::Container::Dense) {
+        AssembleAt(dst, offset, src.dense());
+        return;
+    }
+    AssertInfo(offset + src.size() <= dst.size(),
+               "[ExecExprVisitor]Chunk result out of range of final result");
+    src.for_each_run([&](size_t begin, size_t end) {
+        dst.set(offset + begin, end - begin, true);
+    });
+}
+
+// evaluate `func(i)` for i in [0, size) and write the results into the
+// pre-sized `dst` at bit `offset`, packing a block of results before storing.
+// blocks without any `candidate` row are skipped and left zero
+template <typename Func>
+static void
+FillAt(BitsetType& dst,
+       int64_t offset,
+       int64_t size,
+       const BitsetType* candidate,
+       Func func) {
+    if (size == 0) {
+        return;
+    }
+    AssertInfo(offset + size <= dst.size(),
+               "[ExecExprVisitor]Chunk result out of range of final result");
+    auto dst_blocks = dst.data();
+    auto num_blocks = dst.num_blocks();
+    const BitsetBlock* candidate_blocks = nullptr;
+    if (candidate != nullptr) {
+        AssertInfo(candidate->size() == dst.size(),
+                   "[ExecExprVisitor]Candidate size not equal row count");
+        candidate_blocks = candidate->data();
+    }
+    for (int64_t begin = 0; begin < size; begin += BITS_PER_BLOCK) {
+        if (candidate_blocks != nullptr &&
+            extract_block(candidate_blocks, num_blocks, offset + begin) == 0) {
+            continue;
+        }
+        auto end = std::min(begin + BITS_PER_BLOCK, size);
+        BitsetBlock word = 0;
+        for (auto i = begin; i < end; ++i) {
+            word |= BitsetBlock(func(i)) << (i - begin);
         }
-        counter += chunk.size();
+        merge_block(dst_blocks, num_blocks, offset + begin, word);
     }
-    return res;
+}
+
+// let `func` write the packed results of a whole chunk into the pre-sized
+// `dst` at bit `offset`, in place when the chunk starts on a block boundary.
+// returns false and leaves `dst` untouched when `func` declines the chunk
+template <typename Func>
+static bool
+EvalChunkAt(BitsetType& dst, int64_t offset, int64_t size, Func func) {
+    if (size == 0) {
+        return true;
+    }
+    AssertInfo(offset + size <= dst.size(),
+               "[ExecExprVisitor]Chunk result out of range of final result");
+    auto dst_blocks = dst.data();
+    auto num_blocks = dst.num_blocks();
+    if (offset % BITS_PER_BLOCK == 0) {
+        return func(dst_blocks + offset / BITS_PER_BLOCK);
+    }
+    ScratchVector<BitsetBlock> blocks(upper_div(size, BITS_PER_BLOCK));
+    if (!func(blocks.data())) {
+        return false;
+    }
+    for (int64_t i = 0; i < blocks.size(); ++i) {
+        merge_block(
+            dst_blocks, num_blocks, offset + i * BITS_PER_BLOCK, blocks[i]);
+    }
+    return true;
+}
+
+// rows of a chunk evaluated by one thread at a time, small enough for the
+// values to stay in cache and a multiple of the sealed zone size
+constexpr int64_t MORSEL_ROWS = 64 * 1024;
+static_assert(MORSEL_ROWS % segcore::SEALED_ZONE_ROWS == 0);
+
+// run `func(begin, end)` over [0, size) of a chunk placed at bit `offset`
+// of the result. chunks of at least `expr_parallel_rows` rows are split
+// into morsels shared by the calling thread and helpers on the common
+// pool, each morsel writing its own blocks of the result; the caller
+// claims morsels too, so a busy pool costs parallelism but never progress
+template <typename Func>
+static void
+ForEachMorsel(int64_t offset, int64_t size, Func&& func) {
+    auto& config = segcore::SegcoreConfig::default_config();
+    auto num_morsels = upper_div(size, MORSEL_ROWS);
+    auto num_helpers = std::min<int64_t>(num_morsels - 1, cpu_num - 1);
+    if (size < config.get_expr_parallel_rows() || num_helpers <= 0 ||
+        offset % BITS_PER_BLOCK != 0) {
+        func(0, size);
+        return;
+    }
+
+    ParallelFor(num_morsels, num_helpers, [size, &func](int64_t id) {
+        auto begin = id * MORSEL_ROWS;
+        func(begin, std::min(begin + MORSEL_ROWS, size));
+    });
+}
+
+template <simd::CompareOp op, typename T, typename U>
+static inline bool
+Compare(const T& x, const U& val) {
+    if constexpr (op == simd::CompareOp::Equal) {
+        return x == val;
+    } else if constexpr (op == simd::CompareOp::NotEqual) {
+        return x != val;
+    } else if constexpr (op == simd::CompareOp::GreaterThan) {
+        return x > val;
+    } else if constexpr (op == simd::CompareOp::GreaterEqual) {
+        return x >= val;
+    } else if constexpr (op == simd::CompareOp::LessThan) {
+        return x < val;
+    } else {
+        return x <= val;
+    }
+}
+
+// how a predicate holds over the rows of a zone
+enum class ZoneMatch { None, All, Some };
+
+// whether `op` holds for every row / no row with a value in [min, max],
+// the comparisons against a single value other than (in)equality are
+// monotone, so evaluating them at both ends of the zone is enough
+template <simd::CompareOp op, typename T, typename U>
+static ZoneMatch
+MatchZone(const segcore::Zone<T>& zone, const U& val) {
+    if (!zone.valid) {
+        return ZoneMatch::Some;
+    }
+    if constexpr (op == simd::CompareOp::Equal ||
+                  op == simd::CompareOp::NotEqual) {
+        auto miss = val < zone.min || val > zone.max;
+        auto hit = zone.min == val && zone.max == val;
+        if (miss || hit) {
+            auto all = op == simd::CompareOp::Equal ? hit : miss;
+            return all ? ZoneMatch::All : ZoneMatch::None;
+        }
+        return ZoneMatch::Some;
+    } else {
+        auto at_min = Compare<op>(zone.min, val);
+        auto at_max = Compare<op>(zone.max, val);
+        if (at_min && at_max) {
+            return ZoneMatch::All;
+        }
+        if (!at_min && !at_max) {
+            return ZoneMatch::None;
+        }
+        return ZoneMatch::Some;
+    }
+}
+
+// whether `func` can tell a zone apart without touching its rows
+template <typename Func, typename T, typename = void>
+struct HasZoneFunc : std::false_type {};
+
+template <typename Func, typename T>
+struct HasZoneFunc<Func,
+                   T,
+                   std::void_t<decltype(std::declval<const Func&>().zone(
+                       std::declval<const segcore::Zone<T>&>()))>>
+    : std::true_type {};
+
+// element func of `x op val`, arithmetic types also get a whole-chunk
+// overload backed by the simd kernels
+template <simd::CompareOp op, typename T, typename U>
+struct CompareValFunc {
+    U val;
+
+    bool
+    operator()(const T& x) const {
+        return Compare<op>(x, val);
+    }
+
+    ZoneMatch
+    zone(const segcore::Zone<T>& zone) const {
+        return MatchZone<op>(zone, val);
+    }
+
+    template <typename W = T,
+              typename = std::enable_if_t<simd::IsVectorizable<W> ||
+                                          std::is_same_v<W, bool>>>
+    bool
+    operator()(const T* src, int64_t size, BitsetBlock* dst) const {
+        auto blocks = reinterpret_cast<simd::BlockType*>(dst);
+        if constexpr (std::is_same_v<T, bool>) {
+            // a bool is stored as a byte holding 0 or 1
+            simd::CompareVal<int8_t>(reinterpret_cast<const int8_t*>(src),
+                                     size,
+                                     int8_t(val),
+                                     op,
+                                     blocks);
+        } else {
+            simd::CompareVal<T>(src, size, val, op, blocks);
+        }
+        return true;
+    }
+
+    template <typename W = T,
+              typename = std::enable_if_t<std::is_same_v<W, std::string_view>>>
+    bool
+    operator()(Span<std::string_view>::Rows rows,
+               int64_t size,
+               BitsetBlock* dst) const {
+        rows.VisitOffsets([&](const char* data, auto offsets) {
+            simd::CompareStrings(data,
+                                 offsets,
+                                 size,
+                                 std::string_view(val),
+                                 op,
+                                 reinterpret_cast<simd::BlockType*>(dst));
+        });
+        return true;
+    }
+};
+
+// element func of `x starts with prefix`, raw string rows are matched by
+// the batch kernel
+template <typename T>
+struct PrefixMatchFunc {
+    std::string prefix;
+
+    bool
+    operator()(const T& x) const {
+        return milvus::PrefixMatch(x, prefix);
+    }
+
+    template <typename W = T,
+              typename = std::enable_if_t<std::is_same_v<W, std::string_view>>>
+    bool
+    operator()(Span<std::string_view>::Rows rows,
+               int64_t size,
+               BitsetBlock* dst) const {
+        rows.VisitOffsets([&](const char* data, auto offsets) {
+            simd::PrefixMatch(data,
+                              offsets,
+                              size,
+                              prefix,
+                              reinterpret_cast<simd::BlockType*>(dst));
+        });
+        return true;
+    }
+};
+
+// element func of `lower < x < upper`, inclusiveness per bound
+template <bool lower_inclusive, bool upper_inclusive, typename T, typename U>
+struct CompareRangeFunc {
+    U lower;
+    U upper;
+
+    bool
+    operator()(const T& x) const {
+        constexpr auto lower_op = lower_inclusive
+                                      ? simd::CompareOp::GreaterEqual
+                                      : simd::CompareOp::GreaterThan;
+        constexpr auto upper_op = upper_inclusive ? simd::CompareOp::LessEqual
+                                                  : simd::CompareOp::LessThan;
+        return Compare<lower_op>(x, lower) && Compare<upper_op>(x, upper);
+    }
+
+    // the range is convex: all rows match iff both ends do, and no row
+    // matches iff the zone lies beside the range
+    ZoneMatch
+    zone(const segcore::Zone<T>& zone) const {
+        if (!zone.valid) {
+            return ZoneMatch::Some;
+        }
+        if ((*this)(zone.min) && (*this)(zone.max)) {
+            return ZoneMatch::All;
+        }
+        auto above = upper_inclusive ? zone.min > upper : zone.min >= upper;
+        auto below = lower_inclusive ? zone.max < lower : zone.max <= lower;
+        if (above || below || !(lower <= upper)) {
+            return ZoneMatch::None;
+        }
+        return ZoneMatch::Some;
+    }
+
+    template <typename W = T,
+              typename = std::enable_if_t<simd::IsVectorizable<W>>>
+    bool
+    operator()(const T* src, int64_t size, BitsetBlock* dst) const {
+        simd::CompareRange<T>(src,
+                              size,
+                              lower,
+                              upper,
+                              lower_inclusive,
+                              upper_inclusive,
+                              reinterpret_cast<simd::BlockType*>(dst));
+        return true;
+    }
+};
+
+// element func of `x in terms`, a short term list on an arithmetic type
+// evaluates a whole chunk with one simd pass per term
+template <typename T, typename U>
+struct TermFunc {
+    const TermSet<U>& term_set;
+
+    bool
+    operator()(const T& x) const {
+        return term_set.contains(x);
+    }
+
+    ZoneMatch
+    zone(const segcore::Zone<T>& zone) const {
+        if (!zone.valid) {
+            return ZoneMatch::Some;
+        }
+        auto& terms = term_set.terms();
+        auto it = std::lower_bound(terms.begin(), terms.end(), zone.min);
+        if (it == terms.end() || *it > zone.max) {
+            return ZoneMatch::None;
+        }
+        if (zone.min == zone.max) {
+            return ZoneMatch::All;
+        }
+        return ZoneMatch::Some;
+    }
+
+    template <typename W = T,
+              typename = std::enable_if_t<simd::IsVectorizable<W>>>
+    bool
+    operator()(const T* src, int64_t size, BitsetBlock* dst) const {
+        if (term_set.layout() != TermSet<U>::Layout::Linear) {
+            return false;
+        }
+        auto num_blocks = upper_div(size, BITS_PER_BLOCK);
+        std::fill_n(dst, num_blocks, 0);
+        ScratchVector<BitsetBlock> hits(num_blocks);
+        auto hit_blocks = reinterpret_cast<simd::BlockType*>(hits.data());
+        for (auto term : term_set.terms()) {
+            simd::CompareVal<T>(
+                src, size, term, simd::CompareOp::Equal, hit_blocks);
+            for (int64_t i = 0; i < num_blocks; ++i) {
+                dst[i] |= hits[i];
+            }
+        }
+        return true;
+    }
+};
+
+template <ArithOpType op>
+using ArithTag = std::integral_constant<ArithOpType, op>;
+
+template <simd::CompareOp op>
+using CmpTag = std::integral_constant<simd::CompareOp, op>;
+
+// `x op operand` with the usual arithmetic conversions, so narrow
+// integers do not wrap before the comparison
+template <ArithOpType op, typename T>
+static inline auto
+Arith(T x, T operand) {
+    if constexpr (op == ArithOpType::Add) {
+        return x + operand;
+    } else if constexpr (op == ArithOpType::Sub) {
+        return x - operand;
+    } else if constexpr (op == ArithOpType::Mul) {
+        return x * operand;
+    } else if constexpr (op == ArithOpType::Div) {
+        return x / operand;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(std::fmod(x, operand));
+    } else {
+        return x % operand;
+    }
+}
+
+// bounds of `x op operand` for x in [min, max], false when the op is not
+// monotone or an integer bound overflows
+template <ArithOpType op, typename T, typename R>
+static bool
+ArithBounds(T min, T max, T operand, R& lower, R& upper) {
+    if constexpr (op == ArithOpType::Mod) {
+        return false;
+    } else if constexpr (std::is_integral_v<R>) {
+        if (op == ArithOpType::Div &&
+            (operand == 0 ||
+             (operand == -1 && min == std::numeric_limits<R>::min()))) {
+            return false;
+        }
+        if ((op == ArithOpType::Mul || op == ArithOpType::Div) &&
+            operand < 0) {
+            std::swap(min, max);
+        }
+        if constexpr (op == ArithOpType::Add) {
+            return !__builtin_add_overflow(R(min), R(operand), &lower) &&
+                   !__builtin_add_overflow(R(max), R(operand), &upper);
+        } else if constexpr (op == ArithOpType::Sub) {
+            return !__builtin_sub_overflow(R(min), R(operand), &lower) &&
+                   !__builtin_sub_overflow(R(max), R(operand), &upper);
+        } else if constexpr (op == ArithOpType::Mul) {
+            return !__builtin_mul_overflow(R(min), R(operand), &lower) &&
+                   !__builtin_mul_overflow(R(max), R(operand), &upper);
+        } else {
+            lower = R(min) / R(operand);
+            upper = R(max) / R(operand);
+            return true;
+        }
+    } else {
+        if (op == ArithOpType::Div && operand == 0) {
+            return false;
+        }
+        if ((op == ArithOpType::Mul || op == ArithOpType::Div) &&
+            operand < 0) {
+            std::swap(min, max);
+        }
+        lower = Arith<op>(min, operand);
+        upper = Arith<op>(max, operand);
+        return !std::isnan(lower) && !std::isnan(upper);
+    }
+}
+
+// element func of `(x arith_op operand) cmp_op val`, the chunk overload
+// computes the arithmetic for a batch of rows into a buffer the compiler
+// can vectorize and compares it with the simd kernels in one pass
+template <ArithOpType arith_op, simd::CompareOp cmp_op, typename T>
+struct ArithCompareFunc {
+    using ResultType = decltype(Arith<arith_op>(T(), T()));
+    static constexpr int64_t BATCH_ROWS = 1024;
+    static_assert(BATCH_ROWS % BITS_PER_BLOCK == 0);
+
+    T operand;
+    T val;
+
+    bool
+    operator()(const T& x) const {
+        return Compare<cmp_op>(Arith<arith_op>(x, operand), val);
+    }
+
+    template <typename W = T,
+              typename = std::enable_if_t<simd::IsVectorizable<W>>>
+    bool
+    operator()(const T* src, int64_t size, BitsetBlock* dst) const {
+        ResultType buffer[BATCH_ROWS];
+        for (int64_t begin = 0; begin < size; begin += BATCH_ROWS) {
+            auto count = std::min(BATCH_ROWS, size - begin);
+            for (int64_t i = 0; i < count; ++i) {
+                buffer[i] = Arith<arith_op>(src[begin + i], operand);
+            }
+            simd::CompareVal<ResultType>(
+                buffer,
+                count,
+                ResultType(val),
+                cmp_op,
+                reinterpret_cast<simd::BlockType*>(dst) +
+                    begin / BITS_PER_BLOCK);
+        }
+        return true;
+    }
+
+    ZoneMatch
+    zone(const segcore::Zone<T>& zone) const {
+        segcore::Zone<ResultType> result;
+        if (!zone.valid || !ArithBounds<arith_op>(zone.min,
+                                                  zone.max,
+                                                  operand,
+                                                  result.min,
+                                                  result.max)) {
+            return ZoneMatch::Some;
+        }
+        result.valid = true;
+        return MatchZone<cmp_op>(result, val);
+    }
+};
+
+// evaluate `element_func` over the `size` rows of a dictionary encoded
+// string chunk like EvalRawChunk. the function runs once per distinct
+// value, then the rows only compare their codes: a single run of matching
+// codes, what comparisons and prefixes give on the sorted dictionary, is
+// a simd range check and any other set of codes a table lookup
+template <typename ElementFunc>
+static void
+EvalDictionaryChunk(const segcore::EncodedColumn<std::string_view>& column,
+                    int64_t chunk_offset,
+                    int64_t size,
+                    const BitsetType* candidate,
+                    const ElementFunc& element_func,
+                    BitsetType& dst) {
+    auto dictionary_size = column.dictionary_size();
+    std::vector<uint8_t> matches(dictionary_size);
+    int64_t first = -1;
+    int64_t last = -1;
+    bool single_run = true;
+    for (int64_t code = 0; code < dictionary_size; ++code) {
+        matches[code] = element_func(column.dictionary(code));
+        if (matches[code]) {
+            single_run = single_run && (last == -1 || last == code - 1);
+            first = first == -1 ? code : first;
+            last = code;
+        }
+    }
+    if (first == -1) {
+        return;
+    }
+    column.VisitCodes([&](auto codes) {
+        using Code = std::remove_cv_t<std::remove_pointer_t<decltype(codes)>>;
+        ForEachMorsel(chunk_offset, size, [&](int64_t begin, int64_t end) {
+            if (!AnyCandidate(candidate, chunk_offset + begin, end - begin)) {
+                return;
+            }
+            auto rows = codes + begin;
+            if (single_run) {
+                EvalChunkAt(dst,
+                            chunk_offset + begin,
+                            end - begin,
+                            [&](BitsetBlock* blocks) {
+                                simd::CompareRange<Code>(
+                                    rows,
+                                    end - begin,
+                                    Code(first),
+                                    Code(last),
+                                    true,
+                                    true,
+                                    reinterpret_cast<simd::BlockType*>(blocks));
+                                return true;
+                            });
+                return;
+            }
+            FillAt(dst,
+                   chunk_offset + begin,
+                   end - begin,
+                   candidate,
+                   [rows, &matches](int64_t i) { return matches[rows[i]]; });
+        });
+    });
+}
+
+// evaluate `element_func` over the `size` raw rows of a chunk into `dst`
+// at bit `chunk_offset`, rows out of `candidate` may be left zero
+template <typename T, typename ElementFunc>
+static void
+EvalRawChunk(const segcore::SegmentInternalInterface& segment,
+             FieldId field_id,
+             int64_t chunk_id,
+             int64_t chunk_offset,
+             int64_t size,
+             const BitsetType* candidate,
+             const ElementFunc& element_func,
+             BitsetType& dst) {
+    // encoded chunks are decoded a morsel at a time, never as a whole
+    std::shared_ptr<const segcore::EncodedColumnBase> encoded;
+    if constexpr (segcore::IsEncodable<T>) {
+        encoded = segment.chunk_encoded<T>(field_id, chunk_id);
+    }
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        if (encoded != nullptr) {
+            EvalDictionaryChunk(
+                static_cast<const segcore::EncodedColumn<T>&>(*encoded),
+                chunk_offset,
+                size,
+                candidate,
+                element_func,
+                dst);
+            return;
+        }
+    }
+    // a const T*, or the offset based rows of a string_view span
+    using Rows = decltype(std::declval<Span<T>>().data());
+    std::optional<Rows> data;
+    if (encoded == nullptr) {
+        data = segment.chunk_data<T>(field_id, chunk_id).data();
+    }
+    // evaluate rows [begin, begin + count) of the chunk
+    auto eval_rows = [&](int64_t begin, int64_t count) {
+        auto rows = [&]() -> Rows {
+            if constexpr (segcore::IsEncodable<T> && std::is_arithmetic_v<T>) {
+                if (encoded != nullptr) {
+                    thread_local std::vector<T> decoded;
+                    decoded.resize(count);
+                    static_cast<const segcore::EncodedColumn<T>&>(*encoded)
+                        .Decode(begin, count, decoded.data());
+                    return decoded.data();
+                }
+            }
+            return *data + begin;
+        }();
+        if constexpr (std::is_invocable_v<ElementFunc,
+                                          Rows,
+                                          int64_t,
+                                          BitsetBlock*>) {
+            auto done = EvalChunkAt(
+                dst,
+                chunk_offset + begin,
+                count,
+                [rows, count, &element_func](BitsetBlock* blocks) {
+                    return element_func(rows, count, blocks);
+                });
+            if (done) {
+                return;
+            }
+        }
+        FillAt(dst,
+               chunk_offset + begin,
+               count,
+               candidate,
+               [rows, &element_func](int64_t index) {
+                   return element_func(rows[index]);
+               });
+    };
+    constexpr bool use_zone_map =
+        segcore::HasZoneMap<T> && HasZoneFunc<ElementFunc, T>::value;
+    std::shared_ptr<const segcore::ZoneMap<T>> zone_map;
+    if constexpr (use_zone_map) {
+        zone_map = segment.chunk_zone_map<T>(field_id, chunk_id);
+    }
+    // evaluate rows [begin, end) of the chunk, zones resolved from
+    // min/max are set without a scan and the rest merged into runs
+    auto eval_morsel = [&](int64_t begin, int64_t end) {
+        if (!AnyCandidate(candidate, chunk_offset + begin, end - begin)) {
+            return;
+        }
+        if constexpr (use_zone_map) {
+            if (zone_map != nullptr) {
+                auto zone_rows = zone_map->zone_rows;
+                auto pending = begin;
+                for (auto zone_id = begin / zone_rows;
+                     zone_id < zone_map->zones.size() &&
+                     zone_id * zone_rows < end;
+                     ++zone_id) {
+                    auto& zone = zone_map->zones[zone_id];
+                    auto zone_begin = std::max(zone_id * zone_rows, begin);
+                    auto zone_end = std::min((zone_id + 1) * zone_rows, end);
+                    auto match = element_func.zone(zone);
+                    if (match != ZoneMatch::Some) {
+                        eval_rows(pending, zone_begin - pending);
+                        pending = zone_end;
+                    }
+                    if (match == ZoneMatch::All) {
+                        dst.set(chunk_offset + zone_begin,
+                                zone_end - zone_begin,
+                                true);
+                    }
+                }
+                eval_rows(pending, end - pending);
+                return;
+            }
+        }
+        eval_rows(begin, end - begin);
+    };
+    ForEachMorsel(chunk_offset, size, eval_morsel);
 }
 
 template <typename T, typename IndexFunc, typename ElementFunc>
 auto
 ExecExprVisitor::ExecRangeVisitorImpl(FieldId field_id,
                                       IndexFunc index_func,
-                                      ElementFunc element_func) -> BitsetType {
+                                      ElementFunc element_func)
+    -> CompressedBitset {
     auto& schema = segment_.get_schema();
     auto& field_meta = schema[field_id];
     auto indexing_barrier = segment_.num_chunk_index(field_id);
+    if (indexing_barrier > 0) {
+        segment_.record_field_access(field_id, FieldAccess::IndexHits);
+    }
     auto size_per_chunk = segment_.size_per_chunk();
     auto num_chunk = upper_div(row_count_, size_per_chunk);
-    std::deque<BitsetType> results;
+    // chunk results are written in place, no intermediate chunk bitsets
+    BitsetType final_result(row_count_);
 
     typedef std::
         conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
             IndexInnerType;
     using Index = index::ScalarIndex<IndexInnerType>;
     for (auto chunk_id = 0; chunk_id < indexing_barrier; ++chunk_id) {
+        CheckCancel(cancel_token_);
+        if (!AnyCandidate(
+                candidate_, chunk_id * size_per_chunk, size_per_chunk)) {
+            continue;
+        }
         const Index& indexing =
             segment_.chunk_scalar_index<IndexInnerType>(field_id, chunk_id);
         // NOTE: knowhere is not const-ready
         // This is a dirty workaround
         auto data = index_func(const_cast<Index*>(&indexing));
-        AssertInfo(data->size() == size_per_chunk,
+        if (data.size() == row_count_) {
+            // the index covers the whole segment, a sealed one whatever its
+            // row groups, keep its container
+            return data;
+        }
+        AssertInfo(data.size() == size_per_chunk,
                    "[ExecExprVisitor]Data size not equal to size_per_chunk");
-        results.emplace_back(std::move(*data));
+        AssembleAt(final_result, chunk_id * size_per_chunk, data);
     }
     for (auto chunk_id = indexing_barrier; chunk_id < num_chunk; ++chunk_id) {
+        CheckCancel(cancel_token_);
         auto this_size = chunk_id == num_chunk - 1
                              ? row_count_ - chunk_id * size_per_chunk
                              : size_per_chunk;
-        BitsetType result(this_size);
-        auto chunk = segment_.chunk_data<T>(field_id, chunk_id);
-        const T* data = chunk.data();
-        for (int index = 0; index < this_size; ++index) {
-            auto x = data[index];
-            result[index] = element_func(x);
-        }
-        AssertInfo(result.size() == this_size, "");
-        results.emplace_back(std::move(result));
-    }
-    auto final_result = Assemble(results);
-    AssertInfo(final_result.size() == row_count_,
-               "[ExecExprVisitor]Final result size not equal to row count");
+        if (!AnyCandidate(candidate_, chunk_id * size_per_chunk, this_size)) {
+            continue;
+        }
+        EvalRawChunk<T>(segment_,
+                        field_id,
+                        chunk_id,
+                        chunk_id * size_per_chunk,
+                        this_size,
+                        candidate_,
+                        element_func,
+                        final_result);
+    }
     return final_result;
 }
 
-template <typename T, typename IndexFunc, typename ElementFunc>
+template <typename T, typename ElementFunc>
 auto
 ExecExprVisitor::ExecDataRangeVisitorImpl(FieldId field_id,
-                                          IndexFunc index_func,
                                           ElementFunc element_func)
     -> BitsetType {
     auto& schema = segment_.get_schema();
@@ -220,50 +1167,330 @@ ExecExprVisitor::ExecDataRangeVisitorImpl(FieldId field_id,
     auto data_barrier = segment_.num_chunk_data(field_id);
     AssertInfo(std::max(data_barrier, indexing_barrier) == num_chunk,
                "max(data_barrier, index_barrier) not equal to num_chunk");
-    std::deque<BitsetType> results;
+    if (indexing_barrier > data_barrier) {
+        segment_.record_field_access(field_id, FieldAccess::IndexHits);
+    }
+    BitsetType final_result(row_count_);
 
     // for growing segment, indexing_barrier will always less than data_barrier
     // so growing segment will always execute expr plan using raw data
     // if sealed segment has loaded raw data on this field, then index_barrier = 0 and data_barrier = 1
     // in this case, sealed segment execute expr plan using raw data
     for (auto chunk_id = 0; chunk_id < data_barrier; ++chunk_id) {
+        CheckCancel(cancel_token_);
         auto this_size = chunk_id == num_chunk - 1
                              ? row_count_ - chunk_id * size_per_chunk
                              : size_per_chunk;
-        BitsetType result(this_size);
-        auto chunk = segment_.chunk_data<T>(field_id, chunk_id);
-        const T* data = chunk.data();
-        for (int index = 0; index < this_size; ++index) {
-            result[index] = element_func(data[index]);
-        }
-        AssertInfo(
-            result.size() == this_size,
-            "[ExecExprVisitor]Chunk result size not equal to expected size");
-        results.emplace_back(std::move(result));
+        EvalRawChunk<T>(segment_,
+                        field_id,
+                        chunk_id,
+                        chunk_id * size_per_chunk,
+                        this_size,
+                        candidate_,
+                        element_func,
+                        final_result);
     }
 
     // if sealed segment has loaded scalar index for this field, then index_barrier = 1 and data_barrier = 0
-    // in this case, sealed segment execute expr plan using scalar index
+    // in this case, sealed segment execute expr plan using scalar index.
+    // the values are decoded a morsel at a time, not looked up row by row
     typedef std::
         conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
             IndexInnerType;
     using Index = index::ScalarIndex<IndexInnerType>;
     for (auto chunk_id = data_barrier; chunk_id < indexing_barrier;
          ++chunk_id) {
+        CheckCancel(cancel_token_);
         auto& indexing =
             segment_.chunk_scalar_index<IndexInnerType>(field_id, chunk_id);
-        auto this_size = const_cast<Index*>(&indexing)->Count();
-        BitsetType result(this_size);
-        for (int offset = 0; offset < this_size; ++offset) {
-            result[offset] = index_func(const_cast<Index*>(&indexing), offset);
+        auto index_size = const_cast<Index*>(&indexing)->Count();
+        auto chunk_offset = chunk_id * size_per_chunk;
+        // the rows of the chunk in an index covering the whole segment
+        auto index_offset = index_size == row_count_ ? chunk_offset : 0;
+        auto this_size = std::min(index_size - index_offset, size_per_chunk);
+        ForEachMorsel(chunk_offset, this_size, [&](int64_t begin, int64_t end) {
+            if (!AnyCandidate(candidate_, chunk_offset + begin, end - begin)) {
+                return;
+            }
+            auto values = std::make_unique<IndexInnerType[]>(end - begin);
+            indexing.ReverseLookupRange(
+                index_offset + begin, index_offset + end, values.get());
+            FillAt(final_result,
+                   chunk_offset + begin,
+                   end - begin,
+                   candidate_,
+                   [&values, &element_func](int64_t i) {
+                       return element_func(values[i]);
+                   });
+        });
+    }
+    return final_result;
+}
+
+// a leaf of a FusedConjunction
+struct FusedLeaf {
+    FieldId field_id_;
+    // ANDs the leaf over rows [begin, begin + size) of a chunk into
+    // `words`, the rows of zero words are not read; returns whether any
+    // word is left nonzero
+    std::function<bool(const segcore::SegmentInternalInterface& segment,
+                       int64_t chunk_id,
+                       int64_t begin,
+                       int64_t size,
+                       BitsetBlock* words)>
+        and_into_;
+};
+
+struct FusedConjunction {
+    std::vector<FusedLeaf> leaves_;
+};
+
+// a leaf running `kernel(src, size, dst)` over the raw rows of a field,
+// encoded chunks decoded a run of words at a time
+template <typename T, typename Kernel>
+static FusedLeaf
+MakeFusedLeaf(FieldId field_id, Kernel kernel) {
+    FusedLeaf leaf;
+    leaf.field_id_ = field_id;
+    leaf.and_into_ = [field_id, kernel](
+                         const segcore::SegmentInternalInterface& segment,
+                         int64_t chunk_id,
+                         int64_t begin,
+                         int64_t size,
+                         BitsetBlock* words) {
+        std::shared_ptr<const segcore::EncodedColumnBase> encoded;
+        if constexpr (segcore::IsEncodable<T>) {
+            encoded = segment.chunk_encoded<T>(field_id, chunk_id);
+        }
+        const T* data = nullptr;
+        if (encoded == nullptr) {
+            data = segment.chunk_data<T>(field_id, chunk_id).data() + begin;
+        }
+        thread_local std::vector<T> decoded;
+        thread_local std::vector<simd::BlockType> hits;
+        auto num_words = upper_div(size, BITS_PER_BLOCK);
+        auto any = false;
+        for (int64_t run_begin = 0; run_begin < num_words;) {
+            if (words[run_begin] == 0) {
+                ++run_begin;
+                continue;
+            }
+            auto run_end = run_begin + 1;
+            while (run_end < num_words && words[run_end] != 0) {
+                ++run_end;
+            }
+            auto row = run_begin * BITS_PER_BLOCK;
+            auto count = std::min(run_end * BITS_PER_BLOCK, size) - row;
+            const T* src = data == nullptr ? nullptr : data + row;
+            if constexpr (segcore::IsEncodable<T>) {
+                if (encoded != nullptr) {
+                    decoded.resize(count);
+                    static_cast<const segcore::EncodedColumn<T>&>(*encoded)
+                        .Decode(begin + row, count, decoded.data());
+                    src = decoded.data();
+                }
+            }
+            hits.resize(run_end - run_begin);
+            kernel(src, count, hits.data());
+            for (auto i = run_begin; i < run_end; ++i) {
+                words[i] &= hits[i - run_begin];
+                any = any || words[i] != 0;
+            }
+            run_begin = run_end;
         }
-        results.emplace_back(std::move(result));
+        return any;
+    };
+    return leaf;
+}
+
+template <typename T>
+static bool
+FuseUnaryRange(const UnaryRangeExpr& expr_raw,
+               std::vector<FusedLeaf>& leaves) {
+    auto& expr = static_cast<const UnaryRangeExprImpl<T>&>(expr_raw);
+    simd::CompareOp op;
+    switch (expr.op_type_) {
+        case OpType::Equal:
+            op = simd::CompareOp::Equal;
+            break;
+        case OpType::NotEqual:
+            op = simd::CompareOp::NotEqual;
+            break;
+        case OpType::GreaterThan:
+            op = simd::CompareOp::GreaterThan;
+            break;
+        case OpType::GreaterEqual:
+            op = simd::CompareOp::GreaterEqual;
+            break;
+        case OpType::LessThan:
+            op = simd::CompareOp::LessThan;
+            break;
+        case OpType::LessEqual:
+            op = simd::CompareOp::LessEqual;
+            break;
+        default:
+            return false;
     }
+    auto val = expr.value_;
+    leaves.push_back(MakeFusedLeaf<T>(
+        expr.field_id_,
+        [val, op](const T* src, int64_t size, simd::BlockType* dst) {
+            simd::CompareVal<T>(src, size, val, op, dst);
+        }));
+    return true;
+}
 
-    auto final_result = Assemble(results);
-    AssertInfo(final_result.size() == row_count_,
-               "[ExecExprVisitor]Final result size not equal to row count");
-    return final_result;
+template <typename T>
+static bool
+FuseBinaryRange(const BinaryRangeExpr& expr_raw,
+                std::vector<FusedLeaf>& leaves) {
+    auto& expr = static_cast<const BinaryRangeExprImpl<T>&>(expr_raw);
+    auto lower = expr.lower_value_;
+    auto upper = expr.upper_value_;
+    auto lower_inclusive = expr.lower_inclusive_;
+    auto upper_inclusive = expr.upper_inclusive_;
+    leaves.push_back(MakeFusedLeaf<T>(
+        expr.field_id_,
+        [=](const T* src, int64_t size, simd::BlockType* dst) {
+            simd::CompareRange<T>(
+                src, size, lower, upper, lower_inclusive, upper_inclusive, dst);
+        }));
+    return true;
+}
+
+// the leaves of an AND tree of range predicates on numeric fields,
+// false if anything else is in the tree
+static bool
+CollectFusedLeaves(const Expr& expr, std::vector<FusedLeaf>& leaves) {
+    if (expr.parameterized_) {
+        return false;
+    }
+    if (auto binary = dynamic_cast<const LogicalBinaryExpr*>(&expr)) {
+        return binary->op_type_ == LogicalBinaryExpr::OpType::LogicalAnd &&
+               CollectFusedLeaves(*binary->left_, leaves) &&
+               CollectFusedLeaves(*binary->right_, leaves);
+    }
+    if (auto range = dynamic_cast<const UnaryRangeExpr*>(&expr)) {
+        switch (range->data_type_) {
+            case DataType::INT8:
+                return FuseUnaryRange<int8_t>(*range, leaves);
+            case DataType::INT16:
+                return FuseUnaryRange<int16_t>(*range, leaves);
+            case DataType::INT32:
+                return FuseUnaryRange<int32_t>(*range, leaves);
+            case DataType::INT64:
+                return FuseUnaryRange<int64_t>(*range, leaves);
+            case DataType::FLOAT:
+                return FuseUnaryRange<float>(*range, leaves);
+            case DataType::DOUBLE:
+                return FuseUnaryRange<double>(*range, leaves);
+            default:
+                return false;
+        }
+    }
+    if (auto range = dynamic_cast<const BinaryRangeExpr*>(&expr)) {
+        switch (range->data_type_) {
+            case DataType::INT8:
+                return FuseBinaryRange<int8_t>(*range, leaves);
+            case DataType::INT16:
+                return FuseBinaryRange<int16_t>(*range, leaves);
+            case DataType::INT32:
+                return FuseBinaryRange<int32_t>(*range, leaves);
+            case DataType::INT64:
+                return FuseBinaryRange<int64_t>(*range, leaves);
+            case DataType::FLOAT:
+                return FuseBinaryRange<float>(*range, leaves);
+            case DataType::DOUBLE:
+                return FuseBinaryRange<double>(*range, leaves);
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+static std::shared_ptr<const FusedConjunction>
+FuseConjunction(const LogicalBinaryExpr& expr) {
+    auto fused = std::make_shared<FusedConjunction>();
+    if (!CollectFusedLeaves(expr, fused->leaves_)) {
+        return nullptr;
+    }
+    return fused;
+}
+
+auto
+ExecExprVisitor::ExecFusedConjunction(const LogicalBinaryExpr& expr)
+    -> std::optional<CompressedBitset> {
+    std::call_once(expr.fuse_once_,
+                   [&expr] { expr.fused_ = FuseConjunction(expr); });
+    auto fused = expr.fused_;
+    if (fused == nullptr) {
+        return std::nullopt;
+    }
+    // indexes answer their leaves without a scan, keep them
+    auto size_per_chunk = segment_.size_per_chunk();
+    auto num_chunk = upper_div(row_count_, size_per_chunk);
+    for (auto& leaf : fused->leaves_) {
+        if (segment_.num_chunk_index(leaf.field_id_) > 0 ||
+            segment_.num_chunk_data(leaf.field_id_) < num_chunk) {
+            return std::nullopt;
+        }
+    }
+    for (auto& leaf : fused->leaves_) {
+        segment_.record_field_access(leaf.field_id_, FieldAccess::FilterEvals);
+    }
+
+    BitsetType final_result(row_count_);
+    auto dst_blocks = final_result.data();
+    auto num_blocks = final_result.num_blocks();
+    const BitsetBlock* candidate_blocks =
+        candidate_ == nullptr ? nullptr : candidate_->data();
+    for (auto chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
+        CheckCancel(cancel_token_);
+        auto chunk_offset = chunk_id * size_per_chunk;
+        auto this_size = chunk_id == num_chunk - 1
+                             ? row_count_ - chunk_offset
+                             : size_per_chunk;
+        if (!AnyCandidate(candidate_, chunk_offset, this_size)) {
+            continue;
+        }
+        // a word per 64 rows of the morsel, starting from its candidates
+        // and narrowed by each leaf in turn over the rows still set
+        ForEachMorsel(chunk_offset, this_size, [&](int64_t begin, int64_t end) {
+            if (!AnyCandidate(candidate_, chunk_offset + begin, end - begin)) {
+                return;
+            }
+            auto size = end - begin;
+            thread_local std::vector<BitsetBlock> words;
+            words.resize(upper_div(size, BITS_PER_BLOCK));
+            for (int64_t i = 0; i < words.size(); ++i) {
+                auto rows = std::min(size - i * BITS_PER_BLOCK, BITS_PER_BLOCK);
+                auto word = rows == BITS_PER_BLOCK
+                                ? ~BitsetBlock(0)
+                                : (BitsetBlock(1) << rows) - 1;
+                if (candidate_blocks != nullptr) {
+                    word &= extract_block(candidate_blocks,
+                                          num_blocks,
+                                          chunk_offset + begin +
+                                              i * BITS_PER_BLOCK);
+                }
+                words[i] = word;
+            }
+            for (auto& leaf : fused->leaves_) {
+                if (!leaf.and_into_(
+                        segment_, chunk_id, begin, size, words.data())) {
+                    return;
+                }
+            }
+            for (int64_t i = 0; i < words.size(); ++i) {
+                merge_block(dst_blocks,
+                            num_blocks,
+                            chunk_offset + begin + i * BITS_PER_BLOCK,
+                            words[i]);
+            }
+        });
+    }
+    return CompressedBitset(std::move(final_result));
 }
 
 #pragma clang diagnostic push
@@ -271,61 +1498,77 @@ ExecExprVisitor::ExecDataRangeVisitorImpl(FieldId field_id,
 template <typename T>
 auto
 ExecExprVisitor::ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw)
-    -> BitsetType {
+    -> CompressedBitset {
     typedef std::
         conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
             IndexInnerType;
     using Index = index::ScalarIndex<IndexInnerType>;
+    using CmpOp = simd::CompareOp;
     auto& expr = static_cast<UnaryRangeExprImpl<IndexInnerType>&>(expr_raw);
 
     auto op = expr.op_type_;
     auto val = IndexInnerType(expr.value_);
     switch (op) {
         case OpType::Equal: {
+            if constexpr (std::is_same_v<IndexInnerType, int64_t> ||
+                          std::is_same_v<IndexInnerType, std::string>) {
+                auto rows = PartitionKeyRows(
+                    expr.field_id_, std::vector<IndexInnerType>{val});
+                if (rows.has_value()) {
+                    return std::move(rows.value());
+                }
+            }
             auto index_func = [val](Index* index) {
-                return index->In(1, &val);
+                return index->InCompressed(1, &val);
             };
-            auto elem_func = [val](T x) { return (x == val); };
+            auto elem_func =
+                CompareValFunc<CmpOp::Equal, T, IndexInnerType>{val};
             return ExecRangeVisitorImpl<T>(
                 expr.field_id_, index_func, elem_func);
         }
         case OpType::NotEqual: {
             auto index_func = [val](Index* index) {
-                return index->NotIn(1, &val);
+                return CompressedBitset::compress(
+                    std::move(*index->NotIn(1, &val)));
             };
-            auto elem_func = [val](T x) { return (x != val); };
+            auto elem_func =
+                CompareValFunc<CmpOp::NotEqual, T, IndexInnerType>{val};
             return ExecRangeVisitorImpl<T>(
                 expr.field_id_, index_func, elem_func);
         }
         case OpType::GreaterEqual: {
             auto index_func = [val](Index* index) {
-                return index->Range(val, OpType::GreaterEqual);
+                return index->RangeCompressed(val, OpType::GreaterEqual);
             };
-            auto elem_func = [val](T x) { return (x >= val); };
+            auto elem_func =
+                CompareValFunc<CmpOp::GreaterEqual, T, IndexInnerType>{val};
             return ExecRangeVisitorImpl<T>(
                 expr.field_id_, index_func, elem_func);
         }
         case OpType::GreaterThan: {
             auto index_func = [val](Index* index) {
-                return index->Range(val, OpType::GreaterThan);
+                return index->RangeCompressed(val, OpType::GreaterThan);
             };
-            auto elem_func = [val](T x) { return (x > val); };
+            auto elem_func =
+                CompareValFunc<CmpOp::GreaterThan, T, IndexInnerType>{val};
             return ExecRangeVisitorImpl<T>(
                 expr.field_id_, index_func, elem_func);
         }
         case OpType::LessEqual: {
             auto index_func = [val](Index* index) {
-                return index->Range(val, OpType::LessEqual);
+                return index->RangeCompressed(val, OpType::LessEqual);
             };
-            auto elem_func = [val](T x) { return (x <= val); };
+            auto elem_func =
+                CompareValFunc<CmpOp::LessEqual, T, IndexInnerType>{val};
             return ExecRangeVisitorImpl<T>(
                 expr.field_id_, index_func, elem_func);
         }
         case OpType::LessThan: {
             auto index_func = [val](Index* index) {
-                return index->Range(val, OpType::LessThan);
+                return index->RangeCompressed(val, OpType::LessThan);
             };
-            auto elem_func = [val](T x) { return (x < val); };
+            auto elem_func =
+                CompareValFunc<CmpOp::LessThan, T, IndexInnerType>{val};
             return ExecRangeVisitorImpl<T>(
                 expr.field_id_, index_func, elem_func);
         }
@@ -334,9 +1577,10 @@ ExecExprVisitor::ExecUnaryRangeVisitorDispatcher(UnaryRangeExpr& expr_raw)
                 auto dataset = std::make_unique<Dataset>();
                 dataset->Set(milvus::index::OPERATOR_TYPE, OpType::PrefixMatch);
                 dataset->Set(milvus::index::PREFIX_VALUE, val);
-                return index->Query(std::move(dataset));
+                return CompressedBitset::compress(
+                    std::move(*index->Query(std::move(dataset))));
             };
-            auto elem_func = [val, op](T x) { return Match(x, val, op); };
+            auto elem_func = PrefixMatchFunc<T>{val};
             return ExecRangeVisitorImpl<T>(
                 expr.field_id_, index_func, elem_func);
         }
@@ -355,149 +1599,56 @@ auto
 ExecExprVisitor::ExecBinaryArithOpEvalRangeVisitorDispatcher(
     BinaryArithOpEvalRangeExpr& expr_raw) -> BitsetType {
     auto& expr = static_cast<BinaryArithOpEvalRangeExprImpl<T>&>(expr_raw);
-    using Index = index::ScalarIndex<T>;
+    using CmpOp = simd::CompareOp;
     auto arith_op = expr.arith_op_;
     auto right_operand = expr.right_operand_;
-    auto op = expr.op_type_;
     auto val = expr.value_;
+    if constexpr (std::is_integral_v<T>) {
+        AssertInfo(right_operand != 0 || (arith_op != ArithOpType::Div &&
+                                          arith_op != ArithOpType::Mod),
+                   "[ExecExprVisitor]Integer division by zero");
+    }
 
-    switch (op) {
-        case OpType::Equal: {
-            switch (arith_op) {
-                case ArithOpType::Add: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x + right_operand) == val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x + right_operand) == val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Sub: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x - right_operand) == val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x - right_operand) == val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Mul: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x * right_operand) == val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x * right_operand) == val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Div: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x / right_operand) == val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x / right_operand) == val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Mod: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return static_cast<T>(fmod(x, right_operand)) == val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return (static_cast<T>(fmod(x, right_operand)) == val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                default: {
-                    PanicInfo("unsupported arithmetic operation");
-                }
-            }
-        }
-        case OpType::NotEqual: {
-            switch (arith_op) {
-                case ArithOpType::Add: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x + right_operand) != val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x + right_operand) != val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Sub: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x - right_operand) != val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x - right_operand) != val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Mul: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x * right_operand) != val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x * right_operand) != val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Div: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return (x / right_operand) != val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return ((x / right_operand) != val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                case ArithOpType::Mod: {
-                    auto index_func = [val, right_operand](Index* index,
-                                                           size_t offset) {
-                        auto x = index->Reverse_Lookup(offset);
-                        return static_cast<T>(fmod(x, right_operand)) != val;
-                    };
-                    auto elem_func = [val, right_operand](T x) {
-                        return (static_cast<T>(fmod(x, right_operand)) != val);
-                    };
-                    return ExecDataRangeVisitorImpl<T>(
-                        expr.field_id_, index_func, elem_func);
-                }
-                default: {
-                    PanicInfo("unsupported arithmetic operation");
-                }
+    // one fused functor per (arith op, compare op) pair
+    auto exec = [&](auto arith_tag, auto cmp_tag) {
+        auto elem_func =
+            ArithCompareFunc<decltype(arith_tag)::value,
+                             decltype(cmp_tag)::value,
+                             T>{right_operand, val};
+        return ExecDataRangeVisitorImpl<T>(expr.field_id_, elem_func);
+    };
+    auto exec_cmp = [&](auto arith_tag) {
+        switch (expr.op_type_) {
+            case OpType::Equal:
+                return exec(arith_tag, CmpTag<CmpOp::Equal>{});
+            case OpType::NotEqual:
+                return exec(arith_tag, CmpTag<CmpOp::NotEqual>{});
+            case OpType::GreaterThan:
+                return exec(arith_tag, CmpTag<CmpOp::GreaterThan>{});
+            case OpType::GreaterEqual:
+                return exec(arith_tag, CmpTag<CmpOp::GreaterEqual>{});
+            case OpType::LessThan:
+                return exec(arith_tag, CmpTag<CmpOp::LessThan>{});
+            case OpType::LessEqual:
+                return exec(arith_tag, CmpTag<CmpOp::LessEqual>{});
+            default: {
+                PanicInfo("unsupported range node with arithmetic operation");
             }
         }
+    };
+    switch (arith_op) {
+        case ArithOpType::Add:
+            return exec_cmp(ArithTag<ArithOpType::Add>{});
+        case ArithOpType::Sub:
+            return exec_cmp(ArithTag<ArithOpType::Sub>{});
+        case ArithOpType::Mul:
+            return exec_cmp(ArithTag<ArithOpType::Mul>{});
+        case ArithOpType::Div:
+            return exec_cmp(ArithTag<ArithOpType::Div>{});
+        case ArithOpType::Mod:
+            return exec_cmp(ArithTag<ArithOpType::Mod>{});
         default: {
-            PanicInfo("unsupported range node with arithmetic operation");
+            PanicInfo("unsupported arithmetic operation");
         }
     }
 }
@@ -508,7 +1659,7 @@ ExecExprVisitor::ExecBinaryArithOpEvalRangeVisitorDispatcher(
 template <typename T>
 auto
 ExecExprVisitor::ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw)
-    -> BitsetType {
+    -> CompressedBitset {
     typedef std::
         conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
             IndexInnerType;
@@ -521,19 +1672,24 @@ ExecExprVisitor::ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw)
     IndexInnerType val2 = IndexInnerType(expr.upper_value_);
 
     auto index_func = [=](Index* index) {
-        return index->Range(val1, lower_inclusive, val2, upper_inclusive);
+        return index->RangeCompressed(
+            val1, lower_inclusive, val2, upper_inclusive);
     };
     if (lower_inclusive && upper_inclusive) {
-        auto elem_func = [val1, val2](T x) { return (val1 <= x && x <= val2); };
+        auto elem_func =
+            CompareRangeFunc<true, true, T, IndexInnerType>{val1, val2};
         return ExecRangeVisitorImpl<T>(expr.field_id_, index_func, elem_func);
     } else if (lower_inclusive && !upper_inclusive) {
-        auto elem_func = [val1, val2](T x) { return (val1 <= x && x < val2); };
+        auto elem_func =
+            CompareRangeFunc<true, false, T, IndexInnerType>{val1, val2};
         return ExecRangeVisitorImpl<T>(expr.field_id_, index_func, elem_func);
     } else if (!lower_inclusive && upper_inclusive) {
-        auto elem_func = [val1, val2](T x) { return (val1 < x && x <= val2); };
+        auto elem_func =
+            CompareRangeFunc<false, true, T, IndexInnerType>{val1, val2};
         return ExecRangeVisitorImpl<T>(expr.field_id_, index_func, elem_func);
     } else {
-        auto elem_func = [val1, val2](T x) { return (val1 < x && x < val2); };
+        auto elem_func =
+            CompareRangeFunc<false, false, T, IndexInnerType>{val1, val2};
         return ExecRangeVisitorImpl<T>(expr.field_id_, index_func, elem_func);
     }
 }
@@ -541,10 +1697,15 @@ ExecExprVisitor::ExecBinaryRangeVisitorDispatcher(BinaryRangeExpr& expr_raw)
 
 void
 ExecExprVisitor::visit(UnaryRangeExpr& expr) {
+    if (expr.parameterized_) {
+        BoundExpr(expr).accept(*this);
+        return;
+    }
+    segment_.record_field_access(expr.field_id_, FieldAccess::FilterEvals);
     auto& field_meta = segment_.get_schema()[expr.field_id_];
     AssertInfo(expr.data_type_ == field_meta.get_data_type(),
                "[ExecExprVisitor]DataType of expr isn't field_meta data type");
-    BitsetType res;
+    CompressedBitset res;
     switch (expr.data_type_) {
         case DataType::BOOL: {
             res = ExecUnaryRangeVisitorDispatcher<bool>(expr);
@@ -592,6 +1753,11 @@ ExecExprVisitor::visit(UnaryRangeExpr& expr) {
 
 void
 ExecExprVisitor::visit(BinaryArithOpEvalRangeExpr& expr) {
+    if (expr.parameterized_) {
+        BoundExpr(expr).accept(*this);
+        return;
+    }
+    segment_.record_field_access(expr.field_id_, FieldAccess::FilterEvals);
     auto& field_meta = segment_.get_schema()[expr.field_id_];
     AssertInfo(expr.data_type_ == field_meta.get_data_type(),
                "[ExecExprVisitor]DataType of expr isn't field_meta data type");
@@ -631,10 +1797,15 @@ ExecExprVisitor::visit(BinaryArithOpEvalRangeExpr& expr) {
 
 void
 ExecExprVisitor::visit(BinaryRangeExpr& expr) {
+    if (expr.parameterized_) {
+        BoundExpr(expr).accept(*this);
+        return;
+    }
+    segment_.record_field_access(expr.field_id_, FieldAccess::FilterEvals);
     auto& field_meta = segment_.get_schema()[expr.field_id_];
     AssertInfo(expr.data_type_ == field_meta.get_data_type(),
                "[ExecExprVisitor]DataType of expr isn't field_meta data type");
-    BitsetType res;
+    CompressedBitset res;
     switch (expr.data_type_) {
         case DataType::BOOL: {
             res = ExecBinaryRangeVisitorDispatcher<bool>(expr);
@@ -694,6 +1865,108 @@ struct relational {
     }
 };
 
+// call `func` with the typed raw data of a chunk,
+// returns false for a data type without raw chunk support
+template <typename Func>
+static bool
+VisitRawChunk(const segcore::SegmentInternalInterface& segment,
+              DataType type,
+              FieldId field_id,
+              int64_t chunk_id,
+              Func&& func) {
+    switch (type) {
+        case DataType::BOOL:
+            func(segment.chunk_data<bool>(field_id, chunk_id).data());
+            return true;
+        case DataType::INT8:
+            func(segment.chunk_data<int8_t>(field_id, chunk_id).data());
+            return true;
+        case DataType::INT16:
+            func(segment.chunk_data<int16_t>(field_id, chunk_id).data());
+            return true;
+        case DataType::INT32:
+            func(segment.chunk_data<int32_t>(field_id, chunk_id).data());
+            return true;
+        case DataType::INT64:
+            func(segment.chunk_data<int64_t>(field_id, chunk_id).data());
+            return true;
+        case DataType::FLOAT:
+            func(segment.chunk_data<float>(field_id, chunk_id).data());
+            return true;
+        case DataType::DOUBLE:
+            func(segment.chunk_data<double>(field_id, chunk_id).data());
+            return true;
+        case DataType::VARCHAR:
+            if (segment.type() == SegmentType::Growing) {
+                func(segment.chunk_data<std::string>(field_id, chunk_id)
+                         .data());
+            } else {
+                func(segment.chunk_data<std::string_view>(field_id, chunk_id)
+                         .data());
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+constexpr bool IsStringLike =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+template <typename Op>
+constexpr bool IsMatchOp = false;
+
+template <OpType op>
+constexpr bool IsMatchOp<MatchOp<op>> = true;
+
+// whether `Op` can be applied to the raw elements directly,
+// match ops and mixed string/number operands take the generic path
+template <typename Op, typename L, typename R>
+constexpr bool IsRawComparable =
+    !IsMatchOp<Op> &&
+    std::is_invocable_r_v<bool, const Op&, const L&, const R&> &&
+    ((std::is_arithmetic_v<L> && std::is_arithmetic_v<R>) ||
+     (IsStringLike<L> && IsStringLike<R>));
+
+// the values of a scalar index chunk, decoded a block at a time for
+// readers going through the rows in order
+template <typename T>
+class IndexChunkReader {
+ public:
+    static constexpr int64_t BLOCK_ROWS = 4096;
+
+    // the chunk at chunk_offset of a segment of row_count rows, an index
+    // covering them all read from chunk_offset on
+    IndexChunkReader(const index::ScalarIndex<T>& indexing,
+                     int64_t chunk_offset,
+                     int64_t row_count)
+        : indexing_(indexing),
+          size_(const_cast<index::ScalarIndex<T>&>(indexing).Count()),
+          offset_(size_ == row_count ? chunk_offset : 0),
+          block_(std::make_unique<T[]>(std::min(BLOCK_ROWS, size_))) {
+    }
+
+    const T&
+    operator()(int64_t i) {
+        i += offset_;
+        if (i < begin_ || i >= end_) {
+            begin_ = i / BLOCK_ROWS * BLOCK_ROWS;
+            end_ = std::min(begin_ + BLOCK_ROWS, size_);
+            indexing_.ReverseLookupRange(begin_, end_, block_.get());
+        }
+        return block_[i - begin_];
+    }
+
+ private:
+    const index::ScalarIndex<T>& indexing_;
+    int64_t size_;
+    int64_t offset_;
+    std::unique_ptr<T[]> block_;
+    int64_t begin_ = 0;
+    int64_t end_ = 0;
+};
+
 template <typename Op>
 auto
 ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
@@ -708,7 +1981,7 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                                   std::string>;
     auto size_per_chunk = segment_.size_per_chunk();
     auto num_chunk = upper_div(row_count_, size_per_chunk);
-    std::deque<BitsetType> bitsets;
+    BitsetType final_result(row_count_);
 
     // check for sealed segment, load either raw field data or index
     auto left_indexing_barrier = segment_.num_chunk_index(expr.left_field_id_);
@@ -726,9 +1999,48 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
         "num_chunk");
 
     for (int64_t chunk_id = 0; chunk_id < num_chunk; ++chunk_id) {
-        auto size = chunk_id == num_chunk - 1
-                        ? row_count_ - chunk_id * size_per_chunk
-                        : size_per_chunk;
+        CheckCancel(cancel_token_);
+        auto chunk_offset = chunk_id * size_per_chunk;
+        auto size = chunk_id == num_chunk - 1 ? row_count_ - chunk_offset
+                                              : size_per_chunk;
+        if (!AnyCandidate(candidate_, chunk_offset, size)) {
+            continue;
+        }
+        // both sides on raw data, compare with the concrete element types
+        // instead of a type erased accessor and a variant per row
+        if (chunk_id < left_data_barrier && chunk_id < right_data_barrier) {
+            bool handled = false;
+            auto visit_left = [&](auto left) {
+                auto visit_right = [&, left](auto right) {
+                    // pointers, or the rows of a string_view span
+                    using L = std::decay_t<decltype(left[0])>;
+                    using R = std::decay_t<decltype(right[0])>;
+                    if constexpr (IsRawComparable<Op, L, R>) {
+                        FillAt(final_result,
+                               chunk_id * size_per_chunk,
+                               size,
+                               candidate_,
+                               [left, right, op](int64_t i) {
+                                   return op(left[i], right[i]);
+                               });
+                        handled = true;
+                    }
+                };
+                VisitRawChunk(segment_,
+                              expr.right_data_type_,
+                              expr.right_field_id_,
+                              chunk_id,
+                              visit_right);
+            };
+            VisitRawChunk(segment_,
+                          expr.left_data_type_,
+                          expr.left_field_id_,
+                          chunk_id,
+                          visit_left);
+            if (handled) {
+                continue;
+            }
+        }
         auto getChunkData =
             [&, chunk_id](DataType type, FieldId field_id, int64_t data_barrier)
             -> std::function<const number(int)> {
@@ -745,8 +2057,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing = segment_.chunk_scalar_index<bool>(
                             field_id, chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<bool>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -762,8 +2077,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing = segment_.chunk_scalar_index<int8_t>(
                             field_id, chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<int8_t>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -779,8 +2097,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing = segment_.chunk_scalar_index<int16_t>(
                             field_id, chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<int16_t>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -796,8 +2117,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing = segment_.chunk_scalar_index<int32_t>(
                             field_id, chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<int32_t>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -813,8 +2137,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing = segment_.chunk_scalar_index<int64_t>(
                             field_id, chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<int64_t>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -830,8 +2157,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing = segment_.chunk_scalar_index<float>(
                             field_id, chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<float>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -847,8 +2177,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         // for case, sealed segment has loaded index for scalar field instead of raw data
                         auto& indexing = segment_.chunk_scalar_index<double>(
                             field_id, chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<double>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -876,8 +2209,11 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
                         auto& indexing =
                             segment_.chunk_scalar_index<std::string>(field_id,
                                                                      chunk_id);
-                        return [&indexing](int i) -> const number {
-                            return indexing.Reverse_Lookup(i);
+                        auto reader =
+                            std::make_shared<IndexChunkReader<std::string>>(
+                                indexing, chunk_offset, row_count_);
+                        return [reader](int i) -> const number {
+                            return (*reader)(i);
                         };
                     }
                 }
@@ -890,22 +2226,23 @@ ExecExprVisitor::ExecCompareExprDispatcher(CompareExpr& expr, Op op)
         auto right = getChunkData(
             expr.right_data_type_, expr.right_field_id_, right_data_barrier);
 
-        BitsetType bitset(size);
-        for (int i = 0; i < size; ++i) {
-            bool is_in = boost::apply_visitor(
-                Relational<decltype(op)>{}, left(i), right(i));
-            bitset[i] = is_in;
-        }
-        bitsets.emplace_back(std::move(bitset));
+        FillAt(final_result,
+               chunk_id * size_per_chunk,
+               size,
+               candidate_,
+               [&left, &right](int64_t i) {
+                   return boost::apply_visitor(
+                       Relational<decltype(op)>{}, left(i), right(i));
+               });
     }
-    auto final_result = Assemble(bitsets);
-    AssertInfo(final_result.size() == row_count_,
-               "[ExecExprVisitor]Size of results not equal row count");
     return final_result;
 }
 
 void
 ExecExprVisitor::visit(CompareExpr& expr) {
+    segment_.record_field_access(expr.left_field_id_, FieldAccess::FilterEvals);
+    segment_.record_field_access(expr.right_field_id_,
+                                 FieldAccess::FilterEvals);
     auto& schema = segment_.get_schema();
     auto& left_field_meta = schema[expr.left_field_id_];
     auto& right_field_meta = schema[expr.right_field_id_];
@@ -960,7 +2297,8 @@ ExecExprVisitor::visit(CompareExpr& expr) {
 
 template <typename T>
 auto
-ExecExprVisitor::ExecTermVisitorImpl(TermExpr& expr_raw) -> BitsetType {
+ExecExprVisitor::ExecTermVisitorImpl(TermExpr& expr_raw)
+    -> CompressedBitset {
     auto& expr = static_cast<TermExprImpl<T>&>(expr_raw);
     auto& schema = segment_.get_schema();
     auto primary_filed_id = schema.get_primary_field_id();
@@ -995,15 +2333,14 @@ ExecExprVisitor::ExecTermVisitorImpl(TermExpr& expr_raw) -> BitsetType {
             }
         }
 
+        segment_.record_field_access(field_id, FieldAccess::IndexHits);
         auto [uids, seg_offsets] = segment_.search_ids(*id_array, timestamp_);
-        BitsetType bitset(row_count_);
+        std::vector<CompressedBitset::offset_type> offsets;
+        offsets.reserve(seg_offsets.size());
         for (const auto& offset : seg_offsets) {
-            auto _offset = (int64_t)offset.get();
-            bitset[_offset] = true;
+            offsets.push_back(offset.get());
         }
-        AssertInfo(bitset.size() == row_count_,
-                   "[ExecExprVisitor]Size of results not equal row count");
-        return bitset;
+        return CompressedBitset::from_offsets(row_count_, std::move(offsets));
     }
 
     return ExecTermVisitorImplTemplate<T>(expr_raw);
@@ -1012,53 +2349,74 @@ ExecExprVisitor::ExecTermVisitorImpl(TermExpr& expr_raw) -> BitsetType {
 template <>
 auto
 ExecExprVisitor::ExecTermVisitorImpl<std::string>(TermExpr& expr_raw)
-    -> BitsetType {
+    -> CompressedBitset {
     return ExecTermVisitorImplTemplate<std::string>(expr_raw);
 }
 
 template <>
 auto
 ExecExprVisitor::ExecTermVisitorImpl<std::string_view>(TermExpr& expr_raw)
-    -> BitsetType {
+    -> CompressedBitset {
     return ExecTermVisitorImplTemplate<std::string_view>(expr_raw);
 }
 
 template <typename T>
 auto
-ExecExprVisitor::ExecTermVisitorImplTemplate(TermExpr& expr_raw) -> BitsetType {
+ExecExprVisitor::ExecTermVisitorImplTemplate(TermExpr& expr_raw)
+    -> CompressedBitset {
     typedef std::
         conditional_t<std::is_same_v<T, std::string_view>, std::string, T>
             IndexInnerType;
     using Index = index::ScalarIndex<IndexInnerType>;
     auto& expr = static_cast<TermExprImpl<IndexInnerType>&>(expr_raw);
-    const std::vector<IndexInnerType> terms(expr.terms_.begin(),
-                                            expr.terms_.end());
+    const auto& terms = expr.term_set_.terms();
     auto n = terms.size();
-    std::unordered_set<T> term_set(expr.terms_.begin(), expr.terms_.end());
+    if (n == 0) {
+        // a folded contradiction, see SimplifyExpr
+        return CompressedBitset(row_count_);
+    }
+
+    if constexpr (std::is_same_v<IndexInnerType, int64_t> ||
+                  std::is_same_v<IndexInnerType, std::string>) {
+        auto rows = PartitionKeyRows(expr.field_id_, terms);
+        if (rows.has_value()) {
+            return std::move(rows.value());
+        }
+    }
 
     auto index_func = [&terms, n](Index* index) {
-        return index->In(n, terms.data());
-    };
-    auto elem_func = [&terms, &term_set](T x) {
-        //// terms has already been sorted.
-        // return std::binary_search(terms.begin(), terms.end(), x);
-        return term_set.find(x) != term_set.end();
+        return index->InCompressed(n, terms.data());
     };
+    auto elem_func = TermFunc<T, IndexInnerType>{expr.term_set_};
 
     return ExecRangeVisitorImpl<T>(expr.field_id_, index_func, elem_func);
 }
 
+template <typename K>
+auto
+ExecExprVisitor::PartitionKeyRows(FieldId field_id,
+                                  const std::vector<K>& keys)
+    -> std::optional<CompressedBitset> {
+    if (segment_.get_schema().get_partition_key_field_id() != field_id) {
+        return std::nullopt;
+    }
+    auto partition_keys = segment_.partition_keys<K>();
+    if (partition_keys == nullptr) {
+        return std::nullopt;
+    }
+    return partition_keys->Rows(keys.data(), keys.size(), row_count_);
+}
+
 // TODO: bool is so ugly here.
 template <>
 auto
 ExecExprVisitor::ExecTermVisitorImplTemplate<bool>(TermExpr& expr_raw)
-    -> BitsetType {
+    -> CompressedBitset {
     using T = bool;
     auto& expr = static_cast<TermExprImpl<T>&>(expr_raw);
     using Index = index::ScalarIndex<T>;
     const auto& terms = expr.terms_;
     auto n = terms.size();
-    std::unordered_set<T> term_set(expr.terms_.begin(), expr.terms_.end());
 
     auto index_func = [&terms, n](Index* index) {
         auto bool_arr_copy = new bool[terms.size()];
@@ -1066,26 +2424,27 @@ ExecExprVisitor::ExecTermVisitorImplTemplate<bool>(TermExpr& expr_raw)
         for (auto elem : terms) {
             bool_arr_copy[it++] = elem;
         }
-        auto bitset = index->In(n, bool_arr_copy);
+        auto bitset = index->InCompressed(n, bool_arr_copy);
         delete[] bool_arr_copy;
         return bitset;
     };
 
-    auto elem_func = [&terms, &term_set](T x) {
-        //// terms has already been sorted.
-        // return std::binary_search(terms.begin(), terms.end(), x);
-        return term_set.find(x) != term_set.end();
-    };
+    auto elem_func = TermFunc<T, T>{expr.term_set_};
 
     return ExecRangeVisitorImpl<T>(expr.field_id_, index_func, elem_func);
 }
 
 void
 ExecExprVisitor::visit(TermExpr& expr) {
+    if (expr.parameterized_) {
+        BoundExpr(expr).accept(*this);
+        return;
+    }
+    segment_.record_field_access(expr.field_id_, FieldAccess::FilterEvals);
     auto& field_meta = segment_.get_schema()[expr.field_id_];
     AssertInfo(expr.data_type_ == field_meta.get_data_type(),
                "[ExecExprVisitor]DataType of expr isn't field_meta data type ");
-    BitsetType res;
+    CompressedBitset res;
     switch (expr.data_type_) {
         case DataType::BOOL: {
             res = ExecTermVisitorImpl<bool>(expr);
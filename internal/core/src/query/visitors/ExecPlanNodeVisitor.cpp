@@ -11,11 +11,23 @@
 
 #include "query/generated/ExecPlanNodeVisitor.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <unordered_set>
 #include <utility>
 
+#include "common/Utils.h"
+#include "query/ExprImpl.h"
 #include "query/PlanImpl.h"
+#include "query/QueryScheduler.h"
+#include "query/SearchBruteForce.h"
 #include "query/SubSearchResult.h"
 #include "query/generated/ExecExprVisitor.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/SegmentGrowing.h"
 #include "utils/Json.h"
 
@@ -58,6 +70,11 @@ class ExecPlanNodeVisitor : PlanNodeVisitor {
 };
 }  // namespace impl
 
+// hits fetched per group wanted by the first search of a group by
+constexpr int64_t GROUP_BY_FETCH_FACTOR = 4;
+// the widest ef or nprobe a short filtered search is widened to
+constexpr int64_t MAX_SEARCH_BREADTH = 65536;
+
 static SearchResult
 empty_search_result(int64_t num_queries, SearchInfo& search_info) {
     SearchResult final_result;
@@ -72,6 +89,472 @@ empty_search_result(int64_t num_queries, SearchInfo& search_info) {
     return final_result;
 }
 
+// evaluate a predicate over the active rows, reusing the result of an
+// identical predicate if the segment cached one
+static BitsetType
+ExecPredicate(const segcore::SegmentInternalInterface& segment,
+              Expr& predicate,
+              const std::string& predicate_fingerprint,
+              const ExprBindings* bindings,
+              QueryProfile* profile,
+              const CancelToken* cancel_token,
+              int64_t active_count,
+              Timestamp timestamp) {
+    ProfileTimer timer(profile, "filter");
+    auto cache = predicate_fingerprint.empty()
+                     ? nullptr
+                     : segment.get_filter_cache(timestamp);
+    if (cache == nullptr) {
+        return ExecExprVisitor(segment,
+                               active_count,
+                               timestamp,
+                               bindings,
+                               profile,
+                               cancel_token)
+            .call_child(predicate);
+    }
+    // a prepared predicate is only identical under the same values
+    auto fingerprint = bindings == nullptr
+                           ? predicate_fingerprint
+                           : predicate_fingerprint + bindings->fingerprint_;
+    auto version = cache->version();
+    if (auto cached = cache->Get(fingerprint);
+        cached != nullptr && cached->size() == size_t(active_count)) {
+        if (profile != nullptr) {
+            ++profile->filter_cache_hits_;
+        }
+        return *cached;
+    }
+    auto result = ExecExprVisitor(segment,
+                                  active_count,
+                                  timestamp,
+                                  bindings,
+                                  profile,
+                                  cancel_token)
+                      .call_child(predicate);
+    cache->Put(fingerprint,
+               result,
+               version,
+               segcore::SegcoreConfig::default_config()
+                   .get_filter_cache_bytes());
+    return result;
+}
+
+// whether the segment tracks its partition keys and holds none of keys
+template <typename K>
+static bool
+LacksPartitionKeys(const segcore::SegmentInternalInterface& segment,
+                   const std::vector<K>& keys) {
+    auto partition_keys = segment.partition_keys<K>();
+    return partition_keys != nullptr &&
+           !partition_keys->Contains(keys.data(), keys.size());
+}
+
+// whether a predicate only matches rows with partition keys the segment
+// does not hold, which it tells without evaluating the predicate
+static bool
+LacksPartitionKeys(const segcore::SegmentInternalInterface& segment,
+                   const Expr& predicate,
+                   const ExprBindings* bindings) {
+    auto expr = &predicate;
+    if (expr->parameterized_) {
+        if (bindings == nullptr) {
+            return false;
+        }
+        auto iter = bindings->exprs_.find(expr);
+        if (iter == bindings->exprs_.end()) {
+            return false;
+        }
+        expr = iter->second.get();
+    }
+    if (auto logical = dynamic_cast<const LogicalBinaryExpr*>(expr)) {
+        auto lacks = [&](const ExprPtr& child) {
+            return LacksPartitionKeys(segment, *child, bindings);
+        };
+        switch (logical->op_type_) {
+            case LogicalBinaryExpr::OpType::LogicalAnd:
+                return lacks(logical->left_) || lacks(logical->right_);
+            case LogicalBinaryExpr::OpType::LogicalOr:
+                return lacks(logical->left_) && lacks(logical->right_);
+            case LogicalBinaryExpr::OpType::LogicalMinus:
+                return lacks(logical->left_);
+            default:
+                return false;
+        }
+    }
+    auto field_id = segment.get_schema().get_partition_key_field_id();
+    if (!field_id.has_value()) {
+        return false;
+    }
+    if (auto term = dynamic_cast<const TermExpr*>(expr);
+        term != nullptr && term->field_id_ == field_id.value()) {
+        switch (term->data_type_) {
+            case DataType::INT64:
+                return LacksPartitionKeys(
+                    segment,
+                    static_cast<const TermExprImpl<int64_t>&>(*term)
+                        .term_set_.terms());
+            case DataType::VARCHAR:
+                return LacksPartitionKeys(
+                    segment,
+                    static_cast<const TermExprImpl<std::string>&>(*term)
+                        .term_set_.terms());
+            default:
+                return false;
+        }
+    }
+    if (auto range = dynamic_cast<const UnaryRangeExpr*>(expr);
+        range != nullptr && range->field_id_ == field_id.value() &&
+        range->op_type_ == OpType::Equal) {
+        switch (range->data_type_) {
+            case DataType::INT64:
+                return LacksPartitionKeys(
+                    segment,
+                    std::vector<int64_t>{
+                        static_cast<const UnaryRangeExprImpl<int64_t>&>(
+                            *range)
+                            .value_});
+            case DataType::VARCHAR:
+                return LacksPartitionKeys(
+                    segment,
+                    std::vector<std::string>{
+                        static_cast<const UnaryRangeExprImpl<std::string>&>(
+                            *range)
+                            .value_});
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// the rows visible at timestamp of a term expression on the primary key,
+// resolved through the pk index, in segment order; nullopt for any other
+// predicate
+static std::optional<std::vector<SegOffset>>
+PkTermOffsets(const segcore::SegmentInternalInterface& segment,
+              const Expr& predicate,
+              Timestamp timestamp) {
+    auto term = dynamic_cast<const TermExpr*>(&predicate);
+    auto pk_field_id = segment.get_schema().get_primary_field_id();
+    if (term == nullptr || !pk_field_id.has_value() ||
+        term->field_id_ != pk_field_id.value()) {
+        return std::nullopt;
+    }
+    IdArray ids;
+    switch (term->data_type_) {
+        case DataType::INT64: {
+            auto& terms =
+                static_cast<const TermExprImpl<int64_t>&>(*term).terms_;
+            ids.mutable_int_id()->mutable_data()->Add(terms.begin(),
+                                                      terms.end());
+            break;
+        }
+        case DataType::VARCHAR: {
+            auto& terms =
+                static_cast<const TermExprImpl<std::string>&>(*term).terms_;
+            for (auto& pk : terms) {
+                ids.mutable_str_id()->add_data(pk);
+            }
+            break;
+        }
+        default: {
+            return std::nullopt;
+        }
+    }
+    auto offsets = segment.search_ids(ids, timestamp).second;
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+    return offsets;
+}
+
+BitsetType
+ExecPlanNodeVisitor::ExecSearchFilter(
+    const segcore::SegmentInternalInterface& segment,
+    const VectorPlanNode& node,
+    int64_t active_count,
+    Timestamp timestamp,
+    bool& skips_all,
+    const ExprBindings* bindings,
+    QueryProfile* profile,
+    const CancelToken* cancel_token) {
+    BitsetType bitset;
+    if (node.predicate_.has_value() &&
+        LacksPartitionKeys(segment, *node.predicate_.value(), bindings)) {
+        // a tenant without rows in the segment
+        skips_all = true;
+        return BitsetType(active_count, true);
+    }
+    if (node.predicate_.has_value()) {
+        bitset = ExecPredicate(segment,
+                               *node.predicate_.value(),
+                               node.predicate_fingerprint_,
+                               bindings,
+                               profile,
+                               cancel_token,
+                               active_count,
+                               timestamp);
+    } else {
+        bitset = BitsetType(active_count, true);
+    }
+    ProfileTimer timer(profile, "mask_skipped");
+    bool cached = false;
+    skips_all = segment.mask_skipped(bitset, active_count, timestamp, &cached);
+    if (profile != nullptr) {
+        ++(cached ? profile->delete_cache_hits_
+                  : profile->delete_cache_misses_);
+    }
+    return bitset;
+}
+
+// the best hit of each value of the group by field, topk of them per
+// query: twice as many hits are fetched again while a query is short of
+// groups and its hits were not all the rows the filter left
+template <typename SearchFunc>
+static SearchResult
+GroupBySearch(const segcore::SegmentInternalInterface& segment,
+              const SearchInfo& info,
+              int64_t num_queries,
+              int64_t candidates,
+              SearchFunc&& search) {
+    auto topk = info.topk_;
+    auto field_id = info.group_by_field_id_.value();
+    auto fetch_info = info;
+    auto fetch = topk * GROUP_BY_FETCH_FACTOR;
+    while (true) {
+        CheckCancel(info.cancel_token_);
+        fetch_info.topk_ = std::max<int64_t>(std::min(fetch, candidates), 1);
+        ParseSearchParams(fetch_info);
+        SearchResult hits;
+        search(fetch_info, hits);
+
+        // the values of the valid hits
+        auto& hit_offsets = hits.seg_offsets_;
+        std::vector<int64_t> offsets;
+        for (auto offset : hit_offsets) {
+            if (offset != INVALID_SEG_OFFSET) {
+                offsets.push_back(offset);
+            }
+        }
+        auto values =
+            segment.group_by_values(field_id, offsets.data(), offsets.size());
+
+        SearchResult grouped;
+        grouped.total_nq_ = num_queries;
+        grouped.unity_topK_ = topk;
+        grouped.seg_offsets_.assign(num_queries * topk, INVALID_SEG_OFFSET);
+        grouped.distances_.assign(
+            num_queries * topk, SubSearchResult::init_value(info.metric_type_));
+        grouped.group_by_values_.resize(num_queries * topk);
+        grouped.search_strategy_ = hits.search_strategy_;
+        grouped.index_chunks_ = hits.index_chunks_;
+        grouped.brute_force_chunks_ = hits.brute_force_chunks_;
+
+        auto k = hits.unity_topK_;
+        bool complete = true;
+        size_t next_value = 0;
+        std::unordered_set<PkType> seen;
+        for (int64_t q = 0; q < num_queries; ++q) {
+            seen.clear();
+            int64_t groups = 0;
+            bool exhausted = false;
+            for (int64_t i = q * k; i < (q + 1) * k; ++i) {
+                if (hit_offsets[i] == INVALID_SEG_OFFSET) {
+                    exhausted = true;
+                    continue;
+                }
+                auto& value = values[next_value++];
+                if (groups == topk || !seen.insert(value).second) {
+                    continue;
+                }
+                auto dst = q * topk + groups++;
+                grouped.seg_offsets_[dst] = hit_offsets[i];
+                grouped.distances_[dst] = hits.distances_[i];
+                grouped.group_by_values_[dst] = std::move(value);
+            }
+            complete = complete && (groups == topk || exhausted);
+        }
+        if (complete || fetch_info.topk_ >= candidates) {
+            return grouped;
+        }
+        fetch *= 2;
+    }
+}
+
+// doubles the ef of a graph index and the nprobe of an ivf one in
+// params, up to max_breadth; false if neither could grow
+static bool
+WidenSearchParams(knowhere::Json& params, int64_t max_breadth) {
+    bool widened = false;
+    for (auto key : {knowhere::indexparam::EF, knowhere::indexparam::NPROBE}) {
+        if (!params.contains(key)) {
+            continue;
+        }
+        auto breadth = params[key].get<int64_t>();
+        if (breadth < max_breadth) {
+            params[key] = std::min(std::max<int64_t>(breadth, 1) * 2,
+                                   max_breadth);
+            widened = true;
+        }
+    }
+    return widened;
+}
+
+// the walk of a graph index around filtered rows runs out of unfiltered
+// nodes before it finds topk of them: the queries of result with fewer
+// valid hits than expected are searched again with twice the breadth
+// while the budget lasts, then by brute force over the filtered rows once
+// the breadth can not grow. returns the queries searched again
+template <typename SearchFunc>
+static int64_t
+WidenShortQueries(const SearchInfo& info,
+                  const char* queries,
+                  int64_t query_bytes,
+                  int64_t expected,
+                  int64_t max_breadth,
+                  bool can_brute_force,
+                  SearchFunc&& search,
+                  SearchResult& result) {
+    auto& config = segcore::SegcoreConfig::default_config();
+    auto budget = config.get_filtered_search_budget_ms();
+    if (budget == 0 || info.GetParams()->radius_.has_value()) {
+        return 0;
+    }
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(budget);
+    auto topk = result.unity_topK_;
+    auto wider = info;
+    std::unordered_set<int64_t> widened;
+    std::vector<int64_t> short_queries;
+    std::vector<char> packed;
+    while (std::chrono::steady_clock::now() < deadline) {
+        CheckCancel(info.cancel_token_);
+        short_queries.clear();
+        for (int64_t q = 0; q < result.total_nq_; ++q) {
+            auto hits = result.seg_offsets_.begin() + q * topk;
+            if (topk - std::count(hits, hits + topk, INVALID_SEG_OFFSET) <
+                expected) {
+                short_queries.push_back(q);
+            }
+        }
+        if (short_queries.empty()) {
+            break;
+        }
+        auto brute_force = !WidenSearchParams(wider.search_params_,
+                                              max_breadth);
+        if (brute_force && !can_brute_force) {
+            break;
+        }
+        ParseSearchParams(wider);
+        packed.resize(short_queries.size() * query_bytes);
+        for (size_t i = 0; i < short_queries.size(); ++i) {
+            std::memcpy(packed.data() + i * query_bytes,
+                        queries + short_queries[i] * query_bytes,
+                        query_bytes);
+        }
+        SearchResult retried;
+        search(
+            wider, packed.data(), short_queries.size(), brute_force, retried);
+        AssertInfo(retried.unity_topK_ == topk,
+                   "widened search returned another topk");
+        for (size_t i = 0; i < short_queries.size(); ++i) {
+            auto dst = short_queries[i] * topk;
+            std::copy_n(retried.seg_offsets_.begin() + i * topk,
+                        topk,
+                        result.seg_offsets_.begin() + dst);
+            std::copy_n(retried.distances_.begin() + i * topk,
+                        topk,
+                        result.distances_.begin() + dst);
+            widened.insert(short_queries[i]);
+        }
+        if (brute_force) {
+            break;
+        }
+    }
+    return widened.size();
+}
+
+// appends the hits of the next queries, searched in slice, to result
+static void
+AppendSearchResult(SearchResult& result, const SearchResult& slice) {
+    AssertInfo(result.unity_topK_ == slice.unity_topK_,
+               "slices of a search returned different topks");
+    result.seg_offsets_.insert(result.seg_offsets_.end(),
+                               slice.seg_offsets_.begin(),
+                               slice.seg_offsets_.end());
+    result.distances_.insert(result.distances_.end(),
+                             slice.distances_.begin(),
+                             slice.distances_.end());
+    result.total_nq_ += slice.total_nq_;
+}
+
+// expands the hits of the distinct queries of a batch to all of its
+// queries, query i taking those of distinct query unique_of[i]
+static void
+FanOutQueries(SearchResult& result, const std::vector<int64_t>& unique_of) {
+    auto topk = result.unity_topK_;
+    auto num_queries = int64_t(unique_of.size());
+    auto fan_out = [&](auto& values) {
+        if (values.empty()) {
+            return;
+        }
+        std::remove_reference_t<decltype(values)> expanded;
+        expanded.reserve(num_queries * topk);
+        for (auto unique : unique_of) {
+            auto begin = values.begin() + unique * topk;
+            expanded.insert(expanded.end(), begin, begin + topk);
+        }
+        values = std::move(expanded);
+    };
+    fan_out(result.seg_offsets_);
+    fan_out(result.distances_);
+    fan_out(result.group_by_values_);
+    result.total_nq_ = num_queries;
+}
+
+// the key of the search result cache for the queries of ph searched by
+// node: everything the hits of a segment depend on besides its data.
+// nullopt for a predicate without a fingerprint
+static std::optional<std::string>
+SearchCacheKey(const VectorPlanNode& node,
+               const Placeholder& ph,
+               const ExprBindings* bindings) {
+    if (node.predicate_.has_value() && node.predicate_fingerprint_.empty()) {
+        return std::nullopt;
+    }
+    auto& info = node.search_info_;
+    std::string key;
+    // length prefixed, so that no two searches share a key
+    auto append = [&](const void* data, size_t size) {
+        auto length = uint64_t(size);
+        key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        key.append(static_cast<const char*>(data), size);
+    };
+    auto append_string = [&](const std::string& value) {
+        append(value.data(), value.size());
+    };
+    int64_t scalars[] = {info.field_id_.get(),
+                         info.topk_,
+                         info.round_decimal_,
+                         info.group_by_field_id_.has_value()
+                             ? info.group_by_field_id_->get()
+                             : -1};
+    append(scalars, sizeof(scalars));
+    append_string(info.metric_type_);
+    append_string(info.search_params_.dump());
+    append_string(node.predicate_fingerprint_);
+    append_string(bindings == nullptr ? std::string() : bindings->fingerprint_);
+    append(ph.data_, ph.num_of_queries_ * ph.line_sizeof_);
+    return key;
+}
+
+QueryScheduler::Ticket
+ExecPlanNodeVisitor::AcquireTicket(int64_t num_queries) {
+    ProfileTimer timer(profile_, "queue_wait");
+    return QueryScheduler::GetInstance().Acquire(
+        tenant_, tenant_weight_, num_queries);
+}
+
 template <typename VectorType>
 void
 ExecPlanNodeVisitor::VectorVisitorImpl(VectorPlanNode& node) {
@@ -82,45 +565,406 @@ ExecPlanNodeVisitor::VectorVisitorImpl(VectorPlanNode& node) {
     AssertInfo(segment, "support SegmentSmallIndex Only");
     SearchResult search_result;
     auto& ph = placeholder_group_->at(0);
-    auto src_data = ph.get_blob<EmbeddedType<VectorType>>();
-    auto num_queries = ph.num_of_queries_;
+    // repeated queries of the batch are searched once, see FanOutQueries
+    auto dedup = !ph.unique_of_.empty();
+    auto src_data =
+        dedup ? reinterpret_cast<const EmbeddedType<VectorType>*>(
+                    ph.unique_data_)
+              : ph.get_blob<EmbeddedType<VectorType>>();
+    auto num_queries = dedup ? ph.num_of_unique_queries_ : ph.num_of_queries_;
 
     // TODO: add API to unify row_count
     // auto row_count = segment->get_row_count();
     auto active_count = segment->get_active_count(timestamp_);
 
+    if (profile_ != nullptr) {
+        ++profile_->segments_;
+        profile_->active_rows_ += active_count;
+    }
+
     // skip all calculation
     if (active_count == 0) {
         search_result_opt_ =
-            empty_search_result(num_queries, node.search_info_);
+            empty_search_result(ph.num_of_queries_, node.search_info_);
         return;
     }
 
-    std::unique_ptr<BitsetType> bitset_holder;
-    if (node.predicate_.has_value()) {
-        bitset_holder = std::make_unique<BitsetType>(
-            ExecExprVisitor(*segment, active_count, timestamp_)
-                .call_child(*node.predicate_.value()));
-        bitset_holder->flip();
-    } else {
-        bitset_holder = std::make_unique<BitsetType>(active_count, false);
+    auto& field = segment->get_schema()[node.search_info_.field_id_];
+    // a search narrowed by the bound of its request is not reusable
+    int64_t del_barrier = 0;
+    auto cache = search_bound_ != nullptr || field.is_sparse_vector()
+                     ? nullptr
+                     : segment->get_search_cache(timestamp_, del_barrier);
+    std::optional<std::string> cache_key;
+    if (cache != nullptr) {
+        cache_key = SearchCacheKey(node, ph, bindings_);
+    }
+    auto cache_version = cache != nullptr ? cache->version() : 0;
+    if (cache_key.has_value()) {
+        if (auto cached = cache->Get(cache_key.value(), del_barrier)) {
+            search_result.total_nq_ = cached->total_nq;
+            search_result.unity_topK_ = cached->unity_topk;
+            search_result.distances_ = cached->distances;
+            search_result.seg_offsets_ = cached->seg_offsets;
+            search_result.group_by_values_ = cached->group_by_values;
+            search_result.search_strategy_ = cached->search_strategy;
+            search_result.filtered_rows_ = cached->filtered_rows;
+            if (profile_ != nullptr) {
+                ++profile_->search_cache_hits_;
+                profile_->filtered_rows_ += cached->filtered_rows;
+            }
+            search_result_opt_ = std::move(search_result);
+            return;
+        }
+    }
+
+    bool skips_all = false;
+    auto bitset_holder = ExecSearchFilter(*segment,
+                                          node,
+                                          active_count,
+                                          timestamp_,
+                                          skips_all,
+                                          bindings_,
+                                          profile_,
+                                          cancel_token_);
+    if (skips_all) {
+        search_result_opt_ =
+            empty_search_result(ph.num_of_queries_, node.search_info_);
+        return;
+    }
+    BitsetView final_view = bitset_holder;
+
+    // the info of the plan is shared, a search adjusting it copies it
+    auto* search_info = &node.search_info_;
+    std::optional<SearchInfo> local_info;
+    // a range search sharing the bound of its request needs no hit beyond
+    // the topk the segments searched before found
+    if (search_bound_ != nullptr &&
+        node.search_info_.GetParams()->radius_.has_value()) {
+        local_info = node.search_info_;
+        local_info->search_params_[RADIUS] = search_bound_->Radius();
+        ParseSearchParams(*local_info);
+        search_info = &*local_info;
+    }
+    if (cancel_token_ != nullptr) {
+        if (!local_info.has_value()) {
+            local_info = node.search_info_;
+            search_info = &*local_info;
+        }
+        local_info->cancel_token_ = cancel_token_;
+    }
+
+    // an index searched around almost all of its rows degrades, HNSW
+    // walks the filtered nodes; brute force the few rows left instead
+    auto filtered_rows = active_count - int64_t(bitset_holder.count());
+    auto selectivity =
+        segcore::SegcoreConfig::default_config().get_prefilter_selectivity();
+    auto prefilter = filtered_rows < selectivity * active_count &&
+                     segment->has_raw_vectors(node.search_info_.field_id_);
+    std::vector<SegOffset> prefilter_rows;
+    if (prefilter) {
+        prefilter_rows = segment->search_ids(final_view, timestamp_);
+    }
+    auto max_breadth = std::min(std::max(active_count, search_info->topk_),
+                                MAX_SEARCH_BREADTH);
+    int64_t widened_queries = 0;
+    auto search_slice = [&](SearchInfo& info,
+                            const char* queries,
+                            int64_t count,
+                            SearchResult& result) {
+        if (prefilter) {
+            segment->vector_search_rows(
+                info, queries, count, prefilter_rows, result);
+            result.search_strategy_ = SearchStrategy::PreFilter;
+            return;
+        }
+        segment->vector_search(
+            info, queries, count, timestamp_, final_view, result);
+        auto retry = [&](SearchInfo& wider,
+                         const void* queries,
+                         int64_t count,
+                         bool brute_force,
+                         SearchResult& retried) {
+            if (!brute_force) {
+                segment->vector_search(
+                    wider, queries, count, timestamp_, final_view, retried);
+                return;
+            }
+            if (prefilter_rows.empty()) {
+                prefilter_rows = segment->search_ids(final_view, timestamp_);
+            }
+            segment->vector_search_rows(
+                info, queries, count, prefilter_rows, retried);
+        };
+        widened_queries += WidenShortQueries(
+            info,
+            queries,
+            field.get_sizeof(),
+            std::min(info.topk_, filtered_rows),
+            max_breadth,
+            segment->has_raw_vectors(info.field_id_),
+            retry,
+            result);
+    };
+    // a large request queues for every slice of its queries
+    auto slice_nq =
+        segcore::SegcoreConfig::default_config().get_query_slice_nq();
+    auto search = [&](SearchInfo& info, SearchResult& result) {
+        auto queries = reinterpret_cast<const char*>(src_data);
+        auto query_bytes = field.get_sizeof();
+        for (int64_t begin = 0; begin < num_queries; begin += slice_nq) {
+            auto count = std::min(slice_nq, num_queries - begin);
+            auto ticket = AcquireTicket(count);
+            if (begin == 0) {
+                search_slice(info, queries, count, result);
+                continue;
+            }
+            SearchResult slice;
+            search_slice(info, queries + begin * query_bytes, count, slice);
+            AppendSearchResult(result, slice);
+        }
+    };
+    {
+        ProfileTimer timer(profile_, "vector_search");
+        if (search_info->group_by_field_id_.has_value()) {
+            search_result = GroupBySearch(
+                *segment, *search_info, num_queries, filtered_rows, search);
+        } else {
+            search(*search_info, search_result);
+        }
+    }
+    if (dedup) {
+        FanOutQueries(search_result, ph.unique_of_);
+    }
+    search_result.filtered_rows_ = filtered_rows;
+    if (profile_ != nullptr) {
+        profile_->filtered_rows_ += filtered_rows;
+        profile_->index_chunks_ += search_result.index_chunks_;
+        profile_->brute_force_chunks_ += search_result.brute_force_chunks_;
+        profile_->prefilter_segments_ +=
+            search_result.search_strategy_ == SearchStrategy::PreFilter;
+        profile_->widened_queries_ += widened_queries;
+    }
+    if (cache_key.has_value()) {
+        auto cached = std::make_shared<segcore::CachedSearch>();
+        cached->total_nq = search_result.total_nq_;
+        cached->unity_topk = search_result.unity_topK_;
+        cached->distances = search_result.distances_;
+        cached->seg_offsets = search_result.seg_offsets_;
+        cached->group_by_values = search_result.group_by_values_;
+        cached->search_strategy = search_result.search_strategy_;
+        cached->filtered_rows = filtered_rows;
+        cached->del_barrier = del_barrier;
+        cache->Put(cache_key.value(),
+                   std::move(cached),
+                   cache_version,
+                   segcore::SegcoreConfig::default_config()
+                       .get_search_cache_bytes());
+    }
+
+    search_result_opt_ = std::move(search_result);
+}
+
+static const Placeholder&
+FindPlaceholder(const PlaceholderGroup& group, const std::string& tag) {
+    for (auto& placeholder : group) {
+        if (placeholder.tag_ == tag) {
+            return placeholder;
+        }
+    }
+    PanicInfo("no placeholder for tag " + tag);
+}
+
+// the candidates of a query are the hits of all the fields, each scored on
+// every field: exactly where the raw vectors can be read, as the worst hit
+// of the field for a row it missed otherwise
+static SearchResult
+FuseFieldResults(const segcore::SegmentInternalInterface& segment,
+                 const MultiVectorANNS& node,
+                 const std::vector<const Placeholder*>& placeholders,
+                 const std::vector<SearchResult>& field_results,
+                 int64_t num_queries) {
+    auto& info = node.search_info_;
+    auto descending = PositivelyRelated(info.metric_type_);
+    SubSearchResult fused(
+        num_queries, info.topk_, info.metric_type_, info.round_decimal_);
+    std::vector<SegOffset> candidates;
+    std::vector<float> scores;
+    std::vector<float> distances;
+    std::vector<int64_t> order;
+    for (int64_t q = 0; q < num_queries; ++q) {
+        candidates.clear();
+        for (auto& result : field_results) {
+            auto topk = result.unity_topK_;
+            for (int64_t i = q * topk; i < (q + 1) * topk; ++i) {
+                if (result.seg_offsets_[i] != INVALID_SEG_OFFSET) {
+                    candidates.emplace_back(result.seg_offsets_[i]);
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                         candidates.end());
+        if (candidates.empty()) {
+            continue;
+        }
+        auto position = [&](int64_t offset) {
+            return std::lower_bound(candidates.begin(),
+                                    candidates.end(),
+                                    SegOffset(offset)) -
+                   candidates.begin();
+        };
+
+        auto num_candidates = int64_t(candidates.size());
+        scores.assign(num_candidates, 0);
+        for (size_t f = 0; f < node.fields_.size(); ++f) {
+            auto& field = node.fields_[f];
+            auto& placeholder = *placeholders[f];
+            auto& result = field_results[f];
+            auto topk = result.unity_topK_;
+            if (segment.has_raw_vectors(field.search_info_.field_id_)) {
+                auto search_info = field.search_info_;
+                search_info.topk_ = num_candidates;
+                SearchResult rescored;
+                segment.vector_search_rows(
+                    search_info,
+                    placeholder.data_ + q * placeholder.line_sizeof_,
+                    1,
+                    candidates,
+                    rescored);
+                distances.assign(num_candidates, 0);
+                for (int64_t i = 0; i < num_candidates; ++i) {
+                    distances[position(rescored.seg_offsets_[i])] =
+                        rescored.distances_[i];
+                }
+            } else {
+                auto worst = SubSearchResult::init_value(info.metric_type_);
+                for (int64_t i = q * topk; i < (q + 1) * topk; ++i) {
+                    if (result.seg_offsets_[i] != INVALID_SEG_OFFSET) {
+                        worst = result.distances_[i];
+                    }
+                }
+                distances.assign(num_candidates, worst);
+                for (int64_t i = q * topk; i < (q + 1) * topk; ++i) {
+                    if (result.seg_offsets_[i] != INVALID_SEG_OFFSET) {
+                        distances[position(result.seg_offsets_[i])] =
+                            result.distances_[i];
+                    }
+                }
+            }
+            for (int64_t i = 0; i < num_candidates; ++i) {
+                scores[i] += field.weight_ * distances[i];
+            }
+        }
+
+        // ties go to the smaller offset, candidates are sorted by it
+        order.resize(num_candidates);
+        std::iota(order.begin(), order.end(), 0);
+        auto kept = std::min(info.topk_, num_candidates);
+        std::partial_sort(order.begin(),
+                          order.begin() + kept,
+                          order.end(),
+                          [&](int64_t a, int64_t b) {
+                              if (scores[a] != scores[b]) {
+                                  return descending ? scores[a] > scores[b]
+                                                    : scores[a] < scores[b];
+                              }
+                              return a < b;
+                          });
+        for (int64_t i = 0; i < kept; ++i) {
+            fused.get_seg_offsets()[q * info.topk_ + i] =
+                candidates[order[i]].get();
+            fused.get_distances()[q * info.topk_ + i] = scores[order[i]];
+        }
     }
-    segment->mask_with_timestamps(*bitset_holder, timestamp_);
+    fused.round_values();
 
-    segment->mask_with_delete(*bitset_holder, active_count, timestamp_);
-    // if bitset_holder is all 1's, we got empty result
-    if (bitset_holder->all()) {
+    SearchResult search_result;
+    search_result.total_nq_ = num_queries;
+    search_result.unity_topK_ = info.topk_;
+    search_result.seg_offsets_ = std::move(fused.mutable_seg_offsets());
+    search_result.distances_ = std::move(fused.mutable_distances());
+    return search_result;
+}
+
+// one filter and one delete mask for all the fields, searched in turn
+void
+ExecPlanNodeVisitor::visit(MultiVectorANNS& node) {
+    assert(!search_result_opt_.has_value());
+    auto segment =
+        dynamic_cast<const segcore::SegmentInternalInterface*>(&segment_);
+    AssertInfo(segment, "support SegmentSmallIndex Only");
+    std::vector<const Placeholder*> placeholders;
+    for (auto& field : node.fields_) {
+        placeholders.push_back(
+            &FindPlaceholder(*placeholder_group_, field.placeholder_tag_));
+    }
+    auto num_queries = placeholders[0]->num_of_queries_;
+    for (auto placeholder : placeholders) {
+        AssertInfo(placeholder->num_of_queries_ == num_queries,
+                   "the fields of a multi vector search have different "
+                   "numbers of queries");
+    }
+
+    auto active_count = segment->get_active_count(timestamp_);
+    if (profile_ != nullptr) {
+        ++profile_->segments_;
+        profile_->active_rows_ += active_count;
+    }
+    if (active_count == 0) {
         search_result_opt_ =
             empty_search_result(num_queries, node.search_info_);
         return;
     }
-    BitsetView final_view = *bitset_holder;
-    segment->vector_search(node.search_info_,
-                           src_data,
-                           num_queries,
-                           timestamp_,
-                           final_view,
-                           search_result);
+
+    bool skips_all = false;
+    auto bitset_holder = ExecSearchFilter(*segment,
+                                          node,
+                                          active_count,
+                                          timestamp_,
+                                          skips_all,
+                                          bindings_,
+                                          profile_,
+                                          cancel_token_);
+    if (skips_all) {
+        search_result_opt_ =
+            empty_search_result(num_queries, node.search_info_);
+        return;
+    }
+    BitsetView final_view = bitset_holder;
+
+    SearchResult search_result;
+    {
+        auto ticket = AcquireTicket(num_queries);
+        ProfileTimer timer(profile_, "vector_search");
+        std::vector<SearchResult> field_results(node.fields_.size());
+        for (size_t f = 0; f < node.fields_.size(); ++f) {
+            auto field_info = node.fields_[f].search_info_;
+            field_info.cancel_token_ = cancel_token_;
+            segment->vector_search(field_info,
+                                   placeholders[f]->data_,
+                                   num_queries,
+                                   timestamp_,
+                                   final_view,
+                                   field_results[f]);
+            search_result.index_chunks_ += field_results[f].index_chunks_;
+            search_result.brute_force_chunks_ +=
+                field_results[f].brute_force_chunks_;
+        }
+        auto fused = FuseFieldResults(
+            *segment, node, placeholders, field_results, num_queries);
+        search_result.total_nq_ = fused.total_nq_;
+        search_result.unity_topK_ = fused.unity_topK_;
+        search_result.seg_offsets_ = std::move(fused.seg_offsets_);
+        search_result.distances_ = std::move(fused.distances_);
+    }
+    auto filtered_rows = active_count - int64_t(bitset_holder.count());
+    search_result.filtered_rows_ = filtered_rows;
+    if (profile_ != nullptr) {
+        profile_->filtered_rows_ += filtered_rows;
+        profile_->index_chunks_ += search_result.index_chunks_;
+        profile_->brute_force_chunks_ += search_result.brute_force_chunks_;
+    }
 
     search_result_opt_ = std::move(search_result);
 }
@@ -140,24 +984,68 @@ ExecPlanNodeVisitor::visit(RetrievePlanNode& node) {
         return;
     }
 
+    auto limit = node.limit_ > 0 ? node.limit_ + node.offset_ : -1;
+    // a point lookup by primary keys checks only the rows of those keys
+    if (node.predicate_ != nullptr && node.param_slots_.empty() &&
+        node.aggregates_.empty()) {
+        auto offsets = PkTermOffsets(*segment, *node.predicate_, timestamp_);
+        if (offsets.has_value()) {
+            auto& seg_offsets = offsets.value();
+            seg_offsets.erase(std::lower_bound(seg_offsets.begin(),
+                                               seg_offsets.end(),
+                                               SegOffset(active_count)),
+                              seg_offsets.end());
+            segment->remove_deleted(seg_offsets, active_count, timestamp_);
+            if (node.order_by_pk_) {
+                seg_offsets = segment->order_by_pk(seg_offsets, limit);
+            } else if (limit >= 0 && int64_t(seg_offsets.size()) > limit) {
+                seg_offsets.resize(limit);
+            }
+            retrieve_result.result_offsets_.assign(
+                (int64_t*)seg_offsets.data(),
+                (int64_t*)seg_offsets.data() + seg_offsets.size());
+            retrieve_result_opt_ = std::move(retrieve_result);
+            return;
+        }
+    }
+
+    if (node.predicate_ != nullptr &&
+        LacksPartitionKeys(*segment, *node.predicate_, bindings_)) {
+        retrieve_result_opt_ = std::move(retrieve_result);
+        return;
+    }
+
     BitsetType bitset_holder;
     if (node.predicate_ != nullptr) {
-        bitset_holder = ExecExprVisitor(*segment, active_count, timestamp_)
-                            .call_child(*(node.predicate_));
-        bitset_holder.flip();
+        bitset_holder = ExecPredicate(*segment,
+                                      *node.predicate_,
+                                      node.predicate_fingerprint_,
+                                      bindings_,
+                                      nullptr,
+                                      cancel_token_,
+                                      active_count,
+                                      timestamp_);
     }
 
-    segment->mask_with_timestamps(bitset_holder, timestamp_);
-
-    segment->mask_with_delete(bitset_holder, active_count, timestamp_);
-    // if bitset_holder is all 1's, we got empty result
-    if (bitset_holder.all()) {
+    // nothing matches without a predicate
+    if (bitset_holder.empty() ||
+        segment->mask_skipped(bitset_holder, active_count, timestamp_)) {
         retrieve_result_opt_ = std::move(retrieve_result);
         return;
     }
 
-    BitsetView final_view = bitset_holder;
-    auto seg_offsets = segment->search_ids(final_view, timestamp_);
+    // back to the matching rows, walked set bit by set bit until the
+    // limit is reached
+    bitset_holder.flip();
+    if (!node.aggregates_.empty()) {
+        retrieve_result.matches_ = std::move(bitset_holder);
+        retrieve_result_opt_ = std::move(retrieve_result);
+        return;
+    }
+    auto seg_offsets =
+        node.order_by_pk_
+            ? segment->search_ids_by_pk(bitset_holder, timestamp_, limit)
+            : segment->search_ids(bitset_holder, timestamp_, limit);
     retrieve_result.result_offsets_.assign(
         (int64_t*)seg_offsets.data(),
         (int64_t*)seg_offsets.data() + seg_offsets.size());
@@ -174,4 +1062,63 @@ ExecPlanNodeVisitor::visit(BinaryVectorANNS& node) {
     VectorVisitorImpl<BinaryVector>(node);
 }
 
+// the same filter as the dense fields, without their prefilter, widening
+// or group by; the segment searches its rows or their inverted index
+void
+ExecPlanNodeVisitor::visit(SparseFloatVectorANNS& node) {
+    assert(!search_result_opt_.has_value());
+    auto segment =
+        dynamic_cast<const segcore::SegmentInternalInterface*>(&segment_);
+    AssertInfo(segment, "support SegmentSmallIndex Only");
+    auto& ph = placeholder_group_->at(0);
+    auto active_count = segment->get_active_count(timestamp_);
+    if (profile_ != nullptr) {
+        ++profile_->segments_;
+        profile_->active_rows_ += active_count;
+    }
+    if (active_count == 0) {
+        search_result_opt_ =
+            empty_search_result(ph.num_of_queries_, node.search_info_);
+        return;
+    }
+
+    bool skips_all = false;
+    auto bitset_holder = ExecSearchFilter(*segment,
+                                          node,
+                                          active_count,
+                                          timestamp_,
+                                          skips_all,
+                                          bindings_,
+                                          profile_,
+                                          cancel_token_);
+    if (skips_all) {
+        search_result_opt_ =
+            empty_search_result(ph.num_of_queries_, node.search_info_);
+        return;
+    }
+    BitsetView final_view = bitset_holder;
+
+    auto search_info = node.search_info_;
+    search_info.cancel_token_ = cancel_token_;
+    SearchResult search_result;
+    {
+        ProfileTimer timer(profile_, "vector_search");
+        auto ticket = AcquireTicket(ph.num_of_queries_);
+        segment->sparse_search(search_info,
+                               ph.get_blob<SparseFloatRow>(),
+                               ph.num_of_queries_,
+                               timestamp_,
+                               final_view,
+                               search_result);
+    }
+    auto filtered_rows = active_count - int64_t(bitset_holder.count());
+    search_result.filtered_rows_ = filtered_rows;
+    if (profile_ != nullptr) {
+        profile_->filtered_rows_ += filtered_rows;
+        profile_->index_chunks_ += search_result.index_chunks_;
+        profile_->brute_force_chunks_ += search_result.brute_force_chunks_;
+    }
+    search_result_opt_ = std::move(search_result);
+}
+
 }  // namespace milvus::query
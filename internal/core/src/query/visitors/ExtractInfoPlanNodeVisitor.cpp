@@ -47,6 +47,26 @@ ExtractInfoPlanNodeVisitor::visit(BinaryVectorANNS& node) {
     }
 }
 
+void
+ExtractInfoPlanNodeVisitor::visit(SparseFloatVectorANNS& node) {
+    plan_info_.add_involved_field(node.search_info_.field_id_);
+    if (node.predicate_.has_value()) {
+        ExtractInfoExprVisitor expr_visitor(plan_info_);
+        node.predicate_.value()->accept(expr_visitor);
+    }
+}
+
+void
+ExtractInfoPlanNodeVisitor::visit(MultiVectorANNS& node) {
+    for (auto& field : node.fields_) {
+        plan_info_.add_involved_field(field.search_info_.field_id_);
+    }
+    if (node.predicate_.has_value()) {
+        ExtractInfoExprVisitor expr_visitor(plan_info_);
+        node.predicate_.value()->accept(expr_visitor);
+    }
+}
+
 void
 ExtractInfoPlanNodeVisitor::visit(RetrievePlanNode& node) {
     // Assert(node.predicate_.has_value());
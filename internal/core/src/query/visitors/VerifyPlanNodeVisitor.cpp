@@ -70,6 +70,14 @@ void
 VerifyPlanNodeVisitor::visit(BinaryVectorANNS&) {
 }
 
+void
+VerifyPlanNodeVisitor::visit(SparseFloatVectorANNS&) {
+}
+
+void
+VerifyPlanNodeVisitor::visit(MultiVectorANNS&) {
+}
+
 void
 VerifyPlanNodeVisitor::visit(RetrievePlanNode&) {
 }
@@ -12,9 +12,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <map>
 #include <mutex>
-#include <set>
-#include <shared_mutex>
 
 namespace milvus::segcore {
 
@@ -40,18 +40,38 @@ example() {
 }
 #endif
 
+// Finished segments are published in a ring of slots keyed by their
+// begin, and whoever finishes or finds the segment starting at the ack
+// moves the ack past it with a CAS, so concurrent inserts and deletes
+// don't serialize on a lock. A segment whose slot is taken by another
+// pending one goes to a locked map instead, which only slow consumers
+// of many out of order segments ever reach.
 class AckResponder {
  public:
+    AckResponder() {
+        for (auto& slot : slots_) {
+            slot.begin = empty_slot;
+        }
+    }
+
     // specify that segment [seg_begin, seg_end) has been processed
     // WARN: segments shouldn't overlap
     void
     AddSegment(int64_t seg_begin, int64_t seg_end) {
-        std::lock_guard lck(mutex_);
-        fetch_and_flip(seg_end);
-        auto old_begin = fetch_and_flip(seg_begin);
-        if (old_begin) {
-            minimum_ = *acks_.begin();
+        if (seg_begin == seg_end) {
+            return;
         }
+        auto& slot = slots_[slot_of(seg_begin)];
+        auto expected = empty_slot;
+        if (slot.begin.compare_exchange_strong(expected, busy_slot)) {
+            slot.end.store(seg_end);
+            slot.begin.store(seg_begin);
+        } else {
+            std::lock_guard lck(mutex_);
+            overflow_.emplace(seg_begin, seg_end);
+            overflow_size_.fetch_add(1);
+        }
+        advance();
     }
 
     // return ack
@@ -61,20 +81,56 @@ class AckResponder {
     }
 
  private:
-    bool
-    fetch_and_flip(int64_t endpoint) {
-        if (acks_.count(endpoint)) {
-            acks_.erase(endpoint);
-            return true;
-        } else {
-            acks_.insert(endpoint);
-            return false;
+    static constexpr int64_t num_slots = 256;
+    static constexpr int64_t empty_slot = -1;
+    // claimed, its end not written yet
+    static constexpr int64_t busy_slot = -2;
+
+    struct Slot {
+        std::atomic<int64_t> begin;
+        std::atomic<int64_t> end;
+    };
+
+    static int64_t
+    slot_of(int64_t begin) {
+        // batches are often of one size, spread their begins
+        return (uint64_t(begin) * 0x9e3779b97f4a7c15ULL) >> 56;
+    }
+
+    // moves the ack over the published segments that continue it; the
+    // segment starting at the ack is taken by the one CAS moving past it
+    void
+    advance() {
+        while (true) {
+            auto ack = minimum_.load();
+            auto& slot = slots_[slot_of(ack)];
+            if (slot.begin.load() == ack) {
+                auto end = slot.end.load();
+                if (minimum_.compare_exchange_strong(ack, end)) {
+                    slot.begin.store(empty_slot);
+                }
+                continue;
+            }
+            if (overflow_size_.load() == 0) {
+                return;
+            }
+            std::lock_guard lck(mutex_);
+            auto iter = overflow_.find(ack);
+            if (iter == overflow_.end() || minimum_.load() != ack) {
+                return;
+            }
+            auto end = iter->second;
+            overflow_.erase(iter);
+            overflow_size_.fetch_sub(1);
+            minimum_.store(end);
         }
     }
 
  private:
-    std::shared_mutex mutex_;
-    std::set<int64_t> acks_ = {0};
+    Slot slots_[num_slots];
+    std::mutex mutex_;
+    std::map<int64_t, int64_t> overflow_;
+    std::atomic<int64_t> overflow_size_ = 0;
     std::atomic<int64_t> minimum_ = 0;
 };
 }  // namespace milvus::segcore
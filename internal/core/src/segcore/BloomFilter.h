@@ -0,0 +1,112 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "PkFingerprint.h"
+
+namespace milvus::segcore {
+
+// Blocked bloom filter: a key sets one bit in each of the eight words of
+// a single cache line sized block, so a probe touches one cache line and
+// its eight word tests have no branches in between.
+class BlockedBloomFilter {
+ public:
+    static constexpr int64_t words_per_block = 8;
+    static constexpr int64_t bits_per_block = words_per_block * 64;
+
+    BlockedBloomFilter() = default;
+
+    // under 1% false positives at the default bits_per_key
+    explicit BlockedBloomFilter(int64_t num_keys, int64_t bits_per_key = 12)
+        : blocks_(std::max<int64_t>(
+              1, (num_keys * bits_per_key + bits_per_block - 1) /
+                     bits_per_block)) {
+    }
+
+    void
+    add(uint64_t hash) {
+        auto& block = blocks_[block_index(hash)];
+        for (int64_t i = 0; i < words_per_block; ++i) {
+            block.words[i] |= bit_of(hash, i);
+        }
+    }
+
+    bool
+    may_contain(uint64_t hash) const {
+        if (blocks_.empty()) {
+            return true;
+        }
+        auto& block = blocks_[block_index(hash)];
+        uint64_t missing = 0;
+        for (int64_t i = 0; i < words_per_block; ++i) {
+            missing |= bit_of(hash, i) & ~block.words[i];
+        }
+        return missing == 0;
+    }
+
+    int64_t
+    memory_usage() const {
+        return blocks_.size() * sizeof(Block);
+    }
+
+    // the fingerprint of a pk
+    template <typename T>
+    static uint64_t
+    hash(const T& key) {
+        if constexpr (std::is_same_v<T, std::string> ||
+                      std::is_same_v<T, std::string_view>) {
+            return PkFingerprint(std::string_view(key));
+        } else {
+            return PkFingerprint(static_cast<int64_t>(key));
+        }
+    }
+
+ private:
+    struct alignas(64) Block {
+        uint64_t words[words_per_block] = {};
+    };
+
+    // the high half of the hash picks the block
+    int64_t
+    block_index(uint64_t hash) const {
+        return ((hash >> 32) * blocks_.size()) >> 32;
+    }
+
+    // the low half picks one bit per word, through a different odd salt
+    // per word
+    static uint64_t
+    bit_of(uint64_t hash, int64_t word) {
+        static constexpr uint32_t salts[words_per_block] = {0x47b6137bU,
+                                                            0x44974d91U,
+                                                            0x8824ad5bU,
+                                                            0xa2b7289dU,
+                                                            0x705495c7U,
+                                                            0x2df1424bU,
+                                                            0x9efc4947U,
+                                                            0x5c6bfb31U};
+        auto bit = (static_cast<uint32_t>(hash) * salts[word]) >> 26;
+        return uint64_t(1) << bit;
+    }
+
+ private:
+    std::vector<Block> blocks_;
+};
+
+}  // namespace milvus::segcore
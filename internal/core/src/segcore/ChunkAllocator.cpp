@@ -0,0 +1,199 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/ChunkAllocator.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "exceptions/EasyAssert.h"
+#include "fmt/core.h"
+#include "log/Log.h"
+#include "segcore/SegcoreConfig.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+size_t
+AlignUp(size_t bytes, size_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+// huge chunks are laid out for huge pages whether or not they are
+// enabled, so a chunk is rounded the same when it is released
+size_t
+AlignmentOf(size_t bytes) {
+    return bytes >= ChunkPool::huge_page_bytes ? ChunkPool::huge_page_bytes
+                                               : ChunkPool::page_bytes;
+}
+
+void*
+MapChunk(size_t bytes) {
+    // over-map so the chunk can start on a huge page boundary
+    auto alignment = AlignmentOf(bytes);
+    auto mapped = bytes + alignment - ChunkPool::page_bytes;
+    auto raw = mmap(nullptr,
+                    mapped,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANON,
+                    -1,
+                    0);
+    AssertInfo(raw != MAP_FAILED,
+               fmt::format("failed to map a chunk of {} bytes, err: {}",
+                           bytes,
+                           strerror(errno)));
+    auto begin = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = AlignUp(begin, alignment);
+    if (aligned > begin) {
+        munmap(raw, aligned - begin);
+    }
+    auto tail = begin + mapped - (aligned + bytes);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    auto ptr = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (alignment == ChunkPool::huge_page_bytes &&
+        SegcoreConfig::default_config().get_huge_page_chunks()) {
+        madvise(ptr, bytes, MADV_HUGEPAGE);
+    }
+#endif
+    return ptr;
+}
+
+}  // namespace
+
+ChunkPool&
+ChunkPool::Global() {
+    // never destroyed, chunks of static segments may be released after it
+    static auto pool = new ChunkPool();
+    return *pool;
+}
+
+size_t
+ChunkPool::RoundUp(size_t bytes) {
+    if (bytes < min_pooled_bytes) {
+        return bytes;
+    }
+    return AlignUp(bytes, AlignmentOf(bytes));
+}
+
+void*
+ChunkPool::Allocate(size_t bytes) {
+    auto rounded = RoundUp(bytes);
+    if (rounded < min_pooled_bytes) {
+        // small chunks, which grow on demand row by row, stay on the heap
+        return ::operator new(bytes, std::align_val_t(64));
+    }
+    {
+        std::lock_guard lck(mutex_);
+        auto iter = free_.find(rounded);
+        if (iter != free_.end() && !iter->second.empty()) {
+            auto ptr = iter->second.back();
+            iter->second.pop_back();
+            cached_bytes_ -= rounded;
+            return ptr;
+        }
+    }
+    return MapChunk(rounded);
+}
+
+void
+ChunkPool::Release(void* ptr, size_t bytes) {
+    auto rounded = RoundUp(bytes);
+    if (rounded < min_pooled_bytes) {
+        ::operator delete(ptr, std::align_val_t(64));
+        return;
+    }
+    auto capacity = SegcoreConfig::default_config().get_chunk_pool_bytes();
+    {
+        std::lock_guard lck(mutex_);
+        if (cached_bytes_ + int64_t(rounded) <= capacity) {
+            free_[rounded].push_back(ptr);
+            cached_bytes_ += rounded;
+            return;
+        }
+    }
+    munmap(ptr, rounded);
+}
+
+bool
+ChunkPool::Spill(void* ptr, size_t bytes, const std::string& dir) {
+    auto rounded = RoundUp(bytes);
+    if (rounded < min_pooled_bytes) {
+        return false;
+    }
+    auto path = dir + "/chunk-XXXXXX";
+    int fd = mkstemp(path.data());
+    if (fd == -1) {
+        LOG_SEGCORE_WARNING_ << "failed to create a chunk file under " << dir
+                             << ", err: " << strerror(errno);
+        return false;
+    }
+    // the pages go with the last mapping
+    unlink(path.c_str());
+    auto src = static_cast<const char*>(ptr);
+    size_t written = 0;
+    while (written < rounded) {
+        auto n = pwrite(fd, src + written, rounded - written, written);
+        if (n <= 0) {
+            break;
+        }
+        written += n;
+    }
+    // mapped aside first, a failure leaves the chunk untouched, then
+    // moved over the chunk in one step
+    void* mapped = MAP_FAILED;
+    if (written == rounded) {
+        mapped = mmap(
+            nullptr, rounded, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    auto err = errno;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_SEGCORE_WARNING_ << "failed to spill a chunk of " << rounded
+                             << " bytes to " << dir
+                             << ", err: " << strerror(err);
+        return false;
+    }
+    auto moved =
+        mremap(mapped, rounded, rounded, MREMAP_MAYMOVE | MREMAP_FIXED, ptr);
+    if (moved == MAP_FAILED) {
+        LOG_SEGCORE_WARNING_ << "failed to move a spilled chunk, err: "
+                             << strerror(errno);
+        munmap(mapped, rounded);
+        return false;
+    }
+    return true;
+}
+
+void
+ChunkPool::ReleaseSpilled(void* ptr, size_t bytes) {
+    munmap(ptr, RoundUp(bytes));
+}
+
+void
+ChunkPool::Clear() {
+    std::lock_guard lck(mutex_);
+    for (auto& [rounded, ptrs] : free_) {
+        for (auto ptr : ptrs) {
+            munmap(ptr, rounded);
+        }
+    }
+    free_.clear();
+    cached_bytes_ = 0;
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,261 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/Numa.h"
+
+namespace milvus::segcore {
+
+// Process-wide cache of chunk memory. The chunks of a released segment
+// are kept, up to SegcoreConfig::get_chunk_pool_bytes, for the chunks of
+// the next segments, so opening a segment does not fault all its pages
+// in again. Chunks of at least min_pooled_bytes are mmap-ed in whole
+// pages; those of 2MB and more are aligned to 2MB and advised for
+// transparent huge pages when enabled. Memory handed out is not zeroed.
+class ChunkPool {
+ public:
+    static constexpr size_t min_pooled_bytes = 64 * 1024;
+    static constexpr size_t page_bytes = 4 * 1024;
+    static constexpr size_t huge_page_bytes = 2 * 1024 * 1024;
+
+    static ChunkPool&
+    Global();
+
+    ChunkPool() = default;
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool&
+    operator=(const ChunkPool&) = delete;
+
+    ~ChunkPool() {
+        Clear();
+    }
+
+    // the bytes an allocation of bytes actually takes
+    static size_t
+    RoundUp(size_t bytes);
+
+    void*
+    Allocate(size_t bytes);
+
+    // bytes as passed to Allocate
+    void
+    Release(void* ptr, size_t bytes);
+
+    // moves the pages of a chunk of bytes to an unlinked file under dir
+    // in place: the file, holding the same bytes, is mapped over the chunk,
+    // so readers go on through the same address while the kernel may
+    // write the pages back and drop them. the chunk must not be written
+    // meanwhile. false if the chunk is not mmap-ed or the file can't be
+    // written or mapped, the chunk is left as it was then
+    static bool
+    Spill(void* ptr, size_t bytes, const std::string& dir);
+
+    // unmaps a spilled chunk, which can't be pooled
+    static void
+    ReleaseSpilled(void* ptr, size_t bytes);
+
+    int64_t
+    cached_bytes() const {
+        std::lock_guard lck(mutex_);
+        return cached_bytes_;
+    }
+
+    // unmap all cached chunks
+    void
+    Clear();
+
+ private:
+    mutable std::mutex mutex_;
+    // cached chunks by rounded size
+    std::unordered_map<size_t, std::vector<void*>> free_;
+    int64_t cached_bytes_ = 0;
+};
+
+// Accounts the chunk memory of one segment, which goes back to the global
+// pool as the chunks are destroyed. Given a NUMA node, the mmap-ed chunks
+// are placed on it, cached ones moved there.
+class ChunkArena {
+ public:
+    void*
+    Allocate(size_t bytes) {
+        auto ptr = ChunkPool::Global().Allocate(bytes);
+        allocated_bytes_ += ChunkPool::RoundUp(bytes);
+        if (numa_node_ >= 0 && bytes >= ChunkPool::min_pooled_bytes) {
+            NumaBind(ptr, ChunkPool::RoundUp(bytes), numa_node_);
+        }
+        return ptr;
+    }
+
+    // before the first allocation
+    void
+    set_numa_node(int node) {
+        numa_node_ = node;
+    }
+
+    void
+    Release(void* ptr, size_t bytes) {
+        ChunkPool::Global().Release(ptr, bytes);
+        allocated_bytes_ -= ChunkPool::RoundUp(bytes);
+    }
+
+    // a spilled chunk is accounted apart from the allocated ones
+    bool
+    Spill(void* ptr, size_t bytes, const std::string& dir) {
+        if (!ChunkPool::Spill(ptr, bytes, dir)) {
+            return false;
+        }
+        allocated_bytes_ -= ChunkPool::RoundUp(bytes);
+        spilled_bytes_ += ChunkPool::RoundUp(bytes);
+        return true;
+    }
+
+    void
+    ReleaseSpilled(void* ptr, size_t bytes) {
+        ChunkPool::ReleaseSpilled(ptr, bytes);
+        spilled_bytes_ -= ChunkPool::RoundUp(bytes);
+    }
+
+    int64_t
+    allocated_bytes() const {
+        return allocated_bytes_;
+    }
+
+    int64_t
+    spilled_bytes() const {
+        return spilled_bytes_;
+    }
+
+ private:
+    std::atomic<int64_t> allocated_bytes_ = 0;
+    std::atomic<int64_t> spilled_bytes_ = 0;
+    int numa_node_ = -1;
+};
+
+// Fixed size chunk of a ConcurrentVector in arena memory. Trivial elements
+// are left uninitialized, set_data overwrites them before they are acked.
+template <typename Type>
+class PooledChunk {
+ public:
+    PooledChunk(int64_t size, ChunkArena* arena) : size_(size), arena_(arena) {
+        if (size_ == 0) {
+            return;
+        }
+        auto bytes = size_ * sizeof(Type);
+        auto ptr = arena_ != nullptr ? arena_->Allocate(bytes)
+                                     : ChunkPool::Global().Allocate(bytes);
+        data_ = static_cast<Type*>(ptr);
+        if constexpr (!std::is_trivial_v<Type>) {
+            std::uninitialized_value_construct_n(data_, size_);
+        }
+    }
+
+    PooledChunk(const PooledChunk&) = delete;
+    PooledChunk&
+    operator=(const PooledChunk&) = delete;
+
+    ~PooledChunk() {
+        release();
+    }
+
+    // frees the elements, leaving an empty chunk
+    void
+    release() {
+        if (data_ == nullptr) {
+            return;
+        }
+        if constexpr (!std::is_trivial_v<Type>) {
+            std::destroy_n(data_, size_);
+        }
+        auto bytes = size_ * sizeof(Type);
+        if (spilled_.load(std::memory_order_relaxed)) {
+            if (arena_ != nullptr) {
+                arena_->ReleaseSpilled(data_, bytes);
+            } else {
+                ChunkPool::ReleaseSpilled(data_, bytes);
+            }
+        } else if (arena_ != nullptr) {
+            arena_->Release(data_, bytes);
+        } else {
+            ChunkPool::Global().Release(data_, bytes);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        spilled_.store(false, std::memory_order_relaxed);
+    }
+
+    // moves the elements to a file under dir, see ChunkPool::Spill; by
+    // one thread at a time, once the elements are all written
+    bool
+    spill(const std::string& dir) {
+        if constexpr (!std::is_trivial_v<Type>) {
+            return false;
+        }
+        if (data_ == nullptr || spilled()) {
+            return false;
+        }
+        auto bytes = size_ * sizeof(Type);
+        auto moved = arena_ != nullptr ? arena_->Spill(data_, bytes, dir)
+                                       : ChunkPool::Spill(data_, bytes, dir);
+        spilled_.store(moved, std::memory_order_relaxed);
+        return moved;
+    }
+
+    bool
+    spilled() const {
+        return spilled_.load(std::memory_order_relaxed);
+    }
+
+    Type*
+    data() {
+        return data_;
+    }
+
+    const Type*
+    data() const {
+        return data_;
+    }
+
+    int64_t
+    size() const {
+        return size_;
+    }
+
+    Type&
+    operator[](int64_t index) {
+        return data_[index];
+    }
+
+    const Type&
+    operator[](int64_t index) const {
+        return data_[index];
+    }
+
+ private:
+    Type* data_ = nullptr;
+    int64_t size_;
+    ChunkArena* arena_;
+    std::atomic<bool> spilled_ = false;
+};
+
+}  // namespace milvus::segcore
@@ -15,6 +15,8 @@
 #include <string>
 
 #include "common/Schema.h"
+#include "query/PlanImpl.h"
+#include "segcore/PlanCache.h"
 
 namespace milvus::segcore {
 
@@ -36,10 +38,22 @@ class Collection {
         return collection_name_;
     }
 
+    PlanCache<query::Plan>&
+    get_search_plan_cache() {
+        return search_plan_cache_;
+    }
+
+    PlanCache<query::RetrievePlan>&
+    get_retrieve_plan_cache() {
+        return retrieve_plan_cache_;
+    }
+
  private:
     std::string collection_name_;
     std::string schema_proto_;
     SchemaPtr schema_;
+    PlanCache<query::Plan> search_plan_cache_;
+    PlanCache<query::RetrievePlan> retrieve_plan_cache_;
 };
 
 using CollectionPtr = std::unique_ptr<Collection>;
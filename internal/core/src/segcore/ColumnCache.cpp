@@ -0,0 +1,239 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/ColumnCache.h"
+
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+#include "exceptions/EasyAssert.h"
+#include "storage/LocalChunkManager.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// serializes the evictions of this process
+std::mutex evict_mutex;
+// tells apart the temporary files of concurrent stores
+std::atomic<int64_t> store_count = 0;
+
+uint64_t
+Mix(uint64_t x) {
+    // murmur3 finalizer
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+void
+WriteAll(int fd, const void* data, int64_t size, const std::string& path) {
+    auto begin = static_cast<const char*>(data);
+    while (size > 0) {
+        auto written = write(fd, begin, size);
+        AssertInfo(written > 0,
+                   fmt::format("failed to write column cache file {}, err: {}",
+                               path,
+                               strerror(errno)));
+        begin += written;
+        size -= written;
+    }
+}
+
+// maps size bytes of the column data of an open cache file
+void*
+MapData(int fd, int64_t size) {
+    auto map = mmap(nullptr,
+                    size,
+                    PROT_READ,
+                    MAP_PRIVATE,
+                    fd,
+                    COLUMN_CACHE_HEADER_SIZE);
+    return map == MAP_FAILED ? nullptr : map;
+}
+
+}  // namespace
+
+uint64_t
+ColumnCache::Checksum(const void* data, int64_t size) {
+    auto bytes = static_cast<const char*>(data);
+    uint64_t checksum = Mix(size);
+    int64_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        checksum = (checksum ^ Mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes + i, size - i);
+    return Mix(checksum ^ tail);
+}
+
+std::string
+ColumnCache::ColumnPath(int64_t segment_id, int64_t field_id) const {
+    return (std::filesystem::path(dir_) / std::to_string(segment_id) /
+            (std::to_string(field_id) + ".col"))
+        .string();
+}
+
+void*
+ColumnCache::Load(int64_t segment_id,
+                  const FieldMeta& field_meta,
+                  int64_t row_count) {
+    auto path = ColumnPath(segment_id, field_meta.get_id().get());
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+    int64_t size = field_meta.get_sizeof() * row_count;
+    ColumnCacheHeader header;
+    struct stat st;
+    void* map = nullptr;
+    if (pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+        fstat(fd, &st) == 0 && header.magic == COLUMN_CACHE_MAGIC &&
+        header.version == COLUMN_CACHE_VERSION &&
+        header.segment_id == segment_id &&
+        header.field_id == field_meta.get_id().get() &&
+        header.data_type == int32_t(field_meta.get_data_type()) &&
+        header.dim == (field_meta.is_vector() ? field_meta.get_dim() : 0) &&
+        header.row_count == row_count && header.data_size == size &&
+        st.st_size >= COLUMN_CACHE_HEADER_SIZE + size) {
+        map = MapData(fd, size);
+    }
+    close(fd);
+    if (map == nullptr) {
+        return nullptr;
+    }
+    if (Checksum(map, size) != header.checksum) {
+        munmap(map, size);
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return nullptr;
+    }
+    // a use, for the eviction
+    std::error_code ec;
+    std::filesystem::last_write_time(
+        path, std::filesystem::file_time_type::clock::now(), ec);
+    return map;
+}
+
+void*
+ColumnCache::Store(int64_t segment_id,
+                   const FieldMeta& field_meta,
+                   int64_t row_count,
+                   const void* data) {
+    int64_t size = field_meta.get_sizeof() * row_count;
+    if (COLUMN_CACHE_HEADER_SIZE + size > capacity_) {
+        return nullptr;
+    }
+    Evict(COLUMN_CACHE_HEADER_SIZE + size);
+
+    auto path = ColumnPath(segment_id, field_meta.get_id().get());
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path());
+    auto tmp_path = fmt::format("{}.{}.{}.tmp", path, getpid(), ++store_count);
+    int fd = open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    AssertInfo(fd != -1,
+               fmt::format("failed to create column cache file {}, err: {}",
+                           tmp_path,
+                           strerror(errno)));
+
+    std::vector<char> page(COLUMN_CACHE_HEADER_SIZE, 0);
+    auto header = reinterpret_cast<ColumnCacheHeader*>(page.data());
+    header->magic = COLUMN_CACHE_MAGIC;
+    header->version = COLUMN_CACHE_VERSION;
+    header->segment_id = segment_id;
+    header->field_id = field_meta.get_id().get();
+    header->data_type = int32_t(field_meta.get_data_type());
+    header->dim = field_meta.is_vector() ? field_meta.get_dim() : 0;
+    header->row_count = row_count;
+    header->data_size = size;
+    header->checksum = Checksum(data, size);
+    void* map = nullptr;
+    try {
+        WriteAll(fd, page.data(), page.size(), tmp_path);
+        WriteAll(fd, data, size, tmp_path);
+        map = MapData(fd, size);
+        AssertInfo(map != nullptr,
+                   fmt::format("failed to map column cache file {}, err: {}",
+                               tmp_path,
+                               strerror(errno)));
+        AssertInfo(rename(tmp_path.c_str(), path.c_str()) == 0,
+                   fmt::format("failed to rename column cache file {}, err: {}",
+                               tmp_path,
+                               strerror(errno)));
+    } catch (...) {
+        if (map != nullptr) {
+            munmap(map, size);
+        }
+        close(fd);
+        unlink(tmp_path.c_str());
+        throw;
+    }
+    close(fd);
+    return map;
+}
+
+void
+ColumnCache::Evict(int64_t bytes) {
+    std::lock_guard lck(evict_mutex);
+    if (!std::filesystem::is_directory(dir_)) {
+        return;
+    }
+    auto used = storage::LocalChunkManager::GetInstance().GetSizeOfDir(dir_);
+    if (used + bytes <= capacity_) {
+        return;
+    }
+
+    struct Column {
+        std::filesystem::file_time_type last_use;
+        std::filesystem::path path;
+        int64_t size;
+    };
+    std::vector<Column> columns;
+    std::error_code ec;
+    for (auto& entry :
+         std::filesystem::recursive_directory_iterator(dir_, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".col") {
+            columns.push_back({entry.last_write_time(ec),
+                               entry.path(),
+                               int64_t(entry.file_size(ec))});
+        }
+    }
+    std::sort(columns.begin(), columns.end(), [](auto& x, auto& y) {
+        return x.last_use < y.last_use;
+    });
+    // a mapped column stays readable after its file is removed
+    for (auto& column : columns) {
+        if (used + bytes <= capacity_) {
+            break;
+        }
+        if (std::filesystem::remove(column.path, ec)) {
+            used -= column.size;
+        }
+    }
+}
+
+}  // namespace milvus::segcore
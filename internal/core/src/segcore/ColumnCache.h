@@ -0,0 +1,87 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "common/FieldMeta.h"
+
+namespace milvus::segcore {
+
+// Persistent local cache of the fixed width columns of sealed segments, so
+// reloading a segment maps its columns instead of downloading them again.
+// A column lives in <dir>/<segment_id>/<field_id>.col:
+//
+//   ColumnCacheHeader, padded to COLUMN_CACHE_HEADER_SIZE
+//   the raw column, row_count values of the field's width
+//
+// The data starts page aligned, so it is mapped on its own and released
+// with a plain munmap like the other sealed fields. Columns are written
+// to a temporary file and renamed into place, other processes sharing the
+// directory never see a partial one. The modification time of a file is
+// its last use, eviction drops the least recently used columns until the
+// directory fits the capacity. On a tmpfs the directory is shared memory,
+// the processes mapping a column map the same pages.
+constexpr uint32_t COLUMN_CACHE_MAGIC = 0x4c4f434d;  // "MCOL"
+constexpr uint32_t COLUMN_CACHE_VERSION = 1;
+constexpr int64_t COLUMN_CACHE_HEADER_SIZE = 4096;
+
+struct ColumnCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    int64_t segment_id;
+    int64_t field_id;
+    int32_t data_type;
+    int32_t dim;
+    int64_t row_count;
+    int64_t data_size;
+    uint64_t checksum;
+};
+
+class ColumnCache {
+ public:
+    ColumnCache(std::string dir, int64_t capacity)
+        : dir_(std::move(dir)), capacity_(capacity) {
+    }
+
+    // maps the cached column, nullptr if it is absent, of another shape
+    // or corrupted
+    void*
+    Load(int64_t segment_id, const FieldMeta& field_meta, int64_t row_count);
+
+    // caches the row_count values at data, evicting as needed, and maps
+    // the cached copy; nullptr if the column alone exceeds the capacity
+    void*
+    Store(int64_t segment_id,
+          const FieldMeta& field_meta,
+          int64_t row_count,
+          const void* data);
+
+    static uint64_t
+    Checksum(const void* data, int64_t size);
+
+ private:
+    std::string
+    ColumnPath(int64_t segment_id, int64_t field_id) const;
+
+    // removes the least recently used columns until bytes more fit
+    void
+    Evict(int64_t bytes);
+
+ private:
+    const std::string dir_;
+    const int64_t capacity_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,304 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "SegmentSealedImpl.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <future>
+#include <numeric>
+#include <queue>
+#include <type_traits>
+
+#include "Compaction.h"
+#include "arrow/api.h"
+#include "common/Utils.h"
+#include "storage/InsertData.h"
+#include "storage/ThreadPool.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+template <typename K>
+std::vector<K>
+PkValues(const DataArray& array) {
+    if constexpr (std::is_same_v<K, int64_t>) {
+        auto& data = array.scalars().long_data().data();
+        return {data.begin(), data.end()};
+    } else {
+        auto& data = array.scalars().string_data().data();
+        return {data.begin(), data.end()};
+    }
+}
+
+// puts the rows of a segment in pk order, nothing to do for a segment
+// already sorted by its pk
+template <typename K>
+void
+SortByPk(std::vector<int64_t>& offsets, std::vector<K>& pks) {
+    if (std::is_sorted(pks.begin(), pks.end())) {
+        return;
+    }
+    std::vector<int64_t> order(pks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&pks](auto x, auto y) {
+        return pks[x] < pks[y];
+    });
+    std::vector<int64_t> sorted_offsets(order.size());
+    std::vector<K> sorted_pks(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        sorted_offsets[i] = offsets[order[i]];
+        sorted_pks[i] = std::move(pks[order[i]]);
+    }
+    offsets.swap(sorted_offsets);
+    pks.swap(sorted_pks);
+}
+
+// k-way merges the sorted pks of the segments: the segment each row of
+// the result is the next row of, equal pks in the order of the segments
+template <typename K>
+std::vector<int32_t>
+MergeByPk(const std::vector<std::vector<K>>& pks) {
+    // the next pk of a segment and the segment
+    using Head = std::pair<const K*, int32_t>;
+    auto later = [](const Head& x, const Head& y) {
+        if (*x.first != *y.first) {
+            return *y.first < *x.first;
+        }
+        return y.second < x.second;
+    };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(
+        later);
+    size_t total = 0;
+    for (size_t s = 0; s < pks.size(); ++s) {
+        total += pks[s].size();
+        if (!pks[s].empty()) {
+            heads.emplace(pks[s].data(), s);
+        }
+    }
+    std::vector<int32_t> picks;
+    picks.reserve(total);
+    std::vector<size_t> next(pks.size(), 0);
+    while (!heads.empty()) {
+        auto s = heads.top().second;
+        heads.pop();
+        picks.push_back(s);
+        if (++next[s] < pks[s].size()) {
+            heads.emplace(pks[s].data() + next[s], s);
+        }
+    }
+    return picks;
+}
+
+// lays the rows of the segments out in the order of picks, copying the
+// runs of rows taken from one segment at once
+std::vector<char>
+Interleave(const std::vector<std::vector<char>>& rows,
+           int64_t row_bytes,
+           const std::vector<int32_t>& picks) {
+    std::vector<char> out(picks.size() * row_bytes);
+    std::vector<int64_t> next(rows.size(), 0);
+    for (size_t i = 0; i < picks.size();) {
+        auto s = picks[i];
+        auto end = i + 1;
+        while (end < picks.size() && picks[end] == s) {
+            ++end;
+        }
+        auto n = int64_t(end - i);
+        memcpy(out.data() + i * row_bytes,
+               rows[s].data() + next[s] * row_bytes,
+               n * row_bytes);
+        next[s] += n;
+        i = end;
+    }
+    return out;
+}
+
+}  // namespace
+
+CompactionResult
+SegmentSealedImpl::Compact(
+    const std::vector<const SegmentSealedImpl*>& segments,
+    Timestamp timestamp,
+    const storage::FieldDataMeta& target,
+    const std::string& binlog_dir,
+    storage::ChunkManager& chunk_manager) {
+    AssertInfo(!segments.empty(), "no segments to compact");
+    auto& schema = segments[0]->get_schema();
+    auto pk_field_id = schema.get_primary_field_id();
+    AssertInfo(pk_field_id.has_value(), "schema has no primary key");
+    auto pk_type = schema[pk_field_id.value()].get_data_type();
+    AssertInfo(pk_type == DataType::INT64 || pk_type == DataType::VARCHAR,
+               "unsupported primary key type");
+    int32_t num_segments = segments.size();
+
+    // the rows visible at timestamp and not deleted by then
+    std::vector<std::vector<int64_t>> offsets(num_segments);
+    for (int32_t s = 0; s < num_segments; ++s) {
+        auto segment = segments[s];
+        auto row_count = segment->get_row_count();
+        BitsetType skipped(row_count);
+        segment->mask_with_timestamps(skipped, timestamp);
+        segment->mask_with_delete(skipped, row_count, timestamp);
+        skipped.flip();
+        offsets[s].reserve(skipped.count());
+        for (auto i = skipped.find_first(); i != BitsetType::npos;
+             i = skipped.find_next(i)) {
+            offsets[s].push_back(i);
+        }
+    }
+
+    CompactionResult result;
+    std::vector<int32_t> picks;
+    auto merge = [&](auto key) {
+        using K = decltype(key);
+        std::vector<std::vector<K>> pks(num_segments);
+        for (int32_t s = 0; s < num_segments; ++s) {
+            auto array = segments[s]->bulk_subscript(
+                pk_field_id.value(), offsets[s].data(), offsets[s].size());
+            pks[s] = PkValues<K>(*array);
+            SortByPk(offsets[s], pks[s]);
+        }
+        picks = MergeByPk(pks);
+        if (!picks.empty()) {
+            result.min_pk = pks[picks.front()].front();
+            result.max_pk = pks[picks.back()].back();
+        }
+    };
+    if (pk_type == DataType::INT64) {
+        merge(int64_t());
+    } else {
+        merge(std::string());
+    }
+    result.row_count = picks.size();
+    if (picks.empty()) {
+        return result;
+    }
+    AssertInfo(result.row_count <= INT_MAX,
+               "too many rows to compact into one segment");
+    int rows = result.row_count;
+
+    auto system_field = [&](SystemFieldType type) {
+        std::vector<std::vector<char>> values(num_segments);
+        for (int32_t s = 0; s < num_segments; ++s) {
+            values[s].resize(offsets[s].size() * sizeof(int64_t));
+            segments[s]->bulk_subscript(
+                type, offsets[s].data(), offsets[s].size(), values[s].data());
+        }
+        return Interleave(values, sizeof(int64_t), picks);
+    };
+    auto timestamps = system_field(SystemFieldType::Timestamp);
+    auto timestamp_data = reinterpret_cast<const Timestamp*>(timestamps.data());
+    auto [min_timestamp, max_timestamp] =
+        std::minmax_element(timestamp_data, timestamp_data + rows);
+    result.min_timestamp = *min_timestamp;
+    result.max_timestamp = *max_timestamp;
+
+    auto write = [&](FieldId field_id,
+                     std::shared_ptr<storage::FieldData> field_data) {
+        auto meta = target;
+        meta.field_id = field_id.get();
+        storage::InsertData insert_data(field_data);
+        insert_data.SetFieldDataMeta(meta);
+        insert_data.SetTimestamps(result.min_timestamp, result.max_timestamp);
+        auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+        auto path = binlog_dir + "/" + std::to_string(field_id.get());
+        chunk_manager.Write(path, bytes.data(), bytes.size());
+        return path;
+    };
+    auto write_fixed = [&](const FieldMeta* field_meta,
+                           FieldId field_id,
+                           DataType data_type,
+                           const std::vector<char>& values) {
+        storage::Payload payload{
+            data_type, reinterpret_cast<const uint8_t*>(values.data()), rows};
+        if (field_meta != nullptr && field_meta->is_vector()) {
+            payload.dimension = field_meta->get_dim();
+        }
+        return write(field_id, std::make_shared<storage::FieldData>(payload));
+    };
+    auto gather = [&](const FieldMeta& field_meta) {
+        auto field_id = field_meta.get_id();
+        auto data_type = field_meta.get_data_type();
+        std::vector<std::unique_ptr<DataArray>> arrays(num_segments);
+        for (int32_t s = 0; s < num_segments; ++s) {
+            arrays[s] = segments[s]->bulk_subscript(
+                field_id, offsets[s].data(), offsets[s].size());
+        }
+        if (datatype_is_string(data_type)) {
+            arrow::StringBuilder builder;
+            std::vector<int64_t> next(num_segments, 0);
+            for (auto s : picks) {
+                auto& strings = arrays[s]->scalars().string_data();
+                AssertInfo(builder.Append(strings.data(next[s]++)).ok(),
+                           "failed to append a string");
+            }
+            std::shared_ptr<arrow::Array> array;
+            AssertInfo(builder.Finish(&array).ok(),
+                       "failed to build the strings");
+            return write(
+                field_id,
+                std::make_shared<storage::FieldData>(array, data_type));
+        }
+        AssertInfo(!datatype_is_variable(data_type),
+                   fmt::format("unsupported data type of field {}",
+                               field_id.get()));
+        auto row_bytes = field_meta.get_sizeof();
+        std::vector<std::vector<char>> values(num_segments);
+        for (int32_t s = 0; s < num_segments; ++s) {
+            int64_t count = offsets[s].size();
+            values[s].resize(count * row_bytes);
+            LoadFieldDataInfo info{field_id.get(), arrays[s].get(), count};
+            if (count > 0) {
+                FillField(data_type, count * row_bytes, info, values[s].data());
+            }
+        }
+        return write_fixed(&field_meta,
+                           field_id,
+                           data_type,
+                           Interleave(values, row_bytes, picks));
+    };
+
+    // a field per task, all of them finish before the locals go away
+    auto& pool = ThreadPool::GetInstance(ThreadPoolType::COMPACTION);
+    std::vector<std::pair<FieldId, std::future<std::string>>> tasks;
+    tasks.emplace_back(RowFieldID, pool.Submit([&] {
+        return write_fixed(nullptr,
+                           RowFieldID,
+                           DataType::INT64,
+                           system_field(SystemFieldType::RowId));
+    }));
+    tasks.emplace_back(TimestampFieldID, pool.Submit([&] {
+        return write_fixed(
+            nullptr, TimestampFieldID, DataType::INT64, timestamps);
+    }));
+    for (auto& [field_id, field_meta] : schema.get_fields()) {
+        if (SystemProperty::Instance().IsSystem(field_id)) {
+            continue;
+        }
+        tasks.emplace_back(field_id, pool.Submit([&, meta = &field_meta] {
+            return gather(*meta);
+        }));
+    }
+    for (auto& [field_id, task] : tasks) {
+        task.wait();
+    }
+    for (auto& [field_id, task] : tasks) {
+        result.binlog_paths[field_id.get()] = task.get();
+    }
+    return result;
+}
+
+}  // namespace milvus::segcore
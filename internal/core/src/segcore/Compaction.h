@@ -0,0 +1,34 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// what SegmentSealedImpl::Compact wrote: an insert binlog per field,
+// system ones included, holding row_count rows in pk order. the pks and
+// timestamps bound the rows, for the stats of the new segment; nothing is
+// written for no rows left
+struct CompactionResult {
+    int64_t row_count = 0;
+    std::map<int64_t, std::string> binlog_paths;
+    PkType min_pk;
+    PkType max_pk;
+    Timestamp min_timestamp = 0;
+    Timestamp max_timestamp = 0;
+};
+
+}  // namespace milvus::segcore
@@ -76,6 +76,11 @@ VectorBase::set_data_raw(ssize_t element_offset,
             std::vector<std::string> data_raw(begin, end);
             return set_data_raw(element_offset, data_raw.data(), element_count);
         }
+        case DataType::VECTOR_SPARSE_FLOAT: {
+            auto rows =
+                ParseSparseRows(*data, element_count, field_meta.get_dim());
+            return set_data_raw(element_offset, rows.data(), element_count);
+        }
         default: {
             PanicInfo("unsupported");
         }
@@ -143,6 +148,11 @@ VectorBase::fill_chunk_data(ssize_t element_count,
             }
             return;
         }
+        case DataType::VECTOR_SPARSE_FLOAT: {
+            auto rows =
+                ParseSparseRows(*data, element_count, field_meta.get_dim());
+            return fill_chunk_data(rows.data(), element_count);
+        }
         default: {
             PanicInfo("unsupported");
         }
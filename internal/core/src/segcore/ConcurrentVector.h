@@ -14,73 +14,132 @@
 #include <fmt/core.h>
 #include <tbb/concurrent_vector.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "common/FieldMeta.h"
+#include "common/MemoryUsage.h"
 #include "common/Span.h"
+#include "common/SparseVector.h"
 #include "common/Types.h"
 #include "common/Utils.h"
 #include "exceptions/EasyAssert.h"
+#include "segcore/ChunkAllocator.h"
+#include "segcore/ZoneMap.h"
+#include "simd/hook.h"
 
 namespace milvus::segcore {
 
+// Append-only vector whose elements never move. They live in buckets of
+// doubling capacity, and a bucket pointer is stored before the size that
+// covers it is published, so readers index without taking a lock; only
+// growth and clear serialize on the mutex. clear must not race readers.
 template <typename Type>
 class ThreadSafeVector {
  public:
+    ThreadSafeVector() = default;
+    ThreadSafeVector(const ThreadSafeVector&) = delete;
+    ThreadSafeVector&
+    operator=(const ThreadSafeVector&) = delete;
+
+    ~ThreadSafeVector() {
+        clear();
+    }
+
     template <typename... Args>
     void
     emplace_to_at_least(int64_t size, Args... args) {
-        if (size <= size_) {
+        if (size <= size_.load(std::memory_order_acquire)) {
             return;
         }
         std::lock_guard lck(mutex_);
-        while (vec_.size() < size) {
-            vec_.emplace_back(std::forward<Args...>(args...));
-            ++size_;
+        auto current = size_.load(std::memory_order_relaxed);
+        while (current < size) {
+            auto [bucket_id, slot] = locate(current);
+            auto bucket = buckets_[bucket_id].load(std::memory_order_relaxed);
+            if (bucket == nullptr) {
+                bucket = std::allocator<Type>().allocate(capacity(bucket_id));
+                buckets_[bucket_id].store(bucket, std::memory_order_relaxed);
+            }
+            new (bucket + slot) Type(args...);
+            // publishes the element and its bucket
+            size_.store(++current, std::memory_order_release);
         }
     }
+
     const Type&
     operator[](int64_t index) const {
-        AssertInfo(index < size_,
-                   fmt::format(
-                       "index out of range, index={}, size_={}", index, size_));
-        std::shared_lock lck(mutex_);
-        return vec_[index];
+        AssertInfo(index < size(),
+                   fmt::format("index out of range, index={}, size_={}",
+                               index,
+                               size()));
+        auto [bucket_id, slot] = locate(index);
+        return buckets_[bucket_id].load(std::memory_order_relaxed)[slot];
     }
 
     Type&
     operator[](int64_t index) {
-        AssertInfo(index < size_,
-                   fmt::format(
-                       "index out of range, index={}, size_={}", index, size_));
-        std::shared_lock lck(mutex_);
-        return vec_[index];
+        AssertInfo(index < size(),
+                   fmt::format("index out of range, index={}, size_={}",
+                               index,
+                               size()));
+        auto [bucket_id, slot] = locate(index);
+        return buckets_[bucket_id].load(std::memory_order_relaxed)[slot];
     }
 
     int64_t
     size() const {
-        return size_;
+        return size_.load(std::memory_order_acquire);
     }
 
     void
     clear() {
         std::lock_guard lck(mutex_);
-        size_ = 0;
-        vec_.clear();
+        auto size = size_.exchange(0);
+        for (int64_t index = 0; index < size; ++index) {
+            auto [bucket_id, slot] = locate(index);
+            buckets_[bucket_id].load(std::memory_order_relaxed)[slot].~Type();
+        }
+        for (int64_t bucket_id = 0; bucket_id < num_buckets; ++bucket_id) {
+            auto bucket = buckets_[bucket_id].exchange(nullptr);
+            if (bucket != nullptr) {
+                std::allocator<Type>().deallocate(bucket, capacity(bucket_id));
+            }
+        }
+    }
+
+ private:
+    // bucket b holds elements [8 * (2^b - 1), 8 * (2^(b + 1) - 1))
+    static constexpr int64_t first_bucket_bits = 3;
+    static constexpr int64_t num_buckets = 64 - first_bucket_bits;
+
+    static constexpr int64_t
+    capacity(int64_t bucket_id) {
+        return int64_t(1) << (bucket_id + first_bucket_bits);
+    }
+
+    static std::pair<int64_t, int64_t>
+    locate(int64_t index) {
+        auto biased = uint64_t(index) + (uint64_t(1) << first_bucket_bits);
+        int64_t bit = 63 - __builtin_clzll(biased);
+        return {bit - first_bucket_bits, biased - (uint64_t(1) << bit)};
     }
 
  private:
     std::atomic<int64_t> size_ = 0;
-    std::deque<Type> vec_;
-    mutable std::shared_mutex mutex_;
+    std::atomic<Type*> buckets_[num_buckets] = {};
+    std::mutex mutex_;
 };
 
 class VectorBase {
@@ -104,6 +163,12 @@ class VectorBase {
                  const DataArray* data,
                  const FieldMeta& field_meta);
 
+    // copies the strings straight into the chunks, string vectors only
+    virtual void
+    set_string_data(ssize_t element_offset,
+                    const std::string_view* source,
+                    ssize_t element_count) = 0;
+
     virtual void
     fill_chunk_data(const void* source, ssize_t element_count) = 0;
 
@@ -123,12 +188,45 @@ class VectorBase {
     virtual const void*
     get_chunk_data(ssize_t chunk_index) const = 0;
 
+    // min/max of the rows written into a chunk, nullptr if not tracked
+    virtual std::shared_ptr<const ZoneMapBase>
+    get_zone_map(int64_t chunk_id) const {
+        return nullptr;
+    }
+
+    // squared L2 norms of the rows of a chunk of float vectors, written
+    // with the rows; nullptr for other types
+    virtual const float*
+    get_chunk_norms(int64_t chunk_id) const {
+        return nullptr;
+    }
+
     virtual ssize_t
     num_chunk() const = 0;
 
     virtual bool
     empty() = 0;
 
+    // moves chunks [0, chunk_end), all written, to files under dir, see
+    // ChunkPool::Spill; returns the bytes moved
+    virtual int64_t
+    spill_chunks(int64_t chunk_end, const std::string& dir) {
+        return 0;
+    }
+
+    // bytes of the chunks, the spilled ones aside
+    virtual int64_t
+    chunk_memory_usage() const = 0;
+
+    // bytes the elements own outside of the chunks
+    virtual int64_t
+    heap_memory_usage() const = 0;
+
+    int64_t
+    memory_usage() const {
+        return chunk_memory_usage() + heap_memory_usage();
+    }
+
  protected:
     const int64_t size_per_chunk_;
 };
@@ -137,7 +235,7 @@ template <typename Type, bool is_scalar = false>
 class ConcurrentVectorImpl : public VectorBase {
  public:
     // constants
-    using Chunk = FixedVector<Type>;
+    using Chunk = PooledChunk<Type>;
     ConcurrentVectorImpl(ConcurrentVectorImpl&&) = delete;
     ConcurrentVectorImpl(const ConcurrentVectorImpl&) = delete;
 
@@ -154,21 +252,31 @@ class ConcurrentVectorImpl : public VectorBase {
                                               BinaryVector>>;
 
  public:
-    explicit ConcurrentVectorImpl(ssize_t dim, int64_t size_per_chunk)
-        : VectorBase(size_per_chunk), Dim(is_scalar ? 1 : dim) {
+    // chunks are accounted to arena if given
+    explicit ConcurrentVectorImpl(ssize_t dim,
+                                  int64_t size_per_chunk,
+                                  ChunkArena* arena = nullptr)
+        : VectorBase(size_per_chunk), Dim(is_scalar ? 1 : dim), arena_(arena) {
         // Assert(is_scalar ? dim == 1 : dim != 1);
     }
 
     void
     grow_to_at_least(int64_t element_count) override {
         auto chunk_count = upper_div(element_count, size_per_chunk_);
-        chunks_.emplace_to_at_least(chunk_count, Dim * size_per_chunk_);
+        if constexpr (has_norms) {
+            norms_.emplace_to_at_least(chunk_count, size_per_chunk_, arena_);
+        }
+        chunks_.emplace_to_at_least(
+            chunk_count, Dim * size_per_chunk_, arena_);
     }
 
     void
     grow_on_demand(int64_t element_count) {
         auto chunk_count = upper_div(element_count, size_per_chunk_);
-        chunks_.emplace_to_at_least(chunk_count, Dim * element_count);
+        if constexpr (has_norms) {
+            norms_.emplace_to_at_least(chunk_count, element_count, arena_);
+        }
+        chunks_.emplace_to_at_least(chunk_count, Dim * element_count, arena_);
     }
 
     Span<TraitType>
@@ -198,7 +306,10 @@ class ConcurrentVectorImpl : public VectorBase {
             return;
         }
         AssertInfo(chunks_.size() == 0, "no empty concurrent vector");
-        chunks_.emplace_to_at_least(1, Dim * element_count);
+        if constexpr (has_norms) {
+            norms_.emplace_to_at_least(1, element_count, arena_);
+        }
+        chunks_.emplace_to_at_least(1, Dim * element_count, arena_);
         set_data(0, static_cast<const Type*>(source), element_count);
     }
 
@@ -214,9 +325,25 @@ class ConcurrentVectorImpl : public VectorBase {
             element_offset, static_cast<const Type*>(source), element_count);
     }
 
+    void
+    set_string_data(ssize_t element_offset,
+                    const std::string_view* source,
+                    ssize_t element_count) override {
+        if constexpr (std::is_same_v<Type, std::string>) {
+            if (element_count == 0) {
+                return;
+            }
+            this->grow_to_at_least(element_offset + element_count);
+            set_data(element_offset, source, element_count);
+        } else {
+            PanicInfo("set_string_data on a vector of non string type");
+        }
+    }
+
+    template <typename Source>
     void
     set_data(ssize_t element_offset,
-             const Type* source,
+             const Source* source,
              ssize_t element_count) {
         auto chunk_id = element_offset / size_per_chunk_;
         auto chunk_offset = element_offset % size_per_chunk_;
@@ -265,6 +392,77 @@ class ConcurrentVectorImpl : public VectorBase {
         return chunks_[chunk_index].data();
     }
 
+    std::shared_ptr<const ZoneMapBase>
+    get_zone_map(int64_t chunk_id) const override {
+        if constexpr (has_zone_map) {
+            if (chunk_id >= zones_.size()) {
+                return nullptr;
+            }
+            auto zone_map = std::make_shared<ZoneMap<Type>>();
+            zone_map->zone_rows = size_per_chunk_;
+            zone_map->zones.push_back(zones_[chunk_id].Get());
+            return zone_map;
+        } else {
+            return nullptr;
+        }
+    }
+
+    const float*
+    get_chunk_norms(int64_t chunk_id) const override {
+        if constexpr (has_norms) {
+            return norms_[chunk_id].data();
+        } else {
+            return nullptr;
+        }
+    }
+
+    // calls func(data, begin, count) once per chunk overlapping [begin,
+    // end), data pointing at element begin, so loops over a row range
+    // look up each chunk once instead of once per row
+    template <typename Func>
+    void
+    for_each_span(int64_t begin, int64_t end, Func&& func) const {
+        while (begin < end) {
+            auto chunk_id = begin / size_per_chunk_;
+            auto chunk_offset = begin % size_per_chunk_;
+            auto count = std::min<int64_t>(end - begin,
+                                           size_per_chunk_ - chunk_offset);
+            func(get_chunk(chunk_id).data() + chunk_offset * Dim, begin, count);
+            begin += count;
+        }
+    }
+
+    // the end of the elements in [begin, end) that are at most value, for
+    // a column sorted over them like the timestamps. the zone minimums of
+    // the chunks narrow the search to one chunk, searched in place
+    int64_t
+    sorted_upper_bound(int64_t begin, int64_t end, const Type& value) const {
+        static_assert(has_zone_map, "needs the zones of the chunks");
+        if (begin >= end) {
+            return begin;
+        }
+        // the first chunk, past the one holding begin, starting above value
+        auto chunk_begin = begin / size_per_chunk_;
+        auto lo = chunk_begin + 1;
+        auto hi = (end - 1) / size_per_chunk_ + 1;
+        while (lo < hi) {
+            auto mid = (lo + hi) / 2;
+            if (zones_[mid].Get().min <= value) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        auto chunk_id = lo - 1;
+        auto base = chunk_id * size_per_chunk_;
+        auto first = std::max(begin, base);
+        auto last = std::min(end, base + size_per_chunk_);
+        auto data = get_chunk(chunk_id).data();
+        return base + (std::upper_bound(
+                           data + first - base, data + last - base, value) -
+                       data);
+    }
+
     // just for fun, don't use it directly
     const Type*
     get_element(ssize_t element_index) const {
@@ -298,17 +496,80 @@ class ConcurrentVectorImpl : public VectorBase {
         return true;
     }
 
+    int64_t
+    spill_chunks(int64_t chunk_end, const std::string& dir) override {
+        chunk_end = std::min<int64_t>(chunk_end, chunks_.size());
+        int64_t bytes = 0;
+        for (int64_t chunk_id = 0; chunk_id < chunk_end; ++chunk_id) {
+            Chunk& chunk = chunks_[chunk_id];
+            if (chunk.spill(dir)) {
+                bytes += chunk.size() * sizeof(Type);
+            }
+        }
+        return bytes;
+    }
+
+    int64_t
+    chunk_memory_usage() const override {
+        int64_t bytes = 0;
+        for (int64_t i = 0; i < chunks_.size(); ++i) {
+            if (!chunks_[i].spilled()) {
+                bytes += chunks_[i].size() * sizeof(Type);
+            }
+        }
+        if constexpr (has_norms) {
+            for (int64_t i = 0; i < norms_.size(); ++i) {
+                bytes += norms_[i].size() * sizeof(float);
+            }
+        }
+        return bytes;
+    }
+
+    int64_t
+    heap_memory_usage() const override {
+        return heap_bytes_.load(std::memory_order_relaxed);
+    }
+
+    // frees chunks [0, chunk_end), which nobody reads any more; the
+    // chunk ids of the others stay
+    void
+    release_chunks(int64_t chunk_end) {
+        chunk_end = std::min<int64_t>(chunk_end, chunks_.size());
+        for (int64_t chunk_id = 0; chunk_id < chunk_end; ++chunk_id) {
+            Chunk& chunk = chunks_[chunk_id];
+            if constexpr (owns_heap) {
+                int64_t bytes = 0;
+                for (int64_t i = 0; i < chunk.size(); ++i) {
+                    bytes += HeapBytes(chunk[i]);
+                }
+                heap_bytes_ -= bytes;
+            }
+            chunk.release();
+            if constexpr (has_norms) {
+                norms_[chunk_id].release();
+            }
+        }
+    }
+
     void
     clear() {
         chunks_.clear();
+        heap_bytes_ = 0;
+        if constexpr (has_norms) {
+            norms_.clear();
+        }
+        if constexpr (has_zone_map) {
+            zones_.clear();
+        }
     }
 
  private:
+    template <typename Source>
     void
     fill_chunk(ssize_t chunk_id,
                ssize_t chunk_offset,
                ssize_t element_count,
-               const Type* source,
+               const Source* source,
                ssize_t source_offset) {
         if (element_count <= 0) {
             return;
@@ -324,21 +585,68 @@ class ConcurrentVectorImpl : public VectorBase {
         std::copy_n(source + source_offset * Dim,
                     element_count * Dim,
                     ptr + chunk_offset * Dim);
+        if constexpr (owns_heap) {
+            int64_t bytes = 0;
+            for (ssize_t i = 0; i < element_count * Dim; ++i) {
+                bytes += HeapBytes(ptr[chunk_offset * Dim + i]);
+            }
+            heap_bytes_ += bytes;
+        }
+        if constexpr (has_norms) {
+            if (normalize_rows_) {
+                NormalizeVectors(ptr + chunk_offset * Dim, element_count, Dim);
+            }
+            simd::SquaredNorms(ptr + chunk_offset * Dim,
+                               Dim,
+                               element_count,
+                               norms_[chunk_id].data() + chunk_offset);
+        }
+        if constexpr (has_zone_map) {
+            // widen the zone before the rows are acknowledged
+            zones_.emplace_to_at_least(chunk_id + 1);
+            zones_[chunk_id].Update(source + source_offset, element_count);
+        }
     }
 
     const ssize_t Dim;
+    ChunkArena* const arena_;
+
+ protected:
+    // the rows of a cosine field are scaled to unit length as written
+    bool normalize_rows_ = false;
 
  private:
+    static constexpr bool has_zone_map = is_scalar && HasZoneMap<Type>;
+    static constexpr bool owns_heap = std::is_same_v<Type, std::string> ||
+                                      std::is_same_v<Type, PkType> ||
+                                      std::is_same_v<Type, SparseFloatRow>;
+    // float vectors keep the squared norms of their rows, which make the
+    // L2 distances of a brute force search inner products
+    static constexpr bool has_norms = !is_scalar && std::is_same_v<Type, float>;
+
     ThreadSafeVector<Chunk> chunks_;
+    // what the elements written own, the rows are written once
+    std::atomic<int64_t> heap_bytes_ = 0;
+    std::conditional_t<has_zone_map,
+                       ThreadSafeVector<ChunkZone<Type>>,
+                       std::monostate>
+        zones_;
+    // a chunk of norms per chunk of rows, allocated first
+    std::conditional_t<has_norms,
+                       ThreadSafeVector<PooledChunk<float>>,
+                       std::monostate>
+        norms_;
 };
 
 template <typename Type>
 class ConcurrentVector : public ConcurrentVectorImpl<Type, true> {
  public:
-    static_assert(IsScalar<Type> || std::is_same_v<Type, PkType>);
-    explicit ConcurrentVector(int64_t size_per_chunk)
+    static_assert(IsScalar<Type> || std::is_same_v<Type, PkType> ||
+                  std::is_same_v<Type, SparseFloatRow>);
+    explicit ConcurrentVector(int64_t size_per_chunk,
+                              ChunkArena* arena = nullptr)
         : ConcurrentVectorImpl<Type, true>::ConcurrentVectorImpl(
-              1, size_per_chunk) {
+              1, size_per_chunk, arena) {
     }
 };
 
@@ -346,9 +654,13 @@ template <>
 class ConcurrentVector<FloatVector>
     : public ConcurrentVectorImpl<float, false> {
  public:
-    ConcurrentVector(int64_t dim, int64_t size_per_chunk)
+    ConcurrentVector(int64_t dim,
+                     int64_t size_per_chunk,
+                     ChunkArena* arena = nullptr,
+                     bool normalize_rows = false)
         : ConcurrentVectorImpl<float, false>::ConcurrentVectorImpl(
-              dim, size_per_chunk) {
+              dim, size_per_chunk, arena) {
+        normalize_rows_ = normalize_rows;
     }
 };
 
@@ -356,8 +668,11 @@ template <>
 class ConcurrentVector<BinaryVector>
     : public ConcurrentVectorImpl<uint8_t, false> {
  public:
-    explicit ConcurrentVector(int64_t dim, int64_t size_per_chunk)
-        : binary_dim_(dim), ConcurrentVectorImpl(dim / 8, size_per_chunk) {
+    explicit ConcurrentVector(int64_t dim,
+                              int64_t size_per_chunk,
+                              ChunkArena* arena = nullptr)
+        : binary_dim_(dim),
+          ConcurrentVectorImpl(dim / 8, size_per_chunk, arena) {
         AssertInfo(dim % 8 == 0,
                    fmt::format("dim is not a multiple of 8, dim={}", dim));
     }
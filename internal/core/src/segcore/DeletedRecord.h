@@ -11,91 +11,352 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <numeric>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "AckResponder.h"
+#include "common/MemoryUsage.h"
 #include "common/Schema.h"
 #include "segcore/Record.h"
 #include "ConcurrentVector.h"
+#include "PkFingerprint.h"
+#include "exceptions/EasyAssert.h"
 
 namespace milvus::segcore {
 
 struct DeletedRecord {
-    struct TmpBitmap {
-        // Just for query
-        int64_t del_barrier = 0;
-        BitsetTypePtr bitmap_ptr;
+    // deleted rows as of the first del_barrier delete records, split into
+    // pages that snapshots share; a page without deleted rows is not
+    // allocated. Published snapshots are immutable, an update copies the
+    // pages it touches the first time and leaves the others shared, so
+    // neither taking nor extending a snapshot copies bits.
+    class Snapshot {
+     public:
+        static constexpr int64_t bits_per_page = 64 * 1024;
 
-        std::shared_ptr<TmpBitmap>
-        clone(int64_t capacity);
+        Snapshot() = default;
+
+        // the pages of other seen as a bitmap of size rows, the rows past
+        // size are kept for a later snapshot over more rows
+        Snapshot(const Snapshot& other, int64_t del_barrier, int64_t size)
+            : del_barrier_(del_barrier), size_(size), pages_(other.pages_) {
+        }
+
+        int64_t
+        del_barrier() const {
+            return del_barrier_;
+        }
+
+        int64_t
+        size() const {
+            return size_;
+        }
+
+        bool
+        test(int64_t offset) const {
+            auto page_id = offset / bits_per_page;
+            return offset < size_ && page_id < pages_.size() &&
+                   pages_[page_id] &&
+                   pages_[page_id]->test(offset % bits_per_page);
+        }
+
+        int64_t
+        count() const {
+            int64_t result = 0;
+            for_each_block([&](int64_t, BitsetType::block_type block) {
+                result += __builtin_popcountll(block);
+            });
+            return result;
+        }
+
+        // the blocks of a page, nullptr if it has no deleted rows; bits of
+        // the last page past size are not cleared
+        const BitsetType::block_type*
+        page(int64_t page_id) const {
+            return page_id < pages_.size() && pages_[page_id]
+                       ? pages_[page_id]->data()
+                       : nullptr;
+        }
+
+        // bitset |= the deleted rows
+        void
+        mask(BitsetType& bitset) const {
+            AssertInfo(bitset.size() == size_,
+                       "Deleted bitmap size not equal to filtered bitmap size");
+            auto blocks = bitset.data();
+            for_each_block([&](int64_t block_id, BitsetType::block_type block) {
+                blocks[block_id] |= block;
+            });
+        }
+
+        // only for a snapshot that has not been published
+        void
+        set(int64_t offset, bool value) {
+            AssertInfo(offset < size_, "Deleted offset out of range");
+            auto page_id = offset / bits_per_page;
+            if (page_id >= pages_.size()) {
+                if (!value) {
+                    return;
+                }
+                pages_.resize(page_id + 1);
+            }
+            auto& page = pages_[page_id];
+            if (!page) {
+                if (!value) {
+                    return;
+                }
+                page = std::make_shared<BitsetType>(bits_per_page);
+            } else if (page.use_count() > 1) {
+                // still shared with a published snapshot
+                page = std::make_shared<BitsetType>(*page);
+            }
+            page->set(offset % bits_per_page, value);
+        }
+
+        // bytes of the allocated pages, shared ones included
+        int64_t
+        memory_usage() const {
+            int64_t bytes = pages_.capacity() * sizeof(pages_[0]);
+            for (auto& page : pages_) {
+                if (page) {
+                    bytes += bits_per_page / 8;
+                }
+            }
+            return bytes;
+        }
+
+     private:
+        // every allocated block below size_, the bits past size_ cleared
+        template <typename Func>
+        void
+        for_each_block(Func func) const {
+            constexpr int64_t bits_per_block = BitsetType::bits_per_block;
+            constexpr auto blocks_per_page = bits_per_page / bits_per_block;
+            auto num_blocks = (size_ + bits_per_block - 1) / bits_per_block;
+            auto tail = size_ % bits_per_block;
+            for (int64_t page_id = 0; page_id < pages_.size(); ++page_id) {
+                if (!pages_[page_id]) {
+                    continue;
+                }
+                auto data = pages_[page_id]->data();
+                auto begin = page_id * blocks_per_page;
+                auto end = std::min(begin + blocks_per_page, num_blocks);
+                for (auto block_id = begin; block_id < end; ++block_id) {
+                    auto block = data[block_id - begin];
+                    if (block_id == num_blocks - 1 && tail != 0) {
+                        block &= (BitsetType::block_type(1) << tail) - 1;
+                    }
+                    func(block_id, block);
+                }
+            }
+        }
+
+     private:
+        int64_t del_barrier_ = 0;
+        int64_t size_ = 0;
+        std::vector<std::shared_ptr<BitsetType>> pages_;
     };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
     static constexpr int64_t deprecated_size_per_chunk = 32 * 1024;
-    DeletedRecord()
-        : lru_(std::make_shared<TmpBitmap>()),
-          timestamps_(deprecated_size_per_chunk),
-          pks_(deprecated_size_per_chunk) {
-        lru_->bitmap_ptr = std::make_shared<BitsetType>();
+    explicit DeletedRecord(DataType pk_type = DataType::INT64)
+        : timestamps_(deprecated_size_per_chunk),
+          pk_type_(pk_type),
+          int_pks_(deprecated_size_per_chunk),
+          str_pks_(deprecated_size_per_chunk),
+          str_fingerprints_(deprecated_size_per_chunk),
+          snapshot_(std::make_shared<Snapshot>()) {
+        AssertInfo(pk_type == DataType::INT64 || pk_type == DataType::VARCHAR,
+                   "Primary key is not INT64 or VARCHAR type");
     }
 
-    auto
-    get_lru_entry() {
-        std::shared_lock lck(shared_mutex_);
-        return lru_;
+    // for the pk of schema, int64 if it has none
+    explicit DeletedRecord(const Schema& schema)
+        : DeletedRecord(schema.get_primary_field_id().has_value()
+                            ? schema[schema.get_primary_field_id().value()]
+                                  .get_data_type()
+                            : DataType::INT64) {
     }
 
-    std::shared_ptr<TmpBitmap>
-    clone_lru_entry(int64_t insert_barrier,
-                    int64_t del_barrier,
-                    int64_t& old_del_barrier,
-                    bool& hit_cache) {
-        std::shared_lock lck(shared_mutex_);
-        auto res = lru_->clone(insert_barrier);
-        old_del_barrier = lru_->del_barrier;
+    DataType
+    pk_type() const {
+        return pk_type_;
+    }
+
+    // records deletes [reserved_begin, reserved_begin + size) in timestamp
+    // order and acknowledges them, pks an int64 or string_view column of
+    // the pk type
+    template <typename Pk>
+    void
+    push(int64_t reserved_begin,
+         const Pk* pks,
+         const Timestamp* timestamps,
+         int64_t size) {
+        if (std::is_sorted(timestamps, timestamps + size)) {
+            // as the message stream delivers them, written as they are
+            write(reserved_begin, pks, timestamps, size);
+        } else {
+            // a permutation sorted on the timestamps alone, stable so the
+            // deletes of one timestamp keep their order
+            std::vector<int64_t> order(size);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+                return timestamps[a] < timestamps[b];
+            });
+            std::vector<Timestamp> sorted_timestamps(size);
+            std::vector<Pk> sorted_pks(size);
+            for (int64_t i = 0; i < size; ++i) {
+                sorted_timestamps[i] = timestamps[order[i]];
+                sorted_pks[i] = pks[order[i]];
+            }
+            write(reserved_begin,
+                  sorted_pks.data(),
+                  sorted_timestamps.data(),
+                  size);
+        }
+        ack_responder_.AddSegment(reserved_begin, reserved_begin + size);
+    }
 
-        if (lru_->bitmap_ptr->size() == insert_barrier &&
-            lru_->del_barrier == del_barrier) {
-            hit_cache = true;
+    // calls fn(pks, begin, count) per chunk of the pks of deletes [begin,
+    // end), pks a const int64_t* or a const std::string*
+    template <typename Func>
+    void
+    for_each_pk_span(int64_t begin, int64_t end, Func&& func) const {
+        if (pk_type_ == DataType::INT64) {
+            int_pks_.for_each_span(begin, end, func);
         } else {
-            res->del_barrier = del_barrier;
+            str_pks_.for_each_span(begin, end, func);
+        }
+    }
+
+    // calls fn(fingerprints, begin, count) per chunk of the PkFingerprint
+    // of the string pks of deletes [begin, end)
+    template <typename Func>
+    void
+    for_each_fingerprint_span(int64_t begin, int64_t end, Func&& func) const {
+        str_fingerprints_.for_each_span(begin, end, func);
+    }
+
+    // deletes [0, compacted) are folded into the published snapshot and
+    // no longer readable, barriers never fall below it
+    int64_t
+    compacted() const {
+        return compacted_.load(std::memory_order_acquire);
+    }
+
+    // held while reading the deletes past compacted
+    std::shared_lock<std::shared_mutex>
+    lock_log() const {
+        return std::shared_lock(log_mutex_);
+    }
+
+    // frees the chunks of deletes [0, del_barrier), the published snapshot
+    // must cover them
+    void
+    compact(int64_t del_barrier) {
+        std::unique_lock lck(log_mutex_);
+        AssertInfo(get_snapshot()->del_barrier() >= del_barrier,
+                   "compacting deletes the snapshot does not cover");
+        if (del_barrier <= compacted_.load(std::memory_order_relaxed)) {
+            return;
         }
+        compacted_.store(del_barrier, std::memory_order_release);
+        // the chunk holding del_barrier is still read
+        auto chunk_end = del_barrier / deprecated_size_per_chunk;
+        timestamps_.release_chunks(chunk_end);
+        int_pks_.release_chunks(chunk_end);
+        str_pks_.release_chunks(chunk_end);
+        str_fingerprints_.release_chunks(chunk_end);
+    }
 
-        return res;
+    SnapshotPtr
+    get_snapshot() {
+        std::shared_lock lck(shared_mutex_);
+        return snapshot_;
     }
 
+    // keep the snapshot covering the most delete records, and of those
+    // the one over the most rows
     void
-    insert_lru_entry(std::shared_ptr<TmpBitmap> new_entry, bool force = false) {
+    publish_snapshot(SnapshotPtr snapshot) {
         std::lock_guard lck(shared_mutex_);
-        if (new_entry->del_barrier <= lru_->del_barrier) {
-            if (!force ||
-                new_entry->bitmap_ptr->size() <= lru_->bitmap_ptr->size()) {
-                // DO NOTHING
-                return;
-            }
+        if (snapshot->del_barrier() < snapshot_->del_barrier() ||
+            (snapshot->del_barrier() == snapshot_->del_barrier() &&
+             snapshot->size() <= snapshot_->size())) {
+            return;
         }
-        lru_ = std::move(new_entry);
+        snapshot_ = std::move(snapshot);
+    }
+
+    void
+    add_memory_usage(MemoryUsage& usage) {
+        usage.Add("deleted_record.pks",
+                  int_pks_.memory_usage() + str_pks_.memory_usage() +
+                      str_fingerprints_.memory_usage());
+        usage.Add("deleted_record.timestamps", timestamps_.memory_usage());
+        usage.Add("deleted_record.bitmap", get_snapshot()->memory_usage());
     }
 
  public:
     std::atomic<int64_t> reserved = 0;
     AckResponder ack_responder_;
     ConcurrentVector<Timestamp> timestamps_;
-    ConcurrentVector<PkType> pks_;
 
  private:
-    std::shared_ptr<TmpBitmap> lru_;
+    template <typename Pk>
+    void
+    write(int64_t reserved_begin,
+          const Pk* pks,
+          const Timestamp* timestamps,
+          int64_t size) {
+        if constexpr (std::is_same_v<Pk, int64_t>) {
+            AssertInfo(pk_type_ == DataType::INT64,
+                       "int64 pks deleted from a varchar pk segment");
+            int_pks_.set_data_raw(reserved_begin, pks, size);
+        } else {
+            static_assert(std::is_same_v<Pk, std::string_view>);
+            AssertInfo(pk_type_ == DataType::VARCHAR,
+                       "varchar pks deleted from an int64 pk segment");
+            str_pks_.set_string_data(reserved_begin, pks, size);
+            // fingerprinted once here for every bitmap update matching them
+            std::vector<uint64_t> fingerprints(size);
+            for (int64_t i = 0; i < size; ++i) {
+                fingerprints[i] = PkFingerprint(pks[i]);
+            }
+            str_fingerprints_.set_data_raw(
+                reserved_begin, fingerprints.data(), size);
+        }
+        timestamps_.set_data_raw(reserved_begin, timestamps, size);
+    }
+
+ private:
+    // the pks kept in their own type, only the column of pk_type_ is used
+    DataType pk_type_;
+    ConcurrentVector<int64_t> int_pks_;
+    ConcurrentVector<std::string> str_pks_;
+    // the PkFingerprint of each of str_pks_
+    ConcurrentVector<uint64_t> str_fingerprints_;
+    SnapshotPtr snapshot_;
     std::shared_mutex shared_mutex_;
+    std::atomic<int64_t> compacted_ = 0;
+    mutable std::shared_mutex log_mutex_;
 };
 
-inline auto
-DeletedRecord::TmpBitmap::clone(int64_t capacity)
-    -> std::shared_ptr<TmpBitmap> {
-    auto res = std::make_shared<TmpBitmap>();
-    res->del_barrier = this->del_barrier;
-    res->bitmap_ptr = std::make_shared<BitsetType>();
-    *(res->bitmap_ptr) = *(this->bitmap_ptr);
-    res->bitmap_ptr->resize(capacity, false);
-    return res;
+// the deletes at or before timestamp, at least the compacted ones, whose
+// timestamps are gone
+inline int64_t
+get_barrier(const DeletedRecord& record, Timestamp timestamp) {
+    auto lck = record.lock_log();
+    return record.timestamps_.sorted_upper_bound(
+        record.compacted(), record.ack_responder_.GetAck(), timestamp);
 }
 
 }  // namespace milvus::segcore
@@ -0,0 +1,566 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/FloatCompression.h"
+#include "simd/hook.h"
+
+namespace milvus::segcore {
+
+// rows sharing a base in the block frame of reference encoding
+constexpr int64_t ENCODED_BLOCK_ROWS = 1024;
+// distinct values past which a column is not dictionary encoded
+constexpr int64_t ENCODED_DICTIONARY_SIZE = 4096;
+// the same for string columns, a dictionary lookup saves more there
+constexpr int64_t ENCODED_STRING_DICTIONARY_SIZE = 1 << 20;
+
+// bytes of the blocks of a compressed vector column at most, a block of
+// rows decodes on its own
+constexpr int64_t COMPRESSED_VECTOR_BLOCK_BYTES = 64 * 1024;
+
+// sealed column types worth encoding, narrower ones are small already
+template <typename T>
+constexpr bool IsEncodable = std::is_same_v<T, int32_t> ||
+                             std::is_same_v<T, int64_t> ||
+                             std::is_same_v<T, std::string_view>;
+
+enum class ColumnEncoding {
+    // code = value - min of the column
+    FrameOfReference,
+    // code = value - min of its block, for sorted and clustered columns
+    BlockFrameOfReference,
+    // code = index of the value in the sorted distinct values
+    Dictionary,
+};
+
+class EncodedColumnBase {
+ public:
+    virtual ~EncodedColumnBase() = default;
+
+    virtual int64_t
+    memory_bytes() const = 0;
+};
+
+// A sealed integer column stored as bit packed codes of a fixed width and
+// the values they are relative to. Rows decode independently, so random
+// access stays O(1) and ranges decode with a branch free loop.
+template <typename T>
+class EncodedColumn : public EncodedColumnBase {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+
+ public:
+    // the smallest encoding of data, nullptr if none takes at most half
+    // of the raw size
+    static std::shared_ptr<EncodedColumn<T>>
+    Encode(const T* data, int64_t size) {
+        if (size == 0) {
+            return nullptr;
+        }
+        auto [min, max] = std::minmax_element(data, data + size);
+        auto for_bits = BitWidth(Delta(*max, *min));
+
+        auto num_blocks = (size + ENCODED_BLOCK_ROWS - 1) / ENCODED_BLOCK_ROWS;
+        std::vector<T> block_bases(num_blocks);
+        int block_bits = 0;
+        for (int64_t block = 0; block < num_blocks; ++block) {
+            auto begin = data + block * ENCODED_BLOCK_ROWS;
+            auto end = data + std::min((block + 1) * ENCODED_BLOCK_ROWS, size);
+            auto [block_min, block_max] = std::minmax_element(begin, end);
+            block_bases[block] = *block_min;
+            block_bits =
+                std::max(block_bits, BitWidth(Delta(*block_max, *block_min)));
+        }
+
+        std::vector<T> dictionary;
+        {
+            std::unordered_set<T> distinct;
+            for (int64_t i = 0; i < size; ++i) {
+                distinct.insert(data[i]);
+                if (int64_t(distinct.size()) > ENCODED_DICTIONARY_SIZE) {
+                    break;
+                }
+            }
+            if (int64_t(distinct.size()) <= ENCODED_DICTIONARY_SIZE) {
+                dictionary.assign(distinct.begin(), distinct.end());
+                std::sort(dictionary.begin(), dictionary.end());
+            }
+        }
+
+        auto for_bytes = PackedBytes(size, for_bits) + int64_t(sizeof(T));
+        auto block_bytes = PackedBytes(size, block_bits) +
+                           num_blocks * int64_t(sizeof(T));
+        int64_t dictionary_bytes = INT64_MAX;
+        int dictionary_bits = 0;
+        if (!dictionary.empty()) {
+            dictionary_bits = BitWidth(dictionary.size() - 1);
+            dictionary_bytes = PackedBytes(size, dictionary_bits) +
+                               dictionary.size() * int64_t(sizeof(T));
+        }
+        auto best = std::min({for_bytes, block_bytes, dictionary_bytes});
+        if (best * 2 > size * int64_t(sizeof(T))) {
+            return nullptr;
+        }
+
+        auto column = std::make_shared<EncodedColumn<T>>();
+        column->size_ = size;
+        if (best == for_bytes) {
+            column->encoding_ = ColumnEncoding::FrameOfReference;
+            column->Pack(for_bits, [&](int64_t i) {
+                return Delta(data[i], *min);
+            });
+            column->values_ = {*min};
+        } else if (best == block_bytes) {
+            column->encoding_ = ColumnEncoding::BlockFrameOfReference;
+            column->Pack(block_bits, [&](int64_t i) {
+                return Delta(data[i], block_bases[i / ENCODED_BLOCK_ROWS]);
+            });
+            column->values_ = std::move(block_bases);
+        } else {
+            column->encoding_ = ColumnEncoding::Dictionary;
+            column->Pack(dictionary_bits, [&](int64_t i) {
+                return uint64_t(std::lower_bound(dictionary.begin(),
+                                                 dictionary.end(),
+                                                 data[i]) -
+                                dictionary.begin());
+            });
+            column->values_ = std::move(dictionary);
+        }
+        return column;
+    }
+
+    ColumnEncoding
+    encoding() const {
+        return encoding_;
+    }
+
+    int
+    bits() const {
+        return bits_;
+    }
+
+    int64_t
+    size() const {
+        return size_;
+    }
+
+    int64_t
+    memory_bytes() const override {
+        return codes_.size() * sizeof(uint64_t) + values_.size() * sizeof(T);
+    }
+
+    T
+    at(int64_t row) const {
+        return Value(row, Code(row));
+    }
+
+    // rows [begin, begin + count) into dst
+    void
+    Decode(int64_t begin, int64_t count, T* dst) const {
+        switch (encoding_) {
+            case ColumnEncoding::FrameOfReference: {
+                auto base = values_[0];
+                for (int64_t i = 0; i < count; ++i) {
+                    dst[i] = Add(base, Code(begin + i));
+                }
+                break;
+            }
+            case ColumnEncoding::BlockFrameOfReference: {
+                for (int64_t i = 0; i < count; ++i) {
+                    auto row = begin + i;
+                    dst[i] = Add(values_[row / ENCODED_BLOCK_ROWS], Code(row));
+                }
+                break;
+            }
+            case ColumnEncoding::Dictionary: {
+                for (int64_t i = 0; i < count; ++i) {
+                    dst[i] = values_[Code(begin + i)];
+                }
+                break;
+            }
+        }
+    }
+
+ private:
+    using Unsigned = std::make_unsigned_t<T>;
+
+    static uint64_t
+    Delta(T value, T base) {
+        return Unsigned(Unsigned(value) - Unsigned(base));
+    }
+
+    static T
+    Add(T base, uint64_t code) {
+        return T(Unsigned(Unsigned(base) + Unsigned(code)));
+    }
+
+    static int
+    BitWidth(uint64_t value) {
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+    }
+
+    static int64_t
+    PackedBytes(int64_t size, int bits) {
+        return (size * bits + 63) / 64 * int64_t(sizeof(uint64_t));
+    }
+
+    template <typename GetCode>
+    void
+    Pack(int bits, GetCode&& get_code) {
+        bits_ = bits;
+        // a padding word, so a code never reads past the end
+        codes_.assign((size_ * bits + 63) / 64 + 1, 0);
+        if (bits == 0) {
+            return;
+        }
+        for (int64_t i = 0; i < size_; ++i) {
+            auto code = get_code(i);
+            auto bit = i * bits;
+            auto shift = bit & 63;
+            codes_[bit >> 6] |= code << shift;
+            if (shift + bits > 64) {
+                codes_[(bit >> 6) + 1] |= code >> (64 - shift);
+            }
+        }
+    }
+
+    uint64_t
+    Code(int64_t row) const {
+        auto bit = row * bits_;
+        auto shift = bit & 63;
+        auto word = codes_.data() + (bit >> 6);
+        // the high word is shifted in two steps, a shift by 64 is undefined
+        auto code = (word[0] >> shift) | ((word[1] << 1) << (63 - shift));
+        auto mask = bits_ == 64 ? ~uint64_t(0) : (uint64_t(1) << bits_) - 1;
+        return code & mask;
+    }
+
+    T
+    Value(int64_t row, uint64_t code) const {
+        switch (encoding_) {
+            case ColumnEncoding::FrameOfReference:
+                return Add(values_[0], code);
+            case ColumnEncoding::BlockFrameOfReference:
+                return Add(values_[row / ENCODED_BLOCK_ROWS], code);
+            default:
+                return values_[code];
+        }
+    }
+
+ private:
+    ColumnEncoding encoding_ = ColumnEncoding::FrameOfReference;
+    int64_t size_ = 0;
+    int bits_ = 0;
+    std::vector<uint64_t> codes_;
+    // the base of FrameOfReference, the block bases of
+    // BlockFrameOfReference or the dictionary
+    std::vector<T> values_;
+};
+
+// A sealed string column stored as a sorted dictionary of its distinct
+// values and a code per row, int16_t codes while the dictionary allows
+// them. Codes order like the strings they stand for, so a comparison or a
+// prefix matches one run of codes.
+template <>
+class EncodedColumn<std::string_view> : public EncodedColumnBase {
+ public:
+    // the dictionary encoding of rows[0, size), nullptr unless it takes
+    // at most half of the strings and their 32-bit offsets
+    template <typename Rows>
+    static std::shared_ptr<EncodedColumn<std::string_view>>
+    Encode(const Rows& rows, int64_t size) {
+        if (size == 0) {
+            return nullptr;
+        }
+        auto max_distinct = std::min(ENCODED_STRING_DICTIONARY_SIZE, size / 2);
+        std::unordered_map<std::string_view, int32_t> codes;
+        int64_t raw_bytes = size * int64_t(sizeof(uint32_t));
+        for (int64_t i = 0; i < size; ++i) {
+            std::string_view row = rows[i];
+            raw_bytes += row.size();
+            if (codes.emplace(row, 0).second &&
+                int64_t(codes.size()) > max_distinct) {
+                return nullptr;
+            }
+        }
+
+        auto column = std::make_shared<EncodedColumn<std::string_view>>();
+        std::vector<std::string_view> dictionary;
+        dictionary.reserve(codes.size());
+        for (auto& [value, code] : codes) {
+            dictionary.push_back(value);
+        }
+        std::sort(dictionary.begin(), dictionary.end());
+        column->offsets_.reserve(dictionary.size() + 1);
+        for (int64_t code = 0; code < int64_t(dictionary.size()); ++code) {
+            codes[dictionary[code]] = code;
+            column->offsets_.push_back(column->data_.size());
+            column->data_.append(dictionary[code]);
+        }
+        column->offsets_.push_back(column->data_.size());
+        if (column->data_.size() > std::numeric_limits<uint32_t>::max()) {
+            return nullptr;
+        }
+
+        if (int64_t(dictionary.size()) <=
+            int64_t(std::numeric_limits<int16_t>::max()) + 1) {
+            column->codes16_.resize(size);
+            for (int64_t i = 0; i < size; ++i) {
+                column->codes16_[i] = codes[rows[i]];
+            }
+        } else {
+            column->codes32_.resize(size);
+            for (int64_t i = 0; i < size; ++i) {
+                column->codes32_[i] = codes[rows[i]];
+            }
+        }
+        if (column->memory_bytes() * 2 > raw_bytes) {
+            return nullptr;
+        }
+        return column;
+    }
+
+    int64_t
+    size() const {
+        return codes16_.empty() ? codes32_.size() : codes16_.size();
+    }
+
+    int64_t
+    dictionary_size() const {
+        return offsets_.size() - 1;
+    }
+
+    std::string_view
+    dictionary(int64_t code) const {
+        return std::string_view(data_.data() + offsets_[code],
+                                offsets_[code + 1] - offsets_[code]);
+    }
+
+    int64_t
+    memory_bytes() const override {
+        return data_.size() + offsets_.size() * sizeof(uint32_t) +
+               codes16_.size() * sizeof(int16_t) +
+               codes32_.size() * sizeof(int32_t);
+    }
+
+    int32_t
+    code(int64_t row) const {
+        return codes16_.empty() ? codes32_[row] : codes16_[row];
+    }
+
+    std::string_view
+    at(int64_t row) const {
+        return dictionary(code(row));
+    }
+
+    // rows [begin, begin + count) into dst, viewing the dictionary
+    void
+    Decode(int64_t begin, int64_t count, std::string_view* dst) const {
+        for (int64_t i = 0; i < count; ++i) {
+            dst[i] = at(begin + i);
+        }
+    }
+
+    // calls func with the codes, a const int16_t* or a const int32_t*
+    template <typename Func>
+    void
+    VisitCodes(Func&& func) const {
+        if (codes16_.empty()) {
+            func(codes32_.data());
+        } else {
+            func(codes16_.data());
+        }
+    }
+
+ private:
+    // the sorted distinct values back to back, code i is
+    // [offsets_[i], offsets_[i + 1]) of data_
+    std::string data_;
+    std::vector<uint32_t> offsets_;
+    // one of them holds a code per row
+    std::vector<int16_t> codes16_;
+    std::vector<int32_t> codes32_;
+};
+
+// A sealed float vector column rounded to 16-bit floats, half the bytes
+// of the raw rows. Brute force reads the halves directly, retrieval
+// widens the rows it returns.
+class HalfVectorColumn : public EncodedColumnBase {
+ public:
+    HalfVectorColumn(const float* data,
+                     int64_t rows,
+                     int64_t dim,
+                     simd::HalfType type)
+        : rows_(rows), dim_(dim), type_(type), halves_(rows * dim) {
+        simd::ToHalf(data, rows * dim, type, halves_.data());
+    }
+
+    int64_t
+    size() const {
+        return rows_;
+    }
+
+    int64_t
+    dim() const {
+        return dim_;
+    }
+
+    simd::HalfType
+    type() const {
+        return type_;
+    }
+
+    const uint16_t*
+    data() const {
+        return halves_.data();
+    }
+
+    int64_t
+    memory_bytes() const override {
+        return halves_.size() * sizeof(uint16_t);
+    }
+
+    // rows [begin, begin + count) widened into dst
+    void
+    Decode(int64_t begin, int64_t count, float* dst) const {
+        simd::FromHalf(
+            halves_.data() + begin * dim_, count * dim_, type_, dst);
+    }
+
+ private:
+    const int64_t rows_;
+    const int64_t dim_;
+    const simd::HalfType type_;
+    std::vector<uint16_t> halves_;
+};
+
+// A float vector field stored losslessly compressed, see
+// common/FloatCompression.h, in blocks of a power of two rows decoded on
+// their own; a retrieve decodes the blocks of the rows it asks for and a
+// brute force search one block at a time
+class CompressedVectorColumn : public EncodedColumnBase {
+ public:
+    CompressedVectorColumn(const float* data, int64_t rows, int64_t dim)
+        : rows_(rows), dim_(dim), block_rows_(1) {
+        auto row_bytes = dim * int64_t(sizeof(float));
+        while (block_rows_ * 2 * row_bytes <= COMPRESSED_VECTOR_BLOCK_BYTES) {
+            block_rows_ *= 2;
+        }
+        for (int64_t begin = 0; begin < rows; begin += block_rows_) {
+            auto count = std::min(block_rows_, rows - begin);
+            blocks_.push_back(CompressFloats(data + begin * dim, count * dim));
+        }
+    }
+
+    int64_t
+    size() const {
+        return rows_;
+    }
+
+    int64_t
+    dim() const {
+        return dim_;
+    }
+
+    int64_t
+    block_rows() const {
+        return block_rows_;
+    }
+
+    int64_t
+    memory_bytes() const override {
+        int64_t bytes = blocks_.capacity() * sizeof(std::vector<char>);
+        for (auto& block : blocks_) {
+            bytes += block.size();
+        }
+        return bytes;
+    }
+
+    // rows [begin, begin + count) into dst
+    void
+    Decode(int64_t begin, int64_t count, float* dst) const {
+        std::vector<float> buffer;
+        auto end = begin + count;
+        while (begin < end) {
+            auto block = begin / block_rows_;
+            auto block_begin = block * block_rows_;
+            auto block_end = std::min(block_begin + block_rows_, rows_);
+            auto rows = std::min(block_end, end) - begin;
+            if (begin == block_begin && rows == block_end - block_begin) {
+                DecodeBlock(block, dst);
+            } else {
+                buffer.resize(block_rows_ * dim_);
+                DecodeBlock(block, buffer.data());
+                std::copy_n(buffer.data() + (begin - block_begin) * dim_,
+                            rows * dim_,
+                            dst);
+            }
+            dst += rows * dim_;
+            begin += rows;
+        }
+    }
+
+    // the rows at offsets into dst, in their order; each block is decoded
+    // once, negative offsets get zeros
+    void
+    Gather(const int64_t* offsets, int64_t count, float* dst) const {
+        std::vector<int64_t> order(count);
+        for (int64_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [=](auto x, auto y) {
+            return offsets[x] < offsets[y];
+        });
+        std::vector<float> buffer(block_rows_ * dim_);
+        int64_t decoded = -1;
+        for (auto i : order) {
+            auto row = offsets[i];
+            if (row < 0) {
+                std::fill_n(dst + i * dim_, dim_, 0);
+                continue;
+            }
+            if (row / block_rows_ != decoded) {
+                decoded = row / block_rows_;
+                DecodeBlock(decoded, buffer.data());
+            }
+            std::copy_n(buffer.data() + (row % block_rows_) * dim_,
+                        dim_,
+                        dst + i * dim_);
+        }
+    }
+
+ private:
+    void
+    DecodeBlock(int64_t block, float* dst) const {
+        auto rows = std::min(block_rows_, rows_ - block * block_rows_);
+        DecompressFloats(
+            blocks_[block].data(), blocks_[block].size(), rows * dim_, dst);
+    }
+
+ private:
+    const int64_t rows_;
+    const int64_t dim_;
+    int64_t block_rows_;
+    std::vector<std::vector<char>> blocks_;
+};
+
+}  // namespace milvus::segcore
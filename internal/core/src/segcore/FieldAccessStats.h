@@ -0,0 +1,111 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "common/Consts.h"
+#include "common/Types.h"
+#include "nlohmann/json.hpp"
+
+namespace milvus::segcore {
+
+enum class FieldAccess : int {
+    // predicates evaluated over the field
+    FilterEvals = 0,
+    // bulk_subscript calls for the results of requests, and their rows
+    SubscriptCalls,
+    SubscriptRows,
+    // predicates answered by an index of the field, the pk index included
+    IndexHits,
+    Count,
+};
+
+inline const char*
+FieldAccessName(FieldAccess access) {
+    switch (access) {
+        case FieldAccess::FilterEvals:
+            return "filter_evals";
+        case FieldAccess::SubscriptCalls:
+            return "subscript_calls";
+        case FieldAccess::SubscriptRows:
+            return "subscript_rows";
+        case FieldAccess::IndexHits:
+            return "index_hits";
+        default:
+            return "unknown";
+    }
+}
+
+// counts of the accesses to each field of a segment, for the load policy
+// to tell the hot fields from the cold ones. a count is bumped once a call
+// rather than once a row, with a relaxed add, so they stay on; fields are
+// slotted by field_id - START_USER_FIELDID, the others are not counted
+class FieldAccessStats {
+ public:
+    explicit FieldAccessStats(int64_t num_fields)
+        : counts_(new std::atomic<int64_t>[num_fields * kAccesses]),
+          num_fields_(num_fields) {
+        for (int64_t i = 0; i < num_fields * kAccesses; ++i) {
+            counts_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void
+    Add(FieldId field_id, FieldAccess access, int64_t value = 1) {
+        auto slot = field_id.get() - START_USER_FIELDID;
+        if (slot >= 0 && slot < num_fields_) {
+            counts_[slot * kAccesses + int(access)].fetch_add(
+                value, std::memory_order_relaxed);
+        }
+    }
+
+    int64_t
+    Get(FieldId field_id, FieldAccess access) const {
+        auto slot = field_id.get() - START_USER_FIELDID;
+        if (slot < 0 || slot >= num_fields_) {
+            return 0;
+        }
+        return counts_[slot * kAccesses + int(access)].load(
+            std::memory_order_relaxed);
+    }
+
+    // the counts of the fields accessed at all, by field id
+    nlohmann::json
+    ToJson() const {
+        auto json = nlohmann::json::object();
+        for (int64_t slot = 0; slot < num_fields_; ++slot) {
+            auto field = nlohmann::json::object();
+            for (int i = 0; i < kAccesses; ++i) {
+                auto count = counts_[slot * kAccesses + i].load(
+                    std::memory_order_relaxed);
+                if (count > 0) {
+                    field[FieldAccessName(FieldAccess(i))] = count;
+                }
+            }
+            if (!field.empty()) {
+                json[std::to_string(slot + START_USER_FIELDID)] = field;
+            }
+        }
+        return json;
+    }
+
+ private:
+    static constexpr int kAccesses = int(FieldAccess::Count);
+
+    std::unique_ptr<std::atomic<int64_t>[]> counts_;
+    int64_t num_fields_;
+};
+
+}  // namespace milvus::segcore
@@ -11,6 +11,8 @@
 
 #include <string>
 #include <thread>
+#include "index/BitmapIndex.h"
+#include "index/BoolIndex.h"
 #include "index/ScalarIndexSort.h"
 #include "index/StringIndexSort.h"
 
@@ -53,9 +55,11 @@ VectorFieldIndexing::get_build_params() const {
     auto type_opt = field_meta_.get_metric_type();
     AssertInfo(type_opt.has_value(),
                "Metric type of field meta doesn't have value");
-    auto& metric_type = type_opt.value();
+    auto metric_type = SearchMetric(type_opt.value());
     auto& config = segcore_config_.at(metric_type);
     auto base_params = config.build_params;
+    // the current nlist, which may have changed since the table was made
+    base_params["nlist"] = std::to_string(segcore_config_.get_nlist());
 
     AssertInfo(base_params.count("nlist"), "Can't get nlist from index params");
     base_params[knowhere::meta::DIM] = std::to_string(field_meta_.get_dim());
@@ -70,10 +74,11 @@ VectorFieldIndexing::get_search_params(int top_K) const {
     auto type_opt = field_meta_.get_metric_type();
     AssertInfo(type_opt.has_value(),
                "Metric type of field meta doesn't have value");
-    auto& metric_type = type_opt.value();
+    auto metric_type = SearchMetric(type_opt.value());
     auto& config = segcore_config_.at(metric_type);
 
     auto base_params = config.search_params;
+    base_params["nprobe"] = segcore_config_.get_nprobe();
     AssertInfo(base_params.count("nprobe"),
                "Can't get nprobe from base params");
     base_params[knowhere::meta::TOPK] = top_K;
@@ -92,19 +97,80 @@ ScalarFieldIndexing<T>::BuildIndexRange(int64_t ack_beg,
     auto num_chunk = source->num_chunk();
     AssertInfo(ack_end <= num_chunk, "Ack_end is bigger than num_chunk");
     data_.grow_to_at_least(ack_end);
+    auto size = vec_base->get_size_per_chunk();
     for (int chunk_id = ack_beg; chunk_id < ack_end; chunk_id++) {
         const auto& chunk = source->get_chunk(chunk_id);
-        // build index for chunk
-        // TODO
-        if constexpr (std::is_same_v<T, std::string>) {
-            auto indexing = index::CreateStringIndexSort();
-            indexing->Build(vec_base->get_size_per_chunk(), chunk.data());
-            data_[chunk_id] = std::move(indexing);
+        index::ScalarIndexPtr<T> indexing;
+        // a chunk of few distinct values gets a bitmap of each, which
+        // answers terms and ranges without a search of the rows
+        if constexpr (std::is_same_v<T, bool>) {
+            indexing = index::CreateBoolIndex();
+        } else if (index::FitsBitmapIndex(size, chunk.data())) {
+            indexing = index::CreateBitmapIndex<T>();
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            indexing = index::CreateStringIndexSort();
         } else {
-            auto indexing = index::CreateScalarIndexSort<T>();
-            indexing->Build(vec_base->get_size_per_chunk(), chunk.data());
-            data_[chunk_id] = std::move(indexing);
+            indexing = index::CreateScalarIndexSort<T>();
         }
+        indexing->Build(size, chunk.data());
+        data_[chunk_id] = std::move(indexing);
+    }
+}
+
+SmallIndexBuilder&
+SmallIndexBuilder::Global() {
+    // never destroyed, so no segment outlives its builders at exit
+    static auto builder = new SmallIndexBuilder(
+        SegcoreConfig::default_config().get_small_index_build_threads(),
+        SegcoreConfig::default_config().get_small_index_build_queue());
+    return *builder;
+}
+
+SmallIndexBuilder::SmallIndexBuilder(int64_t num_threads, int64_t max_queued)
+    : max_queued_(max_queued) {
+    for (int64_t i = 0; i < num_threads; ++i) {
+        threads_.emplace_back(&SmallIndexBuilder::Work, this);
+    }
+}
+
+SmallIndexBuilder::~SmallIndexBuilder() {
+    {
+        std::lock_guard lck(mutex_);
+        stopped_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void
+SmallIndexBuilder::Submit(std::function<void()> task) {
+    {
+        std::lock_guard lck(mutex_);
+        if (!threads_.empty() && int64_t(queue_.size()) < max_queued_) {
+            queue_.push_back(std::move(task));
+            cv_.notify_one();
+            return;
+        }
+    }
+    task();
+}
+
+void
+SmallIndexBuilder::Work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lck(mutex_);
+            cv_.wait(lck, [this] { return stopped_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
     }
 }
 
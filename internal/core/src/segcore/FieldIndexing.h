@@ -11,9 +11,15 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <optional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <tbb/concurrent_vector.h>
 #include <index/Index.h>
@@ -22,8 +28,12 @@
 #include "AckResponder.h"
 #include "InsertRecord.h"
 #include "common/Schema.h"
+#include "segcore/GrowingGraphIndex.h"
+#include "segcore/QuantizedChunk.h"
 #include "segcore/SegcoreConfig.h"
+#include "segcore/SharedIvf.h"
 #include "index/VectorIndex.h"
+#include "log/Log.h"
 
 namespace milvus::segcore {
 
@@ -53,12 +63,24 @@ class FieldIndexing {
 
     int64_t
     get_size_per_chunk() const {
-        return segcore_config_.get_chunk_rows();
+        return segcore_config_.get_chunk_rows(field_meta_);
     }
 
     virtual index::IndexBase*
     get_chunk_indexing(int64_t chunk_id) const = 0;
 
+    // bytes of the indexes of the first num_chunks chunks, all built
+    int64_t
+    memory_usage(int64_t num_chunks) const {
+        int64_t bytes = 0;
+        for (int64_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+            if (auto indexing = get_chunk_indexing(chunk_id)) {
+                bytes += indexing->MemoryUsage();
+            }
+        }
+        return bytes;
+    }
+
  protected:
     // additional info
     const FieldMeta& field_meta_;
@@ -115,20 +137,65 @@ class VectorFieldIndexing : public FieldIndexing {
 std::unique_ptr<FieldIndexing>
 CreateIndex(const FieldMeta& field_meta, const SegcoreConfig& segcore_config);
 
+// Background builders of the small indexes of growing segments, shared by
+// all of them. The queue is bounded: a task that does not fit runs on the
+// submitting thread, which throttles inserts once the builders fall behind.
+// Without threads every task runs on its submitter.
+class SmallIndexBuilder {
+ public:
+    // sized by the default SegcoreConfig at the first use
+    static SmallIndexBuilder&
+    Global();
+
+    SmallIndexBuilder(int64_t num_threads, int64_t max_queued);
+
+    SmallIndexBuilder(const SmallIndexBuilder&) = delete;
+    SmallIndexBuilder&
+    operator=(const SmallIndexBuilder&) = delete;
+
+    // runs the queued tasks before returning
+    ~SmallIndexBuilder();
+
+    void
+    Submit(std::function<void()> task);
+
+ private:
+    void
+    Work();
+
+ private:
+    const int64_t max_queued_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool stopped_ = false;
+    std::vector<std::thread> threads_;
+};
+
 class IndexingRecord {
  public:
-    explicit IndexingRecord(const Schema& schema,
+    explicit IndexingRecord(const SchemaPtr& schema,
                             const SegcoreConfig& segcore_config)
-        : schema_(schema), segcore_config_(segcore_config) {
+        : schema_(*schema),
+          schema_ptr_(schema),
+          segcore_config_(segcore_config) {
         Initialize();
     }
 
+    ~IndexingRecord() {
+        WaitForBuilds();
+    }
+
     void
     Initialize() {
         int offset_id = 0;
         for (auto& [field_id, field_meta] : schema_.get_fields()) {
             ++offset_id;
 
+            // sparse vectors are brute forced while growing
+            if (field_meta.is_sparse_vector()) {
+                continue;
+            }
             if (field_meta.is_vector()) {
                 // TODO: skip binary small index now, reenable after config.yaml is ready
                 if (field_meta.get_data_type() == DataType::VECTOR_BINARY) {
@@ -138,43 +205,188 @@ class IndexingRecord {
                 if (!field_meta.get_metric_type().has_value()) {
                     continue;
                 }
+                if (use_quantized_chunks(field_meta)) {
+                    quantized_chunks_[field_id];
+                }
+                if (UseSharedIvf(field_meta, segcore_config_)) {
+                    ivf_chunks_[field_id];
+                    continue;
+                }
+                if (use_graph_index(field_meta)) {
+                    graph_indexings_.try_emplace(
+                        field_id,
+                        std::make_unique<GrowingGraphIndex>(
+                            field_meta.get_dim(),
+                            SearchMetric(field_meta.get_metric_type().value()),
+                            segcore_config_.get_graph_index_config()));
+                    continue;
+                }
             }
 
             field_indexings_.try_emplace(
                 field_id, CreateIndex(field_meta, segcore_config_));
         }
         assert(offset_id == schema_.size());
+
+        // the fields may have chunks of their own size, the acks move on
+        // once the smallest of them completes
+        min_chunk_rows_ = segcore_config_.get_chunk_rows();
+        for (auto& [field_id, indexing] : field_indexings_) {
+            min_chunk_rows_ =
+                std::min(min_chunk_rows_, indexing->get_size_per_chunk());
+        }
+        for (auto& [field_id, chunks] : quantized_chunks_) {
+            min_chunk_rows_ =
+                std::min(min_chunk_rows_,
+                         segcore_config_.get_chunk_rows(schema_[field_id]));
+        }
+        for (auto& [field_id, chunks] : ivf_chunks_) {
+            min_chunk_rows_ =
+                std::min(min_chunk_rows_,
+                         segcore_config_.get_chunk_rows(schema_[field_id]));
+        }
     }
 
-    // concurrent, reentrant
+    // concurrent, reentrant; indexes the chunks of every field completed
+    // within the first row_ack rows since the last call
     template <bool is_sealed>
     void
-    UpdateResourceAck(int64_t chunk_ack,
-                      const InsertRecord<is_sealed>& record) {
-        if (resource_ack_ >= chunk_ack) {
+    UpdateResourceAck(int64_t row_ack, const InsertRecord<is_sealed>& record) {
+        row_ack -= row_ack % min_chunk_rows_;
+        if (resource_ack_ >= row_ack) {
             return;
         }
 
         std::unique_lock lck(mutex_);
         int64_t old_ack = resource_ack_;
-        if (old_ack >= chunk_ack) {
+        if (old_ack >= row_ack) {
             return;
         }
-        resource_ack_ = chunk_ack;
+        resource_ack_ = row_ack;
         lck.unlock();
 
-        //    std::thread([this, old_ack, chunk_ack, &record] {
-        for (auto& [field_offset, entry] : field_indexings_) {
-            auto vec_base = record.get_field_data_base(field_offset);
-            entry->BuildIndexRange(old_ack, chunk_ack, vec_base);
+        // searches use brute force on the chunks until finished_ack_
+        // covers them, record must outlive the build, see WaitForBuilds
+        BeginBuild();
+        SmallIndexBuilder::Global().Submit([this, old_ack, row_ack, &record] {
+            try {
+                for (auto& [field_offset, entry] : field_indexings_) {
+                    auto vec_base = record.get_field_data_base(field_offset);
+                    auto chunk_rows = entry->get_size_per_chunk();
+                    entry->BuildIndexRange(
+                        old_ack / chunk_rows, row_ack / chunk_rows, vec_base);
+                }
+                for (auto& [field_id, chunks] : ivf_chunks_) {
+                    auto vec =
+                        record.template get_field_data<FloatVector>(field_id);
+                    BuildIvfChunks(field_id, chunks, old_ack, row_ack, *vec);
+                }
+                finished_ack_.AddSegment(old_ack, row_ack);
+            } catch (std::exception& e) {
+                // the chunks stay searched by brute force
+                LOG_SEGCORE_ERROR_ << "failed to build small index of rows ["
+                                   << old_ack << ", " << row_ack
+                                   << "): " << e.what();
+            }
+            EndBuild();
+        });
+    }
+
+    // concurrent, reentrant; extends the graph indexes once build_lag
+    // acked rows are missing from them
+    template <bool is_sealed>
+    void
+    UpdateGraphAck(int64_t row_ack, const InsertRecord<is_sealed>& record) {
+        if (graph_indexings_.empty()) {
+            return;
         }
-        finished_ack_.AddSegment(old_ack, chunk_ack);
-        //    }).detach();
+        // graphs end on a word of the search bitset, where the brute
+        // force over the rest can start
+        row_ack -= row_ack % 64;
+        auto build_lag = segcore_config_.get_graph_index_config().build_lag;
+        {
+            std::lock_guard lck(mutex_);
+            if (row_ack <= graph_ack_ || row_ack - graph_ack_ < build_lag) {
+                return;
+            }
+            graph_ack_ = row_ack;
+        }
+
+        // rows past the size of a graph are searched by brute force
+        BeginBuild();
+        SmallIndexBuilder::Global().Submit([this, row_ack, &record] {
+            try {
+                for (auto& [field_id, graph] : graph_indexings_) {
+                    graph->Extend(
+                        *record.template get_field_data<FloatVector>(field_id),
+                        row_ack);
+                }
+            } catch (std::exception& e) {
+                LOG_SEGCORE_ERROR_ << "failed to extend graph index to "
+                                   << row_ack << " rows: " << e.what();
+            }
+            EndBuild();
+        });
     }
 
-    // concurrent
+    // concurrent, reentrant; quantizes the chunks completed within the
+    // first row_ack rows since the last call
+    template <bool is_sealed>
+    void
+    UpdateQuantizedAck(int64_t row_ack, const InsertRecord<is_sealed>& record) {
+        row_ack -= row_ack % min_chunk_rows_;
+        if (quantized_chunks_.empty() || quantized_resource_ack_ >= row_ack) {
+            return;
+        }
+
+        std::unique_lock lck(mutex_);
+        int64_t old_ack = quantized_resource_ack_;
+        if (old_ack >= row_ack) {
+            return;
+        }
+        quantized_resource_ack_ = row_ack;
+        lck.unlock();
+
+        // the slots are written before quantized_ack_ publishes them
+        BeginBuild();
+        SmallIndexBuilder::Global().Submit([this, old_ack, row_ack, &record] {
+            try {
+                for (auto& [field_id, chunks] : quantized_chunks_) {
+                    auto vec =
+                        record.template get_field_data<FloatVector>(field_id);
+                    auto dim = schema_[field_id].get_dim();
+                    auto chunk_rows = vec->get_size_per_chunk();
+                    chunks.grow_to_at_least(row_ack / chunk_rows);
+                    for (auto chunk_id = old_ack / chunk_rows;
+                         chunk_id < row_ack / chunk_rows;
+                         ++chunk_id) {
+                        chunks[chunk_id] = std::make_unique<SQ8Chunk>(
+                            vec->get_element(chunk_id * chunk_rows),
+                            chunk_rows,
+                            dim);
+                    }
+                }
+                quantized_ack_.AddSegment(old_ack, row_ack);
+            } catch (std::exception& e) {
+                // the chunks stay scanned in float
+                LOG_SEGCORE_ERROR_ << "failed to quantize rows [" << old_ack
+                                   << ", " << row_ack << "): " << e.what();
+            }
+            EndBuild();
+        });
+    }
+
+    // blocks until the submitted builds are done
+    void
+    WaitForBuilds() {
+        std::unique_lock lck(builds_mutex_);
+        builds_cv_.wait(lck, [this] { return pending_builds_ == 0; });
+    }
+
+    // concurrent; the chunks of every indexed field within the first
+    // finished rows have their indexes
     int64_t
-    get_finished_ack() const {
+    get_finished_rows() const {
         return finished_ack_.GetAck();
     }
 
@@ -197,6 +409,81 @@ class IndexingRecord {
         return field_indexings_.count(field_id);
     }
 
+    // nullptr unless the field is indexed by a graph
+    const GrowingGraphIndex*
+    get_graph_index(FieldId field_id) const {
+        auto iter = graph_indexings_.find(field_id);
+        return iter == graph_indexings_.end() ? nullptr : iter->second.get();
+    }
+
+    // the inverted lists of a complete chunk over the shared centroids,
+    // nullptr until they are built
+    const IvfChunk*
+    get_ivf_chunk(FieldId field_id, int64_t chunk_id) const {
+        auto iter = ivf_chunks_.find(field_id);
+        if (iter == ivf_chunks_.end()) {
+            return nullptr;
+        }
+        auto chunk_rows = segcore_config_.get_chunk_rows(schema_[field_id]);
+        if ((chunk_id + 1) * chunk_rows > finished_ack_.GetAck()) {
+            return nullptr;
+        }
+        return iter->second[chunk_id].get();
+    }
+
+    // the 8-bit copy of a complete chunk, nullptr until it is built
+    const SQ8Chunk*
+    get_quantized_chunk(FieldId field_id, int64_t chunk_id) const {
+        auto iter = quantized_chunks_.find(field_id);
+        if (iter == quantized_chunks_.end()) {
+            return nullptr;
+        }
+        auto chunk_rows = segcore_config_.get_chunk_rows(schema_[field_id]);
+        if ((chunk_id + 1) * chunk_rows > quantized_ack_.GetAck()) {
+            return nullptr;
+        }
+        return iter->second[chunk_id].get();
+    }
+
+    // bytes of the small indexes of the chunks
+    int64_t
+    get_chunk_index_memory_usage() const {
+        int64_t bytes = 0;
+        auto finished_rows = finished_ack_.GetAck();
+        for (auto& [field_id, indexing] : field_indexings_) {
+            bytes += indexing->memory_usage(finished_rows /
+                                            indexing->get_size_per_chunk());
+        }
+        for (auto& [field_id, chunks] : ivf_chunks_) {
+            auto num_built =
+                finished_rows /
+                segcore_config_.get_chunk_rows(schema_[field_id]);
+            for (int64_t chunk_id = 0; chunk_id < num_built; ++chunk_id) {
+                bytes += chunks[chunk_id]->memory_usage();
+            }
+        }
+        return bytes;
+    }
+
+    // bytes of the graphs and the quantized chunks
+    int64_t
+    get_graph_memory_usage() const {
+        int64_t bytes = 0;
+        for (auto& [field_id, graph] : graph_indexings_) {
+            bytes += graph->memory_usage();
+        }
+        auto quantized_rows = quantized_ack_.GetAck();
+        for (auto& [field_id, chunks] : quantized_chunks_) {
+            auto num_quantized =
+                quantized_rows /
+                segcore_config_.get_chunk_rows(schema_[field_id]);
+            for (int64_t chunk_id = 0; chunk_id < num_quantized; ++chunk_id) {
+                bytes += chunks[chunk_id]->memory_usage();
+            }
+        }
+        return bytes;
+    }
+
     template <typename T>
     auto
     get_scalar_field_indexing(FieldId field_id) const
@@ -207,20 +494,99 @@ class IndexingRecord {
         return *ptr;
     }
 
+ private:
+    bool
+    use_graph_index(const FieldMeta& field_meta) const {
+        auto metric_type = SearchMetric(field_meta.get_metric_type().value());
+        return segcore_config_.get_growing_index_type() == "HNSW" &&
+               field_meta.get_data_type() == DataType::VECTOR_FLOAT &&
+               (metric_type == knowhere::metric::L2 ||
+                metric_type == knowhere::metric::IP);
+    }
+
+    // assigns the rows of the chunks within [old_ack, row_ack) to the
+    // centroids of the field, which the first chunk built trains unless a
+    // segment of the collection did before
+    void
+    BuildIvfChunks(FieldId field_id,
+                   tbb::concurrent_vector<std::unique_ptr<IvfChunk>>& chunks,
+                   int64_t old_ack,
+                   int64_t row_ack,
+                   const ConcurrentVector<FloatVector>& vec) {
+        auto chunk_rows = vec.get_size_per_chunk();
+        chunks.grow_to_at_least(row_ack / chunk_rows);
+        for (auto chunk_id = old_ack / chunk_rows;
+             chunk_id < row_ack / chunk_rows;
+             ++chunk_id) {
+            auto data = vec.get_element(chunk_id * chunk_rows);
+            auto centroids = SharedCentroids::Global().GetOrTrain(
+                schema_ptr_,
+                field_id,
+                data,
+                chunk_rows,
+                segcore_config_.get_nlist());
+            chunks[chunk_id] =
+                std::make_unique<IvfChunk>(centroids, data, chunk_rows);
+        }
+    }
+
+    bool
+    use_quantized_chunks(const FieldMeta& field_meta) const {
+        auto metric_type = SearchMetric(field_meta.get_metric_type().value());
+        return segcore_config_.get_growing_sq8_refine_ratio() > 0 &&
+               field_meta.get_data_type() == DataType::VECTOR_FLOAT &&
+               (metric_type == knowhere::metric::L2 ||
+                metric_type == knowhere::metric::IP);
+    }
+
+    void
+    BeginBuild() {
+        std::lock_guard lck(builds_mutex_);
+        ++pending_builds_;
+    }
+
+    void
+    EndBuild() {
+        std::lock_guard lck(builds_mutex_);
+        if (--pending_builds_ == 0) {
+            builds_cv_.notify_all();
+        }
+    }
+
  private:
     const Schema& schema_;
+    // tells the collection apart for the shared centroids
+    const SchemaPtr schema_ptr_;
     const SegcoreConfig& segcore_config_;
 
  private:
-    // control info
+    // control info, the acks count rows
+    int64_t min_chunk_rows_ = 0;
     std::atomic<int64_t> resource_ack_ = 0;
     //    std::atomic<int64_t> finished_ack_ = 0;
     AckResponder finished_ack_;
     std::mutex mutex_;
+    std::mutex builds_mutex_;
+    std::condition_variable builds_cv_;
+    int64_t pending_builds_ = 0;
+    // rows submitted to the graph indexes, guarded by mutex_
+    int64_t graph_ack_ = 0;
+    // rows submitted for quantization and the ones quantized
+    std::atomic<int64_t> quantized_resource_ack_ = 0;
+    AckResponder quantized_ack_;
 
  private:
     // field_offset => indexing
     std::map<FieldId, std::unique_ptr<FieldIndexing>> field_indexings_;
+    // vector fields indexed by a graph instead of per chunk
+    std::map<FieldId, std::unique_ptr<GrowingGraphIndex>> graph_indexings_;
+    // 8-bit copies of the complete chunks of float vector fields
+    std::map<FieldId, tbb::concurrent_vector<std::unique_ptr<SQ8Chunk>>>
+        quantized_chunks_;
+    // inverted lists of the complete chunks of fields of the IVF_SHARED
+    // growing index type
+    std::map<FieldId, tbb::concurrent_vector<std::unique_ptr<IvfChunk>>>
+        ivf_chunks_;
 };
 
 }  // namespace milvus::segcore
@@ -0,0 +1,117 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// LRU of predicate results of one segment, keyed by the fingerprint of the
+// predicate. Memory is accounted as the bitset blocks plus the key bytes.
+// Results are invalidated as a whole by Clear, whenever the data or the
+// indexes the predicates may read change.
+class FilterCache {
+ public:
+    using Version = uint64_t;
+
+    // bumped by every Clear; a result computed under an older version
+    // may be stale and is not admitted
+    Version
+    version() const {
+        std::lock_guard lck(mutex_);
+        return version_;
+    }
+
+    std::shared_ptr<const BitsetType>
+    Get(const std::string& fingerprint) {
+        std::lock_guard lck(mutex_);
+        auto iter = index_.find(fingerprint);
+        if (iter == index_.end()) {
+            return nullptr;
+        }
+        lru_.splice(lru_.begin(), lru_, iter->second);
+        return iter->second->result;
+    }
+
+    void
+    Put(const std::string& fingerprint,
+        const BitsetType& result,
+        Version version,
+        int64_t capacity) {
+        auto bytes = static_cast<int64_t>(
+            fingerprint.size() +
+            result.num_blocks() * sizeof(BitsetType::block_type));
+        if (bytes > capacity) {
+            return;
+        }
+        auto entry = std::make_shared<const BitsetType>(result);
+        std::lock_guard lck(mutex_);
+        if (version != version_ || index_.count(fingerprint)) {
+            return;
+        }
+        lru_.push_front(Entry{fingerprint, std::move(entry), bytes});
+        index_.emplace(lru_.front().fingerprint, lru_.begin());
+        memory_usage_ += bytes;
+        while (memory_usage_ > capacity) {
+            auto& victim = lru_.back();
+            memory_usage_ -= victim.bytes;
+            index_.erase(victim.fingerprint);
+            lru_.pop_back();
+        }
+    }
+
+    void
+    Clear() {
+        std::lock_guard lck(mutex_);
+        ++version_;
+        index_.clear();
+        lru_.clear();
+        memory_usage_ = 0;
+    }
+
+    int64_t
+    memory_usage() const {
+        std::lock_guard lck(mutex_);
+        return memory_usage_;
+    }
+
+    int64_t
+    size() const {
+        std::lock_guard lck(mutex_);
+        return index_.size();
+    }
+
+ private:
+    struct Entry {
+        std::string fingerprint;
+        std::shared_ptr<const BitsetType> result;
+        int64_t bytes;
+    };
+
+    mutable std::mutex mutex_;
+    // most recently used first
+    std::list<Entry> lru_;
+    // keys view the fingerprints owned by lru_
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    int64_t memory_usage_ = 0;
+    Version version_ = 0;
+};
+
+}  // namespace milvus::segcore
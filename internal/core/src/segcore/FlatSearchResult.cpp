@@ -0,0 +1,344 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <cstring>
+#include <string>
+
+#include "exceptions/EasyAssert.h"
+#include "segcore/FlatSearchResult.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+int64_t
+Padded(int64_t bytes) {
+    return (bytes + 7) / 8 * 8;
+}
+
+// offsets and bytes of a VARCHAR column
+template <typename GetString>
+int64_t
+StringColumnSize(const FlatResultRows& rows, GetString&& get) {
+    int64_t size = (rows.size() + 1) * sizeof(int64_t);
+    for (auto& [result, offset] : rows) {
+        size += get(*result, offset).size();
+    }
+    return size;
+}
+
+template <typename GetString>
+void
+WriteStrings(char* dst, const FlatResultRows& rows, GetString&& get) {
+    auto offsets = reinterpret_cast<int64_t*>(dst);
+    auto bytes = dst + (rows.size() + 1) * sizeof(int64_t);
+    offsets[0] = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto& str = get(*rows[i].first, rows[i].second);
+        std::memcpy(bytes + offsets[i], str.data(), str.size());
+        offsets[i + 1] = offsets[i] + str.size();
+    }
+}
+
+template <typename T, typename Get>
+void
+WriteValues(char* dst, const FlatResultRows& rows, Get&& get) {
+    auto values = reinterpret_cast<T*>(dst);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        values[i] = get(*rows[i].first, rows[i].second);
+    }
+}
+
+const std::string&
+PkString(const SearchResult& result, int64_t offset) {
+    return std::get<std::string>(result.primary_keys_[offset]);
+}
+
+int64_t
+FieldColumnSize(const FieldMeta& field, const FlatResultRows& rows) {
+    auto data_type = field.get_data_type();
+    if (datatype_is_variable(data_type)) {
+        auto id = field.get_id();
+        return StringColumnSize(
+            rows,
+            [id](const SearchResult& result,
+                 int64_t offset) -> const std::string& {
+                return result.output_fields_data_.at(id)
+                    ->scalars()
+                    .string_data()
+                    .data(offset);
+            });
+    }
+    auto dim = field.is_vector() ? field.get_dim() : 1;
+    return rows.size() * datatype_sizeof(data_type, dim);
+}
+
+void
+WriteField(char* dst, const FieldMeta& field, const FlatResultRows& rows) {
+    auto id = field.get_id();
+    auto data_of = [id](const SearchResult& result) -> const DataArray& {
+        return *result.output_fields_data_.at(id);
+    };
+    auto scalars_of = [&](const SearchResult& result) -> const ScalarArray& {
+        return data_of(result).scalars();
+    };
+    switch (field.get_data_type()) {
+        case DataType::BOOL: {
+            WriteValues<bool>(dst, rows, [&](auto& result, int64_t offset) {
+                return scalars_of(result).bool_data().data(offset);
+            });
+            break;
+        }
+        case DataType::INT8: {
+            WriteValues<int8_t>(dst, rows, [&](auto& result, int64_t offset) {
+                return scalars_of(result).int_data().data(offset);
+            });
+            break;
+        }
+        case DataType::INT16: {
+            WriteValues<int16_t>(dst, rows, [&](auto& result, int64_t offset) {
+                return scalars_of(result).int_data().data(offset);
+            });
+            break;
+        }
+        case DataType::INT32: {
+            WriteValues<int32_t>(dst, rows, [&](auto& result, int64_t offset) {
+                return scalars_of(result).int_data().data(offset);
+            });
+            break;
+        }
+        case DataType::INT64: {
+            WriteValues<int64_t>(dst, rows, [&](auto& result, int64_t offset) {
+                return scalars_of(result).long_data().data(offset);
+            });
+            break;
+        }
+        case DataType::FLOAT: {
+            WriteValues<float>(dst, rows, [&](auto& result, int64_t offset) {
+                return scalars_of(result).float_data().data(offset);
+            });
+            break;
+        }
+        case DataType::DOUBLE: {
+            WriteValues<double>(dst, rows, [&](auto& result, int64_t offset) {
+                return scalars_of(result).double_data().data(offset);
+            });
+            break;
+        }
+        case DataType::VARCHAR: {
+            WriteStrings(dst,
+                         rows,
+                         [&](auto& result,
+                             int64_t offset) -> const std::string& {
+                             return scalars_of(result).string_data().data(
+                                 offset);
+                         });
+            break;
+        }
+        case DataType::VECTOR_FLOAT: {
+            auto dim = field.get_dim();
+            auto row_bytes = dim * sizeof(float);
+            for (size_t i = 0; i < rows.size(); ++i) {
+                auto& [result, offset] = rows[i];
+                auto src =
+                    data_of(*result).vectors().float_vector().data().data();
+                std::memcpy(dst + i * row_bytes, src + offset * dim, row_bytes);
+            }
+            break;
+        }
+        case DataType::VECTOR_BINARY: {
+            auto row_bytes = datatype_sizeof(DataType::VECTOR_BINARY,
+                                             field.get_dim());
+            for (size_t i = 0; i < rows.size(); ++i) {
+                auto& [result, offset] = rows[i];
+                auto src = data_of(*result).vectors().binary_vector().data();
+                std::memcpy(
+                    dst + i * row_bytes, src + offset * row_bytes, row_bytes);
+            }
+            break;
+        }
+        default: {
+            PanicInfo("unsupported datatype");
+        }
+    }
+}
+
+// takes the padded sections of a flat result in order
+class SectionReader {
+ public:
+    SectionReader(const char* data, size_t size) : data_(data), size_(size) {
+    }
+
+    const char*
+    Take(int64_t bytes) {
+        AssertInfo(bytes >= 0 && pos_ + Padded(bytes) <= size_,
+                   "truncated flat search result");
+        auto section = data_ + pos_;
+        pos_ += Padded(bytes);
+        return section;
+    }
+
+    // a column of rows values, its size known for fixed widths only
+    FlatColumn
+    TakeColumn(DataType data_type, int32_t dim, int64_t rows, int64_t size) {
+        FlatColumn column;
+        column.data_type = data_type;
+        column.dim = dim;
+        column.rows = rows;
+        if (datatype_is_variable(data_type)) {
+            // the offsets, then the bytes they end at
+            int64_t offsets_size = (rows + 1) * sizeof(int64_t);
+            auto offsets = reinterpret_cast<const int64_t*>(data_ + pos_);
+            AssertInfo(pos_ + offsets_size <= size_ && offsets[rows] >= 0,
+                       "truncated flat search result");
+            column.size = offsets_size + offsets[rows];
+        } else {
+            column.size = rows * datatype_sizeof(data_type, dim);
+        }
+        AssertInfo(size < 0 || size == column.size,
+                   "wrong column size in flat search result");
+        column.data = Take(column.size);
+        return column;
+    }
+
+ private:
+    const char* data_;
+    const size_t size_;
+    size_t pos_ = 0;
+};
+
+}  // namespace
+
+std::vector<char>
+WriteFlatSearchResult(int64_t top_k,
+                      const std::vector<int64_t>& topks,
+                      const FlatResultRows& rows,
+                      DataType pk_type,
+                      const std::vector<const FieldMeta*>& fields) {
+    int64_t num_queries = topks.size();
+    int64_t result_count = rows.size();
+    int64_t ids_size = 0;
+    switch (pk_type) {
+        case DataType::INT64: {
+            ids_size = result_count * sizeof(int64_t);
+            break;
+        }
+        case DataType::VARCHAR: {
+            ids_size = StringColumnSize(rows, PkString);
+            break;
+        }
+        default: {
+            PanicInfo("unsupported primary key type");
+        }
+    }
+    std::vector<int64_t> field_sizes;
+    auto size = Padded(sizeof(FlatResultHeader)) +
+                Padded(num_queries * sizeof(int64_t)) +
+                Padded(result_count * sizeof(float)) + Padded(ids_size);
+    for (auto field : fields) {
+        field_sizes.push_back(FieldColumnSize(*field, rows));
+        size += Padded(sizeof(FlatFieldHeader)) + Padded(field_sizes.back());
+    }
+
+    // zeroed, so is the padding
+    std::vector<char> blob(size);
+    int64_t pos = 0;
+    auto take = [&blob, &pos](int64_t bytes) {
+        auto section = blob.data() + pos;
+        pos += Padded(bytes);
+        return section;
+    };
+
+    auto header = reinterpret_cast<FlatResultHeader*>(
+        take(sizeof(FlatResultHeader)));
+    header->magic = FLAT_RESULT_MAGIC;
+    header->version = FLAT_RESULT_VERSION;
+    header->num_queries = num_queries;
+    header->top_k = top_k;
+    header->result_count = result_count;
+    header->pk_type = int32_t(pk_type);
+    header->num_fields = fields.size();
+
+    std::memcpy(take(num_queries * sizeof(int64_t)),
+                topks.data(),
+                num_queries * sizeof(int64_t));
+    WriteValues<float>(take(result_count * sizeof(float)),
+                       rows,
+                       [](const SearchResult& result, int64_t offset) {
+                           return result.distances_[offset];
+                       });
+    auto ids = take(ids_size);
+    if (pk_type == DataType::INT64) {
+        WriteValues<int64_t>(
+            ids, rows, [](const SearchResult& result, int64_t offset) {
+                return std::get<int64_t>(result.primary_keys_[offset]);
+            });
+    } else {
+        WriteStrings(ids, rows, PkString);
+    }
+
+    for (size_t i = 0; i < fields.size(); ++i) {
+        auto& field = *fields[i];
+        auto field_header = reinterpret_cast<FlatFieldHeader*>(
+            take(sizeof(FlatFieldHeader)));
+        field_header->field_id = field.get_id().get();
+        field_header->data_type = int32_t(field.get_data_type());
+        field_header->dim = field.is_vector() ? field.get_dim() : 0;
+        field_header->size = field_sizes[i];
+        WriteField(take(field_sizes[i]), field, rows);
+    }
+    AssertInfo(pos == size, "flat search result size mismatch");
+    return blob;
+}
+
+std::string_view
+FlatColumn::string_at(int64_t row) const {
+    auto offsets = values<int64_t>();
+    auto bytes = data + (rows + 1) * sizeof(int64_t);
+    return {bytes + offsets[row], size_t(offsets[row + 1] - offsets[row])};
+}
+
+FlatSearchResultView::FlatSearchResultView(const char* data, size_t size) {
+    SectionReader reader(data, size);
+    header_ = reinterpret_cast<const FlatResultHeader*>(
+        reader.Take(sizeof(FlatResultHeader)));
+    AssertInfo(header_->magic == FLAT_RESULT_MAGIC,
+               "not a flat search result");
+    AssertInfo(header_->version == FLAT_RESULT_VERSION,
+               "unsupported flat search result version " +
+                   std::to_string(header_->version));
+    auto num_queries = header_->num_queries;
+    auto result_count = header_->result_count;
+    AssertInfo(num_queries >= 0 && result_count >= 0,
+               "corrupted flat search result");
+
+    topks_ = reinterpret_cast<const int64_t*>(
+        reader.Take(num_queries * sizeof(int64_t)));
+    scores_ = reinterpret_cast<const float*>(
+        reader.Take(result_count * sizeof(float)));
+    auto pk_type = DataType(header_->pk_type);
+    AssertInfo(pk_type == DataType::INT64 || pk_type == DataType::VARCHAR,
+               "unsupported primary key type");
+    ids_ = reader.TakeColumn(pk_type, 0, result_count, -1);
+
+    for (int32_t i = 0; i < header_->num_fields; ++i) {
+        auto field_header = reinterpret_cast<const FlatFieldHeader*>(
+            reader.Take(sizeof(FlatFieldHeader)));
+        auto data_type = DataType(field_header->data_type);
+        auto dim = datatype_is_vector(data_type) ? field_header->dim : 1;
+        auto column =
+            reader.TakeColumn(data_type, dim, result_count, field_header->size);
+        column.dim = field_header->dim;
+        fields_.emplace_back(field_header->field_id, column);
+    }
+}
+
+}  // namespace milvus::segcore
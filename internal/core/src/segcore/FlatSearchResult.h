@@ -0,0 +1,132 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/FieldMeta.h"
+#include "common/QueryResult.h"
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// Flat columnar layout of the reduced results of one slice, an alternative
+// to a serialized SearchResultData that readers use in place, without a
+// decode. All integers are little endian and every section starts at a
+// multiple of 8 bytes:
+//
+//   FlatResultHeader
+//   int64 topks[num_queries]
+//   float scores[result_count]
+//   ids, a column of pk_type
+//   num_fields times: FlatFieldHeader, then a column of its data_type
+//
+// A fixed width column holds result_count values of the type's width,
+// BOOL as one byte and vectors as rows of dim. A VARCHAR column holds
+// int64 offsets[result_count + 1] into the bytes that follow them.
+constexpr uint32_t FLAT_RESULT_MAGIC = 0x5253564d;  // "MVSR"
+constexpr uint32_t FLAT_RESULT_VERSION = 1;
+
+struct FlatResultHeader {
+    uint32_t magic;
+    uint32_t version;
+    int64_t num_queries;
+    int64_t top_k;
+    int64_t result_count;
+    int32_t pk_type;
+    int32_t num_fields;
+};
+
+struct FlatFieldHeader {
+    int64_t field_id;
+    int32_t data_type;
+    // of vectors, 0 otherwise
+    int32_t dim;
+    // bytes of the column, without padding
+    int64_t size;
+};
+
+// the search result and offset of every result row, in output order
+using FlatResultRows = std::vector<std::pair<SearchResult*, int64_t>>;
+
+// one allocation holding the whole slice, written straight from the pks,
+// distances and output fields of the search results
+std::vector<char>
+WriteFlatSearchResult(int64_t top_k,
+                      const std::vector<int64_t>& topks,
+                      const FlatResultRows& rows,
+                      DataType pk_type,
+                      const std::vector<const FieldMeta*>& fields);
+
+// a column of a flat result, viewing the blob
+struct FlatColumn {
+    DataType data_type = DataType::NONE;
+    int32_t dim = 0;
+    int64_t rows = 0;
+    const char* data = nullptr;
+    int64_t size = 0;
+
+    template <typename T>
+    const T*
+    values() const {
+        return reinterpret_cast<const T*>(data);
+    }
+
+    // of a VARCHAR column
+    std::string_view
+    string_at(int64_t row) const;
+};
+
+// Validates a flat result and views its sections, the blob must outlive
+// the view.
+class FlatSearchResultView {
+ public:
+    FlatSearchResultView(const char* data, size_t size);
+
+    const FlatResultHeader&
+    header() const {
+        return *header_;
+    }
+
+    const int64_t*
+    topks() const {
+        return topks_;
+    }
+
+    const float*
+    scores() const {
+        return scores_;
+    }
+
+    const FlatColumn&
+    ids() const {
+        return ids_;
+    }
+
+    // field_id and column of each output field
+    const std::vector<std::pair<int64_t, FlatColumn>>&
+    fields() const {
+        return fields_;
+    }
+
+ private:
+    const FlatResultHeader* header_;
+    const int64_t* topks_;
+    const float* scores_;
+    FlatColumn ids_;
+    std::vector<std::pair<int64_t, FlatColumn>> fields_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,84 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "common/Consts.h"
+
+namespace milvus::segcore {
+
+// rows the prefetches run ahead of the copies
+constexpr int64_t GATHER_PREFETCH_ROWS = 8;
+// bytes prefetched of a row, the hardware streams the rest of long rows
+constexpr int64_t GATHER_PREFETCH_BYTES = 256;
+
+// Calls copy(i, offsets[i]) for every valid offset, skipping those at
+// INVALID_SEG_OFFSET. Unsorted offsets are visited in ascending order, so
+// duplicated and clustered offsets hit the cache, and the row at
+// address(offset) is prefetched GATHER_PREFETCH_ROWS visits ahead; copy
+// still writes row i where the caller's output expects it.
+template <typename Address, typename Copy>
+void
+GatherRows(const int64_t* offsets,
+           int64_t count,
+           int64_t row_bytes,
+           Address&& address,
+           Copy&& copy) {
+    // indexes of offsets in ascending offset order, empty if they are
+    std::vector<int64_t> order;
+    if (!std::is_sorted(offsets, offsets + count)) {
+        order.resize(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [offsets](auto x, auto y) {
+            return offsets[x] < offsets[y];
+        });
+    }
+    auto index = [&order](int64_t k) { return order.empty() ? k : order[k]; };
+    auto prefetch_bytes = std::min(row_bytes, GATHER_PREFETCH_BYTES);
+
+    for (int64_t k = 0; k < count; ++k) {
+        if (k + GATHER_PREFETCH_ROWS < count) {
+            auto ahead = offsets[index(k + GATHER_PREFETCH_ROWS)];
+            if (ahead != INVALID_SEG_OFFSET) {
+                auto row = reinterpret_cast<const char*>(address(ahead));
+                for (int64_t line = 0; line < prefetch_bytes; line += 64) {
+                    __builtin_prefetch(row + line);
+                }
+            }
+        }
+        auto i = index(k);
+        if (offsets[i] != INVALID_SEG_OFFSET) {
+            copy(i, offsets[i]);
+        }
+    }
+}
+
+// writes a gathered value, through the pointer for the strings of a
+// protobuf RepeatedPtrField
+template <typename T, typename S>
+void
+AssignValue(T& dst, const S& src) {
+    dst = src;
+}
+
+template <typename S>
+void
+AssignValue(std::string*& dst, const S& src) {
+    *dst = src;
+}
+
+}  // namespace milvus::segcore
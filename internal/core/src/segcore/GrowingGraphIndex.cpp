@@ -0,0 +1,367 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include "exceptions/EasyAssert.h"
+#include "segcore/GrowingGraphIndex.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+// rows linked per exclusive lock, so searches wait for one batch at most
+constexpr int64_t EXTEND_BATCH_ROWS = 1024;
+
+// nodes visited by the current search of this thread, a node is visited
+// when its tag equals the epoch
+class VisitedTags {
+ public:
+    static VisitedTags&
+    ThreadLocal() {
+        thread_local VisitedTags tags;
+        return tags;
+    }
+
+    void
+    Reset(int64_t num_nodes) {
+        if (int64_t(tags_.size()) < num_nodes) {
+            tags_.resize(num_nodes, 0);
+        }
+        if (++epoch_ == 0) {
+            std::fill(tags_.begin(), tags_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    // true the first time node is visited since Reset
+    bool
+    Visit(int32_t node) {
+        if (tags_[node] == epoch_) {
+            return false;
+        }
+        tags_[node] = epoch_;
+        return true;
+    }
+
+ private:
+    std::vector<uint16_t> tags_;
+    uint16_t epoch_ = 0;
+};
+
+}  // namespace
+
+GrowingGraphIndex::GrowingGraphIndex(int64_t dim,
+                                     const MetricType& metric_type,
+                                     const GraphIndexConf& conf)
+    : dim_(dim),
+      is_ip_(metric_type == knowhere::metric::IP),
+      m_(conf.m),
+      m0_(2 * conf.m),
+      ef_construction_(std::max(conf.ef_construction, conf.m)),
+      level_mult_(1 / std::log(double(conf.m))),
+      level_generator_(100) {
+    AssertInfo(is_ip_ || metric_type == knowhere::metric::L2,
+               "growing graph index supports L2 and IP only");
+    AssertInfo(conf.m >= 2, "graph index m must be at least 2");
+}
+
+float
+GrowingGraphIndex::distance(const float* x, const float* y) const {
+    // four accumulators, so the loop vectorizes without -ffast-math
+    float acc[4] = {0, 0, 0, 0};
+    int64_t i = 0;
+    if (is_ip_) {
+        for (; i + 4 <= dim_; i += 4) {
+            for (int j = 0; j < 4; ++j) {
+                acc[j] += x[i + j] * y[i + j];
+            }
+        }
+        for (; i < dim_; ++i) {
+            acc[0] += x[i] * y[i];
+        }
+        return -(acc[0] + acc[1] + acc[2] + acc[3]);
+    }
+    for (; i + 4 <= dim_; i += 4) {
+        for (int j = 0; j < 4; ++j) {
+            auto diff = x[i + j] - y[i + j];
+            acc[j] += diff * diff;
+        }
+    }
+    for (; i < dim_; ++i) {
+        auto diff = x[i] - y[i];
+        acc[0] += diff * diff;
+    }
+    return acc[0] + acc[1] + acc[2] + acc[3];
+}
+
+int32_t*
+GrowingGraphIndex::links(int32_t node, int level) {
+    if (level == 0) {
+        return level0_.data() + node * (m0_ + 1);
+    }
+    return upper_[node].data() + (level - 1) * (m_ + 1);
+}
+
+const int32_t*
+GrowingGraphIndex::links(int32_t node, int level) const {
+    return const_cast<GrowingGraphIndex*>(this)->links(node, level);
+}
+
+int32_t
+GrowingGraphIndex::greedy_descent(const float* query, int down_to) const {
+    auto current = entry_;
+    auto current_distance = distance(query, vector_of(current));
+    for (int level = max_level_; level > down_to; --level) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            auto list = links(current, level);
+            for (int32_t i = 1; i <= list[0]; ++i) {
+                auto d = distance(query, vector_of(list[i]));
+                if (d < current_distance) {
+                    current = list[i];
+                    current_distance = d;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+template <typename Filter>
+std::vector<GrowingGraphIndex::Neighbor>
+GrowingGraphIndex::search_level(const float* query,
+                                int32_t entry,
+                                int64_t ef,
+                                int level,
+                                int64_t num_nodes,
+                                Filter&& allowed) const {
+    auto& visited = VisitedTags::ThreadLocal();
+    visited.Reset(num_nodes);
+
+    // nearest first
+    std::priority_queue<Neighbor, std::vector<Neighbor>, std::greater<>>
+        candidates;
+    // farthest first, the allowed nodes only
+    std::priority_queue<Neighbor> nearest;
+    auto bound = std::numeric_limits<float>::max();
+
+    auto entry_distance = distance(query, vector_of(entry));
+    visited.Visit(entry);
+    candidates.emplace(entry_distance, entry);
+    if (allowed(entry)) {
+        nearest.emplace(entry_distance, entry);
+        bound = entry_distance;
+    }
+
+    while (!candidates.empty()) {
+        auto [candidate_distance, candidate] = candidates.top();
+        if (candidate_distance > bound && int64_t(nearest.size()) >= ef) {
+            break;
+        }
+        candidates.pop();
+        auto list = links(candidate, level);
+        for (int32_t i = 1; i <= list[0]; ++i) {
+            auto neighbor = list[i];
+            if (!visited.Visit(neighbor)) {
+                continue;
+            }
+            auto d = distance(query, vector_of(neighbor));
+            if (int64_t(nearest.size()) >= ef && d >= bound) {
+                continue;
+            }
+            candidates.emplace(d, neighbor);
+            if (allowed(neighbor)) {
+                nearest.emplace(d, neighbor);
+                if (int64_t(nearest.size()) > ef) {
+                    nearest.pop();
+                }
+                bound = nearest.top().first;
+            }
+        }
+    }
+
+    std::vector<Neighbor> result;
+    result.reserve(nearest.size());
+    while (!nearest.empty()) {
+        result.push_back(nearest.top());
+        nearest.pop();
+    }
+    return result;
+}
+
+void
+GrowingGraphIndex::select_neighbors(std::vector<Neighbor>& candidates,
+                                    int64_t max_neighbors) const {
+    std::sort(candidates.begin(), candidates.end());
+    if (int64_t(candidates.size()) <= max_neighbors) {
+        return;
+    }
+    std::vector<Neighbor> kept;
+    kept.reserve(max_neighbors);
+    for (auto& candidate : candidates) {
+        if (int64_t(kept.size()) == max_neighbors) {
+            break;
+        }
+        auto candidate_vector = vector_of(candidate.second);
+        bool diverse = std::all_of(
+            kept.begin(), kept.end(), [&](const Neighbor& neighbor) {
+                return distance(candidate_vector,
+                                vector_of(neighbor.second)) >=
+                       candidate.first;
+            });
+        if (diverse) {
+            kept.push_back(candidate);
+        }
+    }
+    candidates = std::move(kept);
+}
+
+void
+GrowingGraphIndex::link(int32_t node,
+                        int level,
+                        std::vector<Neighbor>& candidates) {
+    // a new node links m_ neighbors, old ones keep up to max_neighbors
+    auto max_neighbors = level == 0 ? m0_ : m_;
+    select_neighbors(candidates, m_);
+    auto list = links(node, level);
+    list[0] = candidates.size();
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        list[i + 1] = candidates[i].second;
+    }
+
+    for (auto& [d, neighbor] : candidates) {
+        auto neighbor_list = links(neighbor, level);
+        if (neighbor_list[0] < max_neighbors) {
+            neighbor_list[++neighbor_list[0]] = node;
+            continue;
+        }
+        // full, keep the most diverse of its links and the new one
+        auto neighbor_vector = vector_of(neighbor);
+        std::vector<Neighbor> merged;
+        merged.reserve(max_neighbors + 1);
+        merged.emplace_back(d, node);
+        for (int32_t i = 1; i <= neighbor_list[0]; ++i) {
+            merged.emplace_back(
+                distance(neighbor_vector, vector_of(neighbor_list[i])),
+                neighbor_list[i]);
+        }
+        select_neighbors(merged, max_neighbors);
+        neighbor_list[0] = merged.size();
+        for (size_t i = 0; i < merged.size(); ++i) {
+            neighbor_list[i + 1] = merged[i].second;
+        }
+    }
+}
+
+void
+GrowingGraphIndex::insert(int32_t node) {
+    std::uniform_real_distribution<double> uniform(0, 1);
+    auto draw = 1 - uniform(level_generator_);
+    auto level = std::min<int>(int(-std::log(draw) * level_mult_),
+                               std::numeric_limits<int8_t>::max());
+    levels_[node] = level;
+    std::fill_n(links(node, 0), m0_ + 1, 0);
+    if (level > 0) {
+        upper_[node].assign(level * (m_ + 1), 0);
+    }
+
+    if (entry_ < 0) {
+        entry_ = node;
+        max_level_ = level;
+        return;
+    }
+
+    auto query = vector_of(node);
+    auto entry = greedy_descent(query, level);
+    auto all = [](int32_t) { return true; };
+    for (int l = std::min(level, max_level_); l >= 0; --l) {
+        auto candidates =
+            search_level(query, entry, ef_construction_, l, node, all);
+        // the nearest candidate enters the next level down
+        entry = std::min_element(candidates.begin(), candidates.end())->second;
+        link(node, l, candidates);
+    }
+    if (level > max_level_) {
+        entry_ = node;
+        max_level_ = level;
+    }
+}
+
+void
+GrowingGraphIndex::Extend(const ConcurrentVector<FloatVector>& source,
+                          int64_t end) {
+    AssertInfo(end <= std::numeric_limits<int32_t>::max(),
+               "too many rows for the growing graph index");
+    std::lock_guard extend_lck(extend_mutex_);
+    auto begin = size();
+    while (begin < end) {
+        auto batch_end = std::min(end, begin + EXTEND_BATCH_ROWS);
+        std::unique_lock lck(mutex_);
+        source_ = &source;
+        levels_.resize(batch_end);
+        level0_.resize(batch_end * (m0_ + 1));
+        upper_.resize(batch_end);
+        for (auto node = begin; node < batch_end; ++node) {
+            insert(node);
+        }
+        size_.store(batch_end, std::memory_order_release);
+        begin = batch_end;
+    }
+}
+
+int64_t
+GrowingGraphIndex::Search(const float* query,
+                          int64_t topk,
+                          int64_t ef,
+                          int64_t limit,
+                          const BitsetView& bitset,
+                          int64_t* seg_offsets,
+                          float* distances) const {
+    std::shared_lock lck(mutex_);
+    auto num_nodes = size();
+    if (num_nodes == 0 || topk <= 0) {
+        return 0;
+    }
+    auto allowed = [&](int32_t node) {
+        return node < limit && (bitset.empty() || !bitset.test(node));
+    };
+    auto entry = greedy_descent(query, 0);
+    auto nearest = search_level(
+        query, entry, std::max(ef, topk), 0, num_nodes, allowed);
+    std::sort(nearest.begin(), nearest.end());
+
+    auto found = std::min<int64_t>(topk, nearest.size());
+    for (int64_t i = 0; i < found; ++i) {
+        seg_offsets[i] = nearest[i].second;
+        distances[i] = is_ip_ ? -nearest[i].first : nearest[i].first;
+    }
+    return found;
+}
+
+int64_t
+GrowingGraphIndex::memory_usage() const {
+    std::shared_lock lck(mutex_);
+    int64_t bytes = levels_.size() + level0_.size() * sizeof(int32_t) +
+                    upper_.size() * sizeof(upper_[0]);
+    for (auto& list : upper_) {
+        bytes += list.size() * sizeof(int32_t);
+    }
+    return bytes;
+}
+
+}  // namespace milvus::segcore
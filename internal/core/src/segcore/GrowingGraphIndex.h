@@ -0,0 +1,146 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "common/BitsetView.h"
+#include "common/Types.h"
+#include "segcore/ConcurrentVector.h"
+
+namespace milvus::segcore {
+
+struct GraphIndexConf {
+    // neighbors per node on the upper layers, twice as many on layer 0
+    int64_t m = 16;
+    int64_t ef_construction = 100;
+    int64_t ef_search = 64;
+    // acked rows left to brute force before the graph is extended
+    int64_t build_lag = 4096;
+};
+
+// HNSW graph over the rows of a growing float vector field. Unlike the
+// knowhere indexes it grows in place: Extend links newly acked rows into
+// the existing graph, so one graph serves the whole segment. The graph
+// keeps row offsets only and reads the vectors from the insert record.
+//
+// Extensions are serialized and link rows in batches under an exclusive
+// lock; searches share the lock and see the rows of the finished batches.
+class GrowingGraphIndex {
+ public:
+    GrowingGraphIndex(int64_t dim,
+                      const MetricType& metric_type,
+                      const GraphIndexConf& conf);
+
+    GrowingGraphIndex(const GrowingGraphIndex&) = delete;
+    GrowingGraphIndex&
+    operator=(const GrowingGraphIndex&) = delete;
+
+    // rows [0, size()) are in the graph
+    int64_t
+    size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // links rows [size(), end) of source, which must be acked and must
+    // outlive the index
+    void
+    Extend(const ConcurrentVector<FloatVector>& source, int64_t end);
+
+    // the nearest rows of [0, limit) not set in bitset, best first with
+    // distances as knowhere reports them; returns how many were found
+    int64_t
+    Search(const float* query,
+           int64_t topk,
+           int64_t ef,
+           int64_t limit,
+           const BitsetView& bitset,
+           int64_t* seg_offsets,
+           float* distances) const;
+
+    int64_t
+    memory_usage() const;
+
+ private:
+    using Neighbor = std::pair<float, int32_t>;
+
+    // smaller is nearer, the negated inner product for IP
+    float
+    distance(const float* x, const float* y) const;
+
+    const float*
+    vector_of(int32_t node) const {
+        return source_->get_element(node);
+    }
+
+    // neighbor list of node on level, its length first
+    int32_t*
+    links(int32_t node, int level);
+
+    const int32_t*
+    links(int32_t node, int level) const;
+
+    int32_t
+    greedy_descent(const float* query, int down_to) const;
+
+    // the ef nearest nodes reachable from entry on level, unordered
+    template <typename Filter>
+    std::vector<Neighbor>
+    search_level(const float* query,
+                 int32_t entry,
+                 int64_t ef,
+                 int level,
+                 int64_t num_nodes,
+                 Filter&& allowed) const;
+
+    // HNSW heuristic: keeps a candidate only if it is nearer to the base
+    // than to every neighbor kept before it
+    void
+    select_neighbors(std::vector<Neighbor>& candidates,
+                     int64_t max_neighbors) const;
+
+    void
+    link(int32_t node, int level, std::vector<Neighbor>& candidates);
+
+    void
+    insert(int32_t node);
+
+ private:
+    const int64_t dim_;
+    const bool is_ip_;
+    const int64_t m_;
+    const int64_t m0_;
+    const int64_t ef_construction_;
+    const double level_mult_;
+
+    mutable std::shared_mutex mutex_;
+    std::mutex extend_mutex_;
+    std::atomic<int64_t> size_ = 0;
+    const ConcurrentVector<FloatVector>* source_ = nullptr;
+    std::mt19937_64 level_generator_;
+
+    int32_t entry_ = -1;
+    int max_level_ = -1;
+    std::vector<int8_t> levels_;
+    // m0_ + 1 slots per node
+    std::vector<int32_t> level0_;
+    // m_ + 1 slots per upper level of the node
+    std::vector<std::vector<int32_t>> upper_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,89 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/IndexLoader.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+
+#include "storage/DataCodec.h"
+
+namespace milvus::segcore {
+
+static MemoryReservation
+ReserveFetchBytes(int64_t bytes) {
+    auto& budget = IndexFetchBudget();
+    while (true) {
+        auto capacity = budget.Capacity();
+        auto reserved = capacity > 0 ? std::min(bytes, capacity) : bytes;
+        if (budget.Reserve(reserved, std::chrono::seconds(1))) {
+            return MemoryReservation(&budget, reserved);
+        }
+    }
+}
+
+FetchedIndex
+FetchIndexFiles(storage::RemoteChunkManager& remote_chunk_manager,
+                const std::vector<std::string>& remote_files) {
+    std::vector<std::future<uint64_t>> sizes;
+    for (auto& file : remote_files) {
+        sizes.push_back(remote_chunk_manager.SizeAsync(file));
+    }
+    int64_t total_bytes = 0;
+    std::vector<uint64_t> file_bytes;
+    for (auto& size : sizes) {
+        file_bytes.push_back(size.get());
+        total_bytes += file_bytes.back();
+    }
+
+    FetchedIndex fetched;
+    fetched.reservation = ReserveFetchBytes(total_bytes);
+    std::vector<std::unique_ptr<uint8_t[]>> bufs;
+    std::vector<std::future<uint64_t>> reads;
+    for (size_t i = 0; i < remote_files.size(); ++i) {
+        bufs.emplace_back(new uint8_t[file_bytes[i]]);
+        reads.push_back(remote_chunk_manager.ReadAsync(
+            remote_files[i], 0, bufs.back().get(), file_bytes[i]));
+    }
+
+    std::exception_ptr error;
+    for (size_t i = 0; i < remote_files.size(); ++i) {
+        try {
+            auto read_size = reads[i].get();
+            if (error) {
+                continue;
+            }
+            std::shared_ptr<storage::DataCodec> codec =
+                storage::DeserializeFileData(bufs[i].get(), read_size);
+            bufs[i].reset();
+            // the binary points into the decoded payload, which it keeps
+            auto payload = codec->GetPayload();
+            auto data = std::shared_ptr<uint8_t[]>(
+                const_cast<uint8_t*>(payload->raw_data),
+                [codec](uint8_t*) {});
+            auto& file = remote_files[i];
+            auto name = file.substr(file.find_last_of('/') + 1);
+            fetched.binary_set.Append(name, data, payload->rows);
+        } catch (...) {
+            // the reads still in flight write into bufs, so wait them out
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return fetched;
+}
+
+}  // namespace milvus::segcore
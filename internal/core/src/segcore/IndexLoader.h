@@ -0,0 +1,37 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/MemoryBudget.h"
+#include "common/Types.h"
+#include "storage/ChunkManager.h"
+
+namespace milvus::segcore {
+
+// the files of an index as downloaded for its load, their bytes held
+// against IndexFetchBudget until this goes away
+struct FetchedIndex {
+    BinarySet binary_set;
+    MemoryReservation reservation;
+};
+
+// downloads remote_files all at once, each decoded into the binary named
+// by its file name. waits until their bytes fit IndexFetchBudget, an
+// index larger than the whole budget until nothing else is in flight
+FetchedIndex
+FetchIndexFiles(storage::RemoteChunkManager& remote_chunk_manager,
+                const std::vector<std::string>& remote_files);
+
+}  // namespace milvus::segcore
@@ -12,18 +12,26 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "BloomFilter.h"
 #include "TimestampIndex.h"
+#include "common/MemoryUsage.h"
 #include "common/Schema.h"
 #include "easylogging++.h"
+#include "index/ParallelSort.h"
 #include "segcore/AckResponder.h"
 #include "segcore/ConcurrentVector.h"
 #include "segcore/Record.h"
+#include "segcore/SegcoreConfig.h"
 
 namespace milvus::segcore {
 
@@ -34,29 +42,184 @@ class OffsetMap {
     virtual std::vector<int64_t>
     find(const PkType pk) const = 0;
 
+    // offsets of n distinct pks, appended to offsets; those of
+    // pks[i] are offsets[bounds[i], bounds[i + 1]), bounds gets n + 1 items
+    virtual void
+    find_batch(const PkType* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const = 0;
+
+    // the same for a typed column of pks
+    virtual void
+    find_batch(const int64_t* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const = 0;
+
+    virtual void
+    find_batch(const std::string_view* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const = 0;
+
+    // the same with the PkFingerprint of each pk, not computed again
+    virtual void
+    find_batch(const std::string_view* pks,
+               const uint64_t* fingerprints,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const = 0;
+
+    // false only if pk is certainly absent
+    virtual bool
+    may_contain(const PkType& pk) const = 0;
+
+    virtual bool
+    may_contain(int64_t pk) const = 0;
+
+    virtual bool
+    may_contain(std::string_view pk) const = 0;
+
     virtual void
     insert(const PkType pk, int64_t offset) = 0;
 
+    // pks[i] at begin_offset + i
+    virtual void
+    insert_batch(const PkType* pks, int64_t n, int64_t begin_offset) = 0;
+
+    // the same from a typed column, with no PkType built per row
+    virtual void
+    insert_batch(const int64_t* pks, int64_t n, int64_t begin_offset) = 0;
+
+    virtual void
+    insert_batch(const std::string_view* pks,
+                 int64_t n,
+                 int64_t begin_offset) = 0;
+
     virtual void
     seal() = 0;
 
     virtual bool
     empty() const = 0;
+
+    // bytes held, the pks included
+    virtual int64_t
+    memory_usage() const = 0;
+
+    // calls fn with the offsets in ascending pk order until it returns
+    // false, returns false without calling fn if the map keeps no order
+    virtual bool
+    for_each_ordered(const std::function<bool(int64_t)>& fn) const {
+        return false;
+    }
 };
 
+// Growing pk index: open addressing with linear probing over one flat
+// slot array. A slot holds its pk and first offset inline; the further
+// offsets of a duplicated pk are chained through overflow_, so inserting
+// allocates only when the table grows or a pk repeats. A string pk keeps
+// its fingerprint in the slot, compared before the string and reused when
+// the table grows.
 template <typename T>
 class OffsetHashMap : public OffsetMap {
+    static constexpr bool is_string = std::is_same_v<T, std::string>;
+
  public:
     std::vector<int64_t>
     find(const PkType pk) const {
-        auto offset_vector = map_.find(std::get<T>(pk));
-        return offset_vector != map_.end() ? offset_vector->second
-                                           : std::vector<int64_t>();
+        std::vector<int64_t> offset_vector;
+        append_offsets(std::get<T>(pk), offset_vector);
+        return offset_vector;
+    }
+
+    void
+    find_batch(const PkType* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        bounds.resize(n + 1);
+        bounds[0] = offsets.size();
+        for (int64_t i = 0; i < n; ++i) {
+            append_offsets(std::get<T>(pks[i]), offsets);
+            bounds[i + 1] = offsets.size();
+        }
+    }
+
+    void
+    find_batch(const int64_t* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        find_typed(pks, n, offsets, bounds);
+    }
+
+    void
+    find_batch(const std::string_view* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        find_typed(pks, n, offsets, bounds);
+    }
+
+    void
+    find_batch(const std::string_view* pks,
+               const uint64_t* fingerprints,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        if constexpr (is_string) {
+            bounds.resize(n + 1);
+            bounds[0] = offsets.size();
+            for (int64_t i = 0; i < n; ++i) {
+                append_offsets(pks[i], fingerprints[i], offsets);
+                bounds[i + 1] = offsets.size();
+            }
+        } else {
+            PanicInfo("pk column type mismatches the pk index");
+        }
+    }
+
+    bool
+    may_contain(const PkType& pk) const {
+        return find_slot(std::get<T>(pk)) != nullptr;
+    }
+
+    bool
+    may_contain(int64_t pk) const {
+        return may_contain_typed(pk);
+    }
+
+    bool
+    may_contain(std::string_view pk) const {
+        return may_contain_typed(pk);
     }
 
     void
     insert(const PkType pk, int64_t offset) {
-        map_[std::get<T>(pk)].emplace_back(offset);
+        reserve(num_keys_ + 1);
+        insert_impl(std::get<T>(pk), offset);
+    }
+
+    void
+    insert_batch(const PkType* pks, int64_t n, int64_t begin_offset) {
+        // grow at most once for the whole batch
+        reserve(num_keys_ + n);
+        for (int64_t i = 0; i < n; ++i) {
+            insert_impl(std::get<T>(pks[i]), begin_offset + i);
+        }
+    }
+
+    void
+    insert_batch(const int64_t* pks, int64_t n, int64_t begin_offset) {
+        insert_typed(pks, n, begin_offset);
+    }
+
+    void
+    insert_batch(const std::string_view* pks,
+                 int64_t n,
+                 int64_t begin_offset) {
+        insert_typed(pks, n, begin_offset);
     }
 
     void
@@ -67,39 +230,340 @@ class OffsetHashMap : public OffsetMap {
 
     bool
     empty() const {
-        return map_.empty();
+        return num_keys_ == 0;
+    }
+
+    int64_t
+    memory_usage() const {
+        return slots_.capacity() * sizeof(Slot) +
+               overflow_.capacity() * sizeof(Overflow) + key_heap_bytes_;
     }
 
  private:
-    std::unordered_map<T, std::vector<int64_t>> map_;
+    static constexpr int64_t empty_slot = -1;
+
+    struct PlainSlot {
+        T key;
+        // empty_slot if the slot is free
+        int64_t offset = empty_slot;
+        // head of the chain of further offsets in overflow_, -1 if none
+        int64_t next = -1;
+    };
+
+    struct StringSlot : PlainSlot {
+        uint64_t fingerprint = 0;
+    };
+
+    using Slot = std::conditional_t<is_string, StringSlot, PlainSlot>;
+
+    struct Overflow {
+        int64_t offset;
+        int64_t next;
+    };
+
+    // whether a pk column of type Source can index this map
+    template <typename Source>
+    static constexpr bool accepts = std::is_constructible_v<T, const Source&>;
+
+    template <typename Source>
+    void
+    find_typed(const Source* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        if constexpr (accepts<Source>) {
+            bounds.resize(n + 1);
+            bounds[0] = offsets.size();
+            for (int64_t i = 0; i < n; ++i) {
+                append_offsets(pks[i], offsets);
+                bounds[i + 1] = offsets.size();
+            }
+        } else {
+            PanicInfo("pk column type mismatches the pk index");
+        }
+    }
+
+    template <typename Source>
+    bool
+    may_contain_typed(const Source& pk) const {
+        if constexpr (accepts<Source>) {
+            return find_slot(pk) != nullptr;
+        } else {
+            PanicInfo("pk type mismatches the pk index");
+        }
+    }
+
+    template <typename Key>
+    static bool
+    matches(const Slot& slot, const Key& key, uint64_t hash) {
+        if constexpr (is_string) {
+            return slot.fingerprint == hash && slot.key == key;
+        } else {
+            return slot.key == key;
+        }
+    }
+
+    static uint64_t
+    hash_of(const Slot& slot) {
+        if constexpr (is_string) {
+            return slot.fingerprint;
+        } else {
+            return BlockedBloomFilter::hash(slot.key);
+        }
+    }
+
+    // key is a T or a view of one, hash its fingerprint
+    template <typename Key>
+    const Slot*
+    find_slot(const Key& key, uint64_t hash) const {
+        if (slots_.empty()) {
+            return nullptr;
+        }
+        auto mask = slots_.size() - 1;
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            auto& slot = slots_[i];
+            if (slot.offset == empty_slot) {
+                return nullptr;
+            }
+            if (matches(slot, key, hash)) {
+                return &slot;
+            }
+        }
+    }
+
+    template <typename Key>
+    const Slot*
+    find_slot(const Key& key) const {
+        return find_slot(key, BlockedBloomFilter::hash(key));
+    }
+
+    template <typename Key>
+    void
+    append_offsets(const Key& key, std::vector<int64_t>& offsets) const {
+        append_offsets(key, BlockedBloomFilter::hash(key), offsets);
+    }
+
+    template <typename Key>
+    void
+    append_offsets(const Key& key,
+                   uint64_t hash,
+                   std::vector<int64_t>& offsets) const {
+        auto slot = find_slot(key, hash);
+        if (slot == nullptr) {
+            return;
+        }
+        offsets.push_back(slot->offset);
+        for (auto i = slot->next; i != -1; i = overflow_[i].next) {
+            offsets.push_back(overflow_[i].offset);
+        }
+    }
+
+    // the table is kept at most 3/4 full
+    void
+    reserve(int64_t num_keys) {
+        if (4 * num_keys <= 3 * int64_t(slots_.size())) {
+            return;
+        }
+        size_t capacity = std::max<size_t>(slots_.size(), 16);
+        while (4 * num_keys > 3 * int64_t(capacity)) {
+            capacity *= 2;
+        }
+        auto old_slots = std::exchange(slots_, std::vector<Slot>(capacity));
+        auto mask = capacity - 1;
+        for (auto& old_slot : old_slots) {
+            if (old_slot.offset == empty_slot) {
+                continue;
+            }
+            auto i = hash_of(old_slot) & mask;
+            while (slots_[i].offset != empty_slot) {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = std::move(old_slot);
+        }
+    }
+
+    template <typename Source>
+    void
+    insert_typed(const Source* pks, int64_t n, int64_t begin_offset) {
+        if constexpr (accepts<Source>) {
+            reserve(num_keys_ + n);
+            for (int64_t i = 0; i < n; ++i) {
+                insert_impl(pks[i], begin_offset + i);
+            }
+        } else {
+            PanicInfo("pk column type mismatches the pk index");
+        }
+    }
+
+    // key is a T or a view of one, copied only when it is new
+    template <typename Key>
+    void
+    insert_impl(const Key& key, int64_t offset) {
+        auto mask = slots_.size() - 1;
+        auto hash = BlockedBloomFilter::hash(key);
+        auto i = hash & mask;
+        while (slots_[i].offset != empty_slot) {
+            auto& slot = slots_[i];
+            if (matches(slot, key, hash)) {
+                overflow_.push_back({offset, slot.next});
+                slot.next = overflow_.size() - 1;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        slots_[i].key = T(key);
+        slots_[i].offset = offset;
+        if constexpr (is_string) {
+            slots_[i].fingerprint = hash;
+        }
+        key_heap_bytes_ += HeapBytes(slots_[i].key);
+        ++num_keys_;
+    }
+
+ private:
+    // power of two sized
+    std::vector<Slot> slots_;
+    std::vector<Overflow> overflow_;
+    int64_t num_keys_ = 0;
+    // what the string keys own
+    int64_t key_heap_bytes_ = 0;
 };
 
+// int64 values kept as int32 whenever all of them fit
+class CompactOffsets {
+ public:
+    void
+    assign(const std::vector<int64_t>& values) {
+        narrow_ = std::all_of(values.begin(), values.end(), [](int64_t v) {
+            return v >= std::numeric_limits<int32_t>::min() &&
+                   v <= std::numeric_limits<int32_t>::max();
+        });
+        if (narrow_) {
+            values32_.assign(values.begin(), values.end());
+            values64_.clear();
+        } else {
+            values64_ = values;
+            values32_.clear();
+        }
+    }
+
+    int64_t
+    operator[](size_t i) const {
+        return narrow_ ? values32_[i] : values64_[i];
+    }
+
+    int64_t
+    memory_usage() const {
+        return values32_.capacity() * sizeof(int32_t) +
+               values64_.capacity() * sizeof(int64_t);
+    }
+
+ private:
+    bool narrow_ = true;
+    std::vector<int32_t> values32_;
+    std::vector<int64_t> values64_;
+};
+
+// Sealed pk index. seal() turns the inserted (pk, offset) pairs into
+// split arrays in Eytzinger order, the implicit binary tree whose node k
+// has children 2k and 2k + 1, so that the first levels of every search
+// share a few cache lines and the next levels can be prefetched.
+// String pks live in one arena and are compared by a big-endian 8 byte
+// prefix first, touching the arena only on equal prefixes. Offsets are
+// stored inline per key while pks are unique, and as int32 when the
+// segment allows.
 template <typename T>
 class OffsetOrderedArray : public OffsetMap {
+    static constexpr bool is_string = std::is_same_v<T, std::string>;
+    using KeyType = std::conditional_t<is_string, uint64_t, T>;
+    // what a pk is searched by
+    using KeyView = std::conditional_t<is_string, std::string_view, T>;
+
  public:
     std::vector<int64_t>
     find(const PkType pk) const {
-        int left = 0, right = array_.size() - 1;
         T target = std::get<T>(pk);
         if (!is_sealed)
             PanicInfo("OffsetOrderedArray could not search before seal");
+        if (!filter_.may_contain(BlockedBloomFilter::hash(target))) {
+            return {};
+        }
+        std::vector<int64_t> offset_vector;
+        append_offsets(target, offset_vector);
+        return offset_vector;
+    }
 
-        while (left < right) {
-            int mid = (left + right) >> 1;
-            if (array_[mid].first < target)
-                left = mid + 1;
-            else
-                right = mid;
+    void
+    find_batch(const PkType* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        if (!is_sealed)
+            PanicInfo("OffsetOrderedArray could not search before seal");
+        bounds.resize(n + 1);
+        bounds[0] = offsets.size();
+        for (int64_t i = 0; i < n; ++i) {
+            const auto& target = std::get<T>(pks[i]);
+            if (filter_.may_contain(BlockedBloomFilter::hash(target))) {
+                append_offsets(target, offsets);
+            }
+            bounds[i + 1] = offsets.size();
         }
+    }
 
-        std::vector<int64_t> offset_vector;
-        for (int offset_id = right; offset_id < array_.size(); offset_id++) {
-            if (offset_id < 0 || array_[offset_id].first != target)
-                break;
-            offset_vector.push_back(array_[offset_id].second);
+    void
+    find_batch(const int64_t* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        find_typed(pks, n, offsets, bounds);
+    }
+
+    void
+    find_batch(const std::string_view* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        find_typed(pks, n, offsets, bounds);
+    }
+
+    // the fingerprints probe the filter
+    void
+    find_batch(const std::string_view* pks,
+               const uint64_t* fingerprints,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        if constexpr (is_string) {
+            if (!is_sealed)
+                PanicInfo("OffsetOrderedArray could not search before seal");
+            bounds.resize(n + 1);
+            bounds[0] = offsets.size();
+            for (int64_t i = 0; i < n; ++i) {
+                if (filter_.may_contain(fingerprints[i])) {
+                    append_offsets(pks[i], offsets);
+                }
+                bounds[i + 1] = offsets.size();
+            }
+        } else {
+            PanicInfo("pk column type mismatches the pk index");
         }
+    }
 
-        return offset_vector;
+    bool
+    may_contain(const PkType& pk) const {
+        return !is_sealed ||
+               filter_.may_contain(BlockedBloomFilter::hash(std::get<T>(pk)));
+    }
+
+    bool
+    may_contain(int64_t pk) const {
+        return may_contain_typed(pk);
+    }
+
+    bool
+    may_contain(std::string_view pk) const {
+        return may_contain_typed(pk);
     }
 
     void
@@ -107,26 +571,315 @@ class OffsetOrderedArray : public OffsetMap {
         if (is_sealed)
             PanicInfo("OffsetOrderedArray could not insert after seal");
         array_.push_back(std::make_pair(std::get<T>(pk), offset));
+        array_heap_bytes_ += HeapBytes(array_.back().first);
+    }
+
+    void
+    insert_batch(const PkType* pks, int64_t n, int64_t begin_offset) {
+        if (is_sealed)
+            PanicInfo("OffsetOrderedArray could not insert after seal");
+        array_.reserve(array_.size() + n);
+        for (int64_t i = 0; i < n; ++i) {
+            array_.emplace_back(std::get<T>(pks[i]), begin_offset + i);
+            array_heap_bytes_ += HeapBytes(array_.back().first);
+        }
+    }
+
+    void
+    insert_batch(const int64_t* pks, int64_t n, int64_t begin_offset) {
+        insert_typed(pks, n, begin_offset);
+    }
+
+    void
+    insert_batch(const std::string_view* pks,
+                 int64_t n,
+                 int64_t begin_offset) {
+        insert_typed(pks, n, begin_offset);
     }
 
     void
     seal() {
-        sort(array_.begin(), array_.end());
+        if (array_.size() < index::PARALLEL_SORT_MIN_SIZE) {
+            std::sort(array_.begin(), array_.end());
+        } else {
+            tbb::parallel_sort(array_.begin(), array_.end());
+        }
+        // distinct pks in order, and where each one's offsets begin
+        std::vector<size_t> groups;
+        for (size_t i = 0; i < array_.size(); ++i) {
+            if (i == 0 || array_[i].first != array_[i - 1].first) {
+                groups.push_back(i);
+            }
+        }
+        num_keys_ = groups.size();
+        unique_ = num_keys_ == array_.size();
+        groups.push_back(array_.size());
+
+        // an in-order walk of the implicit tree visits the slots in key
+        // order
+        std::vector<size_t> slot_rank(num_keys_ + 1);
+        size_t rank = 0;
+        std::function<void(size_t)> walk = [&](size_t k) {
+            if (k > num_keys_) {
+                return;
+            }
+            walk(2 * k);
+            slot_rank[k] = rank++;
+            walk(2 * k + 1);
+        };
+        walk(1);
+
+        filter_ = BlockedBloomFilter(num_keys_);
+        keys_.assign(num_keys_ + 1, KeyType());
+        std::vector<int64_t> values(num_keys_ + 2, 0);
+        std::vector<int64_t> offsets;
+        std::vector<int64_t> str_begins(num_keys_ + 2, 0);
+        if constexpr (is_string) {
+            size_t total = 0;
+            for (size_t r = 0; r < num_keys_; ++r) {
+                total += array_[groups[r]].first.size();
+            }
+            arena_.reserve(total);
+        }
+        for (size_t k = 1; k <= num_keys_; ++k) {
+            auto begin = groups[slot_rank[k]];
+            auto end = groups[slot_rank[k] + 1];
+            const auto& pk = array_[begin].first;
+            filter_.add(BlockedBloomFilter::hash(pk));
+            if constexpr (is_string) {
+                keys_[k] = prefix_of(pk);
+                str_begins[k] = arena_.size();
+                arena_.insert(arena_.end(), pk.begin(), pk.end());
+            } else {
+                keys_[k] = pk;
+            }
+            if (unique_) {
+                values[k] = array_[begin].second;
+            } else {
+                // groups in slot order, slot k spans values[k, k + 1)
+                values[k] = offsets.size();
+                for (auto i = begin; i < end; ++i) {
+                    offsets.push_back(array_[i].second);
+                }
+            }
+        }
+        if constexpr (is_string) {
+            str_begins[num_keys_ + 1] = arena_.size();
+            str_begins_.assign(str_begins);
+        }
+        if (!unique_) {
+            values[num_keys_ + 1] = offsets.size();
+        }
+        values_.assign(values);
+        offsets_.assign(offsets);
+
+        array_ = {};
+        array_heap_bytes_ = 0;
         is_sealed = true;
     }
 
     bool
     empty() const {
-        return array_.empty();
+        return is_sealed ? num_keys_ == 0 : array_.empty();
+    }
+
+    int64_t
+    memory_usage() const {
+        return array_.capacity() * sizeof(std::pair<T, int64_t>) +
+               array_heap_bytes_ + filter_.memory_usage() +
+               keys_.capacity() * sizeof(KeyType) + values_.memory_usage() +
+               offsets_.memory_usage() + arena_.capacity() +
+               str_begins_.memory_usage();
+    }
+
+    bool
+    for_each_ordered(const std::function<bool(int64_t)>& fn) const {
+        if (!is_sealed) {
+            return false;
+        }
+        // in-order walk of the implicit tree, starting at its leftmost slot
+        size_t k = 1;
+        while (2 * k <= num_keys_) {
+            k = 2 * k;
+        }
+        while (k != 0 && num_keys_ != 0) {
+            if (unique_) {
+                if (!fn(values_[k])) {
+                    return true;
+                }
+            } else {
+                for (auto i = values_[k]; i < values_[k + 1]; ++i) {
+                    if (!fn(offsets_[i])) {
+                        return true;
+                    }
+                }
+            }
+            if (2 * k + 1 <= num_keys_) {
+                k = 2 * k + 1;
+                while (2 * k <= num_keys_) {
+                    k = 2 * k;
+                }
+            } else {
+                // up past the right turns, then once more past a left one
+                while (k & 1) {
+                    k >>= 1;
+                }
+                k >>= 1;
+            }
+        }
+        return true;
+    }
+
+ private:
+    // whether a pk column of type Source can index this array
+    template <typename Source>
+    static constexpr bool accepts = std::is_same_v<KeyView, Source>;
+
+    template <typename Source>
+    void
+    find_typed(const Source* pks,
+               int64_t n,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        if constexpr (accepts<Source>) {
+            if (!is_sealed)
+                PanicInfo("OffsetOrderedArray could not search before seal");
+            bounds.resize(n + 1);
+            bounds[0] = offsets.size();
+            for (int64_t i = 0; i < n; ++i) {
+                if (filter_.may_contain(BlockedBloomFilter::hash(pks[i]))) {
+                    append_offsets(pks[i], offsets);
+                }
+                bounds[i + 1] = offsets.size();
+            }
+        } else {
+            PanicInfo("pk column type mismatches the pk index");
+        }
+    }
+
+    template <typename Source>
+    bool
+    may_contain_typed(const Source& pk) const {
+        if constexpr (accepts<Source>) {
+            return !is_sealed ||
+                   filter_.may_contain(BlockedBloomFilter::hash(pk));
+        } else {
+            PanicInfo("pk type mismatches the pk index");
+        }
+    }
+
+    template <typename Source>
+    void
+    insert_typed(const Source* pks, int64_t n, int64_t begin_offset) {
+        if constexpr (accepts<Source>) {
+            if (is_sealed)
+                PanicInfo("OffsetOrderedArray could not insert after seal");
+            array_.reserve(array_.size() + n);
+            for (int64_t i = 0; i < n; ++i) {
+                array_.emplace_back(T(pks[i]), begin_offset + i);
+                array_heap_bytes_ += HeapBytes(array_.back().first);
+            }
+        } else {
+            PanicInfo("pk column type mismatches the pk index");
+        }
+    }
+
+    // big-endian so that comparing prefixes as integers orders strings
+    static uint64_t
+    prefix_of(std::string_view str) {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+            prefix <<= 8;
+            if (i < str.size()) {
+                prefix |= static_cast<unsigned char>(str[i]);
+            }
+        }
+        return prefix;
+    }
+
+    std::string_view
+    key_string(size_t k) const {
+        auto begin = str_begins_[k];
+        return {arena_.data() + begin, size_t(str_begins_[k + 1] - begin)};
+    }
+
+    // slot of the first key not less than target, 0 if there is none
+    size_t
+    lower_bound(KeyView target) const {
+        KeyType probe;
+        if constexpr (is_string) {
+            probe = prefix_of(target);
+        } else {
+            probe = target;
+        }
+        size_t k = 1;
+        while (k <= num_keys_) {
+            // 16 slots down the tree, four levels ahead
+            if (16 * k <= num_keys_) {
+                __builtin_prefetch(keys_.data() + 16 * k);
+            }
+            bool less;
+            if constexpr (is_string) {
+                less = keys_[k] < probe ||
+                       (keys_[k] == probe && key_string(k) < target);
+            } else {
+                less = keys_[k] < probe;
+            }
+            k = 2 * k + less;
+        }
+        // undo the right turns taken after the last left turn
+        return k >> __builtin_ffsll(~k);
+    }
+
+    void
+    append_offsets(KeyView target, std::vector<int64_t>& offsets) const {
+        auto k = lower_bound(target);
+        if (k == 0) {
+            return;
+        }
+        if constexpr (is_string) {
+            if (key_string(k) != target) {
+                return;
+            }
+        } else {
+            if (keys_[k] != target) {
+                return;
+            }
+        }
+        if (unique_) {
+            offsets.push_back(values_[k]);
+            return;
+        }
+        // the groups are laid out in slot order
+        for (auto i = values_[k]; i < values_[k + 1]; ++i) {
+            offsets.push_back(offsets_[i]);
+        }
     }
 
  private:
     bool is_sealed = false;
     std::vector<std::pair<T, int64_t>> array_;
+    // what the string pks of array_ own
+    int64_t array_heap_bytes_ = 0;
+    // over the pks of array_, built by seal
+    BlockedBloomFilter filter_;
+
+    // built by seal, the slots are 1-based
+    size_t num_keys_ = 0;
+    bool unique_ = true;
+    std::vector<KeyType> keys_;
+    // the offset of each slot if unique_, else where its offsets begin
+    CompactOffsets values_;
+    CompactOffsets offsets_;
+    std::vector<char> arena_;
+    CompactOffsets str_begins_;
 };
 
 template <bool is_sealed = false>
 struct InsertRecord {
+    // memory of all the chunks below, declared first to outlive them
+    ChunkArena chunk_arena_;
+
     ConcurrentVector<Timestamp> timestamps_;
     ConcurrentVector<idx_t> row_ids_;
 
@@ -140,8 +893,13 @@ struct InsertRecord {
     // pks to row offset
     std::unique_ptr<OffsetMap> pk2offset_;
 
-    InsertRecord(const Schema& schema, int64_t size_per_chunk)
-        : row_ids_(size_per_chunk), timestamps_(size_per_chunk) {
+    // a vector_chunk_bytes above 0 sizes the chunks of the vector fields
+    // by bytes, see SegcoreConfig::set_vector_chunk_bytes
+    InsertRecord(const Schema& schema,
+                 int64_t size_per_chunk,
+                 int64_t vector_chunk_bytes = 0)
+        : row_ids_(size_per_chunk, &chunk_arena_),
+          timestamps_(size_per_chunk, &chunk_arena_) {
         std::optional<FieldId> pk_field_id = schema.get_primary_field_id();
 
         for (auto& field : schema) {
@@ -149,39 +907,24 @@ struct InsertRecord {
             auto& field_meta = field.second;
             if (pk2offset_ == nullptr && pk_field_id.has_value() &&
                 pk_field_id.value() == field_id) {
-                switch (field_meta.get_data_type()) {
-                    case DataType::INT64: {
-                        if (is_sealed)
-                            pk2offset_ =
-                                std::make_unique<OffsetOrderedArray<int64_t>>();
-                        else
-                            pk2offset_ =
-                                std::make_unique<OffsetHashMap<int64_t>>();
-                        break;
-                    }
-                    case DataType::VARCHAR: {
-                        if (is_sealed)
-                            pk2offset_ = std::make_unique<
-                                OffsetOrderedArray<std::string>>();
-                        else
-                            pk2offset_ =
-                                std::make_unique<OffsetHashMap<std::string>>();
-                        break;
-                    }
-                    default: {
-                        PanicInfo("unsupported pk type");
-                    }
-                }
+                pk2offset_ = create_pk_map(field_meta.get_data_type());
             }
             if (field_meta.is_vector()) {
+                auto vec_size_per_chunk = SegcoreConfig::FieldChunkRows(
+                    field_meta, size_per_chunk, vector_chunk_bytes);
                 if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
-                    this->append_field_data<FloatVector>(
-                        field_id, field_meta.get_dim(), size_per_chunk);
+                    fields_data_.emplace(
+                        field_id,
+                        std::make_unique<ConcurrentVector<FloatVector>>(
+                            field_meta.get_dim(),
+                            vec_size_per_chunk,
+                            &chunk_arena_,
+                            IsCosineField(field_meta)));
                     continue;
                 } else if (field_meta.get_data_type() ==
                            DataType::VECTOR_BINARY) {
                     this->append_field_data<BinaryVector>(
-                        field_id, field_meta.get_dim(), size_per_chunk);
+                        field_id, field_meta.get_dim(), vec_size_per_chunk);
                     continue;
                 } else {
                     PanicInfo("unsupported");
@@ -221,6 +964,11 @@ struct InsertRecord {
                                                          size_per_chunk);
                     break;
                 }
+                case DataType::VECTOR_SPARSE_FLOAT: {
+                    this->append_field_data<SparseFloatRow>(field_id,
+                                                            size_per_chunk);
+                    break;
+                }
                 default: {
                     PanicInfo("unsupported");
                 }
@@ -254,12 +1002,110 @@ struct InsertRecord {
         return res_offsets;
     }
 
+    // offsets below insert_barrier of ascending distinct pks, in the
+    // layout of OffsetMap::find_batch
+    void
+    search_pks(const std::vector<PkType>& pks,
+               int64_t insert_barrier,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        search_pks(pks.data(), pks.size(), insert_barrier, offsets, bounds);
+    }
+
+    // the same for a PkType, int64 or string_view column
+    template <typename Pk>
+    void
+    search_pks(const Pk* pks,
+               int64_t n,
+               int64_t insert_barrier,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        std::shared_lock lck(shared_mutex_);
+        offsets.clear();
+        pk2offset_->find_batch(pks, n, offsets, bounds);
+        keep_before(insert_barrier, offsets, bounds);
+    }
+
+    // the same for string pks with their fingerprints
+    void
+    search_pks(const std::string_view* pks,
+               const uint64_t* fingerprints,
+               int64_t n,
+               int64_t insert_barrier,
+               std::vector<int64_t>& offsets,
+               std::vector<int64_t>& bounds) const {
+        std::shared_lock lck(shared_mutex_);
+        offsets.clear();
+        pk2offset_->find_batch(pks, fingerprints, n, offsets, bounds);
+        keep_before(insert_barrier, offsets, bounds);
+    }
+
+    // drops the offsets from insert_barrier on, keeping the bounds
+    static void
+    keep_before(int64_t insert_barrier,
+                std::vector<int64_t>& offsets,
+                std::vector<int64_t>& bounds) {
+        int64_t kept = 0;
+        int64_t begin = 0;
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            auto end = bounds[i + 1];
+            bounds[i] = kept;
+            for (auto j = begin; j < end; ++j) {
+                if (offsets[j] < insert_barrier) {
+                    offsets[kept++] = offsets[j];
+                }
+            }
+            begin = end;
+        }
+        bounds.back() = kept;
+        offsets.resize(kept);
+    }
+
     void
     insert_pk(const PkType pk, int64_t offset) {
         std::lock_guard lck(shared_mutex_);
         pk2offset_->insert(pk, offset);
     }
 
+    // pks[i] at begin_offset + i, under one lock
+    void
+    insert_pks(const std::vector<PkType>& pks, int64_t begin_offset) {
+        std::lock_guard lck(shared_mutex_);
+        pk2offset_->insert_batch(pks.data(), pks.size(), begin_offset);
+    }
+
+    // the same from an int64 or string_view column
+    template <typename Pk>
+    void
+    insert_pks(const Pk* pks, int64_t n, int64_t begin_offset) {
+        std::lock_guard lck(shared_mutex_);
+        pk2offset_->insert_batch(pks, n, begin_offset);
+    }
+
+    bool
+    may_contain_pk(const PkType& pk) const {
+        std::shared_lock lck(shared_mutex_);
+        return pk2offset_->may_contain(pk);
+    }
+
+    // pks[i] may be present as keep[i], under one lock
+    template <typename Pk>
+    void
+    may_contain_pks(const Pk* pks, int64_t n, std::vector<bool>& keep) const {
+        std::shared_lock lck(shared_mutex_);
+        keep.resize(n);
+        for (int64_t i = 0; i < n; ++i) {
+            keep[i] = pk2offset_->may_contain(pks[i]);
+        }
+    }
+
+    // see OffsetMap::for_each_ordered
+    bool
+    for_each_ordered_pk(const std::function<bool(int64_t)>& fn) const {
+        std::shared_lock lck(shared_mutex_);
+        return pk2offset_->for_each_ordered(fn);
+    }
+
     bool
     empty_pks() const {
         std::shared_lock lck(shared_mutex_);
@@ -271,6 +1117,35 @@ struct InsertRecord {
         pk2offset_->seal();
     }
 
+    // an empty pk index of this record's kind, to build aside and
+    // publish with set_pks
+    static std::unique_ptr<OffsetMap>
+    create_pk_map(DataType pk_type) {
+        switch (pk_type) {
+            case DataType::INT64: {
+                if (is_sealed)
+                    return std::make_unique<OffsetOrderedArray<int64_t>>();
+                return std::make_unique<OffsetHashMap<int64_t>>();
+            }
+            case DataType::VARCHAR: {
+                if (is_sealed)
+                    return std::make_unique<OffsetOrderedArray<std::string>>();
+                return std::make_unique<OffsetHashMap<std::string>>();
+            }
+            default: {
+                PanicInfo("unsupported pk type");
+            }
+        }
+    }
+
+    // replaces the empty pk index with a built one
+    void
+    set_pks(std::unique_ptr<OffsetMap> pk2offset) {
+        std::lock_guard lck(shared_mutex_);
+        AssertInfo(pk2offset_->empty(), "already exists");
+        pk2offset_ = std::move(pk2offset);
+    }
+
     // get field data without knowing the type
     VectorBase*
     get_field_data_base(FieldId field_id) const {
@@ -306,8 +1181,9 @@ struct InsertRecord {
     void
     append_field_data(FieldId field_id, int64_t size_per_chunk) {
         static_assert(IsScalar<Type>);
-        fields_data_.emplace(
-            field_id, std::make_unique<ConcurrentVector<Type>>(size_per_chunk));
+        fields_data_.emplace(field_id,
+                             std::make_unique<ConcurrentVector<Type>>(
+                                 size_per_chunk, &chunk_arena_));
     }
 
     // append a column of vector type
@@ -317,7 +1193,7 @@ struct InsertRecord {
         static_assert(std::is_base_of_v<VectorTrait, VectorType>);
         fields_data_.emplace(field_id,
                              std::make_unique<ConcurrentVector<VectorType>>(
-                                 dim, size_per_chunk));
+                                 dim, size_per_chunk, &chunk_arena_));
     }
 
     void
@@ -325,6 +1201,41 @@ struct InsertRecord {
         fields_data_.erase(field_id);
     }
 
+    // moves the chunks of the fields, system ones included, holding only
+    // rows below row_count, all acknowledged, to files under dir; returns
+    // the bytes moved
+    int64_t
+    spill_chunks(int64_t row_count, const std::string& dir) {
+        auto chunk_end = row_count / timestamps_.get_size_per_chunk();
+        auto bytes = timestamps_.spill_chunks(chunk_end, dir) +
+                     row_ids_.spill_chunks(chunk_end, dir);
+        for (auto& [field_id, field_data] : fields_data_) {
+            bytes += field_data->spill_chunks(
+                row_count / field_data->get_size_per_chunk(), dir);
+        }
+        return bytes;
+    }
+
+    void
+    add_memory_usage(MemoryUsage& usage) const {
+        usage.Add("insert_record.timestamps", timestamps_.memory_usage());
+        usage.Add("insert_record.row_ids", row_ids_.memory_usage());
+        auto chunk_bytes = timestamps_.chunk_memory_usage() +
+                           row_ids_.chunk_memory_usage();
+        for (auto& [field_id, field_data] : fields_data_) {
+            usage.Add("insert_record.fields", field_data->memory_usage());
+            chunk_bytes += field_data->chunk_memory_usage();
+        }
+        // the chunks are allocated in rounded sizes
+        usage.Add("insert_record.chunk_slack",
+                  std::max<int64_t>(
+                      0, chunk_arena_.allocated_bytes() - chunk_bytes));
+        usage.Add("insert_record.timestamp_index",
+                  timestamp_index_.memory_usage());
+        std::shared_lock lck(shared_mutex_);
+        usage.Add("insert_record.pk_index", pk2offset_->memory_usage());
+    }
+
  private:
     //    std::vector<std::unique_ptr<VectorBase>> fields_data_;
     std::unordered_map<FieldId, std::unique_ptr<VectorBase>> fields_data_{};
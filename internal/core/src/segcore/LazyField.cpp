@@ -0,0 +1,312 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "LazyField.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "common/Consts.h"
+#include "exceptions/EasyAssert.h"
+#include "parquet/arrow/reader.h"
+#include "segcore/Utils.h"
+#include "storage/DataCodec.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+int64_t
+ArrayBytes(const arrow::Array& array) {
+    int64_t bytes = 0;
+    for (auto& buffer : array.data()->buffers) {
+        if (buffer != nullptr) {
+            bytes += buffer->size();
+        }
+    }
+    return bytes;
+}
+
+}  // namespace
+
+LazyField::LazyField(const FieldMeta& field_meta,
+                     const std::vector<std::string>& binlog_paths,
+                     std::shared_ptr<storage::ChunkManager> chunk_manager,
+                     int64_t cache_bytes)
+    : field_meta_(field_meta),
+      chunk_manager_(std::move(chunk_manager)),
+      cache_bytes_(cache_bytes) {
+    for (auto& path : binlog_paths) {
+        DataType data_type;
+        auto input =
+            storage::OpenRemotePayload(chunk_manager_.get(), path, data_type);
+        AssertInfo(data_type == field_meta_.get_data_type(),
+                   fmt::format("binlog {} has data type {}, expected {}",
+                               path,
+                               datatype_name(data_type),
+                               datatype_name(field_meta_.get_data_type())));
+        // only the footer is read here
+        parquet::arrow::FileReaderBuilder builder;
+        auto st = builder.Open(input);
+        AssertInfo(st.ok(),
+                   "failed to open the payload of " + path + ": " +
+                       st.ToString());
+        auto metadata = builder.raw_reader()->metadata();
+        int32_t binlog = binlogs_.size();
+        for (int i = 0; i < metadata->num_row_groups(); ++i) {
+            row_groups_.push_back({binlog, i, row_count_});
+            row_count_ += metadata->RowGroup(i)->num_rows();
+        }
+        binlogs_.push_back(
+            {path, input->offset(), input->GetSize().ValueOrDie(), metadata});
+    }
+}
+
+int64_t
+LazyField::find_row_group(int64_t row) const {
+    auto it = std::upper_bound(row_groups_.begin(),
+                               row_groups_.end(),
+                               row,
+                               [](int64_t row, const RowGroup& group) {
+                                   return row < group.row_begin;
+                               });
+    return it - row_groups_.begin() - 1;
+}
+
+std::shared_ptr<arrow::Array>
+LazyField::read_row_group(int64_t group) const {
+    auto& row_group = row_groups_[group];
+    auto& binlog = binlogs_[row_group.binlog];
+    auto input = std::make_shared<storage::RemotePayloadInputStream>(
+        chunk_manager_.get(),
+        binlog.path,
+        binlog.payload_offset,
+        binlog.payload_size);
+    // the footer read at load is reused, the column chunk of the row
+    // group is the one ranged read
+    parquet::arrow::FileReaderBuilder builder;
+    auto st = builder.Open(
+        input, parquet::default_reader_properties(), binlog.metadata);
+    AssertInfo(st.ok(),
+               "failed to open the payload of " + binlog.path + ": " +
+                   st.ToString());
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    st = builder.memory_pool(arrow::default_memory_pool())->Build(&reader);
+    AssertInfo(st.ok(), "failed to get arrow file reader");
+    std::shared_ptr<arrow::Table> table;
+    st = reader->ReadRowGroup(row_group.index, {0}, &table);
+    AssertInfo(st.ok(),
+               fmt::format("failed to read row group {} of {}: {}",
+                           row_group.index,
+                           binlog.path,
+                           st.ToString()));
+    auto column = table->column(0);
+    if (column->num_chunks() == 1) {
+        return column->chunk(0);
+    }
+    auto array = arrow::Concatenate(column->chunks());
+    AssertInfo(array.ok(), "failed to concatenate the row group");
+    return array.ValueOrDie();
+}
+
+std::shared_ptr<arrow::Array>
+LazyField::get_row_group(int64_t group) const {
+    {
+        std::lock_guard lck(cache_mutex_);
+        if (auto it = cache_.find(group); it != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            return it->second.array;
+        }
+    }
+    // racing readers of a row group both read it, one is cached
+    auto array = read_row_group(group);
+    std::lock_guard lck(cache_mutex_);
+    if (cache_.count(group) > 0) {
+        return array;
+    }
+    auto bytes = ArrayBytes(*array);
+    lru_.push_front(group);
+    cache_.emplace(group, CacheEntry{array, bytes, lru_.begin()});
+    cached_bytes_ += bytes;
+    while (cached_bytes_ > cache_bytes_ && lru_.size() > 1) {
+        auto it = cache_.find(lru_.back());
+        cached_bytes_ -= it->second.bytes;
+        cache_.erase(it);
+        lru_.pop_back();
+    }
+    return array;
+}
+
+template <typename Visit>
+void
+LazyField::for_each_row(const int64_t* seg_offsets,
+                        int64_t count,
+                        const Visit& visit) const {
+    std::vector<int64_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    if (!std::is_sorted(seg_offsets, seg_offsets + count)) {
+        std::sort(order.begin(), order.end(), [=](auto x, auto y) {
+            return seg_offsets[x] < seg_offsets[y];
+        });
+    }
+    int64_t group = -1;
+    std::shared_ptr<arrow::Array> array;
+    for (auto i : order) {
+        auto offset = seg_offsets[i];
+        if (offset == INVALID_SEG_OFFSET) {
+            continue;
+        }
+        AssertInfo(offset >= 0 && offset < row_count_,
+                   fmt::format("row {} out of the {} rows of the field",
+                               offset,
+                               row_count_));
+        if (group < 0 || offset < row_groups_[group].row_begin ||
+            (group + 1 < int64_t(row_groups_.size()) &&
+             offset >= row_groups_[group + 1].row_begin)) {
+            group = find_row_group(offset);
+            array = get_row_group(group);
+        }
+        visit(i, *array, offset - row_groups_[group].row_begin);
+    }
+}
+
+template <typename ArrowType, typename T>
+void
+LazyField::gather(const int64_t* seg_offsets,
+                  int64_t count,
+                  T* output) const {
+    using Array = arrow::NumericArray<ArrowType>;
+    std::fill_n(output, count, T());
+    for_each_row(seg_offsets,
+                 count,
+                 [&](int64_t i, const arrow::Array& array, int64_t row) {
+                     output[i] = static_cast<const Array&>(array).Value(row);
+                 });
+}
+
+std::unique_ptr<DataArray>
+LazyField::bulk_subscript(const int64_t* seg_offsets, int64_t count) const {
+    if (field_meta_.is_vector()) {
+        auto data_array = CreateVectorDataArray(0, field_meta_);
+        auto row_bytes = field_meta_.get_sizeof();
+        auto output = static_cast<char*>(
+            AppendVectorRows(data_array.get(), field_meta_, count));
+        std::memset(output, 0, count * row_bytes);
+        for_each_row(
+            seg_offsets,
+            count,
+            [&](int64_t i, const arrow::Array& array, int64_t row) {
+                auto& values =
+                    static_cast<const arrow::FixedSizeBinaryArray&>(array);
+                std::memcpy(
+                    output + i * row_bytes, values.GetValue(row), row_bytes);
+            });
+        return data_array;
+    }
+
+    auto data_array = CreateScalarDataArray(0, field_meta_);
+    auto scalar_array = data_array->mutable_scalars();
+    switch (field_meta_.get_data_type()) {
+        case DataType::BOOL: {
+            auto output = AppendRows(
+                scalar_array->mutable_bool_data()->mutable_data(), count);
+            std::fill_n(output, count, false);
+            for_each_row(
+                seg_offsets,
+                count,
+                [&](int64_t i, const arrow::Array& array, int64_t row) {
+                    output[i] =
+                        static_cast<const arrow::BooleanArray&>(array).Value(
+                            row);
+                });
+            break;
+        }
+        case DataType::INT8:
+            gather<arrow::Int8Type>(
+                seg_offsets,
+                count,
+                AppendRows(scalar_array->mutable_int_data()->mutable_data(),
+                           count));
+            break;
+        case DataType::INT16:
+            gather<arrow::Int16Type>(
+                seg_offsets,
+                count,
+                AppendRows(scalar_array->mutable_int_data()->mutable_data(),
+                           count));
+            break;
+        case DataType::INT32:
+            gather<arrow::Int32Type>(
+                seg_offsets,
+                count,
+                AppendRows(scalar_array->mutable_int_data()->mutable_data(),
+                           count));
+            break;
+        case DataType::INT64:
+            gather<arrow::Int64Type>(
+                seg_offsets,
+                count,
+                AppendRows(scalar_array->mutable_long_data()->mutable_data(),
+                           count));
+            break;
+        case DataType::FLOAT:
+            gather<arrow::FloatType>(
+                seg_offsets,
+                count,
+                AppendRows(scalar_array->mutable_float_data()->mutable_data(),
+                           count));
+            break;
+        case DataType::DOUBLE:
+            gather<arrow::DoubleType>(
+                seg_offsets,
+                count,
+                AppendRows(
+                    scalar_array->mutable_double_data()->mutable_data(),
+                    count));
+            break;
+        case DataType::VARCHAR:
+        case DataType::STRING: {
+            auto output = AppendRows(
+                scalar_array->mutable_string_data()->mutable_data(), count);
+            for_each_row(
+                seg_offsets,
+                count,
+                [&](int64_t i, const arrow::Array& array, int64_t row) {
+                    auto value =
+                        static_cast<const arrow::StringArray&>(array).GetView(
+                            row);
+                    output[i]->assign(value.data(), value.size());
+                });
+            break;
+        }
+        default:
+            PanicInfo(fmt::format(
+                "unsupported data type {}",
+                datatype_name(field_meta_.get_data_type())));
+    }
+    return data_array;
+}
+
+int64_t
+LazyField::memory_usage() const {
+    int64_t usage = binlogs_.size() * sizeof(Binlog) +
+                    row_groups_.size() * sizeof(RowGroup);
+    for (auto& binlog : binlogs_) {
+        usage += binlog.metadata->size();
+    }
+    std::lock_guard lck(cache_mutex_);
+    return usage + cached_bytes_;
+}
+
+}  // namespace milvus::segcore
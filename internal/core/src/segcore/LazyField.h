@@ -0,0 +1,111 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "common/FieldMeta.h"
+#include "common/Types.h"
+#include "parquet/metadata.h"
+#include "storage/ChunkManager.h"
+
+namespace milvus::segcore {
+
+// a field of a sealed segment left in its remote insert binlogs, for the
+// output only fields rarely retrieved. only the locator of each binlog
+// payload and the rows of its row groups are kept; the rows asked for are
+// served by ranged reads of the row groups holding them, the last decoded
+// ones kept in an lru cache of cache_bytes
+class LazyField {
+ public:
+    LazyField(const FieldMeta& field_meta,
+              const std::vector<std::string>& binlog_paths,
+              std::shared_ptr<storage::ChunkManager> chunk_manager,
+              int64_t cache_bytes);
+
+    int64_t
+    row_count() const {
+        return row_count_;
+    }
+
+    // the values of the rows at seg_offsets, invalid offsets get zeros
+    std::unique_ptr<DataArray>
+    bulk_subscript(const int64_t* seg_offsets, int64_t count) const;
+
+    // the decoded row groups cached and the locators
+    int64_t
+    memory_usage() const;
+
+ private:
+    struct Binlog {
+        std::string path;
+        int64_t payload_offset;
+        int64_t payload_size;
+        std::shared_ptr<parquet::FileMetaData> metadata;
+    };
+
+    struct RowGroup {
+        int32_t binlog;
+        int32_t index;
+        int64_t row_begin;
+    };
+
+    // the row group holding row
+    int64_t
+    find_row_group(int64_t row) const;
+
+    // reads and decodes a row group, through the cache
+    std::shared_ptr<arrow::Array>
+    get_row_group(int64_t group) const;
+
+    std::shared_ptr<arrow::Array>
+    read_row_group(int64_t group) const;
+
+    // calls visit(i, array, row) for each valid seg_offsets[i], the rows
+    // in offset order so a row group is fetched once
+    template <typename Visit>
+    void
+    for_each_row(const int64_t* seg_offsets,
+                 int64_t count,
+                 const Visit& visit) const;
+
+    template <typename ArrowType, typename T>
+    void
+    gather(const int64_t* seg_offsets, int64_t count, T* output) const;
+
+ private:
+    const FieldMeta field_meta_;
+    std::shared_ptr<storage::ChunkManager> chunk_manager_;
+    const int64_t cache_bytes_;
+    std::vector<Binlog> binlogs_;
+    std::vector<RowGroup> row_groups_;
+    int64_t row_count_ = 0;
+
+    struct CacheEntry {
+        std::shared_ptr<arrow::Array> array;
+        int64_t bytes;
+        std::list<int64_t>::iterator lru;
+    };
+    mutable std::mutex cache_mutex_;
+    // the most recently used row group first
+    mutable std::list<int64_t> lru_;
+    mutable std::unordered_map<int64_t, CacheEntry> cache_;
+    mutable int64_t cached_bytes_ = 0;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,251 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "ParquetImport.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+
+#include "arrow/api.h"
+#include "arrow/io/memory.h"
+#include "common/SystemProperty.h"
+#include "exceptions/EasyAssert.h"
+#include "parquet/arrow/reader.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+template <typename T, typename Field>
+void
+AppendValues(Field* field, const T* values, int64_t n) {
+    auto size = field->size();
+    field->Resize(size + n, 0);
+    std::copy_n(values, n, field->mutable_data() + size);
+}
+
+template <typename ArrowType, typename Field>
+void
+AppendNumbers(Field* field, const arrow::Array& chunk) {
+    auto& array = static_cast<const arrow::NumericArray<ArrowType>&>(chunk);
+    AppendValues(field, array.raw_values(), array.length());
+}
+
+// the elements of a list column whose rows all hold n of them
+std::shared_ptr<arrow::Array>
+ListValues(const arrow::Array& chunk, int64_t n, const std::string& name) {
+    if (chunk.type_id() == arrow::Type::FIXED_SIZE_LIST) {
+        auto& list = static_cast<const arrow::FixedSizeListArray&>(chunk);
+        AssertInfo(list.value_length() == n,
+                   fmt::format("rows of column {} hold {} elements, not {}",
+                               name,
+                               list.value_length(),
+                               n));
+        return list.values()->Slice(list.value_offset(0),
+                                    chunk.length() * n);
+    }
+    AssertInfo(chunk.type_id() == arrow::Type::LIST,
+               fmt::format("column {} is not a list", name));
+    auto& list = static_cast<const arrow::ListArray&>(chunk);
+    for (int64_t i = 0; i < list.length(); ++i) {
+        AssertInfo(list.value_length(i) == n,
+                   fmt::format("row {} of column {} holds {} elements, not {}",
+                               i,
+                               name,
+                               list.value_length(i),
+                               n));
+    }
+    return list.values()->Slice(list.value_offset(0), chunk.length() * n);
+}
+
+// the arrow type of a column of a scalar field
+arrow::Type::type
+ScalarArrowType(DataType data_type) {
+    switch (data_type) {
+        case DataType::BOOL:
+            return arrow::Type::BOOL;
+        case DataType::INT8:
+            return arrow::Type::INT8;
+        case DataType::INT16:
+            return arrow::Type::INT16;
+        case DataType::INT32:
+            return arrow::Type::INT32;
+        case DataType::INT64:
+            return arrow::Type::INT64;
+        case DataType::FLOAT:
+            return arrow::Type::FLOAT;
+        case DataType::DOUBLE:
+            return arrow::Type::DOUBLE;
+        case DataType::VARCHAR:
+        case DataType::STRING:
+            return arrow::Type::STRING;
+        default:
+            PanicInfo(fmt::format("unsupported data type {}",
+                                  datatype_name(data_type)));
+    }
+}
+
+void
+AppendColumn(const FieldMeta& field_meta,
+             const arrow::Array& chunk,
+             DataArray& array) {
+    auto& name = field_meta.get_name().get();
+    AssertInfo(chunk.null_count() == 0,
+               fmt::format("column {} has nulls", name));
+    auto data_type = field_meta.get_data_type();
+    // the lists of vectors are checked when their elements are taken
+    if (!field_meta.is_vector()) {
+        AssertInfo(chunk.type_id() == ScalarArrowType(data_type),
+                   fmt::format("column {} has arrow type {}",
+                               name,
+                               chunk.type()->ToString()));
+    }
+
+    auto scalars = array.mutable_scalars();
+    switch (data_type) {
+        case DataType::BOOL: {
+            auto& values = static_cast<const arrow::BooleanArray&>(chunk);
+            auto data = scalars->mutable_bool_data()->mutable_data();
+            for (int64_t i = 0; i < values.length(); ++i) {
+                data->Add(values.Value(i));
+            }
+            break;
+        }
+        case DataType::INT8:
+            AppendNumbers<arrow::Int8Type>(
+                scalars->mutable_int_data()->mutable_data(), chunk);
+            break;
+        case DataType::INT16:
+            AppendNumbers<arrow::Int16Type>(
+                scalars->mutable_int_data()->mutable_data(), chunk);
+            break;
+        case DataType::INT32:
+            AppendNumbers<arrow::Int32Type>(
+                scalars->mutable_int_data()->mutable_data(), chunk);
+            break;
+        case DataType::INT64:
+            AppendNumbers<arrow::Int64Type>(
+                scalars->mutable_long_data()->mutable_data(), chunk);
+            break;
+        case DataType::FLOAT:
+            AppendNumbers<arrow::FloatType>(
+                scalars->mutable_float_data()->mutable_data(), chunk);
+            break;
+        case DataType::DOUBLE:
+            AppendNumbers<arrow::DoubleType>(
+                scalars->mutable_double_data()->mutable_data(), chunk);
+            break;
+        case DataType::VARCHAR:
+        case DataType::STRING: {
+            auto& values = static_cast<const arrow::StringArray&>(chunk);
+            auto data = scalars->mutable_string_data()->mutable_data();
+            data->Reserve(data->size() + values.length());
+            for (int64_t i = 0; i < values.length(); ++i) {
+                auto value = values.GetView(i);
+                data->Add()->assign(value.data(), value.size());
+            }
+            break;
+        }
+        case DataType::VECTOR_FLOAT: {
+            auto values = ListValues(chunk, field_meta.get_dim(), name);
+            AssertInfo(values->type_id() == arrow::Type::FLOAT,
+                       fmt::format("column {} is not a list of floats", name));
+            AppendNumbers<arrow::FloatType>(
+                array.mutable_vectors()->mutable_float_vector()->mutable_data(),
+                *values);
+            break;
+        }
+        case DataType::VECTOR_BINARY: {
+            auto values = ListValues(chunk, field_meta.get_dim() / 8, name);
+            AssertInfo(values->type_id() == arrow::Type::UINT8,
+                       fmt::format("column {} is not a list of bytes", name));
+            auto& bytes = static_cast<const arrow::UInt8Array&>(*values);
+            array.mutable_vectors()->mutable_binary_vector()->append(
+                reinterpret_cast<const char*>(bytes.raw_values()),
+                bytes.length());
+            break;
+        }
+        default:
+            PanicInfo(fmt::format("unsupported data type of column {}", name));
+    }
+}
+
+}  // namespace
+
+std::map<FieldId, std::unique_ptr<DataArray>>
+ReadParquetFields(const Schema& schema,
+                  const std::vector<std::string>& files,
+                  storage::ChunkManager& chunk_manager,
+                  int64_t& row_count) {
+    std::map<FieldId, std::unique_ptr<DataArray>> arrays;
+    for (auto field_id : schema.get_field_ids()) {
+        if (SystemProperty::Instance().IsSystem(field_id)) {
+            continue;
+        }
+        auto& field_meta = schema[field_id];
+        auto array = std::make_unique<DataArray>();
+        array->set_field_id(field_id.get());
+        array->set_type(proto::schema::DataType(field_meta.get_data_type()));
+        if (field_meta.is_vector()) {
+            array->mutable_vectors()->set_dim(field_meta.get_dim());
+        }
+        arrays.emplace(field_id, std::move(array));
+    }
+
+    row_count = 0;
+    std::vector<uint8_t> buf;
+    for (auto& file : files) {
+        buf.resize(chunk_manager.Size(file));
+        chunk_manager.Read(file, buf.data(), buf.size());
+        auto input =
+            std::make_shared<arrow::io::BufferReader>(buf.data(), buf.size());
+        std::unique_ptr<parquet::arrow::FileReader> reader;
+        auto st = parquet::arrow::OpenFile(
+            input, arrow::default_memory_pool(), &reader);
+        AssertInfo(st.ok(),
+                   "failed to open parquet file " + file + ": " +
+                       st.ToString());
+        std::shared_ptr<arrow::Schema> file_schema;
+        st = reader->GetSchema(&file_schema);
+        AssertInfo(st.ok(), "failed to get the schema of " + file);
+        int64_t rows = reader->parquet_reader()->metadata()->num_rows();
+        for (auto& [field_id, array] : arrays) {
+            auto& field_meta = schema[field_id];
+            auto& name = field_meta.get_name().get();
+            auto index = file_schema->GetFieldIndex(name);
+            AssertInfo(index >= 0,
+                       fmt::format("parquet file {} has no column {}",
+                                   file,
+                                   name));
+            std::shared_ptr<arrow::ChunkedArray> column;
+            st = reader->ReadColumn(index, &column);
+            AssertInfo(st.ok(),
+                       fmt::format("failed to read column {} of {}: {}",
+                                   name,
+                                   file,
+                                   st.ToString()));
+            AssertInfo(column->length() == rows,
+                       fmt::format("column {} of {} holds {} rows, not {}",
+                                   name,
+                                   file,
+                                   column->length(),
+                                   rows));
+            for (auto& chunk : column->chunks()) {
+                AppendColumn(field_meta, *chunk, *array);
+            }
+        }
+        row_count += rows;
+    }
+    return arrays;
+}
+
+}  // namespace milvus::segcore
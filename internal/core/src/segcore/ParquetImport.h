@@ -0,0 +1,35 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/Schema.h"
+#include "common/Types.h"
+#include "storage/ChunkManager.h"
+
+namespace milvus::segcore {
+
+// reads the user fields of schema from parquet files, the files in order,
+// each field from the column named after it; only those columns are
+// decoded. a vector is a list of dim floats, or of dim / 8 bytes for a
+// binary one. row_count is set to the rows read
+std::map<FieldId, std::unique_ptr<DataArray>>
+ReadParquetFields(const Schema& schema,
+                  const std::vector<std::string>& files,
+                  storage::ChunkManager& chunk_manager,
+                  int64_t& row_count);
+
+}  // namespace milvus::segcore
@@ -0,0 +1,134 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "common/CompressedBitset.h"
+#include "common/Schema.h"
+
+namespace milvus::segcore {
+
+class PartitionKeysBase {
+ public:
+    virtual ~PartitionKeysBase() = default;
+
+    virtual int64_t
+    memory_usage() const = 0;
+};
+
+// the values of the partition key field held by a segment, K is int64_t
+// or std::string. a growing segment adds the keys of its rows before
+// acknowledging them, so a key it lacks is in none of its visible rows; a
+// sealed one also keeps the rows of each key, to filter on keys without
+// reading the column
+template <typename K>
+class PartitionKeys : public PartitionKeysBase {
+ public:
+    using offset_type = CompressedBitset::offset_type;
+
+    explicit PartitionKeys(bool with_rows) : with_rows_(with_rows) {
+    }
+
+    // the keys of rows [offset, offset + size)
+    template <typename V>
+    void
+    Add(const V* keys, int64_t size, int64_t offset) {
+        std::unique_lock lck(mutex_);
+        for (int64_t i = 0; i < size; ++i) {
+            auto& rows = rows_[K(keys[i])];
+            if (with_rows_) {
+                rows.push_back(offset + i);
+            }
+        }
+    }
+
+    // whether some row holds one of the keys
+    bool
+    Contains(const K* keys, int64_t n) const {
+        std::shared_lock lck(mutex_);
+        for (int64_t i = 0; i < n; ++i) {
+            if (rows_.count(keys[i]) > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // the rows among the first row_count holding one of the keys, nullopt
+    // if the rows are not kept
+    std::optional<CompressedBitset>
+    Rows(const K* keys, int64_t n, int64_t row_count) const {
+        if (!with_rows_) {
+            return std::nullopt;
+        }
+        std::vector<offset_type> offsets;
+        std::shared_lock lck(mutex_);
+        for (int64_t i = 0; i < n; ++i) {
+            auto it = rows_.find(keys[i]);
+            if (it == rows_.end()) {
+                continue;
+            }
+            for (auto row : it->second) {
+                if (row < row_count) {
+                    offsets.push_back(row);
+                }
+            }
+        }
+        lck.unlock();
+        return CompressedBitset::from_offsets(row_count, std::move(offsets));
+    }
+
+    int64_t
+    memory_usage() const override {
+        std::shared_lock lck(mutex_);
+        // a node and a bucket per key
+        int64_t usage =
+            rows_.size() * (sizeof(typename Map::value_type) + 3 * 8);
+        for (auto& [key, rows] : rows_) {
+            usage += rows.capacity() * sizeof(offset_type);
+            if constexpr (std::is_same_v<K, std::string>) {
+                usage += key.capacity();
+            }
+        }
+        return usage;
+    }
+
+ private:
+    using Map = std::unordered_map<K, std::vector<offset_type>>;
+
+    const bool with_rows_;
+    mutable std::shared_mutex mutex_;
+    Map rows_;
+};
+
+// keys of the partition key field of schema, nullptr if it has none
+inline std::shared_ptr<PartitionKeysBase>
+CreatePartitionKeys(const Schema& schema, bool with_rows) {
+    auto field_id = schema.get_partition_key_field_id();
+    if (!field_id.has_value()) {
+        return nullptr;
+    }
+    if (schema[field_id.value()].get_data_type() == DataType::INT64) {
+        return std::make_shared<PartitionKeys<int64_t>>(with_rows);
+    }
+    return std::make_shared<PartitionKeys<std::string>>(with_rows);
+}
+
+}  // namespace milvus::segcore
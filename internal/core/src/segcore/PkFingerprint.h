@@ -0,0 +1,70 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace milvus::segcore {
+
+// murmur3 finalizer, so strided keys spread over a table
+inline uint64_t
+MixFingerprint(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// 64 bit fingerprints of pks, the same in every process unlike std::hash.
+// the tables over string pks keep them next to the pks, compare them
+// first and compare the strings only when they collide
+inline uint64_t
+PkFingerprint(int64_t pk) {
+    return MixFingerprint(static_cast<uint64_t>(pk));
+}
+
+// MurmurHash64A
+inline uint64_t
+PkFingerprint(std::string_view pk) {
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+    constexpr int r = 47;
+    auto n = pk.size();
+    uint64_t h = 0x9747b28cULL ^ (n * m);
+    auto data = pk.data();
+    for (; n >= 8; data += 8, n -= 8) {
+        uint64_t k;
+        std::memcpy(&k, data, 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    if (n > 0) {
+        uint64_t tail = 0;
+        for (size_t i = 0; i < n; ++i) {
+            tail |= uint64_t(uint8_t(data[i])) << (8 * i);
+        }
+        h ^= tail;
+        h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+}  // namespace milvus::segcore
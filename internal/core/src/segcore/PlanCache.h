@@ -0,0 +1,95 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace milvus::segcore {
+
+// LRU of the plans of one collection, keyed by the serialized plan node
+// they are parsed from. Hits are copies of the cached plan sharing its
+// plan node, which nothing modifies after parsing, so the expressions and
+// search params are parsed once per distinct plan.
+template <typename PlanType>
+class PlanCache {
+ public:
+    // create parses the plan on a miss; capacity counts plans, 0 disables
+    // the cache
+    template <typename Create>
+    std::unique_ptr<PlanType>
+    GetOrCreate(const void* serialized_plan,
+                int64_t size,
+                int64_t capacity,
+                Create&& create) {
+        if (capacity <= 0) {
+            return create();
+        }
+        std::string_view key(static_cast<const char*>(serialized_plan), size);
+        {
+            std::lock_guard lck(mutex_);
+            auto iter = index_.find(key);
+            if (iter != index_.end()) {
+                lru_.splice(lru_.begin(), lru_, iter->second);
+                return std::make_unique<PlanType>(*iter->second->plan);
+            }
+        }
+
+        // parsed unlocked, a concurrent miss of the same plan parses too
+        std::shared_ptr<const PlanType> plan = create();
+        auto res = std::make_unique<PlanType>(*plan);
+        std::lock_guard lck(mutex_);
+        if (index_.count(key)) {
+            return res;
+        }
+        lru_.push_front(Entry{std::string(key), std::move(plan)});
+        index_.emplace(lru_.front().key, lru_.begin());
+        while (int64_t(lru_.size()) > capacity) {
+            index_.erase(lru_.back().key);
+            lru_.pop_back();
+        }
+        return res;
+    }
+
+    void
+    Clear() {
+        std::lock_guard lck(mutex_);
+        index_.clear();
+        lru_.clear();
+    }
+
+    int64_t
+    size() const {
+        std::lock_guard lck(mutex_);
+        return index_.size();
+    }
+
+ private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const PlanType> plan;
+    };
+
+    mutable std::mutex mutex_;
+    // most recently used first
+    std::list<Entry> lru_;
+    // keys view the serialized plans owned by lru_
+    std::unordered_map<std::string_view, typename std::list<Entry>::iterator>
+        index_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,84 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "segcore/QuantizedChunk.h"
+
+namespace milvus::segcore {
+
+SQ8Chunk::SQ8Chunk(const float* data, int64_t rows, int64_t dim)
+    : rows_(rows),
+      dim_(dim),
+      min_(dim, std::numeric_limits<float>::max()),
+      step_(dim),
+      codes_(rows * dim) {
+    std::vector<float> max(dim, std::numeric_limits<float>::lowest());
+    for (int64_t i = 0; i < rows; ++i) {
+        auto row = data + i * dim;
+        for (int64_t d = 0; d < dim; ++d) {
+            min_[d] = std::min(min_[d], row[d]);
+            max[d] = std::max(max[d], row[d]);
+        }
+    }
+    std::vector<float> scale(dim);
+    for (int64_t d = 0; d < dim; ++d) {
+        step_[d] = (max[d] - min_[d]) / 255;
+        scale[d] = step_[d] > 0 ? 1 / step_[d] : 0;
+    }
+    for (int64_t i = 0; i < rows; ++i) {
+        auto row = data + i * dim;
+        auto code = codes_.data() + i * dim;
+        for (int64_t d = 0; d < dim; ++d) {
+            auto level = std::nearbyint((row[d] - min_[d]) * scale[d]);
+            code[d] = uint8_t(std::clamp(level, 0.0f, 255.0f));
+        }
+    }
+}
+
+void
+SQ8Chunk::Distances(const float* query,
+                    bool is_ip,
+                    int64_t begin,
+                    int64_t end,
+                    float* distances) const {
+    // fold the decoding into the query, so a row costs one multiply-add
+    // per byte: L2 sums (q - min - c * step)^2, IP sums q * min plus
+    // (q * step) * c
+    std::vector<float> shifted(dim_);
+    std::vector<float> scaled(dim_);
+    float bias = 0;
+    for (int64_t d = 0; d < dim_; ++d) {
+        shifted[d] = query[d] - min_[d];
+        scaled[d] = query[d] * step_[d];
+        bias += query[d] * min_[d];
+    }
+    for (int64_t i = begin; i < end; ++i) {
+        auto code = codes_.data() + i * dim_;
+        float acc = 0;
+        if (is_ip) {
+            for (int64_t d = 0; d < dim_; ++d) {
+                acc += scaled[d] * code[d];
+            }
+            distances[i - begin] = -(bias + acc);
+        } else {
+            for (int64_t d = 0; d < dim_; ++d) {
+                auto diff = shifted[d] - step_[d] * code[d];
+                acc += diff * diff;
+            }
+            distances[i - begin] = acc;
+        }
+    }
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,55 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace milvus::segcore {
+
+// 8-bit scalar quantized copy of a chunk of float vectors: every dimension
+// is mapped linearly from its [min, max] over the chunk onto 0..255. A
+// scan reads a quarter of the bytes of the float rows, at the price of
+// approximate distances that callers re-rank on the float rows.
+class SQ8Chunk {
+ public:
+    SQ8Chunk(const float* data, int64_t rows, int64_t dim);
+
+    int64_t
+    rows() const {
+        return rows_;
+    }
+
+    // approximate distances of query to the rows [begin, end), smaller is
+    // nearer: the squared L2 distance, or the negated inner product
+    void
+    Distances(const float* query,
+              bool is_ip,
+              int64_t begin,
+              int64_t end,
+              float* distances) const;
+
+    int64_t
+    memory_usage() const {
+        return codes_.size() + (min_.size() + step_.size()) * sizeof(float);
+    }
+
+ private:
+    const int64_t rows_;
+    const int64_t dim_;
+    // value of dimension d is min_[d] + code * step_[d]
+    std::vector<float> min_;
+    std::vector<float> step_;
+    std::vector<uint8_t> codes_;
+};
+
+}  // namespace milvus::segcore
@@ -14,15 +14,27 @@
 #include <log/Log.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <vector>
 
+#include "FlatSearchResult.h"
+#include "SegcoreConfig.h"
 #include "SegmentInterface.h"
 #include "Utils.h"
+#include "common/Utils.h"
 #include "pkVisitor.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::segcore {
 
+namespace {
+
+// nqs reduced per task, so small requests stay on the calling thread
+constexpr int64_t REDUCE_BATCH_NQ = 64;
+
+}  // namespace
+
 void
 ReduceHelper::Initialize() {
     AssertInfo(search_results_.size() > 0, "empty search result");
@@ -50,26 +62,187 @@ ReduceHelper::Initialize() {
     for (auto& search_record : final_search_records_) {
         search_record.resize(total_nq_);
     }
+    final_search_ranks_.resize(num_segments_);
+    for (auto& search_ranks : final_search_ranks_) {
+        search_ranks.resize(total_nq_);
+    }
+    nq_result_counts_.resize(total_nq_);
+
+    nq_topks_.resize(total_nq_);
+    for (int64_t slice_index = 0; slice_index < num_slices_; slice_index++) {
+        std::fill(nq_topks_.begin() + slice_nqs_prefix_sum_[slice_index],
+                  nq_topks_.begin() + slice_nqs_prefix_sum_[slice_index + 1],
+                  slice_topKs_[slice_index]);
+    }
+
+    input_rows_ = 0;
+    for (auto search_result : search_results_) {
+        input_rows_ += search_result->seg_offsets_.size();
+    }
+    // the primary keys, offsets and distances merged
+    scratch_ = ReserveScratch(
+        input_rows_ * int64_t(2 * sizeof(int64_t) + sizeof(float)), "reduce");
+
+    if (plan_->profile_) {
+        profile_.emplace();
+        for (auto search_result : search_results_) {
+            if (search_result->profile_ != nullptr) {
+                profile_->Merge(*search_result->profile_);
+            }
+        }
+    }
 }
 
 void
 ReduceHelper::Reduce() {
-    FillPrimaryKey();
-    ReduceResultData();
-    RefreshSearchResult();
+    ScratchScope scratch_scope;
+    auto profile = profile_.has_value() ? &profile_.value() : nullptr;
+    {
+        ProfileTimer timer(profile, "fill_primary_keys");
+        FillPrimaryKey();
+    }
+    {
+        ProfileTimer timer(profile, "reduce");
+        ReduceResultData();
+        RefreshSearchResult();
+    }
+    plan_->cancel_token_.Check();
+    ProfileTimer timer(profile, "fill_target_entry");
     FillEntryData();
 }
 
 void
-ReduceHelper::Marshal() {
+ReduceHelper::Marshal(ResultFormat format) {
+    ProfileTimer timer(profile_.has_value() ? &profile_.value() : nullptr,
+                       "marshal");
     // get search result data blobs of slices
     search_result_data_blobs_ =
         std::make_unique<milvus::segcore::SearchResultDataBlobs>();
     search_result_data_blobs_->blobs.resize(num_slices_);
-    for (int i = 0; i < num_slices_; i++) {
-        auto proto = GetSearchResultDataSlice(i);
-        search_result_data_blobs_->blobs[i] = proto;
+    // the slices only read the reduced results, each fills its own blob
+    ParallelFor(
+        num_slices_,
+        SegcoreConfig::default_config().get_reduce_parallelism() - 1,
+        [this, format](int64_t i) {
+            plan_->cancel_token_.Check();
+            search_result_data_blobs_->blobs[i] =
+                MarshalSlice(search_results_,
+                             slice_nqs_prefix_sum_[i],
+                             slice_nqs_prefix_sum_[i + 1],
+                             slice_topKs_[i],
+                             format);
+        });
+}
+
+void
+ReduceHelper::StreamReduce(ResultFormat format) {
+    ScratchScope scratch_scope;
+    auto profile = profile_.has_value() ? &profile_.value() : nullptr;
+    {
+        ProfileTimer timer(profile, "fill_primary_keys");
+        FillPrimaryKey();
+    }
+    // reduce, fill_target_entry and marshal one slice after another
+    ProfileTimer timer(profile, "stream_reduce");
+    CheckSearchResults();
+    search_result_data_blobs_ =
+        std::make_unique<milvus::segcore::SearchResultDataBlobs>();
+    search_result_data_blobs_->blobs.resize(num_slices_);
+
+    int64_t skip_dup_cnt = 0;
+    for (int64_t i = 0; i < num_slices_; i++) {
+        plan_->cancel_token_.Check();
+        auto nq_begin = slice_nqs_prefix_sum_[i];
+        auto nq_end = slice_nqs_prefix_sum_[i + 1];
+        skip_dup_cnt += ReduceNQs(nq_begin, nq_end);
+
+        auto slice_results = ExtractSlice(nq_begin, nq_end);
+        std::vector<SearchResult*> results;
+        for (auto& slice_result : slice_results) {
+            results.push_back(slice_result.get());
+        }
+        search_result_data_blobs_->blobs[i] = MarshalSlice(
+            results, 0, nq_end - nq_begin, slice_topKs_[i], format);
+
+        // the records of the slice go now, its result rows and output
+        // fields with slice_results
+        for (int64_t j = 0; j < num_segments_; j++) {
+            for (auto qi = nq_begin; qi < nq_end; qi++) {
+                std::vector<int64_t>().swap(final_search_records_[j][qi]);
+                std::vector<int64_t>().swap(final_search_ranks_[j][qi]);
+            }
+        }
+    }
+    if (skip_dup_cnt > 0) {
+        LOG_SEGCORE_DEBUG_ << "skip duplicated search result, count = "
+                           << skip_dup_cnt;
+    }
+}
+
+std::vector<std::unique_ptr<SearchResult>>
+ReduceHelper::ExtractSlice(int64_t nq_begin, int64_t nq_end) {
+    auto slice_nq = nq_end - nq_begin;
+    // where the results of each nq start in the slice
+    std::vector<int64_t> nq_offsets(slice_nq);
+    int64_t offset = 0;
+    for (auto qi = nq_begin; qi < nq_end; qi++) {
+        nq_offsets[qi - nq_begin] = offset;
+        offset += nq_result_counts_[qi];
+    }
+
+    std::vector<std::unique_ptr<SearchResult>> slice_results(num_segments_);
+    auto parallelism = SegcoreConfig::default_config().get_reduce_parallelism();
+    ParallelFor(num_segments_, parallelism - 1, [&](int64_t i) {
+        auto search_result = search_results_[i];
+        auto slice_result = std::make_unique<SearchResult>();
+        slice_result->total_nq_ = slice_nq;
+        slice_result->unity_topK_ = search_result->unity_topK_;
+        slice_result->segment_ = search_result->segment_;
+        slice_result->pk_type_ = search_result->pk_type_;
+        slice_result->topk_per_nq_prefix_sum_.resize(slice_nq + 1, 0);
+        for (auto qi = nq_begin; qi < nq_end; qi++) {
+            auto& records = final_search_records_[i][qi];
+            auto& ranks = final_search_ranks_[i][qi];
+            for (size_t j = 0; j < records.size(); j++) {
+                auto record = records[j];
+                slice_result->primary_keys_.push_back(
+                    search_result->primary_keys_[record]);
+                slice_result->distances_.push_back(
+                    search_result->distances_[record]);
+                slice_result->seg_offsets_.push_back(
+                    search_result->seg_offsets_[record]);
+                if (!search_result->group_by_values_.empty()) {
+                    slice_result->group_by_values_.push_back(
+                        search_result->group_by_values_[record]);
+                }
+                slice_result->result_offsets_.push_back(
+                    nq_offsets[qi - nq_begin] + ranks[j]);
+            }
+            auto& prefix_sum = slice_result->topk_per_nq_prefix_sum_;
+            prefix_sum[qi - nq_begin + 1] =
+                prefix_sum[qi - nq_begin] + records.size();
+        }
+        // output fields of the surviving rows only
+        if (!slice_result->seg_offsets_.empty()) {
+            auto segment =
+                static_cast<SegmentInterface*>(slice_result->segment_);
+            segment->FillTargetEntry(plan_, *slice_result);
+        }
+        slice_results[i] = std::move(slice_result);
+    });
+    return slice_results;
+}
+
+std::vector<char>
+ReduceHelper::MarshalSlice(const std::vector<SearchResult*>& search_results,
+                           int64_t nq_begin,
+                           int64_t nq_end,
+                           int64_t topk,
+                           ResultFormat format) {
+    if (format == ResultFormat::Flat) {
+        return GetFlatSearchResultSlice(search_results, nq_begin, nq_end, topk);
     }
+    return GetSearchResultDataSlice(search_results, nq_begin, nq_end, topk);
 }
 
 void
@@ -88,6 +261,7 @@ ReduceHelper::FilterInvalidSearchResult(SearchResult* search_result) {
     uint32_t valid_index = 0;
     auto& offsets = search_result->seg_offsets_;
     auto& distances = search_result->distances_;
+    auto& group_by_values = search_result->group_by_values_;
     for (auto i = 0; i < nq; ++i) {
         for (auto j = 0; j < topK; ++j) {
             auto index = i * topK + j;
@@ -95,12 +269,19 @@ ReduceHelper::FilterInvalidSearchResult(SearchResult* search_result) {
                 real_topks[i]++;
                 offsets[valid_index] = offsets[index];
                 distances[valid_index] = distances[index];
+                if (!group_by_values.empty()) {
+                    group_by_values[valid_index] =
+                        std::move(group_by_values[index]);
+                }
                 valid_index++;
             }
         }
     }
     offsets.resize(valid_index);
     distances.resize(valid_index);
+    if (!group_by_values.empty()) {
+        group_by_values.resize(valid_index);
+    }
 
     search_result->topk_per_nq_prefix_sum_.resize(nq + 1);
     std::partial_sum(real_topks.begin(),
@@ -139,6 +320,8 @@ ReduceHelper::RefreshSearchResult() {
             std::vector<milvus::PkType> primary_keys(size);
             std::vector<float> distances(size);
             std::vector<int64_t> seg_offsets(size);
+            auto grouped = !search_result->group_by_values_.empty();
+            std::vector<milvus::PkType> group_by_values(grouped ? size : 0);
 
             uint32_t index = 0;
             for (int j = 0; j < total_nq_; j++) {
@@ -146,6 +329,10 @@ ReduceHelper::RefreshSearchResult() {
                     primary_keys[index] = search_result->primary_keys_[offset];
                     distances[index] = search_result->distances_[offset];
                     seg_offsets[index] = search_result->seg_offsets_[offset];
+                    if (grouped) {
+                        group_by_values[index] =
+                            search_result->group_by_values_[offset];
+                    }
                     index++;
                     real_topks[j]++;
                 }
@@ -153,6 +340,7 @@ ReduceHelper::RefreshSearchResult() {
             search_result->primary_keys_.swap(primary_keys);
             search_result->distances_.swap(distances);
             search_result->seg_offsets_.swap(seg_offsets);
+            search_result->group_by_values_.swap(group_by_values);
         }
         std::partial_sum(real_topks.begin(),
                          real_topks.end(),
@@ -162,24 +350,42 @@ ReduceHelper::RefreshSearchResult() {
 
 void
 ReduceHelper::FillEntryData() {
-    for (auto search_result : search_results_) {
-        auto segment = static_cast<milvus::segcore::SegmentInterface*>(
-            search_result->segment_);
-        segment->FillTargetEntry(plan_, *search_result);
-    }
+    // each segment fetches the output fields of the rows it still holds,
+    // the reduced results only
+    ParallelFor(
+        num_segments_,
+        SegcoreConfig::default_config().get_reduce_parallelism() - 1,
+        [this](int64_t i) {
+            auto search_result = search_results_[i];
+            if (search_result->seg_offsets_.empty()) {
+                return;
+            }
+            auto segment = static_cast<milvus::segcore::SegmentInterface*>(
+                search_result->segment_);
+            segment->FillTargetEntry(plan_, *search_result);
+        });
 }
 
 int64_t
 ReduceHelper::ReduceSearchResultForOneNQ(int64_t qi,
                                          int64_t topk,
-                                         int64_t& offset) {
-    while (!heap_.empty()) {
-        heap_.pop();
+                                         ReduceScratch& scratch) {
+    auto& [pairs, heap, pk_set, group_set] = scratch;
+    while (!heap.empty()) {
+        heap.pop();
     }
-    pk_set_.clear();
-    pairs_.clear();
-
-    pairs_.reserve(num_segments_);
+    pk_set.clear();
+    group_set.clear();
+    auto grouped =
+        plan_->plan_node_->search_info_.group_by_field_id_.has_value();
+
+    // the pairs are reset rather than rebuilt, keeping their keys' storage,
+    // and never reallocate under the heap pointing into them
+    if (int64_t(pairs.size()) < num_segments_) {
+        pairs.resize(num_segments_,
+                     SearchResultPair(INVALID_PK, 0, nullptr, 0, 0, 0));
+    }
+    size_t num_pairs = 0;
     for (int i = 0; i < num_segments_; i++) {
         auto search_result = search_results_[i];
         auto offset_beg = search_result->topk_per_nq_prefix_sum_[qi];
@@ -190,47 +396,54 @@ ReduceHelper::ReduceSearchResultForOneNQ(int64_t qi,
         auto primary_key = search_result->primary_keys_[offset_beg];
         auto distance = search_result->distances_[offset_beg];
 
-        pairs_.emplace_back(
+        auto& pair = pairs[num_pairs++];
+        pair.reset(
             primary_key, distance, search_result, i, offset_beg, offset_end);
-        heap_.push(&pairs_.back());
+        heap.push(&pair);
     }
 
     // nq has no results for all segments
-    if (heap_.size() == 0) {
+    if (heap.size() == 0) {
         return 0;
     }
 
     int64_t dup_cnt = 0;
-    auto start = offset;
-    while (offset - start < topk && !heap_.empty()) {
-        auto pilot = heap_.top();
-        heap_.pop();
+    int64_t count = 0;
+    while (count < topk && !heap.empty()) {
+        auto pilot = heap.top();
+        heap.pop();
 
         auto index = pilot->segment_index_;
-        auto pk = pilot->primary_key_;
         // no valid search result for this nq, break to next
-        if (pk == INVALID_PK) {
+        if (pilot->primary_key_ == INVALID_PK) {
             break;
         }
-        // remove duplicates
-        if (pk_set_.count(pk) == 0) {
-            pilot->search_result_->result_offsets_.push_back(offset++);
+        // remove duplicates, by the key in the search result which stays
+        // put while the pair moves on
+        auto& pk = pilot->search_result_->primary_keys_[pilot->offset_];
+        if (pk_set.insert(pk) &&
+            (!grouped ||
+             group_set.insert(
+                 pilot->search_result_->group_by_values_[pilot->offset_]))) {
             final_search_records_[index][qi].push_back(pilot->offset_);
-            pk_set_.insert(pk);
+            final_search_ranks_[index][qi].push_back(count++);
         } else {
-            // skip entity with same primary key
+            // skip entity with same primary key, or of a group kept
             dup_cnt++;
         }
-        pilot->advance();
-        if (pilot->primary_key_ != INVALID_PK) {
-            heap_.push(pilot);
+        // an exhausted pair leaves the heap holding its last key, whose
+        // storage the next nq reuses
+        if (pilot->offset_ + 1 < pilot->offset_rb_) {
+            pilot->advance();
+            heap.push(pilot);
         }
     }
+    nq_result_counts_[qi] = count;
     return dup_cnt;
 }
 
 void
-ReduceHelper::ReduceResultData() {
+ReduceHelper::CheckSearchResults() {
     for (int i = 0; i < num_segments_; i++) {
         auto search_result = search_results_[i];
         auto result_count = search_result->get_total_result_count();
@@ -243,19 +456,55 @@ ReduceHelper::ReduceResultData() {
         AssertInfo(search_result->primary_keys_.size() == result_count,
                    "incorrect search result primary key size");
     }
+}
 
-    int64_t skip_dup_cnt = 0;
-    for (int64_t slice_index = 0; slice_index < num_slices_; slice_index++) {
-        auto nq_begin = slice_nqs_prefix_sum_[slice_index];
-        auto nq_end = slice_nqs_prefix_sum_[slice_index + 1];
+int64_t
+ReduceHelper::ReduceNQs(int64_t nq_begin, int64_t nq_end) {
+    // every nq reduces on its own, a range of them per task
+    auto parallelism = SegcoreConfig::default_config().get_reduce_parallelism();
+    std::atomic<int64_t> skip_dup_cnt = 0;
+    auto reduce_range = [&](int64_t task) {
+        plan_->cancel_token_.Check();
+        ReduceScratch scratch;
+        int64_t dup_cnt = 0;
+        auto begin = nq_begin + task * REDUCE_BATCH_NQ;
+        auto end = std::min(nq_end, begin + REDUCE_BATCH_NQ);
+        for (auto qi = begin; qi < end; qi++) {
+            dup_cnt += ReduceSearchResultForOneNQ(qi, nq_topks_[qi], scratch);
+        }
+        skip_dup_cnt += dup_cnt;
+    };
+    ParallelFor(upper_div(nq_end - nq_begin, REDUCE_BATCH_NQ),
+                parallelism - 1,
+                reduce_range);
+    return skip_dup_cnt;
+}
 
-        // reduce search results
+void
+ReduceHelper::ReduceResultData() {
+    CheckSearchResults();
+    auto skip_dup_cnt = ReduceNQs(0, total_nq_);
+    auto parallelism = SegcoreConfig::default_config().get_reduce_parallelism();
+
+    // result offsets count from the start of their slice, in nq order
+    std::vector<int64_t> nq_offsets(total_nq_);
+    for (int64_t slice_index = 0; slice_index < num_slices_; slice_index++) {
         int64_t offset = 0;
-        for (int64_t qi = nq_begin; qi < nq_end; qi++) {
-            skip_dup_cnt += ReduceSearchResultForOneNQ(
-                qi, slice_topKs_[slice_index], offset);
+        for (auto qi = slice_nqs_prefix_sum_[slice_index];
+             qi < slice_nqs_prefix_sum_[slice_index + 1];
+             qi++) {
+            nq_offsets[qi] = offset;
+            offset += nq_result_counts_[qi];
         }
     }
+    ParallelFor(num_segments_, parallelism - 1, [&](int64_t i) {
+        auto& result_offsets = search_results_[i]->result_offsets_;
+        for (int64_t qi = 0; qi < total_nq_; qi++) {
+            for (auto rank : final_search_ranks_[i][qi]) {
+                result_offsets.push_back(nq_offsets[qi] + rank);
+            }
+        }
+    });
     if (skip_dup_cnt > 0) {
         LOG_SEGCORE_DEBUG_ << "skip duplicated search result, count = "
                            << skip_dup_cnt;
@@ -263,12 +512,13 @@ ReduceHelper::ReduceResultData() {
 }
 
 std::vector<char>
-ReduceHelper::GetSearchResultDataSlice(int slice_index) {
-    auto nq_begin = slice_nqs_prefix_sum_[slice_index];
-    auto nq_end = slice_nqs_prefix_sum_[slice_index + 1];
-
+ReduceHelper::GetSearchResultDataSlice(
+    const std::vector<SearchResult*>& search_results,
+    int64_t nq_begin,
+    int64_t nq_end,
+    int64_t topk) {
     int64_t result_count = 0;
-    for (auto search_result : search_results_) {
+    for (auto search_result : search_results) {
         AssertInfo(search_result->topk_per_nq_prefix_sum_.size() ==
                        search_result->total_nq_ + 1,
                    "incorrect topk_per_nq_prefix_sum_ size in search result");
@@ -276,10 +526,24 @@ ReduceHelper::GetSearchResultDataSlice(int slice_index) {
                         search_result->topk_per_nq_prefix_sum_[nq_begin];
     }
 
-    auto search_result_data =
-        std::make_unique<milvus::proto::schema::SearchResultData>();
+    auto primary_field_id =
+        plan_->schema_.get_primary_field_id().value_or(milvus::FieldId(-1));
+    AssertInfo(primary_field_id.get() != INVALID_FIELD_ID, "Primary key is -1");
+    auto& pk_meta = plan_->schema_[primary_field_id];
+    auto pk_type = pk_meta.get_data_type();
+
+    // the message is built on an arena sized for the slice and freed in one
+    // go once serialized
+    int64_t row_bytes = ResultValueBytes(pk_meta) + sizeof(float);
+    for (auto field_id : plan_->target_entries_) {
+        row_bytes += ResultValueBytes(plan_->schema_[field_id]);
+    }
+    google::protobuf::Arena arena(ResultArenaOptions(
+        result_count * row_bytes + (nq_end - nq_begin) * sizeof(int64_t)));
+    auto search_result_data = google::protobuf::Arena::CreateMessage<
+        milvus::proto::schema::SearchResultData>(&arena);
     // set unify_topK and total_nq
-    search_result_data->set_top_k(slice_topKs_[slice_index]);
+    search_result_data->set_top_k(topk);
     search_result_data->set_num_queries(nq_end - nq_begin);
     search_result_data->mutable_topks()->Resize(nq_end - nq_begin, 0);
 
@@ -287,25 +551,21 @@ ReduceHelper::GetSearchResultDataSlice(int slice_index) {
     std::vector<std::pair<SearchResult*, int64_t>> result_pairs(result_count);
 
     // reserve space for pks
-    auto primary_field_id =
-        plan_->schema_.get_primary_field_id().value_or(milvus::FieldId(-1));
-    AssertInfo(primary_field_id.get() != INVALID_FIELD_ID, "Primary key is -1");
-    auto pk_type = plan_->schema_[primary_field_id].get_data_type();
     switch (pk_type) {
         case milvus::DataType::INT64: {
-            auto ids = std::make_unique<milvus::proto::schema::LongArray>();
-            ids->mutable_data()->Resize(result_count, 0);
-            search_result_data->mutable_ids()->set_allocated_int_id(
-                ids.release());
+            search_result_data->mutable_ids()
+                ->mutable_int_id()
+                ->mutable_data()
+                ->Resize(result_count, 0);
             break;
         }
         case milvus::DataType::VARCHAR: {
-            auto ids = std::make_unique<milvus::proto::schema::StringArray>();
-            std::vector<std::string> string_pks(result_count);
-            // TODO: prevent mem copy
-            *ids->mutable_data() = {string_pks.begin(), string_pks.end()};
-            search_result_data->mutable_ids()->set_allocated_str_id(
-                ids.release());
+            auto str_ids =
+                search_result_data->mutable_ids()->mutable_str_id();
+            str_ids->mutable_data()->Reserve(result_count);
+            for (int64_t i = 0; i < result_count; ++i) {
+                str_ids->add_data();
+            }
             break;
         }
         default: {
@@ -319,7 +579,7 @@ ReduceHelper::GetSearchResultDataSlice(int slice_index) {
     // fill pks and distances
     for (auto qi = nq_begin; qi < nq_end; qi++) {
         int64_t topk_count = 0;
-        for (auto search_result : search_results_) {
+        for (auto search_result : search_results) {
             AssertInfo(search_result != nullptr,
                        "null search result when reorganize");
             if (search_result->result_offsets_.size() == 0) {
@@ -380,10 +640,10 @@ ReduceHelper::GetSearchResultDataSlice(int slice_index) {
     // set output fields
     for (auto field_id : plan_->target_entries_) {
         auto& field_meta = plan_->schema_[field_id];
-        auto field_data =
-            milvus::segcore::MergeDataArray(result_pairs, field_meta);
-        search_result_data->mutable_fields_data()->AddAllocated(
-            field_data.release());
+        milvus::segcore::MergeDataArray(
+            result_pairs,
+            field_meta,
+            search_result_data->mutable_fields_data()->Add());
     }
 
     // SearchResultData to blob
@@ -394,4 +654,49 @@ ReduceHelper::GetSearchResultDataSlice(int slice_index) {
     return buffer;
 }
 
+std::vector<char>
+ReduceHelper::GetFlatSearchResultSlice(
+    const std::vector<SearchResult*>& search_results,
+    int64_t nq_begin,
+    int64_t nq_end,
+    int64_t topk) {
+    int64_t result_count = 0;
+    for (auto search_result : search_results) {
+        result_count += search_result->topk_per_nq_prefix_sum_[nq_end] -
+                        search_result->topk_per_nq_prefix_sum_[nq_begin];
+    }
+
+    // the rows in output order, read in place by the writer
+    FlatResultRows rows(result_count);
+    std::vector<int64_t> topks(nq_end - nq_begin, 0);
+    for (auto qi = nq_begin; qi < nq_end; qi++) {
+        for (auto search_result : search_results) {
+            if (search_result->result_offsets_.size() == 0) {
+                continue;
+            }
+            auto topk_start = search_result->topk_per_nq_prefix_sum_[qi];
+            auto topk_end = search_result->topk_per_nq_prefix_sum_[qi + 1];
+            topks[qi - nq_begin] += topk_end - topk_start;
+            for (auto ki = topk_start; ki < topk_end; ki++) {
+                auto loc = search_result->result_offsets_[ki];
+                AssertInfo(loc < result_count && loc >= 0,
+                           "invalid loc when GetFlatSearchResultSlice, loc = " +
+                               std::to_string(loc) + ", result_count = " +
+                               std::to_string(result_count));
+                rows[loc] = std::make_pair(search_result, ki);
+            }
+        }
+    }
+
+    auto primary_field_id =
+        plan_->schema_.get_primary_field_id().value_or(milvus::FieldId(-1));
+    AssertInfo(primary_field_id.get() != INVALID_FIELD_ID, "Primary key is -1");
+    auto pk_type = plan_->schema_[primary_field_id].get_data_type();
+    std::vector<const FieldMeta*> fields;
+    for (auto field_id : plan_->target_entries_) {
+        fields.push_back(&plan_->schema_[field_id]);
+    }
+    return WriteFlatSearchResult(topk, topks, rows, pk_type, fields);
+}
+
 }  // namespace milvus::segcore
@@ -14,12 +14,15 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 #include <queue>
-#include <unordered_set>
 
 #include "utils/Status.h"
+#include "common/MemoryBudget.h"
 #include "common/type_c.h"
+#include "common/ScratchArena.h"
 #include "common/QueryResult.h"
 #include "query/PlanImpl.h"
 #include "ReduceStructure.h"
@@ -29,6 +32,18 @@ namespace milvus::segcore {
 // SearchResultDataBlobs contains the marshal blobs of many `milvus::proto::schema::SearchResultData`
 struct SearchResultDataBlobs {
     std::vector<std::vector<char>> blobs;
+    // QueryProfile of the segments and the reduce as json, if the plan
+    // asked for one
+    std::string profile;
+    // the segments of a partial search left out past its deadline, by id
+    std::vector<int64_t> skipped_segments;
+};
+
+// encoding of the blobs: serialized SearchResultData, or the flat layout of
+// FlatSearchResult.h that readers use without a decode
+enum class ResultFormat {
+    Proto,
+    Flat,
 };
 
 class ReduceHelper {
@@ -49,10 +64,25 @@ class ReduceHelper {
     Reduce();
 
     void
-    Marshal();
+    Marshal(ResultFormat format = ResultFormat::Proto);
+
+    // Reduce and Marshal in one pass over the slices, with the same blobs:
+    // each slice is reduced, its output fields fetched for the rows kept
+    // and marshaled before the next, so only one slice's worth is held
+    void
+    StreamReduce(ResultFormat format = ResultFormat::Proto);
+
+    // rows of all the search results before the reduction
+    int64_t
+    input_rows() const {
+        return input_rows_;
+    }
 
     void*
     GetSearchResultDataBlobs() {
+        if (profile_.has_value()) {
+            search_result_data_blobs_->profile = profile_->ToJson();
+        }
         return search_result_data_blobs_.release();
     }
 
@@ -72,16 +102,57 @@ class ReduceHelper {
     void
     FillEntryData();
 
+    // merge buffers of the reduction of one nq, one set per thread
+    struct ReduceScratch {
+        ScratchVector<SearchResultPair> pairs;
+        std::priority_queue<SearchResultPair*,
+                            ScratchVector<SearchResultPair*>,
+                            SearchResultPairComparator>
+            heap;
+        PkDedupSet pk_set;
+        // the group by values kept, if the search groups its hits
+        PkDedupSet group_set;
+    };
+
     int64_t
     ReduceSearchResultForOneNQ(int64_t qi,
                                int64_t topk,
-                               int64_t& result_offset);
+                               ReduceScratch& scratch);
+
+    void
+    CheckSearchResults();
+
+    // reduces the nqs [nq_begin, nq_end), returns the duplicates skipped
+    int64_t
+    ReduceNQs(int64_t nq_begin, int64_t nq_end);
 
     void
     ReduceResultData();
 
+    // per segment, the rows kept for the nqs [nq_begin, nq_end) with their
+    // output fields, laid out as reduced search results of those nqs
+    std::vector<std::unique_ptr<SearchResult>>
+    ExtractSlice(int64_t nq_begin, int64_t nq_end);
+
+    // the reduced results of the nqs [nq_begin, nq_end) of search_results
+    std::vector<char>
+    MarshalSlice(const std::vector<SearchResult*>& search_results,
+                 int64_t nq_begin,
+                 int64_t nq_end,
+                 int64_t topk,
+                 ResultFormat format);
+
     std::vector<char>
-    GetSearchResultDataSlice(int slice_index_);
+    GetSearchResultDataSlice(const std::vector<SearchResult*>& search_results,
+                             int64_t nq_begin,
+                             int64_t nq_end,
+                             int64_t topk);
+
+    std::vector<char>
+    GetFlatSearchResultSlice(const std::vector<SearchResult*>& search_results,
+                             int64_t nq_begin,
+                             int64_t nq_end,
+                             int64_t topk);
 
  private:
     std::vector<int64_t> slice_topKs_;
@@ -94,21 +165,26 @@ class ReduceHelper {
     std::vector<SearchResult*>& search_results_;
 
     std::vector<int64_t> slice_nqs_prefix_sum_;
+    // topk of the slice of each nq
+    std::vector<int64_t> nq_topks_;
+    int64_t input_rows_;
 
     // dim0: num_segments_; dim1: total_nq_; dim2: offset
     std::vector<std::vector<std::vector<int64_t>>> final_search_records_;
+    // same dims, the rank of each final search record among the results
+    // of its nq
+    std::vector<std::vector<std::vector<int64_t>>> final_search_ranks_;
+    // results kept per nq
+    std::vector<int64_t> nq_result_counts_;
+
+    // the profiles of the segments merged, and the reduce timed into it
+    std::optional<QueryProfile> profile_;
+
+    // held from the scratch budget until the helper goes away
+    MemoryReservation scratch_;
 
     // output
     std::unique_ptr<SearchResultDataBlobs> search_result_data_blobs_;
-
-    // Used for merge results,
-    // define these here to avoid allocating them for each query
-    std::vector<SearchResultPair> pairs_;
-    std::priority_queue<SearchResultPair*,
-                        std::vector<SearchResultPair*>,
-                        SearchResultPairComparator>
-        heap_;
-    std::unordered_set<milvus::PkType> pk_set_;
 };
 
 }  // namespace milvus::segcore
@@ -11,11 +11,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
 
 #include "common/Consts.h"
 #include "common/Types.h"
 #include "common/QueryResult.h"
+#include "segcore/PkFingerprint.h"
 
 using milvus::SearchResult;
 
@@ -49,6 +57,22 @@ struct SearchResultPair {
         return distance_ > other.distance_;
     }
 
+    // reuses the storage of the key held, unlike assigning a new pair
+    void
+    reset(const milvus::PkType& primary_key,
+          float distance,
+          SearchResult* result,
+          int64_t index,
+          int64_t lb,
+          int64_t rb) {
+        primary_key_ = primary_key;
+        distance_ = distance;
+        search_result_ = result;
+        segment_index_ = index;
+        offset_ = lb;
+        offset_rb_ = rb;
+    }
+
     void
     advance() {
         offset_++;
@@ -68,3 +92,118 @@ struct SearchResultPairComparator {
         return *rhs > *lhs;
     }
 };
+
+// Open addressing set that clear empties by bumping an epoch, so a set
+// reused across nqs allocates only while it grows to the largest of them.
+template <typename Key, typename Hash>
+class ReusableHashSet {
+ public:
+    // false if key is in the set already
+    bool
+    insert(const Key& key) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        auto mask = slots_.size() - 1;
+        for (auto i = Hash{}(key) & mask;; i = (i + 1) & mask) {
+            if (epochs_[i] != epoch_) {
+                slots_[i] = key;
+                epochs_[i] = epoch_;
+                ++size_;
+                return true;
+            }
+            if (slots_[i] == key) {
+                return false;
+            }
+        }
+    }
+
+    void
+    clear() {
+        size_ = 0;
+        if (++epoch_ == 0) {
+            std::fill(epochs_.begin(), epochs_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+ private:
+    void
+    grow() {
+        auto old_slots = std::move(slots_);
+        auto old_epochs = std::move(epochs_);
+        slots_.assign(std::max<size_t>(16, old_slots.size() * 2), Key{});
+        epochs_.assign(slots_.size(), 0);
+        size_ = 0;
+        for (size_t i = 0; i < old_slots.size(); ++i) {
+            if (old_epochs[i] == epoch_) {
+                insert(old_slots[i]);
+            }
+        }
+    }
+
+ private:
+    std::vector<Key> slots_;
+    // a slot is taken if its epoch is the current one
+    std::vector<uint32_t> epochs_;
+    uint32_t epoch_ = 1;
+    size_t size_ = 0;
+};
+
+// the primary keys kept for one nq, without hashing variants or copying
+// strings: int64 keys are stored as they are, string keys as views of
+// the keys in the search results, which must outlive the next clear
+class PkDedupSet {
+ public:
+    // false if pk is in the set already
+    bool
+    insert(const milvus::PkType& pk) {
+        if (auto int_pk = std::get_if<int64_t>(&pk)) {
+            return int_pks_.insert(*int_pk);
+        }
+        auto& str_pk = std::get<std::string>(pk);
+        return str_pks_.insert(
+            {milvus::segcore::PkFingerprint(str_pk), str_pk});
+    }
+
+    void
+    clear() {
+        int_pks_.clear();
+        str_pks_.clear();
+    }
+
+ private:
+    // murmur3 finalizer, so strided keys spread over the table
+    struct Int64Hash {
+        size_t
+        operator()(int64_t key) const {
+            auto x = uint64_t(key);
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            return x;
+        }
+    };
+
+    // a string key with its fingerprint, compared first and rehashed from
+    // when the table grows
+    struct StrKey {
+        uint64_t fingerprint = 0;
+        std::string_view pk;
+
+        bool
+        operator==(const StrKey& other) const {
+            return fingerprint == other.fingerprint && pk == other.pk;
+        }
+    };
+
+    struct StrKeyHash {
+        size_t
+        operator()(const StrKey& key) const {
+            return key.fingerprint;
+        }
+    };
+
+    ReusableHashSet<int64_t, Int64Hash> int_pks_;
+    ReusableHashSet<StrKey, StrKeyHash> str_pks_;
+};
@@ -11,13 +11,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <utility>
+#include <vector>
 #include <tbb/concurrent_hash_map.h>
 
+#include "common/Consts.h"
 #include "common/Types.h"
 #include "exceptions/EasyAssert.h"
 #include "index/VectorIndex.h"
@@ -31,41 +35,121 @@ struct SealedIndexingEntry {
 
 using SealedIndexingEntryPtr = std::unique_ptr<SealedIndexingEntry>;
 
+// the fields of a segment are slotted by their dense offset,
+// field_id - START_USER_FIELDID; out of range ones are never ready
+inline int64_t
+field_slot(FieldId field_id, int64_t num_slots) {
+    auto slot = field_id.get() - START_USER_FIELDID;
+    return slot >= 0 && slot < num_slots ? slot : -1;
+}
+
+// per field flags, set under the lock of the segment and read without one
+class FieldReadyFlags {
+ public:
+    explicit FieldReadyFlags(int64_t num_fields)
+        : flags_(new std::atomic<bool>[num_fields]), num_fields_(num_fields) {
+        for (int64_t i = 0; i < num_fields; ++i) {
+            flags_[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void
+    set(FieldId field_id, bool flag = true) {
+        auto slot = field_slot(field_id, num_fields_);
+        AssertInfo(slot >= 0, "invalid field id");
+        flags_[slot].store(flag, std::memory_order_release);
+    }
+
+    bool
+    test(FieldId field_id) const {
+        auto slot = field_slot(field_id, num_fields_);
+        return slot >= 0 && flags_[slot].load(std::memory_order_acquire);
+    }
+
+ private:
+    std::unique_ptr<std::atomic<bool>[]> flags_;
+    int64_t num_fields_;
+};
+
+// entries are published to searches through an atomic slot per field, so
+// lookups take no lock; writers serialize on mutex_. as before, an entry
+// replaced or dropped is freed at once, the segment is not searched on a
+// field being dropped
 struct SealedIndexingRecord {
+    explicit SealedIndexingRecord(int64_t num_fields = 0)
+        : slots_(new std::atomic<SealedIndexingEntry*>[num_fields]),
+          entries_(num_fields),
+          num_slots_(num_fields) {
+        for (int64_t i = 0; i < num_fields; ++i) {
+            slots_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
     void
     append_field_indexing(FieldId field_id,
                           const MetricType& metric_type,
                           index::IndexBasePtr indexing) {
+        auto slot = field_slot(field_id, num_slots_);
+        AssertInfo(slot >= 0, "invalid field id");
         auto ptr = std::make_unique<SealedIndexingEntry>();
         ptr->indexing_ = std::move(indexing);
         ptr->metric_type_ = metric_type;
-        std::unique_lock lck(mutex_);
-        field_indexings_[field_id] = std::move(ptr);
+        std::lock_guard lck(mutex_);
+        slots_[slot].store(ptr.get(), std::memory_order_release);
+        entries_[slot] = std::move(ptr);
     }
 
     const SealedIndexingEntry*
     get_field_indexing(FieldId field_id) const {
-        std::shared_lock lck(mutex_);
-        AssertInfo(field_indexings_.count(field_id), "field_id not found");
-        return field_indexings_.at(field_id).get();
+        auto entry = lookup(field_id);
+        AssertInfo(entry != nullptr, "field_id not found");
+        return entry;
     }
 
     void
     drop_field_indexing(FieldId field_id) {
-        std::unique_lock lck(mutex_);
-        field_indexings_.erase(field_id);
+        auto slot = field_slot(field_id, num_slots_);
+        if (slot < 0) {
+            return;
+        }
+        std::lock_guard lck(mutex_);
+        slots_[slot].store(nullptr, std::memory_order_release);
+        entries_[slot].reset();
     }
 
     bool
     is_ready(FieldId field_id) const {
-        std::shared_lock lck(mutex_);
-        return field_indexings_.count(field_id);
+        return lookup(field_id) != nullptr;
+    }
+
+    int64_t
+    memory_usage() const {
+        std::lock_guard lck(mutex_);
+        int64_t bytes = 0;
+        for (auto& entry : entries_) {
+            if (entry != nullptr) {
+                bytes += entry->indexing_->MemoryUsage();
+            }
+        }
+        return bytes;
+    }
+
+ private:
+    const SealedIndexingEntry*
+    lookup(FieldId field_id) const {
+        auto slot = field_slot(field_id, num_slots_);
+        if (slot < 0) {
+            return nullptr;
+        }
+        return slots_[slot].load(std::memory_order_acquire);
     }
 
  private:
-    // field_offset -> SealedIndexingEntry
-    std::unordered_map<FieldId, SealedIndexingEntryPtr> field_indexings_;
-    mutable std::shared_mutex mutex_;
+    std::unique_ptr<std::atomic<SealedIndexingEntry*>[]> slots_;
+    // owns what slots_ points to, by slot
+    std::vector<SealedIndexingEntryPtr> entries_;
+    int64_t num_slots_;
+    mutable std::mutex mutex_;
 };
 
 }  // namespace milvus::segcore
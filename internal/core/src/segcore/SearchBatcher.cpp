@@ -0,0 +1,150 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <cstring>
+
+#include "segcore/SearchBatcher.h"
+
+namespace milvus::segcore {
+
+int64_t
+SearchBatcher::TopkBucket(int64_t topk) {
+    int64_t bucket = 1;
+    while (bucket < topk) {
+        bucket *= 2;
+    }
+    return bucket;
+}
+
+bool
+SearchBatcher::SameBitset(const BitsetView& x, const BitsetView& y) {
+    if (x.size() != y.size()) {
+        return false;
+    }
+    if (x.empty() || x.data() == y.data()) {
+        return true;
+    }
+    return std::memcmp(x.data(), y.data(), (x.size() + 7) / 8) == 0;
+}
+
+void
+SearchBatcher::Search(const std::string& key,
+                      int64_t topk,
+                      const void* query_data,
+                      int64_t num_queries,
+                      int64_t query_bytes,
+                      const BitsetView& bitset,
+                      const SearchFunc& search,
+                      SearchResult& output) {
+    if (window_.count() <= 0 || num_queries >= max_queries_) {
+        search(query_data, num_queries, topk, output);
+        return;
+    }
+
+    std::unique_lock lck(mutex_);
+    for (auto& batch : open_) {
+        if (batch->key != key || batch->query_bytes != query_bytes ||
+            batch->num_queries + num_queries > max_queries_ ||
+            !SameBitset(batch->bitset, bitset)) {
+            continue;
+        }
+        // follow: the leader searches for us
+        auto joined = batch;
+        joined->requests.push_back({query_data, num_queries, topk, &output});
+        joined->num_queries += num_queries;
+        if (joined->num_queries >= max_queries_) {
+            joined->full.notify_one();
+        }
+        joined->finished.wait(lck, [&joined] { return joined->done; });
+        if (joined->error) {
+            std::rethrow_exception(joined->error);
+        }
+        return;
+    }
+
+    // lead: wait for followers, then close the batch and search
+    auto batch = std::make_shared<Batch>();
+    batch->key = key;
+    batch->bitset = bitset;
+    batch->query_bytes = query_bytes;
+    batch->num_queries = num_queries;
+    batch->requests.push_back({query_data, num_queries, topk, &output});
+    open_.push_back(batch);
+    batch->full.wait_for(lck, window_, [this, &batch] {
+        return batch->num_queries >= max_queries_;
+    });
+    open_.remove(batch);
+    lck.unlock();
+
+    try {
+        Run(*batch, search);
+    } catch (...) {
+        batch->error = std::current_exception();
+    }
+
+    lck.lock();
+    batch->done = true;
+    batch->finished.notify_all();
+    lck.unlock();
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+void
+SearchBatcher::Run(Batch& batch, const SearchFunc& search) {
+    auto& requests = batch.requests;
+    if (requests.size() == 1) {
+        auto& request = requests.front();
+        search(request.query_data,
+               request.num_queries,
+               request.topk,
+               *request.output);
+        return;
+    }
+
+    int64_t topk = 0;
+    std::vector<char> queries(batch.num_queries * batch.query_bytes);
+    auto dst = queries.data();
+    for (auto& request : requests) {
+        topk = std::max(topk, request.topk);
+        auto bytes = request.num_queries * batch.query_bytes;
+        std::memcpy(dst, request.query_data, bytes);
+        dst += bytes;
+    }
+
+    SearchResult result;
+    search(queries.data(), batch.num_queries, topk, result);
+
+    // every query keeps the first topk of its own
+    int64_t query_offset = 0;
+    for (auto& request : requests) {
+        auto& output = *request.output;
+        output.total_nq_ = request.num_queries;
+        output.unity_topK_ = request.topk;
+        output.seg_offsets_.resize(request.num_queries * request.topk);
+        output.distances_.resize(request.num_queries * request.topk);
+        for (int64_t i = 0; i < request.num_queries; ++i) {
+            auto src = (query_offset + i) * topk;
+            auto dst = i * request.topk;
+            std::copy_n(result.seg_offsets_.data() + src,
+                        request.topk,
+                        output.seg_offsets_.data() + dst);
+            std::copy_n(result.distances_.data() + src,
+                        request.topk,
+                        output.distances_.data() + dst);
+        }
+        query_offset += request.num_queries;
+    }
+}
+
+}  // namespace milvus::segcore
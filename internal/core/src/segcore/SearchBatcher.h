@@ -0,0 +1,102 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/BitsetView.h"
+#include "common/QueryResult.h"
+
+namespace milvus::segcore {
+
+// Coalesces the concurrent searches of one segment. The first search of
+// a key opens a batch and waits up to the window for more; searches of
+// the same key and the same filter bitset arriving meanwhile join it.
+// The leader then runs one search over all the queries with the largest
+// topk of the batch and hands every caller its own slice of the result.
+// The key must cover everything but the queries and the topk that
+// changes the result: field, metric, params and a topk bucket.
+class SearchBatcher {
+ public:
+    // search(queries, num_queries, topk, result) runs one search
+    using SearchFunc = std::function<void(
+        const void*, int64_t, int64_t, SearchResult&)>;
+
+    // a window of zero runs every search on its own
+    SearchBatcher(std::chrono::microseconds window, int64_t max_queries)
+        : window_(window), max_queries_(max_queries) {
+    }
+
+    SearchBatcher(const SearchBatcher&) = delete;
+    SearchBatcher&
+    operator=(const SearchBatcher&) = delete;
+
+    // query_bytes is the size of one query
+    void
+    Search(const std::string& key,
+           int64_t topk,
+           const void* query_data,
+           int64_t num_queries,
+           int64_t query_bytes,
+           const BitsetView& bitset,
+           const SearchFunc& search,
+           SearchResult& output);
+
+    // topk rounded up to a power of two, for keys
+    static int64_t
+    TopkBucket(int64_t topk);
+
+ private:
+    struct Request {
+        const void* query_data;
+        int64_t num_queries;
+        int64_t topk;
+        SearchResult* output;
+    };
+
+    struct Batch {
+        std::string key;
+        BitsetView bitset;
+        int64_t query_bytes;
+        int64_t num_queries = 0;
+        std::vector<Request> requests;
+        bool done = false;
+        std::exception_ptr error;
+        // the leader waits on full, the others on finished
+        std::condition_variable full;
+        std::condition_variable finished;
+    };
+
+    static bool
+    SameBitset(const BitsetView& x, const BitsetView& y);
+
+    // searches the closed batch and fills the outputs of its requests
+    static void
+    Run(Batch& batch, const SearchFunc& search);
+
+ private:
+    const std::chrono::microseconds window_;
+    const int64_t max_queries_;
+    std::mutex mutex_;
+    // batches still taking searches
+    std::list<std::shared_ptr<Batch>> open_;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,141 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/QueryResult.h"
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// the hits of a search of one segment, before any output field is filled
+struct CachedSearch {
+    int64_t total_nq = 0;
+    int64_t unity_topk = 0;
+    std::vector<float> distances;
+    std::vector<int64_t> seg_offsets;
+    std::vector<PkType> group_by_values;
+    SearchStrategy search_strategy = SearchStrategy::Index;
+    int64_t filtered_rows = 0;
+    // the deletes the search saw
+    int64_t del_barrier = 0;
+};
+
+// LRU of search results of one segment, keyed by the encoding of the query
+// vectors, the predicate and the search info. Memory is accounted as the
+// hits plus the key bytes. Like FilterCache, results are invalidated as a
+// whole by Clear whenever data or indexes change; a result also holds only
+// for queries seeing the same deletes.
+class SearchCache {
+ public:
+    using Version = uint64_t;
+
+    // bumped by every Clear; a result computed under an older version
+    // may be stale and is not admitted
+    Version
+    version() const {
+        std::lock_guard lck(mutex_);
+        return version_;
+    }
+
+    std::shared_ptr<const CachedSearch>
+    Get(const std::string& key, int64_t del_barrier) {
+        std::lock_guard lck(mutex_);
+        auto iter = index_.find(key);
+        if (iter == index_.end() ||
+            iter->second->result->del_barrier != del_barrier) {
+            return nullptr;
+        }
+        lru_.splice(lru_.begin(), lru_, iter->second);
+        return iter->second->result;
+    }
+
+    // replaces the result of the key, computed under older deletes
+    void
+    Put(const std::string& key,
+        std::shared_ptr<const CachedSearch> result,
+        Version version,
+        int64_t capacity) {
+        auto bytes = static_cast<int64_t>(
+            key.size() + result->distances.size() * sizeof(float) +
+            result->seg_offsets.size() * sizeof(int64_t) +
+            result->group_by_values.size() * sizeof(PkType));
+        if (bytes > capacity) {
+            return;
+        }
+        std::lock_guard lck(mutex_);
+        if (version != version_) {
+            return;
+        }
+        if (auto iter = index_.find(key); iter != index_.end()) {
+            memory_usage_ -= iter->second->bytes;
+            auto entry = iter->second;
+            index_.erase(iter);
+            lru_.erase(entry);
+        }
+        lru_.push_front(Entry{key, std::move(result), bytes});
+        index_.emplace(lru_.front().key, lru_.begin());
+        memory_usage_ += bytes;
+        while (memory_usage_ > capacity) {
+            auto& victim = lru_.back();
+            memory_usage_ -= victim.bytes;
+            index_.erase(victim.key);
+            lru_.pop_back();
+        }
+    }
+
+    void
+    Clear() {
+        std::lock_guard lck(mutex_);
+        ++version_;
+        index_.clear();
+        lru_.clear();
+        memory_usage_ = 0;
+    }
+
+    int64_t
+    memory_usage() const {
+        std::lock_guard lck(mutex_);
+        return memory_usage_;
+    }
+
+    int64_t
+    size() const {
+        std::lock_guard lck(mutex_);
+        return index_.size();
+    }
+
+ private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const CachedSearch> result;
+        int64_t bytes;
+    };
+
+    mutable std::mutex mutex_;
+    // most recently used first
+    std::list<Entry> lru_;
+    // keys view the keys owned by lru_
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    int64_t memory_usage_ = 0;
+    Version version_ = 0;
+};
+
+}  // namespace milvus::segcore
@@ -0,0 +1,60 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/SearchIterator.h"
+
+namespace milvus::segcore {
+
+int64_t
+SearchIteratorCache::Add(std::shared_ptr<SearchIterator> iterator) {
+    auto now = Clock::now();
+    std::lock_guard lck(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.expire <= now) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    auto handle = next_handle_++;
+    entries_.emplace(handle, Entry{std::move(iterator), now + ttl_});
+    return handle;
+}
+
+std::shared_ptr<SearchIterator>
+SearchIteratorCache::Get(int64_t handle) {
+    auto now = Clock::now();
+    std::lock_guard lck(mutex_);
+    auto it = entries_.find(handle);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+    if (it->second.expire <= now) {
+        entries_.erase(it);
+        return nullptr;
+    }
+    it->second.expire = now + ttl_;
+    return it->second.iterator;
+}
+
+void
+SearchIteratorCache::Remove(int64_t handle) {
+    std::lock_guard lck(mutex_);
+    entries_.erase(handle);
+}
+
+size_t
+SearchIteratorCache::size() const {
+    std::lock_guard lck(mutex_);
+    return entries_.size();
+}
+
+}  // namespace milvus::segcore
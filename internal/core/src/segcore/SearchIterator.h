@@ -0,0 +1,90 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/QueryInfo.h"
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// State of a paged search of one segment: its queries and filter, and
+// the candidates fetched so far. Pages are cut from the candidates; once
+// they run out the search is repeated over the kept filter for at least
+// twice as many, so n pages cost O(log n) searches and no predicate.
+struct SearchIterator {
+    // topk_ is the number of candidates fetched per query
+    SearchInfo search_info;
+    // shared with the placeholder group rather than copied
+    const char* queries = nullptr;
+    std::shared_ptr<const void> queries_holder;
+    int64_t num_queries = 0;
+    Timestamp timestamp = 0;
+    BitsetType filter;
+
+    // num_queries rows of topk_ candidates, best first, padded with
+    // INVALID_SEG_OFFSET
+    std::vector<int64_t> seg_offsets;
+    std::vector<float> distances;
+    // candidates per query handed out in pages
+    int64_t returned = 0;
+    // no candidates beyond the fetched ones
+    bool exhausted = false;
+
+    std::mutex mutex;
+};
+
+// the open search iterators of a segment by handle
+class SearchIteratorCache {
+ public:
+    explicit SearchIteratorCache(std::chrono::milliseconds ttl) : ttl_(ttl) {
+    }
+
+    SearchIteratorCache(const SearchIteratorCache&) = delete;
+    SearchIteratorCache&
+    operator=(const SearchIteratorCache&) = delete;
+
+    // returns the handle of iterator, dropping the expired ones
+    int64_t
+    Add(std::shared_ptr<SearchIterator> iterator);
+
+    // nullptr if handle is closed or expired, otherwise restarts its ttl
+    std::shared_ptr<SearchIterator>
+    Get(int64_t handle);
+
+    void
+    Remove(int64_t handle);
+
+    size_t
+    size() const;
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::shared_ptr<SearchIterator> iterator;
+        Clock::time_point expire;
+    };
+
+    const std::chrono::milliseconds ttl_;
+    mutable std::mutex mutex_;
+    int64_t next_handle_ = 1;
+    std::unordered_map<int64_t, Entry> entries_;
+};
+
+}  // namespace milvus::segcore
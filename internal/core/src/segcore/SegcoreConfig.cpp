@@ -9,6 +9,9 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <functional>
+#include <vector>
+
 #include "common/Schema.h"
 #include "SegcoreConfig.h"
 #include "utils/Json.h"
@@ -42,6 +45,133 @@ apply_parser(const YAML::Node& node, Func func) {
     return results;
 }
 
+namespace {
+
+// a setting SegcoreConfig::update takes, by name
+struct RuntimeSetting {
+    const char* name;
+    std::function<void(SegcoreConfig&, const nlohmann::json&)> set;
+    std::function<nlohmann::json(const SegcoreConfig&)> get;
+};
+
+template <typename T>
+RuntimeSetting
+MakeSetting(const char* name,
+            void (SegcoreConfig::*set)(T),
+            T (SegcoreConfig::*get)() const) {
+    return {name,
+            [=](SegcoreConfig& config, const nlohmann::json& value) {
+                (config.*set)(value.get<T>());
+            },
+            [=](const SegcoreConfig& config) {
+                return nlohmann::json((config.*get)());
+            }};
+}
+
+const std::vector<RuntimeSetting>&
+RuntimeSettings() {
+    using C = SegcoreConfig;
+    static const std::vector<RuntimeSetting> settings = {
+        MakeSetting("expr_parallel_rows",
+                    &C::set_expr_parallel_rows,
+                    &C::get_expr_parallel_rows),
+        MakeSetting("filter_cache_bytes",
+                    &C::set_filter_cache_bytes,
+                    &C::get_filter_cache_bytes),
+        MakeSetting("lazy_field_cache_bytes",
+                    &C::set_lazy_field_cache_bytes,
+                    &C::get_lazy_field_cache_bytes),
+        MakeSetting("search_cache_bytes",
+                    &C::set_search_cache_bytes,
+                    &C::get_search_cache_bytes),
+        MakeSetting("scratch_wait_ms",
+                    &C::set_scratch_wait_ms,
+                    &C::get_scratch_wait_ms),
+        MakeSetting("fused_filters",
+                    &C::set_fused_filters,
+                    &C::get_fused_filters),
+        MakeSetting("growing_search_parallelism",
+                    &C::set_growing_search_parallelism,
+                    &C::get_growing_search_parallelism),
+        MakeSetting("sealed_search_parallelism",
+                    &C::set_sealed_search_parallelism,
+                    &C::get_sealed_search_parallelism),
+        MakeSetting("sealed_search_block_bytes",
+                    &C::set_sealed_search_block_bytes,
+                    &C::get_sealed_search_block_bytes),
+        MakeSetting("reduce_parallelism",
+                    &C::set_reduce_parallelism,
+                    &C::get_reduce_parallelism),
+        MakeSetting("segment_search_parallelism",
+                    &C::set_segment_search_parallelism,
+                    &C::get_segment_search_parallelism),
+        MakeSetting("reduce_stream_rows",
+                    &C::set_reduce_stream_rows,
+                    &C::get_reduce_stream_rows),
+        MakeSetting("search_batch_max_queries",
+                    &C::set_search_batch_max_queries,
+                    &C::get_search_batch_max_queries),
+        MakeSetting("prefilter_selectivity",
+                    &C::set_prefilter_selectivity,
+                    &C::get_prefilter_selectivity),
+        MakeSetting("filtered_search_budget_ms",
+                    &C::set_filtered_search_budget_ms,
+                    &C::get_filtered_search_budget_ms),
+        MakeSetting("query_scheduler_slots",
+                    &C::set_query_scheduler_slots,
+                    &C::get_query_scheduler_slots),
+        MakeSetting("query_slice_nq",
+                    &C::set_query_slice_nq,
+                    &C::get_query_slice_nq),
+        MakeSetting("growing_sq8_refine_ratio",
+                    &C::set_growing_sq8_refine_ratio,
+                    &C::get_growing_sq8_refine_ratio),
+        MakeSetting("nlist", &C::set_nlist, &C::get_nlist),
+        MakeSetting("nprobe", &C::set_nprobe, &C::get_nprobe),
+    };
+    return settings;
+}
+
+const RuntimeSetting&
+FindRuntimeSetting(const std::string& name) {
+    for (auto& setting : RuntimeSettings()) {
+        if (name == setting.name) {
+            return setting;
+        }
+    }
+    PanicInfo("unknown runtime setting " + name);
+}
+
+}  // namespace
+
+void
+SegcoreConfig::update(const nlohmann::json& settings) {
+    AssertInfo(settings.is_object(), "runtime settings must be an object");
+    // set on a copy first, so a bad value sets none of them
+    auto checked = *this;
+    for (auto& [name, value] : settings.items()) {
+        auto& setting = FindRuntimeSetting(name);
+        try {
+            setting.set(checked, value);
+        } catch (const nlohmann::json::exception& e) {
+            PanicInfo("invalid value of runtime setting " + name + ": " +
+                      e.what());
+        }
+    }
+    for (auto& [name, value] : settings.items()) {
+        FindRuntimeSetting(name).set(*this, value);
+    }
+}
+
+nlohmann::json
+SegcoreConfig::runtime_settings() const {
+    auto json = nlohmann::json::object();
+    for (auto& setting : RuntimeSettings()) {
+        json[setting.name] = setting.get(*this);
+    }
+    return json;
+}
+
 void
 SegcoreConfig::parse_from(const std::string& config_path) {
     try {
@@ -11,15 +11,57 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <string>
+#include <thread>
 
+#include "common/FieldMeta.h"
 #include "common/Types.h"
 #include "exceptions/EasyAssert.h"
+#include "segcore/GrowingGraphIndex.h"
 #include "utils/Json.h"
 
 namespace milvus::segcore {
 
+// a setting read on hot paths and updated at runtime, see
+// SegcoreConfig::update; loads and stores are relaxed, a reader sees the
+// old value or the new one. copied along with the config
+template <typename T>
+class Tunable {
+ public:
+    Tunable(T value) : value_(value) {
+    }
+
+    Tunable(const Tunable& other) : value_(other.get()) {
+    }
+
+    Tunable&
+    operator=(const Tunable& other) {
+        value_.store(other.get(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    Tunable&
+    operator=(T value) {
+        value_.store(value, std::memory_order_relaxed);
+        return *this;
+    }
+
+    T
+    get() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+    operator T() const {
+        return get();
+    }
+
+ private:
+    std::atomic<T> value_;
+};
+
 struct SmallIndexConf {
     std::string index_type;
     nlohmann::json build_params;
@@ -31,8 +73,8 @@ class SegcoreConfig {
     SegcoreConfig() {
         // hard code configurations for small index
         SmallIndexConf sub_conf;
-        sub_conf.build_params["nlist"] = std::to_string(nlist_);
-        sub_conf.search_params["nprobe"] = nprobe_;
+        sub_conf.build_params["nlist"] = std::to_string(nlist_.get());
+        sub_conf.search_params["nprobe"] = nprobe_.get();
         sub_conf.index_type = "IVF";
         table_[knowhere::metric::L2] = sub_conf;
         table_[knowhere::metric::IP] = sub_conf;
@@ -49,6 +91,17 @@ class SegcoreConfig {
     void
     parse_from(const std::string& string_path);
 
+    // sets the runtime settings of a json object by their names, e.g.
+    // {"reduce_parallelism": 2, "nprobe": 16}, all checked before any is
+    // set; hot paths pick them up at their next read. the settings read
+    // when a segment or pool is created apply to the later ones only
+    void
+    update(const nlohmann::json& settings);
+
+    // the runtime settings by their names
+    nlohmann::json
+    runtime_settings() const;
+
     const SmallIndexConf&
     at(const MetricType& metric_type) const {
         Assert(table_.count(metric_type));
@@ -65,13 +118,486 @@ class SegcoreConfig {
         chunk_rows_ = chunk_rows;
     }
 
+    // rows per chunk of a field of a growing segment
+    int64_t
+    get_chunk_rows(const FieldMeta& field_meta) const {
+        return FieldChunkRows(field_meta, chunk_rows_, vector_chunk_bytes_);
+    }
+
+    // chunk_rows, or for a vector field with a byte budget the rows of
+    // the budget, a multiple of 64 of at least min_vector_chunk_rows
+    static int64_t
+    FieldChunkRows(const FieldMeta& field_meta,
+                   int64_t chunk_rows,
+                   int64_t vector_chunk_bytes) {
+        if (!field_meta.is_vector() || vector_chunk_bytes <= 0) {
+            return chunk_rows;
+        }
+        auto rows = vector_chunk_bytes / field_meta.get_sizeof();
+        rows = std::max(rows - rows % 64, min_vector_chunk_rows);
+        return std::min(rows, chunk_rows);
+    }
+
+    int64_t
+    get_vector_chunk_bytes() const {
+        return vector_chunk_bytes_;
+    }
+
+    // bytes a chunk of a vector field of a growing segment aims at, so
+    // that wide vectors are built and scanned in smaller chunks; 0 gives
+    // vector fields chunk_rows rows like the others
+    void
+    set_vector_chunk_bytes(int64_t vector_chunk_bytes) {
+        vector_chunk_bytes_ = vector_chunk_bytes;
+    }
+
+    int64_t
+    get_expr_parallel_rows() const {
+        return expr_parallel_rows_;
+    }
+
+    // chunks of at least this many rows are filtered by several threads
+    void
+    set_expr_parallel_rows(int64_t expr_parallel_rows) {
+        expr_parallel_rows_ = expr_parallel_rows;
+    }
+
+    int64_t
+    get_filter_cache_bytes() const {
+        return filter_cache_bytes_;
+    }
+
+    // budget of the predicate result cache of each sealed segment, 0 to
+    // disable it
+    void
+    set_filter_cache_bytes(int64_t filter_cache_bytes) {
+        filter_cache_bytes_ = filter_cache_bytes;
+    }
+
+    int64_t
+    get_search_cache_bytes() const {
+        return search_cache_bytes_;
+    }
+
+    // budget of the search result cache of each sealed segment, 0 to
+    // disable it
+    void
+    set_search_cache_bytes(int64_t search_cache_bytes) {
+        search_cache_bytes_ = search_cache_bytes;
+    }
+
+    int64_t
+    get_plan_cache_size() const {
+        return plan_cache_size_;
+    }
+
+    // plans parsed from serialized plan nodes kept by each collection, for
+    // search and retrieve each; 0 parses every plan
+    void
+    set_plan_cache_size(int64_t plan_cache_size) {
+        plan_cache_size_ = plan_cache_size;
+    }
+
+    int64_t
+    get_chunk_pool_bytes() const {
+        return chunk_pool_bytes_;
+    }
+
+    // chunk memory of released segments kept for new ones
+    void
+    set_chunk_pool_bytes(int64_t chunk_pool_bytes) {
+        chunk_pool_bytes_ = chunk_pool_bytes;
+    }
+
+    bool
+    get_huge_page_chunks() const {
+        return huge_page_chunks_;
+    }
+
+    // advise chunks of 2MB and more for transparent huge pages
+    void
+    set_huge_page_chunks(bool huge_page_chunks) {
+        huge_page_chunks_ = huge_page_chunks;
+    }
+
+    bool
+    get_sealed_column_encoding() const {
+        return sealed_column_encoding_;
+    }
+
+    // sealed int32 and int64 fields loaded into memory are kept bit packed
+    // and varchar fields dictionary encoded when that halves them at
+    // least, decoded as they are read
+    void
+    set_sealed_column_encoding(bool sealed_column_encoding) {
+        sealed_column_encoding_ = sealed_column_encoding;
+    }
+
+    int64_t
+    get_sealed_chunk_rows() const {
+        return sealed_chunk_rows_;
+    }
+
+    // the fields of the sealed segments created from then on are split
+    // into row groups of chunk_rows, a multiple of 64 and best the rows of
+    // a binlog, each a chunk to expression evaluation with its own zone
+    // maps; their int and varchar columns are not encoded. 0 keeps a
+    // segment one chunk
+    void
+    set_sealed_chunk_rows(int64_t chunk_rows) {
+        AssertInfo(chunk_rows >= 0 && chunk_rows % 64 == 0,
+                   "sealed chunk rows must be a multiple of 64");
+        sealed_chunk_rows_ = chunk_rows;
+    }
+
+    bool
+    get_fused_filters() const {
+        return fused_filters_;
+    }
+
+    // ANDs of range predicates on numeric fields with raw data evaluate
+    // all their leaves in one pass over the rows
+    void
+    set_fused_filters(bool fused_filters) {
+        fused_filters_ = fused_filters;
+    }
+
+    const std::string&
+    get_sealed_vector_storage() const {
+        return sealed_vector_storage_;
+    }
+
+    // sealed float vector fields loaded into memory are kept as "FLOAT",
+    // or halved to "FLOAT16" or "BFLOAT16", which brute force searches
+    // directly and retrieval widens back, or losslessly "COMPRESSED" in
+    // blocks that retrieval and brute force decode as they go
+    void
+    set_sealed_vector_storage(const std::string& sealed_vector_storage) {
+        AssertInfo(sealed_vector_storage == "FLOAT" ||
+                       sealed_vector_storage == "FLOAT16" ||
+                       sealed_vector_storage == "BFLOAT16" ||
+                       sealed_vector_storage == "COMPRESSED",
+                   "unknown sealed vector storage " + sealed_vector_storage);
+        sealed_vector_storage_ = sealed_vector_storage;
+    }
+
+    int64_t
+    get_column_cache_bytes() const {
+        return column_cache_bytes_;
+    }
+
+    // budget of the local cache of the sealed columns loaded with mmap,
+    // kept under their mmap dir across reloads and restarts; 0 disables it
+    void
+    set_column_cache_bytes(int64_t column_cache_bytes) {
+        column_cache_bytes_ = column_cache_bytes;
+    }
+
+    const std::string&
+    get_shared_column_dir() const {
+        return shared_column_dir_;
+    }
+
+    int64_t
+    get_shared_column_bytes() const {
+        return shared_column_bytes_;
+    }
+
+    // the fixed width columns loaded into memory are kept in files under
+    // dir, on a tmpfs such as /dev/shm, and mapped from there; the query
+    // nodes of a host sharing dir map the same pages for a segment they
+    // all load. bytes bounds the files of dir, 0 disables it
+    void
+    set_shared_column_dir(const std::string& dir, int64_t bytes) {
+        shared_column_dir_ = dir;
+        shared_column_bytes_ = bytes;
+    }
+
+    int64_t
+    get_lazy_field_cache_bytes() const {
+        return lazy_field_cache_bytes_;
+    }
+
+    // the decoded row groups each lazy field keeps, see LazyField.h
+    void
+    set_lazy_field_cache_bytes(int64_t bytes) {
+        lazy_field_cache_bytes_ = bytes;
+    }
+
+    const std::string&
+    get_load_fallback_mmap_dir() const {
+        return load_fallback_mmap_dir_;
+    }
+
+    // fields and scalar indexes the load budget has no room for get
+    // mapped from files under it instead, empty fails their load
+    void
+    set_load_fallback_mmap_dir(const std::string& load_fallback_mmap_dir) {
+        load_fallback_mmap_dir_ = load_fallback_mmap_dir;
+    }
+
+    int64_t
+    get_scratch_wait_ms() const {
+        return scratch_wait_ms_;
+    }
+
+    // how long a request queues for the scratch budget before it fails
+    void
+    set_scratch_wait_ms(int64_t scratch_wait_ms) {
+        scratch_wait_ms_ = scratch_wait_ms;
+    }
+
+    int64_t
+    get_small_index_build_threads() const {
+        return small_index_build_threads_;
+    }
+
+    // builders of the small indexes of growing segments, 0 to build them
+    // on the inserting thread; read once, at the first build
+    void
+    set_small_index_build_threads(int64_t small_index_build_threads) {
+        small_index_build_threads_ = small_index_build_threads;
+    }
+
+    int64_t
+    get_small_index_build_queue() const {
+        return small_index_build_queue_;
+    }
+
+    // builds waiting for the builders, past it inserts build their own
+    void
+    set_small_index_build_queue(int64_t small_index_build_queue) {
+        small_index_build_queue_ = small_index_build_queue;
+    }
+
+    int64_t
+    get_growing_search_parallelism() const {
+        return growing_search_parallelism_;
+    }
+
+    // threads searching the chunks of one growing segment at a time, the
+    // searching thread included; 1 to search them sequentially
+    void
+    set_growing_search_parallelism(int64_t growing_search_parallelism) {
+        growing_search_parallelism_ = growing_search_parallelism;
+    }
+
+    int64_t
+    get_sealed_search_parallelism() const {
+        return sealed_search_parallelism_;
+    }
+
+    // threads brute forcing the rows of one sealed segment without an
+    // index, the searching thread included; 1 to search sequentially
+    void
+    set_sealed_search_parallelism(int64_t sealed_search_parallelism) {
+        sealed_search_parallelism_ = sealed_search_parallelism;
+    }
+
+    int64_t
+    get_sealed_search_block_bytes() const {
+        return sealed_search_block_bytes_;
+    }
+
+    // bytes of vectors one task of such a search scans, about a core's L2
+    // cache so the rows stay there while all queries pass over them
+    void
+    set_sealed_search_block_bytes(int64_t sealed_search_block_bytes) {
+        sealed_search_block_bytes_ = sealed_search_block_bytes;
+    }
+
+    int64_t
+    get_reduce_parallelism() const {
+        return reduce_parallelism_;
+    }
+
+    // threads reducing the results of one request across segments, the
+    // reducing thread included; 1 to reduce sequentially
+    void
+    set_reduce_parallelism(int64_t reduce_parallelism) {
+        reduce_parallelism_ = reduce_parallelism;
+    }
+
+    int64_t
+    get_segment_search_parallelism() const {
+        return segment_search_parallelism_;
+    }
+
+    // threads searching the segments of one SearchSegmentsAndReduce call,
+    // the calling thread included
+    void
+    set_segment_search_parallelism(int64_t segment_search_parallelism) {
+        segment_search_parallelism_ = segment_search_parallelism;
+    }
+
+    int64_t
+    get_reduce_stream_rows() const {
+        return reduce_stream_rows_;
+    }
+
+    // rows of the search results of a request from which reduce emits one
+    // slice at a time, fetching output fields per slice; 0 never streams
+    void
+    set_reduce_stream_rows(int64_t reduce_stream_rows) {
+        reduce_stream_rows_ = reduce_stream_rows;
+    }
+
+    int64_t
+    get_search_batch_window_us() const {
+        return search_batch_window_us_;
+    }
+
+    // how long a search of a sealed index waits for concurrent ones to
+    // run with it, 0 to search every request on its own; read when a
+    // segment is created
+    void
+    set_search_batch_window_us(int64_t search_batch_window_us) {
+        search_batch_window_us_ = search_batch_window_us;
+    }
+
+    int64_t
+    get_search_batch_max_queries() const {
+        return search_batch_max_queries_;
+    }
+
+    // a batch is searched as soon as it holds this many queries
+    void
+    set_search_batch_max_queries(int64_t search_batch_max_queries) {
+        search_batch_max_queries_ = search_batch_max_queries;
+    }
+
+    int64_t
+    get_search_iterator_ttl_ms() const {
+        return search_iterator_ttl_ms_;
+    }
+
+    // how long a paged search keeps its candidates after its last page;
+    // read when a segment is created
+    void
+    set_search_iterator_ttl_ms(int64_t search_iterator_ttl_ms) {
+        search_iterator_ttl_ms_ = search_iterator_ttl_ms;
+    }
+
+    double
+    get_prefilter_selectivity() const {
+        return prefilter_selectivity_;
+    }
+
+    // a search whose filter leaves less than this share of the rows brute
+    // forces the rows left instead of searching around the filtered ones
+    void
+    set_prefilter_selectivity(double prefilter_selectivity) {
+        AssertInfo(prefilter_selectivity >= 0 && prefilter_selectivity <= 1,
+                   "prefilter selectivity must be in [0, 1]");
+        prefilter_selectivity_ = prefilter_selectivity;
+    }
+
+    int64_t
+    get_filtered_search_budget_ms() const {
+        return filtered_search_budget_ms_;
+    }
+
+    // an index search returning fewer hits than topk for the rows its
+    // filter left is searched again wider for that long at most, then by
+    // brute force over those rows; 0 takes the hits as they are
+    void
+    set_filtered_search_budget_ms(int64_t filtered_search_budget_ms) {
+        AssertInfo(filtered_search_budget_ms >= 0,
+                   "filtered search budget must not be negative");
+        filtered_search_budget_ms_ = filtered_search_budget_ms;
+    }
+
+    int64_t
+    get_query_scheduler_slots() const {
+        return query_scheduler_slots_;
+    }
+
+    // vector searches running at once, the others queue in weighted fair
+    // order of their tenants; 0 runs all of them at once
+    void
+    set_query_scheduler_slots(int64_t query_scheduler_slots) {
+        AssertInfo(query_scheduler_slots >= 0,
+                   "query scheduler slots must not be negative");
+        query_scheduler_slots_ = query_scheduler_slots;
+    }
+
+    int64_t
+    get_query_slice_nq() const {
+        return query_slice_nq_;
+    }
+
+    // a search of more queries queues for each slice of this many, so
+    // the small ones get their turns in between
+    void
+    set_query_slice_nq(int64_t query_slice_nq) {
+        AssertInfo(query_slice_nq > 0, "query slice nq must be positive");
+        query_slice_nq_ = query_slice_nq;
+    }
+
+    int64_t
+    get_growing_sq8_refine_ratio() const {
+        return growing_sq8_refine_ratio_;
+    }
+
+    // complete chunks of growing float vectors get an 8-bit copy, which a
+    // brute force search scans before re-ranking topk times this many rows
+    // on the float vectors; 0 scans the float vectors only
+    void
+    set_growing_sq8_refine_ratio(int64_t growing_sq8_refine_ratio) {
+        AssertInfo(growing_sq8_refine_ratio >= 0,
+                   "sq8 refine ratio must not be negative");
+        growing_sq8_refine_ratio_ = growing_sq8_refine_ratio;
+    }
+
+    const std::string&
+    get_growing_index_type() const {
+        return growing_index_type_;
+    }
+
+    // "IVF" for a small index per chunk, "HNSW" for one graph per vector
+    // field of L2 or IP metric, extended as rows are acked, "IVF_SHARED"
+    // for inverted lists per chunk of float vectors of L2 or IP metric over
+    // nlist centroids trained once per collection and field
+    void
+    set_growing_index_type(const std::string& growing_index_type) {
+        AssertInfo(growing_index_type == "IVF" ||
+                       growing_index_type == "HNSW" ||
+                       growing_index_type == "IVF_SHARED",
+                   "unknown growing index type " + growing_index_type);
+        growing_index_type_ = growing_index_type;
+    }
+
+    const GraphIndexConf&
+    get_graph_index_config() const {
+        return graph_index_conf_;
+    }
+
+    void
+    set_graph_index_config(const GraphIndexConf& graph_index_conf) {
+        graph_index_conf_ = graph_index_conf;
+    }
+
+    int64_t
+    get_nlist() const {
+        return nlist_;
+    }
+
+    // lists of the small indexes built from now on
     void
     set_nlist(int64_t nlist) {
+        AssertInfo(nlist > 0, "nlist must be positive");
         nlist_ = nlist;
     }
 
+    int64_t
+    get_nprobe() const {
+        return nprobe_;
+    }
+
+    // lists a search of a small index probes
     void
     set_nprobe(int64_t nprobe) {
+        AssertInfo(nprobe > 0, "nprobe must be positive");
         nprobe_ = nprobe;
     }
 
@@ -82,9 +608,48 @@ class SegcoreConfig {
     }
 
  private:
+    // the small indexes need some rows to train on
+    static constexpr int64_t min_vector_chunk_rows = 1024;
+
     int64_t chunk_rows_ = 32 * 1024;
-    int64_t nlist_ = 100;
-    int64_t nprobe_ = 4;
+    int64_t vector_chunk_bytes_ = 0;
+    Tunable<int64_t> expr_parallel_rows_ = 2 * 1024 * 1024;
+    Tunable<int64_t> filter_cache_bytes_ = 16 * 1024 * 1024;
+    Tunable<int64_t> search_cache_bytes_ = 0;
+    int64_t plan_cache_size_ = 256;
+    int64_t chunk_pool_bytes_ = 512 * 1024 * 1024;
+    bool huge_page_chunks_ = true;
+    int64_t column_cache_bytes_ = 0;
+    std::string shared_column_dir_;
+    int64_t shared_column_bytes_ = 0;
+    Tunable<int64_t> lazy_field_cache_bytes_ = 64 * 1024 * 1024;
+    std::string load_fallback_mmap_dir_;
+    Tunable<int64_t> scratch_wait_ms_ = 1000;
+    bool sealed_column_encoding_ = false;
+    int64_t sealed_chunk_rows_ = 0;
+    Tunable<bool> fused_filters_ = true;
+    std::string sealed_vector_storage_ = "FLOAT";
+    int64_t small_index_build_threads_ = 2;
+    int64_t small_index_build_queue_ = 16;
+    Tunable<int64_t> growing_search_parallelism_ = 4;
+    Tunable<int64_t> sealed_search_parallelism_ = 4;
+    Tunable<int64_t> sealed_search_block_bytes_ = 1024 * 1024;
+    Tunable<int64_t> reduce_parallelism_ = 4;
+    Tunable<int64_t> segment_search_parallelism_ = 8;
+    Tunable<int64_t> reduce_stream_rows_ = 1024 * 1024;
+    int64_t search_batch_window_us_ = 0;
+    Tunable<int64_t> search_batch_max_queries_ = 64;
+    int64_t search_iterator_ttl_ms_ = 60 * 1000;
+    Tunable<double> prefilter_selectivity_ = 0.01;
+    Tunable<int64_t> filtered_search_budget_ms_ = 100;
+    Tunable<int64_t> query_scheduler_slots_ =
+        std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+    Tunable<int64_t> query_slice_nq_ = 256;
+    Tunable<int64_t> growing_sq8_refine_ratio_ = 0;
+    std::string growing_index_type_ = "IVF";
+    GraphIndexConf graph_index_conf_;
+    Tunable<int64_t> nlist_ = 100;
+    Tunable<int64_t> nprobe_ = 4;
     std::map<knowhere::MetricType, SmallIndexConf> table_;
 };
 
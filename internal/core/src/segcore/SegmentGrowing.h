@@ -23,6 +23,14 @@
 
 namespace milvus::segcore {
 
+// one field of a columnar insert: fixed width values packed in their
+// native type, the varchar value i as data[offsets[i], offsets[i + 1])
+struct InsertColumn {
+    FieldId field_id;
+    const void* data;
+    const int64_t* offsets = nullptr;
+};
+
 class SegmentGrowing : public SegmentInternalInterface {
  public:
     virtual void
@@ -38,6 +46,15 @@ class SegmentGrowing : public SegmentInternalInterface {
            const Timestamp* timestamps,
            const InsertData* insert_data) = 0;
 
+    // the same from one column per schema field, each copied once
+    virtual void
+    InsertColumns(int64_t reserved_offset,
+                  int64_t size,
+                  const int64_t* row_ids,
+                  const Timestamp* timestamps,
+                  const InsertColumn* columns,
+                  int64_t num_columns) = 0;
+
     virtual SegmentType
     type() const override {
         return SegmentType::Growing;
@@ -12,12 +12,15 @@
 #include <algorithm>
 #include <numeric>
 #include <queue>
+#include <string_view>
 #include <thread>
-#include <boost/iterator/counting_iterator.hpp>
+#include <unordered_set>
 
 #include "common/Consts.h"
+#include "common/Metrics.h"
 #include "query/PlanNode.h"
 #include "query/SearchOnSealed.h"
+#include "segcore/Gather.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "segcore/Utils.h"
 
@@ -35,23 +38,23 @@ SegmentGrowingImpl::PreDelete(int64_t size) {
     return reserved_begin;
 }
 
-void
-SegmentGrowingImpl::mask_with_delete(BitsetType& bitset,
-                                     int64_t ins_barrier,
-                                     Timestamp timestamp) const {
+DeletedRecord::SnapshotPtr
+SegmentGrowingImpl::get_deleted_snapshot(int64_t ins_barrier,
+                                         Timestamp timestamp,
+                                         bool* cached) const {
     auto del_barrier = get_barrier(get_deleted_record(), timestamp);
     if (del_barrier == 0) {
-        return;
-    }
-    auto bitmap_holder = get_deleted_bitmap(
-        del_barrier, ins_barrier, deleted_record_, insert_record_, timestamp);
-    if (!bitmap_holder || !bitmap_holder->bitmap_ptr) {
-        return;
+        if (cached != nullptr) {
+            *cached = true;
+        }
+        return nullptr;
     }
-    auto& delete_bitset = *bitmap_holder->bitmap_ptr;
-    AssertInfo(delete_bitset.size() == bitset.size(),
-               "Deleted bitmap size not equal to filtered bitmap size");
-    bitset |= delete_bitset;
+    return get_deleted_bitmap(del_barrier,
+                              ins_barrier,
+                              deleted_record_,
+                              insert_record_,
+                              timestamp,
+                              cached);
 }
 
 void
@@ -60,17 +63,83 @@ SegmentGrowingImpl::Insert(int64_t reserved_offset,
                            const int64_t* row_ids,
                            const Timestamp* timestamps_raw,
                            const InsertData* insert_data) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(InsertLatency);
+    auto& pk_data = set_insert_data(
+        reserved_offset, size, row_ids, timestamps_raw, insert_data);
+
+    // step 4: set pks to offset
+    VisitPks(pk_data, [&](auto pks, int64_t) {
+        insert_record_.insert_pks(pks, size, reserved_offset);
+    });
+
+    // step 5: update small indexes
+    finish_insert(reserved_offset, size);
+}
+
+int64_t
+SegmentGrowingImpl::Upsert(int64_t size,
+                           const int64_t* row_ids,
+                           const Timestamp* timestamps_raw,
+                           const InsertData* insert_data) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(InsertLatency);
+    auto reserved_offset = PreInsert(size);
+    auto& pk_data = set_insert_data(
+        reserved_offset, size, row_ids, timestamps_raw, insert_data);
+
+    VisitPks(pk_data, [&](auto pks, int64_t) {
+        using Pk = std::remove_const_t<std::remove_pointer_t<decltype(pks)>>;
+        // probed before the batch is indexed, so a row finds only the
+        // rows before it
+        std::vector<bool> superseding;
+        insert_record_.may_contain_pks(pks, size, superseding);
+        std::unordered_set<Pk> batch_pks;
+        std::vector<Pk> del_pks;
+        std::vector<Timestamp> del_timestamps;
+        for (int64_t i = 0; i < size; ++i) {
+            if (!batch_pks.insert(pks[i]).second || superseding[i]) {
+                del_pks.push_back(pks[i]);
+                del_timestamps.push_back(timestamps_raw[i]);
+            }
+        }
+        insert_record_.insert_pks(pks, size, reserved_offset);
+        finish_insert(reserved_offset, size);
+
+        // the new rows outlive the deletes, of their own timestamps
+        if (!del_pks.empty()) {
+            int64_t del_size = del_pks.size();
+            deleted_record_.push(PreDelete(del_size),
+                                 del_pks.data(),
+                                 del_timestamps.data(),
+                                 del_size);
+            SEGCORE_METRIC_ADD(DeleteRows, del_size);
+        }
+    });
+    return reserved_offset;
+}
+
+const DataArray&
+SegmentGrowingImpl::set_insert_data(int64_t reserved_offset,
+                                    int64_t size,
+                                    const int64_t* row_ids,
+                                    const Timestamp* timestamps_raw,
+                                    const InsertData* insert_data) {
     AssertInfo(insert_data->num_rows() == size,
                "Entities_raw count not equal to insert size");
     //    AssertInfo(insert_data->fields_data_size() == schema_->size(),
     //               "num fields of insert data not equal to num of schema fields");
-    // step 1: check insert data if valid
-    std::unordered_map<FieldId, int64_t> field_id_to_offset;
-    int64_t field_offset = 0;
-    for (auto field : insert_data->fields_data()) {
-        auto field_id = FieldId(field.field_id());
-        AssertInfo(!field_id_to_offset.count(field_id), "duplicate field data");
-        field_id_to_offset.emplace(field_id, field_offset++);
+    // step 1: check insert data if valid, the position of the data of
+    // each field by the offset of the field in the schema
+    std::vector<int64_t> data_offsets(schema_->size(), -1);
+    for (int64_t i = 0; i < insert_data->fields_data_size(); ++i) {
+        auto field_id = FieldId(insert_data->fields_data(i).field_id());
+        auto offset = schema_->get_field_offset(field_id);
+        if (offset < 0) {
+            continue;
+        }
+        AssertInfo(data_offsets[offset] < 0, "duplicate field data");
+        data_offsets[offset] = i;
     }
 
     // step 2: sort timestamp
@@ -80,34 +149,134 @@ SegmentGrowingImpl::Insert(int64_t reserved_offset,
     insert_record_.timestamps_.set_data_raw(
         reserved_offset, timestamps_raw, size);
     insert_record_.row_ids_.set_data_raw(reserved_offset, row_ids, size);
-    for (auto [field_id, field_meta] : schema_->get_fields()) {
-        AssertInfo(field_id_to_offset.count(field_id), "Cannot find field_id");
-        auto data_offset = field_id_to_offset[field_id];
-        insert_record_.get_field_data_base(field_id)->set_data_raw(
-            reserved_offset,
-            size,
-            &insert_data->fields_data(data_offset),
-            field_meta);
+    for (int64_t offset = 0; offset < data_offsets.size(); ++offset) {
+        auto& field_meta = schema_->get_field_meta(offset);
+        AssertInfo(data_offsets[offset] >= 0, "Cannot find field_id");
+        insert_record_.get_field_data_base(field_meta.get_id())
+            ->set_data_raw(reserved_offset,
+                           size,
+                           &insert_data->fields_data(data_offsets[offset]),
+                           field_meta);
     }
 
-    // step 4: set pks to offset
     auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
     AssertInfo(field_id.get() != INVALID_FIELD_ID, "Primary key is -1");
-    std::vector<PkType> pks(size);
-    ParsePksFromFieldData(
-        pks, insert_data->fields_data(field_id_to_offset[field_id]));
-    for (int i = 0; i < size; ++i) {
-        insert_record_.insert_pk(pks[i], reserved_offset + i);
+    return insert_data->fields_data(
+        data_offsets[schema_->get_field_offset(field_id)]);
+}
+
+void
+SegmentGrowingImpl::InsertColumns(int64_t reserved_offset,
+                                  int64_t size,
+                                  const int64_t* row_ids,
+                                  const Timestamp* timestamps_raw,
+                                  const InsertColumn* columns,
+                                  int64_t num_columns) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(InsertLatency);
+    auto find_column = [&](FieldId field_id) -> const InsertColumn* {
+        for (int64_t i = 0; i < num_columns; ++i) {
+            if (columns[i].field_id == field_id) {
+                return &columns[i];
+            }
+        }
+        PanicInfo(fmt::format("Cannot find column of field {}",
+                              field_id.get()));
+    };
+
+    insert_record_.timestamps_.set_data_raw(
+        reserved_offset, timestamps_raw, size);
+    insert_record_.row_ids_.set_data_raw(reserved_offset, row_ids, size);
+
+    // varchar values are viewed in place and copied once into the chunks
+    auto string_views = [&](const InsertColumn& column) {
+        AssertInfo(column.offsets != nullptr,
+                   "varchar column without offsets");
+        auto chars = static_cast<const char*>(column.data);
+        std::vector<std::string_view> views(size);
+        for (int64_t i = 0; i < size; ++i) {
+            views[i] = std::string_view(chars + column.offsets[i],
+                                        column.offsets[i + 1] -
+                                            column.offsets[i]);
+        }
+        return views;
+    };
+    for (auto& [field_id, field_meta] : schema_->get_fields()) {
+        auto column = find_column(field_id);
+        auto field_data = insert_record_.get_field_data_base(field_id);
+        AssertInfo(!field_meta.is_sparse_vector(),
+                   "sparse vectors are inserted as field data");
+        if (field_meta.get_data_type() == DataType::VARCHAR) {
+            auto views = string_views(*column);
+            field_data->set_string_data(reserved_offset, views.data(), size);
+        } else {
+            field_data->set_data_raw(reserved_offset, column->data, size);
+        }
     }
 
-    // step 5: update small indexes
+    auto pk_field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
+    AssertInfo(pk_field_id.get() != INVALID_FIELD_ID, "Primary key is -1");
+    auto pk_column = find_column(pk_field_id);
+    switch (schema_->operator[](pk_field_id).get_data_type()) {
+        case DataType::INT64: {
+            insert_record_.insert_pks(
+                static_cast<const int64_t*>(pk_column->data),
+                size,
+                reserved_offset);
+            break;
+        }
+        case DataType::VARCHAR: {
+            auto views = string_views(*pk_column);
+            insert_record_.insert_pks(views.data(), size, reserved_offset);
+            break;
+        }
+        default: {
+            PanicInfo("unsupported primary key data type");
+        }
+    }
+
+    finish_insert(reserved_offset, size);
+}
+
+void
+SegmentGrowingImpl::finish_insert(int64_t reserved_offset, int64_t size) {
+    add_partition_keys(reserved_offset, size);
     insert_record_.ack_responder_.AddSegment(reserved_offset,
                                              reserved_offset + size);
+    auto row_ack = insert_record_.ack_responder_.GetAck();
     if (enable_small_index_) {
-        int64_t chunk_rows = segcore_config_.get_chunk_rows();
-        indexing_record_.UpdateResourceAck(
-            insert_record_.ack_responder_.GetAck() / chunk_rows,
-            insert_record_);
+        indexing_record_.UpdateResourceAck(row_ack, insert_record_);
+        indexing_record_.UpdateGraphAck(row_ack, insert_record_);
+    }
+    indexing_record_.UpdateQuantizedAck(row_ack, insert_record_);
+    SEGCORE_METRIC_ADD(InsertRows, size);
+}
+
+void
+SegmentGrowingImpl::add_partition_keys(int64_t reserved_offset,
+                                       int64_t size) {
+    if (partition_keys_ == nullptr) {
+        return;
+    }
+    auto field_id = schema_->get_partition_key_field_id().value();
+    auto end = reserved_offset + size;
+    if (schema_->operator[](field_id).get_data_type() == DataType::INT64) {
+        auto& keys = static_cast<PartitionKeys<int64_t>&>(*partition_keys_);
+        insert_record_.get_field_data<int64_t>(field_id)->for_each_span(
+            reserved_offset,
+            end,
+            [&](const int64_t* values, int64_t begin, int64_t n) {
+                keys.Add(values, n, begin);
+            });
+    } else {
+        auto& keys =
+            static_cast<PartitionKeys<std::string>&>(*partition_keys_);
+        insert_record_.get_field_data<std::string>(field_id)->for_each_span(
+            reserved_offset,
+            end,
+            [&](const std::string* values, int64_t begin, int64_t n) {
+                keys.Add(values, n, begin);
+            });
     }
 }
 
@@ -116,49 +285,44 @@ SegmentGrowingImpl::Delete(int64_t reserved_begin,
                            int64_t size,
                            const IdArray* ids,
                            const Timestamp* timestamps_raw) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(DeleteLatency);
     auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
     AssertInfo(field_id.get() != -1, "Primary key is -1");
     auto& field_meta = schema_->operator[](field_id);
-    std::vector<PkType> pks(size);
-    ParsePksFromIDs(pks, field_meta.get_data_type(), *ids);
 
-    // step 1: sort timestamp
-    std::vector<std::tuple<Timestamp, PkType>> ordering(size);
-    for (int i = 0; i < size; i++) {
-        ordering[i] = std::make_tuple(timestamps_raw[i], pks[i]);
-    }
-    std::sort(ordering.begin(), ordering.end());
-    std::vector<PkType> sort_pks(size);
-    std::vector<Timestamp> sort_timestamps(size);
-
-    for (int i = 0; i < size; i++) {
-        auto [t, pk] = ordering[i];
-        sort_timestamps[i] = t;
-        sort_pks[i] = pk;
-    }
-
-    // step 2: fill delete record
-    deleted_record_.timestamps_.set_data_raw(
-        reserved_begin, sort_timestamps.data(), size);
-    deleted_record_.pks_.set_data_raw(reserved_begin, sort_pks.data(), size);
-    deleted_record_.ack_responder_.AddSegment(reserved_begin,
-                                              reserved_begin + size);
+    // fill delete record in timestamp order
+    VisitPks(field_meta.get_data_type(), *ids, [&](auto pks, int64_t) {
+        deleted_record_.push(reserved_begin, pks, timestamps_raw, size);
+    });
+    SEGCORE_METRIC_ADD(DeleteRows, size);
     return Status::OK();
 }
 
+MemoryUsage
+SegmentGrowingImpl::GetMemoryUsage() const {
+    MemoryUsage usage;
+    insert_record_.add_memory_usage(usage);
+    deleted_record_.add_memory_usage(usage);
+    usage.Add("index.chunks", indexing_record_.get_chunk_index_memory_usage());
+    usage.Add("index.graph", indexing_record_.get_graph_memory_usage());
+    if (partition_keys_ != nullptr) {
+        usage.Add("insert_record.partition_keys",
+                  partition_keys_->memory_usage());
+    }
+    return usage;
+}
+
 int64_t
-SegmentGrowingImpl::GetMemoryUsageInBytes() const {
-    int64_t total_bytes = 0;
-    auto chunk_rows = segcore_config_.get_chunk_rows();
-    int64_t ins_n = upper_align(insert_record_.reserved, chunk_rows);
-    total_bytes += ins_n * (schema_->get_total_sizeof() + 16 + 1);
-    int64_t del_n = upper_align(deleted_record_.reserved, chunk_rows);
-    total_bytes += del_n * (16 * 2);
-    return total_bytes;
+SegmentGrowingImpl::SpillChunks(const std::string& dir) {
+    std::lock_guard lck(spill_mutex_);
+    return insert_record_.spill_chunks(insert_record_.ack_responder_.GetAck(),
+                                       dir);
 }
 
 void
 SegmentGrowingImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
+    ArenaScope arena_scope(arena_);
     AssertInfo(info.row_count > 0, "The row count of deleted record is 0");
     AssertInfo(info.primary_keys, "Deleted primary keys is null");
     AssertInfo(info.timestamps, "Deleted timestamps is null");
@@ -169,16 +333,15 @@ SegmentGrowingImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
                "Primary key has invalid field id");
     auto& field_meta = schema_->operator[](field_id);
     int64_t size = info.row_count;
-    std::vector<PkType> pks(size);
-    ParsePksFromIDs(pks, field_meta.get_data_type(), *info.primary_keys);
     auto timestamps = reinterpret_cast<const Timestamp*>(info.timestamps);
 
     // step 2: fill pks and timestamps
     auto reserved_begin = deleted_record_.reserved.fetch_add(size);
-    deleted_record_.pks_.set_data_raw(reserved_begin, pks.data(), size);
-    deleted_record_.timestamps_.set_data_raw(reserved_begin, timestamps, size);
-    deleted_record_.ack_responder_.AddSegment(reserved_begin,
-                                              reserved_begin + size);
+    VisitPks(field_meta.get_data_type(),
+             *info.primary_keys,
+             [&](auto pks, int64_t) {
+                 deleted_record_.push(reserved_begin, pks, timestamps, size);
+             });
 }
 
 SpanBase
@@ -187,6 +350,13 @@ SegmentGrowingImpl::chunk_data_impl(FieldId field_id, int64_t chunk_id) const {
     return vec->get_span_base(chunk_id);
 }
 
+std::shared_ptr<const ZoneMapBase>
+SegmentGrowingImpl::chunk_zone_map_impl(FieldId field_id,
+                                        int64_t chunk_id) const {
+    auto vec = get_insert_record().get_field_data_base(field_id);
+    return vec->get_zone_map(chunk_id);
+}
+
 int64_t
 SegmentGrowingImpl::num_chunk() const {
     auto size = get_insert_record().ack_responder_.GetAck();
@@ -220,6 +390,17 @@ SegmentGrowingImpl::vector_search(SearchInfo& search_info,
     }
 }
 
+void
+SegmentGrowingImpl::sparse_search(const SearchInfo& search_info,
+                                  const SparseFloatRow* queries,
+                                  int64_t query_count,
+                                  Timestamp timestamp,
+                                  const BitsetView& bitset,
+                                  SearchResult& output) const {
+    query::SearchSparseOnGrowing(
+        *this, search_info, queries, query_count, timestamp, bitset, output);
+}
+
 std::unique_ptr<DataArray>
 SegmentGrowingImpl::bulk_subscript(FieldId field_id,
                                    const int64_t* seg_offsets,
@@ -228,80 +409,95 @@ SegmentGrowingImpl::bulk_subscript(FieldId field_id,
     auto vec_ptr = insert_record_.get_field_data_base(field_id);
     auto& field_meta = schema_->operator[](field_id);
     if (field_meta.is_vector()) {
-        aligned_vector<char> output(field_meta.get_sizeof() * count);
+        auto data_array = CreateVectorDataArray(0, field_meta);
+        auto output = AppendVectorRows(data_array.get(), field_meta, count);
         if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
-            bulk_subscript_impl<FloatVector>(field_meta.get_sizeof(),
-                                             *vec_ptr,
-                                             seg_offsets,
-                                             count,
-                                             output.data());
+            bulk_subscript_impl<FloatVector>(
+                field_meta.get_sizeof(), *vec_ptr, seg_offsets, count, output);
         } else if (field_meta.get_data_type() == DataType::VECTOR_BINARY) {
-            bulk_subscript_impl<BinaryVector>(field_meta.get_sizeof(),
-                                              *vec_ptr,
-                                              seg_offsets,
-                                              count,
-                                              output.data());
+            bulk_subscript_impl<BinaryVector>(
+                field_meta.get_sizeof(), *vec_ptr, seg_offsets, count, output);
         } else {
             PanicInfo("logical error");
         }
-        return CreateVectorDataArrayFrom(output.data(), count, field_meta);
+        return data_array;
+    }
+
+    if (field_meta.is_sparse_vector()) {
+        auto& rows = dynamic_cast<const ConcurrentVector<SparseFloatRow>&>(
+            *vec_ptr);
+        static const SparseFloatRow empty;
+        auto data_array = CreateVectorDataArray(0, field_meta);
+        for (int64_t i = 0; i < count; ++i) {
+            auto offset = seg_offsets[i];
+            auto& row = offset != INVALID_SEG_OFFSET ? rows[offset] : empty;
+            AppendSparseRow(row, data_array.get());
+        }
+        return data_array;
     }
 
     AssertInfo(!field_meta.is_vector(),
                "Scalar field meta type is vector type");
+    // gathered straight into the data array
+    auto data_array = CreateScalarDataArray(0, field_meta);
+    auto scalar_array = data_array->mutable_scalars();
     switch (field_meta.get_data_type()) {
         case DataType::BOOL: {
-            FixedVector<bool> output(count);
-            bulk_subscript_impl<bool>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_bool_data()->mutable_data(), count);
+            bulk_subscript_impl<bool>(*vec_ptr, seg_offsets, count, output);
+            break;
         }
         case DataType::INT8: {
-            FixedVector<bool> output(count);
-            bulk_subscript_impl<int8_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_int_data()->mutable_data(), count);
+            bulk_subscript_impl<int8_t, int32_t>(
+                *vec_ptr, seg_offsets, count, output);
+            break;
         }
         case DataType::INT16: {
-            FixedVector<int16_t> output(count);
-            bulk_subscript_impl<int16_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_int_data()->mutable_data(), count);
+            bulk_subscript_impl<int16_t, int32_t>(
+                *vec_ptr, seg_offsets, count, output);
+            break;
         }
         case DataType::INT32: {
-            FixedVector<int32_t> output(count);
-            bulk_subscript_impl<int32_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_int_data()->mutable_data(), count);
+            bulk_subscript_impl<int32_t>(*vec_ptr, seg_offsets, count, output);
+            break;
         }
         case DataType::INT64: {
-            FixedVector<int64_t> output(count);
-            bulk_subscript_impl<int64_t>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_long_data()->mutable_data(), count);
+            bulk_subscript_impl<int64_t>(*vec_ptr, seg_offsets, count, output);
+            break;
         }
         case DataType::FLOAT: {
-            FixedVector<float> output(count);
-            bulk_subscript_impl<float>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_float_data()->mutable_data(), count);
+            bulk_subscript_impl<float>(*vec_ptr, seg_offsets, count, output);
+            break;
         }
         case DataType::DOUBLE: {
-            FixedVector<double> output(count);
-            bulk_subscript_impl<double>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_double_data()->mutable_data(), count);
+            bulk_subscript_impl<double>(*vec_ptr, seg_offsets, count, output);
+            break;
         }
         case DataType::VARCHAR: {
-            FixedVector<std::string> output(count);
-            bulk_subscript_impl<std::string>(
-                *vec_ptr, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_string_data()->mutable_data(), count);
+            bulk_subscript_impl<std::string, std::string*>(
+                *vec_ptr, seg_offsets, count, output);
+            break;
         }
         default: {
             PanicInfo("unsupported type");
         }
     }
+    return data_array;
 }
 
 template <typename T>
@@ -315,35 +511,48 @@ SegmentGrowingImpl::bulk_subscript_impl(int64_t element_sizeof,
     auto vec_ptr = dynamic_cast<const ConcurrentVector<T>*>(&vec_raw);
     AssertInfo(vec_ptr, "Pointer of vec_raw is nullptr");
     auto& vec = *vec_ptr;
-    std::vector<uint8_t> empty(element_sizeof, 0);
     auto output_base = reinterpret_cast<char*>(output_raw);
-    for (int i = 0; i < count; ++i) {
-        auto dst = output_base + i * element_sizeof;
-        auto offset = seg_offsets[i];
-        const uint8_t* src = (offset == INVALID_SEG_OFFSET
-                                  ? empty.data()
-                                  : (const uint8_t*)vec.get_element(offset));
-        memcpy(dst, src, element_sizeof);
+    for (int64_t i = 0; i < count; ++i) {
+        if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+            memset(output_base + i * element_sizeof, 0, element_sizeof);
+        }
     }
+    GatherRows(
+        seg_offsets,
+        count,
+        element_sizeof,
+        [&vec](int64_t offset) { return vec.get_element(offset); },
+        [&](int64_t i, int64_t offset) {
+            memcpy(output_base + i * element_sizeof,
+                   vec.get_element(offset),
+                   element_sizeof);
+        });
 }
 
-template <typename T>
+template <typename S, typename T>
 void
 SegmentGrowingImpl::bulk_subscript_impl(const VectorBase& vec_raw,
                                         const int64_t* seg_offsets,
                                         int64_t count,
                                         void* output_raw) const {
-    static_assert(IsScalar<T>);
-    auto vec_ptr = dynamic_cast<const ConcurrentVector<T>*>(&vec_raw);
+    static_assert(IsScalar<S>);
+    auto vec_ptr = dynamic_cast<const ConcurrentVector<S>*>(&vec_raw);
     AssertInfo(vec_ptr, "Pointer of vec_raw is nullptr");
     auto& vec = *vec_ptr;
     auto output = reinterpret_cast<T*>(output_raw);
     for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        if (offset != INVALID_SEG_OFFSET) {
-            output[i] = vec[offset];
+        if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+            AssignValue(output[i], S());
         }
     }
+    GatherRows(
+        seg_offsets,
+        count,
+        sizeof(S),
+        [&vec](int64_t offset) { return &vec[offset]; },
+        [&](int64_t i, int64_t offset) {
+            AssignValue(output[i], vec[offset]);
+        });
 }
 
 void
@@ -367,72 +576,42 @@ SegmentGrowingImpl::bulk_subscript(SystemFieldType system_type,
 
 std::vector<SegOffset>
 SegmentGrowingImpl::search_ids(const BitsetType& bitset,
-                               Timestamp timestamp) const {
-    std::vector<SegOffset> res_offsets;
-
-    for (int i = 0; i < bitset.size(); i++) {
-        if (bitset[i]) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                res_offsets.push_back(offset);
-            }
-        }
-    }
-    return res_offsets;
+                               Timestamp timestamp,
+                               int64_t limit) const {
+    // the rows are inserted in timestamp order
+    auto active_count = get_active_count(timestamp);
+    return BitsetOffsets(reinterpret_cast<const uint8_t*>(bitset.data()),
+                         bitset.size(),
+                         false,
+                         limit,
+                         nullptr,
+                         timestamp,
+                         active_count,
+                         active_count);
 }
 
 std::vector<SegOffset>
 SegmentGrowingImpl::search_ids(const BitsetView& bitset,
                                Timestamp timestamp) const {
-    std::vector<SegOffset> res_offsets;
-
-    for (int i = 0; i < bitset.size(); ++i) {
-        if (!bitset.test(i)) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                res_offsets.push_back(offset);
-            }
-        }
-    }
-    return res_offsets;
+    auto active_count = get_active_count(timestamp);
+    return BitsetOffsets(bitset.data(),
+                         bitset.size(),
+                         true,
+                         -1,
+                         nullptr,
+                         timestamp,
+                         active_count,
+                         active_count);
 }
 
 std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
 SegmentGrowingImpl::search_ids(const IdArray& id_array,
                                Timestamp timestamp) const {
-    AssertInfo(id_array.has_int_id(), "Id array doesn't have int_id element");
     auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
     AssertInfo(field_id.get() != -1, "Primary key is -1");
     auto& field_meta = schema_->operator[](field_id);
-    auto data_type = field_meta.get_data_type();
-    auto ids_size = GetSizeOfIdArray(id_array);
-    std::vector<PkType> pks(ids_size);
-    ParsePksFromIDs(pks, data_type, id_array);
-
-    auto res_id_arr = std::make_unique<IdArray>();
-    std::vector<SegOffset> res_offsets;
-    for (auto pk : pks) {
-        auto segOffsets = insert_record_.search_pk(pk, timestamp);
-        for (auto offset : segOffsets) {
-            switch (data_type) {
-                case DataType::INT64: {
-                    res_id_arr->mutable_int_id()->add_data(
-                        std::get<int64_t>(pk));
-                    break;
-                }
-                case DataType::VARCHAR: {
-                    res_id_arr->mutable_str_id()->add_data(
-                        std::get<std::string>(pk));
-                    break;
-                }
-                default: {
-                    PanicInfo("unsupported type");
-                }
-            }
-            res_offsets.push_back(offset);
-        }
-    }
-    return {std::move(res_id_arr), std::move(res_offsets)};
+    return SearchIds(
+        insert_record_, field_meta.get_data_type(), id_array, timestamp);
 }
 
 std::string
@@ -442,14 +621,8 @@ SegmentGrowingImpl::debug() const {
 
 int64_t
 SegmentGrowingImpl::get_active_count(Timestamp ts) const {
-    auto row_count = this->get_row_count();
-    auto& ts_vec = this->get_insert_record().timestamps_;
-    auto iter = std::upper_bound(
-        boost::make_counting_iterator((int64_t)0),
-        boost::make_counting_iterator(row_count),
-        ts,
-        [&](Timestamp ts, int64_t index) { return ts < ts_vec[index]; });
-    return *iter;
+    return get_insert_record().timestamps_.sorted_upper_bound(
+        0, get_row_count(), ts);
 }
 
 void
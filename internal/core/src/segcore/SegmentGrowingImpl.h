@@ -13,6 +13,7 @@
 
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <tbb/concurrent_priority_queue.h>
@@ -29,6 +30,7 @@
 #include "SealedIndexingRecord.h"
 #include "SegmentGrowing.h"
 
+#include "common/Numa.h"
 #include "exceptions/EasyAssert.h"
 #include "query/PlanNode.h"
 #include "query/deprecated/GeneralQuery.h"
@@ -48,6 +50,14 @@ class SegmentGrowingImpl : public SegmentGrowing {
            const Timestamp* timestamps,
            const InsertData* insert_data) override;
 
+    void
+    InsertColumns(int64_t reserved_offset,
+                  int64_t size,
+                  const int64_t* row_ids,
+                  const Timestamp* timestamps,
+                  const InsertColumn* columns,
+                  int64_t num_columns) override;
+
     int64_t
     PreDelete(int64_t size) override;
 
@@ -58,8 +68,25 @@ class SegmentGrowingImpl : public SegmentGrowing {
            const IdArray* pks,
            const Timestamp* timestamps) override;
 
+    // inserts the rows of insert_data, each deleting the rows of its pk
+    // before it: those of the segment and the earlier ones of the batch,
+    // hidden from its timestamp on. one probe of the pk index picks them,
+    // a pk new to the segment records no delete. returns the offset of
+    // the first row
+    int64_t
+    Upsert(int64_t size,
+           const int64_t* row_ids,
+           const Timestamp* timestamps,
+           const InsertData* insert_data);
+
+    MemoryUsage
+    GetMemoryUsage() const override;
+
+    // moves the chunks holding only acknowledged rows, never written
+    // again, to unlinked files under dir, for the kernel to write back and
+    // drop under memory pressure; returns the bytes moved
     int64_t
-    GetMemoryUsageInBytes() const override;
+    SpillChunks(const std::string& dir);
 
     void
     LoadDeletedRecord(const LoadDeletedRecordInfo& info) override;
@@ -93,6 +120,11 @@ class SegmentGrowingImpl : public SegmentGrowing {
         return sealed_indexing_record_;
     }
 
+    const SegcoreConfig&
+    get_segcore_config() const {
+        return segcore_config_;
+    }
+
     const Schema&
     get_schema() const override {
         return *schema_;
@@ -101,7 +133,8 @@ class SegmentGrowingImpl : public SegmentGrowing {
     // return count of index that has index, i.e., [0, num_chunk_index) have built index
     int64_t
     num_chunk_index(FieldId field_id) const final {
-        return indexing_record_.get_finished_ack();
+        return indexing_record_.get_finished_rows() /
+               segcore_config_.get_chunk_rows(schema_->operator[](field_id));
     }
 
     // count of chunk that has raw data
@@ -143,8 +176,8 @@ class SegmentGrowingImpl : public SegmentGrowing {
     int64_t
     get_active_count(Timestamp ts) const override;
 
-    // for scalar vectors
-    template <typename T>
+    // for scalar vectors, gathering values of S into an output of T
+    template <typename S, typename T = S>
     void
     bulk_subscript_impl(const VectorBase& vec_raw,
                         const int64_t* seg_offsets,
@@ -181,9 +214,21 @@ class SegmentGrowingImpl : public SegmentGrowing {
                                 int64_t segment_id)
         : segcore_config_(segcore_config),
           schema_(std::move(schema)),
-          insert_record_(*schema_, segcore_config.get_chunk_rows()),
-          indexing_record_(*schema_, segcore_config_),
+          insert_record_(*schema_,
+                         segcore_config.get_chunk_rows(),
+                         segcore_config.get_vector_chunk_bytes()),
+          indexing_record_(schema_, segcore_config_),
+          deleted_record_(*schema_),
+          partition_keys_(CreatePartitionKeys(*schema_, false)),
           id_(segment_id) {
+        field_access_stats_ =
+            std::make_unique<FieldAccessStats>(schema_->size());
+        insert_record_.chunk_arena_.set_numa_node(SegmentNumaNode(id_));
+    }
+
+    ~SegmentGrowingImpl() override {
+        // the builds read insert_record_, which is destroyed first
+        indexing_record_.WaitForBuilds();
     }
 
     void
@@ -198,17 +243,39 @@ class SegmentGrowingImpl : public SegmentGrowing {
                   const BitsetView& bitset,
                   SearchResult& output) const override;
 
- public:
     void
-    mask_with_delete(BitsetType& bitset,
-                     int64_t ins_barrier,
-                     Timestamp timestamp) const override;
+    sparse_search(const SearchInfo& search_info,
+                  const SparseFloatRow* queries,
+                  int64_t query_count,
+                  Timestamp timestamp,
+                  const BitsetView& bitset,
+                  SearchResult& output) const override;
+
+    bool
+    has_raw_vectors(FieldId field_id) const override {
+        return true;
+    }
+
+ public:
+    DeletedRecord::SnapshotPtr
+    get_deleted_snapshot(int64_t ins_barrier,
+                         Timestamp timestamp,
+                         bool* cached = nullptr) const override;
+
+    std::shared_ptr<const BitsetType>
+    get_timestamp_mask(Timestamp timestamp) const override {
+        // rows are inserted in timestamp order, the later ones are past
+        // the active count
+        return nullptr;
+    }
 
     std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
     search_ids(const IdArray& id_array, Timestamp timestamp) const override;
 
     std::vector<SegOffset>
-    search_ids(const BitsetType& view, Timestamp timestamp) const override;
+    search_ids(const BitsetType& view,
+               Timestamp timestamp,
+               int64_t limit) const override;
 
     std::vector<SegOffset>
     search_ids(const BitsetView& view, Timestamp timestamp) const override;
@@ -223,6 +290,11 @@ class SegmentGrowingImpl : public SegmentGrowing {
         return true;
     }
 
+    bool
+    HasRawData(int64_t field_id) const override {
+        return true;
+    }
+
  protected:
     int64_t
     num_chunk() const override;
@@ -230,11 +302,39 @@ class SegmentGrowingImpl : public SegmentGrowing {
     SpanBase
     chunk_data_impl(FieldId field_id, int64_t chunk_id) const override;
 
+    std::shared_ptr<const ZoneMapBase>
+    chunk_zone_map_impl(FieldId field_id, int64_t chunk_id) const override;
+
+    std::shared_ptr<const PartitionKeysBase>
+    partition_keys_impl() const override {
+        return partition_keys_;
+    }
+
     void
     check_search(const query::Plan* plan) const override {
         Assert(plan);
     }
 
+ private:
+    // writes the rows of insert_data at reserved_offset but for the pk
+    // index, returns the data of the pk field
+    const DataArray&
+    set_insert_data(int64_t reserved_offset,
+                    int64_t size,
+                    const int64_t* row_ids,
+                    const Timestamp* timestamps,
+                    const InsertData* insert_data);
+
+    // acknowledges rows [reserved_offset, reserved_offset + size) once
+    // all their data is written, and indexes the chunks they complete
+    void
+    finish_insert(int64_t reserved_offset, int64_t size);
+
+    // adds the partition keys of rows [reserved_offset, reserved_offset +
+    // size), written but not acknowledged yet
+    void
+    add_partition_keys(int64_t reserved_offset, int64_t size);
+
  private:
     SegcoreConfig segcore_config_;
     SchemaPtr schema_;
@@ -249,8 +349,14 @@ class SegmentGrowingImpl : public SegmentGrowing {
     // deleted pks
     mutable DeletedRecord deleted_record_;
 
+    // the partition keys inserted, nullptr without a partition key field
+    std::shared_ptr<PartitionKeysBase> partition_keys_;
+
     int64_t id_;
 
+    // a chunk is spilled by one thread at a time
+    std::mutex spill_mutex_;
+
  private:
     bool enable_small_index_ = true;
 };
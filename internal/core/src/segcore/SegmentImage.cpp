@@ -0,0 +1,108 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "segcore/SegmentImage.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "exceptions/EasyAssert.h"
+#include "log/Log.h"
+#include "utils/Json.h"
+
+namespace milvus::segcore {
+
+namespace {
+const char MANIFEST_NAME[] = "image.json";
+constexpr int64_t SEGMENT_IMAGE_VERSION = 1;
+
+void
+WriteFile(const std::string& path, const std::string& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+    file.close();
+    AssertInfo(file.good(), "failed to write segment image file " + path);
+}
+}  // namespace
+
+std::string
+SegmentImageDir(const std::string& dir, int64_t segment_id) {
+    return (std::filesystem::path(dir) / std::to_string(segment_id)).string();
+}
+
+void
+WriteSegmentImageManifest(const std::string& dir,
+                          const SegmentImageManifest& manifest) {
+    milvus::json json;
+    json["version"] = SEGMENT_IMAGE_VERSION;
+    json["segment_id"] = manifest.segment_id;
+    json["row_count"] = manifest.row_count;
+    json["columns"] = manifest.columns;
+    json["arrays"] = manifest.arrays;
+    auto path =
+        std::filesystem::path(SegmentImageDir(dir, manifest.segment_id)) /
+        MANIFEST_NAME;
+    auto tmp_path = path.string() + ".tmp";
+    WriteFile(tmp_path, json.dump());
+    AssertInfo(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+               "failed to rename segment image manifest " + tmp_path);
+}
+
+std::optional<SegmentImageManifest>
+ReadSegmentImageManifest(const std::string& dir, int64_t segment_id) {
+    auto path = std::filesystem::path(SegmentImageDir(dir, segment_id)) /
+                MANIFEST_NAME;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    try {
+        std::stringstream bytes;
+        bytes << file.rdbuf();
+        auto json = milvus::json::parse(bytes.str());
+        if (json["version"].get<int64_t>() != SEGMENT_IMAGE_VERSION ||
+            json["segment_id"].get<int64_t>() != segment_id) {
+            return std::nullopt;
+        }
+        SegmentImageManifest manifest;
+        manifest.segment_id = segment_id;
+        manifest.row_count = json["row_count"].get<int64_t>();
+        manifest.columns = json["columns"].get<std::vector<int64_t>>();
+        manifest.arrays = json["arrays"].get<std::vector<int64_t>>();
+        return manifest;
+    } catch (std::exception& e) {
+        LOG_SEGCORE_WARNING_ << "failed to read the segment image manifest "
+                             << path.string() << ": " << e.what();
+        return std::nullopt;
+    }
+}
+
+void
+WriteDataArray(const std::string& path, const DataArray& array) {
+    std::string bytes;
+    AssertInfo(array.SerializeToString(&bytes),
+               "failed to serialize the data array of " + path);
+    WriteFile(path, bytes);
+}
+
+std::unique_ptr<DataArray>
+ReadDataArray(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    AssertInfo(file.is_open(), "segment image file is missing: " + path);
+    auto array = std::make_unique<DataArray>();
+    AssertInfo(array->ParseFromIstream(&file),
+               "segment image file is corrupted: " + path);
+    return array;
+}
+
+}  // namespace milvus::segcore
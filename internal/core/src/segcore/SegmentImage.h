@@ -0,0 +1,64 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// A saved sealed segment, restored after a restart instead of loading its
+// binlogs again. The image of segment s lives in <dir>/<s>/:
+//
+//   image.json        the manifest, written last and replaced atomically
+//   <field_id>.col    a fixed width user field, in the ColumnCache layout
+//   <field_id>.pb     a system or variable length field, a DataArray
+//
+// Restoring maps the columns as they are and loads the arrays, the pk and
+// timestamp indexes are rebuilt from them. Fields loaded as an index and
+// the deletes are not part of an image, they are loaded as usual.
+struct SegmentImageManifest {
+    int64_t segment_id = 0;
+    int64_t row_count = 0;
+    std::vector<int64_t> columns;
+    std::vector<int64_t> arrays;
+};
+
+// capacity of the ColumnCache of an image, which evicts nothing
+constexpr int64_t SEGMENT_IMAGE_CAPACITY =
+    std::numeric_limits<int64_t>::max() / 2;
+
+std::string
+SegmentImageDir(const std::string& dir, int64_t segment_id);
+
+void
+WriteSegmentImageManifest(const std::string& dir,
+                          const SegmentImageManifest& manifest);
+
+// the manifest of the image of segment_id, nullopt if there is none or it
+// can't be read
+std::optional<SegmentImageManifest>
+ReadSegmentImageManifest(const std::string& dir, int64_t segment_id);
+
+void
+WriteDataArray(const std::string& path, const DataArray& array);
+
+std::unique_ptr<DataArray>
+ReadDataArray(const std::string& path);
+
+}  // namespace milvus::segcore
@@ -11,15 +11,184 @@
 
 #include "SegmentInterface.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <unordered_set>
 
 #include "Utils.h"
+#include "common/CancelToken.h"
+#include "common/Metrics.h"
+#include "common/Numa.h"
+#include "common/ScratchArena.h"
 #include "common/SystemProperty.h"
 #include "common/Types.h"
+#include "log/Log.h"
+#include "query/SearchBruteForce.h"
+#include "query/SubSearchResult.h"
 #include "query/generated/ExecPlanNodeVisitor.h"
 
 namespace milvus::segcore {
 
+namespace {
+
+// calls fn with every set bit of [begin, end), a block at a time
+template <typename Fn>
+void
+ForEachMatch(const BitsetType& matches, int64_t begin, int64_t end, Fn&& fn) {
+    auto blocks = matches.data();
+    for (auto i = begin; i < end;) {
+        auto shift = i % BitsetType::bits_per_block;
+        auto n = std::min<int64_t>(BitsetType::bits_per_block - shift, end - i);
+        auto block = blocks[i / BitsetType::bits_per_block] >> shift;
+        if (n == BitsetType::bits_per_block && block == ~uint64_t(0)) {
+            for (int64_t j = 0; j < n; ++j) {
+                fn(i + j);
+            }
+        } else {
+            if (n < BitsetType::bits_per_block) {
+                block &= (uint64_t(1) << n) - 1;
+            }
+            while (block != 0) {
+                fn(i + __builtin_ctzll(block));
+                block &= block - 1;
+            }
+        }
+        i += n;
+    }
+}
+
+bool
+AllMatch(const BitsetType& matches, int64_t begin, int64_t end) {
+    auto blocks = matches.data();
+    for (auto i = begin; i < end;) {
+        if (i % BitsetType::bits_per_block == 0 &&
+            i + int64_t(BitsetType::bits_per_block) <= end) {
+            if (blocks[i / BitsetType::bits_per_block] != ~uint64_t(0)) {
+                return false;
+            }
+            i += BitsetType::bits_per_block;
+        } else {
+            if (!matches.test(i)) {
+                return false;
+            }
+            ++i;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+std::unique_ptr<proto::segcore::AggregateResult>
+AggregateColumn(const SegmentInternalInterface& segment,
+                const query::AggregateInfo& aggregate,
+                const BitsetType& matches) {
+    using SumType =
+        std::conditional_t<std::is_floating_point_v<T>, double, int64_t>;
+    auto op = aggregate.op_;
+    auto field_id = aggregate.field_id_;
+    SumType sum = 0;
+    T min = std::numeric_limits<T>::max();
+    T max = std::numeric_limits<T>::lowest();
+    bool found = false;
+    auto reduce = [&](T value) {
+        sum += value;
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    };
+
+    auto row_count = int64_t(matches.size());
+    if (segment.num_chunk_data(field_id) == 0) {
+        // only the scalar index of the field is loaded
+        auto& index = segment.chunk_scalar_index<T>(field_id, 0);
+        ForEachMatch(matches, 0, row_count, [&](int64_t offset) {
+            reduce(index.Reverse_Lookup(offset));
+            found = true;
+        });
+        row_count = 0;
+    }
+
+    auto size_per_chunk = segment.size_per_chunk();
+    for (int64_t chunk_begin = 0; chunk_begin < row_count;
+         chunk_begin += size_per_chunk) {
+        auto chunk_id = chunk_begin / size_per_chunk;
+        auto chunk_size = std::min(size_per_chunk, row_count - chunk_begin);
+        auto data = segment.chunk_data<T>(field_id, chunk_id).data();
+        // zone maps keep no sums, only min and max skip matched zones
+        std::shared_ptr<const ZoneMap<T>> zone_map;
+        if (op != query::AggregateOp::Sum) {
+            zone_map = segment.chunk_zone_map<T>(field_id, chunk_id);
+        }
+        auto zone_rows = zone_map ? zone_map->zone_rows : chunk_size;
+        for (int64_t begin = 0; begin < chunk_size; begin += zone_rows) {
+            auto end = std::min(begin + zone_rows, chunk_size);
+            // a zone matched as a whole folds in its min and max
+            auto zone_id = size_t(begin / zone_rows);
+            if (zone_map && zone_id < zone_map->zones.size() &&
+                zone_map->zones[zone_id].valid &&
+                AllMatch(matches, chunk_begin + begin, chunk_begin + end)) {
+                reduce(zone_map->zones[zone_id].min);
+                reduce(zone_map->zones[zone_id].max);
+                found = true;
+                continue;
+            }
+            ForEachMatch(matches,
+                         chunk_begin + begin,
+                         chunk_begin + end,
+                         [&](int64_t offset) {
+                             reduce(data[offset - chunk_begin]);
+                             found = true;
+                         });
+        }
+    }
+
+    auto result = std::make_unique<proto::segcore::AggregateResult>();
+    if (op == query::AggregateOp::Sum || found) {
+        auto value = op == query::AggregateOp::Sum ? sum
+                     : op == query::AggregateOp::Min ? SumType(min)
+                                                     : SumType(max);
+        if constexpr (std::is_floating_point_v<T>) {
+            result->set_double_value(value);
+        } else {
+            result->set_long_value(value);
+        }
+    }
+    return result;
+}
+
+std::unique_ptr<proto::segcore::AggregateResult>
+Aggregate(const SegmentInternalInterface& segment,
+          const query::AggregateInfo& aggregate,
+          const BitsetType& matches) {
+    if (aggregate.op_ == query::AggregateOp::Count) {
+        auto result = std::make_unique<proto::segcore::AggregateResult>();
+        result->set_long_value(matches.count());
+        return result;
+    }
+    auto& field_meta = segment.get_schema()[aggregate.field_id_];
+    switch (field_meta.get_data_type()) {
+        case DataType::INT8:
+            return AggregateColumn<int8_t>(segment, aggregate, matches);
+        case DataType::INT16:
+            return AggregateColumn<int16_t>(segment, aggregate, matches);
+        case DataType::INT32:
+            return AggregateColumn<int32_t>(segment, aggregate, matches);
+        case DataType::INT64:
+            return AggregateColumn<int64_t>(segment, aggregate, matches);
+        case DataType::FLOAT:
+            return AggregateColumn<float>(segment, aggregate, matches);
+        case DataType::DOUBLE:
+            return AggregateColumn<double>(segment, aggregate, matches);
+        default:
+            PanicInfo("unsupported data type of aggregate: " +
+                      datatype_name(field_meta.get_data_type()));
+    }
+}
+
+}  // namespace
+
 void
 SegmentInternalInterface::FillPrimaryKeys(const query::Plan* plan,
                                           SearchResult& results) const {
@@ -37,6 +206,8 @@ SegmentInternalInterface::FillPrimaryKeys(const query::Plan* plan,
     auto pk_field_id = pk_field_id_opt.value();
     AssertInfo(IsPrimaryKeyDataType(get_schema()[pk_field_id].get_data_type()),
                "Primary key field is not INT64 or VARCHAR type");
+    record_field_access(pk_field_id, FieldAccess::SubscriptCalls);
+    record_field_access(pk_field_id, FieldAccess::SubscriptRows, size);
     auto field_data =
         bulk_subscript(pk_field_id, results.seg_offsets_.data(), size);
     results.pk_type_ = DataType(field_data->type());
@@ -44,6 +215,54 @@ SegmentInternalInterface::FillPrimaryKeys(const query::Plan* plan,
     ParsePksFromFieldData(results.primary_keys_, *field_data.get());
 }
 
+std::vector<PkType>
+SegmentInternalInterface::group_by_values(FieldId field_id,
+                                          const int64_t* seg_offsets,
+                                          int64_t count) const {
+    std::vector<PkType> values(count);
+    if (count == 0) {
+        return values;
+    }
+    auto field_data = bulk_subscript(field_id, seg_offsets, count);
+    auto& scalars = field_data->scalars();
+    switch (get_schema()[field_id].get_data_type()) {
+        case DataType::BOOL: {
+            auto& data = scalars.bool_data().data();
+            for (int64_t i = 0; i < count; ++i) {
+                values[i] = int64_t(data[i]);
+            }
+            break;
+        }
+        case DataType::INT8:
+        case DataType::INT16:
+        case DataType::INT32: {
+            auto& data = scalars.int_data().data();
+            for (int64_t i = 0; i < count; ++i) {
+                values[i] = int64_t(data[i]);
+            }
+            break;
+        }
+        case DataType::INT64: {
+            auto& data = scalars.long_data().data();
+            for (int64_t i = 0; i < count; ++i) {
+                values[i] = data[i];
+            }
+            break;
+        }
+        case DataType::VARCHAR:
+        case DataType::STRING: {
+            auto& data = scalars.string_data().data();
+            for (int64_t i = 0; i < count; ++i) {
+                values[i] = data[i];
+            }
+            break;
+        }
+        default:
+            PanicInfo("unsupported group by field type");
+    }
+    return values;
+}
+
 void
 SegmentInternalInterface::FillTargetEntry(const query::Plan* plan,
                                           SearchResult& results) const {
@@ -53,11 +272,38 @@ SegmentInternalInterface::FillTargetEntry(const query::Plan* plan,
     AssertInfo(results.seg_offsets_.size() == size,
                "Size of result distances is not equal to size of ids");
 
-    // fill other entries except primary key by result_offset
+    // a row kept for several nqs is fetched once, in offset order
+    std::vector<int64_t> rows(results.seg_offsets_);
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    if (rows.size() == size) {
+        // fill other entries except primary key by result_offset
+        for (auto field_id : plan->target_entries_) {
+            record_field_access(field_id, FieldAccess::SubscriptCalls);
+            record_field_access(field_id, FieldAccess::SubscriptRows, size);
+            auto field_data =
+                bulk_subscript(field_id, results.seg_offsets_.data(), size);
+            results.output_fields_data_[field_id] = std::move(field_data);
+        }
+        return;
+    }
+
+    SearchResult distinct;
     for (auto field_id : plan->target_entries_) {
-        auto field_data =
-            bulk_subscript(field_id, results.seg_offsets_.data(), size);
-        results.output_fields_data_[field_id] = std::move(field_data);
+        record_field_access(field_id, FieldAccess::SubscriptCalls);
+        record_field_access(field_id, FieldAccess::SubscriptRows, rows.size());
+        distinct.output_fields_data_[field_id] =
+            bulk_subscript(field_id, rows.data(), rows.size());
+    }
+    std::vector<std::pair<SearchResult*, int64_t>> result_pairs(size);
+    for (size_t i = 0; i < size; ++i) {
+        auto row = std::lower_bound(
+            rows.begin(), rows.end(), results.seg_offsets_[i]);
+        result_pairs[i] = std::make_pair(&distinct, row - rows.begin());
+    }
+    for (auto field_id : plan->target_entries_) {
+        results.output_fields_data_[field_id] =
+            MergeDataArray(result_pairs, get_schema()[field_id]);
     }
 }
 
@@ -66,30 +312,428 @@ SegmentInternalInterface::Search(
     const query::Plan* plan,
     const query::PlaceholderGroup* placeholder_group,
     Timestamp timestamp) const {
+    SEGCORE_METRIC_TIMER(SearchLatency);
     std::shared_lock lck(mutex_);
+    NumaNodeScope numa_scope(SegmentNumaNode(get_segment_id()));
+    ScratchScope scratch_scope;
     check_search(plan);
-    query::ExecPlanNodeVisitor visitor(*this, timestamp, placeholder_group);
+    SEGCORE_METRIC_ADD(SearchQueries, placeholder_group->at(0).num_of_queries_);
+    // the filter bitset and the result arrays
+    auto num_queries = placeholder_group->at(0).num_of_queries_;
+    auto scratch = ReserveScratch(
+        get_active_count(timestamp) / 8 +
+            num_queries * plan->plan_node_->search_info_.topk_ *
+                int64_t(sizeof(int64_t) + sizeof(float)),
+        "search");
+    query::ExecPlanNodeVisitor visitor(
+        *this, timestamp, placeholder_group, plan->bindings_.get());
+    std::shared_ptr<QueryProfile> profile;
+    if (plan->profile_) {
+        profile = std::make_shared<QueryProfile>();
+        visitor.set_profile(profile.get());
+    }
+    visitor.set_search_bound(plan->search_bound_.get());
+    visitor.set_cancel_token(&plan->cancel_token_);
+    visitor.set_tenant(plan->tenant_, plan->tenant_weight_);
     auto results = std::make_unique<SearchResult>();
     *results = visitor.get_moved_result(*plan->plan_node_);
+    if (auto& bound = plan->search_bound_) {
+        AssertInfo(results->seg_offsets_.size() ==
+                       results->total_nq_ * results->unity_topK_,
+                   "search bound of another placeholder group");
+        // pruned by the segments searched before, then tightening the
+        // bound for the ones after
+        bound->Prune(results->unity_topK_,
+                     results->seg_offsets_.data(),
+                     results->distances_.data());
+        bound->Update(results->unity_topK_,
+                      results->seg_offsets_.data(),
+                      results->distances_.data());
+    }
+    results->segment_ = (void*)this;
+    results->profile_ = std::move(profile);
+    return results;
+}
+
+int64_t
+SegmentInternalInterface::OpenSearch(
+    const query::Plan* plan,
+    const query::PlaceholderGroup* placeholder_group,
+    Timestamp timestamp) const {
+    std::shared_lock lck(mutex_);
+    check_search(plan);
+    auto& node = *plan->plan_node_;
+    AssertInfo(dynamic_cast<const query::MultiVectorANNS*>(&node) == nullptr,
+               "search iterators support one vector field only");
+    AssertInfo(!node.search_info_.group_by_field_id_.has_value(),
+               "search iterators do not support group by");
+    AssertInfo(dynamic_cast<const query::SparseFloatVectorANNS*>(&node) ==
+                   nullptr,
+               "search iterators do not support sparse vectors");
+    auto& ph = placeholder_group->at(0);
+    auto iterator = std::make_shared<SearchIterator>();
+    iterator->search_info = node.search_info_;
+    iterator->search_info.topk_ = 0;
+    iterator->queries = ph.data_;
+    iterator->queries_holder = ph.holder_;
+    iterator->num_queries = ph.num_of_queries_;
+    iterator->timestamp = timestamp;
+
+    auto active_count = get_active_count(timestamp);
+    if (active_count == 0) {
+        iterator->exhausted = true;
+    } else {
+        iterator->filter =
+            query::ExecPlanNodeVisitor::ExecSearchFilter(*this,
+                                                         node,
+                                                         active_count,
+                                                         timestamp,
+                                                         iterator->exhausted,
+                                                         plan->bindings_.get());
+    }
+    return search_iterators_.Add(std::move(iterator));
+}
+
+std::unique_ptr<SearchResult>
+SegmentInternalInterface::SearchNext(int64_t handle, int64_t page_size) const {
+    AssertInfo(page_size > 0, "page size must be positive");
+    auto iterator = search_iterators_.Get(handle);
+    AssertInfo(iterator != nullptr,
+               "search iterator " + std::to_string(handle) +
+                   " is closed or expired");
+    std::shared_lock lck(mutex_);
+    std::lock_guard iterator_lck(iterator->mutex);
+    auto& info = iterator->search_info;
+    auto wanted = iterator->returned + page_size;
+    if (wanted > info.topk_ && !iterator->exhausted) {
+        fetch_search_candidates(*iterator, std::max(wanted, 2 * info.topk_));
+    }
+
+    auto num_queries = iterator->num_queries;
+    query::SubSearchResult page(
+        num_queries, page_size, info.metric_type_, info.round_decimal_);
+    auto available = std::min(
+        page_size, std::max<int64_t>(info.topk_ - iterator->returned, 0));
+    for (int64_t q = 0; q < num_queries; ++q) {
+        auto src = q * info.topk_ + iterator->returned;
+        std::copy_n(iterator->seg_offsets.data() + src,
+                    available,
+                    page.get_seg_offsets() + q * page_size);
+        std::copy_n(iterator->distances.data() + src,
+                    available,
+                    page.get_distances() + q * page_size);
+    }
+    iterator->returned += page_size;
+
+    auto results = std::make_unique<SearchResult>();
+    results->total_nq_ = num_queries;
+    results->unity_topK_ = page_size;
+    results->seg_offsets_ = std::move(page.mutable_seg_offsets());
+    results->distances_ = std::move(page.mutable_distances());
     results->segment_ = (void*)this;
     return results;
 }
 
+void
+SegmentInternalInterface::CloseSearch(int64_t handle) const {
+    search_iterators_.Remove(handle);
+}
+
+void
+SegmentInternalInterface::vector_search_rows(
+    const SearchInfo& search_info,
+    const void* query_data,
+    int64_t query_count,
+    const std::vector<SegOffset>& seg_offsets,
+    SearchResult& output) const {
+    CheckCancel(search_info.cancel_token_);
+    auto& field_meta = get_schema()[search_info.field_id_];
+    ScratchVector<int64_t> rows(seg_offsets.size());
+    std::transform(seg_offsets.begin(),
+                   seg_offsets.end(),
+                   rows.begin(),
+                   [](SegOffset offset) { return offset.get(); });
+    auto vectors =
+        bulk_subscript(search_info.field_id_, rows.data(), rows.size());
+    auto& vector_array = vectors->vectors();
+    const void* vector_data =
+        field_meta.get_data_type() == DataType::VECTOR_FLOAT
+            ? static_cast<const void*>(
+                  vector_array.float_vector().data().data())
+            : static_cast<const void*>(vector_array.binary_vector().data());
+
+    query::dataset::SearchDataset dataset{search_info.metric_type_,
+                                          query_count,
+                                          search_info.topk_,
+                                          search_info.round_decimal_,
+                                          field_meta.get_dim(),
+                                          query_data};
+    auto sub_qr = query::BruteForceSearch(dataset,
+                                          vector_data,
+                                          rows.size(),
+                                          *search_info.GetParams(),
+                                          BitsetView());
+    // positions in the gathered rows to segment offsets
+    for (auto& offset : sub_qr.mutable_seg_offsets()) {
+        if (offset != INVALID_SEG_OFFSET) {
+            offset = rows[offset];
+        }
+    }
+    output.total_nq_ = query_count;
+    output.unity_topK_ = search_info.topk_;
+    output.seg_offsets_ = std::move(sub_qr.mutable_seg_offsets());
+    output.distances_ = std::move(sub_qr.mutable_distances());
+}
+
+void
+SegmentInternalInterface::fetch_search_candidates(SearchIterator& iterator,
+                                                  int64_t topk) const {
+    auto& filter = iterator.filter;
+    auto unfiltered = int64_t(filter.size() - filter.count());
+    topk = std::min(topk, unfiltered);
+    auto info = iterator.search_info;
+    info.topk_ = topk;
+    SearchResult fetched;
+    vector_search(info,
+                  iterator.queries,
+                  iterator.num_queries,
+                  iterator.timestamp,
+                  BitsetView(filter),
+                  fetched);
+
+    // an approximate index may rank the rows differently with a larger
+    // topk, the rows handed out keep their places and are not repeated
+    auto num_queries = iterator.num_queries;
+    auto old_topk = iterator.search_info.topk_;
+    auto returned = std::min(iterator.returned, old_topk);
+    query::SubSearchResult candidates(
+        num_queries, topk, info.metric_type_, info.round_decimal_);
+    auto seg_offsets = candidates.get_seg_offsets();
+    auto distances = candidates.get_distances();
+    bool exhausted = topk == unfiltered;
+    for (int64_t q = 0; q < num_queries; ++q) {
+        auto old_offsets = iterator.seg_offsets.data() + q * old_topk;
+        std::copy_n(old_offsets, returned, seg_offsets + q * topk);
+        std::copy_n(iterator.distances.data() + q * old_topk,
+                    returned,
+                    distances + q * topk);
+        std::unordered_set<int64_t> handed_out(old_offsets,
+                                               old_offsets + returned);
+        auto dst = q * topk + returned;
+        for (int64_t i = q * topk; i < (q + 1) * topk; ++i) {
+            auto seg_offset = fetched.seg_offsets_[i];
+            if (seg_offset == INVALID_SEG_OFFSET) {
+                // fewer rows than asked for, a wider search finds no more
+                exhausted = true;
+                break;
+            }
+            if (dst == (q + 1) * topk || handed_out.count(seg_offset)) {
+                continue;
+            }
+            seg_offsets[dst] = seg_offset;
+            distances[dst] = fetched.distances_[i];
+            ++dst;
+        }
+    }
+
+    iterator.search_info.topk_ = topk;
+    iterator.seg_offsets = std::move(candidates.mutable_seg_offsets());
+    iterator.distances = std::move(candidates.mutable_distances());
+    iterator.exhausted = exhausted;
+}
+
+bool
+SegmentInternalInterface::mask_with_delete(BitsetType& bitset,
+                                           int64_t ins_barrier,
+                                           Timestamp timestamp) const {
+    bool cached = false;
+    auto deleted = get_deleted_snapshot(ins_barrier, timestamp, &cached);
+    if (deleted != nullptr) {
+        deleted->mask(bitset);
+    }
+    return cached;
+}
+
+void
+SegmentInternalInterface::remove_deleted(std::vector<SegOffset>& offsets,
+                                         int64_t ins_barrier,
+                                         Timestamp timestamp) const {
+    auto deleted = get_deleted_snapshot(ins_barrier, timestamp);
+    if (deleted == nullptr) {
+        return;
+    }
+    auto is_deleted = [&](SegOffset offset) {
+        return deleted->test(offset.get());
+    };
+    offsets.erase(std::remove_if(offsets.begin(), offsets.end(), is_deleted),
+                  offsets.end());
+}
+
+bool
+SegmentInternalInterface::mask_skipped(BitsetType& matches,
+                                       int64_t ins_barrier,
+                                       Timestamp timestamp,
+                                       bool* delete_cached) const {
+    AssertInfo(int64_t(matches.size()) == ins_barrier,
+               "bitset size not equal to insert barrier");
+    bool cached = false;
+    auto deleted = get_deleted_snapshot(ins_barrier, timestamp, &cached);
+    if (delete_cached != nullptr) {
+        *delete_cached = cached;
+    }
+    auto inserted_later = get_timestamp_mask(timestamp);
+    auto later_blocks =
+        inserted_later != nullptr ? inserted_later->data() : nullptr;
+
+    // the deletes are paged, so a page of blocks at a time
+    using block_type = BitsetType::block_type;
+    constexpr int64_t blocks_per_page =
+        DeletedRecord::Snapshot::bits_per_page / BitsetType::bits_per_block;
+    auto blocks = matches.data();
+    int64_t num_blocks = matches.num_blocks();
+    block_type skipped_all = ~block_type(0);
+    for (int64_t begin = 0; begin < num_blocks; begin += blocks_per_page) {
+        auto end = std::min(begin + blocks_per_page, num_blocks);
+        auto deleted_blocks = deleted != nullptr
+                                  ? deleted->page(begin / blocks_per_page)
+                                  : nullptr;
+        for (auto i = begin; i < end; ++i) {
+            auto block = ~blocks[i];
+            if (later_blocks != nullptr) {
+                block |= later_blocks[i];
+            }
+            if (deleted_blocks != nullptr) {
+                block |= deleted_blocks[i - begin];
+            }
+            blocks[i] = block;
+            skipped_all &= block;
+        }
+    }
+    // the bits past the size were set along, which the check above counts
+    // as skipped
+    auto tail = matches.size() % BitsetType::bits_per_block;
+    if (tail != 0) {
+        blocks[num_blocks - 1] &= (block_type(1) << tail) - 1;
+    }
+    return skipped_all == ~block_type(0);
+}
+
+// without an ordered pk index, select the smallest pks of all the rows
+std::vector<SegOffset>
+SegmentInternalInterface::search_ids_by_pk(const BitsetType& bitset,
+                                           Timestamp timestamp,
+                                           int64_t limit) const {
+    return order_by_pk(search_ids(bitset, timestamp, -1), limit);
+}
+
+std::vector<SegOffset>
+SegmentInternalInterface::order_by_pk(const std::vector<SegOffset>& offsets,
+                                      int64_t limit) const {
+    auto pk_field_id = get_schema().get_primary_field_id();
+    AssertInfo(pk_field_id.has_value(), "primary key field not found");
+    auto pks = bulk_subscript(pk_field_id.value(),
+                              reinterpret_cast<const int64_t*>(offsets.data()),
+                              offsets.size());
+
+    int64_t keep = offsets.size();
+    if (limit >= 0) {
+        keep = std::min(keep, limit);
+    }
+    std::vector<int64_t> order(offsets.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto select = [&](const auto& keys) {
+        // ties keep segment order, as the pk index would
+        std::partial_sort(order.begin(),
+                          order.begin() + keep,
+                          order.end(),
+                          [&keys](int64_t a, int64_t b) {
+                              return keys[a] < keys[b] ||
+                                     (keys[a] == keys[b] && a < b);
+                          });
+    };
+    switch (get_schema()[pk_field_id.value()].get_data_type()) {
+        case DataType::INT64: {
+            select(pks->scalars().long_data().data());
+            break;
+        }
+        case DataType::VARCHAR: {
+            select(pks->scalars().string_data().data());
+            break;
+        }
+        default: {
+            PanicInfo("unsupported primary key type");
+        }
+    }
+
+    std::vector<SegOffset> res_offsets;
+    res_offsets.reserve(keep);
+    for (int64_t i = 0; i < keep; ++i) {
+        res_offsets.push_back(offsets[order[i]]);
+    }
+    return res_offsets;
+}
+
 std::unique_ptr<proto::segcore::RetrieveResults>
 SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
                                    Timestamp timestamp) const {
+    return std::unique_ptr<proto::segcore::RetrieveResults>(
+        RetrieveOnArena(plan, timestamp, nullptr));
+}
+
+proto::segcore::RetrieveResults*
+SegmentInternalInterface::RetrieveOnArena(
+    const query::RetrievePlan* plan,
+    Timestamp timestamp,
+    std::unique_ptr<google::protobuf::Arena>* arena) const {
+    SEGCORE_METRIC_TIMER(RetrieveLatency);
     std::shared_lock lck(mutex_);
-    auto results = std::make_unique<proto::segcore::RetrieveResults>();
-    query::ExecPlanNodeVisitor visitor(*this, timestamp);
+    NumaNodeScope numa_scope(SegmentNumaNode(get_segment_id()));
+    ScratchScope scratch_scope;
+    // the filter bitset
+    auto scratch = ReserveScratch(get_active_count(timestamp) / 8, "retrieve");
+    query::ExecPlanNodeVisitor visitor(
+        *this, timestamp, plan->bindings_.get());
+    visitor.set_cancel_token(&plan->cancel_token_);
     auto retrieve_results = visitor.get_retrieve_result(*plan->plan_node_);
     retrieve_results.segment_ = (void*)this;
+
+    auto pk_field_id = plan->schema_.get_primary_field_id();
+    if (arena != nullptr) {
+        // the offsets, the system fields and the ids go on the arena, the
+        // columns gathered are owned by it
+        int64_t row_bytes = sizeof(int64_t);
+        for (auto field_id : plan->field_ids_) {
+            if (SystemProperty::Instance().IsSystem(field_id)) {
+                row_bytes += sizeof(int64_t);
+            } else if (pk_field_id.has_value() &&
+                       pk_field_id.value() == field_id) {
+                row_bytes += ResultValueBytes(plan->schema_[field_id]);
+            }
+        }
+        *arena = std::make_unique<google::protobuf::Arena>(ResultArenaOptions(
+            retrieve_results.result_offsets_.size() * row_bytes));
+    }
+    auto results = google::protobuf::Arena::CreateMessage<
+        proto::segcore::RetrieveResults>(arena != nullptr ? arena->get()
+                                                          : nullptr);
+    auto& aggregates = plan->plan_node_->aggregates_;
+    if (!aggregates.empty()) {
+        auto matches = std::move(retrieve_results.matches_)
+                           .value_or(BitsetType(get_row_count(), false));
+        for (auto& aggregate : aggregates) {
+            results->mutable_aggregates()->AddAllocated(
+                Aggregate(*this, aggregate, matches).release());
+        }
+        return results;
+    }
+    SEGCORE_METRIC_ADD(RetrieveRows, retrieve_results.result_offsets_.size());
     results->mutable_offset()->Add(retrieve_results.result_offsets_.begin(),
                                    retrieve_results.result_offsets_.end());
 
     auto fields_data = results->mutable_fields_data();
     auto ids = results->mutable_ids();
-    auto pk_field_id = plan->schema_.get_primary_field_id();
     for (auto field_id : plan->field_ids_) {
+        plan->cancel_token_.Check();
         if (SystemProperty::Instance().IsSystem(field_id)) {
             auto system_type =
                 SystemProperty::Instance().GetSystemFieldType(field_id);
@@ -101,7 +745,7 @@ SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
                            size,
                            output.data());
 
-            auto data_array = std::make_unique<DataArray>();
+            auto data_array = fields_data->Add();
             data_array->set_field_id(field_id.get());
             data_array->set_type(milvus::proto::schema::DataType::Int64);
 
@@ -109,32 +753,34 @@ SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
             auto data = reinterpret_cast<const int64_t*>(output.data());
             auto obj = scalar_array->mutable_long_data();
             obj->mutable_data()->Add(data, data + size);
-
-            fields_data->AddAllocated(data_array.release());
             continue;
         }
 
         auto& field_meta = plan->schema_[field_id];
 
+        record_field_access(field_id, FieldAccess::SubscriptCalls);
+        record_field_access(field_id,
+                            FieldAccess::SubscriptRows,
+                            retrieve_results.result_offsets_.size());
         auto col = bulk_subscript(field_id,
                                   retrieve_results.result_offsets_.data(),
                                   retrieve_results.result_offsets_.size());
         auto col_data = col.release();
         fields_data->AddAllocated(col_data);
         if (pk_field_id.has_value() && pk_field_id.value() == field_id) {
+            // the ids copy the gathered pk column in one go, reading it in
+            // place rather than through a copy of the whole array
             switch (field_meta.get_data_type()) {
                 case DataType::INT64: {
-                    auto int_ids = ids->mutable_int_id();
-                    auto src_data = col_data->scalars().long_data();
-                    int_ids->mutable_data()->Add(src_data.data().begin(),
-                                                 src_data.data().end());
+                    auto& src_data = col_data->scalars().long_data();
+                    ids->mutable_int_id()->mutable_data()->CopyFrom(
+                        src_data.data());
                     break;
                 }
                 case DataType::VARCHAR: {
-                    auto str_ids = ids->mutable_str_id();
-                    auto src_data = col_data->scalars().string_data();
-                    for (auto i = 0; i < src_data.data_size(); ++i)
-                        *(str_ids->mutable_data()->Add()) = src_data.data(i);
+                    auto& src_data = col_data->scalars().string_data();
+                    ids->mutable_str_id()->mutable_data()->CopyFrom(
+                        src_data.data());
                     break;
                 }
                 default: {
@@ -146,6 +792,64 @@ SegmentInternalInterface::Retrieve(const query::RetrievePlan* plan,
     return results;
 }
 
+std::unique_ptr<IdArray>
+SegmentInternalInterface::DeleteByExpr(const query::RetrievePlan* plan,
+                                       Timestamp timestamp) {
+    AssertInfo(timestamp > 0, "invalid delete timestamp");
+    AssertInfo(plan->plan_node_->aggregates_.empty() &&
+                   plan->plan_node_->limit_ == 0,
+               "a delete by expression takes no aggregates nor limit");
+    auto pk_field_id = get_schema().get_primary_field_id();
+    AssertInfo(pk_field_id.has_value(), "primary key field not found");
+    auto pk_type = get_schema()[pk_field_id.value()].get_data_type();
+
+    // a delete at timestamp hides the rows inserted before it, so those
+    // are the rows filtered
+    auto ids = std::make_unique<IdArray>();
+    {
+        std::shared_lock lck(mutex_);
+        query::ExecPlanNodeVisitor visitor(
+            *this, timestamp - 1, plan->bindings_.get());
+        visitor.set_cancel_token(&plan->cancel_token_);
+        auto retrieve_results = visitor.get_retrieve_result(*plan->plan_node_);
+        auto& offsets = retrieve_results.result_offsets_;
+        if (offsets.empty()) {
+            return ids;
+        }
+        auto pks =
+            bulk_subscript(pk_field_id.value(), offsets.data(), offsets.size());
+        switch (pk_type) {
+            case DataType::INT64: {
+                ids->mutable_int_id()->mutable_data()->Swap(
+                    pks->mutable_scalars()
+                        ->mutable_long_data()
+                        ->mutable_data());
+                break;
+            }
+            case DataType::VARCHAR: {
+                ids->mutable_str_id()->mutable_data()->Swap(
+                    pks->mutable_scalars()
+                        ->mutable_string_data()
+                        ->mutable_data());
+                break;
+            }
+            default: {
+                PanicInfo("unsupported data type");
+            }
+        }
+    }
+
+    // the deletes go through the same path as those of the message stream,
+    // mutex_ is not held by it
+    auto size = GetSizeOfIdArray(*ids);
+    std::vector<Timestamp> timestamps(size, timestamp);
+    auto reserved_offset = PreDelete(size);
+    Delete(reserved_offset, size, ids.get(), timestamps.data());
+    LOG_SEGCORE_DEBUG_ << "deleted " << size << " rows of segment "
+                       << get_segment_id() << " by expression";
+    return ids;
+}
+
 int64_t
 SegmentInternalInterface::get_real_count() const {
     auto insert_cnt = get_row_count();
@@ -19,12 +19,21 @@
 #include <index/ScalarIndex.h>
 
 #include "DeletedRecord.h"
+#include "EncodedColumn.h"
+#include "FieldAccessStats.h"
 #include "FieldIndexing.h"
+#include "FilterCache.h"
+#include "PartitionKeys.h"
+#include "SearchCache.h"
+#include "SearchIterator.h"
+#include "ZoneMap.h"
 #include "common/Schema.h"
 #include "common/Span.h"
 #include "common/SystemProperty.h"
 #include "common/Types.h"
+#include "common/Jemalloc.h"
 #include "common/LoadInfo.h"
+#include "common/MemoryUsage.h"
 #include "common/BitsetView.h"
 #include "common/QueryResult.h"
 #include "common/QueryInfo.h"
@@ -52,12 +61,32 @@ class SegmentInterface {
            const query::PlaceholderGroup* placeholder_group,
            Timestamp timestamp) const = 0;
 
+    // paged search: OpenSearch keeps the filter and the queries of a
+    // search under the returned handle, every SearchNext returns the next
+    // page_size results of each query until CloseSearch; a handle left
+    // idle longer than the search iterator ttl expires
+    virtual int64_t
+    OpenSearch(const query::Plan* plan,
+               const query::PlaceholderGroup* placeholder_group,
+               Timestamp timestamp) const = 0;
+
+    virtual std::unique_ptr<SearchResult>
+    SearchNext(int64_t handle, int64_t page_size) const = 0;
+
+    virtual void
+    CloseSearch(int64_t handle) const = 0;
+
     virtual std::unique_ptr<proto::segcore::RetrieveResults>
     Retrieve(const query::RetrievePlan* Plan, Timestamp timestamp) const = 0;
 
-    // TODO: memory use is not correct when load string or load string index
-    virtual int64_t
-    GetMemoryUsageInBytes() const = 0;
+    // bytes held by the segment, by component
+    virtual MemoryUsage
+    GetMemoryUsage() const = 0;
+
+    int64_t
+    GetMemoryUsageInBytes() const {
+        return GetMemoryUsage().Total();
+    }
 
     virtual int64_t
     get_row_count() const = 0;
@@ -88,6 +117,11 @@ class SegmentInterface {
 
     virtual SegmentType
     type() const = 0;
+
+    // whether Retrieve returns the data of the field, otherwise the caller
+    // fills the vectors in from the binlogs
+    virtual bool
+    HasRawData(int64_t field_id) const = 0;
 };
 
 // internal API for DSL calculation
@@ -111,6 +145,32 @@ class SegmentInternalInterface : public SegmentInterface {
         return *ptr;
     }
 
+    // min/max of the zones of a raw data chunk, nullptr if not tracked
+    template <typename T>
+    std::shared_ptr<const ZoneMap<T>>
+    chunk_zone_map(FieldId field_id, int64_t chunk_id) const {
+        return std::dynamic_pointer_cast<const ZoneMap<T>>(
+            chunk_zone_map_impl(field_id, chunk_id));
+    }
+
+    // the values of the partition key field the segment holds, nullptr if
+    // it does not track them
+    template <typename K>
+    std::shared_ptr<const PartitionKeys<K>>
+    partition_keys() const {
+        return std::dynamic_pointer_cast<const PartitionKeys<K>>(
+            partition_keys_impl());
+    }
+
+    // the encoded raw data of a chunk, nullptr if it is stored plain
+    template <typename T>
+    std::shared_ptr<const EncodedColumn<T>>
+    chunk_encoded(FieldId field_id, int64_t chunk_id) const {
+        static_assert(IsEncodable<T>);
+        return std::dynamic_pointer_cast<const EncodedColumn<T>>(
+            chunk_encoded_impl(field_id, chunk_id));
+    }
+
     std::unique_ptr<SearchResult>
     Search(const query::Plan* Plan,
            const query::PlaceholderGroup* placeholder_group,
@@ -128,6 +188,31 @@ class SegmentInternalInterface : public SegmentInterface {
     Retrieve(const query::RetrievePlan* plan,
              Timestamp timestamp) const override;
 
+    // deletes the rows matching the filter of plan among those inserted
+    // before timestamp, with deletes at timestamp as Delete records them;
+    // returns their pks, for the replication of the deletes
+    std::unique_ptr<IdArray>
+    DeleteByExpr(const query::RetrievePlan* plan, Timestamp timestamp);
+
+    // Retrieve with the results built on an arena, created into *arena
+    // once the rows matched are known, which owns them; a null arena
+    // leaves them to the caller
+    proto::segcore::RetrieveResults*
+    RetrieveOnArena(const query::RetrievePlan* plan,
+                    Timestamp timestamp,
+                    std::unique_ptr<google::protobuf::Arena>* arena) const;
+
+    int64_t
+    OpenSearch(const query::Plan* plan,
+               const query::PlaceholderGroup* placeholder_group,
+               Timestamp timestamp) const override;
+
+    std::unique_ptr<SearchResult>
+    SearchNext(int64_t handle, int64_t page_size) const override;
+
+    void
+    CloseSearch(int64_t handle) const override;
+
     virtual bool
     HasIndex(FieldId field_id) const = 0;
 
@@ -140,6 +225,21 @@ class SegmentInternalInterface : public SegmentInterface {
     int64_t
     get_real_count() const override;
 
+    // the accesses to each field counted so far
+    const FieldAccessStats&
+    field_access_stats() const {
+        return *field_access_stats_;
+    }
+
+    void
+    record_field_access(FieldId field_id,
+                        FieldAccess access,
+                        int64_t value = 1) const {
+#ifndef MILVUS_DISABLE_METRICS
+        field_access_stats_->Add(field_id, access, value);
+#endif
+    }
+
  public:
     virtual void
     vector_search(SearchInfo& search_info,
@@ -149,10 +249,72 @@ class SegmentInternalInterface : public SegmentInterface {
                   const BitsetView& bitset,
                   SearchResult& output) const = 0;
 
+    // the topk rows of a sparse float vector field by inner product
     virtual void
+    sparse_search(const SearchInfo& search_info,
+                  const SparseFloatRow* queries,
+                  int64_t query_count,
+                  Timestamp timestamp,
+                  const BitsetView& bitset,
+                  SearchResult& output) const = 0;
+
+    // whether the vectors of field_id can be read by offset; searches call
+    // it holding mutex_
+    virtual bool
+    has_raw_vectors(FieldId field_id) const = 0;
+
+    // brute force over the rows at seg_offsets only, for the filters that
+    // leave few rows; needs has_raw_vectors
+    void
+    vector_search_rows(const SearchInfo& search_info,
+                       const void* query_data,
+                       int64_t query_count,
+                       const std::vector<SegOffset>& seg_offsets,
+                       SearchResult& output) const;
+
+    // the values of a bool, int or varchar field at seg_offsets, the ints
+    // and bools as int64_t, to group hits by; searches call it holding
+    // mutex_
+    std::vector<PkType>
+    group_by_values(FieldId field_id,
+                    const int64_t* seg_offsets,
+                    int64_t count) const;
+
+    // the rows among the first ins_barrier deleted at timestamp, nullptr if
+    // none are; cached is set to whether the snapshot was reused without
+    // rebuilding it
+    virtual DeletedRecord::SnapshotPtr
+    get_deleted_snapshot(int64_t ins_barrier,
+                         Timestamp timestamp,
+                         bool* cached = nullptr) const = 0;
+
+    // the rows inserted after timestamp, nullptr if there are none
+    virtual std::shared_ptr<const BitsetType>
+    get_timestamp_mask(Timestamp timestamp) const = 0;
+
+    // returns whether the deletes came from the cached delete bitmap
+    // without rebuilding it
+    bool
     mask_with_delete(BitsetType& bitset,
                      int64_t ins_barrier,
-                     Timestamp timestamp) const = 0;
+                     Timestamp timestamp) const;
+
+    // drops the offsets deleted at timestamp, like mask_with_delete for
+    // a few rows without a bitset over all of them
+    void
+    remove_deleted(std::vector<SegOffset>& offsets,
+                   int64_t ins_barrier,
+                   Timestamp timestamp) const;
+
+    // turns the rows matching a predicate, the first ins_barrier ones,
+    // into the rows a query at timestamp skips: the unmatched ones, those
+    // inserted later and the deleted ones, composed in one pass over the
+    // blocks. returns whether it skips all of them
+    bool
+    mask_skipped(BitsetType& matches,
+                 int64_t ins_barrier,
+                 Timestamp timestamp,
+                 bool* delete_cached = nullptr) const;
 
     // count of chunk that has index available
     virtual int64_t
@@ -177,8 +339,38 @@ class SegmentInternalInterface : public SegmentInterface {
     virtual int64_t
     get_active_count(Timestamp ts) const = 0;
 
+    // cache of predicate results reusable by a query at `timestamp`,
+    // nullptr if the segment keeps none
+    virtual FilterCache*
+    get_filter_cache(Timestamp timestamp) const {
+        return nullptr;
+    }
+
+    // cache of search results reusable by a query at `timestamp`, nullptr
+    // if the segment keeps none; del_barrier is set to the deletes the
+    // query sees
+    virtual SearchCache*
+    get_search_cache(Timestamp timestamp, int64_t& del_barrier) const {
+        return nullptr;
+    }
+
+    // at most limit of the set rows visible at timestamp, all if negative
     virtual std::vector<SegOffset>
-    search_ids(const BitsetType& view, Timestamp timestamp) const = 0;
+    search_ids(const BitsetType& view,
+               Timestamp timestamp,
+               int64_t limit) const = 0;
+
+    // like search_ids, but the rows with the smallest primary keys, in
+    // primary key order
+    virtual std::vector<SegOffset>
+    search_ids_by_pk(const BitsetType& view,
+                     Timestamp timestamp,
+                     int64_t limit) const;
+
+    // at most limit of the offsets, those with the smallest primary keys,
+    // in primary key order
+    std::vector<SegOffset>
+    order_by_pk(const std::vector<SegOffset>& offsets, int64_t limit) const;
 
     virtual std::vector<SegOffset>
     search_ids(const BitsetView& view, Timestamp timestamp) const = 0;
@@ -195,6 +387,24 @@ class SegmentInternalInterface : public SegmentInterface {
     virtual const index::IndexBase*
     chunk_index_impl(FieldId field_id, int64_t chunk_id) const = 0;
 
+    // internal API: return zone map of a raw data chunk, if any
+    virtual std::shared_ptr<const ZoneMapBase>
+    chunk_zone_map_impl(FieldId field_id, int64_t chunk_id) const {
+        return nullptr;
+    }
+
+    // internal API: return the partition keys of the segment, if tracked
+    virtual std::shared_ptr<const PartitionKeysBase>
+    partition_keys_impl() const {
+        return nullptr;
+    }
+
+    // internal API: return the encoded raw data of a chunk, if any
+    virtual std::shared_ptr<const EncodedColumnBase>
+    chunk_encoded_impl(FieldId field_id, int64_t chunk_id) const {
+        return nullptr;
+    }
+
     // calculate output[i] = Vec[seg_offsets[i]}, where Vec binds to system_type
     virtual void
     bulk_subscript(SystemFieldType system_type,
@@ -211,8 +421,20 @@ class SegmentInternalInterface : public SegmentInterface {
     virtual void
     check_search(const query::Plan* plan) const = 0;
 
+ private:
+    // refetches topk candidates per query, keeping the ones handed out
+    void
+    fetch_search_candidates(SearchIterator& iterator, int64_t topk) const;
+
  protected:
+    // the data the segment loads and inserts lives in it, the members
+    // of the segments are freed before it gets purged
+    SegmentArena arena_;
     mutable std::shared_mutex mutex_;
+    // sized for the schema by the segments
+    std::unique_ptr<FieldAccessStats> field_access_stats_;
+    mutable SearchIteratorCache search_iterators_{std::chrono::milliseconds(
+        SegcoreConfig::default_config().get_search_iterator_ttl_ms())};
 };
 
 }  // namespace milvus::segcore
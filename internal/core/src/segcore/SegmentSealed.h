@@ -16,8 +16,10 @@
 
 #include "common/LoadInfo.h"
 #include "pb/segcore.pb.h"
+#include "segcore/SegmentGrowing.h"
 #include "segcore/SegmentInterface.h"
 #include "segcore/Types.h"
+#include "storage/ChunkManager.h"
 
 namespace milvus::segcore {
 
@@ -30,6 +32,40 @@ class SegmentSealed : public SegmentInternalInterface {
     virtual void
     LoadFieldData(const LoadFieldDataInfo& info) = 0;
     virtual void
+    LoadFieldBinlogs(const LoadFieldBinlogInfo& info,
+                     storage::ChunkManager& chunk_manager) = 0;
+    // keeps an output only field in its insert binlogs, read a row group at
+    // a time when its rows are retrieved; it can't be filtered on
+    virtual void
+    LoadLazyFieldBinlogs(
+        const LoadFieldBinlogInfo& info,
+        std::shared_ptr<storage::ChunkManager> chunk_manager) = 0;
+    // loads all the fields of this empty segment from the columns of
+    // parquet files, their indexes built as each field is loaded
+    virtual void
+    LoadParquet(const LoadParquetInfo& info,
+                storage::ChunkManager& chunk_manager) = 0;
+    // maps a fixed width field from the local column cache of the mmap
+    // dir, without its data; false if it is not cached
+    virtual bool
+    LoadCachedFieldData(const LoadFieldDataInfo& info) = 0;
+    // writes the loaded fields of the segment as an image under dir, see
+    // SegmentImage.h
+    virtual void
+    SaveImage(const std::string& dir) const = 0;
+    // restores the fields of the image of this empty segment under dir,
+    // false if there is none; the fields it lacks are loaded as usual
+    virtual bool
+    LoadImage(const std::string& dir) = 0;
+    // takes the acked rows and deletes of a growing segment of the same
+    // schema into this empty one, without going through binlogs
+    virtual void
+    LoadFromGrowing(const SegmentGrowing& growing) = 0;
+    // folds the deletes at or before timestamp into the delete bitmap and
+    // frees their log; no query may read at an earlier timestamp after
+    virtual void
+    CompactDeletes(Timestamp timestamp) = 0;
+    virtual void
     DropIndex(const FieldId field_id) = 0;
     virtual void
     DropFieldData(const FieldId field_id) = 0;
@@ -14,32 +14,84 @@
 #include <fcntl.h>
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
-
+#include <future>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+
+#include "ColumnCache.h"
+#include "Gather.h"
+#include "ParquetImport.h"
+#include "SegcoreConfig.h"
+#include "SegmentGrowingImpl.h"
+#include "SegmentImage.h"
+#include "SharedIvf.h"
 #include "Utils.h"
+#include "common/CancelToken.h"
 #include "common/Consts.h"
 #include "common/FieldMeta.h"
+#include "common/Metrics.h"
 #include "query/ScalarIndex.h"
 #include "query/SearchBruteForce.h"
 #include "query/SearchOnSealed.h"
+#include "simd/hook.h"
+#include "storage/ThreadPool.h"
 
 namespace milvus::segcore {
 
-static inline void
-set_bit(BitsetType& bitset, FieldId field_id, bool flag = true) {
-    auto pos = field_id.get() - START_USER_FIELDID;
-    AssertInfo(pos >= 0, "invalid field id");
-    bitset[pos] = flag;
+namespace {
+
+// the first row_count rows of a growing segment sorted by a field, equal
+// keys in insert order
+template <typename T, typename Record>
+std::vector<int64_t>
+ClusteringOrder(const Record& record, FieldId field_id, int64_t row_count) {
+    using Key = std::conditional_t<std::is_same_v<T, std::string>,
+                                   std::string_view,
+                                   T>;
+    std::vector<Key> keys;
+    keys.reserve(row_count);
+    record.template get_field_data<T>(field_id)->for_each_span(
+        0, row_count, [&](const T* values, int64_t, int64_t n) {
+            keys.insert(keys.end(), values, values + n);
+        });
+    std::vector<int64_t> order(row_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        return keys[a] < keys[b];
+    });
+    return order;
 }
 
-static inline bool
-get_bit(const BitsetType& bitset, FieldId field_id) {
-    auto pos = field_id.get() - START_USER_FIELDID;
-    AssertInfo(pos >= 0, "invalid field id");
+// values[i] becomes values[order[i]]
+template <typename T>
+void
+Permute(std::vector<T>& values, const std::vector<int64_t>& order) {
+    std::vector<T> permuted(values.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        permuted[i] = values[order[i]];
+    }
+    values.swap(permuted);
+}
 
-    return bitset[pos];
+// the rows of each partition key of a sealed column, V is int64_t or
+// std::string_view
+template <typename V>
+std::shared_ptr<PartitionKeysBase>
+BuildPartitionKeys(const V* values, int64_t row_count) {
+    using K = std::conditional_t<std::is_same_v<V, int64_t>,
+                                 int64_t,
+                                 std::string>;
+    auto keys = std::make_shared<PartitionKeys<K>>(true);
+    keys->Add(values, row_count, 0);
+    return keys;
 }
 
+}  // namespace
+
 int64_t
 SegmentSealedImpl::PreDelete(int64_t size) {
     auto reserved_begin = deleted_record_.reserved.fetch_add(size);
@@ -48,16 +100,26 @@ SegmentSealedImpl::PreDelete(int64_t size) {
 
 void
 SegmentSealedImpl::LoadIndex(const LoadIndexInfo& info) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(LoadLatency);
     // print(info);
     // NOTE: lock only when data is ready to avoid starvation
     auto field_id = FieldId(info.field_id);
     auto& field_meta = schema_->operator[](field_id);
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(!clustered_,
+                   "indexes can't be loaded into a segment whose rows were "
+                   "reordered by the clustering key");
+    }
 
     if (field_meta.is_vector()) {
         LoadVecIndex(info);
     } else {
         LoadScalarIndex(info);
     }
+    filter_cache_.Clear();
+    search_cache_.Clear();
 }
 
 void
@@ -68,17 +130,14 @@ SegmentSealedImpl::LoadVecIndex(const LoadIndexInfo& info) {
 
     AssertInfo(info.index_params.count("metric_type"),
                "Can't get metric_type in index_params");
-    auto metric_type = info.index_params.at("metric_type");
+    auto metric_type = SearchMetric(info.index_params.at("metric_type"));
     auto row_count = info.index->Count();
     AssertInfo(row_count > 0, "Index count is 0");
 
+    // the raw vectors may stay loaded besides the index, to refine its hits
     std::unique_lock lck(mutex_);
-    // Don't allow vector raw data and index exist at the same time
-    AssertInfo(!get_bit(field_data_ready_bitset_, field_id),
-               "vector index can't be loaded when raw data exists at field " +
-                   std::to_string(field_id.get()));
     AssertInfo(
-        !get_bit(index_ready_bitset_, field_id),
+        !index_ready_.test(field_id),
         "vector index has been exist at " + std::to_string(field_id.get()));
     if (row_count_opt_.has_value()) {
         AssertInfo(row_count_opt_.value() == row_count,
@@ -93,8 +152,9 @@ SegmentSealedImpl::LoadVecIndex(const LoadIndexInfo& info) {
         field_id,
         metric_type,
         std::move(const_cast<LoadIndexInfo&>(info).index));
+    index_reservations_[field_id] = info.reservation;
 
-    set_bit(index_ready_bitset_, field_id, true);
+    index_ready_.set(field_id, true);
     update_row_count(row_count);
     lck.unlock();
 }
@@ -110,11 +170,11 @@ SegmentSealedImpl::LoadScalarIndex(const LoadIndexInfo& info) {
 
     std::unique_lock lck(mutex_);
     // Don't allow scalar raw data and index exist at the same time
-    AssertInfo(!get_bit(field_data_ready_bitset_, field_id),
+    AssertInfo(!field_data_ready_.test(field_id),
                "scalar index can't be loaded when raw data exists at field " +
                    std::to_string(field_id.get()));
     AssertInfo(
-        !get_bit(index_ready_bitset_, field_id),
+        !index_ready_.test(field_id),
         "scalar index has been exist at " + std::to_string(field_id.get()));
     if (row_count_opt_.has_value()) {
         AssertInfo(row_count_opt_.value() == row_count,
@@ -125,8 +185,10 @@ SegmentSealedImpl::LoadScalarIndex(const LoadIndexInfo& info) {
                        std::to_string(row_count_opt_.value()) + ")");
     }
 
-    scalar_indexings_[field_id] =
-        std::move(const_cast<LoadIndexInfo&>(info).index);
+    auto field_offset = schema_->get_field_offset(field_id);
+    auto& scalar_index = scalar_indexings_[field_offset];
+    scalar_index = std::move(const_cast<LoadIndexInfo&>(info).index);
+    index_reservations_[field_id] = info.reservation;
     // reverse pk from scalar index and set pks to offset
     if (schema_->get_primary_field_id() == field_id) {
         AssertInfo(field_id.get() != -1, "Primary key is -1");
@@ -134,9 +196,11 @@ SegmentSealedImpl::LoadScalarIndex(const LoadIndexInfo& info) {
         switch (field_meta.get_data_type()) {
             case DataType::INT64: {
                 auto int64_index = dynamic_cast<index::ScalarIndex<int64_t>*>(
-                    scalar_indexings_[field_id].get());
+                    scalar_index.get());
+                std::vector<int64_t> pks(row_count);
+                int64_index->ReverseLookupRange(0, row_count, pks.data());
                 for (int i = 0; i < row_count; ++i) {
-                    insert_record_.insert_pk(int64_index->Reverse_Lookup(i), i);
+                    insert_record_.insert_pk(pks[i], i);
                 }
                 insert_record_.seal_pks();
                 break;
@@ -144,10 +208,11 @@ SegmentSealedImpl::LoadScalarIndex(const LoadIndexInfo& info) {
             case DataType::VARCHAR: {
                 auto string_index =
                     dynamic_cast<index::ScalarIndex<std::string>*>(
-                        scalar_indexings_[field_id].get());
+                        scalar_index.get());
+                std::vector<std::string> pks(row_count);
+                string_index->ReverseLookupRange(0, row_count, pks.data());
                 for (int i = 0; i < row_count; ++i) {
-                    insert_record_.insert_pk(string_index->Reverse_Lookup(i),
-                                             i);
+                    insert_record_.insert_pk(std::move(pks[i]), i);
                 }
                 insert_record_.seal_pks();
                 break;
@@ -158,27 +223,47 @@ SegmentSealedImpl::LoadScalarIndex(const LoadIndexInfo& info) {
         }
     }
 
-    set_bit(index_ready_bitset_, field_id, true);
+    index_ready_.set(field_id, true);
     update_row_count(row_count);
     lck.unlock();
 }
 
 void
-SegmentSealedImpl::LoadFieldData(const LoadFieldDataInfo& info) {
+SegmentSealedImpl::LoadFieldData(const LoadFieldDataInfo& load_info) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(LoadLatency);
     // print(info);
     // NOTE: lock only when data is ready to avoid starvation
-    AssertInfo(info.row_count > 0, "The row count of field data is 0");
-    auto field_id = FieldId(info.field_id);
-    AssertInfo(info.field_data != nullptr, "Field info blob is null");
-    auto size = info.row_count;
-    if (row_count_opt_.has_value()) {
-        AssertInfo(
-            row_count_opt_.value() == size,
-            fmt::format(
-                "field {} has different row count {} to other column's {}",
-                field_id.get(),
-                size,
-                row_count_opt_.value()));
+    AssertInfo(load_info.row_count > 0, "The row count of field data is 0");
+    SEGCORE_METRIC_ADD(LoadRows, load_info.row_count);
+    auto field_id = FieldId(load_info.field_id);
+    AssertInfo(load_info.field_data != nullptr, "Field info blob is null");
+    auto size = load_info.row_count;
+    check_field_row_count(field_id, size);
+
+    // data loaded into memory holds its size of the load budget, fields
+    // the budget has no room for get mapped from the fallback dir if set
+    auto info = load_info;
+    MemoryReservation reservation;
+    if (info.mmap_dir_path == nullptr) {
+        auto is_system = SystemProperty::Instance().IsSystem(field_id);
+        auto bytes = is_system ? size * int64_t(sizeof(int64_t))
+                               : GetDataSize(schema_->operator[](field_id),
+                                             size,
+                                             info.field_data);
+        auto& budget = LoadBudget();
+        auto& fallback_dir =
+            SegcoreConfig::default_config().get_load_fallback_mmap_dir();
+        if (budget.TryReserve(bytes)) {
+            reservation = MemoryReservation(&budget, bytes);
+        } else if (!is_system && !fallback_dir.empty()) {
+            info.mmap_dir_path = fallback_dir.c_str();
+        } else {
+            reservation =
+                budget.Acquire(bytes,
+                               std::chrono::milliseconds(0),
+                               "field " + std::to_string(field_id.get()));
+        }
     }
 
     if (SystemProperty::Instance().IsSystem(field_id)) {
@@ -187,81 +272,935 @@ SegmentSealedImpl::LoadFieldData(const LoadFieldDataInfo& info) {
         if (system_field_type == SystemFieldType::Timestamp) {
             auto timestamps = reinterpret_cast<const Timestamp*>(
                 info.field_data->scalars().long_data().data().data());
-
-            TimestampIndex index;
-            auto min_slice_length = size < 4096 ? 1 : 4096;
-            auto meta = GenerateFakeSlices(timestamps, size, min_slice_length);
-            index.set_length_meta(std::move(meta));
-            index.build_with(timestamps, size);
-
-            // use special index
-            std::unique_lock lck(mutex_);
-            AssertInfo(insert_record_.timestamps_.empty(), "already exists");
-            insert_record_.timestamps_.fill_chunk_data(timestamps, size);
-            insert_record_.timestamp_index_ = std::move(index);
-            AssertInfo(insert_record_.timestamps_.num_chunk() == 1,
-                       "num chunk not equal to 1 for sealed segment");
+            load_timestamps(timestamps, size, std::move(reservation));
         } else {
             AssertInfo(system_field_type == SystemFieldType::RowId,
                        "System field type of id column is not RowId");
             auto row_ids = reinterpret_cast<const idx_t*>(
                 info.field_data->scalars().long_data().data().data());
-            // write data under lock
-            std::unique_lock lck(mutex_);
-            AssertInfo(insert_record_.row_ids_.empty(), "already exists");
-            insert_record_.row_ids_.fill_chunk_data(row_ids, size);
-            AssertInfo(insert_record_.row_ids_.num_chunk() == 1,
-                       "num chunk not equal to 1 for sealed segment");
+            load_row_ids(row_ids, size, std::move(reservation));
         }
-        ++system_ready_count_;
     } else {
         // prepare data
         auto& field_meta = schema_->operator[](field_id);
         auto data_type = field_meta.get_data_type();
         AssertInfo(data_type == DataType(info.field_data->type()),
                    "field type of load data is inconsistent with the schema");
+        // the vectors of a cosine field are stored at unit length
+        std::unique_ptr<DataArray> normalized;
+        if (IsCosineField(field_meta)) {
+            normalized = std::make_unique<DataArray>(*info.field_data);
+            NormalizeVectors(normalized->mutable_vectors()
+                                 ->mutable_float_vector()
+                                 ->mutable_data()
+                                 ->mutable_data(),
+                             info.row_count,
+                             field_meta.get_dim());
+            info.field_data = normalized.get();
+        }
 
-        // write data under lock
-        std::unique_lock lck(mutex_);
+        // Don't allow raw data and index exist at the same time, but for
+        // the raw vectors refining the hits of an index
+        {
+            std::shared_lock lck(mutex_);
+            AssertInfo(!index_ready_.test(field_id) || field_meta.is_vector(),
+                       "field data can't be loaded when indexing exists");
+        }
+
+        // map the data and build its indexes unlocked, so the fields of
+        // a segment load in parallel
+        LoadedField field;
+        if (field_meta.is_sparse_vector()) {
+            auto rows = ParseSparseRows(
+                *info.field_data, info.row_count, field_meta.get_dim());
+            field.sparse_index = std::make_shared<query::SparseInvertedIndex>(
+                rows.data(), info.row_count);
+        } else if (datatype_is_variable(data_type)) {
+            // mmapped fields are paged by the kernel, keep them plain
+            if (info.mmap_dir_path == nullptr) {
+                encode_strings(info, field);
+            }
+            if (field.encoded == nullptr) {
+                field.variable_field.emplace(
+                    get_segment_id(), field_meta, info);
+            }
+            if (schema_->get_primary_field_id() == field_id) {
+                field.pk2offset =
+                    decltype(insert_record_)::create_pk_map(data_type);
+                VisitPks(*info.field_data, [&](auto pks, int64_t n) {
+                    field.pk2offset->insert_batch(pks, n, 0);
+                });
+                field.pk2offset->seal();
+            }
+            if (schema_->get_partition_key_field_id() == field_id) {
+                auto& strings =
+                    info.field_data->scalars().string_data().data();
+                std::vector<std::string_view> keys(strings.begin(),
+                                                   strings.end());
+                field.partition_keys =
+                    BuildPartitionKeys(keys.data(), info.row_count);
+            }
+        } else {
+            bool cached = false;
+            field.field_data = MapFixedField(field_meta, info, cached);
+            build_field_indexes(field_meta, info.row_count, field);
+            // mmapped and shared fields are paged by the kernel, keep them
+            // plain
+            if (info.mmap_dir_path == nullptr && !cached) {
+                encode_field(field_meta, info.row_count, field);
+            }
+        }
+        field.reservation = std::move(reservation);
+        publish_field_data(field_meta, info.row_count, std::move(field));
+    }
+    std::unique_lock lck(mutex_);
+    update_row_count(info.row_count);
+    lck.unlock();
+    filter_cache_.Clear();
+    search_cache_.Clear();
+}
+
+std::unique_ptr<ColumnCache>
+SegmentSealedImpl::OpenColumnCache(const char* mmap_dir_path) {
+    auto& config = SegcoreConfig::default_config();
+    if (mmap_dir_path == nullptr) {
+        auto& dir = config.get_shared_column_dir();
+        auto capacity = config.get_shared_column_bytes();
+        if (dir.empty() || capacity <= 0) {
+            return nullptr;
+        }
+        return std::make_unique<ColumnCache>(dir, capacity);
+    }
+    auto capacity = config.get_column_cache_bytes();
+    if (capacity <= 0) {
+        return nullptr;
+    }
+    auto dir = std::filesystem::path(mmap_dir_path) / "column-cache";
+    return std::make_unique<ColumnCache>(dir.string(), capacity);
+}
+
+void*
+SegmentSealedImpl::MapSharedField(const FieldMeta& field_meta,
+                                  int64_t row_count,
+                                  const std::function<void*()>& map,
+                                  bool& shared) {
+    shared = false;
+    auto cache = OpenColumnCache(nullptr);
+    if (cache == nullptr) {
+        return map();
+    }
+    auto cached = cache->Load(get_segment_id(), field_meta, row_count);
+    if (cached != nullptr) {
+        shared = true;
+        return cached;
+    }
+    auto values = map();
+    auto size = field_meta.get_sizeof() * row_count;
+    try {
+        cached = cache->Store(get_segment_id(), field_meta, row_count, values);
+    } catch (...) {
+        munmap(values, size);
+        throw;
+    }
+    if (cached == nullptr) {
+        // larger than the whole cache
+        return values;
+    }
+    munmap(values, size);
+    shared = true;
+    return cached;
+}
+
+void*
+SegmentSealedImpl::MapFixedField(const FieldMeta& field_meta,
+                                 const LoadFieldDataInfo& info,
+                                 bool& cached) {
+    if (info.mmap_dir_path == nullptr) {
+        return MapSharedField(
+            field_meta,
+            info.row_count,
+            [&] { return CreateMap(get_segment_id(), field_meta, info); },
+            cached);
+    }
+    cached = false;
+    auto cache = OpenColumnCache(info.mmap_dir_path);
+    if (cache == nullptr) {
+        return CreateMap(get_segment_id(), field_meta, info);
+    }
+    // the column gets written to the cache instead of a scratch file
+    auto values_info = info;
+    values_info.mmap_dir_path = nullptr;
+    auto values = CreateMap(get_segment_id(), field_meta, values_info);
+    auto size = field_meta.get_sizeof() * info.row_count;
+    void* stored = nullptr;
+    try {
+        stored =
+            cache->Store(get_segment_id(), field_meta, info.row_count, values);
+    } catch (...) {
+        munmap(values, size);
+        throw;
+    }
+    munmap(values, size);
+    if (stored == nullptr) {
+        // larger than the whole cache
+        return CreateMap(get_segment_id(), field_meta, info);
+    }
+    cached = true;
+    return stored;
+}
+
+bool
+SegmentSealedImpl::LoadCachedFieldData(const LoadFieldDataInfo& info) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(LoadLatency);
+    AssertInfo(info.row_count > 0, "The row count of field data is 0");
+    auto field_id = FieldId(info.field_id);
+    if (SystemProperty::Instance().IsSystem(field_id)) {
+        return false;
+    }
+    auto& field_meta = schema_->operator[](field_id);
+    auto cache = OpenColumnCache(info.mmap_dir_path);
+    if (cache == nullptr || datatype_is_variable(field_meta.get_data_type())) {
+        return false;
+    }
+    return load_cached_column(*cache, field_meta, info.row_count);
+}
+
+bool
+SegmentSealedImpl::load_cached_column(ColumnCache& cache,
+                                      const FieldMeta& field_meta,
+                                      int64_t row_count) {
+    auto field_id = field_meta.get_id();
+    check_field_row_count(field_id, row_count);
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(!index_ready_.test(field_id) || field_meta.is_vector(),
+                   "field data can't be loaded when indexing exists");
+    }
+
+    LoadedField field;
+    field.field_data = cache.Load(get_segment_id(), field_meta, row_count);
+    if (field.field_data == nullptr) {
+        return false;
+    }
+    try {
+        build_field_indexes(field_meta, row_count, field);
+    } catch (...) {
+        munmap(field.field_data, field_meta.get_sizeof() * row_count);
+        throw;
+    }
+    publish_field_data(field_meta, row_count, std::move(field));
+    SEGCORE_METRIC_ADD(LoadRows, row_count);
+
+    std::unique_lock lck(mutex_);
+    update_row_count(row_count);
+    lck.unlock();
+    filter_cache_.Clear();
+    search_cache_.Clear();
+    return true;
+}
+
+void
+SegmentSealedImpl::SaveImage(const std::string& dir) const {
+    int64_t row_count;
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(row_count_opt_.has_value() && system_ready_count_ == 2,
+                   "segment is not loaded");
+        row_count = row_count_opt_.value();
+    }
+    auto image_dir = SegmentImageDir(dir, id_);
+    std::filesystem::remove_all(image_dir);
+    std::filesystem::create_directories(image_dir);
+    auto array_path = [&](FieldId field_id) {
+        return image_dir + "/" + std::to_string(field_id.get()) + ".pb";
+    };
+    std::vector<int64_t> offsets(row_count);
+    std::iota(offsets.begin(), offsets.end(), 0);
+    SegmentImageManifest manifest;
+    manifest.segment_id = id_;
+    manifest.row_count = row_count;
+
+    for (auto [field_id, type] :
+         {std::make_pair(RowFieldID, SystemFieldType::RowId),
+          std::make_pair(TimestampFieldID, SystemFieldType::Timestamp)}) {
+        DataArray array;
+        array.set_field_id(field_id.get());
+        array.set_type(proto::schema::DataType::Int64);
+        auto data = array.mutable_scalars()->mutable_long_data();
+        data->mutable_data()->Resize(row_count, 0);
+        bulk_subscript(
+            type, offsets.data(), row_count, data->mutable_data()->data());
+        WriteDataArray(array_path(field_id), array);
+        manifest.arrays.push_back(field_id.get());
+    }
+
+    // fields loaded as an index are loaded as usual
+    ColumnCache columns(dir, SEGMENT_IMAGE_CAPACITY);
+    for (auto& [field_id, field_meta] : schema_->get_fields()) {
+        if (!field_data_ready_.test(field_id)) {
+            continue;
+        }
+        auto array = bulk_subscript(field_id, offsets.data(), row_count);
+        if (datatype_is_variable(field_meta.get_data_type())) {
+            WriteDataArray(array_path(field_id), *array);
+            manifest.arrays.push_back(field_id.get());
+            continue;
+        }
+        // an encoded column is decoded back into the plain layout
+        LoadFieldDataInfo info{field_id.get(), array.get(), row_count};
+        auto values = CreateMap(id_, field_meta, info);
+        auto size = field_meta.get_sizeof() * row_count;
+        void* stored = nullptr;
+        try {
+            stored = columns.Store(id_, field_meta, row_count, values);
+        } catch (...) {
+            munmap(values, size);
+            throw;
+        }
+        munmap(values, size);
+        AssertInfo(stored != nullptr,
+                   fmt::format("failed to store field {} in the image",
+                               field_id.get()));
+        munmap(stored, size);
+        manifest.columns.push_back(field_id.get());
+    }
+    WriteSegmentImageManifest(dir, manifest);
+}
+
+bool
+SegmentSealedImpl::LoadImage(const std::string& dir) {
+    auto manifest = ReadSegmentImageManifest(dir, id_);
+    if (!manifest.has_value()) {
+        return false;
+    }
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(!row_count_opt_.has_value() && system_ready_count_ == 0,
+                   "segment already has data");
+    }
+    auto image_dir = SegmentImageDir(dir, id_);
+    auto row_count = manifest->row_count;
+    for (auto field_id : manifest->arrays) {
+        auto array = ReadDataArray(image_dir + "/" + std::to_string(field_id) +
+                                   ".pb");
+        LoadFieldData({field_id, array.get(), row_count});
+    }
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(LoadLatency);
+    ColumnCache columns(dir, SEGMENT_IMAGE_CAPACITY);
+    for (auto field_id : manifest->columns) {
+        auto& field_meta = schema_->operator[](FieldId(field_id));
+        AssertInfo(load_cached_column(columns, field_meta, row_count),
+                   fmt::format("field {} of the image of segment {} is "
+                               "missing or corrupted",
+                               field_id,
+                               id_));
+    }
+    return true;
+}
+
+void
+SegmentSealedImpl::LoadParquet(const LoadParquetInfo& info,
+                               storage::ChunkManager& chunk_manager) {
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(!row_count_opt_.has_value() && system_ready_count_ == 0,
+                   "segment already has data");
+    }
+    int64_t row_count;
+    auto arrays =
+        ReadParquetFields(*schema_, info.files, chunk_manager, row_count);
+    AssertInfo(row_count > 0, "parquet files hold no rows");
+
+    for (auto field_id : {RowFieldID, TimestampFieldID}) {
+        DataArray array;
+        array.set_field_id(field_id.get());
+        array.set_type(proto::schema::DataType::Int64);
+        auto data = array.mutable_scalars()->mutable_long_data();
+        if (field_id == RowFieldID) {
+            data->mutable_data()->Resize(row_count, 0);
+            std::iota(data->mutable_data()->begin(),
+                      data->mutable_data()->end(),
+                      info.row_id_begin);
+        } else {
+            data->mutable_data()->Resize(row_count, info.timestamp);
+        }
+        LoadFieldData({field_id.get(), &array, row_count});
+    }
+
+    // a field per task, all of them finish before the arrays go away
+    auto& pool = ThreadPool::GetInstance(ThreadPoolType::LOAD);
+    std::vector<std::future<void>> loads;
+    for (auto& [field_id, array] : arrays) {
+        LoadFieldDataInfo field_info{field_id.get(), array.get(), row_count};
+        loads.push_back(
+            pool.Submit([this, field_info] { LoadFieldData(field_info); }));
+    }
+    for (auto& load : loads) {
+        load.wait();
+    }
+    for (auto& load : loads) {
+        load.get();
+    }
+}
+
+bool
+SegmentSealedImpl::PrefetchFieldBinlogs(int64_t segment_id,
+                                        const FieldMeta& field_meta,
+                                        const LoadFieldBinlogInfo& info,
+                                        const char* mmap_dir_path,
+                                        storage::ChunkManager& chunk_manager) {
+    AssertInfo(info.row_count > 0, "The row count of field data is 0");
+    auto cache = OpenColumnCache(mmap_dir_path);
+    if (cache == nullptr || datatype_is_variable(field_meta.get_data_type())) {
+        return false;
+    }
+    auto size = field_meta.get_sizeof() * info.row_count;
+    auto cached = cache->Load(segment_id, field_meta, info.row_count);
+    if (cached == nullptr) {
+        auto values = MapFieldBinlogs(
+            field_meta, info.binlog_paths, info.row_count, chunk_manager);
+        try {
+            cached =
+                cache->Store(segment_id, field_meta, info.row_count, values);
+        } catch (...) {
+            munmap(values, size);
+            throw;
+        }
+        munmap(values, size);
+    }
+    if (cached == nullptr) {
+        return false;
+    }
+    munmap(cached, size);
+    return true;
+}
 
-        // Don't allow raw data and index exist at the same time
-        AssertInfo(!get_bit(index_ready_bitset_, field_id),
+void
+SegmentSealedImpl::LoadFieldBinlogs(const LoadFieldBinlogInfo& info,
+                                    storage::ChunkManager& chunk_manager) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(LoadLatency);
+    AssertInfo(info.row_count > 0, "The row count of field data is 0");
+    SEGCORE_METRIC_ADD(LoadRows, info.row_count);
+    auto field_id = FieldId(info.field_id);
+    AssertInfo(!SystemProperty::Instance().IsSystem(field_id),
+               "system fields can't be loaded from binlogs");
+    check_field_row_count(field_id, info.row_count);
+    auto& field_meta = schema_->operator[](field_id);
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(!index_ready_.test(field_id) || field_meta.is_vector(),
                    "field data can't be loaded when indexing exists");
+    }
+
+    LoadedField field;
+    bool shared = false;
+    field.field_data = MapSharedField(
+        field_meta,
+        info.row_count,
+        [&] {
+            return MapFieldBinlogs(
+                field_meta, info.binlog_paths, info.row_count, chunk_manager);
+        },
+        shared);
+    build_field_indexes(field_meta, info.row_count, field);
+    if (!shared) {
+        encode_field(field_meta, info.row_count, field);
+    }
+    publish_field_data(field_meta, info.row_count, std::move(field));
+
+    std::unique_lock lck(mutex_);
+    update_row_count(info.row_count);
+    lck.unlock();
+    filter_cache_.Clear();
+    search_cache_.Clear();
+}
+
+void
+SegmentSealedImpl::LoadLazyFieldBinlogs(
+    const LoadFieldBinlogInfo& info,
+    std::shared_ptr<storage::ChunkManager> chunk_manager) {
+    SEGCORE_METRIC_TIMER(LoadLatency);
+    AssertInfo(info.row_count > 0, "The row count of field data is 0");
+    auto field_id = FieldId(info.field_id);
+    AssertInfo(!SystemProperty::Instance().IsSystem(field_id),
+               "system fields can't be loaded lazily");
+    check_field_row_count(field_id, info.row_count);
+    auto& field_meta = schema_->operator[](field_id);
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(!index_ready_.test(field_id) &&
+                       !field_data_ready_.test(field_id),
+                   "field is loaded already");
+    }
 
-        void* field_data = nullptr;
-        size_t size = 0;
+    // only the binlog footers are read
+    auto field = std::make_shared<const LazyField>(
+        field_meta,
+        info.binlog_paths,
+        std::move(chunk_manager),
+        SegcoreConfig::default_config().get_lazy_field_cache_bytes());
+    AssertInfo(field->row_count() == info.row_count,
+               fmt::format("binlogs hold {} rows, expected {}",
+                           field->row_count(),
+                           info.row_count));
+    {
+        std::lock_guard lazy_lck(lazy_fields_mutex_);
+        lazy_fields_[field_id] = std::move(field);
+    }
+    std::unique_lock lck(mutex_);
+    update_row_count(info.row_count);
+}
+
+void
+SegmentSealedImpl::LoadFromGrowing(const SegmentGrowing& segment) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(LoadLatency);
+    auto growing = dynamic_cast<const SegmentGrowingImpl*>(&segment);
+    AssertInfo(growing != nullptr, "segment is not a growing segment");
+    {
+        std::shared_lock lck(mutex_);
+        AssertInfo(!row_count_opt_.has_value() && system_ready_count_ == 0,
+                   "segment already has data");
+    }
+    // the rows inserted from now on are not taken
+    auto& record = growing->get_insert_record();
+    auto row_count = record.ack_responder_.GetAck();
+    AssertInfo(row_count > 0, "The row count of growing segment is 0");
+    SEGCORE_METRIC_ADD(LoadRows, row_count);
+    auto& budget = LoadBudget();
+    auto reserve = [&](FieldId field_id, int64_t bytes) {
+        return budget.Acquire(bytes,
+                              std::chrono::milliseconds(0),
+                              "field " + std::to_string(field_id.get()));
+    };
+
+    // the rows sorted by the clustering key, row i of this segment is row
+    // order[i] of the growing one
+    std::vector<int64_t> order;
+    if (auto key = schema_->get_clustering_key_field_id()) {
+        auto data_type = schema_->operator[](*key).get_data_type();
+        switch (data_type) {
+            case DataType::INT8:
+                order = ClusteringOrder<int8_t>(record, *key, row_count);
+                break;
+            case DataType::INT16:
+                order = ClusteringOrder<int16_t>(record, *key, row_count);
+                break;
+            case DataType::INT32:
+                order = ClusteringOrder<int32_t>(record, *key, row_count);
+                break;
+            case DataType::INT64:
+                order = ClusteringOrder<int64_t>(record, *key, row_count);
+                break;
+            case DataType::VARCHAR:
+            case DataType::STRING:
+                order = ClusteringOrder<std::string>(record, *key, row_count);
+                break;
+            default:
+                PanicInfo("unsupported clustering key type: " +
+                          datatype_name(data_type));
+        }
+    }
+    auto ordered = order.empty() ? nullptr : order.data();
+
+    // step 1: system fields, the chunks concatenated
+    std::vector<Timestamp> timestamps(row_count);
+    record.timestamps_.for_each_span(
+        0, row_count, [&](const Timestamp* values, int64_t begin, int64_t n) {
+            std::copy_n(values, n, timestamps.data() + begin);
+        });
+    std::vector<idx_t> row_ids(row_count);
+    record.row_ids_.for_each_span(
+        0, row_count, [&](const idx_t* values, int64_t begin, int64_t n) {
+            std::copy_n(values, n, row_ids.data() + begin);
+        });
+    if (ordered != nullptr) {
+        Permute(timestamps, order);
+        Permute(row_ids, order);
+    }
+    auto bytes = row_count * int64_t(sizeof(int64_t));
+    load_timestamps(
+        timestamps.data(), row_count, reserve(TimestampFieldID, bytes));
+    load_row_ids(row_ids.data(), row_count, reserve(RowFieldID, bytes));
+
+    // step 2: user fields, into contiguous columns and a sealed pk index
+    for (auto& [field_id, field_meta] : schema_->get_fields()) {
+        {
+            std::shared_lock lck(mutex_);
+            AssertInfo(!index_ready_.test(field_id),
+                       "field data can't be loaded when indexing exists");
+        }
+        LoadedField field;
+        auto data_type = field_meta.get_data_type();
         if (datatype_is_variable(data_type)) {
-            VariableField field(get_segment_id(), field_meta, info);
-            size = field.size();
-            field_data = reinterpret_cast<void*>(field.data());
-            variable_fields_.emplace(field_id, std::move(field));
+            auto& column = *record.get_field_data<std::string>(field_id);
+            field.variable_field.emplace(column, row_count, ordered);
+            auto is_pk = schema_->get_primary_field_id() == field_id;
+            if (is_pk ||
+                schema_->get_partition_key_field_id() == field_id) {
+                std::vector<std::string_view> values;
+                values.reserve(row_count);
+                column.for_each_span(
+                    0,
+                    row_count,
+                    [&](const std::string* data, int64_t, int64_t n) {
+                        values.insert(values.end(), data, data + n);
+                    });
+                if (ordered != nullptr) {
+                    Permute(values, order);
+                }
+                if (is_pk) {
+                    field.pk2offset =
+                        decltype(insert_record_)::create_pk_map(data_type);
+                    field.pk2offset->insert_batch(
+                        values.data(), row_count, 0);
+                    field.pk2offset->seal();
+                }
+                if (schema_->get_partition_key_field_id() == field_id) {
+                    field.partition_keys =
+                        BuildPartitionKeys(values.data(), row_count);
+                }
+            }
+            field.reservation =
+                reserve(field_id, field.variable_field->memory_usage());
         } else {
-            field_data = CreateMap(get_segment_id(), field_meta, info);
-            fixed_fields_[field_id] = field_data;
-            size = field_meta.get_sizeof() * info.row_count;
+            field.reservation =
+                reserve(field_id, field_meta.get_sizeof() * row_count);
+            field.field_data =
+                MapGrowingColumn(field_meta,
+                                 *record.get_field_data_base(field_id),
+                                 row_count,
+                                 ordered);
+            build_field_indexes(field_meta, row_count, field);
+            encode_field(field_meta, row_count, field);
         }
+        publish_field_data(field_meta, row_count, std::move(field));
+    }
+    std::unique_lock lck(mutex_);
+    update_row_count(row_count);
+    clustered_ = ordered != nullptr;
+    lck.unlock();
+    filter_cache_.Clear();
+    search_cache_.Clear();
+
+    // step 3: the deletes, by pk and so independent of the row order
+    auto& deletes = growing->get_deleted_record();
+    auto delete_count = deletes.ack_responder_.GetAck();
+    if (delete_count == 0) {
+        return;
+    }
+    std::vector<Timestamp> delete_timestamps(delete_count);
+    deletes.timestamps_.for_each_span(
+        0,
+        delete_count,
+        [&](const Timestamp* values, int64_t begin, int64_t n) {
+            std::copy_n(values, n, delete_timestamps.data() + begin);
+        });
+    std::vector<int64_t> int_pks;
+    std::vector<std::string_view> str_pks;
+    deletes.for_each_pk_span(
+        0, delete_count, [&](auto pks, int64_t, int64_t n) {
+            if constexpr (std::is_same_v<decltype(pks), const int64_t*>) {
+                int_pks.insert(int_pks.end(), pks, pks + n);
+            } else {
+                str_pks.insert(str_pks.end(), pks, pks + n);
+            }
+        });
+    auto reserved_begin = deleted_record_.reserved.fetch_add(delete_count);
+    if (deleted_record_.pk_type() == DataType::INT64) {
+        deleted_record_.push(reserved_begin,
+                             int_pks.data(),
+                             delete_timestamps.data(),
+                             delete_count);
+    } else {
+        deleted_record_.push(reserved_begin,
+                             str_pks.data(),
+                             delete_timestamps.data(),
+                             delete_count);
+    }
+}
+
+void
+SegmentSealedImpl::load_timestamps(const Timestamp* timestamps,
+                                   int64_t size,
+                                   MemoryReservation&& reservation) {
+    TimestampIndex index;
+    auto min_slice_length = size < 4096 ? 1 : 4096;
+    auto meta = GenerateFakeSlices(timestamps, size, min_slice_length);
+    index.set_length_meta(std::move(meta));
+    index.build_with(timestamps, size);
+
+    // use special index
+    std::unique_lock lck(mutex_);
+    AssertInfo(insert_record_.timestamps_.empty(), "already exists");
+    insert_record_.timestamps_.fill_chunk_data(timestamps, size);
+    insert_record_.timestamp_index_ = std::move(index);
+    {
+        std::lock_guard masks_lck(timestamp_masks_mutex_);
+        timestamp_masks_.clear();
+    }
+    AssertInfo(insert_record_.timestamps_.num_chunk() == 1,
+               "num chunk not equal to 1 for sealed segment");
+    field_reservations_[TimestampFieldID] = std::move(reservation);
+    ++system_ready_count_;
+}
 
-        // set pks to offset
-        if (schema_->get_primary_field_id() == field_id) {
-            AssertInfo(field_id.get() != -1, "Primary key is -1");
-            AssertInfo(insert_record_.empty_pks(), "already exists");
-            std::vector<PkType> pks(info.row_count);
-            ParsePksFromFieldData(pks, *info.field_data);
+void
+SegmentSealedImpl::load_row_ids(const idx_t* row_ids,
+                                int64_t size,
+                                MemoryReservation&& reservation) {
+    // write data under lock
+    std::unique_lock lck(mutex_);
+    AssertInfo(insert_record_.row_ids_.empty(), "already exists");
+    insert_record_.row_ids_.fill_chunk_data(row_ids, size);
+    AssertInfo(insert_record_.row_ids_.num_chunk() == 1,
+               "num chunk not equal to 1 for sealed segment");
+    field_reservations_[RowFieldID] = std::move(reservation);
+    ++system_ready_count_;
+}
+
+void
+SegmentSealedImpl::check_field_row_count(FieldId field_id,
+                                         int64_t row_count) const {
+    if (row_count_opt_.has_value()) {
+        AssertInfo(
+            row_count_opt_.value() == row_count,
+            fmt::format(
+                "field {} has different row count {} to other column's {}",
+                field_id.get(),
+                row_count,
+                row_count_opt_.value()));
+    }
+}
 
-            for (int i = 0; i < info.row_count; ++i) {
-                insert_record_.insert_pk(pks[i], i);
+void
+SegmentSealedImpl::build_field_indexes(const FieldMeta& field_meta,
+                                       int64_t row_count,
+                                       LoadedField& field) const {
+    auto data_type = field_meta.get_data_type();
+    if (field.field_data != nullptr) {
+        auto chunk_rows = chunk_rows_ > 0 ? chunk_rows_ : row_count;
+        for (int64_t begin = 0; begin < row_count; begin += chunk_rows) {
+            auto rows = static_cast<const char*>(field.field_data) +
+                        begin * field_meta.get_sizeof();
+            auto zone_map = BuildZoneMap(
+                data_type, rows, std::min(chunk_rows, row_count - begin));
+            if (zone_map == nullptr) {
+                break;
             }
-            insert_record_.seal_pks();
+            field.zone_maps.push_back(std::move(zone_map));
         }
+    }
+    if (data_type == DataType::VECTOR_FLOAT && field.field_data != nullptr) {
+        auto dim = field_meta.get_dim();
+        field.norms.resize(row_count);
+        simd::SquaredNorms(static_cast<const float*>(field.field_data),
+                           dim,
+                           row_count,
+                           field.norms.data());
+    }
+    if (schema_->get_primary_field_id() == field_meta.get_id()) {
+        AssertInfo(data_type == DataType::INT64, "Primary key is not int64");
+        std::vector<PkType> pks(row_count);
+        auto values = static_cast<const int64_t*>(field.field_data);
+        std::copy_n(values, row_count, pks.begin());
+        field.pk2offset = decltype(insert_record_)::create_pk_map(data_type);
+        field.pk2offset->insert_batch(pks.data(), pks.size(), 0);
+        field.pk2offset->seal();
+    }
+    if (schema_->get_partition_key_field_id() == field_meta.get_id()) {
+        field.partition_keys = BuildPartitionKeys(
+            static_cast<const int64_t*>(field.field_data), row_count);
+    }
+}
 
-        set_bit(field_data_ready_bitset_, field_id, true);
+template <typename T>
+static std::shared_ptr<EncodedColumnBase>
+EncodeValues(const void* data, int64_t row_count) {
+    return EncodedColumn<T>::Encode(static_cast<const T*>(data), row_count);
+}
+
+void
+SegmentSealedImpl::encode_field(const FieldMeta& field_meta,
+                                int64_t row_count,
+                                LoadedField& field) const {
+    auto& config = SegcoreConfig::default_config();
+    if (field_meta.get_data_type() == DataType::VECTOR_FLOAT) {
+        auto& storage = config.get_sealed_vector_storage();
+        if (storage == "FLOAT") {
+            return;
+        }
+        if (storage == "COMPRESSED") {
+            // lossless, the norms still hold
+            field.encoded = std::make_shared<CompressedVectorColumn>(
+                static_cast<const float*>(field.field_data),
+                row_count,
+                field_meta.get_dim());
+        } else {
+            field.encoded = std::make_shared<HalfVectorColumn>(
+                static_cast<const float*>(field.field_data),
+                row_count,
+                field_meta.get_dim(),
+                storage == "FLOAT16" ? simd::HalfType::Float16
+                                     : simd::HalfType::BFloat16);
+            std::vector<float>().swap(field.norms);
+        }
+        munmap(field.field_data, field_meta.get_sizeof() * row_count);
+        field.field_data = nullptr;
+        return;
+    }
+    // a column encoded as a whole would not decode per row group
+    if (!config.get_sealed_column_encoding() || chunk_rows_ > 0) {
+        return;
+    }
+    switch (field_meta.get_data_type()) {
+        case DataType::INT32:
+            field.encoded = EncodeValues<int32_t>(field.field_data, row_count);
+            break;
+        case DataType::INT64:
+            field.encoded = EncodeValues<int64_t>(field.field_data, row_count);
+            break;
+        default:
+            return;
+    }
+    if (field.encoded != nullptr) {
+        munmap(field.field_data, field_meta.get_sizeof() * row_count);
+        field.field_data = nullptr;
+    }
+}
+
+void
+SegmentSealedImpl::encode_strings(const LoadFieldDataInfo& info,
+                                  LoadedField& field) const {
+    if (!SegcoreConfig::default_config().get_sealed_column_encoding() ||
+        chunk_rows_ > 0) {
+        return;
+    }
+    auto& strings = info.field_data->scalars().string_data().data();
+    field.encoded =
+        EncodedColumn<std::string_view>::Encode(strings, info.row_count);
+}
+
+SpanBase
+SegmentSealedImpl::decoded_field_data(const FieldMeta& field_meta,
+                                      const EncodedColumnBase& encoded) const {
+    std::lock_guard lck(decoded_fields_mutex_);
+    auto [it, inserted] = decoded_fields_.try_emplace(field_meta.get_id());
+    auto& decoded = it->second;
+    switch (field_meta.get_data_type()) {
+        case DataType::INT32: {
+            auto& column = dynamic_cast<const EncodedColumn<int32_t>&>(encoded);
+            if (inserted) {
+                decoded.values.resize((column.size() + 1) / 2);
+                auto values = reinterpret_cast<int32_t*>(decoded.values.data());
+                column.Decode(0, column.size(), values);
+            }
+            return SpanBase(
+                decoded.values.data(), column.size(), sizeof(int32_t));
+        }
+        case DataType::INT64: {
+            auto& column = dynamic_cast<const EncodedColumn<int64_t>&>(encoded);
+            if (inserted) {
+                decoded.values.resize(column.size());
+                column.Decode(0, column.size(), decoded.values.data());
+            }
+            return SpanBase(
+                decoded.values.data(), column.size(), sizeof(int64_t));
+        }
+        case DataType::VECTOR_FLOAT: {
+            auto rows = row_count_opt_.value();
+            if (inserted) {
+                decoded.values.resize((rows * field_meta.get_dim() + 1) / 2);
+                auto values = reinterpret_cast<float*>(decoded.values.data());
+                if (auto half = dynamic_cast<const HalfVectorColumn*>(&encoded);
+                    half != nullptr) {
+                    half->Decode(0, rows, values);
+                } else {
+                    dynamic_cast<const CompressedVectorColumn&>(encoded)
+                        .Decode(0, rows, values);
+                }
+            }
+            return SpanBase(
+                decoded.values.data(), rows, field_meta.get_sizeof());
+        }
+        default: {
+            auto& column =
+                dynamic_cast<const EncodedColumn<std::string_view>&>(encoded);
+            if (inserted) {
+                decoded.offsets.reserve(column.size() + 1);
+                for (int64_t i = 0; i < column.size(); ++i) {
+                    decoded.offsets.push_back(decoded.strings.size());
+                    decoded.strings.append(column.at(i));
+                }
+                decoded.offsets.push_back(decoded.strings.size());
+            }
+            return SpanBase(decoded.strings.data(),
+                            decoded.offsets.data(),
+                            column.size(),
+                            sizeof(uint64_t));
+        }
+    }
+}
+
+void
+SegmentSealedImpl::publish_field_data(const FieldMeta& field_meta,
+                                      int64_t row_count,
+                                      LoadedField&& field) {
+    auto field_id = field_meta.get_id();
+    // the first sealed segment of a collection trains the centroids its
+    // growing segments share
+    auto& config = SegcoreConfig::default_config();
+    if (UseSharedIvf(field_meta, config) && field.field_data != nullptr &&
+        row_count > 0) {
+        SharedCentroids::Global().GetOrTrain(
+            schema_,
+            field_id,
+            static_cast<const float*>(field.field_data),
+            row_count,
+            config.get_nlist());
     }
     std::unique_lock lck(mutex_);
-    update_row_count(info.row_count);
+    if (index_ready_.test(field_id) && !field_meta.is_vector()) {
+        // an index got loaded meanwhile
+        if (field.field_data != nullptr) {
+            munmap(field.field_data, field_meta.get_sizeof() * row_count);
+        }
+        PanicInfo("field data can't be loaded when indexing exists");
+    }
+    if (field.variable_field.has_value()) {
+        variable_fields_[schema_->get_field_offset(field_id)].emplace(
+            std::move(*field.variable_field));
+    } else if (field.sparse_index != nullptr) {
+        sparse_fields_[field_id] = std::move(field.sparse_index);
+    } else {
+        auto offset = schema_->get_field_offset(field_id);
+        if (field.encoded != nullptr) {
+            encoded_fields_[field_id] = std::move(field.encoded);
+        } else {
+            fixed_fields_[offset] = field.field_data;
+        }
+        vector_norms_[offset] = std::move(field.norms);
+        if (!field.zone_maps.empty()) {
+            zone_maps_[field_id] = std::move(field.zone_maps);
+        }
+    }
+    if (field.partition_keys) {
+        partition_keys_ = std::move(field.partition_keys);
+    }
+    if (field.pk2offset) {
+        AssertInfo(field_id.get() != -1, "Primary key is -1");
+        insert_record_.set_pks(std::move(field.pk2offset));
+    }
+    field_reservations_[field_id] = std::move(field.reservation);
+    field_data_ready_.set(field_id, true);
 }
 
 void
 SegmentSealedImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
+    ArenaScope arena_scope(arena_);
     AssertInfo(info.row_count > 0, "The row count of deleted record is 0");
     AssertInfo(info.primary_keys, "Deleted primary keys is null");
     AssertInfo(info.timestamps, "Deleted timestamps is null");
@@ -270,16 +1209,45 @@ SegmentSealedImpl::LoadDeletedRecord(const LoadDeletedRecordInfo& info) {
     AssertInfo(field_id.get() != -1, "Primary key is -1");
     auto& field_meta = schema_->operator[](field_id);
     int64_t size = info.row_count;
-    std::vector<PkType> pks(size);
-    ParsePksFromIDs(pks, field_meta.get_data_type(), *info.primary_keys);
     auto timestamps = reinterpret_cast<const Timestamp*>(info.timestamps);
 
-    // step 2: fill pks and timestamps
-    auto reserved_begin = deleted_record_.reserved.fetch_add(size);
-    deleted_record_.pks_.set_data_raw(reserved_begin, pks.data(), size);
-    deleted_record_.timestamps_.set_data_raw(reserved_begin, timestamps, size);
-    deleted_record_.ack_responder_.AddSegment(reserved_begin,
-                                              reserved_begin + size);
+    VisitPks(
+        field_meta.get_data_type(),
+        *info.primary_keys,
+        [&](auto pks, int64_t) {
+            using Pk = std::remove_cv_t<std::remove_pointer_t<decltype(pks)>>;
+            // step 2: drop the pks the segment certainly doesn't have, the
+            // delta logs of a collection are loaded into each of its segments
+            std::vector<bool> keep;
+            insert_record_.may_contain_pks(pks, size, keep);
+            std::vector<Pk> kept_pks;
+            std::vector<Timestamp> kept_timestamps;
+            for (int64_t i = 0; i < size; ++i) {
+                if (keep[i]) {
+                    kept_pks.push_back(pks[i]);
+                    kept_timestamps.push_back(timestamps[i]);
+                }
+            }
+            if (kept_pks.empty()) {
+                return;
+            }
+
+            // step 3: fill pks and timestamps
+            int64_t kept = kept_pks.size();
+            auto reserved_begin = deleted_record_.reserved.fetch_add(kept);
+            deleted_record_.push(reserved_begin,
+                                 kept_pks.data(),
+                                 kept_timestamps.data(),
+                                 kept);
+            search_cache_.Clear();
+        });
+}
+
+void
+SegmentSealedImpl::CompactDeletes(Timestamp timestamp) {
+    compact_deleted_record(
+        deleted_record_, insert_record_, get_row_count(), timestamp);
+    search_cache_.Clear();
 }
 
 // internal API: support scalar index only
@@ -290,63 +1258,165 @@ SegmentSealedImpl::num_chunk_index(FieldId field_id) const {
         return int64_t(vector_indexings_.is_ready(field_id));
     }
 
-    return scalar_indexings_.count(field_id);
+    // the index covers every row group
+    return index_ready_.test(field_id) ? num_chunk() : 0;
 }
 
 int64_t
 SegmentSealedImpl::num_chunk_data(FieldId field_id) const {
-    return get_bit(field_data_ready_bitset_, field_id) ? 1 : 0;
+    return field_data_ready_.test(field_id) ? num_chunk() : 0;
 }
 
 int64_t
 SegmentSealedImpl::num_chunk() const {
-    return 1;
+    auto row_count = get_row_count();
+    if (chunk_rows_ == 0 || row_count == 0) {
+        return 1;
+    }
+    return upper_div(row_count, chunk_rows_);
 }
 
 int64_t
 SegmentSealedImpl::size_per_chunk() const {
-    return get_row_count();
+    return chunk_rows_ > 0 ? chunk_rows_ : get_row_count();
 }
 
 SpanBase
 SegmentSealedImpl::chunk_data_impl(FieldId field_id, int64_t chunk_id) const {
     std::shared_lock lck(mutex_);
-    AssertInfo(get_bit(field_data_ready_bitset_, field_id),
+    AssertInfo(field_data_ready_.test(field_id),
                "Can't get bitset element at " + std::to_string(field_id.get()));
-    auto& field_meta = schema_->operator[](field_id);
-    auto element_sizeof = field_meta.get_sizeof();
-    if (auto it = fixed_fields_.find(field_id); it != fixed_fields_.end()) {
-        auto field_data = it->second;
-        return SpanBase(field_data, get_row_count(), element_sizeof);
-    }
-    if (auto it = variable_fields_.find(field_id);
-        it != variable_fields_.end()) {
-        auto& field = it->second;
-        return SpanBase(field.views().data(),
-                        field.views().size(),
-                        sizeof(std::string_view));
-    }
-    auto field_data = insert_record_.get_field_data_base(field_id);
-    AssertInfo(field_data->num_chunk() == 1,
-               "num chunk not equal to 1 for sealed segment");
-    return field_data->get_span_base(0);
+    auto offset = schema_->get_field_offset(field_id);
+    auto& field_meta = schema_->get_field_meta(offset);
+    auto span = [&]() {
+        if (auto field_data = fixed_fields_[offset]; field_data != nullptr) {
+            return SpanBase(
+                field_data, get_row_count(), field_meta.get_sizeof());
+        }
+        if (auto it = encoded_fields_.find(field_id);
+            it != encoded_fields_.end()) {
+            return decoded_field_data(field_meta, *it->second);
+        }
+        if (auto& field = variable_fields_[offset]; field.has_value()) {
+            return field->span();
+        }
+        auto field_data = insert_record_.get_field_data_base(field_id);
+        AssertInfo(field_data->num_chunk() == 1,
+                   "num chunk not equal to 1 for sealed segment");
+        return field_data->get_span_base(0);
+    }();
+    if (chunk_rows_ == 0) {
+        return span;
+    }
+    // the row groups are views of the one column
+    auto begin = chunk_id * chunk_rows_;
+    AssertInfo(begin < span.row_count(), "chunk out of range");
+    return span.slice(begin, std::min(chunk_rows_, span.row_count() - begin));
 }
 
 const index::IndexBase*
 SegmentSealedImpl::chunk_index_impl(FieldId field_id, int64_t chunk_id) const {
-    AssertInfo(scalar_indexings_.find(field_id) != scalar_indexings_.end(),
+    auto offset = schema_->get_field_offset(field_id);
+    AssertInfo(offset >= 0 && scalar_indexings_[offset] != nullptr,
                "Cannot find scalar_indexing with field_id: " +
                    std::to_string(field_id.get()));
-    auto ptr = scalar_indexings_.at(field_id).get();
-    return ptr;
+    return scalar_indexings_[offset].get();
 }
 
-int64_t
-SegmentSealedImpl::GetMemoryUsageInBytes() const {
-    // TODO: add estimate for index
+std::shared_ptr<const ZoneMapBase>
+SegmentSealedImpl::chunk_zone_map_impl(FieldId field_id,
+                                       int64_t chunk_id) const {
+    std::shared_lock lck(mutex_);
+    if (auto it = zone_maps_.find(field_id);
+        it != zone_maps_.end() && chunk_id < it->second.size()) {
+        return it->second[chunk_id];
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const PartitionKeysBase>
+SegmentSealedImpl::partition_keys_impl() const {
+    std::shared_lock lck(mutex_);
+    return partition_keys_;
+}
+
+std::shared_ptr<const EncodedColumnBase>
+SegmentSealedImpl::chunk_encoded_impl(FieldId field_id,
+                                      int64_t chunk_id) const {
+    std::shared_lock lck(mutex_);
+    if (auto it = encoded_fields_.find(field_id); it != encoded_fields_.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
+MemoryUsage
+SegmentSealedImpl::GetMemoryUsage() const {
+    MemoryUsage usage;
     std::shared_lock lck(mutex_);
     auto row_count = row_count_opt_.value_or(0);
-    return schema_->get_total_sizeof() * row_count;
+    for (int64_t offset = 0; offset < fixed_fields_.size(); ++offset) {
+        if (fixed_fields_[offset] != nullptr) {
+            auto& field_meta = schema_->get_field_meta(offset);
+            usage.Add("sealed.fields", field_meta.get_sizeof() * row_count);
+        }
+    }
+    for (auto& field : variable_fields_) {
+        if (field.has_value()) {
+            usage.Add("sealed.variable_fields", field->memory_usage());
+        }
+    }
+    for (auto& norms : vector_norms_) {
+        if (!norms.empty()) {
+            usage.Add("sealed.vector_norms", norms.size() * sizeof(float));
+        }
+    }
+    for (auto& [field_id, encoded] : encoded_fields_) {
+        usage.Add("sealed.encoded_fields", encoded->memory_bytes());
+    }
+    for (auto& [field_id, sparse] : sparse_fields_) {
+        usage.Add("sealed.sparse_fields", sparse->memory_bytes());
+    }
+    for (auto& [field_id, zone_maps] : zone_maps_) {
+        for (auto& zone_map : zone_maps) {
+            usage.Add("sealed.zone_maps", zone_map->memory_usage());
+        }
+    }
+    if (partition_keys_ != nullptr) {
+        usage.Add("sealed.partition_keys", partition_keys_->memory_usage());
+    }
+    {
+        std::lock_guard decoded_lck(decoded_fields_mutex_);
+        for (auto& [field_id, decoded] : decoded_fields_) {
+            usage.Add("sealed.decoded_fields",
+                      HeapBytes(decoded.values) + HeapBytes(decoded.strings) +
+                          HeapBytes(decoded.offsets));
+        }
+    }
+    {
+        std::lock_guard lazy_lck(lazy_fields_mutex_);
+        for (auto& [field_id, field] : lazy_fields_) {
+            usage.Add("sealed.lazy_fields", field->memory_usage());
+        }
+    }
+    {
+        std::lock_guard masks_lck(timestamp_masks_mutex_);
+        for (auto& [timestamp, mask] : timestamp_masks_) {
+            usage.Add("sealed.timestamp_masks",
+                      mask->num_blocks() * sizeof(BitsetType::block_type));
+        }
+    }
+    usage.Add("sealed.filter_cache", filter_cache_.memory_usage());
+    usage.Add("sealed.search_cache", search_cache_.memory_usage());
+    for (auto& index : scalar_indexings_) {
+        if (index != nullptr) {
+            usage.Add("index.scalar", index->MemoryUsage());
+        }
+    }
+    usage.Add("index.vector", vector_indexings_.memory_usage());
+    insert_record_.add_memory_usage(usage);
+    deleted_record_.add_memory_usage(usage);
+    return usage;
 }
 
 int64_t
@@ -366,23 +1436,23 @@ SegmentSealedImpl::get_schema() const {
     return *schema_;
 }
 
-void
-SegmentSealedImpl::mask_with_delete(BitsetType& bitset,
-                                    int64_t ins_barrier,
-                                    Timestamp timestamp) const {
+DeletedRecord::SnapshotPtr
+SegmentSealedImpl::get_deleted_snapshot(int64_t ins_barrier,
+                                        Timestamp timestamp,
+                                        bool* cached) const {
     auto del_barrier = get_barrier(get_deleted_record(), timestamp);
     if (del_barrier == 0) {
-        return;
-    }
-    auto bitmap_holder = get_deleted_bitmap(
-        del_barrier, ins_barrier, deleted_record_, insert_record_, timestamp);
-    if (!bitmap_holder || !bitmap_holder->bitmap_ptr) {
-        return;
+        if (cached != nullptr) {
+            *cached = true;
+        }
+        return nullptr;
     }
-    auto& delete_bitset = *bitmap_holder->bitmap_ptr;
-    AssertInfo(delete_bitset.size() == bitset.size(),
-               "Deleted bitmap size not equal to filtered bitmap size");
-    bitset |= delete_bitset;
+    return get_deleted_bitmap(del_barrier,
+                              ins_barrier,
+                              deleted_record_,
+                              insert_record_,
+                              timestamp,
+                              cached);
 }
 
 void
@@ -398,35 +1468,135 @@ SegmentSealedImpl::vector_search(SearchInfo& search_info,
 
     AssertInfo(field_meta.is_vector(),
                "The meta type of vector field is not vector type");
-    if (get_bit(index_ready_bitset_, field_id)) {
+    if (index_ready_.test(field_id)) {
         AssertInfo(vector_indexings_.is_ready(field_id),
                    "vector indexes isn't ready for field " +
                        std::to_string(field_id.get()));
-        query::SearchOnSealedIndex(*schema_,
-                                   vector_indexings_,
-                                   search_info,
-                                   query_data,
-                                   query_count,
-                                   bitset,
-                                   output);
+        // a quantized index ranks approximately: with the raw vectors
+        // loaded too, it is asked for more hits, ranked again exactly
+        auto params = search_info.GetParams();
+        auto offset = schema_->get_field_offset(field_id);
+        auto refine = params->refine_factor_ > 1 &&
+                      !params->radius_.has_value() &&
+                      field_meta.get_data_type() == DataType::VECTOR_FLOAT &&
+                      field_data_ready_.test(field_id) &&
+                      fixed_fields_[offset] != nullptr;
+        auto fetch_topk = refine ? search_info.topk_ * params->refine_factor_
+                                 : search_info.topk_;
+        auto search = [&](const void* queries,
+                          int64_t num_queries,
+                          int64_t topk,
+                          SearchResult& result) {
+            // a batch serves the searches of other requests too
+            SearchInfo info(search_info);
+            info.topk_ = topk;
+            info.cancel_token_ = nullptr;
+            query::SearchOnSealedIndex(*schema_,
+                                       vector_indexings_,
+                                       info,
+                                       queries,
+                                       num_queries,
+                                       bitset,
+                                       result);
+        };
+        // searches differing in the queries and the topk only share a key
+        auto key = fmt::format("{}/{}/{}/{}/{}",
+                               field_id.get(),
+                               search_info.metric_type_,
+                               SearchBatcher::TopkBucket(fetch_topk),
+                               search_info.round_decimal_,
+                               params->text_);
+        CheckCancel(search_info.cancel_token_);
+        search_batcher_.Search(key,
+                               fetch_topk,
+                               query_data,
+                               query_count,
+                               field_meta.get_sizeof(),
+                               bitset,
+                               search,
+                               output);
+        if (refine) {
+            query::RefineOnRawVectors(
+                search_info,
+                static_cast<const float*>(fixed_fields_[offset]),
+                field_meta.get_dim(),
+                query_data,
+                query_count,
+                output);
+        }
+        output.index_chunks_ = 1;
     } else {
         AssertInfo(
-            get_bit(field_data_ready_bitset_, field_id),
+            field_data_ready_.test(field_id),
             "Field Data is not loaded: " + std::to_string(field_id.get()));
         AssertInfo(row_count_opt_.has_value(), "Can't get row count value");
         auto row_count = row_count_opt_.value();
-        auto vec_data = fixed_fields_.at(field_id);
-        query::SearchOnSealed(*schema_,
-                              vec_data,
-                              search_info,
-                              query_data,
-                              query_count,
-                              row_count,
-                              bitset,
-                              output);
+        auto offset = schema_->get_field_offset(field_id);
+        auto& norms = vector_norms_[offset];
+        auto it = encoded_fields_.find(field_id);
+        auto encoded =
+            it != encoded_fields_.end() ? it->second.get() : nullptr;
+        if (auto half = dynamic_cast<const HalfVectorColumn*>(encoded);
+            half != nullptr) {
+            query::SearchOnSealed(*schema_,
+                                  *half,
+                                  search_info,
+                                  query_data,
+                                  query_count,
+                                  bitset,
+                                  output);
+        } else if (encoded != nullptr) {
+            query::SearchOnSealed(
+                *schema_,
+                dynamic_cast<const CompressedVectorColumn&>(*encoded),
+                search_info,
+                query_data,
+                query_count,
+                bitset,
+                output,
+                norms.empty() ? nullptr : norms.data());
+        } else {
+            query::SearchOnSealed(*schema_,
+                                  fixed_fields_[offset],
+                                  search_info,
+                                  query_data,
+                                  query_count,
+                                  row_count,
+                                  bitset,
+                                  output,
+                                  norms.empty() ? nullptr : norms.data());
+        }
+        output.brute_force_chunks_ = 1;
     }
 }
 
+void
+SegmentSealedImpl::sparse_search(const SearchInfo& search_info,
+                                 const SparseFloatRow* queries,
+                                 int64_t query_count,
+                                 Timestamp timestamp,
+                                 const BitsetView& bitset,
+                                 SearchResult& output) const {
+    AssertInfo(is_system_field_ready(), "System field is not ready");
+    auto field_id = search_info.field_id_;
+    auto it = sparse_fields_.find(field_id);
+    AssertInfo(it != sparse_fields_.end(),
+               "Field Data is not loaded: " + std::to_string(field_id.get()));
+    AssertInfo(!search_info.GetParams()->radius_.has_value(),
+               "sparse vectors have no range search");
+    auto sub_qr = it->second->Search(queries,
+                                     query_count,
+                                     search_info.topk_,
+                                     search_info.round_decimal_,
+                                     bitset,
+                                     search_info.cancel_token_);
+    output.distances_ = std::move(sub_qr.mutable_distances());
+    output.seg_offsets_ = std::move(sub_qr.mutable_seg_offsets());
+    output.unity_topK_ = search_info.topk_;
+    output.total_nq_ = query_count;
+    output.index_chunks_ = 1;
+}
+
 void
 SegmentSealedImpl::DropFieldData(const FieldId field_id) {
     if (SystemProperty::Instance().IsSystem(field_id)) {
@@ -440,14 +1610,31 @@ SegmentSealedImpl::DropFieldData(const FieldId field_id) {
         } else if (system_field_type == SystemFieldType::Timestamp) {
             insert_record_.timestamps_.clear();
         }
+        field_reservations_.erase(field_id);
         lck.unlock();
     } else {
         auto& field_meta = schema_->operator[](field_id);
         std::unique_lock lck(mutex_);
-        set_bit(field_data_ready_bitset_, field_id, false);
+        field_data_ready_.set(field_id, false);
         insert_record_.drop_field_data(field_id);
+        zone_maps_.erase(field_id);
+        if (schema_->get_partition_key_field_id() == field_id) {
+            partition_keys_ = nullptr;
+        }
+        encoded_fields_.erase(field_id);
+        sparse_fields_.erase(field_id);
+        vector_norms_[schema_->get_field_offset(field_id)].clear();
+        {
+            std::lock_guard decoded_lck(decoded_fields_mutex_);
+            decoded_fields_.erase(field_id);
+        }
+        field_reservations_.erase(field_id);
         lck.unlock();
+        std::lock_guard lazy_lck(lazy_fields_mutex_);
+        lazy_fields_.erase(field_id);
     }
+    filter_cache_.Clear();
+    search_cache_.Clear();
 }
 
 void
@@ -462,7 +1649,11 @@ SegmentSealedImpl::DropIndex(const FieldId field_id) {
 
     std::unique_lock lck(mutex_);
     vector_indexings_.drop_field_indexing(field_id);
-    set_bit(index_ready_bitset_, field_id, false);
+    index_reservations_.erase(field_id);
+    index_ready_.set(field_id, false);
+    lck.unlock();
+    filter_cache_.Clear();
+    search_cache_.Clear();
 }
 
 void
@@ -479,28 +1670,38 @@ SegmentSealedImpl::check_search(const query::Plan* plan) const {
     }
 
     auto& request_fields = plan->extra_info_opt_.value().involved_fields_;
-    auto field_ready_bitset = field_data_ready_bitset_ | index_ready_bitset_;
-    AssertInfo(request_fields.size() == field_ready_bitset.size(),
+    AssertInfo(request_fields.size() == schema_->size(),
                "Request fields size not equal to field ready bitset size when "
                "check search");
-    auto absent_fields = request_fields - field_ready_bitset;
-
-    if (absent_fields.any()) {
-        auto field_id =
-            FieldId(absent_fields.find_first() + START_USER_FIELDID);
-        auto& field_meta = schema_->operator[](field_id);
-        PanicInfo("User Field(" + field_meta.get_name().get() +
-                  ") is not loaded");
+    for (auto pos = request_fields.find_first(); pos != BitsetType::npos;
+         pos = request_fields.find_next(pos)) {
+        auto field_id = FieldId(pos + START_USER_FIELDID);
+        if (!field_data_ready_.test(field_id) && !index_ready_.test(field_id)) {
+            auto& field_meta = schema_->operator[](field_id);
+            PanicInfo("User Field(" + field_meta.get_name().get() +
+                      ") is not loaded");
+        }
     }
 }
 
 SegmentSealedImpl::SegmentSealedImpl(SchemaPtr schema, int64_t segment_id)
     : schema_(schema),
       insert_record_(*schema, MAX_ROW_COUNT),
-      field_data_ready_bitset_(schema->size()),
-      index_ready_bitset_(schema->size()),
+      deleted_record_(*schema),
+      field_data_ready_(schema->size()),
+      index_ready_(schema->size()),
       scalar_indexings_(schema->size()),
-      id_(segment_id) {
+      vector_indexings_(schema->size()),
+      fixed_fields_(schema->size()),
+      variable_fields_(schema->size()),
+      vector_norms_(schema->size()),
+      chunk_rows_(SegcoreConfig::default_config().get_sealed_chunk_rows()),
+      id_(segment_id),
+      search_batcher_(
+          std::chrono::microseconds(
+              SegcoreConfig::default_config().get_search_batch_window_us()),
+          SegcoreConfig::default_config().get_search_batch_max_queries()) {
+    field_access_stats_ = std::make_unique<FieldAccessStats>(schema->size());
 }
 
 void
@@ -535,21 +1736,41 @@ SegmentSealedImpl::bulk_subscript(SystemFieldType system_type,
     }
 }
 
-template <typename T>
+template <typename S, typename T>
 void
 SegmentSealedImpl::bulk_subscript_impl(const void* src_raw,
                                        const int64_t* seg_offsets,
                                        int64_t count,
                                        void* dst_raw) {
-    static_assert(IsScalar<T>);
-    auto src = reinterpret_cast<const T*>(src_raw);
+    static_assert(IsScalar<S>);
+    auto src = reinterpret_cast<const S*>(src_raw);
     auto dst = reinterpret_cast<T*>(dst_raw);
     for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        if (offset != INVALID_SEG_OFFSET) {
-            dst[i] = src[offset];
+        if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+            dst[i] = T();
         }
     }
+    GatherRows(
+        seg_offsets,
+        count,
+        sizeof(S),
+        [src](int64_t offset) { return src + offset; },
+        [&](int64_t i, int64_t offset) { dst[i] = src[offset]; });
+}
+
+template <typename S, typename T>
+void
+SegmentSealedImpl::bulk_subscript_impl(const EncodedColumnBase& encoded,
+                                       const int64_t* seg_offsets,
+                                       int64_t count,
+                                       void* dst_raw) {
+    auto& column = static_cast<const EncodedColumn<S>&>(encoded);
+    auto dst = reinterpret_cast<T*>(dst_raw);
+    for (int64_t i = 0; i < count; ++i) {
+        auto offset = seg_offsets[i];
+        AssignValue(dst[i],
+                    offset == INVALID_SEG_OFFSET ? S() : column.at(offset));
+    }
 }
 
 template <typename T>
@@ -560,12 +1781,18 @@ SegmentSealedImpl::bulk_subscript_impl(const VariableField& field,
                                        void* dst_raw) {
     auto dst = reinterpret_cast<T*>(dst_raw);
     for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        if (offset != INVALID_SEG_OFFSET) {
-            auto entry = field[offset];
-            dst[i] = std::move(T(entry.data(), entry.row_count()));
+        if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+            AssignValue(dst[i], std::string_view());
         }
     }
+    // the sizes are unknown before the lookup, prefetch the first line
+    auto rows = Span<std::string_view>(field.span()).data();
+    GatherRows(
+        seg_offsets,
+        count,
+        64,
+        [rows](int64_t offset) { return rows[offset].data(); },
+        [&](int64_t i, int64_t offset) { AssignValue(dst[i], rows[offset]); });
 }
 
 // for vector
@@ -578,27 +1805,55 @@ SegmentSealedImpl::bulk_subscript_impl(int64_t element_sizeof,
     auto src_vec = reinterpret_cast<const char*>(src_raw);
     auto dst_vec = reinterpret_cast<char*>(dst_raw);
     for (int64_t i = 0; i < count; ++i) {
-        auto offset = seg_offsets[i];
-        auto dst = dst_vec + i * element_sizeof;
-        const char* src = (offset == INVALID_SEG_OFFSET
-                               ? nullptr
-                               : (src_vec + element_sizeof * offset));
-        if (!src) {
-            continue;
+        if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+            memset(dst_vec + i * element_sizeof, 0, element_sizeof);
         }
-        memcpy(dst, src, element_sizeof);
     }
+    GatherRows(
+        seg_offsets,
+        count,
+        element_sizeof,
+        [=](int64_t offset) { return src_vec + element_sizeof * offset; },
+        [=](int64_t i, int64_t offset) {
+            memcpy(dst_vec + i * element_sizeof,
+                   src_vec + element_sizeof * offset,
+                   element_sizeof);
+        });
 }
 
 std::unique_ptr<DataArray>
 SegmentSealedImpl::fill_with_empty(FieldId field_id, int64_t count) const {
     auto& field_meta = schema_->operator[](field_id);
-    if (datatype_is_vector(field_meta.get_data_type())) {
+    if (datatype_is_vector(field_meta.get_data_type()) ||
+        field_meta.is_sparse_vector()) {
         return CreateVectorDataArray(count, field_meta);
     }
     return CreateScalarDataArray(count, field_meta);
 }
 
+std::unique_ptr<DataArray>
+SegmentSealedImpl::get_vector_from_index(const index::VectorIndex& vec_index,
+                                         const FieldMeta& field_meta,
+                                         const int64_t* seg_offsets,
+                                         int64_t count) const {
+    // invalid offsets read row 0 and get zeroed afterwards
+    std::vector<int64_t> ids(seg_offsets, seg_offsets + count);
+    for (auto& id : ids) {
+        id = id == INVALID_SEG_OFFSET ? 0 : id;
+    }
+    auto data_array = CreateVectorDataArray(0, field_meta);
+    auto output = static_cast<char*>(
+        AppendVectorRows(data_array.get(), field_meta, count));
+    vec_index.GetVector(ids.data(), count, output);
+    auto row_bytes = field_meta.get_sizeof();
+    for (int64_t i = 0; i < count; ++i) {
+        if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+            memset(output + i * row_bytes, 0, row_bytes);
+        }
+    }
+    return data_array;
+}
+
 std::unique_ptr<DataArray>
 SegmentSealedImpl::bulk_subscript(FieldId field_id,
                                   const int64_t* seg_offsets,
@@ -609,33 +1864,116 @@ SegmentSealedImpl::bulk_subscript(FieldId field_id,
         return fill_with_empty(field_id, count);
     }
 
-    if (HasIndex(field_id)) {
+    {
+        std::unique_lock lazy_lck(lazy_fields_mutex_);
+        if (auto it = lazy_fields_.find(field_id); it != lazy_fields_.end()) {
+            auto field = it->second;
+            lazy_lck.unlock();
+            return field->bulk_subscript(seg_offsets, count);
+        }
+    }
+
+    // the raw vectors loaded besides an index are read as they are
+    if (HasIndex(field_id) && !field_data_ready_.test(field_id)) {
         // if field has load scalar index, reverse raw data from index
         if (!datatype_is_vector(field_meta.get_data_type())) {
-            AssertInfo(num_chunk() == 1,
-                       "num chunk not equal to 1 for sealed segment");
+            // the index covers every row group
             auto index = chunk_index_impl(field_id, 0);
             return ReverseDataFromIndex(index, seg_offsets, count, field_meta);
         }
 
-        // TODO: knowhere support reverse data from vector index
-        // Now, real data will be filled in data array using chunk manager
+        auto vec_index = dynamic_cast<const index::VectorIndex*>(
+            vector_indexings_.get_field_indexing(field_id)->indexing_.get());
+        if (vec_index != nullptr && vec_index->HasRawData()) {
+            return get_vector_from_index(
+                *vec_index, field_meta, seg_offsets, count);
+        }
+        // otherwise real data will be filled in data array using chunk
+        // manager
         return fill_with_empty(field_id, count);
     }
 
-    Assert(get_bit(field_data_ready_bitset_, field_id));
+    Assert(field_data_ready_.test(field_id));
+
+    if (auto it = sparse_fields_.find(field_id); it != sparse_fields_.end()) {
+        auto data_array = CreateVectorDataArray(0, field_meta);
+        for (int64_t i = 0; i < count; ++i) {
+            if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+                AppendSparseRow(SparseFloatRow(), data_array.get());
+            } else {
+                it->second->AppendRow(seg_offsets[i], data_array.get());
+            }
+        }
+        return data_array;
+    }
+
+    // encoded fields decode the requested rows only
+    if (auto it = encoded_fields_.find(field_id); it != encoded_fields_.end()) {
+        if (field_meta.is_vector()) {
+            auto data_array = CreateVectorDataArray(0, field_meta);
+            auto output = static_cast<float*>(
+                AppendVectorRows(data_array.get(), field_meta, count));
+            if (auto compressed = dynamic_cast<const CompressedVectorColumn*>(
+                    it->second.get());
+                compressed != nullptr) {
+                compressed->Gather(seg_offsets, count, output);
+                return data_array;
+            }
+            auto& column = dynamic_cast<const HalfVectorColumn&>(*it->second);
+            auto dim = column.dim();
+            for (int64_t i = 0; i < count; ++i) {
+                if (seg_offsets[i] == INVALID_SEG_OFFSET) {
+                    std::fill_n(output + i * dim, dim, 0);
+                } else {
+                    column.Decode(seg_offsets[i], 1, output + i * dim);
+                }
+            }
+            return data_array;
+        }
+        auto data_array = CreateScalarDataArray(0, field_meta);
+        auto scalar_array = data_array->mutable_scalars();
+        auto& encoded = *it->second;
+        switch (field_meta.get_data_type()) {
+            case DataType::INT32: {
+                auto output = AppendRows(
+                    scalar_array->mutable_int_data()->mutable_data(), count);
+                bulk_subscript_impl<int32_t>(
+                    encoded, seg_offsets, count, output);
+                break;
+            }
+            case DataType::INT64: {
+                auto output = AppendRows(
+                    scalar_array->mutable_long_data()->mutable_data(), count);
+                bulk_subscript_impl<int64_t>(
+                    encoded, seg_offsets, count, output);
+                break;
+            }
+            default: {
+                auto output = AppendRows(
+                    scalar_array->mutable_string_data()->mutable_data(),
+                    count);
+                bulk_subscript_impl<std::string_view, std::string*>(
+                    encoded, seg_offsets, count, output);
+                break;
+            }
+        }
+        return data_array;
+    }
 
     if (datatype_is_variable(field_meta.get_data_type())) {
         switch (field_meta.get_data_type()) {
             case DataType::VARCHAR:
             case DataType::STRING: {
-                FixedVector<std::string> output(count);
-                bulk_subscript_impl<std::string>(variable_fields_.at(field_id),
-                                                 seg_offsets,
-                                                 count,
-                                                 output.data());
-                return CreateScalarDataArrayFrom(
-                    output.data(), count, field_meta);
+                auto data_array = CreateScalarDataArray(0, field_meta);
+                auto output = AppendRows(data_array->mutable_scalars()
+                                             ->mutable_string_data()
+                                             ->mutable_data(),
+                                         count);
+                auto& field =
+                    variable_fields_[schema_->get_field_offset(field_id)];
+                bulk_subscript_impl<std::string*>(
+                    *field, seg_offsets, count, output);
+                return data_array;
             }
 
             default:
@@ -645,120 +1983,110 @@ SegmentSealedImpl::bulk_subscript(FieldId field_id,
         }
     }
 
-    auto src_vec = fixed_fields_.at(field_id);
+    // gathered straight into the data array
+    auto src_vec = fixed_fields_[schema_->get_field_offset(field_id)];
+    if (field_meta.is_vector()) {
+        auto data_array = CreateVectorDataArray(0, field_meta);
+        auto output = AppendVectorRows(data_array.get(), field_meta, count);
+        bulk_subscript_impl(
+            field_meta.get_sizeof(), src_vec, seg_offsets, count, output);
+        return data_array;
+    }
+
+    auto data_array = CreateScalarDataArray(0, field_meta);
+    auto scalar_array = data_array->mutable_scalars();
     switch (field_meta.get_data_type()) {
         case DataType::BOOL: {
-            FixedVector<bool> output(count);
-            bulk_subscript_impl<bool>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_bool_data()->mutable_data(), count);
+            bulk_subscript_impl<bool>(src_vec, seg_offsets, count, output);
+            break;
         }
         case DataType::INT8: {
-            FixedVector<int8_t> output(count);
-            bulk_subscript_impl<int8_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_int_data()->mutable_data(), count);
+            bulk_subscript_impl<int8_t, int32_t>(
+                src_vec, seg_offsets, count, output);
+            break;
         }
         case DataType::INT16: {
-            FixedVector<int16_t> output(count);
-            bulk_subscript_impl<int16_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_int_data()->mutable_data(), count);
+            bulk_subscript_impl<int16_t, int32_t>(
+                src_vec, seg_offsets, count, output);
+            break;
         }
         case DataType::INT32: {
-            FixedVector<int32_t> output(count);
-            bulk_subscript_impl<int32_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_int_data()->mutable_data(), count);
+            bulk_subscript_impl<int32_t>(src_vec, seg_offsets, count, output);
+            break;
         }
         case DataType::INT64: {
-            FixedVector<int64_t> output(count);
-            bulk_subscript_impl<int64_t>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_long_data()->mutable_data(), count);
+            bulk_subscript_impl<int64_t>(src_vec, seg_offsets, count, output);
+            break;
         }
         case DataType::FLOAT: {
-            FixedVector<float> output(count);
-            bulk_subscript_impl<float>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_float_data()->mutable_data(), count);
+            bulk_subscript_impl<float>(src_vec, seg_offsets, count, output);
+            break;
         }
         case DataType::DOUBLE: {
-            FixedVector<double> output(count);
-            bulk_subscript_impl<double>(
-                src_vec, seg_offsets, count, output.data());
-            return CreateScalarDataArrayFrom(output.data(), count, field_meta);
-        }
-
-        case DataType::VECTOR_FLOAT:
-        case DataType::VECTOR_BINARY: {
-            aligned_vector<char> output(field_meta.get_sizeof() * count);
-            bulk_subscript_impl(field_meta.get_sizeof(),
-                                src_vec,
-                                seg_offsets,
-                                count,
-                                output.data());
-            return CreateVectorDataArrayFrom(output.data(), count, field_meta);
+            auto output = AppendRows(
+                scalar_array->mutable_double_data()->mutable_data(), count);
+            bulk_subscript_impl<double>(src_vec, seg_offsets, count, output);
+            break;
         }
-
         default: {
             PanicInfo("unsupported");
         }
     }
+    return data_array;
 }
 
 bool
 SegmentSealedImpl::HasIndex(FieldId field_id) const {
-    std::shared_lock lck(mutex_);
-    return get_bit(index_ready_bitset_, field_id);
+    return index_ready_.test(field_id);
+}
+
+bool
+SegmentSealedImpl::HasRawData(int64_t field_id) const {
+    auto fid = FieldId(field_id);
+    auto& field_meta = schema_->operator[](fid);
+    if (!field_meta.is_vector() || !index_ready_.test(fid) ||
+        field_data_ready_.test(fid)) {
+        return true;
+    }
+    auto vec_index = dynamic_cast<const index::VectorIndex*>(
+        vector_indexings_.get_field_indexing(fid)->indexing_.get());
+    return vec_index != nullptr && vec_index->HasRawData();
+}
+
+bool
+SegmentSealedImpl::has_raw_vectors(FieldId field_id) const {
+    return field_data_ready_.test(field_id);
 }
 
 bool
 SegmentSealedImpl::HasFieldData(FieldId field_id) const {
-    std::shared_lock lck(mutex_);
     if (SystemProperty::Instance().IsSystem(field_id)) {
         return is_system_field_ready();
     } else {
-        return get_bit(field_data_ready_bitset_, field_id);
+        return field_data_ready_.test(field_id);
     }
 }
 
 std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
 SegmentSealedImpl::search_ids(const IdArray& id_array,
                               Timestamp timestamp) const {
-    AssertInfo(id_array.has_int_id(), "Id array doesn't have int_id element");
     auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
     AssertInfo(field_id.get() != -1, "Primary key is -1");
     auto& field_meta = schema_->operator[](field_id);
-    auto data_type = field_meta.get_data_type();
-    auto ids_size = GetSizeOfIdArray(id_array);
-    std::vector<PkType> pks(ids_size);
-    ParsePksFromIDs(pks, data_type, id_array);
-
-    auto res_id_arr = std::make_unique<IdArray>();
-    std::vector<SegOffset> res_offsets;
-    for (auto pk : pks) {
-        auto segOffsets = insert_record_.search_pk(pk, timestamp);
-        for (auto offset : segOffsets) {
-            switch (data_type) {
-                case DataType::INT64: {
-                    res_id_arr->mutable_int_id()->add_data(
-                        std::get<int64_t>(pk));
-                    break;
-                }
-                case DataType::VARCHAR: {
-                    res_id_arr->mutable_str_id()->add_data(
-                        std::get<std::string>(pk));
-                    break;
-                }
-                default: {
-                    PanicInfo("unsupported type");
-                }
-            }
-            res_offsets.push_back(offset);
-        }
-    }
-    return {std::move(res_id_arr), std::move(res_offsets)};
+    return SearchIds(
+        insert_record_, field_meta.get_data_type(), id_array, timestamp);
 }
 
 Status
@@ -766,45 +2094,56 @@ SegmentSealedImpl::Delete(int64_t reserved_offset,
                           int64_t size,
                           const IdArray* ids,
                           const Timestamp* timestamps_raw) {
+    ArenaScope arena_scope(arena_);
+    SEGCORE_METRIC_TIMER(DeleteLatency);
     auto field_id = schema_->get_primary_field_id().value_or(FieldId(-1));
     AssertInfo(field_id.get() != -1, "Primary key is -1");
     auto& field_meta = schema_->operator[](field_id);
-    std::vector<PkType> pks(size);
-    ParsePksFromIDs(pks, field_meta.get_data_type(), *ids);
-
-    // step 1: sort timestamp
-    std::vector<std::tuple<Timestamp, PkType>> ordering(size);
-    for (int i = 0; i < size; i++) {
-        ordering[i] = std::make_tuple(timestamps_raw[i], pks[i]);
-    }
-    std::sort(ordering.begin(), ordering.end());
-    std::vector<PkType> sort_pks(size);
-    std::vector<Timestamp> sort_timestamps(size);
-
-    for (int i = 0; i < size; i++) {
-        auto [t, pk] = ordering[i];
-        sort_timestamps[i] = t;
-        sort_pks[i] = pk;
-    }
-    deleted_record_.timestamps_.set_data_raw(
-        reserved_offset, sort_timestamps.data(), size);
-    deleted_record_.pks_.set_data_raw(reserved_offset, sort_pks.data(), size);
-    deleted_record_.ack_responder_.AddSegment(reserved_offset,
-                                              reserved_offset + size);
+    VisitPks(field_meta.get_data_type(), *ids, [&](auto pks, int64_t) {
+        deleted_record_.push(reserved_offset, pks, timestamps_raw, size);
+    });
+    // a search running meanwhile may or may not have seen the deletes
+    search_cache_.Clear();
+    SEGCORE_METRIC_ADD(DeleteRows, size);
     return Status::OK();
 }
 
 std::vector<SegOffset>
 SegmentSealedImpl::search_ids(const BitsetType& bitset,
-                              Timestamp timestamp) const {
+                              Timestamp timestamp,
+                              int64_t limit) const {
+    auto range = insert_record_.timestamp_index_.get_active_range(timestamp);
+    auto timestamps = range.first < range.second
+                          ? insert_record_.timestamps_.get_chunk(0).data()
+                          : nullptr;
+    return BitsetOffsets(reinterpret_cast<const uint8_t*>(bitset.data()),
+                         bitset.size(),
+                         false,
+                         limit,
+                         timestamps,
+                         timestamp,
+                         range.first,
+                         range.second);
+}
+
+std::vector<SegOffset>
+SegmentSealedImpl::search_ids_by_pk(const BitsetType& bitset,
+                                    Timestamp timestamp,
+                                    int64_t limit) const {
     std::vector<SegOffset> dst_offset;
-    for (int i = 0; i < bitset.size(); i++) {
-        if (bitset[i]) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                dst_offset.push_back(offset);
-            }
+    if (limit == 0) {
+        return dst_offset;
+    }
+    auto ordered = insert_record_.for_each_ordered_pk([&](int64_t offset) {
+        if (size_t(offset) < bitset.size() && bitset[offset] &&
+            insert_record_.timestamps_[offset] <= timestamp) {
+            dst_offset.emplace_back(offset);
         }
+        return limit != int64_t(dst_offset.size());
+    });
+    if (!ordered) {
+        return SegmentInternalInterface::search_ids_by_pk(
+            bitset, timestamp, limit);
     }
     return dst_offset;
 }
@@ -812,16 +2151,18 @@ SegmentSealedImpl::search_ids(const BitsetType& bitset,
 std::vector<SegOffset>
 SegmentSealedImpl::search_ids(const BitsetView& bitset,
                               Timestamp timestamp) const {
-    std::vector<SegOffset> dst_offset;
-    for (int i = 0; i < bitset.size(); i++) {
-        if (!bitset.test(i)) {
-            auto offset = SegOffset(i);
-            if (insert_record_.timestamps_[offset.get()] <= timestamp) {
-                dst_offset.push_back(offset);
-            }
-        }
-    }
-    return dst_offset;
+    auto range = insert_record_.timestamp_index_.get_active_range(timestamp);
+    auto timestamps = range.first < range.second
+                          ? insert_record_.timestamps_.get_chunk(0).data()
+                          : nullptr;
+    return BitsetOffsets(bitset.data(),
+                         bitset.size(),
+                         true,
+                         -1,
+                         timestamps,
+                         timestamp,
+                         range.first,
+                         range.second);
 }
 
 std::string
@@ -850,6 +2191,45 @@ SegmentSealedImpl::get_active_count(Timestamp ts) const {
     return this->get_row_count();
 }
 
+FilterCache*
+SegmentSealedImpl::get_filter_cache(Timestamp timestamp) const {
+    if (SegcoreConfig::default_config().get_filter_cache_bytes() <= 0) {
+        return nullptr;
+    }
+    // pk lookups skip rows inserted after the query, so only results of
+    // queries that see every row hold for later queries
+    std::shared_lock lck(mutex_);
+    if (!is_system_field_ready()) {
+        return nullptr;
+    }
+    auto row_count = row_count_opt_.value_or(0);
+    auto range = insert_record_.timestamp_index_.get_active_range(timestamp);
+    if (range.first != row_count || range.second != row_count) {
+        return nullptr;
+    }
+    return &filter_cache_;
+}
+
+SearchCache*
+SegmentSealedImpl::get_search_cache(Timestamp timestamp,
+                                    int64_t& del_barrier) const {
+    if (SegcoreConfig::default_config().get_search_cache_bytes() <= 0) {
+        return nullptr;
+    }
+    // as for the filter cache, only results of queries seeing every row
+    std::shared_lock lck(mutex_);
+    if (!is_system_field_ready()) {
+        return nullptr;
+    }
+    auto row_count = row_count_opt_.value_or(0);
+    auto range = insert_record_.timestamp_index_.get_active_range(timestamp);
+    if (range.first != row_count || range.second != row_count) {
+        return nullptr;
+    }
+    del_barrier = get_barrier(deleted_record_, timestamp);
+    return &search_cache_;
+}
+
 void
 SegmentSealedImpl::mask_with_timestamps(BitsetType& bitset_chunk,
                                         Timestamp timestamp) const {
@@ -874,9 +2254,51 @@ SegmentSealedImpl::mask_with_timestamps(BitsetType& bitset_chunk,
         bitset_chunk.set();
         return;
     }
-    auto mask = TimestampIndex::GenerateBitset(
-        timestamp, range, timestamps_data.data(), timestamps_data.size());
-    bitset_chunk |= mask;
+    bitset_chunk |= *get_timestamp_mask(timestamp, range);
+}
+
+std::shared_ptr<const BitsetType>
+SegmentSealedImpl::get_timestamp_mask(Timestamp timestamp) const {
+    auto row_count = get_row_count();
+    auto range = insert_record_.timestamp_index_.get_active_range(timestamp);
+    if (range.first == range.second && range.first == row_count) {
+        return nullptr;
+    }
+    if (range.first == range.second && range.first == 0) {
+        return std::make_shared<const BitsetType>(row_count, true);
+    }
+    return get_timestamp_mask(timestamp, range);
+}
+
+std::shared_ptr<const BitsetType>
+SegmentSealedImpl::get_timestamp_mask(
+    Timestamp timestamp, std::pair<int64_t, int64_t> range) const {
+    {
+        std::lock_guard lck(timestamp_masks_mutex_);
+        for (auto iter = timestamp_masks_.begin();
+             iter != timestamp_masks_.end();
+             ++iter) {
+            if (iter->first == timestamp) {
+                auto mask = iter->second;
+                timestamp_masks_.erase(iter);
+                timestamp_masks_.emplace_front(timestamp, mask);
+                return mask;
+            }
+        }
+    }
+    const auto& timestamps_data = insert_record_.timestamps_.get_chunk(0);
+    auto mask = std::make_shared<const BitsetType>(
+        insert_record_.timestamp_index_.GenerateBitset(
+            timestamp,
+            range,
+            timestamps_data.data(),
+            timestamps_data.size()));
+    std::lock_guard lck(timestamp_masks_mutex_);
+    timestamp_masks_.emplace_front(timestamp, mask);
+    if (timestamp_masks_.size() > MAX_TIMESTAMP_MASKS) {
+        timestamp_masks_.pop_back();
+    }
+    return mask;
 }
 
 }  // namespace milvus::segcore
@@ -15,21 +15,35 @@
 #include <tbb/concurrent_vector.h>
 
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "ColumnCache.h"
+#include "Compaction.h"
 #include "ConcurrentVector.h"
 #include "DeletedRecord.h"
+#include "FilterCache.h"
+#include "LazyField.h"
+#include "PartitionKeys.h"
 #include "ScalarIndex.h"
+#include "SearchBatcher.h"
+#include "SearchCache.h"
 #include "SealedIndexingRecord.h"
 #include "SegmentSealed.h"
 #include "TimestampIndex.h"
 #include "VariableField.h"
+#include "ZoneMap.h"
+#include "common/MemoryBudget.h"
 #include "index/ScalarIndex.h"
+#include "index/VectorIndex.h"
+#include "query/SparseSearch.h"
 #include "sys/mman.h"
 
 namespace milvus::segcore {
@@ -38,13 +52,16 @@ class SegmentSealedImpl : public SegmentSealed {
  public:
     explicit SegmentSealedImpl(SchemaPtr schema, int64_t segment_id);
     ~SegmentSealedImpl() {
-        for (auto& [field_id, data] : fixed_fields_) {
-            auto field_meta = schema_->operator[](field_id);
-            auto data_type = field_meta.get_data_type();
+        for (int64_t offset = 0; offset < fixed_fields_.size(); ++offset) {
+            auto data = fixed_fields_[offset];
+            if (data == nullptr) {
+                continue;
+            }
+            auto& field_meta = schema_->get_field_meta(offset);
             if (munmap(data, field_meta.get_sizeof() * get_row_count())) {
                 AssertInfo(true,
                            "failed to unmap field " +
-                               std::to_string(field_id.get()) +
+                               std::to_string(field_meta.get_id().get()) +
                                " err=" + strerror(errno));
             }
         }
@@ -54,6 +71,44 @@ class SegmentSealedImpl : public SegmentSealed {
     void
     LoadFieldData(const LoadFieldDataInfo& info) override;
     void
+    LoadFieldBinlogs(const LoadFieldBinlogInfo& info,
+                     storage::ChunkManager& chunk_manager) override;
+    void
+    LoadLazyFieldBinlogs(
+        const LoadFieldBinlogInfo& info,
+        std::shared_ptr<storage::ChunkManager> chunk_manager) override;
+    void
+    LoadParquet(const LoadParquetInfo& info,
+                storage::ChunkManager& chunk_manager) override;
+    bool
+    LoadCachedFieldData(const LoadFieldDataInfo& info) override;
+    void
+    SaveImage(const std::string& dir) const override;
+    bool
+    LoadImage(const std::string& dir) override;
+    // writes a fixed width field of a segment still to be loaded into the
+    // column cache under mmap_dir_path, for LoadCachedFieldData to map;
+    // false if the cache is disabled or can't take the field
+    static bool
+    PrefetchFieldBinlogs(int64_t segment_id,
+                         const FieldMeta& field_meta,
+                         const LoadFieldBinlogInfo& info,
+                         const char* mmap_dir_path,
+                         storage::ChunkManager& chunk_manager);
+    // merges the rows of segments visible at timestamp, deletes applied,
+    // into the insert binlogs of the target segment under binlog_dir, in
+    // pk order; the field_id of target is ignored
+    static CompactionResult
+    Compact(const std::vector<const SegmentSealedImpl*>& segments,
+            Timestamp timestamp,
+            const storage::FieldDataMeta& target,
+            const std::string& binlog_dir,
+            storage::ChunkManager& chunk_manager);
+    void
+    LoadFromGrowing(const SegmentGrowing& growing) override;
+    void
+    CompactDeletes(Timestamp timestamp) override;
+    void
     LoadDeletedRecord(const LoadDeletedRecordInfo& info) override;
     void
     LoadSegmentMeta(
@@ -66,6 +121,9 @@ class SegmentSealedImpl : public SegmentSealed {
     HasIndex(FieldId field_id) const override;
     bool
     HasFieldData(FieldId field_id) const override;
+    // a vector index keeping its raw vectors serves them to Retrieve
+    bool
+    HasRawData(int64_t field_id) const override;
 
     int64_t
     get_segment_id() const override {
@@ -73,8 +131,8 @@ class SegmentSealedImpl : public SegmentSealed {
     }
 
  public:
-    int64_t
-    GetMemoryUsageInBytes() const override;
+    MemoryUsage
+    GetMemoryUsage() const override;
 
     int64_t
     get_row_count() const override;
@@ -120,6 +178,15 @@ class SegmentSealedImpl : public SegmentSealed {
     const index::IndexBase*
     chunk_index_impl(FieldId field_id, int64_t chunk_id) const override;
 
+    std::shared_ptr<const ZoneMapBase>
+    chunk_zone_map_impl(FieldId field_id, int64_t chunk_id) const override;
+
+    std::shared_ptr<const EncodedColumnBase>
+    chunk_encoded_impl(FieldId field_id, int64_t chunk_id) const override;
+
+    std::shared_ptr<const PartitionKeysBase>
+    partition_keys_impl() const override;
+
     // Calculate: output[i] = Vec[seg_offset[i]],
     // where Vec is determined from field_offset
     void
@@ -141,14 +208,31 @@ class SegmentSealedImpl : public SegmentSealed {
     int64_t
     get_active_count(Timestamp ts) const override;
 
+    FilterCache*
+    get_filter_cache(Timestamp timestamp) const override;
+
+    SearchCache*
+    get_search_cache(Timestamp timestamp,
+                     int64_t& del_barrier) const override;
+
  private:
-    template <typename T>
+    // gathers values of S into an output of T
+    template <typename S, typename T = S>
     static void
     bulk_subscript_impl(const void* src_raw,
                         const int64_t* seg_offsets,
                         int64_t count,
                         void* dst_raw);
 
+    // decodes the rows of an EncodedColumn<S> into an output of T
+    template <typename S, typename T = S>
+    static void
+    bulk_subscript_impl(const EncodedColumnBase& encoded,
+                        const int64_t* seg_offsets,
+                        int64_t count,
+                        void* dst_raw);
+
+    // T is std::string, or std::string* to assign strings in place
     template <typename T>
     static void
     bulk_subscript_impl(const VariableField& field,
@@ -166,6 +250,102 @@ class SegmentSealedImpl : public SegmentSealed {
     std::unique_ptr<DataArray>
     fill_with_empty(FieldId field_id, int64_t count) const;
 
+    std::unique_ptr<DataArray>
+    get_vector_from_index(const index::VectorIndex& vec_index,
+                          const FieldMeta& field_meta,
+                          const int64_t* seg_offsets,
+                          int64_t count) const;
+
+    // a user field mapped and indexed, not yet visible to searches
+    struct LoadedField {
+        std::optional<VariableField> variable_field;
+        void* field_data = nullptr;
+        // one per row group
+        std::vector<std::shared_ptr<ZoneMapBase>> zone_maps;
+        // squared norms of the rows of a float vector field
+        std::vector<float> norms;
+        std::unique_ptr<OffsetMap> pk2offset;
+        // the rows of each key of the partition key field
+        std::shared_ptr<PartitionKeysBase> partition_keys;
+        // replaces field_data if set
+        std::shared_ptr<EncodedColumnBase> encoded;
+        // the rows of a sparse float vector field and their index
+        std::shared_ptr<query::SparseInvertedIndex> sparse_index;
+        MemoryReservation reservation;
+    };
+
+    // the column cache under an mmap dir, or the shared column cache for
+    // a nullptr mmap dir; nullptr if disabled
+    static std::unique_ptr<ColumnCache>
+    OpenColumnCache(const char* mmap_dir_path);
+
+    // maps a fixed width field, through the column cache if enabled, sets
+    // cached if it is mapped from the cache
+    void*
+    MapFixedField(const FieldMeta& field_meta,
+                  const LoadFieldDataInfo& info,
+                  bool& cached);
+
+    // maps a fixed width field loaded into memory from the shared column
+    // cache: the copy another process shared, else the one map returns,
+    // stored for the others. sets shared unless the cache is disabled or
+    // has no room for it, the map is returned as is then
+    void*
+    MapSharedField(const FieldMeta& field_meta,
+                   int64_t row_count,
+                   const std::function<void*()>& map,
+                   bool& shared);
+
+    // maps a fixed width field from cache, false if it is not there
+    bool
+    load_cached_column(ColumnCache& cache,
+                       const FieldMeta& field_meta,
+                       int64_t row_count);
+
+    void
+    check_field_row_count(FieldId field_id, int64_t row_count) const;
+
+    // the timestamp column and its index, under the segment lock
+    void
+    load_timestamps(const Timestamp* timestamps,
+                    int64_t size,
+                    MemoryReservation&& reservation);
+
+    void
+    load_row_ids(const idx_t* row_ids,
+                 int64_t size,
+                 MemoryReservation&& reservation);
+
+    // builds the zone map, the pk index and the partition keys of a mapped
+    // fixed width field
+    void
+    build_field_indexes(const FieldMeta& field_meta,
+                        int64_t row_count,
+                        LoadedField& field) const;
+
+    // swaps the in-memory data of an int field for its encoding, if the
+    // encoding is on and pays off
+    void
+    encode_field(const FieldMeta& field_meta,
+                 int64_t row_count,
+                 LoadedField& field) const;
+
+    // dictionary encodes a varchar field instead of mapping it, if the
+    // encoding is on and pays off
+    void
+    encode_strings(const LoadFieldDataInfo& info, LoadedField& field) const;
+
+    // the plain values of an encoded field, decoded at the first call
+    SpanBase
+    decoded_field_data(const FieldMeta& field_meta,
+                       const EncodedColumnBase& encoded) const;
+
+    // makes the field visible under the segment lock
+    void
+    publish_field_data(const FieldMeta& field_meta,
+                       int64_t row_count,
+                       LoadedField&& field);
+
     void
     update_row_count(int64_t row_count) {
         // if (row_count_opt_.has_value()) {
@@ -188,9 +368,28 @@ class SegmentSealedImpl : public SegmentSealed {
                   SearchResult& output) const override;
 
     void
-    mask_with_delete(BitsetType& bitset,
-                     int64_t ins_barrier,
-                     Timestamp timestamp) const override;
+    sparse_search(const SearchInfo& search_info,
+                  const SparseFloatRow* queries,
+                  int64_t query_count,
+                  Timestamp timestamp,
+                  const BitsetView& bitset,
+                  SearchResult& output) const override;
+
+    bool
+    has_raw_vectors(FieldId field_id) const override;
+
+    // rows of the undecided range not visible at timestamp
+    std::shared_ptr<const BitsetType>
+    get_timestamp_mask(Timestamp timestamp,
+                       std::pair<int64_t, int64_t> range) const;
+
+    DeletedRecord::SnapshotPtr
+    get_deleted_snapshot(int64_t ins_barrier,
+                         Timestamp timestamp,
+                         bool* cached = nullptr) const override;
+
+    std::shared_ptr<const BitsetType>
+    get_timestamp_mask(Timestamp timestamp) const override;
 
     bool
     is_system_field_ready() const {
@@ -209,7 +408,15 @@ class SegmentSealedImpl : public SegmentSealed {
     search_ids(const BitsetView& view, Timestamp timestamp) const override;
 
     std::vector<SegOffset>
-    search_ids(const BitsetType& view, Timestamp timestamp) const override;
+    search_ids(const BitsetType& view,
+               Timestamp timestamp,
+               int64_t limit) const override;
+
+    // walks the sorted pk index when the segment has one
+    std::vector<SegOffset>
+    search_ids_by_pk(const BitsetType& view,
+                     Timestamp timestamp,
+                     int64_t limit) const override;
 
     void
     LoadVecIndex(const LoadIndexInfo& info);
@@ -218,17 +425,17 @@ class SegmentSealedImpl : public SegmentSealed {
     LoadScalarIndex(const LoadIndexInfo& info);
 
  private:
-    // segment loading state
-    BitsetType field_data_ready_bitset_;
-    BitsetType index_ready_bitset_;
+    // segment loading state, read by searches without mutex_
+    FieldReadyFlags field_data_ready_;
+    FieldReadyFlags index_ready_;
     std::atomic<int> system_ready_count_ = 0;
     // segment data
 
     // TODO: generate index for scalar
     std::optional<int64_t> row_count_opt_;
 
-    // scalar field index
-    std::unordered_map<FieldId, index::IndexBasePtr> scalar_indexings_;
+    // scalar field index, by the offset of the field in the schema
+    std::vector<index::IndexBasePtr> scalar_indexings_;
     // vector field index
     SealedIndexingRecord vector_indexings_;
 
@@ -238,10 +445,65 @@ class SegmentSealedImpl : public SegmentSealed {
     // deleted pks
     mutable DeletedRecord deleted_record_;
 
+    // the load budget held by the fields and indexes in memory
+    std::unordered_map<FieldId, MemoryReservation> field_reservations_;
+    std::unordered_map<FieldId, std::shared_ptr<MemoryReservation>>
+        index_reservations_;
+
     SchemaPtr schema_;
     int64_t id_;
-    std::unordered_map<FieldId, void*> fixed_fields_;
-    std::unordered_map<FieldId, VariableField> variable_fields_;
+    // the rows were sorted by the clustering key when built from a growing
+    // segment, indexes built on the stored order don't fit them
+    bool clustered_ = false;
+    // raw data by the offset of the field in the schema, null or empty
+    // unless loaded that way
+    std::vector<void*> fixed_fields_;
+    std::vector<std::optional<VariableField>> variable_fields_;
+    // squared norms of the rows of the float vector fields in
+    // fixed_fields_, by field offset too
+    std::vector<std::vector<float>> vector_norms_;
+    // rows per row group, 0 for a single one; see
+    // SegcoreConfig::set_sealed_chunk_rows
+    const int64_t chunk_rows_;
+    // min/max per SEALED_ZONE_ROWS rows of fixed arithmetic fields, a zone
+    // map per row group
+    std::unordered_map<FieldId, std::vector<std::shared_ptr<ZoneMapBase>>>
+        zone_maps_;
+    // the rows of each key once the partition key field is loaded
+    std::shared_ptr<PartitionKeysBase> partition_keys_;
+    // the fields kept encoded instead of in fixed_fields_ or
+    // variable_fields_, with the plain copies readers of whole spans asked
+    // for; int64_t storage keeps either int width aligned
+    std::unordered_map<FieldId, std::shared_ptr<EncodedColumnBase>>
+        encoded_fields_;
+    // the sparse float vector fields, their rows kept by the index
+    std::unordered_map<FieldId, std::shared_ptr<query::SparseInvertedIndex>>
+        sparse_fields_;
+    struct DecodedField {
+        std::vector<int64_t> values;
+        std::string strings;
+        std::vector<uint64_t> offsets;
+    };
+    mutable std::mutex decoded_fields_mutex_;
+    mutable std::unordered_map<FieldId, DecodedField> decoded_fields_;
+    // the fields left in their binlogs, only bulk_subscript reads them
+    mutable std::mutex lazy_fields_mutex_;
+    std::unordered_map<FieldId, std::shared_ptr<const LazyField>>
+        lazy_fields_;
+    // predicate results, cleared whenever data or an index is loaded or
+    // dropped
+    mutable FilterCache filter_cache_;
+    // search results, cleared along with filter_cache_ and whenever deletes
+    // are added or compacted
+    mutable SearchCache search_cache_;
+    // timestamp masks of the last few query timestamps, most recent first;
+    // searches over a time window mostly share their guarantee timestamp
+    static constexpr size_t MAX_TIMESTAMP_MASKS = 4;
+    mutable std::mutex timestamp_masks_mutex_;
+    mutable std::deque<std::pair<Timestamp, std::shared_ptr<const BitsetType>>>
+        timestamp_masks_;
+    // coalesces concurrent searches of the vector indexes
+    mutable SearchBatcher search_batcher_;
 };
 
 inline SegmentSealedPtr
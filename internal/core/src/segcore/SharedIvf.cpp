@@ -0,0 +1,295 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "common/ScratchArena.h"
+#include "common/Utils.h"
+#include "exceptions/EasyAssert.h"
+#include "segcore/SharedIvf.h"
+#include "simd/hook.h"
+
+namespace milvus::segcore {
+
+namespace {
+
+constexpr int64_t kTrainRowsPerList = 256;
+constexpr int kTrainIterations = 10;
+// rows scored against all the centroids at once
+constexpr int64_t kBatchRows = 256;
+
+}  // namespace
+
+bool
+UseSharedIvf(const FieldMeta& field_meta, const SegcoreConfig& config) {
+    if (config.get_growing_index_type() != "IVF_SHARED" ||
+        field_meta.get_data_type() != DataType::VECTOR_FLOAT ||
+        !field_meta.get_metric_type().has_value()) {
+        return false;
+    }
+    auto metric_type = SearchMetric(field_meta.get_metric_type().value());
+    return metric_type == knowhere::metric::L2 ||
+           metric_type == knowhere::metric::IP;
+}
+
+IvfCentroids::IvfCentroids(const float* data,
+                           int64_t rows,
+                           int64_t dim,
+                           int64_t nlist,
+                           bool is_ip)
+    : dim_(dim),
+      nlist_(std::min(nlist, rows)),
+      is_ip_(is_ip),
+      centroids_(nlist_ * dim),
+      norms_(nlist_) {
+    AssertInfo(rows > 0 && nlist > 0,
+               "ivf centroids need rows and lists to train");
+    std::mt19937_64 rng(42);
+    std::vector<int64_t> sample(rows);
+    std::iota(sample.begin(), sample.end(), 0);
+    std::shuffle(sample.begin(), sample.end(), rng);
+    sample.resize(std::min(rows, nlist_ * kTrainRowsPerList));
+    auto num_train = int64_t(sample.size());
+    std::vector<float> train(num_train * dim);
+    for (int64_t i = 0; i < num_train; ++i) {
+        std::copy_n(data + sample[i] * dim, dim, train.data() + i * dim);
+    }
+
+    // the first rows of the shuffled sample seed the centroids
+    std::copy_n(train.data(), nlist_ * dim, centroids_.data());
+    std::vector<int32_t> lists(num_train);
+    std::vector<int64_t> counts(nlist_);
+    for (int iter = 0; iter < kTrainIterations; ++iter) {
+        UpdateNorms();
+        Nearest(train.data(), num_train, false, lists.data());
+        std::fill(centroids_.begin(), centroids_.end(), 0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int64_t i = 0; i < num_train; ++i) {
+            auto centroid = centroids_.data() + lists[i] * dim;
+            auto row = train.data() + i * dim;
+            for (int64_t d = 0; d < dim; ++d) {
+                centroid[d] += row[d];
+            }
+            ++counts[lists[i]];
+        }
+        for (int64_t c = 0; c < nlist_; ++c) {
+            auto centroid = centroids_.data() + c * dim;
+            if (counts[c] == 0) {
+                // an empty list starts over from a random row
+                std::copy_n(train.data() + rng() % num_train * dim,
+                            dim,
+                            centroid);
+                continue;
+            }
+            for (int64_t d = 0; d < dim; ++d) {
+                centroid[d] /= counts[c];
+            }
+        }
+    }
+    UpdateNorms();
+}
+
+void
+IvfCentroids::UpdateNorms() {
+    simd::SquaredNorms(centroids_.data(), dim_, nlist_, norms_.data());
+}
+
+void
+IvfCentroids::Scores(const float* data,
+                     int64_t rows,
+                     bool by_ip,
+                     float* dst) const {
+    simd::InnerProducts(data, rows, centroids_.data(), dim_, nlist_, dst);
+    for (int64_t i = 0; i < rows; ++i) {
+        auto scores = dst + i * nlist_;
+        for (int64_t c = 0; c < nlist_; ++c) {
+            scores[c] = by_ip ? -scores[c] : norms_[c] - 2 * scores[c];
+        }
+    }
+}
+
+void
+IvfCentroids::Nearest(const float* data,
+                      int64_t rows,
+                      bool by_ip,
+                      int32_t* lists) const {
+    ScratchVector<float> scores(std::min(rows, kBatchRows) * nlist_);
+    for (int64_t begin = 0; begin < rows; begin += kBatchRows) {
+        auto size = std::min(kBatchRows, rows - begin);
+        Scores(data + begin * dim_, size, by_ip, scores.data());
+        for (int64_t i = 0; i < size; ++i) {
+            auto row_scores = scores.data() + i * nlist_;
+            lists[begin + i] =
+                std::min_element(row_scores, row_scores + nlist_) - row_scores;
+        }
+    }
+}
+
+void
+IvfCentroids::Assign(const float* data, int64_t rows, int32_t* lists) const {
+    Nearest(data, rows, is_ip_, lists);
+}
+
+std::vector<int32_t>
+IvfCentroids::Probe(const float* queries,
+                    int64_t num_queries,
+                    int64_t nprobe) const {
+    AssertInfo(nprobe > 0 && nprobe <= nlist_,
+               "nprobe out of range of the ivf lists");
+    std::vector<int32_t> probes(num_queries * nprobe);
+    ScratchVector<float> scores(std::min(num_queries, kBatchRows) * nlist_);
+    ScratchVector<int32_t> order(nlist_);
+    for (int64_t begin = 0; begin < num_queries; begin += kBatchRows) {
+        auto size = std::min(kBatchRows, num_queries - begin);
+        Scores(queries + begin * dim_, size, is_ip_, scores.data());
+        for (int64_t q = 0; q < size; ++q) {
+            auto query_scores = scores.data() + q * nlist_;
+            std::iota(order.begin(), order.end(), 0);
+            std::partial_sort(order.begin(),
+                              order.begin() + nprobe,
+                              order.end(),
+                              [&](int32_t a, int32_t b) {
+                                  if (query_scores[a] != query_scores[b]) {
+                                      return query_scores[a] < query_scores[b];
+                                  }
+                                  return a < b;
+                              });
+            std::copy_n(
+                order.begin(), nprobe, probes.begin() + (begin + q) * nprobe);
+        }
+    }
+    return probes;
+}
+
+IvfChunk::IvfChunk(std::shared_ptr<const IvfCentroids> centroids,
+                   const float* data,
+                   int64_t rows)
+    : centroids_(std::move(centroids)),
+      list_offsets_(centroids_->nlist() + 1),
+      rows_(rows) {
+    std::vector<int32_t> lists(rows);
+    centroids_->Assign(data, rows, lists.data());
+    // counting sort of the rows by list
+    for (auto list : lists) {
+        ++list_offsets_[list + 1];
+    }
+    std::partial_sum(
+        list_offsets_.begin(), list_offsets_.end(), list_offsets_.begin());
+    auto next = list_offsets_;
+    for (int64_t i = 0; i < rows; ++i) {
+        rows_[next[lists[i]]++] = i;
+    }
+}
+
+int64_t
+IvfChunk::Search(const float* data,
+                 const float* query,
+                 const int32_t* probes,
+                 int64_t nprobe,
+                 int64_t topk,
+                 const BitsetView& bitset,
+                 int64_t* seg_offsets,
+                 float* distances) const {
+    int64_t num_probed = 0;
+    for (int64_t p = 0; p < nprobe; ++p) {
+        num_probed += list_offsets_[probes[p] + 1] - list_offsets_[probes[p]];
+    }
+    ScratchVector<int64_t> candidates;
+    candidates.reserve(num_probed);
+    for (int64_t p = 0; p < nprobe; ++p) {
+        auto list = probes[p];
+        for (auto i = list_offsets_[list]; i < list_offsets_[list + 1]; ++i) {
+            if (bitset.empty() || !bitset.test(rows_[i])) {
+                candidates.push_back(rows_[i]);
+            }
+        }
+    }
+    auto is_ip = centroids_->is_ip();
+    ScratchVector<float> exact(candidates.size());
+    simd::GatherDistances(query,
+                          data,
+                          centroids_->dim(),
+                          candidates.data(),
+                          candidates.size(),
+                          is_ip,
+                          exact.data());
+    ScratchVector<int64_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto found = std::min<int64_t>(topk, candidates.size());
+    std::partial_sort(order.begin(),
+                      order.begin() + found,
+                      order.end(),
+                      [&](int64_t a, int64_t b) {
+                          if (exact[a] != exact[b]) {
+                              return is_ip ? exact[a] > exact[b]
+                                           : exact[a] < exact[b];
+                          }
+                          return candidates[a] < candidates[b];
+                      });
+    for (int64_t i = 0; i < found; ++i) {
+        seg_offsets[i] = candidates[order[i]];
+        distances[i] = exact[order[i]];
+    }
+    return found;
+}
+
+SharedCentroids&
+SharedCentroids::Global() {
+    static SharedCentroids centroids;
+    return centroids;
+}
+
+std::shared_ptr<const IvfCentroids>
+SharedCentroids::GetOrTrain(const SchemaPtr& schema,
+                            FieldId field_id,
+                            const float* data,
+                            int64_t rows,
+                            int64_t nlist) {
+    std::shared_ptr<Slot> slot;
+    {
+        std::lock_guard lck(mutex_);
+        // a dropped collection goes first, a new schema may take its address
+        for (auto iter = entries_.begin(); iter != entries_.end();) {
+            iter = iter->second.schema.expired() ? entries_.erase(iter)
+                                                 : std::next(iter);
+        }
+        auto& entry = entries_[{schema.get(), field_id.get()}];
+        if (entry.slot == nullptr) {
+            entry.schema = schema;
+            entry.slot = std::make_shared<Slot>();
+        }
+        slot = entry.slot;
+    }
+    // a failed training leaves the next caller to try again
+    std::call_once(slot->trained, [&] {
+        auto& field_meta = (*schema)[field_id];
+        auto metric_type = SearchMetric(field_meta.get_metric_type().value());
+        slot->centroids =
+            std::make_shared<IvfCentroids>(data,
+                                           rows,
+                                           field_meta.get_dim(),
+                                           nlist,
+                                           metric_type == knowhere::metric::IP);
+    });
+    return slot->centroids;
+}
+
+int64_t
+SharedCentroids::size() const {
+    std::lock_guard lck(mutex_);
+    return std::count_if(entries_.begin(), entries_.end(), [](auto& entry) {
+        return !entry.second.schema.expired();
+    });
+}
+
+}  // namespace milvus::segcore
@@ -0,0 +1,175 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/BitsetView.h"
+#include "common/Schema.h"
+#include "common/Types.h"
+#include "segcore/SegcoreConfig.h"
+
+namespace milvus::segcore {
+
+// whether growing segments index the field by IvfChunks over shared
+// centroids: float vectors of L2 or IP metric, with IVF_SHARED as the
+// growing index type
+bool
+UseSharedIvf(const FieldMeta& field_meta, const SegcoreConfig& config);
+
+// k-means centroids of a float vector field. Trained with L2 like the
+// quantizers of the knowhere IVF indexes, rows are assigned to the nearest
+// centroid by the metric of the field.
+class IvfCentroids {
+ public:
+    // trains min(nlist, rows) centroids on a sample of at most 256 rows
+    // per centroid
+    IvfCentroids(const float* data,
+                 int64_t rows,
+                 int64_t dim,
+                 int64_t nlist,
+                 bool is_ip);
+
+    int64_t
+    dim() const {
+        return dim_;
+    }
+
+    int64_t
+    nlist() const {
+        return nlist_;
+    }
+
+    bool
+    is_ip() const {
+        return is_ip_;
+    }
+
+    // lists[i] = the list of row i
+    void
+    Assign(const float* data, int64_t rows, int32_t* lists) const;
+
+    // the nprobe nearest lists of each query, nearest first, nprobe at
+    // most nlist
+    std::vector<int32_t>
+    Probe(const float* queries, int64_t num_queries, int64_t nprobe) const;
+
+    int64_t
+    memory_usage() const {
+        return (centroids_.size() + norms_.size()) * sizeof(float);
+    }
+
+ private:
+    // dst[i * nlist + c] for row i and centroid c, smaller is nearer: the
+    // squared L2 distance shifted by the norm of the row, or the negated
+    // inner product
+    void
+    Scores(const float* data, int64_t rows, bool by_ip, float* dst) const;
+
+    // lists[i] = the nearest centroid of row i, batch by batch
+    void
+    Nearest(const float* data, int64_t rows, bool by_ip, int32_t* lists) const;
+
+    void
+    UpdateNorms();
+
+ private:
+    const int64_t dim_;
+    const int64_t nlist_;
+    const bool is_ip_;
+    std::vector<float> centroids_;
+    std::vector<float> norms_;
+};
+
+// inverted lists of one chunk of rows over shared centroids: a build is
+// the assignment of the rows alone, no training. The lists hold offsets
+// in the chunk, the vectors stay in the insert record.
+class IvfChunk {
+ public:
+    IvfChunk(std::shared_ptr<const IvfCentroids> centroids,
+             const float* data,
+             int64_t rows);
+
+    const IvfCentroids*
+    centroids() const {
+        return centroids_.get();
+    }
+
+    // the topk nearest rows of data not set in bitset, within the nprobe
+    // lists of probes; best first with distances as knowhere reports them,
+    // returns how many were found
+    int64_t
+    Search(const float* data,
+           const float* query,
+           const int32_t* probes,
+           int64_t nprobe,
+           int64_t topk,
+           const BitsetView& bitset,
+           int64_t* seg_offsets,
+           float* distances) const;
+
+    int64_t
+    memory_usage() const {
+        return (list_offsets_.size() + rows_.size()) * sizeof(int64_t);
+    }
+
+ private:
+    std::shared_ptr<const IvfCentroids> centroids_;
+    // rows of list l are rows_[list_offsets_[l], list_offsets_[l + 1])
+    std::vector<int64_t> list_offsets_;
+    std::vector<int64_t> rows_;
+};
+
+// the centroids of the float vector fields of each collection, trained on
+// the first rows a segment of it offers: the raw vectors of a sealed
+// segment, or the first complete chunk of a growing one. A collection is
+// told by the schema its segments share; its centroids go once the schema
+// does.
+class SharedCentroids {
+ public:
+    static SharedCentroids&
+    Global();
+
+    // the centroids of the field, trained on rows of data by the first
+    // caller; concurrent callers wait for that training
+    std::shared_ptr<const IvfCentroids>
+    GetOrTrain(const SchemaPtr& schema,
+               FieldId field_id,
+               const float* data,
+               int64_t rows,
+               int64_t nlist);
+
+    // fields with centroids or in training, of collections still alive
+    int64_t
+    size() const;
+
+ private:
+    struct Slot {
+        std::once_flag trained;
+        std::shared_ptr<const IvfCentroids> centroids;
+    };
+
+    struct Entry {
+        std::weak_ptr<Schema> schema;
+        std::shared_ptr<Slot> slot;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::pair<const Schema*, int64_t>, Entry> entries_;
+};
+
+}  // namespace milvus::segcore
@@ -11,6 +11,10 @@
 
 #include "TimestampIndex.h"
 
+#include <limits>
+
+#include "simd/hook.h"
+
 namespace milvus::segcore {
 
 void
@@ -48,6 +52,26 @@ TimestampIndex::build_with(const Timestamp* timestamps, int64_t size) {
     this->min_timestamp_ = min_ts;
     this->max_timestamp_ = last_max_v;
     this->timestamp_barriers_ = std::move(timestamp_barriers);
+
+    constexpr int64_t BITS_PER_BLOCK = BitsetType::bits_per_block;
+    auto num_blocks = (size + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK;
+    std::vector<Timestamp> prefix_max(num_blocks);
+    std::vector<Timestamp> suffix_min(num_blocks);
+    for (int64_t block_id = 0; block_id < num_blocks; ++block_id) {
+        auto beg = timestamps + block_id * BITS_PER_BLOCK;
+        auto end = timestamps + std::min(size, (block_id + 1) * BITS_PER_BLOCK);
+        auto [min_v, max_v] = std::minmax_element(beg, end);
+        prefix_max[block_id] =
+            block_id == 0 ? *max_v
+                          : std::max(*max_v, prefix_max[block_id - 1]);
+        suffix_min[block_id] = *min_v;
+    }
+    for (auto block_id = num_blocks - 2; block_id >= 0; --block_id) {
+        suffix_min[block_id] =
+            std::min(suffix_min[block_id], suffix_min[block_id + 1]);
+    }
+    this->block_prefix_max_ = std::move(prefix_max);
+    this->block_suffix_min_ = std::move(suffix_min);
 }
 
 std::pair<int64_t, int64_t>
@@ -64,23 +88,58 @@ TimestampIndex::get_active_range(Timestamp query_timestamp) const {
                                  query_timestamp);
     int block_id = (iter - timestamp_barriers_.begin()) - 1;
     Assert(0 <= block_id && block_id < lengths_.size());
-    return {start_locs_[block_id], start_locs_[block_id + 1]};
+    auto beg = start_locs_[block_id];
+    auto end = start_locs_[block_id + 1];
+
+    // rows before the first block holding a later timestamp are all OK,
+    // rows from the first block holding only later ones are all not OK
+    constexpr int64_t BITS_PER_BLOCK = BitsetType::bits_per_block;
+    auto first_later = std::upper_bound(block_prefix_max_.begin(),
+                                        block_prefix_max_.end(),
+                                        query_timestamp) -
+                       block_prefix_max_.begin();
+    auto first_all_later = std::upper_bound(block_suffix_min_.begin(),
+                                            block_suffix_min_.end(),
+                                            query_timestamp) -
+                           block_suffix_min_.begin();
+    beg = std::max(beg, first_later * BITS_PER_BLOCK);
+    end = std::min(end, first_all_later * BITS_PER_BLOCK);
+    return {beg, end};
 }
 
 BitsetType
 TimestampIndex::GenerateBitset(Timestamp query_timestamp,
                                std::pair<int64_t, int64_t> active_range,
                                const Timestamp* timestamps,
-                               int64_t size) {
+                               int64_t size) const {
     auto [beg, end] = active_range;
-    Assert(beg < end);
-    BitsetType bitset;
-    bitset.reserve(size);
-    bitset.resize(beg, false);
-    bitset.resize(size, true);
-    for (int64_t i = beg; i < end; ++i) {
-        bitset[i] = timestamps[i] > query_timestamp;
+    Assert(beg <= end);
+    using Block = BitsetType::block_type;
+    constexpr int64_t BITS_PER_BLOCK = BitsetType::bits_per_block;
+    BitsetType bitset(size, false);
+    // start at the block holding beg, the rows before beg compare false
+    auto block_beg = beg / BITS_PER_BLOCK * BITS_PER_BLOCK;
+    if (block_beg < end) {
+        constexpr auto int64_max = std::numeric_limits<int64_t>::max();
+        if (max_timestamp_ <= Timestamp(int64_max)) {
+            // both sides fit the signed comparison of the kernels
+            simd::CompareVal(
+                reinterpret_cast<const int64_t*>(timestamps) + block_beg,
+                end - block_beg,
+                static_cast<int64_t>(query_timestamp),
+                simd::CompareOp::GreaterThan,
+                bitset.data() + block_beg / BITS_PER_BLOCK);
+        } else {
+            auto blocks = bitset.data();
+            for (int64_t i = beg; i < end; ++i) {
+                blocks[i / BITS_PER_BLOCK] |=
+                    Block(timestamps[i] > query_timestamp)
+                    << (i % BITS_PER_BLOCK);
+            }
+        }
     }
+    // after the kernel, which clears the bits past end in its last block
+    bitset.set(end, size - end, true);
     return bitset;
 }
 
@@ -11,10 +11,10 @@
 
 #pragma once
 
-#include <boost/dynamic_bitset.hpp>
 #include <vector>
 #include <utility>
 
+#include "common/MemoryUsage.h"
 #include "common/Schema.h"
 
 namespace milvus::segcore {
@@ -34,11 +34,19 @@ class TimestampIndex {
     std::pair<int64_t, int64_t>
     get_active_range(Timestamp query_timestamp) const;
 
-    static BitsetType
+    // bit i set if row i is not OK, timestamps are the ones built with
+    BitsetType
     GenerateBitset(Timestamp query_timestamp,
                    std::pair<int64_t, int64_t> active_range,
                    const Timestamp* timestamps,
-                   int64_t size);
+                   int64_t size) const;
+
+    int64_t
+    memory_usage() const {
+        return HeapBytes(lengths_) + HeapBytes(start_locs_) +
+               HeapBytes(timestamp_barriers_) + HeapBytes(block_prefix_max_) +
+               HeapBytes(block_suffix_min_);
+    }
 
  private:
     // numSlice
@@ -50,6 +58,11 @@ class TimestampIndex {
     Timestamp max_timestamp_;
     // numSlice + 1
     std::vector<Timestamp> timestamp_barriers_;
+    // per bitset block of rows, the max timestamp of the blocks up to it
+    // and the min of the blocks from it on; both are sorted, and narrow
+    // the undecided slice down to whole blocks when data is nearly sorted
+    std::vector<Timestamp> block_prefix_max_;
+    std::vector<Timestamp> block_suffix_min_;
 };
 
 std::vector<int64_t>
@@ -18,9 +18,11 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "common/MemoryBudget.h"
 #include "common/Types.h"
 #include "common/type_c.h"
 #include "index/Index.h"
@@ -42,6 +44,10 @@ struct LoadIndexInfo {
     std::vector<std::string> index_files;
     index::IndexBasePtr index;
     storage::StorageConfig storage_config;
+    // scalar indexes are mapped from files under it unless empty
+    std::string mmap_dir_path;
+    // the load budget the index holds, shared by the segment it goes to
+    std::shared_ptr<MemoryReservation> reservation;
 };
 
 }  // namespace milvus::segcore
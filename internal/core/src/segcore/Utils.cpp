@@ -11,7 +11,15 @@
 
 #include "segcore/Utils.h"
 
+#include <fmt/core.h>
+#include <sys/mman.h>
+
+#include <chrono>
+#include <cstring>
+
 #include "index/ScalarIndex.h"
+#include "segcore/SegcoreConfig.h"
+#include "storage/DataCodec.h"
 
 namespace milvus::segcore {
 
@@ -35,26 +43,11 @@ ParsePksFromFieldData(std::vector<PkType>& pks, const DataArray& data) {
     }
 }
 
-void
-ParsePksFromIDs(std::vector<PkType>& pks,
-                DataType data_type,
-                const IdArray& data) {
-    switch (data_type) {
-        case DataType::INT64: {
-            auto source_data =
-                reinterpret_cast<const int64_t*>(data.int_id().data().data());
-            std::copy_n(source_data, pks.size(), pks.data());
-            break;
-        }
-        case DataType::VARCHAR: {
-            auto source_data = data.str_id().data();
-            std::copy(source_data.begin(), source_data.end(), pks.begin());
-            break;
-        }
-        default: {
-            PanicInfo("unsupported");
-        }
-    }
+MemoryReservation
+ReserveScratch(int64_t bytes, const std::string& what) {
+    auto wait = std::chrono::milliseconds(
+        SegcoreConfig::default_config().get_scratch_wait_ms());
+    return ScratchBudget().Acquire(bytes, wait, what);
 }
 
 int64_t
@@ -159,6 +152,12 @@ CreateVectorDataArray(int64_t count, const FieldMeta& field_meta) {
             obj->resize(num_bytes);
             break;
         }
+        case DataType::VECTOR_SPARSE_FLOAT: {
+            // count empty rows, a zero count of nonzeros each
+            vector_array->mutable_binary_vector()->resize(
+                count * sizeof(uint32_t));
+            break;
+        }
         default: {
             PanicInfo("unsupported datatype");
         }
@@ -166,6 +165,29 @@ CreateVectorDataArray(int64_t count, const FieldMeta& field_meta) {
     return data_array;
 }
 
+void*
+AppendVectorRows(DataArray* data_array,
+                 const FieldMeta& field_meta,
+                 int64_t count) {
+    auto vector_array = data_array->mutable_vectors();
+    switch (field_meta.get_data_type()) {
+        case DataType::VECTOR_FLOAT: {
+            auto obj = vector_array->mutable_float_vector();
+            auto length = count * field_meta.get_dim();
+            return AppendRows(obj->mutable_data(), length);
+        }
+        case DataType::VECTOR_BINARY: {
+            auto obj = vector_array->mutable_binary_vector();
+            auto size = obj->size();
+            obj->resize(size + count * field_meta.get_sizeof());
+            return obj->data() + size;
+        }
+        default: {
+            PanicInfo("unsupported datatype");
+        }
+    }
+}
+
 std::unique_ptr<DataArray>
 CreateScalarDataArrayFrom(const void* data_raw,
                           int64_t count,
@@ -290,18 +312,82 @@ std::unique_ptr<DataArray>
 MergeDataArray(
     std::vector<std::pair<milvus::SearchResult*, int64_t>>& result_offsets,
     const FieldMeta& field_meta) {
-    auto data_type = field_meta.get_data_type();
     auto data_array = std::make_unique<DataArray>();
+    MergeDataArray(result_offsets, field_meta, data_array.get());
+    return data_array;
+}
+
+void
+MergeDataArray(
+    std::vector<std::pair<milvus::SearchResult*, int64_t>>& result_offsets,
+    const FieldMeta& field_meta,
+    DataArray* data_array) {
+    auto data_type = field_meta.get_data_type();
     data_array->set_field_id(field_meta.get_id().get());
     data_array->set_type(
         milvus::proto::schema::DataType(field_meta.get_data_type()));
 
+    // the rows are appended one by one, reserved up front so an arena does
+    // not keep the outgrown buffers
+    int64_t n = result_offsets.size();
+    if (n > 0 && data_type == DataType::VECTOR_FLOAT) {
+        data_array->mutable_vectors()
+            ->mutable_float_vector()
+            ->mutable_data()
+            ->Reserve(n * field_meta.get_dim());
+    } else if (n > 0 && !field_meta.is_vector()) {
+        auto scalar_array = data_array->mutable_scalars();
+        switch (data_type) {
+            case DataType::BOOL:
+                scalar_array->mutable_bool_data()->mutable_data()->Reserve(n);
+                break;
+            case DataType::INT8:
+            case DataType::INT16:
+            case DataType::INT32:
+                scalar_array->mutable_int_data()->mutable_data()->Reserve(n);
+                break;
+            case DataType::INT64:
+                scalar_array->mutable_long_data()->mutable_data()->Reserve(n);
+                break;
+            case DataType::FLOAT:
+                scalar_array->mutable_float_data()->mutable_data()->Reserve(
+                    n);
+                break;
+            case DataType::DOUBLE:
+                scalar_array->mutable_double_data()->mutable_data()->Reserve(
+                    n);
+                break;
+            case DataType::VARCHAR:
+                scalar_array->mutable_string_data()->mutable_data()->Reserve(
+                    n);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // the rows of each source, variable sized
+    std::unordered_map<const DataArray*, std::vector<int64_t>> sparse_starts;
     for (auto& result_pair : result_offsets) {
         auto src_field_data =
             result_pair.first->output_fields_data_[field_meta.get_id()].get();
         auto src_offset = result_pair.second;
         AssertInfo(data_type == DataType(src_field_data->type()),
                    "merge field data type not consistent");
+        if (field_meta.is_sparse_vector()) {
+            auto [it, inserted] = sparse_starts.try_emplace(src_field_data);
+            if (inserted) {
+                it->second = SparseRowStarts(*src_field_data);
+            }
+            auto& starts = it->second;
+            auto vector_array = data_array->mutable_vectors();
+            vector_array->set_dim(field_meta.get_dim());
+            vector_array->mutable_binary_vector()->append(
+                src_field_data->vectors().binary_vector(),
+                starts[src_offset],
+                starts[src_offset + 1] - starts[src_offset]);
+            continue;
+        }
         if (field_meta.is_vector()) {
             auto vector_array = data_array->mutable_vectors();
             auto dim = field_meta.get_dim();
@@ -363,7 +449,7 @@ MergeDataArray(
                 continue;
             }
             case DataType::VARCHAR: {
-                auto data = src_field_data->scalars().string_data();
+                auto& data = src_field_data->scalars().string_data();
                 auto obj = scalar_array->mutable_string_data();
                 *(obj->mutable_data()->Add()) = data.data(src_offset);
                 continue;
@@ -373,8 +459,28 @@ MergeDataArray(
             }
         }
     }
+}
 
-    return data_array;
+int64_t
+ResultValueBytes(const FieldMeta& field_meta) {
+    if (field_meta.is_string()) {
+        return sizeof(std::string);
+    }
+    return field_meta.get_sizeof();
+}
+
+google::protobuf::ArenaOptions
+ResultArenaOptions(int64_t expected_bytes) {
+    constexpr int64_t kMinBlockSize = 4 << 10;
+    constexpr int64_t kMaxBlockSize = 64 << 20;
+    google::protobuf::ArenaOptions options;
+    // a quarter more for the headers of the messages, the repeated fields
+    // sized up front take the rest; a bigger one gets a block of its own
+    options.start_block_size = std::clamp(
+        expected_bytes + expected_bytes / 4, kMinBlockSize, kMaxBlockSize);
+    options.max_block_size =
+        std::max(options.start_block_size, options.max_block_size);
+    return options;
 }
 
 // TODO: split scalar IndexBase with knowhere::Index
@@ -394,21 +500,18 @@ ReverseDataFromIndex(const index::IndexBase* index,
         case DataType::BOOL: {
             using IndexType = index::ScalarIndex<bool>;
             auto ptr = dynamic_cast<const IndexType*>(index);
-            std::vector<bool> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            // std::vector<bool> has no data() to decode into
+            auto raw_data = std::make_unique<bool[]>(count);
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.get());
             auto obj = scalar_array->mutable_bool_data();
-            *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
+            *(obj->mutable_data()) = {raw_data.get(), raw_data.get() + count};
             break;
         }
         case DataType::INT8: {
             using IndexType = index::ScalarIndex<int8_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int8_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_int_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -417,9 +520,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<int16_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int16_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_int_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -428,9 +529,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<int32_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int32_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_int_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -439,9 +538,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<int64_t>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<int64_t> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_long_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -450,9 +547,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<float>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<float> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_float_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -461,9 +556,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<double>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<double> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_double_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -472,9 +565,7 @@ ReverseDataFromIndex(const index::IndexBase* index,
             using IndexType = index::ScalarIndex<std::string>;
             auto ptr = dynamic_cast<const IndexType*>(index);
             std::vector<std::string> raw_data(count);
-            for (int64_t i = 0; i < count; ++i) {
-                raw_data[i] = ptr->Reverse_Lookup(seg_offsets[i]);
-            }
+            ptr->ReverseLookupBatch(seg_offsets, count, raw_data.data());
             auto obj = scalar_array->mutable_string_data();
             *(obj->mutable_data()) = {raw_data.begin(), raw_data.end()};
             break;
@@ -487,4 +578,164 @@ ReverseDataFromIndex(const index::IndexBase* index,
     return data_array;
 }
 
+void*
+MapFieldBinlogs(const FieldMeta& field_meta,
+                const std::vector<std::string>& binlogs,
+                int64_t row_count,
+                storage::ChunkManager& chunk_manager) {
+    auto data_type = field_meta.get_data_type();
+    AssertInfo(!datatype_is_variable(data_type) && data_type != DataType::BOOL,
+               "binlogs of fixed width fields only can be mapped");
+    auto row_bytes = field_meta.get_sizeof();
+    auto size = row_bytes * row_count;
+    auto map = mmap(nullptr,
+                    size,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANON,
+                    -1,
+                    0);
+    AssertInfo(
+        map != MAP_FAILED,
+        fmt::format("failed to create anon map, err: {}", strerror(errno)));
+
+    try {
+        int64_t rows = 0;
+        std::vector<uint8_t> buf;
+        for (auto& binlog : binlogs) {
+            buf.resize(chunk_manager.Size(binlog));
+            chunk_manager.Read(binlog, buf.data(), buf.size());
+            auto codec = storage::DeserializeFileData(buf.data(), buf.size());
+            auto payload = codec->GetPayload();
+            AssertInfo(payload->data_type == data_type,
+                       fmt::format("binlog {} has data type {}, expected {}",
+                                   binlog,
+                                   int(payload->data_type),
+                                   int(data_type)));
+            if (field_meta.is_vector()) {
+                AssertInfo(payload->dimension == field_meta.get_dim(),
+                           "binlog " + binlog + " has a different dim");
+            }
+            AssertInfo(rows + payload->rows <= row_count,
+                       "binlogs hold more rows than the field");
+            auto rows_map = static_cast<char*>(map) + rows * row_bytes;
+            std::memcpy(rows_map, payload->raw_data, payload->rows * row_bytes);
+            if (IsCosineField(field_meta)) {
+                NormalizeVectors(reinterpret_cast<float*>(rows_map),
+                                 payload->rows,
+                                 field_meta.get_dim());
+            }
+            rows += payload->rows;
+        }
+        AssertInfo(rows == row_count,
+                   fmt::format("binlogs hold {} rows, expected {}",
+                               rows,
+                               row_count));
+    } catch (...) {
+        munmap(map, size);
+        throw;
+    }
+    return map;
+}
+
+void*
+MapGrowingColumn(const FieldMeta& field_meta,
+                 const VectorBase& column,
+                 int64_t row_count,
+                 const int64_t* order) {
+    AssertInfo(!datatype_is_variable(field_meta.get_data_type()),
+               "columns of fixed width fields only can be mapped");
+    auto row_bytes = field_meta.get_sizeof();
+    auto size = row_bytes * row_count;
+    auto map = mmap(nullptr,
+                    size,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANON,
+                    -1,
+                    0);
+    AssertInfo(
+        map != MAP_FAILED,
+        fmt::format("failed to create anon map, err: {}", strerror(errno)));
+
+    auto size_per_chunk = column.get_size_per_chunk();
+    if (order != nullptr) {
+        for (int64_t i = 0; i < row_count; ++i) {
+            auto chunk = static_cast<const char*>(
+                column.get_chunk_data(order[i] / size_per_chunk));
+            std::memcpy(static_cast<char*>(map) + i * row_bytes,
+                        chunk + (order[i] % size_per_chunk) * row_bytes,
+                        row_bytes);
+        }
+        return map;
+    }
+    for (int64_t begin = 0; begin < row_count; begin += size_per_chunk) {
+        auto rows = std::min(size_per_chunk, row_count - begin);
+        std::memcpy(static_cast<char*>(map) + begin * row_bytes,
+                    column.get_chunk_data(begin / size_per_chunk),
+                    rows * row_bytes);
+    }
+    return map;
+}
+
+std::vector<SegOffset>
+BitsetOffsets(const uint8_t* data,
+              int64_t size,
+              bool invert,
+              int64_t limit,
+              const Timestamp* timestamps,
+              Timestamp timestamp,
+              int64_t check_begin,
+              int64_t check_end) {
+    std::vector<SegOffset> offsets;
+    size = std::min(size, check_end);
+    if (size <= 0 || limit == 0) {
+        return offsets;
+    }
+    auto num_bytes = (size + 7) / 8;
+    auto num_words = (size + 63) / 64;
+    auto load = [&](int64_t word_id) {
+        uint64_t word = 0;
+        auto begin = word_id * 8;
+        memcpy(&word, data + begin, std::min<int64_t>(8, num_bytes - begin));
+        if (invert) {
+            word = ~word;
+        }
+        auto rest = size - word_id * 64;
+        if (rest < 64) {
+            word &= (uint64_t(1) << rest) - 1;
+        }
+        return word;
+    };
+
+    int64_t count = 0;
+    for (int64_t word_id = 0; word_id < num_words; ++word_id) {
+        count += __builtin_popcountll(load(word_id));
+    }
+    offsets.reserve(limit < 0 ? count : std::min(count, limit));
+
+    for (int64_t word_id = 0; word_id < num_words; ++word_id) {
+        auto word = load(word_id);
+        if (word == 0) {
+            continue;
+        }
+        auto base = word_id * 64;
+        if (check_begin < size && base + 64 > check_begin) {
+            // a mask of the rows of the word inserted by timestamp
+            auto n = std::min<int64_t>(64, size - base);
+            uint64_t inserted = 0;
+            for (int64_t i = 0; i < n; ++i) {
+                inserted |= uint64_t(timestamps[base + i] <= timestamp) << i;
+            }
+            word &= inserted;
+        }
+        while (word != 0) {
+            offsets.emplace_back(base + __builtin_ctzll(word));
+            if (int64_t(offsets.size()) == limit) {
+                return offsets;
+            }
+            word &= word - 1;
+        }
+    }
+    return offsets;
+}
+
 }  // namespace milvus::segcore
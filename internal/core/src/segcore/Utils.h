@@ -9,33 +9,89 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <algorithm>
 #include <unordered_map>
 #include <exception>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <stdlib.h>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "google/protobuf/arena.h"
+#include "common/MemoryBudget.h"
 #include "common/QueryResult.h"
 #include "segcore/DeletedRecord.h"
 #include "segcore/InsertRecord.h"
 #include "index/Index.h"
+#include "storage/ChunkManager.h"
 
 namespace milvus::segcore {
 
 void
 ParsePksFromFieldData(std::vector<PkType>& pks, const DataArray& data);
 
-void
-ParsePksFromIDs(std::vector<PkType>& pks,
-                DataType data_type,
-                const IdArray& data);
-
 int64_t
 GetSizeOfIdArray(const IdArray& data);
 
+// calls fn(pks, n) with the pks of ids as a column of the pk type, a
+// const int64_t* viewing ids in place or a const std::string_view*
+template <typename Fn>
+void
+VisitPks(DataType pk_type, const IdArray& ids, Fn&& fn) {
+    switch (pk_type) {
+        case DataType::INT64: {
+            AssertInfo(ids.has_int_id(), "Id array doesn't have int_id");
+            auto& data = ids.int_id().data();
+            fn(reinterpret_cast<const int64_t*>(data.data()),
+               int64_t(data.size()));
+            break;
+        }
+        case DataType::VARCHAR: {
+            AssertInfo(ids.has_str_id(), "Id array doesn't have str_id");
+            auto& data = ids.str_id().data();
+            std::vector<std::string_view> pks(data.begin(), data.end());
+            fn(pks.data(), int64_t(pks.size()));
+            break;
+        }
+        default: {
+            PanicInfo("unsupported primary key data type");
+        }
+    }
+}
+
+// the same for the data of a pk field
+template <typename Fn>
+void
+VisitPks(const DataArray& data, Fn&& fn) {
+    switch (DataType(data.type())) {
+        case DataType::INT64: {
+            auto& pks = data.scalars().long_data().data();
+            fn(reinterpret_cast<const int64_t*>(pks.data()),
+               int64_t(pks.size()));
+            break;
+        }
+        case DataType::VARCHAR: {
+            auto& src = data.scalars().string_data().data();
+            std::vector<std::string_view> pks(src.begin(), src.end());
+            fn(pks.data(), int64_t(pks.size()));
+            break;
+        }
+        default: {
+            PanicInfo("unsupported primary key data type");
+        }
+    }
+}
+
+// the scratch of a request out of the scratch budget, queueing for it up
+// to the configured wait before failing with OutOfMemory
+MemoryReservation
+ReserveScratch(int64_t bytes, const std::string& what);
+
 // Note: this is temporary solution.
 // modify bulk script implement to make process more clear
 std::unique_ptr<DataArray>
@@ -44,6 +100,35 @@ CreateScalarDataArray(int64_t count, const FieldMeta& field_meta);
 std::unique_ptr<DataArray>
 CreateVectorDataArray(int64_t count, const FieldMeta& field_meta);
 
+// Appends count rows to a repeated field of a data array and returns the
+// first, for bulk_subscript to gather into in place rather than into a
+// buffer copied in later. The values are left uninitialized, the strings
+// are empty and written through their pointers.
+template <typename T>
+T*
+AppendRows(google::protobuf::RepeatedField<T>* field, int64_t count) {
+    field->Reserve(field->size() + count);
+    return field->AddNAlreadyReserved(count);
+}
+
+inline std::string**
+AppendRows(google::protobuf::RepeatedPtrField<std::string>* field,
+           int64_t count) {
+    auto begin = field->size();
+    field->Reserve(begin + count);
+    for (int64_t i = 0; i < count; ++i) {
+        field->Add();
+    }
+    return field->mutable_data() + begin;
+}
+
+// as AppendRows, for count rows of the vectors of data_array; binary rows
+// come zeroed
+void*
+AppendVectorRows(DataArray* data_array,
+                 const FieldMeta& field_meta,
+                 int64_t count);
+
 std::unique_ptr<DataArray>
 CreateScalarDataArrayFrom(const void* data_raw,
                           int64_t count,
@@ -65,23 +150,186 @@ MergeDataArray(
     std::vector<std::pair<milvus::SearchResult*, int64_t>>& result_offsets,
     const FieldMeta& field_meta);
 
+// merges into data_array, which may live on an arena
+void
+MergeDataArray(
+    std::vector<std::pair<milvus::SearchResult*, int64_t>>& result_offsets,
+    const FieldMeta& field_meta,
+    DataArray* data_array);
+
+// the bytes of a value of field_meta in a result message, a string counted
+// by its header
+int64_t
+ResultValueBytes(const FieldMeta& field_meta);
+
+// options of an arena for a result message of about expected_bytes, the
+// message taking a single block when it is not too big
+google::protobuf::ArenaOptions
+ResultArenaOptions(int64_t expected_bytes);
+
+// the rows whose bits among the first size bits of data are set, or
+// clear if invert, at most limit of them unless negative. the rows in
+// [check_begin, check_end) are kept if timestamps has them inserted by
+// timestamp, the ones from check_end on are dropped. the bits are scanned
+// a 64-bit word at a time, the empty words skipped
+std::vector<SegOffset>
+BitsetOffsets(const uint8_t* data,
+              int64_t size,
+              bool invert,
+              int64_t limit,
+              const Timestamp* timestamps,
+              Timestamp timestamp,
+              int64_t check_begin,
+              int64_t check_end);
+
+// the rows of the pks of ids inserted by timestamp, and the pk of each
 template <bool is_sealed>
-std::shared_ptr<DeletedRecord::TmpBitmap>
+std::pair<std::unique_ptr<IdArray>, std::vector<SegOffset>>
+SearchIds(const InsertRecord<is_sealed>& insert_record,
+          DataType pk_type,
+          const IdArray& ids,
+          Timestamp timestamp) {
+    auto res_id_arr = std::make_unique<IdArray>();
+    std::vector<SegOffset> res_offsets;
+    VisitPks(pk_type, ids, [&](auto pks, int64_t n) {
+        std::vector<int64_t> offsets;
+        std::vector<int64_t> bounds;
+        insert_record.search_pks(pks,
+                                 n,
+                                 std::numeric_limits<int64_t>::max(),
+                                 offsets,
+                                 bounds);
+        for (int64_t i = 0; i < n; ++i) {
+            for (auto j = bounds[i]; j < bounds[i + 1]; ++j) {
+                if (insert_record.timestamps_[offsets[j]] > timestamp) {
+                    continue;
+                }
+                if constexpr (std::is_same_v<decltype(pks),
+                                             const int64_t*>) {
+                    res_id_arr->mutable_int_id()->add_data(pks[i]);
+                } else {
+                    res_id_arr->mutable_str_id()->add_data(
+                        std::string(pks[i]));
+                }
+                res_offsets.emplace_back(offsets[j]);
+            }
+        }
+    });
+    return {std::move(res_id_arr), std::move(res_offsets)};
+}
+
+// the distinct pks of delete records [start, end) in ascending order, with
+// the timestamp of the latest delete of each; string pks view the record
+template <typename Pk>
+void
+LatestDeletes(const DeletedRecord& delete_record,
+              int64_t start,
+              int64_t end,
+              std::vector<Pk>& pks,
+              std::vector<Timestamp>& delete_timestamps) {
+    std::vector<std::pair<Pk, Timestamp>> deletes(end - start);
+    delete_record.for_each_pk_span(
+        start, end, [&](const auto* span, int64_t begin, int64_t count) {
+            if constexpr (std::is_constructible_v<Pk, decltype(*span)>) {
+                for (int64_t i = 0; i < count; ++i) {
+                    deletes[begin - start + i].first = Pk(span[i]);
+                }
+            } else {
+                PanicInfo("pk type mismatches the deleted record");
+            }
+        });
+    delete_record.timestamps_.for_each_span(
+        start, end, [&](const Timestamp* ts, int64_t begin, int64_t count) {
+            for (int64_t i = 0; i < count; ++i) {
+                deletes[begin - start + i].second = ts[i];
+            }
+        });
+    std::sort(deletes.begin(), deletes.end());
+    for (size_t i = 0; i < deletes.size(); ++i) {
+        if (i + 1 < deletes.size() &&
+            deletes[i + 1].first == deletes[i].first) {
+            continue;
+        }
+        pks.push_back(deletes[i].first);
+        delete_timestamps.push_back(deletes[i].second);
+    }
+}
+
+// the same for string pks with their fingerprints, grouped by fingerprint
+// so the strings are compared only when fingerprints collide
+inline void
+LatestDeletes(const DeletedRecord& delete_record,
+              int64_t start,
+              int64_t end,
+              std::vector<std::string_view>& pks,
+              std::vector<uint64_t>& fingerprints,
+              std::vector<Timestamp>& delete_timestamps) {
+    std::vector<std::tuple<uint64_t, std::string_view, Timestamp>> deletes(
+        end - start);
+    delete_record.for_each_fingerprint_span(
+        start, end, [&](const uint64_t* span, int64_t begin, int64_t count) {
+            for (int64_t i = 0; i < count; ++i) {
+                std::get<0>(deletes[begin - start + i]) = span[i];
+            }
+        });
+    delete_record.for_each_pk_span(
+        start, end, [&](const auto* span, int64_t begin, int64_t count) {
+            if constexpr (std::is_constructible_v<std::string_view,
+                                                  decltype(*span)>) {
+                for (int64_t i = 0; i < count; ++i) {
+                    std::get<1>(deletes[begin - start + i]) = span[i];
+                }
+            } else {
+                PanicInfo("pk type mismatches the deleted record");
+            }
+        });
+    delete_record.timestamps_.for_each_span(
+        start, end, [&](const Timestamp* ts, int64_t begin, int64_t count) {
+            for (int64_t i = 0; i < count; ++i) {
+                std::get<2>(deletes[begin - start + i]) = ts[i];
+            }
+        });
+    std::sort(deletes.begin(), deletes.end());
+    for (size_t i = 0; i < deletes.size(); ++i) {
+        auto& [fingerprint, pk, timestamp] = deletes[i];
+        if (i + 1 < deletes.size() &&
+            std::get<0>(deletes[i + 1]) == fingerprint &&
+            std::get<1>(deletes[i + 1]) == pk) {
+            continue;
+        }
+        pks.push_back(pk);
+        fingerprints.push_back(fingerprint);
+        delete_timestamps.push_back(timestamp);
+    }
+}
+
+template <bool is_sealed>
+DeletedRecord::SnapshotPtr
 get_deleted_bitmap(int64_t del_barrier,
                    int64_t insert_barrier,
                    DeletedRecord& delete_record,
                    const InsertRecord<is_sealed>& insert_record,
-                   Timestamp query_timestamp) {
+                   Timestamp query_timestamp,
+                   bool* cached = nullptr) {
+    // the deletes read stay until the snapshot is published, and the ones
+    // compacted meanwhile are in the published snapshot
+    auto log_lck = delete_record.lock_log();
+    del_barrier = std::max(del_barrier, delete_record.compacted());
+
     // if insert_barrier and del_barrier have not changed, use cache data directly
-    bool hit_cache = false;
-    int64_t old_del_barrier = 0;
-    auto current = delete_record.clone_lru_entry(
-        insert_barrier, del_barrier, old_del_barrier, hit_cache);
-    if (hit_cache) {
-        return current;
+    auto published = delete_record.get_snapshot();
+    auto old_del_barrier = published->del_barrier();
+    if (old_del_barrier == del_barrier &&
+        published->size() == insert_barrier) {
+        if (cached != nullptr) {
+            *cached = true;
+        }
+        return published;
     }
 
-    auto bitmap = current->bitmap_ptr;
+    // shares every page with the published snapshot until it is written
+    auto current = std::make_shared<DeletedRecord::Snapshot>(
+        *published, del_barrier, insert_barrier);
 
     int64_t start, end;
     if (del_barrier < old_del_barrier) {
@@ -98,24 +346,34 @@ get_deleted_bitmap(int64_t del_barrier,
         end = del_barrier;
     }
 
-    // Avoid invalid calculations when there are a lot of repeated delete pks
-    std::unordered_map<PkType, Timestamp> delete_timestamps;
-    for (auto del_index = start; del_index < end; ++del_index) {
-        auto pk = delete_record.pks_[del_index];
-        auto timestamp = delete_record.timestamps_[del_index];
-
-        delete_timestamps[pk] = timestamp > delete_timestamps[pk]
-                                    ? timestamp
-                                    : delete_timestamps[pk];
+    // Avoid invalid calculations when there are a lot of repeated delete pks,
+    // the latest delete of each pk decides, pks are resolved in one sorted
+    // batch
+    std::vector<Timestamp> delete_timestamps;
+    std::vector<int64_t> offsets;
+    std::vector<int64_t> bounds;
+    if (delete_record.pk_type() == DataType::INT64) {
+        std::vector<int64_t> pks;
+        LatestDeletes(delete_record, start, end, pks, delete_timestamps);
+        insert_record.search_pks(
+            pks.data(), pks.size(), insert_barrier, offsets, bounds);
+    } else {
+        std::vector<std::string_view> pks;
+        std::vector<uint64_t> fingerprints;
+        LatestDeletes(
+            delete_record, start, end, pks, fingerprints, delete_timestamps);
+        insert_record.search_pks(pks.data(),
+                                 fingerprints.data(),
+                                 pks.size(),
+                                 insert_barrier,
+                                 offsets,
+                                 bounds);
     }
 
-    for (auto iter = delete_timestamps.begin(); iter != delete_timestamps.end();
-         iter++) {
-        auto pk = iter->first;
-        auto delete_timestamp = iter->second;
-        auto segOffsets = insert_record.search_pk(pk, insert_barrier);
-        for (auto offset : segOffsets) {
-            int64_t insert_row_offset = offset.get();
+    for (size_t i = 0; i < delete_timestamps.size(); ++i) {
+        auto delete_timestamp = delete_timestamps[i];
+        for (auto j = bounds[i]; j < bounds[i + 1]; ++j) {
+            int64_t insert_row_offset = offsets[j];
             // for now, insert_barrier == insert count of segment, so this Assert will always work
             AssertInfo(insert_row_offset < insert_barrier,
                        "Timestamp offset is larger than insert barrier");
@@ -124,29 +382,69 @@ get_deleted_bitmap(int64_t del_barrier,
             // and reset bitmap to 0
             if (insert_record.timestamps_[insert_row_offset] >=
                 delete_timestamp) {
-                bitmap->reset(insert_row_offset);
+                current->set(insert_row_offset, false);
                 continue;
             }
 
             // the deletion record do not take effect in search/query
             // and reset bitmap to 0
             if (delete_timestamp > query_timestamp) {
-                bitmap->reset(insert_row_offset);
+                current->set(insert_row_offset, false);
                 continue;
             }
             // insert data corresponding to the insert_row_offset will be ignored in search/query
-            bitmap->set(insert_row_offset);
+            current->set(insert_row_offset, true);
         }
     }
 
-    delete_record.insert_lru_entry(current);
+    delete_record.publish_snapshot(current);
     return current;
 }
 
+// Folds the deletes at or before timestamp into the published snapshot
+// and frees the part of the delete log they fill. Queries must not read
+// at an earlier timestamp afterwards, they would see these deletes too;
+// the rows past insert_barrier must not be hit by them.
+template <bool is_sealed>
+void
+compact_deleted_record(DeletedRecord& delete_record,
+                       const InsertRecord<is_sealed>& insert_record,
+                       int64_t insert_barrier,
+                       Timestamp timestamp) {
+    auto del_barrier = get_barrier(delete_record, timestamp);
+    if (del_barrier <= delete_record.compacted()) {
+        return;
+    }
+    get_deleted_bitmap(del_barrier,
+                       insert_barrier,
+                       delete_record,
+                       insert_record,
+                       timestamp);
+    delete_record.compact(del_barrier);
+}
+
 std::unique_ptr<DataArray>
 ReverseDataFromIndex(const index::IndexBase* index,
                      const int64_t* seg_offsets,
                      int64_t count,
                      const FieldMeta& field_meta);
 
+// Anonymously maps the row_count rows of a fixed width field from its
+// insert binlogs, read in order through chunk_manager. The decoded arrow
+// payloads are copied straight into the mapping, a binlog at a time.
+void*
+MapFieldBinlogs(const FieldMeta& field_meta,
+                const std::vector<std::string>& binlogs,
+                int64_t row_count,
+                storage::ChunkManager& chunk_manager);
+
+// Anonymously maps the first row_count rows of a fixed width field of a
+// growing segment, its chunks copied one after another; row i is the one
+// at order[i] if given.
+void*
+MapGrowingColumn(const FieldMeta& field_meta,
+                 const VectorBase& column,
+                 int64_t row_count,
+                 const int64_t* order = nullptr);
+
 }  // namespace milvus::segcore
@@ -2,10 +2,15 @@
 
 #include <sys/mman.h>
 
+#include <cstring>
+#include <limits>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include "common/LoadInfo.h"
+#include "common/MemoryUsage.h"
+#include "segcore/ConcurrentVector.h"
 
 namespace milvus::segcore {
 
@@ -16,30 +21,77 @@ struct Entry {
 
 // Used for string/varchar field only,
 // TODO(yah01): make this generic
+// Row i is [offsets[i], offsets[i + 1]) of the mapped data, the offsets are
+// 32 bits wide unless the strings take more than 4GB.
 class VariableField {
  public:
     explicit VariableField(int64_t segment_id,
                            const FieldMeta& field_meta,
                            const LoadFieldDataInfo& info) {
-        auto begin = info.field_data->scalars().string_data().data().begin();
-        auto end = info.field_data->scalars().string_data().data().end();
-
-        indices_.reserve(info.row_count);
-        while (begin != end) {
-            indices_.push_back(size_);
-            size_ += begin->size();
-            begin++;
+        auto& strings = info.field_data->scalars().string_data().data();
+        for (auto& str : strings) {
+            size_ += str.size();
+        }
+        if (size_ <= std::numeric_limits<uint32_t>::max()) {
+            fill_offsets(strings, offsets32_);
+        } else {
+            fill_offsets(strings, offsets64_);
         }
 
         data_ = (char*)CreateMap(segment_id, field_meta, info);
-        construct_views();
+    }
+
+    // the first row_count strings of a growing segment column, copied
+    // into one anonymous mapping; row i is the one at order[i] if given
+    VariableField(const ConcurrentVector<std::string>& column,
+                  int64_t row_count,
+                  const int64_t* order = nullptr) {
+        std::vector<std::string_view> strings;
+        strings.reserve(row_count);
+        column.for_each_span(
+            0, row_count, [&](const std::string* values, int64_t, int64_t n) {
+                strings.insert(strings.end(), values, values + n);
+            });
+        if (order != nullptr) {
+            std::vector<std::string_view> ordered(row_count);
+            for (int64_t i = 0; i < row_count; ++i) {
+                ordered[i] = strings[order[i]];
+            }
+            strings.swap(ordered);
+        }
+        for (auto& str : strings) {
+            size_ += str.size();
+        }
+        if (size_ <= std::numeric_limits<uint32_t>::max()) {
+            fill_offsets(strings, offsets32_);
+        } else {
+            fill_offsets(strings, offsets64_);
+        }
+        if (size_ == 0) {
+            return;
+        }
+
+        data_ = (char*)mmap(nullptr,
+                            size_,
+                            PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANON,
+                            -1,
+                            0);
+        AssertInfo(data_ != MAP_FAILED,
+                   std::string("failed to create anon map, err: ") +
+                       strerror(errno));
+        auto dest = data_;
+        for (auto& str : strings) {
+            std::memcpy(dest, str.data(), str.size());
+            dest += str.size();
+        }
     }
 
     VariableField(VariableField&& field)
-        : indices_(std::move(field.indices_)),
+        : offsets32_(std::move(field.offsets32_)),
+          offsets64_(std::move(field.offsets64_)),
           size_(field.size_),
-          data_(field.data_),
-          views_(std::move(field.views_)) {
+          data_(field.data_) {
         field.data_ = nullptr;
     }
 
@@ -58,9 +110,19 @@ class VariableField {
         return data_;
     }
 
-    const std::vector<std::string_view>&
-    views() const {
-        return views_;
+    // the rows as a Span<std::string_view>
+    SpanBase
+    span() const {
+        if (offsets64_.empty()) {
+            return SpanBase(data_,
+                            offsets32_.data(),
+                            offsets32_.size() - 1,
+                            sizeof(uint32_t));
+        }
+        return SpanBase(data_,
+                        offsets64_.data(),
+                        offsets64_.size() - 1,
+                        sizeof(uint64_t));
     }
 
     size_t
@@ -68,30 +130,36 @@ class VariableField {
         return size_;
     }
 
+    // the mapped data and the offsets
+    int64_t
+    memory_usage() const {
+        return size_ + HeapBytes(offsets32_) + HeapBytes(offsets64_);
+    }
+
     Span<char>
-    operator[](const int i) const {
-        uint64_t next = (i + 1 == indices_.size()) ? size_ : indices_[i + 1];
-        uint64_t offset = indices_[i];
-        return Span<char>(data_ + offset, uint32_t(next - offset));
+    operator[](const int64_t i) const {
+        auto row = Span<std::string_view>(span())[i];
+        return Span<char>(row.data(), row.size());
     }
 
- protected:
-    void
-    construct_views() {
-        views_.reserve(indices_.size());
-        for (size_t i = 0; i < indices_.size() - 1; i++) {
-            views_.emplace_back(data_ + indices_[i],
-                                indices_[i + 1] - indices_[i]);
+ private:
+    template <typename Strings, typename Offset>
+    static void
+    fill_offsets(const Strings& strings, std::vector<Offset>& offsets) {
+        offsets.reserve(strings.size() + 1);
+        Offset offset = 0;
+        for (auto& str : strings) {
+            offsets.push_back(offset);
+            offset += str.size();
         }
-        views_.emplace_back(data_ + indices_.back(), size_ - indices_.back());
+        offsets.push_back(offset);
     }
 
  private:
-    std::vector<uint64_t> indices_{};
+    // one of them holds row_count + 1 offsets
+    std::vector<uint32_t> offsets32_{};
+    std::vector<uint64_t> offsets64_{};
     uint64_t size_{0};
     char* data_{nullptr};
-
-    // Compatible with current Span type
-    std::vector<std::string_view> views_{};
 };
 }  // namespace milvus::segcore
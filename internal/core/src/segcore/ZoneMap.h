@@ -0,0 +1,154 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "common/Types.h"
+
+namespace milvus::segcore {
+
+// rows per zone of a sealed column, a multiple of 64 so that a zone resolved
+// without touching the data covers whole bitset blocks
+constexpr int64_t SEALED_ZONE_ROWS = 8192;
+
+template <typename T>
+constexpr bool HasZoneMap = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// min/max of a range of rows, `valid` is false when the range is empty
+// or holds a NaN, which no bound can describe
+template <typename T>
+struct Zone {
+    T min = std::numeric_limits<T>::max();
+    T max = std::numeric_limits<T>::lowest();
+    bool valid = false;
+};
+
+template <typename T>
+Zone<T>
+ComputeZone(const T* data, int64_t size) {
+    Zone<T> zone;
+    if (size == 0) {
+        return zone;
+    }
+    auto [min, max] = std::minmax_element(data, data + size);
+    zone.min = *min;
+    zone.max = *max;
+    zone.valid = true;
+    if constexpr (std::is_floating_point_v<T>) {
+        zone.valid = std::none_of(
+            data, data + size, [](T x) { return std::isnan(x); });
+    }
+    return zone;
+}
+
+class ZoneMapBase {
+ public:
+    virtual ~ZoneMapBase() = default;
+
+    virtual int64_t
+    memory_usage() const = 0;
+};
+
+// zones of consecutive `zone_rows` rows of one chunk
+template <typename T>
+struct ZoneMap : ZoneMapBase {
+    int64_t zone_rows = 0;
+    std::vector<Zone<T>> zones;
+
+    int64_t
+    memory_usage() const override {
+        return zones.capacity() * sizeof(Zone<T>);
+    }
+
+    static std::shared_ptr<ZoneMap<T>>
+    Build(const T* data, int64_t size, int64_t zone_rows) {
+        auto zone_map = std::make_shared<ZoneMap<T>>();
+        zone_map->zone_rows = zone_rows;
+        for (int64_t begin = 0; begin < size; begin += zone_rows) {
+            auto end = std::min(begin + zone_rows, size);
+            zone_map->zones.push_back(ComputeZone(data + begin, end - begin));
+        }
+        return zone_map;
+    }
+};
+
+// zone of a growing chunk, widened by concurrent inserts before their
+// rows are acknowledged, so it always covers every visible row
+template <typename T>
+class ChunkZone {
+ public:
+    void
+    Update(const T* data, int64_t size) {
+        auto zone = ComputeZone(data, size);
+        if (size > 0 && !zone.valid) {
+            has_nan_ = true;
+        }
+        if (size == 0 || !zone.valid) {
+            return;
+        }
+        auto min = min_.load();
+        while (zone.min < min && !min_.compare_exchange_weak(min, zone.min)) {
+        }
+        auto max = max_.load();
+        while (zone.max > max && !max_.compare_exchange_weak(max, zone.max)) {
+        }
+    }
+
+    Zone<T>
+    Get() const {
+        Zone<T> zone;
+        zone.min = min_.load();
+        zone.max = max_.load();
+        zone.valid = !has_nan_ && zone.min <= zone.max;
+        return zone;
+    }
+
+ private:
+    std::atomic<T> min_ = std::numeric_limits<T>::max();
+    std::atomic<T> max_ = std::numeric_limits<T>::lowest();
+    std::atomic<bool> has_nan_ = false;
+};
+
+inline std::shared_ptr<ZoneMapBase>
+BuildZoneMap(DataType data_type, const void* data, int64_t size) {
+    switch (data_type) {
+        case DataType::INT8:
+            return ZoneMap<int8_t>::Build(
+                static_cast<const int8_t*>(data), size, SEALED_ZONE_ROWS);
+        case DataType::INT16:
+            return ZoneMap<int16_t>::Build(
+                static_cast<const int16_t*>(data), size, SEALED_ZONE_ROWS);
+        case DataType::INT32:
+            return ZoneMap<int32_t>::Build(
+                static_cast<const int32_t*>(data), size, SEALED_ZONE_ROWS);
+        case DataType::INT64:
+            return ZoneMap<int64_t>::Build(
+                static_cast<const int64_t*>(data), size, SEALED_ZONE_ROWS);
+        case DataType::FLOAT:
+            return ZoneMap<float>::Build(
+                static_cast<const float*>(data), size, SEALED_ZONE_ROWS);
+        case DataType::DOUBLE:
+            return ZoneMap<double>::Build(
+                static_cast<const double*>(data), size, SEALED_ZONE_ROWS);
+        default:
+            return nullptr;
+    }
+}
+
+}  // namespace milvus::segcore
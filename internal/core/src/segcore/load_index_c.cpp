@@ -9,15 +9,26 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <chrono>
+
 #include "common/CDataType.h"
 #include "common/FieldMeta.h"
 #include "common/Utils.h"
+#include "index/BitmapIndex.h"
 #include "index/Meta.h"
 #include "index/Utils.h"
 #include "index/IndexFactory.h"
+#include "log/Log.h"
+#include "storage/MinioChunkManager.h"
+#include "storage/ThreadPool.h"
 #include "storage/Util.h"
+#include "segcore/IndexLoader.h"
 #include "segcore/load_index_c.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/Types.h"
+#ifdef BUILD_DISK_ANN
+#include "storage/DiskFileManagerImpl.h"
+#endif
 
 CStatus
 NewLoadIndexInfo(CLoadIndexInfo* c_load_index_info,
@@ -111,6 +122,16 @@ AppendFieldInfo(CLoadIndexInfo c_load_index_info,
     }
 }
 
+// about what an index loaded from the binaries takes in memory
+static int64_t
+BinarySetBytes(const knowhere::BinarySet& binary_set) {
+    int64_t bytes = 0;
+    for (auto& [key, binary] : binary_set.binary_map_) {
+        bytes += binary->size;
+    }
+    return bytes;
+}
+
 CStatus
 appendVecIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
     try {
@@ -159,6 +180,13 @@ appendVecIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
             load_index_info->index_params);
         config["index_files"] = load_index_info->index_files;
 
+        load_index_info->reservation =
+            std::make_shared<milvus::MemoryReservation>(
+                milvus::LoadBudget().Acquire(
+                    BinarySetBytes(*binary_set),
+                    std::chrono::milliseconds(0),
+                    "index of field " +
+                        std::to_string(load_index_info->field_id)));
         load_index_info->index =
             milvus::index::IndexFactory::GetInstance().CreateIndex(
                 index_info, file_manager);
@@ -167,6 +195,11 @@ appendVecIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
         status.error_code = Success;
         status.error_msg = "";
         return status;
+    } catch (milvus::SegcoreError& e) {
+        auto status = CStatus();
+        status.error_code = e.get_error_code();
+        status.error_msg = strdup(e.what());
+        return status;
     } catch (std::exception& e) {
         auto status = CStatus();
         status.error_code = UnexpectedError;
@@ -191,6 +224,10 @@ appendScalarIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
         milvus::index::CreateIndexInfo index_info;
         index_info.field_type = milvus::DataType(field_type);
         index_info.index_type = index_params["index_type"];
+        // the builder swaps in a bitmap index by the data, not the params
+        if (binary_set->Contains(milvus::index::BITMAP_INDEX_META)) {
+            index_info.index_type = milvus::index::BITMAP_INDEX_TYPE;
+        }
         // set default index mode
         index_info.index_mode = milvus::IndexMode::MODE_CPU;
         if (index_params.count("index_mode")) {
@@ -201,11 +238,47 @@ appendScalarIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
         load_index_info->index =
             milvus::index::IndexFactory::GetInstance().CreateIndex(index_info,
                                                                    nullptr);
-        load_index_info->index->Load(*binary_set);
+        // indexes the load budget has no room for get mapped from the
+        // fallback dir if set
+        auto& mmap_dir_path = load_index_info->mmap_dir_path;
+        if (mmap_dir_path.empty()) {
+            auto bytes = BinarySetBytes(*binary_set);
+            auto& budget = milvus::LoadBudget();
+            auto& fallback_dir =
+                milvus::segcore::SegcoreConfig::default_config()
+                    .get_load_fallback_mmap_dir();
+            if (budget.TryReserve(bytes)) {
+                load_index_info->reservation =
+                    std::make_shared<milvus::MemoryReservation>(&budget, bytes);
+            } else if (!fallback_dir.empty()) {
+                mmap_dir_path = fallback_dir;
+            } else {
+                load_index_info->reservation =
+                    std::make_shared<milvus::MemoryReservation>(budget.Acquire(
+                        bytes,
+                        std::chrono::milliseconds(0),
+                        "index of field " +
+                            std::to_string(load_index_info->field_id)));
+            }
+        }
+        milvus::Config config;
+        if (!load_index_info->mmap_dir_path.empty()) {
+            auto filepath =
+                std::filesystem::path(load_index_info->mmap_dir_path) /
+                std::to_string(load_index_info->segment_id) /
+                ("index_" + std::to_string(load_index_info->field_id));
+            config[milvus::index::MMAP_FILE_PATH] = filepath.string();
+        }
+        load_index_info->index->Load(*binary_set, config);
         auto status = CStatus();
         status.error_code = Success;
         status.error_msg = "";
         return status;
+    } catch (milvus::SegcoreError& e) {
+        auto status = CStatus();
+        status.error_code = e.get_error_code();
+        status.error_msg = strdup(e.what());
+        return status;
     } catch (std::exception& e) {
         auto status = CStatus();
         status.error_code = UnexpectedError;
@@ -224,6 +297,110 @@ AppendIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set) {
     return appendScalarIndex(c_load_index_info, c_binary_set);
 }
 
+CStatus
+AppendIndexFromFiles(CLoadIndexInfo c_load_index_info) {
+    try {
+        auto load_index_info =
+            (milvus::segcore::LoadIndexInfo*)c_load_index_info;
+        auto& index_params = load_index_info->index_params;
+        AssertInfo(index_params.count("index_type") > 0,
+                   "Can't find index type in index_params");
+        // disk indexes download their files themselves
+        knowhere::BinarySet binary_set;
+        if (milvus::datatype_is_vector(load_index_info->field_type) &&
+            milvus::storage::is_in_disk_list(index_params["index_type"])) {
+            return AppendIndex(c_load_index_info, &binary_set);
+        }
+
+        AssertInfo(!load_index_info->index_files.empty(),
+                   "no index files to load");
+        milvus::storage::MinioChunkManager remote_chunk_manager(
+            load_index_info->storage_config);
+        auto fetched = milvus::segcore::FetchIndexFiles(
+            remote_chunk_manager, load_index_info->index_files);
+        // the caller waits on a bounded pool, so concurrent loads download
+        // while others deserialize
+        auto& pool =
+            milvus::ThreadPool::GetInstance(milvus::ThreadPoolType::LOAD);
+        return pool
+            .Submit([&] {
+                return AppendIndex(c_load_index_info, &fetched.binary_set);
+            })
+            .get();
+    } catch (milvus::SegcoreError& e) {
+        auto status = CStatus();
+        status.error_code = e.get_error_code();
+        status.error_msg = strdup(e.what());
+        return status;
+    } catch (std::exception& e) {
+        auto status = CStatus();
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+        return status;
+    }
+}
+
+CStatus
+PrefetchIndexFiles(CLoadIndexInfo c_load_index_info) {
+    try {
+        auto load_index_info =
+            (milvus::segcore::LoadIndexInfo*)c_load_index_info;
+        auto& index_params = load_index_info->index_params;
+        AssertInfo(index_params.count("index_type") > 0,
+                   "Can't find index type in index_params");
+        milvus::storage::FieldDataMeta field_meta{
+            load_index_info->collection_id,
+            load_index_info->partition_id,
+            load_index_info->segment_id,
+            load_index_info->field_id};
+        milvus::storage::IndexMeta index_meta{load_index_info->segment_id,
+                                              load_index_info->field_id,
+                                              load_index_info->index_build_id,
+                                              load_index_info->index_version};
+        auto file_manager =
+            milvus::storage::CreateFileManager(index_params["index_type"],
+                                               field_meta,
+                                               index_meta,
+                                               load_index_info->storage_config);
+#ifdef BUILD_DISK_ANN
+        auto disk_file_manager =
+            std::dynamic_pointer_cast<milvus::storage::DiskFileManagerImpl>(
+                file_manager);
+        if (disk_file_manager != nullptr &&
+            !load_index_info->index_files.empty()) {
+            // releasing the file manager keeps the files in the cache
+            auto& pool = milvus::ThreadPool::GetInstance(
+                milvus::ThreadPoolType::PREFETCH);
+            pool.Submit([disk_file_manager,
+                         files = load_index_info->index_files,
+                         build_id = load_index_info->index_build_id] {
+                try {
+                    disk_file_manager->CacheIndexToDisk(files);
+                } catch (std::exception& e) {
+                    LOG_SEGCORE_WARNING_ << "failed to prefetch the files of "
+                                         << "index build " << build_id << ": "
+                                         << e.what();
+                }
+            });
+        }
+#endif
+        auto status = CStatus();
+        status.error_code = Success;
+        status.error_msg = "";
+        return status;
+    } catch (milvus::SegcoreError& e) {
+        auto status = CStatus();
+        status.error_code = e.get_error_code();
+        status.error_msg = strdup(e.what());
+        return status;
+    } catch (std::exception& e) {
+        auto status = CStatus();
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+        return status;
+    }
+}
+
 CStatus
 AppendIndexFilePath(CLoadIndexInfo c_load_index_info, const char* c_file_path) {
     try {
@@ -268,6 +445,26 @@ AppendIndexInfo(CLoadIndexInfo c_load_index_info,
     }
 }
 
+CStatus
+AppendIndexMMapDirPath(CLoadIndexInfo c_load_index_info,
+                       const char* mmap_dir_path) {
+    try {
+        auto load_index_info =
+            (milvus::segcore::LoadIndexInfo*)c_load_index_info;
+        load_index_info->mmap_dir_path = mmap_dir_path;
+
+        auto status = CStatus();
+        status.error_code = Success;
+        status.error_msg = "";
+        return status;
+    } catch (std::exception& e) {
+        auto status = CStatus();
+        status.error_code = UnexpectedError;
+        status.error_msg = strdup(e.what());
+        return status;
+    }
+}
+
 CStatus
 CleanLoadedIndex(CLoadIndexInfo c_load_index_info) {
     try {
@@ -55,6 +55,23 @@ AppendIndex(CLoadIndexInfo c_load_index_info, CBinarySet c_binary_set);
 CStatus
 AppendIndexFilePath(CLoadIndexInfo c_load_index_info, const char* file_path);
 
+// loads the index from the files appended by AppendIndexFilePath: they
+// are downloaded in parallel and deserialized on the load pool
+CStatus
+AppendIndexFromFiles(CLoadIndexInfo c_load_index_info);
+
+// starts downloading the files of a disk index into the local index
+// cache at idle io priority, ahead of a load predicted to come; they stay
+// there only while disk_index_local_cache_size has room. other indexes
+// are not prefetched
+CStatus
+PrefetchIndexFiles(CLoadIndexInfo c_load_index_info);
+
+// scalar indexes get mapped from files under mmap_dir_path
+CStatus
+AppendIndexMMapDirPath(CLoadIndexInfo c_load_index_info,
+                       const char* mmap_dir_path);
+
 CStatus
 CleanLoadedIndex(CLoadIndexInfo c_load_index_info);
 
@@ -13,6 +13,7 @@
 #include "pb/segcore.pb.h"
 #include "query/Plan.h"
 #include "segcore/Collection.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/plan_c.h"
 
 CStatus
@@ -52,8 +53,15 @@ CreateSearchPlanByExpr(CCollection c_col,
     auto col = (milvus::segcore::Collection*)c_col;
 
     try {
-        auto res = milvus::query::CreateSearchPlanByExpr(
-            *col->get_schema(), serialized_expr_plan, size);
+        auto res = col->get_search_plan_cache().GetOrCreate(
+            serialized_expr_plan,
+            size,
+            milvus::segcore::SegcoreConfig::default_config()
+                .get_plan_cache_size(),
+            [&] {
+                return milvus::query::CreateSearchPlanByExpr(
+                    *col->get_schema(), serialized_expr_plan, size);
+            });
 
         auto status = CStatus();
         status.error_code = Success;
@@ -76,6 +84,66 @@ CreateSearchPlanByExpr(CCollection c_col,
     }
 }
 
+CStatus
+BindSearchPlanParams(CSearchPlan c_plan,
+                     const void* serialized_params,
+                     const int64_t size) {
+    try {
+        auto plan = static_cast<milvus::query::Plan*>(c_plan);
+        milvus::query::BindSearchPlanParams(plan, serialized_params, size);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, strdup(e.what()));
+    }
+}
+
+void
+SetSearchPlanProfile(CSearchPlan c_plan, bool enable) {
+    auto plan = static_cast<milvus::query::Plan*>(c_plan);
+    plan->profile_ = enable;
+}
+
+void
+SetSearchPlanDeadline(CSearchPlan c_plan, int64_t deadline_ms) {
+    auto plan = static_cast<milvus::query::Plan*>(c_plan);
+    plan->cancel_token_.SetDeadline(deadline_ms);
+}
+
+void
+SetSearchPlanPartialOnDeadline(CSearchPlan c_plan, bool enable) {
+    auto plan = static_cast<milvus::query::Plan*>(c_plan);
+    plan->partial_on_deadline_ = enable;
+}
+
+void
+CancelSearchPlan(CSearchPlan c_plan) {
+    auto plan = static_cast<milvus::query::Plan*>(c_plan);
+    plan->cancel_token_.Cancel();
+}
+
+void
+SetSearchPlanTenant(CSearchPlan c_plan, const char* tenant, int64_t weight) {
+    auto plan = static_cast<milvus::query::Plan*>(c_plan);
+    plan->tenant_ = tenant;
+    plan->tenant_weight_ = std::max<int64_t>(weight, 1);
+}
+
+CStatus
+ShareSearchPlanBound(CSearchPlan c_plan, CPlaceholderGroup placeholder_group) {
+    try {
+        auto plan = static_cast<milvus::query::Plan*>(c_plan);
+        milvus::query::ShareSearchBound(
+            plan,
+            static_cast<milvus::query::PlaceholderGroup*>(placeholder_group));
+        return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()),
+                                      e.what());
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 ParsePlaceholderGroup(CSearchPlan c_plan,
                       const void* placeholder_group_blob,
@@ -154,8 +222,15 @@ CreateRetrievePlanByExpr(CCollection c_col,
     auto col = (milvus::segcore::Collection*)c_col;
 
     try {
-        auto res = milvus::query::CreateRetrievePlanByExpr(
-            *col->get_schema(), serialized_expr_plan, size);
+        auto res = col->get_retrieve_plan_cache().GetOrCreate(
+            serialized_expr_plan,
+            size,
+            milvus::segcore::SegcoreConfig::default_config()
+                .get_plan_cache_size(),
+            [&] {
+                return milvus::query::CreateRetrievePlanByExpr(
+                    *col->get_schema(), serialized_expr_plan, size);
+            });
 
         auto status = CStatus();
         status.error_code = Success;
@@ -178,6 +253,31 @@ CreateRetrievePlanByExpr(CCollection c_col,
     }
 }
 
+CStatus
+BindRetrievePlanParams(CRetrievePlan c_plan,
+                       const void* serialized_params,
+                       const int64_t size) {
+    try {
+        auto plan = static_cast<milvus::query::RetrievePlan*>(c_plan);
+        milvus::query::BindRetrievePlanParams(plan, serialized_params, size);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, strdup(e.what()));
+    }
+}
+
+void
+SetRetrievePlanDeadline(CRetrievePlan c_plan, int64_t deadline_ms) {
+    auto plan = static_cast<milvus::query::RetrievePlan*>(c_plan);
+    plan->cancel_token_.SetDeadline(deadline_ms);
+}
+
+void
+CancelRetrievePlan(CRetrievePlan c_plan) {
+    auto plan = static_cast<milvus::query::RetrievePlan*>(c_plan);
+    plan->cancel_token_.Cancel();
+}
+
 void
 DeleteRetrievePlan(CRetrievePlan c_plan) {
     auto plan = (milvus::query::RetrievePlan*)c_plan;
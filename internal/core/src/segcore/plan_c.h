@@ -33,6 +33,45 @@ CreateSearchPlanByExpr(CCollection col,
                        const int64_t size,
                        CSearchPlan* res_plan);
 
+// bind the parameters of a plan created from a prepared expression,
+// serialized_params is a proto::plan::PlanParams of binary format
+CStatus
+BindSearchPlanParams(CSearchPlan plan,
+                     const void* serialized_params,
+                     const int64_t size);
+
+// collect a profile of the search with this plan, read back with
+// GetSearchResultProfile after the reduce
+void
+SetSearchPlanProfile(CSearchPlan plan, bool enable);
+
+// the searches with plan fail with QueryCancelled once deadline_ms, a
+// unix time in milliseconds, passed; 0 for no deadline
+void
+SetSearchPlanDeadline(CSearchPlan plan, int64_t deadline_ms);
+
+// once the deadline of plan passed, SearchSegmentsAndReduce returns the
+// results of the segments searched by then, and lists the others in
+// GetSearchResultSkippedSegments, instead of failing
+void
+SetSearchPlanPartialOnDeadline(CSearchPlan plan, bool enable);
+
+// the searches with plan running or to come fail with QueryCancelled,
+// may be called while they run
+void
+CancelSearchPlan(CSearchPlan plan);
+
+// the searches with plan queue for the cores as work of tenant, which
+// gets weight times the share of a tenant of weight 1
+void
+SetSearchPlanTenant(CSearchPlan plan, const char* tenant, int64_t weight);
+
+// the segments searched with plan and placeholder_group drop the hits
+// the ones searched before rule out of the topk, so less reaches the
+// reduce; not for plans of several vector fields
+CStatus
+ShareSearchPlanBound(CSearchPlan plan, CPlaceholderGroup placeholder_group);
+
 CStatus
 ParsePlaceholderGroup(CSearchPlan plan,
                       const void* placeholder_group_blob,
@@ -63,6 +102,18 @@ CreateRetrievePlanByExpr(CCollection c_col,
                          const int64_t size,
                          CRetrievePlan* res_plan);
 
+CStatus
+BindRetrievePlanParams(CRetrievePlan plan,
+                       const void* serialized_params,
+                       const int64_t size);
+
+// like SetSearchPlanDeadline and CancelSearchPlan, for the retrieves
+void
+SetRetrievePlanDeadline(CRetrievePlan plan, int64_t deadline_ms);
+
+void
+CancelRetrievePlan(CRetrievePlan plan);
+
 void
 DeleteRetrievePlan(CRetrievePlan plan);
 
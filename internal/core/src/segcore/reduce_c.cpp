@@ -9,25 +9,34 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <memory>
 #include <vector>
 #include "Reduce.h"
 #include "common/CGoHelper.h"
 #include "common/QueryResult.h"
+#include "common/Utils.h"
 #include "exceptions/EasyAssert.h"
 #include "query/Plan.h"
+#include "segcore/SegcoreConfig.h"
+#include "segcore/SegmentInterface.h"
 #include "segcore/reduce_c.h"
 #include "segcore/Utils.h"
+#include "storage/ThreadPool.h"
 
 using SearchResult = milvus::SearchResult;
 
+namespace {
+
 CStatus
-ReduceSearchResultsAndFillData(CSearchResultDataBlobs* cSearchResultDataBlobs,
-                               CSearchPlan c_plan,
-                               CSearchResult* c_search_results,
-                               int64_t num_segments,
-                               int64_t* slice_nqs,
-                               int64_t* slice_topKs,
-                               int64_t num_slices) {
+ReduceAndMarshal(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                 CSearchPlan c_plan,
+                 CSearchResult* c_search_results,
+                 int64_t num_segments,
+                 int64_t* slice_nqs,
+                 int64_t* slice_topKs,
+                 int64_t num_slices,
+                 milvus::segcore::ResultFormat format,
+                 std::vector<int64_t> skipped_segments = {}) {
     try {
         // get SearchResult and SearchPlan
         auto plan = static_cast<milvus::query::Plan*>(c_plan);
@@ -39,15 +48,147 @@ ReduceSearchResultsAndFillData(CSearchResultDataBlobs* cSearchResultDataBlobs,
 
         auto reduce_helper = milvus::segcore::ReduceHelper(
             search_results, plan, slice_nqs, slice_topKs, num_slices);
-        reduce_helper.Reduce();
-        reduce_helper.Marshal();
+        auto stream_rows = milvus::segcore::SegcoreConfig::default_config()
+                               .get_reduce_stream_rows();
+        if (stream_rows > 0 && reduce_helper.input_rows() >= stream_rows) {
+            reduce_helper.StreamReduce(format);
+        } else {
+            reduce_helper.Reduce();
+            reduce_helper.Marshal(format);
+        }
 
         // set final result ptr
-        *cSearchResultDataBlobs = reduce_helper.GetSearchResultDataBlobs();
+        auto blobs = static_cast<milvus::segcore::SearchResultDataBlobs*>(
+            reduce_helper.GetSearchResultDataBlobs());
+        blobs->skipped_segments = std::move(skipped_segments);
+        *cSearchResultDataBlobs = blobs;
         return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()), e.what());
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+}  // namespace
+
+CStatus
+ReduceSearchResultsAndFillData(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                               CSearchPlan c_plan,
+                               CSearchResult* c_search_results,
+                               int64_t num_segments,
+                               int64_t* slice_nqs,
+                               int64_t* slice_topKs,
+                               int64_t num_slices) {
+    return ReduceAndMarshal(cSearchResultDataBlobs,
+                            c_plan,
+                            c_search_results,
+                            num_segments,
+                            slice_nqs,
+                            slice_topKs,
+                            num_slices,
+                            milvus::segcore::ResultFormat::Proto);
+}
+
+CStatus
+ReduceSearchResultsAndFillFlatData(
+    CSearchResultDataBlobs* cSearchResultDataBlobs,
+    CSearchPlan c_plan,
+    CSearchResult* c_search_results,
+    int64_t num_segments,
+    int64_t* slice_nqs,
+    int64_t* slice_topKs,
+    int64_t num_slices) {
+    return ReduceAndMarshal(cSearchResultDataBlobs,
+                            c_plan,
+                            c_search_results,
+                            num_segments,
+                            slice_nqs,
+                            slice_topKs,
+                            num_slices,
+                            milvus::segcore::ResultFormat::Flat);
+}
+
+CStatus
+SearchSegmentsAndReduce(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                        CSegmentInterface* c_segments,
+                        int64_t num_segments,
+                        CSearchPlan c_plan,
+                        CPlaceholderGroup c_placeholder_group,
+                        uint64_t timestamp,
+                        int64_t* slice_nqs,
+                        int64_t* slice_topKs,
+                        int64_t num_slices) {
+    std::vector<std::unique_ptr<SearchResult>> results(num_segments);
+    auto plan = static_cast<milvus::query::Plan*>(c_plan);
+    try {
+        AssertInfo(num_segments > 0, "num_segments must be greater than 0");
+        auto placeholder_group =
+            static_cast<const milvus::query::PlaceholderGroup*>(
+                c_placeholder_group);
+        auto positively_related = milvus::PositivelyRelated(
+            plan->plan_node_->search_info_.metric_type_);
+        auto parallelism = milvus::segcore::SegcoreConfig::default_config()
+                               .get_segment_search_parallelism();
+        milvus::ParallelFor(num_segments, parallelism - 1, [&](int64_t i) {
+            auto segment =
+                static_cast<milvus::segcore::SegmentInterface*>(c_segments[i]);
+            std::unique_ptr<SearchResult> result;
+            try {
+                result = segment->Search(plan, placeholder_group, timestamp);
+            } catch (milvus::SegcoreError& e) {
+                // left out of a partial search past its deadline
+                if (plan->partial_on_deadline_ &&
+                    e.get_error_code() ==
+                        static_cast<ErrorCodeEnum>(QueryCancelled) &&
+                    !plan->cancel_token_.CancelRequested()) {
+                    return;
+                }
+                throw;
+            }
+            // reduce takes greater as better, like Search hands them out
+            if (!positively_related) {
+                for (auto& dis : result->distances_) {
+                    dis *= -1;
+                }
+            }
+            results[i] = std::move(result);
+        });
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()), e.what());
     } catch (std::exception& e) {
         return milvus::FailureCStatus(UnexpectedError, e.what());
     }
+
+    std::vector<CSearchResult> c_search_results;
+    std::vector<int64_t> skipped_segments;
+    for (int64_t i = 0; i < num_segments; ++i) {
+        if (results[i] != nullptr) {
+            c_search_results.push_back(results[i].get());
+        } else {
+            auto segment =
+                static_cast<milvus::segcore::SegmentInterface*>(c_segments[i]);
+            skipped_segments.push_back(segment->get_segment_id());
+        }
+    }
+    if (c_search_results.empty()) {
+        return milvus::FailureCStatus(
+            QueryCancelled, "no segment searched before the deadline");
+    }
+    if (!skipped_segments.empty()) {
+        // the results in hand are reduced past the deadline, a cancel
+        // still stops them
+        plan->cancel_token_.SetDeadline(0);
+    }
+    return ReduceAndMarshal(cSearchResultDataBlobs,
+                            c_plan,
+                            c_search_results.data(),
+                            c_search_results.size(),
+                            slice_nqs,
+                            slice_topKs,
+                            num_slices,
+                            milvus::segcore::ResultFormat::Proto,
+                            std::move(skipped_segments));
 }
 
 CStatus
@@ -72,6 +213,45 @@ GetSearchResultDataBlob(CProto* searchResultDataBlob,
     }
 }
 
+CStatus
+GetSearchResultProfile(CProto* profile,
+                       CSearchResultDataBlobs cSearchResultDataBlobs) {
+    try {
+        auto search_result_data_blobs =
+            reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(
+                cSearchResultDataBlobs);
+        AssertInfo(search_result_data_blobs != nullptr,
+                   "search result data blobs is null");
+        profile->proto_blob = search_result_data_blobs->profile.data();
+        profile->proto_size = search_result_data_blobs->profile.size();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        profile->proto_blob = nullptr;
+        profile->proto_size = 0;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+GetSearchResultSkippedSegments(const int64_t** segment_ids,
+                               int64_t* num_segments,
+                               CSearchResultDataBlobs cSearchResultDataBlobs) {
+    try {
+        auto search_result_data_blobs =
+            reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(
+                cSearchResultDataBlobs);
+        AssertInfo(search_result_data_blobs != nullptr,
+                   "search result data blobs is null");
+        *segment_ids = search_result_data_blobs->skipped_segments.data();
+        *num_segments = search_result_data_blobs->skipped_segments.size();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        *segment_ids = nullptr;
+        *num_segments = 0;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 void
 DeleteSearchResultDataBlobs(CSearchResultDataBlobs cSearchResultDataBlobs) {
     if (cSearchResultDataBlobs == nullptr) {
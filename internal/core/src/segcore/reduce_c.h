@@ -28,11 +28,53 @@ ReduceSearchResultsAndFillData(CSearchResultDataBlobs* cSearchResultDataBlobs,
                                int64_t* slice_topKs,
                                int64_t num_slices);
 
+// as ReduceSearchResultsAndFillData, but the blobs hold the flat layout
+// of segcore/FlatSearchResult.h instead of serialized SearchResultData
+CStatus
+ReduceSearchResultsAndFillFlatData(
+    CSearchResultDataBlobs* cSearchResultDataBlobs,
+    CSearchPlan c_plan,
+    CSearchResult* search_results,
+    int64_t num_segments,
+    int64_t* slice_nqs,
+    int64_t* slice_topKs,
+    int64_t num_slices);
+
+// searches num_segments segments with one plan and placeholder group on
+// the query pool, then reduces their results as
+// ReduceSearchResultsAndFillData does; the results of the segments are
+// freed before returning. with SetSearchPlanPartialOnDeadline, the
+// segments not searched by the deadline are left out and listed by
+// GetSearchResultSkippedSegments; it fails if none was searched
+CStatus
+SearchSegmentsAndReduce(CSearchResultDataBlobs* cSearchResultDataBlobs,
+                        CSegmentInterface* c_segments,
+                        int64_t num_segments,
+                        CSearchPlan c_plan,
+                        CPlaceholderGroup c_placeholder_group,
+                        uint64_t timestamp,
+                        int64_t* slice_nqs,
+                        int64_t* slice_topKs,
+                        int64_t num_slices);
+
 CStatus
 GetSearchResultDataBlob(CProto* searchResultDataBlob,
                         CSearchResultDataBlobs cSearchResultDataBlobs,
                         int32_t blob_index);
 
+// the profile of a search whose plan asked for one, as json, empty
+// otherwise; owned by the blobs
+CStatus
+GetSearchResultProfile(CProto* profile,
+                       CSearchResultDataBlobs cSearchResultDataBlobs);
+
+// the ids of the segments a partial search left out, owned by the blobs;
+// none when the results are complete
+CStatus
+GetSearchResultSkippedSegments(const int64_t** segment_ids,
+                               int64_t* num_segments,
+                               CSearchResultDataBlobs cSearchResultDataBlobs);
+
 void
 DeleteSearchResultDataBlobs(CSearchResultDataBlobs cSearchResultDataBlobs);
 
@@ -9,10 +9,16 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include "common/CGoHelper.h"
+#include "common/MemoryBudget.h"
+#include "common/ScratchArena.h"
 #include "config/ConfigKnowhere.h"
+#include "log/AsyncLogSink.h"
 #include "log/Log.h"
+#include "query/QueryScheduler.h"
 #include "segcore/SegcoreConfig.h"
 #include "segcore/segcore_init_c.h"
+#include "simd/hook.h"
 
 namespace milvus::segcore {
 extern "C" void
@@ -28,6 +34,204 @@ SegcoreSetChunkRows(const int64_t value) {
     config.set_chunk_rows(value);
 }
 
+extern "C" void
+SegcoreSetVectorChunkBytes(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_vector_chunk_bytes(value);
+}
+
+extern "C" void
+SegcoreSetExprParallelRows(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_expr_parallel_rows(value);
+}
+
+extern "C" void
+SegcoreSetFilterCacheBytes(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_filter_cache_bytes(value);
+}
+
+extern "C" void
+SegcoreSetSearchCacheBytes(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_search_cache_bytes(value);
+}
+
+extern "C" void
+SegcoreSetPlanCacheSize(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_plan_cache_size(value);
+}
+
+extern "C" void
+SegcoreSetChunkPoolBytes(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_chunk_pool_bytes(value);
+}
+
+extern "C" void
+SegcoreSetHugePageChunks(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_huge_page_chunks(value);
+}
+
+extern "C" void
+SegcoreSetColumnCacheBytes(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_column_cache_bytes(value);
+}
+
+extern "C" void
+SegcoreSetSealedColumnEncoding(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_sealed_column_encoding(value);
+}
+
+extern "C" void
+SegcoreSetSealedChunkRows(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_sealed_chunk_rows(value);
+}
+
+extern "C" void
+SegcoreSetFusedFilters(const bool value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_fused_filters(value);
+}
+
+extern "C" void
+SegcoreSetSealedVectorStorage(const char* value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_sealed_vector_storage(value);
+}
+
+extern "C" void
+SegcoreSetLoadMemoryBudget(const int64_t value) {
+    milvus::LoadBudget().SetCapacity(value);
+}
+
+extern "C" void
+SegcoreSetLoadFallbackMmapDir(const char* value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_load_fallback_mmap_dir(value);
+}
+
+extern "C" void
+SegcoreSetSharedColumnDir(const char* dir, const int64_t bytes) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_shared_column_dir(dir, bytes);
+}
+
+extern "C" void
+SegcoreSetLazyFieldCacheBytes(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_lazy_field_cache_bytes(value);
+}
+
+extern "C" void
+SegcoreSetScratchMemoryBudget(const int64_t value) {
+    milvus::ScratchBudget().SetCapacity(value);
+}
+
+extern "C" void
+SegcoreSetScratchArenaBytes(const int64_t value) {
+    milvus::SetScratchArenaBytes(value);
+}
+
+extern "C" void
+SegcoreSetIndexFetchBudget(const int64_t value) {
+    milvus::IndexFetchBudget().SetCapacity(value);
+}
+
+extern "C" void
+SegcoreSetScratchWaitMs(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_scratch_wait_ms(value);
+}
+
+extern "C" void
+SegcoreSetSmallIndexBuildThreads(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_small_index_build_threads(value);
+}
+
+extern "C" void
+SegcoreSetSearchBatchWindowUs(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_search_batch_window_us(value);
+}
+
+extern "C" void
+SegcoreSetGrowingIndexType(const char* value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_growing_index_type(value);
+}
+
+extern "C" void
+SegcoreSetGrowingIndexBuildLag(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    auto graph_index_conf = config.get_graph_index_config();
+    graph_index_conf.build_lag = value;
+    config.set_graph_index_config(graph_index_conf);
+}
+
+extern "C" void
+SegcoreSetPrefilterSelectivity(const double value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_prefilter_selectivity(value);
+}
+
+extern "C" void
+SegcoreSetFilteredSearchBudgetMs(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_filtered_search_budget_ms(value);
+}
+
+extern "C" void
+SegcoreSetQuerySchedulerSlots(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_query_scheduler_slots(value);
+    milvus::query::QueryScheduler::GetInstance().Reconfigured();
+}
+
+extern "C" void
+SegcoreSetQuerySliceNq(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_query_slice_nq(value);
+}
+
+extern "C" void
+SegcoreSetGrowingSQ8RefineRatio(const int64_t value) {
+    milvus::segcore::SegcoreConfig& config =
+        milvus::segcore::SegcoreConfig::default_config();
+    config.set_growing_sq8_refine_ratio(value);
+}
+
 extern "C" void
 SegcoreSetNlist(const int64_t value) {
     milvus::segcore::SegcoreConfig& config =
@@ -47,15 +251,55 @@ SegcoreSetThreadPoolNum(const uint32_t num_threads) {
     milvus::config::KnowhereInitThreadPool(num_threads);
 }
 
+extern "C" void
+SegcoreSetAsyncLogCapacity(const int64_t value) {
+    if (value > 0) {
+        milvus::AsyncLogSink::Enable(value);
+    } else {
+        milvus::AsyncLogSink::Disable();
+    }
+}
+
 // return value must be freed by the caller
 extern "C" char*
 SegcoreSetSimdType(const char* value) {
     LOG_SEGCORE_DEBUG_ << "set config simd_type: " << value;
     auto real_type = milvus::config::KnowhereSetSimdType(value);
+    // predicate kernels follow the instruction set knowhere settled on
+    milvus::simd::SetSimdType(real_type);
     char* ret = reinterpret_cast<char*>(malloc(real_type.length() + 1));
     memcpy(ret, real_type.c_str(), real_type.length());
     ret[real_type.length()] = 0;
     return ret;
 }
 
+// sets the runtime settings in a json object, e.g. {"nprobe": 32}, all of
+// them or none when one is unknown or invalid
+extern "C" CStatus
+SegcoreUpdateConfig(const char* settings) {
+    try {
+        milvus::segcore::SegcoreConfig& config =
+            milvus::segcore::SegcoreConfig::default_config();
+        config.update(nlohmann::json::parse(settings));
+        milvus::query::QueryScheduler::GetInstance().Reconfigured();
+        return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()), e.what());
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+// return value must be freed by the caller
+extern "C" char*
+SegcoreGetRuntimeConfig() {
+    auto settings =
+        milvus::segcore::SegcoreConfig::default_config().runtime_settings();
+    auto dump = settings.dump();
+    char* ret = reinterpret_cast<char*>(malloc(dump.length() + 1));
+    memcpy(ret, dump.c_str(), dump.length());
+    ret[dump.length()] = 0;
+    return ret;
+}
+
 }  // namespace milvus::segcore
@@ -11,6 +11,10 @@
 
 #pragma once
 
+#include <stdbool.h>
+
+#include "common/type_c.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -21,6 +25,102 @@ SegcoreInit(const char*);
 void
 SegcoreSetChunkRows(const int64_t);
 
+void
+SegcoreSetVectorChunkBytes(const int64_t);
+
+void
+SegcoreSetExprParallelRows(const int64_t);
+
+void
+SegcoreSetFilterCacheBytes(const int64_t);
+
+void
+SegcoreSetSearchCacheBytes(const int64_t);
+
+void
+SegcoreSetPlanCacheSize(const int64_t);
+
+void
+SegcoreSetChunkPoolBytes(const int64_t);
+
+void
+SegcoreSetHugePageChunks(const bool);
+
+void
+SegcoreSetColumnCacheBytes(const int64_t);
+
+void
+SegcoreSetSealedColumnEncoding(const bool);
+
+// rows per row group of the sealed fields, 0 for one chunk
+void
+SegcoreSetSealedChunkRows(const int64_t);
+
+void
+SegcoreSetFusedFilters(const bool);
+
+// "FLOAT", "FLOAT16", "BFLOAT16" or "COMPRESSED"
+void
+SegcoreSetSealedVectorStorage(const char*);
+
+// bytes of fields and indexes loaded into memory, 0 for no limit
+void
+SegcoreSetLoadMemoryBudget(const int64_t);
+
+void
+SegcoreSetLoadFallbackMmapDir(const char*);
+
+void
+SegcoreSetSharedColumnDir(const char*, const int64_t);
+
+// bytes of decoded row groups each field loaded lazily caches
+void
+SegcoreSetLazyFieldCacheBytes(const int64_t);
+
+// bytes of scratch of the requests in flight, 0 for no limit
+void
+SegcoreSetScratchMemoryBudget(const int64_t);
+
+// bytes of the buffer each thread keeps for the scratch of requests, 0 to
+// take all of it from the heap
+void
+SegcoreSetScratchArenaBytes(const int64_t);
+
+// bytes of index files downloaded by AppendIndexFromFiles and not yet
+// deserialized, 0 for no limit
+void
+SegcoreSetIndexFetchBudget(const int64_t);
+
+void
+SegcoreSetScratchWaitMs(const int64_t);
+
+void
+SegcoreSetSmallIndexBuildThreads(const int64_t);
+
+void
+SegcoreSetSearchBatchWindowUs(const int64_t);
+
+void
+SegcoreSetGrowingIndexType(const char*);
+
+void
+SegcoreSetGrowingIndexBuildLag(const int64_t);
+
+void
+SegcoreSetPrefilterSelectivity(const double);
+
+void
+SegcoreSetFilteredSearchBudgetMs(const int64_t);
+
+void
+SegcoreSetQuerySchedulerSlots(const int64_t);
+
+void
+SegcoreSetQuerySliceNq(const int64_t);
+
+void
+SegcoreSetGrowingSQ8RefineRatio(const int64_t);
+
 void
 SegcoreSetNlist(const int64_t);
 
@@ -34,6 +134,19 @@ SegcoreSetSimdType(const char*);
 void
 SegcoreSetThreadPoolNum(const uint32_t num_threads);
 
+// writes the log lines from a background thread, queued in a ring of
+// value lines that drops them when full; 0 writes them in place again
+void
+SegcoreSetAsyncLogCapacity(const int64_t value);
+
+// sets the runtime settings in a json object, all of them or none
+CStatus
+SegcoreUpdateConfig(const char* settings);
+
+// the runtime settings as a json object, must be freed by the caller
+char*
+SegcoreGetRuntimeConfig();
+
 #ifdef __cplusplus
 }
 #endif
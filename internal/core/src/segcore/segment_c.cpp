@@ -11,6 +11,9 @@
 
 #include "segcore/segment_c.h"
 
+#include <cstdlib>
+#include <cstring>
+
 #include "common/CGoHelper.h"
 #include "common/LoadInfo.h"
 #include "common/Types.h"
@@ -18,9 +21,29 @@
 #include "google/protobuf/text_format.h"
 #include "index/IndexInfo.h"
 #include "log/Log.h"
+#include "nlohmann/json.hpp"
 #include "segcore/Collection.h"
 #include "segcore/SegmentGrowingImpl.h"
 #include "segcore/SegmentSealedImpl.h"
+#include "storage/MinioChunkManager.h"
+#include "storage/ThreadPool.h"
+
+static milvus::storage::StorageConfig
+ToStorageConfig(const CStorageConfig& c_storage_config) {
+    milvus::storage::StorageConfig storage_config;
+    storage_config.address = std::string(c_storage_config.address);
+    storage_config.bucket_name = std::string(c_storage_config.bucket_name);
+    storage_config.access_key_id = std::string(c_storage_config.access_key_id);
+    storage_config.access_key_value =
+        std::string(c_storage_config.access_key_value);
+    storage_config.remote_root_path =
+        std::string(c_storage_config.remote_root_path);
+    storage_config.storage_type = std::string(c_storage_config.storage_type);
+    storage_config.iam_endpoint = std::string(c_storage_config.iam_endpoint);
+    storage_config.useSSL = c_storage_config.useSSL;
+    storage_config.useIAM = c_storage_config.useIAM;
+    return storage_config;
+}
 
 //////////////////////////////    common interfaces    //////////////////////////////
 CSegmentInterface
@@ -82,6 +105,8 @@ Search(CSegmentInterface c_segment,
         }
         *result = search_result.release();
         return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()), e.what());
     } catch (std::exception& e) {
         return milvus::FailureCStatus(UnexpectedError, e.what());
     }
@@ -98,9 +123,16 @@ Retrieve(CSegmentInterface c_segment,
          uint64_t timestamp,
          CRetrieveResult* result) {
     try {
-        auto segment = (const milvus::segcore::SegmentInterface*)c_segment;
+        auto segment =
+            dynamic_cast<const milvus::segcore::SegmentInternalInterface*>(
+                reinterpret_cast<const milvus::segcore::SegmentInterface*>(
+                    c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
         auto plan = (const milvus::query::RetrievePlan*)c_plan;
-        auto retrieve_result = segment->Retrieve(plan, timestamp);
+        // the results are freed with the arena once serialized
+        std::unique_ptr<google::protobuf::Arena> arena;
+        auto retrieve_result =
+            segment->RetrieveOnArena(plan, timestamp, &arena);
 
         auto size = retrieve_result->ByteSizeLong();
         void* buffer = malloc(size);
@@ -109,6 +141,8 @@ Retrieve(CSegmentInterface c_segment,
         result->proto_blob = buffer;
         result->proto_size = size;
         return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()), e.what());
     } catch (std::exception& e) {
         return milvus::FailureCStatus(UnexpectedError, e.what());
     }
@@ -121,6 +155,73 @@ GetMemoryUsageInBytes(CSegmentInterface c_segment) {
     return mem_size;
 }
 
+CStatus
+GetMemoryUsage(CSegmentInterface c_segment, CProto* usage) {
+    try {
+        auto segment = (milvus::segcore::SegmentInterface*)c_segment;
+        auto memory_usage = segment->GetMemoryUsage();
+        nlohmann::json json = {
+            {"total", memory_usage.Total()},
+            {"components", memory_usage.Components()},
+        };
+        auto dump = json.dump();
+        void* buffer = malloc(dump.size());
+        memcpy(buffer, dump.data(), dump.size());
+        usage->proto_blob = buffer;
+        usage->proto_size = dump.size();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        usage->proto_blob = nullptr;
+        usage->proto_size = 0;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+void
+DeleteMemoryUsage(CProto* usage) {
+    std::free(const_cast<void*>(usage->proto_blob));
+    usage->proto_blob = nullptr;
+    usage->proto_size = 0;
+}
+
+CStatus
+GetFieldAccessStats(CSegmentInterface c_segment, CProto* stats) {
+    try {
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentInternalInterface*>(
+                reinterpret_cast<milvus::segcore::SegmentInterface*>(
+                    c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto dump = segment->field_access_stats().ToJson().dump();
+        void* buffer = malloc(dump.size());
+        memcpy(buffer, dump.data(), dump.size());
+        stats->proto_blob = buffer;
+        stats->proto_size = dump.size();
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        stats->proto_blob = nullptr;
+        stats->proto_size = 0;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SpillGrowingSegment(CSegmentInterface c_segment,
+                    const char* mmap_dir_path,
+                    int64_t* spilled_bytes) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment = dynamic_cast<milvus::segcore::SegmentGrowingImpl*>(
+            segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        *spilled_bytes = segment->SpillChunks(mmap_dir_path);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 int64_t
 GetRowCount(CSegmentInterface c_segment) {
     auto segment = (milvus::segcore::SegmentInterface*)c_segment;
@@ -146,6 +247,13 @@ GetRealCount(CSegmentInterface c_segment) {
     return segment->get_real_count();
 }
 
+bool
+HasRawData(CSegmentInterface c_segment, int64_t field_id) {
+    auto segment =
+        reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+    return segment->HasRawData(field_id);
+}
+
 //////////////////////////////    interfaces for growing segment    //////////////////////////////
 CStatus
 Insert(CSegmentInterface c_segment,
@@ -169,6 +277,35 @@ Insert(CSegmentInterface c_segment,
     }
 }
 
+CStatus
+InsertColumns(CSegmentInterface c_segment,
+              int64_t reserved_offset,
+              int64_t size,
+              const int64_t* row_ids,
+              const uint64_t* timestamps,
+              const CInsertColumn* columns,
+              int64_t num_columns) {
+    try {
+        auto segment = (milvus::segcore::SegmentGrowing*)c_segment;
+        std::vector<milvus::segcore::InsertColumn> insert_columns(
+            num_columns);
+        for (int64_t i = 0; i < num_columns; ++i) {
+            insert_columns[i].field_id = milvus::FieldId(columns[i].field_id);
+            insert_columns[i].data = columns[i].data;
+            insert_columns[i].offsets = columns[i].offsets;
+        }
+        segment->InsertColumns(reserved_offset,
+                               size,
+                               row_ids,
+                               timestamps,
+                               insert_columns.data(),
+                               num_columns);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 PreInsert(CSegmentInterface c_segment, int64_t size, int64_t* offset) {
     try {
@@ -207,6 +344,43 @@ PreDelete(CSegmentInterface c_segment, int64_t size) {
     return segment->PreDelete(size);
 }
 
+CStatus
+DeleteByExpr(CSegmentInterface c_segment,
+             CRetrievePlan c_plan,
+             uint64_t timestamp,
+             CProto* deleted_pks) {
+    try {
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentInternalInterface*>(
+                reinterpret_cast<milvus::segcore::SegmentInterface*>(
+                    c_segment));
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto plan = (const milvus::query::RetrievePlan*)c_plan;
+        auto ids = segment->DeleteByExpr(plan, timestamp);
+        auto size = ids->ByteSizeLong();
+        void* buffer = malloc(size);
+        ids->SerializePartialToArray(buffer, size);
+        deleted_pks->proto_blob = buffer;
+        deleted_pks->proto_size = size;
+        return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        deleted_pks->proto_blob = nullptr;
+        deleted_pks->proto_size = 0;
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()), e.what());
+    } catch (std::exception& e) {
+        deleted_pks->proto_blob = nullptr;
+        deleted_pks->proto_size = 0;
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+void
+DeleteDeletedPks(CProto* deleted_pks) {
+    std::free(const_cast<void*>(deleted_pks->proto_blob));
+    deleted_pks->proto_blob = nullptr;
+    deleted_pks->proto_size = 0;
+}
+
 //////////////////////////////    interfaces for sealed segment    //////////////////////////////
 CStatus
 LoadFieldData(CSegmentInterface c_segment,
@@ -227,6 +401,247 @@ LoadFieldData(CSegmentInterface c_segment,
                                            load_field_data_info.mmap_dir_path};
         segment->LoadFieldData(load_info);
         return milvus::SuccessCStatus();
+    } catch (milvus::SegcoreError& e) {
+        return milvus::FailureCStatus(ErrorCode(e.get_error_code()), e.what());
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadCachedFieldData(CSegmentInterface c_segment,
+                    int64_t field_id,
+                    int64_t row_count,
+                    const char* mmap_dir_path,
+                    bool* loaded) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto load_info =
+            LoadFieldDataInfo{field_id, nullptr, row_count, mmap_dir_path};
+        *loaded = segment->LoadCachedFieldData(load_info);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+SaveSegmentImage(CSegmentInterface c_segment, const char* dir) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        segment->SaveImage(dir);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadSegmentImage(CSegmentInterface c_segment, const char* dir, bool* loaded) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        *loaded = segment->LoadImage(dir);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadFieldBinlogs(CSegmentInterface c_segment,
+                 int64_t field_id,
+                 const char** binlog_paths,
+                 int64_t num_binlogs,
+                 int64_t row_count,
+                 CStorageConfig c_storage_config) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        milvus::storage::MinioChunkManager chunk_manager(
+            ToStorageConfig(c_storage_config));
+
+        LoadFieldBinlogInfo load_info;
+        load_info.field_id = field_id;
+        load_info.binlog_paths.assign(binlog_paths,
+                                      binlog_paths + num_binlogs);
+        load_info.row_count = row_count;
+        segment->LoadFieldBinlogs(load_info, chunk_manager);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadLazyFieldBinlogs(CSegmentInterface c_segment,
+                     int64_t field_id,
+                     const char** binlog_paths,
+                     int64_t num_binlogs,
+                     int64_t row_count,
+                     CStorageConfig c_storage_config) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        // the field reads its binlogs for as long as it is loaded
+        auto chunk_manager =
+            std::make_shared<milvus::storage::MinioChunkManager>(
+                ToStorageConfig(c_storage_config));
+
+        LoadFieldBinlogInfo load_info;
+        load_info.field_id = field_id;
+        load_info.binlog_paths.assign(binlog_paths,
+                                      binlog_paths + num_binlogs);
+        load_info.row_count = row_count;
+        segment->LoadLazyFieldBinlogs(load_info, std::move(chunk_manager));
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadParquetFiles(CSegmentInterface c_segment,
+                 const char** files,
+                 int64_t num_files,
+                 int64_t row_id_begin,
+                 uint64_t timestamp,
+                 CStorageConfig c_storage_config) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        milvus::storage::MinioChunkManager chunk_manager(
+            ToStorageConfig(c_storage_config));
+
+        LoadParquetInfo load_info;
+        load_info.files.assign(files, files + num_files);
+        load_info.row_id_begin = row_id_begin;
+        load_info.timestamp = timestamp;
+        segment->LoadParquet(load_info, chunk_manager);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+CompactSegments(CSegmentInterface* c_segments,
+                int64_t num_segments,
+                uint64_t timestamp,
+                int64_t collection_id,
+                int64_t partition_id,
+                int64_t segment_id,
+                const char* binlog_dir,
+                CStorageConfig c_storage_config,
+                int64_t* row_count) {
+    try {
+        std::vector<const milvus::segcore::SegmentSealedImpl*> segments;
+        for (int64_t i = 0; i < num_segments; ++i) {
+            auto segment_interface =
+                reinterpret_cast<milvus::segcore::SegmentInterface*>(
+                    c_segments[i]);
+            auto segment =
+                dynamic_cast<milvus::segcore::SegmentSealedImpl*>(
+                    segment_interface);
+            AssertInfo(segment != nullptr, "segment conversion failed");
+            segments.push_back(segment);
+        }
+        milvus::storage::MinioChunkManager chunk_manager(
+            ToStorageConfig(c_storage_config));
+        auto result = milvus::segcore::SegmentSealedImpl::Compact(
+            segments,
+            timestamp,
+            {collection_id, partition_id, segment_id, 0},
+            binlog_dir,
+            chunk_manager);
+        *row_count = result.row_count;
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+PrefetchFieldBinlogs(CCollection c_collection,
+                     int64_t segment_id,
+                     int64_t field_id,
+                     const char** binlog_paths,
+                     int64_t num_binlogs,
+                     int64_t row_count,
+                     const char* mmap_dir_path,
+                     CStorageConfig c_storage_config) {
+    try {
+        auto collection = (milvus::segcore::Collection*)c_collection;
+        auto field_meta =
+            collection->get_schema()->operator[](milvus::FieldId(field_id));
+        AssertInfo(mmap_dir_path != nullptr, "mmap dir path is empty");
+        LoadFieldBinlogInfo info;
+        info.field_id = field_id;
+        info.binlog_paths.assign(binlog_paths, binlog_paths + num_binlogs);
+        info.row_count = row_count;
+        auto& pool =
+            milvus::ThreadPool::GetInstance(milvus::ThreadPoolType::PREFETCH);
+        pool.Submit([field_meta,
+                     segment_id,
+                     info = std::move(info),
+                     mmap_dir = std::string(mmap_dir_path),
+                     storage_config = ToStorageConfig(c_storage_config)] {
+            try {
+                milvus::storage::MinioChunkManager chunk_manager(
+                    storage_config);
+                milvus::segcore::SegmentSealedImpl::PrefetchFieldBinlogs(
+                    segment_id,
+                    field_meta,
+                    info,
+                    mmap_dir.c_str(),
+                    chunk_manager);
+            } catch (std::exception& e) {
+                LOG_SEGCORE_WARNING_ << "failed to prefetch field "
+                                     << info.field_id << " of segment "
+                                     << segment_id << ": " << e.what();
+            }
+        });
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
+CStatus
+LoadFromGrowing(CSegmentInterface c_segment, CSegmentInterface c_growing) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        auto growing_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_growing);
+        auto growing =
+            dynamic_cast<milvus::segcore::SegmentGrowing*>(growing_interface);
+        AssertInfo(growing != nullptr, "growing segment conversion failed");
+        segment->LoadFromGrowing(*growing);
+        return milvus::SuccessCStatus();
     } catch (std::exception& e) {
         return milvus::FailureCStatus(UnexpectedError, e.what());
     }
@@ -253,6 +668,21 @@ LoadDeletedRecord(CSegmentInterface c_segment,
     }
 }
 
+CStatus
+CompactDeletedRecord(CSegmentInterface c_segment, uint64_t timestamp) {
+    try {
+        auto segment_interface =
+            reinterpret_cast<milvus::segcore::SegmentInterface*>(c_segment);
+        auto segment =
+            dynamic_cast<milvus::segcore::SegmentSealed*>(segment_interface);
+        AssertInfo(segment != nullptr, "segment conversion failed");
+        segment->CompactDeletes(timestamp);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 CStatus
 UpdateSealedSegmentIndex(CSegmentInterface c_segment,
                          CLoadIndexInfo c_load_index_info) {
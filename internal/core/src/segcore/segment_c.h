@@ -27,6 +27,14 @@ typedef void* CSegmentInterface;
 typedef void* CSearchResult;
 typedef CProto CRetrieveResult;
 
+// a field of InsertColumns: fixed width values packed in their native
+// type, or varchar value i as data[offsets[i], offsets[i + 1])
+typedef struct CInsertColumn {
+    int64_t field_id;
+    const void* data;
+    const int64_t* offsets;
+} CInsertColumn;
+
 //////////////////////////////    common interfaces    //////////////////////////////
 CSegmentInterface
 NewSegment(CCollection collection, SegmentType seg_type, int64_t segment_id);
@@ -56,6 +64,28 @@ Retrieve(CSegmentInterface c_segment,
 int64_t
 GetMemoryUsageInBytes(CSegmentInterface c_segment);
 
+// the bytes held by the segment as json, the total and the bytes of each
+// component, free it with DeleteMemoryUsage
+CStatus
+GetMemoryUsage(CSegmentInterface c_segment, CProto* usage);
+
+void
+DeleteMemoryUsage(CProto* usage);
+
+// the counts of the filter evaluations, output reads and index hits of
+// each field of the segment as json, by field id; free it with
+// DeleteSegcoreMetrics
+CStatus
+GetFieldAccessStats(CSegmentInterface c_segment, CProto* stats);
+
+// moves the acknowledged chunks of a growing segment to files under
+// mmap_dir_path, when memory runs low; spilled_bytes is set to the bytes
+// moved
+CStatus
+SpillGrowingSegment(CSegmentInterface c_segment,
+                    const char* mmap_dir_path,
+                    int64_t* spilled_bytes);
+
 int64_t
 GetRowCount(CSegmentInterface c_segment);
 
@@ -65,6 +95,10 @@ GetDeletedCount(CSegmentInterface c_segment);
 int64_t
 GetRealCount(CSegmentInterface c_segment);
 
+// false if the vectors of the field must be read from the binlogs
+bool
+HasRawData(CSegmentInterface c_segment, int64_t field_id);
+
 //////////////////////////////    interfaces for growing segment    //////////////////////////////
 CStatus
 Insert(CSegmentInterface c_segment,
@@ -75,6 +109,16 @@ Insert(CSegmentInterface c_segment,
        const uint8_t* data_info,
        const uint64_t data_info_len);
 
+// the columns are read in place, one per field of the schema
+CStatus
+InsertColumns(CSegmentInterface c_segment,
+              int64_t reserved_offset,
+              int64_t size,
+              const int64_t* row_ids,
+              const uint64_t* timestamps,
+              const CInsertColumn* columns,
+              int64_t num_columns);
+
 CStatus
 PreInsert(CSegmentInterface c_segment, int64_t size, int64_t* offset);
 
@@ -83,10 +127,105 @@ CStatus
 LoadFieldData(CSegmentInterface c_segment,
               CLoadFieldDataInfo load_field_data_info);
 
+// Maps a fixed width field cached under mmap_dir_path by an earlier load
+// of the segment, or shared by a process of the host for a NULL
+// mmap_dir_path; sets loaded to false if it is not cached there
+CStatus
+LoadCachedFieldData(CSegmentInterface c_segment,
+                    int64_t field_id,
+                    int64_t row_count,
+                    const char* mmap_dir_path,
+                    bool* loaded);
+
+// Writes the loaded fields of a sealed segment under dir, for
+// LoadSegmentImage to restore after a restart
+CStatus
+SaveSegmentImage(CSegmentInterface c_segment, const char* dir);
+
+// Restores the fields of an empty sealed segment from its image under
+// dir, sets loaded to false if there is none. The fields the image lacks,
+// the indexes and the deletes are loaded as usual
+CStatus
+LoadSegmentImage(CSegmentInterface c_segment, const char* dir, bool* loaded);
+
+// Loads a fixed width field from its insert binlogs, read by segcore
+// from the remote storage instead of passed in as a DataArray
+CStatus
+LoadFieldBinlogs(CSegmentInterface c_segment,
+                 int64_t field_id,
+                 const char** binlog_paths,
+                 int64_t num_binlogs,
+                 int64_t row_count,
+                 CStorageConfig c_storage_config);
+
+// Keeps an output only field in its insert binlogs instead of loading it:
+// only the payload footers are read now, the row groups holding the rows
+// retrieved are read when asked for, see LazyField.h
+CStatus
+LoadLazyFieldBinlogs(CSegmentInterface c_segment,
+                     int64_t field_id,
+                     const char** binlog_paths,
+                     int64_t num_binlogs,
+                     int64_t row_count,
+                     CStorageConfig c_storage_config);
+
+// Loads all the fields of an empty sealed segment from the parquet files
+// of a bulk import, a column per field named after it. The rows get the
+// row ids from row_id_begin on and are inserted at timestamp; the segment
+// is queryable once it returns, CompactSegments writes its binlogs
+CStatus
+LoadParquetFiles(CSegmentInterface c_segment,
+                 const char** files,
+                 int64_t num_files,
+                 int64_t row_id_begin,
+                 uint64_t timestamp,
+                 CStorageConfig c_storage_config);
+
+// Merges the rows of the loaded sealed segments visible at timestamp,
+// their deletes applied, into segment_id of the partition: an insert
+// binlog per field named by the field id under binlog_dir, in pk order.
+// Sets row_count to the rows written, nothing is written for none
+CStatus
+CompactSegments(CSegmentInterface* c_segments,
+                int64_t num_segments,
+                uint64_t timestamp,
+                int64_t collection_id,
+                int64_t partition_id,
+                int64_t segment_id,
+                const char* binlog_dir,
+                CStorageConfig c_storage_config,
+                int64_t* row_count);
+
+// Starts writing a fixed width field of a segment predicted to be loaded
+// into the column cache under mmap_dir_path, in the background at idle io
+// priority; LoadCachedFieldData maps it then. A no-op for the fields the
+// cache can't take
+CStatus
+PrefetchFieldBinlogs(CCollection c_collection,
+                     int64_t segment_id,
+                     int64_t field_id,
+                     const char** binlog_paths,
+                     int64_t num_binlogs,
+                     int64_t row_count,
+                     const char* mmap_dir_path,
+                     CStorageConfig c_storage_config);
+
+// Loads the rows and deletes of a flushed growing segment into an empty
+// sealed segment of the same collection, in memory; the growing segment
+// may be deleted afterwards
+CStatus
+LoadFromGrowing(CSegmentInterface c_segment, CSegmentInterface c_growing);
+
 CStatus
 LoadDeletedRecord(CSegmentInterface c_segment,
                   CLoadDeletedRecordInfo deleted_record_info);
 
+// Folds the deletes of a sealed segment at or before timestamp into its
+// delete bitmap and frees their log, once no query reads at an earlier
+// timestamp, e.g. as the safe timestamp of the channel advances
+CStatus
+CompactDeletedRecord(CSegmentInterface c_segment, uint64_t timestamp);
+
 CStatus
 UpdateSealedSegmentIndex(CSegmentInterface c_segment,
                          CLoadIndexInfo c_load_index_info);
@@ -108,6 +247,19 @@ Delete(CSegmentInterface c_segment,
 
 int64_t
 PreDelete(CSegmentInterface c_segment, int64_t size);
+
+// deletes the rows matching the filter of c_plan among those inserted
+// before timestamp, with deletes at timestamp; deleted_pks is set to the
+// serialized IDs of their pks, for the replication of the deletes, free
+// it with DeleteDeletedPks
+CStatus
+DeleteByExpr(CSegmentInterface c_segment,
+             CRetrievePlan c_plan,
+             uint64_t timestamp,
+             CProto* deleted_pks);
+
+void
+DeleteDeletedPks(CProto* deleted_pks);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,647 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "simd/avx2.h"
+
+#include <immintrin.h>
+
+#include <cstring>
+
+// this file is built with -mavx2, so it must not instantiate any inline
+// template shared with the generic translation units
+namespace milvus::simd::avx2 {
+
+namespace {
+
+// AVX2 only has == and > for integers, the other comparisons are
+// derived by swapping the operands or inverting the resulting mask
+enum IntPredicate { INT_EQ, INT_GT, INT_LT };
+
+template <typename T>
+constexpr int
+PredicateOf(CompareOp op) {
+    if constexpr (std::is_floating_point_v<T>) {
+        switch (op) {
+            case CompareOp::Equal:
+                return _CMP_EQ_OQ;
+            case CompareOp::NotEqual:
+                return _CMP_NEQ_UQ;
+            case CompareOp::GreaterThan:
+                return _CMP_GT_OQ;
+            case CompareOp::GreaterEqual:
+                return _CMP_GE_OQ;
+            case CompareOp::LessThan:
+                return _CMP_LT_OQ;
+            case CompareOp::LessEqual:
+                return _CMP_LE_OQ;
+        }
+    } else {
+        switch (op) {
+            case CompareOp::Equal:
+            case CompareOp::NotEqual:
+                return INT_EQ;
+            case CompareOp::GreaterThan:
+            case CompareOp::LessEqual:
+                return INT_GT;
+            case CompareOp::LessThan:
+            case CompareOp::GreaterEqual:
+                return INT_LT;
+        }
+    }
+    return 0;
+}
+
+template <typename T>
+constexpr bool
+InvertOf(CompareOp op) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return false;
+    } else {
+        return op == CompareOp::NotEqual || op == CompareOp::LessEqual ||
+               op == CompareOp::GreaterEqual;
+    }
+}
+
+template <int pred, int width>
+inline __m256i
+IntCompare(__m256i x, __m256i v) {
+    if constexpr (pred == INT_EQ) {
+        if constexpr (width == 8) {
+            return _mm256_cmpeq_epi8(x, v);
+        } else if constexpr (width == 16) {
+            return _mm256_cmpeq_epi16(x, v);
+        } else if constexpr (width == 32) {
+            return _mm256_cmpeq_epi32(x, v);
+        } else {
+            return _mm256_cmpeq_epi64(x, v);
+        }
+    } else {
+        // x > v, or v > x for INT_LT
+        auto a = pred == INT_GT ? x : v;
+        auto b = pred == INT_GT ? v : x;
+        if constexpr (width == 8) {
+            return _mm256_cmpgt_epi8(a, b);
+        } else if constexpr (width == 16) {
+            return _mm256_cmpgt_epi16(a, b);
+        } else if constexpr (width == 32) {
+            return _mm256_cmpgt_epi32(a, b);
+        } else {
+            return _mm256_cmpgt_epi64(a, b);
+        }
+    }
+}
+
+inline __m256i
+Load(const void* src) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+// Mask32 compares 32 consecutive elements and packs the results
+template <typename T>
+struct Kernel;
+
+template <>
+struct Kernel<int8_t> {
+    using Vec = __m256i;
+    static Vec
+    Set1(int8_t val) {
+        return _mm256_set1_epi8(val);
+    }
+    template <int pred>
+    static uint32_t
+    Mask32(const int8_t* src, Vec v) {
+        return _mm256_movemask_epi8(IntCompare<pred, 8>(Load(src), v));
+    }
+};
+
+template <>
+struct Kernel<int16_t> {
+    using Vec = __m256i;
+    static Vec
+    Set1(int16_t val) {
+        return _mm256_set1_epi16(val);
+    }
+    template <int pred>
+    static uint32_t
+    Mask32(const int16_t* src, Vec v) {
+        auto lo = IntCompare<pred, 16>(Load(src), v);
+        auto hi = IntCompare<pred, 16>(Load(src + 16), v);
+        // packs works per 128-bit lane, restore the element order after it
+        auto packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(lo, hi),
+                                               _MM_SHUFFLE(3, 1, 2, 0));
+        return _mm256_movemask_epi8(packed);
+    }
+};
+
+template <>
+struct Kernel<int32_t> {
+    using Vec = __m256i;
+    static Vec
+    Set1(int32_t val) {
+        return _mm256_set1_epi32(val);
+    }
+    template <int pred>
+    static uint32_t
+    Mask32(const int32_t* src, Vec v) {
+        uint32_t mask = 0;
+        for (int k = 0; k < 4; ++k) {
+            auto cmp = IntCompare<pred, 32>(Load(src + 8 * k), v);
+            mask |= uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)))
+                    << (8 * k);
+        }
+        return mask;
+    }
+};
+
+template <>
+struct Kernel<int64_t> {
+    using Vec = __m256i;
+    static Vec
+    Set1(int64_t val) {
+        return _mm256_set1_epi64x(val);
+    }
+    template <int pred>
+    static uint32_t
+    Mask32(const int64_t* src, Vec v) {
+        uint32_t mask = 0;
+        for (int k = 0; k < 8; ++k) {
+            auto cmp = IntCompare<pred, 64>(Load(src + 4 * k), v);
+            mask |= uint32_t(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)))
+                    << (4 * k);
+        }
+        return mask;
+    }
+};
+
+template <>
+struct Kernel<float> {
+    using Vec = __m256;
+    static Vec
+    Set1(float val) {
+        return _mm256_set1_ps(val);
+    }
+    template <int pred>
+    static uint32_t
+    Mask32(const float* src, Vec v) {
+        uint32_t mask = 0;
+        for (int k = 0; k < 4; ++k) {
+            auto cmp = _mm256_cmp_ps(_mm256_loadu_ps(src + 8 * k), v, pred);
+            mask |= uint32_t(_mm256_movemask_ps(cmp)) << (8 * k);
+        }
+        return mask;
+    }
+};
+
+template <>
+struct Kernel<double> {
+    using Vec = __m256d;
+    static Vec
+    Set1(double val) {
+        return _mm256_set1_pd(val);
+    }
+    template <int pred>
+    static uint32_t
+    Mask32(const double* src, Vec v) {
+        uint32_t mask = 0;
+        for (int k = 0; k < 8; ++k) {
+            auto cmp = _mm256_cmp_pd(_mm256_loadu_pd(src + 4 * k), v, pred);
+            mask |= uint32_t(_mm256_movemask_pd(cmp)) << (4 * k);
+        }
+        return mask;
+    }
+};
+
+template <typename T, CompareOp op>
+inline BlockType
+Compare64(const T* src, typename Kernel<T>::Vec v) {
+    constexpr int pred = PredicateOf<T>(op);
+    constexpr BlockType flip = InvertOf<T>(op) ? ~BlockType(0) : 0;
+    auto lo = BlockType(Kernel<T>::template Mask32<pred>(src, v));
+    auto hi = BlockType(Kernel<T>::template Mask32<pred>(src + 32, v));
+    return (lo | (hi << 32)) ^ flip;
+}
+
+template <typename T, typename Func>
+inline void
+ForEachBlock(const T* src, int64_t size, BlockType* dst, Func func) {
+    int64_t i = 0;
+    for (; i + BITS_PER_BLOCK <= size; i += BITS_PER_BLOCK) {
+        dst[i / BITS_PER_BLOCK] = func(src + i);
+    }
+    if (i < size) {
+        // pad the tail to a whole block, the padding bits are cleared after
+        T buf[BITS_PER_BLOCK] = {};
+        memcpy(buf, src + i, (size - i) * sizeof(T));
+        auto valid = (BlockType(1) << (size - i)) - 1;
+        dst[i / BITS_PER_BLOCK] = func(buf) & valid;
+    }
+}
+
+template <typename T, CompareOp op>
+void
+CompareValImpl(const T* src, int64_t size, T val, BlockType* dst) {
+    auto v = Kernel<T>::Set1(val);
+    ForEachBlock(src, size, dst, [v](const T* data) {
+        return Compare64<T, op>(data, v);
+    });
+}
+
+template <typename T, CompareOp lower_op, CompareOp upper_op>
+void
+CompareRangeImpl(const T* src, int64_t size, T lower, T upper, BlockType* dst) {
+    auto lo = Kernel<T>::Set1(lower);
+    auto hi = Kernel<T>::Set1(upper);
+    ForEachBlock(src, size, dst, [lo, hi](const T* data) {
+        return Compare64<T, lower_op>(data, lo) &
+               Compare64<T, upper_op>(data, hi);
+    });
+}
+
+}  // namespace
+
+template <typename T>
+void
+CompareVal(const T* src, int64_t size, T val, CompareOp op, BlockType* dst) {
+    switch (op) {
+        case CompareOp::Equal:
+            return CompareValImpl<T, CompareOp::Equal>(src, size, val, dst);
+        case CompareOp::NotEqual:
+            return CompareValImpl<T, CompareOp::NotEqual>(src, size, val, dst);
+        case CompareOp::GreaterThan:
+            return CompareValImpl<T, CompareOp::GreaterThan>(
+                src, size, val, dst);
+        case CompareOp::GreaterEqual:
+            return CompareValImpl<T, CompareOp::GreaterEqual>(
+                src, size, val, dst);
+        case CompareOp::LessThan:
+            return CompareValImpl<T, CompareOp::LessThan>(src, size, val, dst);
+        case CompareOp::LessEqual:
+            return CompareValImpl<T, CompareOp::LessEqual>(src, size, val, dst);
+    }
+}
+
+template <typename T>
+void
+CompareRange(const T* src,
+             int64_t size,
+             T lower,
+             T upper,
+             bool lower_inclusive,
+             bool upper_inclusive,
+             BlockType* dst) {
+    constexpr auto GE = CompareOp::GreaterEqual;
+    constexpr auto GT = CompareOp::GreaterThan;
+    constexpr auto LE = CompareOp::LessEqual;
+    constexpr auto LT = CompareOp::LessThan;
+    if (lower_inclusive && upper_inclusive) {
+        CompareRangeImpl<T, GE, LE>(src, size, lower, upper, dst);
+    } else if (lower_inclusive && !upper_inclusive) {
+        CompareRangeImpl<T, GE, LT>(src, size, lower, upper, dst);
+    } else if (!lower_inclusive && upper_inclusive) {
+        CompareRangeImpl<T, GT, LE>(src, size, lower, upper, dst);
+    } else {
+        CompareRangeImpl<T, GT, LT>(src, size, lower, upper, dst);
+    }
+}
+
+namespace {
+
+// round half away from zero: truncate, then step away from zero when
+// the dropped fraction is at least a half, as std::round
+inline __m256
+Round8(__m256 x, __m256 multiplier) {
+    const auto sign_mask = _mm256_set1_ps(-0.0f);
+    auto t = _mm256_mul_ps(x, multiplier);
+    auto r = _mm256_round_ps(t, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto fraction = _mm256_andnot_ps(sign_mask, _mm256_sub_ps(t, r));
+    auto away = _mm256_cmp_ps(fraction, _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    auto step =
+        _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(t, sign_mask));
+    // blended, adding a zero step would turn -0 into +0
+    r = _mm256_blendv_ps(r, _mm256_add_ps(r, step), away);
+    return _mm256_div_ps(r, multiplier);
+}
+
+}  // namespace
+
+void
+Round(float* data, int64_t size, float multiplier) {
+    auto m = _mm256_set1_ps(multiplier);
+    int64_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(data + i, Round8(_mm256_loadu_ps(data + i), m));
+    }
+    if (i < size) {
+        // the tail goes through a full vector, no scalar code here
+        float buf[8] = {};
+        std::memcpy(buf, data + i, (size - i) * sizeof(float));
+        _mm256_storeu_ps(buf, Round8(_mm256_loadu_ps(buf), m));
+        std::memcpy(data + i, buf, (size - i) * sizeof(float));
+    }
+}
+
+namespace {
+
+// bits set in every byte by a nibble lookup, summed into the 64-bit lanes
+inline __m256i
+Popcount32(__m256i v) {
+    const auto lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+                                         2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                         1, 2, 2, 3, 2, 3, 3, 4);
+    const auto low = _mm256_set1_epi8(0x0f);
+    auto lo = _mm256_and_si256(v, low);
+    auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+    auto counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                  _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+// bits set in op(a, b) over size bytes, op takes both __m256i and the
+// scalar words since the gcc vector types have the bitwise operators
+template <typename Op>
+inline int64_t
+Popcount(const uint8_t* a, const uint8_t* b, int64_t size, Op op) {
+    auto acc = _mm256_setzero_si256();
+    int64_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        acc = _mm256_add_epi64(acc, Popcount32(op(x, y)));
+    }
+    int64_t count = _mm256_extract_epi64(acc, 0) +
+                    _mm256_extract_epi64(acc, 1) +
+                    _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+    for (; i + 8 <= size; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, sizeof(x));
+        std::memcpy(&y, b + i, sizeof(y));
+        count += _mm_popcnt_u64(op(x, y));
+    }
+    for (; i < size; ++i) {
+        count += _mm_popcnt_u32(op(a[i], b[i]));
+    }
+    return count;
+}
+
+}  // namespace
+
+void
+Hamming(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        dst[i] = Popcount(query,
+                          rows + i * code_size,
+                          code_size,
+                          [](auto x, auto y) { return x ^ y; });
+    }
+}
+
+void
+Jaccard(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + i * code_size;
+        auto intersection = Popcount(
+            query, row, code_size, [](auto x, auto y) { return x & y; });
+        auto union_ = Popcount(
+            query, row, code_size, [](auto x, auto y) { return x | y; });
+        dst[i] =
+            union_ == 0 ? 0 : 1 - float(intersection) / float(union_);
+    }
+}
+
+namespace {
+
+// 8 halves widened to floats
+template <HalfType type>
+inline __m256
+LoadHalves(const uint16_t* src) {
+    auto halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    if constexpr (type == HalfType::Float16) {
+        return _mm256_cvtph_ps(halves);
+    } else {
+        return _mm256_castsi256_ps(
+            _mm256_slli_epi32(_mm256_cvtepu16_epi32(halves), 16));
+    }
+}
+
+template <HalfType type, bool is_ip>
+inline __m256
+Accumulate(__m256 acc, __m256 query, __m256 row) {
+    if constexpr (is_ip) {
+        return _mm256_add_ps(acc, _mm256_mul_ps(query, row));
+    } else {
+        auto diff = _mm256_sub_ps(query, row);
+        return _mm256_add_ps(acc, _mm256_mul_ps(diff, diff));
+    }
+}
+
+template <HalfType type, bool is_ip>
+void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst) {
+    // the tail of the query padded with zeros, which zero halves match
+    int64_t body = dim / 8 * 8;
+    float query_tail[8] = {};
+    std::memcpy(query_tail, query + body, (dim - body) * sizeof(float));
+    auto tail = _mm256_loadu_ps(query_tail);
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + i * dim;
+        auto acc = _mm256_setzero_ps();
+        for (int64_t d = 0; d < body; d += 8) {
+            acc = Accumulate<type, is_ip>(
+                acc, _mm256_loadu_ps(query + d), LoadHalves<type>(row + d));
+        }
+        if (body < dim) {
+            uint16_t row_tail[8] = {};
+            std::memcpy(row_tail, row + body, (dim - body) * sizeof(uint16_t));
+            acc = Accumulate<type, is_ip>(
+                acc, tail, LoadHalves<type>(row_tail));
+        }
+        auto sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+                              _mm256_extractf128_ps(acc, 1));
+        sum = _mm_hadd_ps(sum, sum);
+        sum = _mm_hadd_ps(sum, sum);
+        dst[i] = _mm_cvtss_f32(sum);
+    }
+}
+
+}  // namespace
+
+void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              HalfType type,
+              bool is_ip,
+              float* dst) {
+    if (type == HalfType::Float16) {
+        is_ip ? HalfDistances<HalfType::Float16, true>(
+                    query, rows, dim, size, dst)
+              : HalfDistances<HalfType::Float16, false>(
+                    query, rows, dim, size, dst);
+    } else {
+        is_ip ? HalfDistances<HalfType::BFloat16, true>(
+                    query, rows, dim, size, dst)
+              : HalfDistances<HalfType::BFloat16, false>(
+                    query, rows, dim, size, dst);
+    }
+}
+
+namespace {
+
+inline float
+HorizontalSum(__m256 acc) {
+    auto sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+                          _mm256_extractf128_ps(acc, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+    return _mm_cvtss_f32(sum);
+}
+
+// the inner products of row with the N queries into out, the dimensions
+// past the last 8 in scalar
+template <int N>
+inline void
+RowProducts(const float* const* queries,
+            const float* row,
+            int64_t dim,
+            float* out) {
+    int64_t body = dim / 8 * 8;
+    __m256 acc[N];
+    for (int k = 0; k < N; ++k) {
+        acc[k] = _mm256_setzero_ps();
+    }
+    for (int64_t d = 0; d < body; d += 8) {
+        auto r = _mm256_loadu_ps(row + d);
+        for (int k = 0; k < N; ++k) {
+            acc[k] = _mm256_add_ps(
+                acc[k], _mm256_mul_ps(_mm256_loadu_ps(queries[k] + d), r));
+        }
+    }
+    for (int k = 0; k < N; ++k) {
+        auto sum = HorizontalSum(acc[k]);
+        for (int64_t d = body; d < dim; ++d) {
+            sum += queries[k][d] * row[d];
+        }
+        out[k] = sum;
+    }
+}
+
+}  // namespace
+
+void
+InnerProducts(const float* queries,
+              int64_t nq,
+              const float* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst) {
+    int64_t q = 0;
+    for (; q + 4 <= nq; q += 4) {
+        const float* tile[4] = {queries + q * dim,
+                                queries + (q + 1) * dim,
+                                queries + (q + 2) * dim,
+                                queries + (q + 3) * dim};
+        for (int64_t i = 0; i < size; ++i) {
+            float out[4];
+            RowProducts<4>(tile, rows + i * dim, dim, out);
+            for (int k = 0; k < 4; ++k) {
+                dst[(q + k) * size + i] = out[k];
+            }
+        }
+    }
+    for (; q < nq; ++q) {
+        const float* tile[1] = {queries + q * dim};
+        for (int64_t i = 0; i < size; ++i) {
+            RowProducts<1>(tile, rows + i * dim, dim, dst + q * size + i);
+        }
+    }
+}
+
+namespace {
+
+// the distance of query and row, the dimensions past the last 8 in scalar
+template <bool is_ip>
+inline float
+FloatDistance(const float* query, const float* row, int64_t dim) {
+    int64_t body = dim / 8 * 8;
+    auto acc = _mm256_setzero_ps();
+    for (int64_t d = 0; d < body; d += 8) {
+        auto x = _mm256_loadu_ps(query + d);
+        auto r = _mm256_loadu_ps(row + d);
+        if constexpr (is_ip) {
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(x, r));
+        } else {
+            auto diff = _mm256_sub_ps(x, r);
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(diff, diff));
+        }
+    }
+    auto sum = HorizontalSum(acc);
+    for (int64_t d = body; d < dim; ++d) {
+        if constexpr (is_ip) {
+            sum += query[d] * row[d];
+        } else {
+            auto diff = query[d] - row[d];
+            sum += diff * diff;
+        }
+    }
+    return sum;
+}
+
+}  // namespace
+
+void
+GatherDistances(const float* query,
+                const float* rows,
+                int64_t dim,
+                const int64_t* offsets,
+                int64_t size,
+                bool is_ip,
+                float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + offsets[i] * dim;
+        dst[i] = is_ip ? FloatDistance<true>(query, row, dim)
+                       : FloatDistance<false>(query, row, dim);
+    }
+}
+
+#define INSTANTIATE_COMPARE(T)                                             \
+    template void CompareVal<T>(                                           \
+        const T* src, int64_t size, T val, CompareOp op, BlockType* dst); \
+    template void CompareRange<T>(const T* src,                            \
+                                  int64_t size,                            \
+                                  T lower,                                 \
+                                  T upper,                                 \
+                                  bool lower_inclusive,                    \
+                                  bool upper_inclusive,                    \
+                                  BlockType* dst);
+
+INSTANTIATE_COMPARE(int8_t)
+INSTANTIATE_COMPARE(int16_t)
+INSTANTIATE_COMPARE(int32_t)
+INSTANTIATE_COMPARE(int64_t)
+INSTANTIATE_COMPARE(float)
+INSTANTIATE_COMPARE(double)
+
+#undef INSTANTIATE_COMPARE
+
+}  // namespace milvus::simd::avx2
@@ -0,0 +1,589 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "simd/avx512.h"
+
+#include <immintrin.h>
+
+#include <cstring>
+
+// this file is built with -mavx512f -mavx512bw, so it must not instantiate
+// any inline template shared with the generic translation units
+namespace milvus::simd::avx512 {
+
+namespace {
+
+template <typename T>
+constexpr int
+PredicateOf(CompareOp op) {
+    if constexpr (std::is_floating_point_v<T>) {
+        switch (op) {
+            case CompareOp::Equal:
+                return _CMP_EQ_OQ;
+            case CompareOp::NotEqual:
+                return _CMP_NEQ_UQ;
+            case CompareOp::GreaterThan:
+                return _CMP_GT_OQ;
+            case CompareOp::GreaterEqual:
+                return _CMP_GE_OQ;
+            case CompareOp::LessThan:
+                return _CMP_LT_OQ;
+            case CompareOp::LessEqual:
+                return _CMP_LE_OQ;
+        }
+    } else {
+        switch (op) {
+            case CompareOp::Equal:
+                return _MM_CMPINT_EQ;
+            case CompareOp::NotEqual:
+                return _MM_CMPINT_NE;
+            case CompareOp::GreaterThan:
+                return _MM_CMPINT_NLE;
+            case CompareOp::GreaterEqual:
+                return _MM_CMPINT_NLT;
+            case CompareOp::LessThan:
+                return _MM_CMPINT_LT;
+            case CompareOp::LessEqual:
+                return _MM_CMPINT_LE;
+        }
+    }
+    return 0;
+}
+
+inline __m512i
+Load(const void* src) {
+    return _mm512_loadu_si512(src);
+}
+
+// Mask compares LANES consecutive elements into the low bits of the result
+template <typename T>
+struct Kernel;
+
+template <>
+struct Kernel<int8_t> {
+    using Vec = __m512i;
+    static constexpr int LANES = 64;
+    static Vec
+    Set1(int8_t val) {
+        return _mm512_set1_epi8(val);
+    }
+    template <int pred>
+    static BlockType
+    Mask(const int8_t* src, Vec v) {
+        return _mm512_cmp_epi8_mask(Load(src), v, pred);
+    }
+};
+
+template <>
+struct Kernel<int16_t> {
+    using Vec = __m512i;
+    static constexpr int LANES = 32;
+    static Vec
+    Set1(int16_t val) {
+        return _mm512_set1_epi16(val);
+    }
+    template <int pred>
+    static BlockType
+    Mask(const int16_t* src, Vec v) {
+        return _mm512_cmp_epi16_mask(Load(src), v, pred);
+    }
+};
+
+template <>
+struct Kernel<int32_t> {
+    using Vec = __m512i;
+    static constexpr int LANES = 16;
+    static Vec
+    Set1(int32_t val) {
+        return _mm512_set1_epi32(val);
+    }
+    template <int pred>
+    static BlockType
+    Mask(const int32_t* src, Vec v) {
+        return _mm512_cmp_epi32_mask(Load(src), v, pred);
+    }
+};
+
+template <>
+struct Kernel<int64_t> {
+    using Vec = __m512i;
+    static constexpr int LANES = 8;
+    static Vec
+    Set1(int64_t val) {
+        return _mm512_set1_epi64(val);
+    }
+    template <int pred>
+    static BlockType
+    Mask(const int64_t* src, Vec v) {
+        return _mm512_cmp_epi64_mask(Load(src), v, pred);
+    }
+};
+
+template <>
+struct Kernel<float> {
+    using Vec = __m512;
+    static constexpr int LANES = 16;
+    static Vec
+    Set1(float val) {
+        return _mm512_set1_ps(val);
+    }
+    template <int pred>
+    static BlockType
+    Mask(const float* src, Vec v) {
+        return _mm512_cmp_ps_mask(_mm512_loadu_ps(src), v, pred);
+    }
+};
+
+template <>
+struct Kernel<double> {
+    using Vec = __m512d;
+    static constexpr int LANES = 8;
+    static Vec
+    Set1(double val) {
+        return _mm512_set1_pd(val);
+    }
+    template <int pred>
+    static BlockType
+    Mask(const double* src, Vec v) {
+        return _mm512_cmp_pd_mask(_mm512_loadu_pd(src), v, pred);
+    }
+};
+
+template <typename T, CompareOp op>
+inline BlockType
+Compare64(const T* src, typename Kernel<T>::Vec v) {
+    constexpr int pred = PredicateOf<T>(op);
+    constexpr int lanes = Kernel<T>::LANES;
+    BlockType mask = 0;
+    for (int k = 0; k < BITS_PER_BLOCK / lanes; ++k) {
+        mask |= Kernel<T>::template Mask<pred>(src + lanes * k, v)
+                << (lanes * k);
+    }
+    return mask;
+}
+
+template <typename T, typename Func>
+inline void
+ForEachBlock(const T* src, int64_t size, BlockType* dst, Func func) {
+    int64_t i = 0;
+    for (; i + BITS_PER_BLOCK <= size; i += BITS_PER_BLOCK) {
+        dst[i / BITS_PER_BLOCK] = func(src + i);
+    }
+    if (i < size) {
+        // pad the tail to a whole block, the padding bits are cleared after
+        T buf[BITS_PER_BLOCK] = {};
+        memcpy(buf, src + i, (size - i) * sizeof(T));
+        auto valid = (BlockType(1) << (size - i)) - 1;
+        dst[i / BITS_PER_BLOCK] = func(buf) & valid;
+    }
+}
+
+template <typename T, CompareOp op>
+void
+CompareValImpl(const T* src, int64_t size, T val, BlockType* dst) {
+    auto v = Kernel<T>::Set1(val);
+    ForEachBlock(src, size, dst, [v](const T* data) {
+        return Compare64<T, op>(data, v);
+    });
+}
+
+template <typename T, CompareOp lower_op, CompareOp upper_op>
+void
+CompareRangeImpl(const T* src, int64_t size, T lower, T upper, BlockType* dst) {
+    auto lo = Kernel<T>::Set1(lower);
+    auto hi = Kernel<T>::Set1(upper);
+    ForEachBlock(src, size, dst, [lo, hi](const T* data) {
+        return Compare64<T, lower_op>(data, lo) &
+               Compare64<T, upper_op>(data, hi);
+    });
+}
+
+}  // namespace
+
+template <typename T>
+void
+CompareVal(const T* src, int64_t size, T val, CompareOp op, BlockType* dst) {
+    switch (op) {
+        case CompareOp::Equal:
+            return CompareValImpl<T, CompareOp::Equal>(src, size, val, dst);
+        case CompareOp::NotEqual:
+            return CompareValImpl<T, CompareOp::NotEqual>(src, size, val, dst);
+        case CompareOp::GreaterThan:
+            return CompareValImpl<T, CompareOp::GreaterThan>(
+                src, size, val, dst);
+        case CompareOp::GreaterEqual:
+            return CompareValImpl<T, CompareOp::GreaterEqual>(
+                src, size, val, dst);
+        case CompareOp::LessThan:
+            return CompareValImpl<T, CompareOp::LessThan>(src, size, val, dst);
+        case CompareOp::LessEqual:
+            return CompareValImpl<T, CompareOp::LessEqual>(src, size, val, dst);
+    }
+}
+
+template <typename T>
+void
+CompareRange(const T* src,
+             int64_t size,
+             T lower,
+             T upper,
+             bool lower_inclusive,
+             bool upper_inclusive,
+             BlockType* dst) {
+    constexpr auto GE = CompareOp::GreaterEqual;
+    constexpr auto GT = CompareOp::GreaterThan;
+    constexpr auto LE = CompareOp::LessEqual;
+    constexpr auto LT = CompareOp::LessThan;
+    if (lower_inclusive && upper_inclusive) {
+        CompareRangeImpl<T, GE, LE>(src, size, lower, upper, dst);
+    } else if (lower_inclusive && !upper_inclusive) {
+        CompareRangeImpl<T, GE, LT>(src, size, lower, upper, dst);
+    } else if (!lower_inclusive && upper_inclusive) {
+        CompareRangeImpl<T, GT, LE>(src, size, lower, upper, dst);
+    } else {
+        CompareRangeImpl<T, GT, LT>(src, size, lower, upper, dst);
+    }
+}
+
+namespace {
+
+// round half away from zero: truncate, then step away from zero when
+// the dropped fraction is at least a half, as std::round
+inline __m512
+Round16(__m512 x, __m512 multiplier) {
+    auto t = _mm512_mul_ps(x, multiplier);
+    auto r = _mm512_roundscale_ps(t, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto fraction = _mm512_abs_ps(_mm512_sub_ps(t, r));
+    auto away =
+        _mm512_cmp_ps_mask(fraction, _mm512_set1_ps(0.5f), _CMP_GE_OQ);
+    auto negative =
+        _mm512_cmp_ps_mask(t, _mm512_setzero_ps(), _CMP_LT_OQ);
+    auto step = _mm512_mask_blend_ps(
+        negative, _mm512_set1_ps(1.0f), _mm512_set1_ps(-1.0f));
+    r = _mm512_mask_add_ps(r, away, r, step);
+    return _mm512_div_ps(r, multiplier);
+}
+
+}  // namespace
+
+void
+Round(float* data, int64_t size, float multiplier) {
+    auto m = _mm512_set1_ps(multiplier);
+    int64_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        _mm512_storeu_ps(data + i, Round16(_mm512_loadu_ps(data + i), m));
+    }
+    if (i < size) {
+        __mmask16 tail = (1u << (size - i)) - 1;
+        auto x = _mm512_maskz_loadu_ps(tail, data + i);
+        _mm512_mask_storeu_ps(data + i, tail, Round16(x, m));
+    }
+}
+
+namespace {
+
+// bits set in op(a, b) over size bytes, the tail through a masked load.
+// vpopcntq comes after avx512f, so only this kernel is built for it and
+// hook.cpp installs it where the cpu has it
+template <typename Op>
+__attribute__((target("avx512vpopcntdq"))) inline int64_t
+Popcount(const uint8_t* a, const uint8_t* b, int64_t size, Op op) {
+    auto acc = _mm512_setzero_si512();
+    int64_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        auto x = op(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+    }
+    if (i < size) {
+        __mmask64 tail = ~uint64_t(0) >> (64 - (size - i));
+        auto x = op(_mm512_maskz_loadu_epi8(tail, a + i),
+                    _mm512_maskz_loadu_epi8(tail, b + i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+    }
+    return _mm512_reduce_add_epi64(acc);
+}
+
+template <typename Op>
+__attribute__((target("avx512vpopcntdq"))) void
+PopcountRows(const uint8_t* query,
+             const uint8_t* rows,
+             int64_t code_size,
+             int64_t size,
+             int64_t* dst,
+             Op op) {
+    for (int64_t i = 0; i < size; ++i) {
+        dst[i] = Popcount(query, rows + i * code_size, code_size, op);
+    }
+}
+
+}  // namespace
+
+void
+Hamming(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    int64_t counts[64];
+    for (int64_t begin = 0; begin < size; begin += 64) {
+        auto n = size - begin < 64 ? size - begin : 64;
+        PopcountRows(query,
+                     rows + begin * code_size,
+                     code_size,
+                     n,
+                     counts,
+                     [](auto x, auto y) { return x ^ y; });
+        for (int64_t i = 0; i < n; ++i) {
+            dst[begin + i] = counts[i];
+        }
+    }
+}
+
+void
+Jaccard(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    int64_t intersections[64];
+    int64_t unions[64];
+    for (int64_t begin = 0; begin < size; begin += 64) {
+        auto n = size - begin < 64 ? size - begin : 64;
+        auto block = rows + begin * code_size;
+        PopcountRows(query,
+                     block,
+                     code_size,
+                     n,
+                     intersections,
+                     [](auto x, auto y) { return x & y; });
+        PopcountRows(query,
+                     block,
+                     code_size,
+                     n,
+                     unions,
+                     [](auto x, auto y) { return x | y; });
+        for (int64_t i = 0; i < n; ++i) {
+            dst[begin + i] =
+                unions[i] == 0
+                    ? 0
+                    : 1 - float(intersections[i]) / float(unions[i]);
+        }
+    }
+}
+
+namespace {
+
+// 16 halves widened to floats
+template <HalfType type>
+inline __m512
+LoadHalves(const uint16_t* src) {
+    auto halves = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    if constexpr (type == HalfType::Float16) {
+        return _mm512_cvtph_ps(halves);
+    } else {
+        return _mm512_castsi512_ps(
+            _mm512_slli_epi32(_mm512_cvtepu16_epi32(halves), 16));
+    }
+}
+
+template <HalfType type, bool is_ip>
+inline __m512
+Accumulate(__m512 acc, __m512 query, __m512 row) {
+    if constexpr (is_ip) {
+        return _mm512_fmadd_ps(query, row, acc);
+    } else {
+        auto diff = _mm512_sub_ps(query, row);
+        return _mm512_fmadd_ps(diff, diff, acc);
+    }
+}
+
+template <HalfType type, bool is_ip>
+void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst) {
+    // the tail of the query padded with zeros, which zero halves match
+    int64_t body = dim / 16 * 16;
+    __mmask16 tail_mask = (1u << (dim - body)) - 1;
+    auto tail = _mm512_maskz_loadu_ps(tail_mask, query + body);
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + i * dim;
+        auto acc = _mm512_setzero_ps();
+        for (int64_t d = 0; d < body; d += 16) {
+            acc = Accumulate<type, is_ip>(
+                acc, _mm512_loadu_ps(query + d), LoadHalves<type>(row + d));
+        }
+        if (body < dim) {
+            uint16_t row_tail[16] = {};
+            std::memcpy(row_tail, row + body, (dim - body) * sizeof(uint16_t));
+            acc = Accumulate<type, is_ip>(
+                acc, tail, LoadHalves<type>(row_tail));
+        }
+        dst[i] = _mm512_reduce_add_ps(acc);
+    }
+}
+
+}  // namespace
+
+void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              HalfType type,
+              bool is_ip,
+              float* dst) {
+    if (type == HalfType::Float16) {
+        is_ip ? HalfDistances<HalfType::Float16, true>(
+                    query, rows, dim, size, dst)
+              : HalfDistances<HalfType::Float16, false>(
+                    query, rows, dim, size, dst);
+    } else {
+        is_ip ? HalfDistances<HalfType::BFloat16, true>(
+                    query, rows, dim, size, dst)
+              : HalfDistances<HalfType::BFloat16, false>(
+                    query, rows, dim, size, dst);
+    }
+}
+
+namespace {
+
+// the inner products of row with the N queries into out, the last
+// dimensions through masked loads
+template <int N>
+inline void
+RowProducts(const float* const* queries,
+            const float* row,
+            int64_t dim,
+            float* out) {
+    int64_t body = dim / 16 * 16;
+    __m512 acc[N];
+    for (int k = 0; k < N; ++k) {
+        acc[k] = _mm512_setzero_ps();
+    }
+    for (int64_t d = 0; d < body; d += 16) {
+        auto r = _mm512_loadu_ps(row + d);
+        for (int k = 0; k < N; ++k) {
+            acc[k] = _mm512_add_ps(
+                acc[k], _mm512_mul_ps(_mm512_loadu_ps(queries[k] + d), r));
+        }
+    }
+    if (body < dim) {
+        __mmask16 tail = (1u << (dim - body)) - 1;
+        auto r = _mm512_maskz_loadu_ps(tail, row + body);
+        for (int k = 0; k < N; ++k) {
+            auto x = _mm512_maskz_loadu_ps(tail, queries[k] + body);
+            acc[k] = _mm512_add_ps(acc[k], _mm512_mul_ps(x, r));
+        }
+    }
+    for (int k = 0; k < N; ++k) {
+        out[k] = _mm512_reduce_add_ps(acc[k]);
+    }
+}
+
+}  // namespace
+
+void
+InnerProducts(const float* queries,
+              int64_t nq,
+              const float* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst) {
+    int64_t q = 0;
+    for (; q + 4 <= nq; q += 4) {
+        const float* tile[4] = {queries + q * dim,
+                                queries + (q + 1) * dim,
+                                queries + (q + 2) * dim,
+                                queries + (q + 3) * dim};
+        for (int64_t i = 0; i < size; ++i) {
+            float out[4];
+            RowProducts<4>(tile, rows + i * dim, dim, out);
+            for (int k = 0; k < 4; ++k) {
+                dst[(q + k) * size + i] = out[k];
+            }
+        }
+    }
+    for (; q < nq; ++q) {
+        const float* tile[1] = {queries + q * dim};
+        for (int64_t i = 0; i < size; ++i) {
+            RowProducts<1>(tile, rows + i * dim, dim, dst + q * size + i);
+        }
+    }
+}
+
+namespace {
+
+// the distance of query and row, the last dimensions through masked loads
+template <bool is_ip>
+inline float
+FloatDistance(const float* query, const float* row, int64_t dim) {
+    int64_t body = dim / 16 * 16;
+    auto acc = _mm512_setzero_ps();
+    auto accumulate = [&](__m512 x, __m512 r) {
+        if constexpr (is_ip) {
+            acc = _mm512_fmadd_ps(x, r, acc);
+        } else {
+            auto diff = _mm512_sub_ps(x, r);
+            acc = _mm512_fmadd_ps(diff, diff, acc);
+        }
+    };
+    for (int64_t d = 0; d < body; d += 16) {
+        accumulate(_mm512_loadu_ps(query + d), _mm512_loadu_ps(row + d));
+    }
+    if (body < dim) {
+        __mmask16 tail = (1u << (dim - body)) - 1;
+        accumulate(_mm512_maskz_loadu_ps(tail, query + body),
+                   _mm512_maskz_loadu_ps(tail, row + body));
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+}  // namespace
+
+void
+GatherDistances(const float* query,
+                const float* rows,
+                int64_t dim,
+                const int64_t* offsets,
+                int64_t size,
+                bool is_ip,
+                float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + offsets[i] * dim;
+        dst[i] = is_ip ? FloatDistance<true>(query, row, dim)
+                       : FloatDistance<false>(query, row, dim);
+    }
+}
+
+#define INSTANTIATE_COMPARE(T)                                             \
+    template void CompareVal<T>(                                           \
+        const T* src, int64_t size, T val, CompareOp op, BlockType* dst); \
+    template void CompareRange<T>(const T* src,                            \
+                                  int64_t size,                            \
+                                  T lower,                                 \
+                                  T upper,                                 \
+                                  bool lower_inclusive,                    \
+                                  bool upper_inclusive,                    \
+                                  BlockType* dst);
+
+INSTANTIATE_COMPARE(int8_t)
+INSTANTIATE_COMPARE(int16_t)
+INSTANTIATE_COMPARE(int32_t)
+INSTANTIATE_COMPARE(int64_t)
+INSTANTIATE_COMPARE(float)
+INSTANTIATE_COMPARE(double)
+
+#undef INSTANTIATE_COMPARE
+
+}  // namespace milvus::simd::avx512
@@ -0,0 +1,75 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include "simd/common.h"
+
+namespace milvus::simd::avx512 {
+
+template <typename T>
+void
+CompareVal(const T* src, int64_t size, T val, CompareOp op, BlockType* dst);
+
+template <typename T>
+void
+CompareRange(const T* src,
+             int64_t size,
+             T lower,
+             T upper,
+             bool lower_inclusive,
+             bool upper_inclusive,
+             BlockType* dst);
+
+void
+Round(float* data, int64_t size, float multiplier);
+
+void
+Hamming(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst);
+
+void
+Jaccard(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst);
+
+void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              HalfType type,
+              bool is_ip,
+              float* dst);
+
+void
+InnerProducts(const float* queries,
+              int64_t nq,
+              const float* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst);
+
+void
+GatherDistances(const float* query,
+                const float* rows,
+                int64_t dim,
+                const int64_t* offsets,
+                int64_t size,
+                bool is_ip,
+                float* dst);
+
+}  // namespace milvus::simd::avx512
@@ -0,0 +1,101 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace milvus::simd {
+
+// same layout as the blocks of BitsetType, bit i of block j is row 64 * j + i
+using BlockType = uint64_t;
+constexpr int64_t BITS_PER_BLOCK = 64;
+
+enum class CompareOp {
+    Equal,
+    NotEqual,
+    GreaterThan,
+    GreaterEqual,
+    LessThan,
+    LessEqual,
+};
+
+template <typename T>
+constexpr bool IsVectorizable =
+    std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// kernel signatures shared by every instruction set,
+// `dst` receives upper_div(size, 64) blocks and the bits past `size` are zero
+template <typename T>
+using CompareValFunc = void (*)(
+    const T* src, int64_t size, T val, CompareOp op, BlockType* dst);
+
+template <typename T>
+using CompareRangeFunc = void (*)(const T* src,
+                                  int64_t size,
+                                  T lower,
+                                  T upper,
+                                  bool lower_inclusive,
+                                  bool upper_inclusive,
+                                  BlockType* dst);
+
+// data[i] = round(data[i] * multiplier) / multiplier, rounding halves
+// away from zero as std::round
+using RoundFunc = void (*)(float* data, int64_t size, float multiplier);
+
+// 16-bit floats vectors may be stored as: ieee half precision, or the
+// upper half of a float
+enum class HalfType {
+    Float16,
+    BFloat16,
+};
+
+// dst[i] = squared L2 distance between query and row i of rows, the inner
+// product if is_ip, size rows of dim halves back to back
+using HalfDistanceFunc = void (*)(const float* query,
+                                  const uint16_t* rows,
+                                  int64_t dim,
+                                  int64_t size,
+                                  HalfType type,
+                                  bool is_ip,
+                                  float* dst);
+
+// dst[q * size + i] = inner product of query q and row i, nq queries and
+// size rows of dim floats back to back
+using InnerProductFunc = void (*)(const float* queries,
+                                  int64_t nq,
+                                  const float* rows,
+                                  int64_t dim,
+                                  int64_t size,
+                                  float* dst);
+
+// dst[i] = squared L2 distance between query and row offsets[i] of rows,
+// the inner product if is_ip, rows of dim floats back to back
+using GatherDistanceFunc = void (*)(const float* query,
+                                    const float* rows,
+                                    int64_t dim,
+                                    const int64_t* offsets,
+                                    int64_t size,
+                                    bool is_ip,
+                                    float* dst);
+
+// dst[i] = distance between query and row i of rows, size rows of
+// code_size bytes packed back to back
+using BinaryDistanceFunc = void (*)(const uint8_t* query,
+                                    const uint8_t* rows,
+                                    int64_t code_size,
+                                    int64_t size,
+                                    float* dst);
+
+}  // namespace milvus::simd
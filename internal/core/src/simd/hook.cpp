@@ -0,0 +1,282 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "simd/hook.h"
+
+#include <cmath>
+
+#include "log/Log.h"
+#include "simd/ref.h"
+#if defined(__x86_64__)
+#include "simd/avx2.h"
+#include "simd/avx512.h"
+#endif
+
+namespace milvus::simd {
+
+namespace {
+
+template <typename T>
+struct Kernels {
+    static inline CompareValFunc<T> compare_val = ref::CompareVal<T>;
+    static inline CompareRangeFunc<T> compare_range = ref::CompareRange<T>;
+};
+
+template <typename T>
+void
+Install(CompareValFunc<T> compare_val, CompareRangeFunc<T> compare_range) {
+    Kernels<T>::compare_val = compare_val;
+    Kernels<T>::compare_range = compare_range;
+}
+
+RoundFunc round_kernel = ref::Round;
+BinaryDistanceFunc hamming_kernel = ref::Hamming;
+BinaryDistanceFunc jaccard_kernel = ref::Jaccard;
+HalfDistanceFunc half_distance_kernel = ref::HalfDistances;
+InnerProductFunc inner_product_kernel = ref::InnerProducts;
+GatherDistanceFunc gather_distance_kernel = ref::GatherDistances;
+
+#define INSTALL_KERNELS(ISA)                                        \
+    do {                                                            \
+        round_kernel = ISA::Round;                                  \
+        hamming_kernel = ISA::Hamming;                              \
+        jaccard_kernel = ISA::Jaccard;                              \
+        half_distance_kernel = ISA::HalfDistances;                  \
+        inner_product_kernel = ISA::InnerProducts;                  \
+        gather_distance_kernel = ISA::GatherDistances;              \
+        Install<int8_t>(ISA::CompareVal, ISA::CompareRange);        \
+        Install<int16_t>(ISA::CompareVal, ISA::CompareRange);       \
+        Install<int32_t>(ISA::CompareVal, ISA::CompareRange);       \
+        Install<int64_t>(ISA::CompareVal, ISA::CompareRange);       \
+        Install<float>(ISA::CompareVal, ISA::CompareRange);         \
+        Install<double>(ISA::CompareVal, ISA::CompareRange);        \
+    } while (false)
+
+std::string simd_type = "REF";
+
+bool
+CpuSupports(const std::string& type) {
+#if defined(__x86_64__)
+    if (type == "AVX512") {
+        return __builtin_cpu_supports("avx512f") &&
+               __builtin_cpu_supports("avx512bw");
+    }
+    if (type == "AVX2") {
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+    return false;
+}
+
+std::string
+Select(const std::string& type) {
+#if defined(__x86_64__)
+    if (type == "AVX512" && CpuSupports(type)) {
+        INSTALL_KERNELS(avx512);
+        // the popcount kernels need vpopcntq, which came later than
+        // avx512bw, the avx2 ones take over without it
+        if (!__builtin_cpu_supports("avx512vpopcntdq")) {
+            hamming_kernel = avx2::Hamming;
+            jaccard_kernel = avx2::Jaccard;
+        }
+        return type;
+    }
+    if (type == "AVX2" && CpuSupports(type)) {
+        INSTALL_KERNELS(avx2);
+        return type;
+    }
+#endif
+    INSTALL_KERNELS(ref);
+    return "REF";
+}
+
+// pick the best kernels up front, so callers which never configure
+// the simd type still get them
+const bool auto_detected = [] {
+    for (auto type : {"AVX512", "AVX2"}) {
+        if (CpuSupports(type)) {
+            simd_type = Select(type);
+            return true;
+        }
+    }
+    return false;
+}();
+
+}  // namespace
+
+std::string
+SetSimdType(const std::string& type) {
+    simd_type = Select(type);
+    LOG_SEGCORE_INFO_ << "predicate simd type: " << simd_type;
+    return simd_type;
+}
+
+std::string
+GetSimdType() {
+    return simd_type;
+}
+
+template <typename T>
+void
+CompareVal(const T* src, int64_t size, T val, CompareOp op, BlockType* dst) {
+    Kernels<T>::compare_val(src, size, val, op, dst);
+}
+
+template <typename T>
+void
+CompareRange(const T* src,
+             int64_t size,
+             T lower,
+             T upper,
+             bool lower_inclusive,
+             bool upper_inclusive,
+             BlockType* dst) {
+    Kernels<T>::compare_range(
+        src, size, lower, upper, lower_inclusive, upper_inclusive, dst);
+}
+
+// memory bound, the portable kernels use sse2 where it is there already
+template <typename Offset>
+void
+PrefixMatch(const char* data,
+            const Offset* offsets,
+            int64_t size,
+            std::string_view prefix,
+            BlockType* dst) {
+    ref::PrefixMatch(data, offsets, size, prefix, dst);
+}
+
+template <typename Offset>
+void
+CompareStrings(const char* data,
+               const Offset* offsets,
+               int64_t size,
+               std::string_view val,
+               CompareOp op,
+               BlockType* dst) {
+    ref::CompareStrings(data, offsets, size, val, op, dst);
+}
+
+void
+RoundDecimal(float* data, int64_t size, int64_t round_decimal) {
+    if (round_decimal == -1) {
+        return;
+    }
+    const float multiplier = std::pow(10.0, round_decimal);
+    round_kernel(data, size, multiplier);
+}
+
+void
+Hamming(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    hamming_kernel(query, rows, code_size, size, dst);
+}
+
+void
+Jaccard(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    jaccard_kernel(query, rows, code_size, size, dst);
+}
+
+// conversions run at load and retrieve time only, the portable ones do
+void
+ToHalf(const float* src, int64_t size, HalfType type, uint16_t* dst) {
+    ref::ToHalf(src, size, type, dst);
+}
+
+void
+FromHalf(const uint16_t* src, int64_t size, HalfType type, float* dst) {
+    ref::FromHalf(src, size, type, dst);
+}
+
+void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              HalfType type,
+              bool is_ip,
+              float* dst) {
+    half_distance_kernel(query, rows, dim, size, type, is_ip, dst);
+}
+
+void
+InnerProducts(const float* queries,
+              int64_t nq,
+              const float* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst) {
+    inner_product_kernel(queries, nq, rows, dim, size, dst);
+}
+
+void
+GatherDistances(const float* query,
+                const float* rows,
+                int64_t dim,
+                const int64_t* offsets,
+                int64_t size,
+                bool is_ip,
+                float* dst) {
+    gather_distance_kernel(query, rows, dim, offsets, size, is_ip, dst);
+}
+
+// norms are computed when rows are written, once per row
+void
+SquaredNorms(const float* rows, int64_t dim, int64_t size, float* dst) {
+    ref::SquaredNorms(rows, dim, size, dst);
+}
+
+#define INSTANTIATE_COMPARE(T)                                             \
+    template void CompareVal<T>(                                           \
+        const T* src, int64_t size, T val, CompareOp op, BlockType* dst); \
+    template void CompareRange<T>(const T* src,                            \
+                                  int64_t size,                            \
+                                  T lower,                                 \
+                                  T upper,                                 \
+                                  bool lower_inclusive,                    \
+                                  bool upper_inclusive,                    \
+                                  BlockType* dst);
+
+INSTANTIATE_COMPARE(int8_t)
+INSTANTIATE_COMPARE(int16_t)
+INSTANTIATE_COMPARE(int32_t)
+INSTANTIATE_COMPARE(int64_t)
+INSTANTIATE_COMPARE(float)
+INSTANTIATE_COMPARE(double)
+
+#undef INSTANTIATE_COMPARE
+
+#define INSTANTIATE_STRINGS(Offset)                                  \
+    template void PrefixMatch<Offset>(const char* data,              \
+                                      const Offset* offsets,         \
+                                      int64_t size,                  \
+                                      std::string_view prefix,       \
+                                      BlockType* dst);               \
+    template void CompareStrings<Offset>(const char* data,           \
+                                         const Offset* offsets,      \
+                                         int64_t size,               \
+                                         std::string_view val,       \
+                                         CompareOp op,               \
+                                         BlockType* dst);
+
+INSTANTIATE_STRINGS(uint32_t)
+INSTANTIATE_STRINGS(uint64_t)
+
+#undef INSTANTIATE_STRINGS
+
+}  // namespace milvus::simd
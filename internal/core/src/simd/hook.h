@@ -0,0 +1,133 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "simd/common.h"
+
+namespace milvus::simd {
+
+// select the kernels by the simd type knowhere settled on,
+// "AVX512", "AVX2" and anything else falls back to the portable kernels,
+// returns the one actually in use
+std::string
+SetSimdType(const std::string& simd_type);
+
+std::string
+GetSimdType();
+
+// dst[i] = src[i] op val, packed into 64-bit blocks
+template <typename T>
+void
+CompareVal(const T* src, int64_t size, T val, CompareOp op, BlockType* dst);
+
+// dst[i] = lower < src[i] < upper, inclusiveness per bound
+template <typename T>
+void
+CompareRange(const T* src,
+             int64_t size,
+             T lower,
+             T upper,
+             bool lower_inclusive,
+             bool upper_inclusive,
+             BlockType* dst);
+
+// dst[i] = row i starts with prefix, row i being
+// [offsets[i], offsets[i + 1]) of data
+template <typename Offset>
+void
+PrefixMatch(const char* data,
+            const Offset* offsets,
+            int64_t size,
+            std::string_view prefix,
+            BlockType* dst);
+
+// dst[i] = row i op val, rows laid out like PrefixMatch
+template <typename Offset>
+void
+CompareStrings(const char* data,
+               const Offset* offsets,
+               int64_t size,
+               std::string_view val,
+               CompareOp op,
+               BlockType* dst);
+
+// rounds data to round_decimal decimals in place, -1 keeps it as is
+void
+RoundDecimal(float* data, int64_t size, int64_t round_decimal);
+
+// dst[i] = number of bits query and row i differ in, size rows of
+// code_size bytes packed back to back
+void
+Hamming(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst);
+
+// dst[i] = 1 - |query & row i| / |query | row i|, rows laid out like
+// Hamming, 0 when both are all zeros
+void
+Jaccard(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst);
+
+// dst[i] = src[i] rounded to the nearest half, ties to even
+void
+ToHalf(const float* src, int64_t size, HalfType type, uint16_t* dst);
+
+void
+FromHalf(const uint16_t* src, int64_t size, HalfType type, float* dst);
+
+// dst[i] = squared L2 distance between the float query and row i, the
+// inner product if is_ip, size rows of dim halves back to back
+void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              HalfType type,
+              bool is_ip,
+              float* dst);
+
+// dst[q * size + i] = inner product of query q and row i, nq queries and
+// size rows of dim floats back to back. every row loaded is multiplied
+// with several queries, a batch costs far less than nq single ones
+void
+InnerProducts(const float* queries,
+              int64_t nq,
+              const float* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst);
+
+// dst[i] = squared L2 distance between query and row offsets[i] of rows,
+// the inner product if is_ip, rows of dim floats back to back. for a few
+// scattered rows, such as the candidates an index found
+void
+GatherDistances(const float* query,
+                const float* rows,
+                int64_t dim,
+                const int64_t* offsets,
+                int64_t size,
+                bool is_ip,
+                float* dst);
+
+// dst[i] = squared L2 norm of row i, size rows of dim floats
+void
+SquaredNorms(const float* rows, int64_t dim, int64_t size, float* dst);
+
+}  // namespace milvus::simd
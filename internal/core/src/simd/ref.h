@@ -0,0 +1,475 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "simd/common.h"
+
+// portable kernels, used when no instruction set is available
+// and for the tail of a chunk that does not fill a whole block
+namespace milvus::simd::ref {
+
+template <typename Pred>
+inline void
+PackRows(int64_t size, BlockType* dst, Pred pred) {
+    for (int64_t begin = 0; begin < size; begin += BITS_PER_BLOCK) {
+        auto end = std::min(begin + BITS_PER_BLOCK, size);
+        BlockType word = 0;
+        for (auto i = begin; i < end; ++i) {
+            word |= BlockType(pred(i)) << (i - begin);
+        }
+        dst[begin / BITS_PER_BLOCK] = word;
+    }
+}
+
+template <typename T, typename Pred>
+inline void
+PackBits(const T* src, int64_t size, BlockType* dst, Pred pred) {
+    PackRows(size, dst, [src, &pred](int64_t i) { return pred(src[i]); });
+}
+
+template <typename T>
+void
+CompareVal(const T* src, int64_t size, T val, CompareOp op, BlockType* dst) {
+    switch (op) {
+        case CompareOp::Equal:
+            return PackBits(src, size, dst, [val](T x) { return x == val; });
+        case CompareOp::NotEqual:
+            return PackBits(src, size, dst, [val](T x) { return x != val; });
+        case CompareOp::GreaterThan:
+            return PackBits(src, size, dst, [val](T x) { return x > val; });
+        case CompareOp::GreaterEqual:
+            return PackBits(src, size, dst, [val](T x) { return x >= val; });
+        case CompareOp::LessThan:
+            return PackBits(src, size, dst, [val](T x) { return x < val; });
+        case CompareOp::LessEqual:
+            return PackBits(src, size, dst, [val](T x) { return x <= val; });
+    }
+}
+
+template <typename T>
+void
+CompareRange(const T* src,
+             int64_t size,
+             T lower,
+             T upper,
+             bool lower_inclusive,
+             bool upper_inclusive,
+             BlockType* dst) {
+    if (lower_inclusive && upper_inclusive) {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower <= x && x <= upper;
+        });
+    } else if (lower_inclusive && !upper_inclusive) {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower <= x && x < upper;
+        });
+    } else if (!lower_inclusive && upper_inclusive) {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower < x && x <= upper;
+        });
+    } else {
+        PackBits(src, size, dst, [lower, upper](T x) {
+            return lower < x && x < upper;
+        });
+    }
+}
+
+// the first 8 bytes of str as a big endian integer, zero padded: strings
+// with different keys order like their keys. `readable` bytes may be read
+// from str, a whole word is loaded and masked when they are enough
+inline uint64_t
+StringKey(const char* str, uint64_t length, uint64_t readable) {
+    uint64_t key = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (readable >= sizeof(key)) {
+        std::memcpy(&key, str, sizeof(key));
+        if (length < sizeof(key)) {
+            key &= (uint64_t(1) << (length * 8)) - 1;
+        }
+        return __builtin_bswap64(key);
+    }
+    std::memcpy(&key, str, std::min<uint64_t>(length, sizeof(key)));
+    return __builtin_bswap64(key);
+#else
+    std::memcpy(&key, str, std::min<uint64_t>(length, sizeof(key)));
+    return key;
+#endif
+}
+
+// row i of the strings is [offsets[i], offsets[i + 1]) of data, so
+// offsets[size] bounds every read
+template <typename Offset>
+void
+PrefixMatch(const char* data,
+            const Offset* offsets,
+            int64_t size,
+            std::string_view prefix,
+            BlockType* dst) {
+    auto end = offsets[size];
+#if defined(__SSE2__)
+    // a prefix of up to 16 bytes is checked with one compare of the
+    // row's first 16 bytes, after its length rules the row in
+    if (prefix.size() <= 16) {
+        char padded[16] = {};
+        std::memcpy(padded, prefix.data(), prefix.size());
+        auto pattern = _mm_loadu_si128(reinterpret_cast<__m128i*>(padded));
+        auto mask = (1u << prefix.size()) - 1;
+        PackRows(size, dst, [&](int64_t i) {
+            auto begin = offsets[i];
+            if (offsets[i + 1] - begin < prefix.size()) {
+                return false;
+            }
+            auto row = data + begin;
+            if (end - begin < 16) {
+                return std::memcmp(row, prefix.data(), prefix.size()) == 0;
+            }
+            auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+            auto equal = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, pattern));
+            return (unsigned(equal) & mask) == mask;
+        });
+        return;
+    }
+#endif
+    PackRows(size, dst, [&](int64_t i) {
+        auto begin = offsets[i];
+        return offsets[i + 1] - begin >= prefix.size() &&
+               std::memcmp(data + begin, prefix.data(), prefix.size()) == 0;
+    });
+}
+
+// dst[i] = row i op val, rows laid out like PrefixMatch. equality checks
+// the length first, the other comparisons the 8 byte keys and only look
+// at the rest of the rows whose key ties with val's
+template <typename Offset>
+void
+CompareStrings(const char* data,
+               const Offset* offsets,
+               int64_t size,
+               std::string_view val,
+               CompareOp op,
+               BlockType* dst) {
+    auto end = offsets[size];
+    auto val_key = StringKey(val.data(), val.size(), val.size());
+    auto equal = [&](int64_t i) {
+        auto begin = offsets[i];
+        auto length = offsets[i + 1] - begin;
+        if (length != val.size()) {
+            return false;
+        }
+        if (StringKey(data + begin, length, end - begin) != val_key) {
+            return false;
+        }
+        return length <= 8 || std::memcmp(data + begin + 8,
+                                          val.data() + 8,
+                                          length - 8) == 0;
+    };
+    auto compare = [&](int64_t i) {
+        auto begin = offsets[i];
+        auto length = offsets[i + 1] - begin;
+        auto key = StringKey(data + begin, length, end - begin);
+        if (key != val_key) {
+            return key < val_key ? -1 : 1;
+        }
+        return std::string_view(data + begin, length).compare(val);
+    };
+    switch (op) {
+        case CompareOp::Equal:
+            return PackRows(size, dst, equal);
+        case CompareOp::NotEqual:
+            return PackRows(size, dst, [&](int64_t i) { return !equal(i); });
+        case CompareOp::GreaterThan:
+            return PackRows(
+                size, dst, [&](int64_t i) { return compare(i) > 0; });
+        case CompareOp::GreaterEqual:
+            return PackRows(
+                size, dst, [&](int64_t i) { return compare(i) >= 0; });
+        case CompareOp::LessThan:
+            return PackRows(
+                size, dst, [&](int64_t i) { return compare(i) < 0; });
+        case CompareOp::LessEqual:
+            return PackRows(
+                size, dst, [&](int64_t i) { return compare(i) <= 0; });
+    }
+}
+
+inline void
+Round(float* data, int64_t size, float multiplier) {
+    for (int64_t i = 0; i < size; ++i) {
+        data[i] = std::round(data[i] * multiplier) / multiplier;
+    }
+}
+
+// bits set in op(a, b) over size bytes, a word at a time
+template <typename Op>
+inline int64_t
+Popcount(const uint8_t* a, const uint8_t* b, int64_t size, Op op) {
+    int64_t count = 0;
+    int64_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, sizeof(x));
+        std::memcpy(&y, b + i, sizeof(y));
+        count += __builtin_popcountll(op(x, y));
+    }
+    for (; i < size; ++i) {
+        count += __builtin_popcount(op(a[i], b[i]));
+    }
+    return count;
+}
+
+inline void
+Hamming(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        dst[i] = Popcount(query,
+                          rows + i * code_size,
+                          code_size,
+                          [](auto x, auto y) { return x ^ y; });
+    }
+}
+
+inline void
+Jaccard(const uint8_t* query,
+        const uint8_t* rows,
+        int64_t code_size,
+        int64_t size,
+        float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + i * code_size;
+        auto intersection = Popcount(
+            query, row, code_size, [](auto x, auto y) { return x & y; });
+        auto union_ = Popcount(
+            query, row, code_size, [](auto x, auto y) { return x | y; });
+        dst[i] =
+            union_ == 0 ? 0 : 1 - float(intersection) / float(union_);
+    }
+}
+
+// round to nearest even: the subnormals by a float add that aligns their
+// bits, the normals by a bias on the bits that get dropped
+inline uint16_t
+FloatToFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = (bits >> 16) & 0x8000;
+    bits &= 0x7fffffff;
+    if (bits >= (127 + 16) << 23) {
+        // inf, nan or too large
+        return sign | (bits > 0x7f800000 ? 0x7e00 : 0x7c00);
+    }
+    if (bits < (127 - 14) << 23) {
+        const uint32_t magic_bits = 126 << 23;
+        float magic;
+        std::memcpy(&magic, &magic_bits, sizeof(magic));
+        float aligned;
+        std::memcpy(&aligned, &bits, sizeof(aligned));
+        aligned += magic;
+        std::memcpy(&bits, &aligned, sizeof(bits));
+        return sign | (bits - magic_bits);
+    }
+    auto odd = (bits >> 13) & 1;
+    bits += (uint32_t(15 - 127) << 23) + 0xfff + odd;
+    return sign | (bits >> 13);
+}
+
+inline float
+Float16ToFloat(uint16_t half) {
+    uint32_t sign = uint32_t(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+    if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    } else {
+        // zero or subnormal, mantissa * 2^-24 is exact in a float
+        float value = std::ldexp(float(mantissa), -24);
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits |= sign;
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline uint16_t
+FloatToBFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+        // keep nan a nan, the rounding could carry it into inf
+        return (bits >> 16) | 0x40;
+    }
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return bits >> 16;
+}
+
+inline float
+BFloat16ToFloat(uint16_t half) {
+    uint32_t bits = uint32_t(half) << 16;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline void
+ToHalf(const float* src, int64_t size, HalfType type, uint16_t* dst) {
+    if (type == HalfType::Float16) {
+        std::transform(src, src + size, dst, FloatToFloat16);
+    } else {
+        std::transform(src, src + size, dst, FloatToBFloat16);
+    }
+}
+
+inline void
+FromHalf(const uint16_t* src, int64_t size, HalfType type, float* dst) {
+    if (type == HalfType::Float16) {
+        std::transform(src, src + size, dst, Float16ToFloat);
+    } else {
+        std::transform(src, src + size, dst, BFloat16ToFloat);
+    }
+}
+
+template <typename Convert>
+inline void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              bool is_ip,
+              float* dst,
+              Convert convert) {
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + i * dim;
+        float acc = 0;
+        if (is_ip) {
+            for (int64_t d = 0; d < dim; ++d) {
+                acc += query[d] * convert(row[d]);
+            }
+        } else {
+            for (int64_t d = 0; d < dim; ++d) {
+                auto diff = query[d] - convert(row[d]);
+                acc += diff * diff;
+            }
+        }
+        dst[i] = acc;
+    }
+}
+
+inline void
+HalfDistances(const float* query,
+              const uint16_t* rows,
+              int64_t dim,
+              int64_t size,
+              HalfType type,
+              bool is_ip,
+              float* dst) {
+    if (type == HalfType::Float16) {
+        HalfDistances(query, rows, dim, size, is_ip, dst, Float16ToFloat);
+    } else {
+        HalfDistances(query, rows, dim, size, is_ip, dst, BFloat16ToFloat);
+    }
+}
+
+// the inner products of row with the N queries into out
+template <int N>
+inline void
+RowProducts(const float* const* queries,
+            const float* row,
+            int64_t dim,
+            float* out) {
+    float acc[N] = {};
+    for (int64_t d = 0; d < dim; ++d) {
+        for (int k = 0; k < N; ++k) {
+            acc[k] += queries[k][d] * row[d];
+        }
+    }
+    std::copy_n(acc, N, out);
+}
+
+// four queries at a time share every row read
+inline void
+InnerProducts(const float* queries,
+              int64_t nq,
+              const float* rows,
+              int64_t dim,
+              int64_t size,
+              float* dst) {
+    int64_t q = 0;
+    for (; q + 4 <= nq; q += 4) {
+        const float* tile[4] = {queries + q * dim,
+                                queries + (q + 1) * dim,
+                                queries + (q + 2) * dim,
+                                queries + (q + 3) * dim};
+        for (int64_t i = 0; i < size; ++i) {
+            float out[4];
+            RowProducts<4>(tile, rows + i * dim, dim, out);
+            for (int k = 0; k < 4; ++k) {
+                dst[(q + k) * size + i] = out[k];
+            }
+        }
+    }
+    for (; q < nq; ++q) {
+        const float* tile[1] = {queries + q * dim};
+        for (int64_t i = 0; i < size; ++i) {
+            RowProducts<1>(tile, rows + i * dim, dim, dst + q * size + i);
+        }
+    }
+}
+
+inline void
+GatherDistances(const float* query,
+                const float* rows,
+                int64_t dim,
+                const int64_t* offsets,
+                int64_t size,
+                bool is_ip,
+                float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        auto row = rows + offsets[i] * dim;
+        float acc = 0;
+        if (is_ip) {
+            for (int64_t d = 0; d < dim; ++d) {
+                acc += query[d] * row[d];
+            }
+        } else {
+            for (int64_t d = 0; d < dim; ++d) {
+                auto diff = query[d] - row[d];
+                acc += diff * diff;
+            }
+        }
+        dst[i] = acc;
+    }
+}
+
+inline void
+SquaredNorms(const float* rows, int64_t dim, int64_t size, float* dst) {
+    for (int64_t i = 0; i < size; ++i) {
+        const float* tile[1] = {rows + i * dim};
+        RowProducts<1>(tile, rows + i * dim, dim, dst + i);
+    }
+}
+
+}  // namespace milvus::simd::ref
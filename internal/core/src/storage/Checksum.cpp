@@ -0,0 +1,135 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "storage/Checksum.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace milvus::storage {
+
+namespace {
+
+// reflected polynomial of crc32c
+constexpr uint32_t CRC32C_POLY = 0x82f63b78;
+
+// slicing by 8: table k advances a byte k bytes further through the crc
+using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+CrcTables
+MakeCrcTables() {
+    CrcTables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        auto crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0 - (crc & 1)));
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t k = 1; k < tables.size(); ++k) {
+            auto prev = tables[k - 1][i];
+            tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xff];
+        }
+    }
+    return tables;
+}
+
+const CrcTables crc_tables = MakeCrcTables();
+
+uint32_t
+SoftwareCrc32c(uint32_t crc, const uint8_t* data, size_t size) {
+    auto& t = crc_tables;
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        word ^= crc;
+        crc = t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^
+              t[5][(word >> 16) & 0xff] ^ t[4][(word >> 24) & 0xff] ^
+              t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^
+              t[1][(word >> 48) & 0xff] ^ t[0][word >> 56];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xff];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t
+HardwareCrc32c(uint32_t crc, const uint8_t* data, size_t size) {
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        size -= 8;
+    }
+    crc = uint32_t(crc64);
+    while (size-- > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+
+const bool has_hardware_crc = __builtin_cpu_supports("sse4.2");
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+uint32_t
+HardwareCrc32c(uint32_t crc, const uint8_t* data, size_t size) {
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+}
+
+const bool has_hardware_crc = true;
+#else
+uint32_t
+HardwareCrc32c(uint32_t crc, const uint8_t* data, size_t size) {
+    return SoftwareCrc32c(crc, data, size);
+}
+
+const bool has_hardware_crc = false;
+#endif
+
+}  // namespace
+
+uint32_t
+Crc32c(const void* data, size_t size, uint32_t crc) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    crc = has_hardware_crc ? HardwareCrc32c(crc, bytes, size)
+                           : SoftwareCrc32c(crc, bytes, size);
+    return ~crc;
+}
+
+}  // namespace milvus::storage
@@ -0,0 +1,30 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace milvus::storage {
+
+// crc32c (castagnoli) of size bytes, continuing crc: the checksum of a
+// concatenation is Crc32c(b, nb, Crc32c(a, na)). uses the sse4.2 or armv8
+// crc instructions where the cpu has them
+uint32_t
+Crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+}  // namespace milvus::storage
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <future>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -105,6 +106,52 @@ class ChunkManager {
     virtual void
     Remove(const std::string& filepath) = 0;
 
+    /**
+     * @brief Get file size without blocking the caller
+     * By default the request is made when the result is waited for,
+     * on the waiting thread
+     * @param filepath
+     * @return std::future<uint64_t>
+     */
+    virtual std::future<uint64_t>
+    SizeAsync(const std::string& filepath) {
+        return std::async(std::launch::deferred,
+                          [this, filepath]() { return Size(filepath); });
+    }
+
+    /**
+     * @brief Read file to buffer with offset without blocking the caller,
+     * buf has to outlive the returned future
+     * @param filepath
+     * @param offset
+     * @param buf
+     * @param len
+     * @return std::future<uint64_t>
+     */
+    virtual std::future<uint64_t>
+    ReadAsync(const std::string& filepath,
+              uint64_t offset,
+              void* buf,
+              uint64_t len) {
+        return std::async(std::launch::deferred, [=]() {
+            return Read(filepath, offset, buf, len);
+        });
+    }
+
+    /**
+     * @brief Write buffer to file without blocking the caller,
+     * buf has to outlive the returned future
+     * @param filepath
+     * @param buf
+     * @param len
+     * @return std::future<void>
+     */
+    virtual std::future<void>
+    WriteAsync(const std::string& filepath, void* buf, uint64_t len) {
+        return std::async(std::launch::deferred,
+                          [=]() { Write(filepath, buf, len); });
+    }
+
     /**
      * @brief Get the Name object
      * Used for forming diagnosis messages
@@ -127,6 +174,27 @@ class RemoteChunkManager : public ChunkManager {
     GetName() const {
         return "RemoteChunkManager";
     }
+
+    /**
+     * @brief Read the whole file without knowing its size beforehand
+     * @param filepath
+     * @return std::vector<uint8_t>
+     */
+    virtual std::vector<uint8_t>
+    ReadAll(const std::string& filepath) {
+        std::vector<uint8_t> buf(Size(filepath));
+        Read(filepath, buf.data(), buf.size());
+        return buf;
+    }
+
+    /**
+     * @brief Write a local file to the remote file
+     * @param filepath
+     * @param local_file
+     */
+    virtual void
+    WriteFromLocalFile(const std::string& filepath,
+                       const std::string& local_file) = 0;
 };
 
 using RemoteChunkManagerPtr = std::unique_ptr<RemoteChunkManager>;
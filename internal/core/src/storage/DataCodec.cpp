@@ -19,6 +19,7 @@
 #include "storage/Util.h"
 #include "storage/InsertData.h"
 #include "storage/IndexData.h"
+#include "storage/PayloadReader.h"
 #include "exceptions/EasyAssert.h"
 #include "common/Consts.h"
 
@@ -35,13 +36,16 @@ DeserializeRemoteFileData(PayloadInputStream* input_stream) {
                             descriptor_fix_part.partition_id,
                             descriptor_fix_part.segment_id,
                             descriptor_fix_part.field_id};
+    auto payload_crc32c = GetPayloadCrc32c(descriptor_event.event_data);
     EventHeader header(input_stream);
     switch (header.event_type_) {
         case EventType::InsertEvent: {
             auto event_data_length =
                 header.event_length_ - header.next_position_;
-            auto insert_event_data =
-                InsertEventData(input_stream, event_data_length, data_type);
+            auto insert_event_data = InsertEventData(input_stream,
+                                                     event_data_length,
+                                                     data_type,
+                                                     payload_crc32c);
             auto insert_data =
                 std::make_unique<InsertData>(insert_event_data.field_data);
             insert_data->SetFieldDataMeta(data_meta);
@@ -52,8 +56,10 @@ DeserializeRemoteFileData(PayloadInputStream* input_stream) {
         case EventType::IndexFileEvent: {
             auto event_data_length =
                 header.event_length_ - header.next_position_;
-            auto index_event_data =
-                IndexEventData(input_stream, event_data_length, data_type);
+            auto index_event_data = IndexEventData(input_stream,
+                                                   event_data_length,
+                                                   data_type,
+                                                   payload_crc32c);
             auto index_data =
                 std::make_unique<IndexData>(index_event_data.field_data);
             index_data->SetFieldDataMeta(data_meta);
@@ -125,4 +131,56 @@ DeserializeLocalIndexFileData(const uint8_t* input_data, int64_t length) {
     return std::make_unique<IndexData>(event.field_data);
 }
 
+// remote file layout
+// ------------------------------------------------------------------------
+// | Magic | DescriptorEvent | EventHeader | Start/EndTimestamp | Payload |
+// ------------------------------------------------------------------------
+std::shared_ptr<RemotePayloadInputStream>
+OpenRemotePayload(ChunkManager* chunk_manager,
+                  const std::string& filepath,
+                  DataType& data_type) {
+    EventHeader header;
+    BaseEventData event_data;
+    int64_t header_size = GetEventHeaderSize(header);
+    int64_t fix_part_size = GetFixPartSize(event_data);
+
+    // the descriptor header tells how far the headers reach
+    std::vector<uint8_t> head(sizeof(MAGIC_NUM) + header_size);
+    chunk_manager->Read(filepath, 0, head.data(), head.size());
+    PayloadInputStream head_stream(head.data(), head.size());
+    AssertInfo(ReadMediumType(&head_stream) == StorageType::Remote,
+               "file " + filepath + " is not a remote binlog");
+    EventHeader descriptor_header(&head_stream);
+
+    int64_t event_offset = sizeof(MAGIC_NUM) + descriptor_header.event_length_;
+    head.resize(event_offset + header_size + fix_part_size);
+    chunk_manager->Read(filepath, 0, head.data(), head.size());
+    PayloadInputStream input_stream(head.data(), head.size());
+    ReadMediumType(&input_stream);
+    DescriptorEvent descriptor_event(&input_stream);
+    data_type = DataType(descriptor_event.event_data.fix_part.data_type);
+    header = EventHeader(&input_stream);
+    AssertInfo(header.event_type_ == EventType::InsertEvent ||
+                   header.event_type_ == EventType::IndexFileEvent,
+               "unsupported event type");
+
+    int64_t payload_offset = event_offset + header.next_position_ +
+                             fix_part_size;
+    int64_t payload_length =
+        header.event_length_ - header.next_position_ - fix_part_size;
+    return std::make_shared<RemotePayloadInputStream>(
+        chunk_manager, filepath, payload_offset, payload_length);
+}
+
+void
+DeserializeRemoteFileStream(
+    ChunkManager* chunk_manager,
+    const std::string& filepath,
+    int64_t batch_bytes,
+    const std::function<void(const Payload&)>& consumer) {
+    DataType data_type;
+    auto payload_stream = OpenRemotePayload(chunk_manager, filepath, data_type);
+    ReadPayloadBatches(payload_stream, data_type, batch_bytes, consumer);
+}
+
 }  // namespace milvus::storage
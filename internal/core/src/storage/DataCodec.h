@@ -16,10 +16,13 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
 #include <vector>
 #include <memory>
 #include <utility>
 
+#include "storage/ChunkManager.h"
 #include "storage/Types.h"
 #include "storage/FieldData.h"
 #include "storage/PayloadStream.h"
@@ -67,6 +70,11 @@ class DataCodec {
         return field_data_->get_payload();
     }
 
+    std::shared_ptr<FieldData>
+    GetFieldData() const {
+        return field_data_;
+    }
+
  protected:
     CodecType codec_type_;
     std::pair<Timestamp, Timestamp> time_range_;
@@ -91,4 +99,21 @@ DeserializeRemoteFileData(PayloadInputStream* input_stream);
 std::unique_ptr<DataCodec>
 DeserializeLocalFileData(PayloadInputStream* input_stream);
 
+// Open the payload of a remote insert or index file for ranged reads, only
+// the event headers are fetched; data_type is set to the type of the payload
+std::shared_ptr<RemotePayloadInputStream>
+OpenRemotePayload(ChunkManager* chunk_manager,
+                  const std::string& filepath,
+                  DataType& data_type);
+
+// Decode a remote insert or index file in place: only the event headers are
+// fetched up front, the payload is then read through ranged reads and handed
+// to consumer in batches of about batch_bytes
+void
+DeserializeRemoteFileStream(
+    ChunkManager* chunk_manager,
+    const std::string& filepath,
+    int64_t batch_bytes,
+    const std::function<void(const Payload&)>& consumer);
+
 }  // namespace milvus::storage
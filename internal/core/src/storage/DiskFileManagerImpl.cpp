@@ -15,15 +15,21 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <deque>
+#include <optional>
 #include <boost/filesystem.hpp>
 #include <mutex>
+#include <unordered_map>
 
 #include "common/Common.h"
 #include "common/Slice.h"
+#include "exceptions/EasyAssert.h"
 #include "log/Log.h"
 #include "config/ConfigKnowhere.h"
+#include "storage/Checksum.h"
 #include "storage/DiskFileManagerImpl.h"
 #include "storage/LocalChunkManager.h"
+#include "storage/LocalIndexCache.h"
 #include "storage/MinioChunkManager.h"
 #include "storage/Exception.h"
 #include "storage/FieldData.h"
@@ -70,6 +76,10 @@ DiskFileManagerImpl::DiskFileManagerImpl(const FieldDataMeta& field_meta,
 }
 
 DiskFileManagerImpl::~DiskFileManagerImpl() {
+    if (!cached_index_dir_.empty()) {
+        LocalIndexCache::GetInstance().Release(cached_index_dir_);
+        return;
+    }
     auto& local_chunk_manager = LocalChunkManager::GetInstance();
     local_chunk_manager.RemoveDir(
         GetLocalIndexPathPrefixWithBuildID(index_meta_.build_id));
@@ -106,7 +116,7 @@ EncodeAndUploadIndexSlice(RemoteChunkManager* remote_chunk_manager,
 bool
 DiskFileManagerImpl::AddFile(const std::string& file) noexcept {
     auto& local_chunk_manager = LocalChunkManager::GetInstance();
-    auto& pool = ThreadPool::GetInstance();
+    auto& pool = ThreadPool::GetInstance(ThreadPoolType::INDEX_BUILD);
     FILEMANAGER_TRY
     if (!local_chunk_manager.Exist(file)) {
         LOG_SEGCORE_ERROR_C << "local file: " << file << " does not exist ";
@@ -156,7 +166,7 @@ DiskFileManagerImpl::AddFile(const std::string& file) noexcept {
     return true;
 }  // namespace knowhere
 
-void
+bool
 DiskFileManagerImpl::CacheIndexToDisk(std::vector<std::string> remote_files) {
     auto& local_chunk_manager = LocalChunkManager::GetInstance();
 
@@ -171,83 +181,157 @@ DiskFileManagerImpl::CacheIndexToDisk(std::vector<std::string> remote_files) {
         std::sort(slices.second.begin(), slices.second.end());
     }
 
-    auto EstimateParallelDegree = [&](const std::string& file) -> uint64_t {
-        auto fileSize = rcm_->Size(file);
-        return uint64_t(DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT / fileSize);
+    auto local_index_dir = GetLocalIndexObjectPrefix();
+    auto local_file_name = [&](const std::string& prefix) {
+        return local_index_dir + prefix.substr(prefix.find_last_of("/") + 1);
     };
+    std::sort(remote_files.begin(), remote_files.end());
+    auto& cache = LocalIndexCache::GetInstance();
+    auto reused = cache.Acquire(local_index_dir, remote_files);
+    cached_index_dir_ = local_index_dir;
+    if (reused) {
+        for (auto& slices : index_slices) {
+            local_paths_.emplace_back(local_file_name(slices.first));
+        }
+        return true;
+    }
 
+    // checksums of the local files, a kept copy is checked against them
+    // before it is reused
+    std::unordered_map<std::string, uint32_t> checksums;
     for (auto& slices : index_slices) {
         auto prefix = slices.first;
-        auto local_index_file_name =
-            GetLocalIndexObjectPrefix() +
-            prefix.substr(prefix.find_last_of("/") + 1);
+        auto local_index_file_name = local_file_name(prefix);
         local_chunk_manager.CreateFile(local_index_file_name);
-        int64_t offset = 0;
-        std::vector<std::string> batch_remote_files;
-        uint64_t max_parallel_degree = INT_MAX;
-        for (auto iter = slices.second.begin(); iter != slices.second.end();
-             iter++) {
-            if (batch_remote_files.size() == max_parallel_degree) {
-                auto next_offset = CacheBatchIndexFilesToDisk(
-                    batch_remote_files, local_index_file_name, offset);
-                offset = next_offset;
-                batch_remote_files.clear();
-            }
-            auto origin_file = prefix + "_" + std::to_string(*iter);
-            if (batch_remote_files.size() == 0) {
-                // Use first file size as average size to estimate
-                max_parallel_degree = EstimateParallelDegree(origin_file);
-            }
-            batch_remote_files.push_back(origin_file);
+        LocalFileAppender local_file(local_index_file_name, 0);
+        std::vector<std::string> slice_files;
+        for (auto slice_id : slices.second) {
+            slice_files.push_back(prefix + "_" + std::to_string(slice_id));
         }
-        if (batch_remote_files.size() > 0) {
-            auto next_offset = CacheBatchIndexFilesToDisk(
-                batch_remote_files, local_index_file_name, offset);
-            offset = next_offset;
-            batch_remote_files.clear();
+        uint32_t crc = 0;
+        ForEachRemoteFile(slice_files, [&](std::unique_ptr<DataCodec> res) {
+            auto index_payload = res->GetPayload();
+            auto index_size = index_payload->rows * sizeof(uint8_t);
+            if (binlog_checksum) {
+                crc = Crc32c(index_payload->raw_data, index_size, crc);
+            }
+            local_file.Append(index_payload->raw_data, index_size);
+        });
+        local_file.Finish();
+        if (binlog_checksum) {
+            checksums[local_index_file_name] = crc;
         }
         local_paths_.emplace_back(local_index_file_name);
     }
+    cache.Commit(local_index_dir, std::move(checksums));
+    return false;
 }
 
-std::unique_ptr<DataCodec>
-DownloadAndDecodeRemoteIndexfile(RemoteChunkManager* remote_chunk_manager,
-                                 std::string file) {
-    auto fileSize = remote_chunk_manager->Size(file);
-    auto buf = std::shared_ptr<uint8_t[]>(new uint8_t[fileSize]);
-    remote_chunk_manager->Read(file, buf.get(), fileSize);
-
-    return DeserializeFileData(buf.get(), fileSize);
-}
-
-uint64_t
-DiskFileManagerImpl::CacheBatchIndexFilesToDisk(
+void
+DiskFileManagerImpl::ForEachRemoteFile(
     const std::vector<std::string>& remote_files,
-    const std::string& local_file_name,
-    uint64_t local_file_init_offfset) {
-    auto& local_chunk_manager = LocalChunkManager::GetInstance();
-    auto& pool = ThreadPool::GetInstance();
-    int batch_size = remote_files.size();
+    const std::function<void(std::unique_ptr<DataCodec>)>& consumer) {
+    struct Download {
+        std::unique_ptr<uint8_t[]> buf;
+        uint64_t size;
+        std::future<uint64_t> read;
+    };
+    // downloads run ahead of the file being consumed while their buffers
+    // fit in the budget, so consuming file k overlaps downloading k+1..k+n
+    const uint64_t budget = DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT;
+    std::vector<std::future<uint64_t>> sizes;
+    for (auto& file : remote_files) {
+        sizes.push_back(rcm_->SizeAsync(file));
+    }
+    std::deque<Download> downloads;
+    uint64_t download_bytes = 0;
+    size_t next = 0;
+    std::optional<uint64_t> next_size;
+    auto download_ahead = [&]() {
+        while (next < remote_files.size()) {
+            if (!next_size.has_value()) {
+                next_size = sizes[next].get();
+            }
+            if (!downloads.empty() &&
+                download_bytes + next_size.value() > budget) {
+                return;
+            }
+            auto size = next_size.value();
+            auto buf = std::unique_ptr<uint8_t[]>(new uint8_t[size]);
+            auto read = rcm_->ReadAsync(remote_files[next], 0, buf.get(), size);
+            downloads.push_back({std::move(buf), size, std::move(read)});
+            download_bytes += size;
+            next_size.reset();
+            ++next;
+        }
+    };
 
-    std::vector<std::future<std::unique_ptr<DataCodec>>> futures;
-    for (int i = 0; i < batch_size; ++i) {
-        futures.push_back(pool.Submit(
-            DownloadAndDecodeRemoteIndexfile, rcm_.get(), remote_files[i]));
+    try {
+        for (size_t i = 0; i < remote_files.size(); ++i) {
+            download_ahead();
+            auto download = std::move(downloads.front());
+            downloads.pop_front();
+            auto read_size = download.read.get();
+            download_bytes -= download.size;
+            auto res = DeserializeFileData(download.buf.get(), read_size);
+            download.buf.reset();
+            consumer(std::move(res));
+        }
+    } catch (...) {
+        // the reads still in flight write into buffers freed on return
+        for (auto& download : downloads) {
+            try {
+                download.read.get();
+            } catch (...) {
+            }
+        }
+        throw;
     }
+}
 
-    uint64_t offset = local_file_init_offfset;
-    for (int i = 0; i < batch_size; ++i) {
-        auto res = futures[i].get();
-        auto index_payload = res->GetPayload();
-        auto index_size = index_payload->rows * sizeof(uint8_t);
-        local_chunk_manager.Write(local_file_name,
-                                  offset,
-                                  const_cast<uint8_t*>(index_payload->raw_data),
-                                  index_size);
-        offset += index_size;
+void
+DiskFileManagerImpl::ForEachRawData(
+    const std::vector<std::string>& remote_files,
+    const std::function<void(const Payload&)>& consumer) {
+    // binlogs are decoded while they stream in, so a binlog larger than
+    // the memory budget never has to be held as a whole
+    for (auto& file : remote_files) {
+        DeserializeRemoteFileStream(rcm_.get(),
+                                    file,
+                                    DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT,
+                                    consumer);
     }
+}
 
-    return offset;
+std::string
+DiskFileManagerImpl::CacheRawDataToDisk(
+    const std::vector<std::string>& remote_files) {
+    auto& local_chunk_manager = LocalChunkManager::GetInstance();
+    auto local_data_path = GetLocalRawDataObjectPrefix() + "raw_data";
+    local_chunk_manager.CreateFile(local_data_path);
+
+    // the row count and dim lead the file, written once every row is in
+    uint32_t num = 0;
+    uint32_t dim = 0;
+    LocalFileAppender local_file(local_data_path, 0);
+    uint32_t header[2] = {0, 0};
+    local_file.Append(header, sizeof(header));
+    ForEachRawData(remote_files, [&](const Payload& payload) {
+        AssertInfo(payload.dimension.has_value(),
+                   "raw data of disk index is not a vector field");
+        if (num == 0) {
+            dim = uint32_t(payload.dimension.value());
+        }
+        AssertInfo(dim == uint32_t(payload.dimension.value()),
+                   "inconsistent dim in insert binlogs");
+        local_file.Append(payload.raw_data, GetPayloadSize(&payload));
+        num += uint32_t(payload.rows);
+    });
+    local_file.Finish();
+    local_chunk_manager.Write(local_data_path, 0, &num, sizeof(num));
+    local_chunk_manager.Write(local_data_path, sizeof(num), &dim, sizeof(dim));
+
+    return local_data_path;
 }
 
 std::string
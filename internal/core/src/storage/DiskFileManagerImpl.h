@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <shared_mutex>
@@ -76,13 +77,22 @@ class DiskFileManagerImpl : public FileManagerImpl {
         return local_paths_;
     }
 
-    void
+    // downloads the index files into the local index directory, unless a
+    // load of the same index left them there; returns whether they were
+    // reused
+    bool
     CacheIndexToDisk(std::vector<std::string> remote_files);
 
-    uint64_t
-    CacheBatchIndexFilesToDisk(const std::vector<std::string>& remote_files,
-                               const std::string& local_file_name,
-                               uint64_t local_file_init_offfset);
+    // hands the payloads of the insert binlogs in remote_files to consumer
+    // in order, streamed in batches of DEFAULT_DISK_INDEX_MAX_MEMORY_LIMIT
+    void
+    ForEachRawData(const std::vector<std::string>& remote_files,
+                   const std::function<void(const Payload&)>& consumer);
+
+    // streams the vectors in the insert binlogs into the local raw data file
+    // a disk index is built from, returns its path
+    std::string
+    CacheRawDataToDisk(const std::vector<std::string>& remote_files);
 
     FieldDataMeta
     GetFileDataMeta() const {
@@ -103,6 +113,13 @@ class DiskFileManagerImpl : public FileManagerImpl {
     std::string
     GetFileName(const std::string& localfile);
 
+    // downloads the remote files in a bounded pipeline and hands each
+    // decoded file to consumer in order
+    void
+    ForEachRemoteFile(
+        const std::vector<std::string>& remote_files,
+        const std::function<void(std::unique_ptr<DataCodec>)>& consumer);
+
  private:
     // collection meta
     FieldDataMeta field_meta_;
@@ -116,6 +133,10 @@ class DiskFileManagerImpl : public FileManagerImpl {
     // remote file path
     std::map<std::string, int64_t> remote_paths_to_size_;
 
+    // the local index directory acquired from LocalIndexCache, which
+    // decides whether its files outlive this file manager
+    std::string cached_index_dir_;
+
     RemoteChunkManagerPtr rcm_;
     std::string remote_root_path_;
 };
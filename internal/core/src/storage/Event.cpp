@@ -15,16 +15,102 @@
 // limitations under the License.
 
 #include "storage/Event.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "storage/Checksum.h"
 #include "storage/Util.h"
 #include "storage/PayloadReader.h"
 #include "storage/PayloadWriter.h"
 #include "exceptions/EasyAssert.h"
 #include "utils/Json.h"
+#include "common/Common.h"
 #include "common/Consts.h"
 #include "common/FieldMeta.h"
 
 namespace milvus::storage {
 
+namespace {
+inline void
+AppendBytes(std::vector<uint8_t>& buffer, const void* data, size_t size) {
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+template <typename T>
+inline void
+AppendValue(std::vector<uint8_t>& buffer, const T& value) {
+    AppendBytes(buffer, &value, sizeof(value));
+}
+
+// the event length is only known once the event data is in the buffer, so
+// the header goes in first and its length field is patched afterwards
+template <typename Event>
+void
+SerializeEventTo(Event& event, std::vector<uint8_t>& buffer) {
+    auto& header = event.event_header;
+    auto header_offset = buffer.size();
+    header.next_position_ = GetEventHeaderSize(header);
+    header.event_length_ = 0;
+    header.SerializeTo(buffer);
+    event.event_data.SerializeTo(buffer);
+    header.event_length_ = buffer.size() - header_offset;
+    auto length_offset = header_offset + sizeof(header.timestamp_) +
+                         sizeof(header.event_type_);
+    memcpy(buffer.data() + length_offset,
+           &header.event_length_,
+           sizeof(header.event_length_));
+}
+}  // namespace
+
+std::vector<uint8_t>
+SerializeRemoteEvents(DescriptorEvent& descriptor_event, BaseEvent& event) {
+    auto& extras = descriptor_event.event_data.extras;
+    extras.erase(PAYLOAD_CRC32C_KEY);
+    if (binlog_checksum) {
+        // the payload comes after the descriptor, its checksum is patched
+        // into the fixed width placeholder once it is written
+        extras[PAYLOAD_CRC32C_KEY] = std::string(8, '0');
+    }
+    std::vector<uint8_t> res;
+    descriptor_event.SerializeTo(res);
+    auto descriptor_end = res.size();
+    event.SerializeTo(res);
+    if (!binlog_checksum) {
+        return res;
+    }
+
+    auto payload_offset = descriptor_end + event.event_header.next_position_ +
+                          GetFixPartSize(event.event_data);
+    char hex[9];
+    snprintf(hex,
+             sizeof(hex),
+             "%08x",
+             Crc32c(res.data() + payload_offset, res.size() - payload_offset));
+    extras[PAYLOAD_CRC32C_KEY] = hex;
+    auto& extra_bytes = descriptor_event.event_data.extra_bytes;
+    auto key = std::string("\"") + PAYLOAD_CRC32C_KEY + "\":\"";
+    auto extras_begin = res.begin() + descriptor_end - extra_bytes.size();
+    auto it = std::search(extras_begin,
+                          res.begin() + descriptor_end,
+                          key.begin(),
+                          key.end());
+    AssertInfo(it != res.begin() + descriptor_end,
+               "payload checksum placeholder not found");
+    std::copy(hex, hex + 8, it + key.size());
+    return res;
+}
+
+std::optional<uint32_t>
+GetPayloadCrc32c(const DescriptorEventData& data) {
+    auto it = data.extras.find(PAYLOAD_CRC32C_KEY);
+    if (it == data.extras.end()) {
+        return std::nullopt;
+    }
+    return uint32_t(std::stoul(it->second, nullptr, 16));
+}
+
 int
 GetFixPartSize(DescriptorEventData& data) {
     return sizeof(data.fix_part.collection_id) +
@@ -80,21 +166,19 @@ EventHeader::EventHeader(PayloadInputStream* input) {
 
 std::vector<uint8_t>
 EventHeader::Serialize() {
-    auto header_size = sizeof(timestamp_) + sizeof(event_type_) +
-                       sizeof(event_length_) + sizeof(next_position_);
-    std::vector<uint8_t> res(header_size);
-    int offset = 0;
-    memcpy(res.data() + offset, &timestamp_, sizeof(timestamp_));
-    offset += sizeof(timestamp_);
-    memcpy(res.data() + offset, &event_type_, sizeof(event_type_));
-    offset += sizeof(event_type_);
-    memcpy(res.data() + offset, &event_length_, sizeof(event_length_));
-    offset += sizeof(event_length_);
-    memcpy(res.data() + offset, &next_position_, sizeof(next_position_));
-
+    std::vector<uint8_t> res;
+    SerializeTo(res);
     return res;
 }
 
+void
+EventHeader::SerializeTo(std::vector<uint8_t>& buffer) {
+    AppendValue(buffer, timestamp_);
+    AppendValue(buffer, event_type_);
+    AppendValue(buffer, event_length_);
+    AppendValue(buffer, next_position_);
+}
+
 DescriptorEventDataFixPart::DescriptorEventDataFixPart(
     PayloadInputStream* input) {
     auto ast = input->Read(sizeof(collection_id), &collection_id);
@@ -115,29 +199,22 @@ DescriptorEventDataFixPart::DescriptorEventDataFixPart(
 
 std::vector<uint8_t>
 DescriptorEventDataFixPart::Serialize() {
-    auto fix_part_size = sizeof(collection_id) + sizeof(partition_id) +
-                         sizeof(segment_id) + sizeof(field_id) +
-                         sizeof(start_timestamp) + sizeof(end_timestamp) +
-                         sizeof(data_type);
-    std::vector<uint8_t> res(fix_part_size);
-    int offset = 0;
-    memcpy(res.data() + offset, &collection_id, sizeof(collection_id));
-    offset += sizeof(collection_id);
-    memcpy(res.data() + offset, &partition_id, sizeof(partition_id));
-    offset += sizeof(partition_id);
-    memcpy(res.data() + offset, &segment_id, sizeof(segment_id));
-    offset += sizeof(segment_id);
-    memcpy(res.data() + offset, &field_id, sizeof(field_id));
-    offset += sizeof(field_id);
-    memcpy(res.data() + offset, &start_timestamp, sizeof(start_timestamp));
-    offset += sizeof(start_timestamp);
-    memcpy(res.data() + offset, &end_timestamp, sizeof(end_timestamp));
-    offset += sizeof(end_timestamp);
-    memcpy(res.data() + offset, &data_type, sizeof(data_type));
-
+    std::vector<uint8_t> res;
+    SerializeTo(res);
     return res;
 }
 
+void
+DescriptorEventDataFixPart::SerializeTo(std::vector<uint8_t>& buffer) {
+    AppendValue(buffer, collection_id);
+    AppendValue(buffer, partition_id);
+    AppendValue(buffer, segment_id);
+    AppendValue(buffer, field_id);
+    AppendValue(buffer, start_timestamp);
+    AppendValue(buffer, end_timestamp);
+    AppendValue(buffer, data_type);
+}
+
 DescriptorEventData::DescriptorEventData(PayloadInputStream* input) {
     fix_part = DescriptorEventDataFixPart(input);
     for (auto i = int8_t(EventType::DescriptorEvent);
@@ -162,11 +239,20 @@ DescriptorEventData::DescriptorEventData(PayloadInputStream* input) {
     if (json.contains(INDEX_BUILD_ID_KEY)) {
         extras[INDEX_BUILD_ID_KEY] = json[INDEX_BUILD_ID_KEY];
     }
+    if (json.contains(PAYLOAD_CRC32C_KEY)) {
+        extras[PAYLOAD_CRC32C_KEY] = json[PAYLOAD_CRC32C_KEY];
+    }
 }
 
 std::vector<uint8_t>
 DescriptorEventData::Serialize() {
-    auto fix_part_data = fix_part.Serialize();
+    std::vector<uint8_t> res;
+    SerializeTo(res);
+    return res;
+}
+
+void
+DescriptorEventData::SerializeTo(std::vector<uint8_t>& buffer) {
     milvus::json extras_json;
     for (auto v : extras) {
         extras_json.emplace(v.first, v.second);
@@ -175,26 +261,17 @@ DescriptorEventData::Serialize() {
     extra_length = extras_string.size();
     extra_bytes =
         std::vector<uint8_t>(extras_string.begin(), extras_string.end());
-    auto len = fix_part_data.size() + post_header_lengths.size() +
-               sizeof(extra_length) + extra_length;
-    std::vector<uint8_t> res(len);
-    int offset = 0;
-    memcpy(res.data() + offset, fix_part_data.data(), fix_part_data.size());
-    offset += fix_part_data.size();
-    memcpy(res.data() + offset,
-           post_header_lengths.data(),
-           post_header_lengths.size());
-    offset += post_header_lengths.size();
-    memcpy(res.data() + offset, &extra_length, sizeof(extra_length));
-    offset += sizeof(extra_length);
-    memcpy(res.data() + offset, extra_bytes.data(), extra_bytes.size());
 
-    return res;
+    fix_part.SerializeTo(buffer);
+    AppendBytes(buffer, post_header_lengths.data(), post_header_lengths.size());
+    AppendValue(buffer, extra_length);
+    AppendBytes(buffer, extra_bytes.data(), extra_bytes.size());
 }
 
 BaseEventData::BaseEventData(PayloadInputStream* input,
                              int event_length,
-                             DataType data_type) {
+                             DataType data_type,
+                             const std::optional<uint32_t>& payload_crc32c) {
     auto ast = input->Read(sizeof(start_timestamp), &start_timestamp);
     AssertInfo(ast.ok(), "read start timestamp failed");
     ast = input->Read(sizeof(end_timestamp), &end_timestamp);
@@ -203,37 +280,53 @@ BaseEventData::BaseEventData(PayloadInputStream* input,
     int payload_length =
         event_length - sizeof(start_timestamp) - sizeof(end_timestamp);
     auto res = input->Read(payload_length);
+    auto payload = res.ValueOrDie();
+    AssertInfo(payload->size() == payload_length, "event payload truncated");
+    if (payload_crc32c.has_value()) {
+        AssertInfo(Crc32c(payload->data(), payload_length) ==
+                       payload_crc32c.value(),
+                   "event payload checksum mismatch");
+    }
     auto payload_reader = std::make_shared<PayloadReader>(
-        res.ValueOrDie()->data(), payload_length, data_type);
+        payload->data(), payload_length, data_type);
     field_data = payload_reader->get_field_data();
 }
 
-// TODO :: handle string and bool type
 std::vector<uint8_t>
 BaseEventData::Serialize() {
-    auto payload = field_data->get_payload();
+    std::vector<uint8_t> res;
+    SerializeTo(res);
+    return res;
+}
+
+void
+BaseEventData::SerializeTo(std::vector<uint8_t>& buffer) {
     std::shared_ptr<PayloadWriter> payload_writer;
-    if (milvus::datatype_is_vector(payload->data_type)) {
-        AssertInfo(payload->dimension.has_value(), "empty dimension");
-        payload_writer = std::make_unique<PayloadWriter>(
-            payload->data_type, payload->dimension.value());
+    auto data_type = field_data->get_data_type();
+    if (milvus::datatype_is_string(data_type)) {
+        const char* data;
+        const int32_t* offsets;
+        int rows;
+        field_data->get_string_payload(&data, &offsets, &rows);
+        payload_writer = std::make_unique<PayloadWriter>(data_type);
+        payload_writer->add_string_payload(data, offsets, rows);
     } else {
-        payload_writer = std::make_unique<PayloadWriter>(payload->data_type);
+        auto payload = field_data->get_payload();
+        if (milvus::datatype_is_vector(payload->data_type)) {
+            AssertInfo(payload->dimension.has_value(), "empty dimension");
+            payload_writer = std::make_unique<PayloadWriter>(
+                payload->data_type, payload->dimension.value());
+        } else {
+            payload_writer =
+                std::make_unique<PayloadWriter>(payload->data_type);
+        }
+        payload_writer->add_payload(*payload.get());
     }
-    payload_writer->add_payload(*payload.get());
-    payload_writer->finish();
-    auto payload_buffer = payload_writer->get_payload_buffer();
-    auto len =
-        sizeof(start_timestamp) + sizeof(end_timestamp) + payload_buffer.size();
-    std::vector<uint8_t> res(len);
-    int offset = 0;
-    memcpy(res.data() + offset, &start_timestamp, sizeof(start_timestamp));
-    offset += sizeof(start_timestamp);
-    memcpy(res.data() + offset, &end_timestamp, sizeof(end_timestamp));
-    offset += sizeof(end_timestamp);
-    memcpy(res.data() + offset, payload_buffer.data(), payload_buffer.size());
 
-    return res;
+    AppendValue(buffer, start_timestamp);
+    AppendValue(buffer, end_timestamp);
+    // parquet writes straight behind the timestamps
+    payload_writer->finish(&buffer);
 }
 
 BaseEvent::BaseEvent(PayloadInputStream* input, DataType data_type) {
@@ -245,24 +338,16 @@ BaseEvent::BaseEvent(PayloadInputStream* input, DataType data_type) {
 
 std::vector<uint8_t>
 BaseEvent::Serialize() {
-    auto data = event_data.Serialize();
-    int data_size = data.size();
-
-    event_header.next_position_ = GetEventHeaderSize(event_header);
-    event_header.event_length_ = event_header.next_position_ + data_size;
-    auto header = event_header.Serialize();
-    int header_size = header.size();
-
-    int len = header_size + data_size;
-    std::vector<uint8_t> res(len);
-    int offset = 0;
-    memcpy(res.data() + offset, header.data(), header_size);
-    offset += header_size;
-    memcpy(res.data() + offset, data.data(), data_size);
-
+    std::vector<uint8_t> res;
+    SerializeTo(res);
     return res;
 }
 
+void
+BaseEvent::SerializeTo(std::vector<uint8_t>& buffer) {
+    SerializeEventTo(*this, buffer);
+}
+
 DescriptorEvent::DescriptorEvent(PayloadInputStream* input) {
     event_header = EventHeader(input);
     event_data = DescriptorEventData(input);
@@ -270,25 +355,16 @@ DescriptorEvent::DescriptorEvent(PayloadInputStream* input) {
 
 std::vector<uint8_t>
 DescriptorEvent::Serialize() {
-    auto data = event_data.Serialize();
-    int data_size = data.size();
+    std::vector<uint8_t> res;
+    SerializeTo(res);
+    return res;
+}
 
+void
+DescriptorEvent::SerializeTo(std::vector<uint8_t>& buffer) {
     event_header.event_type_ = EventType::DescriptorEvent;
-    event_header.next_position_ = GetEventHeaderSize(event_header);
-    event_header.event_length_ = event_header.next_position_ + data_size;
-    auto header = event_header.Serialize();
-    int header_size = header.size();
-
-    int len = header_size + data_size + sizeof(MAGIC_NUM);
-    std::vector<uint8_t> res(len);
-    int offset = 0;
-    memcpy(res.data(), &MAGIC_NUM, sizeof(MAGIC_NUM));
-    offset += sizeof(MAGIC_NUM);
-    memcpy(res.data() + offset, header.data(), header_size);
-    offset += header_size;
-    memcpy(res.data() + offset, data.data(), data_size);
-
-    return res;
+    AppendValue(buffer, MAGIC_NUM);
+    SerializeEventTo(*this, buffer);
 }
 
 LocalInsertEvent::LocalInsertEvent(PayloadInputStream* input,
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 
@@ -40,6 +41,11 @@ struct EventHeader {
 
     std::vector<uint8_t>
     Serialize();
+
+    // append the serialized bytes to buffer, events are assembled in one
+    // output buffer rather than concatenated from per-part vectors
+    void
+    SerializeTo(std::vector<uint8_t>& buffer);
 };
 
 struct DescriptorEventDataFixPart {
@@ -57,6 +63,9 @@ struct DescriptorEventDataFixPart {
 
     std::vector<uint8_t>
     Serialize();
+
+    void
+    SerializeTo(std::vector<uint8_t>& buffer);
 };
 
 struct DescriptorEventData {
@@ -72,6 +81,9 @@ struct DescriptorEventData {
 
     std::vector<uint8_t>
     Serialize();
+
+    void
+    SerializeTo(std::vector<uint8_t>& buffer);
 };
 
 struct BaseEventData {
@@ -81,12 +93,18 @@ struct BaseEventData {
 
     BaseEventData() {
     }
-    explicit BaseEventData(PayloadInputStream* input,
-                           int event_length,
-                           DataType data_type);
+    // checks the payload against payload_crc32c if it is given
+    explicit BaseEventData(
+        PayloadInputStream* input,
+        int event_length,
+        DataType data_type,
+        const std::optional<uint32_t>& payload_crc32c = std::nullopt);
 
     std::vector<uint8_t>
     Serialize();
+
+    void
+    SerializeTo(std::vector<uint8_t>& buffer);
 };
 
 struct DescriptorEvent {
@@ -99,6 +117,9 @@ struct DescriptorEvent {
 
     std::vector<uint8_t>
     Serialize();
+
+    void
+    SerializeTo(std::vector<uint8_t>& buffer);
 };
 
 struct BaseEvent {
@@ -111,6 +132,9 @@ struct BaseEvent {
 
     std::vector<uint8_t>
     Serialize();
+
+    void
+    SerializeTo(std::vector<uint8_t>& buffer);
 };
 
 using InsertEvent = BaseEvent;
@@ -128,6 +152,16 @@ using DropCollectionEventData = BaseEventData;
 using DropPartitionEvent = BaseEvent;
 using DropPartitionEventData = BaseEventData;
 
+// a remote file of the descriptor event and one data event; with
+// binlog_checksum on, the descriptor extras carry the crc32c of the
+// payload under PAYLOAD_CRC32C_KEY
+std::vector<uint8_t>
+SerializeRemoteEvents(DescriptorEvent& descriptor_event, BaseEvent& event);
+
+// the payload crc32c the descriptor extras carry, if any
+std::optional<uint32_t>
+GetPayloadCrc32c(const DescriptorEventData& data);
+
 int
 GetFixPartSize(DescriptorEventData& data);
 int
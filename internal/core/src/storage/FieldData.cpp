@@ -73,6 +73,22 @@ FieldData::get_one_string_payload(int idx, char** cstr, int* str_size) const {
     *str_size = length;
 }
 
+void
+FieldData::get_string_payload(const char** data,
+                              const int32_t** offsets,
+                              int* rows) const {
+    AssertInfo(array_ != nullptr, "null arrow array");
+    AssertInfo(array_->type()->id() == arrow::Type::type::STRING,
+               "inconsistent data type");
+    auto array = std::static_pointer_cast<arrow::StringArray>(array_);
+    // offsets of a sliced array still index the whole value buffer
+    auto values = array->value_data();
+    *data = values != nullptr ? reinterpret_cast<const char*>(values->data())
+                              : nullptr;
+    *offsets = array->raw_value_offsets();
+    *rows = array->length();
+}
+
 std::unique_ptr<Payload>
 FieldData::get_payload() const {
     AssertInfo(array_ != nullptr, "null arrow array");
@@ -88,9 +104,15 @@ FieldData::get_payload() const {
     return raw_data_info;
 }
 
-// TODO :: handle string type
 int
 FieldData::get_data_size() const {
+    if (milvus::datatype_is_string(data_type_)) {
+        const char* data;
+        const int32_t* offsets;
+        int rows;
+        get_string_payload(&data, &offsets, &rows);
+        return offsets[rows] - offsets[0];
+    }
     auto payload = get_payload();
     return GetPayloadSize(payload.get());
 }
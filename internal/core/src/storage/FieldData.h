@@ -52,6 +52,13 @@ class FieldData {
     void
     get_one_string_payload(int idx, char** cstr, int* str_size) const;
 
+    // the buffers of a string array, without copying: row i is
+    // data[offsets[i]] up to data[offsets[i + 1]]
+    void
+    get_string_payload(const char** data,
+                       const int32_t** offsets,
+                       int* rows) const;
+
     // get the bytes stream of the arrow array data
     std::unique_ptr<Payload>
     get_payload() const;
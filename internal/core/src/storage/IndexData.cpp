@@ -63,8 +63,6 @@ IndexData::serialize_to_remote_file() {
     // TODO :: set timestamps
     index_event_header.timestamp_ = 0;
 
-    // serialize insert event
-    auto index_event_bytes = index_event.Serialize();
     DataType data_type = field_data_->get_data_type();
 
     // create descriptor event
@@ -93,14 +91,7 @@ IndexData::serialize_to_remote_file() {
     // TODO :: set timestamp
     des_event_header.timestamp_ = 0;
 
-    // serialize descriptor event data
-    auto des_event_bytes = descriptor_event.Serialize();
-
-    des_event_bytes.insert(des_event_bytes.end(),
-                           index_event_bytes.begin(),
-                           index_event_bytes.end());
-
-    return des_event_bytes;
+    return SerializeRemoteEvents(descriptor_event, index_event);
 }
 
 // Just for test
@@ -59,8 +59,6 @@ InsertData::serialize_to_remote_file() {
     insert_event_header.timestamp_ = 0;
     insert_event_header.event_type_ = EventType::InsertEvent;
 
-    // serialize insert event
-    auto insert_event_bytes = insert_event.Serialize();
     DataType data_type = field_data_->get_data_type();
 
     // create descriptor event
@@ -87,14 +85,7 @@ InsertData::serialize_to_remote_file() {
     // TODO :: set timestamp
     des_event_header.timestamp_ = 0;
 
-    // serialize descriptor event data
-    auto des_event_bytes = descriptor_event.Serialize();
-
-    des_event_bytes.insert(des_event_bytes.end(),
-                           insert_event_bytes.begin(),
-                           insert_event_bytes.end());
-
-    return des_event_bytes;
+    return SerializeRemoteEvents(descriptor_event, insert_event);
 }
 
 // local insert file format
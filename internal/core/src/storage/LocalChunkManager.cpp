@@ -18,7 +18,13 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/system/error_code.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <numeric>
 #include <sstream>
 
 #include "Exception.h"
@@ -32,6 +38,30 @@
 
 namespace milvus::storage {
 
+constexpr uint64_t kDirectIOAlignment = 4096;
+constexpr uint64_t kDirectIOBufferSize = 4 << 20;
+
+inline void
+PWriteAll(int fd,
+          const std::string& filepath,
+          const void* buf,
+          uint64_t size,
+          uint64_t offset) {
+    auto pos = static_cast<const uint8_t*>(buf);
+    while (size > 0) {
+        auto written = pwrite(fd, pos, size, offset);
+        if (written <= 0) {
+            std::stringstream err_msg;
+            err_msg << "Error: write local file '" << filepath << " failed, "
+                    << strerror(errno);
+            throw WriteFileException(err_msg.str());
+        }
+        pos += written;
+        size -= written;
+        offset += written;
+    }
+}
+
 bool
 LocalChunkManager::Exist(const std::string& filepath) {
     boost::filesystem::path absPath(filepath);
@@ -144,6 +174,50 @@ LocalChunkManager::Write(const std::string& absPathStr,
     }
 }
 
+std::vector<uint64_t>
+LocalChunkManager::ReadBatch(const std::string& filepath,
+                             const std::vector<LocalReadRequest>& requests) {
+    auto fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1) {
+        std::stringstream err_msg;
+        err_msg << "Error: open local file '" << filepath << " failed, "
+                << strerror(errno);
+        throw OpenFileException(err_msg.str());
+    }
+
+    std::vector<size_t> order(requests.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return requests[a].offset < requests[b].offset;
+    });
+    std::vector<uint64_t> read_sizes(requests.size());
+    for (auto i : order) {
+        auto& request = requests[i];
+        auto pos = static_cast<uint8_t*>(request.buf);
+        uint64_t read_size = 0;
+        while (read_size < request.len) {
+            auto n = pread(fd,
+                           pos + read_size,
+                           request.len - read_size,
+                           request.offset + read_size);
+            if (n < 0) {
+                std::stringstream err_msg;
+                err_msg << "Error: read local file '" << filepath
+                        << " failed, " << strerror(errno);
+                close(fd);
+                throw ReadFileException(err_msg.str());
+            }
+            if (n == 0) {
+                break;
+            }
+            read_size += n;
+        }
+        read_sizes[i] = read_size;
+    }
+    close(fd);
+    return read_sizes;
+}
+
 std::vector<std::string>
 LocalChunkManager::ListWithPrefix(const std::string& filepath) {
     throw NotImplementedException(GetName() + "::ListWithPrefix" +
@@ -231,4 +305,83 @@ LocalChunkManager::GetSizeOfDir(const std::string& dir) {
     return total_file_size;
 }
 
+LocalFileAppender::LocalFileAppender(const std::string& filepath,
+                                     uint64_t offset)
+    : filepath_(filepath), offset_(offset) {
+    fd_ = open(filepath.c_str(), O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR);
+    if (fd_ == -1) {
+        std::stringstream err_msg;
+        err_msg << "Error: open local file '" << filepath << " failed, "
+                << strerror(errno);
+        throw OpenFileException(err_msg.str());
+    }
+    if (!ChunkMangerConfig::GetLocalDirectIO() ||
+        offset % kDirectIOAlignment != 0) {
+        return;
+    }
+    // file systems without O_DIRECT, such as tmpfs, keep to the page cache
+    direct_fd_ = open(filepath.c_str(), O_WRONLY | O_DIRECT);
+    if (direct_fd_ == -1) {
+        return;
+    }
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, kDirectIOAlignment, kDirectIOBufferSize) !=
+        0) {
+        close(direct_fd_);
+        direct_fd_ = -1;
+        return;
+    }
+    buffer_ = static_cast<uint8_t*>(buffer);
+}
+
+LocalFileAppender::~LocalFileAppender() {
+    free(buffer_);
+    if (direct_fd_ != -1) {
+        close(direct_fd_);
+    }
+    close(fd_);
+}
+
+void
+LocalFileAppender::Append(const void* buf, uint64_t len) {
+    if (direct_fd_ == -1) {
+        PWriteAll(fd_, filepath_, buf, len, offset_);
+        offset_ += len;
+        return;
+    }
+    auto pos = static_cast<const uint8_t*>(buf);
+    while (len > 0) {
+        auto n = std::min(len, kDirectIOBufferSize - buffered_);
+        memcpy(buffer_ + buffered_, pos, n);
+        buffered_ += n;
+        pos += n;
+        len -= n;
+        if (buffered_ == kDirectIOBufferSize) {
+            FlushDirect(kDirectIOBufferSize);
+        }
+    }
+}
+
+uint64_t
+LocalFileAppender::Finish() {
+    if (buffered_ > 0) {
+        auto aligned = buffered_ / kDirectIOAlignment * kDirectIOAlignment;
+        if (aligned > 0) {
+            FlushDirect(aligned);
+        }
+        PWriteAll(fd_, filepath_, buffer_, buffered_, offset_);
+        offset_ += buffered_;
+        buffered_ = 0;
+    }
+    return offset_;
+}
+
+void
+LocalFileAppender::FlushDirect(uint64_t len) {
+    PWriteAll(direct_fd_, filepath_, buffer_, len, offset_);
+    offset_ += len;
+    buffered_ -= len;
+    memmove(buffer_, buffer_ + len, buffered_);
+}
+
 }  // namespace milvus::storage
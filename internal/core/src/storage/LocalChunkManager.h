@@ -25,6 +25,12 @@
 
 namespace milvus::storage {
 
+struct LocalReadRequest {
+    uint64_t offset;
+    void* buf;
+    uint64_t len;
+};
+
 /**
  * @brief LocalChunkManager is responsible for read and write local file
  * that inherited from ChunkManager
@@ -94,6 +100,17 @@ class LocalChunkManager : public ChunkManager {
           void* buf,
           uint64_t len);
 
+    /**
+     * @brief Read scattered ranges of a file with one open, in offset
+     * order rather than one open per range
+     * @param filepath
+     * @param requests
+     * @return bytes read of each request
+     */
+    std::vector<uint64_t>
+    ReadBatch(const std::string& filepath,
+              const std::vector<LocalReadRequest>& requests);
+
     virtual std::vector<std::string>
     ListWithPrefix(const std::string& filepath);
 
@@ -151,6 +168,46 @@ class LocalChunkManager : public ChunkManager {
     std::string path_prefix_;
 };
 
+/**
+ * @brief LocalFileAppender writes a file sequentially from an offset.
+ * With direct io set in ConfigChunkManager and an aligned offset, the
+ * data is staged in an aligned buffer and written with O_DIRECT, so large
+ * files do not fill the page cache; the last partial block is written
+ * through the page cache by Finish
+ */
+class LocalFileAppender {
+ public:
+    LocalFileAppender(const std::string& filepath, uint64_t offset);
+
+    LocalFileAppender(const LocalFileAppender&) = delete;
+    LocalFileAppender&
+    operator=(const LocalFileAppender&) = delete;
+
+    ~LocalFileAppender();
+
+    void
+    Append(const void* buf, uint64_t len);
+
+    /**
+     * @brief Write what is still staged
+     * @return the offset following the appended data
+     */
+    uint64_t
+    Finish();
+
+ private:
+    void
+    FlushDirect(uint64_t len);
+
+ private:
+    std::string filepath_;
+    uint64_t offset_;
+    int fd_ = -1;
+    int direct_fd_ = -1;
+    uint8_t* buffer_ = nullptr;
+    uint64_t buffered_ = 0;
+};
+
 using LocalChunkManagerSPtr =
     std::shared_ptr<milvus::storage::LocalChunkManager>;
 
@@ -0,0 +1,311 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "storage/LocalIndexCache.h"
+
+#include <algorithm>
+#include <ctime>
+#include <memory>
+#include <utility>
+#include <boost/filesystem.hpp>
+
+#include "common/Common.h"
+#include "config/ConfigChunkManager.h"
+#include "exceptions/EasyAssert.h"
+#include "log/Log.h"
+#include "storage/Checksum.h"
+#include "storage/LocalChunkManager.h"
+#include "utils/Json.h"
+
+namespace milvus::storage {
+
+namespace {
+const char MANIFEST_SUFFIX[] = ".manifest";
+}  // namespace
+
+LocalIndexCache&
+LocalIndexCache::GetInstance() {
+    static LocalIndexCache instance;
+    static std::once_flag recovered;
+    std::call_once(recovered, [] {
+        instance.Recover(ChunkMangerConfig::GetLocalRootPath() + "/" +
+                         std::string(INDEX_ROOT_PATH));
+    });
+    return instance;
+}
+
+bool
+LocalIndexCache::Acquire(const std::string& dir,
+                         const std::vector<std::string>& remote_files) {
+    std::unique_lock lck(mutex_);
+    downloaded_.wait(lck, [&] {
+        auto it = entries_.find(dir);
+        return it == entries_.end() || it->second.complete;
+    });
+    auto it = entries_.find(dir);
+    if (it == entries_.end()) {
+        Adopt(dir);
+        it = entries_.find(dir);
+    }
+    if (it != entries_.end() && it->second.remote_files == remote_files) {
+        auto& entry = it->second;
+        if (entry.refs++ > 0) {
+            return true;
+        }
+        released_.erase(entry.released);
+        released_bytes_ -= entry.bytes;
+        in_use_bytes_ += entry.bytes;
+        if (entry.checksums.empty()) {
+            return true;
+        }
+        // a kept copy sat on disk unused, it is checked before it is
+        // reused; the ones acquiring it meanwhile wait as for a download
+        entry.complete = false;
+        auto checksums = entry.checksums;
+        lck.unlock();
+        auto intact = Verify(dir, checksums);
+        lck.lock();
+        it = entries_.find(dir);
+        if (intact) {
+            it->second.complete = true;
+            downloaded_.notify_all();
+            return true;
+        }
+        // still the only reference, the caller downloads them again
+        LOG_SEGCORE_WARNING_ << "local index files of " << dir
+                             << " are corrupted, downloading them again";
+        in_use_bytes_ -= it->second.bytes;
+        it->second.bytes = 0;
+        it->second.checksums.clear();
+        RemoveFiles(dir);
+        LocalChunkManager::GetInstance().CreateDir(dir);
+        return false;
+    }
+    if (it != entries_.end()) {
+        AssertInfo(it->second.refs == 0,
+                   "local index files of " + dir +
+                       " are in use by another version of the index");
+        released_.erase(it->second.released);
+        released_bytes_ -= it->second.bytes;
+        entries_.erase(it);
+    }
+
+    // files left without a manifest are not known to be complete
+    RemoveFiles(dir);
+    LocalChunkManager::GetInstance().CreateDir(dir);
+    auto& entry = entries_[dir];
+    entry.remote_files = remote_files;
+    entry.refs = 1;
+    return false;
+}
+
+void
+LocalIndexCache::Commit(const std::string& dir,
+                        std::unordered_map<std::string, uint32_t> checksums) {
+    std::lock_guard lck(mutex_);
+    auto it = entries_.find(dir);
+    AssertInfo(it != entries_.end(), "local index files not acquired: " + dir);
+    auto& entry = it->second;
+    auto& local_chunk_manager = LocalChunkManager::GetInstance();
+    entry.bytes = local_chunk_manager.GetSizeOfDir(dir);
+    entry.checksums = std::move(checksums);
+    entry.complete = true;
+    in_use_bytes_ += entry.bytes;
+
+    milvus::json manifest;
+    manifest["remote_files"] = entry.remote_files;
+    manifest["checksums"] = entry.checksums;
+    auto manifest_bytes = manifest.dump();
+    local_chunk_manager.Write(
+        ManifestPath(dir), manifest_bytes.data(), manifest_bytes.size());
+
+    // the kept copies make room for the new one
+    Evict(disk_index_local_cache_size);
+    downloaded_.notify_all();
+}
+
+void
+LocalIndexCache::Release(const std::string& dir) {
+    std::lock_guard lck(mutex_);
+    auto it = entries_.find(dir);
+    if (it == entries_.end() || --it->second.refs > 0) {
+        return;
+    }
+    auto& entry = it->second;
+    auto size = disk_index_local_cache_size;
+    if (entry.complete) {
+        in_use_bytes_ -= entry.bytes;
+    }
+    if (entry.complete && entry.bytes <= size) {
+        entry.released = released_.insert(released_.end(), dir);
+        released_bytes_ += entry.bytes;
+        Evict(size);
+    } else {
+        RemoveFiles(dir);
+        entries_.erase(it);
+    }
+    // a failed download leaves the directory to the next one waiting
+    downloaded_.notify_all();
+}
+
+void
+LocalIndexCache::Recover(const std::string& index_root) {
+    namespace fs = boost::filesystem;
+    // by the time they were committed, oldest first to be evicted first
+    std::vector<std::pair<std::time_t, std::string>> dirs;
+    try {
+        if (!fs::is_directory(index_root)) {
+            return;
+        }
+        // <index_root>/<build id>/<index version>.manifest
+        for (auto& build : fs::directory_iterator(index_root)) {
+            if (!fs::is_directory(build.path())) {
+                continue;
+            }
+            for (auto& file : fs::directory_iterator(build.path())) {
+                auto path = file.path();
+                if (path.extension() == MANIFEST_SUFFIX) {
+                    dirs.emplace_back(fs::last_write_time(path),
+                                      path.parent_path().string() + "/" +
+                                          path.stem().string() + "/");
+                }
+            }
+        }
+    } catch (std::exception& e) {
+        LOG_SEGCORE_WARNING_ << "failed to scan the local index files under "
+                             << index_root << ": " << e.what();
+    }
+    std::sort(dirs.begin(), dirs.end());
+
+    std::lock_guard lck(mutex_);
+    for (auto& [time, dir] : dirs) {
+        if (entries_.count(dir) == 0) {
+            Adopt(dir);
+        }
+    }
+    Evict(disk_index_local_cache_size);
+    LOG_SEGCORE_INFO_ << "recovered " << released_.size()
+                      << " local index directories, " << released_bytes_
+                      << " bytes";
+}
+
+bool
+LocalIndexCache::Contains(const std::string& dir) {
+    std::lock_guard lck(mutex_);
+    return entries_.count(dir) > 0;
+}
+
+int64_t
+LocalIndexCache::ReleasedBytes() {
+    std::lock_guard lck(mutex_);
+    return released_bytes_;
+}
+
+int64_t
+LocalIndexCache::InUseBytes() {
+    std::lock_guard lck(mutex_);
+    return in_use_bytes_;
+}
+
+std::string
+LocalIndexCache::ManifestPath(const std::string& dir) {
+    auto end = dir.find_last_not_of('/');
+    return dir.substr(0, end + 1) + MANIFEST_SUFFIX;
+}
+
+void
+LocalIndexCache::Adopt(const std::string& dir) {
+    auto& local_chunk_manager = LocalChunkManager::GetInstance();
+    auto manifest_path = ManifestPath(dir);
+    try {
+        if (!local_chunk_manager.Exist(manifest_path) ||
+            !local_chunk_manager.DirExist(dir)) {
+            return;
+        }
+        std::string manifest_bytes(local_chunk_manager.Size(manifest_path),
+                                   '\0');
+        local_chunk_manager.Read(
+            manifest_path, manifest_bytes.data(), manifest_bytes.size());
+        auto manifest = milvus::json::parse(manifest_bytes);
+        Entry entry;
+        entry.remote_files =
+            manifest["remote_files"].get<std::vector<std::string>>();
+        entry.checksums =
+            manifest["checksums"]
+                .get<std::unordered_map<std::string, uint32_t>>();
+        entry.bytes = local_chunk_manager.GetSizeOfDir(dir);
+        entry.complete = true;
+        entry.released = released_.insert(released_.end(), dir);
+        released_bytes_ += entry.bytes;
+        entries_.emplace(dir, std::move(entry));
+    } catch (std::exception& e) {
+        // Acquire removes the files of a directory it does not know
+        LOG_SEGCORE_WARNING_ << "failed to read the manifest of " << dir
+                             << ": " << e.what();
+    }
+}
+
+void
+LocalIndexCache::RemoveFiles(const std::string& dir) {
+    auto& local_chunk_manager = LocalChunkManager::GetInstance();
+    if (local_chunk_manager.DirExist(dir)) {
+        local_chunk_manager.RemoveDir(dir);
+    }
+    local_chunk_manager.Remove(ManifestPath(dir));
+}
+
+bool
+LocalIndexCache::Verify(
+    const std::string& dir,
+    const std::unordered_map<std::string, uint32_t>& checksums) {
+    auto& local_chunk_manager = LocalChunkManager::GetInstance();
+    const uint64_t buffer_size = 4 << 20;
+    auto buffer = std::make_unique<uint8_t[]>(buffer_size);
+    try {
+        for (auto& [file, checksum] : checksums) {
+            auto size = local_chunk_manager.Size(file);
+            uint32_t crc = 0;
+            for (uint64_t offset = 0; offset < size; offset += buffer_size) {
+                auto len = std::min(buffer_size, size - offset);
+                local_chunk_manager.Read(file, offset, buffer.get(), len);
+                crc = Crc32c(buffer.get(), len, crc);
+            }
+            if (crc != checksum) {
+                return false;
+            }
+        }
+    } catch (std::exception& e) {
+        LOG_SEGCORE_WARNING_ << "failed to check the local index files of "
+                             << dir << ": " << e.what();
+        return false;
+    }
+    return true;
+}
+
+void
+LocalIndexCache::Evict(int64_t size) {
+    while (!released_.empty() && released_bytes_ + in_use_bytes_ > size) {
+        auto dir = released_.front();
+        released_.pop_front();
+        auto it = entries_.find(dir);
+        released_bytes_ -= it->second.bytes;
+        entries_.erase(it);
+        RemoveFiles(dir);
+        LOG_SEGCORE_DEBUG_ << "evicted the local index files of " << dir;
+    }
+}
+
+}  // namespace milvus::storage
@@ -0,0 +1,122 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace milvus::storage {
+
+// the local directories the disk indexes loaded on this node were
+// downloaded into, reference counted by the loaded indexes. all of them
+// share disk_index_local_cache_size: the files of a released index stay
+// behind for a reload of the same index while the room is not needed by
+// the ones in use, the least recently released go first. a committed
+// directory leaves a manifest next to it, so its files are reused by a
+// later process too
+class LocalIndexCache {
+ public:
+    static LocalIndexCache&
+    GetInstance();
+
+    // takes a reference to dir; returns true if it holds a complete copy
+    // of remote_files, false if the caller has to download them into the
+    // emptied dir and Commit. waits for a download in flight into dir
+    bool
+    Acquire(const std::string& dir,
+            const std::vector<std::string>& remote_files);
+
+    // records dir as a complete copy of the remote_files it was acquired
+    // for; the files with a crc32c in checksums are checked against it
+    // before a kept copy is reused, a mismatch downloads them again
+    void
+    Commit(const std::string& dir,
+           std::unordered_map<std::string, uint32_t> checksums = {});
+
+    // drops a reference to dir, the last one keeps a complete copy while
+    // it fits and removes the files otherwise
+    void
+    Release(const std::string& dir);
+
+    // takes in the directories committed under index_root by an earlier
+    // process as released ones, evicting what does not fit
+    void
+    Recover(const std::string& index_root);
+
+    // whether dir is acquired or kept
+    bool
+    Contains(const std::string& dir);
+
+    // bytes of the copies kept after their release
+    int64_t
+    ReleasedBytes();
+
+    // bytes of the copies acquired
+    int64_t
+    InUseBytes();
+
+ private:
+    LocalIndexCache() = default;
+
+    struct Entry {
+        std::vector<std::string> remote_files;
+        int64_t refs = 0;
+        int64_t bytes = 0;
+        bool complete = false;
+        std::unordered_map<std::string, uint32_t> checksums;
+        // its place in released_ once refs dropped to 0
+        std::list<std::string>::iterator released;
+    };
+
+    // the manifest of dir, a file next to it
+    static std::string
+    ManifestPath(const std::string& dir);
+
+    // registers dir as released if its manifest is there
+    void
+    Adopt(const std::string& dir);
+
+    // removes dir and its manifest
+    static void
+    RemoveFiles(const std::string& dir);
+
+    // whether the files of dir still match their checksums
+    static bool
+    Verify(const std::string& dir,
+           const std::unordered_map<std::string, uint32_t>& checksums);
+
+    // removes kept copies, oldest release first, until the kept and the
+    // acquired ones fit the size
+    void
+    Evict(int64_t size);
+
+ private:
+    std::mutex mutex_;
+    std::condition_variable downloaded_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> released_;
+    int64_t released_bytes_ = 0;
+    // complete copies with references
+    int64_t in_use_bytes_ = 0;
+};
+
+}  // namespace milvus::storage
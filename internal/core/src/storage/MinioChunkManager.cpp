@@ -14,7 +14,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <aws/core/auth/AWSCredentials.h>
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 #include <aws/core/auth/STSCredentialsProvider.h>
@@ -26,8 +28,18 @@
 #include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
+#include <aws/core/utils/stream/PreallocatedStreamBuf.h>
+#include <aws/core/utils/threading/Executor.h>
 
 #include "storage/MinioChunkManager.h"
+#include "common/Common.h"
+#include "common/Consts.h"
+#include "common/Metrics.h"
+#include "storage/LocalChunkManager.h"
 #include "exceptions/EasyAssert.h"
 #include "log/Log.h"
 
@@ -43,6 +55,22 @@
 #define S3NoSuchBucket "NoSuchBucket"
 namespace milvus::storage {
 
+// the error of an async request, which is set on its future
+inline std::exception_ptr
+MakeS3Error(const char* function,
+            const std::string& object_name,
+            const Aws::S3::S3Error& err) {
+    if (err.GetErrorType() == Aws::S3::S3Errors::NO_SUCH_KEY ||
+        err.GetResponseCode() == Aws::Http::HttpResponseCode::NOT_FOUND) {
+        return std::make_exception_ptr(
+            ObjectNotExistException("object(" + object_name + ") not exists"));
+    }
+    std::stringstream err_msg;
+    err_msg << "Error:" << function << ":" << err.GetExceptionName() << "  "
+            << err.GetMessage();
+    return std::make_exception_ptr(S3ErrorException(err_msg.str()));
+}
+
 std::atomic<size_t> MinioChunkManager::init_count_(0);
 std::mutex MinioChunkManager::client_mutex_;
 
@@ -92,6 +120,9 @@ MinioChunkManager::MinioChunkManager(const StorageConfig& storage_config)
     InitSDKAPI();
     Aws::Client::ClientConfiguration config;
     config.endpointOverride = ConvertToAwsString(storage_config.address);
+    config.executor =
+        Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(
+            "MinioChunkManager", DEFAULT_REMOTE_ASYNC_THREAD_NUM);
 
     if (storage_config.useSSL) {
         config.scheme = Aws::Http::Scheme::HTTPS;
@@ -172,20 +203,194 @@ MinioChunkManager::ListWithPrefix(const std::string& filepath) {
 
 uint64_t
 MinioChunkManager::Read(const std::string& filepath, void* buf, uint64_t size) {
-    if (!ObjectExists(default_bucket_name_, filepath)) {
-        std::stringstream err_msg;
-        err_msg << "object('" << default_bucket_name_ << "', " << filepath
-                << "') not exists";
-        throw ObjectNotExistException(err_msg.str());
+    return GetObjectParts(default_bucket_name_, filepath, 0, buf, size);
+}
+
+uint64_t
+MinioChunkManager::Read(const std::string& filepath,
+                        uint64_t offset,
+                        void* buf,
+                        uint64_t size) {
+    return GetObjectParts(default_bucket_name_, filepath, offset, buf, size);
+}
+
+std::vector<uint8_t>
+MinioChunkManager::ReadAll(const std::string& filepath) {
+    // the first part tells the object size, so no HEAD request is needed
+    std::vector<uint8_t> buf(DEFAULT_REMOTE_READ_PART_SIZE);
+    uint64_t object_size = 0;
+    auto read_size = GetObjectBuffer(default_bucket_name_,
+                                     filepath,
+                                     0,
+                                     buf.data(),
+                                     buf.size(),
+                                     &object_size);
+    buf.resize(object_size);
+    if (object_size > read_size) {
+        GetObjectParts(default_bucket_name_,
+                       filepath,
+                       read_size,
+                       buf.data() + read_size,
+                       object_size - read_size);
     }
-    return GetObjectBuffer(default_bucket_name_, filepath, buf, size);
+    return buf;
 }
 
 void
 MinioChunkManager::Write(const std::string& filepath,
                          void* buf,
                          uint64_t size) {
-    PutObjectBuffer(default_bucket_name_, filepath, buf, size);
+    if (size <= uint64_t(remote_upload_part_size << 20)) {
+        PutObjectBuffer(default_bucket_name_, filepath, buf, size);
+        return;
+    }
+    PutObjectParts(default_bucket_name_,
+                   filepath,
+                   size,
+                   [buf](uint64_t offset, void* part, uint64_t len) {
+                       memcpy(part, static_cast<uint8_t*>(buf) + offset, len);
+                   });
+}
+
+std::future<uint64_t>
+MinioChunkManager::SizeAsync(const std::string& filepath) {
+    Aws::S3::Model::HeadObjectRequest request;
+    request.SetBucket(default_bucket_name_.c_str());
+    request.SetKey(filepath.c_str());
+
+    auto promise = std::make_shared<std::promise<uint64_t>>();
+    client_->HeadObjectAsync(
+        request,
+        [promise, filepath](
+            const Aws::S3::S3Client*,
+            const Aws::S3::Model::HeadObjectRequest&,
+            const Aws::S3::Model::HeadObjectOutcome& outcome,
+            const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
+            if (!outcome.IsSuccess()) {
+                promise->set_exception(MakeS3Error(
+                    "GetObjectSize", filepath, outcome.GetError()));
+                return;
+            }
+            promise->set_value(outcome.GetResult().GetContentLength());
+        });
+    return promise->get_future();
+}
+
+std::future<uint64_t>
+MinioChunkManager::ReadAsync(const std::string& filepath,
+                             uint64_t offset,
+                             void* buf,
+                             uint64_t size) {
+    auto promise = std::make_shared<std::promise<uint64_t>>();
+    auto future = promise->get_future();
+    if (size == 0) {
+        promise->set_value(0);
+        return future;
+    }
+    Aws::S3::Model::GetObjectRequest request;
+    request.SetBucket(default_bucket_name_.c_str());
+    request.SetKey(filepath.c_str());
+    request.SetRange(ConvertToAwsString("bytes=" + std::to_string(offset) +
+                                        "-" +
+                                        std::to_string(offset + size - 1)));
+    auto stream_buf =
+        std::make_shared<Aws::Utils::Stream::PreallocatedStreamBuf>(
+            reinterpret_cast<unsigned char*>(buf), size);
+    request.SetResponseStreamFactory([stream_buf]() {
+        return Aws::New<Aws::IOStream>("", stream_buf.get());
+    });
+
+    client_->GetObjectAsync(
+        request,
+        [promise,
+         stream_buf,
+         filepath,
+         start = std::chrono::steady_clock::now()](
+            const Aws::S3::S3Client*,
+            const Aws::S3::Model::GetObjectRequest&,
+            Aws::S3::Model::GetObjectOutcome outcome,
+            const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
+            if (!outcome.IsSuccess()) {
+                auto& err = outcome.GetError();
+                if (err.GetResponseCode() ==
+                    Aws::Http::HttpResponseCode::
+                        REQUESTED_RANGE_NOT_SATISFIABLE) {
+                    promise->set_value(0);
+                    return;
+                }
+                promise->set_exception(
+                    MakeS3Error("GetObjectBuffer", filepath, err));
+                return;
+            }
+            auto read_size = outcome.GetResult().GetContentLength();
+            SEGCORE_METRIC_OBSERVE(
+                RemoteReadLatency,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+            SEGCORE_METRIC_ADD(RemoteReadBytes, read_size);
+            promise->set_value(read_size);
+        });
+    return future;
+}
+
+std::future<void>
+MinioChunkManager::WriteAsync(const std::string& filepath,
+                              void* buf,
+                              uint64_t size) {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(default_bucket_name_.c_str());
+    request.SetKey(filepath.c_str());
+    auto stream_buf =
+        std::make_shared<Aws::Utils::Stream::PreallocatedStreamBuf>(
+            reinterpret_cast<unsigned char*>(buf), size);
+    request.SetBody(
+        Aws::MakeShared<Aws::IOStream>("MinioChunkManager", stream_buf.get()));
+    request.SetContentLength(size);
+
+    auto promise = std::make_shared<std::promise<void>>();
+    client_->PutObjectAsync(
+        request,
+        [promise,
+         stream_buf,
+         filepath,
+         size,
+         start = std::chrono::steady_clock::now()](
+            const Aws::S3::S3Client*,
+            const Aws::S3::Model::PutObjectRequest&,
+            const Aws::S3::Model::PutObjectOutcome& outcome,
+            const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
+            if (!outcome.IsSuccess()) {
+                promise->set_exception(MakeS3Error(
+                    "PutObjectBuffer", filepath, outcome.GetError()));
+                return;
+            }
+            SEGCORE_METRIC_OBSERVE(
+                RemoteWriteLatency,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+            SEGCORE_METRIC_ADD(RemoteWriteBytes, size);
+            promise->set_value();
+        });
+    return promise->get_future();
+}
+
+void
+MinioChunkManager::WriteFromLocalFile(const std::string& filepath,
+                                      const std::string& local_file) {
+    auto& local_chunk_manager = LocalChunkManager::GetInstance();
+    auto size = local_chunk_manager.Size(local_file);
+    auto read_part = [&](uint64_t offset, void* part, uint64_t len) {
+        local_chunk_manager.Read(local_file, offset, part, len);
+    };
+    if (size <= uint64_t(remote_upload_part_size << 20)) {
+        std::vector<uint8_t> buf(size);
+        read_part(0, buf.data(), size);
+        PutObjectBuffer(default_bucket_name_, filepath, buf.data(), size);
+        return;
+    }
+    PutObjectParts(default_bucket_name_, filepath, size, read_part);
 }
 
 bool
@@ -323,6 +528,7 @@ MinioChunkManager::PutObjectBuffer(const std::string& bucket_name,
                                    const std::string& object_name,
                                    void* buf,
                                    uint64_t size) {
+    SEGCORE_METRIC_TIMER(RemoteWriteLatency);
     Aws::S3::Model::PutObjectRequest request;
     request.SetBucket(bucket_name.c_str());
     request.SetKey(object_name.c_str());
@@ -338,33 +544,220 @@ MinioChunkManager::PutObjectBuffer(const std::string& bucket_name,
     if (!outcome.IsSuccess()) {
         THROWS3ERROR(PutObjectBuffer);
     }
+    SEGCORE_METRIC_ADD(RemoteWriteBytes, size);
     return true;
 }
 
+void
+MinioChunkManager::PutObjectParts(
+    const std::string& bucket_name,
+    const std::string& object_name,
+    uint64_t size,
+    const std::function<void(uint64_t, void*, uint64_t)>& read_part) {
+    // S3 takes at most 10000 parts
+    const uint64_t part_size =
+        std::max(uint64_t(remote_upload_part_size << 20),
+                 (size + 9999) / 10000);
+    const uint64_t parallel_degree =
+        std::max(remote_upload_parallel_degree, int64_t(1));
+
+    Aws::S3::Model::CreateMultipartUploadRequest create_request;
+    create_request.SetBucket(bucket_name.c_str());
+    create_request.SetKey(object_name.c_str());
+    auto create_outcome = client_->CreateMultipartUpload(create_request);
+    if (!create_outcome.IsSuccess()) {
+        auto& outcome = create_outcome;
+        THROWS3ERROR(CreateMultipartUpload);
+    }
+    auto upload_id = create_outcome.GetResult().GetUploadId();
+
+    auto upload_part = [&](int part_number, uint64_t offset, uint64_t len) {
+        auto start = std::chrono::steady_clock::now();
+        const std::shared_ptr<Aws::IOStream> input_data =
+            Aws::MakeShared<Aws::StringStream>("");
+        {
+            std::vector<char> part(len);
+            read_part(offset, part.data(), len);
+            input_data->write(part.data(), len);
+        }
+        Aws::S3::Model::UploadPartRequest request;
+        request.SetBucket(bucket_name.c_str());
+        request.SetKey(object_name.c_str());
+        request.SetUploadId(upload_id);
+        request.SetPartNumber(part_number);
+        request.SetContentLength(len);
+        request.SetBody(input_data);
+
+        auto outcome = client_->UploadPart(request);
+        if (!outcome.IsSuccess()) {
+            THROWS3ERROR(UploadPart);
+        }
+        auto cost = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+        SEGCORE_METRIC_OBSERVE(RemoteWriteLatency, cost);
+        SEGCORE_METRIC_ADD(RemoteWriteBytes, len);
+        LOG_SEGCORE_DEBUG_ << "upload part " << part_number << " of object('"
+                           << bucket_name << "', " << object_name << ") cost "
+                           << cost << "us";
+        Aws::S3::Model::CompletedPart completed_part;
+        completed_part.SetPartNumber(part_number);
+        completed_part.SetETag(outcome.GetResult().GetETag());
+        return completed_part;
+    };
+
+    Aws::S3::Model::CompletedMultipartUpload completed_upload;
+    try {
+        const uint64_t wave_size = part_size * parallel_degree;
+        int part_number = 1;
+        for (uint64_t wave = 0; wave < size; wave += wave_size) {
+            std::vector<std::future<Aws::S3::Model::CompletedPart>> futures;
+            for (auto pos = wave; pos < std::min(size, wave + wave_size);
+                 pos += part_size) {
+                futures.push_back(std::async(std::launch::async,
+                                             upload_part,
+                                             part_number++,
+                                             pos,
+                                             std::min(part_size, size - pos)));
+            }
+            // wait for every part of the wave before rethrowing, the parts
+            // still reference this frame
+            std::exception_ptr error = nullptr;
+            for (auto& future : futures) {
+                try {
+                    completed_upload.AddParts(future.get());
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+            if (error != nullptr) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        Aws::S3::Model::CompleteMultipartUploadRequest request;
+        request.SetBucket(bucket_name.c_str());
+        request.SetKey(object_name.c_str());
+        request.SetUploadId(upload_id);
+        request.SetMultipartUpload(completed_upload);
+        auto outcome = client_->CompleteMultipartUpload(request);
+        if (!outcome.IsSuccess()) {
+            THROWS3ERROR(CompleteMultipartUpload);
+        }
+    } catch (...) {
+        // the uploaded parts are kept, and billed, until the upload is aborted
+        Aws::S3::Model::AbortMultipartUploadRequest request;
+        request.SetBucket(bucket_name.c_str());
+        request.SetKey(object_name.c_str());
+        request.SetUploadId(upload_id);
+        auto outcome = client_->AbortMultipartUpload(request);
+        if (!outcome.IsSuccess()) {
+            LOG_SEGCORE_ERROR_C << "failed to abort multipart upload of "
+                                << "object('" << bucket_name << "', "
+                                << object_name << "'): "
+                                << outcome.GetError().GetMessage();
+        }
+        throw;
+    }
+}
+
 uint64_t
 MinioChunkManager::GetObjectBuffer(const std::string& bucket_name,
                                    const std::string& object_name,
+                                   uint64_t offset,
                                    void* buf,
-                                   uint64_t size) {
+                                   uint64_t size,
+                                   uint64_t* object_size) {
+    if (size == 0) {
+        return 0;
+    }
+    auto start = std::chrono::steady_clock::now();
     Aws::S3::Model::GetObjectRequest request;
     request.SetBucket(bucket_name.c_str());
     request.SetKey(object_name.c_str());
+    request.SetRange(ConvertToAwsString("bytes=" + std::to_string(offset) +
+                                        "-" +
+                                        std::to_string(offset + size - 1)));
+    // the body is received straight into buf
+    Aws::Utils::Stream::PreallocatedStreamBuf stream_buf(
+        reinterpret_cast<unsigned char*>(buf), size);
+    request.SetResponseStreamFactory(
+        [&stream_buf]() { return Aws::New<Aws::IOStream>("", &stream_buf); });
 
     auto outcome = client_->GetObject(request);
 
     if (!outcome.IsSuccess()) {
+        auto& err = outcome.GetError();
+        if (err.GetErrorType() == Aws::S3::S3Errors::NO_SUCH_KEY) {
+            std::stringstream err_msg;
+            err_msg << "object('" << bucket_name << "', " << object_name
+                    << "') not exists";
+            throw ObjectNotExistException(err_msg.str());
+        }
+        // the range starts at or past the end of the object
+        if (err.GetResponseCode() ==
+            Aws::Http::HttpResponseCode::REQUESTED_RANGE_NOT_SATISFIABLE) {
+            if (object_size != nullptr) {
+                *object_size = offset;
+            }
+            return 0;
+        }
         THROWS3ERROR(GetObjectBuffer);
     }
-    std::stringstream ss;
-    ss << outcome.GetResultWithOwnership().GetBody().rdbuf();
-    uint64_t realSize = size;
-    if (ss.str().size() <= size) {
-        memcpy(buf, ss.str().data(), ss.str().size());
-        realSize = ss.str().size();
-    } else {
-        memcpy(buf, ss.str().data(), size);
+    auto& result = outcome.GetResult();
+    uint64_t read_size = result.GetContentLength();
+    if (object_size != nullptr) {
+        // Content-Range: bytes <first>-<last>/<object size>
+        auto content_range = ConvertFromAwsString(result.GetContentRange());
+        auto pos = content_range.find_last_of('/');
+        *object_size = pos == std::string::npos
+                           ? offset + read_size
+                           : std::stoull(content_range.substr(pos + 1));
+    }
+
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    SEGCORE_METRIC_OBSERVE(RemoteReadLatency, cost);
+    SEGCORE_METRIC_ADD(RemoteReadBytes, read_size);
+    LOG_SEGCORE_DEBUG_ << "get object('" << bucket_name << "', "
+                       << object_name << ") range [" << offset << ", "
+                       << offset + read_size << ") cost " << cost << "us";
+    return read_size;
+}
+
+uint64_t
+MinioChunkManager::GetObjectParts(const std::string& bucket_name,
+                                  const std::string& object_name,
+                                  uint64_t offset,
+                                  void* buf,
+                                  uint64_t size) {
+    const uint64_t part_size = DEFAULT_REMOTE_READ_PART_SIZE;
+    if (size <= part_size) {
+        return GetObjectBuffer(bucket_name, object_name, offset, buf, size);
+    }
+
+    // the parts get their own threads, as the callers already run on the
+    // storage thread pool
+    uint64_t read_size = 0;
+    const uint64_t wave_size = part_size * DEFAULT_REMOTE_READ_PARALLEL_DEGREE;
+    for (uint64_t wave = 0; wave < size; wave += wave_size) {
+        std::vector<std::future<uint64_t>> futures;
+        for (auto pos = wave; pos < std::min(size, wave + wave_size);
+             pos += part_size) {
+            futures.push_back(std::async(std::launch::async, [=]() {
+                return GetObjectBuffer(bucket_name,
+                                       object_name,
+                                       offset + pos,
+                                       static_cast<uint8_t*>(buf) + pos,
+                                       std::min(part_size, size - pos));
+            }));
+        }
+        for (auto& future : futures) {
+            read_size += future.get();
+        }
     }
-    return realSize;
+    return read_size;
 }
 
 std::vector<std::string>
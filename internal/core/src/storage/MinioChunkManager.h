@@ -18,6 +18,7 @@
 
 #include <aws/core/Aws.h>
 #include <aws/s3/S3Client.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -54,10 +55,7 @@ class MinioChunkManager : public RemoteChunkManager {
     Read(const std::string& filepath,
          uint64_t offset,
          void* buf,
-         uint64_t len) {
-        throw NotImplementedException(GetName() +
-                                      "Read with offset not implement");
-    }
+         uint64_t len);
 
     virtual void
     Write(const std::string& filepath,
@@ -74,6 +72,28 @@ class MinioChunkManager : public RemoteChunkManager {
     virtual void
     Write(const std::string& filepath, void* buf, uint64_t len);
 
+    virtual std::vector<uint8_t>
+    ReadAll(const std::string& filepath);
+
+    // the async requests queue on a pool of DEFAULT_REMOTE_ASYNC_THREAD_NUM
+    // threads shared by the client rather than taking a thread each
+    virtual std::future<uint64_t>
+    SizeAsync(const std::string& filepath);
+
+    virtual std::future<uint64_t>
+    ReadAsync(const std::string& filepath,
+              uint64_t offset,
+              void* buf,
+              uint64_t len);
+
+    virtual std::future<void>
+    WriteAsync(const std::string& filepath, void* buf, uint64_t len);
+
+    // streams the file from the local disk, a part at a time
+    virtual void
+    WriteFromLocalFile(const std::string& filepath,
+                       const std::string& local_file);
+
     virtual std::vector<std::string>
     ListWithPrefix(const std::string& filepath);
 
@@ -122,11 +142,29 @@ class MinioChunkManager : public RemoteChunkManager {
                     const std::string& object_name,
                     void* buf,
                     uint64_t size);
+    // one ranged GET, object_size is set to the size of the whole object
     uint64_t
     GetObjectBuffer(const std::string& bucket_name,
                     const std::string& object_name,
+                    uint64_t offset,
                     void* buf,
-                    uint64_t size);
+                    uint64_t size,
+                    uint64_t* object_size = nullptr);
+    // ranged GETs of DEFAULT_REMOTE_READ_PART_SIZE issued in parallel
+    // multipart upload of size bytes, the body of each part is copied into
+    // its buffer by read_part(offset, buf, len); aborted if a part fails
+    void
+    PutObjectParts(
+        const std::string& bucket_name,
+        const std::string& object_name,
+        uint64_t size,
+        const std::function<void(uint64_t, void*, uint64_t)>& read_part);
+    uint64_t
+    GetObjectParts(const std::string& bucket_name,
+                   const std::string& object_name,
+                   uint64_t offset,
+                   void* buf,
+                   uint64_t size);
     std::vector<std::string>
     ListObjects(const char* bucket_name, const char* prefix = NULL);
     void
@@ -14,8 +14,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "storage/PayloadReader.h"
 #include "exceptions/EasyAssert.h"
+#include "parquet/properties.h"
 
 namespace milvus::storage {
 PayloadReader::PayloadReader(std::shared_ptr<PayloadInputStream> input,
@@ -65,6 +68,14 @@ PayloadReader::get_one_string_Payload(int idx,
     return field_data_->get_one_string_payload(idx, cstr, str_size);
 }
 
+void
+PayloadReader::get_string_payload(const char** data,
+                                  const int32_t** offsets,
+                                  int* rows) const {
+    AssertInfo(field_data_ != nullptr, "empty payload");
+    field_data_->get_string_payload(data, offsets, rows);
+}
+
 std::unique_ptr<Payload>
 PayloadReader::get_payload() const {
     AssertInfo(field_data_ != nullptr, "empty payload");
@@ -77,4 +88,46 @@ PayloadReader::get_payload_length() const {
     return field_data_->get_payload_length();
 }
 
+void
+ReadPayloadBatches(std::shared_ptr<arrow::io::RandomAccessFile> input,
+                   DataType data_type,
+                   int64_t batch_bytes,
+                   const std::function<void(const Payload&)>& consumer) {
+    // buffered column chunk streams keep the ranged reads page sized
+    // instead of pulling a whole column chunk per row group
+    auto properties = parquet::default_reader_properties();
+    properties.enable_buffered_stream();
+    parquet::arrow::FileReaderBuilder builder;
+    auto st = builder.Open(input, properties);
+    AssertInfo(st.ok(), "failed to open parquet payload: " + st.ToString());
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    st = builder.memory_pool(arrow::default_memory_pool())->Build(&reader);
+    AssertInfo(st.ok(), "failed to get arrow file reader");
+
+    auto schema = reader->parquet_reader()->metadata()->schema();
+    AssertInfo(schema->num_columns() == 1,
+               "payload should contain exactly one column");
+    auto type_length = schema->Column(0)->type_length();
+    auto row_size = type_length > 0 ? type_length : int64_t(sizeof(int64_t));
+    reader->set_batch_size(std::max(batch_bytes / row_size, int64_t(1)));
+
+    std::vector<int> row_groups;
+    for (int i = 0; i < reader->num_row_groups(); ++i) {
+        row_groups.push_back(i);
+    }
+    std::unique_ptr<arrow::RecordBatchReader> batch_reader;
+    st = reader->GetRecordBatchReader(row_groups, &batch_reader);
+    AssertInfo(st.ok(), "failed to get record batch reader");
+    while (true) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        st = batch_reader->ReadNext(&batch);
+        AssertInfo(st.ok(), "failed to read record batch: " + st.ToString());
+        if (batch == nullptr) {
+            break;
+        }
+        FieldData field_data(batch->column(0), data_type);
+        consumer(*field_data.get_payload());
+    }
+}
+
 }  // namespace milvus::storage
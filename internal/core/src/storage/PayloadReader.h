@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <parquet/arrow/reader.h>
 
@@ -42,6 +43,12 @@ class PayloadReader {
     void
     get_one_string_Payload(int idx, char** cstr, int* str_size) const;
 
+    // a view of all the strings, valid while the reader lives
+    void
+    get_string_payload(const char** data,
+                       const int32_t** offsets,
+                       int* rows) const;
+
     std::unique_ptr<Payload>
     get_payload() const;
 
@@ -58,4 +65,13 @@ class PayloadReader {
     std::shared_ptr<FieldData> field_data_;
 };
 
+// decode the parquet payload behind input record batch by record batch, a
+// batch holds about batch_bytes of values and is dropped once consumer
+// returns, so the whole column is never materialized at once
+void
+ReadPayloadBatches(std::shared_ptr<arrow::io::RandomAccessFile> input,
+                   DataType data_type,
+                   int64_t batch_bytes,
+                   const std::function<void(const Payload&)>& consumer);
+
 }  // namespace milvus::storage
@@ -14,6 +14,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "arrow/api.h"
 
 #include "storage/PayloadStream.h"
@@ -21,9 +23,12 @@
 
 namespace milvus::storage {
 
-PayloadOutputStream::PayloadOutputStream() {
-    buffer_.reserve(1024 * 1024);
-    closed_ = false;
+PayloadOutputStream::PayloadOutputStream()
+    : buffer_(&own_buffer_), start_(0), closed_(false) {
+}
+
+PayloadOutputStream::PayloadOutputStream(std::vector<uint8_t>* buffer)
+    : buffer_(buffer), start_(buffer->size()), closed_(false) {
 }
 
 PayloadOutputStream::~PayloadOutputStream() noexcept {
@@ -37,7 +42,7 @@ PayloadOutputStream::Close() {
 
 arrow::Result<int64_t>
 PayloadOutputStream::Tell() const {
-    return arrow::Result<int64_t>(buffer_.size());
+    return arrow::Result<int64_t>(buffer_->size() - start_);
 }
 
 bool
@@ -49,9 +54,8 @@ arrow::Status
 PayloadOutputStream::Write(const void* data, int64_t nbytes) {
     if (nbytes <= 0)
         return arrow::Status::OK();
-    auto size = buffer_.size();
-    buffer_.resize(size + nbytes);
-    std::memcpy(buffer_.data() + size, data, nbytes);
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    buffer_->insert(buffer_->end(), bytes, bytes + nbytes);
     return arrow::Status::OK();
 }
 
@@ -62,7 +66,12 @@ PayloadOutputStream::Flush() {
 
 const std::vector<uint8_t>&
 PayloadOutputStream::Buffer() const {
-    return buffer_;
+    return *buffer_;
+}
+
+void
+PayloadOutputStream::Reserve(int64_t nbytes) {
+    buffer_->reserve(buffer_->size() + nbytes);
 }
 
 PayloadInputStream::PayloadInputStream(const uint8_t* data, int64_t size)
@@ -121,4 +130,93 @@ PayloadInputStream::GetSize() {
     return arrow::Result<int64_t>(size_);
 }
 
+RemotePayloadInputStream::RemotePayloadInputStream(
+    ChunkManager* chunk_manager,
+    const std::string& filepath,
+    int64_t offset,
+    int64_t size)
+    : chunk_manager_(chunk_manager),
+      filepath_(filepath),
+      offset_(offset),
+      size_(size),
+      tell_(0),
+      closed_(false) {
+}
+
+RemotePayloadInputStream::~RemotePayloadInputStream() noexcept {
+}
+
+arrow::Status
+RemotePayloadInputStream::Close() {
+    closed_ = true;
+    return arrow::Status::OK();
+}
+
+bool
+RemotePayloadInputStream::closed() const {
+    return closed_;
+}
+
+arrow::Result<int64_t>
+RemotePayloadInputStream::Tell() const {
+    return arrow::Result<int64_t>(tell_);
+}
+
+arrow::Status
+RemotePayloadInputStream::Seek(int64_t position) {
+    if (position < 0 || position >= size_)
+        return arrow::Status::IOError("invalid position");
+    tell_ = position;
+    return arrow::Status::OK();
+}
+
+arrow::Result<int64_t>
+RemotePayloadInputStream::Read(int64_t nbytes, void* out) {
+    ARROW_ASSIGN_OR_RAISE(auto read_size, ReadAt(tell_, nbytes, out));
+    tell_ += read_size;
+    return arrow::Result<int64_t>(read_size);
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+RemotePayloadInputStream::Read(int64_t nbytes) {
+    ARROW_ASSIGN_OR_RAISE(auto buf, ReadAt(tell_, nbytes));
+    tell_ += buf->size();
+    return arrow::Result<std::shared_ptr<arrow::Buffer>>(buf);
+}
+
+arrow::Result<int64_t>
+RemotePayloadInputStream::ReadAt(int64_t position,
+                                 int64_t nbytes,
+                                 void* out) {
+    auto remain = size_ - position;
+    if (nbytes > remain)
+        nbytes = remain;
+    if (nbytes <= 0)
+        return arrow::Result<int64_t>(0);
+    try {
+        auto read_size =
+            chunk_manager_->Read(filepath_, offset_ + position, out, nbytes);
+        return arrow::Result<int64_t>(read_size);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+RemotePayloadInputStream::ReadAt(int64_t position, int64_t nbytes) {
+    auto remain = std::max(size_ - position, int64_t(0));
+    ARROW_ASSIGN_OR_RAISE(auto buf,
+                          arrow::AllocateResizableBuffer(
+                              std::min(nbytes, remain)));
+    ARROW_ASSIGN_OR_RAISE(auto read_size,
+                          ReadAt(position, buf->size(), buf->mutable_data()));
+    ARROW_RETURN_NOT_OK(buf->Resize(read_size));
+    return arrow::Result<std::shared_ptr<arrow::Buffer>>(std::move(buf));
+}
+
+arrow::Result<int64_t>
+RemotePayloadInputStream::GetSize() {
+    return arrow::Result<int64_t>(size_);
+}
+
 }  // namespace milvus::storage
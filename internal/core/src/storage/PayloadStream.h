@@ -18,10 +18,12 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 #include <arrow/api.h>
 #include <arrow/io/api.h>
 
+#include "storage/ChunkManager.h"
 #include "storage/Types.h"
 
 namespace milvus::storage {
@@ -39,6 +41,8 @@ struct Payload {
 class PayloadOutputStream : public arrow::io::OutputStream {
  public:
     PayloadOutputStream();
+    // append to the end of buffer, Tell() counts from where it started
+    explicit PayloadOutputStream(std::vector<uint8_t>* buffer);
     ~PayloadOutputStream() noexcept;
 
     arrow::Status
@@ -56,8 +60,13 @@ class PayloadOutputStream : public arrow::io::OutputStream {
     const std::vector<uint8_t>&
     Buffer() const;
 
+    void
+    Reserve(int64_t nbytes);
+
  private:
-    std::vector<uint8_t> buffer_;
+    std::vector<uint8_t> own_buffer_;
+    std::vector<uint8_t>* buffer_;
+    size_t start_;
     bool closed_;
 };
 
@@ -88,4 +97,48 @@ class PayloadInputStream : public arrow::io::RandomAccessFile {
     bool closed_;
 };
 
+// presents [offset, offset + size) of a remote file as a stream, every
+// read is a ranged read of just the bytes asked for
+class RemotePayloadInputStream : public arrow::io::RandomAccessFile {
+ public:
+    RemotePayloadInputStream(ChunkManager* chunk_manager,
+                             const std::string& filepath,
+                             int64_t offset,
+                             int64_t size);
+    ~RemotePayloadInputStream() noexcept;
+
+    arrow::Status
+    Close() override;
+    arrow::Result<int64_t>
+    Tell() const override;
+    bool
+    closed() const override;
+    arrow::Status
+    Seek(int64_t position) override;
+    arrow::Result<int64_t>
+    Read(int64_t nbytes, void* out) override;
+    arrow::Result<std::shared_ptr<arrow::Buffer>>
+    Read(int64_t nbytes) override;
+    arrow::Result<int64_t>
+    ReadAt(int64_t position, int64_t nbytes, void* out) override;
+    arrow::Result<std::shared_ptr<arrow::Buffer>>
+    ReadAt(int64_t position, int64_t nbytes) override;
+    arrow::Result<int64_t>
+    GetSize() override;
+
+    // where the stream starts in the file
+    int64_t
+    offset() const {
+        return offset_;
+    }
+
+ private:
+    ChunkManager* chunk_manager_;
+    const std::string filepath_;
+    const int64_t offset_;
+    const int64_t size_;
+    int64_t tell_;
+    bool closed_;
+};
+
 }  // namespace milvus::storage
@@ -14,23 +14,48 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+
 #include "storage/PayloadWriter.h"
 #include "exceptions/EasyAssert.h"
+#include "common/Common.h"
 #include "common/FieldMeta.h"
+#include "log/Log.h"
 #include "storage/Util.h"
+#include "arrow/util/byte_size.h"
+#include "arrow/util/compression.h"
 
 namespace milvus::storage {
 
+PayloadWriteOptions
+GetPayloadWriteOptions(DataType data_type) {
+    auto is_vector = milvus::datatype_is_vector(data_type);
+    auto& codec =
+        is_vector ? vector_payload_compression : scalar_payload_compression;
+    auto compression = arrow::util::Codec::GetCompressionType(codec);
+    AssertInfo(compression.ok(), "unknown payload compression: " + codec);
+    AssertInfo(arrow::util::Codec::IsAvailable(*compression),
+               "payload compression " + codec + " is not built in");
+    auto level = is_vector ? vector_payload_compression_level
+                           : scalar_payload_compression_level;
+    auto byte_stream_split =
+        float_byte_stream_split &&
+        (data_type == DataType::FLOAT || data_type == DataType::DOUBLE);
+    return PayloadWriteOptions{*compression, level, byte_stream_split};
+}
+
 // create payload writer for numeric data type
 PayloadWriter::PayloadWriter(const DataType column_type)
-    : column_type_(column_type) {
+    : column_type_(column_type),
+      options_(GetPayloadWriteOptions(column_type)) {
     builder_ = CreateArrowBuilder(column_type);
     schema_ = CreateArrowSchema(column_type);
 }
 
 // create payload writer for vector data type
 PayloadWriter::PayloadWriter(const DataType column_type, int dim)
-    : column_type_(column_type) {
+    : column_type_(column_type),
+      options_(GetPayloadWriteOptions(column_type)) {
     init_dimension(dim);
 }
 
@@ -55,6 +80,16 @@ PayloadWriter::add_one_string_payload(const char* str, int str_size) {
     rows_.fetch_add(1);
 }
 
+void
+PayloadWriter::add_string_payload(const char* data,
+                                  const int32_t* offsets,
+                                  int rows) {
+    AssertInfo(output_ == nullptr, "payload writer has been finished");
+    AssertInfo(milvus::datatype_is_string(column_type_), "mismatch data type");
+    AddStringsToArrowBuilder(builder_, data, offsets, rows);
+    rows_.fetch_add(rows);
+}
+
 void
 PayloadWriter::add_payload(const Payload& raw_data) {
     AssertInfo(output_ == nullptr, "payload writer has been finished");
@@ -70,24 +105,57 @@ PayloadWriter::add_payload(const Payload& raw_data) {
 }
 
 void
-PayloadWriter::finish() {
+PayloadWriter::finish(std::vector<uint8_t>* buffer) {
     AssertInfo(output_ == nullptr, "payload writer has been finished");
+    auto start = std::chrono::steady_clock::now();
     std::shared_ptr<arrow::Array> array;
     auto ast = builder_->Finish(&array);
     AssertInfo(ast.ok(), ast.ToString());
 
     auto table = arrow::Table::Make(schema_, {array});
-    output_ = std::make_shared<storage::PayloadOutputStream>();
+    if (buffer != nullptr) {
+        output_ = std::make_shared<storage::PayloadOutputStream>(buffer);
+    } else {
+        output_ = std::make_shared<storage::PayloadOutputStream>();
+    }
+    // compressed output rarely outgrows the raw values plus a page of
+    // metadata, so one reservation saves regrowing the buffer as it fills
+    stats_.raw_size = arrow::util::TotalBufferSize(*array->data());
+    output_->Reserve(stats_.raw_size + 4096);
+
+    parquet::WriterProperties::Builder properties;
+    properties.compression(options_.compression);
+    if (arrow::util::Codec::SupportsCompressionLevel(options_.compression)) {
+        properties.compression_level(options_.compression_level);
+    }
+    if (options_.byte_stream_split) {
+        // dictionary encoding would take precedence over the column encoding
+        properties.disable_dictionary()->encoding(
+            parquet::Encoding::BYTE_STREAM_SPLIT);
+    }
     auto mem_pool = arrow::default_memory_pool();
     ast = parquet::arrow::WriteTable(*table,
                                      mem_pool,
                                      output_,
                                      1024 * 1024 * 1024,
-                                     parquet::WriterProperties::Builder()
-                                         .compression(arrow::Compression::ZSTD)
-                                         ->compression_level(3)
-                                         ->build());
+                                     properties.build());
     AssertInfo(ast.ok(), ast.ToString());
+
+    stats_.encoded_size = output_->Tell().ValueOrDie();
+    stats_.encode_time_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    LOG_SEGCORE_DEBUG_ << "write payload of " << rows_.load() << " rows, "
+                       << stats_.raw_size << " -> " << stats_.encoded_size
+                       << " bytes (ratio " << stats_.compression_ratio()
+                       << ") in " << stats_.encode_time_us << "us";
+}
+
+void
+PayloadWriter::set_write_options(const PayloadWriteOptions& options) {
+    AssertInfo(output_ == nullptr, "payload writer has been finished");
+    options_ = options;
 }
 
 bool
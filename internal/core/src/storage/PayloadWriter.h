@@ -23,6 +23,28 @@
 #include <parquet/arrow/writer.h>
 
 namespace milvus::storage {
+
+struct PayloadWriteOptions {
+    arrow::Compression::type compression;
+    int compression_level;
+    bool byte_stream_split;
+};
+
+// the configured options for payloads of data_type
+PayloadWriteOptions
+GetPayloadWriteOptions(DataType data_type);
+
+struct PayloadWriterStats {
+    int64_t raw_size = 0;
+    int64_t encoded_size = 0;
+    int64_t encode_time_us = 0;
+
+    double
+    compression_ratio() const {
+        return encoded_size > 0 ? double(raw_size) / encoded_size : 0;
+    }
+};
+
 class PayloadWriter {
  public:
     explicit PayloadWriter(const DataType column_type);
@@ -35,8 +57,15 @@ class PayloadWriter {
     void
     add_one_string_payload(const char* str, int str_size);
 
+    // rows strings in one buffer, arrow style: row i is data[offsets[i]]
+    // up to data[offsets[i + 1]]
+    void
+    add_string_payload(const char* data, const int32_t* offsets, int rows);
+
+    // buffer, if given, gets the parquet bytes appended to it instead of a
+    // buffer owned by the writer, get_payload_buffer then returns buffer
     void
-    finish();
+    finish(std::vector<uint8_t>* buffer = nullptr);
 
     bool
     has_finished();
@@ -49,6 +78,15 @@ class PayloadWriter {
         return rows_;
     }
 
+    // override the configured options, e.g. for a single field
+    void
+    set_write_options(const PayloadWriteOptions& options);
+
+    const PayloadWriterStats&
+    get_stats() const {
+        return stats_;
+    }
+
  private:
     void
     init_dimension(int dim);
@@ -60,5 +98,7 @@ class PayloadWriter {
     std::shared_ptr<PayloadOutputStream> output_;
     std::atomic<int> rows_ = 0;
     std::optional<int> dimension_;  // binary vector, float vector
+    PayloadWriteOptions options_;
+    PayloadWriterStats stats_;
 };
 }  // namespace milvus::storage
@@ -14,25 +14,180 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include "ThreadPool.h"
+#include "exceptions/EasyAssert.h"
 
 namespace milvus {
 
+namespace {
+// the pool and queue of the worker running on this thread, if any
+thread_local ThreadPool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+}  // namespace
+
+ThreadPool&
+ThreadPool::GetInstance(ThreadPoolType type) {
+    switch (type) {
+        case ThreadPoolType::QUERY: {
+            static ThreadPool pool(query_thread_core_coefficient, "query");
+            return pool;
+        }
+        case ThreadPoolType::LOAD: {
+            static ThreadPool pool(thread_core_coefficient, "load");
+            return pool;
+        }
+        case ThreadPoolType::INDEX_BUILD: {
+            static ThreadPool pool(build_thread_core_coefficient, "build", 10);
+            return pool;
+        }
+        case ThreadPoolType::COMPACTION: {
+            static ThreadPool pool(
+                compaction_thread_core_coefficient, "compaction", 10);
+            return pool;
+        }
+        case ThreadPoolType::PREFETCH: {
+            static ThreadPool pool(1, "prefetch", 10, true);
+            return pool;
+        }
+        default:
+            PanicInfo("unsupported thread pool type");
+    }
+}
+
+ThreadPool&
+ThreadPool::GetNumaQueryInstance(int node) {
+    static const std::vector<std::unique_ptr<ThreadPool>> pools = [] {
+        auto& nodes = NumaNodes();
+        std::vector<std::unique_ptr<ThreadPool>> pools(
+            *std::max_element(nodes.begin(), nodes.end()) + 1);
+        for (auto node : nodes) {
+            pools[node] = std::make_unique<ThreadPool>(
+                query_thread_core_coefficient,
+                "query-node" + std::to_string(node),
+                0,
+                false,
+                NumaNodeCpus(node));
+        }
+        return pools;
+    }();
+    AssertInfo(node >= 0 && node < pools.size() && pools[node] != nullptr,
+               "unknown numa node " + std::to_string(node));
+    return *pools[node];
+}
+
 void
 ThreadPool::Init() {
-    for (int i = 0; i < threads_.size(); i++) {
-        threads_[i] = std::thread(Worker(this, i));
+    for (size_t i = 0; i < threads_.size(); i++) {
+        threads_[i] = std::thread([this, i] { Work(i); });
     }
 }
 
 void
 ThreadPool::ShutDown() {
-    shutdown_ = true;
-    condition_lock_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        shutdown_ = true;
+    }
+    idle_cond_.notify_all();
     for (int i = 0; i < threads_.size(); i++) {
         if (threads_[i].joinable()) {
             threads_[i].join();
         }
     }
 }
-};  // namespace milvus
+
+void
+ThreadPool::Push(PoolTask&& task) {
+    auto id = current_pool == this ? current_queue
+                                   : next_queue_++ % queues_.size();
+    task.enqueue_time = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(queues_[id].mutex);
+        queues_[id].tasks.push_back(std::move(task));
+    }
+    pending_++;
+    // a worker going idle registers before it checks pending_, so either
+    // it sees this task or it is counted here and gets woken up
+    if (idle_workers_ > 0) {
+        { std::lock_guard<std::mutex> lock(idle_mutex_); }
+        idle_cond_.notify_one();
+    }
+}
+
+ThreadPoolStats
+ThreadPool::GetStats() const {
+    auto finished = finished_tasks_.load();
+    return ThreadPoolStats{name_,
+                           int64_t(threads_.size()),
+                           std::max(pending_.load(), int64_t(0)),
+                           finished,
+                           finished > 0 ? total_wait_us_ / finished : 0};
+}
+
+bool
+ThreadPool::Pop(size_t id, PoolTask& task) {
+    for (size_t i = 0; i < queues_.size(); i++) {
+        auto& queue = queues_[(id + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        } else {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        pending_--;
+        return true;
+    }
+    return false;
+}
+
+void
+ThreadPool::Work(size_t id) {
+    current_pool = this;
+    current_queue = id;
+    if (nice_ != 0) {
+        // on linux the priority of a thread id only affects that thread
+        setpriority(PRIO_PROCESS, syscall(SYS_gettid), nice_);
+    }
+    if (!cpus_.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (auto cpu : cpus_) {
+            CPU_SET(cpu, &set);
+        }
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+    if (idle_io_) {
+        // IOPRIO_WHO_PROCESS of this thread, IOPRIO_CLASS_IDLE
+        syscall(SYS_ioprio_set, 1, syscall(SYS_gettid), 3 << 13);
+    }
+    PoolTask task;
+    while (!shutdown_) {
+        if (Pop(id, task)) {
+            total_wait_us_ +=
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - task.enqueue_time)
+                    .count();
+            task();
+            task = PoolTask();
+            finished_tasks_++;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_workers_++;
+        idle_cond_.wait(lock, [this] { return shutdown_ || pending_ > 0; });
+        idle_workers_--;
+    }
+}
+
+}  // namespace milvus
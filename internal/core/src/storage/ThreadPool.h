@@ -16,27 +16,117 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
 #include <mutex>
 #include <memory>
-#include <queue>
+#include <string>
 #include <thread>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <utility>
 
-#include "SafeQueue.h"
 #include "common/Common.h"
+#include "common/Numa.h"
+#include "common/ScratchArena.h"
 #include "log/Log.h"
 
 namespace milvus {
 
+// move-only type erased task, holds a packaged_task without wrapping it in
+// a shared_ptr and a std::function first
+class PoolTask {
+ public:
+    PoolTask() = default;
+
+    template <typename F>
+    explicit PoolTask(F&& f)
+        : impl_(std::make_unique<Impl<std::decay_t<F>>>(std::forward<F>(f))) {
+    }
+
+    void
+    operator()() {
+        impl_->Run();
+    }
+
+    // set when the task is queued, to measure how long it waited
+    std::chrono::steady_clock::time_point enqueue_time;
+
+ private:
+    struct Base {
+        virtual ~Base() = default;
+        virtual void
+        Run() = 0;
+    };
+
+    template <typename F>
+    struct Impl : Base {
+        explicit Impl(F&& f) : func(std::move(f)) {
+        }
+        void
+        Run() override {
+            func();
+        }
+        F func;
+    };
+
+    std::unique_ptr<Base> impl_;
+};
+
+// latency sensitive work gets its own pool so that a large load or build
+// can't take every thread, background pools also run at a lower priority
+enum class ThreadPoolType {
+    QUERY = 0,
+    LOAD,
+    INDEX_BUILD,
+    COMPACTION,
+    // downloads ahead of predicted loads, at idle io priority
+    PREFETCH,
+};
+
+struct ThreadPoolStats {
+    std::string name;
+    int64_t thread_num;
+    int64_t queue_depth;
+    int64_t finished_tasks;
+    // average time a task waited in the queue before a worker took it
+    int64_t avg_wait_us;
+};
+
+// every worker owns a deque, tasks submitted from a worker go to its own
+// deque and the rest are spread round robin, an idle worker steals from
+// the others before it sleeps, so workers only contend on a deque when
+// stealing
 class ThreadPool {
  public:
-    explicit ThreadPool(const int thread_core_coefficient) : shutdown_(false) {
-        auto thread_num = cpu_num * thread_core_coefficient;
-        LOG_SEGCORE_INFO_C << "Thread pool's worker num:" << thread_num;
+    // nice is added to the scheduling priority of the worker threads,
+    // idle_io leaves them the disk only when nothing else uses it, a pool
+    // given cpus is sized by them and its workers run on them only
+    explicit ThreadPool(const int thread_core_coefficient,
+                        const std::string& name = "default",
+                        const int nice = 0,
+                        const bool idle_io = false,
+                        const std::vector<int>& cpus = {})
+        : shutdown_(false),
+          name_(name),
+          nice_(nice),
+          idle_io_(idle_io),
+          cpus_(cpus) {
+        auto thread_num =
+            (cpus_.empty() ? cpu_num : int(cpus_.size())) *
+            thread_core_coefficient;
+        LOG_SEGCORE_INFO_C << "Thread pool " << name_
+                           << "'s worker num:" << thread_num;
         threads_ = std::vector<std::thread>(thread_num);
+        queues_ = std::vector<WorkQueue>(thread_num);
         Init();
     }
 
@@ -44,11 +134,13 @@ class ThreadPool {
         ShutDown();
     }
 
+    // pools are created on first use, sized by their core coefficient
     static ThreadPool&
-    GetInstance() {
-        static ThreadPool pool(thread_core_coefficient);
-        return pool;
-    }
+    GetInstance(ThreadPoolType type);
+
+    // the query pool of a NUMA node, pinned to its cpus
+    static ThreadPool&
+    GetNumaQueryInstance(int node);
 
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool(ThreadPool&&) = delete;
@@ -65,55 +157,113 @@ class ThreadPool {
 
     template <typename F, typename... Args>
     auto
-    // Submit(F&& f, Args&&... args) -> std::future<decltype(f(args...))>;
     Submit(F&& f, Args&&... args) -> std::future<decltype(f(args...))> {
-        std::function<decltype(f(args...))()> func =
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-        auto task_ptr =
-            std::make_shared<std::packaged_task<decltype(f(args...))()>>(func);
+        using R = decltype(f(args...));
+        std::packaged_task<R()> task(
+            [f = std::forward<F>(f),
+             args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(f), std::move(args));
+            });
+        auto future = task.get_future();
+        Push(PoolTask(std::move(task)));
+        return future;
+    }
 
-        std::function<void()> wrap_func = [task_ptr]() { (*task_ptr)(); };
+    ThreadPoolStats
+    GetStats() const;
 
-        work_queue_.enqueue(wrap_func);
+ private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<PoolTask> tasks;
+    };
 
-        condition_lock_.notify_one();
+    void
+    Push(PoolTask&& task);
 
-        return task_ptr->get_future();
-    }
+    // own deque front first, then the back of the others
+    bool
+    Pop(size_t id, PoolTask& task);
 
- public:
-    bool shutdown_;
-    SafeQueue<std::function<void()>> work_queue_;
-    std::vector<std::thread> threads_;
-    std::mutex mutex_;
-    std::condition_variable condition_lock_;
-};
+    void
+    Work(size_t id);
 
-class Worker {
  private:
-    int id_;
-    ThreadPool* pool_;
+    std::atomic<bool> shutdown_;
+    const std::string name_;
+    const int nice_;
+    const bool idle_io_;
+    const std::vector<int> cpus_;
+    std::vector<std::thread> threads_;
+    std::vector<WorkQueue> queues_;
+    std::atomic<size_t> next_queue_ = 0;
+    // submitted but not yet taken tasks, idle workers sleep on it
+    std::atomic<int64_t> pending_ = 0;
+    std::atomic<int64_t> idle_workers_ = 0;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cond_;
+    std::atomic<int64_t> finished_tasks_ = 0;
+    std::atomic<int64_t> total_wait_us_ = 0;
+};
 
- public:
-    Worker(ThreadPool* pool, const int id) : pool_(pool), id_(id) {
+// run `func(id)` for every id in [0, num_tasks) on the calling thread and
+// up to `num_helpers` helpers on the query pool, the one of the NUMA node
+// of the current thread if set, then rethrow the first error. the caller
+// claims tasks too, so a busy pool costs parallelism but never progress,
+// and nesting on a pool thread cannot deadlock
+template <typename Func>
+void
+ParallelFor(int64_t num_tasks, int64_t num_helpers, Func&& func) {
+    num_helpers = std::min(num_helpers, num_tasks - 1);
+    if (num_helpers <= 0) {
+        for (int64_t id = 0; id < num_tasks; ++id) {
+            func(id);
+        }
+        return;
     }
 
-    void
-    operator()() {
-        std::function<void()> func;
-        bool dequeue;
-        while (!pool_->shutdown_) {
-            std::unique_lock<std::mutex> lock(pool_->mutex_);
-            if (pool_->work_queue_.empty()) {
-                pool_->condition_lock_.wait(lock);
+    struct State {
+        std::atomic<int64_t> next = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+        int64_t done = 0;
+        std::exception_ptr error;
+    };
+    // helpers started after the last task is claimed only touch `state`
+    auto state = std::make_shared<State>();
+    auto node = CurrentNumaNode();
+    // helpers nest on the node too
+    auto run = [state, num_tasks, node, &func] {
+        NumaNodeScope numa_scope(node);
+        ScratchScope scratch_scope;
+        for (auto id = state->next++; id < num_tasks; id = state->next++) {
+            std::exception_ptr error;
+            try {
+                func(id);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard lck(state->mutex);
+            if (error && !state->error) {
+                state->error = error;
             }
-            dequeue = pool_->work_queue_.dequeue(func);
-            lock.unlock();
-            if (dequeue) {
-                func();
+            if (++state->done == num_tasks) {
+                state->finished.notify_all();
             }
         }
+    };
+    auto& pool = node < 0 ? ThreadPool::GetInstance(ThreadPoolType::QUERY)
+                          : ThreadPool::GetNumaQueryInstance(node);
+    for (int64_t i = 0; i < num_helpers; ++i) {
+        pool.Submit(run);
     }
-};
+    run();
+    std::unique_lock lck(state->mutex);
+    state->finished.wait(
+        lck, [&state, num_tasks] { return state->done == num_tasks; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
 
 }  // namespace milvus
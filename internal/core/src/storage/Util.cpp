@@ -140,6 +140,30 @@ AddOneStringToArrowBuilder(std::shared_ptr<arrow::ArrayBuilder> builder,
     AssertInfo(ast.ok(), "append value to arrow builder failed");
 }
 
+void
+AddStringsToArrowBuilder(std::shared_ptr<arrow::ArrayBuilder> builder,
+                         const char* data,
+                         const int32_t* offsets,
+                         int rows) {
+    AssertInfo(builder != nullptr, "empty arrow builder");
+    AssertInfo(rows == 0 || (data != nullptr && offsets != nullptr),
+               "null strings");
+    auto string_builder =
+        std::dynamic_pointer_cast<arrow::StringBuilder>(builder);
+    auto ast = string_builder->Reserve(rows);
+    AssertInfo(ast.ok(), "reserve arrow builder failed");
+    if (rows == 0) {
+        return;
+    }
+    ast = string_builder->ReserveData(offsets[rows] - offsets[0]);
+    AssertInfo(ast.ok(), "reserve arrow builder failed");
+    for (int i = 0; i < rows; ++i) {
+        auto size = offsets[i + 1] - offsets[i];
+        AssertInfo(size >= 0, "offsets of strings are not ascending");
+        string_builder->UnsafeAppend(data + offsets[i], size);
+    }
+}
+
 std::shared_ptr<arrow::ArrayBuilder>
 CreateArrowBuilder(DataType data_type) {
     switch (static_cast<DataType>(data_type)) {
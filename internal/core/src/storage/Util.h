@@ -38,6 +38,14 @@ AddOneStringToArrowBuilder(std::shared_ptr<arrow::ArrayBuilder> builder,
                            const char* str,
                            int str_size);
 
+// appends the rows strings of data, row i being data[offsets[i]] up to
+// data[offsets[i + 1]]
+void
+AddStringsToArrowBuilder(std::shared_ptr<arrow::ArrayBuilder> builder,
+                         const char* data,
+                         const int32_t* offsets,
+                         int rows);
+
 std::shared_ptr<arrow::ArrayBuilder>
 CreateArrowBuilder(DataType data_type);
 
@@ -142,6 +142,20 @@ AddOneStringToPayload(CPayloadWriter payloadWriter, char* cstr, int str_size) {
     }
 }
 
+extern "C" CStatus
+AddStringsToPayload(CPayloadWriter payloadWriter,
+                    char* data,
+                    int32_t* offsets,
+                    int length) {
+    try {
+        auto p = reinterpret_cast<PayloadWriter*>(payloadWriter);
+        p->add_string_payload(data, offsets, length);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 extern "C" CStatus
 AddBinaryVectorToPayload(CPayloadWriter payloadWriter,
                          uint8_t* values,
@@ -361,6 +375,20 @@ GetOneStringFromPayload(CPayloadReader payloadReader,
     }
 }
 
+extern "C" CStatus
+GetStringsFromPayload(CPayloadReader payloadReader,
+                      const char** data,
+                      const int32_t** offsets,
+                      int* length) {
+    try {
+        auto p = reinterpret_cast<PayloadReader*>(payloadReader);
+        p->get_string_payload(data, offsets, length);
+        return milvus::SuccessCStatus();
+    } catch (std::exception& e) {
+        return milvus::FailureCStatus(UnexpectedError, e.what());
+    }
+}
+
 extern "C" CStatus
 GetBinaryVectorFromPayload(CPayloadReader payloadReader,
                            uint8_t** values,
@@ -52,6 +52,12 @@ CStatus
 AddDoubleToPayload(CPayloadWriter payloadWriter, double* values, int length);
 CStatus
 AddOneStringToPayload(CPayloadWriter payloadWriter, char* cstr, int str_size);
+// length strings, the i-th one data[offsets[i]] up to data[offsets[i + 1]]
+CStatus
+AddStringsToPayload(CPayloadWriter payloadWriter,
+                    char* data,
+                    int32_t* offsets,
+                    int length);
 CStatus
 AddBinaryVectorToPayload(CPayloadWriter payloadWriter,
                          uint8_t* values,
@@ -103,6 +109,13 @@ GetOneStringFromPayload(CPayloadReader payloadReader,
                         int idx,
                         char** cstr,
                         int* str_size);
+// all the strings as views of the reader's buffers, valid until it is
+// released: the i-th one is data[offsets[i]] up to data[offsets[i + 1]]
+CStatus
+GetStringsFromPayload(CPayloadReader payloadReader,
+                      const char** data,
+                      const int32_t** offsets,
+                      int* length);
 CStatus
 GetBinaryVectorFromPayload(CPayloadReader payloadReader,
                            uint8_t** values,
@@ -0,0 +1,328 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench/bench_perf.h"
+#include "pb/plan.pb.h"
+#include "segcore/Collection.h"
+#include "segcore/plan_c.h"
+#include "segcore/reduce_c.h"
+#include "segcore/segment_c.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::segcore;
+
+// the exported functions a search or a retrieve request goes through, one at a time and end to end, on segments
+// from tiny to mid sized: at nq 1 over 16 rows what is left is the fixed cost of a call, the parsing, the copies
+// and the marshaling, against the work that grows with the rows and the queries
+namespace {
+
+enum SegmentKind : int64_t {
+    GrowingSegment = 0,
+    SealedSegment = 1,
+};
+
+constexpr int64_t dim = 128;
+constexpr int64_t topk = 10;
+
+const char* schema_text = R"(name: "bench-collection"
+                             fields: <
+                               fieldID: 100
+                               name: "fakevec"
+                               data_type: FloatVector
+                               type_params: <
+                                 key: "dim"
+                                 value: "128"
+                               >
+                               index_params: <
+                                 key: "metric_type"
+                                 value: "L2"
+                               >
+                             >
+                             fields: <
+                               fieldID: 101
+                               name: "pk"
+                               data_type: Int64
+                               is_primary_key: true
+                             >
+                             fields: <
+                               fieldID: 102
+                               name: "name"
+                               data_type: VarChar
+                               type_params: <
+                                 key: "max_length"
+                                 value: "128"
+                               >
+                             >)";
+
+CCollection
+GetCollection() {
+    static auto collection = NewCollection(schema_text);
+    return collection;
+}
+
+SchemaPtr
+GetSchema() {
+    return static_cast<Collection*>(GetCollection())->get_schema();
+}
+
+// through Insert for a growing segment, as the loads of the field data do for a sealed one
+CSegmentInterface
+GetSegment(int64_t kind, int64_t rows) {
+    static std::map<std::pair<int64_t, int64_t>, CSegmentInterface> segments;
+    auto& segment = segments[{kind, rows}];
+    if (segment != nullptr) {
+        return segment;
+    }
+    auto dataset = DataGen(GetSchema(), rows);
+    if (kind == GrowingSegment) {
+        segment = NewSegment(GetCollection(), Growing, 1);
+        int64_t offset;
+        PreInsert(segment, rows, &offset);
+        auto insert_data = dataset.raw_->SerializeAsString();
+        auto status = Insert(segment,
+                             offset,
+                             rows,
+                             dataset.row_ids_.data(),
+                             dataset.timestamps_.data(),
+                             reinterpret_cast<const uint8_t*>(insert_data.data()),
+                             insert_data.size());
+        AssertInfo(status.error_code == Success, status.error_msg);
+    } else {
+        segment = NewSegment(GetCollection(), Sealed, 2);
+        SealedLoadFieldData(dataset, *static_cast<SegmentSealed*>(static_cast<SegmentInterface*>(segment)));
+    }
+    return segment;
+}
+
+// a search of the topk by L2 with the pk and the name as output, filtered by a pk IN list of filter_size pks
+std::string
+SerializedSearchPlan(int64_t filter_size) {
+    proto::plan::PlanNode plan_node;
+    auto anns = plan_node.mutable_vector_anns();
+    anns->set_field_id(100);
+    anns->set_placeholder_tag("$0");
+    auto query_info = anns->mutable_query_info();
+    query_info->set_topk(topk);
+    query_info->set_round_decimal(-1);
+    query_info->set_metric_type(knowhere::metric::L2);
+    query_info->set_search_params(R"({"nprobe": 10})");
+    if (filter_size > 0) {
+        auto term = anns->mutable_predicates()->mutable_term_expr();
+        term->mutable_column_info()->set_field_id(101);
+        term->mutable_column_info()->set_data_type(proto::schema::DataType::Int64);
+        for (int64_t i = 0; i < filter_size; ++i) {
+            term->add_values()->set_int64_val(i * 3);
+        }
+    }
+    plan_node.add_output_field_ids(101);
+    plan_node.add_output_field_ids(102);
+    return plan_node.SerializeAsString();
+}
+
+// a retrieve of the pk and the name of count pks
+std::string
+SerializedRetrievePlan(int64_t count) {
+    proto::plan::PlanNode plan_node;
+    auto term = plan_node.mutable_predicates()->mutable_term_expr();
+    term->mutable_column_info()->set_field_id(101);
+    term->mutable_column_info()->set_data_type(proto::schema::DataType::Int64);
+    for (int64_t i = 0; i < count; ++i) {
+        term->add_values()->set_int64_val(i);
+    }
+    plan_node.add_output_field_ids(101);
+    plan_node.add_output_field_ids(102);
+    return plan_node.SerializeAsString();
+}
+
+std::string
+Placeholders(int64_t nq) {
+    return CreatePlaceholderGroup(nq, dim).SerializeAsString();
+}
+
+void
+CheckStatus(const CStatus& status) {
+    AssertInfo(status.error_code == Success, status.error_msg);
+}
+
+// the reduce of one segment result into one blob, its fields filled
+CSearchResultDataBlobs
+ReduceOne(CSearchPlan plan, CSearchResult result, int64_t nq) {
+    int64_t slice_nq = nq;
+    int64_t slice_topk = topk;
+    CSearchResultDataBlobs blobs;
+    CheckStatus(ReduceSearchResultsAndFillData(&blobs, plan, &result, 1, &slice_nq, &slice_topk, 1));
+    CProto blob;
+    CheckStatus(GetSearchResultDataBlob(&blob, blobs, 0));
+    benchmark::DoNotOptimize(blob);
+    return blobs;
+}
+
+const std::vector<int64_t> segment_rows = {16, 4096, 1 << 16};
+
+}  // namespace
+
+static void
+CApi_NewSegment(benchmark::State& state) {
+    auto type = state.range(0) == GrowingSegment ? Growing : Sealed;
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto segment = NewSegment(GetCollection(), type, 3);
+        DeleteSegment(segment);
+    }
+}
+
+BENCHMARK(CApi_NewSegment)->ArgName("segment")->Arg(GrowingSegment)->Arg(SealedSegment);
+
+// parsing a serialized plan into a search plan, the search params json included
+static void
+CApi_CreateSearchPlan(benchmark::State& state) {
+    auto binary_plan = SerializedSearchPlan(state.range(0));
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        CSearchPlan plan;
+        CheckStatus(CreateSearchPlanByExpr(GetCollection(), binary_plan.data(), binary_plan.size(), &plan));
+        DeleteSearchPlan(plan);
+    }
+}
+
+BENCHMARK(CApi_CreateSearchPlan)->ArgName("filter_size")->Arg(0)->Arg(16)->Arg(1024);
+
+static void
+CApi_ParsePlaceholderGroup(benchmark::State& state) {
+    auto nq = state.range(0);
+    auto binary_plan = SerializedSearchPlan(0);
+    auto blob = Placeholders(nq);
+    CSearchPlan plan;
+    CheckStatus(CreateSearchPlanByExpr(GetCollection(), binary_plan.data(), binary_plan.size(), &plan));
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        CPlaceholderGroup placeholder_group;
+        CheckStatus(ParsePlaceholderGroup(plan, blob.data(), blob.size(), &placeholder_group));
+        DeletePlaceholderGroup(placeholder_group);
+    }
+    DeleteSearchPlan(plan);
+    state.SetItemsProcessed(state.iterations() * nq);
+}
+
+BENCHMARK(CApi_ParsePlaceholderGroup)->ArgName("nq")->Arg(1)->Arg(16)->Arg(256);
+
+// Search of one segment alone, the plan and the placeholders parsed up front
+static void
+CApi_Search(benchmark::State& state) {
+    auto segment = GetSegment(state.range(0), state.range(1));
+    auto nq = state.range(2);
+    auto binary_plan = SerializedSearchPlan(0);
+    auto blob = Placeholders(nq);
+    CSearchPlan plan;
+    CheckStatus(CreateSearchPlanByExpr(GetCollection(), binary_plan.data(), binary_plan.size(), &plan));
+    CPlaceholderGroup placeholder_group;
+    CheckStatus(ParsePlaceholderGroup(plan, blob.data(), blob.size(), &placeholder_group));
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        CSearchResult result;
+        CheckStatus(Search(segment, plan, placeholder_group, MAX_TIMESTAMP, &result));
+        DeleteSearchResult(result);
+    }
+    DeletePlaceholderGroup(placeholder_group);
+    DeleteSearchPlan(plan);
+}
+
+BENCHMARK(CApi_Search)
+    ->ArgNames({"segment", "rows", "nq"})
+    ->ArgsProduct({{GrowingSegment, SealedSegment}, segment_rows, {1, 16}})
+    ->Unit(benchmark::kMicrosecond);
+
+// the reduce of the result of one segment and the marshaling of its blob, output fields included
+static void
+CApi_Reduce(benchmark::State& state) {
+    auto segment = GetSegment(SealedSegment, state.range(0));
+    auto nq = state.range(1);
+    auto binary_plan = SerializedSearchPlan(0);
+    auto blob = Placeholders(nq);
+    CSearchPlan plan;
+    CheckStatus(CreateSearchPlanByExpr(GetCollection(), binary_plan.data(), binary_plan.size(), &plan));
+    CPlaceholderGroup placeholder_group;
+    CheckStatus(ParsePlaceholderGroup(plan, blob.data(), blob.size(), &placeholder_group));
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        CSearchResult result;
+        CheckStatus(Search(segment, plan, placeholder_group, MAX_TIMESTAMP, &result));
+        state.ResumeTiming();
+        auto blobs = ReduceOne(plan, result, nq);
+        state.PauseTiming();
+        DeleteSearchResultDataBlobs(blobs);
+        DeleteSearchResult(result);
+        state.ResumeTiming();
+    }
+    DeletePlaceholderGroup(placeholder_group);
+    DeleteSearchPlan(plan);
+}
+
+BENCHMARK(CApi_Reduce)
+    ->ArgNames({"rows", "nq"})
+    ->ArgsProduct({segment_rows, {1, 16}})
+    ->Unit(benchmark::kMicrosecond);
+
+// a whole search request on one segment: the plan, the placeholders, the search, the reduce and the blob, freed
+static void
+CApi_SearchRequest(benchmark::State& state) {
+    auto segment = GetSegment(state.range(0), state.range(1));
+    auto nq = state.range(2);
+    auto binary_plan = SerializedSearchPlan(0);
+    auto blob = Placeholders(nq);
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        CSearchPlan plan;
+        CheckStatus(CreateSearchPlanByExpr(GetCollection(), binary_plan.data(), binary_plan.size(), &plan));
+        CPlaceholderGroup placeholder_group;
+        CheckStatus(ParsePlaceholderGroup(plan, blob.data(), blob.size(), &placeholder_group));
+        CSearchResult result;
+        CheckStatus(Search(segment, plan, placeholder_group, MAX_TIMESTAMP, &result));
+        auto blobs = ReduceOne(plan, result, nq);
+        DeleteSearchResultDataBlobs(blobs);
+        DeleteSearchResult(result);
+        DeletePlaceholderGroup(placeholder_group);
+        DeleteSearchPlan(plan);
+    }
+}
+
+BENCHMARK(CApi_SearchRequest)
+    ->ArgNames({"segment", "rows", "nq"})
+    ->ArgsProduct({{GrowingSegment, SealedSegment}, segment_rows, {1, 16}})
+    ->Unit(benchmark::kMicrosecond);
+
+// a whole retrieve request by count pks: the plan, the retrieve and its serialized result, freed
+static void
+CApi_RetrieveRequest(benchmark::State& state) {
+    auto segment = GetSegment(state.range(0), state.range(1));
+    auto binary_plan = SerializedRetrievePlan(state.range(2));
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        CRetrievePlan plan;
+        CheckStatus(CreateRetrievePlanByExpr(GetCollection(), binary_plan.data(), binary_plan.size(), &plan));
+        CRetrieveResult result;
+        CheckStatus(Retrieve(segment, plan, MAX_TIMESTAMP, &result));
+        DeleteRetrieveResult(&result);
+        DeleteRetrievePlan(plan);
+    }
+}
+
+BENCHMARK(CApi_RetrieveRequest)
+    ->ArgNames({"segment", "rows", "count"})
+    ->ArgsProduct({{GrowingSegment, SealedSegment}, segment_rows, {1, 16}})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,165 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/bench_perf.h"
+#include "query/Plan.h"
+#include "segcore/SegmentGrowingImpl.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+namespace {
+
+constexpr int dim = 64;
+constexpr int64_t initial_rows = 1 << 16;
+constexpr int64_t batch_rows = 1000;
+constexpr int64_t delete_batch_rows = 100;
+// the inserters stop here, so a long run does not take all the memory
+constexpr int64_t max_rows = 1 << 21;
+
+const auto schema = []() {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    schema->AddDebugField("age", DataType::INT32);
+    return schema;
+}();
+
+const auto pk_fid = schema->get_primary_field_id().value();
+
+const auto plan = [] {
+    proto::plan::PlanNode plan_node;
+    auto anns = plan_node.mutable_vector_anns();
+    anns->set_field_id((*schema)[FieldName("fakevec")].get_id().get());
+    anns->set_placeholder_tag("$0");
+    auto query_info = anns->mutable_query_info();
+    query_info->set_topk(10);
+    query_info->set_metric_type(knowhere::metric::L2);
+    query_info->set_search_params(R"({"nprobe": 10})");
+    auto binary_plan = plan_node.SerializeAsString();
+    return CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+}();
+
+const auto ph_group = [] {
+    auto ph_group_raw = CreatePlaceholderGroup(10, dim, 1024);
+    return ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+}();
+
+void
+SetPks(GeneratedData& batch, int64_t first_pk) {
+    for (auto& field_data : *batch.raw_->mutable_fields_data()) {
+        if (field_data.field_id() != pk_fid.get()) {
+            continue;
+        }
+        auto pks = field_data.mutable_scalars()->mutable_long_data()->mutable_data();
+        for (int64_t i = 0; i < pks->size(); ++i) {
+            pks->Set(i, first_pk + i);
+        }
+    }
+}
+
+double
+Percentile(std::vector<double>& sorted, double quantile) {
+    auto index = std::min(sorted.size() - 1, size_t(sorted.size() * quantile));
+    return sorted[index];
+}
+
+}  // namespace
+
+// searches on the benchmark thread while state.range(0) threads insert batches and state.range(1) threads delete
+// random pks, all of them taking their timestamps from one clock the way the dml channel does; the search latency
+// percentiles and the insert rate tell how much the writers hold up the readers and the other way round
+static void
+Growing_ConcurrentInsertSearch(benchmark::State& state) {
+    auto inserters = state.range(0);
+    auto deleters = state.range(1);
+    auto segment = CreateGrowingSegment(schema);
+    auto dataset = DataGen(schema, initial_rows);
+    segment->PreInsert(initial_rows);
+    segment->Insert(0, initial_rows, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+
+    std::atomic<Timestamp> clock = initial_rows;
+    std::atomic<int64_t> next_pk = initial_rows;
+    std::atomic<int64_t> inserted_rows = 0;
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> writers;
+    for (int64_t t = 0; t < inserters; ++t) {
+        writers.emplace_back([&, t] {
+            auto batch = DataGen(schema, batch_rows, t + 1);
+            std::vector<Timestamp> timestamps(batch_rows);
+            while (!stop.load() && next_pk.load() < max_rows) {
+                SetPks(batch, next_pk.fetch_add(batch_rows));
+                std::iota(timestamps.begin(), timestamps.end(), clock.fetch_add(batch_rows));
+                auto offset = segment->PreInsert(batch_rows);
+                segment->Insert(offset, batch_rows, batch.row_ids_.data(), timestamps.data(), batch.raw_);
+                inserted_rows += batch_rows;
+            }
+        });
+    }
+    for (int64_t t = 0; t < deleters; ++t) {
+        writers.emplace_back([&, t] {
+            std::default_random_engine er(t);
+            std::vector<Timestamp> timestamps(delete_batch_rows);
+            while (!stop.load()) {
+                IdArray ids;
+                auto pk_end = next_pk.load();
+                for (int64_t i = 0; i < delete_batch_rows; ++i) {
+                    ids.mutable_int_id()->add_data(er() % pk_end);
+                }
+                std::iota(timestamps.begin(), timestamps.end(), clock.fetch_add(delete_batch_rows));
+                auto offset = segment->PreDelete(delete_batch_rows);
+                segment->Delete(offset, delete_batch_rows, &ids, timestamps.data());
+            }
+        });
+    }
+
+    std::vector<double> latencies;
+    auto start = std::chrono::steady_clock::now();
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto search_start = std::chrono::steady_clock::now();
+        auto result = segment->Search(plan.get(), ph_group.get(), clock.load());
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - search_start)
+                                .count());
+        benchmark::DoNotOptimize(result);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stop = true;
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p50_us"] = Percentile(latencies, 0.5);
+    state.counters["p99_us"] = Percentile(latencies, 0.99);
+    state.counters["p999_us"] = Percentile(latencies, 0.999);
+    state.counters["insert_rows_per_s"] = inserted_rows.load() / elapsed;
+    state.counters["rows"] = segment->get_row_count();
+}
+
+BENCHMARK(Growing_ConcurrentInsertSearch)
+    ->ArgNames({"inserters", "deleters"})
+    ->ArgsProduct({{0, 1, 4}, {0, 1, 4}})
+    ->Iterations(1000)
+    ->UseRealTime();
@@ -0,0 +1,197 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <atomic>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <thread>
+#include "segcore/SegmentGrowingImpl.h"
+#include "segcore/SegmentSealedImpl.h"
+#include "segcore/Utils.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::segcore;
+
+// rows are inserted at timestamps [0, rows) with pks [0, rows), the deletes come after them
+const auto schema = []() {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 4, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    return schema;
+}();
+
+struct Deletes {
+    std::vector<int64_t> pks;
+    std::vector<Timestamp> timestamps;
+};
+
+// permille of the rows deleted, each deleted repeats times, at timestamps [rows, rows + deletes)
+static Deletes
+GenDeletes(int64_t rows, int64_t permille, int64_t repeats = 1) {
+    std::default_random_engine er(42);
+    std::vector<int64_t> pks(rows);
+    std::iota(pks.begin(), pks.end(), 0);
+    std::shuffle(pks.begin(), pks.end(), er);
+    pks.resize(rows * permille / 1000);
+    Deletes deletes;
+    for (int64_t r = 0; r < repeats; ++r) {
+        for (auto pk : pks) {
+            deletes.pks.emplace_back(pk);
+            deletes.timestamps.push_back(rows + deletes.timestamps.size());
+        }
+    }
+    return deletes;
+}
+
+static void
+ApplyDeletes(SegmentInternalInterface& segment, const Deletes& deletes) {
+    IdArray ids;
+    ids.mutable_int_id()->mutable_data()->Add(deletes.pks.begin(), deletes.pks.end());
+    auto size = deletes.pks.size();
+    auto offset = segment.PreDelete(size);
+    segment.Delete(offset, size, &ids, deletes.timestamps.data());
+}
+
+// building the whole delete bitmap of a sealed segment, as the first query after a load does
+static void
+DeletedBitmap_Build(benchmark::State& state) {
+    auto rows = state.range(0);
+    auto deletes = GenDeletes(rows, state.range(1), state.range(2));
+    auto del_barrier = int64_t(deletes.pks.size());
+
+    InsertRecord<true> insert_record(*schema, rows);
+    std::vector<Timestamp> timestamps(rows);
+    std::iota(timestamps.begin(), timestamps.end(), 0);
+    insert_record.timestamps_.fill_chunk_data(timestamps.data(), rows);
+    std::vector<PkType> pks(rows);
+    for (int64_t i = 0; i < rows; ++i) {
+        pks[i] = i;
+    }
+    insert_record.insert_pks(pks, 0);
+    insert_record.seal_pks();
+
+    std::optional<DeletedRecord> delete_record;
+    for (auto _ : state) {
+        state.PauseTiming();
+        delete_record.emplace();
+        delete_record->push(0, deletes.pks.data(), deletes.timestamps.data(), del_barrier);
+        state.ResumeTiming();
+        auto bitmap = get_deleted_bitmap(del_barrier, rows, *delete_record, insert_record, MAX_TIMESTAMP);
+        benchmark::DoNotOptimize(bitmap);
+    }
+    state.SetItemsProcessed(state.iterations() * del_barrier);
+}
+
+BENCHMARK(DeletedBitmap_Build)->ArgsProduct({{1 << 20}, {1, 10, 50, 200}, {1, 4}});
+
+// a query at a timestamp percent of the way through the deletes, after one at the latest timestamp published
+// the bitmap of every delete: only the last position finds it cached
+static void
+Sealed_MaskWithDelete(benchmark::State& state) {
+    auto rows = state.range(0);
+    auto dataset = DataGen(schema, rows);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto deletes = GenDeletes(rows, state.range(1));
+    ApplyDeletes(*segment, deletes);
+
+    const SegmentInternalInterface& sealed = *segment;
+    BitsetType bitset(rows);
+    sealed.mask_with_delete(bitset, rows, MAX_TIMESTAMP);
+    auto timestamp = rows + Timestamp(deletes.pks.size()) * state.range(2) / 100;
+    for (auto _ : state) {
+        bitset.reset();
+        sealed.mask_with_delete(bitset, rows, timestamp);
+        benchmark::DoNotOptimize(bitset);
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+BENCHMARK(Sealed_MaskWithDelete)->ArgsProduct({{1 << 20}, {1, 10, 50, 200}, {0, 50, 99, 100}});
+
+// hiding the rows inserted after a timestamp percent of the way through the inserts
+static void
+Sealed_MaskWithTimestamps(benchmark::State& state) {
+    auto rows = state.range(0);
+    auto dataset = DataGen(schema, rows);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    const SegmentInternalInterface& sealed = *segment;
+    BitsetType bitset(rows);
+    auto timestamp = Timestamp(rows * state.range(1) / 100);
+    for (auto _ : state) {
+        bitset.reset();
+        sealed.mask_with_timestamps(bitset, timestamp);
+        benchmark::DoNotOptimize(bitset);
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+BENCHMARK(Sealed_MaskWithTimestamps)->ArgsProduct({{1 << 20}, {0, 50, 99, 100}});
+
+// the deletes of a growing segment masked while another thread keeps inserting, so the insert barrier of every
+// query moves past the cached bitmap
+static void
+Growing_MaskWithDeleteUnderInserts(benchmark::State& state) {
+    auto rows = state.range(0);
+    constexpr int64_t batch_rows = 1000;
+    auto segment = CreateGrowingSegment(schema);
+    auto dataset = DataGen(schema, rows);
+    segment->PreInsert(rows);
+    segment->Insert(0, rows, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+    auto deletes = GenDeletes(rows, state.range(1));
+    ApplyDeletes(*segment, deletes);
+
+    // the batches insert new pks after the deletes
+    auto batch = DataGen(schema, batch_rows);
+    auto pk_fid = schema->get_primary_field_id().value();
+    std::atomic<bool> stop = false;
+    std::thread inserter([&] {
+        auto next_timestamp = Timestamp(rows + deletes.pks.size());
+        for (int64_t next_pk = rows; !stop.load(); next_pk += batch_rows) {
+            for (auto& field_data : *batch.raw_->mutable_fields_data()) {
+                if (field_data.field_id() != pk_fid.get()) {
+                    continue;
+                }
+                auto pks = field_data.mutable_scalars()->mutable_long_data()->mutable_data();
+                for (int64_t i = 0; i < batch_rows; ++i) {
+                    pks->Set(i, next_pk + i);
+                }
+            }
+            std::vector<Timestamp> timestamps(batch_rows);
+            std::iota(timestamps.begin(), timestamps.end(), next_timestamp);
+            next_timestamp += batch_rows;
+            auto offset = segment->PreInsert(batch_rows);
+            segment->Insert(offset, batch_rows, batch.row_ids_.data(), timestamps.data(), batch.raw_);
+        }
+    });
+
+    const SegmentInternalInterface& growing = *segment;
+    int64_t masked_rows = 0;
+    for (auto _ : state) {
+        auto active_count = growing.get_active_count(MAX_TIMESTAMP);
+        BitsetType bitset(active_count);
+        growing.mask_with_delete(bitset, active_count, MAX_TIMESTAMP);
+        masked_rows += active_count;
+        benchmark::DoNotOptimize(bitset);
+    }
+    stop = true;
+    inserter.join();
+    state.SetItemsProcessed(masked_rows);
+}
+
+BENCHMARK(Growing_MaskWithDeleteUnderInserts)->ArgsProduct({{1 << 18}, {1, 10, 200}})->UseRealTime();
@@ -0,0 +1,254 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <map>
+#include <random>
+#include <string>
+#include "bench/bench_perf.h"
+#include "query/PlanProto.h"
+#include "query/generated/ExecExprVisitor.h"
+#include "segcore/SegmentGrowingImpl.h"
+#include "segcore/SegmentSealedImpl.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+// the expressions run on every row of a segment of one of these kinds
+enum SegmentKind : int64_t {
+    GrowingSegment = 0,
+    SealedRawSegment = 1,
+    SealedIndexedSegment = 2,
+};
+
+// "random" and "other" are uniform in [0, 2 * rows), "score" is normal and "name" a random decimal string
+const auto schema = []() {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 4, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    schema->AddDebugField("random", DataType::INT32);
+    schema->AddDebugField("other", DataType::INT32);
+    schema->AddDebugField("score", DataType::FLOAT);
+    schema->AddDebugField("name", DataType::VARCHAR);
+    return schema;
+}();
+
+const auto random_fid = (*schema)[FieldName("random")].get_id();
+const auto other_fid = (*schema)[FieldName("other")].get_id();
+const auto score_fid = (*schema)[FieldName("score")].get_id();
+const auto name_fid = (*schema)[FieldName("name")].get_id();
+
+struct BenchSegment {
+    GeneratedData dataset;
+    std::unique_ptr<SegmentInternalInterface> segment;
+};
+
+static BenchSegment&
+GetSegment(int64_t kind, int64_t rows) {
+    // building a segment costs far more than the expressions, so the segments are shared by the benchmarks
+    static std::map<std::pair<int64_t, int64_t>, std::unique_ptr<BenchSegment>> segments;
+    auto iter = segments.find({kind, rows});
+    if (iter != segments.end()) {
+        return *iter->second;
+    }
+    auto dataset = DataGen(schema, rows);
+    std::unique_ptr<SegmentInternalInterface> segment;
+    if (kind == GrowingSegment) {
+        auto growing = CreateGrowingSegment(schema);
+        growing->PreInsert(rows);
+        growing->Insert(0, rows, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+        segment = std::move(growing);
+    } else if (kind == SealedRawSegment) {
+        auto sealed = CreateSealedSegment(schema);
+        SealedLoadFieldData(dataset, *sealed);
+        segment = std::move(sealed);
+    } else {
+        auto sealed = CreateSealedSegment(schema);
+        SealedLoadFieldData(dataset, *sealed, {random_fid.get(), other_fid.get(), score_fid.get(), name_fid.get()});
+        auto load_index = [&](FieldId field_id, DataType data_type, index::IndexBasePtr index) {
+            LoadIndexInfo info;
+            info.field_id = field_id.get();
+            info.field_type = data_type;
+            info.index_params["index_type"] = "sort";
+            info.index = std::move(index);
+            sealed->LoadIndex(info);
+        };
+        load_index(random_fid, DataType::INT32,
+                   GenScalarIndexing<int32_t>(rows, dataset.get_col<int32_t>(random_fid).data()));
+        load_index(other_fid, DataType::INT32,
+                   GenScalarIndexing<int32_t>(rows, dataset.get_col<int32_t>(other_fid).data()));
+        load_index(score_fid, DataType::FLOAT,
+                   GenScalarIndexing<float>(rows, dataset.get_col<float>(score_fid).data()));
+        load_index(name_fid, DataType::VARCHAR,
+                   GenScalarIndexing<std::string>(rows, dataset.get_col<std::string>(name_fid).data()));
+        segment = std::move(sealed);
+    }
+    auto& bench_segment = segments[{kind, rows}];
+    bench_segment.reset(new BenchSegment{std::move(dataset), std::move(segment)});
+    return *bench_segment;
+}
+
+static proto::plan::ColumnInfo*
+SetColumn(proto::plan::ColumnInfo* column, FieldId field_id) {
+    column->set_field_id(field_id.get());
+    column->set_data_type(static_cast<proto::schema::DataType>((*schema)[field_id].get_data_type()));
+    return column;
+}
+
+// the value below which selectivity percent of the uniform values in [0, 2 * rows) fall
+static int64_t
+Quantile(int64_t rows, int64_t selectivity) {
+    return 2 * rows * selectivity / 100;
+}
+
+static void
+RunExpr(benchmark::State& state, const proto::plan::Expr& expr_pb) {
+    auto& bench_segment = GetSegment(state.range(0), state.range(1));
+    auto& segment = *bench_segment.segment;
+    auto expr = ProtoParser(*schema).ParseExpr(expr_pb);
+    int64_t matched = 0;
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        ExecExprVisitor visitor(segment, segment.get_row_count(), MAX_TIMESTAMP);
+        auto result = visitor.call_child(*expr);
+        matched = result.count();
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * segment.get_row_count());
+    state.counters["selectivity"] = double(matched) / segment.get_row_count();
+}
+
+// random < quantile
+static void
+Expr_UnaryRange(benchmark::State& state) {
+    proto::plan::Expr expr;
+    auto range = expr.mutable_unary_range_expr();
+    SetColumn(range->mutable_column_info(), random_fid);
+    range->set_op(proto::plan::OpType::LessThan);
+    range->mutable_value()->set_int64_val(Quantile(state.range(1), state.range(2)));
+    RunExpr(state, expr);
+}
+
+// lower <= random < upper, centered in the values
+static void
+Expr_BinaryRange(benchmark::State& state) {
+    auto rows = state.range(1);
+    auto width = Quantile(rows, state.range(2));
+    proto::plan::Expr expr;
+    auto range = expr.mutable_binary_range_expr();
+    SetColumn(range->mutable_column_info(), random_fid);
+    range->set_lower_inclusive(true);
+    range->set_upper_inclusive(false);
+    range->mutable_lower_value()->set_int64_val(rows - width / 2);
+    range->mutable_upper_value()->set_int64_val(rows - width / 2 + width);
+    RunExpr(state, expr);
+}
+
+// random in a list of state.range(2) values
+static void
+Expr_Term(benchmark::State& state) {
+    auto rows = state.range(1);
+    std::default_random_engine er(42);
+    proto::plan::Expr expr;
+    auto term = expr.mutable_term_expr();
+    SetColumn(term->mutable_column_info(), random_fid);
+    for (int64_t i = 0; i < state.range(2); ++i) {
+        term->add_values()->set_int64_val(er() % (2 * rows));
+    }
+    RunExpr(state, expr);
+}
+
+// random < other, about half of the rows
+static void
+Expr_Compare(benchmark::State& state) {
+    proto::plan::Expr expr;
+    auto compare = expr.mutable_compare_expr();
+    SetColumn(compare->mutable_left_column_info(), random_fid);
+    SetColumn(compare->mutable_right_column_info(), other_fid);
+    compare->set_op(proto::plan::OpType::LessThan);
+    RunExpr(state, expr);
+}
+
+// random % 100 < selectivity
+static void
+Expr_Arith(benchmark::State& state) {
+    proto::plan::Expr expr;
+    auto arith = expr.mutable_binary_arith_op_eval_range_expr();
+    SetColumn(arith->mutable_column_info(), random_fid);
+    arith->set_arith_op(proto::plan::ArithOpType::Mod);
+    arith->mutable_right_operand()->set_int64_val(100);
+    arith->set_op(proto::plan::OpType::LessThan);
+    arith->mutable_value()->set_int64_val(state.range(2));
+    RunExpr(state, expr);
+}
+
+// name < the selectivity quantile of the names
+static void
+Expr_StringRange(benchmark::State& state) {
+    auto& bench_segment = GetSegment(state.range(0), state.range(1));
+    auto names = bench_segment.dataset.get_col<std::string>(name_fid);
+    auto nth = names.begin() + names.size() * state.range(2) / 100;
+    std::nth_element(names.begin(), nth, names.end());
+    proto::plan::Expr expr;
+    auto range = expr.mutable_unary_range_expr();
+    SetColumn(range->mutable_column_info(), name_fid);
+    range->set_op(proto::plan::OpType::LessThan);
+    range->mutable_value()->set_string_val(*nth);
+    RunExpr(state, expr);
+}
+
+// name starts with the first state.range(2) digits of a name
+static void
+Expr_StringPrefix(benchmark::State& state) {
+    auto& bench_segment = GetSegment(state.range(0), state.range(1));
+    auto prefix = bench_segment.dataset.get_col<std::string>(name_fid)[0].substr(0, state.range(2));
+    proto::plan::Expr expr;
+    auto range = expr.mutable_unary_range_expr();
+    SetColumn(range->mutable_column_info(), name_fid);
+    range->set_op(proto::plan::OpType::PrefixMatch);
+    range->mutable_value()->set_string_val(prefix);
+    RunExpr(state, expr);
+}
+
+// score > threshold and random < quantile
+static void
+Expr_And(benchmark::State& state) {
+    proto::plan::Expr expr;
+    auto binary = expr.mutable_binary_expr();
+    binary->set_op(proto::plan::BinaryExpr::LogicalAnd);
+    auto left = binary->mutable_left()->mutable_unary_range_expr();
+    SetColumn(left->mutable_column_info(), score_fid);
+    left->set_op(proto::plan::OpType::GreaterThan);
+    left->mutable_value()->set_float_val(0);
+    auto right = binary->mutable_right()->mutable_unary_range_expr();
+    SetColumn(right->mutable_column_info(), random_fid);
+    right->set_op(proto::plan::OpType::LessThan);
+    right->mutable_value()->set_int64_val(Quantile(state.range(1), state.range(2)));
+    RunExpr(state, expr);
+}
+
+static const std::vector<int64_t> kinds = {GrowingSegment, SealedRawSegment, SealedIndexedSegment};
+static const std::vector<int64_t> row_counts = {1 << 16, 1 << 20};
+static const std::vector<int64_t> selectivities = {1, 10, 50, 90};
+
+BENCHMARK(Expr_UnaryRange)->ArgsProduct({kinds, row_counts, selectivities});
+BENCHMARK(Expr_BinaryRange)->ArgsProduct({kinds, row_counts, selectivities});
+BENCHMARK(Expr_Term)->ArgsProduct({kinds, row_counts, {4, 64, 4096}});
+BENCHMARK(Expr_Compare)->ArgsProduct({kinds, row_counts, {0}});
+BENCHMARK(Expr_Arith)->ArgsProduct({kinds, row_counts, selectivities});
+BENCHMARK(Expr_StringRange)->ArgsProduct({kinds, row_counts, selectivities});
+BENCHMARK(Expr_StringPrefix)->ArgsProduct({kinds, row_counts, {1, 2, 4}});
+BENCHMARK(Expr_And)->ArgsProduct({kinds, row_counts, selectivities});
@@ -0,0 +1,364 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <cstdint>
+#include <cstdlib>
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "common/Common.h"
+#include "common/Utils.h"
+#include "config/ConfigChunkManager.h"
+#include "index/ScalarIndexSort.h"
+#include "segcore/SegmentSealedImpl.h"
+#include "storage/LocalChunkManager.h"
+#include "storage/MinioChunkManager.h"
+#include "test_utils/DataGen.h"
+#ifdef BUILD_DISK_ANN
+#include "storage/DiskFileManagerImpl.h"
+#endif
+
+using namespace milvus;
+using namespace milvus::segcore;
+using namespace milvus::storage;
+
+// the minio benchmarks run only with MILVUS_BENCH_MINIO set, against the minio of the default StorageConfig, or
+// the one at MILVUS_BENCH_MINIO_ADDRESS
+namespace {
+
+enum FieldKind : int64_t {
+    FloatVectorField = 0,
+    Int64Field = 1,
+    VarCharField = 2,
+};
+
+constexpr int64_t dim = 128;
+const char* mmap_dir = "./data/bench-mmap";
+
+const auto schema = []() {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    schema->AddDebugField("name", DataType::VARCHAR);
+    return schema;
+}();
+
+const FieldId field_ids[] = {
+    (*schema)[FieldName("fakevec")].get_id(),
+    (*schema)[FieldName("pk")].get_id(),
+    (*schema)[FieldName("name")].get_id(),
+};
+
+GeneratedData&
+GetDataset(int64_t rows) {
+    static std::map<int64_t, std::unique_ptr<GeneratedData>> datasets;
+    auto& dataset = datasets[rows];
+    if (dataset == nullptr) {
+        dataset = std::make_unique<GeneratedData>(DataGen(schema, rows));
+    }
+    return *dataset;
+}
+
+const DataArray&
+GetFieldData(const GeneratedData& dataset, FieldId field_id) {
+    for (auto& field_data : dataset.raw_->fields_data()) {
+        if (field_data.field_id() == field_id.get()) {
+            return field_data;
+        }
+    }
+    PanicInfo("field not generated");
+}
+
+// resident and peak resident memory of the process, in MiB; the peak never goes down, so it only tells about a
+// benchmark run on its own with --benchmark_filter
+void
+ReportMemory(benchmark::State& state) {
+    long pages = 0;
+    std::ifstream("/proc/self/statm") >> pages >> pages;
+    state.counters["rss_mb"] = double(pages) * sysconf(_SC_PAGESIZE) / (1 << 20);
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    state.counters["peak_rss_mb"] = double(usage.ru_maxrss) / (1 << 10);
+}
+
+std::unique_ptr<MinioChunkManager>
+CreateMinioChunkManager() {
+    StorageConfig config;
+    if (auto address = std::getenv("MILVUS_BENCH_MINIO_ADDRESS")) {
+        config.address = address;
+    }
+    auto chunk_manager = std::make_unique<MinioChunkManager>(config);
+    if (!chunk_manager->BucketExists(config.bucket_name)) {
+        chunk_manager->CreateBucket(config.bucket_name);
+    }
+    return chunk_manager;
+}
+
+}  // namespace
+
+// loading one field of a fresh sealed segment, into memory or into a file mapping
+static void
+Load_FieldData(benchmark::State& state) {
+    auto field_id = field_ids[state.range(0)];
+    auto rows = state.range(1);
+    auto with_mmap = state.range(2) != 0;
+    auto& dataset = GetDataset(rows);
+    auto& field_data = GetFieldData(dataset, field_id);
+
+    LoadFieldDataInfo info;
+    info.field_id = field_id.get();
+    info.row_count = rows;
+    info.field_data = &field_data;
+    info.mmap_dir_path = with_mmap ? mmap_dir : nullptr;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto segment = CreateSealedSegment(schema);
+        state.ResumeTiming();
+        segment->LoadFieldData(info);
+        state.PauseTiming();
+        ReportMemory(state);
+        segment.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * field_data.ByteSizeLong());
+}
+
+BENCHMARK(Load_FieldData)
+    ->ArgNames({"field", "rows", "mmap"})
+    ->ArgsProduct({{FloatVectorField, Int64Field, VarCharField}, {1 << 16, 1 << 20}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// CreateMap alone, the anonymous mapping against the file mapping, populated up front or lazily
+static void
+Load_CreateMap(benchmark::State& state) {
+    auto field_id = field_ids[state.range(0)];
+    auto& field_meta = (*schema)[field_id];
+    auto rows = state.range(1);
+    auto with_mmap = state.range(2) != 0;
+    auto& dataset = GetDataset(rows);
+    auto& field_data = GetFieldData(dataset, field_id);
+    auto size = field_meta.get_sizeof() * rows;
+
+    LoadFieldDataInfo info;
+    info.field_id = field_id.get();
+    info.row_count = rows;
+    info.field_data = &field_data;
+    info.mmap_dir_path = with_mmap ? mmap_dir : nullptr;
+    auto lazy = lazy_mmap_populate;
+    SetLazyMmapPopulate(state.range(3) != 0);
+    for (auto _ : state) {
+        auto map = CreateMap(0, field_meta, info);
+        benchmark::DoNotOptimize(map);
+        state.PauseTiming();
+        munmap(map, size);
+        state.ResumeTiming();
+    }
+    SetLazyMmapPopulate(lazy);
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(Load_CreateMap)
+    ->ArgNames({"field", "rows", "mmap", "lazy"})
+    ->ArgsProduct({{FloatVectorField, Int64Field}, {1 << 16, 1 << 20}, {0, 1}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// deserializing a vector index and loading it into a fresh sealed segment
+static void
+Load_VecIndex(benchmark::State& state) {
+    auto rows = state.range(0);
+    auto& dataset = GetDataset(rows);
+    auto vectors = dataset.get_col<float>(field_ids[FloatVectorField]);
+    auto built = GenVecIndexing(rows, dim, vectors.data());
+    auto binary_set = built->Serialize({});
+    int64_t binary_size = 0;
+    for (auto& [name, binary] : binary_set.binary_map_) {
+        binary_size += binary->size;
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto segment = CreateSealedSegment(schema);
+        state.ResumeTiming();
+        auto index = std::make_unique<index::VectorMemNMIndex>(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT,
+                                                               knowhere::metric::L2, IndexMode::MODE_CPU);
+        index->Load(binary_set);
+        LoadIndexInfo info;
+        info.field_id = field_ids[FloatVectorField].get();
+        info.field_type = DataType::VECTOR_FLOAT;
+        info.index_params["metric_type"] = knowhere::metric::L2;
+        info.index = std::move(index);
+        segment->LoadIndex(info);
+        state.PauseTiming();
+        ReportMemory(state);
+        segment.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * binary_size);
+}
+
+BENCHMARK(Load_VecIndex)->Arg(1 << 16)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+// deserializing a sort index of the pks and loading it into a fresh sealed segment
+static void
+Load_ScalarIndex(benchmark::State& state) {
+    auto rows = state.range(0);
+    auto& dataset = GetDataset(rows);
+    auto pks = dataset.get_col<int64_t>(field_ids[Int64Field]);
+    auto built = index::CreateScalarIndexSort<int64_t>();
+    built->Build(rows, pks.data());
+    auto binary_set = built->Serialize({});
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto segment = CreateSealedSegment(schema);
+        state.ResumeTiming();
+        auto index = index::CreateScalarIndexSort<int64_t>();
+        index->Load(binary_set);
+        LoadIndexInfo info;
+        info.field_id = field_ids[Int64Field].get();
+        info.field_type = DataType::INT64;
+        info.index_params["index_type"] = "sort";
+        info.index = std::move(index);
+        segment->LoadIndex(info);
+        state.PauseTiming();
+        segment.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+BENCHMARK(Load_ScalarIndex)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// writing and reading back a file of state.range(0) MiB through the local chunk manager
+static void
+Storage_LocalWriteRead(benchmark::State& state) {
+    auto size = state.range(0) << 20;
+    auto& chunk_manager = LocalChunkManager::GetInstance();
+    std::string path = "/tmp/bench-load/object";
+    chunk_manager.CreateFile(path);
+    std::vector<uint8_t> data(size, 42);
+    std::vector<uint8_t> buf(size);
+    for (auto _ : state) {
+        chunk_manager.Write(path, data.data(), size);
+        chunk_manager.Read(path, buf.data(), size);
+    }
+    chunk_manager.Remove(path);
+    state.SetBytesProcessed(state.iterations() * size * 2);
+}
+
+BENCHMARK(Storage_LocalWriteRead)->Arg(1)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+// uploading an object of state.range(0) MiB in parts of state.range(1) MiB, state.range(2) of them at once
+static void
+Storage_MinioUpload(benchmark::State& state) {
+    auto size = state.range(0) << 20;
+    auto chunk_manager = CreateMinioChunkManager();
+    auto part_size = remote_upload_part_size;
+    auto parallel_degree = remote_upload_parallel_degree;
+    SetRemoteUploadPartSize(state.range(1));
+    SetRemoteUploadParallelDegree(state.range(2));
+    std::vector<uint8_t> data(size, 42);
+    for (auto _ : state) {
+        chunk_manager->Write("bench-load/upload", data.data(), size);
+    }
+    chunk_manager->Remove("bench-load/upload");
+    SetRemoteUploadPartSize(part_size);
+    SetRemoteUploadParallelDegree(parallel_degree);
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+// downloading an object of state.range(0) MiB, in a single read or with ReadAll as the loads do
+static void
+Storage_MinioDownload(benchmark::State& state) {
+    auto size = state.range(0) << 20;
+    auto read_all = state.range(1) != 0;
+    auto chunk_manager = CreateMinioChunkManager();
+    std::vector<uint8_t> data(size, 42);
+    chunk_manager->Write("bench-load/download", data.data(), size);
+    for (auto _ : state) {
+        if (read_all) {
+            auto buf = chunk_manager->ReadAll("bench-load/download");
+            benchmark::DoNotOptimize(buf);
+        } else {
+            chunk_manager->Read("bench-load/download", data.data(), size);
+        }
+    }
+    chunk_manager->Remove("bench-load/download");
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+#ifdef BUILD_DISK_ANN
+// caching a disk index of state.range(0) MiB, uploaded in slices once, to the local disk
+static void
+Storage_CacheIndexToDisk(benchmark::State& state) {
+    auto size = state.range(0) << 20;
+    ChunkMangerConfig::SetLocalRootPath("/tmp/bench-load");
+    auto& local_chunk_manager = LocalChunkManager::GetInstance();
+    auto chunk_manager = CreateMinioChunkManager();
+    std::string index_path = "/tmp/bench-load/index_files/1000/index";
+    local_chunk_manager.CreateFile(index_path);
+    std::vector<uint8_t> data(size, 42);
+    local_chunk_manager.Write(index_path, data.data(), size);
+
+    FieldDataMeta field_data_meta = {1, 2, 3, 100};
+    IndexMeta index_meta = {3, 100, 1000, 1, "index"};
+    DiskFileManagerImpl uploader(field_data_meta, index_meta, StorageConfig{});
+    AssertInfo(uploader.AddFile(index_path), "failed to upload the index");
+    std::vector<std::string> remote_files;
+    for (auto& [file, file_size] : uploader.GetRemotePathsToFileSize()) {
+        remote_files.push_back(file);
+    }
+
+    for (auto _ : state) {
+        DiskFileManagerImpl file_manager(field_data_meta, index_meta, StorageConfig{});
+        file_manager.CacheIndexToDisk(remote_files);
+        state.PauseTiming();
+        ReportMemory(state);
+        state.ResumeTiming();
+    }
+    for (auto& file : remote_files) {
+        chunk_manager->Remove(file);
+    }
+    local_chunk_manager.RemoveDir("/tmp/bench-load");
+    state.SetBytesProcessed(state.iterations() * size);
+}
+#endif
+
+static const bool minio_registered = []() {
+    if (std::getenv("MILVUS_BENCH_MINIO") == nullptr) {
+        return false;
+    }
+    benchmark::RegisterBenchmark("Storage_MinioUpload", Storage_MinioUpload)
+        ->ArgNames({"mb", "part_mb", "parallel"})
+        ->ArgsProduct({{16, 256}, {5, 16, 64}, {1, 4, 16}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark("Storage_MinioDownload", Storage_MinioDownload)
+        ->ArgNames({"mb", "read_all"})
+        ->ArgsProduct({{1, 16, 256}, {0, 1}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+#ifdef BUILD_DISK_ANN
+    benchmark::RegisterBenchmark("Storage_CacheIndexToDisk", Storage_CacheIndexToDisk)
+        ->Arg(64)
+        ->Arg(512)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+#endif
+    return true;
+}();
@@ -0,0 +1,59 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include "common/PerfCounters.h"
+
+namespace milvus {
+
+// with MILVUS_BENCH_PERF set, the hardware counters of the benchmark thread over the loop of state, as user counters
+// per iteration, with the memory traffic the cache misses estimate as a rate. made right before the loop, it counts
+// the PauseTiming sections too, and misses the work of the thread pools
+class BenchPerfCounters {
+ public:
+    explicit BenchPerfCounters(benchmark::State& state) : state_(state) {
+        if (Enabled()) {
+            start_ = ThreadPerfCounters().Read();
+        }
+    }
+
+    ~BenchPerfCounters() {
+        if (!Enabled() || !ThreadPerfCounters().available()) {
+            return;
+        }
+        auto counts = ThreadPerfCounters().Read() - start_;
+        auto per_iteration = [](uint64_t count) {
+            return benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+        };
+        state_.counters["cycles"] = per_iteration(counts.cycles);
+        state_.counters["instructions"] = per_iteration(counts.instructions);
+        state_.counters["ipc"] = counts.ipc();
+        state_.counters["cache_misses"] = per_iteration(counts.cache_misses);
+        state_.counters["branch_misses"] = per_iteration(counts.branch_misses);
+        state_.counters["mem_bw"] =
+            benchmark::Counter(counts.memory_bytes(), benchmark::Counter::kIsRate, benchmark::Counter::kIs1024);
+    }
+
+    static bool
+    Enabled() {
+        static const bool enabled = std::getenv("MILVUS_BENCH_PERF") != nullptr;
+        return enabled;
+    }
+
+ private:
+    benchmark::State& state_;
+    PerfCounts start_;
+};
+
+}  // namespace milvus
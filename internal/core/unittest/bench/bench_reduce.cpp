@@ -0,0 +1,236 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include "bench/bench_perf.h"
+#include "query/Plan.h"
+#include "segcore/Reduce.h"
+#include "segcore/SegmentSealedImpl.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+namespace {
+
+enum PkKind : int64_t {
+    Int64Pk = 0,
+    VarCharPk = 1,
+};
+
+// what the plan outputs besides the pks
+enum OutputKind : int64_t {
+    NoOutput = 0,
+    ScalarOutput = 1,
+    ScalarAndVectorOutput = 2,
+};
+
+constexpr int64_t segment_rows = 1 << 16;
+constexpr int64_t dim = 128;
+
+// the results of every segment point into one sealed segment: equal offsets are equal pks, so the duplicates
+// across segments are the offsets they share
+struct ReduceFixture {
+    SchemaPtr schema;
+    std::unique_ptr<SegmentSealed> segment;
+    std::unique_ptr<Plan> plans[3];
+};
+
+ReduceFixture&
+GetFixture(int64_t pk_kind) {
+    static std::unique_ptr<ReduceFixture> fixtures[2];
+    auto& fixture = fixtures[pk_kind];
+    if (fixture != nullptr) {
+        return *fixture;
+    }
+    fixture = std::make_unique<ReduceFixture>();
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("pk", pk_kind == Int64Pk ? DataType::INT64 : DataType::VARCHAR);
+    schema->set_primary_field_id(pk_fid);
+    auto counter_fid = schema->AddDebugField("counter", DataType::INT64);
+    auto score_fid = schema->AddDebugField("score", DataType::FLOAT);
+    auto name_fid = schema->AddDebugField("name", DataType::VARCHAR);
+    fixture->schema = schema;
+
+    auto dataset = DataGen(schema, segment_rows);
+    fixture->segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *fixture->segment);
+
+    std::vector<std::vector<FieldId>> outputs = {
+        {},
+        {counter_fid, score_fid, name_fid},
+        {counter_fid, score_fid, name_fid, vec_fid},
+    };
+    for (int i = 0; i < 3; ++i) {
+        proto::plan::PlanNode plan_node;
+        auto anns = plan_node.mutable_vector_anns();
+        anns->set_field_id(vec_fid.get());
+        anns->set_placeholder_tag("$0");
+        auto query_info = anns->mutable_query_info();
+        query_info->set_topk(10);
+        query_info->set_metric_type(knowhere::metric::L2);
+        query_info->set_search_params(R"({"nprobe": 10})");
+        for (auto field_id : outputs[i]) {
+            plan_node.add_output_field_ids(field_id.get());
+        }
+        auto binary_plan = plan_node.SerializeAsString();
+        fixture->plans[i] = CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+    }
+    return *fixture;
+}
+
+struct ReduceArgs {
+    int64_t pk_kind;
+    int64_t segments;
+    int64_t nq;
+    int64_t topk;
+    int64_t duplicate_percent;
+    int64_t output;
+
+    explicit ReduceArgs(const benchmark::State& state)
+        : pk_kind(state.range(0)),
+          segments(state.range(1)),
+          nq(state.range(2)),
+          topk(state.range(3)),
+          duplicate_percent(state.range(4)),
+          output(state.range(5)) {
+    }
+};
+
+// topk results per nq of every segment, the best first; duplicate_percent of them are offsets all the segments draw
+// from, the others come from offsets of the segment only
+std::vector<std::unique_ptr<SearchResult>>
+GenSearchResults(const ReduceArgs& args, SegmentSealed& segment, int64_t seed) {
+    std::default_random_engine er(seed);
+    std::uniform_real_distribution<float> distances(0, 1);
+    auto own_rows = segment_rows / (args.segments + 1);
+    std::vector<std::unique_ptr<SearchResult>> results;
+    for (int64_t s = 0; s < args.segments; ++s) {
+        auto result = std::make_unique<SearchResult>();
+        result->total_nq_ = args.nq;
+        result->unity_topK_ = args.topk;
+        result->segment_ = (void*)&segment;
+        result->seg_offsets_.resize(args.nq * args.topk);
+        result->distances_.resize(args.nq * args.topk);
+        for (int64_t i = 0; i < args.nq * args.topk; ++i) {
+            auto shared = int64_t(er() % 100) < args.duplicate_percent;
+            auto range_begin = shared ? 0 : (s + 1) * own_rows;
+            result->seg_offsets_[i] = range_begin + er() % own_rows;
+            result->distances_[i] = distances(er);
+        }
+        for (int64_t q = 0; q < args.nq; ++q) {
+            auto begin = result->distances_.begin() + q * args.topk;
+            std::sort(begin, begin + args.topk, std::greater<float>());
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+// the synthetic results of one iteration, and a ReduceHelper over them
+struct ReduceInput {
+    std::vector<std::unique_ptr<SearchResult>> results;
+    std::vector<SearchResult*> result_ptrs;
+    std::vector<int64_t> slice_nqs;
+    std::vector<int64_t> slice_topks;
+    std::unique_ptr<ReduceHelper> helper;
+
+    ReduceInput(const ReduceArgs& args, ReduceFixture& fixture, int64_t seed)
+        : results(GenSearchResults(args, *fixture.segment, seed)), slice_nqs{args.nq}, slice_topks{args.topk} {
+        for (auto& result : results) {
+            result_ptrs.push_back(result.get());
+        }
+        helper = std::make_unique<ReduceHelper>(result_ptrs, fixture.plans[args.output].get(), slice_nqs.data(),
+                                                slice_topks.data(), slice_nqs.size());
+    }
+};
+
+template <typename Prepare, typename Measure>
+void
+RunReduce(benchmark::State& state, Prepare prepare, Measure measure) {
+    ReduceArgs args(state);
+    auto& fixture = GetFixture(args.pk_kind);
+    int64_t seed = 0;
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto input = std::make_unique<ReduceInput>(args, fixture, seed++);
+        prepare(*input->helper);
+        state.ResumeTiming();
+        measure(*input->helper);
+        state.PauseTiming();
+        input.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * args.segments * args.nq * args.topk);
+}
+
+void
+ReduceArgsProduct(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"pk", "segments", "nq", "topk", "dup%", "output"});
+    for (int64_t pk_kind : {Int64Pk, VarCharPk}) {
+        for (int64_t segments : {2, 8, 32}) {
+            bench->Args({pk_kind, segments, 100, 100, 10, ScalarOutput});
+        }
+        for (auto [nq, topk] : std::vector<std::pair<int64_t, int64_t>>{{1, 1000}, {1000, 10}, {100, 1000}}) {
+            bench->Args({pk_kind, 8, nq, topk, 10, ScalarOutput});
+        }
+        for (int64_t duplicate_percent : {0, 50, 90}) {
+            bench->Args({pk_kind, 8, 100, 100, duplicate_percent, ScalarOutput});
+        }
+        for (int64_t output : {NoOutput, ScalarAndVectorOutput}) {
+            bench->Args({pk_kind, 8, 100, 100, 10, output});
+        }
+    }
+}
+
+}  // namespace
+
+// merging the segments: primary keys, the reduction and the output fields of the rows kept
+static void
+Reduce_Reduce(benchmark::State& state) {
+    RunReduce(
+        state, [](ReduceHelper&) {}, [](ReduceHelper& helper) { helper.Reduce(); });
+}
+
+// marshaling reduced results into SearchResultData
+static void
+Reduce_Marshal(benchmark::State& state) {
+    RunReduce(
+        state, [](ReduceHelper& helper) { helper.Reduce(); },
+        [](ReduceHelper& helper) { helper.Marshal(ResultFormat::Proto); });
+}
+
+// marshaling reduced results into the flat layout
+static void
+Reduce_MarshalFlat(benchmark::State& state) {
+    RunReduce(
+        state, [](ReduceHelper& helper) { helper.Reduce(); },
+        [](ReduceHelper& helper) { helper.Marshal(ResultFormat::Flat); });
+}
+
+// reducing and marshaling a slice at a time
+static void
+Reduce_StreamReduce(benchmark::State& state) {
+    RunReduce(
+        state, [](ReduceHelper&) {}, [](ReduceHelper& helper) { helper.StreamReduce(ResultFormat::Proto); });
+}
+
+BENCHMARK(Reduce_Reduce)->Apply(ReduceArgsProduct);
+BENCHMARK(Reduce_Marshal)->Apply(ReduceArgsProduct);
+BENCHMARK(Reduce_MarshalFlat)->Apply(ReduceArgsProduct);
+BENCHMARK(Reduce_StreamReduce)->Apply(ReduceArgsProduct);
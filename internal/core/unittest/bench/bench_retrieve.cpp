@@ -0,0 +1,188 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <algorithm>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "bench/bench_perf.h"
+#include "query/ExprImpl.h"
+#include "query/Plan.h"
+#include "query/PlanImpl.h"
+#include "segcore/SegmentGrowingImpl.h"
+#include "segcore/SegmentSealedImpl.h"
+#include "test_utils/DataGen.h"
+
+using namespace milvus;
+using namespace milvus::query;
+using namespace milvus::segcore;
+
+// fetching the output fields of given offsets, the gather of bulk_subscript under FillTargetEntry and Retrieve,
+// over the same rows in a growing segment and in sealed ones loaded into memory or into file mappings
+namespace {
+
+enum SegmentKind : int64_t {
+    GrowingSegment = 0,
+    SealedAnonSegment = 1,
+    SealedMmapSegment = 2,
+};
+
+enum FieldKind : int64_t {
+    Int64Field = 0,
+    VarCharField = 1,
+    Vec128Field = 2,
+    Vec768Field = 3,
+    Vec1536Field = 4,
+};
+
+// the order of the offsets fetched: ascending, shuffled, or shuffled runs of consecutive rows
+enum Locality : int64_t {
+    Sorted = 0,
+    Random = 1,
+    Clustered = 2,
+};
+
+constexpr int64_t segment_rows = 1 << 14;
+constexpr int64_t cluster_rows = 64;
+
+const auto schema = []() {
+    auto schema = std::make_shared<Schema>();
+    auto pk_fid = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+    schema->AddDebugField("name", DataType::VARCHAR);
+    schema->AddDebugField("vec128", DataType::VECTOR_FLOAT, 128, knowhere::metric::L2);
+    schema->AddDebugField("vec768", DataType::VECTOR_FLOAT, 768, knowhere::metric::L2);
+    schema->AddDebugField("vec1536", DataType::VECTOR_FLOAT, 1536, knowhere::metric::L2);
+    return schema;
+}();
+
+const FieldId field_ids[] = {
+    (*schema)[FieldName("pk")].get_id(),
+    (*schema)[FieldName("name")].get_id(),
+    (*schema)[FieldName("vec128")].get_id(),
+    (*schema)[FieldName("vec768")].get_id(),
+    (*schema)[FieldName("vec1536")].get_id(),
+};
+
+// the pks are the offsets, so a term expression on them retrieves given offsets
+const SegmentInternalInterface&
+GetSegment(int64_t kind) {
+    static auto dataset = DataGen(schema, segment_rows);
+    static std::unique_ptr<SegmentInternalInterface> segments[3];
+    auto& segment = segments[kind];
+    if (segment == nullptr) {
+        if (kind == GrowingSegment) {
+            auto growing = CreateGrowingSegment(schema);
+            growing->PreInsert(segment_rows);
+            growing->Insert(0, segment_rows, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+            segment = std::move(growing);
+        } else {
+            auto sealed = CreateSealedSegment(schema);
+            SealedLoadFieldData(dataset, *sealed, {}, kind == SealedMmapSegment);
+            segment = std::move(sealed);
+        }
+    }
+    return *segment;
+}
+
+// count distinct offsets
+std::vector<int64_t>
+GenOffsets(int64_t count, int64_t locality) {
+    std::default_random_engine er(42);
+    std::vector<int64_t> offsets;
+    if (locality == Clustered) {
+        std::vector<int64_t> clusters(segment_rows / cluster_rows);
+        std::iota(clusters.begin(), clusters.end(), 0);
+        std::shuffle(clusters.begin(), clusters.end(), er);
+        for (auto cluster : clusters) {
+            for (int64_t i = 0; i < cluster_rows && int64_t(offsets.size()) < count; ++i) {
+                offsets.push_back(cluster * cluster_rows + i);
+            }
+        }
+        return offsets;
+    }
+    offsets.resize(segment_rows);
+    std::iota(offsets.begin(), offsets.end(), 0);
+    std::shuffle(offsets.begin(), offsets.end(), er);
+    offsets.resize(count);
+    if (locality == Sorted) {
+        std::sort(offsets.begin(), offsets.end());
+    }
+    return offsets;
+}
+
+const std::vector<int64_t> counts = {16, 1024, 8192};
+
+}  // namespace
+
+// FillTargetEntry of one output field for count results, each a distinct row, so it is a single bulk_subscript
+static void
+Fetch_FillTargetEntry(benchmark::State& state) {
+    auto& segment = GetSegment(state.range(0));
+    auto field_id = field_ids[state.range(1)];
+    auto offsets = GenOffsets(state.range(2), state.range(3));
+    Plan plan(*schema);
+    plan.target_entries_ = {field_id};
+    SearchResult result;
+    result.seg_offsets_ = offsets;
+    result.distances_.resize(offsets.size());
+    int64_t bytes = 0;
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        segment.FillTargetEntry(&plan, result);
+        state.PauseTiming();
+        bytes = result.output_fields_data_.at(field_id)->ByteSizeLong();
+        result.output_fields_data_.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * offsets.size());
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+BENCHMARK(Fetch_FillTargetEntry)
+    ->ArgNames({"segment", "field", "count", "locality"})
+    ->ArgsProduct({{GrowingSegment, SealedAnonSegment, SealedMmapSegment},
+                   {Int64Field, VarCharField, Vec128Field, Vec768Field, Vec1536Field},
+                   counts,
+                   {Sorted, Random, Clustered}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Retrieve by the pks of count offsets, with the first width + 1 fields as output: the pk alone, then the varchar
+// and the vectors from the narrowest
+static void
+Fetch_Retrieve(benchmark::State& state) {
+    auto& segment = GetSegment(state.range(0));
+    auto width = state.range(1);
+    auto pks = GenOffsets(state.range(2), state.range(3));
+    RetrievePlan plan(*schema);
+    plan.plan_node_ = std::make_shared<RetrievePlanNode>();
+    plan.plan_node_->predicate_ = std::make_unique<TermExprImpl<int64_t>>(field_ids[Int64Field], DataType::INT64, pks);
+    plan.field_ids_.assign(field_ids, field_ids + width + 1);
+    int64_t bytes = 0;
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto results = segment.Retrieve(&plan, MAX_TIMESTAMP);
+        state.PauseTiming();
+        bytes = results->ByteSizeLong();
+        results.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * pks.size());
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+BENCHMARK(Fetch_Retrieve)
+    ->ArgNames({"segment", "width", "count", "locality"})
+    ->ArgsProduct(
+        {{GrowingSegment, SealedAnonSegment, SealedMmapSegment}, {0, 1, 2, 4}, counts, {Sorted, Random, Clustered}})
+    ->Unit(benchmark::kMicrosecond);
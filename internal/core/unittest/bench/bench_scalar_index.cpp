@@ -0,0 +1,358 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <fmt/core.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include "bench/bench_perf.h"
+#include "exceptions/EasyAssert.h"
+#include "index/BitmapIndex.h"
+#include "index/BoolIndex.h"
+#include "index/Meta.h"
+#include "index/ScalarIndexSort.h"
+#include "index/StringIndexMarisa.h"
+#include "index/StringIndexSort.h"
+
+using namespace milvus;
+using namespace milvus::index;
+
+// every index kind of a type over the same columns, so formats compare on equal footing: rows values drawn
+// uniformly from cardinality ones, strings as 8 digit numbers so their order and prefixes follow the numbers
+namespace {
+
+enum IndexKind : int64_t {
+    SortKind = 0,
+    BitmapKind = 1,
+    MarisaKind = 2,
+    BoolKind = 3,
+};
+
+template <typename T>
+T
+Value(int64_t v);
+
+template <>
+int64_t
+Value<int64_t>(int64_t v) {
+    return v;
+}
+
+template <>
+std::string
+Value<std::string>(int64_t v) {
+    return fmt::format("{:08d}", v);
+}
+
+template <>
+bool
+Value<bool>(int64_t v) {
+    return v % 2 != 0;
+}
+
+template <typename T>
+ScalarIndexPtr<T>
+CreateIndex(int64_t kind) {
+    switch (kind) {
+        case SortKind:
+            if constexpr (std::is_same_v<T, std::string>) {
+                return CreateStringIndexSort();
+            } else {
+                return CreateScalarIndexSort<T>();
+            }
+        case BitmapKind:
+            return CreateBitmapIndex<T>();
+        case MarisaKind:
+            if constexpr (std::is_same_v<T, std::string>) {
+                return CreateStringIndexMarisa();
+            }
+            break;
+        case BoolKind:
+            if constexpr (std::is_same_v<T, bool>) {
+                return CreateBoolIndex();
+            }
+            break;
+    }
+    PanicInfo("index kind not benchmarked for the type");
+}
+
+// a unique_ptr rather than a vector, std::vector<bool> has no data()
+template <typename T>
+const T*
+GetColumn(int64_t rows, int64_t cardinality) {
+    static std::map<std::pair<int64_t, int64_t>, std::unique_ptr<T[]>> columns;
+    auto& column = columns[{rows, cardinality}];
+    if (column == nullptr) {
+        std::default_random_engine er(42);
+        column = std::make_unique<T[]>(rows);
+        for (int64_t i = 0; i < rows; ++i) {
+            column[i] = Value<T>(er() % cardinality);
+        }
+    }
+    return column.get();
+}
+
+// built once and shared by the query benchmarks, which don't change it
+template <typename T>
+ScalarIndex<T>&
+GetIndex(int64_t kind, int64_t rows, int64_t cardinality) {
+    static std::map<std::tuple<int64_t, int64_t, int64_t>, ScalarIndexPtr<T>> indexes;
+    auto& index = indexes[{kind, rows, cardinality}];
+    if (index == nullptr) {
+        index = CreateIndex<T>(kind);
+        index->Build(rows, GetColumn<T>(rows, cardinality));
+    }
+    return *index;
+}
+
+// size of the values of an IN list, spread evenly over the cardinality ones
+template <typename T>
+std::unique_ptr<T[]>
+InList(int64_t size, int64_t cardinality) {
+    auto values = std::make_unique<T[]>(size);
+    for (int64_t i = 0; i < size; ++i) {
+        values[i] = Value<T>(i * cardinality / size);
+    }
+    return values;
+}
+
+std::vector<int64_t>
+Kinds(DataType type) {
+    switch (type) {
+        case DataType::INT64:
+            return {SortKind, BitmapKind};
+        case DataType::VARCHAR:
+            return {SortKind, BitmapKind, MarisaKind};
+        default:
+            return {BoolKind, BitmapKind};
+    }
+}
+
+// (kind, rows, cardinality) with the extra args, leaving out the cardinalities a bitmap index can't hold
+template <DataType type>
+void
+IndexArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& extra) {
+    auto names = std::vector<std::string>{"kind", "rows", "cardinality"};
+    if (!extra.empty()) {
+        names.push_back("arg");
+    }
+    b->ArgNames(names);
+    auto cardinalities = type == DataType::BOOL ? std::vector<int64_t>{2} : std::vector<int64_t>{16, 256, 1 << 16};
+    for (auto kind : Kinds(type)) {
+        for (int64_t rows : {1 << 16, 1 << 20}) {
+            for (auto cardinality : cardinalities) {
+                if (kind == BitmapKind && cardinality > int64_t(BITMAP_INDEX_MAX_VALUES)) {
+                    continue;
+                }
+                if (extra.empty()) {
+                    b->Args({kind, rows, cardinality});
+                }
+                for (auto arg : extra) {
+                    b->Args({kind, rows, cardinality, arg});
+                }
+            }
+        }
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+template <DataType type>
+void
+PlainArgs(benchmark::internal::Benchmark* b) {
+    IndexArgs<type>(b, {});
+}
+
+// the size of the IN list
+template <DataType type>
+void
+InArgs(benchmark::internal::Benchmark* b) {
+    IndexArgs<type>(b, {1, 16, 256});
+}
+
+// the percent of the cardinality values a range covers
+template <DataType type>
+void
+RangeArgs(benchmark::internal::Benchmark* b) {
+    IndexArgs<type>(b, {1, 10, 50, 90});
+}
+
+// the trailing digits a prefix leaves out, it matches 10^arg values
+void
+PrefixArgs(benchmark::internal::Benchmark* b) {
+    IndexArgs<DataType::VARCHAR>(b, {0, 2, 4});
+}
+
+// one lookup at a time against a batch of them
+template <DataType type>
+void
+LookupArgs(benchmark::internal::Benchmark* b) {
+    IndexArgs<type>(b, {0, 1});
+}
+
+}  // namespace
+
+template <typename T>
+static void
+ScalarIndex_Build(benchmark::State& state) {
+    auto kind = state.range(0);
+    auto rows = state.range(1);
+    auto values = GetColumn<T>(rows, state.range(2));
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto index = CreateIndex<T>(kind);
+        index->Build(rows, values);
+        benchmark::DoNotOptimize(index);
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+BENCHMARK_TEMPLATE(ScalarIndex_Build, int64_t)->Apply(PlainArgs<DataType::INT64>);
+BENCHMARK_TEMPLATE(ScalarIndex_Build, std::string)->Apply(PlainArgs<DataType::VARCHAR>);
+BENCHMARK_TEMPLATE(ScalarIndex_Build, bool)->Apply(PlainArgs<DataType::BOOL>);
+
+template <typename T>
+static void
+ScalarIndex_Serialize(benchmark::State& state) {
+    auto& index = GetIndex<T>(state.range(0), state.range(1), state.range(2));
+    int64_t size = 0;
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto binary_set = index.Serialize({});
+        state.PauseTiming();
+        size = 0;
+        for (auto& [name, binary] : binary_set.binary_map_) {
+            size += binary->size;
+        }
+        state.ResumeTiming();
+    }
+    state.counters["index_bytes"] = size;
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK_TEMPLATE(ScalarIndex_Serialize, int64_t)->Apply(PlainArgs<DataType::INT64>);
+BENCHMARK_TEMPLATE(ScalarIndex_Serialize, std::string)->Apply(PlainArgs<DataType::VARCHAR>);
+BENCHMARK_TEMPLATE(ScalarIndex_Serialize, bool)->Apply(PlainArgs<DataType::BOOL>);
+
+template <typename T>
+static void
+ScalarIndex_Load(benchmark::State& state) {
+    auto kind = state.range(0);
+    auto binary_set = GetIndex<T>(kind, state.range(1), state.range(2)).Serialize({});
+    int64_t size = 0;
+    for (auto& [name, binary] : binary_set.binary_map_) {
+        size += binary->size;
+    }
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto index = CreateIndex<T>(kind);
+        index->Load(binary_set);
+        benchmark::DoNotOptimize(index);
+    }
+    state.counters["index_bytes"] = size;
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK_TEMPLATE(ScalarIndex_Load, int64_t)->Apply(PlainArgs<DataType::INT64>);
+BENCHMARK_TEMPLATE(ScalarIndex_Load, std::string)->Apply(PlainArgs<DataType::VARCHAR>);
+BENCHMARK_TEMPLATE(ScalarIndex_Load, bool)->Apply(PlainArgs<DataType::BOOL>);
+
+template <typename T, bool not_in>
+static void
+ScalarIndex_In(benchmark::State& state) {
+    auto& index = GetIndex<T>(state.range(0), state.range(1), state.range(2));
+    auto size = std::min(state.range(3), state.range(2));
+    auto values = InList<T>(size, state.range(2));
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto bitset = not_in ? index.NotIn(size, values.get()) : index.In(size, values.get());
+        benchmark::DoNotOptimize(bitset);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK_TEMPLATE(ScalarIndex_In, int64_t, false)->Apply(InArgs<DataType::INT64>);
+BENCHMARK_TEMPLATE(ScalarIndex_In, std::string, false)->Apply(InArgs<DataType::VARCHAR>);
+BENCHMARK_TEMPLATE(ScalarIndex_In, bool, false)->Apply(InArgs<DataType::BOOL>);
+BENCHMARK_TEMPLATE(ScalarIndex_In, int64_t, true)->Apply(InArgs<DataType::INT64>);
+BENCHMARK_TEMPLATE(ScalarIndex_In, std::string, true)->Apply(InArgs<DataType::VARCHAR>);
+BENCHMARK_TEMPLATE(ScalarIndex_In, bool, true)->Apply(InArgs<DataType::BOOL>);
+
+// [0, upper) over the values, upper set by the selectivity
+template <typename T>
+static void
+ScalarIndex_Range(benchmark::State& state) {
+    auto& index = GetIndex<T>(state.range(0), state.range(1), state.range(2));
+    auto lower = Value<T>(0);
+    auto upper = Value<T>(state.range(2) * state.range(3) / 100);
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto bitset = index.Range(lower, true, upper, false);
+        benchmark::DoNotOptimize(bitset);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK_TEMPLATE(ScalarIndex_Range, int64_t)->Apply(RangeArgs<DataType::INT64>);
+BENCHMARK_TEMPLATE(ScalarIndex_Range, std::string)->Apply(RangeArgs<DataType::VARCHAR>);
+
+static void
+StringIndex_PrefixMatch(benchmark::State& state) {
+    auto& index = GetIndex<std::string>(state.range(0), state.range(1), state.range(2));
+    auto prefix = Value<std::string>(0);
+    prefix.resize(prefix.size() - state.range(3));
+    auto ds = std::make_shared<knowhere::DataSet>();
+    ds->Set<OpType>(OPERATOR_TYPE, OpType::PrefixMatch);
+    ds->Set<std::string>(PREFIX_VALUE, prefix);
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        auto bitset = index.Query(ds);
+        benchmark::DoNotOptimize(bitset);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(StringIndex_PrefixMatch)->Apply(PrefixArgs);
+
+// 1024 random rows per iteration, by Reverse_Lookup or by one ReverseLookupBatch
+template <typename T>
+static void
+ScalarIndex_ReverseLookup(benchmark::State& state) {
+    constexpr int64_t count = 1024;
+    auto& index = GetIndex<T>(state.range(0), state.range(1), state.range(2));
+    auto batch = state.range(3) != 0;
+    std::default_random_engine er(42);
+    std::vector<int64_t> offsets(count);
+    for (auto& offset : offsets) {
+        offset = er() % state.range(1);
+    }
+    auto out = std::make_unique<T[]>(count);
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        if (batch) {
+            index.ReverseLookupBatch(offsets.data(), count, out.get());
+        } else {
+            for (int64_t i = 0; i < count; ++i) {
+                out[i] = index.Reverse_Lookup(offsets[i]);
+            }
+        }
+        benchmark::DoNotOptimize(out[count - 1]);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(ScalarIndex_ReverseLookup, int64_t)->Apply(LookupArgs<DataType::INT64>);
+BENCHMARK_TEMPLATE(ScalarIndex_ReverseLookup, std::string)->Apply(LookupArgs<DataType::VARCHAR>);
+BENCHMARK_TEMPLATE(ScalarIndex_ReverseLookup, bool)->Apply(LookupArgs<DataType::BOOL>);
@@ -12,6 +12,9 @@
 #include <cstdint>
 #include <benchmark/benchmark.h>
 #include <string>
+#include "bench/bench_perf.h"
+#include "knowhere/comp/brute_force.h"
+#include "query/SearchBruteForce.h"
 #include "segcore/SegmentGrowing.h"
 #include "segcore/SegmentSealed.h"
 #include "test_utils/DataGen.h"
@@ -83,6 +86,7 @@ Search_SmallIndex(benchmark::State& state) {
 
     Timestamp time = 10000000;
 
+    BenchPerfCounters perf(state);
     for (auto _ : state) {
         auto qr = segment->Search(plan.get(), ph_group.get(), time);
     }
@@ -116,9 +120,54 @@ Search_Sealed(benchmark::State& state) {
         segment->LoadIndex(info);
     }
     Timestamp time = 10000000;
+    BenchPerfCounters perf(state);
     for (auto _ : state) {
         auto qr = segment->Search(plan.get(), ph_group.get(), time);
     }
 }
 
 BENCHMARK(Search_Sealed)->MinTime(5)->Arg(1)->Arg(0);
+
+// binary brute force over one chunk, by knowhere when state.range(0) is 1 or else the popcount kernels of
+// BinaryBruteForceSearch, then the metric (0 HAMMING, 1 JACCARD) and the dimension in bits
+static void
+Search_BinaryBruteForce(benchmark::State& state) {
+    auto use_knowhere = state.range(0) == 1;
+    std::string metric = state.range(1) == 0 ? knowhere::metric::HAMMING : knowhere::metric::JACCARD;
+    int64_t bin_dim = state.range(2);
+    int64_t nb = 1 << 16;
+    int64_t nq = 10;
+    int64_t topk = 10;
+    auto bin_schema = std::make_shared<Schema>();
+    auto bvec = bin_schema->AddDebugField("bvec", DataType::VECTOR_BINARY, bin_dim, metric);
+    auto base = DataGen(bin_schema, nb).get_col<uint8_t>(bvec);
+    auto query = DataGen(bin_schema, nq, 43).get_col<uint8_t>(bvec);
+    BitsetType bitset(nb);
+    BitsetView bitset_view(bitset);
+
+    dataset::SearchDataset dataset{metric, nq, topk, -1, bin_dim, query.data()};
+    auto base_dataset = knowhere::GenDataSet(nb, bin_dim, base.data());
+    auto query_dataset = knowhere::GenDataSet(nq, bin_dim, query.data());
+    knowhere::Json config{
+        {knowhere::meta::METRIC_TYPE, metric},
+        {knowhere::meta::DIM, bin_dim},
+        {knowhere::meta::TOPK, topk},
+    };
+    std::vector<int64_t> ids(nq * topk);
+    std::vector<float> distances(nq * topk);
+    BenchPerfCounters perf(state);
+    for (auto _ : state) {
+        if (use_knowhere) {
+            knowhere::BruteForce::SearchWithBuf(base_dataset, query_dataset, ids.data(), distances.data(), config,
+                                                bitset_view);
+        } else {
+            auto result = BinaryBruteForceSearch(dataset, base.data(), nb, bitset_view);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * nb * nq);
+}
+
+BENCHMARK(Search_BinaryBruteForce)
+    ->ArgNames({"knowhere", "metric", "dim"})
+    ->ArgsProduct({{0, 1}, {0, 1}, {256, 1024}});
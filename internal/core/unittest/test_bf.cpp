@@ -15,6 +15,8 @@
 #include "common/Utils.h"
 
 #include "query/SearchBruteForce.h"
+#include "query/SparseSearch.h"
+#include "simd/hook.h"
 #include "test_utils/Distance.h"
 #include "test_utils/DataGen.h"
 
@@ -120,7 +122,7 @@ class TestFloatSearchBruteForce : public ::testing::Test {
             // ASSERT_ANY_THROW(BruteForceSearch(dataset, base.data(), nb, bitset_view));
             return;
         }
-        auto result = BruteForceSearch(dataset, base.data(), nb, knowhere::Json(), bitset_view);
+        auto result = BruteForceSearch(dataset, base.data(), nb, milvus::SearchParams(), bitset_view);
         for (int i = 0; i < nq; i++) {
             auto ref = Ref(base.data(), query.data() + i * dim, nb, dim, topk, metric_type);
             auto ans = result.get_seg_offsets() + i * topk;
@@ -142,3 +144,203 @@ TEST_F(TestFloatSearchBruteForce, IP) {
 TEST_F(TestFloatSearchBruteForce, NotSupported) {
     Run(100, 10, 5, 128, "aaaaaaaaaaaa");
 }
+
+TEST(RangeSearchBound, Narrow) {
+    int64_t topk = 2;
+    RangeSearchBound l2_bound(2, knowhere::metric::L2, 10);
+    SubSearchResult chunk1(2, topk, knowhere::metric::L2, -1);
+    chunk1.mutable_seg_offsets() = {1, 2, 5, INVALID_SEG_OFFSET};
+    chunk1.mutable_distances() = {1, 3, 2, std::numeric_limits<float>::max()};
+    l2_bound.Update(chunk1);
+    // the second query has no topk yet
+    ASSERT_EQ(l2_bound.Radius(), 10);
+
+    SubSearchResult chunk2(2, topk, knowhere::metric::L2, -1);
+    chunk2.mutable_seg_offsets() = {3, 4, 7, 8};
+    chunk2.mutable_distances() = {5, 6, 0.5, 4};
+    l2_bound.Update(chunk2);
+    // a worse topk never loosens the bound of the first query
+    ASSERT_FLOAT_EQ(l2_bound.Radius(), 4);
+    ASSERT_GT(l2_bound.Radius(), 4);
+
+    RangeSearchBound ip_bound(1, knowhere::metric::IP, 0.1);
+    SubSearchResult chunk3(1, topk, knowhere::metric::IP, -1);
+    chunk3.mutable_seg_offsets() = {1, 2};
+    chunk3.mutable_distances() = {0.9, 0.8};
+    ip_bound.Update(chunk3);
+    ASSERT_FLOAT_EQ(ip_bound.Radius(), 0.8);
+    ASSERT_LT(ip_bound.Radius(), 0.8f);
+
+    // hits beyond the bound of their query are dropped, ties with it kept
+    std::vector<int64_t> seg_offsets{3, 4, 5};
+    std::vector<float> distances{0.85, 0.8, 0.7};
+    ASSERT_EQ(ip_bound.Prune(3, seg_offsets.data(), distances.data()), 1);
+    ASSERT_EQ(seg_offsets, (std::vector<int64_t>{3, 4, INVALID_SEG_OFFSET}));
+}
+
+TEST(SearchParams, ParsedOnce) {
+    SearchInfo info;
+    info.topk_ = 10;
+    info.round_decimal_ = -1;
+    info.metric_type_ = knowhere::metric::L2;
+    info.search_params_ = {{"nprobe", 16}, {RADIUS, 20}, {RANGE_FILTER, 1.5}};
+    ParseSearchParams(info);
+    auto params = info.params_;
+    ASSERT_FLOAT_EQ(params->radius_.value(), 20);
+    ASSERT_FLOAT_EQ(params->range_filter_.value(), 1.5);
+    ASSERT_EQ(params->index_conf_[knowhere::meta::TOPK], 10);
+    ASSERT_EQ(params->index_conf_["nprobe"], 16);
+
+    // copies share the params, a conf for another topk is a copy
+    SearchInfo copy(info);
+    copy.topk_ = 5;
+    ASSERT_EQ(copy.GetParams(), params);
+    knowhere::Json scratch;
+    ASSERT_EQ(&params->IndexConf(10, knowhere::metric::L2, scratch), &params->index_conf_);
+    auto& conf = params->IndexConf(copy.topk_, knowhere::metric::L2, scratch);
+    ASSERT_EQ(&conf, &scratch);
+    ASSERT_EQ(conf[knowhere::meta::TOPK], 5);
+
+    // an info built by hand is parsed on use
+    SearchInfo plain;
+    plain.topk_ = 1;
+    plain.metric_type_ = knowhere::metric::IP;
+    plain.search_params_ = {{"ef", 64}};
+    ASSERT_FALSE(plain.GetParams()->radius_.has_value());
+    ASSERT_EQ(plain.GetParams()->text_, plain.search_params_.dump());
+}
+
+TEST(NormBruteForce, MatchesKnowhere) {
+    int64_t nb = 3000;
+    int64_t dim = 32;
+    int64_t topk = 10;
+    auto base = GenFloatVecs(dim, nb, knowhere::metric::L2);
+    auto query = GenFloatVecs(dim, 6, knowhere::metric::L2, 7);
+    std::vector<float> norms(nb);
+    simd::SquaredNorms(base.data(), dim, nb, norms.data());
+    BitsetType bitset(nb);
+    for (int64_t i = 0; i < nb; i += 3) {
+        bitset.set(i);
+    }
+
+    for (int64_t nq : {1, 6}) {
+        dataset::SearchDataset dataset{knowhere::metric::L2, nq, topk, -1, dim, query.data()};
+        auto expected = BruteForceSearch(dataset, base.data(), nb, SearchParams(), BitsetView(bitset));
+        auto result =
+            BruteForceSearch(dataset, base.data(), nb, SearchParams(), BitsetView(bitset), nullptr, norms.data());
+        ASSERT_EQ(result.mutable_seg_offsets(), expected.mutable_seg_offsets()) << nq;
+        for (int64_t i = 0; i < nq * topk; ++i) {
+            ASSERT_NEAR(result.get_distances()[i], expected.get_distances()[i], 1e-3);
+        }
+    }
+}
+
+TEST(BinaryBruteForce, HammingJaccard) {
+    int64_t nb = 3000;
+    int64_t nq = 5;
+    int64_t topk = 20;
+    int64_t dim = 200;
+    auto code_size = dim / 8;
+    auto schema = std::make_shared<Schema>();
+    auto bvec = schema->AddDebugField("bvec", DataType::VECTOR_BINARY, dim, knowhere::metric::HAMMING);
+    auto base = DataGen(schema, nb, 42).get_col<uint8_t>(bvec);
+    auto query = DataGen(schema, nq, 43).get_col<uint8_t>(bvec);
+
+    BitsetType bitset(nb);
+    for (int64_t i = 0; i < nb; i += 3) {
+        bitset.set(i);
+    }
+    BitsetView bitset_view(bitset);
+
+    for (std::string metric : {knowhere::metric::HAMMING, knowhere::metric::JACCARD}) {
+        bool is_jaccard = metric == knowhere::metric::JACCARD;
+        dataset::SearchDataset dataset{metric, nq, topk, -1, dim, query.data()};
+        auto result = BruteForceSearch(dataset, base.data(), nb, milvus::SearchParams(), bitset_view);
+        for (int64_t q = 0; q < nq; ++q) {
+            // the nearest unfiltered rows, ties by offset
+            std::vector<std::tuple<float, int64_t>> ref;
+            for (int64_t i = 0; i < nb; ++i) {
+                if (bitset[i]) {
+                    continue;
+                }
+                int64_t diff = 0, intersection = 0, union_ = 0;
+                for (int64_t b = 0; b < code_size; ++b) {
+                    auto x = query[q * code_size + b];
+                    auto y = base[i * code_size + b];
+                    diff += __builtin_popcount(x ^ y);
+                    intersection += __builtin_popcount(x & y);
+                    union_ += __builtin_popcount(x | y);
+                }
+                ref.emplace_back(is_jaccard ? 1 - float(intersection) / float(union_) : float(diff), i);
+            }
+            std::sort(ref.begin(), ref.end());
+            for (int64_t k = 0; k < topk; ++k) {
+                auto [distance, offset] = ref[k];
+                ASSERT_EQ(result.get_seg_offsets()[q * topk + k], offset) << metric << " " << q << " " << k;
+                ASSERT_EQ(result.get_distances()[q * topk + k], distance) << metric << " " << q << " " << k;
+            }
+        }
+    }
+
+    // fewer unfiltered rows than topk leave the rest of the results empty
+    BitsetType most(nb);
+    most.set();
+    most.reset(7);
+    dataset::SearchDataset dataset{knowhere::metric::HAMMING, 1, topk, -1, dim, query.data()};
+    auto result = BinaryBruteForceSearch(dataset, base.data(), nb, BitsetView(most));
+    ASSERT_EQ(result.get_seg_offsets()[0], 7);
+    for (int64_t k = 1; k < topk; ++k) {
+        ASSERT_EQ(result.get_seg_offsets()[k], INVALID_SEG_OFFSET);
+    }
+}
+
+TEST(SparseBruteForce, InvertedIndexMatches) {
+    int64_t nb = 2000;
+    int64_t nq = 8;
+    int64_t topk = 10;
+    // small whole values, so the sums are exact in any order
+    auto gen_rows = [](int64_t n, int64_t seed, bool negative) {
+        std::default_random_engine e(seed);
+        std::vector<SparseFloatRow> rows;
+        for (int64_t i = 0; i < n; ++i) {
+            std::vector<uint32_t> indices;
+            std::vector<float> values;
+            for (uint32_t d = 0; d < 64; ++d) {
+                if (e() % 8 == 0) {
+                    indices.push_back(d);
+                    values.push_back(float(e() % 5) + 1 - (negative ? 3 : 0));
+                }
+            }
+            rows.emplace_back(std::move(indices), std::move(values));
+        }
+        return rows;
+    };
+    BitsetType bitset(nb);
+    for (int64_t i = 0; i < nb; i += 3) {
+        bitset.set(i);
+    }
+
+    for (bool negative : {false, true}) {
+        auto rows = gen_rows(nb, 42, negative);
+        auto queries = gen_rows(nq, 7, negative);
+        SparseInvertedIndex index(rows.data(), nb);
+        ASSERT_EQ(index.size(), nb);
+        for (auto view : {BitsetView(), BitsetView(bitset)}) {
+            auto expected = SparseBruteForceSearch(queries.data(), nq, rows.data(), nb, topk, -1, view);
+            auto result = index.Search(queries.data(), nq, topk, -1, view, nullptr);
+            ASSERT_EQ(result.mutable_seg_offsets(), expected.mutable_seg_offsets()) << negative;
+            ASSERT_EQ(result.mutable_distances(), expected.mutable_distances()) << negative;
+            for (int64_t i = 0; i < nq * topk; ++i) {
+                auto offset = result.get_seg_offsets()[i];
+                ASSERT_NE(offset, INVALID_SEG_OFFSET);
+                ASSERT_FALSE(!view.empty() && view.test(offset));
+                ASSERT_EQ(result.get_distances()[i], queries[i / topk].dot(rows[offset]));
+            }
+        }
+    }
+
+    // rows sharing no dimension with a query are not hits
+    SparseFloatRow query({100}, {1});
+    auto result = SparseBruteForceSearch(&query, 1, gen_rows(nb, 42, false).data(), nb, topk, -1, BitsetView());
+    ASSERT_EQ(result.get_seg_offsets()[0], INVALID_SEG_OFFSET);
+}
@@ -10,6 +10,10 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <random>
+
+#include "common/BitsetView.h"
+#include "common/CompressedBitset.h"
 #include "test_utils/DataGen.h"
 #include "index/ScalarIndexSort.h"
 
@@ -34,4 +38,256 @@ TEST(Bitmap, Naive) {
         double count = res->count();
         ASSERT_NEAR(count / N, 0.682, 0.01);
     }
-}
\ No newline at end of file
+}
+
+TEST(Bitmap, Bitset) {
+    using namespace milvus;
+
+    std::mt19937 gen(42);
+    for (int iter = 0; iter < 1000; ++iter) {
+        size_t n = gen() % 1000;
+        BitsetType bitset(n, iter % 2 == 0);
+        BitsetType other(n);
+        std::vector<bool> ref(n, iter % 2 == 0);
+        std::vector<bool> other_ref(n);
+        for (int k = 0; k < 10; ++k) {
+            auto pos = n == 0 ? 0 : gen() % n;
+            auto len = gen() % (n - pos + 1);
+            auto value = gen() % 2 == 0;
+            bitset.set(pos, len, value);
+            for (size_t i = pos; i < pos + len; ++i) {
+                ref[i] = value;
+            }
+            if (n > 0) {
+                other[pos] = true;
+                other_ref[pos] = true;
+            }
+            switch (gen() % 5) {
+                case 0:
+                    bitset &= other;
+                    for (size_t i = 0; i < n; ++i) {
+                        ref[i] = ref[i] && other_ref[i];
+                    }
+                    break;
+                case 1:
+                    bitset |= other;
+                    for (size_t i = 0; i < n; ++i) {
+                        ref[i] = ref[i] || other_ref[i];
+                    }
+                    break;
+                case 2:
+                    bitset ^= other;
+                    for (size_t i = 0; i < n; ++i) {
+                        ref[i] = ref[i] != other_ref[i];
+                    }
+                    break;
+                case 3:
+                    bitset -= other;
+                    for (size_t i = 0; i < n; ++i) {
+                        ref[i] = ref[i] && !other_ref[i];
+                    }
+                    break;
+                default:
+                    bitset.flip();
+                    ref.flip();
+            }
+        }
+
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(bitset.data()) % 64, 0);
+        ASSERT_EQ(bitset.size(), n);
+        size_t count = 0;
+        size_t first = BitsetType::npos;
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(bitset.test(i), bool(ref[i])) << iter << "@" << i;
+            if (ref[i]) {
+                count++;
+                first = std::min(first, i);
+            }
+        }
+        ASSERT_EQ(bitset.count(), count);
+        ASSERT_EQ(bitset.any(), count > 0);
+        ASSERT_EQ(bitset.none(), count == 0);
+        ASSERT_EQ(bitset.all(), count == n);
+        ASSERT_EQ(bitset.find_first(), first);
+        size_t visited = 0;
+        for (auto i = bitset.find_first(); i != BitsetType::npos; i = bitset.find_next(i)) {
+            ASSERT_TRUE(ref[i]);
+            visited++;
+        }
+        ASSERT_EQ(visited, count);
+
+        // the view shares the storage of the bitset
+        BitsetView view = bitset;
+        ASSERT_EQ(view.size(), n);
+        if (n > 0) {
+            ASSERT_EQ(view.data(), reinterpret_cast<const uint8_t*>(bitset.data()));
+        }
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(view.test(i), bool(ref[i]));
+        }
+    }
+
+    BitsetType bitset(70);
+    bitset.resize(130, true);
+    ASSERT_EQ(bitset.count(), 60);
+    ASSERT_EQ(bitset.find_first(), 70);
+    bitset.resize(100);
+    ASSERT_EQ(bitset.count(), 30);
+    bitset.set();
+    ASSERT_TRUE(bitset.all());
+    ASSERT_EQ(bitset.count(), 100);
+    ASSERT_TRUE(BitsetType().all());
+}
+
+TEST(Bitmap, CompressedBitset) {
+    using namespace milvus;
+    using Container = CompressedBitset::Container;
+    std::mt19937 rng(11);
+
+    // random sets of each density, built the way the visitor builds them
+    auto gen = [&](size_t n, std::vector<bool>& ref) {
+        ref.assign(n, false);
+        auto kind = rng() % 4;
+        if (kind == 0) {
+            std::vector<CompressedBitset::offset_type> offsets;
+            for (size_t i = 0; i < n / 100 + 1; ++i) {
+                auto pos = rng() % n;
+                offsets.push_back(pos);
+                ref[pos] = true;
+            }
+            return CompressedBitset::from_offsets(n, std::move(offsets));
+        }
+        BitsetType dense(n);
+        for (size_t i = 0; i < n;) {
+            // kind 1: random bits, kind 2: long runs, kind 3: mostly set
+            auto len = kind == 2 ? rng() % 300 + 1 : 1;
+            auto value = kind == 3 ? rng() % 8 != 0 : rng() % 2 == 0;
+            for (auto end = std::min(n, i + len); i < end; ++i) {
+                dense[i] = value;
+                ref[i] = value;
+            }
+        }
+        return CompressedBitset::compress(std::move(dense));
+    };
+    auto check = [](const CompressedBitset& bitset, const std::vector<bool>& ref) {
+        ASSERT_EQ(bitset.size(), ref.size());
+        auto dense = bitset.to_dense();
+        size_t count = 0;
+        for (size_t i = 0; i < ref.size(); ++i) {
+            ASSERT_EQ(bitset.test(i), bool(ref[i]));
+            ASSERT_EQ(dense[i], bool(ref[i]));
+            count += ref[i];
+        }
+        ASSERT_EQ(bitset.count(), count);
+        ASSERT_EQ(dense.count(), count);
+    };
+
+    int containers[3] = {0, 0, 0};
+    for (int iter = 0; iter < 1000; ++iter) {
+        auto n = rng() % 3000 + 1;
+        std::vector<bool> x, y;
+        auto left = gen(n, x);
+        auto right = gen(n, y);
+        containers[int(left.container())]++;
+        check(left, x);
+        check(right, y);
+
+        auto op = rng() % 5;
+        for (size_t i = 0; i < n; ++i) {
+            switch (op) {
+                case 0:
+                    x[i] = x[i] && y[i];
+                    break;
+                case 1:
+                    x[i] = x[i] || y[i];
+                    break;
+                case 2:
+                    x[i] = x[i] != y[i];
+                    break;
+                case 3:
+                    x[i] = x[i] && !y[i];
+                    break;
+                default:
+                    x[i] = !x[i];
+            }
+        }
+        switch (op) {
+            case 0:
+                left &= right;
+                break;
+            case 1:
+                left |= right;
+                break;
+            case 2:
+                left ^= right;
+                break;
+            case 3:
+                left -= right;
+                break;
+            default:
+                left.flip();
+        }
+        check(left, x);
+        auto optimized = left;
+        optimized.optimize();
+        ASSERT_EQ(optimized, left);
+    }
+    for (auto count : containers) {
+        ASSERT_GT(count, 0);
+    }
+
+    // the smallest container is chosen
+    BitsetType dense(1 << 16);
+    ASSERT_EQ(CompressedBitset::compress(BitsetType(dense)).container(), Container::Array);
+    dense.set(100, 30000, true);
+    auto runs = CompressedBitset::compress(BitsetType(dense));
+    ASSERT_EQ(runs.container(), Container::Run);
+    ASSERT_EQ(runs.memory_usage(), 2 * sizeof(CompressedBitset::offset_type));
+    for (size_t i = 0; i < dense.size(); i += 2) {
+        dense[i] = true;
+    }
+    ASSERT_EQ(CompressedBitset::compress(BitsetType(dense)).container(), Container::Dense);
+
+    // a sparse set intersected with a dense one stays sparse
+    auto sparse = CompressedBitset::from_offsets(dense.size(), {1, 3, 200, 40000});
+    sparse &= CompressedBitset(dense);
+    ASSERT_EQ(sparse.container(), Container::Array);
+    ASSERT_EQ(sparse.count(), 2);
+    ASSERT_TRUE(sparse.test(200));
+    ASSERT_TRUE(sparse.test(40000));
+}
+
+TEST(Bitmap, CompressedIndexResults) {
+    using namespace milvus;
+    using Container = CompressedBitset::Container;
+    int N = 100000;
+    std::vector<int64_t> values(N);
+    for (int i = 0; i < N; ++i) {
+        values[i] = i % 1000;
+    }
+    auto sort_index = std::make_shared<index::ScalarIndexSort<int64_t>>();
+    sort_index->Build(N, values.data());
+
+    auto expect_same = [](const CompressedBitset& compressed, const TargetBitmap& bitmap) {
+        ASSERT_EQ(compressed.to_dense(), bitmap);
+    };
+    std::vector<int64_t> terms{1, 7, 999, 5000};
+    auto in = sort_index->InCompressed(terms.size(), terms.data());
+    ASSERT_EQ(in.container(), Container::Array);
+    ASSERT_EQ(in.count(), 300);
+    expect_same(in, *sort_index->In(terms.size(), terms.data()));
+
+    auto narrow = sort_index->RangeCompressed(10, true, 12, false);
+    ASSERT_EQ(narrow.container(), Container::Array);
+    expect_same(narrow, *sort_index->Range(10, true, 12, false));
+
+    // every value covers rows i * 1000 + value, so a wide range is one run
+    // per thousand rows
+    auto wide = sort_index->RangeCompressed(500, OpType::LessThan);
+    ASSERT_EQ(wide.container(), Container::Run);
+    expect_same(wide, *sort_index->Range(500, OpType::LessThan));
+
+    auto empty = sort_index->RangeCompressed(12, false, 10, true);
+    ASSERT_TRUE(empty.none());
+    ASSERT_EQ(empty.size(), N);
+}
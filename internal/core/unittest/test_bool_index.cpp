@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 #include <pb/schema.pb.h>
 #include <index/BoolIndex.h>
+#include <index/ScalarIndexSort.h>
 #include "test_utils/indexbuilder_test_utils.h"
 
 class BoolIndexTest : public ::testing::Test {
@@ -206,3 +207,59 @@ TEST_F(BoolIndexTest, Codec) {
         }
     }
 }
+
+TEST_F(BoolIndexTest, Range) {
+    auto index = milvus::index::CreateBoolIndex();
+    index->Build(half.data_size(), half.data().data());
+    using milvus::OpType;
+    struct Case {
+        bool value;
+        OpType op;
+        bool has_false;
+        bool has_true;
+    };
+    std::vector<Case> cases{
+        {true, OpType::LessThan, true, false},      {false, OpType::LessThan, false, false},
+        {false, OpType::LessEqual, true, false},    {true, OpType::LessEqual, true, true},
+        {false, OpType::GreaterThan, false, true},  {true, OpType::GreaterThan, false, false},
+        {true, OpType::GreaterEqual, false, true},  {false, OpType::GreaterEqual, true, true},
+    };
+    for (auto& c : cases) {
+        auto bitset = index->Range(c.value, c.op);
+        for (size_t i = 0; i < n; i++) {
+            ASSERT_EQ(bitset->test(i), (i % 2) == 0 ? c.has_true : c.has_false);
+        }
+    }
+
+    auto both = index->Range(false, true, true, true);
+    ASSERT_TRUE(both->all());
+    auto only_false = index->Range(false, true, true, false);
+    auto only_true = index->Range(false, false, true, true);
+    auto none = index->Range(false, false, true, false);
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(only_false->test(i), (i % 2) != 0);
+        ASSERT_EQ(only_true->test(i), (i % 2) == 0);
+    }
+    ASSERT_TRUE(none->none());
+
+    auto out = std::make_unique<bool[]>(n);
+    index->ReverseLookupRange(0, n, out.get());
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(out[i], (i % 2) == 0);
+        ASSERT_EQ(index->Reverse_Lookup(i), (i % 2) == 0);
+    }
+}
+
+TEST_F(BoolIndexTest, LoadSortIndex) {
+    // bool fields were indexed by sort indexes before
+    auto sorted = milvus::index::CreateScalarIndexSort<bool>();
+    sorted->Build(half.data_size(), half.data().data());
+    auto index = milvus::index::CreateBoolIndex();
+    index->Load(sorted->Serialize(nullptr));
+    ASSERT_EQ(n, index->Count());
+    auto true_test = true;
+    auto bitset = index->In(1, &true_test);
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(bitset->test(i), (i % 2) == 0);
+    }
+}
@@ -25,7 +25,9 @@
 #include "pb/plan.pb.h"
 #include "query/ExprImpl.h"
 #include "segcore/Collection.h"
+#include "segcore/FlatSearchResult.h"
 #include "segcore/Reduce.h"
+#include "segcore/SegcoreConfig.h"
 #include "segcore/reduce_c.h"
 #include "test_utils/DataGen.h"
 #include "test_utils/PbHelper.h"
@@ -916,6 +918,51 @@ TEST(CApiTest, SearchTestWithExpr) {
     DeleteSegment(segment);
 }
 
+TEST(CApiTest, PlanCache) {
+    auto c_collection = NewCollection(get_default_schema_config());
+    auto col = (milvus::segcore::Collection*)c_collection;
+    auto make_plan = [&](int topk) {
+        auto text_plan = boost::str(boost::format(R"(vector_anns: <
+                                            field_id: 100
+                                            query_info: <
+                                                topk: %1%
+                                                metric_type: "L2"
+                                                search_params: "{\"nprobe\": 10}"
+                                            >
+                                            placeholder_tag: "$0"
+                                         >)") % topk);
+        auto binary_plan = translate_text_plan_to_binary_plan(text_plan.c_str());
+        void* plan = nullptr;
+        auto status = CreateSearchPlanByExpr(c_collection, binary_plan.data(), binary_plan.size(), &plan);
+        EXPECT_EQ(status.error_code, Success);
+        return (milvus::query::Plan*)plan;
+    };
+
+    // the same plan bytes share the parsed plan node
+    auto plan1 = make_plan(10);
+    auto plan2 = make_plan(10);
+    auto plan3 = make_plan(20);
+    ASSERT_NE(plan1, plan2);
+    ASSERT_EQ(plan1->plan_node_, plan2->plan_node_);
+    ASSERT_NE(plan1->plan_node_, plan3->plan_node_);
+    ASSERT_EQ(GetTopK(plan2), 10);
+    ASSERT_EQ(GetTopK(plan3), 20);
+    ASSERT_EQ(col->get_search_plan_cache().size(), 2);
+    DeleteSearchPlan(plan1);
+    DeleteSearchPlan(plan2);
+
+    // capacity 0 parses every plan
+    auto& config = milvus::segcore::SegcoreConfig::default_config();
+    auto capacity = config.get_plan_cache_size();
+    config.set_plan_cache_size(0);
+    auto plan4 = make_plan(20);
+    ASSERT_NE(plan3->plan_node_, plan4->plan_node_);
+    config.set_plan_cache_size(capacity);
+    DeleteSearchPlan(plan3);
+    DeleteSearchPlan(plan4);
+    DeleteCollection(c_collection);
+}
+
 TEST(CApiTest, RetrieveTestWithExpr) {
     auto collection = NewCollection(get_default_schema_config());
     auto segment = NewSegment(collection, Growing, -1);
@@ -1392,6 +1439,490 @@ TEST(CApiTest, ReduceSearchWithExpr) {
     testReduceSearchWithExpr(10000, 10, 10);
 }
 
+TEST(CApiTest, ReduceParallel) {
+    auto collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(collection, Growing, -1);
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    int N = 2000;
+    auto dataset = DataGen(schema, N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment, offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(), insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    const char* raw_plan = R"(vector_anns: <
+                                field_id: 100
+                                query_info: <
+                                    topk: 10
+                                    metric_type: "L2"
+                                    search_params: "{\"nprobe\": 10}"
+                                >
+                                placeholder_tag: "$0">
+                                output_field_ids: 100)";
+    int num_queries = 300;
+    auto blob = generate_query_data(num_queries);
+    void* plan = nullptr;
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    auto status = CreateSearchPlanByExpr(collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    // many nq ranges and slices, reduced by one thread and by several
+    auto slice_nqs = std::vector<int64_t>{100, 70, 130};
+    auto slice_topKs = std::vector<int64_t>{10, 3, 7};
+    auto reduce = [&](int64_t parallelism) {
+        milvus::segcore::SegcoreConfig::default_config().set_reduce_parallelism(parallelism);
+        std::vector<CSearchResult> results(3);
+        for (auto& result : results) {
+            auto res = Search(segment, plan, placeholderGroup, dataset.timestamps_[N - 1], &result);
+            EXPECT_EQ(res.error_code, Success);
+        }
+        CSearchResultDataBlobs cSearchResultData;
+        auto status = ReduceSearchResultsAndFillData(&cSearchResultData, plan, results.data(), results.size(),
+                                                     slice_nqs.data(), slice_topKs.data(), slice_nqs.size());
+        EXPECT_EQ(status.error_code, Success);
+        auto blobs = reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(cSearchResultData)->blobs;
+        DeleteSearchResultDataBlobs(cSearchResultData);
+        for (auto& result : results) {
+            DeleteSearchResult(result);
+        }
+        return blobs;
+    };
+    auto sequential = reduce(1);
+    auto parallel = reduce(4);
+    milvus::segcore::SegcoreConfig::default_config().set_reduce_parallelism(4);
+    ASSERT_EQ(sequential, parallel);
+
+    for (int i = 0; i < slice_nqs.size(); i++) {
+        milvus::proto::schema::SearchResultData search_result_data;
+        ASSERT_TRUE(search_result_data.ParseFromArray(parallel[i].data(), parallel[i].size()));
+        ASSERT_EQ(search_result_data.num_queries(), slice_nqs[i]);
+        // the same segment searched thrice, duplicates are removed
+        ASSERT_EQ(search_result_data.ids().int_id().data_size(), slice_nqs[i] * slice_topKs[i]);
+        for (auto real_topk : search_result_data.topks()) {
+            ASSERT_EQ(real_topk, slice_topKs[i]);
+        }
+    }
+
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteCollection(collection);
+    DeleteSegment(segment);
+}
+
+TEST(CApiTest, SearchSegmentsAndReduce) {
+    auto collection = NewCollection(get_default_schema_config());
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    int N = 1000;
+    std::vector<CSegmentInterface> segments;
+    Timestamp timestamp = 0;
+    for (auto seed : {42, 43, 44}) {
+        auto segment = NewSegment(collection, Growing, -1);
+        auto dataset = DataGen(schema, N, seed);
+        int64_t offset;
+        PreInsert(segment, N, &offset);
+        auto insert_data = serialize(dataset.raw_);
+        auto ins_res = Insert(segment, offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(),
+                              insert_data.data(), insert_data.size());
+        ASSERT_EQ(ins_res.error_code, Success);
+        segments.push_back(segment);
+        timestamp = std::max(timestamp, dataset.timestamps_[N - 1]);
+    }
+
+    const char* raw_plan = R"(vector_anns: <
+                                field_id: 100
+                                query_info: <
+                                    topk: 10
+                                    metric_type: "L2"
+                                    search_params: "{\"nprobe\": 10}"
+                                >
+                                placeholder_tag: "$0">
+                                output_field_ids: 100)";
+    int num_queries = 20;
+    auto blob = generate_query_data(num_queries);
+    void* plan = nullptr;
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    auto status = CreateSearchPlanByExpr(collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    auto slice_nqs = std::vector<int64_t>{15, 5};
+    auto slice_topKs = std::vector<int64_t>{10, 4};
+    auto blobs_of = [](CSearchResultDataBlobs cSearchResultData) {
+        auto blobs = reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(cSearchResultData)->blobs;
+        DeleteSearchResultDataBlobs(cSearchResultData);
+        return blobs;
+    };
+
+    // a call per segment, then the reduce
+    std::vector<CSearchResult> results(segments.size());
+    for (int i = 0; i < segments.size(); i++) {
+        auto res = Search(segments[i], plan, placeholderGroup, timestamp, &results[i]);
+        ASSERT_EQ(res.error_code, Success);
+    }
+    CSearchResultDataBlobs cSearchResultData;
+    status = ReduceSearchResultsAndFillData(&cSearchResultData, plan, results.data(), results.size(),
+                                            slice_nqs.data(), slice_topKs.data(), slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+    auto expected = blobs_of(cSearchResultData);
+    for (auto& result : results) {
+        DeleteSearchResult(result);
+    }
+
+    for (auto parallelism : {1, 4}) {
+        milvus::segcore::SegcoreConfig::default_config().set_segment_search_parallelism(parallelism);
+        status = SearchSegmentsAndReduce(&cSearchResultData, segments.data(), segments.size(), plan, placeholderGroup,
+                                         timestamp, slice_nqs.data(), slice_topKs.data(), slice_nqs.size());
+        ASSERT_EQ(status.error_code, Success);
+        ASSERT_EQ(blobs_of(cSearchResultData), expected);
+    }
+    milvus::segcore::SegcoreConfig::default_config().set_segment_search_parallelism(8);
+
+    // a partial search done before its deadline skips no segment
+    SetSearchPlanPartialOnDeadline(plan, true);
+    SetSearchPlanDeadline(plan, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch() + std::chrono::hours(1))
+                                    .count());
+    status = SearchSegmentsAndReduce(&cSearchResultData, segments.data(), segments.size(), plan, placeholderGroup,
+                                     timestamp, slice_nqs.data(), slice_topKs.data(), slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+    const int64_t* skipped_segments = nullptr;
+    int64_t num_skipped = -1;
+    status = GetSearchResultSkippedSegments(&skipped_segments, &num_skipped, cSearchResultData);
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_EQ(num_skipped, 0);
+    ASSERT_EQ(blobs_of(cSearchResultData), expected);
+
+    // past the deadline with no segment searched, it fails
+    SetSearchPlanDeadline(plan, 1);
+    status = SearchSegmentsAndReduce(&cSearchResultData, segments.data(), segments.size(), plan, placeholderGroup,
+                                     timestamp, slice_nqs.data(), slice_topKs.data(), slice_nqs.size());
+    ASSERT_EQ(status.error_code, QueryCancelled);
+
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    for (auto segment : segments) {
+        DeleteSegment(segment);
+    }
+    DeleteCollection(collection);
+}
+
+TEST(CApiTest, SearchProfile) {
+    auto collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(collection, Growing, -1);
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    int N = 1000;
+    auto dataset = DataGen(schema, N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment, offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(), insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    const char* raw_plan = R"(vector_anns: <
+                                field_id: 100
+                                predicates: <
+                                  unary_range_expr: <
+                                    column_info: <
+                                      field_id: 101
+                                      data_type: Int64
+                                    >
+                                    op: GreaterEqual
+                                    value: <
+                                      int64_val: 0
+                                    >
+                                  >
+                                >
+                                query_info: <
+                                    topk: 10
+                                    metric_type: "L2"
+                                    search_params: "{\"nprobe\": 10}"
+                                >
+                                placeholder_tag: "$0">)";
+    int num_queries = 5;
+    auto blob = generate_query_data(num_queries);
+    void* plan = nullptr;
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    auto status = CreateSearchPlanByExpr(collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+    SetSearchPlanProfile(plan, true);
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    std::vector<CSearchResult> results(2);
+    for (auto& result : results) {
+        auto res = Search(segment, plan, placeholderGroup, dataset.timestamps_[N - 1], &result);
+        ASSERT_EQ(res.error_code, Success);
+        auto profile = ((milvus::SearchResult*)result)->profile_;
+        ASSERT_NE(profile, nullptr);
+        ASSERT_EQ(profile->segments_, 1);
+        ASSERT_EQ(profile->active_rows_, N);
+        ASSERT_FALSE(profile->exprs_.empty());
+        ASSERT_EQ(profile->stage_nanos_.count("vector_search"), 1);
+    }
+
+    auto slice_nqs = std::vector<int64_t>{num_queries};
+    auto slice_topKs = std::vector<int64_t>{10};
+    CSearchResultDataBlobs cSearchResultData;
+    status = ReduceSearchResultsAndFillData(&cSearchResultData, plan, results.data(), results.size(), slice_nqs.data(),
+                                            slice_topKs.data(), slice_nqs.size());
+    ASSERT_EQ(status.error_code, Success);
+    CProto profile_blob;
+    status = GetSearchResultProfile(&profile_blob, cSearchResultData);
+    ASSERT_EQ(status.error_code, Success);
+    auto profile = nlohmann::json::parse(std::string((const char*)profile_blob.proto_blob, profile_blob.proto_size));
+    ASSERT_EQ(profile["segments"], 2);
+    ASSERT_EQ(profile["active_rows"], 2 * N);
+    ASSERT_TRUE(profile["stage_nanos"].contains("reduce"));
+    ASSERT_TRUE(profile["stage_nanos"].contains("marshal"));
+
+    DeleteSearchResultDataBlobs(cSearchResultData);
+    for (auto& result : results) {
+        DeleteSearchResult(result);
+    }
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteCollection(collection);
+    DeleteSegment(segment);
+}
+
+TEST(CApiTest, SharedSearchBound) {
+    auto collection = NewCollection(get_default_schema_config());
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    int N = 1000;
+    std::vector<CSegmentInterface> segments;
+    std::vector<Timestamp> timestamps;
+    for (auto seed : {42, 43}) {
+        auto segment = NewSegment(collection, Growing, -1);
+        auto dataset = DataGen(schema, N, seed);
+        int64_t offset;
+        PreInsert(segment, N, &offset);
+        auto insert_data = serialize(dataset.raw_);
+        auto ins_res = Insert(segment, offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(),
+                              insert_data.data(), insert_data.size());
+        ASSERT_EQ(ins_res.error_code, Success);
+        segments.push_back(segment);
+        timestamps.push_back(dataset.timestamps_[N - 1]);
+    }
+
+    const char* raw_plan = R"(vector_anns: <
+                                field_id: 100
+                                query_info: <
+                                    topk: 10
+                                    metric_type: "L2"
+                                    search_params: "{\"nprobe\": 10}"
+                                >
+                                placeholder_tag: "$0">)";
+    int num_queries = 5;
+    int topk = 10;
+    auto blob = generate_query_data(num_queries);
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    void* shared_plan = nullptr;
+    void* plan = nullptr;
+    ASSERT_EQ(CreateSearchPlanByExpr(collection, binary_plan.data(), binary_plan.size(), &shared_plan).error_code,
+              Success);
+    ASSERT_EQ(CreateSearchPlanByExpr(collection, binary_plan.data(), binary_plan.size(), &plan).error_code, Success);
+    void* placeholderGroup = nullptr;
+    ASSERT_EQ(ParsePlaceholderGroup(shared_plan, blob.data(), blob.length(), &placeholderGroup).error_code, Success);
+    ASSERT_EQ(ShareSearchPlanBound(shared_plan, placeholderGroup).error_code, Success);
+
+    CSearchResult first, pruned, full;
+    ASSERT_EQ(Search(segments[0], shared_plan, placeholderGroup, timestamps[0], &first).error_code, Success);
+    ASSERT_EQ(Search(segments[1], shared_plan, placeholderGroup, timestamps[1], &pruned).error_code, Success);
+    ASSERT_EQ(Search(segments[1], plan, placeholderGroup, timestamps[1], &full).error_code, Success);
+
+    // the second segment keeps the hits no farther than the topk-th of the first, the L2 distances come negated
+    auto first_result = (milvus::SearchResult*)first;
+    auto pruned_result = (milvus::SearchResult*)pruned;
+    auto full_result = (milvus::SearchResult*)full;
+    int64_t dropped = 0;
+    for (int q = 0; q < num_queries; ++q) {
+        auto kth = first_result->distances_[q * topk + topk - 1];
+        for (int j = 0; j < topk; ++j) {
+            auto i = q * topk + j;
+            auto kept = full_result->distances_[i] >= kth;
+            ASSERT_EQ(pruned_result->seg_offsets_[i], kept ? full_result->seg_offsets_[i] : INVALID_SEG_OFFSET);
+            dropped += !kept;
+        }
+    }
+    ASSERT_GT(dropped, 0);
+
+    for (auto result : {first, pruned, full}) {
+        DeleteSearchResult(result);
+    }
+    DeleteSearchPlan(shared_plan);
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    for (auto segment : segments) {
+        DeleteSegment(segment);
+    }
+    DeleteCollection(collection);
+}
+
+TEST(CApiTest, ReduceFlatResult) {
+    auto collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(collection, Growing, -1);
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    int N = 1000;
+    auto dataset = DataGen(schema, N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment, offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(), insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    const char* raw_plan = R"(vector_anns: <
+                                field_id: 100
+                                query_info: <
+                                    topk: 10
+                                    metric_type: "L2"
+                                    search_params: "{\"nprobe\": 10}"
+                                >
+                                placeholder_tag: "$0">
+                                output_field_ids: 100)";
+    int num_queries = 20;
+    auto blob = generate_query_data(num_queries);
+    void* plan = nullptr;
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    auto status = CreateSearchPlanByExpr(collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    auto slice_nqs = std::vector<int64_t>{15, 5};
+    auto slice_topKs = std::vector<int64_t>{10, 4};
+    auto reduce = [&](bool flat) {
+        std::vector<CSearchResult> results(2);
+        for (auto& result : results) {
+            auto res = Search(segment, plan, placeholderGroup, dataset.timestamps_[N - 1], &result);
+            EXPECT_EQ(res.error_code, Success);
+        }
+        CSearchResultDataBlobs cSearchResultData;
+        auto reduce_func = flat ? ReduceSearchResultsAndFillFlatData : ReduceSearchResultsAndFillData;
+        auto status = reduce_func(&cSearchResultData, plan, results.data(), results.size(), slice_nqs.data(),
+                                  slice_topKs.data(), slice_nqs.size());
+        EXPECT_EQ(status.error_code, Success);
+        auto blobs = reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(cSearchResultData)->blobs;
+        DeleteSearchResultDataBlobs(cSearchResultData);
+        for (auto& result : results) {
+            DeleteSearchResult(result);
+        }
+        return blobs;
+    };
+    auto proto_blobs = reduce(false);
+    auto flat_blobs = reduce(true);
+
+    for (int i = 0; i < slice_nqs.size(); i++) {
+        milvus::proto::schema::SearchResultData expected;
+        ASSERT_TRUE(expected.ParseFromArray(proto_blobs[i].data(), proto_blobs[i].size()));
+        milvus::segcore::FlatSearchResultView flat(flat_blobs[i].data(), flat_blobs[i].size());
+        auto& header = flat.header();
+        ASSERT_EQ(header.num_queries, expected.num_queries());
+        ASSERT_EQ(header.top_k, expected.top_k());
+        ASSERT_EQ(header.result_count, expected.scores_size());
+        ASSERT_EQ(DataType(header.pk_type), DataType::INT64);
+        for (int64_t qi = 0; qi < header.num_queries; qi++) {
+            ASSERT_EQ(flat.topks()[qi], expected.topks(qi));
+        }
+        for (int64_t j = 0; j < header.result_count; j++) {
+            ASSERT_EQ(flat.scores()[j], expected.scores(j));
+            ASSERT_EQ(flat.ids().values<int64_t>()[j], expected.ids().int_id().data(j));
+        }
+
+        ASSERT_EQ(flat.fields().size(), 1);
+        auto& [field_id, column] = flat.fields()[0];
+        ASSERT_EQ(field_id, 100);
+        ASSERT_EQ(column.data_type, DataType::VECTOR_FLOAT);
+        ASSERT_EQ(column.dim, DIM);
+        auto& vectors = expected.fields_data(0).vectors().float_vector().data();
+        ASSERT_EQ(column.size, vectors.size() * sizeof(float));
+        ASSERT_EQ(memcmp(column.data, vectors.data(), column.size), 0);
+    }
+
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteCollection(collection);
+    DeleteSegment(segment);
+}
+
+TEST(CApiTest, ReduceStream) {
+    auto collection = NewCollection(get_default_schema_config());
+    auto segment = NewSegment(collection, Growing, -1);
+    auto schema = ((milvus::segcore::Collection*)collection)->get_schema();
+    int N = 1000;
+    auto dataset = DataGen(schema, N);
+    int64_t offset;
+    PreInsert(segment, N, &offset);
+    auto insert_data = serialize(dataset.raw_);
+    auto ins_res = Insert(segment, offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(), insert_data.data(),
+                          insert_data.size());
+    ASSERT_EQ(ins_res.error_code, Success);
+
+    const char* raw_plan = R"(vector_anns: <
+                                field_id: 100
+                                query_info: <
+                                    topk: 10
+                                    metric_type: "L2"
+                                    search_params: "{\"nprobe\": 10}"
+                                >
+                                placeholder_tag: "$0">
+                                output_field_ids: 100)";
+    int num_queries = 150;
+    auto blob = generate_query_data(num_queries);
+    void* plan = nullptr;
+    auto binary_plan = translate_text_plan_to_binary_plan(raw_plan);
+    auto status = CreateSearchPlanByExpr(collection, binary_plan.data(), binary_plan.size(), &plan);
+    ASSERT_EQ(status.error_code, Success);
+    void* placeholderGroup = nullptr;
+    status = ParsePlaceholderGroup(plan, blob.data(), blob.length(), &placeholderGroup);
+    ASSERT_EQ(status.error_code, Success);
+
+    // streaming emits the same blobs slice by slice
+    auto slice_nqs = std::vector<int64_t>{70, 1, 79};
+    auto slice_topKs = std::vector<int64_t>{10, 3, 6};
+    auto reduce = [&](int64_t stream_rows, bool flat) {
+        milvus::segcore::SegcoreConfig::default_config().set_reduce_stream_rows(stream_rows);
+        std::vector<CSearchResult> results(3);
+        for (auto& result : results) {
+            auto res = Search(segment, plan, placeholderGroup, dataset.timestamps_[N - 1], &result);
+            EXPECT_EQ(res.error_code, Success);
+        }
+        CSearchResultDataBlobs cSearchResultData;
+        auto reduce_func = flat ? ReduceSearchResultsAndFillFlatData : ReduceSearchResultsAndFillData;
+        auto status = reduce_func(&cSearchResultData, plan, results.data(), results.size(), slice_nqs.data(),
+                                  slice_topKs.data(), slice_nqs.size());
+        EXPECT_EQ(status.error_code, Success);
+        auto blobs = reinterpret_cast<milvus::segcore::SearchResultDataBlobs*>(cSearchResultData)->blobs;
+        DeleteSearchResultDataBlobs(cSearchResultData);
+        for (auto& result : results) {
+            DeleteSearchResult(result);
+        }
+        return blobs;
+    };
+    for (auto flat : {false, true}) {
+        auto whole = reduce(0, flat);
+        auto streamed = reduce(1, flat);
+        ASSERT_EQ(whole.size(), slice_nqs.size());
+        ASSERT_EQ(whole, streamed);
+    }
+    milvus::segcore::SegcoreConfig::default_config().set_reduce_stream_rows(1024 * 1024);
+
+    DeleteSearchPlan(plan);
+    DeletePlaceholderGroup(placeholderGroup);
+    DeleteCollection(collection);
+    DeleteSegment(segment);
+}
+
 TEST(CApiTest, LoadIndexInfo) {
     // generator index
     constexpr auto TOPK = 10;
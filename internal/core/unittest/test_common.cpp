@@ -11,9 +11,24 @@
 
 #include <gtest/gtest.h>
 #include <segcore/ConcurrentVector.h>
+#include <limits>
+#include <thread>
+#include "common/Jemalloc.h"
+#include "common/MemoryBudget.h"
+#include "common/Numa.h"
+#include "common/PerfCounters.h"
+#include "common/ScratchArena.h"
+#include "common/Metrics.h"
+#include "common/metrics_c.h"
 #include "common/Types.h"
 #include "common/Span.h"
+#include "common/Common.h"
+#include "common/Slice.h"
 #include "common/VectorTrait.h"
+#include "log/AsyncLogSink.h"
+#include "log/Log.h"
+#include "nlohmann/json.hpp"
+#include "storage/ThreadPool.h"
 
 TEST(Common, Span) {
     using namespace milvus;
@@ -29,3 +44,350 @@ TEST(Common, Span) {
     ASSERT_EQ(r2.row_count(), 10);
     ASSERT_EQ(r2.element_sizeof(), 16 * sizeof(float));
 }
+
+TEST(Common, StringSpan) {
+    using namespace milvus;
+
+    std::string data = "abcdefgh";
+    std::vector<uint32_t> offsets32{0, 1, 3, 3, 8};
+    std::vector<uint64_t> offsets64(offsets32.begin(), offsets32.end());
+    for (auto base : {SpanBase(data.data(), offsets32.data(), 4, sizeof(uint32_t)),
+                      SpanBase(data.data(), offsets64.data(), 4, sizeof(uint64_t))}) {
+        auto span = static_cast<Span<std::string_view>>(base);
+        ASSERT_EQ(span.row_count(), 4);
+        ASSERT_EQ(span[0], "a");
+        ASSERT_EQ(span[1], "bc");
+        ASSERT_EQ(span[2], "");
+        ASSERT_EQ((span.data() + 3)[0], "defgh");
+        SpanBase copy = span;
+        ASSERT_EQ(copy.offsets(), base.offsets());
+        ASSERT_EQ(static_cast<Span<std::string_view>>(copy)[1], "bc");
+    }
+}
+
+TEST(Common, SliceWithoutCopy) {
+    using namespace milvus;
+
+    auto slice_size = index_file_slice_size;
+    SetIndexSliceSize(1);
+    int64_t len = (3 << 20) + 7;
+    std::shared_ptr<uint8_t[]> data(new uint8_t[len]);
+    for (int64_t i = 0; i < len; ++i) {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+    BinarySet set;
+    set.Append("data", data, len);
+    Disassemble(set);
+    ASSERT_EQ(set.GetByName("data"), nullptr);
+
+    auto slices = GetSlices(set, "data");
+    ASSERT_EQ(slices.size(), 4);
+    ASSERT_EQ(SlicesSize(slices), len);
+    ASSERT_EQ(slices[1]->data.get(), data.get() + (1 << 20));
+    std::vector<uint8_t> copy(len);
+    CopySlices(slices, copy.data());
+    ASSERT_EQ(memcmp(copy.data(), data.get(), len), 0);
+
+    Assemble(set);
+    auto whole = set.GetByName("data");
+    ASSERT_EQ(whole->data.get(), data.get());
+    ASSERT_EQ(whole->size, len);
+    SetIndexSliceSize(slice_size);
+}
+
+TEST(Common, MetricsHistogramBuckets) {
+    using milvus::metrics::ShardedHistogram;
+    // every value falls into the bucket whose bounds enclose it
+    int64_t lower = 0;
+    for (int bucket = 0; bucket < ShardedHistogram::kBuckets; ++bucket) {
+        auto upper = ShardedHistogram::UpperBound(bucket);
+        ASSERT_GE(upper, lower);
+        ASSERT_EQ(ShardedHistogram::BucketOf(lower), bucket);
+        ASSERT_EQ(ShardedHistogram::BucketOf(upper), bucket);
+        // the width of a bucket is at most a quarter of its values
+        ASSERT_LE((upper - lower) * ShardedHistogram::kSubBuckets, std::max<int64_t>(lower, 1));
+        lower = upper + 1;
+    }
+    ASSERT_EQ(ShardedHistogram::BucketOf(-1), 0);
+    ASSERT_EQ(ShardedHistogram::BucketOf(std::numeric_limits<int64_t>::max()), ShardedHistogram::kBuckets - 1);
+}
+
+TEST(Common, MetricsConcurrentRecording) {
+    using namespace milvus::metrics;
+    auto& registry = Registry::GetInstance();
+    auto rows = registry.counter(Counter::InsertRows).Value();
+    auto latencies = registry.histogram(Histogram::InsertLatency).Collect();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 1000; ++i) {
+                Add(Counter::InsertRows, 2);
+                Observe(Histogram::InsertLatency, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(registry.counter(Counter::InsertRows).Value() - rows, 8 * 1000 * 2);
+    auto collected = registry.histogram(Histogram::InsertLatency).Collect();
+    ASSERT_EQ(collected.count_ - latencies.count_, 8 * 1000);
+    ASSERT_EQ(collected.sum_ - latencies.sum_, 8 * (999 * 1000 / 2));
+
+    CProto blob;
+    auto status = GetSegcoreMetrics(&blob);
+    ASSERT_EQ(status.error_code, Success);
+    auto json = nlohmann::json::parse(std::string((const char*)blob.proto_blob, blob.proto_size));
+    DeleteSegcoreMetrics(&blob);
+    ASSERT_EQ(json["counters"]["segcore_insert_rows_total"], registry.counter(Counter::InsertRows).Value());
+    auto& histogram = json["histograms"]["segcore_insert_latency_us"];
+    ASSERT_EQ(histogram["count"], collected.count_);
+    // the buckets are cumulative, the last one counts every value
+    ASSERT_EQ(histogram["buckets"].back()[1], collected.count_);
+}
+
+TEST(Common, MemoryBudget) {
+    using namespace milvus;
+    MemoryBudget budget;
+    ASSERT_TRUE(budget.TryReserve(1 << 30));
+    budget.Release(1 << 30);
+
+    budget.SetCapacity(100);
+    {
+        auto reservation = budget.Acquire(60, std::chrono::milliseconds(0), "test");
+        ASSERT_EQ(budget.Used(), 60);
+        ASSERT_FALSE(budget.TryReserve(50));
+        ASSERT_THROW(budget.Acquire(50, std::chrono::milliseconds(10), "test"), SegcoreError);
+        // more than the whole budget fails without waiting
+        ASSERT_FALSE(budget.Reserve(200, std::chrono::milliseconds(1000)));
+    }
+    ASSERT_EQ(budget.Used(), 0);
+
+    // a waiting reservation gets the bytes released by another
+    auto reservation = budget.Acquire(100, std::chrono::milliseconds(0), "test");
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        reservation.reset();
+    });
+    ASSERT_TRUE(budget.Reserve(100, std::chrono::seconds(10)));
+    releaser.join();
+    budget.Release(100);
+    ASSERT_EQ(budget.Used(), 0);
+}
+
+TEST(Common, SegmentArena) {
+    using namespace milvus;
+    if (!JemallocAvailable()) {
+        SegmentArena arena;
+        ASSERT_EQ(arena.id(), 0);
+        ArenaScope scope(arena);
+        ASSERT_ANY_THROW(DumpHeapProfile("/tmp/milvus-heap.prof"));
+        return;
+    }
+    unsigned id = 0;
+    {
+        SegmentArena arena;
+        ASSERT_NE(arena.id(), 0);
+        id = arena.id();
+        ArenaScope scope(arena);
+        std::vector<int64_t> data(1 << 20);
+    }
+    // a released arena is purged and handed out again
+    SegmentArena arena;
+    ASSERT_EQ(arena.id(), id);
+}
+
+TEST(Common, LogRateLimiter) {
+    // starts right after a second begins, the lines below fall in one
+    auto second = [] {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    };
+    for (auto start = second(); second() == start;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    LogRateLimiter limiter(2);
+    ASSERT_EQ(limiter.Acquire(), 0);
+    ASSERT_EQ(limiter.Acquire(), 0);
+    ASSERT_EQ(limiter.Acquire(), -1);
+    ASSERT_EQ(limiter.Acquire(), -1);
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    // the first line of the next second tells about the dropped ones
+    ASSERT_EQ(limiter.Acquire(), 2);
+    ASSERT_EQ(limiter.Acquire(), 0);
+    ASSERT_EQ(LogDroppedNote(0), "");
+    ASSERT_EQ(LogDroppedNote(2), "(2 similar lines dropped) ");
+
+    // a disabled level evaluates none of the operands
+    auto levels = log_enabled_levels.load();
+    log_enabled_levels = levels & ~static_cast<uint32_t>(el::Level::Debug);
+    int evaluated = 0;
+    LOG_SEGCORE_DEBUG_ << ++evaluated;
+    LOG_SEGCORE_DEBUG_LIMITED_(10) << ++evaluated;
+    log_enabled_levels = levels;
+    ASSERT_EQ(evaluated, 0);
+}
+
+TEST(Common, LogRing) {
+    using namespace milvus;
+    LogRing ring(3);
+    int64_t pushed = 0;
+    for (int i = 0; i < 10; ++i) {
+        pushed += ring.Push({nullptr, el::Level::Info, std::to_string(i)});
+    }
+    // rounded up to 4
+    ASSERT_EQ(pushed, 4);
+    LogRing::Line line;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.Pop(line));
+        ASSERT_EQ(line.text, std::to_string(i));
+    }
+    ASSERT_FALSE(ring.Pop(line));
+
+    // producers racing the consumer, each line popped once
+    LogRing shared(64);
+    const int threads = 4;
+    const int lines = 10000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([&shared, t] {
+            for (int i = 0; i < lines; ++i) {
+                while (!shared.Push({nullptr, el::Level::Info, std::to_string(t * lines + i)})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<bool> seen(threads * lines);
+    for (int popped = 0; popped < threads * lines;) {
+        if (shared.Pop(line)) {
+            auto id = std::stoi(line.text);
+            ASSERT_FALSE(seen[id]);
+            seen[id] = true;
+            ++popped;
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+}
+
+TEST(Common, Numa) {
+    using namespace milvus;
+    ASSERT_EQ(ParseCpuList("0-3,8,10-11\n"), std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    ASSERT_TRUE(ParseCpuList("").empty());
+
+    ASSERT_FALSE(NumaNodes().empty());
+    SetNumaPlacement(false);
+    ASSERT_EQ(SegmentNumaNode(1), -1);
+    SetNumaPlacement(true);
+    auto node = SegmentNumaNode(1);
+    ASSERT_TRUE(NumaNodes().size() > 1 ? node >= 0 : node == -1);
+    SetNumaPlacement(DEFAULT_NUMA_PLACEMENT);
+
+    {
+        NumaNodeScope scope(NumaNodes()[0]);
+        ASSERT_EQ(CurrentNumaNode(), NumaNodes()[0]);
+        std::atomic<int64_t> sum = 0;
+        ParallelFor(64, 4, [&](int64_t id) { sum += id; });
+        ASSERT_EQ(sum, 64 * 63 / 2);
+    }
+    ASSERT_EQ(CurrentNumaNode(), -1);
+}
+
+TEST(Common, PerfCounters) {
+    using namespace milvus;
+    PerfCounts a;
+    a.cycles = 100;
+    a.instructions = 250;
+    a.cache_misses = 2;
+    PerfCounts b;
+    b.cycles = 40;
+    b.instructions = 300;
+    auto diff = a - b;
+    ASSERT_EQ(diff.cycles, 60);
+    // a scaled count stepping back reads as none
+    ASSERT_EQ(diff.instructions, 0);
+    ASSERT_EQ(diff.memory_bytes(), 128);
+    diff += a;
+    ASSERT_EQ(diff.cycles, 160);
+    ASSERT_DOUBLE_EQ(a.ipc(), 2.5);
+    ASSERT_EQ(PerfCounts().ipc(), 0);
+
+    // the kernel may refuse the counters here, the counts are then none
+    PerfCounts sum;
+    {
+        ScopedPerfCounters outer(&sum);
+        ScopedPerfCounters inner("inner");
+        volatile int64_t x = 0;
+        for (int i = 0; i < 1000000; ++i) {
+            x = x + i;
+        }
+    }
+    if (ThreadPerfCounters().available()) {
+        ASSERT_GT(sum.instructions, 1000000);
+    } else {
+        ASSERT_EQ(sum.instructions, 0);
+    }
+}
+
+TEST(Common, ScratchArena) {
+    using namespace milvus;
+    auto limit = GetScratchArenaBytes();
+    auto& arena = ScratchArena::Get();
+    // drop what earlier requests on this thread left
+    SetScratchArenaBytes(0);
+    {
+        ScratchScope scope;
+    }
+    SetScratchArenaBytes(limit);
+    // outside a scope every buffer comes from the heap
+    {
+        ScratchVector<int64_t> v(16);
+        ASSERT_FALSE(arena.Owns(v.data()));
+    }
+    // the first request overflows the empty arena, the buffer grows for the next ones
+    {
+        ScratchScope scope;
+        ScratchVector<int64_t> v(1000);
+        ASSERT_FALSE(arena.Owns(v.data()));
+    }
+    ASSERT_GE(arena.capacity(), 1000 * sizeof(int64_t));
+    const void* first = nullptr;
+    for (int i = 0; i < 3; ++i) {
+        ScratchScope scope;
+        ScratchVector<int64_t> v(1000);
+        ASSERT_TRUE(arena.Owns(v.data()));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(v.data()) % alignof(int64_t), 0);
+        {
+            // nested scopes share the buffer of the outermost one
+            ScratchScope inner;
+            ScratchVector<char> c(3);
+            ScratchVector<double> d(4);
+            ASSERT_TRUE(arena.Owns(c.data()));
+            ASSERT_TRUE(arena.Owns(d.data()));
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(d.data()) % alignof(double), 0);
+        }
+        // every request starts from the beginning of the buffer
+        if (first == nullptr) {
+            first = v.data();
+        }
+        ASSERT_EQ(first, v.data());
+    }
+    ASSERT_EQ(arena.used(), 0);
+
+    // a limit of 0 returns the buffer and turns the arena off
+    SetScratchArenaBytes(0);
+    {
+        ScratchScope scope;
+    }
+    ASSERT_EQ(arena.capacity(), 0);
+    {
+        ScratchScope scope;
+        ScratchVector<int64_t> v(1000);
+        ASSERT_FALSE(arena.Owns(v.data()));
+    }
+    ASSERT_EQ(arena.capacity(), 0);
+    SetScratchArenaBytes(limit);
+}
@@ -10,12 +10,16 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
 #include <random>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "segcore/ConcurrentVector.h"
+#include "segcore/Gather.h"
 #include "segcore/SegmentGrowing.h"
 #include "segcore/AckResponder.h"
 
@@ -94,6 +98,132 @@ TEST(ConcurrentVector, TestMultithreads) {
     }
 }
 
+TEST(ConcurrentVector, TestReadWhileGrowing) {
+    constexpr int64_t chunk_rows = 32;
+    constexpr int64_t N = 100000;
+    ConcurrentVector<int64_t> c_vec(chunk_rows);
+    std::atomic<int64_t> ack = 0;
+
+    // readers index published chunks while the writer keeps adding more
+    std::thread writer([&] {
+        for (int64_t offset = 0; offset < N; offset += 100) {
+            std::vector<int64_t> vec(100);
+            std::iota(vec.begin(), vec.end(), offset);
+            c_vec.set_data_raw(offset, vec.data(), vec.size());
+            ack.store(offset + 100);
+        }
+    });
+    std::vector<std::thread> readers;
+    std::atomic<int64_t> mismatches = 0;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t] {
+            std::default_random_engine e(t);
+            for (int64_t acked = 0; acked < N; acked = ack.load()) {
+                if (acked == 0) {
+                    continue;
+                }
+                auto offset = int64_t(e() % acked);
+                mismatches += c_vec[offset] != offset;
+            }
+        });
+    }
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(mismatches, 0);
+    ASSERT_EQ(c_vec.num_chunk(), N / chunk_rows + (N % chunk_rows != 0));
+
+    // spans are cut at chunk boundaries and cover the range in order
+    int64_t next = 17;
+    c_vec.for_each_span(17, N - 5, [&](const int64_t* data, int64_t begin, int64_t count) {
+        ASSERT_EQ(begin, next);
+        ASSERT_LE(begin % chunk_rows + count, chunk_rows);
+        for (int64_t i = 0; i < count; ++i) {
+            ASSERT_EQ(data[i], begin + i);
+        }
+        next += count;
+    });
+    ASSERT_EQ(next, N - 5);
+}
+
+TEST(ConcurrentVector, TestPooledChunks) {
+    auto& pool = ChunkPool::Global();
+    pool.Clear();
+    constexpr int64_t dim = 128;
+    constexpr int64_t chunk_rows = 8192;
+    // 4MB chunks, laid out for huge pages
+    constexpr size_t chunk_bytes = dim * chunk_rows * sizeof(float);
+    ASSERT_EQ(ChunkPool::RoundUp(chunk_bytes), chunk_bytes);
+    ASSERT_EQ(ChunkPool::RoundUp(chunk_bytes + 1), chunk_bytes + ChunkPool::huge_page_bytes);
+
+    ChunkArena arena;
+    std::vector<const void*> chunks;
+    {
+        ConcurrentVector<FloatVector> c_vec(dim, chunk_rows, &arena);
+        std::vector<float> data(dim * (2 * chunk_rows + 1), 1.0f);
+        c_vec.set_data_raw(0, data.data(), 2 * chunk_rows + 1);
+        ASSERT_EQ(c_vec.num_chunk(), 3);
+        // and a chunk of the squared norms of the rows per chunk
+        auto norm_bytes = ChunkPool::RoundUp(chunk_rows * sizeof(float));
+        ASSERT_EQ(arena.allocated_bytes(), 3 * (chunk_bytes + norm_bytes));
+        ASSERT_FLOAT_EQ(c_vec.get_chunk_norms(2)[0], dim);
+        for (int64_t i = 0; i < c_vec.num_chunk(); ++i) {
+            auto chunk = c_vec.get_chunk_data(i);
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(chunk) % ChunkPool::huge_page_bytes, 0);
+            chunks.push_back(chunk);
+        }
+        ASSERT_EQ(c_vec.get_element(2 * chunk_rows)[dim - 1], 1.0f);
+    }
+    // released chunks are cached for the next segment
+    ASSERT_EQ(arena.allocated_bytes(), 0);
+    ASSERT_EQ(pool.cached_bytes(), 3 * chunk_bytes);
+    {
+        ConcurrentVector<FloatVector> c_vec(dim, chunk_rows, &arena);
+        c_vec.grow_to_at_least(1);
+        auto chunk = c_vec.get_chunk_data(0);
+        ASSERT_NE(std::find(chunks.begin(), chunks.end(), chunk), chunks.end());
+        ASSERT_EQ(pool.cached_bytes(), 2 * chunk_bytes);
+    }
+
+    // non trivial elements are constructed in pooled memory
+    {
+        ConcurrentVector<std::string> c_vec(chunk_rows, &arena);
+        c_vec.grow_to_at_least(chunk_rows);
+        ASSERT_TRUE(c_vec[chunk_rows - 1].empty());
+        c_vec.get_chunk(0)[0] = std::string(100, 'x');
+        ASSERT_EQ(c_vec[0].size(), 100);
+    }
+    ASSERT_EQ(arena.allocated_bytes(), 0);
+    pool.Clear();
+    ASSERT_EQ(pool.cached_bytes(), 0);
+}
+
+TEST(ConcurrentVector, SortedUpperBound) {
+    // sorted timestamps with runs of equal ones across the chunks
+    ConcurrentVector<uint64_t> c_vec(32);
+    std::default_random_engine e(42);
+    std::vector<uint64_t> timestamps(1000);
+    uint64_t ts = 10;
+    for (auto& x : timestamps) {
+        ts += e() % 4 == 0;
+        x = ts;
+    }
+    c_vec.grow_to_at_least(timestamps.size());
+    c_vec.set_data(0, timestamps.data(), timestamps.size());
+
+    for (int i = 0; i < 2000; ++i) {
+        int64_t begin = e() % timestamps.size();
+        int64_t end = begin + e() % (timestamps.size() - begin + 1);
+        uint64_t value = e() % (ts + 10);
+        auto expected =
+            std::upper_bound(timestamps.begin() + begin, timestamps.begin() + end, value) - timestamps.begin();
+        ASSERT_EQ(c_vec.sorted_upper_bound(begin, end, value), expected);
+    }
+    ASSERT_EQ(c_vec.sorted_upper_bound(0, timestamps.size(), ts), timestamps.size());
+    ASSERT_EQ(c_vec.sorted_upper_bound(0, timestamps.size(), 0), 0);
+}
+
 TEST(ConcurrentVector, TestAckSingle) {
     std::vector<std::tuple<int64_t, int64_t, int64_t>> raw_data;
     std::default_random_engine e(42);
@@ -112,3 +242,56 @@ TEST(ConcurrentVector, TestAckSingle) {
     }
     EXPECT_EQ(ack.GetAck(), N);
 }
+
+TEST(ConcurrentVector, TestAckConcurrent) {
+    // batches of varied sizes finished in random order by several threads, many left pending at once so that
+    // some of them share a slot
+    constexpr int64_t num_batches = 20000;
+    constexpr int num_threads = 8;
+    std::default_random_engine e(42);
+    std::vector<std::pair<int64_t, int64_t>> batches;
+    int64_t offset = 0;
+    for (int64_t i = 0; i < num_batches; ++i) {
+        auto size = int64_t(e() % 3 == 0 ? 0 : 1 + e() % 64);
+        batches.emplace_back(offset, offset + size);
+        offset += size;
+    }
+    std::shuffle(batches.begin(), batches.end(), e);
+
+    AckResponder ack;
+    std::atomic<int64_t> next = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&] {
+            for (auto i = next.fetch_add(1); i < num_batches; i = next.fetch_add(1)) {
+                auto [begin, end] = batches[i];
+                ack.AddSegment(begin, end);
+                EXPECT_GE(ack.GetAck(), 0);
+                EXPECT_LE(ack.GetAck(), offset);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(ack.GetAck(), offset);
+}
+
+TEST(Gather, Rows) {
+    std::vector<int64_t> source(1000);
+    std::iota(source.begin(), source.end(), 0);
+    // unsorted, repeated and invalid offsets
+    std::vector<int64_t> offsets{17, 3, 999, INVALID_SEG_OFFSET, 3, 500, 0, 17, 42, 41, 40, 999};
+    for (auto sorted : {false, true}) {
+        if (sorted) {
+            std::sort(offsets.begin(), offsets.end());
+        }
+        std::vector<int64_t> output(offsets.size(), -2);
+        GatherRows(
+            offsets.data(), offsets.size(), sizeof(int64_t), [&](int64_t offset) { return &source[offset]; },
+            [&](int64_t i, int64_t offset) { output[i] = source[offset]; });
+        for (size_t i = 0; i < offsets.size(); i++) {
+            ASSERT_EQ(output[i], offsets[i] == INVALID_SEG_OFFSET ? -2 : offsets[i]);
+        }
+    }
+}
@@ -15,10 +15,15 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <numeric>
 
+#include "common/Common.h"
+#include "storage/Checksum.h"
 #include "storage/DataCodec.h"
+#include "storage/Event.h"
 #include "storage/InsertData.h"
 #include "storage/IndexData.h"
+#include "storage/Util.h"
 #include "common/Consts.h"
 #include "utils/Json.h"
 
@@ -47,6 +52,33 @@ TEST(storage, InsertDataFloat) {
     ASSERT_EQ(data, new_data);
 }
 
+TEST(storage, InsertDataString) {
+    std::vector<std::string> data = {"a", "", "bcd", "ef"};
+    arrow::StringBuilder builder;
+    ASSERT_TRUE(builder.AppendValues(data).ok());
+    std::shared_ptr<arrow::Array> array;
+    ASSERT_TRUE(builder.Finish(&array).ok());
+    auto field_data = std::make_shared<storage::FieldData>(array, storage::DataType::VARCHAR);
+    ASSERT_EQ(field_data->get_data_size(), 6);
+
+    storage::InsertData insert_data(field_data);
+    storage::FieldDataMeta field_data_meta{100, 101, 102, 103};
+    insert_data.SetFieldDataMeta(field_data_meta);
+    insert_data.SetTimestamps(0, 100);
+
+    auto serialized_bytes = insert_data.Serialize(storage::StorageType::Remote);
+    auto new_insert_data = storage::DeserializeFileData(serialized_bytes.data(), serialized_bytes.size());
+    auto new_field_data = new_insert_data->GetFieldData();
+    ASSERT_EQ(new_field_data->get_data_type(), storage::DataType::VARCHAR);
+    ASSERT_EQ(new_field_data->get_payload_length(), data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        char* value;
+        int size;
+        new_field_data->get_one_string_payload(i, &value, &size);
+        ASSERT_EQ(std::string(value, size), data[i]);
+    }
+}
+
 TEST(storage, InsertDataVectorFloat) {
     std::vector<float> data = {1, 2, 3, 4, 5, 6, 7, 8};
     int DIM = 2;
@@ -113,3 +145,39 @@ TEST(storage, LocalIndexData) {
     memcpy(new_data.data(), new_payload->raw_data, new_payload->rows * sizeof(uint8_t));
     ASSERT_EQ(data, new_data);
 }
+
+TEST(storage, Crc32c) {
+    std::string digits = "123456789";
+    ASSERT_EQ(storage::Crc32c(digits.data(), digits.size()), 0xe3069283);
+    ASSERT_EQ(storage::Crc32c(digits.data() + 4, 5, storage::Crc32c(digits.data(), 4)), 0xe3069283);
+    ASSERT_EQ(storage::Crc32c(nullptr, 0), 0);
+}
+
+TEST(storage, InsertDataChecksum) {
+    std::vector<float> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+    storage::Payload payload{storage::DataType::FLOAT, reinterpret_cast<const uint8_t*>(data.data()), int(data.size())};
+    auto field_data = std::make_shared<storage::FieldData>(payload);
+    storage::InsertData insert_data(field_data);
+    insert_data.SetFieldDataMeta(storage::FieldDataMeta{100, 101, 102, 103});
+    insert_data.SetTimestamps(0, 100);
+
+    auto checksum = binlog_checksum;
+    SetBinlogChecksum(true);
+    auto serialized_bytes = insert_data.Serialize(storage::StorageType::Remote);
+    SetBinlogChecksum(checksum);
+
+    storage::PayloadInputStream input(serialized_bytes.data(), serialized_bytes.size());
+    storage::ReadMediumType(&input);
+    storage::DescriptorEvent descriptor_event(&input);
+    ASSERT_TRUE(storage::GetPayloadCrc32c(descriptor_event.event_data).has_value());
+
+    auto decoded = storage::DeserializeFileData(serialized_bytes.data(), serialized_bytes.size());
+    auto new_payload = decoded->GetPayload();
+    ASSERT_EQ(new_payload->rows, data.size());
+    ASSERT_EQ(memcmp(new_payload->raw_data, data.data(), data.size() * sizeof(float)), 0);
+
+    // a flipped bit of the payload fails the read instead of loading
+    serialized_bytes[serialized_bytes.size() - 100] ^= 1;
+    ASSERT_ANY_THROW(storage::DeserializeFileData(serialized_bytes.data(), serialized_bytes.size()));
+}
@@ -15,8 +15,11 @@
 #include <vector>
 #include <unistd.h>
 
+#include "common/MemoryBudget.h"
 #include "common/Slice.h"
+#include "segcore/IndexLoader.h"
 #include "storage/Event.h"
+#include "storage/IndexData.h"
 #include "storage/LocalChunkManager.h"
 #include "storage/MinioChunkManager.h"
 #include "storage/DiskFileManagerImpl.h"
@@ -156,6 +159,60 @@ TEST_F(DiskAnnFileManagerTest, AddFilePositiveParallel) {
     }
 }
 
+TEST_F(DiskAnnFileManagerTest, FetchIndexFiles) {
+    string testBucketName = "test-diskann";
+    storage_config_.bucket_name = testBucketName;
+    auto rcm = std::make_unique<MinioChunkManager>(storage_config_);
+    if (!rcm->BucketExists(testBucketName)) {
+        rcm->CreateBucket(testBucketName);
+    }
+
+    FieldDataMeta field_data_meta = {1, 2, 3, 100};
+    IndexMeta index_meta = {3, 100, 1001, 1, "index"};
+    std::vector<std::string> remote_files;
+    std::vector<std::vector<uint8_t>> datas;
+    for (int i = 0; i < 3; ++i) {
+        std::vector<uint8_t> data(1024 * (i + 1), uint8_t(i + 1));
+        auto field_data = std::make_shared<FieldData>(data.data(), data.size());
+        auto index_data = std::make_shared<IndexData>(field_data);
+        index_data->set_index_meta(index_meta);
+        index_data->SetFieldDataMeta(field_data_meta);
+        auto serialized = index_data->serialize_to_remote_file();
+        auto file = "index_files/1001/1/HNSW_" + std::to_string(i);
+        rcm->Write(file, serialized.data(), serialized.size());
+        remote_files.push_back(file);
+        datas.push_back(std::move(data));
+    }
+
+    auto& budget = milvus::IndexFetchBudget();
+    budget.SetCapacity(1 << 20);
+    {
+        auto fetched = milvus::segcore::FetchIndexFiles(*rcm, remote_files);
+        EXPECT_GT(budget.Used(), 6 * 1024);
+        for (int i = 0; i < 3; ++i) {
+            auto binary = fetched.binary_set.GetByName("HNSW_" + std::to_string(i));
+            ASSERT_NE(binary, nullptr);
+            ASSERT_EQ(binary->size, datas[i].size());
+            EXPECT_EQ(memcmp(binary->data.get(), datas[i].data(), binary->size), 0);
+        }
+    }
+    EXPECT_EQ(budget.Used(), 0);
+
+    // an index larger than the whole budget still loads, alone
+    budget.SetCapacity(1024);
+    {
+        auto fetched = milvus::segcore::FetchIndexFiles(*rcm, remote_files);
+        EXPECT_EQ(budget.Used(), 1024);
+        EXPECT_FALSE(budget.TryReserve(1));
+    }
+    EXPECT_EQ(budget.Used(), 0);
+    budget.SetCapacity(0);
+
+    for (auto& file : remote_files) {
+        rcm->Remove(file);
+    }
+}
+
 int
 test_worker(string s) {
     std::cout << s << std::endl;
@@ -180,6 +237,42 @@ TEST_F(DiskAnnFileManagerTest, TestThreadPool) {
     EXPECT_LT(second, 4 * 100);
 }
 
+TEST_F(DiskAnnFileManagerTest, TestThreadPoolNestedSubmit) {
+    auto thread_pool = std::make_unique<milvus::ThreadPool>(2);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 10; i++) {
+        // move-only arguments and tasks submitted from pool threads
+        futures.push_back(thread_pool->Submit(
+            [&thread_pool](std::unique_ptr<int> value) {
+                return thread_pool->Submit([](int v) { return v * 2; }, *value).get();
+            },
+            std::make_unique<int>(i)));
+    }
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(futures[i].get(), i * 2);
+    }
+}
+
+TEST_F(DiskAnnFileManagerTest, TestThreadPoolStats) {
+    auto& pool = milvus::ThreadPool::GetInstance(milvus::ThreadPoolType::QUERY);
+    auto before = pool.GetStats();
+    EXPECT_EQ(before.name, "query");
+    EXPECT_GT(before.thread_num, 0);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 10; i++) {
+        futures.push_back(pool.Submit([i] { return i; }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    // a task is counted once it has run, which may trail its future
+    while (pool.GetStats().finished_tasks < before.finished_tasks + 10) {
+        std::this_thread::yield();
+    }
+    EXPECT_GE(pool.GetStats().avg_wait_us, 0);
+    EXPECT_NE(&pool, &milvus::ThreadPool::GetInstance(milvus::ThreadPoolType::LOAD));
+}
+
 int
 test_exception(string s) {
     if (s == "test_id60") {
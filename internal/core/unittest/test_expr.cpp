@@ -13,6 +13,8 @@
 #include <gtest/gtest.h>
 #include <regex>
 
+#include "common/Common.h"
+#include "query/ArithFold.h"
 #include "query/Expr.h"
 #include "query/Plan.h"
 #include "query/PlanNode.h"
@@ -326,6 +328,62 @@ TEST(Expr, TestRange) {
     }
 }
 
+TEST(Expr, TestRangeUnalignedChunk) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    std::string dsl_string = R"({
+        "bool": {
+            "must": [
+                {
+                    "range": {
+                        "age": {
+                            "GE": 1000, "LT": 3000
+                        }
+                    }
+                },
+                {
+                    "vector": {
+                        "fakevec": {
+                            "metric_type": "L2",
+                            "params": {
+                                "nprobe": 10
+                            },
+                            "query": "$0",
+                            "topk": 10,
+                            "round_decimal": 3
+                        }
+                    }
+                }
+            ]
+        }
+    })";
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+
+    // chunk boundaries fall in the middle of bitset blocks
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1000);
+    auto seg = CreateGrowingSegment(schema, -1, seg_conf);
+    seg->disable_small_index();
+    int N = 10007;
+    auto raw_data = DataGen(schema, N);
+    auto age_col = raw_data.get_col<int64_t>(i64_fid);
+    seg->PreInsert(N);
+    seg->Insert(0, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(*seg_promote, seg_promote->get_row_count(), MAX_TIMESTAMP);
+    auto plan = CreatePlan(*schema, dsl_string);
+    auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+    EXPECT_EQ(final.size(), N);
+    for (int i = 0; i < N; ++i) {
+        auto val = age_col[i];
+        ASSERT_EQ(final[i], 1000 <= val && val < 3000) << "@" << i << "!!" << val;
+    }
+}
+
 TEST(Expr, TestTerm) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -409,6 +467,244 @@ TEST(Expr, TestTerm) {
     }
 }
 
+TEST(Expr, TestTermNonPrimaryKey) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto to_list = [](std::function<bool(int)> pred) {
+        Json terms = Json::array();
+        for (int i = 0; i < 2000; ++i) {
+            if (pred(i)) {
+                terms.push_back(i);
+            }
+        }
+        return terms.dump();
+    };
+
+    // term lists of different lengths take the linear, sorted and hash probes
+    std::vector<std::function<bool(int)>> preds = {
+        [](int v) { return v == 1000; },
+        [](int v) { return v % 199 == 0; },
+        [](int v) { return v < 600 && v % 2 == 0; },
+        [](int v) { return v < 1500 && v % 3 != 0; },
+    };
+
+    std::string dsl_string_tmp = R"({
+        "bool": {
+            "must": [
+                {
+                    "term": {
+                        "score": {
+                            "values": @@@@
+                        }
+                    }
+                },
+                {
+                    "vector": {
+                        "fakevec": {
+                            "metric_type": "L2",
+                            "params": {
+                                "nprobe": 10
+                            },
+                            "query": "$0",
+                            "topk": 10,
+                            "round_decimal": 3
+                        }
+                    }
+                }
+            ]
+        }
+    })";
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    auto i32_fid = schema->AddDebugField("score", DataType::INT32);
+    schema->set_primary_field_id(i64_fid);
+
+    auto seg = CreateGrowingSegment(schema);
+    int N = 1000;
+    std::vector<int> score_col;
+    int num_iters = 10;
+    for (int iter = 0; iter < num_iters; ++iter) {
+        auto raw_data = DataGen(schema, N, iter);
+        auto new_score_col = raw_data.get_col<int>(i32_fid);
+        score_col.insert(score_col.end(), new_score_col.begin(), new_score_col.end());
+        seg->PreInsert(N);
+        seg->Insert(iter * N, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+    }
+
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(*seg_promote, seg_promote->get_row_count(), MAX_TIMESTAMP);
+    for (auto& ref_func : preds) {
+        auto clause = to_list(ref_func);
+        auto loc = dsl_string_tmp.find("@@@@");
+        auto dsl_string = dsl_string_tmp;
+        dsl_string.replace(loc, 4, clause);
+        auto plan = CreatePlan(*schema, dsl_string);
+        auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+        EXPECT_EQ(final.size(), N * num_iters);
+
+        for (int i = 0; i < N * num_iters; ++i) {
+            auto val = score_col[i];
+            ASSERT_EQ(final[i], ref_func(val)) << "@" << i << "!!" << val;
+        }
+    }
+}
+
+TEST(Expr, TestZoneMap) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    std::vector<std::tuple<std::string, std::function<bool(int64_t)>>> testcases = {
+        {R"("range": {"age": {"GT": 2500}})", [](int64_t v) { return v > 2500; }},
+        {R"("range": {"age": {"LE": 8191}})", [](int64_t v) { return v <= 8191; }},
+        {R"("range": {"age": {"EQ": 16384}})", [](int64_t v) { return v == 16384; }},
+        {R"("range": {"age": {"NE": 1000}})", [](int64_t v) { return v != 1000; }},
+        {R"("range": {"age": {"GE": 1000, "LT": 20000}})", [](int64_t v) { return v >= 1000 && v < 20000; }},
+        {R"("range": {"age": {"GT": 8191, "LE": 16383}})", [](int64_t v) { return v > 8191 && v <= 16383; }},
+        {R"("term": {"age": {"values": [7, 9000, 24575]}})",
+         [](int64_t v) { return v == 7 || v == 9000 || v == 24575; }},
+    };
+
+    std::string dsl_string_tmp = R"({
+        "bool": {
+            "must": [
+                {
+                    @@@@
+                },
+                {
+                    "vector": {
+                        "fakevec": {
+                            "metric_type": "L2",
+                            "params": {
+                                "nprobe": 10
+                            },
+                            "query": "$0",
+                            "topk": 10,
+                            "round_decimal": 3
+                        }
+                    }
+                }
+            ]
+        }
+    })";
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk_fid = schema->AddDebugField("id", DataType::INT64);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(pk_fid);
+
+    // age is the row offset, so most zones resolve without a scan
+    int N = 30000;
+    auto raw_data = DataGen(schema, N);
+    auto age_col = raw_data.get_col<int64_t>(i64_fid);
+
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1000);
+    auto growing = CreateGrowingSegment(schema, -1, seg_conf);
+    growing->PreInsert(N);
+    growing->Insert(0, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+    auto growing_promote = dynamic_cast<SegmentGrowingImpl*>(growing.get());
+    auto growing_zone = growing_promote->chunk_zone_map<int64_t>(i64_fid, 3);
+    ASSERT_NE(growing_zone, nullptr);
+    ASSERT_EQ(growing_zone->zones.size(), 1);
+    EXPECT_EQ(growing_zone->zones[0].min, 3000);
+    EXPECT_EQ(growing_zone->zones[0].max, 3999);
+
+    auto sealed = SealedCreator(schema, raw_data);
+    auto sealed_zone = sealed->chunk_zone_map<int64_t>(i64_fid, 0);
+    ASSERT_NE(sealed_zone, nullptr);
+    ASSERT_EQ(sealed_zone->zones.size(), upper_div(N, SEALED_ZONE_ROWS));
+    EXPECT_EQ(sealed_zone->zones[1].min, SEALED_ZONE_ROWS);
+    EXPECT_EQ(sealed_zone->zones[1].max, 2 * SEALED_ZONE_ROWS - 1);
+
+    std::vector<const SegmentInternalInterface*> segments = {growing_promote, sealed.get()};
+    for (auto segment : segments) {
+        ExecExprVisitor visitor(*segment, N, MAX_TIMESTAMP);
+        for (auto [clause, ref_func] : testcases) {
+            auto loc = dsl_string_tmp.find("@@@@");
+            auto dsl_string = dsl_string_tmp;
+            dsl_string.replace(loc, 4, clause);
+            auto plan = CreatePlan(*schema, dsl_string);
+            auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+            EXPECT_EQ(final.size(), N);
+            for (int i = 0; i < N; ++i) {
+                auto val = age_col[i];
+                ASSERT_EQ(final[i], ref_func(val)) << clause << "@" << i << "!!" << val;
+            }
+        }
+    }
+}
+
+TEST(Expr, TestParallelSealed) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    std::vector<std::tuple<std::string, std::function<bool(int64_t, int32_t)>>> testcases = {
+        {R"("range": {"age": {"GE": 70000, "LT": 150000}})",
+         [](int64_t v, int32_t s) { return v >= 70000 && v < 150000; }},
+        {R"("range": {"score": {"LT": 100000}})", [](int64_t v, int32_t s) { return s < 100000; }},
+        {R"("term": {"score": {"values": [1, 77, 1234, 99999]}})",
+         [](int64_t v, int32_t s) { return s == 1 || s == 77 || s == 1234 || s == 99999; }},
+        {R"("range": {"score": {"EQ": {"MOD": {"right_operand": 10, "value": 3}}}})",
+         [](int64_t v, int32_t s) { return s % 10 == 3; }},
+    };
+
+    std::string dsl_string_tmp = R"({
+        "bool": {
+            "must": [
+                {
+                    @@@@
+                },
+                {
+                    "vector": {
+                        "fakevec": {
+                            "metric_type": "L2",
+                            "params": {
+                                "nprobe": 10
+                            },
+                            "query": "$0",
+                            "topk": 10,
+                            "round_decimal": 3
+                        }
+                    }
+                }
+            ]
+        }
+    })";
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    auto i32_fid = schema->AddDebugField("score", DataType::INT32);
+    schema->set_primary_field_id(i64_fid);
+
+    int N = 300007;
+    auto raw_data = DataGen(schema, N);
+    auto age_col = raw_data.get_col<int64_t>(i64_fid);
+    auto score_col = raw_data.get_col<int32_t>(i32_fid);
+    auto sealed = SealedCreator(schema, raw_data);
+
+    // the single sealed chunk is split into morsels shared with the pool
+    auto& config = SegcoreConfig::default_config();
+    auto parallel_rows = config.get_expr_parallel_rows();
+    auto old_cpu_num = milvus::cpu_num;
+    config.set_expr_parallel_rows(1);
+    milvus::SetCpuNum(4);
+
+    ExecExprVisitor visitor(*sealed, N, MAX_TIMESTAMP);
+    for (auto [clause, ref_func] : testcases) {
+        auto loc = dsl_string_tmp.find("@@@@");
+        auto dsl_string = dsl_string_tmp;
+        dsl_string.replace(loc, 4, clause);
+        auto plan = CreatePlan(*schema, dsl_string);
+        auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+        EXPECT_EQ(final.size(), N);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(final[i], ref_func(age_col[i], score_col[i])) << clause << "@" << i;
+        }
+    }
+
+    config.set_expr_parallel_rows(parallel_rows);
+    milvus::SetCpuNum(old_cpu_num);
+}
+
 TEST(Expr, TestSimpleDsl) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -508,6 +804,204 @@ TEST(Expr, TestSimpleDsl) {
     }
 }
 
+TEST(Expr, TestShortCircuit) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto vec_dsl = Json::parse(R"({
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 10,
+                        "round_decimal": 3
+                    }
+                }
+            })");
+    auto range = [](int64_t lower, int64_t upper) {
+        Json s;
+        s["range"]["age"]["GE"] = lower;
+        s["range"]["age"]["LT"] = upper;
+        return s;
+    };
+    auto must = [](std::vector<Json> items) {
+        Json s;
+        s["must"] = items;
+        return s;
+    };
+    auto should = [](std::vector<Json> items) {
+        Json s;
+        s["should"] = items;
+        return s;
+    };
+    auto must_not = [](std::vector<Json> items) {
+        Json s;
+        s["must_not"] = items;
+        return s;
+    };
+
+    int N = 10007;
+    std::vector<std::tuple<Json, std::function<bool(int64_t)>>> testcases;
+    // selective left side, the right side only sees a few blocks
+    testcases.emplace_back(must({range(100, 200), range(150, 20000)}),
+                           [](int64_t x) { return 150 <= x && x < 200; });
+    // NOT below a short-circuited AND
+    testcases.emplace_back(must({range(100, 5000), must_not({range(150, 4000)})}),
+                           [](int64_t x) { return (100 <= x && x < 150) || (4000 <= x && x < 5000); });
+    // left side already decides everything
+    testcases.emplace_back(must({range(N, 2 * N), range(0, N)}), [](int64_t x) { return false; });
+    testcases.emplace_back(should({range(0, N), range(100, 200)}), [](int64_t x) { return true; });
+    // OR below AND, the right side of OR only sees candidates of both
+    testcases.emplace_back(must({range(1000, 3000), should({range(0, 1500), range(2900, 9000)})}),
+                           [](int64_t x) { return (1000 <= x && x < 1500) || (2900 <= x && x < 3000); });
+    testcases.emplace_back(
+        should({range(0, 10), must_not({should({range(5, 9000), range(9500, 9600)})})}),
+        [](int64_t x) { return x < 10 || (9000 <= x && x < 9500) || 9600 <= x; });
+
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+
+    // chunk boundaries fall in the middle of bitset blocks
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1000);
+    auto seg = CreateGrowingSegment(schema, -1, seg_conf);
+    seg->disable_small_index();
+    auto raw_data = DataGen(schema, N);
+    auto age_col = raw_data.get_col<int64_t>(i64_fid);
+    seg->PreInsert(N);
+    seg->Insert(0, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(*seg_promote, seg_promote->get_row_count(), MAX_TIMESTAMP);
+    for (auto [clause, ref_func] : testcases) {
+        Json dsl;
+        dsl["bool"]["must"] = Json::array({clause, vec_dsl});
+        auto plan = CreatePlan(*schema, dsl.dump());
+        auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+        EXPECT_EQ(final.size(), N);
+        for (int i = 0; i < N; ++i) {
+            auto val = age_col[i];
+            ASSERT_EQ(final[i], ref_func(val)) << clause << "@" << i << "!!" << val;
+        }
+    }
+}
+
+TEST(Expr, TestCostOrder) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    auto other_fid = schema->AddDebugField("other", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    int N = 1000;
+    auto seg = CreateGrowingSegment(schema);
+    auto raw_data = DataGen(schema, N);
+    seg->PreInsert(N);
+    seg->Insert(0, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+
+    // the compare of two raw columns written first
+    auto compare = std::make_unique<CompareExpr>();
+    compare->left_field_id_ = i64_fid;
+    compare->right_field_id_ = other_fid;
+    compare->left_data_type_ = DataType::INT64;
+    compare->right_data_type_ = DataType::INT64;
+    compare->op_type_ = OpType::LessEqual;
+    ExprPtr left = std::move(compare);
+    ExprPtr right = std::make_unique<TermExprImpl<int64_t>>(i64_fid, DataType::INT64, std::vector<int64_t>{3, 7});
+    LogicalBinaryExpr expr(LogicalBinaryExpr::OpType::LogicalAnd, left, right);
+
+    QueryProfile profile;
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(*seg_promote, N, MAX_TIMESTAMP, nullptr, &profile);
+    auto final = visitor.call_child(expr);
+    ASSERT_EQ(final.count(), 2);
+    ASSERT_TRUE(final[3]);
+    ASSERT_TRUE(final[7]);
+
+    // the term on the pk runs first, the compare only over its rows
+    ASSERT_EQ(profile.exprs_.size(), 3);
+    ASSERT_EQ(profile.exprs_[0].name_, "Term(" + std::to_string(i64_fid.get()) + ")");
+    ASSERT_EQ(profile.exprs_[1].rows_, 2);
+}
+
+TEST(Expr, TestFusedConjunction) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto i32_fid = schema->AddDebugField("age32", DataType::INT32);
+    auto i64_fid = schema->AddDebugField("age64", DataType::INT64);
+    auto float_fid = schema->AddDebugField("score", DataType::FLOAT);
+    schema->set_primary_field_id(i64_fid);
+
+    // chunk boundaries fall in the middle of bitset blocks
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1000);
+    auto seg = CreateGrowingSegment(schema, -1, seg_conf);
+    seg->disable_small_index();
+    int N = 10007;
+    auto raw_data = DataGen(schema, N);
+    auto i32_col = raw_data.get_col<int32_t>(i32_fid);
+    auto i64_col = raw_data.get_col<int64_t>(i64_fid);
+    auto float_col = raw_data.get_col<float>(float_fid);
+    seg->PreInsert(N);
+    seg->Insert(0, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+
+    auto i32_val = i32_col[N / 3];
+    auto i64_val = i64_col[N / 2];
+    auto lower = std::min(float_col[1], float_col[2]);
+    auto upper = std::max(float_col[1], float_col[2]);
+    // age32 >= i32_val and lower <= score < upper and age64 != i64_val
+    auto make_and = [&]() -> ExprPtr {
+        ExprPtr ge =
+            std::make_unique<UnaryRangeExprImpl<int32_t>>(i32_fid, DataType::INT32, OpType::GreaterEqual, i32_val);
+        ExprPtr range =
+            std::make_unique<BinaryRangeExprImpl<float>>(float_fid, DataType::FLOAT, true, false, lower, upper);
+        ExprPtr ne = std::make_unique<UnaryRangeExprImpl<int64_t>>(i64_fid, DataType::INT64, OpType::NotEqual, i64_val);
+        ExprPtr inner = std::make_unique<LogicalBinaryExpr>(LogicalBinaryExpr::OpType::LogicalAnd, ge, range);
+        return std::make_unique<LogicalBinaryExpr>(LogicalBinaryExpr::OpType::LogicalAnd, inner, ne);
+    };
+    auto and_ref = [&](int i) {
+        return i32_col[i] >= i32_val && lower <= float_col[i] && float_col[i] < upper && i64_col[i] != i64_val;
+    };
+    // age64 < i64_val or the AND above, which only runs over the rows the
+    // left side leaves undecided
+    ExprPtr lt = std::make_unique<UnaryRangeExprImpl<int64_t>>(i64_fid, DataType::INT64, OpType::LessThan, i64_val);
+    ExprPtr conjunction = make_and();
+    LogicalBinaryExpr disjunction(LogicalBinaryExpr::OpType::LogicalOr, lt, conjunction);
+    auto and_expr = make_and();
+
+    auto& config = SegcoreConfig::default_config();
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    std::vector<BitsetType> results;
+    for (auto fused : {true, false}) {
+        config.set_fused_filters(fused);
+        QueryProfile profile;
+        ExecExprVisitor visitor(*seg_promote, N, MAX_TIMESTAMP, nullptr, &profile);
+        auto final = visitor.call_child(*and_expr);
+        ASSERT_EQ(final.size(), N);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(final[i], and_ref(i)) << fused << "@" << i;
+        }
+        // fused, the leaves are not evaluated on their own
+        ASSERT_EQ(profile.exprs_.size(), fused ? 1 : 5);
+
+        auto either = visitor.call_child(disjunction);
+        for (int i = 0; i < N; ++i) {
+            ASSERT_EQ(either[i], i64_col[i] < i64_val || and_ref(i)) << fused << "@" << i;
+        }
+        results.push_back(std::move(either));
+    }
+    ASSERT_EQ(results[0], results[1]);
+    config.set_fused_filters(true);
+}
+
 TEST(Expr, TestCompare) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -585,6 +1079,82 @@ TEST(Expr, TestCompare) {
     }
 }
 
+TEST(Expr, TestCompareFloatDouble) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    std::vector<std::tuple<std::string, std::function<bool(float, double)>>> testcases = {
+        {R"("LT")", [](float a, double b) { return a < b; }},  {R"("LE")", [](float a, double b) { return a <= b; }},
+        {R"("GT")", [](float a, double b) { return a > b; }},  {R"("GE")", [](float a, double b) { return a >= b; }},
+        {R"("EQ")", [](float a, double b) { return a == b; }}, {R"("NE")", [](float a, double b) { return a != b; }},
+    };
+
+    std::string dsl_string_tpl = R"({
+        "bool": {
+            "must": [
+                {
+                    "compare": {
+                        %1%: [
+                            "score1",
+                            "score2"
+                        ]
+                    }
+                },
+                {
+                    "vector": {
+                        "fakevec": {
+                            "metric_type": "L2",
+                            "params": {
+                                "nprobe": 10
+                            },
+                            "query": "$0",
+                            "topk": 10,
+                            "round_decimal": 3
+                        }
+                    }
+                }
+            ]
+        }
+    })";
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto float_fid = schema->AddDebugField("score1", DataType::FLOAT);
+    auto double_fid = schema->AddDebugField("score2", DataType::DOUBLE);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+
+    auto seg = CreateGrowingSegment(schema);
+    int N = 1000;
+    std::vector<float> score1_col;
+    std::vector<double> score2_col;
+    int num_iters = 10;
+    for (int iter = 0; iter < num_iters; ++iter) {
+        auto raw_data = DataGen(schema, N, iter);
+        auto new_score1_col = raw_data.get_col<float>(float_fid);
+        auto new_score2_col = raw_data.get_col<double>(double_fid);
+        score1_col.insert(score1_col.end(), new_score1_col.begin(), new_score1_col.end());
+        score2_col.insert(score2_col.end(), new_score2_col.begin(), new_score2_col.end());
+        seg->PreInsert(N);
+        seg->Insert(iter * N, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+    }
+
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(*seg_promote, seg_promote->get_row_count(), MAX_TIMESTAMP);
+    for (auto [clause, ref_func] : testcases) {
+        auto dsl_string = boost::str(boost::format(dsl_string_tpl) % clause);
+        auto plan = CreatePlan(*schema, dsl_string);
+        auto final = visitor.call_child(*plan->plan_node_->predicate_.value());
+        EXPECT_EQ(final.size(), N * num_iters);
+
+        for (int i = 0; i < N * num_iters; ++i) {
+            auto ans = final[i];
+            auto val1 = score1_col[i];
+            auto val2 = score2_col[i];
+            auto ref = ref_func(val1, val2);
+            ASSERT_EQ(ans, ref) << clause << "@" << i << "!!" << boost::format("[%1%, %2%]") % val1 % val2;
+        }
+    }
+}
+
 TEST(Expr, TestCompareWithScalarIndex) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -1140,6 +1710,102 @@ TEST(Expr, TestBinaryArithOpEvalRangeExceptions) {
     }
 }
 
+TEST(Expr, TestBinaryArithOpEvalRangeFold) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i8_fid = schema->AddDebugField("age8", DataType::INT8);
+    auto i64_fid = schema->AddDebugField("id", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+
+    auto seg = CreateGrowingSegment(schema);
+    int N = 1000;
+    int num_iters = 10;
+    std::vector<int8_t> age8_col;
+    for (int iter = 0; iter < num_iters; ++iter) {
+        auto raw_data = DataGen(schema, N, iter);
+        auto new_age8_col = raw_data.get_col<int8_t>(i8_fid);
+        age8_col.insert(age8_col.end(), new_age8_col.begin(), new_age8_col.end());
+        seg->PreInsert(N);
+        seg->Insert(iter * N, N, raw_data.row_ids_.data(), raw_data.timestamps_.data(), raw_data.raw_);
+    }
+
+    auto seg_promote = dynamic_cast<SegmentGrowingImpl*>(seg.get());
+    ExecExprVisitor visitor(*seg_promote, seg_promote->get_row_count(), MAX_TIMESTAMP);
+
+    auto apply = [](ArithOpType arith_op, int x, int c) {
+        switch (arith_op) {
+            case ArithOpType::Add:
+                return x + c;
+            case ArithOpType::Sub:
+                return x - c;
+            case ArithOpType::Mul:
+                return x * c;
+            case ArithOpType::Div:
+                return x / c;
+            default:
+                return x % c;
+        }
+    };
+    auto compare = [](OpType op, int x, int v) {
+        switch (op) {
+            case OpType::GreaterThan:
+                return x > v;
+            case OpType::GreaterEqual:
+                return x >= v;
+            case OpType::LessThan:
+                return x < v;
+            case OpType::LessEqual:
+                return x <= v;
+            case OpType::Equal:
+                return x == v;
+            default:
+                return x != v;
+        }
+    };
+
+    std::vector<ArithOpType> arith_ops = {
+        ArithOpType::Add, ArithOpType::Sub, ArithOpType::Mul, ArithOpType::Div, ArithOpType::Mod};
+    std::vector<OpType> ops = {OpType::GreaterThan, OpType::GreaterEqual, OpType::LessThan,
+                               OpType::LessEqual,   OpType::Equal,        OpType::NotEqual};
+    std::vector<int8_t> operands = {1, 3, 7, -2, 127};
+    std::vector<int8_t> values = {-128, -5, 0, 4, 100, 127};
+    for (auto arith_op : arith_ops) {
+        for (auto op : ops) {
+            for (auto c : operands) {
+                for (auto v : values) {
+                    auto make_expr = [&] {
+                        return std::make_unique<BinaryArithOpEvalRangeExprImpl<int8_t>>(
+                            i8_fid, DataType::INT8, arith_op, c, op, v);
+                    };
+                    auto raw_expr = make_expr();
+                    auto folded = FoldBinaryArithOpEvalRange(make_expr());
+                    if (arith_op == ArithOpType::Add || arith_op == ArithOpType::Sub) {
+                        ASSERT_EQ(dynamic_cast<BinaryArithOpEvalRangeExpr*>(folded.get()), nullptr);
+                    }
+                    auto raw = visitor.call_child(*raw_expr);
+                    auto final = visitor.call_child(*folded);
+                    ASSERT_EQ(final.size(), N * num_iters);
+                    for (int i = 0; i < N * num_iters; ++i) {
+                        auto val = age8_col[i];
+                        auto ref = compare(op, apply(arith_op, val, c), v);
+                        ASSERT_EQ(raw[i], ref) << int(c) << "," << int(v) << "@" << i << "!!" << int(val);
+                        ASSERT_EQ(final[i], ref) << int(c) << "," << int(v) << "@" << i << "!!" << int(val);
+                    }
+                }
+            }
+        }
+    }
+
+    // integer division by zero is rejected instead of being evaluated
+    for (auto arith_op : {ArithOpType::Div, ArithOpType::Mod}) {
+        auto expr = std::make_unique<BinaryArithOpEvalRangeExprImpl<int8_t>>(
+            i8_fid, DataType::INT8, arith_op, 0, OpType::Equal, 0);
+        ASSERT_ANY_THROW(visitor.call_child(*expr));
+    }
+}
+
 TEST(Expr, TestBinaryArithOpEvalRangeWithScalarSortIndex) {
     using namespace milvus::query;
     using namespace milvus::segcore;
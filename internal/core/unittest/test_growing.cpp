@@ -11,8 +11,25 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+
+#include <boost/format.hpp>
+#include <google/protobuf/text_format.h>
+
+#include "index/BitmapIndex.h"
+#include "query/PlanProto.h"
+#include "query/SearchOnGrowing.h"
+#include "segcore/GrowingGraphIndex.h"
 #include "segcore/SegmentGrowing.h"
 #include "segcore/SegmentGrowingImpl.h"
+#include "segcore/SharedIvf.h"
 #include "pb/schema.pb.h"
 #include "test_utils/DataGen.h"
 
@@ -40,6 +57,102 @@ TEST(Growing, DeleteCount) {
     ASSERT_EQ(cnt, c);
 }
 
+TEST(Growing, VarCharPkDelete) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::VARCHAR);
+    schema->set_primary_field_id(pk);
+    auto segment = CreateGrowingSegment(schema);
+
+    int64_t c = 10;
+    auto offset = segment->PreInsert(c);
+    auto dataset = DataGen(schema, c);
+    auto pks = dataset.get_col<std::string>(pk);
+    segment->Insert(offset, c, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+
+    // the deletes arrive out of timestamp order, the last one twice
+    IdArray ids;
+    for (int64_t i = 0; i < c / 2; ++i) {
+        ids.mutable_str_id()->add_data(pks[i]);
+    }
+    ids.mutable_str_id()->add_data(pks[0]);
+    std::vector<Timestamp> tss(c / 2 + 1);
+    for (int64_t i = 0; i < c / 2; ++i) {
+        tss[i] = c + c / 2 - i;
+    }
+    tss.back() = c + c;
+    auto del_offset = segment->PreDelete(tss.size());
+    auto status = segment->Delete(del_offset, tss.size(), &ids, tss.data());
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(segment->get_deleted_count(), c / 2 + 1);
+    ASSERT_EQ(segment->get_real_count(), c - c / 2);
+
+    // int64 pks do not delete from a varchar pk segment
+    auto int_ids = GenPKs(1, 0);
+    Timestamp ts = c + c;
+    ASSERT_ANY_THROW(segment->Delete(segment->PreDelete(1), 1, int_ids.get(), &ts));
+}
+
+TEST(Growing, DeleteByExpr) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::VARCHAR);
+    auto age = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto segment = CreateGrowingSegment(schema);
+
+    // row i is inserted at timestamp i
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    segment->Insert(
+        segment->PreInsert(N), N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+    auto pks = dataset.get_col<std::string>(pk);
+    auto ages = dataset.get_col<int64_t>(age);
+    auto threshold = ages[N / 3];
+
+    auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  unary_range_expr: <
+    column_info: <
+      field_id: %1%
+      data_type: Int64
+    >
+    op: LessThan
+    value: <
+      int64_val: %2%
+    >
+  >
+>
+output_field_ids: %3%
+)") % age.get() % threshold % pk.get());
+    pb::plan::PlanNode node_proto;
+    google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+    auto plan = query::ProtoParser(*schema).CreateRetrievePlan(node_proto);
+
+    // a delete at N / 2 covers the rows inserted before it
+    Timestamp delete_ts = N / 2;
+    std::set<std::string> expected;
+    for (int64_t i = 0; i < delete_ts; ++i) {
+        if (ages[i] < threshold) {
+            expected.insert(pks[i]);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+    auto internal = dynamic_cast<SegmentInternalInterface*>(segment.get());
+    auto ids = internal->DeleteByExpr(plan.get(), delete_ts);
+    std::set<std::string> deleted(ids->str_id().data().begin(), ids->str_id().data().end());
+    ASSERT_EQ(deleted, expected);
+    ASSERT_EQ(segment->get_deleted_count(), int64_t(expected.size()));
+    ASSERT_EQ(segment->get_real_count(), N - int64_t(expected.size()));
+
+    // the rows left matching are the later ones, a second delete finds
+    // none before delete_ts
+    auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+    for (auto& retrieved : results->fields_data(0).scalars().string_data().data()) {
+        ASSERT_EQ(deleted.count(retrieved), 0);
+    }
+    ASSERT_EQ(internal->DeleteByExpr(plan.get(), delete_ts)->str_id().data_size(), 0);
+    ASSERT_EQ(segment->get_deleted_count(), int64_t(expected.size()));
+}
+
 TEST(Growing, RealCount) {
     auto schema = std::make_shared<Schema>();
     auto pk = schema->AddDebugField("pk", DataType::INT64);
@@ -83,3 +196,822 @@ TEST(Growing, RealCount) {
     ASSERT_TRUE(status.ok());
     ASSERT_EQ(0, segment->get_real_count());
 }
+
+TEST(Growing, Upsert) {
+    for (auto pk_type : {DataType::INT64, DataType::VARCHAR}) {
+        auto schema = std::make_shared<Schema>();
+        auto pk = schema->AddDebugField("pk", pk_type);
+        schema->AddDebugField("value", DataType::INT32);
+        schema->set_primary_field_id(pk);
+        auto segment = CreateGrowingSegment(schema);
+        auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+        auto& deleted_record = impl->get_deleted_record();
+
+        // new pks record no delete
+        int64_t c = 10;
+        auto dataset = DataGen(schema, c);
+        ASSERT_EQ(impl->Upsert(c, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_), 0);
+        ASSERT_EQ(deleted_record.reserved, 0);
+        ASSERT_EQ(segment->get_real_count(), c);
+
+        // the same pks replace every row
+        auto replacing = DataGen(schema, c, 42, c);
+        ASSERT_EQ(impl->Upsert(c, replacing.row_ids_.data(), replacing.timestamps_.data(), replacing.raw_), c);
+        ASSERT_EQ(deleted_record.reserved, c);
+        ASSERT_EQ(segment->get_real_count(), c);
+
+        // pairs of a pk, the second replacing the first: the int pks are 0 and 1 again, the varchar ones new
+        auto pairs = DataGen(schema, 4, 43, 2 * c, 2);
+        ASSERT_EQ(impl->Upsert(4, pairs.row_ids_.data(), pairs.timestamps_.data(), pairs.raw_), 2 * c);
+        if (pk_type == DataType::INT64) {
+            ASSERT_EQ(deleted_record.reserved, c + 4);
+            ASSERT_EQ(segment->get_real_count(), c);
+        } else {
+            ASSERT_EQ(deleted_record.reserved, c + 2);
+            ASSERT_EQ(segment->get_real_count(), c + 2);
+        }
+    }
+}
+
+TEST(Growing, InsertColumns) {
+    for (auto pk_type : {DataType::INT64, DataType::VARCHAR}) {
+        auto schema = std::make_shared<Schema>();
+        auto vec_fid = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 4, knowhere::metric::L2);
+        auto pk_fid = schema->AddDebugField("pk", pk_type);
+        schema->set_primary_field_id(pk_fid);
+        auto age_fid = schema->AddDebugField("age", DataType::INT32);
+        auto name_fid = schema->AddDebugField("name", DataType::VARCHAR);
+
+        int64_t N = 1000;
+        auto dataset = DataGen(schema, N);
+        auto vecs = dataset.get_col<float>(vec_fid);
+        auto ages = dataset.get_col<int32_t>(age_fid);
+        auto names = dataset.get_col<std::string>(name_fid);
+
+        // varchar columns as one buffer and offsets into it
+        auto pack = [](const std::vector<std::string>& strs, std::string& chars, std::vector<int64_t>& offsets) {
+            offsets.push_back(0);
+            for (auto& str : strs) {
+                chars += str;
+                offsets.push_back(chars.size());
+            }
+        };
+        std::string name_chars;
+        std::vector<int64_t> name_offsets;
+        pack(names, name_chars, name_offsets);
+        std::vector<InsertColumn> columns = {
+            {vec_fid, vecs.data()},
+            {age_fid, ages.data()},
+            {name_fid, name_chars.data(), name_offsets.data()},
+        };
+        std::vector<int64_t> int_pks;
+        std::string pk_chars;
+        std::vector<int64_t> pk_offsets;
+        if (pk_type == DataType::INT64) {
+            int_pks = dataset.get_col<int64_t>(pk_fid);
+            columns.push_back({pk_fid, int_pks.data()});
+        } else {
+            pack(dataset.get_col<std::string>(pk_fid), pk_chars, pk_offsets);
+            columns.push_back({pk_fid, pk_chars.data(), pk_offsets.data()});
+        }
+
+        auto expected = CreateGrowingSegment(schema);
+        expected->PreInsert(N);
+        expected->Insert(0, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+        auto segment = CreateGrowingSegment(schema);
+        segment->PreInsert(N);
+        segment->InsertColumns(0, N, dataset.row_ids_.data(), dataset.timestamps_.data(), columns.data(),
+                               columns.size());
+        ASSERT_EQ(segment->get_row_count(), N);
+
+        auto& expected_record = dynamic_cast<SegmentGrowingImpl&>(*expected).get_insert_record();
+        auto& record = dynamic_cast<SegmentGrowingImpl&>(*segment).get_insert_record();
+        auto expected_names = expected_record.get_field_data<std::string>(name_fid);
+        auto record_names = record.get_field_data<std::string>(name_fid);
+        auto record_ages = record.get_field_data<int32_t>(age_fid);
+        auto record_vecs = record.get_field_data<FloatVector>(vec_fid);
+        for (int64_t i = 0; i < N; ++i) {
+            ASSERT_EQ((*record_names)[i], (*expected_names)[i]);
+            ASSERT_EQ((*record_ages)[i], ages[i]);
+            ASSERT_TRUE(std::equal(vecs.begin() + i * 4, vecs.begin() + i * 4 + 4, record_vecs->get_element(i)));
+        }
+
+        IdArray ids;
+        if (pk_type == DataType::INT64) {
+            ids.mutable_int_id()->mutable_data()->Add(int_pks.begin(), int_pks.end());
+        } else {
+            for (auto& pk : dataset.get_col<std::string>(pk_fid)) {
+                ids.mutable_str_id()->add_data(pk);
+            }
+        }
+        auto [found, offsets] = segment->search_ids(ids, MAX_TIMESTAMP);
+        auto [expected_found, expected_offsets] = expected->search_ids(ids, MAX_TIMESTAMP);
+        ASSERT_FALSE(offsets.empty());
+        ASSERT_EQ(offsets, expected_offsets);
+    }
+}
+
+TEST(Growing, SmallIndexBuilder) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool released = false;
+    std::atomic<int> started = 0;
+    std::atomic<int> done = 0;
+    auto blocked = [&] {
+        ++started;
+        std::unique_lock lck(mutex);
+        cv.wait(lck, [&] { return released; });
+        ++done;
+    };
+    {
+        SmallIndexBuilder builder(1, 1);
+        // one task runs, one waits in the queue, the third does not fit
+        // and runs on the submitter
+        builder.Submit(blocked);
+        while (started == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        builder.Submit(blocked);
+        auto caller = std::this_thread::get_id();
+        std::thread::id runner;
+        builder.Submit([&] { runner = std::this_thread::get_id(); });
+        ASSERT_EQ(runner, caller);
+        {
+            std::lock_guard lck(mutex);
+            released = true;
+        }
+        cv.notify_all();
+    }
+    // the destructor drains the queue
+    ASSERT_EQ(done, 2);
+}
+
+TEST(Growing, AsyncSmallIndex) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto age = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1000);
+    auto segment = CreateGrowingSegment(schema, -1, seg_conf);
+
+    int64_t N = 10500;
+    for (int64_t offset = 0; offset < N; offset += 1500) {
+        auto count = std::min<int64_t>(1500, N - offset);
+        auto reserved = segment->PreInsert(count);
+        auto raw = DataGen(schema, count, 42, reserved);
+        segment->Insert(reserved, count, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    }
+    auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+    ASSERT_NE(impl, nullptr);
+    // indexes show up once built, and never for the partial chunk
+    for (int i = 0; i < 10000 && impl->num_chunk_index(age) < N / 1000; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(impl->num_chunk_index(age), N / 1000);
+    for (int64_t chunk_id = 0; chunk_id < N / 1000; ++chunk_id) {
+        auto& indexing = impl->get_indexing_record().get_scalar_field_indexing<int32_t>(age);
+        ASSERT_NE(indexing.get_chunk_indexing(chunk_id), nullptr);
+    }
+}
+
+TEST(Growing, BitmapChunkIndex) {
+    FieldMeta field_meta(FieldName("age"), FieldId(101), DataType::INT32);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1000);
+    ScalarFieldIndexing<int32_t> indexing(field_meta, seg_conf);
+
+    // few distinct values in the first chunk, all distinct in the second
+    ConcurrentVector<int32_t> source(1000);
+    std::vector<int32_t> values(2000);
+    for (int32_t i = 0; i < 2000; ++i) {
+        values[i] = i < 1000 ? i % 5 : i;
+    }
+    source.set_data_raw(0, values.data(), values.size());
+    indexing.BuildIndexRange(0, 2, &source);
+
+    auto bitmap = indexing.get_chunk_indexing(0);
+    ASSERT_NE(dynamic_cast<index::BitmapIndex<int32_t>*>(bitmap), nullptr);
+    ASSERT_EQ(dynamic_cast<index::BitmapIndex<int32_t>*>(indexing.get_chunk_indexing(1)), nullptr);
+    std::vector<int32_t> terms{1, 3, 7};
+    auto in = bitmap->In(terms.size(), terms.data());
+    auto less = bitmap->Range(2, OpType::LessThan);
+    for (int32_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(in->test(i), i % 5 == 1 || i % 5 == 3);
+        ASSERT_EQ(less->test(i), i % 5 < 2);
+    }
+}
+
+TEST(Growing, GraphIndexRecall) {
+    int64_t dim = 16;
+    int64_t N = 5000;
+    ConcurrentVector<FloatVector> source(dim, 1024);
+    std::vector<float> data(N * dim);
+    std::default_random_engine e(42);
+    std::normal_distribution<float> dist;
+    for (auto& x : data) {
+        x = dist(e);
+    }
+    source.grow_to_at_least(N);
+    source.set_data_raw(0, data.data(), N);
+
+    GraphIndexConf conf;
+    GrowingGraphIndex graph(dim, knowhere::metric::L2, conf);
+    graph.Extend(source, N / 2);
+    graph.Extend(source, N);
+    ASSERT_EQ(graph.size(), N);
+
+    // filter the even rows out
+    BitsetType bitset(N);
+    for (int64_t i = 0; i < N; i += 2) {
+        bitset.set(i);
+    }
+    int64_t topk = 10;
+    int64_t hits = 0;
+    int64_t num_queries = 20;
+    for (int64_t q = 0; q < num_queries; ++q) {
+        std::vector<float> query(dim);
+        for (auto& x : query) {
+            x = dist(e);
+        }
+        std::vector<std::pair<float, int64_t>> exact;
+        for (int64_t i = 1; i < N; i += 2) {
+            float d = 0;
+            for (int64_t j = 0; j < dim; ++j) {
+                auto diff = query[j] - data[i * dim + j];
+                d += diff * diff;
+            }
+            exact.emplace_back(d, i);
+        }
+        std::sort(exact.begin(), exact.end());
+        std::set<int64_t> truth;
+        for (int64_t k = 0; k < topk; ++k) {
+            truth.insert(exact[k].second);
+        }
+
+        std::vector<int64_t> offsets(topk, -1);
+        std::vector<float> distances(topk);
+        auto found = graph.Search(query.data(), topk, conf.ef_search, N, BitsetView(bitset), offsets.data(), distances.data());
+        ASSERT_EQ(found, topk);
+        for (int64_t k = 0; k < topk; ++k) {
+            ASSERT_EQ(offsets[k] % 2, 1);
+            if (k > 0) {
+                ASSERT_LE(distances[k - 1], distances[k]);
+            }
+            hits += truth.count(offsets[k]);
+        }
+    }
+    ASSERT_GE(hits, num_queries * topk * 9 / 10);
+
+    // rows past the limit are never returned
+    std::vector<int64_t> offsets(topk, -1);
+    std::vector<float> distances(topk);
+    auto found = graph.Search(data.data(), topk, conf.ef_search, 5, BitsetView(), offsets.data(), distances.data());
+    ASSERT_EQ(found, 5);
+    for (int64_t k = 0; k < found; ++k) {
+        ASSERT_LT(offsets[k], 5);
+    }
+}
+
+TEST(Growing, GraphIndexSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1024);
+    seg_conf.set_growing_index_type("HNSW");
+    auto graph_conf = seg_conf.get_graph_index_config();
+    graph_conf.build_lag = 256;
+    seg_conf.set_graph_index_config(graph_conf);
+    auto segment = CreateGrowingSegment(schema, -1, seg_conf);
+
+    int64_t N = 4000;
+    std::vector<float> vectors;
+    for (int64_t offset = 0; offset < N; offset += 500) {
+        auto reserved = segment->PreInsert(500);
+        auto raw = DataGen(schema, 500, 42 + offset, reserved);
+        auto col = raw.get_col<float>(vec);
+        vectors.insert(vectors.end(), col.begin(), col.end());
+        segment->Insert(reserved, 500, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    }
+    auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+    ASSERT_NE(impl, nullptr);
+    auto graph = impl->get_indexing_record().get_graph_index(vec);
+    ASSERT_NE(graph, nullptr);
+    // no chunk indexes for a field indexed by a graph
+    ASSERT_FALSE(impl->get_indexing_record().is_in(vec));
+    // the graph ends on a multiple of 64 rows
+    for (int i = 0; i < 10000 && graph->size() < N - N % 64; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(graph->size(), N - N % 64);
+
+    // a row in the graph and one in the brute forced tail find themselves
+    SearchInfo info{5, -1, vec, knowhere::metric::L2, {}};
+    BitsetType bitset(N);
+    for (int64_t row : {int64_t(10), N - 1}) {
+        SearchResult result;
+        query::SearchOnGrowing(*impl, info, vectors.data() + row * 16, 1, MAX_TIMESTAMP, BitsetView(bitset), result);
+        ASSERT_EQ(result.seg_offsets_[0], row);
+        ASSERT_NEAR(result.distances_[0], 0, 1e-4);
+    }
+}
+
+TEST(Growing, ParallelChunkSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(256);
+    auto segment = CreateGrowingSegment(schema, -1, seg_conf);
+    auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+    ASSERT_NE(impl, nullptr);
+    impl->disable_small_index();
+
+    int64_t N = 4000;
+    auto raw = DataGen(schema, N);
+    segment->PreInsert(N);
+    segment->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    auto vectors = raw.get_col<float>(vec);
+
+    int64_t num_queries = 5;
+    SearchInfo info{10, -1, vec, knowhere::metric::L2, {}};
+    BitsetType bitset(N);
+    SearchResult parallel;
+    query::SearchOnGrowing(*impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), parallel);
+
+    // the same segment searched chunk by chunk
+    seg_conf.set_growing_search_parallelism(1);
+    auto sequential_segment = CreateGrowingSegment(schema, -1, seg_conf);
+    auto sequential_impl = dynamic_cast<SegmentGrowingImpl*>(sequential_segment.get());
+    sequential_impl->disable_small_index();
+    sequential_segment->PreInsert(N);
+    sequential_segment->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    SearchResult sequential;
+    query::SearchOnGrowing(
+        *sequential_impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), sequential);
+
+    ASSERT_EQ(parallel.seg_offsets_, sequential.seg_offsets_);
+    ASSERT_EQ(parallel.distances_, sequential.distances_);
+    for (int64_t q = 0; q < num_queries; ++q) {
+        ASSERT_EQ(parallel.seg_offsets_[q * 10], q);
+    }
+}
+
+TEST(Growing, VectorChunkBytes) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto age = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(4096);
+    auto uniform_segment = CreateGrowingSegment(schema, -1, seg_conf);
+    // 64 bytes a row, 1024 rows a chunk
+    seg_conf.set_vector_chunk_bytes(64 * 1024);
+    ASSERT_EQ(seg_conf.get_chunk_rows((*schema)[vec]), 1024);
+    ASSERT_EQ(seg_conf.get_chunk_rows((*schema)[age]), 4096);
+    auto segment = CreateGrowingSegment(schema, -1, seg_conf);
+    auto indexed_segment = CreateGrowingSegment(schema, -1, seg_conf);
+    auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+    auto uniform_impl = dynamic_cast<SegmentGrowingImpl*>(uniform_segment.get());
+    auto indexed_impl = dynamic_cast<SegmentGrowingImpl*>(indexed_segment.get());
+    ASSERT_EQ(impl->get_insert_record().get_field_data_base(vec)->get_size_per_chunk(), 1024);
+    ASSERT_EQ(impl->get_insert_record().get_field_data_base(age)->get_size_per_chunk(), 4096);
+    impl->disable_small_index();
+    uniform_impl->disable_small_index();
+
+    int64_t N = 9000;
+    auto raw = DataGen(schema, N);
+    for (auto& s : {segment.get(), uniform_segment.get(), indexed_segment.get()}) {
+        s->PreInsert(N);
+        s->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    }
+
+    // every field gets the indexes of its own complete chunks
+    for (int i = 0; i < 10000 && indexed_impl->num_chunk_index(vec) < N / 1024; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(indexed_impl->num_chunk_index(vec), N / 1024);
+    ASSERT_EQ(indexed_impl->num_chunk_index(age), N / 4096);
+
+    // the brute force over the smaller chunks finds the same rows
+    int64_t num_queries = 5;
+    auto vectors = raw.get_col<float>(vec);
+    SearchInfo info{10, -1, vec, knowhere::metric::L2, {}};
+    BitsetType bitset(N);
+    SearchResult chunked;
+    SearchResult uniform;
+    query::SearchOnGrowing(*impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), chunked);
+    query::SearchOnGrowing(
+        *uniform_impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), uniform);
+    ASSERT_EQ(chunked.seg_offsets_, uniform.seg_offsets_);
+    ASSERT_EQ(chunked.distances_, uniform.distances_);
+}
+
+TEST(Growing, SpillChunks) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(4096);
+    auto segment = CreateGrowingSegment(schema, -1, seg_conf);
+    auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+    impl->disable_small_index();
+
+    int64_t N = 9000;
+    auto raw = DataGen(schema, N);
+    segment->PreInsert(N);
+    segment->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    auto vectors = raw.get_col<float>(vec);
+    int64_t num_queries = 5;
+    SearchInfo info{10, -1, vec, knowhere::metric::L2, {}};
+    BitsetType bitset(N);
+    SearchResult before;
+    query::SearchOnGrowing(*impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), before);
+
+    auto dir = std::filesystem::temp_directory_path() / "growing_spill_test";
+    std::filesystem::create_directories(dir);
+    auto& arena = impl->get_insert_record().chunk_arena_;
+    auto allocated = arena.allocated_bytes();
+    // the two full chunks of vectors, the smaller chunks are not mmap-ed
+    auto spilled = impl->SpillChunks(dir.string());
+    ASSERT_EQ(spilled, 2 * 4096 * 16 * sizeof(float));
+    ASSERT_EQ(arena.spilled_bytes(), spilled);
+    ASSERT_EQ(arena.allocated_bytes(), allocated - spilled);
+    ASSERT_EQ(impl->SpillChunks(dir.string()), 0);
+    // the files are unlinked
+    ASSERT_TRUE(std::filesystem::is_empty(dir));
+
+    // the rows read the same through the spilled chunks
+    auto field_data = impl->get_insert_record().get_field_data<FloatVector>(vec);
+    for (int64_t i = 0; i < N; i += 97) {
+        ASSERT_EQ(memcmp(field_data->get_element(i), vectors.data() + i * 16, 16 * sizeof(float)), 0);
+    }
+    SearchResult after;
+    query::SearchOnGrowing(*impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), after);
+    ASSERT_EQ(before.seg_offsets_, after.seg_offsets_);
+    ASSERT_EQ(before.distances_, after.distances_);
+
+    segment.reset();
+    std::filesystem::remove_all(dir);
+}
+
+TEST(Growing, SearchIterator) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter);
+    auto make_dsl = [](int64_t topk) {
+        return R"({
+        "bool": {
+            "must": [
+            {
+                "range": {
+                    "counter": {
+                        "GE": 1000,
+                        "LT": 3000
+                    }
+                }
+            },
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": )" +
+               std::to_string(topk) + R"(,
+                        "round_decimal": -1
+                    }
+                }
+            }
+            ]
+        }
+    })";
+    };
+
+    int64_t N = 4000;
+    auto raw = DataGen(schema, N);
+    auto segment = CreateGrowingSegment(schema);
+    dynamic_cast<SegmentGrowingImpl*>(segment.get())->disable_small_index();
+    segment->PreInsert(N);
+    segment->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    auto vectors = raw.get_col<float>(vec);
+
+    int64_t num_queries = 2;
+    int64_t page_size = 10;
+    int64_t num_pages = 5;
+    auto plan = query::CreatePlan(*schema, make_dsl(page_size));
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, 16, vectors.data() + 1500 * 16);
+    auto ph_group = query::ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    // the pages are the slices of one search of all of them
+    auto full_plan = query::CreatePlan(*schema, make_dsl(page_size * num_pages));
+    auto full = segment->Search(full_plan.get(), ph_group.get(), MAX_TIMESTAMP);
+
+    auto handle = segment->OpenSearch(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    for (int64_t p = 0; p < num_pages; ++p) {
+        auto page = segment->SearchNext(handle, page_size);
+        ASSERT_EQ(page->total_nq_, num_queries);
+        ASSERT_EQ(page->unity_topK_, page_size);
+        for (int64_t q = 0; q < num_queries; ++q) {
+            for (int64_t i = 0; i < page_size; ++i) {
+                auto expected = q * page_size * num_pages + p * page_size + i;
+                ASSERT_EQ(page->seg_offsets_[q * page_size + i], full->seg_offsets_[expected]);
+                ASSERT_EQ(page->distances_[q * page_size + i], full->distances_[expected]);
+            }
+        }
+    }
+    ASSERT_EQ(full->seg_offsets_[0], 1500);
+
+    // past the filtered rows the pages are padded
+    auto last = segment->SearchNext(handle, 2000);
+    ASSERT_NE(last->seg_offsets_[2000 - page_size * num_pages - 1], INVALID_SEG_OFFSET);
+    ASSERT_EQ(last->seg_offsets_[2000 - page_size * num_pages], INVALID_SEG_OFFSET);
+
+    segment->CloseSearch(handle);
+    ASSERT_ANY_THROW(segment->SearchNext(handle, page_size));
+
+    // an idle handle expires
+    auto& config = SegcoreConfig::default_config();
+    auto ttl = config.get_search_iterator_ttl_ms();
+    config.set_search_iterator_ttl_ms(0);
+    auto expiring = CreateGrowingSegment(schema);
+    config.set_search_iterator_ttl_ms(ttl);
+    expiring->PreInsert(N);
+    expiring->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    handle = expiring->OpenSearch(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_ANY_THROW(expiring->SearchNext(handle, page_size));
+}
+
+TEST(Growing, CosineSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, METRIC_COSINE);
+    auto counter = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "COSINE",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 5,
+                        "round_decimal": -1
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    int64_t N = 1000;
+    auto raw = DataGen(schema, N);
+    auto segment = CreateGrowingSegment(schema);
+    auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+    impl->disable_small_index();
+    segment->PreInsert(N);
+    segment->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+
+    // the rows are stored at unit length
+    auto vectors = raw.get_col<float>(vec);
+    auto record_vecs = impl->get_insert_record().get_field_data<FloatVector>(vec);
+    for (int64_t i = 0; i < N; ++i) {
+        auto row = record_vecs->get_element(i);
+        float norm = 0;
+        float expected_norm = 0;
+        for (int d = 0; d < dim; ++d) {
+            norm += row[d] * row[d];
+            expected_norm += vectors[i * dim + d] * vectors[i * dim + d];
+        }
+        ASSERT_NEAR(norm, 1, 1e-4);
+        ASSERT_NEAR(row[0], vectors[i * dim] / std::sqrt(expected_norm), 1e-5);
+    }
+
+    // a query finds the row it is a multiple of, at a similarity of 1
+    std::vector<float> queries(vectors.begin() + 7 * dim, vectors.begin() + 9 * dim);
+    for (int d = 0; d < dim; ++d) {
+        queries[d] *= 4;
+    }
+    auto plan = query::CreatePlan(*schema, dsl);
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(2, dim, queries.data());
+    auto ph_group = query::ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    auto topk = result->unity_topK_;
+    ASSERT_EQ(result->seg_offsets_[0], 7);
+    ASSERT_EQ(result->seg_offsets_[topk], 8);
+    ASSERT_NEAR(result->distances_[0], 1, 1e-4);
+    ASSERT_NEAR(result->distances_[topk], 1, 1e-4);
+    ASSERT_GE(result->distances_[0], result->distances_[1]);
+}
+
+TEST(Growing, QuantizedChunkSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(256);
+    auto exact_segment = CreateGrowingSegment(schema, -1, seg_conf);
+    seg_conf.set_growing_sq8_refine_ratio(4);
+    auto segment = CreateGrowingSegment(schema, -1, seg_conf);
+    auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+    auto exact_impl = dynamic_cast<SegmentGrowingImpl*>(exact_segment.get());
+    impl->disable_small_index();
+    exact_impl->disable_small_index();
+
+    int64_t N = 4000;
+    auto raw = DataGen(schema, N);
+    for (auto& s : {segment.get(), exact_segment.get()}) {
+        s->PreInsert(N);
+        s->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    }
+    auto& indexing_record = impl->get_indexing_record();
+    auto num_chunks = N / 256;
+    for (int i = 0; i < 10000 && indexing_record.get_quantized_chunk(vec, num_chunks - 1) == nullptr; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_NE(indexing_record.get_quantized_chunk(vec, num_chunks - 1), nullptr);
+    // never for the partial chunk
+    ASSERT_EQ(indexing_record.get_quantized_chunk(vec, num_chunks), nullptr);
+
+    int64_t num_queries = 20;
+    int64_t topk = 10;
+    auto vectors = raw.get_col<float>(vec);
+    SearchInfo info{topk, -1, vec, knowhere::metric::L2, {}};
+    BitsetType bitset(N);
+    SearchResult quantized;
+    SearchResult exact;
+    query::SearchOnGrowing(*impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), quantized);
+    query::SearchOnGrowing(*exact_impl, info, vectors.data(), num_queries, MAX_TIMESTAMP, BitsetView(bitset), exact);
+
+    int64_t hits = 0;
+    for (int64_t q = 0; q < num_queries; ++q) {
+        // re-ranked on the floats, the row itself comes first
+        ASSERT_EQ(quantized.seg_offsets_[q * topk], q);
+        ASSERT_EQ(quantized.distances_[q * topk], 0);
+        std::set<int64_t> truth(exact.seg_offsets_.begin() + q * topk, exact.seg_offsets_.begin() + (q + 1) * topk);
+        for (int64_t i = 0; i < topk; ++i) {
+            hits += truth.count(quantized.seg_offsets_[q * topk + i]);
+        }
+    }
+    ASSERT_GE(hits, num_queries * topk * 9 / 10);
+}
+
+TEST(Growing, IvfChunk) {
+    int64_t dim = 16;
+    int64_t N = 3000;
+    int64_t nlist = 16;
+    std::vector<float> data(N * dim);
+    std::default_random_engine e(42);
+    std::normal_distribution<float> dist;
+    for (auto& x : data) {
+        x = dist(e);
+    }
+    auto centroids = std::make_shared<IvfCentroids>(data.data(), N, dim, nlist, false);
+    ASSERT_EQ(centroids->nlist(), nlist);
+    // fewer rows than lists
+    ASSERT_EQ(IvfCentroids(data.data(), 5, dim, nlist, false).nlist(), 5);
+
+    // a chunk of other rows is built by assignment to the same centroids
+    IvfChunk chunk(centroids, data.data() + 1000 * dim, 2000);
+    ASSERT_EQ(chunk.centroids(), centroids.get());
+    auto chunk_data = data.data() + 1000 * dim;
+
+    // filter the even rows out
+    BitsetType bitset(2000);
+    for (int64_t i = 0; i < 2000; i += 2) {
+        bitset.set(i);
+    }
+    int64_t topk = 10;
+    int64_t num_queries = 10;
+    // probing every list is exact
+    auto all_lists = centroids->Probe(chunk_data, num_queries, nlist);
+    auto some_lists = centroids->Probe(chunk_data, num_queries, 4);
+    int64_t hits = 0;
+    for (int64_t q = 0; q < num_queries; ++q) {
+        auto query = chunk_data + q * dim;
+        std::vector<std::pair<float, int64_t>> exact;
+        for (int64_t i = 1; i < 2000; i += 2) {
+            float d = 0;
+            for (int64_t j = 0; j < dim; ++j) {
+                auto diff = query[j] - chunk_data[i * dim + j];
+                d += diff * diff;
+            }
+            exact.emplace_back(d, i);
+        }
+        std::sort(exact.begin(), exact.end());
+
+        std::vector<int64_t> offsets(topk, -1);
+        std::vector<float> distances(topk);
+        auto found = chunk.Search(chunk_data,
+                                  query,
+                                  all_lists.data() + q * nlist,
+                                  nlist,
+                                  topk,
+                                  BitsetView(bitset),
+                                  offsets.data(),
+                                  distances.data());
+        ASSERT_EQ(found, topk);
+        for (int64_t k = 0; k < topk; ++k) {
+            ASSERT_EQ(offsets[k], exact[k].second);
+            ASSERT_NEAR(distances[k], exact[k].first, 1e-3);
+        }
+
+        std::set<int64_t> truth;
+        for (int64_t k = 0; k < topk; ++k) {
+            truth.insert(exact[k].second);
+        }
+        found = chunk.Search(chunk_data,
+                             query,
+                             some_lists.data() + q * 4,
+                             4,
+                             topk,
+                             BitsetView(bitset),
+                             offsets.data(),
+                             distances.data());
+        for (int64_t k = 0; k < found; ++k) {
+            ASSERT_EQ(offsets[k] % 2, 1);
+            hits += truth.count(offsets[k]);
+        }
+    }
+    ASSERT_GE(hits, num_queries * topk / 2);
+}
+
+TEST(Growing, SharedIvfSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(1024);
+    seg_conf.set_nlist(16);
+    seg_conf.set_growing_index_type("IVF_SHARED");
+    auto num_shared = SharedCentroids::Global().size();
+
+    // two segments of the collection, indexed over the same centroids
+    int64_t N = 4000;
+    auto raw = DataGen(schema, N);
+    auto vectors = raw.get_col<float>(vec);
+    std::unique_ptr<SegmentGrowing> segments[2];
+    for (auto& segment : segments) {
+        segment = CreateGrowingSegment(schema, -1, seg_conf);
+        segment->PreInsert(N);
+        segment->Insert(0, N, raw.row_ids_.data(), raw.timestamps_.data(), raw.raw_);
+    }
+    const IvfCentroids* centroids = nullptr;
+    for (auto& segment : segments) {
+        auto impl = dynamic_cast<SegmentGrowingImpl*>(segment.get());
+        auto& indexing_record = impl->get_indexing_record();
+        // no knowhere index for the field
+        ASSERT_FALSE(indexing_record.is_in(vec));
+        for (int i = 0; i < 10000 && indexing_record.get_finished_rows() < N - N % 1024; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (int64_t chunk_id = 0; chunk_id < N / 1024; ++chunk_id) {
+            auto chunk = indexing_record.get_ivf_chunk(vec, chunk_id);
+            ASSERT_NE(chunk, nullptr);
+            if (centroids == nullptr) {
+                centroids = chunk->centroids();
+            }
+            ASSERT_EQ(chunk->centroids(), centroids);
+        }
+        // never for the partial chunk
+        ASSERT_EQ(indexing_record.get_ivf_chunk(vec, N / 1024), nullptr);
+        ASSERT_GT(indexing_record.get_chunk_index_memory_usage(), 0);
+
+        // a row in an indexed chunk and one in the brute forced tail find themselves
+        SearchInfo info{5, -1, vec, knowhere::metric::L2, {}};
+        BitsetType bitset(N);
+        for (int64_t row : {int64_t(10), int64_t(2000), N - 1}) {
+            SearchResult result;
+            auto query = vectors.data() + row * 16;
+            query::SearchOnGrowing(*impl, info, query, 1, MAX_TIMESTAMP, BitsetView(bitset), result);
+            ASSERT_EQ(result.seg_offsets_[0], row);
+            ASSERT_NEAR(result.distances_[0], 0, 1e-4);
+            ASSERT_EQ(result.index_chunks_, N / 1024);
+        }
+    }
+    ASSERT_EQ(SharedCentroids::Global().size(), num_shared + 1);
+
+    // the centroids go with the collection
+    segments[0].reset();
+    segments[1].reset();
+    raw.schema_.reset();
+    schema.reset();
+    auto other = std::make_shared<Schema>();
+    auto other_vec = other->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    SharedCentroids::Global().GetOrTrain(other, other_vec, vectors.data(), 100, 16);
+    ASSERT_EQ(SharedCentroids::Global().size(), num_shared + 1);
+}
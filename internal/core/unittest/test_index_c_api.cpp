@@ -233,6 +233,46 @@ TEST(CInt64IndexTest, All) {
     }
 }
 
+TEST(CInt64IndexTest, BuildContext) {
+    auto arr = GenArr<int64_t>(NB);
+    auto [type_params, index_params] = GenParams<int64_t>()[0];
+    auto type_params_str = generate_type_params(type_params);
+    auto index_params_str = generate_index_params(index_params);
+
+    std::vector<std::tuple<std::string, int64_t, int64_t>> reports;
+    auto progress = [](void* user_data, const char* phase, int64_t rows_done, int64_t rows_total) {
+        auto reports = static_cast<std::vector<std::tuple<std::string, int64_t, int64_t>>*>(user_data);
+        reports->emplace_back(phase, rows_done, rows_total);
+    };
+    CBuildContext context;
+    auto status = NewBuildContext(2, progress, &reports, &context);
+    ASSERT_EQ(Success, status.error_code);
+
+    CIndex index;
+    status = CreateIndex(Int64, type_params_str.c_str(), index_params_str.c_str(), &index, c_storage_config);
+    ASSERT_EQ(Success, status.error_code);
+    status = SetIndexBuildContext(index, context);
+    ASSERT_EQ(Success, status.error_code);
+    status = BuildScalarIndex(index, arr.size(), arr.data());
+    ASSERT_EQ(Success, status.error_code);
+    ASSERT_EQ(reports.size(), 2);
+    ASSERT_EQ(reports[0], std::make_tuple(std::string("build"), int64_t(0), int64_t(NB)));
+    ASSERT_EQ(reports[1], std::make_tuple(std::string("build"), int64_t(NB), int64_t(NB)));
+
+    // a cancelled context fails the builds under it
+    CancelBuild(context);
+    status = BuildScalarIndex(index, arr.size(), arr.data());
+    ASSERT_NE(Success, status.error_code);
+    free((char*)status.error_msg);
+    CBinarySet binary_set;
+    status = SerializeIndexToBinarySet(index, &binary_set);
+    ASSERT_NE(Success, status.error_code);
+    free((char*)status.error_msg);
+
+    DeleteIndex(index);
+    DeleteBuildContext(context);
+}
+
 // disable this case since marisa not supported in mac
 #ifdef __linux__
 TEST(CStringIndexTest, All) {
@@ -19,6 +19,7 @@
 #include "query/SearchBruteForce.h"
 #include "segcore/Reduce.h"
 #include "index/IndexFactory.h"
+#include "index/Utils.h"
 #include "common/QueryResult.h"
 #include "test_utils/indexbuilder_test_utils.h"
 #include "test_utils/DataGen.h"
@@ -163,7 +164,7 @@ TEST(Indexing, BinaryBruteForce) {
         query_data  //
     };
 
-    auto sub_result = query::BruteForceSearch(search_dataset, bin_vec.data(), N, knowhere::Json(), nullptr);
+    auto sub_result = query::BruteForceSearch(search_dataset, bin_vec.data(), N, milvus::SearchParams(), nullptr);
 
     SearchResult sr;
     sr.total_nq_ = num_queries;
@@ -280,6 +281,35 @@ TEST(Indexing, Naive) {
     }
 }
 
+TEST(Indexing, AdaptDiskAnnSearch) {
+    using milvus::index::AdaptDiskAnnSearch;
+    // unfiltered queries keep the beamwidth of the load
+    auto params = AdaptDiskAnnSearch(10, 1.0, "balanced", 8);
+    ASSERT_EQ(params.search_list, 32);
+    ASSERT_EQ(params.beamwidth, 8);
+    ASSERT_EQ(AdaptDiskAnnSearch(10, 1.0, "latency", 8).search_list, 16);
+    ASSERT_EQ(AdaptDiskAnnSearch(10, 1.0, "recall", 8).search_list, 64);
+
+    // a selective filter grows the list and the beam
+    params = AdaptDiskAnnSearch(100, 0.5, "recall", 8);
+    ASSERT_EQ(params.search_list, 800);
+    ASSERT_EQ(params.beamwidth, 11);
+
+    // both stay within what a query takes
+    for (int64_t topk : {1, 10, 100, 1000, 10000}) {
+        for (double pass_ratio : {0.0, 0.001, 0.1, 0.5, 1.0}) {
+            for (auto profile : {"latency", "balanced", "recall"}) {
+                auto params = AdaptDiskAnnSearch(topk, pass_ratio, profile, 8);
+                ASSERT_GE(params.search_list, topk);
+                ASSERT_LE(params.search_list, milvus::index::DiskAnnMaxSearchList(topk));
+                ASSERT_GE(params.beamwidth, 1);
+                ASSERT_LE(params.beamwidth, 16);
+            }
+        }
+    }
+    ASSERT_ANY_THROW(AdaptDiskAnnSearch(10, 1.0, "fastest", 8));
+}
+
 using Param = std::pair<knowhere::IndexType, knowhere::MetricType>;
 
 class IndexTest : public ::testing::TestWithParam<Param> {
@@ -22,3 +22,34 @@ TEST(Init, Naive) {
     auto simd_type = SegcoreSetSimdType("auto");
     free(simd_type);
 }
+
+TEST(Init, UpdateConfig) {
+    using namespace milvus;
+    using namespace milvus::segcore;
+    auto& config = SegcoreConfig::default_config();
+    auto nprobe = config.get_nprobe();
+    auto slots = config.get_query_scheduler_slots();
+
+    auto status = SegcoreUpdateConfig(R"({"nprobe": 24, "query_scheduler_slots": 3})");
+    ASSERT_EQ(status.error_code, Success);
+    ASSERT_EQ(config.get_nprobe(), 24);
+    ASSERT_EQ(config.get_query_scheduler_slots(), 3);
+
+    auto runtime_config = SegcoreGetRuntimeConfig();
+    auto settings = nlohmann::json::parse(runtime_config);
+    free(runtime_config);
+    ASSERT_EQ(settings["nprobe"], 24);
+    ASSERT_EQ(settings["query_scheduler_slots"], 3);
+
+    // an unknown setting or a bad value sets none of them
+    status = SegcoreUpdateConfig(R"({"nprobe": 8, "no_such_setting": 1})");
+    ASSERT_NE(status.error_code, Success);
+    status = SegcoreUpdateConfig(R"({"nprobe": 8, "query_scheduler_slots": "many"})");
+    ASSERT_NE(status.error_code, Success);
+    status = SegcoreUpdateConfig(R"({"nprobe": 8, "nlist": 0})");
+    ASSERT_NE(status.error_code, Success);
+    ASSERT_EQ(config.get_nprobe(), 24);
+
+    config.set_nprobe(nprobe);
+    config.set_query_scheduler_slots(slots);
+}
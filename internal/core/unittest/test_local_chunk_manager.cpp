@@ -16,7 +16,12 @@
 #include <string>
 #include <vector>
 
+#include "common/Common.h"
+#include "storage/Checksum.h"
+#include "storage/DataCodec.h"
+#include "storage/InsertData.h"
 #include "storage/LocalChunkManager.h"
+#include "storage/LocalIndexCache.h"
 
 using namespace std;
 using namespace milvus;
@@ -263,3 +268,224 @@ TEST_F(LocalChunkManagerTest, GetSizeOfDir) {
     exist = lcm.DirExist(path_prefix);
     EXPECT_EQ(exist, false);
 }
+
+TEST_F(LocalChunkManagerTest, ReadBatch) {
+    auto& lcm = LocalChunkManager::GetInstance();
+
+    uint8_t data[8] = {0x17, 0x32, 0x45, 0x34, 0x23, 0x11, 0x05, 0x64};
+    string path = "/tmp/local-test-dir/test-read-batch";
+    lcm.CreateFile(path);
+    lcm.Write(path, data, sizeof(data));
+
+    uint8_t first[2];
+    uint8_t second[3];
+    uint8_t beyond[4];
+    auto sizes = lcm.ReadBatch(
+        path, {{5, second, 3}, {1, first, 2}, {6, beyond, 4}});
+    EXPECT_EQ(sizes, std::vector<uint64_t>({3, 2, 2}));
+    EXPECT_EQ(memcmp(second, data + 5, 3), 0);
+    EXPECT_EQ(memcmp(first, data + 1, 2), 0);
+    EXPECT_EQ(memcmp(beyond, data + 6, 2), 0);
+
+    lcm.Remove(path);
+}
+
+TEST_F(LocalChunkManagerTest, AppendDirect) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    ChunkMangerConfig::SetLocalDirectIO(true);
+
+    // crosses the staging buffer and ends in a partial block
+    std::vector<uint8_t> data((4 << 20) + 4096 * 3 + 5);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i * 11);
+    }
+    string path = "/tmp/local-test-dir/test-append-direct";
+    lcm.CreateFile(path);
+    {
+        LocalFileAppender appender(path, 0);
+        appender.Append(data.data(), 7);
+        appender.Append(data.data() + 7, data.size() - 7);
+        EXPECT_EQ(appender.Finish(), data.size());
+    }
+    ChunkMangerConfig::SetLocalDirectIO(false);
+
+    EXPECT_EQ(lcm.Size(path), data.size());
+    std::vector<uint8_t> readdata(data.size());
+    lcm.Read(path, readdata.data(), readdata.size());
+    EXPECT_EQ(readdata, data);
+
+    lcm.Remove(path);
+}
+
+TEST_F(LocalChunkManagerTest, StreamDecodeBinlog) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    int dim = 4;
+    int rows = 1000;
+    std::vector<float> data(rows * dim);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = float(i);
+    }
+    Payload payload{DataType::VECTOR_FLOAT,
+                    reinterpret_cast<const uint8_t*>(data.data()),
+                    rows,
+                    dim};
+    InsertData insert_data(std::make_shared<FieldData>(payload));
+    insert_data.SetFieldDataMeta(FieldDataMeta{100, 101, 102, 103});
+    insert_data.SetTimestamps(0, 100);
+    auto bytes = insert_data.Serialize(StorageType::Remote);
+
+    string path = "/tmp/local-test-dir/test-stream-binlog";
+    lcm.CreateFile(path);
+    lcm.Write(path, bytes.data(), bytes.size());
+
+    // a batch budget of 64 rows forces several batches
+    std::vector<float> decoded;
+    int batches = 0;
+    DeserializeRemoteFileStream(
+        &lcm, path, 64 * dim * sizeof(float), [&](const Payload& p) {
+            EXPECT_EQ(p.dimension.value(), dim);
+            auto values = reinterpret_cast<const float*>(p.raw_data);
+            decoded.insert(decoded.end(), values, values + p.rows * dim);
+            ++batches;
+        });
+    EXPECT_GT(batches, 1);
+    EXPECT_EQ(decoded, data);
+
+    lcm.Remove(path);
+}
+
+TEST_F(LocalChunkManagerTest, LocalIndexCache) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    auto& cache = LocalIndexCache::GetInstance();
+    auto local_cache_size = disk_index_local_cache_size;
+    std::vector<std::string> remote_files{"files/index_0", "files/index_1"};
+    auto download = [&](const std::string& dir) {
+        auto file = dir + "index";
+        lcm.CreateFile(file);
+        std::vector<uint8_t> data(1024);
+        lcm.Write(file, data.data(), data.size());
+        cache.Commit(dir);
+    };
+
+    // without a local cache the files go with the last release
+    SetDiskIndexLocalCacheSize(0);
+    string dir1 = "/tmp/local-test-dir/index_files/1/1/";
+    EXPECT_FALSE(cache.Acquire(dir1, remote_files));
+    download(dir1);
+    EXPECT_TRUE(cache.Acquire(dir1, remote_files));
+    cache.Release(dir1);
+    EXPECT_TRUE(lcm.DirExist(dir1));
+    cache.Release(dir1);
+    EXPECT_FALSE(lcm.DirExist(dir1));
+    EXPECT_FALSE(cache.Contains(dir1));
+
+    // a reload finds the files of the released index while they fit
+    SetDiskIndexLocalCacheSize(1500);
+    EXPECT_FALSE(cache.Acquire(dir1, remote_files));
+    download(dir1);
+    cache.Release(dir1);
+    EXPECT_EQ(cache.ReleasedBytes(), 1024);
+    EXPECT_TRUE(cache.Acquire(dir1, remote_files));
+    EXPECT_EQ(cache.ReleasedBytes(), 0);
+    cache.Release(dir1);
+
+    // other remote files for the directory replace them
+    EXPECT_FALSE(cache.Acquire(dir1, {"files/other_0"}));
+    EXPECT_FALSE(lcm.Exist(dir1 + "index"));
+    download(dir1);
+    cache.Release(dir1);
+
+    // a second index needs the room of the first
+    string dir2 = "/tmp/local-test-dir/index_files/2/1/";
+    EXPECT_FALSE(cache.Acquire(dir2, remote_files));
+    download(dir2);
+    EXPECT_FALSE(lcm.DirExist(dir1));
+    EXPECT_EQ(cache.InUseBytes(), 1024);
+    cache.Release(dir2);
+    EXPECT_TRUE(lcm.DirExist(dir2));
+    EXPECT_EQ(cache.ReleasedBytes(), 1024);
+
+    SetDiskIndexLocalCacheSize(0);
+    EXPECT_TRUE(cache.Acquire(dir2, remote_files));
+    cache.Release(dir2);
+    EXPECT_FALSE(lcm.DirExist(dir2));
+    SetDiskIndexLocalCacheSize(local_cache_size);
+}
+
+TEST_F(LocalChunkManagerTest, LocalIndexCacheChecksum) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    auto& cache = LocalIndexCache::GetInstance();
+    auto local_cache_size = disk_index_local_cache_size;
+    SetDiskIndexLocalCacheSize(1 << 20);
+    std::vector<std::string> remote_files{"files/index_0"};
+    string dir = "/tmp/local-test-dir/index_files/3/1/";
+    auto file = dir + "index";
+    std::vector<uint8_t> data(1024, 7);
+    auto download = [&]() {
+        lcm.CreateFile(file);
+        lcm.Write(file, data.data(), data.size());
+        cache.Commit(dir, {{file, Crc32c(data.data(), data.size())}});
+    };
+
+    EXPECT_FALSE(cache.Acquire(dir, remote_files));
+    download();
+    cache.Release(dir);
+    // an intact kept copy is reused
+    EXPECT_TRUE(cache.Acquire(dir, remote_files));
+    cache.Release(dir);
+
+    // a corrupted one is downloaded again
+    uint8_t flipped = 8;
+    lcm.Write(file, 100, &flipped, 1);
+    EXPECT_FALSE(cache.Acquire(dir, remote_files));
+    EXPECT_FALSE(lcm.Exist(file));
+    download();
+    cache.Release(dir);
+    EXPECT_TRUE(cache.Acquire(dir, remote_files));
+    cache.Release(dir);
+
+    SetDiskIndexLocalCacheSize(0);
+    EXPECT_TRUE(cache.Acquire(dir, remote_files));
+    cache.Release(dir);
+    EXPECT_FALSE(lcm.DirExist(dir));
+    SetDiskIndexLocalCacheSize(local_cache_size);
+}
+
+TEST_F(LocalChunkManagerTest, LocalIndexCacheRecover) {
+    auto& lcm = LocalChunkManager::GetInstance();
+    auto& cache = LocalIndexCache::GetInstance();
+    auto local_cache_size = disk_index_local_cache_size;
+    SetDiskIndexLocalCacheSize(1 << 20);
+    std::vector<std::string> remote_files{"files/index_0"};
+    string root = "/tmp/local-test-dir/index_files";
+    string dir = root + "/4/1/";
+    EXPECT_FALSE(cache.Acquire(dir, remote_files));
+    lcm.CreateFile(dir + "index");
+    std::vector<uint8_t> data(1024);
+    lcm.Write(dir + "index", data.data(), data.size());
+    cache.Commit(dir);
+    EXPECT_TRUE(lcm.Exist(root + "/4/1.manifest"));
+
+    // the files a process left with their manifest are reused
+    string left = root + "/5/1/";
+    lcm.CreateDir(left);
+    lcm.CreateFile(left + "index");
+    lcm.Write(left + "index", data.data(), data.size());
+    std::string manifest = R"({"remote_files":["files/index_0"],"checksums":{}})";
+    lcm.Write(root + "/5/1.manifest", manifest.data(), manifest.size());
+    cache.Recover(root);
+    EXPECT_TRUE(cache.Contains(left));
+    EXPECT_EQ(cache.ReleasedBytes(), 1024);
+    EXPECT_TRUE(cache.Acquire(left, remote_files));
+    EXPECT_EQ(cache.InUseBytes(), 2048);
+
+    // without room they go as soon as they are released
+    SetDiskIndexLocalCacheSize(0);
+    cache.Release(left);
+    cache.Release(dir);
+    EXPECT_FALSE(lcm.DirExist(left));
+    EXPECT_FALSE(lcm.Exist(root + "/5/1.manifest"));
+    EXPECT_FALSE(lcm.DirExist(dir));
+    EXPECT_EQ(cache.InUseBytes(), 0);
+    SetDiskIndexLocalCacheSize(local_cache_size);
+}
@@ -9,10 +9,14 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
+#include <array>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <string>
 #include <vector>
 
+#include "common/Common.h"
+#include "common/Consts.h"
 #include "storage/MinioChunkManager.h"
 #include "test_utils/indexbuilder_test_utils.h"
 
@@ -158,6 +162,113 @@ TEST_F(MinioChunkManagerTest, ReadPositive) {
     chunk_manager_->DeleteBucket(testBucketName);
 }
 
+TEST_F(MinioChunkManagerTest, ReadRangeAndParts) {
+    string testBucketName = "test-read-range";
+    chunk_manager_->SetBucketName(testBucketName);
+    if (!chunk_manager_->BucketExists(testBucketName)) {
+        chunk_manager_->CreateBucket(testBucketName);
+    }
+
+    // spans several parts, the last one partial
+    std::vector<uint8_t> data(DEFAULT_REMOTE_READ_PART_SIZE * 3 + 17);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i * 7);
+    }
+    string path = "1/9/1";
+    chunk_manager_->Write(path, data.data(), data.size());
+
+    std::vector<uint8_t> readdata(data.size());
+    auto size = chunk_manager_->Read(path, readdata.data(), readdata.size());
+    EXPECT_EQ(size, data.size());
+    EXPECT_EQ(readdata, data);
+
+    uint8_t range[10];
+    size = chunk_manager_->Read(path, 100, range, sizeof(range));
+    EXPECT_EQ(size, sizeof(range));
+    EXPECT_EQ(memcmp(range, data.data() + 100, sizeof(range)), 0);
+
+    EXPECT_EQ(chunk_manager_->ReadAll(path), data);
+    EXPECT_THROW(chunk_manager_->ReadAll("1/9/2"), ObjectNotExistException);
+
+    chunk_manager_->Remove(path);
+    chunk_manager_->DeleteBucket(testBucketName);
+}
+
+TEST_F(MinioChunkManagerTest, WriteMultipart) {
+    string testBucketName = "test-write-multipart";
+    chunk_manager_->SetBucketName(testBucketName);
+    if (!chunk_manager_->BucketExists(testBucketName)) {
+        chunk_manager_->CreateBucket(testBucketName);
+    }
+
+    // S3 parts other than the last are at least 5 MB
+    auto part_size = remote_upload_part_size;
+    SetRemoteUploadPartSize(5);
+    std::vector<uint8_t> data((5 << 20) * 2 + 13);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i * 13);
+    }
+    string path = "1/9/3";
+    chunk_manager_->Write(path, data.data(), data.size());
+    EXPECT_EQ(chunk_manager_->ReadAll(path), data);
+
+    string local_file = "/tmp/milvus_test_write_multipart";
+    {
+        std::ofstream file(local_file, std::ios::binary);
+        file.write(reinterpret_cast<char*>(data.data()), data.size());
+    }
+    string file_path = "1/9/4";
+    chunk_manager_->WriteFromLocalFile(file_path, local_file);
+    EXPECT_EQ(chunk_manager_->ReadAll(file_path), data);
+    boost::filesystem::remove(local_file);
+
+    SetRemoteUploadPartSize(part_size);
+    chunk_manager_->Remove(path);
+    chunk_manager_->Remove(file_path);
+    chunk_manager_->DeleteBucket(testBucketName);
+}
+
+TEST_F(MinioChunkManagerTest, Async) {
+    string testBucketName = "test-async";
+    chunk_manager_->SetBucketName(testBucketName);
+    if (!chunk_manager_->BucketExists(testBucketName)) {
+        chunk_manager_->CreateBucket(testBucketName);
+    }
+
+    const int num = 32;
+    uint8_t data[5] = {0x17, 0x32, 0x45, 0x34, 0x23};
+    std::vector<std::future<void>> writes;
+    for (int i = 0; i < num; ++i) {
+        writes.push_back(
+            chunk_manager_->WriteAsync("2/" + to_string(i), data, 5));
+    }
+    for (auto& write : writes) {
+        write.get();
+    }
+
+    std::vector<std::future<uint64_t>> sizes;
+    std::vector<std::future<uint64_t>> reads;
+    std::vector<std::array<uint8_t, 3>> readdata(num);
+    for (int i = 0; i < num; ++i) {
+        sizes.push_back(chunk_manager_->SizeAsync("2/" + to_string(i)));
+        reads.push_back(chunk_manager_->ReadAsync(
+            "2/" + to_string(i), 1, readdata[i].data(), 3));
+    }
+    for (int i = 0; i < num; ++i) {
+        EXPECT_EQ(sizes[i].get(), 5);
+        EXPECT_EQ(reads[i].get(), 3);
+        EXPECT_EQ(memcmp(readdata[i].data(), data + 1, 3), 0);
+    }
+    uint8_t buf[5];
+    auto missing = chunk_manager_->ReadAsync("2/missing", 0, buf, 5);
+    EXPECT_THROW(missing.get(), ObjectNotExistException);
+
+    for (int i = 0; i < num; ++i) {
+        chunk_manager_->Remove("2/" + to_string(i));
+    }
+    chunk_manager_->DeleteBucket(testBucketName);
+}
+
 TEST_F(MinioChunkManagerTest, RemovePositive) {
     string testBucketName = "test-remove";
     chunk_manager_->SetBucketName(testBucketName);
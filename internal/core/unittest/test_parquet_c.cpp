@@ -212,6 +212,43 @@ TEST(storage, stringarray) {
     ReleasePayloadReader(reader);
 }
 
+TEST(storage, stringarray_batch) {
+    auto payload = NewPayloadWriter(int(milvus::DataType::VARCHAR));
+    char data[] = "1234abcxyz";
+    int32_t offsets[] = {0, 4, 4, 7};
+    auto st = AddStringsToPayload(payload, data, offsets, 3);
+    ASSERT_EQ(st.error_code, ErrorCode::Success);
+    st = AddOneStringToPayload(payload, (char*)"xyz", 3);
+    ASSERT_EQ(st.error_code, ErrorCode::Success);
+    st = FinishPayloadWriter(payload);
+    ASSERT_EQ(st.error_code, ErrorCode::Success);
+    ASSERT_EQ(GetPayloadLengthFromWriter(payload), 4);
+    auto cb = GetPayloadBufferFromWriter(payload);
+
+    auto reader = NewPayloadReader(int(milvus::DataType::VARCHAR), (uint8_t*)cb.data, cb.length);
+    const char* values;
+    const int32_t* value_offsets;
+    int length;
+    st = GetStringsFromPayload(reader, &values, &value_offsets, &length);
+    ASSERT_EQ(st.error_code, ErrorCode::Success);
+    ASSERT_EQ(length, 4);
+    std::vector<std::string> strings;
+    for (int i = 0; i < length; ++i) {
+        strings.emplace_back(values + value_offsets[i], value_offsets[i + 1] - value_offsets[i]);
+    }
+    ASSERT_EQ(strings, (std::vector<std::string>{"1234", "", "abc", "xyz"}));
+
+    // the views are the buffers the strings are read from
+    char* v;
+    int s;
+    st = GetOneStringFromPayload(reader, 2, &v, &s);
+    ASSERT_EQ(st.error_code, ErrorCode::Success);
+    ASSERT_EQ(v, values + value_offsets[2]);
+
+    ReleasePayloadWriter(payload);
+    ReleasePayloadReader(reader);
+}
+
 TEST(storage, binary_vector) {
     int DIM = 16;
     auto payload = NewVectorPayloadWriter(int(milvus::DataType::VECTOR_BINARY), DIM);
@@ -348,3 +385,29 @@ TEST(storage, int8_2) {
     ASSERT_EQ(bool_array->Value(2), -100);
     ASSERT_EQ(bool_array->Value(3), 100);
 }
+
+TEST(storage, write_options) {
+    std::vector<double> data(1000);
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = i * 0.5;
+    }
+    milvus::storage::Payload payload{milvus::DataType::DOUBLE, reinterpret_cast<const uint8_t*>(data.data()),
+                                     int(data.size())};
+
+    for (auto compression : {arrow::Compression::UNCOMPRESSED, arrow::Compression::LZ4, arrow::Compression::ZSTD}) {
+        wrapper::PayloadWriter writer(milvus::DataType::DOUBLE);
+        writer.set_write_options({compression, 1, true});
+        writer.add_payload(payload);
+        writer.finish();
+        auto& stats = writer.get_stats();
+        ASSERT_EQ(stats.raw_size, data.size() * sizeof(double));
+        ASSERT_EQ(stats.encoded_size, writer.get_payload_buffer().size());
+        ASSERT_GT(stats.compression_ratio(), 0);
+
+        auto& buffer = writer.get_payload_buffer();
+        wrapper::PayloadReader reader(buffer.data(), buffer.size(), milvus::DataType::DOUBLE);
+        auto new_payload = reader.get_payload();
+        ASSERT_EQ(new_payload->rows, data.size());
+        ASSERT_EQ(memcmp(new_payload->raw_data, data.data(), data.size() * sizeof(double)), 0);
+    }
+}
@@ -661,3 +661,57 @@ vector_anns: <
     auto ref_plan = CreatePlan(*schema, dsl_text);
     plan->check_identical(*ref_plan);
 }
+
+TEST(PlanProtoTest, SimplifyExpr) {
+    auto leaf = [](int64_t field_id, const string& op, int64_t value) {
+        return boost::str(boost::format(R"(unary_range_expr: <
+  column_info: < field_id: %1% data_type: Int64 >
+  op: %2%
+  value: < int64_val: %3% >
+>)") % field_id % op % value);
+    };
+    auto logical = [](const string& op, const string& left, const string& right) {
+        return "binary_expr: < op: " + op + " left: < " + left + " > right: < " + right + " > >";
+    };
+    auto expect = [](const string& text, const string& expected_text) {
+        planpb::Expr expr;
+        planpb::Expr expected;
+        ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(text, &expr));
+        ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(expected_text, &expected));
+        auto simplified = SimplifyExpr(expr);
+        EXPECT_EQ(simplified.SerializeAsString(), expected.SerializeAsString()) << simplified.DebugString();
+    };
+    auto a_gt5 = leaf(101, "GreaterThan", 5);
+    auto a_gt3 = leaf(101, "GreaterThan", 3);
+    auto a_lt10 = leaf(101, "LessThan", 10);
+    auto a_lt4 = leaf(101, "LessThan", 4);
+    auto b_eq2 = leaf(102, "Equal", 2);
+    auto c_eq3 = leaf(103, "Equal", 3);
+
+    // a > 5 && a > 3 && a < 10 is 5 < a < 10
+    expect(logical("LogicalAnd", logical("LogicalAnd", a_gt5, a_gt3), a_lt10), R"(binary_range_expr: <
+  column_info: < field_id: 101 data_type: Int64 >
+  lower_value: < int64_val: 5 >
+  upper_value: < int64_val: 10 >
+>)");
+    // a > 5 && a < 4 matches nothing, and neither does an AND over it
+    auto never = "term_expr: < column_info: < field_id: 101 data_type: Int64 > >";
+    expect(logical("LogicalAnd", a_gt5, a_lt4), never);
+    expect(logical("LogicalOr", logical("LogicalAnd", b_eq2, logical("LogicalAnd", a_gt5, a_lt4)), c_eq3), c_eq3);
+    // repeated operands are kept once
+    expect(logical("LogicalAnd", b_eq2, b_eq2), b_eq2);
+    // common conjuncts move out of the OR
+    expect(logical("LogicalOr", logical("LogicalAnd", a_gt5, b_eq2), logical("LogicalAnd", a_gt5, c_eq3)),
+           logical("LogicalAnd", a_gt5, logical("LogicalOr", b_eq2, c_eq3)));
+    expect(logical("LogicalOr", a_gt5, logical("LogicalAnd", a_gt5, c_eq3)), a_gt5);
+    // bounds out of the range of the field are not merged
+    auto narrow = [](const string& op, int64_t value) {
+        return boost::str(boost::format(R"(unary_range_expr: <
+  column_info: < field_id: 104 data_type: Int8 >
+  op: %1%
+  value: < int64_val: %2% >
+>)") % op % value);
+    };
+    auto wide = logical("LogicalAnd", narrow("GreaterThan", 256), narrow("GreaterThan", 3));
+    expect(wide, wide);
+}
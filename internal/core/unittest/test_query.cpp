@@ -11,6 +11,8 @@
 
 #include <gtest/gtest.h>
 
+#include <numeric>
+
 #include "pb/schema.pb.h"
 #include "query/Expr.h"
 #include "query/PlanImpl.h"
@@ -135,6 +137,55 @@ TEST(Query, ParsePlaceholderGroup) {
     auto placeholder = ParsePlaceholderGroup(plan.get(), blob);
 }
 
+TEST(Query, ParsePlaceholderGroupView) {
+    std::string dsl_string = R"(
+{
+    "bool": {
+        "vector": {
+            "fakevec": {
+                "metric_type": "L2",
+                "params": {
+                    "nprobe": 10
+                },
+                "query": "$0",
+                "topk": 10,
+                "round_decimal":3
+            }
+        }
+    }
+})";
+
+    auto schema = std::make_shared<Schema>();
+    int dim = 16;
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto plan = CreatePlan(*schema, dsl_string);
+    for (int64_t num_queries : {1, 10}) {
+        std::vector<float> vecs(num_queries * dim);
+        std::iota(vecs.begin(), vecs.end(), 0);
+        auto raw_group = CreatePlaceholderGroup(num_queries, dim, vecs);
+        auto blob = std::make_shared<const std::string>(raw_group.SerializeAsString());
+        auto placeholder = ParsePlaceholderGroup(plan.get(), blob);
+        auto& ph = placeholder->at(0);
+        ASSERT_EQ(ph.num_of_queries_, num_queries);
+        auto data = ph.get_blob<float>();
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % alignof(float), 0);
+        ASSERT_EQ(std::vector<float>(data, data + vecs.size()), vecs);
+
+        // only a single query is contiguous in the serialized group
+        std::string first_query(reinterpret_cast<const char*>(vecs.data()), dim * sizeof(float));
+        auto line = blob->data() + blob->find(first_query);
+        auto viewable = num_queries == 1 && reinterpret_cast<uintptr_t>(line) % alignof(float) == 0;
+        ASSERT_EQ(ph.holder_ == blob, viewable);
+        ASSERT_EQ(reinterpret_cast<const char*>(data) == line, viewable);
+
+        // without a kept buffer the queries are always copied
+        auto copied = ParsePlaceholderGroup(plan.get(), *blob);
+        ASSERT_NE(copied->at(0).holder_, blob);
+        auto copied_data = copied->at(0).get_blob<float>();
+        ASSERT_EQ(std::vector<float>(copied_data, copied_data + vecs.size()), vecs);
+    }
+}
+
 TEST(Query, ExecWithPredicateLoader) {
     using namespace milvus::query;
     using namespace milvus::segcore;
@@ -752,6 +803,21 @@ TEST(Query, FillSegment) {
                 ASSERT_EQ(i32, std_i32);
             }
         }
+
+        // rows kept for several nqs are fetched once and fanned out
+        SearchResult repeated;
+        repeated.seg_offsets_ = {7, 3, 7, 7, 0, 3};
+        repeated.distances_.resize(repeated.seg_offsets_.size());
+        segment->FillTargetEntry(plan.get(), repeated);
+        auto& repeated_vec = repeated.output_fields_data_.at(vec_field_id)->vectors().float_vector().data();
+        auto& repeated_i32 = repeated.output_fields_data_.at(i32_field_id)->scalars().int_data().data();
+        ASSERT_EQ(repeated_i32.size(), repeated.seg_offsets_.size());
+        for (int i = 0; i < repeated.seg_offsets_.size(); i++) {
+            auto internal_offset = repeated.seg_offsets_[i];
+            ASSERT_EQ(repeated_i32[i], std_i32_vec[internal_offset]);
+            ASSERT_TRUE(std::equal(repeated_vec.begin() + i * dim, repeated_vec.begin() + (i + 1) * dim,
+                                   std_vfloat_vec.begin() + internal_offset * dim));
+        }
     }
 }
 
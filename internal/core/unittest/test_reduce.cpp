@@ -124,3 +124,56 @@ TEST(Reduce, SubSearchResult) {
     TestSubSearchResultMerge<queue_type_ip>(knowhere::metric::IP, 4, 16, 1);
     TestSubSearchResultMerge<queue_type_ip>(knowhere::metric::IP, 4, 16, 10);
 }
+
+template <class queue_type>
+void
+TestSubSearchResultMergeMany(const knowhere::MetricType& metric_type,
+                             const int64_t num_results,
+                             const int64_t nq,
+                             const int64_t topk) {
+    const int64_t round_decimal = 3;
+
+    std::vector<queue_type> result_ref(nq);
+
+    std::vector<SubSearchResultUniq> sub_results;
+    std::vector<const SubSearchResult*> others;
+    for (int i = 0; i < num_results; ++i) {
+        sub_results.push_back(GenSubSearchResult(nq, topk, metric_type, round_decimal));
+        auto ids = sub_results.back()->get_ids();
+        for (int n = 0; n < nq; ++n) {
+            for (int k = 0; k < topk; ++k) {
+                result_ref[n].push(ids[n * topk + k]);
+                if (result_ref[n].size() > topk) {
+                    result_ref[n].pop();
+                }
+            }
+        }
+        if (i > 0) {
+            others.push_back(sub_results.back().get());
+        }
+    }
+    sub_results.front()->merge_many(others);
+    CheckSubSearchResult<queue_type>(nq, topk, *sub_results.front(), result_ref);
+}
+
+TEST(Reduce, SubSearchResultMergeMany) {
+    using queue_type_l2 = std::priority_queue<int64_t, std::vector<int64_t>, std::less<int64_t>>;
+    using queue_type_ip = std::priority_queue<int64_t, std::vector<int64_t>, std::greater<int64_t>>;
+
+    TestSubSearchResultMergeMany<queue_type_l2>(knowhere::metric::L2, 1, 16, 10);
+    TestSubSearchResultMergeMany<queue_type_l2>(knowhere::metric::L2, 2, 1, 1);
+    TestSubSearchResultMergeMany<queue_type_l2>(knowhere::metric::L2, 30, 16, 10);
+    TestSubSearchResultMergeMany<queue_type_ip>(knowhere::metric::IP, 1, 16, 10);
+    TestSubSearchResultMergeMany<queue_type_ip>(knowhere::metric::IP, 2, 1, 1);
+    TestSubSearchResultMergeMany<queue_type_ip>(knowhere::metric::IP, 30, 16, 10);
+
+    // partial results end with invalid entries, which never win
+    SubSearchResult left(1, 4, knowhere::metric::L2, -1);
+    SubSearchResult right(1, 4, knowhere::metric::L2, -1);
+    left.mutable_seg_offsets()[0] = 7;
+    left.mutable_distances()[0] = 2;
+    right.mutable_seg_offsets()[0] = 9;
+    right.mutable_distances()[0] = 1;
+    left.merge_many({&right});
+    ASSERT_EQ(left.mutable_seg_offsets(), (std::vector<int64_t>{9, 7, -1, -1}));
+}
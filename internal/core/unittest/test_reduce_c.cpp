@@ -33,3 +33,38 @@ TEST(SearchResultPair, SameDistance) {
     ASSERT_EQ(pair2 > pair1, true);
     ASSERT_EQ(pair1.primary_key_, INVALID_PK);
 }
+
+TEST(PkDedupSet, Int64) {
+    PkDedupSet pk_set;
+    for (int64_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(pk_set.insert(milvus::PkType(i * 1024)));
+    }
+    for (int64_t i = 0; i < 1000; ++i) {
+        ASSERT_FALSE(pk_set.insert(milvus::PkType(i * 1024)));
+    }
+    ASSERT_TRUE(pk_set.insert(milvus::PkType(int64_t(-1))));
+
+    pk_set.clear();
+    ASSERT_TRUE(pk_set.insert(milvus::PkType(int64_t(0))));
+    ASSERT_FALSE(pk_set.insert(milvus::PkType(int64_t(0))));
+    ASSERT_TRUE(pk_set.insert(milvus::PkType(int64_t(1024))));
+}
+
+TEST(PkDedupSet, VarChar) {
+    // the set keeps views, the keys must outlive it
+    std::vector<milvus::PkType> pks;
+    for (int i = 0; i < 100; ++i) {
+        pks.emplace_back(std::string("pk") + std::to_string(i));
+    }
+    PkDedupSet pk_set;
+    for (auto& pk : pks) {
+        ASSERT_TRUE(pk_set.insert(pk));
+    }
+    for (auto& pk : pks) {
+        ASSERT_FALSE(pk_set.insert(pk));
+    }
+
+    pk_set.clear();
+    ASSERT_TRUE(pk_set.insert(pks[0]));
+    ASSERT_FALSE(pk_set.insert(milvus::PkType(std::string("pk0"))));
+}
@@ -10,8 +10,10 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <numeric>
 
 #include "query/ExprImpl.h"
+#include "query/Plan.h"
 #include "segcore/ScalarIndex.h"
 #include "test_utils/DataGen.h"
 
@@ -378,3 +380,226 @@ TEST(Retrieve, Delete) {
         ASSERT_EQ(field2_data.data_size(), DIM * size);
     }
 }
+
+TEST(Retrieve, LimitOrderByPk) {
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    auto DIM = 16;
+    auto fid_vec = schema->AddDebugField("vector_64", DataType::VECTOR_FLOAT, DIM, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    int64_t N = 100;
+    auto dataset = DataGen(schema, N);
+    auto i64_col = dataset.get_col<int64_t>(fid_64);
+    std::vector<int64_t> sorted_pks(i64_col.begin(), i64_col.end());
+    std::sort(sorted_pks.begin(), sorted_pks.end());
+
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *sealed);
+    auto growing = CreateGrowingSegment(schema);
+    auto offset = growing->PreInsert(N);
+    growing->Insert(offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+
+    for (auto segment : {static_cast<SegmentInternalInterface*>(sealed.get()),
+                         static_cast<SegmentInternalInterface*>(growing.get())}) {
+        auto plan = std::make_unique<query::RetrievePlan>(*schema);
+        plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+        plan->plan_node_->predicate_ = std::make_unique<query::TermExprImpl<int64_t>>(fid_64, DataType::INT64, i64_col);
+        plan->field_ids_ = {fid_64};
+
+        // every match when there is no limit
+        auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        ASSERT_EQ(results->offset_size(), N);
+
+        // offset + limit rows of the smallest pks, in pk order
+        plan->plan_node_->limit_ = 5;
+        plan->plan_node_->offset_ = 3;
+        plan->plan_node_->order_by_pk_ = true;
+        results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        auto pks = results->fields_data(0).scalars().long_data();
+        ASSERT_EQ(pks.data_size(), 8);
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_EQ(pks.data(i), sorted_pks[i]);
+        }
+
+        // offset + limit rows in segment order
+        plan->plan_node_->order_by_pk_ = false;
+        results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        ASSERT_EQ(results->offset_size(), 8);
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_EQ(results->offset(i), i);
+        }
+    }
+}
+
+TEST(Retrieve, PkLookup) {
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    auto fid_vec = schema->AddDebugField("vector_64", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    int64_t N = 100;
+    auto dataset = DataGen(schema, N);
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *sealed);
+    auto growing = CreateGrowingSegment(schema);
+    auto offset = growing->PreInsert(N);
+    growing->Insert(offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+
+    for (auto segment : {static_cast<SegmentInternalInterface*>(sealed.get()),
+                         static_cast<SegmentInternalInterface*>(growing.get())}) {
+        auto plan = std::make_unique<query::RetrievePlan>(*schema);
+        plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+        // a repeated pk and one not in the segment
+        std::vector<int64_t> pks{70, 4, 4, 12, N + 7, 31};
+        plan->plan_node_->predicate_ = std::make_unique<query::TermExprImpl<int64_t>>(fid_64, DataType::INT64, pks);
+        plan->field_ids_ = {fid_64};
+
+        // each row once, in segment order, inserted by the timestamp
+        auto results = segment->Retrieve(plan.get(), 50);
+        ASSERT_EQ(std::vector<int64_t>(results->offset().begin(), results->offset().end()),
+                  std::vector<int64_t>({4, 12, 31}));
+
+        std::vector<int64_t> deleted{12};
+        auto ids = std::make_unique<IdArray>();
+        ids->mutable_int_id()->mutable_data()->Add(deleted.begin(), deleted.end());
+        std::vector<Timestamp> delete_timestamps{N + 1};
+        auto reserved_offset = segment->PreDelete(1);
+        segment->Delete(reserved_offset, 1, ids.get(), delete_timestamps.data());
+
+        results = segment->Retrieve(plan.get(), N);
+        ASSERT_EQ(std::vector<int64_t>(results->offset().begin(), results->offset().end()),
+                  std::vector<int64_t>({4, 12, 31, 70}));
+        results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        ASSERT_EQ(std::vector<int64_t>(results->offset().begin(), results->offset().end()),
+                  std::vector<int64_t>({4, 31, 70}));
+
+        plan->plan_node_->limit_ = 2;
+        results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        ASSERT_EQ(std::vector<int64_t>(results->offset().begin(), results->offset().end()),
+                  std::vector<int64_t>({4, 31}));
+    }
+}
+
+TEST(Retrieve, Aggregate) {
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    auto fid_32 = schema->AddDebugField("i32", DataType::INT32);
+    auto fid_double = schema->AddDebugField("double", DataType::DOUBLE);
+    auto DIM = 16;
+    auto fid_vec = schema->AddDebugField("vector_64", DataType::VECTOR_FLOAT, DIM, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    int64_t N = 10000;
+    auto dataset = DataGen(schema, N);
+    auto i64_col = dataset.get_col<int64_t>(fid_64);
+    auto i32_col = dataset.get_col<int32_t>(fid_32);
+    auto double_col = dataset.get_col<double>(fid_double);
+
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *sealed);
+    auto growing = CreateGrowingSegment(schema);
+    auto offset = growing->PreInsert(N);
+    growing->Insert(offset, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+
+    using query::AggregateOp;
+    // with every row matching whole zones fold in from zone maps
+    for (int64_t matched : {N, int64_t(37)}) {
+        std::vector<int64_t> terms(i64_col.begin(), i64_col.begin() + matched);
+        int64_t i32_sum = std::accumulate(i32_col.begin(), i32_col.begin() + matched, int64_t(0));
+        auto [i32_min, i32_max] = std::minmax_element(i32_col.begin(), i32_col.begin() + matched);
+        double double_sum = std::accumulate(double_col.begin(), double_col.begin() + matched, 0.0);
+        auto [double_min, double_max] = std::minmax_element(double_col.begin(), double_col.begin() + matched);
+
+        for (auto segment : {static_cast<SegmentInternalInterface*>(sealed.get()),
+                             static_cast<SegmentInternalInterface*>(growing.get())}) {
+            auto plan = std::make_unique<query::RetrievePlan>(*schema);
+            plan->plan_node_ = std::make_unique<query::RetrievePlanNode>();
+            plan->plan_node_->predicate_ = std::make_unique<query::TermExprImpl<int64_t>>(fid_64, DataType::INT64, terms);
+            plan->plan_node_->aggregates_ = {{AggregateOp::Count, fid_64},
+                                             {AggregateOp::Sum, fid_32},
+                                             {AggregateOp::Min, fid_32},
+                                             {AggregateOp::Max, fid_32},
+                                             {AggregateOp::Sum, fid_double},
+                                             {AggregateOp::Min, fid_double},
+                                             {AggregateOp::Max, fid_double}};
+            plan->field_ids_ = {fid_64};
+
+            auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+            ASSERT_EQ(results->offset_size(), 0);
+            ASSERT_EQ(results->fields_data_size(), 0);
+            ASSERT_EQ(results->aggregates_size(), 7);
+            ASSERT_EQ(results->aggregates(0).long_value(), matched);
+            ASSERT_EQ(results->aggregates(1).long_value(), i32_sum);
+            ASSERT_EQ(results->aggregates(2).long_value(), *i32_min);
+            ASSERT_EQ(results->aggregates(3).long_value(), *i32_max);
+            ASSERT_NEAR(results->aggregates(4).double_value(), double_sum, 1e-6 * std::abs(double_sum) + 1e-6);
+            ASSERT_EQ(results->aggregates(5).double_value(), *double_min);
+            ASSERT_EQ(results->aggregates(6).double_value(), *double_max);
+        }
+    }
+}
+
+TEST(Retrieve, PreparedPlan) {
+    namespace planpb = milvus::proto::plan;
+    auto schema = std::make_shared<Schema>();
+    auto fid_64 = schema->AddDebugField("i64", DataType::INT64);
+    auto fid_32 = schema->AddDebugField("i32", DataType::INT32);
+    auto DIM = 16;
+    schema->AddDebugField("vector_64", DataType::VECTOR_FLOAT, DIM, knowhere::metric::L2);
+    schema->set_primary_field_id(fid_64);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto i64_col = dataset.get_col<int64_t>(fid_64);
+    auto i32_col = dataset.get_col<int32_t>(fid_32);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    // i64 in (?0, ?1) or i32 < ?2
+    planpb::PlanNode plan_pb;
+    auto binary = plan_pb.mutable_predicates()->mutable_binary_expr();
+    binary->set_op(planpb::BinaryExpr::LogicalOr);
+    auto term = binary->mutable_left()->mutable_term_expr();
+    term->mutable_column_info()->set_field_id(fid_64.get());
+    term->mutable_column_info()->set_data_type(proto::schema::DataType::Int64);
+    term->add_values()->set_param_index(0);
+    term->add_values()->set_param_index(1);
+    auto range = binary->mutable_right()->mutable_unary_range_expr();
+    range->mutable_column_info()->set_field_id(fid_32.get());
+    range->mutable_column_info()->set_data_type(proto::schema::DataType::Int32);
+    range->set_op(planpb::LessThan);
+    range->mutable_value()->set_param_index(2);
+    plan_pb.add_output_field_ids(fid_64.get());
+    auto serialized_plan = plan_pb.SerializeAsString();
+
+    auto plan = query::CreateRetrievePlanByExpr(*schema, serialized_plan.data(), serialized_plan.size());
+    ASSERT_EQ(plan->plan_node_->param_slots_.size(), 2);
+    ASSERT_ANY_THROW(segment->Retrieve(plan.get(), MAX_TIMESTAMP));
+
+    for (int64_t i = 0; i < 3; ++i) {
+        auto a = i64_col[i];
+        auto b = i64_col[i + 10];
+        auto c = *std::min_element(i32_col.begin(), i32_col.end()) + int32_t(i * 1000);
+        planpb::PlanParams params;
+        params.add_values()->set_int64_val(a);
+        params.add_values()->set_int64_val(b);
+        params.add_values()->set_int64_val(c);
+        auto serialized_params = params.SerializeAsString();
+        query::BindRetrievePlanParams(plan.get(), serialized_params.data(), serialized_params.size());
+
+        int64_t expected = 0;
+        for (int64_t row = 0; row < N; ++row) {
+            expected += i64_col[row] == a || i64_col[row] == b || i32_col[row] < c;
+        }
+        auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        ASSERT_EQ(results->offset_size(), expected);
+    }
+
+    // a parameter index the bound values do not cover
+    planpb::PlanParams params;
+    params.add_values()->set_int64_val(0);
+    auto serialized_params = params.SerializeAsString();
+    ASSERT_ANY_THROW(
+        query::BindRetrievePlanParams(plan.get(), serialized_params.data(), serialized_params.size()));
+}
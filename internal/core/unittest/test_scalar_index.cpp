@@ -10,8 +10,15 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
 
+#include "index/BitmapIndex.h"
 #include "index/IndexFactory.h"
+#include "index/ParallelSort.h"
 #include "common/CDataType.h"
 #include "test_utils/indexbuilder_test_utils.h"
 #include "test_utils/AssertUtils.h"
@@ -164,3 +171,241 @@ using ScalarT = ::testing::Types<int8_t, int16_t, int32_t, int64_t, float, doubl
 REGISTER_TYPED_TEST_CASE_P(TypedScalarIndexTest, Dummy, Constructor, Count, In, NotIn, Range, Codec, Reverse);
 
 INSTANTIATE_TYPED_TEST_CASE_P(ArithmeticCheck, TypedScalarIndexTest, ScalarT);
+
+TEST(ScalarIndexSort, InMergedProbes) {
+    // runs of equal values, probed with unsorted, duplicated and absent values
+    std::vector<int64_t> data(10000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i * 7919) % 1000;
+    }
+    auto index = milvus::index::CreateScalarIndexSort<int64_t>();
+    index->Build(data.size(), data.data());
+
+    auto check = [&](const std::vector<int64_t>& values) {
+        std::set<int64_t> expected(values.begin(), values.end());
+        auto in = index->In(values.size(), values.data());
+        auto not_in = index->NotIn(values.size(), values.data());
+        auto compressed = index->InCompressed(values.size(), values.data());
+        ASSERT_EQ(in->size(), data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            auto matched = expected.count(data[i]) > 0;
+            ASSERT_EQ(in->test(i), matched);
+            ASSERT_EQ(not_in->test(i), !matched);
+            ASSERT_EQ(compressed.test(i), matched);
+        }
+    };
+    check({});
+    check({-1, 5000});
+    check({999, 3, 3, 0, -7, 500, 3});
+    std::vector<int64_t> most;
+    for (int64_t v = 1000; v >= 100; --v) {
+        most.push_back(v);
+        most.push_back(v);
+    }
+    check(most);
+
+    auto range = index->Range(10, true, 989, false);
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(range->test(i), data[i] >= 10 && data[i] < 989);
+    }
+}
+
+TEST(ScalarIndexSort, ParallelBuild) {
+    // sorted by value then row, as a stable sort of the rows would
+    auto check_sort = [](auto values) {
+        using T = typename decltype(values)::value_type;
+        std::vector<milvus::index::IndexStructure<T>> entries;
+        for (size_t i = 0; i < values.size(); ++i) {
+            entries.emplace_back(values[i], i);
+        }
+        auto expected = entries;
+        std::stable_sort(expected.begin(), expected.end());
+        milvus::index::ParallelRadixSort(entries);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            ASSERT_EQ(entries[i].a_, expected[i].a_);
+            ASSERT_EQ(entries[i].idx_, expected[i].idx_);
+        }
+    };
+    std::default_random_engine er(42);
+    const size_t n = milvus::index::PARALLEL_SORT_MIN_SIZE * 3 + 17;
+    std::vector<int8_t> int8s(n);
+    std::vector<int64_t> int64s(n);
+    std::vector<double> doubles(n);
+    for (size_t i = 0; i < n; ++i) {
+        int8s[i] = int8_t(er());
+        auto magnitude = int64_t(er()) << (i % 32);
+        int64s[i] = i % 2 ? magnitude : -magnitude;
+        doubles[i] = std::normal_distribution<double>(0, 1000)(er);
+    }
+    doubles[0] = -0.0;
+    doubles[1] = std::numeric_limits<double>::infinity();
+    doubles[2] = -std::numeric_limits<double>::infinity();
+    check_sort(int8s);
+    check_sort(int64s);
+    check_sort(doubles);
+
+    auto index = milvus::index::CreateScalarIndexSort<int64_t>();
+    index->Build(int64s.size(), int64s.data());
+    for (size_t i = 0; i < n; i += 997) {
+        ASSERT_EQ(index->Reverse_Lookup(i), int64s[i]);
+    }
+    auto range = index->Range(-1000, true, 1 << 20, false);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(range->test(i), int64s[i] >= -1000 && int64s[i] < (1 << 20));
+    }
+}
+
+TEST(ScalarIndexSort, LoadInPlace) {
+    std::vector<int64_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i * 37) % 101;
+    }
+    auto index = milvus::index::CreateScalarIndexSort<int64_t>();
+    index->Build(data.size(), data.data());
+    auto binary_set = index->Serialize({});
+    auto binary = binary_set.GetByName(milvus::index::SORT_INDEX_DATA);
+    ASSERT_NE(binary, nullptr);
+
+    // queries read the serialized buffer itself
+    auto loaded = milvus::index::CreateScalarIndexSort<int64_t>();
+    loaded->Load(binary_set);
+    auto entries = reinterpret_cast<const uint8_t*>(loaded->GetData().data);
+    ASSERT_GE(entries, binary->data.get());
+    ASSERT_LT(entries, binary->data.get() + binary->size);
+
+    auto path = std::filesystem::temp_directory_path() / "sort_index_test" / "index_0";
+    milvus::Config config;
+    config[milvus::index::MMAP_FILE_PATH] = path.string();
+    auto mapped = milvus::index::CreateScalarIndexSort<int64_t>();
+    mapped->Load(binary_set, config);
+    ASSERT_FALSE(std::filesystem::exists(path));
+
+    std::vector<int64_t> values{5, 3, 200, 5};
+    auto expected = index->In(values.size(), values.data());
+    for (auto& other : {loaded.get(), mapped.get()}) {
+        ASSERT_EQ(other->Count(), data.size());
+        ASSERT_EQ(*other->In(values.size(), values.data()), *expected);
+        for (size_t i = 0; i < data.size(); ++i) {
+            ASSERT_EQ(other->Reverse_Lookup(i), data[i]);
+        }
+    }
+
+    // the layout before the in-place one loads by copy
+    auto size = data.size();
+    auto entries_size = size * sizeof(milvus::index::IndexStructure<int64_t>);
+    std::shared_ptr<uint8_t[]> index_data(new uint8_t[entries_size]);
+    memcpy(index_data.get(), index->GetData().data, entries_size);
+    std::shared_ptr<uint8_t[]> index_length(new uint8_t[sizeof(size_t)]);
+    memcpy(index_length.get(), &size, sizeof(size_t));
+    milvus::BinarySet legacy_set;
+    legacy_set.Append("index_data", index_data, entries_size);
+    legacy_set.Append("index_length", index_length, sizeof(size_t));
+    auto legacy = milvus::index::CreateScalarIndexSort<int64_t>();
+    legacy->Load(legacy_set);
+    ASSERT_EQ(*legacy->In(values.size(), values.data()), *expected);
+
+    binary->data[0] ^= 1;
+    auto corrupted = milvus::index::CreateScalarIndexSort<int64_t>();
+    ASSERT_ANY_THROW(corrupted->Load(binary_set));
+}
+
+TEST(BitmapIndex, Int64) {
+    std::vector<int64_t> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i * 13) % 200 - 50;
+    }
+    ASSERT_TRUE(milvus::index::FitsBitmapIndex(data.size(), data.data()));
+    auto built = milvus::index::CreateBitmapIndex<int64_t>();
+    built->Build(data.size(), data.data());
+    auto binary_set = built->Serialize({});
+    auto index = milvus::index::CreateBitmapIndex<int64_t>();
+    index->Load(binary_set);
+    ASSERT_EQ(index->Count(), data.size());
+
+    // a few values, and most of them as the complement of the rest
+    std::vector<int64_t> few{3, 3, -50, 999, 10};
+    std::vector<int64_t> most;
+    for (int64_t v = -50; v < 140; ++v) {
+        most.push_back(v);
+    }
+    for (auto& values : {few, most}) {
+        std::set<int64_t> expected(values.begin(), values.end());
+        auto in = index->In(values.size(), values.data());
+        auto not_in = index->NotIn(values.size(), values.data());
+        auto compressed = index->InCompressed(values.size(), values.data());
+        for (size_t i = 0; i < data.size(); ++i) {
+            auto matched = expected.count(data[i]) > 0;
+            ASSERT_EQ(in->test(i), matched);
+            ASSERT_EQ(not_in->test(i), !matched);
+            ASSERT_EQ(compressed.test(i), matched);
+        }
+    }
+
+    auto range = index->Range(-10, true, 60, false);
+    auto greater = index->Range(-10, milvus::OpType::GreaterThan);
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(range->test(i), data[i] >= -10 && data[i] < 60);
+        ASSERT_EQ(greater->test(i), data[i] > -10);
+        ASSERT_EQ(index->Reverse_Lookup(i), data[i]);
+    }
+
+    std::vector<int64_t> distinct(1000);
+    std::iota(distinct.begin(), distinct.end(), 0);
+    ASSERT_FALSE(milvus::index::FitsBitmapIndex(distinct.size(), distinct.data()));
+}
+
+TEST(BitmapIndex, String) {
+    std::vector<std::string> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = "tier-" + std::to_string(i % 12);
+    }
+    milvus::index::CreateIndexInfo index_info;
+    index_info.field_type = milvus::DataType::VARCHAR;
+    index_info.index_type = milvus::index::BITMAP_INDEX_TYPE;
+    auto built = milvus::index::IndexFactory::GetInstance().CreateScalarIndex(index_info);
+    auto index = dynamic_cast<milvus::index::ScalarIndex<std::string>*>(built.get());
+    ASSERT_NE(index, nullptr);
+    index->Build(data.size(), data.data());
+    auto binary_set = index->Serialize({});
+    ASSERT_TRUE(binary_set.Contains(milvus::index::BITMAP_INDEX_META));
+
+    auto loaded = milvus::index::CreateBitmapIndex<std::string>();
+    loaded->Load(binary_set);
+    std::vector<std::string> values{"tier-1", "tier-11", "absent"};
+    auto in = loaded->In(values.size(), values.data());
+    auto ds = std::make_shared<knowhere::DataSet>();
+    ds->Set<milvus::OpType>(milvus::index::OPERATOR_TYPE, milvus::OpType::PrefixMatch);
+    ds->Set<std::string>(milvus::index::PREFIX_VALUE, "tier-1");
+    auto prefix = loaded->Query(ds);
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(in->test(i), data[i] == "tier-1" || data[i] == "tier-11");
+        ASSERT_EQ(prefix->test(i), data[i].rfind("tier-1", 0) == 0);
+        ASSERT_EQ(loaded->Reverse_Lookup(i), data[i]);
+    }
+}
+
+TEST(ScalarIndex, BulkReverseLookup) {
+    std::vector<int64_t> data(3000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i * 31) % 97;
+    }
+    auto sort_index = milvus::index::CreateScalarIndexSort<int64_t>();
+    sort_index->Build(data.size(), data.data());
+    auto bitmap_index = milvus::index::CreateBitmapIndex<int64_t>();
+    bitmap_index->Build(data.size(), data.data());
+
+    std::vector<int64_t> offsets{2999, 0, 17, 17, 1500};
+    std::vector<milvus::index::ScalarIndex<int64_t>*> indexes{sort_index.get(), bitmap_index.get()};
+    for (auto index : indexes) {
+        std::vector<int64_t> range(data.size() - 100);
+        index->ReverseLookupRange(100, data.size(), range.data());
+        for (size_t i = 0; i < range.size(); ++i) {
+            ASSERT_EQ(range[i], data[i + 100]);
+        }
+        std::vector<int64_t> batch(offsets.size());
+        index->ReverseLookupBatch(offsets.data(), offsets.size(), batch.data());
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            ASSERT_EQ(batch[i], data[offsets[i]]);
+        }
+    }
+}
@@ -10,11 +10,30 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <numeric>
+#include <thread>
 #include <boost/format.hpp>
-
+#include <google/protobuf/text_format.h>
+#include <arrow/api.h>
+#include <arrow/io/memory.h>
+#include <parquet/arrow/writer.h>
+
+#include "query/PlanProto.h"
+#include "query/QueryScheduler.h"
+#include "query/SearchOnSealed.h"
+#include "segcore/Reduce.h"
+#include "segcore/SearchBatcher.h"
+#include "segcore/SegcoreConfig.h"
+#include "segcore/SegmentGrowingImpl.h"
 #include "segcore/SegmentSealedImpl.h"
+#include "simd/hook.h"
+#include "storage/InsertData.h"
+#include "storage/LocalChunkManager.h"
 #include "test_utils/DataGen.h"
 #include "index/IndexFactory.h"
+#include "common/Common.h"
 
 using namespace milvus;
 using namespace milvus::query;
@@ -854,6 +873,48 @@ TEST(Sealed, BF_Overflow) {
     }
 }
 
+TEST(Sealed, BlockedBruteForce) {
+    auto schema = std::make_shared<Schema>();
+    int64_t dim = 16;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    int64_t N = 20000;
+    auto raw = DataGen(schema, N);
+    auto vectors = raw.get_col<float>(vec);
+    std::vector<float> norms(N);
+    simd::SquaredNorms(vectors.data(), dim, N, norms.data());
+    BitsetType bitset(N);
+    for (int64_t i = 0; i < N; i += 5) {
+        bitset.set(i);
+    }
+
+    int64_t num_queries = 5;
+    SearchInfo info{10, -1, vec, knowhere::metric::L2, {}};
+    auto& config = SegcoreConfig::default_config();
+    auto block_bytes = config.get_sealed_search_block_bytes();
+    auto search = [&](const float* row_norms) {
+        SearchResult result;
+        SearchOnSealed(
+            *schema, vectors.data(), info, vectors.data(), num_queries, N, BitsetView(bitset), result, row_norms);
+        return result;
+    };
+    for (const float* row_norms : {static_cast<const float*>(nullptr), static_cast<const float*>(norms.data())}) {
+        config.set_sealed_search_block_bytes(N * dim * sizeof(float));
+        auto whole = search(row_norms);
+        // ranges of 1024 rows, the smallest block
+        config.set_sealed_search_block_bytes(1);
+        auto blocked = search(row_norms);
+        ASSERT_EQ(blocked.seg_offsets_, whole.seg_offsets_);
+        ASSERT_EQ(blocked.distances_, whole.distances_);
+        // every query finds itself unless it is filtered out
+        for (int64_t q = 1; q < num_queries; ++q) {
+            ASSERT_EQ(blocked.seg_offsets_[q * 10], q);
+        }
+    }
+    config.set_sealed_search_block_bytes(block_bytes);
+}
+
 TEST(Sealed, DeleteCount) {
     auto schema = std::make_shared<Schema>();
     auto pk = schema->AddDebugField("pk", DataType::INT64);
@@ -874,6 +935,125 @@ TEST(Sealed, DeleteCount) {
     ASSERT_EQ(cnt, c);
 }
 
+TEST(Sealed, LoadDeletedRecordDropsAbsentPks) {
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    // pks [0, N) are in the segment, the others certainly not, but for
+    // the odd false positive of the bloom filter
+    int64_t row_count = 2 * N;
+    std::vector<idx_t> pks(row_count);
+    std::iota(pks.begin(), pks.end(), N / 2);
+    auto ids = std::make_unique<IdArray>();
+    ids->mutable_int_id()->mutable_data()->Add(pks.begin(), pks.end());
+    std::vector<Timestamp> timestamps(row_count, N + 1);
+    LoadDeletedRecordInfo info = {timestamps.data(), ids.get(), row_count};
+    segment->LoadDeletedRecord(info);
+
+    auto deleted = segment->get_deleted_count();
+    ASSERT_GE(deleted, N / 2);
+    ASSERT_LT(deleted, N / 2 + N / 20);
+    BitsetType bitset(N, false);
+    segment->mask_with_delete(bitset, N, N + 1);
+    ASSERT_EQ(bitset.count(), N / 2);
+    ASSERT_FALSE(bitset[N / 2 - 1]);
+    ASSERT_TRUE(bitset[N / 2]);
+}
+
+TEST(Sealed, CompactDeletes) {
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    // pks [0, 100) deleted over and over, more deletes than a chunk of the log holds
+    int64_t c = 40000;
+    std::vector<int64_t> pks(c);
+    for (int64_t i = 0; i < c; ++i) {
+        pks[i] = i % 100;
+    }
+    auto ids = GenPKs(pks);
+    auto tss = GenTss(c, N);
+    ASSERT_TRUE(segment->Delete(segment->PreDelete(c), c, ids.get(), tss.data()).ok());
+    auto before = segment->GetMemoryUsage().Components().at("deleted_record.pks");
+
+    segment->CompactDeletes(N + c);
+    auto after = segment->GetMemoryUsage().Components().at("deleted_record.pks");
+    ASSERT_LT(after, before);
+    ASSERT_EQ(segment->get_deleted_count(), c);
+    BitsetType bitset(N, false);
+    segment->mask_with_delete(bitset, N, MAX_TIMESTAMP);
+    ASSERT_EQ(bitset.count(), 100);
+
+    // the deletes after the compaction apply on top of it
+    auto more_ids = GenPKs(10, 100);
+    auto more_tss = GenTss(10, N + c);
+    ASSERT_TRUE(segment->Delete(segment->PreDelete(10), 10, more_ids.get(), more_tss.data()).ok());
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, MAX_TIMESTAMP);
+    ASSERT_EQ(bitset.count(), 110);
+    // a query at an earlier timestamp sees the compacted deletes
+    bitset.reset();
+    segment->mask_with_delete(bitset, N, N + 5);
+    ASSERT_EQ(bitset.count(), 100);
+}
+
+TEST(Sealed, MaskSkipped) {
+    auto schema = std::make_shared<Schema>();
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    // rows over more than one page of deletes
+    int64_t N = DeletedRecord::Snapshot::bits_per_page + 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+
+    std::vector<int64_t> pks;
+    for (int64_t i = 0; i < N; i += 7) {
+        pks.push_back(i);
+    }
+    auto ids = GenPKs(pks);
+    auto tss = GenTss(pks.size(), N);
+    ASSERT_TRUE(segment->Delete(segment->PreDelete(pks.size()), pks.size(), ids.get(), tss.data()).ok());
+
+    BitsetType matches(N);
+    for (int64_t i = 0; i < N; i += 2) {
+        matches[i] = true;
+    }
+    // the same rows as masking them one source after another
+    for (auto timestamp : {Timestamp(N / 2), Timestamp(N + pks.size()), MAX_TIMESTAMP}) {
+        auto expected = matches;
+        expected.flip();
+        segment->mask_with_timestamps(expected, timestamp);
+        segment->mask_with_delete(expected, N, timestamp);
+        auto skipped = matches;
+        ASSERT_FALSE(segment->mask_skipped(skipped, N, timestamp));
+        ASSERT_EQ(skipped, expected);
+    }
+
+    BitsetType none(N);
+    ASSERT_TRUE(segment->mask_skipped(none, N, MAX_TIMESTAMP));
+    ASSERT_TRUE(none.all());
+    // matching deleted rows only, before and after the deletes
+    BitsetType deleted(N);
+    for (auto i : pks) {
+        deleted[i] = true;
+    }
+    auto before_deletes = deleted;
+    ASSERT_TRUE(segment->mask_skipped(deleted, N, MAX_TIMESTAMP));
+    ASSERT_FALSE(segment->mask_skipped(before_deletes, N, N - 1));
+}
+
 TEST(Sealed, RealCount) {
     auto schema = std::make_shared<Schema>();
     auto pk = schema->AddDebugField("pk", DataType::INT64);
@@ -915,3 +1095,2334 @@ TEST(Sealed, RealCount) {
     ASSERT_TRUE(status.ok());
     ASSERT_EQ(0, segment->get_real_count());
 }
+
+TEST(Sealed, LoadFieldDataConcurrently) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto str = schema->AddDebugField("str", DataType::VARCHAR);
+    auto value = schema->AddDebugField("value", DataType::DOUBLE);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {vec.get(), pk.get(), str.get(), value.get()});
+
+    std::vector<std::thread> loaders;
+    for (auto& field_data : dataset.raw_->fields_data()) {
+        loaders.emplace_back([&segment, &field_data, N] {
+            LoadFieldDataInfo info;
+            info.field_id = field_data.field_id();
+            info.row_count = N;
+            info.field_data = &field_data;
+            segment->LoadFieldData(info);
+        });
+    }
+    for (auto& loader : loaders) {
+        loader.join();
+    }
+    for (auto field_id : {vec, pk, str, value}) {
+        ASSERT_TRUE(segment->HasFieldData(field_id));
+    }
+    ASSERT_EQ(segment->get_row_count(), N);
+
+    // the pk index got published with its field
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto half = N / 2;
+    auto del_ids = GenPKs(pks.begin(), pks.begin() + half);
+    auto del_tss = GenTss(half, N);
+    auto status = segment->Delete(segment->PreDelete(half), half, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(segment->get_real_count(), N - half);
+}
+
+TEST(Sealed, LoadFieldBinlogs) {
+    auto schema = std::make_shared<Schema>();
+    int dim = 16;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto value = schema->AddDebugField("value", DataType::DOUBLE);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {vec.get(), pk.get(), value.get()});
+
+    auto& chunk_manager = storage::LocalChunkManager::GetInstance();
+    std::string dir = "/tmp/sealed-load-binlogs";
+    chunk_manager.CreateDir(dir);
+    // writes the rows of a field as two binlogs
+    auto write_binlogs = [&](FieldId field_id, const void* data, int64_t row_bytes, DataType data_type) {
+        LoadFieldBinlogInfo info{field_id.get(), {}, N};
+        for (int64_t begin : {int64_t(0), N / 3}) {
+            auto end = begin == 0 ? N / 3 : N;
+            storage::Payload payload{data_type, static_cast<const uint8_t*>(data) + begin * row_bytes,
+                                     int(end - begin)};
+            if (datatype_is_vector(data_type)) {
+                payload.dimension = dim;
+            }
+            storage::InsertData insert_data(std::make_shared<storage::FieldData>(payload));
+            insert_data.SetFieldDataMeta({100, 101, segment->get_segment_id(), field_id.get()});
+            insert_data.SetTimestamps(0, 100);
+            auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+            auto path = dir + "/" + std::to_string(field_id.get()) + "_" + std::to_string(begin);
+            chunk_manager.Write(path, bytes.data(), bytes.size());
+            info.binlog_paths.push_back(path);
+        }
+        return info;
+    };
+
+    auto vectors = dataset.get_col<float>(vec);
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto values = dataset.get_col<double>(value);
+    segment->LoadFieldBinlogs(write_binlogs(vec, vectors.data(), dim * sizeof(float), DataType::VECTOR_FLOAT),
+                              chunk_manager);
+    segment->LoadFieldBinlogs(write_binlogs(pk, pks.data(), sizeof(int64_t), DataType::INT64), chunk_manager);
+    // a binlog of another type is refused
+    auto wrong = write_binlogs(value, pks.data(), sizeof(int64_t), DataType::INT64);
+    ASSERT_ANY_THROW(segment->LoadFieldBinlogs(wrong, chunk_manager));
+    ASSERT_FALSE(segment->HasFieldData(value));
+    segment->LoadFieldBinlogs(write_binlogs(value, values.data(), sizeof(double), DataType::DOUBLE), chunk_manager);
+    chunk_manager.RemoveDir(dir);
+
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    auto value_span = segment->chunk_data<double>(value, 0);
+    ASSERT_TRUE(std::equal(values.begin(), values.end(), value_span.data()));
+    ASSERT_EQ(segment->get_row_count(), N);
+
+    // the pk index got built from the mapped binlogs
+    auto del_ids = GenPKs(pks.begin(), pks.begin() + 10);
+    auto del_tss = GenTss(10, N);
+    auto status = segment->Delete(segment->PreDelete(10), 10, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(segment->get_real_count(), N - 10);
+}
+
+TEST(Sealed, LoadLazyFieldBinlogs) {
+    auto schema = std::make_shared<Schema>();
+    int dim = 16;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto text = schema->AddDebugField("text", DataType::VARCHAR);
+    auto score = schema->AddDebugField("score", DataType::DOUBLE);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto plain = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *plain);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {text.get(), score.get()});
+
+    auto& local = storage::LocalChunkManager::GetInstance();
+    std::shared_ptr<storage::ChunkManager> chunk_manager(&local, [](auto*) {});
+    std::string dir = "/tmp/sealed-lazy-binlogs";
+    local.CreateDir(dir);
+    // the rows of a field as three binlogs
+    auto write_binlogs = [&](FieldId field_id, auto make) {
+        LoadFieldBinlogInfo info{field_id.get(), {}, N};
+        for (int begin = 0; begin < N; begin += 400) {
+            auto end = std::min<int>(begin + 400, N);
+            storage::InsertData insert_data(make(begin, end));
+            insert_data.SetFieldDataMeta({100, 101, segment->get_segment_id(), field_id.get()});
+            insert_data.SetTimestamps(0, 100);
+            auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+            auto path = dir + "/" + std::to_string(field_id.get()) + "_" + std::to_string(begin);
+            local.Write(path, bytes.data(), bytes.size());
+            info.binlog_paths.push_back(path);
+        }
+        return info;
+    };
+    auto texts = dataset.get_col<std::string>(text);
+    auto scores = dataset.get_col<double>(score);
+    auto text_info = write_binlogs(text, [&](int begin, int end) {
+        arrow::StringBuilder builder;
+        for (int i = begin; i < end; ++i) {
+            EXPECT_TRUE(builder.Append(texts[i]).ok());
+        }
+        std::shared_ptr<arrow::Array> array;
+        EXPECT_TRUE(builder.Finish(&array).ok());
+        return std::make_shared<storage::FieldData>(array, DataType::VARCHAR);
+    });
+    auto score_info = write_binlogs(score, [&](int begin, int end) {
+        storage::Payload payload{
+            DataType::DOUBLE, reinterpret_cast<const uint8_t*>(scores.data() + begin), end - begin};
+        return std::make_shared<storage::FieldData>(payload);
+    });
+    // a row group at a time fits the cache
+    auto& config = SegcoreConfig::default_config();
+    auto cache_bytes = config.get_lazy_field_cache_bytes();
+    config.set_lazy_field_cache_bytes(1);
+    segment->LoadLazyFieldBinlogs(text_info, chunk_manager);
+    segment->LoadLazyFieldBinlogs(score_info, chunk_manager);
+    config.set_lazy_field_cache_bytes(cache_bytes);
+    ASSERT_FALSE(segment->HasFieldData(text));
+    ASSERT_EQ(segment->get_row_count(), N);
+    // the row count has to match the binlogs
+    auto wrong = score_info;
+    wrong.field_id = text.get();
+    wrong.row_count = N + 1;
+    ASSERT_ANY_THROW(segment->LoadLazyFieldBinlogs(wrong, chunk_manager));
+
+    // the rows of both ends of the pk range are read from the binlogs
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  unary_range_expr: <
+    column_info: <
+      field_id: %1%
+      data_type: Int64
+    >
+    op: GreaterEqual
+    value: <
+      int64_val: %2%
+    >
+  >
+>
+output_field_ids: %3%
+output_field_ids: %4%
+)") % pk.get() % pks[N / 2] % text.get() % score.get());
+    proto::plan::PlanNode node_proto;
+    google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+    auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+    auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+    auto expected = plain->Retrieve(plan.get(), MAX_TIMESTAMP);
+    ASSERT_GT(results->offset_size(), 0);
+    ASSERT_EQ(results->SerializeAsString(), expected->SerializeAsString());
+    auto usage = segment->GetMemoryUsage();
+    ASSERT_GT(usage.Components().at("sealed.lazy_fields"), 0);
+
+    segment->DropFieldData(text);
+    ASSERT_ANY_THROW(segment->Retrieve(plan.get(), MAX_TIMESTAMP));
+    local.RemoveDir(dir);
+}
+
+TEST(Sealed, FieldAccessStats) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto age = schema->AddDebugField("age", DataType::INT32);
+    auto score = schema->AddDebugField("score", DataType::DOUBLE);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto& stats = dynamic_cast<SegmentInternalInterface*>(segment.get())->field_access_stats();
+    ASSERT_TRUE(stats.ToJson().empty());
+
+    auto ages = dataset.get_col<int32_t>(age);
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto retrieve = [&](const std::string& predicate) {
+        auto proto_text = "predicates: < " + predicate + " > output_field_ids: " + std::to_string(score.get());
+        proto::plan::PlanNode node_proto;
+        google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+        auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+        return segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+    };
+    auto results = retrieve("unary_range_expr: < column_info: < field_id: " + std::to_string(age.get()) +
+                            " data_type: Int32 > op: GreaterEqual value: < int64_val: " +
+                            std::to_string(ages[N / 2]) + " > >");
+    ASSERT_GT(results->offset_size(), 0);
+    ASSERT_EQ(stats.Get(age, FieldAccess::FilterEvals), 1);
+    ASSERT_EQ(stats.Get(age, FieldAccess::IndexHits), 0);
+    ASSERT_EQ(stats.Get(score, FieldAccess::SubscriptCalls), 1);
+    ASSERT_EQ(stats.Get(score, FieldAccess::SubscriptRows), results->offset_size());
+    ASSERT_EQ(stats.Get(vec, FieldAccess::SubscriptCalls), 0);
+
+    // a term on the pk is answered by the pk index
+    results = retrieve("term_expr: < column_info: < field_id: " + std::to_string(pk.get()) +
+                       " data_type: Int64 > values: < int64_val: " + std::to_string(pks[0]) + " > >");
+    ASSERT_EQ(results->offset_size(), 1);
+    ASSERT_EQ(stats.Get(pk, FieldAccess::FilterEvals), 1);
+    ASSERT_EQ(stats.Get(pk, FieldAccess::IndexHits), 1);
+    ASSERT_EQ(stats.Get(score, FieldAccess::SubscriptCalls), 2);
+
+    auto json = stats.ToJson();
+    ASSERT_EQ(json[std::to_string(age.get())]["filter_evals"], 1);
+    ASSERT_FALSE(json.contains(std::to_string(vec.get())));
+}
+
+TEST(Sealed, RetrieveOnArena) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::VARCHAR);
+    auto score = schema->AddDebugField("score", DataType::DOUBLE);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto internal = dynamic_cast<SegmentInternalInterface*>(segment.get());
+
+    auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  unary_range_expr: <
+    column_info: <
+      field_id: %1%
+      data_type: Double
+    >
+    op: GreaterThan
+    value: <
+      float_val: 0
+    >
+  >
+>
+output_field_ids: %2%
+output_field_ids: %3%
+output_field_ids: %4%
+)") % score.get() % pk.get() % score.get() % TimestampFieldID.get());
+    proto::plan::PlanNode node_proto;
+    google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+    auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+    auto expected = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+    ASSERT_GT(expected->offset_size(), 0);
+
+    std::unique_ptr<google::protobuf::Arena> arena;
+    auto results = internal->RetrieveOnArena(plan.get(), MAX_TIMESTAMP, &arena);
+    ASSERT_NE(arena, nullptr);
+    ASSERT_EQ(results->GetArena(), arena.get());
+    // the system columns are built on it
+    ASSERT_EQ(results->fields_data(2).GetArena(), arena.get());
+    ASSERT_EQ(results->ids().str_id().data_size(), expected->offset_size());
+    ASSERT_EQ(results->SerializeAsString(), expected->SerializeAsString());
+}
+
+TEST(Sealed, DedupQueries) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto fake_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 5,
+                        "round_decimal": 3
+                    }
+                }
+            }
+            ]
+        }
+    })";
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto plan = CreatePlan(*schema, dsl);
+
+    // queries q0 q1 q0 q2 q1
+    auto vec_col = dataset.get_col<float>(fake_id);
+    std::vector<float> queries;
+    for (auto row : {0, 1, 0, 2, 1}) {
+        queries.insert(queries.end(), vec_col.begin() + row * dim, vec_col.begin() + (row + 1) * dim);
+    }
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(5, dim, queries.data());
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto& ph = ph_group->at(0);
+    ASSERT_EQ(ph.num_of_unique_queries_, 3);
+    ASSERT_EQ(ph.unique_of_, std::vector<int64_t>({0, 1, 0, 2, 1}));
+
+    auto sr = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(sr->total_nq_, 5);
+    auto topk = sr->unity_topK_;
+    ASSERT_EQ(sr->seg_offsets_.size(), 5 * topk);
+    ASSERT_EQ(sr->distances_.size(), 5 * topk);
+    for (auto [query, first] : {std::pair{2, 0}, std::pair{4, 1}}) {
+        for (int64_t k = 0; k < topk; ++k) {
+            ASSERT_EQ(sr->seg_offsets_[query * topk + k], sr->seg_offsets_[first * topk + k]);
+            ASSERT_EQ(sr->distances_[query * topk + k], sr->distances_[first * topk + k]);
+        }
+    }
+    // each query finds its own row first
+    ASSERT_EQ(sr->seg_offsets_[3 * topk], 2);
+
+    // a batch of distinct queries is searched as is
+    auto distinct_raw = CreatePlaceholderGroupFromBlob(3, dim, vec_col.data());
+    auto distinct = ParsePlaceholderGroup(plan.get(), distinct_raw.SerializeAsString());
+    ASSERT_TRUE(distinct->at(0).unique_of_.empty());
+}
+
+TEST(Sealed, LoadParquet) {
+    auto schema = std::make_shared<Schema>();
+    int dim = 16;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto str = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto vectors = dataset.get_col<float>(vec);
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto strs = dataset.get_col<std::string>(str);
+
+    auto& chunk_manager = storage::LocalChunkManager::GetInstance();
+    std::string dir = "/tmp/sealed-load-parquet";
+    chunk_manager.CreateDir(dir);
+    // the rows as two files, the vectors as lists of floats
+    Timestamp timestamp = 5000;
+    LoadParquetInfo info{{}, 100, timestamp};
+    for (int64_t begin : {int64_t(0), N / 3}) {
+        auto end = begin == 0 ? N / 3 : N;
+        arrow::Int64Builder pk_builder;
+        arrow::StringBuilder str_builder;
+        auto value_builder = std::make_shared<arrow::FloatBuilder>();
+        arrow::ListBuilder vec_builder(arrow::default_memory_pool(), value_builder);
+        for (auto i = begin; i < end; ++i) {
+            ASSERT_TRUE(pk_builder.Append(pks[i]).ok());
+            ASSERT_TRUE(str_builder.Append(strs[i]).ok());
+            ASSERT_TRUE(vec_builder.Append().ok());
+            ASSERT_TRUE(value_builder->AppendValues(vectors.data() + i * dim, dim).ok());
+        }
+        std::shared_ptr<arrow::Array> pk_array, str_array, vec_array;
+        ASSERT_TRUE(pk_builder.Finish(&pk_array).ok());
+        ASSERT_TRUE(str_builder.Finish(&str_array).ok());
+        ASSERT_TRUE(vec_builder.Finish(&vec_array).ok());
+        // columns are found by name, not by position
+        auto table = arrow::Table::Make(arrow::schema({arrow::field("str", arrow::utf8()),
+                                                       arrow::field("pk", arrow::int64()),
+                                                       arrow::field("fakevec", arrow::list(arrow::float32()))}),
+                                        {str_array, pk_array, vec_array});
+        auto output = arrow::io::BufferOutputStream::Create().ValueOrDie();
+        ASSERT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), output, 256).ok());
+        auto buffer = output->Finish().ValueOrDie();
+        auto path = dir + "/" + std::to_string(begin) + ".parquet";
+        chunk_manager.Write(path, const_cast<uint8_t*>(buffer->data()), buffer->size());
+        info.files.push_back(path);
+    }
+
+    auto segment = CreateSealedSegment(schema);
+    segment->LoadParquet(info, chunk_manager);
+    ASSERT_ANY_THROW(segment->LoadParquet(info, chunk_manager));
+    chunk_manager.RemoveDir(dir);
+
+    ASSERT_EQ(segment->get_row_count(), N);
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    auto pk_span = segment->chunk_data<int64_t>(pk, 0);
+    ASSERT_TRUE(std::equal(pks.begin(), pks.end(), pk_span.data()));
+    auto str_span = segment->chunk_data<std::string_view>(str, 0);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(strs[i], str_span[i]);
+    }
+    // the rows are visible from the import timestamp on
+    BitsetType before(N, false);
+    segment->mask_with_timestamps(before, timestamp - 1);
+    ASSERT_EQ(before.count(), N);
+    BitsetType after(N, false);
+    segment->mask_with_timestamps(after, timestamp);
+    ASSERT_EQ(after.count(), 0);
+    // the pk index got built
+    auto del_ids = GenPKs(pks.begin(), pks.begin() + 10);
+    auto del_tss = GenTss(10, timestamp + 1);
+    auto status = segment->Delete(segment->PreDelete(10), 10, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(segment->get_real_count(), N - 10);
+}
+
+TEST(Sealed, LoadFromGrowing) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::VARCHAR);
+    auto age = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(pk);
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(256);
+    auto growing = CreateGrowingSegment(schema, -1, seg_conf);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    growing->PreInsert(N);
+    growing->Insert(0, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+    auto pks = dataset.get_col<std::string>(pk);
+    IdArray ids;
+    for (int64_t i = 0; i < 10; ++i) {
+        ids.mutable_str_id()->add_data(pks[i]);
+    }
+    auto del_tss = GenTss(10, N);
+    ASSERT_TRUE(growing->Delete(growing->PreDelete(10), 10, &ids, del_tss.data()).ok());
+
+    auto segment = CreateSealedSegment(schema);
+    segment->LoadFromGrowing(*growing);
+    // the rows inserted after the handoff stay behind
+    auto more = DataGen(schema, 10, 43, N);
+    growing->PreInsert(10);
+    growing->Insert(N, 10, more.row_ids_.data(), more.timestamps_.data(), more.raw_);
+    growing.reset();
+
+    ASSERT_EQ(segment->get_row_count(), N);
+    ASSERT_EQ(segment->get_deleted_count(), 10);
+    ASSERT_EQ(segment->get_real_count(), N - 10);
+    auto vectors = dataset.get_col<float>(vec);
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    auto ages = dataset.get_col<int32_t>(age);
+    auto age_span = segment->chunk_data<int32_t>(age, 0);
+    ASSERT_TRUE(std::equal(ages.begin(), ages.end(), age_span.data()));
+    auto pk_span = segment->chunk_data<std::string_view>(pk, 0);
+    ASSERT_TRUE(std::equal(pks.begin(), pks.end(), pk_span.data()));
+
+    // the sealed pk index finds the rows
+    IdArray found_ids;
+    found_ids.mutable_str_id()->add_data(pks[N - 1]);
+    auto [found, offsets] = segment->search_ids(found_ids, MAX_TIMESTAMP);
+    ASSERT_EQ(offsets.size(), 1);
+    ASSERT_EQ(offsets[0].get(), N - 1);
+
+    // only into an empty segment
+    auto other = CreateGrowingSegment(schema);
+    other->PreInsert(N);
+    other->Insert(0, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+    ASSERT_ANY_THROW(segment->LoadFromGrowing(*other));
+}
+
+TEST(Sealed, ClusteredLoadFromGrowing) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::VARCHAR);
+    auto age = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(pk);
+    schema->set_clustering_key_field_id(age);
+    ASSERT_ANY_THROW(schema->set_clustering_key_field_id(vec));
+    auto seg_conf = SegcoreConfig::default_config();
+    seg_conf.set_chunk_rows(256);
+    auto growing = CreateGrowingSegment(schema, -1, seg_conf);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    growing->PreInsert(N);
+    growing->Insert(0, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+    auto segment = CreateSealedSegment(schema);
+    segment->LoadFromGrowing(*growing);
+    growing.reset();
+
+    // the rows sorted by age, each one whole
+    auto ages = dataset.get_col<int32_t>(age);
+    auto vectors = dataset.get_col<float>(vec);
+    auto pks = dataset.get_col<std::string>(pk);
+    auto age_span = segment->chunk_data<int32_t>(age, 0);
+    ASSERT_TRUE(std::is_sorted(age_span.data(), age_span.data() + N));
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    auto pk_span = segment->chunk_data<std::string_view>(pk, 0);
+    std::unordered_map<std::string, int64_t> rows;
+    for (int64_t i = 0; i < N; ++i) {
+        rows.emplace(pks[i], i);
+    }
+    for (int64_t i = 0; i < N; ++i) {
+        auto row = rows.at(std::string(pk_span.data()[i]));
+        ASSERT_EQ(age_span.data()[i], ages[row]);
+        ASSERT_TRUE(std::equal(vec_span.data() + i * 16, vec_span.data() + (i + 1) * 16, vectors.data() + row * 16));
+    }
+
+    // the pk index follows the rows
+    IdArray ids;
+    ids.mutable_str_id()->add_data(pk_span.data()[N / 2]);
+    auto [found, found_offsets] = segment->search_ids(ids, MAX_TIMESTAMP);
+    ASSERT_EQ(found_offsets.size(), 1);
+    ASSERT_EQ(found_offsets[0].get(), N / 2);
+    auto del_tss = GenTss(1, N);
+    ASSERT_TRUE(segment->Delete(segment->PreDelete(1), 1, &ids, del_tss.data()).ok());
+    ASSERT_EQ(segment->get_real_count(), N - 1);
+}
+
+TEST(Sealed, PartitionKeyPruning) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::VARCHAR);
+    auto tenant = schema->AddDebugField("tenant", DataType::INT64);
+    auto age = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(pk);
+    ASSERT_ANY_THROW(schema->set_partition_key_field_id(age));
+    schema->set_partition_key_field_id(tenant);
+
+    // 100 rows per tenant, tenants 0 to 9
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N, 42, 0, 100);
+    auto sealed = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *sealed);
+    auto growing = CreateGrowingSegment(schema);
+    growing->PreInsert(N);
+    growing->Insert(0, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+
+    auto retrieve = [&](SegmentInterface& segment, const std::string& predicate) {
+        auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  %1%
+>
+output_field_ids: %2%
+)") % predicate % tenant.get());
+        proto::plan::PlanNode node_proto;
+        google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+        auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+        auto results = segment.Retrieve(plan.get(), MAX_TIMESTAMP);
+        return std::vector<int64_t>(results->offset().begin(), results->offset().end());
+    };
+    auto column = "column_info: < field_id: " + std::to_string(tenant.get()) + " data_type: Int64 > ";
+    auto term = [&](int64_t a, int64_t b) {
+        return "term_expr: < " + column + "values: < int64_val: " + std::to_string(a) +
+               " > values: < int64_val: " + std::to_string(b) + " > >";
+    };
+    auto equal = [&](int64_t value) {
+        return "unary_range_expr: < " + column + "op: Equal value: < int64_val: " + std::to_string(value) + " > >";
+    };
+    auto rows = [](int64_t begin, int64_t end) {
+        std::vector<int64_t> offsets(end - begin);
+        std::iota(offsets.begin(), offsets.end(), begin);
+        return offsets;
+    };
+
+    for (auto segment : {static_cast<SegmentInternalInterface*>(sealed.get()),
+                         static_cast<SegmentInternalInterface*>(growing.get())}) {
+        auto keys = segment->partition_keys<int64_t>();
+        ASSERT_NE(keys, nullptr);
+        int64_t present[] = {42, 3};
+        ASSERT_TRUE(keys->Contains(present, 2));
+        ASSERT_FALSE(keys->Contains(present, 1));
+        auto usage = segment->GetMemoryUsage().Components();
+        ASSERT_EQ(usage.count("sealed.partition_keys") + usage.count("insert_record.partition_keys"), 1);
+
+        ASSERT_EQ(retrieve(*segment, term(3, 42)), rows(300, 400));
+        ASSERT_EQ(retrieve(*segment, equal(7)), rows(700, 800));
+        ASSERT_TRUE(retrieve(*segment, term(42, 43)).empty());
+        ASSERT_TRUE(retrieve(*segment, equal(42)).empty());
+        auto any = "unary_range_expr: < column_info: < field_id: " + std::to_string(age.get()) +
+                   " data_type: Int32 > op: GreaterEqual value: < int64_val: -2147483648 > >";
+        auto binary = [](const std::string& op, const std::string& left, const std::string& right) {
+            return "binary_expr: < op: " + op + " left: < " + left + " > right: < " + right + " > >";
+        };
+        ASSERT_TRUE(retrieve(*segment, binary("LogicalAnd", equal(42), any)).empty());
+        ASSERT_EQ(retrieve(*segment, binary("LogicalOr", equal(42), equal(5))), rows(500, 600));
+    }
+
+    // without the key field loaded nothing is pruned
+    sealed->DropFieldData(tenant);
+    ASSERT_EQ(dynamic_cast<SegmentInternalInterface*>(sealed.get())->partition_keys<int64_t>(), nullptr);
+}
+
+TEST(Sealed, LoadFieldDataMmapLazyPopulate) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto str = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+
+    SetLazyMmapPopulate(true);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {}, true);
+    SetLazyMmapPopulate(DEFAULT_LAZY_MMAP_POPULATE);
+
+    // the pages not read ahead yet fault in on access
+    auto vectors = dataset.get_col<float>(vec);
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto pk_span = segment->chunk_data<int64_t>(pk, 0);
+    ASSERT_TRUE(std::equal(pks.begin(), pks.end(), pk_span.data()));
+    auto strs = dataset.get_col<std::string>(str);
+    auto str_span = segment->chunk_data<std::string_view>(str, 0);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(strs[i], str_span[i]);
+    }
+}
+
+TEST(Sealed, LoadCachedFieldData) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto str = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    int64_t segment_id = 39;
+    auto dataset = DataGen(schema, N);
+    std::string mmap_dir = "./data/mmap-test";
+    auto& config = SegcoreConfig::default_config();
+    auto capacity = config.get_column_cache_bytes();
+    config.set_column_cache_bytes(64 * 1024 * 1024);
+    auto cache_dir = std::filesystem::path(mmap_dir) / "column-cache";
+    std::filesystem::remove_all(cache_dir);
+
+    auto load_cached = [&](SegmentSealed& segment, FieldId field_id) {
+        return segment.LoadCachedFieldData({field_id.get(), nullptr, N, mmap_dir.c_str()});
+    };
+    {
+        auto segment = CreateSealedSegment(schema, segment_id);
+        ASSERT_FALSE(load_cached(*segment, vec));
+        SealedLoadFieldData(dataset, *segment, {}, true);
+    }
+
+    // a reload maps the fixed width columns the first load cached
+    auto segment = CreateSealedSegment(schema, segment_id);
+    SealedLoadFieldData(dataset, *segment, {vec.get(), pk.get(), str.get()});
+    ASSERT_TRUE(load_cached(*segment, vec));
+    ASSERT_TRUE(load_cached(*segment, pk));
+    ASSERT_FALSE(load_cached(*segment, str));
+    auto other = CreateSealedSegment(schema, segment_id + 1);
+    ASSERT_FALSE(load_cached(*other, vec));
+    config.set_column_cache_bytes(capacity);
+
+    auto vectors = dataset.get_col<float>(vec);
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto pk_span = segment->chunk_data<int64_t>(pk, 0);
+    ASSERT_TRUE(std::equal(pks.begin(), pks.end(), pk_span.data()));
+    // the pk index is rebuilt from the cached column
+    auto del_ids = GenPKs(pks.begin(), pks.begin() + 10);
+    auto del_tss = GenTss(10, N);
+    auto status = segment->Delete(segment->PreDelete(10), 10, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(segment->get_real_count(), N - 10);
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST(Sealed, PrefetchFieldBinlogs) {
+    auto schema = std::make_shared<Schema>();
+    int dim = 16;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    int64_t segment_id = 41;
+    auto dataset = DataGen(schema, N);
+    std::string mmap_dir = "./data/mmap-test";
+    auto& config = SegcoreConfig::default_config();
+    auto capacity = config.get_column_cache_bytes();
+    config.set_column_cache_bytes(64 * 1024 * 1024);
+    auto cache_dir = std::filesystem::path(mmap_dir) / "column-cache";
+    std::filesystem::remove_all(cache_dir);
+
+    auto& chunk_manager = storage::LocalChunkManager::GetInstance();
+    std::string dir = "/tmp/sealed-prefetch-binlogs";
+    chunk_manager.CreateDir(dir);
+    auto vectors = dataset.get_col<float>(vec);
+    storage::Payload payload{DataType::VECTOR_FLOAT, reinterpret_cast<const uint8_t*>(vectors.data()), int(N), dim};
+    storage::InsertData insert_data(std::make_shared<storage::FieldData>(payload));
+    insert_data.SetFieldDataMeta({100, 101, segment_id, vec.get()});
+    insert_data.SetTimestamps(0, 100);
+    auto bytes = insert_data.Serialize(storage::StorageType::Remote);
+    auto path = dir + "/" + std::to_string(vec.get());
+    chunk_manager.Write(path, bytes.data(), bytes.size());
+    LoadFieldBinlogInfo info{vec.get(), {path}, N};
+    auto& field_meta = schema->operator[](vec);
+    ASSERT_TRUE(SegmentSealedImpl::PrefetchFieldBinlogs(segment_id, field_meta, info, mmap_dir.c_str(), chunk_manager));
+    // the second one finds it cached
+    chunk_manager.RemoveDir(dir);
+    ASSERT_TRUE(SegmentSealedImpl::PrefetchFieldBinlogs(segment_id, field_meta, info, mmap_dir.c_str(), chunk_manager));
+
+    // the load maps the prefetched column
+    auto segment = CreateSealedSegment(schema, segment_id);
+    SealedLoadFieldData(dataset, *segment, {vec.get()});
+    ASSERT_TRUE(segment->LoadCachedFieldData({vec.get(), nullptr, N, mmap_dir.c_str()}));
+    config.set_column_cache_bytes(capacity);
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST(Sealed, SharedColumns) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    int64_t segment_id = 43;
+    auto dataset = DataGen(schema, N);
+    std::string shared_dir = "./data/shared-columns";
+    std::filesystem::remove_all(shared_dir);
+    auto& config = SegcoreConfig::default_config();
+    config.set_shared_column_dir(shared_dir, 64 * 1024 * 1024);
+
+    auto load_shared = [&](SegmentSealed& segment, FieldId field_id) {
+        return segment.LoadCachedFieldData({field_id.get(), nullptr, N, nullptr});
+    };
+    // the first process to load the segment shares its columns
+    auto segment = CreateSealedSegment(schema, segment_id);
+    ASSERT_FALSE(load_shared(*segment, vec));
+    SealedLoadFieldData(dataset, *segment);
+    ASSERT_TRUE(std::filesystem::exists(std::filesystem::path(shared_dir) / std::to_string(segment_id)));
+
+    // the others map them
+    auto replica = CreateSealedSegment(schema, segment_id);
+    SealedLoadFieldData(dataset, *replica, {vec.get(), pk.get()});
+    ASSERT_TRUE(load_shared(*replica, vec));
+    ASSERT_TRUE(load_shared(*replica, pk));
+    auto vectors = dataset.get_col<float>(vec);
+    auto vec_span = replica->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto pk_span = replica->chunk_data<int64_t>(pk, 0);
+    ASSERT_TRUE(std::equal(pks.begin(), pks.end(), pk_span.data()));
+    ASSERT_EQ(replica->get_real_count(), N);
+
+    config.set_shared_column_dir("", 0);
+    auto unshared = CreateSealedSegment(schema, segment_id);
+    ASSERT_FALSE(load_shared(*unshared, vec));
+    std::filesystem::remove_all(shared_dir);
+}
+
+TEST(Sealed, SegmentImage) {
+    auto schema = std::make_shared<Schema>();
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto str = schema->AddDebugField("str", DataType::VARCHAR);
+    auto i8 = schema->AddDebugField("i8", DataType::INT8);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    int64_t segment_id = 45;
+    auto dataset = DataGen(schema, N);
+    std::string image_dir = "./data/segment-image";
+    std::filesystem::remove_all(image_dir);
+    {
+        auto segment = CreateSealedSegment(schema, segment_id);
+        ASSERT_ANY_THROW(segment->SaveImage(image_dir));
+        SealedLoadFieldData(dataset, *segment);
+        segment->SaveImage(image_dir);
+    }
+
+    // after a restart the segment is restored from its image
+    auto segment = CreateSealedSegment(schema, segment_id);
+    ASSERT_TRUE(segment->LoadImage(image_dir));
+    ASSERT_EQ(segment->get_row_count(), N);
+    auto vectors = dataset.get_col<float>(vec);
+    auto vec_span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+    auto pks = dataset.get_col<int64_t>(pk);
+    auto pk_span = segment->chunk_data<int64_t>(pk, 0);
+    ASSERT_TRUE(std::equal(pks.begin(), pks.end(), pk_span.data()));
+    auto strs = dataset.get_col<std::string>(str);
+    auto str_span = segment->chunk_data<std::string_view>(str, 0);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(strs[i], str_span[i]);
+    }
+    auto i8s = dataset.get_col<int8_t>(i8);
+    auto i8_span = segment->chunk_data<int8_t>(i8, 0);
+    ASSERT_TRUE(std::equal(i8s.begin(), i8s.end(), i8_span.data()));
+    // the timestamp and pk indexes are rebuilt
+    BitsetType inserted_later(N, false);
+    segment->mask_with_timestamps(inserted_later, dataset.timestamps_[N / 2]);
+    ASSERT_EQ(inserted_later.count(), N - N / 2 - 1);
+    auto del_ids = GenPKs(pks.begin(), pks.begin() + 10);
+    auto del_tss = GenTss(10, N);
+    auto status = segment->Delete(segment->PreDelete(10), 10, del_ids.get(), del_tss.data());
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(segment->get_real_count(), N - 10);
+
+    ASSERT_ANY_THROW(segment->LoadImage(image_dir));
+    auto other = CreateSealedSegment(schema, segment_id + 1);
+    ASSERT_FALSE(other->LoadImage(image_dir));
+    std::filesystem::remove_all(image_dir);
+}
+
+TEST(Sealed, Compact) {
+    auto schema = std::make_shared<Schema>();
+    int dim = 16;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    auto str = schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(pk);
+    int64_t N = 1000;
+    // both hold the pks [0, N), the first keeps the odd ones, the second the even ones
+    auto dataset0 = DataGen(schema, N, 42);
+    auto dataset1 = DataGen(schema, N, 43);
+    std::vector<const GeneratedData*> datasets{&dataset0, &dataset1};
+    std::vector<std::unique_ptr<SegmentSealed>> segments;
+    std::vector<const SegmentSealedImpl*> inputs;
+    for (int s = 0; s < 2; ++s) {
+        segments.push_back(CreateSealedSegment(schema, 100 + s));
+        SealedLoadFieldData(*datasets[s], *segments[s]);
+        std::vector<int64_t> deleted;
+        for (int64_t i = 1 - s; i < N; i += 2) {
+            deleted.push_back(i);
+        }
+        auto del_ids = GenPKs(deleted);
+        auto del_tss = GenTss(deleted.size(), N);
+        auto status = segments[s]->Delete(segments[s]->PreDelete(deleted.size()), deleted.size(), del_ids.get(),
+                                          del_tss.data());
+        ASSERT_TRUE(status.ok());
+        inputs.push_back(dynamic_cast<const SegmentSealedImpl*>(segments[s].get()));
+    }
+
+    auto& chunk_manager = storage::LocalChunkManager::GetInstance();
+    std::string dir = "/tmp/sealed-compact";
+    chunk_manager.CreateDir(dir);
+    auto result = SegmentSealedImpl::Compact(inputs, MAX_TIMESTAMP, {100, 101, 200, 0}, dir, chunk_manager);
+    ASSERT_EQ(result.row_count, N);
+    ASSERT_EQ(std::get<int64_t>(result.min_pk), 0);
+    ASSERT_EQ(std::get<int64_t>(result.max_pk), N - 1);
+    ASSERT_EQ(result.min_timestamp, 0);
+    ASSERT_EQ(result.max_timestamp, N - 1);
+    // the system fields and the user ones
+    ASSERT_EQ(result.binlog_paths.size(), 5);
+
+    std::vector<std::vector<uint8_t>> files;
+    auto read = [&](FieldId field_id) {
+        auto path = result.binlog_paths.at(field_id.get());
+        auto& bytes = files.emplace_back(chunk_manager.Size(path));
+        chunk_manager.Read(path, bytes.data(), bytes.size());
+        return storage::DeserializeFileData(bytes.data(), bytes.size())->GetFieldData();
+    };
+    auto pk_payload = read(pk)->get_payload();
+    ASSERT_EQ(pk_payload->rows, N);
+    auto pks = reinterpret_cast<const int64_t*>(pk_payload->raw_data);
+    auto vec_payload = read(vec)->get_payload();
+    auto vectors = reinterpret_cast<const float*>(vec_payload->raw_data);
+    auto str_data = read(str);
+    std::vector<std::vector<float>> source_vectors{dataset0.get_col<float>(vec), dataset1.get_col<float>(vec)};
+    std::vector<std::vector<std::string>> source_strs{dataset0.get_col<std::string>(str),
+                                                      dataset1.get_col<std::string>(str)};
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(pks[i], i);
+        auto s = i % 2 == 1 ? 0 : 1;
+        ASSERT_TRUE(std::equal(vectors + i * dim, vectors + (i + 1) * dim, source_vectors[s].data() + i * dim));
+        char* value;
+        int size;
+        str_data->get_one_string_payload(i, &value, &size);
+        ASSERT_EQ(std::string(value, size), source_strs[s][i]);
+    }
+
+    // before the deletes both copies of the rows inserted by then are kept
+    auto before = SegmentSealedImpl::Compact(inputs, N / 2, {100, 101, 201, 0}, dir, chunk_manager);
+    ASSERT_EQ(before.row_count, 2 * (N / 2 + 1));
+    ASSERT_EQ(std::get<int64_t>(before.max_pk), N / 2);
+    ASSERT_EQ(before.max_timestamp, N / 2);
+    chunk_manager.RemoveDir(dir);
+}
+
+TEST(Sealed, EncodedColumn) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto age_id = schema->AddDebugField("age", DataType::INT32);
+    schema->set_primary_field_id(counter_id);
+    int64_t N = 3000;
+    auto dataset = DataGen(schema, N);
+    auto counter_col = dataset.get_col<int64_t>(counter_id);
+    auto age_col = dataset.get_col<int32_t>(age_id);
+
+    auto plain = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *plain);
+    auto& config = SegcoreConfig::default_config();
+    config.set_sealed_column_encoding(true);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    config.set_sealed_column_encoding(false);
+    auto interface = dynamic_cast<SegmentInternalInterface*>(segment.get());
+
+    // the sorted pks and the small ages pack into a few bits a row
+    auto counter_encoded = interface->chunk_encoded<int64_t>(counter_id, 0);
+    ASSERT_NE(counter_encoded, nullptr);
+    ASSERT_EQ(counter_encoded->encoding(), ColumnEncoding::BlockFrameOfReference);
+    ASSERT_EQ(counter_encoded->bits(), 10);
+    auto age_encoded = interface->chunk_encoded<int32_t>(age_id, 0);
+    ASSERT_NE(age_encoded, nullptr);
+    ASSERT_LE(age_encoded->bits(), 13);
+    ASSERT_LT(segment->GetMemoryUsageInBytes(), plain->GetMemoryUsageInBytes());
+
+    auto age_span = interface->chunk_data<int32_t>(age_id, 0);
+    ASSERT_TRUE(std::equal(age_col.begin(), age_col.end(), age_span.data()));
+
+    auto value = age_col[N / 2];
+    auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  unary_range_expr: <
+    column_info: <
+      field_id: %1%
+      data_type: Int32
+    >
+    op: GreaterEqual
+    value: <
+      int64_val: %2%
+    >
+  >
+>
+output_field_ids: %1%
+output_field_ids: %3%
+)") % age_id.get() % value % counter_id.get());
+    proto::plan::PlanNode node_proto;
+    google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+    auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+    auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+    auto expected = plain->Retrieve(plan.get(), MAX_TIMESTAMP);
+    ASSERT_GT(results->offset_size(), 0);
+    ASSERT_EQ(results->SerializeAsString(), expected->SerializeAsString());
+    for (auto offset : results->offset()) {
+        ASSERT_GE(age_col[offset], value);
+    }
+
+    // the pk index is built before the column is encoded
+    auto pks = GenPKs(counter_col.begin(), counter_col.begin() + 2);
+    auto [ids, offsets] = interface->search_ids(*pks, MAX_TIMESTAMP);
+    ASSERT_EQ(offsets.size(), 2);
+}
+
+TEST(Sealed, EncodedStringColumn) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto status_id = schema->AddDebugField("status", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+    int64_t N = 3000;
+    auto dataset = DataGen(schema, N);
+    for (auto& field_data : *dataset.raw_->mutable_fields_data()) {
+        if (field_data.field_id() == status_id.get()) {
+            auto strings = field_data.mutable_scalars()->mutable_string_data()->mutable_data();
+            for (int64_t i = 0; i < N; ++i) {
+                *strings->Mutable(i) = "status-" + std::to_string(i * 7 % 20);
+            }
+        }
+    }
+    auto status_col = dataset.get_col<std::string>(status_id);
+
+    auto plain = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *plain);
+    auto& config = SegcoreConfig::default_config();
+    config.set_sealed_column_encoding(true);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    config.set_sealed_column_encoding(false);
+    auto interface = dynamic_cast<SegmentInternalInterface*>(segment.get());
+
+    auto encoded = interface->chunk_encoded<std::string_view>(status_id, 0);
+    ASSERT_NE(encoded, nullptr);
+    ASSERT_EQ(encoded->dictionary_size(), 20);
+    auto status_span = interface->chunk_data<std::string_view>(status_id, 0);
+    for (int64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(status_span[i], status_col[i]);
+    }
+
+    // the predicates resolved on the dictionary match the plain rows
+    auto retrieve = [&](const std::string& predicate) {
+        auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  %1%
+>
+output_field_ids: %2%
+output_field_ids: %3%
+)") % predicate % status_id.get() % counter_id.get());
+        proto::plan::PlanNode node_proto;
+        google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+        auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+        auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        auto expected = plain->Retrieve(plan.get(), MAX_TIMESTAMP);
+        ASSERT_EQ(results->SerializeAsString(), expected->SerializeAsString()) << predicate;
+    };
+    auto column = "column_info: < field_id: " + std::to_string(status_id.get()) + " data_type: VarChar > ";
+    auto unary = [&](const std::string& op, const std::string& value) {
+        retrieve("unary_range_expr: < " + column + "op: " + op + " value: < string_val: \"" + value + "\" > >");
+    };
+    unary("Equal", "status-3");
+    unary("NotEqual", "status-3");
+    unary("GreaterEqual", "status-15");
+    unary("PrefixMatch", "status-1");
+    unary("Equal", "missing");
+    retrieve("binary_range_expr: < " + column +
+             R"(lower_inclusive: true lower_value: < string_val: "status-11" > upper_value: < string_val: "status-4" > >)");
+    retrieve("term_expr: < " + column + R"(values: < string_val: "status-2" > values: < string_val: "status-9" > >)");
+}
+
+TEST(Sealed, RowGroupChunks) {
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto age_id = schema->AddDebugField("age", DataType::INT32);
+    auto score_id = schema->AddDebugField("score", DataType::DOUBLE);
+    schema->set_primary_field_id(counter_id);
+    int64_t N = 3000;
+    auto dataset = DataGen(schema, N);
+    auto age_col = dataset.get_col<int32_t>(age_id);
+    auto score_col = dataset.get_col<double>(score_id);
+
+    // the score field by its index only, which covers every row group
+    auto load = [&](SegmentSealed& segment) {
+        SealedLoadFieldData(dataset, segment, {score_id.get()});
+        LoadIndexInfo score_index;
+        score_index.field_id = score_id.get();
+        score_index.field_type = DataType::DOUBLE;
+        score_index.index_params["index_type"] = "sort";
+        score_index.index = GenScalarIndexing<double>(N, score_col.data());
+        segment.LoadIndex(score_index);
+    };
+    auto plain = CreateSealedSegment(schema);
+    load(*plain);
+    auto& config = SegcoreConfig::default_config();
+    config.set_sealed_chunk_rows(512);
+    auto segment = CreateSealedSegment(schema);
+    config.set_sealed_chunk_rows(0);
+    load(*segment);
+    auto interface = dynamic_cast<SegmentInternalInterface*>(segment.get());
+    ASSERT_EQ(interface->num_chunk(), 6);
+    ASSERT_EQ(interface->size_per_chunk(), 512);
+    ASSERT_EQ(interface->num_chunk_data(age_id), 6);
+    ASSERT_EQ(interface->num_chunk_index(score_id), 6);
+
+    // the last row group holds the rest, each with its own zones
+    auto last = interface->chunk_data<int32_t>(age_id, 5);
+    ASSERT_EQ(last.row_count(), N - 5 * 512);
+    ASSERT_TRUE(std::equal(age_col.begin() + 5 * 512, age_col.end(), last.data()));
+    auto zone_map = interface->chunk_zone_map<int32_t>(age_id, 1);
+    ASSERT_NE(zone_map, nullptr);
+    ASSERT_EQ(zone_map->zones.size(), 1);
+    auto [min, max] = std::minmax_element(age_col.begin() + 512, age_col.begin() + 1024);
+    ASSERT_EQ(zone_map->zones[0].min, *min);
+    ASSERT_EQ(zone_map->zones[0].max, *max);
+
+    auto age = age_col[N / 2];
+    auto score = score_col[N / 2];
+    std::vector<std::string> predicates = {
+        // raw rows and zone maps
+        boost::str(boost::format(R"(unary_range_expr: <
+  column_info: < field_id: %1% data_type: Int32 >
+  op: GreaterEqual
+  value: < int64_val: %2% >
+>)") % age_id.get() % age),
+        // the index
+        boost::str(boost::format(R"(unary_range_expr: <
+  column_info: < field_id: %1% data_type: Double >
+  op: LessThan
+  value: < float_val: %2% >
+>)") % score_id.get() % score),
+        // raw rows against the index, a row group at a time
+        boost::str(boost::format(R"(compare_expr: <
+  left_column_info: < field_id: %1% data_type: Int32 >
+  right_column_info: < field_id: %2% data_type: Double >
+  op: GreaterThan
+>)") % age_id.get() % score_id.get()),
+    };
+    for (auto& predicate : predicates) {
+        auto proto_text = "predicates: < " + predicate + " >\noutput_field_ids: " + std::to_string(counter_id.get());
+        proto::plan::PlanNode node_proto;
+        ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto));
+        auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+        auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+        auto expected = plain->Retrieve(plan.get(), MAX_TIMESTAMP);
+        ASSERT_GT(results->offset_size(), 0);
+        ASSERT_EQ(results->SerializeAsString(), expected->SerializeAsString());
+    }
+}
+
+TEST(Sealed, HalfVectorStorage) {
+    auto schema = std::make_shared<Schema>();
+    int64_t dim = 60;
+    auto vec = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto pk = schema->AddDebugField("pk", DataType::INT64);
+    schema->set_primary_field_id(pk);
+    int64_t N = 3000;
+    auto dataset = DataGen(schema, N);
+    auto vectors = dataset.get_col<float>(vec);
+    auto plain = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *plain);
+
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 10,
+                        "round_decimal": -1
+                    }
+                }
+            }
+            ]
+        }
+    })";
+    auto plan = CreatePlan(*schema, dsl);
+    plan->target_entries_.push_back(vec);
+    // the first rows are the queries, each finds itself first
+    int64_t num_queries = 5;
+    int64_t topk = 10;
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, dim, vectors.data());
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto expected = plain->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+
+    auto& config = SegcoreConfig::default_config();
+    for (auto [storage, precision] : {std::pair<std::string, float>{"FLOAT16", 1e-3}, {"BFLOAT16", 1e-2}}) {
+        config.set_sealed_vector_storage(storage);
+        auto segment = CreateSealedSegment(schema);
+        SealedLoadFieldData(dataset, *segment);
+        config.set_sealed_vector_storage("FLOAT");
+        ASSERT_LT(segment->GetMemoryUsageInBytes(), plain->GetMemoryUsageInBytes()) << storage;
+
+        auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+        int64_t hits = 0;
+        for (int64_t q = 0; q < num_queries; ++q) {
+            ASSERT_EQ(result->seg_offsets_[q * topk], q) << storage;
+            auto begin = expected->seg_offsets_.begin() + q * topk;
+            for (int64_t k = 0; k < topk; ++k) {
+                hits += std::count(begin, begin + topk, result->seg_offsets_[q * topk + k]);
+            }
+        }
+        ASSERT_GE(hits, num_queries * topk * 9 / 10) << storage;
+
+        // retrieval widens the halves back
+        segment->FillTargetEntry(plan.get(), *result);
+        auto& output = result->output_fields_data_.at(vec)->vectors().float_vector().data();
+        ASSERT_EQ(output.size(), num_queries * topk * dim);
+        for (int64_t i = 0; i < num_queries * topk; ++i) {
+            auto row = vectors.data() + result->seg_offsets_[i] * dim;
+            for (int64_t d = 0; d < dim; ++d) {
+                ASSERT_NEAR(output[i * dim + d], row[d], std::max(std::abs(row[d]) * precision, 1e-4f)) << storage;
+            }
+        }
+        auto span = segment->chunk_data<FloatVector>(vec, 0);
+        for (int64_t i = 0; i < N * dim; ++i) {
+            ASSERT_NEAR(span.data()[i], vectors[i], std::max(std::abs(vectors[i]) * precision, 1e-4f)) << storage;
+        }
+    }
+    ASSERT_ANY_THROW(config.set_sealed_vector_storage("INT8"));
+
+    // compressed vectors are lossless, searched and retrieved exactly
+    config.set_sealed_vector_storage("COMPRESSED");
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    config.set_sealed_vector_storage("FLOAT");
+    ASSERT_LT(segment->GetMemoryUsageInBytes(), plain->GetMemoryUsageInBytes());
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(result->seg_offsets_, expected->seg_offsets_);
+    ASSERT_EQ(result->distances_, expected->distances_);
+    result->seg_offsets_[1] = INVALID_SEG_OFFSET;
+    segment->FillTargetEntry(plan.get(), *result);
+    auto& output = result->output_fields_data_.at(vec)->vectors().float_vector().data();
+    for (int64_t i = 0; i < num_queries * topk; ++i) {
+        auto offset = result->seg_offsets_[i];
+        for (int64_t d = 0; d < dim; ++d) {
+            ASSERT_EQ(output[i * dim + d], offset == INVALID_SEG_OFFSET ? 0 : vectors[offset * dim + d]);
+        }
+    }
+    auto span = segment->chunk_data<FloatVector>(vec, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), span.data()));
+}
+
+TEST(Sealed, FilterCache) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    auto age_id = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto age_col = dataset.get_col<int64_t>(age_id);
+    auto interface = dynamic_cast<SegmentInternalInterface*>(segment.get());
+
+    auto make_plan = [&](int64_t value) {
+        auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  unary_range_expr: <
+    column_info: <
+      field_id: %1%
+      data_type: Int64
+    >
+    op: GreaterEqual
+    value: <
+      int64_val: %2%
+    >
+  >
+>
+output_field_ids: %1%
+)") % age_id.get() % value);
+        proto::plan::PlanNode node_proto;
+        google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+        return ProtoParser(*schema).CreateRetrievePlan(node_proto);
+    };
+    auto expected = [&](int64_t value) {
+        std::vector<int64_t> offsets;
+        for (int64_t i = 0; i < N; ++i) {
+            if (age_col[i] >= value) {
+                offsets.push_back(i);
+            }
+        }
+        return offsets;
+    };
+    auto retrieve = [&](int64_t value, Timestamp timestamp) {
+        auto plan = make_plan(value);
+        auto results = segment->Retrieve(plan.get(), timestamp);
+        return std::vector<int64_t>(results->offset().begin(), results->offset().end());
+    };
+
+    auto cache = interface->get_filter_cache(MAX_TIMESTAMP);
+    ASSERT_NE(cache, nullptr);
+    // rows inserted after the query timestamp must not be reused
+    ASSERT_EQ(interface->get_filter_cache(0), nullptr);
+
+    auto memory_usage = segment->GetMemoryUsageInBytes();
+    auto value = age_col[N / 2];
+    ASSERT_EQ(retrieve(value, MAX_TIMESTAMP), expected(value));
+    ASSERT_EQ(cache->size(), 1);
+    ASSERT_GT(cache->memory_usage(), 0);
+    ASSERT_EQ(segment->GetMemoryUsageInBytes(), memory_usage + cache->memory_usage());
+    ASSERT_EQ(retrieve(value, MAX_TIMESTAMP), expected(value));
+    ASSERT_EQ(cache->size(), 1);
+    // only the first row is visible at timestamp 0
+    ASSERT_EQ(retrieve(value, 0).size(), age_col[0] >= value ? 1 : 0);
+    ASSERT_EQ(cache->size(), 1);
+
+    // loading or dropping data invalidates every result
+    segment->DropFieldData(age_id);
+    ASSERT_EQ(cache->size(), 0);
+    ASSERT_EQ(cache->memory_usage(), 0);
+    for (auto& field_data : dataset.raw_->fields_data()) {
+        if (field_data.field_id() == age_id.get()) {
+            LoadFieldDataInfo info;
+            info.field_id = age_id.get();
+            info.row_count = N;
+            info.field_data = &field_data;
+            segment->LoadFieldData(info);
+        }
+    }
+    ASSERT_EQ(retrieve(value, MAX_TIMESTAMP), expected(value));
+    ASSERT_EQ(cache->size(), 1);
+
+    // the budget bounds the cache, evicting the least recently used
+    auto& config = SegcoreConfig::default_config();
+    auto filter_cache_bytes = config.get_filter_cache_bytes();
+    config.set_filter_cache_bytes(cache->memory_usage() * 2);
+    auto fingerprint = make_plan(value)->plan_node_->predicate_fingerprint_;
+    for (auto v : {age_col[0], age_col[1], age_col[2]}) {
+        ASSERT_EQ(retrieve(v, MAX_TIMESTAMP), expected(v));
+        ASSERT_LE(cache->size(), 2);
+    }
+    ASSERT_EQ(cache->Get(fingerprint), nullptr);
+    config.set_filter_cache_bytes(0);
+    ASSERT_EQ(interface->get_filter_cache(MAX_TIMESTAMP), nullptr);
+    config.set_filter_cache_bytes(filter_cache_bytes);
+
+    // a result computed before an invalidation is not admitted
+    FilterCache local_cache;
+    auto version = local_cache.version();
+    local_cache.Clear();
+    local_cache.Put("stale", BitsetType(N), version, 1 << 20);
+    ASSERT_EQ(local_cache.Get("stale"), nullptr);
+    local_cache.Put("fresh", BitsetType(N), local_cache.version(), 1 << 20);
+    ASSERT_NE(local_cache.Get("fresh"), nullptr);
+}
+
+TEST(Sealed, RefineOnRawVectors) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto topK = 5;
+    auto fakevec_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    auto make_dsl = [&](const std::string& params) {
+        return R"({
+            "bool": {
+                "must": [
+                {
+                    "vector": {
+                        "fakevec": {
+                            "metric_type": "L2",
+                            "params": )" +
+               params + R"(,
+                            "query": "$0",
+                            "topk": 5,
+                            "round_decimal": -1
+                        }
+                    }
+                }
+                ]
+            }
+        })";
+    };
+
+    int64_t N = 4000;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(fakevec_id);
+    milvus::index::CreateIndexInfo create_index_info;
+    create_index_info.field_type = DataType::VECTOR_FLOAT;
+    create_index_info.metric_type = knowhere::metric::L2;
+    create_index_info.index_type = knowhere::IndexEnum::INDEX_FAISS_IVFPQ;
+    auto indexing = milvus::index::IndexFactory::GetInstance().CreateIndex(create_index_info, nullptr);
+    auto build_conf = knowhere::Json{{knowhere::meta::METRIC_TYPE, knowhere::metric::L2},
+                                     {knowhere::meta::DIM, std::to_string(dim)},
+                                     {knowhere::indexparam::NLIST, "10"},
+                                     {knowhere::indexparam::M, "4"},
+                                     {knowhere::indexparam::NBITS, "8"}};
+    indexing->BuildWithDataset(knowhere::GenDataSet(N, dim, vec_col.data()), build_conf);
+
+    // the raw vectors stay loaded besides the index
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    LoadIndexInfo load_info;
+    load_info.field_id = fakevec_id.get();
+    load_info.index = std::move(indexing);
+    load_info.index_params["metric_type"] = "L2";
+    segment->LoadIndex(load_info);
+    ASSERT_TRUE(segment->HasIndex(fakevec_id));
+    ASSERT_TRUE(segment->HasFieldData(fakevec_id));
+
+    auto num_queries = 4;
+    auto exact = [&](int64_t q, int64_t offset) {
+        float distance = 0;
+        for (int64_t d = 0; d < dim; ++d) {
+            auto diff = vec_col[q * dim + d] - vec_col[offset * dim + d];
+            distance += diff * diff;
+        }
+        return distance;
+    };
+    auto search = [&](const std::string& params) {
+        auto plan = CreatePlan(*schema, make_dsl(params));
+        auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, dim, vec_col.data());
+        auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+        return segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    };
+
+    // the hits of the quantized index ranked again on the raw vectors
+    auto refined = search(R"({"nprobe": 10, "refine_factor": 8})");
+    ASSERT_EQ(refined->unity_topK_, topK);
+    ASSERT_EQ(refined->seg_offsets_.size(), num_queries * topK);
+    for (int64_t q = 0; q < num_queries; ++q) {
+        ASSERT_EQ(refined->seg_offsets_[q * topK], q);
+        ASSERT_EQ(refined->distances_[q * topK], 0);
+        for (int64_t i = q * topK; i < (q + 1) * topK; ++i) {
+            ASSERT_NE(refined->seg_offsets_[i], INVALID_SEG_OFFSET);
+            ASSERT_NEAR(refined->distances_[i], exact(q, refined->seg_offsets_[i]), 1e-4);
+            if (i > q * topK) {
+                ASSERT_LE(refined->distances_[i - 1], refined->distances_[i]);
+            }
+        }
+    }
+
+    // without the factor the index ranks alone
+    auto approximate = search(R"({"nprobe": 10})");
+    ASSERT_EQ(approximate->unity_topK_, topK);
+    ASSERT_EQ(approximate->seg_offsets_.size(), num_queries * topK);
+    ASSERT_ANY_THROW(search(R"({"nprobe": 10, "refine_factor": 0})"));
+}
+
+TEST(Sealed, SearchCache) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto fakevec_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 5,
+                        "round_decimal": 6
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    int64_t N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    auto interface = dynamic_cast<SegmentInternalInterface*>(segment.get());
+    auto vec_col = dataset.get_col<float>(fakevec_id);
+    auto counter_col = dataset.get_col<int64_t>(counter_id);
+    auto plan = CreatePlan(*schema, dsl);
+    auto num_queries = 3;
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, dim, vec_col.data());
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    // off by default
+    auto& config = SegcoreConfig::default_config();
+    auto search_cache_bytes = config.get_search_cache_bytes();
+    int64_t del_barrier = -1;
+    ASSERT_EQ(interface->get_search_cache(MAX_TIMESTAMP, del_barrier), nullptr);
+    config.set_search_cache_bytes(1 << 20);
+    auto cache = interface->get_search_cache(MAX_TIMESTAMP, del_barrier);
+    ASSERT_NE(cache, nullptr);
+    ASSERT_EQ(del_barrier, 0);
+    // rows inserted after the query timestamp must not be reused
+    ASSERT_EQ(interface->get_search_cache(0, del_barrier), nullptr);
+
+    auto memory_usage = segment->GetMemoryUsageInBytes();
+    auto first = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(cache->size(), 1);
+    ASSERT_GT(cache->memory_usage(), 0);
+    ASSERT_EQ(segment->GetMemoryUsageInBytes(), memory_usage + cache->memory_usage());
+    auto second = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(second->seg_offsets_, first->seg_offsets_);
+    ASSERT_EQ(second->distances_, first->distances_);
+    ASSERT_EQ(cache->size(), 1);
+
+    // other query vectors are another entry
+    auto other_raw = CreatePlaceholderGroupFromBlob(num_queries, dim, vec_col.data() + 10 * dim);
+    auto other_group = ParsePlaceholderGroup(plan.get(), other_raw.SerializeAsString());
+    segment->Search(plan.get(), other_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(cache->size(), 2);
+
+    // a delete invalidates every result
+    auto hit = first->seg_offsets_[0];
+    auto ids = GenPKs(std::vector<int64_t>{counter_col[hit]});
+    auto tss = GenTss(1, N);
+    ASSERT_TRUE(segment->Delete(segment->PreDelete(1), 1, ids.get(), tss.data()).ok());
+    ASSERT_EQ(cache->size(), 0);
+    auto deleted = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_NE(deleted->seg_offsets_[0], hit);
+    ASSERT_EQ(cache->size(), 1);
+    // a query before the delete sees all rows but not the delete
+    ASSERT_NE(interface->get_search_cache(N - 1, del_barrier), nullptr);
+    ASSERT_EQ(del_barrier, 0);
+    auto before = segment->Search(plan.get(), ph_group.get(), N - 1);
+    ASSERT_EQ(before->seg_offsets_, first->seg_offsets_);
+
+    // loading or dropping data invalidates every result
+    segment->DropFieldData(fakevec_id);
+    ASSERT_EQ(cache->size(), 0);
+    ASSERT_EQ(cache->memory_usage(), 0);
+
+    config.set_search_cache_bytes(0);
+    ASSERT_EQ(interface->get_search_cache(MAX_TIMESTAMP, del_barrier), nullptr);
+    config.set_search_cache_bytes(search_cache_bytes);
+
+    // a result computed before an invalidation is not admitted, and one
+    // holds only for the deletes it saw
+    SearchCache local_cache;
+    auto version = local_cache.version();
+    local_cache.Clear();
+    local_cache.Put("stale", std::make_shared<CachedSearch>(), version, 1 << 20);
+    ASSERT_EQ(local_cache.Get("stale", 0), nullptr);
+    local_cache.Put("fresh", std::make_shared<CachedSearch>(), local_cache.version(), 1 << 20);
+    ASSERT_NE(local_cache.Get("fresh", 0), nullptr);
+    ASSERT_EQ(local_cache.Get("fresh", 1), nullptr);
+}
+
+TEST(Sealed, SearchBatcher) {
+    SearchBatcher batcher(std::chrono::milliseconds(50), 64);
+    std::atomic<int> num_searches = 0;
+    // the result of a query q is q * 100 + k at position k
+    SearchBatcher::SearchFunc search = [&](const void* queries, int64_t nq, int64_t topk, SearchResult& result) {
+        ++num_searches;
+        auto values = static_cast<const float*>(queries);
+        result.total_nq_ = nq;
+        result.unity_topK_ = topk;
+        result.seg_offsets_.resize(nq * topk);
+        result.distances_.resize(nq * topk);
+        for (int64_t i = 0; i < nq; ++i) {
+            for (int64_t k = 0; k < topk; ++k) {
+                result.seg_offsets_[i * topk + k] = int64_t(values[i]) * 100 + k;
+                result.distances_[i * topk + k] = k;
+            }
+        }
+    };
+
+    // the last search filters differently and runs on its own
+    int num_requests = 8;
+    BitsetType bitset(64);
+    BitsetType other_bitset(64);
+    other_bitset.set(3);
+    std::vector<float> queries(num_requests);
+    std::vector<SearchResult> results(num_requests);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_requests; ++i) {
+        queries[i] = i;
+        threads.emplace_back([&, i] {
+            BitsetView view(i == num_requests - 1 ? other_bitset : bitset);
+            batcher.Search("key", 1 + i % 3, &queries[i], 1, sizeof(float), view, search, results[i]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_LT(num_searches, num_requests);
+    for (int i = 0; i < num_requests; ++i) {
+        auto topk = 1 + i % 3;
+        ASSERT_EQ(results[i].total_nq_, 1);
+        ASSERT_EQ(results[i].unity_topK_, topk);
+        for (int k = 0; k < topk; ++k) {
+            ASSERT_EQ(results[i].seg_offsets_[k], i * 100 + k);
+        }
+    }
+
+    // every search of a failed batch sees the error
+    std::atomic<int> num_errors = 0;
+    SearchBatcher::SearchFunc failing = [](const void*, int64_t, int64_t, SearchResult&) {
+        throw std::runtime_error("search failed");
+    };
+    threads.clear();
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&, i] {
+            SearchResult result;
+            try {
+                batcher.Search("key", 1, &queries[i], 1, sizeof(float), BitsetView(bitset), failing, result);
+            } catch (std::exception&) {
+                ++num_errors;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(num_errors, 4);
+}
+
+TEST(Sealed, PreFilterStrategy) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto fake_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "range": {
+                    "counter": {
+                        "GE": 42000,
+                        "LT": 42100
+                    }
+                }
+            },
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 5,
+                        "round_decimal": 6
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    auto N = ROW_COUNT;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(fake_id);
+    auto sealed_segment = SealedCreator(schema, dataset);
+    auto plan = CreatePlan(*schema, dsl);
+    auto num_queries = 5;
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, 16, vec_col.data() + 42010 * dim);
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    // 100 of 100k rows pass, below the default selectivity
+    auto prefiltered = sealed_segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(prefiltered->search_strategy_, SearchStrategy::PreFilter);
+    ASSERT_EQ(prefiltered->filtered_rows_, 100);
+
+    auto& config = SegcoreConfig::default_config();
+    auto selectivity = config.get_prefilter_selectivity();
+    config.set_prefilter_selectivity(0);
+    auto searched = sealed_segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    config.set_prefilter_selectivity(selectivity);
+    ASSERT_EQ(searched->search_strategy_, SearchStrategy::Index);
+    ASSERT_EQ(searched->filtered_rows_, 100);
+
+    ASSERT_EQ(prefiltered->seg_offsets_, searched->seg_offsets_);
+    ASSERT_EQ(prefiltered->distances_, searched->distances_);
+    for (int i = 0; i < num_queries; ++i) {
+        ASSERT_EQ(prefiltered->seg_offsets_[i * 5], 42010 + i);
+    }
+}
+
+TEST(Sealed, WidenFilteredSearch) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto fake_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "range": {
+                    "counter": {
+                        "LT": 500
+                    }
+                }
+            },
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 1
+                        },
+                        "query": "$0",
+                        "topk": 10,
+                        "round_decimal": 6
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    auto N = 10000;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(fake_id);
+    auto plain = SealedCreator(schema, dataset);
+    auto segment = SealedCreator(schema, dataset);
+    segment->DropFieldData(fake_id);
+    LoadIndexInfo vec_info;
+    vec_info.field_id = fake_id.get();
+    vec_info.index = GenVecIndexing(N, dim, vec_col.data());
+    vec_info.index_params["metric_type"] = knowhere::metric::L2;
+    segment->LoadIndex(vec_info);
+
+    auto plan = CreatePlan(*schema, dsl);
+    auto num_queries = 5;
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, 16, vec_col.data() + 10 * dim);
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+
+    // one of 1024 lists holds a few of the 500 rows the filter leaves
+    auto& config = SegcoreConfig::default_config();
+    auto budget = config.get_filtered_search_budget_ms();
+    config.set_filtered_search_budget_ms(0);
+    auto narrow = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    config.set_filtered_search_budget_ms(budget);
+    ASSERT_EQ(narrow->search_strategy_, SearchStrategy::Index);
+    ASSERT_NE(std::count(narrow->seg_offsets_.begin(), narrow->seg_offsets_.end(), INVALID_SEG_OFFSET), 0);
+
+    // widened until all the lists are probed, the hits are exact
+    auto widened = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    auto expected = plain->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(widened->seg_offsets_, expected->seg_offsets_);
+    for (size_t i = 0; i < expected->distances_.size(); ++i) {
+        ASSERT_NEAR(widened->distances_[i], expected->distances_[i], 1e-4);
+    }
+    for (int i = 0; i < num_queries; ++i) {
+        ASSERT_EQ(widened->seg_offsets_[i * 10], 10 + i);
+    }
+}
+
+TEST(Sealed, CancelSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto fake_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "range": {
+                    "counter": {
+                        "LT": 500
+                    }
+                }
+            },
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 10,
+                        "round_decimal": 6
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(fake_id);
+    auto segment = SealedCreator(schema, dataset);
+    auto plan = CreatePlan(*schema, dsl);
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(1, dim, vec_col.data());
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto expect_cancelled = [](auto&& func) {
+        try {
+            func();
+        } catch (SegcoreError& e) {
+            ASSERT_EQ(e.get_error_code(), static_cast<ErrorCodeEnum>(QueryCancelled));
+            return;
+        }
+        FAIL() << "not cancelled";
+    };
+
+    // a deadline to come does not stop it
+    auto now_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    plan->cancel_token_.SetDeadline(now_ms + 60 * 1000);
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(result->seg_offsets_[0], 0);
+
+    plan->cancel_token_.SetDeadline(now_ms - 1);
+    expect_cancelled([&] { segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP); });
+
+    // a copy of the plan is another execution
+    query::Plan copy(*plan);
+    ASSERT_FALSE(copy.cancel_token_.Cancelled());
+    copy.cancel_token_.Cancel();
+    expect_cancelled([&] { segment->Search(&copy, ph_group.get(), MAX_TIMESTAMP); });
+
+    auto retrieve_text = boost::str(boost::format(R"(
+predicates: <
+  unary_range_expr: <
+    column_info: <
+      field_id: %1%
+      data_type: Int64
+    >
+    op: LessThan
+    value: <
+      int64_val: 500
+    >
+  >
+>
+output_field_ids: %1%
+)") % i64_fid.get());
+    proto::plan::PlanNode node_proto;
+    google::protobuf::TextFormat::ParseFromString(retrieve_text, &node_proto);
+    auto retrieve_plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+    ASSERT_EQ(segment->Retrieve(retrieve_plan.get(), MAX_TIMESTAMP)->offset_size(), 500);
+    retrieve_plan->cancel_token_.Cancel();
+    expect_cancelled([&] { segment->Retrieve(retrieve_plan.get(), MAX_TIMESTAMP); });
+}
+
+TEST(Sealed, QueryScheduler) {
+    auto& config = SegcoreConfig::default_config();
+    auto slots = config.get_query_scheduler_slots();
+    config.set_query_scheduler_slots(1);
+    auto& scheduler = query::QueryScheduler::GetInstance();
+
+    // big was admitted for 1000 queries already, small for none
+    scheduler.Acquire("big", 1, 1000);
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> threads;
+    {
+        auto held = scheduler.Acquire("other", 1, 1);
+        for (auto tenant : {"big", "small"}) {
+            auto waiting = scheduler.Waiting();
+            threads.emplace_back([&, tenant] {
+                auto ticket = scheduler.Acquire(tenant, 1, 1);
+                std::lock_guard lck(mutex);
+                order.push_back(tenant);
+            });
+            while (scheduler.Waiting() == waiting) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    config.set_query_scheduler_slots(slots);
+    ASSERT_EQ(order, (std::vector<std::string>{"small", "big"}));
+}
+
+TEST(Sealed, SlicedSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto dim = 16;
+    auto fake_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    std::string dsl = R"({
+        "bool": {
+            "must": [
+            {
+                "vector": {
+                    "fakevec": {
+                        "metric_type": "L2",
+                        "params": {
+                            "nprobe": 10
+                        },
+                        "query": "$0",
+                        "topk": 5,
+                        "round_decimal": 6
+                    }
+                }
+            }
+            ]
+        }
+    })";
+
+    auto N = 1000;
+    auto dataset = DataGen(schema, N);
+    auto vec_col = dataset.get_col<float>(fake_id);
+    auto segment = SealedCreator(schema, dataset);
+    auto plan = CreatePlan(*schema, dsl);
+    auto num_queries = 10;
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, dim, vec_col.data());
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto whole = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+
+    // slices of 3, 3, 3 and 1 queries
+    auto& config = SegcoreConfig::default_config();
+    auto slice_nq = config.get_query_slice_nq();
+    config.set_query_slice_nq(3);
+    plan->tenant_ = "tenant";
+    auto sliced = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    config.set_query_slice_nq(slice_nq);
+    ASSERT_EQ(sliced->total_nq_, num_queries);
+    ASSERT_EQ(sliced->seg_offsets_, whole->seg_offsets_);
+    ASSERT_EQ(sliced->distances_, whole->distances_);
+    for (int i = 0; i < num_queries; ++i) {
+        ASSERT_EQ(sliced->seg_offsets_[i * 5], i);
+    }
+}
+
+TEST(Sealed, MultiVectorSearch) {
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    auto text_fid = schema->AddDebugField("text", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto image_fid = schema->AddDebugField("image", DataType::VECTOR_FLOAT, 8, knowhere::metric::L2);
+    auto counter_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_fid);
+
+    int64_t N = 3000;
+    auto dataset = DataGen(schema, N);
+    auto text = dataset.get_col<float>(text_fid);
+    auto image = dataset.get_col<float>(image_fid);
+    auto segment = SealedCreator(schema, dataset);
+
+    auto field_text = [](FieldId field_id, const std::string& metric, const std::string& tag) {
+        return boost::str(boost::format(R"(fields: <
+  field_id: %1%
+  query_info: <
+    topk: 10
+    metric_type: "%2%"
+    search_params: "{\"nprobe\": 10}"
+  >
+  placeholder_tag: "%3%"
+>
+)") % field_id.get() % metric % tag);
+    };
+    auto make_plan = [&](float image_weight, const std::string& image_metric = "L2") {
+        auto proto_text = boost::str(boost::format(R"(multi_vector_anns: <
+  predicates: <
+    unary_range_expr: <
+      column_info: <
+        field_id: %1%
+        data_type: Int64
+      >
+      op: LessThan
+      value: <
+        int64_val: 1500
+      >
+    >
+  >
+  %2%
+  %3%
+  weights: 1
+  weights: %4%
+>
+)") % counter_fid.get() % field_text(text_fid, "L2", "$0") %
+                                      field_text(image_fid, image_metric, "$1") % image_weight);
+        proto::plan::PlanNode node_proto;
+        google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+        return ProtoParser(*schema).CreatePlan(node_proto);
+    };
+
+    // the queries are rows 10 to 14 in both fields
+    auto num_queries = 5;
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, 16, text.data() + 10 * 16);
+    auto image_queries = ph_group_raw.add_placeholders();
+    image_queries->set_tag("$1");
+    image_queries->set_type(proto::common::PlaceholderType::FloatVector);
+    for (int i = 0; i < num_queries; ++i) {
+        image_queries->add_values(image.data() + (10 + i) * 8, 8 * sizeof(float));
+    }
+    auto plan = make_plan(0.5);
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(result->unity_topK_, 10);
+    auto l2 = [](const float* a, const float* b, int64_t dim) {
+        float distance = 0;
+        for (int64_t d = 0; d < dim; ++d) {
+            distance += (a[d] - b[d]) * (a[d] - b[d]);
+        }
+        return distance;
+    };
+    for (int q = 0; q < num_queries; ++q) {
+        ASSERT_EQ(result->seg_offsets_[q * 10], 10 + q);
+        for (int i = 0; i < 10; ++i) {
+            auto offset = result->seg_offsets_[q * 10 + i];
+            ASSERT_LT(offset, 1500);
+            auto score = l2(text.data() + (10 + q) * 16, text.data() + offset * 16, 16) +
+                         0.5f * l2(image.data() + (10 + q) * 8, image.data() + offset * 8, 8);
+            ASSERT_NEAR(result->distances_[q * 10 + i], score, 1e-3 * std::max(1.0f, score));
+            if (i > 0) {
+                ASSERT_LE(result->distances_[q * 10 + i - 1], result->distances_[q * 10 + i]);
+            }
+        }
+    }
+
+    // without the image the hits are those of the text field alone
+    auto text_only = make_plan(0);
+    auto text_result = segment->Search(text_only.get(), ph_group.get(), MAX_TIMESTAMP);
+    auto text_plan_text = boost::str(boost::format(R"(vector_anns: <
+  field_id: %1%
+  predicates: <
+    unary_range_expr: <
+      column_info: <
+        field_id: %2%
+        data_type: Int64
+      >
+      op: LessThan
+      value: <
+        int64_val: 1500
+      >
+    >
+  >
+  query_info: <
+    topk: 10
+    metric_type: "L2"
+    search_params: "{\"nprobe\": 10}"
+  >
+  placeholder_tag: "$0"
+>
+)") % text_fid.get() % counter_fid.get());
+    proto::plan::PlanNode node_proto;
+    google::protobuf::TextFormat::ParseFromString(text_plan_text, &node_proto);
+    auto single_plan = ProtoParser(*schema).CreatePlan(node_proto);
+    auto single_result = segment->Search(single_plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(text_result->seg_offsets_, single_result->seg_offsets_);
+
+    ASSERT_ANY_THROW(make_plan(1, "IP"));
+}
+
+TEST(Sealed, GroupBySearch) {
+    auto schema = std::make_shared<Schema>();
+    auto vec_fid = schema->AddDebugField("vec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto counter_fid = schema->AddDebugField("counter", DataType::INT64);
+    auto group_fid = schema->AddDebugField("group", DataType::INT8);
+    schema->set_primary_field_id(counter_fid);
+
+    auto N = 3000;
+    auto dataset = DataGen(schema, N, 42);
+    auto segment = SealedCreator(schema, dataset);
+    auto vec = dataset.get_col<float>(vec_fid);
+    auto groups = dataset.get_col<int8_t>(group_fid);
+
+    auto make_plan = [&](FieldId field_id) {
+        auto proto_text = boost::format(R"(
+vector_anns: <
+  field_id: %1%
+  query_info: <
+    topk: 10
+    metric_type: "L2"
+    search_params: "{\"nprobe\": 10, \"group_by_field\": %2%}"
+  >
+  placeholder_tag: "$0"
+>)") % vec_fid.get() % field_id.get();
+        proto::plan::PlanNode node_proto;
+        google::protobuf::TextFormat::ParseFromString(proto_text.str(), &node_proto);
+        return ProtoParser(*schema).CreatePlan(node_proto);
+    };
+
+    // the queries are rows 10 to 14
+    auto num_queries = 5;
+    auto plan = make_plan(group_fid);
+    auto ph_group_raw = CreatePlaceholderGroupFromBlob(num_queries, 16, vec.data() + 10 * 16);
+    auto ph_group = ParsePlaceholderGroup(plan.get(), ph_group_raw.SerializeAsString());
+    auto result = segment->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(result->unity_topK_, 10);
+    ASSERT_EQ(result->group_by_values_.size(), num_queries * 10);
+
+    for (int q = 0; q < num_queries; ++q) {
+        // the best row of each group, by brute force
+        std::map<int64_t, float> best;
+        for (int64_t row = 0; row < N; ++row) {
+            float distance = 0;
+            for (int d = 0; d < 16; ++d) {
+                auto diff = vec[(10 + q) * 16 + d] - vec[row * 16 + d];
+                distance += diff * diff;
+            }
+            auto [it, inserted] = best.emplace(groups[row], distance);
+            if (!inserted) {
+                it->second = std::min(it->second, distance);
+            }
+        }
+        std::vector<float> expected;
+        for (auto& [group, distance] : best) {
+            expected.push_back(distance);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::set<int64_t> seen;
+        for (int i = 0; i < 10; ++i) {
+            auto offset = result->seg_offsets_[q * 10 + i];
+            ASSERT_NE(offset, INVALID_SEG_OFFSET);
+            auto group = std::get<int64_t>(result->group_by_values_[q * 10 + i]);
+            ASSERT_EQ(group, groups[offset]);
+            ASSERT_TRUE(seen.insert(group).second);
+            ASSERT_NEAR(result->distances_[q * 10 + i], expected[i], 1e-3 * std::max(1.0f, expected[i]));
+        }
+    }
+
+    // the reduce keeps one hit per group across segments too
+    auto other = SealedCreator(schema, DataGen(schema, N, 43));
+    auto other_result = other->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    std::vector<SearchResult*> results{result.get(), other_result.get()};
+    int64_t slice_nqs[] = {num_queries};
+    int64_t slice_topks[] = {10};
+    segcore::ReduceHelper reduce(results, plan.get(), slice_nqs, slice_topks, 1);
+    reduce.Reduce();
+    for (int q = 0; q < num_queries; ++q) {
+        std::set<int64_t> seen;
+        for (auto search_result : results) {
+            auto& prefix_sum = search_result->topk_per_nq_prefix_sum_;
+            for (auto i = prefix_sum[q]; i < prefix_sum[q + 1]; ++i) {
+                ASSERT_TRUE(seen.insert(std::get<int64_t>(search_result->group_by_values_[i])).second);
+            }
+        }
+        ASSERT_EQ(seen.size(), 10);
+    }
+
+    // a vector field can not group hits
+    ASSERT_ANY_THROW(make_plan(vec_fid));
+}
+
+TEST(Sealed, RetrieveVectorsFromIndex) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+
+    auto dataset = DataGen(schema, N);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+    auto counter_col = dataset.get_col<int64_t>(counter_id);
+
+    auto plain = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *plain);
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment);
+    segment->DropFieldData(fakevec_id);
+    LoadIndexInfo vec_info;
+    vec_info.field_id = fakevec_id.get();
+    vec_info.index = GenVecIndexing(N, dim, fakevec.data());
+    vec_info.index_params["metric_type"] = knowhere::metric::L2;
+    segment->LoadIndex(vec_info);
+    ASSERT_TRUE(segment->HasRawData(fakevec_id.get()));
+
+    auto proto_text = boost::str(boost::format(R"(
+predicates: <
+  term_expr: <
+    column_info: <
+      field_id: %1%
+      data_type: Int64
+    >
+    values: <
+      int64_val: %2%
+    >
+    values: <
+      int64_val: %3%
+    >
+  >
+>
+output_field_ids: %1%
+output_field_ids: %4%
+)") % counter_id.get() % counter_col[0] % counter_col[N - 1] % fakevec_id.get());
+    proto::plan::PlanNode node_proto;
+    google::protobuf::TextFormat::ParseFromString(proto_text, &node_proto);
+    auto plan = ProtoParser(*schema).CreateRetrievePlan(node_proto);
+    auto results = segment->Retrieve(plan.get(), MAX_TIMESTAMP);
+    auto expected = plain->Retrieve(plan.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(results->fields_data(1).vectors().float_vector().data_size(), 2 * dim);
+    ASSERT_EQ(results->SerializeAsString(), expected->SerializeAsString());
+}
+
+TEST(Sealed, MemoryUsage) {
+    auto dim = 16;
+    auto N = ROW_COUNT;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->AddDebugField("str", DataType::VARCHAR);
+    schema->set_primary_field_id(counter_id);
+
+    auto dataset = DataGen(schema, N);
+    auto fakevec = dataset.get_col<float>(fakevec_id);
+    auto segment = CreateSealedSegment(schema);
+    ASSERT_EQ(segment->GetMemoryUsageInBytes(), 0);
+
+    SealedLoadFieldData(dataset, *segment);
+    auto usage = segment->GetMemoryUsage();
+    auto& components = usage.Components();
+    ASSERT_EQ(usage.Total(), segment->GetMemoryUsageInBytes());
+    ASSERT_EQ(components.at("sealed.fields"), (dim * sizeof(float) + sizeof(int64_t)) * N);
+    ASSERT_EQ(components.at("sealed.vector_norms"), N * sizeof(float));
+    ASSERT_GT(components.at("sealed.variable_fields"), 0);
+    ASSERT_GE(components.at("insert_record.timestamps"), N * sizeof(Timestamp));
+    ASSERT_GT(components.at("insert_record.pk_index"), 0);
+    ASSERT_EQ(components.at("index.vector"), 0);
+
+    segment->DropFieldData(fakevec_id);
+    LoadIndexInfo vec_info;
+    vec_info.field_id = fakevec_id.get();
+    vec_info.index = GenVecIndexing(N, dim, fakevec.data());
+    vec_info.index_params["metric_type"] = knowhere::metric::L2;
+    segment->LoadIndex(vec_info);
+    auto indexed = segment->GetMemoryUsage();
+    ASSERT_GT(indexed.Components().at("index.vector"), 0);
+    ASSERT_GT(indexed.Total(), usage.Total());
+    ASSERT_EQ(indexed.Total(), segment->GetMemoryUsageInBytes());
+}
+
+TEST(Sealed, LoadMemoryBudget) {
+    auto dim = 16;
+    int64_t N = 1000;
+    auto schema = std::make_shared<Schema>();
+    auto fakevec_id = schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, dim, knowhere::metric::L2);
+    auto counter_id = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(counter_id);
+    auto dataset = DataGen(schema, N);
+    LoadFieldDataInfo vec_info;
+    vec_info.field_id = fakevec_id.get();
+    vec_info.row_count = N;
+    for (auto& field_data : dataset.raw_->fields_data()) {
+        if (field_data.field_id() == fakevec_id.get()) {
+            vec_info.field_data = &field_data;
+        }
+    }
+
+    // room for the row ids, the timestamps and the pks only
+    auto& budget = LoadBudget();
+    auto& config = SegcoreConfig::default_config();
+    auto used = budget.Used();
+    budget.SetCapacity(used + 3 * N * sizeof(int64_t));
+    auto segment = CreateSealedSegment(schema);
+    SealedLoadFieldData(dataset, *segment, {fakevec_id.get()});
+    ASSERT_EQ(budget.Used(), used + 3 * N * sizeof(int64_t));
+    try {
+        segment->LoadFieldData(vec_info);
+        FAIL() << "the vectors are over the budget";
+    } catch (SegcoreError& e) {
+        ASSERT_EQ(e.get_error_code(), ErrorCodeEnum::OutOfMemory);
+    }
+
+    // with a fallback dir they get mapped from a file instead
+    config.set_load_fallback_mmap_dir("./data/mmap-test");
+    segment->LoadFieldData(vec_info);
+    config.set_load_fallback_mmap_dir("");
+    ASSERT_EQ(budget.Used(), used + 3 * N * sizeof(int64_t));
+    auto vectors = dataset.get_col<float>(fakevec_id);
+    auto vec_span = segment->chunk_data<FloatVector>(fakevec_id, 0);
+    ASSERT_TRUE(std::equal(vectors.begin(), vectors.end(), vec_span.data()));
+
+    segment->DropFieldData(counter_id);
+    ASSERT_EQ(budget.Used(), used + 2 * N * sizeof(int64_t));
+    segment.reset();
+    ASSERT_EQ(budget.Used(), used);
+    budget.SetCapacity(0);
+}
+
+TEST(Sealed, IndexingRecordLookup) {
+    SealedIndexingRecord record(2);
+    auto field_id = FieldId(START_USER_FIELDID + 1);
+    ASSERT_FALSE(record.is_ready(field_id));
+    ASSERT_ANY_THROW(record.get_field_indexing(field_id));
+
+    record.append_field_indexing(field_id, knowhere::metric::L2, nullptr);
+    ASSERT_TRUE(record.is_ready(field_id));
+    ASSERT_EQ(record.get_field_indexing(field_id)->metric_type_, knowhere::metric::L2);
+    ASSERT_FALSE(record.is_ready(FieldId(START_USER_FIELDID)));
+
+    // ids outside the schema are never ready
+    ASSERT_FALSE(record.is_ready(FieldId(START_USER_FIELDID + 2)));
+    ASSERT_FALSE(record.is_ready(FieldId(0)));
+    ASSERT_ANY_THROW(record.append_field_indexing(FieldId(START_USER_FIELDID + 2), knowhere::metric::L2, nullptr));
+
+    record.drop_field_indexing(field_id);
+    ASSERT_FALSE(record.is_ready(field_id));
+
+    FieldReadyFlags flags(2);
+    flags.set(field_id);
+    ASSERT_TRUE(flags.test(field_id));
+    ASSERT_FALSE(flags.test(FieldId(START_USER_FIELDID)));
+    ASSERT_FALSE(flags.test(FieldId(START_USER_FIELDID + 5)));
+    flags.set(field_id, false);
+    ASSERT_FALSE(flags.test(field_id));
+}
+
+TEST(Sealed, SparseVectorSearch) {
+    auto schema = std::make_shared<Schema>();
+    auto sparse_id = schema->AddDebugField("sparse", DataType::VECTOR_SPARSE_FLOAT, 0, knowhere::metric::IP);
+    auto i64_fid = schema->AddDebugField("counter", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    auto topK = 5;
+    auto fmt = boost::format(R"(vector_anns: <
+                                    field_id: %1%
+                                    query_info: <
+                                        topk: %2%
+                                        metric_type: "IP"
+                                        round_decimal: -1
+                                    >
+                                    placeholder_tag: "$0">
+                                    output_field_ids: %1%)") %
+               sparse_id.get() % topK;
+    auto binary_plan = translate_text_plan_to_binary_plan(fmt.str().data());
+    auto plan = CreateSearchPlanByExpr(*schema, binary_plan.data(), binary_plan.size());
+
+    auto N = 2000;
+    auto dataset = DataGen(schema, N);
+    auto col = dataset.get_col(sparse_id);
+    auto rows = ParseSparseRows(*col, N, 0);
+    auto num_queries = 10;
+    proto::common::PlaceholderGroup raw_group;
+    auto value = raw_group.add_placeholders();
+    value->set_tag("$0");
+    value->set_type(proto::common::PlaceholderType::FloatVector);
+    for (int i = 0; i < num_queries; ++i) {
+        value->add_values(SerializeSparseQuery(rows[i * 7]));
+    }
+    auto ph_group = ParsePlaceholderGroup(plan.get(), raw_group.SerializeAsString());
+
+    auto growing = CreateGrowingSegment(schema);
+    growing->PreInsert(N);
+    growing->Insert(0, N, dataset.row_ids_.data(), dataset.timestamps_.data(), dataset.raw_);
+    auto sealed = SealedCreator(schema, dataset);
+    auto growing_result = growing->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    auto sealed_result = sealed->Search(plan.get(), ph_group.get(), MAX_TIMESTAMP);
+    ASSERT_EQ(sealed_result->seg_offsets_, growing_result->seg_offsets_);
+    for (int i = 0; i < num_queries * topK; ++i) {
+        auto offset = sealed_result->seg_offsets_[i];
+        ASSERT_NE(offset, INVALID_SEG_OFFSET);
+        auto& query = rows[i / topK * 7];
+        ASSERT_NEAR(sealed_result->distances_[i], query.dot(rows[offset]), 1e-4);
+        ASSERT_NEAR(growing_result->distances_[i], query.dot(rows[offset]), 1e-4);
+    }
+
+    // the rows come back as they were inserted
+    auto check_output = [&](const SegmentInterface& segment, SearchResult& result) {
+        segment.FillTargetEntry(plan.get(), result);
+        auto output = ParseSparseRows(*result.output_fields_data_.at(sparse_id), num_queries * topK, 0);
+        for (int i = 0; i < num_queries * topK; ++i) {
+            ASSERT_EQ(output[i], rows[result.seg_offsets_[i]]);
+        }
+    };
+    check_output(*growing, *growing_result);
+    check_output(*sealed, *sealed_result);
+}
@@ -10,6 +10,7 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <random>
 #include <string>
 #include <iostream>
@@ -115,6 +116,35 @@ TEST(InsertRecordTest, growing_string) {
     }
 }
 
+TEST(InsertRecordTest, growing_batch_duplicates) {
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    auto record = milvus::segcore::InsertRecord<false>(*schema, int64_t(32));
+    const int N = 100000;
+
+    // batches of pk i % (N / 4), so every pk lands at four offsets
+    ASSERT_TRUE(record.empty_pks());
+    for (int begin = 0; begin < N; begin += 1000) {
+        std::vector<PkType> pks;
+        for (int i = begin; i < begin + 1000; i++) pks.emplace_back(int64_t(i % (N / 4)));
+        record.insert_pks(pks, begin);
+    }
+    ASSERT_FALSE(record.empty_pks());
+
+    for (int pk = 0; pk < N / 4; pk++) {
+        std::vector<int64_t> found;
+        for (auto offset : record.search_pk(PkType(int64_t(pk)), int64_t(N))) found.push_back(offset.get());
+        std::sort(found.begin(), found.end());
+        std::vector<int64_t> expected{pk, pk + N / 4, pk + N / 2, pk + 3 * N / 4};
+        ASSERT_EQ(found, expected);
+    }
+    ASSERT_TRUE(record.search_pk(PkType(int64_t(N)), int64_t(N)).empty());
+    ASSERT_FALSE(record.may_contain_pk(PkType(int64_t(-1))));
+}
+
 TEST(InsertRecordTest, sealed_int64_t) {
     using namespace milvus::segcore;
     auto schema = std::make_shared<Schema>();
@@ -150,4 +180,169 @@ TEST(InsertRecordTest, sealed_string) {
         std::vector<SegOffset> offset = record.search_pk(std::to_string(i), int64_t(N + 1));
         ASSERT_EQ(offset[0].get(), int64_t(i));
     }
-}
\ No newline at end of file
+}
+TEST(InsertRecordTest, sealed_string_duplicates) {
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto str_fid = schema->AddDebugField("name", DataType::VARCHAR);
+    schema->set_primary_field_id(str_fid);
+    auto sealed = milvus::segcore::InsertRecord<true>(*schema, int64_t(32));
+    auto growing = milvus::segcore::InsertRecord<false>(*schema, int64_t(32));
+    const int N = 30000;
+
+    // pks sharing their first 8 bytes are told apart past the prefix
+    auto pk_of = [](int i) { return (i % 2 ? std::string("user_id_") : std::string()) + std::to_string(i); };
+    std::default_random_engine e(42);
+    for (int i = 0; i < N; i++) {
+        auto pk = PkType(pk_of(e() % (N / 3)));
+        sealed.insert_pk(pk, int64_t(i));
+        growing.insert_pk(pk, int64_t(i));
+    }
+    sealed.seal_pks();
+
+    for (int i = 0; i < N / 2; i++) {
+        auto pk = PkType(pk_of(i));
+        std::vector<int64_t> expected, found;
+        for (auto offset : growing.search_pk(pk, int64_t(N))) expected.push_back(offset.get());
+        for (auto offset : sealed.search_pk(pk, int64_t(N))) found.push_back(offset.get());
+        std::sort(expected.begin(), expected.end());
+        std::sort(found.begin(), found.end());
+        ASSERT_EQ(found, expected);
+    }
+    ASSERT_TRUE(sealed.search_pk(PkType(std::string("user_id_")), int64_t(N)).empty());
+    ASSERT_TRUE(sealed.search_pk(PkType(std::string()), int64_t(N)).empty());
+}
+
+TEST(InsertRecordTest, search_pks) {
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    auto sealed = milvus::segcore::InsertRecord<true>(*schema, int64_t(32));
+    auto growing = milvus::segcore::InsertRecord<false>(*schema, int64_t(32));
+    const int N = 100000;
+
+    // every pk twice, at offsets i and N + i
+    for (int i = 0; i < 2 * N; i++) {
+        sealed.insert_pk(PkType(int64_t(i % N) * 2), int64_t(i));
+        growing.insert_pk(PkType(int64_t(i % N) * 2), int64_t(i));
+    }
+    sealed.seal_pks();
+
+    // ascending, odd pks are absent
+    std::vector<PkType> pks;
+    for (int64_t pk = -3; pk < 2 * N + 3; pk += 7) {
+        pks.emplace_back(pk);
+    }
+    for (auto insert_barrier : {int64_t(N + N / 2), int64_t(2 * N)}) {
+        std::vector<int64_t> sealed_offsets, growing_offsets;
+        std::vector<int64_t> sealed_bounds, growing_bounds;
+        sealed.search_pks(pks, insert_barrier, sealed_offsets, sealed_bounds);
+        growing.search_pks(pks, insert_barrier, growing_offsets, growing_bounds);
+        ASSERT_EQ(sealed_bounds.size(), pks.size() + 1);
+        ASSERT_EQ(growing_bounds.size(), pks.size() + 1);
+        for (size_t i = 0; i < pks.size(); ++i) {
+            auto expected = sealed.search_pk(pks[i], insert_barrier);
+            std::vector<int64_t> expected_offsets;
+            for (auto offset : expected) {
+                expected_offsets.push_back(offset.get());
+            }
+            std::sort(expected_offsets.begin(), expected_offsets.end());
+            for (auto [offsets, bounds] : {std::pair{&sealed_offsets, &sealed_bounds},
+                                           std::pair{&growing_offsets, &growing_bounds}}) {
+                std::vector<int64_t> found(offsets->begin() + (*bounds)[i], offsets->begin() + (*bounds)[i + 1]);
+                std::sort(found.begin(), found.end());
+                ASSERT_EQ(found, expected_offsets);
+            }
+        }
+    }
+}
+
+TEST(InsertRecordTest, search_pks_by_fingerprint) {
+    using namespace milvus::segcore;
+    auto schema = std::make_shared<Schema>();
+    schema->AddDebugField("fakevec", DataType::VECTOR_FLOAT, 16, knowhere::metric::L2);
+    auto str_fid = schema->AddDebugField("name", DataType::VARCHAR);
+    schema->set_primary_field_id(str_fid);
+    auto sealed = milvus::segcore::InsertRecord<true>(*schema, int64_t(32));
+    auto growing = milvus::segcore::InsertRecord<false>(*schema, int64_t(32));
+    const int N = 30000;
+
+    // fingerprints are stable, so they may outlive the process
+    ASSERT_EQ(PkFingerprint(std::string_view("milvus_pk")), 7678063895419608558ULL);
+    ASSERT_NE(PkFingerprint(std::string_view("pk_1")), PkFingerprint(std::string_view("pk_2")));
+    ASSERT_EQ(PkFingerprint(int64_t(42)), BlockedBloomFilter::hash(int64_t(42)));
+
+    // every pk twice, at offsets i and N + i, through growth of the table
+    for (int i = 0; i < 2 * N; i++) {
+        auto pk = PkType("pk_" + std::to_string(i % N * 2));
+        sealed.insert_pk(pk, int64_t(i));
+        growing.insert_pk(pk, int64_t(i));
+    }
+    sealed.seal_pks();
+
+    // odd pks are absent
+    std::vector<std::string> strs;
+    for (int i = 0; i < 2 * N; i += 7) {
+        strs.push_back("pk_" + std::to_string(i));
+    }
+    std::vector<std::string_view> pks(strs.begin(), strs.end());
+    std::vector<uint64_t> fingerprints;
+    for (auto pk : pks) {
+        fingerprints.push_back(PkFingerprint(pk));
+    }
+    auto check = [&](const auto& record) {
+        std::vector<int64_t> offsets, bounds, expected_offsets, expected_bounds;
+        record.search_pks(pks.data(), fingerprints.data(), pks.size(), N + N / 2, offsets, bounds);
+        record.search_pks(pks.data(), pks.size(), N + N / 2, expected_offsets, expected_bounds);
+        ASSERT_EQ(bounds, expected_bounds);
+        ASSERT_EQ(offsets, expected_offsets);
+        for (size_t i = 0; i < pks.size(); ++i) {
+            // pk_2k is at k and at N + k, the barrier keeps the latter if k < N / 2
+            auto value = std::stoi(strs[i].substr(3));
+            auto expected = value % 2 != 0 ? 0 : (value / 2 < N / 2 ? 2 : 1);
+            ASSERT_EQ(bounds[i + 1] - bounds[i], expected);
+        }
+    };
+    check(sealed);
+    check(growing);
+}
+
+TEST(InsertRecordTest, pk_bloom_filter) {
+    using milvus::segcore::BlockedBloomFilter;
+    const int N = 100000;
+    BlockedBloomFilter filter(N);
+    for (int64_t i = 0; i < N; i++) {
+        filter.add(BlockedBloomFilter::hash(i * 3));
+    }
+    int64_t false_positives = 0;
+    for (int64_t i = 0; i < 3 * N; i++) {
+        auto found = filter.may_contain(BlockedBloomFilter::hash(i));
+        if (i % 3 == 0) {
+            ASSERT_TRUE(found);
+        } else {
+            false_positives += found;
+        }
+    }
+    ASSERT_LT(false_positives, 2 * N / 50);
+
+    // the sealed pk array answers lookups of absent pks from its filter
+    auto schema = std::make_shared<Schema>();
+    auto str_fid = schema->AddDebugField("name", DataType::VARCHAR);
+    schema->set_primary_field_id(str_fid);
+    auto record = milvus::segcore::InsertRecord<true>(*schema, int64_t(32));
+    for (int i = 0; i < N; i++) record.insert_pk(PkType(std::to_string(i)), int64_t(i));
+    ASSERT_TRUE(record.may_contain_pk(PkType(std::string("absent"))));
+    record.seal_pks();
+    for (int i = 0; i < N; i += 97) {
+        ASSERT_TRUE(record.may_contain_pk(PkType(std::to_string(i))));
+    }
+    int64_t absent = 0;
+    for (int i = N; i < 2 * N; i++) {
+        absent += !record.may_contain_pk(PkType(std::to_string(i)));
+        ASSERT_TRUE(record.search_pk(PkType(std::to_string(i)), int64_t(N)).empty());
+    }
+    ASSERT_GT(absent, N * 95 / 100);
+}
@@ -0,0 +1,425 @@
+// Copyright (C) 2019-2020 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simd/hook.h"
+
+using namespace milvus::simd;
+
+namespace {
+
+template <typename T>
+std::vector<T>
+GenData(int64_t size, std::default_random_engine& er) {
+    // narrow value domain so that equality actually hits
+    std::uniform_int_distribution<int> distrib(-8, 8);
+    std::vector<T> data(size);
+    for (auto& x : data) {
+        x = static_cast<T>(distrib(er));
+    }
+    return data;
+}
+
+bool
+GetBit(const std::vector<BlockType>& blocks, int64_t i) {
+    return (blocks[i / BITS_PER_BLOCK] >> (i % BITS_PER_BLOCK)) & 1;
+}
+
+// check the bits past `size` are left zero
+void
+CheckTail(const std::vector<BlockType>& blocks, int64_t size) {
+    for (int64_t i = size; i < blocks.size() * BITS_PER_BLOCK; ++i) {
+        ASSERT_FALSE(GetBit(blocks, i)) << i;
+    }
+}
+
+}  // namespace
+
+template <typename T>
+class SimdCompareTest : public ::testing::Test {
+ protected:
+    void
+    SetUp() override {
+        origin_ = GetSimdType();
+    }
+    void
+    TearDown() override {
+        SetSimdType(origin_);
+    }
+
+    std::string origin_;
+};
+
+using SimdTypes =
+    ::testing::Types<int8_t, int16_t, int32_t, int64_t, float, double>;
+TYPED_TEST_CASE_P(SimdCompareTest);
+
+TYPED_TEST_P(SimdCompareTest, Val) {
+    using T = TypeParam;
+    std::default_random_engine er(42);
+    std::vector<std::pair<CompareOp, std::function<bool(T, T)>>> ops{
+        {CompareOp::Equal, std::equal_to<T>{}},
+        {CompareOp::NotEqual, std::not_equal_to<T>{}},
+        {CompareOp::GreaterThan, std::greater<T>{}},
+        {CompareOp::GreaterEqual, std::greater_equal<T>{}},
+        {CompareOp::LessThan, std::less<T>{}},
+        {CompareOp::LessEqual, std::less_equal<T>{}},
+    };
+    for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+        SetSimdType(simd_type);
+        for (int64_t size : {0, 1, 31, 64, 65, 1000, 4096}) {
+            auto data = GenData<T>(size, er);
+            std::vector<BlockType> dst((size + BITS_PER_BLOCK - 1) /
+                                       BITS_PER_BLOCK, ~BlockType(0));
+            for (auto& [op, func] : ops) {
+                auto val = static_cast<T>(3);
+                CompareVal(data.data(), size, val, op, dst.data());
+                for (int64_t i = 0; i < size; ++i) {
+                    ASSERT_EQ(GetBit(dst, i), func(data[i], val))
+                        << GetSimdType() << " " << int(op) << " " << i;
+                }
+                CheckTail(dst, size);
+            }
+        }
+    }
+}
+
+TYPED_TEST_P(SimdCompareTest, Range) {
+    using T = TypeParam;
+    std::default_random_engine er(42);
+    for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+        SetSimdType(simd_type);
+        for (int64_t size : {0, 1, 31, 64, 65, 1000, 4096}) {
+            auto data = GenData<T>(size, er);
+            std::vector<BlockType> dst((size + BITS_PER_BLOCK - 1) /
+                                       BITS_PER_BLOCK, ~BlockType(0));
+            auto lower = static_cast<T>(-2);
+            auto upper = static_cast<T>(5);
+            for (auto lower_inclusive : {false, true}) {
+                for (auto upper_inclusive : {false, true}) {
+                    CompareRange(data.data(), size, lower, upper, lower_inclusive, upper_inclusive, dst.data());
+                    for (int64_t i = 0; i < size; ++i) {
+                        auto x = data[i];
+                        auto ref = (lower_inclusive ? lower <= x : lower < x) &&
+                                   (upper_inclusive ? x <= upper : x < upper);
+                        ASSERT_EQ(GetBit(dst, i), ref) << GetSimdType() << " " << i;
+                    }
+                    CheckTail(dst, size);
+                }
+            }
+        }
+    }
+}
+
+REGISTER_TYPED_TEST_CASE_P(SimdCompareTest, Val, Range);
+INSTANTIATE_TYPED_TEST_CASE_P(Simd, SimdCompareTest, SimdTypes);
+
+TEST(Simd, NaN) {
+    auto origin = GetSimdType();
+    std::vector<float> data(100, std::numeric_limits<float>::quiet_NaN());
+    std::vector<BlockType> dst(2);
+    for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+        SetSimdType(simd_type);
+        CompareVal(data.data(), data.size(), 1.0f, CompareOp::NotEqual, dst.data());
+        ASSERT_EQ(dst[0], ~BlockType(0));
+        ASSERT_EQ(dst[1], (BlockType(1) << 36) - 1);
+        CompareVal(data.data(), data.size(), 1.0f, CompareOp::LessEqual, dst.data());
+        ASSERT_EQ(dst[0], 0);
+        ASSERT_EQ(dst[1], 0);
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, RoundDecimal) {
+    auto origin = GetSimdType();
+    std::default_random_engine rng(42);
+    std::uniform_real_distribution<float> dist(-1000, 1000);
+    std::vector<float> data(1003);
+    for (auto& x : data) {
+        x = dist(rng);
+    }
+    // ties, signed zeros and the extremes
+    data[0] = 0.5f;
+    data[1] = -0.5f;
+    data[2] = -0.0f;
+    data[3] = 2.5f;
+    data[4] = -0.00001f;
+    data[5] = std::numeric_limits<float>::infinity();
+    data[6] = -std::numeric_limits<float>::infinity();
+    data[7] = std::numeric_limits<float>::max();
+    for (int64_t round_decimal : {-1, 0, 2, 5}) {
+        std::vector<float> expected(data);
+        if (round_decimal != -1) {
+            const float multiplier = std::pow(10.0, round_decimal);
+            for (auto& x : expected) {
+                x = std::round(x * multiplier) / multiplier;
+            }
+        }
+        for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+            SetSimdType(simd_type);
+            std::vector<float> rounded(data);
+            RoundDecimal(rounded.data(), rounded.size(), round_decimal);
+            for (size_t i = 0; i < data.size(); ++i) {
+                ASSERT_EQ(std::memcmp(&rounded[i], &expected[i], sizeof(float)), 0)
+                    << GetSimdType() << " " << round_decimal << " " << data[i];
+            }
+        }
+    }
+    SetSimdType(origin);
+}
+
+template <typename Offset>
+void
+CheckStringKernels() {
+    std::default_random_engine er(42);
+    // short strings over few bytes, so prefixes and ties of the 8 byte keys are common,
+    // a byte over 0x7f orders as unsigned
+    const char alphabet[] = {'a', 'b', '\xff'};
+    std::vector<std::string> rows(1000);
+    std::string data;
+    std::vector<Offset> offsets;
+    for (auto& row : rows) {
+        auto length = er() % 24;
+        for (int i = 0; i < length; ++i) {
+            row += alphabet[er() % 3];
+        }
+        offsets.push_back(data.size());
+        data += row;
+    }
+    offsets.push_back(data.size());
+
+    std::vector<std::string> values{"", "a", "ab", "abab", "\xff\xff", "aaaaaaaa", "aaaaaaaab", "abababababababababab"};
+    std::vector<std::pair<CompareOp, std::function<bool(int)>>> ops{
+        {CompareOp::Equal, [](int c) { return c == 0; }},
+        {CompareOp::NotEqual, [](int c) { return c != 0; }},
+        {CompareOp::GreaterThan, [](int c) { return c > 0; }},
+        {CompareOp::GreaterEqual, [](int c) { return c >= 0; }},
+        {CompareOp::LessThan, [](int c) { return c < 0; }},
+        {CompareOp::LessEqual, [](int c) { return c <= 0; }},
+    };
+    // a slice starting mid way, its last rows bound the reads
+    for (auto [begin, size] : {std::pair<int64_t, int64_t>{0, 1000}, {5, 995}, {7, 3}}) {
+        std::vector<BlockType> dst((size + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK);
+        for (auto& value : values) {
+            PrefixMatch(data.data(), offsets.data() + begin, size, value, dst.data());
+            for (int64_t i = 0; i < size; ++i) {
+                auto expected = std::string_view(rows[begin + i]).substr(0, value.size()) == value;
+                ASSERT_EQ(GetBit(dst, i), expected) << value << " " << rows[begin + i];
+            }
+            CheckTail(dst, size);
+            for (auto& [op, check] : ops) {
+                CompareStrings(data.data(), offsets.data() + begin, size, value, op, dst.data());
+                for (int64_t i = 0; i < size; ++i) {
+                    auto expected = check(std::string_view(rows[begin + i]).compare(value));
+                    ASSERT_EQ(GetBit(dst, i), expected) << value << " " << int(op) << " " << rows[begin + i];
+                }
+                CheckTail(dst, size);
+            }
+        }
+    }
+}
+
+TEST(Simd, StringKernels) {
+    CheckStringKernels<uint32_t>();
+    CheckStringKernels<uint64_t>();
+}
+
+TEST(Simd, BinaryDistances) {
+    auto origin = GetSimdType();
+    std::default_random_engine er(42);
+    // code sizes around the widths of the vectors, and an all zero pair for jaccard
+    for (int64_t code_size : {1, 7, 8, 25, 32, 33, 64, 100, 128}) {
+        int64_t size = 70;
+        std::vector<uint8_t> query(code_size);
+        std::vector<uint8_t> rows(size * code_size);
+        for (auto& x : query) {
+            x = er();
+        }
+        for (auto& x : rows) {
+            x = er();
+        }
+        std::fill_n(rows.begin(), code_size, 0);
+        std::vector<float> hamming(size);
+        std::vector<float> jaccard(size);
+        for (int64_t i = 0; i < size; ++i) {
+            int64_t diff = 0, intersection = 0, union_ = 0;
+            for (int64_t b = 0; b < code_size; ++b) {
+                auto x = query[b];
+                auto y = rows[i * code_size + b];
+                diff += __builtin_popcount(x ^ y);
+                intersection += __builtin_popcount(x & y);
+                union_ += __builtin_popcount(x | y);
+            }
+            hamming[i] = diff;
+            jaccard[i] = union_ == 0 ? 0 : 1 - float(intersection) / float(union_);
+        }
+        std::vector<uint8_t> zeros(code_size);
+        for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+            SetSimdType(simd_type);
+            std::vector<float> dst(size);
+            Hamming(query.data(), rows.data(), code_size, size, dst.data());
+            ASSERT_EQ(dst, hamming) << GetSimdType() << " " << code_size;
+            Jaccard(query.data(), rows.data(), code_size, size, dst.data());
+            ASSERT_EQ(dst, jaccard) << GetSimdType() << " " << code_size;
+            Jaccard(zeros.data(), rows.data(), code_size, 1, dst.data());
+            ASSERT_EQ(dst[0], 0) << GetSimdType() << " " << code_size;
+        }
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, HalfVectors) {
+    auto origin = GetSimdType();
+    // exact, rounded to even, overflowing and subnormal values
+    std::vector<float> values{1.0f, -2.5f, 0.0f, 65504.0f, 1e6f, 1.0f + 1.0f / 2048, 1e-7f};
+    std::vector<uint16_t> fp16(values.size());
+    ToHalf(values.data(), values.size(), HalfType::Float16, fp16.data());
+    ASSERT_EQ(fp16, (std::vector<uint16_t>{0x3c00, 0xc100, 0x0000, 0x7bff, 0x7c00, 0x3c00, 0x0002}));
+    std::vector<uint16_t> bf16(values.size());
+    ToHalf(values.data(), values.size(), HalfType::BFloat16, bf16.data());
+    ASSERT_EQ(bf16[0], 0x3f80);
+    ASSERT_EQ(bf16[1], 0xc020);
+    std::vector<float> widened(values.size());
+    FromHalf(fp16.data(), fp16.size(), HalfType::Float16, widened.data());
+    ASSERT_EQ(widened[1], -2.5f);
+    ASSERT_EQ(widened[3], 65504.0f);
+    ASSERT_TRUE(std::isinf(widened[4]));
+
+    std::default_random_engine er(42);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    for (int64_t dim : {1, 7, 16, 33, 128}) {
+        int64_t size = 20;
+        std::vector<float> query(dim);
+        std::vector<float> rows(size * dim);
+        for (auto& x : query) {
+            x = dist(er);
+        }
+        for (auto& x : rows) {
+            x = dist(er);
+        }
+        for (auto type : {HalfType::Float16, HalfType::BFloat16}) {
+            std::vector<uint16_t> halves(rows.size());
+            ToHalf(rows.data(), rows.size(), type, halves.data());
+            std::vector<float> widened_rows(rows.size());
+            FromHalf(halves.data(), halves.size(), type, widened_rows.data());
+            for (bool is_ip : {false, true}) {
+                std::vector<float> expected(size);
+                for (int64_t i = 0; i < size; ++i) {
+                    for (int64_t d = 0; d < dim; ++d) {
+                        auto x = widened_rows[i * dim + d];
+                        expected[i] += is_ip ? query[d] * x : (query[d] - x) * (query[d] - x);
+                    }
+                }
+                for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+                    SetSimdType(simd_type);
+                    std::vector<float> distances(size);
+                    HalfDistances(query.data(), halves.data(), dim, size, type, is_ip, distances.data());
+                    for (int64_t i = 0; i < size; ++i) {
+                        ASSERT_NEAR(distances[i], expected[i], 1e-4 * std::max(1.0f, std::abs(expected[i])))
+                            << GetSimdType() << " " << dim << " " << is_ip;
+                    }
+                }
+            }
+        }
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, InnerProducts) {
+    auto origin = GetSimdType();
+    std::default_random_engine rng(11);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    int64_t size = 37;
+    for (int64_t dim : {1, 7, 8, 16, 19, 128}) {
+        std::vector<float> rows(size * dim);
+        for (auto& x : rows) {
+            x = dist(rng);
+        }
+        std::vector<float> norms(size);
+        SquaredNorms(rows.data(), dim, size, norms.data());
+        for (int64_t i = 0; i < size; ++i) {
+            float expected = 0;
+            for (int64_t d = 0; d < dim; ++d) {
+                expected += rows[i * dim + d] * rows[i * dim + d];
+            }
+            ASSERT_NEAR(norms[i], expected, 1e-4);
+        }
+        // batches of queries not a multiple of the four sharing a row
+        for (int64_t nq : {1, 4, 6}) {
+            std::vector<float> queries(nq * dim);
+            for (auto& x : queries) {
+                x = dist(rng);
+            }
+            for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+                SetSimdType(simd_type);
+                std::vector<float> products(nq * size);
+                InnerProducts(queries.data(), nq, rows.data(), dim, size, products.data());
+                for (int64_t q = 0; q < nq; ++q) {
+                    for (int64_t i = 0; i < size; ++i) {
+                        float expected = 0;
+                        for (int64_t d = 0; d < dim; ++d) {
+                            expected += queries[q * dim + d] * rows[i * dim + d];
+                        }
+                        ASSERT_NEAR(products[q * size + i], expected, 1e-4) << GetSimdType() << " " << dim << " " << nq;
+                    }
+                }
+            }
+        }
+    }
+    SetSimdType(origin);
+}
+
+TEST(Simd, GatherDistances) {
+    auto origin = GetSimdType();
+    std::default_random_engine rng(13);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    int64_t size = 41;
+    // scattered and repeated rows
+    std::vector<int64_t> offsets = {40, 3, 3, 17, 0, 29};
+    for (int64_t dim : {1, 7, 8, 16, 19, 128}) {
+        std::vector<float> rows(size * dim);
+        for (auto& x : rows) {
+            x = dist(rng);
+        }
+        std::vector<float> query(dim);
+        for (auto& x : query) {
+            x = dist(rng);
+        }
+        for (bool is_ip : {false, true}) {
+            for (auto simd_type : {"REF", "AVX2", "AVX512"}) {
+                SetSimdType(simd_type);
+                std::vector<float> distances(offsets.size());
+                GatherDistances(
+                    query.data(), rows.data(), dim, offsets.data(), offsets.size(), is_ip, distances.data());
+                for (size_t i = 0; i < offsets.size(); ++i) {
+                    float expected = 0;
+                    for (int64_t d = 0; d < dim; ++d) {
+                        auto x = rows[offsets[i] * dim + d];
+                        expected += is_ip ? query[d] * x : (query[d] - x) * (query[d] - x);
+                    }
+                    ASSERT_NEAR(distances[i], expected, 1e-4 * std::max(1.0f, std::abs(expected)))
+                        << GetSimdType() << " " << dim << " " << is_ip;
+                }
+            }
+        }
+    }
+    SetSimdType(origin);
+}
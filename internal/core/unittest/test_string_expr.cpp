@@ -538,7 +538,7 @@ TEST(AlwaysTrueStringPlan, SearchWithOutputFields) {
         dim,       //
         query_ptr  //
     };
-    auto sub_result = BruteForceSearch(search_dataset, vec_col.data(), N, knowhere::Json(), nullptr);
+    auto sub_result = BruteForceSearch(search_dataset, vec_col.data(), N, milvus::SearchParams(), nullptr);
 
     auto sr = segment->Search(plan.get(), ph_group.get(), time);
     segment->FillPrimaryKeys(plan.get(), *sr);
@@ -586,4 +586,7 @@ TEST(AlwaysTrueStringPlan, QueryWithOutputFields) {
     ASSERT_EQ(retrieved->offset().size(), N);
     ASSERT_EQ(retrieved->fields_data().size(), 1);
     ASSERT_EQ(retrieved->fields_data(0).scalars().string_data().data().size(), N);
+    for (int i = 0; i < N; ++i) {
+        ASSERT_EQ(retrieved->ids().str_id().data(i), retrieved->fields_data(0).scalars().string_data().data(i));
+    }
 }
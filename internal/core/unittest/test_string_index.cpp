@@ -15,6 +15,7 @@
 #include "index/ScalarIndex.h"
 
 #define private public
+#include "index/PackedIds.h"
 #include "index/StringIndexMarisa.h"
 
 #include "index/IndexFactory.h"
@@ -330,3 +331,65 @@ TEST_F(StringIndexMarisaTest, BaseIndexCodec) {
         }
     }
 }
+
+TEST(StringIndexMarisa, RepeatedStrings) {
+    // few distinct strings over many rows, unevenly spread
+    std::vector<std::string> strings(5000);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        strings[i] = i % 10 == 0 ? "rare-" + std::to_string(i % 3) : "common-" + std::to_string(i % 7);
+    }
+    auto index = milvus::index::CreateStringIndexMarisa();
+    index->Build(strings.size(), strings.data());
+    auto binary_set = index->Serialize({});
+    auto loaded = milvus::index::CreateStringIndexMarisa();
+    loaded->Load(binary_set);
+
+    std::vector<std::string> values{"rare-1", "common-3", "rare-1", "absent"};
+    auto in = loaded->In(values.size(), values.data());
+    auto not_in = loaded->NotIn(values.size(), values.data());
+    auto prefix = loaded->PrefixMatch("rare-");
+    auto range = loaded->Range("common-2", true, "common-5", false);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        auto matched = strings[i] == "rare-1" || strings[i] == "common-3";
+        ASSERT_EQ(in->test(i), matched);
+        ASSERT_EQ(not_in->test(i), !matched);
+        ASSERT_EQ(prefix->test(i), strings[i].rfind("rare-", 0) == 0);
+        ASSERT_EQ(range->test(i), strings[i] >= "common-2" && strings[i] < "common-5");
+        ASSERT_EQ(loaded->Reverse_Lookup(i), strings[i]);
+    }
+
+    std::vector<std::string> decoded(strings.size());
+    loaded->ReverseLookupRange(0, strings.size(), decoded.data());
+    ASSERT_EQ(decoded, strings);
+    std::vector<int64_t> offsets{4999, 10, 0, 10, 7};
+    std::vector<std::string> batch(offsets.size());
+    loaded->ReverseLookupBatch(offsets.data(), offsets.size(), batch.data());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        ASSERT_EQ(batch[i], strings[offsets[i]]);
+    }
+}
+
+TEST(StringIndexMarisa, PackedIds) {
+    std::vector<size_t> ids(1000);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = (i * 7919) % 1000;
+    }
+    milvus::index::PackedIds packed(ids.data(), ids.size(), 1000);
+    ASSERT_EQ(packed.bits(), 10);
+    ASSERT_EQ(packed.size(), ids.size());
+    ASSERT_LT(packed.memory_bytes(), ids.size() * sizeof(size_t) / 4);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ASSERT_EQ(packed[i], ids[i]);
+    }
+    std::vector<uint32_t> decoded(100);
+    packed.Decode(450, 550, decoded.data());
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        ASSERT_EQ(decoded[i], ids[450 + i]);
+    }
+
+    // a single distinct id takes no bits
+    std::vector<size_t> zeros(10, 0);
+    milvus::index::PackedIds single(zeros.data(), zeros.size(), 1);
+    ASSERT_EQ(single.bits(), 0);
+    ASSERT_EQ(single[9], 0);
+}
@@ -58,3 +58,29 @@ TEST(TimestampIndex, Naive) {
     ASSERT_EQ(range.first, 8);
     ASSERT_EQ(range.second, 8);
 }
+
+TEST(TimestampIndex, NearlySorted) {
+    // sorted but for a few late rows, which merge everything after them
+    // into a single slice
+    const int64_t N = 100000;
+    std::vector<Timestamp> timestamps(N);
+    for (int64_t i = 0; i < N; ++i) {
+        timestamps[i] = 10 * i;
+    }
+    for (int64_t i = 1000; i + 5000 < N; i += 7919) {
+        std::swap(timestamps[i], timestamps[i + 5000]);
+    }
+    TimestampIndex index;
+    index.set_length_meta(GenerateFakeSlices(timestamps.data(), N, 4096));
+    index.build_with(timestamps.data(), N);
+
+    for (Timestamp query_ts : {Timestamp(5), Timestamp(123456), Timestamp(10 * N / 2 + 3), Timestamp(10 * N - 20)}) {
+        auto [beg, end] = index.get_active_range(query_ts);
+        ASSERT_LE(beg, end);
+        ASSERT_LE(end - beg, 5000 + 2 * 64);
+        auto bitset = index.GenerateBitset(query_ts, {beg, end}, timestamps.data(), N);
+        for (int64_t i = 0; i < N; ++i) {
+            ASSERT_EQ(bitset[i], timestamps[i] > query_ts);
+        }
+    }
+}
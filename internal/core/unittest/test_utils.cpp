@@ -14,6 +14,7 @@
 
 #include "common/Utils.h"
 #include "query/Utils.h"
+#include "segcore/Utils.h"
 #include "test_utils/DataGen.h"
 
 TEST(Util, StringMatch) {
@@ -65,33 +66,202 @@ TEST(Util, GetDeleteBitmap) {
 
     // test case delete pk1(ts = 0) -> insert repeated pk1 (ts = {1 ... N}) -> query (ts = N)
     std::vector<Timestamp> delete_ts = {0};
-    std::vector<PkType> delete_pk = {1};
+    std::vector<int64_t> delete_pk = {1};
     auto offset = delete_record.reserved.fetch_add(1);
-    delete_record.timestamps_.set_data_raw(offset, delete_ts.data(), 1);
-    delete_record.pks_.set_data_raw(offset, delete_pk.data(), 1);
-    delete_record.ack_responder_.AddSegment(offset, offset + 1);
+    delete_record.push(offset, delete_pk.data(), delete_ts.data(), 1);
 
     auto query_timestamp = tss[N - 1];
     auto del_barrier = get_barrier(delete_record, query_timestamp);
     auto insert_barrier = get_barrier(insert_record, query_timestamp);
     auto res_bitmap = get_deleted_bitmap(del_barrier, insert_barrier, delete_record, insert_record, query_timestamp);
-    ASSERT_EQ(res_bitmap->bitmap_ptr->count(), 0);
+    ASSERT_EQ(res_bitmap->count(), 0);
 
     // test case insert repeated pk1 (ts = {1 ... N}) -> delete pk1 (ts = N) -> query (ts = N)
     delete_ts = {uint64_t(N)};
     delete_pk = {1};
     offset = delete_record.reserved.fetch_add(1);
-    delete_record.timestamps_.set_data_raw(offset, delete_ts.data(), 1);
-    delete_record.pks_.set_data_raw(offset, delete_pk.data(), 1);
-    delete_record.ack_responder_.AddSegment(offset, offset + 1);
+    delete_record.push(offset, delete_pk.data(), delete_ts.data(), 1);
 
     del_barrier = get_barrier(delete_record, query_timestamp);
     res_bitmap = get_deleted_bitmap(del_barrier, insert_barrier, delete_record, insert_record, query_timestamp);
-    ASSERT_EQ(res_bitmap->bitmap_ptr->count(), N - 1);
+    ASSERT_EQ(res_bitmap->count(), N - 1);
 
     // test case insert repeated pk1 (ts = {1 ... N}) -> delete pk1 (ts = N) -> query (ts = N/2)
     query_timestamp = tss[N - 1] / 2;
     del_barrier = get_barrier(delete_record, query_timestamp);
     res_bitmap = get_deleted_bitmap(del_barrier, N, delete_record, insert_record, query_timestamp);
-    ASSERT_EQ(res_bitmap->bitmap_ptr->count(), 0);
+    ASSERT_EQ(res_bitmap->count(), 0);
+}
+
+TEST(Util, DeletedBitmapSnapshot) {
+    using namespace milvus;
+    using namespace milvus::query;
+    using namespace milvus::segcore;
+
+    auto schema = std::make_shared<Schema>();
+    auto i64_fid = schema->AddDebugField("age", DataType::INT64);
+    schema->set_primary_field_id(i64_fid);
+    auto N = 100000;
+
+    // distinct pks {0 ... N - 1}, timestamps {1 ... N}
+    InsertRecord insert_record(*schema, N);
+    DeletedRecord delete_record;
+    std::vector<int64_t> age_data(N);
+    std::vector<Timestamp> tss(N);
+    for (int i = 0; i < N; ++i) {
+        age_data[i] = i;
+        tss[i] = i + 1;
+        insert_record.insert_pk(i, i);
+    }
+    auto insert_offset = insert_record.reserved.fetch_add(N);
+    insert_record.timestamps_.fill_chunk_data(tss.data(), N);
+    insert_record.get_field_data_base(i64_fid)->fill_chunk_data(age_data.data(), N);
+    insert_record.ack_responder_.AddSegment(insert_offset, insert_offset + N);
+
+    auto delete_pks = [&](std::vector<int64_t> pks, Timestamp ts) {
+        std::vector<Timestamp> delete_ts(pks.size(), ts);
+        auto offset = delete_record.reserved.fetch_add(pks.size());
+        delete_record.push(offset, pks.data(), delete_ts.data(), pks.size());
+    };
+    auto query = [&](Timestamp ts, int64_t insert_barrier) {
+        auto del_barrier = get_barrier(delete_record, ts);
+        return get_deleted_bitmap(del_barrier, insert_barrier, delete_record, insert_record, ts);
+    };
+
+    delete_pks({3, 70000}, N + 1);
+    auto first = query(N + 1, N);
+    ASSERT_EQ(first->count(), 2);
+    // unchanged barriers are served from the published snapshot
+    ASSERT_EQ(query(N + 1, N), first);
+
+    // a later delete leaves the snapshot held by the earlier query untouched
+    delete_pks({5}, N + 2);
+    auto second = query(N + 2, N);
+    ASSERT_NE(second, first);
+    ASSERT_EQ(first->count(), 2);
+    ASSERT_FALSE(first->test(5));
+    ASSERT_EQ(second->count(), 3);
+    ASSERT_TRUE(second->test(5));
+    ASSERT_TRUE(second->test(70000));
+
+    // fewer rows see the same pages
+    auto fewer = query(N + 2, 60000);
+    ASSERT_EQ(fewer->size(), 60000);
+    ASSERT_EQ(fewer->count(), 2);
+    BitsetType bitset(60000);
+    fewer->mask(bitset);
+    ASSERT_EQ(bitset.count(), 2);
+    ASSERT_TRUE(bitset[3]);
+    ASSERT_TRUE(bitset[5]);
+
+    // an older timestamp does not see the later delete
+    auto older = query(N + 1, N);
+    ASSERT_EQ(older->count(), 2);
+    ASSERT_FALSE(older->test(5));
+    ASSERT_EQ(query(N + 2, N)->count(), 3);
+}
+
+TEST(Util, DeletedRecordPush) {
+    using namespace milvus;
+    using namespace milvus::segcore;
+
+    auto collect = [](const DeletedRecord& record, int64_t size) {
+        std::vector<std::pair<Timestamp, std::string>> deletes(size);
+        record.for_each_pk_span(0, size, [&](const auto* pks, int64_t begin, int64_t count) {
+            for (int64_t i = 0; i < count; ++i) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(*pks)>, std::string>) {
+                    deletes[begin + i].second = pks[i];
+                } else {
+                    deletes[begin + i].second = std::to_string(pks[i]);
+                }
+            }
+        });
+        for (int64_t i = 0; i < size; ++i) {
+            deletes[i].first = record.timestamps_[i];
+        }
+        return deletes;
+    };
+
+    // sorted input is written as it is, the rest in timestamp order with ties kept in place
+    DeletedRecord int_record;
+    std::vector<int64_t> int_pks = {7, 8, 9};
+    std::vector<Timestamp> sorted_ts = {1, 2, 2};
+    int_record.push(0, int_pks.data(), sorted_ts.data(), 3);
+    std::vector<Timestamp> unsorted_ts = {5, 3, 3};
+    int_record.push(3, int_pks.data(), unsorted_ts.data(), 3);
+    ASSERT_EQ(int_record.ack_responder_.GetAck(), 6);
+    std::vector<std::pair<Timestamp, std::string>> expected = {{1, "7"}, {2, "8"}, {2, "9"},
+                                                               {3, "8"}, {3, "9"}, {5, "7"}};
+    ASSERT_EQ(collect(int_record, 6), expected);
+
+    DeletedRecord str_record(DataType::VARCHAR);
+    std::vector<std::string_view> str_pks = {"a", "b", "c"};
+    str_record.push(0, str_pks.data(), unsorted_ts.data(), 3);
+    expected = {{3, "b"}, {3, "c"}, {5, "a"}};
+    ASSERT_EQ(collect(str_record, 3), expected);
+    ASSERT_ANY_THROW(str_record.push(3, int_pks.data(), sorted_ts.data(), 3));
+}
+
+TEST(Util, BitsetOffsets) {
+    using namespace milvus;
+    using namespace milvus::segcore;
+
+    int64_t N = 200;
+    BitsetType bitset(N);
+    std::vector<Timestamp> timestamps(N);
+    for (int64_t i = 0; i < N; ++i) {
+        bitset[i] = i % 3 == 0 || (i >= 64 && i < 128);
+        timestamps[i] = i % 2 == 0 ? 10 : 20;
+    }
+    auto data = reinterpret_cast<const uint8_t*>(bitset.data());
+    auto offsets = [](const std::vector<SegOffset>& offsets) {
+        std::vector<int64_t> res;
+        for (auto offset : offsets) {
+            res.push_back(offset.get());
+        }
+        return res;
+    };
+
+    // no timestamp check, every set bit in order
+    std::vector<int64_t> expected;
+    for (int64_t i = 0; i < N; ++i) {
+        if (bitset[i]) {
+            expected.push_back(i);
+        }
+    }
+    ASSERT_EQ(offsets(BitsetOffsets(data, N, false, -1, nullptr, 0, N, N)), expected);
+    ASSERT_EQ(offsets(BitsetOffsets(data, N, false, 5, nullptr, 0, N, N)),
+              std::vector<int64_t>(expected.begin(), expected.begin() + 5));
+    ASSERT_TRUE(BitsetOffsets(data, N, false, 0, nullptr, 0, N, N).empty());
+
+    // the clear bits, rows in [100, 150) checked and the ones past 150 dropped
+    expected.clear();
+    for (int64_t i = 0; i < 150; ++i) {
+        if (!bitset[i] && (i < 100 || timestamps[i] <= 10)) {
+            expected.push_back(i);
+        }
+    }
+    ASSERT_EQ(offsets(BitsetOffsets(data, N, true, -1, timestamps.data(), 10, 100, 150)), expected);
+}
+
+TEST(Util, SchemaFieldOffsets) {
+    using namespace milvus;
+    Schema schema;
+    auto sparse_id = FieldId(START_USER_FIELDID + 100000);
+    schema.AddField(FieldName("a"), FieldId(START_USER_FIELDID + 2), DataType::INT64);
+    schema.AddField(FieldName("b"), sparse_id, DataType::DOUBLE);
+    schema.AddField(FieldName("c"), FieldId(START_USER_FIELDID), DataType::INT32);
+
+    ASSERT_EQ(schema.get_field_offset(FieldId(START_USER_FIELDID + 2)), 0);
+    ASSERT_EQ(schema.get_field_offset(sparse_id), 1);
+    ASSERT_EQ(schema.get_field_offset(FieldId(START_USER_FIELDID)), 2);
+    ASSERT_EQ(schema.get_field_offset(FieldId(START_USER_FIELDID + 1)), -1);
+    ASSERT_EQ(schema.get_field_offset(FieldId(START_USER_FIELDID + 100001)), -1);
+    ASSERT_EQ(schema.get_field_offset(FieldId(0)), -1);
+    for (int64_t offset = 0; offset < schema.size(); ++offset) {
+        auto field_id = schema.get_field_ids()[offset];
+        ASSERT_EQ(schema.get_field_meta(offset).get_id(), field_id);
+        ASSERT_EQ(&schema[field_id], &schema.get_field_meta(offset));
+    }
+    ASSERT_EQ(schema[FieldName("b")].get_data_type(), DataType::DOUBLE);
 }
@@ -219,6 +219,25 @@ DataGen(SchemaPtr schema, int64_t N, uint64_t seed = 42, uint64_t ts_offset = 0,
                 insert_cols(data, N, field_meta);
                 break;
             }
+            case DataType::VECTOR_SPARSE_FLOAT: {
+                // up to 7 nonnegative nonzeros each, some rows empty
+                auto dim = field_meta.get_dim() > 0 ? field_meta.get_dim() : 1000;
+                auto array = milvus::segcore::CreateVectorDataArray(0, field_meta);
+                for (int n = 0; n < N; ++n) {
+                    std::vector<uint32_t> indices;
+                    std::vector<float> values;
+                    for (auto k = er() % 8; k > 0; --k) {
+                        auto index = uint32_t(er() % dim);
+                        if (std::find(indices.begin(), indices.end(), index) == indices.end()) {
+                            indices.push_back(index);
+                            values.push_back(std::abs(distr(er)));
+                        }
+                    }
+                    AppendSparseRow(SparseFloatRow(std::move(indices), std::move(values)), array.get());
+                }
+                insert_data->mutable_fields_data()->AddAllocated(array.release());
+                break;
+            }
             case DataType::INT64: {
                 vector<int64_t> data(N);
                 for (int i = 0; i < N; i++) {